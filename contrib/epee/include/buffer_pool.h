@@ -0,0 +1,111 @@
+// Copyright (c) 2020, The Monero Project
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this list of
+//    conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list
+//    of conditions and the following disclaimer in the documentation and/or other
+//    materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its contributors may be
+//    used to endorse or promote products derived from this software without specific
+//    prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+// THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <new>
+
+namespace epee
+{
+  /*! \brief Process wide pool of message buffers, sorted into size classes.
+
+      Network messages are built, queued and released at a high rate, and
+      most of them fall into a few sizes (small notifications, transaction
+      relays, block spans). Blocks of a size class are kept on a free list
+      when released, so the next message of that class - on any connection -
+      reuses one instead of going through the system allocator. Blocks above
+      the largest class are passed through to `malloc`/`free`.
+
+      Every block returned may be given to `resize` or `release` from any
+      thread. */
+  namespace buffer_pool
+  {
+    //! Allocation counters, since process start.
+    struct stats
+    {
+      std::uint64_t system_allocations; //!< Blocks obtained from `malloc`/`realloc`
+      std::uint64_t reused;             //!< Blocks taken from a free list
+      std::uint64_t released;           //!< Blocks returned with `release`
+      std::uint64_t cached_bytes;       //!< Bytes currently on the free lists
+    };
+
+    /*! \return Block of at least `bytes`, aligned for any fundamental type.
+        \throw std::bad_alloc if allocation fails. */
+    void* allocate(std::size_t bytes);
+
+    /*! Change capacity of `ptr` to at least `bytes`, preserving contents up
+        to the smaller of the two sizes. `ptr` may be `nullptr`.
+
+        \return New block, or `nullptr` on failure (`ptr` remains valid). */
+    void* resize(void* ptr, std::size_t bytes) noexcept;
+
+    //! Return `ptr` to its free list, or to the system. `ptr` may be `nullptr`.
+    void release(void* ptr) noexcept;
+
+    //! \return Usable bytes in `ptr`, which can be more than requested.
+    std::size_t capacity(const void* ptr) noexcept;
+
+    //! \return Current counters.
+    stats get_stats() noexcept;
+
+    //! Release every cached block back to the system.
+    void trim() noexcept;
+  } // buffer_pool
+
+  //! Standard allocator backed by `buffer_pool`, for byte containers.
+  template<typename T>
+  struct pooled_allocator
+  {
+    using value_type = T;
+
+    pooled_allocator() noexcept = default;
+    template<typename U>
+    pooled_allocator(const pooled_allocator<U>&) noexcept
+    {}
+
+    T* allocate(const std::size_t count)
+    {
+      if (std::numeric_limits<std::size_t>::max() / sizeof(T) < count)
+        throw std::bad_alloc{};
+      return static_cast<T*>(buffer_pool::allocate(count * sizeof(T)));
+    }
+
+    void deallocate(T* ptr, std::size_t) noexcept
+    {
+      buffer_pool::release(ptr);
+    }
+
+    template<typename U>
+    bool operator==(const pooled_allocator<U>&) const noexcept { return true; }
+    template<typename U>
+    bool operator!=(const pooled_allocator<U>&) const noexcept { return false; }
+  };
+} // epee
@@ -41,7 +41,8 @@
 #define MAX_LOG_FILES 50
 
 #define MCLOG_TYPE(level, cat, color, type, x) do { \
-    if (el::Loggers::allowed(level, cat)) { \
+    static el::base::LogSite mlog_site; \
+    if (mlog_site.allowed(level, cat)) { \
       el::base::Writer(level, color, __FILE__, __LINE__, ELPP_FUNC, type).construct(cat) << x; \
     } \
   } while (0)
@@ -89,7 +90,8 @@
 
 #define IFLOG(level, cat, color, type, init, x) \
   do { \
-    if (el::Loggers::allowed(level, cat)) { \
+    static el::base::LogSite mlog_site; \
+    if (mlog_site.allowed(level, cat)) { \
       init; \
       el::base::Writer(level, color, __FILE__, __LINE__, ELPP_FUNC, type).construct(cat) << x; \
     } \
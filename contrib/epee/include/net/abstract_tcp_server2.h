@@ -61,6 +61,10 @@
 #define MONERO_DEFAULT_LOG_CATEGORY "net"
 
 #define ABSTRACT_SERVER_SEND_QUE_MAX_COUNT 1000
+// queued chunks written by a single vectored write (matches the iovec batch asio writes at once)
+#define ABSTRACT_SERVER_SEND_QUE_GATHER_COUNT 64
+// bytes gathered into one write on throttled connections, which sleep after each write in proportion to its size
+#define ABSTRACT_SERVER_SEND_QUE_GATHER_THROTTLED_BYTES (256 * 1024)
 
 namespace epee
 {
@@ -143,6 +147,7 @@ namespace net_utils
     virtual bool release();
     //------------------------------------------------------
     bool do_send_chunk(byte_slice chunk); ///< will send (or queue) a part of data. internal use only
+    void start_write_from_queue(); ///< writes the chunks at the front of the queue. m_send_que_lock must be held
 
     boost::shared_ptr<connection<t_protocol_handler> > safe_shared_from_this();
     bool shutdown();
@@ -236,6 +241,9 @@ namespace net_utils
     /// Run the server's io_service loop.
     bool run_server(size_t threads_count, bool wait = true, const boost::thread::attributes& attrs = boost::thread::attributes());
 
+    /// Give each worker thread its own io_service, and assign connections to them round-robin. Call before run_server.
+    void set_io_service_per_thread(bool enable) { m_io_service_per_thread = enable; }
+
     /// wait for service workers stop
     bool timed_wait_server_stop(uint64_t wait_mseconds);
 
@@ -353,7 +361,7 @@ namespace net_utils
 
   private:
     /// Run the server's io_service loop.
-    bool worker_thread();
+    bool worker_thread(size_t index);
     /// Handle completion of an asynchronous accept operation.
     void handle_accept_ipv4(const boost::system::error_code& e);
     void handle_accept_ipv6(const boost::system::error_code& e);
@@ -361,6 +369,10 @@ namespace net_utils
 
     bool is_thread_worker();
 
+    /// io_service for the next new connection
+    boost::asio::io_service& next_io_service();
+    bool is_own_io_service(const boost::asio::io_service& io_service) const;
+
     const std::shared_ptr<typename connection<t_protocol_handler>::shared_state> m_state;
 
     /// The io_service used to perform asynchronous operations.
@@ -369,12 +381,18 @@ namespace net_utils
       worker()
         : io_service(), work(io_service)
       {}
+      explicit worker(int concurrency_hint)
+        : io_service(concurrency_hint), work(io_service)
+      {}
 
       boost::asio::io_service io_service;
       boost::asio::io_service::work work;
     };
     std::unique_ptr<worker> m_io_service_local_instance;
     boost::asio::io_service& io_service_;    
+    /// With m_io_service_per_thread, the io_services of worker threads other than the first, which runs io_service_
+    std::vector<std::unique_ptr<worker>> m_thread_io_services;
+    std::atomic<size_t> m_next_io_service;
 
     /// Acceptor used to listen for incoming connections.
     boost::asio::ip::tcp::acceptor acceptor_;
@@ -390,6 +408,7 @@ namespace net_utils
     bool m_require_ipv4;
     std::string m_thread_name_prefix; //TODO: change to enum server_type, now used
     size_t m_threads_count;
+    bool m_io_service_per_thread;
     std::vector<boost::shared_ptr<boost::thread> > m_threads;
     boost::thread::id m_main_thread_id;
     critical_section m_threads_lock;
@@ -697,11 +697,7 @@ PRAGMA_WARNING_DISABLE_VS(4355)
 
         CHECK_AND_ASSERT_MES( size_now == m_send_que.front().size(), false, "Unexpected queue size");
         reset_timer(get_default_timeout(), false);
-            async_write(boost::asio::buffer(m_send_que.front().data(), size_now ) ,
-                                 strand_.wrap(
-                                 std::bind(&connection<t_protocol_handler>::handle_write, self, std::placeholders::_1, std::placeholders::_2)
-                                 )
-                                 );
+        start_write_from_queue();
         //_dbg3("(chunk): " << size_now);
         //logger_handle_net_write(size_now);
         //_info("[sock " << socket().native_handle() << "] Async send requested " << m_send_que.front().size());
@@ -715,6 +711,34 @@ PRAGMA_WARNING_DISABLE_VS(4355)
   } // do_send_chunk
   //---------------------------------------------------------------------------------
   template<class t_protocol_handler>
+  void connection<t_protocol_handler>::start_write_from_queue()
+  {
+    // chunks share the messages' buffers, so gathering them into one vectored write sends a
+    // chunked message with a single write and no copy; throttled connections gather less, so
+    // the speed limit sleep after each write stays short
+    const size_t max_count = std::min<size_t>(m_send_que.size(), ABSTRACT_SERVER_SEND_QUE_GATHER_COUNT);
+    const bool throttled = speed_limit_is_enabled();
+    std::vector<boost::asio::const_buffer> buffers;
+    buffers.reserve(max_count);
+    size_t bytes = 0;
+    size_t count = 0;
+    for (; count < max_count; ++count)
+    {
+      const size_t size = m_send_que[count].size();
+      if (count && throttled && bytes + size > ABSTRACT_SERVER_SEND_QUE_GATHER_THROTTLED_BYTES)
+        break;
+      buffers.emplace_back(m_send_que[count].data(), size);
+      bytes += size;
+    }
+    m_send_que_in_flight = count;
+    async_write(buffers,
+      strand_.wrap(
+        std::bind(&connection<t_protocol_handler>::handle_write, connection<t_protocol_handler>::shared_from_this(), std::placeholders::_1, std::placeholders::_2)
+      )
+    );
+  }
+  //---------------------------------------------------------------------------------
+  template<class t_protocol_handler>
   boost::posix_time::milliseconds connection<t_protocol_handler>::get_default_timeout()
   {
     unsigned count;
@@ -886,7 +910,8 @@ PRAGMA_WARNING_DISABLE_VS(4355)
       return;
     }
 
-    m_send_que.pop_front();
+    m_send_que.erase(m_send_que.begin(), m_send_que.begin() + std::min(std::max<size_t>(m_send_que_in_flight, 1), m_send_que.size()));
+    m_send_que_in_flight = 0;
     if(m_send_que.empty())
     {
       if(boost::interprocess::ipcdetail::atomic_read32(&m_want_close_connection))
@@ -902,11 +927,7 @@ PRAGMA_WARNING_DISABLE_VS(4355)
 		if (speed_limit_is_enabled())
 			do_send_handler_write_from_queue(e, m_send_que.front().size() , m_send_que.size()); // (((H)))
 		CHECK_AND_ASSERT_MES( size_now == m_send_que.front().size(), void(), "Unexpected queue size");
-		  async_write(boost::asio::buffer(m_send_que.front().data(), size_now) , 
-           strand_.wrap(
-            std::bind(&connection<t_protocol_handler>::handle_write, connection<t_protocol_handler>::shared_from_this(), std::placeholders::_1, std::placeholders::_2)
-			  )
-          );
+		start_write_from_queue();
       //_dbg3("(normal)" << size_now);
     }
     CRITICAL_REGION_END();
@@ -941,11 +962,13 @@ PRAGMA_WARNING_DISABLE_VS(4355)
     m_state(std::make_shared<typename connection<t_protocol_handler>::shared_state>()),
     m_io_service_local_instance(new worker()),
     io_service_(m_io_service_local_instance->io_service),
+    m_next_io_service(0),
     acceptor_(io_service_),
     acceptor_ipv6(io_service_),
     default_remote(),
     m_stop_signal_sent(false), m_port(0), 
     m_threads_count(0),
+    m_io_service_per_thread(false),
     m_thread_index(0),
 		m_connection_type( connection_type ),
     new_connection_(),
@@ -959,11 +982,13 @@ PRAGMA_WARNING_DISABLE_VS(4355)
   boosted_tcp_server<t_protocol_handler>::boosted_tcp_server(boost::asio::io_service& extarnal_io_service, t_connection_type connection_type) :
     m_state(std::make_shared<typename connection<t_protocol_handler>::shared_state>()),
     io_service_(extarnal_io_service),
+    m_next_io_service(0),
     acceptor_(io_service_),
     acceptor_ipv6(io_service_),
     default_remote(),
     m_stop_signal_sent(false), m_port(0),
     m_threads_count(0),
+    m_io_service_per_thread(false),
     m_thread_index(0),
 		m_connection_type(connection_type),
     new_connection_(),
@@ -1116,9 +1141,10 @@ DISABLE_GCC_WARNING(maybe-uninitialized)
 POP_WARNINGS
   //---------------------------------------------------------------------------------
   template<class t_protocol_handler>
-  bool boosted_tcp_server<t_protocol_handler>::worker_thread()
+  bool boosted_tcp_server<t_protocol_handler>::worker_thread(size_t index)
   {
     TRY_ENTRY();
+    boost::asio::io_service& io_service = 0 < index && index <= m_thread_io_services.size() ? m_thread_io_services[index - 1]->io_service : io_service_;
     uint32_t local_thr_index = boost::interprocess::ipcdetail::atomic_inc32(&m_thread_index); 
     std::string thread_name = std::string("[") + m_thread_name_prefix;
     thread_name += boost::to_string(local_thr_index) + "]";
@@ -1128,7 +1154,7 @@ POP_WARNINGS
     {
       try
       {
-        io_service_.run();
+        io_service.run();
         return true;
       }
       catch(const std::exception& ex)
@@ -1169,6 +1195,13 @@ POP_WARNINGS
     m_threads_count = threads_count;
     m_main_thread_id = boost::this_thread::get_id();
     MLOG_SET_THREAD_NAME("[SRV_MAIN]");
+    if (m_io_service_per_thread && m_thread_io_services.empty())
+    {
+      // the first thread runs io_service_, which keeps the acceptors, idle handlers and other zones' servers
+      for (std::size_t i = 1; i < threads_count; ++i)
+        m_thread_io_services.emplace_back(new worker(1));
+      MINFO("Running " << threads_count << " io_services, one per thread");
+    }
     while(!m_stop_signal_sent)
     {
 
@@ -1177,7 +1210,7 @@ POP_WARNINGS
       for (std::size_t i = 0; i < threads_count; ++i)
       {
         boost::shared_ptr<boost::thread> thread(new boost::thread(
-          attrs, boost::bind(&boosted_tcp_server<t_protocol_handler>::worker_thread, this)));
+          attrs, boost::bind(&boosted_tcp_server<t_protocol_handler>::worker_thread, this, i)));
           _note("Run server thread name: " << m_thread_name_prefix);
         m_threads.push_back(thread);
       }
@@ -1234,6 +1267,26 @@ POP_WARNINGS
   }
   //---------------------------------------------------------------------------------
   template<class t_protocol_handler>
+  boost::asio::io_service& boosted_tcp_server<t_protocol_handler>::next_io_service()
+  {
+    if (m_thread_io_services.empty())
+      return io_service_;
+    const size_t index = m_next_io_service++ % (m_thread_io_services.size() + 1);
+    return index ? m_thread_io_services[index - 1]->io_service : io_service_;
+  }
+  //---------------------------------------------------------------------------------
+  template<class t_protocol_handler>
+  bool boosted_tcp_server<t_protocol_handler>::is_own_io_service(const boost::asio::io_service& io_service) const
+  {
+    if (std::addressof(io_service) == std::addressof(io_service_))
+      return true;
+    for (const auto &w: m_thread_io_services)
+      if (std::addressof(io_service) == std::addressof(w->io_service))
+        return true;
+    return false;
+  }
+  //---------------------------------------------------------------------------------
+  template<class t_protocol_handler>
   bool boosted_tcp_server<t_protocol_handler>::timed_wait_server_stop(uint64_t wait_mseconds)
   {
     TRY_ENTRY();
@@ -1265,6 +1318,8 @@ POP_WARNINGS
     connections_.clear();
     connections_mutex.unlock();
     io_service_.stop();
+    for (auto &w: m_thread_io_services)
+      w->io_service.stop();
     CATCH_ENTRY_L0("boosted_tcp_server<t_protocol_handler>::send_stop_signal()", void());
   }
   //---------------------------------------------------------------------------------
@@ -1311,7 +1366,7 @@ POP_WARNINGS
         (*current_new_connection)->setRpcStation(); // hopefully this is not needed actually
       }
       connection_ptr conn(std::move((*current_new_connection)));
-      (*current_new_connection).reset(new connection<t_protocol_handler>(io_service_, m_state, m_connection_type, conn->get_ssl_support()));
+      (*current_new_connection).reset(new connection<t_protocol_handler>(next_io_service(), m_state, m_connection_type, conn->get_ssl_support()));
       current_acceptor->async_accept((*current_new_connection)->socket(),
           boost::bind(accept_function_pointer, this,
             boost::asio::placeholders::error));
@@ -1346,7 +1401,7 @@ POP_WARNINGS
     assert(m_state != nullptr); // always set in constructor
     _erro("Some problems at accept: " << e.message() << ", connections_count = " << m_state->sock_count);
     misc_utils::sleep_no_w(100);
-    (*current_new_connection).reset(new connection<t_protocol_handler>(io_service_, m_state, m_connection_type, (*current_new_connection)->get_ssl_support()));
+    (*current_new_connection).reset(new connection<t_protocol_handler>(next_io_service(), m_state, m_connection_type, (*current_new_connection)->get_ssl_support()));
     current_acceptor->async_accept((*current_new_connection)->socket(),
         boost::bind(accept_function_pointer, this,
           boost::asio::placeholders::error));
@@ -1355,7 +1410,7 @@ POP_WARNINGS
   template<class t_protocol_handler>
   bool boosted_tcp_server<t_protocol_handler>::add_connection(t_connection_context& out, boost::asio::ip::tcp::socket&& sock, network_address real_remote, epee::net_utils::ssl_support_t ssl_support)
   {
-    if(std::addressof(get_io_service()) == std::addressof(GET_IO_SERVICE(sock)))
+    if(is_own_io_service(GET_IO_SERVICE(sock)))
     {
       connection_ptr conn(new connection<t_protocol_handler>(std::move(sock), m_state, m_connection_type, ssl_support));
       if(conn->start(false, 1 < m_threads_count, std::move(real_remote)))
@@ -1475,7 +1530,7 @@ POP_WARNINGS
   {
     TRY_ENTRY();
 
-    connection_ptr new_connection_l(new connection<t_protocol_handler>(io_service_, m_state, m_connection_type, ssl_support) );
+    connection_ptr new_connection_l(new connection<t_protocol_handler>(next_io_service(), m_state, m_connection_type, ssl_support) );
     connections_mutex.lock();
     connections_.insert(new_connection_l);
     MDEBUG("connections_ size now " << connections_.size());
@@ -1600,7 +1655,7 @@ POP_WARNINGS
   bool boosted_tcp_server<t_protocol_handler>::connect_async(const std::string& adr, const std::string& port, uint32_t conn_timeout, const t_callback &cb, const std::string& bind_ip, epee::net_utils::ssl_support_t ssl_support)
   {
     TRY_ENTRY();    
-    connection_ptr new_connection_l(new connection<t_protocol_handler>(io_service_, m_state, m_connection_type, ssl_support) );
+    connection_ptr new_connection_l(new connection<t_protocol_handler>(next_io_service(), m_state, m_connection_type, ssl_support) );
     connections_mutex.lock();
     connections_.insert(new_connection_l);
     MDEBUG("connections_ size now " << connections_.size());
@@ -1678,7 +1733,7 @@ POP_WARNINGS
       }
     }
     
-    boost::shared_ptr<boost::asio::deadline_timer> sh_deadline(new boost::asio::deadline_timer(io_service_));
+    boost::shared_ptr<boost::asio::deadline_timer> sh_deadline(new boost::asio::deadline_timer(GET_IO_SERVICE(sock_)));
     //start deadline
     sh_deadline->expires_from_now(boost::posix_time::milliseconds(conn_timeout));
     sh_deadline->async_wait([=](const boost::system::error_code& error)
@@ -29,6 +29,7 @@
 #pragma once
 
 #include <vector>
+#include "buffer_pool.h"
 #include "misc_log_ex.h"
 #include "span.h"
 
@@ -55,7 +56,9 @@ public:
   size_t size() const { return storage.size() - offset; }
 
 private:
-  std::vector<uint8_t> storage;
+  using storage_type = std::vector<uint8_t, pooled_allocator<uint8_t>>; // storage is reused across connections
+
+  storage_type storage;
   size_t offset;
 };
 }
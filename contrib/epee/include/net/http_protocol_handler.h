@@ -111,7 +111,7 @@ namespace net_utils
 				http_body_transfer_undefined
 			};
 
-			bool handle_buff_in(std::string& buf);
+			bool handle_buff_in();
 
 			bool analize_cached_request_header_and_invoke_state(size_t pos);
 
@@ -25,6 +25,7 @@
 // 
 
 
+#include <algorithm>
 #include <boost/regex.hpp>
 #include <boost/lexical_cast.hpp>
 #include "http_protocol_handler.h"
@@ -40,6 +41,7 @@
 #define HTTP_MAX_URI_LEN		 9000 
 #define HTTP_MAX_HEADER_LEN		 100000
 #define HTTP_MAX_STARTING_NEWLINES       8
+#define HTTP_MAX_BODY_PRERESERVE         8192 // one receive buffer, the body grows as data actually arrives
 
 namespace epee
 {
@@ -227,27 +229,44 @@ namespace net_utils
   template<class t_connection_context>
 	bool simple_http_connection_handler<t_connection_context>::handle_recv(const void* ptr, size_t cb)
 	{
-		std::string buf((const char*)ptr, cb);
-		//LOG_PRINT_L0("HTTP_RECV: " << ptr << "\r\n" << buf);
-		//file_io_utils::save_string_to_file(string_tools::get_current_module_folder() + "/" + boost::lexical_cast<std::string>(ptr), std::string((const char*)ptr, cb));
+		const char* data = static_cast<const char*>(ptr);
+		//LOG_PRINT_L0("HTTP_RECV: " << ptr << "\r\n" << std::string(data, cb));
 
-		bool res = handle_buff_in(buf);
+		//body bytes of a measured request go straight from the receive buffer into the request body,
+		//without being staged in m_cache first
+		if(m_state == http_state_retriving_body && m_body_transfer_type == http_body_transfer_measure && m_cache.empty())
+		{
+			const size_t body_part = std::min(cb, m_len_remain);
+			m_query_info.m_body.append(data, body_part);
+			m_len_remain -= body_part;
+			data += body_part;
+			cb -= body_part;
+			if(!m_len_remain)
+			{
+				if(handle_request_and_send_response(m_query_info))
+					set_ready_state();
+				else
+					m_state = http_state_error;
+			}
+			if(m_want_close)
+				return false;
+			if(!cb)
+				return m_state != http_state_error;
+		}
+
+		m_cache.append(data, cb);
+		bool res = handle_buff_in();
 		if(m_want_close/*m_state == http_state_connection_close || m_state == http_state_error*/)
 			return false;
 		return res;
 	}
 	//--------------------------------------------------------------------------------------------
   template<class t_connection_context>
-	bool simple_http_connection_handler<t_connection_context>::handle_buff_in(std::string& buf)
+	bool simple_http_connection_handler<t_connection_context>::handle_buff_in()
 	{
 
 		size_t ndel;
 
-		if(m_cache.size())
-			m_cache += buf;
-		else
-			m_cache.swap(buf);
-
 		m_is_stop_handling = false;
 		while(!m_is_stop_handling)
 		{
@@ -443,6 +462,7 @@ namespace net_utils
 					m_state = http_state_error;
 			}
 			m_len_remain = m_len_summary;
+			m_query_info.m_body.reserve(std::min<size_t>(m_len_summary, HTTP_MAX_BODY_PRERESERVE));
 		}else
 		{//current query finished, next will be next query
 			handle_request_and_send_response(m_query_info);
@@ -479,7 +499,11 @@ namespace net_utils
 		if(m_len_remain >= m_cache.size())
 		{
 			m_len_remain -= m_cache.size();
-			m_query_info.m_body += m_cache;
+			//the usual case is the whole cache being body, hand the buffer over instead of copying it
+			if(m_query_info.m_body.empty() && m_query_info.m_body.capacity() <= m_cache.capacity())
+				m_query_info.m_body.swap(m_cache);
+			else
+				m_query_info.m_body += m_cache;
 			m_cache.clear();
 		}else
 		{
@@ -80,6 +80,7 @@ namespace epee
         LOG_ERROR("Failed to load_from_binary on command " << command);
         return false;
       }
+      stg_ret.move_strings_on_get(true);
       return result_struct.load(stg_ret);
     }
 
@@ -128,6 +129,7 @@ namespace epee
         return false;
       }
       on_levin_traffic(context, true, false, false, buff_to_recv.size(), command);
+      stg_ret.move_strings_on_get(true);
       return result_struct.load(stg_ret);
     }
 
@@ -158,6 +160,7 @@ namespace epee
           cb(LEVIN_ERROR_FORMAT, result_struct, context);
           return false;
         }
+        stg_ret.move_strings_on_get(true);
         if (!result_struct.load(stg_ret))
         {
           on_levin_traffic(context, true, false, true, buff.size(), command);
@@ -206,6 +209,7 @@ namespace epee
         LOG_ERROR("Failed to load_from_binary in command " << command);
         return -1;
       }
+      strg.move_strings_on_get(true);
       boost::value_initialized<t_in_type> in_struct;
       boost::value_initialized<t_out_type> out_struct;
 
@@ -239,6 +243,7 @@ namespace epee
         LOG_ERROR("Failed to load_from_binary in notify " << command);
         return -1;
       }
+      strg.move_strings_on_get(true);
       boost::value_initialized<t_in_type> in_struct;
       if (!static_cast<t_in_type&>(in_struct).load(strg))
       {
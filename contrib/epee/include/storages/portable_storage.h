@@ -56,7 +56,7 @@ namespace epee
         size_t n_strings; // not counting field names
       };
 
-      portable_storage(){}
+      portable_storage(): m_move_strings(false) {}
       virtual ~portable_storage(){}
       hsection   open_section(const std::string& section_name,  hsection hparent_section, bool create_if_notexist = false);
       template<class t_value>
@@ -98,8 +98,13 @@ namespace epee
       bool		  dump_as_json(std::string& targetObj, size_t indent = 0, bool insert_newlines = true);
       bool		  load_from_json(const std::string& source);
 
+      //! lets get_value and get_first_value/get_next_value move strings out instead of copying them,
+      //! for storages which are loaded into a struct once and then thrown away
+      void      move_strings_on_get(bool move) { m_move_strings = move; }
+
     private:
       section m_root;
+      bool m_move_strings;
       hsection	get_root_section() {return &m_root;}
       storage_entry* find_storage_entry(const std::string& pentry_name, hsection psection);
       template<class entry_type>
@@ -128,9 +133,15 @@ namespace epee
     struct get_value_visitor: boost::static_visitor<void>
     {
       to_type& m_target;
-      get_value_visitor(to_type& target):m_target(target){}
+      bool m_move;
+      get_value_visitor(to_type& target, bool move = false):m_target(target), m_move(move){}
       template<class from_type>
       void operator()(const from_type& v){convert_t(v, m_target);}
+      void operator()(std::string& v){get_string(v, m_target, m_move);}
+
+      template<class t>
+      static void get_string(std::string& v, t& target, bool move){convert_t(const_cast<const std::string&>(v), target);}
+      static void get_string(std::string& v, std::string& target, bool move){if(move) target = std::move(v); else target = v;}
     };
 
     template<class t_value>
@@ -143,7 +154,7 @@ namespace epee
       if(!pentry)
         return false;
 
-      get_value_visitor<t_value> gvv(val);
+      get_value_visitor<t_value> gvv(val, m_move_strings);
       boost::apply_visitor(gvv, *pentry);
       return true;
       //CATCH_ENTRY("portable_storage::template<>get_value", false);
@@ -186,7 +197,16 @@ namespace epee
     struct get_first_value_visitor: boost::static_visitor<bool>
     {
       to_type& m_target;
-      get_first_value_visitor(to_type& target):m_target(target){}
+      bool m_move;
+      get_first_value_visitor(to_type& target, bool move = false):m_target(target), m_move(move){}
+      bool operator()(array_entry_t<std::string>& a)
+      {
+        std::string* pv = a.get_first_val();
+        if(!pv)
+          return false;
+        get_value_visitor<to_type>::get_string(*pv, m_target, m_move);
+        return true;
+      }
       template<class from_type>
       bool operator()(const array_entry_t<from_type>& a)
       {
@@ -211,7 +231,7 @@ namespace epee
         return nullptr;
       array_entry& ar_entry = boost::get<array_entry>(*pentry);
       
-      get_first_value_visitor<t_value> gfv(target);
+      get_first_value_visitor<t_value> gfv(target, m_move_strings);
       if(!boost::apply_visitor(gfv, ar_entry))
         return nullptr;
       return &ar_entry;
@@ -222,7 +242,16 @@ namespace epee
     struct get_next_value_visitor: boost::static_visitor<bool>
     {
       to_type& m_target;
-      get_next_value_visitor(to_type& target):m_target(target){}
+      bool m_move;
+      get_next_value_visitor(to_type& target, bool move = false):m_target(target), m_move(move){}
+      bool operator()(array_entry_t<std::string>& a)
+      {
+        std::string* pv = a.get_next_val();
+        if(!pv)
+          return false;
+        get_value_visitor<to_type>::get_string(*pv, m_target, m_move);
+        return true;
+      }
       template<class from_type>
       bool operator()(const array_entry_t<from_type>& a)
       {
@@ -242,7 +271,7 @@ namespace epee
       //TRY_ENTRY();
       CHECK_AND_ASSERT(hval_array, false);
       array_entry& ar_entry = *hval_array;
-      get_next_value_visitor<t_value> gnv(target);
+      get_next_value_visitor<t_value> gnv(target, m_move_strings);
       if(!boost::apply_visitor(gnv, ar_entry))
         return false;
       return true;
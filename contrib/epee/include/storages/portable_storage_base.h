@@ -30,6 +30,7 @@
 
 #include <boost/variant.hpp>
 #include <string>
+#include <type_traits>
 #include <vector>
 #include <deque>
 #include <map>
@@ -83,6 +84,8 @@ namespace epee
     {
       array_entry_t():m_it(m_array.end()){}        
       array_entry_t(const array_entry_t& other):m_array(other.m_array), m_it(m_array.end()){}
+      // without these, every array (and everything nested in it) would be deep copied each time the parser moves it up the tree
+      array_entry_t(array_entry_t&& other) noexcept(std::is_nothrow_move_constructible<typename entry_container<t_entry_type>::type>::value):m_array(std::move(other.m_array)), m_it(m_array.end()){ other.m_it = other.m_array.end(); }
 
       array_entry_t& operator=(const array_entry_t& other)
       {
@@ -91,6 +94,14 @@ namespace epee
         return *this;
       }
 
+      array_entry_t& operator=(array_entry_t&& other) noexcept(std::is_nothrow_move_assignable<typename entry_container<t_entry_type>::type>::value)
+      {
+        m_array = std::move(other.m_array);
+        m_it = m_array.end();
+        other.m_it = other.m_array.end();
+        return *this;
+      }
+
       const t_entry_type* get_first_val() const 
       {
         m_it = m_array.begin();
@@ -98,6 +98,7 @@ namespace epee
           --m_counter_ref;
         }
       };
+// only taken by the readers which may recurse, leaf reads of PODs, varints and strings can't nest
 #define RECURSION_LIMITATION()  recursuion_limitation_guard rl(m_recursion_count)
 
       const uint8_t* m_ptr;
@@ -131,7 +132,6 @@ namespace epee
     inline 
     void throwable_buffer_reader::read(void* target, size_t count)
     {
-      RECURSION_LIMITATION();
       CHECK_AND_ASSERT_THROW_MES(m_count >= count, " attempt to read " << count << " bytes from buffer with " << m_count << " bytes remained");
       memcpy(target, m_ptr, count);
       m_ptr += count;
@@ -140,7 +140,6 @@ namespace epee
     inline 
     void throwable_buffer_reader::read_sec_name(std::string& sce_name)
     {
-      RECURSION_LIMITATION();
       uint8_t name_len = 0;
       read(name_len);
       CHECK_AND_ASSERT_THROW_MES(name_len > 0, "Section name is missing");
@@ -151,7 +150,6 @@ namespace epee
     template<class t_pod_type>
     void throwable_buffer_reader::read(t_pod_type& pod_val)
     {
-      RECURSION_LIMITATION();
       static_assert(std::is_pod<t_pod_type>::value, "POD type expected");
       read(&pod_val, sizeof(pod_val));
       pod_val = CONVERT_POD(pod_val);
@@ -160,7 +158,6 @@ namespace epee
     template<class t_type>
     t_type throwable_buffer_reader::read()
     {
-      RECURSION_LIMITATION();
       t_type v;
       read(v);
       return v;
@@ -221,7 +218,6 @@ namespace epee
     inline 
     size_t throwable_buffer_reader::read_varint()
     {
-      RECURSION_LIMITATION();
       CHECK_AND_ASSERT_THROW_MES(m_count >= 1, "empty buff, expected place for varint");
       size_t v = 0;
       uint8_t size_mask = (*(uint8_t*)m_ptr) &PORTABLE_RAW_SIZE_MARK_MASK;
@@ -329,7 +325,6 @@ namespace epee
     inline 
     void throwable_buffer_reader::read(std::string& str)
     {
-      RECURSION_LIMITATION();
       size_t len = read_varint();
       CHECK_AND_ASSERT_THROW_MES(len < MAX_STRING_LEN_POSSIBLE, "to big string len value in storage: " << len);
       CHECK_AND_ASSERT_THROW_MES(m_count >= len, "string len count value " << len << " goes out of remain storage len " << m_count);
@@ -95,6 +95,7 @@ namespace epee
       if(!rs)
         return false;
 
+      ps.move_strings_on_get(true);
       return out.load(ps);
     }
     //-----------------------------------------------------------------------------------------------------------
@@ -61,7 +61,7 @@ void buffer::append(const void *data, size_t sz)
     else
     {
       NET_BUFFER_LOG("appending " << sz << " from " << size() << " by reallocating");
-      std::vector<uint8_t> new_storage;
+      storage_type new_storage;
       size_t reserve = (((size() + sz) * 3 / 2) + 4095) & ~4095;
       new_storage.reserve(reserve);
       new_storage.resize(size());
@@ -0,0 +1,234 @@
+// Copyright (c) 2020, The Monero Project
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this list of
+//    conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list
+//    of conditions and the following disclaimer in the documentation and/or other
+//    materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its contributors may be
+//    used to endorse or promote products derived from this software without specific
+//    prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+// THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "buffer_pool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+namespace
+{
+  // Levin messages are built in a `byte_stream` that grows in powers of 2
+  // from 4 KiB, so the classes follow; the slack leaves room for the
+  // `byte_slice` reference count stored in front of the bytes.
+  constexpr const std::size_t class_count = 7; // 4 KiB - 256 KiB
+  constexpr const std::size_t smallest_class = 4096;
+  constexpr const std::size_t class_slack = 64;
+  constexpr const std::size_t max_cached_bytes = 4 * 1024 * 1024; // per class
+  constexpr const std::size_t unpooled = std::numeric_limits<std::size_t>::max();
+
+  struct alignas(alignof(std::max_align_t)) block_header
+  {
+    std::size_t capacity;
+    std::size_t size_class;
+  };
+
+  struct free_list
+  {
+    std::mutex lock;
+    std::vector<block_header*> blocks; // reserved up front, so push_back never allocates
+  };
+
+  struct pool
+  {
+    pool()
+    {
+      for (std::size_t i = 0; i < class_count; ++i)
+        lists[i].blocks.reserve(max_cached_bytes / smallest_class >> i);
+    }
+
+    free_list lists[class_count];
+    std::atomic<std::uint64_t> system_allocations{0};
+    std::atomic<std::uint64_t> reused{0};
+    std::atomic<std::uint64_t> released{0};
+    std::atomic<std::uint64_t> cached_bytes{0};
+  };
+
+  pool& get_pool()
+  {
+    // never destroyed, buffers can be released by other static destructors
+    static pool* const instance = new pool{};
+    return *instance;
+  }
+
+  constexpr std::size_t class_capacity(const std::size_t size_class) noexcept
+  {
+    return (smallest_class << size_class) + class_slack;
+  }
+
+  std::size_t get_size_class(const std::size_t bytes) noexcept
+  {
+    for (std::size_t i = 0; i < class_count; ++i)
+    {
+      if (bytes <= class_capacity(i))
+        return i;
+    }
+    return unpooled;
+  }
+
+  block_header* get_header(const void* ptr) noexcept
+  {
+    return static_cast<block_header*>(const_cast<void*>(ptr)) - 1;
+  }
+} // anonymous
+
+namespace epee
+{
+namespace buffer_pool
+{
+  void* allocate(std::size_t bytes)
+  {
+    pool& self = get_pool();
+    const std::size_t size_class = get_size_class(bytes);
+    if (size_class != unpooled)
+    {
+      block_header* block = nullptr;
+      free_list& list = self.lists[size_class];
+      {
+        const std::lock_guard<std::mutex> lock{list.lock};
+        if (!list.blocks.empty())
+        {
+          block = list.blocks.back();
+          list.blocks.pop_back();
+        }
+      }
+      if (block)
+      {
+        self.reused.fetch_add(1, std::memory_order_relaxed);
+        self.cached_bytes.fetch_sub(block->capacity, std::memory_order_relaxed);
+        return block + 1;
+      }
+      bytes = class_capacity(size_class);
+    }
+
+    if (std::numeric_limits<std::size_t>::max() - sizeof(block_header) < bytes)
+      throw std::bad_alloc{};
+
+    void* const ptr = std::malloc(sizeof(block_header) + bytes);
+    if (ptr == nullptr)
+      throw std::bad_alloc{};
+
+    self.system_allocations.fetch_add(1, std::memory_order_relaxed);
+    return new (ptr) block_header{bytes, size_class} + 1;
+  }
+
+  void* resize(void* const ptr, const std::size_t bytes) noexcept
+  {
+    try
+    {
+      if (ptr == nullptr)
+        return allocate(bytes);
+
+      block_header* const block = get_header(ptr);
+      const std::size_t size_class = get_size_class(bytes);
+      if (size_class == block->size_class)
+      {
+        if (size_class != unpooled)
+          return ptr; // already fits
+
+        if (std::numeric_limits<std::size_t>::max() - sizeof(block_header) < bytes)
+          return nullptr;
+
+        block_header* const moved = static_cast<block_header*>(std::realloc(block, sizeof(block_header) + bytes));
+        if (moved == nullptr)
+          return nullptr;
+
+        get_pool().system_allocations.fetch_add(1, std::memory_order_relaxed);
+        moved->capacity = bytes;
+        return moved + 1;
+      }
+
+      void* const out = allocate(bytes);
+      std::memcpy(out, ptr, std::min(block->capacity, bytes));
+      release(ptr);
+      return out;
+    }
+    catch (const std::bad_alloc&)
+    {
+      return nullptr;
+    }
+  }
+
+  void release(void* const ptr) noexcept
+  {
+    if (ptr == nullptr)
+      return;
+
+    pool& self = get_pool();
+    block_header* const block = get_header(ptr);
+    self.released.fetch_add(1, std::memory_order_relaxed);
+    if (block->size_class != unpooled)
+    {
+      free_list& list = self.lists[block->size_class];
+      const std::lock_guard<std::mutex> lock{list.lock};
+      if (list.blocks.size() < list.blocks.capacity())
+      {
+        list.blocks.push_back(block);
+        self.cached_bytes.fetch_add(block->capacity, std::memory_order_relaxed);
+        return;
+      }
+    }
+    std::free(block);
+  }
+
+  std::size_t capacity(const void* const ptr) noexcept
+  {
+    return ptr ? get_header(ptr)->capacity : 0;
+  }
+
+  stats get_stats() noexcept
+  {
+    const pool& self = get_pool();
+    return {
+      self.system_allocations.load(std::memory_order_relaxed),
+      self.reused.load(std::memory_order_relaxed),
+      self.released.load(std::memory_order_relaxed),
+      self.cached_bytes.load(std::memory_order_relaxed)
+    };
+  }
+
+  void trim() noexcept
+  {
+    pool& self = get_pool();
+    for (free_list& list : self.lists)
+    {
+      const std::lock_guard<std::mutex> lock{list.lock};
+      for (block_header* const block : list.blocks)
+      {
+        self.cached_bytes.fetch_sub(block->capacity, std::memory_order_relaxed);
+        std::free(block);
+      }
+      list.blocks.clear();
+    }
+  }
+} // buffer_pool
+} // epee
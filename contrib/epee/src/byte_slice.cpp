@@ -33,6 +33,7 @@
 #include <stdexcept>
 #include <utility>
 
+#include "buffer_pool.h"
 #include "byte_slice.h"
 #include "byte_stream.h"
 
@@ -63,7 +64,7 @@ namespace epee
       if (--(self->ref_count) == 0)
       {
         self->~byte_slice_data();
-        free(self);
+        buffer_pool::release(self);
       }
     }
   }
@@ -97,8 +98,8 @@ namespace epee
     /* This technique is not-standard, but allows for the reference count and
        memory for the bytes (when given a list of spans) to be allocated in a
        single call. In that situation, the dynamic sized bytes are after/behind
-       the raw_byte_slice class. The C runtime has to track the number of bytes
-       allocated regardless, so free'ing is relatively easy. */
+       the raw_byte_slice class. The buffer pool tracks the size of every
+       block regardless, so free'ing is relatively easy. */
 
     template<typename T, typename... U>
     std::unique_ptr<T, release_byte_slice> allocate_slice(std::size_t extra_bytes, U&&... args)
@@ -106,9 +107,7 @@ namespace epee
       if (std::numeric_limits<std::size_t>::max() - sizeof(T) < extra_bytes)
         throw std::bad_alloc{};
 
-      void* const ptr = malloc(sizeof(T) + extra_bytes);
-      if (ptr == nullptr)
-        throw std::bad_alloc{};
+      void* const ptr = buffer_pool::allocate(sizeof(T) + extra_bytes);
 
       try
       {
@@ -116,7 +115,7 @@ namespace epee
       }
       catch (...)
       {
-        free(ptr);
+        buffer_pool::release(ptr);
         throw;
       }
       return std::unique_ptr<T, release_byte_slice>{reinterpret_cast<T*>(ptr)};
@@ -126,7 +125,7 @@ namespace epee
   void release_byte_buffer::operator()(std::uint8_t* buf) const noexcept
   {
     if (buf)
-      std::free(buf - sizeof(raw_byte_slice));
+      buffer_pool::release(buf - sizeof(raw_byte_slice));
   }
 
   byte_slice::byte_slice(byte_slice_data* storage, span<const std::uint8_t> portion) noexcept
@@ -269,7 +268,7 @@ namespace epee
     if (data != nullptr)
       data -= sizeof(raw_byte_slice);
 
-    data = static_cast<std::uint8_t*>(std::realloc(data, sizeof(raw_byte_slice) + length));
+    data = static_cast<std::uint8_t*>(buffer_pool::resize(data, sizeof(raw_byte_slice) + length));
     if (data == nullptr)
       return nullptr;
 
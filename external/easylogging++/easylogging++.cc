@@ -2119,28 +2119,15 @@ void VRegistry::setModules(const char* modules) {
   }
 }
 
-// Log levels are sorted in a weird way...
-static int priority(Level level) {
-  if (level == Level::Fatal) return 0;
-  if (level == Level::Error) return 1;
-  if (level == Level::Warning) return 2;
-  if (level == Level::Info) return 3;
-  if (level == Level::Debug) return 4;
-  if (level == Level::Verbose) return 5;
-  if (level == Level::Trace) return 6;
-  return 7;
-}
-
-namespace
-{
-  std::atomic<int> s_lowest_priority{INT_MAX};
-}
+std::atomic<int> s_lowest_priority{INT_MAX};
+std::atomic<uint32_t> s_categories_generation{1};
 
 void VRegistry::clearCategories(void) {
   const base::threading::ScopedLock scopedLock(lock());
   m_categories.clear();
   m_cached_allowed_categories.clear();
   s_lowest_priority = INT_MAX;
+  ++s_categories_generation;
 }
 
 void VRegistry::setCategories(const char* categories, bool clear) {
@@ -2159,8 +2146,10 @@ void VRegistry::setCategories(const char* categories, bool clear) {
     m_cached_allowed_categories.clear();
     m_categoriesString.clear();
   }
-  if (!categories)
+  if (!categories) {
+    ++s_categories_generation;
     return;
+  }
   if (!m_categoriesString.empty())
     m_categoriesString += ",";
   m_categoriesString += categories;
@@ -2204,6 +2193,7 @@ void VRegistry::setCategories(const char* categories, bool clear) {
   if (!ss.str().empty() && level != Level::Unknown) {
     insert(ss, level);
   }
+  ++s_categories_generation;
 }
 
 std::string VRegistry::getCategories() {
@@ -2216,22 +2206,34 @@ bool VRegistry::allowed(Level level, const std::string &category) {
 }
 bool VRegistry::priority_allowed(const int pri, const std::string &category) {
   base::threading::ScopedLock scopedLock(lock());
+  return pri <= category_priority(category);
+}
+
+uint32_t VRegistry::category_state(const std::string &category) {
+  base::threading::ScopedLock scopedLock(lock());
+  // the generation only changes under the lock, so it matches the priority
+  const uint32_t generation = s_categories_generation.load(std::memory_order_relaxed) & 0xffffff;
+  return (generation << 8) | static_cast<uint32_t>(category_priority(category) + 1);
+}
+
+// must hold the lock, -1 if the category does not log
+int VRegistry::category_priority(const std::string &category) {
   const std::map<std::string, int>::const_iterator it = m_cached_allowed_categories.find(category);
   if (it != m_cached_allowed_categories.end())
-    return pri <= it->second;
+    return it->second;
   if (m_categories.empty()) {
-    return false;
+    return -1;
   } else {
     std::vector<std::pair<std::string, Level>>::const_reverse_iterator it = m_categories.rbegin();
     for (; it != m_categories.rend(); ++it) {
       if (base::utils::Str::wildCardMatch(category.c_str(), it->first.c_str())) {
         const int p = priority(it->second);
         m_cached_allowed_categories.insert(std::make_pair(category, p));
-        return pri <= p;
+        return p;
       }
     }
     m_cached_allowed_categories.insert(std::make_pair(category, -1));
-    return false;
+    return -1;
   }
 }
 
@@ -3355,11 +3357,16 @@ void Helpers::logCrashReason(int sig, bool stackTraceIfAvailable, Level level, c
 bool Loggers::allowed(Level level, const char* cat)
 {
   const int pri = base::priority(level);
-  if (pri > base::s_lowest_priority)
+  if (pri > base::s_lowest_priority.load(std::memory_order_relaxed))
     return false;
   return ELPP->vRegistry()->priority_allowed(pri, std::string{cat});
 }
 
+uint32_t Loggers::categoryState(const char* cat)
+{
+  return ELPP->vRegistry()->category_state(std::string{cat});
+}
+
 Logger* Loggers::getLogger(const std::string& identity, bool registerIfNotAvailable) {
   return ELPP->registeredLoggers()->get(identity, registerIfNotAvailable);
 }
@@ -412,6 +412,7 @@ ELPP_INTERNAL_DEBUGGING_OUT_INFO << ELPP_INTERNAL_DEBUGGING_MSG(internalInfoStre
 #include <sstream>
 #include <memory>
 #include <type_traits>
+#include <atomic>
 #if ELPP_THREADING_ENABLED
 #  if ELPP_USE_STD_THREADING
 #      include <mutex>
@@ -2479,6 +2480,9 @@ class VRegistry : base::NoCopy, public base::threading::ThreadSafe {
 
   bool priority_allowed(int priority, const std::string &category);
   bool allowed(Level level, const std::string &category);
+  /// @brief The category's priority plus one (0 if it does not log), with the current categories generation
+  /// in the upper bits, for LogSite
+  uint32_t category_state(const std::string &category);
 
   bool allowed(base::type::VerboseLevel vlevel, const char* file);
 
@@ -2508,6 +2512,8 @@ class VRegistry : base::NoCopy, public base::threading::ThreadSafe {
   std::vector<std::pair<std::string, Level>> m_categories;
   std::map<std::string, int> m_cached_allowed_categories;
   std::string m_categoriesString;
+
+  int category_priority(const std::string &category);
   std::string m_filenameCommonPrefix;
 };
 }  // namespace base
@@ -3983,7 +3989,71 @@ class Loggers : base::StaticClass {
   static void setFilenameCommonPrefix(const std::string &prefix);
   /// @brief Gets filename common prefix
   static const std::string &getFilenameCommonPrefix();
+  /// @brief See VRegistry::category_state
+  static uint32_t categoryState(const char* cat);
 };
+namespace base {
+/// @brief Priority of a level, lower is more important (the Level values are sorted in a weird way)
+inline int priority(Level level) {
+  if (level == Level::Fatal) return 0;
+  if (level == Level::Error) return 1;
+  if (level == Level::Warning) return 2;
+  if (level == Level::Info) return 3;
+  if (level == Level::Debug) return 4;
+  if (level == Level::Verbose) return 5;
+  if (level == Level::Trace) return 6;
+  return 7;
+}
+/// @brief Lowest priority (highest number) any category logs at, INT_MAX until the categories are first set
+extern std::atomic<int> s_lowest_priority;
+/// @brief Bumped whenever the categories change, invalidating the LogSite caches. Starts at 1 so a zeroed cache is stale
+extern std::atomic<uint32_t> s_categories_generation;
+/// @brief Caches whether a log call site's category logs at each level, until the categories change
+/// Levels no category logs at are rejected with one relaxed load. Otherwise a site with a string literal
+/// category reads its cached category priority instead of locking the registry and looking the category
+/// up. The cache belongs to the first literal category seen at the site: other categories (a site in an
+/// inline function shared by files with different default categories) and non literal ones take the slow path.
+/// Constant initialized, so a function local static one costs no guard.
+class LogSite {
+ public:
+  constexpr LogSite() : m_cat(nullptr), m_state(0) {}
+
+  template<size_t N>
+  bool allowed(Level level, const char (&cat)[N]) { return allowed(level, cat, true); }
+  template<size_t N>
+  bool allowed(Level level, char (&cat)[N]) { return allowed(level, cat, false); }
+  template<typename T>
+  bool allowed(Level level, const T &cat) { return allowed(level, cat, false); }
+
+  /// @brief For a category passed through a pointer: constant_category says whether the string never changes
+  bool allowed(Level level, const char *cat, bool constant_category) {
+    const int pri = priority(level);
+    if (pri > s_lowest_priority.load(std::memory_order_relaxed))
+      return false;
+    if (!constant_category || !owns(cat))
+      return Loggers::allowed(level, cat);
+    uint32_t state = m_state.load(std::memory_order_relaxed);
+    if ((state >> 8) != (s_categories_generation.load(std::memory_order_relaxed) & 0xffffff)) {
+      state = Loggers::categoryState(cat);
+      m_state.store(state, std::memory_order_relaxed);
+    }
+    return pri < static_cast<int>(state & 0xff);
+  }
+
+ private:
+  bool owns(const char *cat) {
+    const char *site_cat = m_cat.load(std::memory_order_relaxed);
+    if (site_cat == cat)
+      return true;
+    if (site_cat)
+      return false;
+    return m_cat.compare_exchange_strong(site_cat, cat, std::memory_order_relaxed) || site_cat == cat;
+  }
+
+  std::atomic<const char*> m_cat;
+  std::atomic<uint32_t> m_state;
+};
+}  // namespace base
 class VersionInfo : base::StaticClass {
  public:
   /// @brief Current version number
@@ -160,6 +160,17 @@ const command_line::arg_descriptor<bool> arg_db_salvage  = {
 , "Try to salvage a blockchain database if it seems corrupted"
 , false
 };
+const command_line::arg_descriptor<uint64_t> arg_db_spent_key_filter_size  = {
+  "db-spent-key-filter-size"
+, "Memory in bytes for an in-memory filter of spent key images, which spares a database search for most unspent ones (0 to disable)"
+, 64 * 1024 * 1024
+};
+
+const command_line::arg_descriptor<uint64_t> arg_db_undo_log_depth  = {
+  "db-undo-log-depth"
+, "Number of top blocks to keep an undo log for, which makes popping them in a reorg faster (0 to disable)"
+, 1000
+};
 
 BlockchainDB *new_db()
 {
@@ -170,6 +181,8 @@ void BlockchainDB::init_options(boost::program_options::options_description& des
 {
   command_line::add_arg(desc, arg_db_sync_mode);
   command_line::add_arg(desc, arg_db_salvage);
+  command_line::add_arg(desc, arg_db_spent_key_filter_size);
+  command_line::add_arg(desc, arg_db_undo_log_depth);
 }
 
 void BlockchainDB::pop_block()
@@ -324,9 +337,69 @@ void BlockchainDB::pop_block(block& blk, std::vector<transaction>& txs)
     if (!get_tx(h, tx) && !get_pruned_tx(h, tx))
       throw DB_ERROR("Failed to get pruned or unpruned transaction from the db");
     txs.push_back(std::move(tx));
-    remove_transaction(h);
   }
-  remove_transaction(get_transaction_hash(blk.miner_tx));
+
+  if (!remove_block_transactions(blk))
+  {
+    for (const auto& h : boost::adaptors::reverse(blk.tx_hashes))
+      remove_transaction(h);
+    remove_transaction(get_transaction_hash(blk.miner_tx));
+  }
+}
+
+std::vector<uint64_t> BlockchainDB::get_block_cumulative_rct_outputs_range(uint64_t start_height, uint64_t end_height) const
+{
+  if (end_height < start_height)
+    return {};
+
+  const uint64_t db_height = height();
+  if (end_height >= db_height)
+    throw BLOCK_DNE(std::string("Attempt to get rct distribution up to height " + std::to_string(end_height) + " failed -- block not in db").c_str());
+  // by height rather than top_block_hash(), which another process writing the db may have moved meanwhile
+  const crypto::hash top_hash = get_block_hash_from_height(db_height - 1);
+
+  // the mirror only follows what readers see, and the db is read without holding its lock
+  for (;;)
+  {
+    uint64_t mirror_height;
+    crypto::hash mirror_top_hash;
+    {
+      std::lock_guard<std::mutex> lock(m_rct_cumulative_lock);
+      if (m_rct_cumulative.size() == db_height && m_rct_cumulative_top_hash == top_hash)
+        return std::vector<uint64_t>(m_rct_cumulative.begin() + start_height, m_rct_cumulative.begin() + end_height + 1);
+      mirror_height = m_rct_cumulative.size();
+      mirror_top_hash = m_rct_cumulative_top_hash;
+    }
+
+    // another reader has seen a later state than this one, leave the mirror to it
+    if (mirror_height > db_height)
+    {
+      std::vector<uint64_t> heights(end_height - start_height + 1);
+      for (uint64_t h = start_height; h <= end_height; ++h)
+        heights[h - start_height] = h;
+      return get_block_cumulative_rct_outputs(heights);
+    }
+
+    // if blocks were only added on top (eg, by that other process), only those are read
+    uint64_t first_height = 0;
+    if (mirror_height > 0 && get_block_hash_from_height(mirror_height - 1) == mirror_top_hash)
+      first_height = mirror_height;
+
+    std::vector<uint64_t> heights(db_height - first_height);
+    for (uint64_t h = first_height; h < db_height; ++h)
+      heights[h - first_height] = h;
+    std::vector<uint64_t> cumulative = get_block_cumulative_rct_outputs(heights);
+
+    std::lock_guard<std::mutex> lock(m_rct_cumulative_lock);
+    if (first_height == 0)
+      m_rct_cumulative = std::move(cumulative);
+    else if (m_rct_cumulative.size() == mirror_height && m_rct_cumulative_top_hash == mirror_top_hash)
+      m_rct_cumulative.insert(m_rct_cumulative.end(), cumulative.begin(), cumulative.end());
+    else
+      continue; // another reader changed the mirror meanwhile, start over from that
+    m_rct_cumulative_top_hash = top_hash;
+    return std::vector<uint64_t>(m_rct_cumulative.begin() + start_height, m_rct_cumulative.begin() + end_height + 1);
+  }
 }
 
 bool BlockchainDB::is_open() const
@@ -440,6 +513,32 @@ void BlockchainDB::show_stats()
   );
 }
 
+void BlockchainDB::has_key_images(const epee::span<const crypto::key_image> &imgs, std::vector<bool> &found) const
+{
+  found.clear();
+  found.reserve(imgs.size());
+  for (const crypto::key_image &img: imgs)
+    found.push_back(has_key_image(img));
+}
+
+void BlockchainDB::get_split_tx_blobs(const epee::span<const crypto::hash> &tx_hashes, std::vector<split_tx_blob> &blobs) const
+{
+  blobs.clear();
+  blobs.resize(tx_hashes.size());
+  for (size_t i = 0; i < tx_hashes.size(); ++i)
+  {
+    split_tx_blob &blob = blobs[i];
+    blob.found = get_pruned_tx_blob(tx_hashes[i], blob.pruned);
+    blob.has_prunable_hash = false;
+    blob.prunable_hash = crypto::null_hash;
+    if (!blob.found)
+      continue;
+    blob.has_prunable_hash = get_prunable_tx_hash(tx_hashes[i], blob.prunable_hash);
+    if (!get_prunable_tx_blob(tx_hashes[i], blob.prunable))
+      blob.prunable.clear();
+  }
+}
+
 void BlockchainDB::fixup()
 {
   if (is_read_only()) {
@@ -32,6 +32,7 @@
 
 #include <string>
 #include <exception>
+#include <mutex>
 #include <boost/program_options.hpp>
 #include "common/command_line.h"
 #include "crypto/hash.h"
@@ -40,6 +41,7 @@
 #include "cryptonote_basic/difficulty.h"
 #include "cryptonote_basic/hardfork.h"
 #include "cryptonote_protocol/enums.h"
+#include "blockchain_db/key_image_filter.h"
 
 /** \file
  * Cryptonote Blockchain Database Interface
@@ -105,6 +107,8 @@ typedef std::pair<crypto::hash, uint64_t> tx_out_index;
 
 extern const command_line::arg_descriptor<std::string> arg_db_sync_mode;
 extern const command_line::arg_descriptor<bool, false> arg_db_salvage;
+extern const command_line::arg_descriptor<uint64_t> arg_db_spent_key_filter_size;
+extern const command_line::arg_descriptor<uint64_t> arg_db_undo_log_depth;
 
 enum class relay_category : uint8_t
 {
@@ -139,6 +143,46 @@ struct tx_data_t
 };
 #pragma pack(pop)
 
+/**
+ * @brief a transaction's blob, held in the database
+ *
+ * The pruned blob is `pruned`; the full blob is `pruned` followed by `prunable`.
+ */
+struct tx_blob_ref
+{
+  crypto::hash hash;
+  epee::span<const uint8_t> pruned;
+  epee::span<const uint8_t> prunable;
+};
+
+/**
+ * @brief a block's blob and its transactions' blobs, held in the database
+ *
+ * The spans point into the database, and are only valid for as long as the
+ * read transaction they were fetched in.
+ */
+struct block_blob_refs
+{
+  epee::span<const uint8_t> block;
+  crypto::hash miner_tx_hash;
+  std::vector<tx_blob_ref> txs;
+};
+
+/**
+ * @brief a transaction's blobs as served by get_split_tx_blobs()
+ *
+ * `prunable` is empty when the prunable data was pruned away, and
+ * `has_prunable_hash` is false for transactions without one (v1).
+ */
+struct split_tx_blob
+{
+  bool found;
+  cryptonote::blobdata pruned;
+  bool has_prunable_hash;
+  crypto::hash prunable_hash;
+  cryptonote::blobdata prunable;
+};
+
 struct alt_block_data_t
 {
   uint64_t height;
@@ -527,6 +571,24 @@ private:
    */
   virtual void remove_spent_key(const crypto::key_image& k_image) = 0;
 
+  /**
+   * @brief remove the transactions, outputs and spent keys of the top block in bulk
+   *
+   * Called by pop_block() after remove_block(), with the block being popped.
+   * A subclass which recorded what the block added when it was added can
+   * reverse it here with fewer and cheaper operations than removing each
+   * transaction in turn.
+   *
+   * If any of this cannot be done, the subclass should throw the corresponding
+   * subclass of DB_EXCEPTION
+   *
+   * @param blk the block being popped
+   *
+   * @return false if nothing was recorded for the block, in which case each
+   *         transaction is removed by remove_transaction()
+   */
+  virtual bool remove_block_transactions(const block& blk) { return false; }
+
 
   /*********************************************************************
    * private concrete members
@@ -554,6 +616,13 @@ private:
   uint64_t time_add_block1 = 0;  //!< a performance metric
   uint64_t time_add_transaction = 0;  //!< a performance metric
 
+  // in-memory copy of every block's cumulative number of rct outputs, as last read from the db by
+  // get_block_cumulative_rct_outputs_range(): extended when blocks were only added on top, and
+  // rebuilt when its top block is no longer in the chain
+  mutable std::mutex m_rct_cumulative_lock;
+  mutable std::vector<uint64_t> m_rct_cumulative;
+  mutable crypto::hash m_rct_cumulative_top_hash = crypto::null_hash;  //!< hash of the block at m_rct_cumulative.size() - 1
+
 
 protected:
 
@@ -804,6 +873,19 @@ public:
    */
   virtual void batch_abort() = 0;
 
+  /**
+   * @brief gets what it cost to commit the last batch
+   *
+   * The dirty volume is an estimate, and subclasses which cannot measure it
+   * may report 0.
+   *
+   * @param commit_ms return-by-reference how long the commit took, in milliseconds
+   * @param dirty_bytes return-by-reference how many bytes of pages the batch wrote
+   *
+   * @return false if the subclass does not measure its commits, or no batch was committed yet
+   */
+  virtual bool get_last_batch_commit_cost(uint64_t &commit_ms, uint64_t &dirty_bytes) const { return false; }
+
   /**
    * @brief sets whether or not to batch transactions
    *
@@ -977,6 +1059,22 @@ public:
    */
   virtual std::vector<uint64_t> get_block_cumulative_rct_outputs(const std::vector<uint64_t> &heights) const = 0;
 
+  /**
+   * @brief fetch the cumulative number of rct outputs of a range of blocks
+   *
+   * Returns what get_block_cumulative_rct_outputs would for every height from
+   * start_height to end_height (inclusive), sliced from an in-memory copy
+   * which is kept up to date as blocks are added and popped.
+   *
+   * If a block does not exist, throws BLOCK_DNE
+   *
+   * @param start_height the first height requested
+   * @param end_height the last height requested
+   *
+   * @return the cumulative numbers of rct outputs
+   */
+  std::vector<uint64_t> get_block_cumulative_rct_outputs_range(uint64_t start_height, uint64_t end_height) const;
+
   /**
    * @brief fetch the top block's timestamp
    *
@@ -1327,6 +1425,16 @@ public:
    */
   virtual bool get_blocks_from(uint64_t start_height, size_t min_block_count, size_t max_block_count, size_t max_tx_count, size_t max_size, std::vector<std::pair<std::pair<cryptonote::blobdata, crypto::hash>, std::vector<std::pair<crypto::hash, cryptonote::blobdata>>>>& blocks, bool pruned, bool skip_coinbase, bool get_miner_tx_hash) const = 0;
 
+  /**
+   * @brief references the same blocks and transactions as get_blocks_from(), without copying them
+   *
+   * The caller must hold a read transaction (see db_rtxn_guard) for as long
+   * as it uses the returned spans.  Parameters are as for get_blocks_from().
+   *
+   * @return false if the subclass cannot hand out references, otherwise true
+   */
+  virtual bool get_block_blob_refs_from(uint64_t start_height, size_t min_block_count, size_t max_block_count, size_t max_tx_count, size_t max_size, std::vector<block_blob_refs>& blocks, bool pruned, bool skip_coinbase, bool get_miner_tx_hash) const { return false; }
+
   /**
    * @brief fetches the prunable transaction blob with the given hash
    *
@@ -1355,6 +1463,17 @@ public:
    */
   virtual bool get_prunable_tx_hash(const crypto::hash& tx_hash, crypto::hash &prunable_hash) const = 0;
 
+  /**
+   * @brief fetches the pruned blob, prunable hash and prunable blob of several transactions
+   *
+   * The default implementation makes the three single-transaction calls for
+   * each hash; implementations may look them up together.
+   *
+   * @param tx_hashes the tx hashes to look for
+   * @param blobs return-by-reference blobs[i] holds the data for tx_hashes[i]
+   */
+  virtual void get_split_tx_blobs(const epee::span<const crypto::hash> &tx_hashes, std::vector<split_tx_blob> &blobs) const;
+
   /**
    * @brief fetches the total number of transactions ever
    *
@@ -1522,6 +1641,49 @@ public:
    */
   virtual bool has_key_image(const crypto::key_image& img) const = 0;
 
+  /**
+   * @brief check which of a set of key images are stored as spent
+   *
+   * The default implementation calls has_key_image for each image;
+   * implementations may look them up together.
+   *
+   * @param imgs the key images to check for
+   * @param found return-by-reference found[i] is true if imgs[i] is present
+   */
+  virtual void has_key_images(const epee::span<const crypto::key_image> &imgs, std::vector<bool> &found) const;
+
+  /**
+   * @brief set the memory for an in-memory filter of the spent key images
+   *
+   * The filter answers most lookups of unspent key images without a
+   * database search. It is built when the database is opened, so this
+   * must be called before open() to take effect.
+   *
+   * @param bytes memory for the filter, 0 to not use one
+   */
+  virtual void set_spent_key_filter_size(uint64_t bytes) { }
+
+  /**
+   * @brief set how many of the top blocks keep an undo log
+   *
+   * A block's undo log records what adding it wrote, so popping it (eg, in
+   * a reorg) can remove that directly instead of deriving it again from the
+   * block's transactions. Blocks added before their undo log was kept are
+   * popped the slower way.
+   *
+   * @param blocks number of top blocks to keep undo logs for, 0 to not keep any
+   */
+  virtual void set_undo_log_depth(uint64_t blocks) { }
+
+  /**
+   * @brief get usage counters of the spent key image filter
+   *
+   * @param stats return-by-reference the counters
+   *
+   * @return false if no filter is in use
+   */
+  virtual bool get_spent_key_filter_stats(key_image_filter_stats &stats) const { return false; }
+
   /**
    * @brief add a txpool transaction
    *
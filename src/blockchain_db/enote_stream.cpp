@@ -0,0 +1,568 @@
+// Copyright (c) 2021, The Monero Project
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of
+//    conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list
+//    of conditions and the following disclaimer in the documentation and/or other
+//    materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be
+//    used to endorse or promote products derived from this software without specific
+//    prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+// THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+#include <boost/filesystem.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include "enote_stream.h"
+#include "blockchain_db.h"
+#include "cryptonote_basic/cryptonote_format_utils.h"
+#include "misc_log_ex.h"
+#include "ringct/rctTypes.h"
+
+#undef MONERO_DEFAULT_LOG_CATEGORY
+#define MONERO_DEFAULT_LOG_CATEGORY "blockchain.db.enote_stream"
+
+#define ENOTE_STREAM_MAGIC "Monero enote stream"
+#define ENOTE_STREAM_VERSION 1
+#define ENOTE_STREAM_BYTE_ORDER_MARK 0x0102030405060708ull
+#define ENOTE_STREAM_META_FILE "meta"
+#define ENOTE_STREAM_COMMIT_INTERVAL 5000
+
+namespace
+{
+  struct column_info
+  {
+    const char *name;
+    size_t width;
+  };
+
+  const column_info s_columns[cryptonote::ENOTE_STREAM_NUM_COLUMNS] = {
+    {"tx_pubkeys", sizeof(crypto::public_key)},
+    {"additional_pubkeys", sizeof(crypto::public_key)},
+    {"onetime_addresses", sizeof(crypto::public_key)},
+    {"amounts", sizeof(uint64_t)},
+    {"tx_indices", sizeof(uint32_t)},
+    {"output_indices", sizeof(uint32_t)},
+    {"view_tags", sizeof(uint8_t)},
+    {"flags", sizeof(uint8_t)},
+    {"block_hashes", sizeof(crypto::hash)},
+    {"block_offsets", sizeof(uint64_t)},
+  };
+
+#pragma pack(push, 1)
+  struct meta_t
+  {
+    char magic[sizeof(ENOTE_STREAM_MAGIC)];
+    uint32_t version;
+    uint64_t byte_order_mark;
+    uint64_t num_blocks;
+    uint64_t num_enotes;
+  };
+#pragma pack(pop)
+
+  bool is_block_column(const size_t id)
+  {
+    return id >= cryptonote::ENOTE_STREAM_NUM_ENOTE_COLUMNS;
+  }
+
+  uint64_t column_size(const size_t id, const uint64_t num_blocks, const uint64_t num_enotes)
+  {
+    return s_columns[id].width * (is_block_column(id) ? num_blocks : num_enotes);
+  }
+
+  std::string column_path(const std::string &dir, const size_t id)
+  {
+    return (boost::filesystem::path(dir) / s_columns[id].name).string();
+  }
+
+  bool read_meta(const std::string &dir, bool &found, uint64_t &num_blocks, uint64_t &num_enotes)
+  {
+    found = false;
+    num_blocks = 0;
+    num_enotes = 0;
+
+    const boost::filesystem::path path = boost::filesystem::path(dir) / ENOTE_STREAM_META_FILE;
+    boost::system::error_code ec;
+    if (!boost::filesystem::exists(path, ec))
+      return true;
+
+    meta_t meta;
+    std::ifstream file(path.string(), std::ios::in | std::ios::binary);
+    if (!file.read(reinterpret_cast<char*>(&meta), sizeof(meta)))
+    {
+      MERROR("Failed to read enote stream meta file " << path.string());
+      return false;
+    }
+    if (memcmp(meta.magic, ENOTE_STREAM_MAGIC, sizeof(meta.magic)) != 0 || meta.version != ENOTE_STREAM_VERSION)
+    {
+      MERROR(dir << " does not hold a version " << ENOTE_STREAM_VERSION << " enote stream");
+      return false;
+    }
+    if (meta.byte_order_mark != ENOTE_STREAM_BYTE_ORDER_MARK)
+    {
+      MERROR("Enote stream " << dir << " was written on a host with a different byte order");
+      return false;
+    }
+
+    found = true;
+    num_blocks = meta.num_blocks;
+    num_enotes = meta.num_enotes;
+    return true;
+  }
+
+  bool read_column_entry(const std::string &dir, const size_t id, const uint64_t index, void *entry)
+  {
+    std::ifstream file(column_path(dir, id), std::ios::in | std::ios::binary);
+    return file.seekg(index * s_columns[id].width) && file.read(reinterpret_cast<char*>(entry), s_columns[id].width);
+  }
+}
+
+namespace cryptonote
+{
+
+void get_enote_stream_enotes(const transaction &tx, const uint32_t tx_index, std::vector<enote_stream_enote> &enotes_inout)
+{
+  // a partially parsed extra still yields the fields before the bad one, as in the wallet
+  std::vector<tx_extra_field> fields;
+  parse_tx_extra(tx.extra, fields);
+
+  tx_extra_pub_key pub_key_field;
+  const crypto::public_key tx_pubkey = find_tx_extra_field_by_type(fields, pub_key_field) ? pub_key_field.pub_key : crypto::null_pkey;
+  tx_extra_additional_pub_keys additional_pub_keys;
+  find_tx_extra_field_by_type(fields, additional_pub_keys);
+
+  const uint8_t rct_type = tx.rct_signatures.type;
+  const bool cleartext = tx.version == 1 || rct_type == rct::RCTTypeNull;
+  const bool compact_amounts = rct_type == rct::RCTTypeBulletproof2 || rct_type == rct::RCTTypeCLSAG;
+
+  for (size_t i = 0; i < tx.vout.size(); ++i)
+  {
+    if (tx.vout[i].target.type() != typeid(txout_to_key))
+      continue;
+
+    enote_stream_enote enote;
+    enote.tx_pubkey = tx_pubkey;
+    enote.additional_pubkey = crypto::null_pkey;
+    enote.onetime_address = boost::get<txout_to_key>(tx.vout[i].target).key;
+    enote.amount = 0;
+    enote.tx_index = tx_index;
+    enote.output_index = i;
+    enote.view_tag = 0;
+    enote.flags = 0;
+
+    if (i < additional_pub_keys.data.size())
+    {
+      enote.additional_pubkey = additional_pub_keys.data[i];
+      enote.flags |= ENOTE_STREAM_HAS_ADDITIONAL_PUBKEY;
+    }
+
+    if (cleartext)
+    {
+      enote.amount = tx.vout[i].amount;
+      enote.flags |= ENOTE_STREAM_CLEARTEXT_AMOUNT;
+    }
+    else if (i < tx.rct_signatures.ecdhInfo.size())
+    {
+      // compact encodings are 8 bytes; older ones keep 32, of which a scanner only needs the low 8
+      memcpy(&enote.amount, tx.rct_signatures.ecdhInfo[i].amount.bytes, sizeof(enote.amount));
+      if (!compact_amounts)
+        enote.flags |= ENOTE_STREAM_LEGACY_ENCODED_AMOUNT;
+    }
+
+    enotes_inout.push_back(enote);
+  }
+}
+
+struct enote_stream_writer::column_file
+{
+  std::string path;
+  std::string pending;  //!< entries appended since the last commit
+};
+
+enote_stream_writer::enote_stream_writer():
+  m_committed_blocks(0),
+  m_committed_enotes(0),
+  m_kept_blocks(0),
+  m_kept_enotes(0),
+  m_num_blocks(0),
+  m_num_enotes(0)
+{
+}
+
+enote_stream_writer::~enote_stream_writer()
+{
+}
+
+bool enote_stream_writer::open(const std::string &dir)
+{
+  m_dir = dir;
+  m_columns.clear();
+
+  boost::system::error_code ec;
+  boost::filesystem::create_directories(dir, ec);
+  if (ec)
+  {
+    MERROR("Failed to create enote stream directory " << dir << ": " << ec.message());
+    return false;
+  }
+
+  bool found;
+  if (!read_meta(dir, found, m_committed_blocks, m_committed_enotes))
+    return false;
+
+  for (size_t id = 0; id < ENOTE_STREAM_NUM_COLUMNS; ++id)
+  {
+    std::unique_ptr<column_file> column(new column_file());
+    column->path = column_path(dir, id);
+
+    if (!boost::filesystem::exists(column->path, ec) && !std::ofstream(column->path, std::ios::out | std::ios::binary))
+    {
+      MERROR("Failed to create enote stream column " << column->path);
+      return false;
+    }
+
+    // drop whatever an interrupted commit left past the committed rows
+    const uint64_t size = boost::filesystem::file_size(column->path, ec);
+    const uint64_t committed_size = column_size(id, m_committed_blocks, m_committed_enotes);
+    if (ec || size < committed_size)
+    {
+      MERROR("Enote stream column " << column->path << " is shorter than its committed rows");
+      return false;
+    }
+    if (size > committed_size)
+    {
+      boost::filesystem::resize_file(column->path, committed_size, ec);
+      if (ec)
+      {
+        MERROR("Failed to truncate enote stream column " << column->path << ": " << ec.message());
+        return false;
+      }
+    }
+
+    m_columns.push_back(std::move(column));
+  }
+
+  if (!found && !write_meta(0, 0))
+    return false;
+
+  m_kept_blocks = m_num_blocks = m_committed_blocks;
+  m_kept_enotes = m_num_enotes = m_committed_enotes;
+  return true;
+}
+
+crypto::hash enote_stream_writer::get_block_hash(const uint64_t height) const
+{
+  if (height >= m_num_blocks)
+    throw std::out_of_range("Block height " + std::to_string(height) + " is not in the enote stream");
+
+  crypto::hash hash;
+  if (height >= m_kept_blocks)
+  {
+    memcpy(&hash, m_columns[ENOTE_STREAM_BLOCK_HASHES]->pending.data() + (height - m_kept_blocks) * sizeof(hash), sizeof(hash));
+  }
+  else if (!read_column_entry(m_dir, ENOTE_STREAM_BLOCK_HASHES, height, &hash))
+  {
+    throw std::runtime_error("Failed to read block hash " + std::to_string(height) + " from the enote stream");
+  }
+  return hash;
+}
+
+void enote_stream_writer::append_block(const crypto::hash &block_hash, const std::vector<enote_stream_enote> &enotes)
+{
+  const auto append = [this](const size_t id, const void *entry)
+  {
+    m_columns[id]->pending.append(reinterpret_cast<const char*>(entry), s_columns[id].width);
+  };
+
+  for (const enote_stream_enote &enote: enotes)
+  {
+    append(ENOTE_STREAM_TX_PUBKEYS, &enote.tx_pubkey);
+    append(ENOTE_STREAM_ADDITIONAL_PUBKEYS, &enote.additional_pubkey);
+    append(ENOTE_STREAM_ONETIME_ADDRESSES, &enote.onetime_address);
+    append(ENOTE_STREAM_AMOUNTS, &enote.amount);
+    append(ENOTE_STREAM_TX_INDICES, &enote.tx_index);
+    append(ENOTE_STREAM_OUTPUT_INDICES, &enote.output_index);
+    append(ENOTE_STREAM_VIEW_TAGS, &enote.view_tag);
+    append(ENOTE_STREAM_FLAGS, &enote.flags);
+  }
+  append(ENOTE_STREAM_BLOCK_HASHES, &block_hash);
+  append(ENOTE_STREAM_BLOCK_OFFSETS, &m_num_enotes);
+
+  ++m_num_blocks;
+  m_num_enotes += enotes.size();
+}
+
+void enote_stream_writer::truncate(const uint64_t num_blocks)
+{
+  if (num_blocks >= m_num_blocks)
+    return;
+
+  if (num_blocks >= m_kept_blocks)
+  {
+    // only buffered blocks go
+    memcpy(&m_num_enotes, m_columns[ENOTE_STREAM_BLOCK_OFFSETS]->pending.data() + (num_blocks - m_kept_blocks) * sizeof(uint64_t), sizeof(uint64_t));
+  }
+  else
+  {
+    uint64_t num_enotes;
+    if (!read_column_entry(m_dir, ENOTE_STREAM_BLOCK_OFFSETS, num_blocks, &num_enotes))
+      throw std::runtime_error("Failed to read block offset " + std::to_string(num_blocks) + " from the enote stream");
+    m_kept_blocks = num_blocks;
+    m_kept_enotes = num_enotes;
+    m_num_enotes = num_enotes;
+  }
+  m_num_blocks = num_blocks;
+
+  for (size_t id = 0; id < ENOTE_STREAM_NUM_COLUMNS; ++id)
+    m_columns[id]->pending.resize(column_size(id, m_num_blocks - m_kept_blocks, m_num_enotes - m_kept_enotes));
+}
+
+bool enote_stream_writer::commit()
+{
+  // publish a truncation before rewriting the columns, so the meta file never covers bytes being rewritten
+  if (m_kept_blocks < m_committed_blocks)
+  {
+    if (!write_meta(m_kept_blocks, m_kept_enotes))
+      return false;
+    m_committed_blocks = m_kept_blocks;
+    m_committed_enotes = m_kept_enotes;
+  }
+
+  for (size_t id = 0; id < ENOTE_STREAM_NUM_COLUMNS; ++id)
+  {
+    column_file &column = *m_columns[id];
+
+    // also drops anything a failed commit left behind
+    boost::system::error_code ec;
+    boost::filesystem::resize_file(column.path, column_size(id, m_committed_blocks, m_committed_enotes), ec);
+    if (ec)
+    {
+      MERROR("Failed to truncate enote stream column " << column.path << ": " << ec.message());
+      return false;
+    }
+
+    std::ofstream file(column.path, std::ios::out | std::ios::binary | std::ios::app);
+    if (!file.write(column.pending.data(), column.pending.size()) || !file.flush())
+    {
+      MERROR("Failed to write enote stream column " << column.path);
+      return false;
+    }
+  }
+
+  if (!write_meta(m_num_blocks, m_num_enotes))
+    return false;
+
+  for (const std::unique_ptr<column_file> &column: m_columns)
+    column->pending.clear();
+  m_committed_blocks = m_kept_blocks = m_num_blocks;
+  m_committed_enotes = m_kept_enotes = m_num_enotes;
+  return true;
+}
+
+bool enote_stream_writer::write_meta(const uint64_t num_blocks, const uint64_t num_enotes) const
+{
+  meta_t meta;
+  memcpy(meta.magic, ENOTE_STREAM_MAGIC, sizeof(meta.magic));
+  meta.version = ENOTE_STREAM_VERSION;
+  meta.byte_order_mark = ENOTE_STREAM_BYTE_ORDER_MARK;
+  meta.num_blocks = num_blocks;
+  meta.num_enotes = num_enotes;
+
+  // write aside and rename over, so readers see either the old or the new counts
+  const boost::filesystem::path path = boost::filesystem::path(m_dir) / ENOTE_STREAM_META_FILE;
+  const boost::filesystem::path tmp_path = boost::filesystem::path(m_dir) / ENOTE_STREAM_META_FILE ".new";
+  {
+    std::ofstream file(tmp_path.string(), std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!file.write(reinterpret_cast<const char*>(&meta), sizeof(meta)) || !file.flush())
+    {
+      MERROR("Failed to write enote stream meta file " << tmp_path.string());
+      return false;
+    }
+  }
+
+  boost::system::error_code ec;
+  boost::filesystem::rename(tmp_path, path, ec);
+  if (ec)
+  {
+    MERROR("Failed to replace enote stream meta file " << path.string() << ": " << ec.message());
+    return false;
+  }
+  return true;
+}
+
+int64_t update_enote_stream(enote_stream_writer &writer, const BlockchainDB &db, const uint64_t stop_height)
+{
+  try
+  {
+    const uint64_t db_height = db.height();
+    const uint64_t end_height = stop_height ? std::min(stop_height, db_height) : db_height;
+
+    // walk back to the last block both still agree on
+    uint64_t height = writer.num_blocks();
+    while (height > 0 && (height > db_height || writer.get_block_hash(height - 1) != db.get_block_hash_from_height(height - 1)))
+      --height;
+    if (height < writer.num_blocks())
+    {
+      MINFO("Dropping " << writer.num_blocks() - height << " blocks that are no longer in the blockchain");
+      writer.truncate(height);
+    }
+
+    const uint64_t start_height = height;
+    std::vector<enote_stream_enote> enotes;
+    for (; height < end_height; ++height)
+    {
+      const block b = db.get_block_from_height(height);
+
+      enotes.clear();
+      get_enote_stream_enotes(b.miner_tx, 0, enotes);
+      for (size_t i = 0; i < b.tx_hashes.size(); ++i)
+      {
+        transaction tx;
+        if (!db.get_pruned_tx(b.tx_hashes[i], tx))
+        {
+          MERROR("Tx " << b.tx_hashes[i] << " from block " << height << " not found in the blockchain");
+          return -1;
+        }
+        get_enote_stream_enotes(tx, i + 1, enotes);
+      }
+      writer.append_block(db.get_block_hash_from_height(height), enotes);
+
+      if ((height + 1) % ENOTE_STREAM_COMMIT_INTERVAL == 0)
+      {
+        if (!writer.commit())
+          return -1;
+        MINFO("Enote stream at height " << height + 1 << "/" << end_height << ", " << writer.num_enotes() << " enotes");
+      }
+    }
+
+    if (!writer.commit())
+      return -1;
+    return height - start_height;
+  }
+  catch (const std::exception &e)
+  {
+    MERROR("Failed to update enote stream: " << e.what());
+    return -1;
+  }
+}
+
+struct enote_stream_reader::mapped_column
+{
+  mapped_column(const std::string &path, const uint64_t size):
+    file(path.c_str(), boost::interprocess::read_only),
+    region(file, boost::interprocess::read_only, 0, size)
+  {
+  }
+
+  boost::interprocess::file_mapping file;
+  boost::interprocess::mapped_region region;
+};
+
+enote_stream_reader::enote_stream_reader():
+  m_data(),
+  m_num_blocks(0),
+  m_num_enotes(0)
+{
+}
+
+enote_stream_reader::~enote_stream_reader()
+{
+}
+
+bool enote_stream_reader::open(const std::string &dir)
+{
+  m_mappings.clear();
+  std::fill(std::begin(m_data), std::end(m_data), nullptr);
+  m_num_blocks = 0;
+  m_num_enotes = 0;
+
+  bool found;
+  uint64_t num_blocks, num_enotes;
+  if (!read_meta(dir, found, num_blocks, num_enotes))
+    return false;
+  if (!found)
+  {
+    MERROR("No enote stream in " << dir);
+    return false;
+  }
+
+  for (size_t id = 0; id < ENOTE_STREAM_NUM_COLUMNS; ++id)
+  {
+    const uint64_t size = column_size(id, num_blocks, num_enotes);
+    if (size == 0)
+      continue;
+
+    const std::string path = column_path(dir, id);
+    boost::system::error_code ec;
+    if (boost::filesystem::file_size(path, ec) < size || ec)
+    {
+      MERROR("Enote stream column " << path << " is shorter than its committed rows");
+      m_mappings.clear();
+      std::fill(std::begin(m_data), std::end(m_data), nullptr);
+      return false;
+    }
+
+    try
+    {
+      m_mappings.emplace_back(new mapped_column(path, size));
+    }
+    catch (const std::exception &e)
+    {
+      MERROR("Failed to map enote stream column " << path << ": " << e.what());
+      m_mappings.clear();
+      std::fill(std::begin(m_data), std::end(m_data), nullptr);
+      return false;
+    }
+    m_data[id] = m_mappings.back()->region.get_address();
+  }
+
+  m_num_blocks = num_blocks;
+  m_num_enotes = num_enotes;
+  return true;
+}
+
+std::pair<uint64_t, uint64_t> enote_stream_reader::get_block_enotes(const uint64_t height) const
+{
+  if (height >= m_num_blocks)
+    throw std::out_of_range("Block height " + std::to_string(height) + " is not in the enote stream");
+  const uint64_t end = height + 1 < m_num_blocks ? block_offsets()[height + 1] : m_num_enotes;
+  return std::make_pair(block_offsets()[height], end);
+}
+
+enote_stream_enote enote_stream_reader::get_enote(const uint64_t index) const
+{
+  if (index >= m_num_enotes)
+    throw std::out_of_range("Enote " + std::to_string(index) + " is not in the enote stream");
+
+  enote_stream_enote enote;
+  enote.tx_pubkey = tx_pubkeys()[index];
+  enote.additional_pubkey = additional_pubkeys()[index];
+  enote.onetime_address = onetime_addresses()[index];
+  enote.amount = amounts()[index];
+  enote.tx_index = tx_indices()[index];
+  enote.output_index = output_indices()[index];
+  enote.view_tag = view_tags()[index];
+  enote.flags = flags()[index];
+  return enote;
+}
+
+}  // namespace cryptonote
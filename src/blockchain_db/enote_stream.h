@@ -0,0 +1,238 @@
+// Copyright (c) 2021, The Monero Project
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of
+//    conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list
+//    of conditions and the following disclaimer in the documentation and/or other
+//    materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be
+//    used to endorse or promote products derived from this software without specific
+//    prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+// THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include "crypto/crypto.h"
+#include "crypto/hash.h"
+#include "cryptonote_basic/cryptonote_basic.h"
+
+/** \file
+ * Enote stream: the scan-relevant fields of every output on the chain, stored column by column
+ *
+ * A stream is a directory holding one flat file per column plus a small meta file. Each enote
+ * column has one fixed-width entry per output, in ledger order (block, then tx, then output), so a
+ * scanner can map the columns and read them in place without deserializing any transaction.
+ * Per-block columns hold each block's hash (to detect reorgs) and the index of its first enote.
+ *
+ * The meta file holds the committed counts and is rewritten atomically after the columns are
+ * written, so bytes past the committed counts (e.g. from an interrupted update) are ignored and
+ * cut off on the next open. Integers are stored in host byte order; the meta file records a
+ * byte-order marker so a stream moved to a host of the other endianness is refused.
+ */
+
+namespace cryptonote
+{
+
+class BlockchainDB;
+
+/**
+ * @brief bits of the per-enote flags column
+ */
+enum enote_stream_flags : uint8_t
+{
+  ENOTE_STREAM_HAS_ADDITIONAL_PUBKEY = 1,  //!< the additional pubkeys column holds this output's R_t
+  ENOTE_STREAM_HAS_VIEW_TAG = 2,           //!< the view tags column is meaningful for this output
+  ENOTE_STREAM_CLEARTEXT_AMOUNT = 4,       //!< the amounts column holds the cleartext amount
+  ENOTE_STREAM_LEGACY_ENCODED_AMOUNT = 8,  //!< the amounts column holds the first 8 bytes of a 32-byte encoded amount
+};
+
+/**
+ * @brief the columns of an enote stream; the first ENOTE_STREAM_NUM_ENOTE_COLUMNS have one entry per enote,
+ * the rest one entry per block
+ */
+enum enote_stream_column
+{
+  ENOTE_STREAM_TX_PUBKEYS,
+  ENOTE_STREAM_ADDITIONAL_PUBKEYS,
+  ENOTE_STREAM_ONETIME_ADDRESSES,
+  ENOTE_STREAM_AMOUNTS,
+  ENOTE_STREAM_TX_INDICES,
+  ENOTE_STREAM_OUTPUT_INDICES,
+  ENOTE_STREAM_VIEW_TAGS,
+  ENOTE_STREAM_FLAGS,
+  ENOTE_STREAM_NUM_ENOTE_COLUMNS,
+  ENOTE_STREAM_BLOCK_HASHES = ENOTE_STREAM_NUM_ENOTE_COLUMNS,
+  ENOTE_STREAM_BLOCK_OFFSETS,
+  ENOTE_STREAM_NUM_COLUMNS
+};
+
+/**
+ * @brief one row of an enote stream
+ */
+struct enote_stream_enote
+{
+  crypto::public_key tx_pubkey;          //!< R (null_pkey if the tx has none)
+  crypto::public_key additional_pubkey;  //!< R_t (null_pkey if the tx has no additional pubkeys)
+  crypto::public_key onetime_address;    //!< Ko_t
+  uint64_t amount;                       //!< cleartext or encoded amount, see the flags
+  uint32_t tx_index;                     //!< 0 for the miner tx, i + 1 for the block's tx i
+  uint32_t output_index;                 //!< t
+  uint8_t view_tag;
+  uint8_t flags;                         //!< enote_stream_flags
+};
+
+/**
+ * @brief collect the enotes of a tx, in output order
+ *
+ * Outputs that are not to a key (none exist on the main chains) are skipped, so a tx may add
+ * fewer rows than it has outputs; output_index is always the position in the tx's vout.
+ */
+void get_enote_stream_enotes(const transaction &tx, const uint32_t tx_index, std::vector<enote_stream_enote> &enotes_inout);
+
+/**
+ * @brief appends blocks to an enote stream directory
+ *
+ * Appended and truncated blocks are buffered until commit(). Committing appends is safe while
+ * readers have the stream open; committing a truncation (a reorg) shrinks the column files, so
+ * open readers must reopen before touching the dropped rows.
+ */
+class enote_stream_writer
+{
+public:
+  enote_stream_writer();
+  ~enote_stream_writer();
+
+  /**
+   * @brief open (creating if needed) the stream in a directory
+   *
+   * @return false if the directory can't be created or holds a stream that can't be used
+   */
+  bool open(const std::string &dir);
+
+  uint64_t num_blocks() const { return m_num_blocks; }
+  uint64_t num_enotes() const { return m_num_enotes; }
+
+  /**
+   * @brief get the hash of a block in the stream (including uncommitted blocks)
+   */
+  crypto::hash get_block_hash(const uint64_t height) const;
+
+  /**
+   * @brief append the next block's enotes
+   */
+  void append_block(const crypto::hash &block_hash, const std::vector<enote_stream_enote> &enotes);
+
+  /**
+   * @brief drop every block at or above a height
+   */
+  void truncate(const uint64_t num_blocks);
+
+  /**
+   * @brief write the buffered changes and publish the new counts
+   *
+   * @return false on an I/O error; the stream then stays at its previous committed state
+   */
+  bool commit();
+
+private:
+  struct column_file;
+
+  bool write_meta(const uint64_t num_blocks, const uint64_t num_enotes) const;
+
+  std::string m_dir;
+  std::vector<std::unique_ptr<column_file>> m_columns;
+
+  uint64_t m_committed_blocks;  //!< counts in the meta file
+  uint64_t m_committed_enotes;
+  uint64_t m_kept_blocks;       //!< committed rows that survive the buffered truncation
+  uint64_t m_kept_enotes;
+  uint64_t m_num_blocks;        //!< counts including buffered rows
+  uint64_t m_num_enotes;
+};
+
+/**
+ * @brief bring an enote stream up to date with a blockchain
+ *
+ * Blocks the DB no longer has (a reorg since the last update) are dropped first, then blocks
+ * are appended up to stop_height (0 = the DB's height), committing every few thousand blocks
+ * so an interrupted update keeps most of its work.
+ *
+ * @return the number of blocks appended, or -1 on error
+ */
+int64_t update_enote_stream(enote_stream_writer &writer, const BlockchainDB &db, const uint64_t stop_height = 0);
+
+/**
+ * @brief read-only view of an enote stream, with every column memory mapped
+ *
+ * The column pointers stay valid until the reader is destroyed or reopened, and are null for
+ * empty columns. Rows a writer commits after open() are not visible until the next open().
+ */
+class enote_stream_reader
+{
+public:
+  enote_stream_reader();
+  ~enote_stream_reader();
+
+  /**
+   * @brief map the committed part of the stream in a directory
+   */
+  bool open(const std::string &dir);
+
+  uint64_t num_blocks() const { return m_num_blocks; }
+  uint64_t num_enotes() const { return m_num_enotes; }
+
+  const crypto::public_key *tx_pubkeys() const { return column<crypto::public_key>(ENOTE_STREAM_TX_PUBKEYS); }
+  const crypto::public_key *additional_pubkeys() const { return column<crypto::public_key>(ENOTE_STREAM_ADDITIONAL_PUBKEYS); }
+  const crypto::public_key *onetime_addresses() const { return column<crypto::public_key>(ENOTE_STREAM_ONETIME_ADDRESSES); }
+  const uint64_t *amounts() const { return column<uint64_t>(ENOTE_STREAM_AMOUNTS); }
+  const uint32_t *tx_indices() const { return column<uint32_t>(ENOTE_STREAM_TX_INDICES); }
+  const uint32_t *output_indices() const { return column<uint32_t>(ENOTE_STREAM_OUTPUT_INDICES); }
+  const uint8_t *view_tags() const { return column<uint8_t>(ENOTE_STREAM_VIEW_TAGS); }
+  const uint8_t *flags() const { return column<uint8_t>(ENOTE_STREAM_FLAGS); }
+  const crypto::hash *block_hashes() const { return column<crypto::hash>(ENOTE_STREAM_BLOCK_HASHES); }
+  const uint64_t *block_offsets() const { return column<uint64_t>(ENOTE_STREAM_BLOCK_OFFSETS); }
+
+  /**
+   * @brief get the half-open range of enote indices created in a block
+   */
+  std::pair<uint64_t, uint64_t> get_block_enotes(const uint64_t height) const;
+
+  /**
+   * @brief copy one row out of the columns
+   */
+  enote_stream_enote get_enote(const uint64_t index) const;
+
+private:
+  struct mapped_column;
+
+  template <typename T>
+  const T *column(const enote_stream_column id) const { return reinterpret_cast<const T*>(m_data[id]); }
+
+  std::vector<std::unique_ptr<mapped_column>> m_mappings;
+  const void *m_data[ENOTE_STREAM_NUM_COLUMNS];
+  uint64_t m_num_blocks;
+  uint64_t m_num_enotes;
+};
+
+}  // namespace cryptonote
@@ -0,0 +1,158 @@
+// Copyright (c) 2021, The Monero Project
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of
+//    conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list
+//    of conditions and the following disclaimer in the documentation and/or other
+//    materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be
+//    used to endorse or promote products derived from this software without specific
+//    prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+// THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include <cstring>
+#include "key_image_filter.h"
+
+namespace
+{
+  // splitmix64 finalizer
+  inline uint64_t mix64(uint64_t x)
+  {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ull;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebull;
+    x ^= x >> 31;
+    return x;
+  }
+}
+
+namespace cryptonote
+{
+
+key_image_filter::key_image_filter():
+  m_num_blocks(0),
+  m_salt(crypto::rand<uint64_t>()),
+  m_ready(false),
+  m_num_keys(0),
+  m_lookups(0),
+  m_negatives(0),
+  m_false_positives(0),
+  m_filter_ns(0),
+  m_filter_samples(0),
+  m_db_ns(0),
+  m_db_samples(0)
+{
+}
+
+void key_image_filter::reset(size_t bytes)
+{
+  m_ready = false;
+  m_num_blocks = bytes / (WORDS_PER_BLOCK * sizeof(uint64_t));
+  m_words.reset(m_num_blocks ? new std::atomic<uint64_t>[m_num_blocks * WORDS_PER_BLOCK] : NULL);
+  for (size_t i = 0; i < m_num_blocks * WORDS_PER_BLOCK; ++i)
+    m_words[i].store(0, std::memory_order_relaxed);
+  m_num_keys = 0;
+  m_lookups = 0;
+  m_negatives = 0;
+  m_false_positives = 0;
+  m_filter_ns = 0;
+  m_filter_samples = 0;
+  m_db_ns = 0;
+  m_db_samples = 0;
+}
+
+void key_image_filter::locate(const crypto::key_image &ki, size_t &block, uint64_t &bits) const
+{
+  // the salt keeps anyone from picking key images that all land in the same block
+  uint64_t w[4];
+  static_assert(sizeof(w) == sizeof(ki), "Unexpected key image size");
+  memcpy(w, &ki, sizeof(w));
+  const uint64_t h1 = mix64(w[0] ^ m_salt);
+  const uint64_t h2 = mix64(w[1] ^ w[2] ^ w[3] ^ h1);
+  block = h1 % m_num_blocks;
+  bits = h2;
+}
+
+void key_image_filter::add(const crypto::key_image &ki)
+{
+  if (!m_num_blocks)
+    return;
+  size_t block;
+  uint64_t bits;
+  locate(ki, block, bits);
+  std::atomic<uint64_t> *words = &m_words[block * WORDS_PER_BLOCK];
+  for (size_t i = 0; i < WORDS_PER_BLOCK; ++i)
+    words[i].fetch_or(1ull << ((bits >> (6 * i)) & 63), std::memory_order_relaxed);
+  ++m_num_keys;
+}
+
+bool key_image_filter::may_contain(const crypto::key_image &ki) const
+{
+  m_lookups.fetch_add(1, std::memory_order_relaxed);
+  size_t block;
+  uint64_t bits;
+  locate(ki, block, bits);
+  const std::atomic<uint64_t> *words = &m_words[block * WORDS_PER_BLOCK];
+  for (size_t i = 0; i < WORDS_PER_BLOCK; ++i)
+  {
+    if (!(words[i].load(std::memory_order_relaxed) & (1ull << ((bits >> (6 * i)) & 63))))
+    {
+      m_negatives.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+  }
+  return true;
+}
+
+void key_image_filter::record_db_lookup(bool found)
+{
+  if (!found)
+    m_false_positives.fetch_add(1, std::memory_order_relaxed);
+}
+
+void key_image_filter::record_filter_timing(uint64_t ns)
+{
+  m_filter_ns.fetch_add(ns, std::memory_order_relaxed);
+  m_filter_samples.fetch_add(1, std::memory_order_relaxed);
+}
+
+void key_image_filter::record_db_timing(uint64_t ns)
+{
+  m_db_ns.fetch_add(ns, std::memory_order_relaxed);
+  m_db_samples.fetch_add(1, std::memory_order_relaxed);
+}
+
+key_image_filter_stats key_image_filter::get_stats() const
+{
+  key_image_filter_stats stats;
+  stats.memory_bytes = m_num_blocks * WORDS_PER_BLOCK * sizeof(uint64_t);
+  stats.num_keys = m_num_keys.load(std::memory_order_relaxed);
+  stats.lookups = m_lookups.load(std::memory_order_relaxed);
+  stats.negatives = m_negatives.load(std::memory_order_relaxed);
+  stats.false_positives = m_false_positives.load(std::memory_order_relaxed);
+  stats.filter_ns = m_filter_ns.load(std::memory_order_relaxed);
+  stats.filter_samples = m_filter_samples.load(std::memory_order_relaxed);
+  stats.db_ns = m_db_ns.load(std::memory_order_relaxed);
+  stats.db_samples = m_db_samples.load(std::memory_order_relaxed);
+  return stats;
+}
+
+}  // namespace cryptonote
@@ -0,0 +1,140 @@
+// Copyright (c) 2021, The Monero Project
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of
+//    conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list
+//    of conditions and the following disclaimer in the documentation and/or other
+//    materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be
+//    used to endorse or promote products derived from this software without specific
+//    prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+// THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include "crypto/crypto.h"
+
+/** \file
+ * Key image filter: an in-memory blocked Bloom filter over the spent key images
+ *
+ * Most spent key checks (e.g. for incoming pool txes) are for key images that are not spent, and
+ * each of those would otherwise cost a B-tree search in the database. The filter answers "not
+ * spent" for most of them from memory; "maybe spent" still goes to the database, so the filter
+ * never changes an answer. Each key image sets one bit in each 64 bit word of a single 64 byte
+ * block, so a lookup touches one cache line.
+ *
+ * Key images can't be removed from a Bloom filter, so popped blocks leave their bits set, which
+ * only makes the filter a little less selective until it is next rebuilt.
+ */
+
+namespace cryptonote
+{
+
+/**
+ * @brief usage counters of a key image filter
+ */
+struct key_image_filter_stats
+{
+  uint64_t memory_bytes;     //!< size of the filter
+  uint64_t num_keys;         //!< key images added since it was built
+  uint64_t lookups;          //!< key images looked up
+  uint64_t negatives;        //!< lookups answered by the filter alone
+  uint64_t false_positives;  //!< lookups the filter passed on, but that were not in the database
+  uint64_t filter_ns;        //!< time spent in sampled filter lookups
+  uint64_t filter_samples;   //!< number of filter lookups timed
+  uint64_t db_ns;            //!< time spent in sampled database lookups behind the filter
+  uint64_t db_samples;       //!< number of database lookups timed
+
+  //! fraction of lookups of unspent key images which the filter could not answer
+  double false_positive_rate() const
+  {
+    return negatives + false_positives ? false_positives / (double)(negatives + false_positives) : 0.0;
+  }
+};
+
+class key_image_filter
+{
+public:
+  key_image_filter();
+
+  /**
+   * @brief drops all key images and resizes the filter
+   *
+   * @param bytes memory to use, rounded down to a whole number of blocks; 0 disables the filter
+   */
+  void reset(size_t bytes);
+
+  //! whether the filter holds every spent key image, and so may be asked
+  bool ready() const { return m_ready.load(std::memory_order_acquire); }
+
+  //! marks the filter as holding every spent key image (or not, e.g. while it is rebuilt)
+  void set_ready(bool ready) { m_ready.store(ready && m_num_blocks > 0, std::memory_order_release); }
+
+  /**
+   * @brief adds a key image; safe to call while other threads look key images up
+   */
+  void add(const crypto::key_image &ki);
+
+  /**
+   * @brief checks whether a key image may have been added
+   *
+   * @return false if the key image was certainly never added
+   */
+  bool may_contain(const crypto::key_image &ki) const;
+
+  //! records the outcome of a database lookup done after may_contain returned true
+  void record_db_lookup(bool found);
+
+  //! whether the next lookup should be timed (lookups are sampled to keep timing cheap)
+  bool sample_timing() const { return (m_lookups.load(std::memory_order_relaxed) & (TIMING_SAMPLE_INTERVAL - 1)) == 0; }
+
+  //! records the time of a sampled filter lookup
+  void record_filter_timing(uint64_t ns);
+
+  //! records the time of a sampled database lookup done after may_contain returned true
+  void record_db_timing(uint64_t ns);
+
+  key_image_filter_stats get_stats() const;
+
+private:
+  static constexpr size_t WORDS_PER_BLOCK = 8;
+  static constexpr uint64_t TIMING_SAMPLE_INTERVAL = 64;
+
+  void locate(const crypto::key_image &ki, size_t &block, uint64_t &bits) const;
+
+  std::unique_ptr<std::atomic<uint64_t>[]> m_words;
+  size_t m_num_blocks;
+  uint64_t m_salt;
+  std::atomic<bool> m_ready;
+  std::atomic<uint64_t> m_num_keys;
+  mutable std::atomic<uint64_t> m_lookups;
+  mutable std::atomic<uint64_t> m_negatives;
+  std::atomic<uint64_t> m_false_positives;
+  std::atomic<uint64_t> m_filter_ns;
+  std::atomic<uint64_t> m_filter_samples;
+  std::atomic<uint64_t> m_db_ns;
+  std::atomic<uint64_t> m_db_samples;
+};
+
+}  // namespace cryptonote
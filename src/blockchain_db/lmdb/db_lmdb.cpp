@@ -37,6 +37,7 @@
 #include <boost/filesystem.hpp>
 #include <boost/format.hpp>
 #include <boost/circular_buffer.hpp>
+#include <algorithm>
 #include <memory>  // std::unique_ptr
 #include <cstring>  // memcpy
 
@@ -44,6 +45,8 @@
 #include "file_io_utils.h"
 #include "common/util.h"
 #include "common/pruning.h"
+#include "common/metrics.h"
+#include "common/threadpool.h"
 #include "cryptonote_basic/cryptonote_format_utils.h"
 #include "crypto/crypto.h"
 #include "profile_tools.h"
@@ -139,6 +142,18 @@ private:
   std::unique_ptr<char[]> data;
 };
 
+tools::MetricsHistogram lmdb_write_txn_seconds("monero_lmdb_write_txn_seconds",
+  "Lifetime of committed LMDB write txns (batch or per block), from begin to the end of the commit", 1e-9);
+tools::MetricsHistogram lmdb_write_txn_commit_seconds("monero_lmdb_write_txn_commit_seconds",
+  "Duration of LMDB write txn commits", 1e-9);
+
+void record_write_txn_commit(uint64_t txn_start_ns, uint64_t commit_start_ns)
+{
+  const uint64_t now_ns = epee::misc_utils::get_ns_count();
+  lmdb_write_txn_seconds.add(now_ns - txn_start_ns);
+  lmdb_write_txn_commit_seconds.add(now_ns - commit_start_ns);
+}
+
 }
 
 namespace cryptonote
@@ -193,6 +208,7 @@ namespace
  * blocks           block ID     block blob
  * block_heights    block hash   block height
  * block_info       block ID     {block metadata}
+ * block_undo       block ID     {undo log header, [txn hashes], [spent keys], [output amounts]}
  *
  * txs_pruned       txn ID       pruned txn blob
  * txs_prunable     txn ID       prunable txn blob
@@ -222,6 +238,7 @@ namespace
 const char* const LMDB_BLOCKS = "blocks";
 const char* const LMDB_BLOCK_HEIGHTS = "block_heights";
 const char* const LMDB_BLOCK_INFO = "block_info";
+const char* const LMDB_BLOCK_UNDO = "block_undo";
 
 const char* const LMDB_TXS = "txs";
 const char* const LMDB_TXS_PRUNED = "txs_pruned";
@@ -261,6 +278,22 @@ inline void lmdb_db_open(MDB_txn* txn, const char* name, int flags, MDB_dbi& dbi
 }
 
 
+// delete the records of a uint64 keyed table whose keys are at least first_key (the last records of the table)
+void delete_key_tail(MDB_cursor *cur, uint64_t first_key, const char *table)
+{
+  MDB_val k, v;
+  int result;
+  while ((result = mdb_cursor_get(cur, &k, &v, MDB_LAST)) == 0)
+  {
+    if (*(const uint64_t *)k.mv_data < first_key)
+      return;
+    if ((result = mdb_cursor_del(cur, MDB_NODUPDATA)))
+      throw0(cryptonote::DB_ERROR(lmdb_error(std::string("Failed to add removal from ") + table + " to db transaction: ", result).c_str()));
+  }
+  if (result != MDB_NOTFOUND)
+    throw0(cryptonote::DB_ERROR(lmdb_error(std::string("Failed to locate last record of ") + table + ": ", result).c_str()));
+}
+
 }  // anonymous namespace
 
 #define CURSOR(name) \
@@ -358,6 +391,17 @@ typedef struct outtx {
     uint64_t local_index;
 } outtx;
 
+// what adding a block wrote, so popping it can remove that from the ends of the tables
+// (followed by bu_num_txs tx hashes, bu_num_spent_keys key images and bu_num_outputs output amounts)
+typedef struct mdb_block_undo {
+    crypto::hash bu_hash;
+    uint64_t bu_first_tx_id;
+    uint64_t bu_first_output_id;
+    uint32_t bu_num_txs;
+    uint32_t bu_num_spent_keys;
+    uint64_t bu_num_outputs;
+} mdb_block_undo;
+
 std::atomic<uint64_t> mdb_txn_safe::num_active_txns{0};
 std::atomic_flag mdb_txn_safe::creation_gate = ATOMIC_FLAG_INIT;
 
@@ -822,6 +866,8 @@ void BlockchainLMDB::add_block(const block& blk, size_t block_weight, uint64_t l
   if (result)
     throw0(DB_ERROR(lmdb_error("Failed to add block height by hash to db transaction: ", result).c_str()));
 
+  write_block_undo(m_height, blk_hash);
+
   // we use weight as a proxy for size, since we don't have size but weight is >= size
   // and often actually equal
   m_cum_size += block_weight;
@@ -905,6 +951,13 @@ uint64_t BlockchainLMDB::add_transaction_data(const crypto::hash& blk_hash, cons
   if (result)
     throw0(DB_ERROR(lmdb_error("Failed to add tx data to db transaction: ", result).c_str()));
 
+  if (m_undo_log_depth)
+  {
+    if (m_block_undo_builder.tx_hashes.empty())
+      m_block_undo_builder.first_tx_id = tx_id;
+    m_block_undo_builder.tx_hashes.push_back(tx_hash);
+  }
+
   const cryptonote::blobdata_ref &blob = txp.second;
 
   unsigned int unprunable_size = tx.unprunable_size;
@@ -1091,6 +1144,13 @@ uint64_t BlockchainLMDB::add_output(const crypto::hash& tx_hash,
   if ((result = mdb_cursor_put(m_cur_output_amounts, &val_amount, &data, MDB_APPENDDUP)))
       throw0(DB_ERROR(lmdb_error("Failed to add output pubkey to db transaction: ", result).c_str()));
 
+  if (m_undo_log_depth)
+  {
+    if (m_block_undo_builder.output_amounts.empty())
+      m_block_undo_builder.first_output_id = m_num_outputs;
+    m_block_undo_builder.output_amounts.push_back(tx_output.amount);
+  }
+
   return ok.amount_index;
 }
 
@@ -1247,6 +1307,13 @@ void BlockchainLMDB::add_spent_key(const crypto::key_image& k_image)
     else
       throw1(DB_ERROR(lmdb_error("Error adding spent key image to db transaction: ", result).c_str()));
   }
+
+  if (m_undo_log_depth)
+    m_block_undo_builder.spent_keys.push_back(k_image);
+
+  // added before the txn commits, so readers never see a spent key the filter misses
+  // (if the txn is aborted, the key's bits just stay set)
+  m_spent_key_filter.add(k_image);
 }
 
 void BlockchainLMDB::remove_spent_key(const crypto::key_image& k_image)
@@ -1269,6 +1336,169 @@ void BlockchainLMDB::remove_spent_key(const crypto::key_image& k_image)
   }
 }
 
+void BlockchainLMDB::write_block_undo(uint64_t block_height, const crypto::hash& blk_hash)
+{
+  LOG_PRINT_L3("BlockchainLMDB::" << __func__);
+  mdb_txn_cursors *m_cursors = &m_wcursors;
+  CURSOR(block_undo)
+
+  int result;
+  if (m_undo_log_depth)
+  {
+    const block_undo_builder &builder = m_block_undo_builder;
+    mdb_block_undo bu;
+    bu.bu_hash = blk_hash;
+    bu.bu_first_tx_id = builder.tx_hashes.empty() ? get_tx_count() : builder.first_tx_id;
+    bu.bu_first_output_id = builder.output_amounts.empty() ? num_outputs() : builder.first_output_id;
+    bu.bu_num_txs = builder.tx_hashes.size();
+    bu.bu_num_spent_keys = builder.spent_keys.size();
+    bu.bu_num_outputs = builder.output_amounts.size();
+
+    const size_t tx_hashes_size = builder.tx_hashes.size() * sizeof(crypto::hash);
+    const size_t spent_keys_size = builder.spent_keys.size() * sizeof(crypto::key_image);
+    const size_t output_amounts_size = builder.output_amounts.size() * sizeof(uint64_t);
+    std::string record(sizeof(bu) + tx_hashes_size + spent_keys_size + output_amounts_size, '\0');
+    char *p = &record[0];
+    memcpy(p, &bu, sizeof(bu));
+    p += sizeof(bu);
+    memcpy(p, builder.tx_hashes.data(), tx_hashes_size);
+    p += tx_hashes_size;
+    memcpy(p, builder.spent_keys.data(), spent_keys_size);
+    p += spent_keys_size;
+    memcpy(p, builder.output_amounts.data(), output_amounts_size);
+
+    MDB_val_set(key, block_height);
+    MDB_val_sized(val, record);
+    if ((result = mdb_cursor_put(m_cur_block_undo, &key, &val, 0)))
+      throw0(DB_ERROR(lmdb_error("Failed to add block undo log to db transaction: ", result).c_str()));
+  }
+
+  // drop the records past the depth (normally just the one this block pushed out of it)
+  MDB_val k, v;
+  while ((result = mdb_cursor_get(m_cur_block_undo, &k, &v, MDB_FIRST)) == 0)
+  {
+    if (*(const uint64_t *)k.mv_data + m_undo_log_depth > block_height)
+      break;
+    if ((result = mdb_cursor_del(m_cur_block_undo, 0)))
+      throw0(DB_ERROR(lmdb_error("Failed to add removal of block undo log to db transaction: ", result).c_str()));
+  }
+  if (result && result != MDB_NOTFOUND)
+    throw0(DB_ERROR(lmdb_error("Failed to locate oldest block undo log: ", result).c_str()));
+}
+
+bool BlockchainLMDB::remove_block_transactions(const block& blk)
+{
+  int result;
+
+  LOG_PRINT_L3("BlockchainLMDB::" << __func__);
+  check_open();
+  if (!m_has_block_undo)
+    return false;
+  mdb_txn_cursors *m_cursors = &m_wcursors;
+  CURSOR(block_undo)
+
+  // remove_block() has already run, so this is the height of the block being popped
+  uint64_t m_height = height();
+
+  MDB_val_set(k, m_height);
+  MDB_val v;
+  result = mdb_cursor_get(m_cur_block_undo, &k, &v, MDB_SET);
+  if (result == MDB_NOTFOUND)
+    return false;
+  if (result)
+    throw1(DB_ERROR(lmdb_error("Failed to locate block undo log: ", result).c_str()));
+
+  // copy the record out, deleting it invalidates v
+  mdb_block_undo bu;
+  if (v.mv_size < sizeof(bu))
+    throw0(DB_ERROR("Block undo log is too short"));
+  memcpy(&bu, v.mv_data, sizeof(bu));
+  const size_t tx_hashes_size = bu.bu_num_txs * sizeof(crypto::hash);
+  const size_t spent_keys_size = bu.bu_num_spent_keys * sizeof(crypto::key_image);
+  const size_t output_amounts_size = bu.bu_num_outputs * sizeof(uint64_t);
+  if (v.mv_size != sizeof(bu) + tx_hashes_size + spent_keys_size + output_amounts_size)
+    throw0(DB_ERROR("Block undo log has the wrong size"));
+
+  std::vector<crypto::hash> tx_hashes(bu.bu_num_txs);
+  std::vector<crypto::key_image> spent_keys(bu.bu_num_spent_keys);
+  std::vector<uint64_t> output_amounts(bu.bu_num_outputs);
+  const char *p = (const char *)v.mv_data + sizeof(bu);
+  memcpy(tx_hashes.data(), p, tx_hashes_size);
+  p += tx_hashes_size;
+  memcpy(spent_keys.data(), p, spent_keys_size);
+  p += spent_keys_size;
+  memcpy(output_amounts.data(), p, output_amounts_size);
+
+  if ((result = mdb_cursor_del(m_cur_block_undo, 0)))
+    throw1(DB_ERROR(lmdb_error("Failed to add removal of block undo log to db transaction: ", result).c_str()));
+
+  // only trust a record written for this very block
+  if (bu.bu_hash != get_block_hash(blk))
+  {
+    MWARNING("Block undo log at height " << m_height << " is for another block, ignoring it");
+    return false;
+  }
+
+  for (const crypto::key_image &k_image: spent_keys)
+    remove_spent_key(k_image);
+
+  CURSOR(tx_indices)
+  CURSOR(txs_pruned)
+  CURSOR(txs_prunable)
+  CURSOR(txs_prunable_hash)
+  CURSOR(txs_prunable_tip)
+  CURSOR(tx_outputs)
+  CURSOR(output_txs)
+  CURSOR(output_amounts)
+
+  // tx indices are keyed by hash, so each is looked up
+  for (const crypto::hash &tx_hash: tx_hashes)
+  {
+    MDB_val_set(val_h, tx_hash);
+    if ((result = mdb_cursor_get(m_cur_tx_indices, (MDB_val *)&zerokval, &val_h, MDB_GET_BOTH)))
+      throw1(TX_DNE(lmdb_error("Failed to locate tx index for removal: ", result).c_str()));
+    if (((const txindex *)val_h.mv_data)->data.tx_id < bu.bu_first_tx_id)
+      throw0(DB_ERROR("Block undo log has a tx from an earlier block"));
+    if ((result = mdb_cursor_del(m_cur_tx_indices, 0)))
+      throw1(DB_ERROR(lmdb_error("Failed to add removal of tx index to db transaction: ", result).c_str()));
+  }
+
+  // the block's txs and outputs have the highest ids, so the rest of their records are the last ones of their tables
+  delete_key_tail(m_cur_txs_pruned, bu.bu_first_tx_id, LMDB_TXS_PRUNED);
+  delete_key_tail(m_cur_txs_prunable, bu.bu_first_tx_id, LMDB_TXS_PRUNABLE);
+  delete_key_tail(m_cur_txs_prunable_hash, bu.bu_first_tx_id, LMDB_TXS_PRUNABLE_HASH);
+  delete_key_tail(m_cur_txs_prunable_tip, bu.bu_first_tx_id, LMDB_TXS_PRUNABLE_TIP);
+  delete_key_tail(m_cur_tx_outputs, bu.bu_first_tx_id, LMDB_TX_OUTPUTS);
+
+  for (uint64_t i = 0; i < bu.bu_num_outputs; ++i)
+  {
+    MDB_val k_out, v_out;
+    if ((result = mdb_cursor_get(m_cur_output_txs, &k_out, &v_out, MDB_LAST)))
+      throw1(DB_ERROR(lmdb_error("Failed to locate output tx for removal: ", result).c_str()));
+    if (((const outtx *)v_out.mv_data)->output_id < bu.bu_first_output_id)
+      throw0(DB_ERROR("Block undo log has more outputs than the block added"));
+    if ((result = mdb_cursor_del(m_cur_output_txs, 0)))
+      throw1(DB_ERROR(lmdb_error("Failed to add removal of output tx to db transaction: ", result).c_str()));
+  }
+
+  // and each of its outputs is the last one of its amount
+  for (size_t i = output_amounts.size(); i-- > 0; )
+  {
+    MDB_val_set(k_amount, output_amounts[i]);
+    MDB_val v_amount;
+    if ((result = mdb_cursor_get(m_cur_output_amounts, &k_amount, &v_amount, MDB_SET)) == 0)
+      result = mdb_cursor_get(m_cur_output_amounts, &k_amount, &v_amount, MDB_LAST_DUP);
+    if (result)
+      throw1(OUTPUT_DNE(lmdb_error("Failed to locate output amount for removal: ", result).c_str()));
+    if (((const pre_rct_outkey *)v_amount.mv_data)->output_id < bu.bu_first_output_id)
+      throw0(DB_ERROR("Block undo log has an output from an earlier block"));
+    if ((result = mdb_cursor_del(m_cur_output_amounts, 0)))
+      throw1(DB_ERROR(lmdb_error("Failed to add removal of output amount to db transaction: ", result).c_str()));
+  }
+
+  return true;
+}
+
 BlockchainLMDB::~BlockchainLMDB()
 {
   LOG_PRINT_L3("BlockchainLMDB::" << __func__);
@@ -1294,8 +1524,17 @@ BlockchainLMDB::BlockchainLMDB(bool batch_transactions): BlockchainDB()
   m_write_txn = nullptr;
   m_write_batch_txn = nullptr;
   m_batch_active = false;
+  m_batch_start_last_pgno = 0;
+  m_write_txn_start_ns = 0;
+  m_last_batch_commit_valid = false;
+  m_last_batch_commit_ms = 0;
+  m_last_batch_dirty_bytes = 0;
   m_cum_size = 0;
   m_cum_count = 0;
+  m_spent_key_filter_size = 0;
+  m_spent_key_filter_stop = false;
+  m_undo_log_depth = 0;
+  m_has_block_undo = false;
 
   // reset may also need changing when initialize things here
 
@@ -1432,6 +1671,19 @@ void BlockchainLMDB::open(const std::string& filename, const int db_flags)
 
   lmdb_db_open(txn, LMDB_BLOCK_INFO, MDB_INTEGERKEY | MDB_CREATE | MDB_DUPSORT | MDB_DUPFIXED, m_block_info, "Failed to open db handle for m_block_info");
   lmdb_db_open(txn, LMDB_BLOCK_HEIGHTS, MDB_INTEGERKEY | MDB_CREATE | MDB_DUPSORT | MDB_DUPFIXED, m_block_heights, "Failed to open db handle for m_block_heights");
+  // a db from an older version has no undo log, and a read-only txn can't create it: its blocks just have no records
+  if (!(mdb_flags & MDB_RDONLY))
+  {
+    lmdb_db_open(txn, LMDB_BLOCK_UNDO, MDB_INTEGERKEY | MDB_CREATE, m_block_undo, "Failed to open db handle for m_block_undo");
+    m_has_block_undo = true;
+  }
+  else
+  {
+    const int res = mdb_dbi_open(txn, LMDB_BLOCK_UNDO, MDB_INTEGERKEY, &m_block_undo);
+    if (res && res != MDB_NOTFOUND)
+      throw0(DB_OPEN_FAILURE((lmdb_error("Failed to open db handle for m_block_undo : ", res) + std::string(" - you may want to start with --db-salvage")).c_str()));
+    m_has_block_undo = res == 0;
+  }
 
   lmdb_db_open(txn, LMDB_TXS, MDB_INTEGERKEY | MDB_CREATE, m_txs, "Failed to open db handle for m_txs");
   lmdb_db_open(txn, LMDB_TXS_PRUNED, MDB_INTEGERKEY | MDB_CREATE, m_txs_pruned, "Failed to open db handle for m_txs_pruned");
@@ -1523,6 +1775,7 @@ void BlockchainLMDB::open(const std::string& filename, const int db_flags)
       txn.commit();
       m_open = true;
       migrate(db_version);
+      build_spent_key_filter();
       return;
     }
 #endif
@@ -1569,6 +1822,7 @@ void BlockchainLMDB::open(const std::string& filename, const int db_flags)
   txn.commit();
 
   m_open = true;
+  build_spent_key_filter();
   // from here, init should be finished
 }
 
@@ -1580,12 +1834,14 @@ void BlockchainLMDB::close()
     LOG_PRINT_L3("close() first calling batch_abort() due to active batch transaction");
     BlockchainLMDB::batch_abort();
   }
+  stop_spent_key_filter_build();
   BlockchainLMDB::sync();
   m_tinfo.reset();
 
   // FIXME: not yet thread safe!!!  Use with care.
   mdb_env_close(m_env);
   m_open = false;
+  m_spent_key_filter.set_ready(false);
 }
 
 void BlockchainLMDB::sync()
@@ -1625,6 +1881,8 @@ void BlockchainLMDB::reset()
     throw0(DB_ERROR(lmdb_error("Failed to drop m_block_info: ", result).c_str()));
   if (auto result = mdb_drop(txn, m_block_heights, 0))
     throw0(DB_ERROR(lmdb_error("Failed to drop m_block_heights: ", result).c_str()));
+  if (auto result = mdb_drop(txn, m_block_undo, 0))
+    throw0(DB_ERROR(lmdb_error("Failed to drop m_block_undo: ", result).c_str()));
   if (auto result = mdb_drop(txn, m_txs_pruned, 0))
     throw0(DB_ERROR(lmdb_error("Failed to drop m_txs_pruned: ", result).c_str()));
   if (auto result = mdb_drop(txn, m_txs_prunable, 0))
@@ -1658,6 +1916,7 @@ void BlockchainLMDB::reset()
   txn.commit();
   m_cum_size = 0;
   m_cum_count = 0;
+  build_spent_key_filter();
 }
 
 std::vector<std::string> BlockchainLMDB::get_filenames() const
@@ -2049,6 +2308,7 @@ bool BlockchainLMDB::prune_worker(int mode, uint32_t pruning_seed)
   MDB_val v;
   result = mdb_get(txn, m_properties, &k, &v);
   bool prune_tip_table = false;
+  bool resume_prune = false;
   if (result == MDB_NOTFOUND)
   {
     // not pruned yet
@@ -2067,6 +2327,13 @@ bool BlockchainLMDB::prune_worker(int mode, uint32_t pruning_seed)
     result = mdb_put(txn, m_properties, &k, &v, 0);
     if (result)
       throw0(DB_ERROR("Failed to save pruning seed"));
+    // stays until all stripes are pruned and the tip txes listed, see prune_by_stripe
+    uint64_t pruned_height = 0;
+    MDB_val_str(kp, "pruning_progress");
+    MDB_val_set(vp, pruned_height);
+    result = mdb_put(txn, m_properties, &kp, &vp, 0);
+    if (result)
+      throw0(DB_ERROR(lmdb_error("Failed to save pruning progress: ", result).c_str()));
     prune_tip_table = false;
   }
   else if (result == 0)
@@ -2083,6 +2350,14 @@ bool BlockchainLMDB::prune_worker(int mode, uint32_t pruning_seed)
       throw0(DB_ERROR("Blockchain already pruned with different base"));
     pruning_seed = tools::make_pruning_seed(pruning_seed, CRYPTONOTE_PRUNING_LOG_STRIPES);
     prune_tip_table = (mode == prune_mode_update);
+
+    MDB_val_str(kp, "pruning_progress");
+    MDB_val vp;
+    result = mdb_get(txn, m_properties, &kp, &vp);
+    if (result == 0)
+      resume_prune = true;
+    else if (result != MDB_NOTFOUND)
+      throw0(DB_ERROR(lmdb_error("Failed to retrieve pruning progress: ", result).c_str()));
   }
   else
   {
@@ -2094,6 +2369,23 @@ bool BlockchainLMDB::prune_worker(int mode, uint32_t pruning_seed)
   else
     MINFO("Pruning blockchain...");
 
+  if (resume_prune && mode == prune_mode_check)
+    MWARNING("Blockchain pruning was interrupted, it will resume when pruning is next updated");
+
+  if (mode == prune_mode_prune || (resume_prune && mode == prune_mode_update))
+  {
+    // the seed is saved first, with the pruning progress: an interrupted prune resumes with the same seed
+    // from the last stripe it completed, whether restarted with --prune-blockchain or not
+    txn.commit();
+    if (resume_prune)
+      MINFO("Resuming interrupted blockchain pruning...");
+    prune_by_stripe(pruning_seed, n_total_records, n_prunable_records, n_pruned_records, n_bytes);
+    TIME_MEASURE_FINISH(t);
+    MINFO("Pruned blockchain in " << t << " ms: " << (n_bytes/1024.0f/1024.0f) << " MB pruned in " <<
+        n_pruned_records << " records, " << n_prunable_records << "/" << n_total_records << " prunable records");
+    return true;
+  }
+
   MDB_cursor *c_txs_pruned, *c_txs_prunable, *c_txs_prunable_tip;
   result = mdb_cursor_open(txn, m_txs_pruned, &c_txs_pruned);
   if (result)
@@ -2302,6 +2594,196 @@ bool BlockchainLMDB::prune_worker(int mode, uint32_t pruning_seed)
   return true;
 }
 
+uint64_t BlockchainLMDB::get_block_first_tx_id(uint64_t block_height) const
+{
+  LOG_PRINT_L3("BlockchainLMDB::" << __func__);
+  check_open();
+
+  if (block_height >= height())
+    return get_tx_count();
+
+  const crypto::hash miner_tx_hash = cryptonote::get_transaction_hash(get_block_from_height(block_height).miner_tx);
+
+  TXN_PREFIX_RDONLY();
+  RCURSOR(tx_indices);
+
+  MDB_val_set(v, miner_tx_hash);
+  auto result = mdb_cursor_get(m_cur_tx_indices, (MDB_val *)&zerokval, &v, MDB_GET_BOTH);
+  if (result)
+    throw0(DB_ERROR(lmdb_error("Failed to find the miner tx of block " + std::to_string(block_height) + ": ", result).c_str()));
+  const uint64_t tx_id = ((const txindex *)v.mv_data)->data.tx_id;
+
+  TXN_POSTFIX_RDONLY();
+
+  return tx_id;
+}
+
+void BlockchainLMDB::prune_by_stripe(uint32_t pruning_seed, size_t &n_total_records, size_t &n_prunable_records, size_t &n_pruned_records, uint64_t &n_bytes)
+{
+  LOG_PRINT_L3("BlockchainLMDB::" << __func__);
+
+  // deletions per write txn, so readers and a crash lose little, and the dirty pages stay bounded
+  static constexpr size_t PRUNE_RECORDS_PER_TXN = 4096;
+
+  const uint64_t blockchain_height = height();
+  const uint64_t tip_height = blockchain_height - std::min<uint64_t>(blockchain_height, CRYPTONOTE_PRUNING_TIP_BLOCKS);
+
+  // the stripes below this height were pruned by an earlier run which did not finish
+  uint64_t pruned_height = 0;
+  {
+    TXN_PREFIX_RDONLY();
+    RCURSOR(properties)
+    MDB_val_str(k, "pruning_progress");
+    MDB_val v;
+    int result = mdb_cursor_get(m_cur_properties, &k, &v, MDB_SET);
+    if (result == 0 && v.mv_size == sizeof(pruned_height))
+      memcpy(&pruned_height, v.mv_data, sizeof(pruned_height));
+    else if (result && result != MDB_NOTFOUND)
+      throw0(DB_ERROR(lmdb_error("Failed to retrieve pruning progress: ", result).c_str()));
+    TXN_POSTFIX_RDONLY();
+  }
+  if (pruned_height)
+    MINFO("Resuming pruning from block " << pruned_height);
+
+  // Txes are stored in chain order, so the blocks of a stripe hold a contiguous run of tx ids.
+  // Each run is read in parallel, in read txns, to find the prunable data still there (v1 txes
+  // keep theirs), and then deleted in key order in bounded write txns.
+  struct stripe_scan
+  {
+    std::vector<uint64_t> tx_ids;
+    uint64_t bytes = 0;
+  };
+  uint64_t start_height = tools::get_next_pruned_block_height(std::min(pruned_height, blockchain_height), blockchain_height, pruning_seed);
+  while (start_height < tip_height)
+  {
+    const uint64_t end_height = std::min(tools::get_next_unpruned_block_height(start_height, blockchain_height, pruning_seed), tip_height);
+    const uint64_t start_tx_id = get_block_first_tx_id(start_height);
+    const uint64_t end_tx_id = get_block_first_tx_id(end_height);
+
+    stripe_scan scan;
+    const bool r = tools::parallel_reduce(start_tx_id, end_tx_id, 0, scan, [this](size_t begin, size_t end) {
+      stripe_scan chunk;
+      TXN_PREFIX_RDONLY();
+      RCURSOR(txs_pruned);
+      RCURSOR(txs_prunable);
+
+      uint64_t first = begin;
+      MDB_val_set(k, first);
+      MDB_val v;
+      int result = mdb_cursor_get(m_cur_txs_prunable, &k, &v, MDB_SET_RANGE);
+      while (result == 0)
+      {
+        const uint64_t tx_id = *(const uint64_t*)k.mv_data;
+        if (tx_id >= end)
+          break;
+        MDB_val_set(kp, tx_id);
+        if (!is_v1_tx(m_cur_txs_pruned, &kp))
+        {
+          chunk.tx_ids.push_back(tx_id);
+          chunk.bytes += k.mv_size + v.mv_size;
+        }
+        result = mdb_cursor_get(m_cur_txs_prunable, &k, &v, MDB_NEXT);
+      }
+      if (result && result != MDB_NOTFOUND)
+        throw0(DB_ERROR(lmdb_error("Failed to enumerate transaction prunable data: ", result).c_str()));
+
+      TXN_POSTFIX_RDONLY();
+      return chunk;
+    }, [](stripe_scan result, stripe_scan chunk) {
+      result.tx_ids.insert(result.tx_ids.end(), chunk.tx_ids.begin(), chunk.tx_ids.end());
+      result.bytes += chunk.bytes;
+      return result;
+    });
+    if (!r)
+      throw0(DB_ERROR("Failed to read transaction prunable data"));
+
+    n_total_records += end_tx_id - start_tx_id;
+    n_prunable_records += scan.tx_ids.size();
+    n_bytes += scan.bytes;
+    size_t i = 0;
+    do
+    {
+      mdb_txn_safe txn;
+      int result = mdb_txn_begin(m_env, NULL, 0, txn);
+      if (result)
+        throw0(DB_ERROR(lmdb_error("Failed to create a transaction for the db: ", result).c_str()));
+      MDB_cursor *c_txs_prunable;
+      result = mdb_cursor_open(txn, m_txs_prunable, &c_txs_prunable);
+      if (result)
+        throw0(DB_ERROR(lmdb_error("Failed to open a cursor for txs_prunable: ", result).c_str()));
+      for (const size_t end = std::min(scan.tx_ids.size(), i + PRUNE_RECORDS_PER_TXN); i < end; ++i)
+      {
+        MDB_val_set(k, scan.tx_ids[i]);
+        MDB_val v;
+        result = mdb_cursor_get(c_txs_prunable, &k, &v, MDB_SET);
+        if (result == MDB_NOTFOUND)
+          continue;
+        if (result)
+          throw0(DB_ERROR(lmdb_error("Failed to find transaction prunable data: ", result).c_str()));
+        result = mdb_cursor_del(c_txs_prunable, 0);
+        if (result)
+          throw0(DB_ERROR(lmdb_error("Failed to delete transaction prunable data: ", result).c_str()));
+        ++n_pruned_records;
+      }
+      mdb_cursor_close(c_txs_prunable);
+      // the run's last deletions commit with the progress, an interruption redoes at most this run
+      if (i == scan.tx_ids.size())
+      {
+        MDB_val_str(kp, "pruning_progress");
+        MDB_val_set(vp, end_height);
+        result = mdb_put(txn, m_properties, &kp, &vp, 0);
+        if (result)
+          throw0(DB_ERROR(lmdb_error("Failed to save pruning progress: ", result).c_str()));
+      }
+      txn.commit();
+    } while (i < scan.tx_ids.size());
+    MINFO("Pruned blocks " << start_height << " to " << end_height - 1 << " of " << blockchain_height << ": " <<
+        scan.tx_ids.size() << "/" << end_tx_id - start_tx_id << " txes had prunable data");
+
+    start_height = tools::get_next_pruned_block_height(end_height, blockchain_height, pruning_seed);
+  }
+
+  // the txes of the tip blocks are listed so update_pruning can prune them once they fall behind
+  std::vector<std::pair<uint64_t, uint64_t>> tip_txes;
+  uint64_t tx_id = get_block_first_tx_id(tip_height);
+  for (uint64_t block_height = tip_height; block_height < blockchain_height; ++block_height)
+  {
+    const uint64_t next_tx_id = get_block_first_tx_id(block_height + 1);
+    for (; tx_id < next_tx_id; ++tx_id)
+      tip_txes.push_back(std::make_pair(tx_id, block_height));
+  }
+  size_t i = 0;
+  do
+  {
+    mdb_txn_safe txn;
+    int result = mdb_txn_begin(m_env, NULL, 0, txn);
+    if (result)
+      throw0(DB_ERROR(lmdb_error("Failed to create a transaction for the db: ", result).c_str()));
+    MDB_cursor *c_txs_prunable_tip;
+    result = mdb_cursor_open(txn, m_txs_prunable_tip, &c_txs_prunable_tip);
+    if (result)
+      throw0(DB_ERROR(lmdb_error("Failed to open a cursor for txs_prunable_tip: ", result).c_str()));
+    for (const size_t end = std::min(tip_txes.size(), i + PRUNE_RECORDS_PER_TXN); i < end; ++i)
+    {
+      MDB_val_set(kp, tip_txes[i].first);
+      MDB_val_set(vp, tip_txes[i].second);
+      result = mdb_cursor_put(c_txs_prunable_tip, &kp, &vp, MDB_NODUPDATA);
+      if (result && result != MDB_KEYEXIST)
+        throw0(DB_ERROR(lmdb_error("Failed to add transaction to the prunable tip table: ", result).c_str()));
+    }
+    mdb_cursor_close(c_txs_prunable_tip);
+    // with the tip listed, pruning is complete and left to update_pruning from now on
+    if (i == tip_txes.size())
+    {
+      MDB_val_str(kp, "pruning_progress");
+      result = mdb_del(txn, m_properties, &kp, NULL);
+      if (result && result != MDB_NOTFOUND)
+        throw0(DB_ERROR(lmdb_error("Failed to delete pruning progress: ", result).c_str()));
+    }
+    txn.commit();
+  } while (i < tip_txes.size());
+}
+
 bool BlockchainLMDB::prune_blockchain(uint32_t pruning_seed)
 {
   return prune_worker(prune_mode_prune, pruning_seed);
@@ -3282,6 +3764,111 @@ bool BlockchainLMDB::get_blocks_from(uint64_t start_height, size_t min_block_cou
   return true;
 }
 
+bool BlockchainLMDB::get_block_blob_refs_from(uint64_t start_height, size_t min_block_count, size_t max_block_count, size_t max_tx_count, size_t max_size, std::vector<block_blob_refs>& blocks, bool pruned, bool skip_coinbase, bool get_miner_tx_hash) const
+{
+  LOG_PRINT_L3("BlockchainLMDB::" << __func__);
+  check_open();
+
+  // the spans only outlive this call if the caller holds the read txn
+  TXN_PREFIX_RDONLY();
+  if (my_rtxn)
+    throw0(DB_ERROR("get_block_blob_refs_from needs a read transaction held by the caller"));
+  RCURSOR(blocks);
+  RCURSOR(tx_indices);
+  RCURSOR(txs_pruned);
+  if (!pruned)
+  {
+    RCURSOR(txs_prunable);
+  }
+
+  blocks.reserve(std::min<size_t>(max_block_count, 10000)); // guard against very large max count if only checking bytes
+  const uint64_t blockchain_height = height();
+  uint64_t size = 0;
+  size_t num_txes = 0;
+  MDB_val_copy<uint64_t> key(start_height);
+  MDB_val v, val_tx_id;
+  uint64_t tx_id = ~0;
+  const auto as_span = [](const MDB_val &val) { return epee::span<const uint8_t>{reinterpret_cast<const uint8_t*>(val.mv_data), val.mv_size}; };
+  for (uint64_t h = start_height; h < blockchain_height && blocks.size() < max_block_count && (size < max_size || blocks.size() < min_block_count); ++h)
+  {
+    MDB_cursor_op op = h == start_height ? MDB_SET : MDB_NEXT;
+    int result = mdb_cursor_get(m_cur_blocks, &key, &v, op);
+    if (result == MDB_NOTFOUND)
+      throw0(BLOCK_DNE(std::string("Attempt to get block from height ").append(boost::lexical_cast<std::string>(h)).append(" failed -- block not in db").c_str()));
+    else if (result)
+      throw0(DB_ERROR(lmdb_error("Error attempting to retrieve a block from the db", result).c_str()));
+
+    blocks.resize(blocks.size() + 1);
+    auto &current_block = blocks.back();
+
+    current_block.block = as_span(v);
+    size += v.mv_size;
+
+    cryptonote::block b;
+    if (!parse_and_validate_block_from_blob(cryptonote::blobdata_ref{reinterpret_cast<const char*>(v.mv_data), v.mv_size}, b))
+      throw0(DB_ERROR("Invalid block"));
+    current_block.miner_tx_hash = get_miner_tx_hash ? cryptonote::get_transaction_hash(b.miner_tx) : crypto::null_hash;
+
+    // get the tx_id for the first tx (the first block's coinbase tx)
+    if (h == start_height)
+    {
+      crypto::hash hash = cryptonote::get_transaction_hash(b.miner_tx);
+      MDB_val_set(v, hash);
+      result = mdb_cursor_get(m_cur_tx_indices, (MDB_val *)&zerokval, &v, MDB_GET_BOTH);
+      if (result)
+        throw0(DB_ERROR(lmdb_error("Error attempting to retrieve block coinbase transaction from the db: ", result).c_str()));
+
+      const txindex *tip = (const txindex *)v.mv_data;
+      tx_id = tip->data.tx_id;
+      val_tx_id.mv_data = &tx_id;
+      val_tx_id.mv_size = sizeof(tx_id);
+    }
+
+    if (skip_coinbase)
+    {
+      result = mdb_cursor_get(m_cur_txs_pruned, &val_tx_id, &v, op);
+      if (result)
+        throw0(DB_ERROR(lmdb_error("Error attempting to retrieve transaction data from the db: ", result).c_str()));
+      if (!pruned)
+      {
+        result = mdb_cursor_get(m_cur_txs_prunable, &val_tx_id, &v, op);
+        if (result)
+          throw0(DB_ERROR(lmdb_error("Error attempting to retrieve transaction data from the db: ", result).c_str()));
+      }
+    }
+
+    op = MDB_NEXT;
+
+    current_block.txs.resize(b.tx_hashes.size());
+    num_txes += b.tx_hashes.size() + (skip_coinbase ? 0 : 1);
+    for (size_t i = 0; i < b.tx_hashes.size(); ++i)
+    {
+      tx_blob_ref &tx = current_block.txs[i];
+      tx.hash = b.tx_hashes[i];
+      result = mdb_cursor_get(m_cur_txs_pruned, &val_tx_id, &v, op);
+      if (result)
+        throw0(DB_ERROR(lmdb_error("Error attempting to retrieve transaction data from the db: ", result).c_str()));
+      tx.pruned = as_span(v);
+
+      if (!pruned)
+      {
+        result = mdb_cursor_get(m_cur_txs_prunable, &val_tx_id, &v, op);
+        if (result)
+          throw0(DB_ERROR(lmdb_error("Error attempting to retrieve transaction data from the db: ", result).c_str()));
+        tx.prunable = as_span(v);
+      }
+      size += tx.pruned.size() + tx.prunable.size();
+    }
+
+    if (blocks.size() >= min_block_count && num_txes >= max_tx_count)
+      break;
+  }
+
+  TXN_POSTFIX_RDONLY();
+
+  return true;
+}
+
 bool BlockchainLMDB::get_prunable_tx_blob(const crypto::hash& h, cryptonote::blobdata &bd) const
 {
   LOG_PRINT_L3("BlockchainLMDB::" << __func__);
@@ -3342,6 +3929,93 @@ bool BlockchainLMDB::get_prunable_tx_hash(const crypto::hash& tx_hash, crypto::h
   return true;
 }
 
+void BlockchainLMDB::get_split_tx_blobs(const epee::span<const crypto::hash> &tx_hashes, std::vector<split_tx_blob> &blobs) const
+{
+  LOG_PRINT_L3("BlockchainLMDB::" << __func__);
+  check_open();
+
+  blobs.clear();
+  blobs.resize(tx_hashes.size());
+  for (split_tx_blob &blob: blobs)
+  {
+    blob.found = false;
+    blob.has_prunable_hash = false;
+    blob.prunable_hash = crypto::null_hash;
+  }
+  if (tx_hashes.empty())
+    return;
+
+  // resolve the hashes in tx_indices order, then read the data tables in tx_id
+  // order, so each cursor only ever moves forward
+  std::vector<size_t> order(tx_hashes.size());
+  for (size_t i = 0; i < order.size(); ++i)
+    order[i] = i;
+  std::sort(order.begin(), order.end(), [&tx_hashes](size_t a, size_t b) {
+    MDB_val va = {sizeof(crypto::hash), (void *)&tx_hashes[a]};
+    MDB_val vb = {sizeof(crypto::hash), (void *)&tx_hashes[b]};
+    return compare_hash32(&va, &vb) < 0;
+  });
+
+  TXN_PREFIX_RDONLY();
+  RCURSOR(tx_indices);
+  RCURSOR(txs_pruned);
+  RCURSOR(txs_prunable);
+  RCURSOR(txs_prunable_hash);
+
+  std::vector<std::pair<uint64_t, size_t>> ids;
+  ids.reserve(order.size());
+  for (size_t n = 0; n < order.size(); ++n)
+  {
+    const size_t i = order[n];
+    if (n > 0 && tx_hashes[order[n - 1]] == tx_hashes[i])
+    {
+      if (!ids.empty() && ids.back().second == order[n - 1])
+        ids.emplace_back(ids.back().first, i);
+      continue;
+    }
+    MDB_val_set(v, tx_hashes[i]);
+    int result = mdb_cursor_get(m_cur_tx_indices, (MDB_val *)&zerokval, &v, MDB_GET_BOTH);
+    if (result == MDB_NOTFOUND)
+      continue;
+    if (result)
+      throw0(DB_ERROR(lmdb_error("DB error attempting to fetch tx index from hash: ", result).c_str()));
+    const txindex *tip = (const txindex *)v.mv_data;
+    ids.emplace_back(tip->data.tx_id, i);
+  }
+  std::sort(ids.begin(), ids.end());
+
+  for (const auto &id: ids)
+  {
+    split_tx_blob &blob = blobs[id.second];
+    MDB_val_set(val_tx_id, id.first);
+    MDB_val v;
+    int result = mdb_cursor_get(m_cur_txs_pruned, &val_tx_id, &v, MDB_SET);
+    if (result == MDB_NOTFOUND)
+      continue;
+    if (result)
+      throw0(DB_ERROR(lmdb_error("DB error attempting to fetch pruned tx: ", result).c_str()));
+    blob.found = true;
+    blob.pruned.assign(reinterpret_cast<const char*>(v.mv_data), v.mv_size);
+
+    result = mdb_cursor_get(m_cur_txs_prunable_hash, &val_tx_id, &v, MDB_SET);
+    if (result == 0)
+    {
+      blob.has_prunable_hash = true;
+      blob.prunable_hash = *(const crypto::hash*)v.mv_data;
+    }
+    else if (result != MDB_NOTFOUND)
+      throw0(DB_ERROR(lmdb_error("DB error attempting to fetch tx prunable hash: ", result).c_str()));
+
+    result = mdb_cursor_get(m_cur_txs_prunable, &val_tx_id, &v, MDB_SET);
+    if (result == 0)
+      blob.prunable.assign(reinterpret_cast<const char*>(v.mv_data), v.mv_size);
+    else if (result != MDB_NOTFOUND)
+      throw0(DB_ERROR(lmdb_error("DB error attempting to fetch prunable tx: ", result).c_str()));
+  }
+
+  TXN_POSTFIX_RDONLY();
+}
+
 uint64_t BlockchainLMDB::get_tx_count() const
 {
   LOG_PRINT_L3("BlockchainLMDB::" << __func__);
@@ -3539,7 +4213,20 @@ bool BlockchainLMDB::has_key_image(const crypto::key_image& img) const
   check_open();
 
   bool ret;
+  const bool filtered = m_spent_key_filter.ready();
+  const bool timed = filtered && m_spent_key_filter.sample_timing();
+  if (filtered)
+  {
+    TIME_MEASURE_NS_START(filter_time);
+    const bool maybe_spent = m_spent_key_filter.may_contain(img);
+    TIME_MEASURE_NS_FINISH(filter_time);
+    if (timed)
+      m_spent_key_filter.record_filter_timing(filter_time);
+    if (!maybe_spent)
+      return false;
+  }
 
+  TIME_MEASURE_NS_START(db_time);
   TXN_PREFIX_RDONLY();
   RCURSOR(spent_keys);
 
@@ -3547,9 +4234,198 @@ bool BlockchainLMDB::has_key_image(const crypto::key_image& img) const
   ret = (mdb_cursor_get(m_cur_spent_keys, (MDB_val *)&zerokval, &k, MDB_GET_BOTH) == 0);
 
   TXN_POSTFIX_RDONLY();
+  TIME_MEASURE_NS_FINISH(db_time);
+  if (filtered)
+  {
+    m_spent_key_filter.record_db_lookup(ret);
+    if (timed)
+      m_spent_key_filter.record_db_timing(db_time);
+  }
   return ret;
 }
 
+void BlockchainLMDB::has_key_images(const epee::span<const crypto::key_image> &imgs, std::vector<bool> &found) const
+{
+  LOG_PRINT_L3("BlockchainLMDB::" << __func__);
+  check_open();
+
+  found.assign(imgs.size(), false);
+  if (imgs.empty())
+    return;
+
+  // only key images the filter can't rule out go to the database,
+  // probed in the table's own order, so one cursor moves forward through it
+  const bool filtered = m_spent_key_filter.ready();
+  std::vector<size_t> order;
+  order.reserve(imgs.size());
+  for (size_t i = 0; i < imgs.size(); ++i)
+    if (!filtered || m_spent_key_filter.may_contain(imgs[i]))
+      order.push_back(i);
+  if (order.empty())
+    return;
+  std::sort(order.begin(), order.end(), [&imgs](size_t a, size_t b) {
+    MDB_val va = {sizeof(crypto::key_image), (void *)&imgs[a]};
+    MDB_val vb = {sizeof(crypto::key_image), (void *)&imgs[b]};
+    return compare_hash32(&va, &vb) < 0;
+  });
+
+  TXN_PREFIX_RDONLY();
+  RCURSOR(spent_keys);
+
+  MDB_val k, v;
+  bool positioned = false, at_end = false;
+  for (const size_t i: order)
+  {
+    MDB_val probe = {sizeof(crypto::key_image), (void *)&imgs[i]};
+
+    // the cursor sits on the first spent key not below the previous probe: if it is above
+    // this probe too, nothing lies in between and there is no need to search again
+    if (positioned)
+    {
+      if (at_end)
+        continue;
+      const int cmp = compare_hash32(&probe, &v);
+      if (cmp <= 0)
+      {
+        found[i] = cmp == 0;
+        continue;
+      }
+    }
+
+    k = zerokval;
+    v = probe;
+    int result = mdb_cursor_get(m_cur_spent_keys, &k, &v, MDB_GET_BOTH_RANGE);
+    positioned = true;
+    if (result == MDB_NOTFOUND)
+    {
+      at_end = true;
+      continue;
+    }
+    if (result)
+      throw0(DB_ERROR(lmdb_error("Failed to look up spent key: ", result).c_str()));
+    found[i] = compare_hash32(&probe, &v) == 0;
+  }
+
+  TXN_POSTFIX_RDONLY();
+
+  if (filtered)
+    for (const size_t i: order)
+      m_spent_key_filter.record_db_lookup(found[i]);
+}
+
+void BlockchainLMDB::set_spent_key_filter_size(uint64_t bytes)
+{
+  LOG_PRINT_L3("BlockchainLMDB::" << __func__);
+  m_spent_key_filter_size = bytes;
+}
+
+void BlockchainLMDB::set_undo_log_depth(uint64_t blocks)
+{
+  LOG_PRINT_L3("BlockchainLMDB::" << __func__);
+  m_undo_log_depth = blocks;
+}
+
+bool BlockchainLMDB::get_spent_key_filter_stats(key_image_filter_stats &stats) const
+{
+  LOG_PRINT_L3("BlockchainLMDB::" << __func__);
+  if (!m_spent_key_filter.ready())
+    return false;
+  stats = m_spent_key_filter.get_stats();
+  return true;
+}
+
+void BlockchainLMDB::build_spent_key_filter()
+{
+  LOG_PRINT_L3("BlockchainLMDB::" << __func__);
+
+  stop_spent_key_filter_build();
+  m_spent_key_filter.reset(m_spent_key_filter_size);
+  if (m_spent_key_filter_size == 0)
+    return;
+
+  // lookups go to the database until the filter is ready, so the daemon need not wait for it.
+  // Key images added meanwhile go into the filter directly, and the ones already stored are
+  // added here, from this thread's own snapshot.
+  m_spent_key_filter_stop = false;
+  m_spent_key_filter_thread = boost::thread([this]() {
+    TIME_MEASURE_START(t);
+    try
+    {
+      if (!fill_spent_key_filter())
+        return;
+    }
+    catch (const std::exception &e)
+    {
+      MERROR("Failed to build the spent key image filter, key images will be looked up in the database: " << e.what());
+      return;
+    }
+    TIME_MEASURE_FINISH(t);
+    m_spent_key_filter.set_ready(true);
+
+    const key_image_filter_stats stats = m_spent_key_filter.get_stats();
+    MINFO("Spent key image filter built with " << stats.num_keys << " key images in " << stats.memory_bytes / (1024 * 1024) << " MB, took " << t << " ms");
+    if (stats.num_keys > stats.memory_bytes)
+      MWARNING("The spent key image filter has less than 8 bits per key image, and will let many lookups through. Consider raising --" << arg_db_spent_key_filter_size.name);
+  });
+}
+
+bool BlockchainLMDB::fill_spent_key_filter()
+{
+  LOG_PRINT_L3("BlockchainLMDB::" << __func__);
+  check_open();
+
+  // a read txn per chunk, so a resize waiting for readers to finish is not held up for the
+  // whole build
+  static constexpr size_t KEY_IMAGES_PER_TXN = 1 << 20;
+
+  crypto::key_image last;
+  bool started = false;
+  while (true)
+  {
+    if (m_spent_key_filter_stop.load(std::memory_order_relaxed))
+      return false;
+
+    TXN_PREFIX_RDONLY();
+    RCURSOR(spent_keys);
+
+    MDB_val k = zerokval, v;
+    int ret;
+    if (!started)
+    {
+      ret = mdb_cursor_get(m_cur_spent_keys, &k, &v, MDB_FIRST);
+    }
+    else
+    {
+      v = {sizeof(last), (void *)&last};
+      ret = mdb_cursor_get(m_cur_spent_keys, &k, &v, MDB_GET_BOTH_RANGE);
+      if (ret == 0 && *(const crypto::key_image*)v.mv_data == last)
+        ret = mdb_cursor_get(m_cur_spent_keys, &k, &v, MDB_NEXT);
+    }
+    started = true;
+
+    for (size_t n = 0; n < KEY_IMAGES_PER_TXN; ++n)
+    {
+      if (ret == MDB_NOTFOUND)
+        return true;
+      if (ret)
+        throw0(DB_ERROR(lmdb_error("Failed to enumerate key images: ", ret).c_str()));
+      last = *(const crypto::key_image*)v.mv_data;
+      m_spent_key_filter.add(last);
+      ret = mdb_cursor_get(m_cur_spent_keys, &k, &v, MDB_NEXT);
+    }
+
+    TXN_POSTFIX_RDONLY();
+  }
+}
+
+void BlockchainLMDB::stop_spent_key_filter_build()
+{
+  if (!m_spent_key_filter_thread.joinable())
+    return;
+  m_spent_key_filter_stop = true;
+  m_spent_key_filter_thread.join();
+}
+
 bool BlockchainLMDB::for_all_key_images(std::function<bool(const crypto::key_image&)> f) const
 {
   LOG_PRINT_L3("BlockchainLMDB::" << __func__);
@@ -3788,6 +4664,11 @@ bool BlockchainLMDB::batch_start(uint64_t batch_num_blocks, uint64_t batch_bytes
   m_writer = boost::this_thread::get_id();
   check_and_resize_for_batch(batch_num_blocks, batch_bytes);
 
+  MDB_envinfo mei;
+  mdb_env_info(m_env, &mei);
+  m_batch_start_last_pgno = mei.me_last_pgno;
+  m_write_txn_start_ns = epee::misc_utils::get_ns_count();
+
   m_write_batch_txn = new mdb_txn_safe();
 
   // NOTE: need to make sure it's destroyed properly when done
@@ -3830,9 +4711,11 @@ void BlockchainLMDB::batch_commit()
   check_open();
 
   LOG_PRINT_L3("batch transaction: committing...");
+  const uint64_t commit_start_ns = epee::misc_utils::get_ns_count();
   TIME_MEASURE_START(time1);
   m_write_txn->commit();
   TIME_MEASURE_FINISH(time1);
+  record_write_txn_commit(m_write_txn_start_ns, commit_start_ns);
   time_commit1 += time1;
   LOG_PRINT_L3("batch transaction: committed");
 
@@ -3865,13 +4748,25 @@ void BlockchainLMDB::batch_stop()
     throw1(DB_ERROR("batch transaction owned by other thread"));
   check_open();
   LOG_PRINT_L3("batch transaction: committing...");
+  const uint64_t commit_start_ns = epee::misc_utils::get_ns_count();
   TIME_MEASURE_START(time1);
   try
   {
     m_write_txn->commit();
     TIME_MEASURE_FINISH(time1);
+    record_write_txn_commit(m_write_txn_start_ns, commit_start_ns);
     time_commit1 += time1;
     cleanup_batch();
+
+    // pages are copied on write, so the growth of the map approximates what the batch
+    // wrote; pages reused from the freelist are missed
+    MDB_envinfo mei;
+    MDB_stat mst;
+    mdb_env_info(m_env, &mei);
+    mdb_env_stat(m_env, &mst);
+    m_last_batch_commit_ms = time1;
+    m_last_batch_dirty_bytes = mei.me_last_pgno > m_batch_start_last_pgno ? (mei.me_last_pgno - m_batch_start_last_pgno) * mst.ms_psize : 0;
+    m_last_batch_commit_valid = true;
   }
   catch (const std::exception &e)
   {
@@ -3904,6 +4799,16 @@ void BlockchainLMDB::batch_abort()
   LOG_PRINT_L3("batch transaction: aborted");
 }
 
+bool BlockchainLMDB::get_last_batch_commit_cost(uint64_t &commit_ms, uint64_t &dirty_bytes) const
+{
+  LOG_PRINT_L3("BlockchainLMDB::" << __func__);
+  if (!m_last_batch_commit_valid)
+    return false;
+  commit_ms = m_last_batch_commit_ms;
+  dirty_bytes = m_last_batch_dirty_bytes;
+  return true;
+}
+
 void BlockchainLMDB::set_batch_transactions(bool batch_transactions)
 {
   LOG_PRINT_L3("BlockchainLMDB::" << __func__);
@@ -3982,6 +4887,7 @@ void BlockchainLMDB::block_wtxn_start()
   if (! m_batch_active)
   {
     m_writer = boost::this_thread::get_id();
+    m_write_txn_start_ns = epee::misc_utils::get_ns_count();
     m_write_txn = new mdb_txn_safe();
     if (auto mdb_res = lmdb_txn_begin(m_env, NULL, 0, *m_write_txn))
     {
@@ -4010,10 +4916,12 @@ void BlockchainLMDB::block_wtxn_stop()
   {
     if (! m_batch_active)
 	{
+      const uint64_t commit_start_ns = epee::misc_utils::get_ns_count();
       TIME_MEASURE_START(time1);
       m_write_txn->commit();
       TIME_MEASURE_FINISH(time1);
       time_commit1 += time1;
+      record_write_txn_commit(m_write_txn_start_ns, commit_start_ns);
 
       delete m_write_txn;
       m_write_txn = nullptr;
@@ -4062,6 +4970,10 @@ uint64_t BlockchainLMDB::add_block(const std::pair<block, blobdata>& blk, size_t
     }
   }
 
+  m_block_undo_builder.tx_hashes.clear();
+  m_block_undo_builder.spent_keys.clear();
+  m_block_undo_builder.output_amounts.clear();
+
   try
   {
     BlockchainDB::add_block(blk, block_weight, long_term_block_weight, cumulative_difficulty, coins_generated, txs);
@@ -31,6 +31,7 @@
 #include "blockchain_db/blockchain_db.h"
 #include "cryptonote_basic/blobdatatype.h" // for type blobdata
 #include "ringct/rctTypes.h"
+#include <boost/thread/thread.hpp>
 #include <boost/thread/tss.hpp>
 
 #include <lmdb.h>
@@ -50,6 +51,7 @@ typedef struct mdb_txn_cursors
   MDB_cursor *m_txc_blocks;
   MDB_cursor *m_txc_block_heights;
   MDB_cursor *m_txc_block_info;
+  MDB_cursor *m_txc_block_undo;
 
   MDB_cursor *m_txc_output_txs;
   MDB_cursor *m_txc_output_amounts;
@@ -77,6 +79,7 @@ typedef struct mdb_txn_cursors
 #define m_cur_blocks	m_cursors->m_txc_blocks
 #define m_cur_block_heights	m_cursors->m_txc_block_heights
 #define m_cur_block_info	m_cursors->m_txc_block_info
+#define m_cur_block_undo	m_cursors->m_txc_block_undo
 #define m_cur_output_txs	m_cursors->m_txc_output_txs
 #define m_cur_output_amounts	m_cursors->m_txc_output_amounts
 #define m_cur_txs	m_cursors->m_txc_txs
@@ -259,8 +262,10 @@ public:
   virtual bool get_pruned_tx_blob(const crypto::hash& h, cryptonote::blobdata &tx) const;
   virtual bool get_pruned_tx_blobs_from(const crypto::hash& h, size_t count, std::vector<cryptonote::blobdata> &bd) const;
   virtual bool get_blocks_from(uint64_t start_height, size_t min_block_count, size_t max_block_count, size_t max_tx_count, size_t max_size, std::vector<std::pair<std::pair<cryptonote::blobdata, crypto::hash>, std::vector<std::pair<crypto::hash, cryptonote::blobdata>>>>& blocks, bool pruned, bool skip_coinbase, bool get_miner_tx_hash) const;
+  virtual bool get_block_blob_refs_from(uint64_t start_height, size_t min_block_count, size_t max_block_count, size_t max_tx_count, size_t max_size, std::vector<block_blob_refs>& blocks, bool pruned, bool skip_coinbase, bool get_miner_tx_hash) const;
   virtual bool get_prunable_tx_blob(const crypto::hash& h, cryptonote::blobdata &tx) const;
   virtual bool get_prunable_tx_hash(const crypto::hash& tx_hash, crypto::hash &prunable_hash) const;
+  virtual void get_split_tx_blobs(const epee::span<const crypto::hash> &tx_hashes, std::vector<split_tx_blob> &blobs) const;
 
   virtual uint64_t get_tx_count() const;
 
@@ -283,6 +288,11 @@ public:
   virtual std::vector<std::vector<uint64_t>> get_tx_amount_output_indices(const uint64_t tx_id, size_t n_txes) const;
 
   virtual bool has_key_image(const crypto::key_image& img) const;
+  virtual void has_key_images(const epee::span<const crypto::key_image> &imgs, std::vector<bool> &found) const;
+
+  virtual void set_spent_key_filter_size(uint64_t bytes);
+  virtual void set_undo_log_depth(uint64_t blocks);
+  virtual bool get_spent_key_filter_stats(key_image_filter_stats &stats) const;
 
   virtual void add_txpool_tx(const crypto::hash &txid, const cryptonote::blobdata_ref &blob, const txpool_tx_meta_t& meta);
   virtual void update_txpool_tx(const crypto::hash &txid, const txpool_tx_meta_t& meta);
@@ -325,6 +335,7 @@ public:
   virtual void batch_commit();
   virtual void batch_stop();
   virtual void batch_abort();
+  virtual bool get_last_batch_commit_cost(uint64_t &commit_ms, uint64_t &dirty_bytes) const;
 
   virtual void block_wtxn_start();
   virtual void block_wtxn_stop();
@@ -402,6 +413,11 @@ private:
 
   virtual void remove_spent_key(const crypto::key_image& k_image);
 
+  virtual bool remove_block_transactions(const block& blk);
+
+  // write the undo log record of the block just added at the given height, and drop those past the undo log depth
+  void write_block_undo(uint64_t block_height, const crypto::hash& blk_hash);
+
   uint64_t num_outputs() const;
 
   // Hard fork
@@ -414,6 +430,13 @@ private:
 
   bool prune_worker(int mode, uint32_t pruning_seed);
 
+  // drop the prunable data of the stripes pruning_seed does not keep, a block range at a time,
+  // from the "pruning_progress" property left by an interrupted run if any
+  void prune_by_stripe(uint32_t pruning_seed, size_t &n_total_records, size_t &n_prunable_records, size_t &n_pruned_records, uint64_t &n_bytes);
+
+  // the id of the first tx (the miner tx) of the block at the given height, or the tx count at the chain height
+  uint64_t get_block_first_tx_id(uint64_t block_height) const;
+
   virtual bool is_read_only() const;
 
   virtual uint64_t get_database_size() const;
@@ -446,12 +469,23 @@ private:
 
   void cleanup_batch();
 
+  // fill the spent key image filter from the spent keys table, in the background
+  void build_spent_key_filter();
+
+  // add the stored spent key images to the filter, false if stopped first
+  bool fill_spent_key_filter();
+
+  // stop and wait for a background spent key image filter build
+  void stop_spent_key_filter_build();
+
 private:
   MDB_env* m_env;
 
   MDB_dbi m_blocks;
   MDB_dbi m_block_heights;
   MDB_dbi m_block_info;
+  MDB_dbi m_block_undo;
+  bool m_has_block_undo;
 
   MDB_dbi m_txs;
   MDB_dbi m_txs_pruned;
@@ -485,10 +519,32 @@ private:
 
   bool m_batch_transactions; // support for batch transactions
   bool m_batch_active; // whether batch transaction is in progress
+  uint64_t m_batch_start_last_pgno; // map size when the batch started, to estimate its dirty pages
+  uint64_t m_write_txn_start_ns; // when the current write txn (batch or not) began, for the metrics
+  bool m_last_batch_commit_valid;
+  uint64_t m_last_batch_commit_ms;
+  uint64_t m_last_batch_dirty_bytes;
 
   mdb_txn_cursors m_wcursors;
   mutable boost::thread_specific_ptr<mdb_threadinfo> m_tinfo;
 
+  // what the block being added has written so far, for its undo log record
+  struct block_undo_builder
+  {
+    uint64_t first_tx_id;
+    uint64_t first_output_id;
+    std::vector<crypto::hash> tx_hashes;
+    std::vector<crypto::key_image> spent_keys;
+    std::vector<uint64_t> output_amounts;
+  };
+  block_undo_builder m_block_undo_builder;
+  uint64_t m_undo_log_depth;
+
+  uint64_t m_spent_key_filter_size;
+  mutable key_image_filter m_spent_key_filter;
+  boost::thread m_spent_key_filter_thread;
+  std::atomic<bool> m_spent_key_filter_stop;
+
 #if defined(__arm__)
   // force a value so it can compile with 32-bit ARM
   constexpr static uint64_t DEFAULT_MAPSIZE = 1LL << 31;
@@ -29,8 +29,13 @@
 #include <boost/range/adaptor/transformed.hpp>
 #include <boost/algorithm/string.hpp>
 #include <boost/filesystem.hpp>
+#include <boost/thread/mutex.hpp>
+#include <array>
+#include <atomic>
+#include <unordered_set>
 #include "common/unordered_containers_boost_serialization.h"
 #include "common/command_line.h"
+#include "common/threadpool.h"
 #include "common/varint.h"
 #include "serialization/crypto.h"
 #include "cryptonote_basic/cryptonote_boost_serialization.h"
@@ -66,6 +71,45 @@ struct output_data
   output_data(): amount(0), offset(0) {}
   output_data(uint64_t a, uint64_t i): amount(a), offset(i) {}
   bool operator==(const output_data &other) const { return other.amount == amount && other.offset == offset; }
+  bool operator<(const output_data &other) const { return amount < other.amount || (amount == other.amount && offset < other.offset); }
+};
+
+struct output_data_hash
+{
+  size_t operator()(const output_data &od) const { return od.amount * 0x9e3779b97f4a7c15ull ^ od.offset; }
+};
+
+// outputs found spent by the threads of a chain reaction pass, sharded so they rarely wait on each other
+class concurrent_output_set
+{
+public:
+  // returns false if the output was already in the set
+  bool insert(const output_data &od)
+  {
+    shard &s = get_shard(od);
+    boost::lock_guard<boost::mutex> lock(s.mutex);
+    return s.outputs.insert(od).second;
+  }
+
+  bool contains(const output_data &od)
+  {
+    shard &s = get_shard(od);
+    boost::lock_guard<boost::mutex> lock(s.mutex);
+    return s.outputs.find(od) != s.outputs.end();
+  }
+
+private:
+  static constexpr size_t NUM_SHARDS = 64;
+
+  struct shard
+  {
+    boost::mutex mutex;
+    std::unordered_set<output_data, output_data_hash> outputs;
+  };
+
+  shard &get_shard(const output_data &od) { return m_shards[output_data_hash()(od) % NUM_SHARDS]; }
+
+  std::array<shard, NUM_SHARDS> m_shards;
 };
 
 //
@@ -367,35 +411,60 @@ static bool for_all_transactions(const std::string &filename, uint64_t &start_id
 
   bool fret = true;
 
+  // parsing is most of the cost of reading, and does not depend on the order txes are handled
+  // in, so it is done a batch at a time in parallel, and the txes are then passed to f in order
+  static constexpr size_t TX_PARSE_BATCH = 4096;
+  std::vector<std::pair<uint64_t, blobdata>> blobs;
+  std::vector<cryptonote::transaction_prefix> txs;
+  std::vector<uint8_t> parsed;
+
   k.mv_size = sizeof(uint64_t);
   k.mv_data = &start_idx;
   MDB_cursor_op op = MDB_SET;
-  while (1)
+  bool done = false;
+  while (fret && !done)
   {
-    int ret = mdb_cursor_get(cur, &k, &v, op);
-    op = MDB_NEXT;
-    if (ret == MDB_NOTFOUND)
-      break;
-    if (ret)
-      throw std::runtime_error("Failed to enumerate transactions: " + std::string(mdb_strerror(ret)));
+    blobs.clear();
+    while (blobs.size() < TX_PARSE_BATCH)
+    {
+      int ret = mdb_cursor_get(cur, &k, &v, op);
+      op = MDB_NEXT;
+      if (ret == MDB_NOTFOUND)
+      {
+        done = true;
+        break;
+      }
+      if (ret)
+        throw std::runtime_error("Failed to enumerate transactions: " + std::string(mdb_strerror(ret)));
+
+      if (k.mv_size != sizeof(uint64_t))
+        throw std::runtime_error("Bad key size");
+      const uint64_t idx = *(uint64_t*)k.mv_data;
+      if (idx < start_idx)
+        continue;
+      blobs.emplace_back(idx, blobdata(reinterpret_cast<const char*>(v.mv_data), v.mv_size));
+    }
 
-    if (k.mv_size != sizeof(uint64_t))
-      throw std::runtime_error("Bad key size");
-    const uint64_t idx = *(uint64_t*)k.mv_data;
-    if (idx < start_idx)
-      continue;
+    txs.clear();
+    txs.resize(blobs.size());
+    parsed.assign(blobs.size(), 0);
+    tools::parallel_for(0, blobs.size(), 0, [&blobs, &txs, &parsed](size_t begin, size_t end) {
+      for (size_t i = begin; i < end; ++i)
+      {
+        binary_archive<false> ba{epee::strspan<std::uint8_t>(blobs[i].second)};
+        parsed[i] = do_serialize(ba, txs[i]);
+      }
+    });
 
-    cryptonote::transaction_prefix tx;
-    blobdata bd;
-    bd.assign(reinterpret_cast<char*>(v.mv_data), v.mv_size);
-    binary_archive<false> ba{epee::strspan<std::uint8_t>(bd)};
-    bool r = do_serialize(ba, tx);
-    CHECK_AND_ASSERT_MES(r, false, "Failed to parse transaction from blob");
+    for (size_t i = 0; i < blobs.size(); ++i)
+    {
+      CHECK_AND_ASSERT_MES(parsed[i], false, "Failed to parse transaction from blob");
 
-    start_idx = *(uint64_t*)k.mv_data;
-    if (!f(tx)) {
-      fret = false;
-      break;
+      start_idx = blobs[i].first;
+      if (!f(txs[i])) {
+        fret = false;
+        break;
+      }
     }
   }
 
@@ -935,15 +1004,20 @@ static void set_stat(MDB_txn *txn, const char *key, uint64_t data)
   CHECK_AND_ASSERT_THROW_MES(!dbr, "Failed to set stat record");
 }
 
-static void inc_stat(MDB_txn *txn, const char *key)
+static void add_stat(MDB_txn *txn, const char *key, uint64_t n)
 {
   uint64_t data;
   if (!get_stat(txn, key, data))
     data = 0;
-  ++data;
+  data += n;
   set_stat(txn, key, data);
 }
 
+static void inc_stat(MDB_txn *txn, const char *key)
+{
+  add_stat(txn, key, 1);
+}
+
 static void open_db(const std::string &filename, MDB_env **env, MDB_txn **txn, MDB_cursor **cur, MDB_dbi *dbi)
 {
   tools::create_directories_if_necessary(filename);
@@ -1266,7 +1340,7 @@ int main(int argc, char* argv[])
 
   tools::ringdb ringdb(output_file_path.string(), epee::string_tools::pod_to_hex(get_genesis_block_hash(inputs[0])));
 
-  bool stop_requested = false;
+  std::atomic<bool> stop_requested{false};
   tools::signal_handler::install([&stop_requested](int type) {
     stop_requested = true;
   });
@@ -1283,6 +1357,23 @@ int main(int argc, char* argv[])
 
   std::vector<output_data> work_spent;
 
+  // The chain reaction passes only need to look at rings which may have changed: those with a
+  // member newly found spent, and new rings. These are collected as seeds while scanning. The
+  // stat below marks a run whose chain reaction passes did not complete (or never ran, for a
+  // database written before it existed), which the next run then redoes over all spent outputs.
+  bool chain_reaction_pending = true;
+  {
+    MDB_txn *txn;
+    int dbr = mdb_txn_begin(env, NULL, MDB_RDONLY, &txn);
+    CHECK_AND_ASSERT_THROW_MES(!dbr, "Failed to create LMDB transaction: " + std::string(mdb_strerror(dbr)));
+    uint64_t pending;
+    if (get_stat(txn, "chain-reaction-pending", pending))
+      chain_reaction_pending = pending != 0;
+    mdb_txn_abort(txn);
+  }
+  const bool full_chain_reaction_pass = opt_force_chain_reaction_pass || chain_reaction_pending;
+  std::vector<output_data> chain_reaction_seeds;
+
   if (opt_historical_stat)
   {
     if (!start_blackballed_outputs)
@@ -1362,8 +1453,12 @@ int main(int argc, char* argv[])
         blackballs.push_back(output);
         if (add_spent_output(cur, output_data(output.first, output.second)))
           inc_stat(txn, output.first ? "pre-rct-extra" : "rct-ring-extra");
+        if (!full_chain_reaction_pass)
+          chain_reaction_seeds.push_back(output_data(output.first, output.second));
       }
     }
+    if (!blackballs.empty())
+      set_stat(txn, "chain-reaction-pending", 1);
     if (!blackballs.empty())
     {
       ringdb.blackball(blackballs);
@@ -1408,8 +1503,13 @@ int main(int argc, char* argv[])
 
         const std::vector<uint64_t> absolute = cryptonote::relative_output_offsets_to_absolute(txin.key_offsets);
         if (n == 0)
+        {
           for (uint64_t out: absolute)
             add_key_image(txn, output_data(txin.amount, out), txin.k_image);
+          // any member leads a chain reaction pass to this new ring
+          if (!full_chain_reaction_pass)
+            chain_reaction_seeds.push_back(output_data(txin.amount, absolute[0]));
+        }
 
         std::vector<uint64_t> relative_ring;
         std::vector<uint64_t> new_ring = canonicalize(txin.key_offsets);
@@ -1545,12 +1645,17 @@ int main(int argc, char* argv[])
         }
       }
 
+      if (records == 0)
+        set_stat(txn, "chain-reaction-pending", 1);
       ++records;
       if (records >= records_per_sync)
       {
         if (!blackballs.empty())
         {
           ringdb.blackball(blackballs);
+          if (!full_chain_reaction_pass)
+            for (const std::pair<uint64_t, uint64_t> &output: blackballs)
+              chain_reaction_seeds.push_back(output_data(output.first, output.second));
           blackballs.clear();
         }
         mdb_cursor_close(cur);
@@ -1572,6 +1677,9 @@ int main(int argc, char* argv[])
       }
       return true;
     });
+    if (!full_chain_reaction_pass)
+      for (const std::pair<uint64_t, uint64_t> &output: blackballs)
+        chain_reaction_seeds.push_back(output_data(output.first, output.second));
     mdb_cursor_close(cur);
     dbr = mdb_txn_commit(txn);
     CHECK_AND_ASSERT_THROW_MES(!dbr, "Failed to commit txn creating/opening database: " + std::string(mdb_strerror(dbr)));
@@ -1583,7 +1691,7 @@ int main(int argc, char* argv[])
   if (stop_requested)
     goto skip_secondary_passes;
 
-  if (opt_force_chain_reaction_pass || get_num_spent_outputs() > start_blackballed_outputs)
+  if (full_chain_reaction_pass)
   {
     MDB_txn *txn;
     dbr = mdb_txn_begin(env, NULL, MDB_RDONLY, &txn);
@@ -1591,11 +1699,74 @@ int main(int argc, char* argv[])
     work_spent = get_spent_outputs(txn);
     mdb_txn_abort(txn);
   }
+  else
+  {
+    work_spent = std::move(chain_reaction_seeds);
+    std::sort(work_spent.begin(), work_spent.end());
+    work_spent.erase(std::unique(work_spent.begin(), work_spent.end()), work_spent.end());
+  }
 
   while (!work_spent.empty())
   {
     LOG_PRINT_L0("Secondary pass on " << work_spent.size() << " spent outputs");
 
+    // The rings of each output are checked in parallel, each thread reading through its own read
+    // txn. Outputs found spent earlier in the pass are not in the database yet, so the threads
+    // share them in a set, which also keeps two threads from finding the same output.
+    const std::vector<output_data> scan_spent = std::move(work_spent);
+    work_spent.clear();
+    concurrent_output_set marked;
+    const bool pass_ok = tools::parallel_reduce(0, scan_spent.size(), 0, work_spent,
+      [&](size_t begin, size_t end) {
+        std::vector<output_data> found;
+        MDB_txn *txn;
+        int dbr = mdb_txn_begin(env, NULL, MDB_RDONLY, &txn);
+        CHECK_AND_ASSERT_THROW_MES(!dbr, "Failed to create LMDB transaction: " + std::string(mdb_strerror(dbr)));
+        epee::misc_utils::auto_scope_leave_caller txn_dtor = epee::misc_utils::create_scope_leave_handler([&](){mdb_txn_abort(txn);});
+        MDB_cursor *cur;
+        dbr = mdb_cursor_open(txn, dbi_spent, &cur);
+        CHECK_AND_ASSERT_THROW_MES(!dbr, "Failed to open LMDB cursor: " + std::string(mdb_strerror(dbr)));
+        for (size_t i = begin; i < end && !stop_requested; ++i)
+        {
+          const output_data &od = scan_spent[i];
+          std::vector<crypto::key_image> key_images = get_key_images(txn, od);
+          for (const crypto::key_image &ki: key_images)
+          {
+            std::vector<uint64_t> relative_ring;
+            CHECK_AND_ASSERT_THROW_MES(get_relative_ring(txn, ki, relative_ring), "Relative ring not found");
+            std::vector<uint64_t> absolute = cryptonote::relative_output_offsets_to_absolute(relative_ring);
+            size_t known = 0;
+            uint64_t last_unknown = 0;
+            for (uint64_t out: absolute)
+            {
+              output_data new_od(od.amount, out);
+              if (marked.contains(new_od) || is_output_spent(cur, new_od))
+                ++known;
+              else
+                last_unknown = out;
+            }
+            if (known == absolute.size() - 1 && marked.insert(output_data(od.amount, last_unknown)))
+              found.push_back(output_data(od.amount, last_unknown));
+          }
+        }
+        mdb_cursor_close(cur);
+        return found;
+      },
+      [](std::vector<output_data> result, std::vector<output_data> found) {
+        result.insert(result.end(), found.begin(), found.end());
+        return result;
+      });
+    CHECK_AND_ASSERT_THROW_MES(pass_ok, "Failed to run a secondary pass");
+
+    if (stop_requested)
+    {
+      MINFO("Stopping secondary passes. They will re-run fully on the next run.");
+      return 0;
+    }
+
+    // written in one txn, in key order
+    std::sort(work_spent.begin(), work_spent.end());
+
     int dbr = resize_env(cache_dir.c_str());
     CHECK_AND_ASSERT_THROW_MES(!dbr, "Failed to resize LMDB database: " + std::string(mdb_strerror(dbr)));
 
@@ -1607,47 +1778,23 @@ int main(int argc, char* argv[])
     CHECK_AND_ASSERT_THROW_MES(!dbr, "Failed to open LMDB cursor: " + std::string(mdb_strerror(dbr)));
 
     std::vector<std::pair<uint64_t, uint64_t>> blackballs;
-    std::vector<output_data> scan_spent = std::move(work_spent);
-    work_spent.clear();
-    for (const output_data &od: scan_spent)
+    blackballs.reserve(work_spent.size());
+    uint64_t pre_rct_found = 0, rct_found = 0;
+    for (const output_data &od: work_spent)
     {
-      std::vector<crypto::key_image> key_images = get_key_images(txn, od);
-      for (const crypto::key_image &ki: key_images)
+      const std::pair<uint64_t, uint64_t> output = std::make_pair(od.amount, od.offset);
+      if (opt_verbose)
       {
-        std::vector<uint64_t> relative_ring;
-        CHECK_AND_ASSERT_THROW_MES(get_relative_ring(txn, ki, relative_ring), "Relative ring not found");
-        std::vector<uint64_t> absolute = cryptonote::relative_output_offsets_to_absolute(relative_ring);
-        size_t known = 0;
-        uint64_t last_unknown = 0;
-        for (uint64_t out: absolute)
-        {
-          output_data new_od(od.amount, out);
-          if (is_output_spent(cur, new_od))
-            ++known;
-          else
-            last_unknown = out;
-        }
-        if (known == absolute.size() - 1)
-        {
-          const std::pair<uint64_t, uint64_t> output = std::make_pair(od.amount, last_unknown);
-          if (opt_verbose)
-          {
-            MINFO("Marking output " << output.first << "/" << output.second << " as spent, due to being used in a " <<
-                absolute.size() << "-ring where all other outputs are known to be spent");
-          }
-          blackballs.push_back(output);
-          if (add_spent_output(cur, output_data(od.amount, last_unknown)))
-            inc_stat(txn, od.amount ? "pre-rct-chain-reaction" : "rct-chain-reaction");
-          work_spent.push_back(output_data(od.amount, last_unknown));
-        }
-      }
-
-      if (stop_requested)
-      {
-        MINFO("Stopping secondary passes. Secondary passes are not incremental, they will re-run fully.");
-        return 0;
+        MINFO("Marking output " << output.first << "/" << output.second << " as spent, due to being used in a ring where all other outputs are known to be spent");
       }
+      blackballs.push_back(output);
+      if (add_spent_output(cur, od))
+        ++(od.amount ? pre_rct_found : rct_found);
     }
+    if (pre_rct_found)
+      add_stat(txn, "pre-rct-chain-reaction", pre_rct_found);
+    if (rct_found)
+      add_stat(txn, "rct-chain-reaction", rct_found);
     if (!blackballs.empty())
     {
       ringdb.blackball(blackballs);
@@ -1658,6 +1805,15 @@ int main(int argc, char* argv[])
     CHECK_AND_ASSERT_THROW_MES(!dbr, "Failed to commit txn creating/opening database: " + std::string(mdb_strerror(dbr)));
   }
 
+  {
+    MDB_txn *txn;
+    dbr = mdb_txn_begin(env, NULL, 0, &txn);
+    CHECK_AND_ASSERT_THROW_MES(!dbr, "Failed to create LMDB transaction: " + std::string(mdb_strerror(dbr)));
+    set_stat(txn, "chain-reaction-pending", 0);
+    dbr = mdb_txn_commit(txn);
+    CHECK_AND_ASSERT_THROW_MES(!dbr, "Failed to commit txn: " + std::string(mdb_strerror(dbr)));
+  }
+
 skip_secondary_passes:
   uint64_t diff = get_num_spent_outputs() - start_blackballed_outputs;
   LOG_PRINT_L0(std::to_string(diff) << " new outputs marked as spent, " << get_num_spent_outputs() << " total outputs marked as spent");
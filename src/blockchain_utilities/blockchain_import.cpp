@@ -29,12 +29,18 @@
 #include <atomic>
 #include <cstdio>
 #include <algorithm>
+#include <deque>
 #include <fstream>
 
 #include <boost/filesystem.hpp>
 #include <boost/algorithm/string.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
 #include <unistd.h>
 #include "misc_log_ex.h"
+#include "misc_os_dependent.h"
+#include "common/util.h"
 #include "bootstrap_file.h"
 #include "bootstrap_serialization.h"
 #include "blocks/blocks.h"
@@ -102,12 +108,16 @@ int pop_blocks(cryptonote::core& core, int num_blocks)
   int quit = 0;
   block popped_block;
   std::vector<transaction> popped_txs;
+  const uint64_t start_ns = epee::misc_utils::get_ns_count();
   for (int i=0; i < num_blocks; ++i)
   {
     // simple_core.m_storage.pop_block_from_blockchain() is private, so call directly through db
     core.get_blockchain_storage().get_db().pop_block(popped_block, popped_txs);
     quit = 1;
   }
+  const uint64_t elapsed_us = (epee::misc_utils::get_ns_count() - start_ns) / 1000;
+  MINFO("Popped " << num_blocks << " blocks in " << elapsed_us / 1000 << " ms"
+      << (num_blocks > 0 ? " (" + std::to_string(elapsed_us / num_blocks) + " us per block)" : ""));
 
 
   if (use_batch)
@@ -127,7 +137,211 @@ int pop_blocks(cryptonote::core& core, int num_blocks)
   return num_blocks;
 }
 
-int check_flush(cryptonote::core &core, std::vector<block_complete_entry> &blocks, bool force)
+namespace
+{
+uint64_t stage_verify_ns = 0;
+uint64_t stage_commit_ns = 0;
+uint64_t stage_verified_blocks = 0;
+
+// A chunk of the bootstrap file, decoded by the reader thread
+struct import_chunk
+{
+  bootstrap::block_package bp;
+  crypto::hash block_hash;
+  block_complete_entry bce; // filled when verifying
+  uint64_t bytes;           // bytes read from the file for this chunk
+  std::streampos end_pos;   // file position after this chunk
+};
+
+// Reads and decodes chunks ahead of the importer on its own thread, so the
+// file I/O and deserialization overlap with verification and commit.
+class chunk_reader
+{
+public:
+  enum status { ok, end_of_file, error };
+
+  chunk_reader(std::ifstream &import_file, uint8_t major_version, size_t max_queued)
+    : m_import_file(import_file), m_major_version(major_version), m_max_queued(max_queued),
+      m_status(ok), m_stop(false), m_busy_ns(0), m_chunks(0)
+  {
+    m_thread = boost::thread([this]() { run(); });
+  }
+
+  ~chunk_reader()
+  {
+    {
+      boost::unique_lock<boost::mutex> lock(m_mutex);
+      m_stop = true;
+    }
+    m_cond.notify_all();
+    m_thread.join();
+  }
+
+  //! Blocks until the next chunk is decoded, returns end_of_file or error after the last one
+  status next(import_chunk &chunk)
+  {
+    boost::unique_lock<boost::mutex> lock(m_mutex);
+    while (m_queue.empty() && m_status == ok)
+      m_cond.wait(lock);
+    if (m_queue.empty())
+      return m_status;
+    chunk = std::move(m_queue.front());
+    m_queue.pop_front();
+    m_cond.notify_all();
+    return ok;
+  }
+
+  uint64_t busy_ns() const { return m_busy_ns; }
+  uint64_t chunks() const { return m_chunks; }
+
+private:
+  void run()
+  {
+    status s = ok;
+    try
+    {
+      while (s == ok)
+      {
+        {
+          boost::unique_lock<boost::mutex> lock(m_mutex);
+          while (m_queue.size() >= m_max_queued && !m_stop)
+            m_cond.wait(lock);
+          if (m_stop)
+            return;
+        }
+
+        const uint64_t start = epee::misc_utils::get_ns_count();
+        import_chunk chunk;
+        s = read_chunk(chunk);
+        m_busy_ns += epee::misc_utils::get_ns_count() - start;
+        if (s != ok)
+          break;
+        ++m_chunks;
+
+        boost::unique_lock<boost::mutex> lock(m_mutex);
+        m_queue.push_back(std::move(chunk));
+        m_cond.notify_all();
+      }
+    }
+    catch (const std::exception &e)
+    {
+      std::cout << refresh_string;
+      MFATAL("exception while reading from file: " << e.what());
+      s = error;
+    }
+
+    boost::unique_lock<boost::mutex> lock(m_mutex);
+    m_status = s;
+    m_cond.notify_all();
+  }
+
+  status read_chunk(import_chunk &chunk)
+  {
+    uint32_t chunk_size;
+    m_import_file.read(m_buffer1, sizeof(chunk_size));
+    if (! m_import_file) {
+      std::cout << refresh_string;
+      MINFO("End of file reached");
+      return end_of_file;
+    }
+
+    m_str1.assign(m_buffer1, sizeof(chunk_size));
+    if (! ::serialization::parse_binary(m_str1, chunk_size))
+    {
+      throw std::runtime_error("Error in deserialization of chunk size");
+    }
+    MDEBUG("chunk_size: " << chunk_size);
+
+    if (chunk_size > BUFFER_SIZE)
+    {
+      MWARNING("WARNING: chunk_size " << chunk_size << " > BUFFER_SIZE " << BUFFER_SIZE);
+      throw std::runtime_error("Aborting: chunk size exceeds buffer size");
+    }
+    if (chunk_size > CHUNK_SIZE_WARNING_THRESHOLD)
+    {
+      MINFO("NOTE: chunk_size " << chunk_size << " > " << CHUNK_SIZE_WARNING_THRESHOLD);
+    }
+    else if (chunk_size == 0) {
+      MFATAL("ERROR: chunk_size == 0");
+      return error;
+    }
+    m_str1.resize(chunk_size);
+    m_import_file.read(&m_str1[0], chunk_size);
+    if (! m_import_file) {
+      if (m_import_file.eof())
+      {
+        std::cout << refresh_string;
+        MINFO("End of file reached - file was truncated");
+        return end_of_file;
+      }
+      else
+      {
+        MFATAL("ERROR: unexpected end of file: bytes read before error: "
+            << m_import_file.gcount() << " of chunk_size " << chunk_size);
+        return error;
+      }
+    }
+    chunk.bytes = sizeof(chunk_size) + chunk_size;
+    chunk.end_pos = m_import_file.tellg();
+
+    bool res;
+    if (m_major_version == 0)
+    {
+      bootstrap::block_package_1 bp1;
+      res = ::serialization::parse_binary(m_str1, bp1);
+      if (res)
+      {
+        chunk.bp.block = std::move(bp1.block);
+        chunk.bp.txs = std::move(bp1.txs);
+        chunk.bp.block_weight = bp1.block_weight;
+        chunk.bp.cumulative_difficulty = bp1.cumulative_difficulty;
+        chunk.bp.coins_generated = bp1.coins_generated;
+      }
+    }
+    else
+      res = ::serialization::parse_binary(m_str1, chunk.bp);
+    if (!res)
+      throw std::runtime_error("Error in deserialization of chunk");
+
+    chunk.block_hash = get_block_hash(chunk.bp.block);
+    if (opt_verify)
+    {
+      chunk.bce.pruned = false;
+      cryptonote::block_to_blob(chunk.bp.block, chunk.bce.block);
+      chunk.bce.txs.reserve(chunk.bp.txs.size());
+      for (const auto &tx: chunk.bp.txs)
+      {
+        chunk.bce.txs.push_back({cryptonote::blobdata(), crypto::null_hash});
+        cryptonote::tx_to_blob(tx, chunk.bce.txs.back().blob);
+      }
+    }
+    return ok;
+  }
+
+  std::ifstream &m_import_file;
+  const uint8_t m_major_version;
+  const size_t m_max_queued;
+  std::string m_str1;
+  char m_buffer1[1024];
+
+  boost::mutex m_mutex;
+  boost::condition_variable m_cond;
+  std::deque<import_chunk> m_queue;
+  status m_status;
+  bool m_stop;
+  std::atomic<uint64_t> m_busy_ns;
+  std::atomic<uint64_t> m_chunks;
+  boost::thread m_thread;
+};
+
+void print_stage_rate(const char *stage, uint64_t blocks, uint64_t ns)
+{
+  const double seconds = ns / 1e9;
+  MINFO(stage << ": " << blocks << " blocks in " << seconds << " s (" << (seconds > 0 ? blocks / seconds : 0.0) << " blocks/s)");
+}
+}
+
+int check_flush(cryptonote::core &core, std::vector<block_complete_entry> &blocks, std::vector<crypto::hash> &hashes, bool force)
 {
   if (blocks.empty())
     return 0;
@@ -139,19 +353,7 @@ int check_flush(cryptonote::core &core, std::vector<block_complete_entry> &block
   if (!force && new_height % HASH_OF_HASHES_STEP)
     return 0;
 
-  std::vector<crypto::hash> hashes;
-  for (const auto &b: blocks)
-  {
-    cryptonote::block block;
-    if (!parse_and_validate_block_from_blob(b.block, block))
-    {
-      MERROR("Failed to parse block: "
-          << epee::string_tools::buff_to_hex_nodelimer(b.block));
-      core.cleanup_handle_incoming_blocks();
-      return 1;
-    }
-    hashes.push_back(cryptonote::get_block_hash(block));
-  }
+  const uint64_t verify_start = epee::misc_utils::get_ns_count();
   core.prevalidate_block_hashes(core.get_blockchain_storage().get_db().height(), hashes, {});
 
   std::vector<block> pblocks;
@@ -167,26 +369,33 @@ int check_flush(cryptonote::core &core, std::vector<block_complete_entry> &block
     return 1;
   }
 
-  size_t blockidx = 0;
-  for(const block_complete_entry& block_entry: blocks)
+  // the context free checks of all the batch's transactions run in parallel,
+  // their inputs are checked again when their block is added below
+  std::vector<tx_blob_entry> tx_blobs;
+  for (block_complete_entry &block_entry: blocks)
+    for (tx_blob_entry &tx_blob: block_entry.txs)
+      tx_blobs.push_back(std::move(tx_blob));
+  std::vector<tx_verification_context> tvcs(tx_blobs.size());
+  core.handle_incoming_txs(tx_blobs, tvcs, relay_method::block, true);
+  for (size_t i = 0; i < tvcs.size(); ++i)
   {
-    // process transactions
-    for(auto& tx_blob: block_entry.txs)
+    if(tvcs[i].m_verifivation_failed)
     {
-      tx_verification_context tvc = AUTO_VAL_INIT(tvc);
-      core.handle_incoming_tx(tx_blob, tvc, relay_method::block, true);
-      if(tvc.m_verifivation_failed)
-      {
-        cryptonote::transaction transaction;
-        if (cryptonote::parse_and_validate_tx_from_blob(tx_blob.blob, transaction))
-          MERROR("Transaction verification failed, tx_id = " << cryptonote::get_transaction_hash(transaction));
-        else
-          MERROR("Transaction verification failed, transaction is unparsable");
-        core.cleanup_handle_incoming_blocks();
-        return 1;
-      }
+      cryptonote::transaction transaction;
+      if (cryptonote::parse_and_validate_tx_from_blob(tx_blobs[i].blob, transaction))
+        MERROR("Transaction verification failed, tx_id = " << cryptonote::get_transaction_hash(transaction));
+      else
+        MERROR("Transaction verification failed, transaction is unparsable");
+      core.cleanup_handle_incoming_blocks();
+      return 1;
     }
+  }
+  const uint64_t commit_start = epee::misc_utils::get_ns_count();
+  stage_verify_ns += commit_start - verify_start;
 
+  size_t blockidx = 0;
+  for(const block_complete_entry& block_entry: blocks)
+  {
     // process block
 
     block_verification_context bvc = {};
@@ -213,8 +422,11 @@ int check_flush(cryptonote::core &core, std::vector<block_complete_entry> &block
   } // each download block
   if (!core.cleanup_handle_incoming_blocks())
     return 1;
+  stage_commit_ns += epee::misc_utils::get_ns_count() - commit_start;
+  stage_verified_blocks += blocks.size();
 
   blocks.clear();
+  hashes.clear();
   return 0;
 }
 
@@ -270,9 +482,6 @@ int import_from_file(cryptonote::core& core, const std::string& import_file_path
   uint64_t dummy;
   bootstrap.seek_to_first_chunk(import_file, major_version, minor_version, dummy, dummy);
 
-  std::string str1;
-  char buffer1[1024];
-  char buffer_block[BUFFER_SIZE];
   block b;
   transaction tx;
   int quit = 0;
@@ -297,6 +506,8 @@ int import_from_file(cryptonote::core& core, const std::string& import_file_path
   std::cout << ENDL;
 
   std::vector<block_complete_entry> blocks;
+  std::vector<crypto::hash> hashes;
+  uint64_t import_start = epee::misc_utils::get_ns_count(), read_ns = 0, read_chunks = 0;
 
   // Skip to start_height before we start adding.
   {
@@ -322,56 +533,27 @@ int import_from_file(cryptonote::core& core, const std::string& import_file_path
     import_file.seekg(pos);
     core.get_blockchain_storage().get_db().batch_start(db_batch_size, bytes);
   }
+
+  {
+  // batch sizes are counted on a separate stream, the reader thread owns import_file
+  std::ifstream count_file;
+  if (use_batch)
+    count_file.open(import_file_path, std::ios_base::binary | std::ifstream::in);
+
+  import_start = epee::misc_utils::get_ns_count();
+  chunk_reader reader(import_file, major_version, std::max<size_t>(db_batch_size, 256));
   while (! quit)
   {
-    uint32_t chunk_size;
-    import_file.read(buffer1, sizeof(chunk_size));
-    // TODO: bootstrap.read_chunk();
-    if (! import_file) {
-      std::cout << refresh_string;
-      MINFO("End of file reached");
+    import_chunk chunk;
+    const chunk_reader::status status = reader.next(chunk);
+    if (status == chunk_reader::end_of_file)
+    {
       quit = 1;
       break;
     }
-    bytes_read += sizeof(chunk_size);
-
-    str1.assign(buffer1, sizeof(chunk_size));
-    if (! ::serialization::parse_binary(str1, chunk_size))
-    {
-      throw std::runtime_error("Error in deserialization of chunk size");
-    }
-    MDEBUG("chunk_size: " << chunk_size);
-
-    if (chunk_size > BUFFER_SIZE)
-    {
-      MWARNING("WARNING: chunk_size " << chunk_size << " > BUFFER_SIZE " << BUFFER_SIZE);
-      throw std::runtime_error("Aborting: chunk size exceeds buffer size");
-    }
-    if (chunk_size > CHUNK_SIZE_WARNING_THRESHOLD)
-    {
-      MINFO("NOTE: chunk_size " << chunk_size << " > " << CHUNK_SIZE_WARNING_THRESHOLD);
-    }
-    else if (chunk_size == 0) {
-      MFATAL("ERROR: chunk_size == 0");
+    if (status == chunk_reader::error)
       return 2;
-    }
-    import_file.read(buffer_block, chunk_size);
-    if (! import_file) {
-      if (import_file.eof())
-      {
-        std::cout << refresh_string;
-        MINFO("End of file reached - file was truncated");
-        quit = 1;
-        break;
-      }
-      else
-      {
-        MFATAL("ERROR: unexpected end of file: bytes read before error: "
-            << import_file.gcount() << " of chunk_size " << chunk_size);
-        return 2;
-      }
-    }
-    bytes_read += chunk_size;
+    bytes_read += chunk.bytes;
     MDEBUG("Total bytes read: " << bytes_read);
 
     if (h > block_stop)
@@ -387,26 +569,7 @@ int import_from_file(cryptonote::core& core, const std::string& import_file_path
 
     try
     {
-      str1.assign(buffer_block, chunk_size);
-      bootstrap::block_package bp;
-      bool res;
-      if (major_version == 0)
-      {
-        bootstrap::block_package_1 bp1;
-        res = ::serialization::parse_binary(str1, bp1);
-        if (res)
-        {
-          bp.block = std::move(bp1.block);
-          bp.txs = std::move(bp1.txs);
-          bp.block_weight = bp1.block_weight;
-          bp.cumulative_difficulty = bp1.cumulative_difficulty;
-          bp.coins_generated = bp1.coins_generated;
-        }
-      }
-      else
-        res = ::serialization::parse_binary(str1, bp);
-      if (!res)
-        throw std::runtime_error("Error in deserialization of chunk");
+      bootstrap::block_package &bp = chunk.bp;
 
       int display_interval = 1000;
       int progress_interval = 10;
@@ -435,20 +598,9 @@ int import_from_file(cryptonote::core& core, const std::string& import_file_path
 
         if (opt_verify)
         {
-          cryptonote::blobdata block;
-          cryptonote::block_to_blob(bp.block, block);
-          std::vector<tx_blob_entry> txs;
-          for (const auto &tx: bp.txs)
-          {
-            txs.push_back({cryptonote::blobdata(), crypto::null_hash});
-            cryptonote::tx_to_blob(tx, txs.back().blob);
-          }
-          block_complete_entry bce;
-          bce.pruned = false;
-          bce.block = std::move(block);
-          bce.txs = std::move(txs);
-          blocks.push_back(bce);
-          int ret = check_flush(core, blocks, false);
+          blocks.push_back(std::move(chunk.bce));
+          hashes.push_back(chunk.block_hash);
+          int ret = check_flush(core, blocks, hashes, false);
           if (ret)
           {
             quit = 2; // make sure we don't commit partial block data
@@ -457,6 +609,7 @@ int import_from_file(cryptonote::core& core, const std::string& import_file_path
         }
         else
         {
+          const uint64_t commit_start = epee::misc_utils::get_ns_count();
           std::vector<std::pair<transaction, blobdata>> txs;
           std::vector<transaction> archived_txs;
 
@@ -508,14 +661,15 @@ int import_from_file(cryptonote::core& core, const std::string& import_file_path
               // zero-based height
               std::cout << ENDL << "[- batch commit at height " << h-1 << " -]" << ENDL;
               core.get_blockchain_storage().get_db().batch_stop();
-              pos = import_file.tellg();
-              bytes = bootstrap.count_bytes(import_file, db_batch_size, h2, q2);
-              import_file.seekg(pos);
+              count_file.clear();
+              count_file.seekg(chunk.end_pos);
+              bytes = bootstrap.count_bytes(count_file, db_batch_size, h2, q2);
               core.get_blockchain_storage().get_db().batch_start(db_batch_size, bytes);
               std::cout << ENDL;
               core.get_blockchain_storage().get_db().show_stats();
             }
           }
+          stage_commit_ns += epee::misc_utils::get_ns_count() - commit_start;
         }
         ++num_imported;
       }
@@ -528,12 +682,16 @@ int import_from_file(cryptonote::core& core, const std::string& import_file_path
     }
   } // while
 
+  read_ns = reader.busy_ns();
+  read_chunks = reader.chunks();
+  }
+
 quitting:
   import_file.close();
 
   if (opt_verify)
   {
-    int ret = check_flush(core, blocks, true);
+    int ret = check_flush(core, blocks, hashes, true);
     if (ret)
       return ret;
   }
@@ -552,6 +710,11 @@ quitting:
   }
 
   core.get_blockchain_storage().get_db().show_stats();
+  print_stage_rate("read", read_chunks, read_ns);
+  if (opt_verify)
+    print_stage_rate("verify", stage_verified_blocks, stage_verify_ns);
+  print_stage_rate("commit", opt_verify ? stage_verified_blocks : num_imported, stage_commit_ns);
+  print_stage_rate("total", num_imported, epee::misc_utils::get_ns_count() - import_start);
   MINFO("Number of blocks imported: " << num_imported);
   if (h > 0)
     // TODO: if there was an error, the last added block is probably at zero-based height h-2
@@ -583,6 +746,7 @@ int main(int argc, char* argv[])
   const command_line::arg_descriptor<std::string> arg_log_level   = {"log-level",  "0-4 or categories", ""};
   const command_line::arg_descriptor<uint64_t> arg_block_stop  = {"block-stop", "Stop at block number", block_stop};
   const command_line::arg_descriptor<uint64_t> arg_batch_size  = {"batch-size", "", db_batch_size};
+  const command_line::arg_descriptor<unsigned> arg_threads     = {"threads", "Number of threads verifying transactions and blocks (0 for one per core)", 0};
   const command_line::arg_descriptor<uint64_t> arg_pop_blocks  = {"pop-blocks", "Remove blocks from end of blockchain", num_blocks};
   const command_line::arg_descriptor<bool>        arg_drop_hf  = {"drop-hard-fork", "Drop hard fork subdbs", false};
   const command_line::arg_descriptor<bool>     arg_count_blocks = {
@@ -601,6 +765,7 @@ int main(int argc, char* argv[])
   command_line::add_arg(desc_cmd_sett, arg_log_level);
   command_line::add_arg(desc_cmd_sett, arg_batch_size);
   command_line::add_arg(desc_cmd_sett, arg_block_stop);
+  command_line::add_arg(desc_cmd_sett, arg_threads);
 
   command_line::add_arg(desc_cmd_only, arg_count_blocks);
   command_line::add_arg(desc_cmd_only, arg_pop_blocks);
@@ -634,6 +799,8 @@ int main(int argc, char* argv[])
   opt_resume    = command_line::get_arg(vm, arg_resume);
   block_stop    = command_line::get_arg(vm, arg_block_stop);
   db_batch_size = command_line::get_arg(vm, arg_batch_size);
+  if (!command_line::is_arg_defaulted(vm, arg_threads))
+    tools::set_max_concurrency(command_line::get_arg(vm, arg_threads));
 
   if (command_line::get_arg(vm, command_line::arg_help))
   {
@@ -457,6 +457,7 @@ int main(int argc, char* argv[])
   , "fast:1000"
   };
   const command_line::arg_descriptor<bool> arg_copy_pruned_database  = {"copy-pruned-database",  "Copy database anyway if already pruned"};
+  const command_line::arg_descriptor<bool> arg_in_place  = {"in-place",  "Prune the database where it is instead of copying it: no extra disk space is needed, but the file does not shrink (freed space is reused as the chain grows). Can be interrupted and run again"};
 
   command_line::add_arg(desc_cmd_sett, cryptonote::arg_data_dir);
   command_line::add_arg(desc_cmd_sett, cryptonote::arg_testnet_on);
@@ -464,6 +465,7 @@ int main(int argc, char* argv[])
   command_line::add_arg(desc_cmd_sett, arg_log_level);
   command_line::add_arg(desc_cmd_sett, arg_db_sync_mode);
   command_line::add_arg(desc_cmd_sett, arg_copy_pruned_database);
+  command_line::add_arg(desc_cmd_sett, arg_in_place);
   command_line::add_arg(desc_cmd_only, command_line::arg_help);
 
   po::options_description desc_options("Allowed options");
@@ -499,6 +501,7 @@ int main(int argc, char* argv[])
   bool opt_stagenet = command_line::get_arg(vm, cryptonote::arg_stagenet_on);
   network_type net_type = opt_testnet ? TESTNET : opt_stagenet ? STAGENET : MAINNET;
   bool opt_copy_pruned_database = command_line::get_arg(vm, arg_copy_pruned_database);
+  bool opt_in_place = command_line::get_arg(vm, arg_in_place);
   std::string data_dir = command_line::get_arg(vm, cryptonote::arg_data_dir);
   while (boost::ends_with(data_dir, "/") || boost::ends_with(data_dir, "\\"))
     data_dir.pop_back();
@@ -511,6 +514,40 @@ int main(int argc, char* argv[])
     return 1;
   }
 
+  if (opt_in_place)
+  {
+    std::unique_ptr<BlockchainDB> db(new_db());
+    if (!db)
+    {
+      MERROR("Failed to initialize a database");
+      return 1;
+    }
+    const boost::filesystem::path path = boost::filesystem::path(data_dir) / db->get_db_name();
+    MINFO("Pruning blockchain in " << path << " in place...");
+    try
+    {
+      db->open(path.string(), db_flags);
+      if (!db->m_open)
+      {
+        MERROR("Failed to open database in " << path);
+        return 1;
+      }
+      if (!db->prune_blockchain())
+      {
+        MERROR("Failed to prune blockchain");
+        return 1;
+      }
+      db->close();
+    }
+    catch (const std::exception& e)
+    {
+      MERROR("Error pruning database: " << e.what());
+      return 1;
+    }
+    MINFO("Blockchain pruned OK");
+    return 0;
+  }
+
   // If we wanted to use the memory pool, we would set up a fake_core.
 
   // Use Blockchain instead of lower-level BlockchainDB for two reasons:
@@ -0,0 +1,637 @@
+// Copyright (c) 2021, The Monero Project
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this list of
+//    conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list
+//    of conditions and the following disclaimer in the documentation and/or other
+//    materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its contributors may be
+//    used to endorse or promote products derived from this software without specific
+//    prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+// THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// Replays the txs of a range of blocks from a bootstrap file (made with monero-blockchain-export) through the
+// verification stages a node runs on them (parse, semantics, range proofs, ring signatures), reading ring members
+// from an existing database opened read only, and reports the time spent in each stage.
+//
+// With --verification-jobs-address and --verification-results-address, the stages that need no database run on
+// verification workers instead (this tool started with --verification-worker, on any number of machines), which
+// receive each batch of txs with its ring members.
+
+#include <atomic>
+#include <fstream>
+#include <iomanip>
+#include <unordered_map>
+
+#include <boost/filesystem.hpp>
+#include "common/command_line.h"
+#include "common/util.h"
+#include "bootstrap_file.h"
+#include "bootstrap_serialization.h"
+#include "blockchain_db/blockchain_db.h"
+#include "cryptonote_basic/cryptonote_format_utils.h"
+#include "cryptonote_core/cryptonote_core.h"
+#include "cryptonote_core/tx_verification_batch.h"
+#include "misc_os_dependent.h"
+#include "ringct/rctOps.h"
+#include "ringct/rctSigs.h"
+#include "rpc/zmq_verification.h"
+#include "serialization/binary_utils.h" // parse_binary()
+#include "version.h"
+
+#undef MONERO_DEFAULT_LOG_CATEGORY
+#define MONERO_DEFAULT_LOG_CATEGORY "bcutil"
+
+namespace po = boost::program_options;
+using namespace epee;
+using namespace cryptonote;
+
+namespace
+{
+
+std::atomic<bool> stop_requested{false};
+
+enum replay_stage
+{
+  STAGE_READ,  // file reads and bootstrap chunk decoding (not part of verification)
+  STAGE_PARSE,  // block and tx blobs -> objects, tx hashes
+  STAGE_SEMANTICS,  // context free tx checks (core::check_tx_semantic), block tx hashes
+  STAGE_RING_MEMBERS,  // ring member lookups in the database
+  STAGE_RANGE_PROOFS,  // ringct semantics: range proofs and amount balance (batched per block, as in a node)
+  STAGE_RING_SIGNATURES,  // MLSAG/CLSAG (or pre-ringct ring signatures)
+  STAGE_REMOTE,  // waiting on verification workers (semantics, range proofs and ring signatures run there)
+  NUM_STAGES
+};
+
+const char *const stage_names[NUM_STAGES] = {
+  "read", "parse", "semantics", "ring members", "range proofs", "ring signatures", "workers (wait)"
+};
+
+struct replay_stats
+{
+  uint64_t ns[NUM_STAGES]{};
+  uint64_t blocks{0};
+  uint64_t txs{0};
+  uint64_t inputs{0};
+  uint64_t failed_txs{0};
+};
+
+// adds the time from construction to destruction to one stage
+class stage_timer
+{
+public:
+  stage_timer(replay_stats &stats, const replay_stage stage)
+    : m_stats(stats), m_stage(stage), m_start(epee::misc_utils::get_ns_count())
+  {}
+  ~stage_timer()
+  {
+    m_stats.ns[m_stage] += epee::misc_utils::get_ns_count() - m_start;
+  }
+
+private:
+  replay_stats &m_stats;
+  const replay_stage m_stage;
+  const uint64_t m_start;
+};
+
+// one block as it would arrive from a peer
+struct replay_block
+{
+  blobdata block_blob;
+  std::vector<blobdata> tx_blobs;
+};
+
+// a tx being replayed
+struct replay_tx
+{
+  transaction tx;
+  crypto::hash hash;
+  std::vector<std::vector<rct::ctkey>> ring_members;
+  bool failed{false};
+};
+
+// read the next chunk of a bootstrap file; returns false at the end of the file
+bool read_chunk(std::ifstream &import_file, const uint8_t major_version, std::string &buffer, replay_block &block_out)
+{
+  uint32_t chunk_size;
+  char chunk_size_buffer[sizeof(chunk_size)];
+  import_file.read(chunk_size_buffer, sizeof(chunk_size));
+  if (!import_file)
+    return false;
+  if (!::serialization::parse_binary(std::string(chunk_size_buffer, sizeof(chunk_size)), chunk_size))
+    throw std::runtime_error("Error in deserialization of chunk size");
+  if (chunk_size == 0 || chunk_size > BUFFER_SIZE)
+    throw std::runtime_error("Invalid chunk size: " + std::to_string(chunk_size));
+
+  buffer.resize(chunk_size);
+  import_file.read(&buffer[0], chunk_size);
+  if (!import_file)
+    return false;
+
+  bootstrap::block_package bp;
+  bool r;
+  if (major_version == 0)
+  {
+    bootstrap::block_package_1 bp1;
+    r = ::serialization::parse_binary(buffer, bp1);
+    bp.block = std::move(bp1.block);
+    bp.txs = std::move(bp1.txs);
+  }
+  else
+    r = ::serialization::parse_binary(buffer, bp);
+  if (!r)
+    throw std::runtime_error("Error in deserialization of chunk");
+
+  // back to blobs, so the parse stage starts from the same bytes a node gets
+  block_out.block_blob = block_to_blob(bp.block);
+  block_out.tx_blobs.clear();
+  block_out.tx_blobs.reserve(bp.txs.size());
+  for (const transaction &tx : bp.txs)
+    block_out.tx_blobs.push_back(tx_to_blob(tx));
+
+  return true;
+}
+
+// parse a block and its txs, and check the txs against the block's tx hashes
+block parse_block_txs(const replay_block &rblock, std::vector<replay_tx> &txs, replay_stats &stats)
+{
+  stage_timer timer(stats, STAGE_PARSE);
+  block b;
+  if (!parse_and_validate_block_from_blob(rblock.block_blob, b))
+    throw std::runtime_error("Failed to parse block");
+  if (b.tx_hashes.size() != rblock.tx_blobs.size())
+    throw std::runtime_error("Block and bootstrap chunk have different tx counts");
+
+  txs.clear();
+  txs.resize(rblock.tx_blobs.size());
+  for (size_t i = 0; i < txs.size(); ++i)
+  {
+    if (!parse_and_validate_tx_from_blob(rblock.tx_blobs[i], txs[i].tx, txs[i].hash) || txs[i].hash != b.tx_hashes[i])
+      txs[i].failed = true;
+  }
+  return b;
+}
+
+// look up the ring members of the txs that did not fail yet
+void get_ring_members(const BlockchainDB &db, std::vector<replay_tx> &txs, replay_stats &stats)
+{
+  stage_timer timer(stats, STAGE_RING_MEMBERS);
+  std::vector<output_data_t> outputs;
+  for (replay_tx &rtx : txs)
+  {
+    if (rtx.failed)
+      continue;
+    rtx.ring_members.resize(rtx.tx.vin.size());
+    for (size_t n = 0; n < rtx.tx.vin.size() && !rtx.failed; ++n)
+    {
+      // semantics may not have been checked yet (remote verification)
+      const txin_to_key *in = boost::get<txin_to_key>(&rtx.tx.vin[n]);
+      if (!in)
+      {
+        rtx.failed = true;
+        break;
+      }
+      try
+      {
+        db.get_output_key(epee::span<const uint64_t>(&in->amount, 1),
+          relative_output_offsets_to_absolute(in->key_offsets),
+          outputs);
+      }
+      catch (const std::exception &e)
+      {
+        MERROR("Failed to read ring members of tx " << rtx.hash << ": " << e.what());
+        rtx.failed = true;
+        break;
+      }
+      rtx.ring_members[n].clear();
+      rtx.ring_members[n].reserve(outputs.size());
+      for (const output_data_t &output : outputs)
+        rtx.ring_members[n].push_back({rct::pk2rct(output.pubkey), output.commitment});
+    }
+    stats.inputs += rtx.tx.vin.size();
+  }
+}
+
+void report_failed_tx(const crypto::hash &hash, const uint64_t height, replay_stats &stats)
+{
+  MERROR("Tx failed verification: " << hash << " (block " << height << ")");
+  ++stats.failed_txs;
+}
+
+// run one block's txs through all verification stages
+void replay_block_txs(const BlockchainDB &db, const replay_block &rblock, replay_stats &stats)
+{
+  std::vector<replay_tx> txs;
+  const block b = parse_block_txs(rblock, txs, stats);
+
+  {
+    stage_timer timer(stats, STAGE_SEMANTICS);
+    for (replay_tx &rtx : txs)
+    {
+      if (!rtx.failed && !check_tx_semantics_stateless(rtx.tx, b.major_version))
+        rtx.failed = true;
+    }
+  }
+
+  get_ring_members(db, txs, stats);
+
+  {
+    stage_timer timer(stats, STAGE_RANGE_PROOFS);
+    std::vector<const rct::rctSig*> batch;
+    std::vector<replay_tx*> batch_txs;
+    for (replay_tx &rtx : txs)
+    {
+      if (rtx.failed || rtx.tx.version == 1)
+        continue;
+      if (!expand_rct_signatures(rtx.tx, rtx.ring_members))
+        rtx.failed = true;
+      else if (rtx.tx.rct_signatures.type == rct::RCTTypeFull)
+        rtx.failed = !rct::verRct(rtx.tx.rct_signatures, true);
+      else
+      {
+        batch.push_back(&rtx.tx.rct_signatures);
+        batch_txs.push_back(&rtx);
+      }
+    }
+
+    // if the batch fails, find the txs that failed it
+    if (!batch.empty() && !rct::verRctSemanticsSimple(batch))
+    {
+      for (replay_tx *rtx : batch_txs)
+        rtx->failed = !rct::verRctSemanticsSimple(rtx->tx.rct_signatures);
+    }
+  }
+
+  {
+    stage_timer timer(stats, STAGE_RING_SIGNATURES);
+    for (replay_tx &rtx : txs)
+    {
+      if (rtx.failed)
+        continue;
+      if (rtx.tx.version == 1)
+        rtx.failed = !check_v1_ring_signatures(rtx.tx, rtx.ring_members);
+      else if (rtx.tx.rct_signatures.type == rct::RCTTypeFull)
+        rtx.failed = !rct::verRct(rtx.tx.rct_signatures, false);
+      else
+        rtx.failed = !rct::verRctNonSemanticsSimple(rtx.tx.rct_signatures);
+    }
+  }
+
+  for (const replay_tx &rtx : txs)
+  {
+    if (rtx.failed)
+      report_failed_tx(rtx.hash, get_block_height(b), stats);
+  }
+  ++stats.blocks;
+  stats.txs += txs.size();
+}
+
+// ships txs (with their ring members) to verification workers in batches, and collects the verdicts
+class remote_verifier
+{
+public:
+  remote_verifier(rpc::ZmqVerificationCoordinator &coordinator, const size_t batch_size, const size_t max_in_flight,
+      replay_stats &stats)
+    : m_coordinator(coordinator), m_batch_size(batch_size), m_max_in_flight(max_in_flight), m_stats(stats)
+  {}
+
+  void add(const replay_tx &rtx, blobdata tx_blob, const uint64_t height, const uint8_t hf_version)
+  {
+    // a batch is verified at one hard fork version
+    if (!m_jobs.empty() && hf_version != m_hf_version)
+      flush();
+    m_hf_version = hf_version;
+    m_jobs.push_back({std::move(tx_blob), rtx.ring_members});
+    m_tx_ids.push_back({rtx.hash, height});
+    if (m_jobs.size() >= m_batch_size)
+      flush();
+  }
+
+  // submit the partial batch, and wait for every verdict
+  void finish()
+  {
+    flush();
+    while (m_coordinator.in_flight())
+      collect();
+  }
+
+private:
+  struct tx_id
+  {
+    crypto::hash hash;
+    uint64_t height;
+  };
+
+  void flush()
+  {
+    if (m_jobs.empty())
+      return;
+    while (m_coordinator.in_flight() >= m_max_in_flight)
+      collect();
+
+    stage_timer timer(m_stats, STAGE_REMOTE);
+    const uint64_t batch_id = MONERO_UNWRAP(m_coordinator.submit(std::move(m_jobs), m_hf_version));
+    m_batches.emplace(batch_id, std::move(m_tx_ids));
+    m_jobs.clear();
+    m_tx_ids.clear();
+  }
+
+  void collect()
+  {
+    stage_timer timer(m_stats, STAGE_REMOTE);
+    const tx_verification_result result = MONERO_UNWRAP(m_coordinator.next_result());
+    const auto batch = m_batches.find(result.batch_id);
+    if (batch == m_batches.end() || batch->second.size() != result.verdicts.size())
+      throw std::runtime_error("Unexpected verification result for batch " + std::to_string(result.batch_id));
+    for (size_t i = 0; i < result.verdicts.size(); ++i)
+    {
+      if (!result.verdicts[i])
+        report_failed_tx(batch->second[i].hash, batch->second[i].height, m_stats);
+    }
+    m_batches.erase(batch);
+  }
+
+  rpc::ZmqVerificationCoordinator &m_coordinator;
+  const size_t m_batch_size;
+  const size_t m_max_in_flight;
+  replay_stats &m_stats;
+
+  uint8_t m_hf_version{0};
+  std::vector<tx_verification_job> m_jobs;
+  std::vector<tx_id> m_tx_ids;
+  std::unordered_map<uint64_t, std::vector<tx_id>> m_batches;
+};
+
+// parse one block's txs and look up their ring members here; everything else runs on the workers
+void replay_block_txs_remote(const BlockchainDB &db, replay_block &rblock, remote_verifier &verifier, replay_stats &stats)
+{
+  std::vector<replay_tx> txs;
+  const block b = parse_block_txs(rblock, txs, stats);
+  get_ring_members(db, txs, stats);
+
+  const uint64_t height = get_block_height(b);
+  for (size_t i = 0; i < txs.size(); ++i)
+  {
+    if (txs[i].failed)
+      report_failed_tx(txs[i].hash, height, stats);
+    else
+      verifier.add(txs[i], std::move(rblock.tx_blobs[i]), height, b.major_version);
+  }
+  ++stats.blocks;
+  stats.txs += txs.size();
+}
+
+void print_report(const replay_stats &stats)
+{
+  uint64_t verify_ns = 0;
+  for (size_t stage = STAGE_PARSE; stage < NUM_STAGES; ++stage)
+    verify_ns += stats.ns[stage];
+
+  std::cout << ENDL << "Replayed " << stats.blocks << " blocks, " << stats.txs << " txs, " << stats.inputs << " inputs ("
+    << stats.failed_txs << " txs failed)" << ENDL;
+  std::cout << std::left << std::setw(18) << "stage" << std::right << std::setw(12) << "seconds" << std::setw(14)
+    << "us/tx" << std::setw(10) << "share" << ENDL;
+  for (size_t stage = 0; stage < NUM_STAGES; ++stage)
+  {
+    std::cout << std::left << std::setw(18) << stage_names[stage] << std::right << std::fixed
+      << std::setw(12) << std::setprecision(3) << stats.ns[stage] / 1e9
+      << std::setw(14) << std::setprecision(1) << (stats.txs ? stats.ns[stage] / 1e3 / stats.txs : 0.0);
+    if (stage == STAGE_READ)
+      std::cout << std::setw(10) << "-" << ENDL;
+    else
+      std::cout << std::setw(9) << std::setprecision(1) << (verify_ns ? 100.0 * stats.ns[stage] / verify_ns : 0.0)
+        << "%" << ENDL;
+  }
+  std::cout << "verification: " << std::setprecision(3) << verify_ns / 1e9 << " s, "
+    << std::setprecision(1) << (verify_ns ? stats.txs * 1e9 / verify_ns : 0.0) << " txs/s" << ENDL;
+}
+
+} // anonymous namespace
+
+int main(int argc, char* argv[])
+{
+  TRY_ENTRY();
+
+  epee::string_tools::set_module_name_and_folder(argv[0]);
+
+  uint32_t log_level = 0;
+
+  tools::on_startup();
+
+  po::options_description desc_cmd_only("Command line options");
+  po::options_description desc_cmd_sett("Command line options and settings options");
+  const command_line::arg_descriptor<std::string> arg_log_level  = {"log-level",  "0-4 or categories", ""};
+  const command_line::arg_descriptor<std::string> arg_input_file = {"input-file", "Bootstrap file to replay (default: <data-dir>/export/" BLOCKCHAIN_RAW ")", ""};
+  const command_line::arg_descriptor<uint64_t> arg_block_start  = {"block-start", "Replay from this block height", 0};
+  const command_line::arg_descriptor<uint64_t> arg_block_stop = {"block-stop", "Stop after this block height (0 = end of the file)", 0};
+  const command_line::arg_descriptor<bool> arg_worker = {"verification-worker", "Verify batches from a replay coordinator instead of replaying", false};
+  const command_line::arg_descriptor<std::string> arg_jobs_address = {"verification-jobs-address", "ZMQ address batches go out on (bound by the coordinator, connected to by workers), e.g. tcp://0.0.0.0:18090", ""};
+  const command_line::arg_descriptor<std::string> arg_results_address = {"verification-results-address", "ZMQ address verdicts come back on (bound by the coordinator, connected to by workers)", ""};
+  const command_line::arg_descriptor<uint64_t> arg_batch_size = {"verification-batch-size", "Txs per batch sent to a worker", 64};
+  const command_line::arg_descriptor<uint64_t> arg_max_in_flight = {"verification-max-in-flight", "Batches sent to workers and not answered yet, before the coordinator waits", 64};
+  const command_line::arg_descriptor<uint64_t> arg_worker_threads = {"verification-worker-threads", "Batches a worker verifies at once (0 = number of cores)", 0};
+
+  command_line::add_arg(desc_cmd_sett, cryptonote::arg_data_dir);
+  command_line::add_arg(desc_cmd_sett, cryptonote::arg_testnet_on);
+  command_line::add_arg(desc_cmd_sett, cryptonote::arg_stagenet_on);
+  command_line::add_arg(desc_cmd_sett, arg_log_level);
+  command_line::add_arg(desc_cmd_sett, arg_input_file);
+  command_line::add_arg(desc_cmd_sett, arg_block_start);
+  command_line::add_arg(desc_cmd_sett, arg_block_stop);
+  command_line::add_arg(desc_cmd_sett, arg_worker);
+  command_line::add_arg(desc_cmd_sett, arg_jobs_address);
+  command_line::add_arg(desc_cmd_sett, arg_results_address);
+  command_line::add_arg(desc_cmd_sett, arg_batch_size);
+  command_line::add_arg(desc_cmd_sett, arg_max_in_flight);
+  command_line::add_arg(desc_cmd_sett, arg_worker_threads);
+  command_line::add_arg(desc_cmd_only, command_line::arg_help);
+
+  po::options_description desc_options("Allowed options");
+  desc_options.add(desc_cmd_only).add(desc_cmd_sett);
+
+  po::variables_map vm;
+  bool r = command_line::handle_error_helper(desc_options, [&]()
+  {
+    auto parser = po::command_line_parser(argc, argv).options(desc_options);
+    po::store(parser.run(), vm);
+    po::notify(vm);
+    return true;
+  });
+  if (! r)
+    return 1;
+
+  if (command_line::get_arg(vm, command_line::arg_help))
+  {
+    std::cout << "Monero '" << MONERO_RELEASE_NAME << "' (v" << MONERO_VERSION_FULL << ")" << ENDL << ENDL;
+    std::cout << desc_options << std::endl;
+    return 1;
+  }
+
+  mlog_configure(mlog_get_default_log_path("monero-blockchain-replay.log"), true);
+  if (!command_line::is_arg_defaulted(vm, arg_log_level))
+    mlog_set_log(command_line::get_arg(vm, arg_log_level).c_str());
+  else
+    mlog_set_log(std::string(std::to_string(log_level) + ",bcutil:INFO").c_str());
+
+  LOG_PRINT_L0("Starting...");
+
+  const std::string jobs_address = command_line::get_arg(vm, arg_jobs_address);
+  const std::string results_address = command_line::get_arg(vm, arg_results_address);
+  const bool remote = !jobs_address.empty() || !results_address.empty();
+  if (remote && (jobs_address.empty() || results_address.empty()))
+  {
+    std::cerr << "Both --" << arg_jobs_address.name << " and --" << arg_results_address.name << " are needed" << std::endl;
+    return 1;
+  }
+
+  if (command_line::get_arg(vm, arg_worker))
+  {
+    if (!remote)
+    {
+      std::cerr << "A verification worker needs the coordinator's addresses" << std::endl;
+      return 1;
+    }
+    uint64_t threads = command_line::get_arg(vm, arg_worker_threads);
+    if (threads == 0)
+      threads = tools::get_max_concurrency();
+
+    rpc::ZmqVerificationWorker worker;
+    if (!worker.init(jobs_address, results_address, threads))
+      return 1;
+    tools::signal_handler::install([](int type) {
+      stop_requested = true;
+    });
+    MINFO("Verifying batches from " << jobs_address << " with " << threads << " threads");
+    worker.run();
+    while (!stop_requested)
+      boost::this_thread::sleep_for(boost::chrono::milliseconds(100));
+    worker.stop();
+    return 0;
+  }
+
+  std::string opt_data_dir = command_line::get_arg(vm, cryptonote::arg_data_dir);
+  const uint64_t block_start = command_line::get_arg(vm, arg_block_start);
+  uint64_t block_stop = command_line::get_arg(vm, arg_block_stop);
+  std::string import_file_path = command_line::get_arg(vm, arg_input_file);
+  if (import_file_path.empty())
+    import_file_path = (boost::filesystem::path(opt_data_dir) / "export" / BLOCKCHAIN_RAW).string();
+
+  // ring members come from an existing database; nothing is written to it
+  LOG_PRINT_L0("Initializing source blockchain (BlockchainDB)");
+  std::unique_ptr<BlockchainDB> db(new_db());
+  if (!db)
+  {
+    LOG_ERROR("Failed to initialize a database");
+    return 1;
+  }
+  const std::string filename = (boost::filesystem::path(opt_data_dir) / db->get_db_name()).string();
+  LOG_PRINT_L0("Loading blockchain from folder " << filename << " ...");
+  try
+  {
+    db->open(filename, DBF_RDONLY);
+  }
+  catch (const std::exception& e)
+  {
+    LOG_PRINT_L0("Error opening database: " << e.what());
+    return 1;
+  }
+
+  std::ifstream import_file(import_file_path, std::ios_base::binary | std::ifstream::in);
+  if (import_file.fail())
+  {
+    LOG_PRINT_L0("Failed to open bootstrap file " << import_file_path);
+    return 1;
+  }
+
+  BootstrapFile bootstrap;
+  uint8_t major_version, minor_version;
+  uint64_t block_first, block_last;
+  bootstrap.seek_to_first_chunk(import_file, major_version, minor_version, block_first, block_last);
+  if (!block_stop || block_stop > block_last)
+    block_stop = block_last;
+  if (block_stop >= db->height())
+    MWARNING("The database (height " << db->height() << ") does not have all the blocks to replay, ring members "
+      "from the missing ones will not be found");
+
+  tools::signal_handler::install([](int type) {
+    stop_requested = true;
+  });
+
+  // skip to the first block to replay
+  uint64_t height = block_first;
+  if (block_start > height)
+  {
+    uint64_t skipped = 0;
+    bool quit = false;
+    bootstrap.count_bytes(import_file, block_start - height, skipped, quit);
+    height += skipped;
+    if (quit)
+    {
+      LOG_PRINT_L0("Bootstrap file ends before block " << block_start);
+      return 1;
+    }
+  }
+  MINFO("Replaying blocks " << height << " to " << block_stop << " from " << import_file_path);
+
+  std::unique_ptr<rpc::ZmqVerificationCoordinator> coordinator;
+  std::unique_ptr<remote_verifier> verifier;
+  replay_stats stats;
+  if (remote)
+  {
+    const uint64_t batch_size = command_line::get_arg(vm, arg_batch_size);
+    const uint64_t max_in_flight = command_line::get_arg(vm, arg_max_in_flight);
+    if (batch_size == 0 || max_in_flight == 0)
+    {
+      std::cerr << "Batch size and batches in flight must be positive" << std::endl;
+      return 1;
+    }
+    coordinator.reset(new rpc::ZmqVerificationCoordinator());
+    if (!coordinator->init(jobs_address, results_address))
+      return 1;
+    verifier.reset(new remote_verifier(*coordinator, batch_size, max_in_flight, stats));
+    MINFO("Sending batches of " << batch_size << " txs to verification workers at " << jobs_address);
+  }
+
+  std::string buffer;
+  replay_block rblock;
+  for (; height <= block_stop && !stop_requested; ++height)
+  {
+    {
+      stage_timer timer(stats, STAGE_READ);
+      if (!read_chunk(import_file, major_version, buffer, rblock))
+        break;
+    }
+    if (verifier)
+      replay_block_txs_remote(*db, rblock, *verifier, stats);
+    else
+      replay_block_txs(*db, rblock, stats);
+
+    if (height % 1000 == 0)
+      std::cout << "\r" << "block height: " << height << "    \r" << std::flush;
+  }
+
+  if (verifier)
+    verifier->finish();
+  print_report(stats);
+
+  db->close();
+  return stats.failed_txs == 0 ? 0 : 1;
+
+  CATCH_ENTRY("Replay error", 1);
+}
@@ -32,6 +32,9 @@
 #include <stdint.h>
 #include <string.h>
 #include "aligned.h"
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
 
 static inline int is_power_of_2(size_t n) { return n && (n & (n-1)) == 0; }
 
@@ -54,12 +57,87 @@ typedef struct
   void *raw;
   size_t bytes;
   size_t align;
+  size_t mapped; /* size of the mapping at 'raw', or 0 if 'raw' is from malloc */
 } control;
 
+static int huge_pages_mode = ALIGNED_HUGE_PAGES_OFF;
+
+int aligned_set_huge_pages(int mode)
+{
+  if (mode != ALIGNED_HUGE_PAGES_OFF && mode != ALIGNED_HUGE_PAGES_THP && mode != ALIGNED_HUGE_PAGES_HUGETLB)
+    return -1;
+#if !defined(__linux__) || !defined(MADV_HUGEPAGE)
+  if (mode != ALIGNED_HUGE_PAGES_OFF)
+    return -1;
+#endif
+  huge_pages_mode = mode;
+  return 0;
+}
+
+int aligned_get_huge_pages(void)
+{
+  return huge_pages_mode;
+}
+
+void aligned_advise_huge_pages(void *ptr, size_t bytes)
+{
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+  uintptr_t begin, end;
+
+  if (huge_pages_mode == ALIGNED_HUGE_PAGES_OFF || !ptr || bytes < ALIGNED_HUGE_PAGE_SIZE)
+    return;
+  begin = ((uintptr_t)ptr + ALIGNED_HUGE_PAGE_SIZE - 1) & ~(uintptr_t)(ALIGNED_HUGE_PAGE_SIZE - 1);
+  end = ((uintptr_t)ptr + bytes) & ~(uintptr_t)(ALIGNED_HUGE_PAGE_SIZE - 1);
+  if (begin < end)
+    madvise((void*)begin, end - begin, MADV_HUGEPAGE);
+#else
+  (void)ptr;
+  (void)bytes;
+#endif
+}
+
+/* map 'size' bytes (a multiple of the huge page size) backed by huge pages, or return NULL */
+static void *map_huge_pages(size_t size)
+{
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+  void *raw;
+  uintptr_t begin;
+  size_t head;
+
+#ifdef MAP_HUGETLB
+  if (huge_pages_mode == ALIGNED_HUGE_PAGES_HUGETLB)
+  {
+    raw = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (raw != MAP_FAILED)
+      return raw;
+  }
+#endif
+
+  /* transparent huge pages only back whole aligned huge pages: over-map, then trim to a huge page boundary */
+  if (size > (size_t)-1 - ALIGNED_HUGE_PAGE_SIZE)
+    return NULL;
+  raw = mmap(NULL, size + ALIGNED_HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (raw == MAP_FAILED)
+    return NULL;
+  begin = ((uintptr_t)raw + ALIGNED_HUGE_PAGE_SIZE - 1) & ~(uintptr_t)(ALIGNED_HUGE_PAGE_SIZE - 1);
+  head = begin - (uintptr_t)raw;
+  if (head)
+    munmap(raw, head);
+  if (ALIGNED_HUGE_PAGE_SIZE - head)
+    munmap((void*)(begin + size), ALIGNED_HUGE_PAGE_SIZE - head);
+  madvise((void*)begin, size, MADV_HUGEPAGE);
+  return (void*)begin;
+#else
+  (void)size;
+  return NULL;
+#endif
+}
+
 void *aligned_malloc(size_t bytes, size_t align)
 {
   void *raw, *ptr;
   control *ctrl;
+  size_t mapped = 0, header;
 
   if (!is_power_of_2(align))
     return NULL;
@@ -68,22 +146,54 @@ void *aligned_malloc(size_t bytes, size_t align)
   if (bytes + align > (size_t)-1 - sizeof(control))
     return NULL;
 
-  raw = malloc(bytes + sizeof(control) + align);
+  raw = NULL;
+  if (huge_pages_mode != ALIGNED_HUGE_PAGES_OFF && bytes >= ALIGNED_HUGE_PAGE_SIZE && align <= ALIGNED_HUGE_PAGE_SIZE)
+  {
+    /* the mapping starts on a huge page boundary, so the control block just needs to fit below 'align' */
+    header = (sizeof(control) + align - 1) & ~(align-1);
+    if (bytes <= (size_t)-1 - header - ALIGNED_HUGE_PAGE_SIZE)
+    {
+      mapped = (bytes + header + ALIGNED_HUGE_PAGE_SIZE - 1) & ~(ALIGNED_HUGE_PAGE_SIZE - 1);
+      raw = map_huge_pages(mapped);
+      if (raw)
+        ptr = (void*)((uintptr_t)raw + header);
+      else
+        mapped = 0;
+    }
+  }
   if (!raw)
-    return NULL;
-  ptr = (void*)(((uintptr_t)raw + align + sizeof(control) - 1) & ~(align-1));
+  {
+    raw = malloc(bytes + sizeof(control) + align);
+    if (!raw)
+      return NULL;
+    ptr = (void*)(((uintptr_t)raw + align + sizeof(control) - 1) & ~(align-1));
+  }
   ctrl = ((control*)ptr) - 1;
   ctrl->magic = MAGIC;
   ctrl->raw = raw;
   ctrl->bytes = bytes;
   ctrl->align = align;
+  ctrl->mapped = mapped;
   return ptr;
 }
 
+static void release(control *ctrl)
+{
+  ctrl->magic = MAGIC_FREED;
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+  if (ctrl->mapped)
+  {
+    munmap(ctrl->raw, ctrl->mapped);
+    return;
+  }
+#endif
+  free(ctrl->raw);
+}
+
 void *aligned_realloc(void *ptr, size_t bytes, size_t align)
 {
-  void *raw, *ptr2;
-  control *ctrl, *ctrl2;
+  void *ptr2;
+  control *ctrl;
 
   if (!ptr)
     return aligned_malloc(bytes, align);
@@ -105,23 +215,11 @@ void *aligned_realloc(void *ptr, size_t bytes, size_t align)
   if (ctrl->bytes >= bytes)
     return ptr;
 
-  if (ctrl->bytes > (size_t)-1 - ctrl->align)
-    return NULL;
-  if (ctrl->bytes + ctrl->align > (size_t)-1 - sizeof(control))
+  ptr2 = aligned_malloc(bytes, ctrl->align);
+  if (!ptr2)
     return NULL;
-
-  raw = malloc(bytes + sizeof(control) + ctrl->align);
-  if (!raw)
-    return NULL;
-  ptr2 = (void*)(((uintptr_t)raw + ctrl->align + sizeof(control) - 1) & ~(ctrl->align-1));
   memcpy(ptr2, ptr, ctrl->bytes);
-  ctrl2 = ((control*)ptr2) - 1;
-  ctrl2->magic = MAGIC;
-  ctrl2->raw = raw;
-  ctrl2->bytes = bytes;
-  ctrl2->align = ctrl->align;
-  ctrl->magic = MAGIC_FREED;
-  free(ctrl->raw);
+  release(ctrl);
   return ptr2;
 }
 
@@ -134,6 +232,5 @@ void aligned_free(void *ptr)
     local_abort("Double free detected");
   if (ctrl->magic != MAGIC)
     local_abort("Freeing unallocated memory");
-  ctrl->magic = MAGIC_FREED;
-  free(ctrl->raw);
+  release(ctrl);
 }
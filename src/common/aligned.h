@@ -36,6 +36,19 @@ void *aligned_malloc(size_t bytes, size_t align);
 void *aligned_realloc(void *ptr, size_t bytes, size_t align);
 void aligned_free(void *ptr);
 
+/* Huge page backing for large allocations (at least ALIGNED_HUGE_PAGE_SIZE bytes), to cut TLB misses when big
+   buffers are walked at random (multiexp data, ledger arrays). Off by default; Linux only.
+   - THP: large allocations are mapped at huge page boundaries and madvise()d for transparent huge pages
+   - HUGETLB: large allocations come from the reserved huge page pool (MAP_HUGETLB), or as with THP if it is empty
+   Set the mode before allocating from several threads. Returns 0, or -1 if the mode isn't supported here. */
+#define ALIGNED_HUGE_PAGE_SIZE ((size_t)2 << 20)
+enum aligned_huge_pages_mode { ALIGNED_HUGE_PAGES_OFF = 0, ALIGNED_HUGE_PAGES_THP = 1, ALIGNED_HUGE_PAGES_HUGETLB = 2 };
+int aligned_set_huge_pages(int mode);
+int aligned_get_huge_pages(void);
+/* Ask for transparent huge pages over the whole huge pages inside a buffer that wasn't allocated here (e.g. a large
+   std::vector reserve), if huge pages are enabled. Best done before the buffer is first written. */
+void aligned_advise_huge_pages(void *ptr, size_t bytes);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,200 @@
+// Copyright (c) 2021, The Monero Project
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of
+//    conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list
+//    of conditions and the following disclaimer in the documentation and/or other
+//    materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be
+//    used to endorse or promote products derived from this software without specific
+//    prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+// THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <cmath>
+#include <limits>
+#include <mutex>
+#include <stdio.h>
+#include "perf_timer.h"
+#include "metrics.h"
+
+namespace tools
+{
+
+namespace
+{
+  struct metrics_registry
+  {
+    std::mutex mutex;
+    std::vector<const MetricsHistogram*> histograms;
+  };
+
+  metrics_registry &get_metrics_registry()
+  {
+    static metrics_registry registry;
+    return registry;
+  }
+
+  std::string format_value(double value)
+  {
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%.9g", value);
+    return buf;
+  }
+}
+
+MetricsHistogram::MetricsHistogram(const char *name, const char *help, double scale):
+  name(name), help(help), scale(scale), count(0), sum(0)
+{
+  for (auto &b: buckets)
+    b.store(0, std::memory_order_relaxed);
+  metrics_registry &registry = get_metrics_registry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  registry.histograms.push_back(this);
+}
+
+void MetricsHistogram::add(uint64_t value)
+{
+  size_t bucket = 0;
+  for (uint64_t v = value >> 1; v; v >>= 1)
+    ++bucket;
+  count.fetch_add(1, std::memory_order_relaxed);
+  sum.fetch_add(value, std::memory_order_relaxed);
+  buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+}
+
+void PrometheusWriter::header(const std::string &name, const std::string &help, const char *type)
+{
+  out += "# HELP " + name + " " + help + "\n";
+  out += "# TYPE " + name + " " + type + "\n";
+}
+
+void PrometheusWriter::write_labels(const labels_t &labels, const char *le)
+{
+  if (labels.empty() && !le)
+    return;
+  out += '{';
+  bool first = true;
+  for (const auto &label: labels)
+  {
+    if (!first)
+      out += ',';
+    first = false;
+    out += label.first + "=\"";
+    for (char c: label.second)
+    {
+      if (c == '\\' || c == '"')
+        out += '\\';
+      if (c == '\n')
+        out += "\\n";
+      else
+        out += c;
+    }
+    out += '"';
+  }
+  if (le)
+  {
+    if (!first)
+      out += ',';
+    out += std::string("le=\"") + le + '"';
+  }
+  out += '}';
+}
+
+void PrometheusWriter::sample(const std::string &name, const labels_t &labels, double value)
+{
+  out += name;
+  write_labels(labels);
+  out += ' ' + format_value(value) + '\n';
+}
+
+void PrometheusWriter::sample(const std::string &name, const labels_t &labels, uint64_t value)
+{
+  out += name;
+  write_labels(labels);
+  out += ' ' + std::to_string(value) + '\n';
+}
+
+void PrometheusWriter::histogram(const std::string &name, const labels_t &labels, double sum,
+  const std::vector<std::pair<double, uint64_t>> &buckets)
+{
+  uint64_t count = 0;
+  for (const auto &bucket: buckets)
+    count += bucket.second;
+  size_t used = buckets.size();
+  while (used > 0 && (buckets[used - 1].second == 0 || std::isinf(buckets[used - 1].first)))
+    --used;
+  uint64_t cumulative = 0;
+  for (size_t b = 0; b < used; ++b)
+  {
+    cumulative += buckets[b].second;
+    out += name + "_bucket";
+    write_labels(labels, format_value(buckets[b].first).c_str());
+    out += ' ' + std::to_string(cumulative) + '\n';
+  }
+  out += name + "_bucket";
+  write_labels(labels, "+Inf");
+  out += ' ' + std::to_string(count) + '\n';
+  sample(name + "_sum", labels, sum);
+  sample(name + "_count", labels, count);
+}
+
+void PrometheusWriter::counter(const std::string &name, const std::string &help, uint64_t value)
+{
+  header(name, help, "counter");
+  sample(name, {}, value);
+}
+
+void PrometheusWriter::gauge(const std::string &name, const std::string &help, double value)
+{
+  header(name, help, "gauge");
+  sample(name, {}, value);
+}
+
+void write_metrics(PrometheusWriter &writer)
+{
+  {
+    metrics_registry &registry = get_metrics_registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    for (const MetricsHistogram *h: registry.histograms)
+    {
+      // bucket b holds values up to 2^(b+1) - 1
+      std::vector<std::pair<double, uint64_t>> buckets(METRICS_HISTOGRAM_BUCKETS);
+      for (size_t b = 0; b < METRICS_HISTOGRAM_BUCKETS; ++b)
+        buckets[b] = {double((uint64_t(1) << b) * 2 - 1) * h->scale, h->buckets[b].load(std::memory_order_relaxed)};
+      writer.header(h->name, h->help, "histogram");
+      writer.histogram(h->name, {}, h->sum.load(std::memory_order_relaxed) * h->scale, buckets);
+    }
+  }
+
+  const std::vector<PerformanceTimerHistogram> timers = get_performance_timer_histograms();
+  writer.header("monero_perf_timer_seconds", "Durations of PERF_TIMER scopes, recorded while the PERF_TIMER histograms are on", "histogram");
+  for (const PerformanceTimerHistogram &h: timers)
+  {
+    std::vector<std::pair<double, uint64_t>> buckets;
+    for (size_t b = 0; b < PERF_TIMER_HISTOGRAM_BUCKETS; ++b)
+    {
+      const uint64_t limit_ns = performance_timer_bucket_limit_ns(b);
+      const double limit = limit_ns == std::numeric_limits<uint64_t>::max() ? std::numeric_limits<double>::infinity() : limit_ns * 1e-9;
+      buckets.push_back({limit, h.buckets[b]});
+    }
+    writer.histogram("monero_perf_timer_seconds", {{"name", h.name}, {"category", h.cat}}, h.total_ns * 1e-9, buckets);
+  }
+}
+
+}
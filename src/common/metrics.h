@@ -0,0 +1,95 @@
+// Copyright (c) 2021, The Monero Project
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of
+//    conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list
+//    of conditions and the following disclaimer in the documentation and/or other
+//    materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be
+//    used to endorse or promote products derived from this software without specific
+//    prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+// THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace tools
+{
+
+#define METRICS_HISTOGRAM_BUCKETS 64
+
+// an always recorded histogram of plain values (sizes, durations in ns), exported by the /metrics RPC endpoint
+// - bucket b counts values of [2^b, 2^(b+1)) (bucket 0 also counts 0)
+// - made once per metric as a static, which registers it for the export
+// - adding is a few relaxed atomic increments, safe from any thread
+class MetricsHistogram
+{
+public:
+  // name and help are the Prometheus metric name and help text; exported values are the added values times scale
+  MetricsHistogram(const char *name, const char *help, double scale = 1.0);
+  MetricsHistogram(const MetricsHistogram&) = delete;
+  MetricsHistogram &operator=(const MetricsHistogram&) = delete;
+
+  void add(uint64_t value);
+
+  const char *name;
+  const char *help;
+  double scale;
+  std::atomic<uint64_t> count;
+  std::atomic<uint64_t> sum;
+  std::array<std::atomic<uint64_t>, METRICS_HISTOGRAM_BUCKETS> buckets;
+};
+
+// builds a response in the Prometheus text exposition format
+// - a metric family is a header followed by one or more samples or histograms, with distinct labels
+class PrometheusWriter
+{
+public:
+  typedef std::vector<std::pair<std::string, std::string>> labels_t;
+
+  void header(const std::string &name, const std::string &help, const char *type);
+  void sample(const std::string &name, const labels_t &labels, double value);
+  void sample(const std::string &name, const labels_t &labels, uint64_t value);
+  // buckets are (inclusive upper bound, count in that bucket only) in increasing order, the last bound may be
+  // infinite; they are exported cumulatively, up to the last non-empty finite one, followed by +Inf
+  // - +Inf and _count are the total of the buckets, so one snapshot of the counts gives a consistent histogram
+  void histogram(const std::string &name, const labels_t &labels, double sum,
+    const std::vector<std::pair<double, uint64_t>> &buckets);
+
+  void counter(const std::string &name, const std::string &help, uint64_t value);
+  void gauge(const std::string &name, const std::string &help, double value);
+
+  const std::string &str() const { return out; }
+
+private:
+  void write_labels(const labels_t &labels, const char *le = nullptr);
+
+  std::string out;
+};
+
+// writes every MetricsHistogram, and the PERF_TIMER histograms (when recorded) as the
+// monero_perf_timer_seconds family, labelled by timer name and category
+void write_metrics(PrometheusWriter &writer);
+
+}
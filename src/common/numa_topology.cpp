@@ -0,0 +1,166 @@
+// Copyright (c) 2021, The Monero Project
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of
+//    conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list
+//    of conditions and the following disclaimer in the documentation and/or other
+//    materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be
+//    used to endorse or promote products derived from this software without specific
+//    prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+// THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "common/numa_topology.h"
+
+#include <boost/thread/thread.hpp>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+static __thread int pinned_node = -1;
+
+namespace
+{
+  // "0-3,8,10-11" -> {0, 1, 2, 3, 8, 10, 11}
+  std::vector<unsigned int> parse_cpu_list(const std::string &list)
+  {
+    std::vector<unsigned int> cpus;
+    std::stringstream ss(list);
+    std::string range;
+    while (std::getline(ss, range, ','))
+    {
+      unsigned int first = 0, last = 0;
+      const size_t dash = range.find('-');
+      try
+      {
+        first = std::stoul(range.substr(0, dash));
+        last = dash == std::string::npos ? first : std::stoul(range.substr(dash + 1));
+      }
+      catch (...) { continue; }
+      for (unsigned int cpu = first; cpu <= last; ++cpu)
+        cpus.push_back(cpu);
+    }
+    return cpus;
+  }
+
+  struct numa_topology
+  {
+    std::vector<std::vector<unsigned int>> node_cpus;
+    std::vector<size_t> cpu_nodes;  // node of each CPU (by CPU id)
+  };
+
+  numa_topology read_numa_topology()
+  {
+    numa_topology topology;
+    std::vector<std::vector<unsigned int>> &node_cpus = topology.node_cpus;
+#ifdef __linux__
+    std::ifstream online("/sys/devices/system/node/online");
+    std::string nodes;
+    if (online && std::getline(online, nodes))
+    {
+      for (const unsigned int node: parse_cpu_list(nodes))
+      {
+        std::ifstream cpulist("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+        std::string list;
+        if (!cpulist || !std::getline(cpulist, list))
+          continue;
+        std::vector<unsigned int> cpus = parse_cpu_list(list);
+        if (!cpus.empty())  // memory-only nodes have no CPUs to pin to
+          node_cpus.push_back(std::move(cpus));
+      }
+    }
+#endif
+    if (node_cpus.empty())
+    {
+      node_cpus.emplace_back();
+      for (unsigned int cpu = 0; cpu < std::max(boost::thread::hardware_concurrency(), 1u); ++cpu)
+        node_cpus.back().push_back(cpu);
+    }
+    for (size_t node = 0; node < node_cpus.size(); ++node)
+    {
+      for (const unsigned int cpu: node_cpus[node])
+      {
+        if (cpu >= topology.cpu_nodes.size())
+          topology.cpu_nodes.resize(cpu + 1, 0);
+        topology.cpu_nodes[cpu] = node;
+      }
+    }
+    return topology;
+  }
+
+  const numa_topology &get_numa_topology()
+  {
+    static const numa_topology topology = read_numa_topology();
+    return topology;
+  }
+}
+
+namespace tools
+{
+const std::vector<std::vector<unsigned int>> &get_numa_node_cpus()
+{
+  return get_numa_topology().node_cpus;
+}
+
+size_t get_numa_node_count()
+{
+  return get_numa_node_cpus().size();
+}
+
+size_t get_current_numa_node()
+{
+  if (pinned_node >= 0)
+    return pinned_node;
+  const numa_topology &topology = get_numa_topology();
+  if (topology.node_cpus.size() <= 1)
+    return 0;
+#ifdef __linux__
+  // our node indices skip CPU-less nodes, so map the CPU rather than asking the kernel for its node id
+  const int cpu = sched_getcpu();
+  if (cpu >= 0 && static_cast<size_t>(cpu) < topology.cpu_nodes.size())
+    return topology.cpu_nodes[cpu];
+#endif
+  return 0;
+}
+
+bool pin_current_thread_to_numa_node(size_t node)
+{
+  const std::vector<std::vector<unsigned int>> &node_cpus = get_numa_node_cpus();
+  if (node >= node_cpus.size())
+    return false;
+#ifdef __linux__
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for (const unsigned int cpu: node_cpus[node])
+    if (cpu < CPU_SETSIZE)
+      CPU_SET(cpu, &set);
+  if (sched_setaffinity(0, sizeof(set), &set) != 0)
+    return false;
+  pinned_node = node;
+  return true;
+#else
+  return false;
+#endif
+}
+}
@@ -0,0 +1,95 @@
+// Copyright (c) 2021, The Monero Project
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of
+//    conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list
+//    of conditions and the following disclaimer in the documentation and/or other
+//    materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be
+//    used to endorse or promote products derived from this software without specific
+//    prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+// THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace tools
+{
+
+//! CPUs of each NUMA node that has any, in node order (read from sysfs on Linux; elsewhere, or if sysfs has no NUMA
+//! information, a single node with all CPUs)
+const std::vector<std::vector<unsigned int>> &get_numa_node_cpus();
+//! Number of NUMA nodes with CPUs (at least 1)
+size_t get_numa_node_count();
+//! NUMA node of the calling thread: its node if it was pinned with pin_current_thread_to_numa_node(), else the node of
+//! the CPU it is running on (0 if unknown)
+size_t get_current_numa_node();
+//! Restrict the calling thread to the CPUs of a NUMA node, returns false if the node does not exist or the affinity
+//! can not be set here (the thread is left as it was)
+bool pin_current_thread_to_numa_node(size_t node);
+
+//! Per NUMA node copies of a read-mostly object, so threads on every node read node-local memory.
+//! The copy for a node is made on the first get() from that node, by the calling thread: with first-touch page
+//! placement (the default on Linux) its pages then land on that node when the thread is pinned there (see
+//! threadpool::set_numa_pinning()). On single node machines get() returns the original object without copying.
+template<typename T>
+class numa_replicated
+{
+public:
+  typedef std::function<std::shared_ptr<T>(const T&)> copy_function;
+
+  numa_replicated(std::shared_ptr<T> original, copy_function copy):
+    m_original(std::move(original)), m_copy(std::move(copy)), m_replicas(get_numa_node_count())
+  {}
+
+  const std::shared_ptr<T> &original() const { return m_original; }
+
+  std::shared_ptr<T> get() const
+  {
+    if (m_replicas.size() <= 1 || !m_original)
+      return m_original;
+    const size_t node = std::min(get_current_numa_node(), m_replicas.size() - 1);
+    std::shared_ptr<T> replica = std::atomic_load(&m_replicas[node]);
+    if (replica)
+      return replica;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    replica = std::atomic_load(&m_replicas[node]);
+    if (!replica)
+    {
+      replica = m_copy(*m_original);
+      std::atomic_store(&m_replicas[node], replica);
+    }
+    return replica;
+  }
+
+private:
+  const std::shared_ptr<T> m_original;
+  const copy_function m_copy;
+  mutable std::vector<std::shared_ptr<T>> m_replicas;
+  mutable std::mutex m_mutex;
+};
+
+}
@@ -26,6 +26,11 @@
 // STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
 // THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <mutex>
+#include <unordered_set>
 #include <vector>
 #include "misc_os_dependent.h"
 #include "perf_timer.h"
@@ -92,6 +97,212 @@ el::Level performance_timer_log_level = el::Level::Info;
 
 static __thread std::vector<LoggingPerformanceTimer*> *performance_timers = NULL;
 
+namespace
+{
+  struct site_histogram
+  {
+    std::atomic<uint64_t> count{0};
+    std::atomic<uint64_t> ticks{0};
+    std::atomic<uint64_t> buckets[PERF_TIMER_HISTOGRAM_BUCKETS];
+
+    site_histogram() { for (auto &b: buckets) b.store(0, std::memory_order_relaxed); }
+
+    // single writer (the owning thread): plain load/store, readers may see a slightly stale value
+    static void bump(std::atomic<uint64_t> &counter, uint64_t n)
+    {
+      counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+  };
+
+  // plain totals, for sums over threads
+  struct site_totals
+  {
+    uint64_t count = 0;
+    uint64_t ticks = 0;
+    uint64_t buckets[PERF_TIMER_HISTOGRAM_BUCKETS] = {};
+
+    void add(const site_histogram &h)
+    {
+      count += h.count.load(std::memory_order_relaxed);
+      ticks += h.ticks.load(std::memory_order_relaxed);
+      for (size_t b = 0; b < PERF_TIMER_HISTOGRAM_BUCKETS; ++b)
+        buckets[b] += h.buckets[b].load(std::memory_order_relaxed);
+    }
+  };
+
+  struct thread_histograms;
+
+  // all call sites, the histograms of live threads, and the totals of exited threads and at the last clear
+  struct histogram_registry
+  {
+    std::mutex mutex;
+    std::vector<const PerformanceTimerSite*> sites;
+    std::unordered_set<thread_histograms*> threads;
+    std::vector<site_totals> exited;
+    std::vector<site_totals> baseline;
+  };
+
+  histogram_registry &get_histogram_registry()
+  {
+    static histogram_registry registry;
+    return registry;
+  }
+
+  // one thread's histograms, by site id (allocated on the site's first timing in the thread)
+  struct thread_histograms
+  {
+    std::atomic<site_histogram*> sites[PERF_TIMER_MAX_SITES];
+
+    thread_histograms()
+    {
+      for (auto &site: sites) site.store(nullptr, std::memory_order_relaxed);
+      histogram_registry &registry = get_histogram_registry();
+      std::lock_guard<std::mutex> lock(registry.mutex);
+      registry.threads.insert(this);
+    }
+
+    ~thread_histograms()
+    {
+      histogram_registry &registry = get_histogram_registry();
+      std::lock_guard<std::mutex> lock(registry.mutex);
+      registry.threads.erase(this);
+      if (registry.exited.size() < PERF_TIMER_MAX_SITES)
+        registry.exited.resize(PERF_TIMER_MAX_SITES);
+      for (size_t id = 0; id < PERF_TIMER_MAX_SITES; ++id)
+      {
+        site_histogram *h = sites[id].load(std::memory_order_relaxed);
+        if (!h)
+          continue;
+        registry.exited[id].add(*h);
+        delete h;
+      }
+    }
+
+    site_histogram &get(size_t id)
+    {
+      site_histogram *h = sites[id].load(std::memory_order_relaxed);
+      if (!h)
+      {
+        h = new site_histogram();
+        sites[id].store(h, std::memory_order_release);
+      }
+      return *h;
+    }
+  };
+
+  thread_local std::unique_ptr<thread_histograms> local_histograms;
+
+  std::atomic<bool> histograms_enabled{false};
+
+  void record_histogram(const PerformanceTimerSite &site, uint64_t ticks)
+  {
+    if (site.id >= PERF_TIMER_MAX_SITES)
+      return;
+    if (!local_histograms)
+      local_histograms.reset(new thread_histograms());
+    site_histogram &h = local_histograms->get(site.id);
+    site_histogram::bump(h.count, 1);
+    site_histogram::bump(h.ticks, ticks);
+    site_histogram::bump(h.buckets[performance_timer_bucket(ticks)], 1);
+  }
+
+  // must hold the registry lock
+  std::vector<site_totals> sum_histograms(histogram_registry &registry)
+  {
+    std::vector<site_totals> totals(registry.sites.size());
+    for (size_t id = 0; id < totals.size(); ++id)
+    {
+      if (id < registry.exited.size())
+        totals[id] = registry.exited[id];
+      for (const thread_histograms *thread: registry.threads)
+      {
+        const site_histogram *h = thread->sites[id].load(std::memory_order_acquire);
+        if (h)
+          totals[id].add(*h);
+      }
+    }
+    return totals;
+  }
+}
+
+PerformanceTimerSite::PerformanceTimerSite(const char *name, const char *cat): name(name), cat(cat)
+{
+  histogram_registry &registry = get_histogram_registry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  id = registry.sites.size();
+  if (id < PERF_TIMER_MAX_SITES)
+    registry.sites.push_back(this);
+  else
+    id = PERF_TIMER_MAX_SITES;
+}
+
+void set_performance_timer_histograms(bool enabled)
+{
+  histograms_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool performance_timer_histograms_enabled()
+{
+  return histograms_enabled.load(std::memory_order_relaxed);
+}
+
+std::vector<PerformanceTimerHistogram> get_performance_timer_histograms()
+{
+  histogram_registry &registry = get_histogram_registry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  const std::vector<site_totals> totals = sum_histograms(registry);
+
+  // sites with the same name and category (e.g. instances of a template) are reported together
+  std::vector<PerformanceTimerHistogram> histograms;
+  for (size_t id = 0; id < totals.size(); ++id)
+  {
+    const site_totals &base = id < registry.baseline.size() ? registry.baseline[id] : site_totals();
+    if (totals[id].count == base.count)
+      continue;
+    const PerformanceTimerSite &site = *registry.sites[id];
+    auto it = std::find_if(histograms.begin(), histograms.end(), [&site](const PerformanceTimerHistogram &h) {
+      return h.name == site.name && h.cat == site.cat;
+    });
+    if (it == histograms.end())
+    {
+      histograms.push_back({site.name, site.cat, 0, 0, {}});
+      it = histograms.end() - 1;
+    }
+    it->count += totals[id].count - base.count;
+    it->total_ns += ticks_to_ns(totals[id].ticks - base.ticks);
+    for (size_t b = 0; b < PERF_TIMER_HISTOGRAM_BUCKETS; ++b)
+      it->buckets[b] += totals[id].buckets[b] - base.buckets[b];
+  }
+  return histograms;
+}
+
+void clear_performance_timer_histograms()
+{
+  // the counters only ever grow (each has a single writer), so clearing records a baseline to report from
+  histogram_registry &registry = get_histogram_registry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  registry.baseline = sum_histograms(registry);
+}
+
+size_t performance_timer_bucket(uint64_t ticks)
+{
+  size_t bucket = 0;
+  for (uint64_t t = ticks >> 1; t; t >>= 1)
+    ++bucket;
+  return bucket;
+}
+
+uint64_t performance_timer_bucket_limit_ns(size_t bucket)
+{
+  if (bucket + 1 >= PERF_TIMER_HISTOGRAM_BUCKETS)
+    return std::numeric_limits<uint64_t>::max();
+  const uint64_t ticks = uint64_t(1) << (bucket + 1);
+  // avoid overflowing ticks_to_ns()'s intermediate product for the highest buckets
+  if (ticks > std::numeric_limits<uint64_t>::max() / 256)
+    return std::numeric_limits<uint64_t>::max();
+  return ticks_to_ns(ticks);
+}
+
 void set_performance_timer_log_level(el::Level level)
 {
   if (level != el::Level::Debug && level != el::Level::Trace && level != el::Level::Info
@@ -111,13 +322,15 @@ PerformanceTimer::PerformanceTimer(bool paused): started(true), paused(paused)
     ticks = get_tick_count();
 }
 
-LoggingPerformanceTimer::LoggingPerformanceTimer(const std::string &s, const std::string &cat, uint64_t unit, el::Level l): PerformanceTimer(), name(s), cat(cat), unit(unit), level(l)
+LoggingPerformanceTimer::LoggingPerformanceTimer(const PerformanceTimerSite &site, uint64_t unit, el::Level l): PerformanceTimer(), site(site), unit(unit), level(l), histogram(performance_timer_histograms_enabled())
 {
-  const bool log = ELPP->vRegistry()->allowed(level, cat.c_str());
+  if (histogram)
+    return;
+  const bool log = site.log_allowed(level);
   if (!performance_timers)
   {
     if (log)
-      PERF_LOG_ALWAYS(level, cat.c_str(), "PERF             ----------");
+      PERF_LOG_ALWAYS(level, site.cat, "PERF             ----------");
     performance_timers = new std::vector<LoggingPerformanceTimer*>();
     performance_timers->reserve(16); // how deep before realloc
   }
@@ -129,7 +342,7 @@ LoggingPerformanceTimer::LoggingPerformanceTimer(const std::string &s, const std
       if (log)
       {
         size_t size = 0; for (const auto *tmp: *performance_timers) if (!tmp->paused) ++size;
-        PERF_LOG_ALWAYS(pt->level, cat.c_str(), "PERF           " << std::string((size-1) * 2, ' ') << "  " << pt->name);
+        PERF_LOG_ALWAYS(pt->level, site.cat, "PERF           " << std::string((size-1) * 2, ' ') << "  " << pt->site.name);
       }
       pt->started = true;
     }
@@ -146,14 +359,19 @@ PerformanceTimer::~PerformanceTimer()
 LoggingPerformanceTimer::~LoggingPerformanceTimer()
 {
   pause();
+  if (histogram)
+  {
+    record_histogram(site, ticks);
+    return;
+  }
   performance_timers->pop_back();
-  const bool log = ELPP->vRegistry()->allowed(level, cat.c_str());
+  const bool log = site.log_allowed(level);
   if (log)
   {
     char s[12];
     snprintf(s, sizeof(s), "%8llu  ", (unsigned long long)(ticks_to_ns(ticks) / (1000000000 / unit)));
     size_t size = 0; for (const auto *tmp: *performance_timers) if (!tmp->paused || tmp==this) ++size;
-    PERF_LOG_ALWAYS(level, cat.c_str(), "PERF " << s << std::string(size * 2, ' ') << "  " << name);
+    PERF_LOG_ALWAYS(level, site.cat, "PERF " << s << std::string(size * 2, ' ') << "  " << site.name);
   }
   if (performance_timers->empty())
   {
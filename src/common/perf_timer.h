@@ -28,9 +28,11 @@
 
 #pragma once
 
+#include <array>
 #include <string>
 #include <stdio.h>
 #include <memory>
+#include <vector>
 #include "misc_log_ex.h"
 
 namespace tools
@@ -61,27 +63,70 @@ protected:
   bool paused;
 };
 
-class LoggingPerformanceTimer: public PerformanceTimer
+// one PERF_TIMER call site: its name and log category, and its slot in the histograms
+// - made once per call site by the PERF_TIMER macros (a function-local static)
+class PerformanceTimerSite
 {
 public:
-  LoggingPerformanceTimer(const std::string &s, const std::string &cat, uint64_t unit, el::Level l = el::Level::Info);
-  ~LoggingPerformanceTimer();
+  PerformanceTimerSite(const char *name, const char *cat);
+  bool log_allowed(el::Level level) const { return log_site.allowed(level, cat, true); }
+  const char *name;
+  const char *cat;
+  size_t id; // PERF_TIMER_MAX_SITES if there was no room left
 
 private:
+  mutable el::base::LogSite log_site;
+};
+
+#define PERF_TIMER_MAX_SITES 1024
+#define PERF_TIMER_HISTOGRAM_BUCKETS 64
+
+// aggregated timings of all PERF_TIMERs with one name and category, since the last clear
+// - bucket b counts timings of [2^b, 2^(b+1)) ticks (bucket 0 also counts 0 ticks)
+struct PerformanceTimerHistogram
+{
   std::string name;
   std::string cat;
+  uint64_t count;
+  uint64_t total_ns;
+  std::array<uint64_t, PERF_TIMER_HISTOGRAM_BUCKETS> buckets;
+};
+
+// histogram mode: instead of logging, every PERF_TIMER adds its duration to a per-thread histogram of its call site
+// - recording is a few relaxed atomic stores into the calling thread's own counters (no locks, no logging)
+// - dumping sums all threads' counters, plus those of threads that have exited
+void set_performance_timer_histograms(bool enabled);
+bool performance_timer_histograms_enabled();
+std::vector<PerformanceTimerHistogram> get_performance_timer_histograms();
+void clear_performance_timer_histograms();
+// histogram bucket of a timing of the given number of ticks
+size_t performance_timer_bucket(uint64_t ticks);
+// upper bound of a histogram bucket, in ns
+uint64_t performance_timer_bucket_limit_ns(size_t bucket);
+
+class LoggingPerformanceTimer: public PerformanceTimer
+{
+public:
+  LoggingPerformanceTimer(const PerformanceTimerSite &site, uint64_t unit, el::Level l = el::Level::Info);
+  ~LoggingPerformanceTimer();
+
+private:
+  const PerformanceTimerSite &site;
   uint64_t unit;
   el::Level level;
+  bool histogram;
 };
 
 void set_performance_timer_log_level(el::Level level);
 
 #define PERF_TIMER_NAME(name) pt_##name
-#define PERF_TIMER_UNIT(name, unit) tools::LoggingPerformanceTimer PERF_TIMER_NAME(name)(#name, "perf." MONERO_DEFAULT_LOG_CATEGORY, unit, tools::performance_timer_log_level)
-#define PERF_TIMER_UNIT_L(name, unit, l) tools::LoggingPerformanceTimer PERF_TIMER_NAME(name)t_##name(#name, "perf." MONERO_DEFAULT_LOG_CATEGORY, unit, l)
+#define PERF_TIMER_SITE(name) pt_site_##name
+#define PERF_TIMER_DECLARE_SITE(name) static const tools::PerformanceTimerSite PERF_TIMER_SITE(name)(#name, "perf." MONERO_DEFAULT_LOG_CATEGORY)
+#define PERF_TIMER_UNIT(name, unit) PERF_TIMER_DECLARE_SITE(name); tools::LoggingPerformanceTimer PERF_TIMER_NAME(name)(PERF_TIMER_SITE(name), unit, tools::performance_timer_log_level)
+#define PERF_TIMER_UNIT_L(name, unit, l) PERF_TIMER_DECLARE_SITE(name); tools::LoggingPerformanceTimer PERF_TIMER_NAME(name)t_##name(PERF_TIMER_SITE(name), unit, l)
 #define PERF_TIMER(name) PERF_TIMER_UNIT(name, 1000000)
 #define PERF_TIMER_L(name, l) PERF_TIMER_UNIT_L(name, 1000000, l)
-#define PERF_TIMER_START_UNIT(name, unit) std::unique_ptr<tools::LoggingPerformanceTimer> PERF_TIMER_NAME(name)(new tools::LoggingPerformanceTimer(#name, "perf." MONERO_DEFAULT_LOG_CATEGORY, unit, el::Level::Info))
+#define PERF_TIMER_START_UNIT(name, unit) PERF_TIMER_DECLARE_SITE(name); std::unique_ptr<tools::LoggingPerformanceTimer> PERF_TIMER_NAME(name)(new tools::LoggingPerformanceTimer(PERF_TIMER_SITE(name), unit, el::Level::Info))
 #define PERF_TIMER_START(name) PERF_TIMER_START_UNIT(name, 1000000)
 #define PERF_TIMER_STOP(name) do { PERF_TIMER_NAME(name).reset(NULL); } while(0)
 #define PERF_TIMER_PAUSE(name) PERF_TIMER_NAME(name).pause()
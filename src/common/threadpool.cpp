@@ -30,13 +30,15 @@
 
 #include "cryptonote_config.h"
 #include "common/util.h"
+#include "common/numa_topology.h"
 
-static __thread int depth = 0;
+static __thread const tools::threadpool *worker_pool = NULL;
+static __thread size_t worker_index = 0;
 static __thread bool is_leaf = false;
 
 namespace tools
 {
-threadpool::threadpool(unsigned int max_threads) : running(true), active(0) {
+threadpool::threadpool(unsigned int max_threads) : pending(0), idle(0), running(true), numa_pinning(false) {
   create(max_threads);
 }
 
@@ -70,6 +72,12 @@ void threadpool::recycle() {
   create(max);
 }
 
+void threadpool::set_numa_pinning(bool pin) {
+  destroy();
+  numa_pinning = pin;
+  create(max);
+}
+
 void threadpool::create(unsigned int max_threads) {
   const boost::unique_lock<boost::mutex> lock(mutex);
   boost::thread::attributes attrs;
@@ -77,30 +85,43 @@ void threadpool::create(unsigned int max_threads) {
   max = max_threads ? max_threads : tools::get_max_concurrency();
   size_t i = max ? max - 1 : 0;
   running = true;
-  while(i--) {
-    threads.push_back(boost::thread(attrs, boost::bind(&threadpool::run, this, false)));
+  // tasks left from before a recycle move to the shared queue
+  std::deque<entry> tasks;
+  for (auto &queue: queues)
+    for (auto &e: queue->tasks)
+      tasks.push_back(std::move(e));
+  queues.clear();
+  const size_t num_nodes = get_numa_node_count();
+  for (size_t n = 0; n <= i; ++n) {
+    queues.emplace_back(new task_queue());
+    if (n)
+      queues.back()->node = (n - 1) * num_nodes / i;
+  }
+  queues[0]->size = tasks.size();
+  queues[0]->tasks = std::move(tasks);
+  for (size_t n = 1; n <= i; ++n) {
+    threads.push_back(boost::thread(attrs, boost::bind(&threadpool::run, this, n)));
   }
 }
 
 void threadpool::submit(waiter *obj, std::function<void()> f, bool leaf) {
   CHECK_AND_ASSERT_THROW_MES(!is_leaf, "A leaf routine is using a thread pool");
-  boost::unique_lock<boost::mutex> lock(mutex);
-  if (!leaf && ((active == max && !queue.empty()) || depth > 0)) {
-    // if all available threads are already running
-    // and there's work waiting, just run in current thread
-    lock.unlock();
-    ++depth;
-    is_leaf = leaf;
-    f();
-    --depth;
-    is_leaf = false;
-  } else {
-    if (obj)
-      obj->inc();
+  if (obj)
+    obj->inc();
+  task_queue &queue = *queues[worker_pool == this ? worker_index : 0];
+  {
+    const boost::unique_lock<boost::mutex> lock(queue.mutex);
     if (leaf)
-      queue.push_front({obj, f, leaf});
+      queue.tasks.push_front({obj, std::move(f), leaf});
     else
-      queue.push_back({obj, f, leaf});
+      queue.tasks.push_back({obj, std::move(f), leaf});
+    ++queue.size;
+  }
+  // a worker going to sleep counts itself idle before checking pending, so one of the two sees the other
+  ++pending;
+  if (idle)
+  {
+    const boost::unique_lock<boost::mutex> lock(mutex);
     has_work.notify_one();
   }
 }
@@ -109,6 +130,11 @@ unsigned int threadpool::get_max_concurrency() const {
   return max;
 }
 
+size_t threadpool::get_queue_length() const {
+  const int n = pending.load(std::memory_order_relaxed);
+  return n > 0 ? n : 0;
+}
+
 threadpool::waiter::~waiter()
 {
   try
@@ -129,7 +155,9 @@ threadpool::waiter::~waiter()
 }
 
 bool threadpool::waiter::wait() {
-  pool.run(true);
+  // help with any queued task rather than block; once there are none, ours are all running elsewhere
+  while (num && pool.run_one())
+    continue;
   boost::unique_lock<boost::mutex> lock(mt);
   while(num)
     cv.wait(lock);
@@ -137,44 +165,91 @@ bool threadpool::waiter::wait() {
 }
 
 void threadpool::waiter::inc() {
-  const boost::unique_lock<boost::mutex> lock(mt);
-  num++;
+  ++num;
 }
 
 void threadpool::waiter::dec() {
+  // decrement under the lock: once wait() sees zero the waiter may be destroyed
   const boost::unique_lock<boost::mutex> lock(mt);
-  num--;
-  if (!num)
+  if (--num == 0)
     cv.notify_all();
 }
 
-void threadpool::run(bool flush) {
-  boost::unique_lock<boost::mutex> lock(mutex);
+bool threadpool::pop(size_t index, entry &e) {
+  // own newest task first, it is likely the one being waited on and still in cache
+  if (queues[index]->size)
+  {
+    task_queue &queue = *queues[index];
+    const boost::unique_lock<boost::mutex> lock(queue.mutex);
+    if (!queue.tasks.empty()) {
+      e = std::move(queue.tasks.back());
+      queue.tasks.pop_back();
+      --queue.size;
+      --pending;
+      return true;
+    }
+  }
+  // then steal the oldest task of the shared queue, then of the other workers (pinned workers: those on
+  // their own node in a first pass, then those on other nodes)
+  const bool by_node = numa_pinning && index;
+  for (int pass = by_node ? 0 : 1; pass < 2; ++pass) {
+    for (size_t n = 0; n < queues.size(); ++n) {
+      const size_t victim = n ? (index + n) % queues.size() : 0;
+      if (victim == index || (n && !victim))
+        continue;
+      if (by_node && (!victim || queues[victim]->node == queues[index]->node) != (pass == 0))
+        continue;
+      task_queue &queue = *queues[victim];
+      if (!queue.size)
+        continue;
+      const boost::unique_lock<boost::mutex> lock(queue.mutex);
+      if (!queue.tasks.empty()) {
+        e = std::move(queue.tasks.front());
+        queue.tasks.pop_front();
+        --queue.size;
+        --pending;
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+bool threadpool::run_one() {
+  entry e;
+  if (!pop(worker_pool == this ? worker_index : 0, e))
+    return false;
+  execute(e);
+  return true;
+}
+
+void threadpool::execute(entry &e) {
+  const bool was_leaf = is_leaf;
+  is_leaf = e.leaf;
+  try { e.f(); }
+  catch (const std::exception &ex) { if (e.wo) e.wo->set_error(); try { MERROR("Exception in threadpool job: " << ex.what()); } catch (...) {} }
+  is_leaf = was_leaf;
+
+  if (e.wo)
+    e.wo->dec();
+}
+
+void threadpool::run(size_t index) {
+  worker_pool = this;
+  worker_index = index;
+  if (numa_pinning && !pin_current_thread_to_numa_node(queues[index]->node))
+    MWARNING("Failed to pin threadpool worker " << index << " to NUMA node " << queues[index]->node);
   while (running) {
     entry e;
-    while(queue.empty() && running)
-    {
-      if (flush)
-        return;
-      has_work.wait(lock);
+    if (pop(index, e)) {
+      execute(e);
+      continue;
     }
-    if (!running) break;
-
-    active++;
-    e = std::move(queue.front());
-    queue.pop_front();
-    lock.unlock();
-    ++depth;
-    is_leaf = e.leaf;
-    try { e.f(); }
-    catch (const std::exception &ex) { e.wo->set_error(); try { MERROR("Exception in threadpool job: " << ex.what()); } catch (...) {} }
-    --depth;
-    is_leaf = false;
-
-    if (e.wo)
-      e.wo->dec();
-    lock.lock();
-    active--;
+    boost::unique_lock<boost::mutex> lock(mutex);
+    ++idle;
+    while (running && pending <= 0)
+      has_work.wait(lock);
+    --idle;
   }
 }
 }
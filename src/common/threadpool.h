@@ -30,15 +30,22 @@
 #include <boost/thread/condition_variable.hpp>
 #include <boost/thread/mutex.hpp>
 #include <boost/thread/thread.hpp>
+#include <algorithm>
+#include <atomic>
 #include <cstddef>
+#include <deque>
 #include <functional>
+#include <memory>
 #include <utility>
 #include <vector>
 #include <stdexcept>
 
 namespace tools
 {
-//! A global thread pool
+//! A global work-stealing thread pool
+//! Each worker thread has its own task deque: it pushes the tasks it submits and pops its own most recent
+//! task at the back, and idle threads steal the oldest tasks at the front. Tasks submitted from threads
+//! outside the pool go to a shared deque. A thread waiting on a waiter runs queued tasks until none are left.
 class threadpool
 {
 public:
@@ -56,12 +63,12 @@ public:
     boost::mutex mt;
     boost::condition_variable cv;
     threadpool &pool;
-    int num;
+    std::atomic<int> num;
     bool error_flag;
     public:
     void inc();
     void dec();
-    bool wait();  //! Wait for a set of tasks to finish, returns false iff any error
+    bool wait();  //! Wait for a set of tasks to finish, running queued tasks meanwhile, returns false iff any error
     void set_error() noexcept { error_flag = true; }
     bool error() const noexcept { return error_flag; }
     waiter(threadpool &pool) : pool(pool), num(0), error_flag(false) {}
@@ -70,14 +77,24 @@ public:
 
   // Submit a task to the pool. The waiter pointer may be
   // NULL if the caller doesn't care to wait for the
-  // task to finish.
+  // task to finish. Leaf tasks may not submit tasks,
+  // and are stolen before other tasks.
   void submit(waiter *waiter, std::function<void()> f, bool leaf = false);
 
   // destroy and recreate threads
   void recycle();
 
+  // Pin the worker threads to NUMA nodes (contiguous blocks of workers per node) and have idle workers steal
+  // from workers on their own node before others, so tasks tend to stay near the data they touch. Recycles
+  // the threads, so only call while no tasks are running. Off by default.
+  void set_numa_pinning(bool pin);
+  bool get_numa_pinning() const { return numa_pinning; }
+
   unsigned int get_max_concurrency() const;
 
+  // number of tasks submitted but not yet started, for monitoring
+  size_t get_queue_length() const;
+
   ~threadpool();
 
   private:
@@ -89,14 +106,93 @@ public:
       std::function<void()> f;
       bool leaf;
     } entry;
-    std::deque<entry> queue;
+    struct task_queue {
+      boost::mutex mutex;
+      std::deque<entry> tasks;
+      std::atomic<size_t> size{0}; // tasks.size(), readable without the lock to skip empty queues
+      size_t node{0}; // NUMA node of the owning worker when pinning
+    };
+    // queues[0] is shared by threads outside the pool, queues[i] belongs to worker thread i
+    std::vector<std::unique_ptr<task_queue>> queues;
+    std::atomic<int> pending; // queued tasks, briefly negative when a task is popped before being counted
+    std::atomic<unsigned int> idle; // workers sleeping on has_work
     boost::condition_variable has_work;
     boost::mutex mutex;
     std::vector<boost::thread> threads;
-    unsigned int active;
     unsigned int max;
-    bool running;
-    void run(bool flush = false);
+    std::atomic<bool> running;
+    bool numa_pinning;
+    void run(size_t index);
+    bool pop(size_t index, entry &e);
+    bool run_one();
+    void execute(entry &e);
 };
 
+namespace detail
+{
+  inline size_t parallel_num_chunks(const size_t size, size_t grain, const threadpool &tpool)
+  {
+    if (grain == 0)
+    {
+      const size_t target_chunks = 4 * std::max(tpool.get_max_concurrency(), 1u);
+      grain = std::max<size_t>((size + target_chunks - 1) / target_chunks, 1);
+    }
+    return (size + grain - 1) / grain;
+  }
+}
+
+//! Run fn(chunk_begin, chunk_end) over contiguous chunks covering [begin, end) on the global pool, and wait for them.
+//! Chunks hold at most grain elements; a grain of 0 picks one giving each thread a few chunks, so uneven chunks
+//! balance out. A single chunk runs on the calling thread. Chunks are not leaf tasks, so fn may use the pool.
+//! Returns false iff any chunk threw.
+template<typename F>
+bool parallel_for(const size_t begin, const size_t end, const size_t grain, F fn)
+{
+  if (begin >= end)
+    return true;
+  threadpool &tpool = threadpool::getInstance();
+  const size_t size = end - begin;
+  const size_t num_chunks = detail::parallel_num_chunks(size, grain, tpool);
+  if (num_chunks == 1)
+  {
+    try { fn(begin, end); }
+    catch (const std::exception &e) { return false; }
+    return true;
+  }
+
+  // equal chunks rather than full ones and a short tail
+  threadpool::waiter waiter(tpool);
+  for (size_t chunk = 0; chunk < num_chunks; ++chunk)
+  {
+    const size_t chunk_begin = begin + chunk * size / num_chunks;
+    const size_t chunk_end = begin + (chunk + 1) * size / num_chunks;
+    tpool.submit(&waiter, [&fn, chunk_begin, chunk_end]{ fn(chunk_begin, chunk_end); });
+  }
+  return waiter.wait();
+}
+
+//! Fold map(chunk_begin, chunk_end) over the chunks of [begin, end), as split by parallel_for, into result:
+//! result = combine(std::move(result), map(chunk)) for each chunk in order, so combine need only be associative.
+//! The chunks are mapped in parallel and combined on the calling thread. T must be default constructible.
+//! Returns false iff any chunk threw, leaving result unchanged.
+template<typename T, typename Map, typename Combine>
+bool parallel_reduce(const size_t begin, const size_t end, const size_t grain, T &result, Map map, Combine combine)
+{
+  if (begin >= end)
+    return true;
+  const size_t size = end - begin;
+  const size_t num_chunks = detail::parallel_num_chunks(size, grain, threadpool::getInstance());
+
+  std::vector<T> partials(num_chunks);
+  const bool r = parallel_for(0, num_chunks, 1, [&](const size_t chunk_begin, const size_t chunk_end){
+    for (size_t chunk = chunk_begin; chunk < chunk_end; ++chunk)
+      partials[chunk] = map(begin + chunk * size / num_chunks, begin + (chunk + 1) * size / num_chunks);
+  });
+  if (!r)
+    return false;
+  for (T &partial: partials)
+    result = combine(std::move(result), std::move(partial));
+  return true;
+}
+
 }
@@ -1,5 +1,6 @@
 #include <string.h>
 #include <errno.h>
+#include <stdlib.h>
 #include <time.h>
 #include <algorithm>
 #include <boost/algorithm/string.hpp>
@@ -26,7 +27,7 @@ TimingsDatabase::~TimingsDatabase()
 
 bool TimingsDatabase::load()
 {
-  instances.clear();
+  history.clear();
 
   if (filename.empty())
     return true;
@@ -37,32 +38,44 @@ bool TimingsDatabase::load()
     MDEBUG("Failed to load timings file " << filename << ": " << strerror(errno));
     return false;
   }
-  while (1)
+
+  // lines are "<key>,<t>,<npoints>,<min>,...,<npskew>,<11 deciles>," (see save()), or a time stamp between runs
+  std::string line;
+  char s[4096];
+  while (fgets(s, sizeof(s), f))
   {
-    char s[4096];
-    if (!fgets(s, sizeof(s), f))
-      break;
-    char *tab = strchr(s, '\t');
-    if (!tab)
-    {
-      MWARNING("Bad format: no tab found");
+    line += s;
+    if (line.empty() || (line.back() != '\n' && !feof(f)))
+      continue;  // the line is longer than the buffer
+    boost::trim_right_if(line, boost::is_any_of("\r\n"));
+
+    std::vector<std::string> fields;
+    boost::split(fields, line, boost::is_any_of(","));
+    line.clear();
+    if (fields.size() < N_EXPECTED_FIELDS + 2 || !fields.back().empty())
       continue;
+    fields.pop_back();
+
+    // the key may contain commas, so the numbers are taken from the end of the line
+    const size_t first_number = fields.size() - N_EXPECTED_FIELDS;
+    bool numbers_ok = true;
+    for (size_t n = first_number; n < fields.size() && numbers_ok; ++n)
+    {
+      char *end = nullptr;
+      strtod(fields[n].c_str(), &end);
+      numbers_ok = !fields[n].empty() && end && *end == '\0';
     }
-    const std::string name = std::string(s, tab - s);
-    std::vector<std::string> fields;
-    char *ptr = tab + 1;
-    boost::split(fields, ptr, boost::is_any_of(" "));
-    if (fields.size() != N_EXPECTED_FIELDS)
+    if (!numbers_ok)
     {
-      MERROR("Bad format: wrong number of fields: got " << fields.size() << " expected " << N_EXPECTED_FIELDS);
+      MWARNING("Bad format: expected " << N_EXPECTED_FIELDS << " numbers at the end of a timings line");
       continue;
     }
 
     instance i;
 
-    unsigned int idx = 0;
-    i.t = atoi(fields[idx++].c_str());
-    i.npoints = atoi(fields[idx++].c_str());
+    unsigned int idx = first_number;
+    i.t = strtoull(fields[idx++].c_str(), NULL, 10);
+    i.npoints = strtoull(fields[idx++].c_str(), NULL, 10);
     i.min = atof(fields[idx++].c_str());
     i.max = atof(fields[idx++].c_str());
     i.mean = atof(fields[idx++].c_str());
@@ -72,9 +85,10 @@ bool TimingsDatabase::load()
     i.deciles.reserve(11);
     for (int n = 0; n < 11; ++n)
     {
-      i.deciles.push_back(atoi(fields[idx++].c_str()));
+      i.deciles.push_back(strtoull(fields[idx++].c_str(), NULL, 10));
     }
-    instances.emplace_back(name, i);
+    fields.resize(first_number);
+    history.emplace_back(boost::join(fields, ","), i);
   }
   fclose(f);
   return true;
@@ -150,17 +164,31 @@ bool TimingsDatabase::save(const bool print_current_time /*=true*/)
   return true;
 }
 
-/*
-std::vector<TimingsDatabase::instance> TimingsDatabase::get(const char *name) const
+std::vector<TimingsDatabase::instance> TimingsDatabase::get(const std::string &name) const
 {
   std::vector<instance> ret;
-  auto range = instances.equal_range(name);
-  for (auto i = range.first; i != range.second; ++i)
-    ret.push_back(i->second);
-  std::sort(ret.begin(), ret.end(), [](const instance &e0, const instance &e1){ return e0.t < e1.t; });
+  for (const auto &i: history)
+  {
+    if (i.first == name ||
+        (i.first.size() > name.size() && boost::ends_with(i.first, name) &&
+          i.first[i.first.size() - name.size() - 1] == ','))
+      ret.push_back(i.second);
+  }
+  std::stable_sort(ret.begin(), ret.end(), [](const instance &e0, const instance &e1){ return e0.t < e1.t; });
   return ret;
 }
-*/
+
+std::string TimingsDatabase::get_key(const char *name, const size_t first_pending) const
+{
+  std::string key;
+  size_t index = 0;
+  for (const auto &i: instances)
+  {
+    if (index++ >= first_pending && i.second.npoints == 0)
+      key += i.first + ',';
+  }
+  return key + name;
+}
 
 void TimingsDatabase::add(const char *name, const instance &i)
 {
@@ -22,14 +22,23 @@ public:
   TimingsDatabase(const std::string &filename, const bool load_previous = false);
   ~TimingsDatabase();
 
-  //std::vector<instance> get(const char *name) const;  //changed to std::list from std::multimap... can't get range
+  // previous runs of a test (loaded from the file), oldest first; a record's key may have other records' names
+  // prepended (they are saved on the same line), so keys that end with ",<name>" match too
+  std::vector<instance> get(const std::string &name) const;
   void add(const char *name, const instance &data);
   bool save(const bool print_current_time = true);
 
+  // number of records added since the last save
+  size_t num_pending() const { return instances.size(); }
+  // the key 'name' is saved under if added now, including the names of the records added since pending record
+  // 'first_pending' (e.g. a test's description, added while it was set up)
+  std::string get_key(const char *name, const size_t first_pending) const;
+
 private:
   bool load();
 
 private:
   std::string filename;
   std::list<std::pair<std::string, instance>> instances;
+  std::vector<std::pair<std::string, instance>> history;
 };
@@ -0,0 +1,546 @@
+// Copyright (c) 2021, The Monero Project
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of
+//    conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list
+//    of conditions and the following disclaimer in the documentation and/or other
+//    materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be
+//    used to endorse or promote products derived from this software without specific
+//    prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+// THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "crypto-ops.h"
+
+/* 4-way batched point addition
+ *
+ * Pippenger's bucket accumulation does many independent 'bucket += point' additions. Here four of them run side by
+ * side, one per 64-bit lane of an AVX2 register: a field element is ten vectors, vector i holding limb i (radix
+ * 2^25.5, as in ref10) of each of the four lanes' elements.
+ *
+ * Limbs are kept unsigned. After a carry pass even limbs are < 2^26 and odd limbs are < 2^25 + 2^18; results are
+ * rebalanced to ref10's signed limb ranges on the way out, since the scalar code relies on those bounds. Multiplication inputs may be the sum of two carried elements (limbs
+ * < 2^27), which keeps 19*g within the 32 bits read by _mm256_mul_epu32 and every product sum below 2^62.
+ * Differences are computed as f + 2p - g (g carried) and carried before they are multiplied.
+ */
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define GE_X4_AVX2 1
+#endif
+
+#if defined(GE_X4_AVX2)
+#include <immintrin.h>
+
+#define GE_X4_TARGET __attribute__((target("avx2")))
+/* the limb loops must be fully unrolled so the limbs stay in registers (not the default at -O2) */
+#define GE_X4_UNROLL _Pragma("GCC unroll 10")
+
+typedef struct {
+  __m256i v[10];
+} fe_x4;
+
+GE_X4_TARGET static inline __m256i fe_x4_limb_bias(int i, int64_t multiple) {
+  /* limb i of 'multiple' * p */
+  const int64_t limb = i == 0 ? (1 << 26) - 19 : (i & 1) ? (1 << 25) - 1 : (1 << 26) - 1;
+  return _mm256_set1_epi64x(limb * multiple);
+}
+
+GE_X4_TARGET static void fe_x4_carry(fe_x4 *h) {
+  static const int order[] = {0, 4, 1, 5, 2, 6, 3, 7, 4, 8};
+  const __m256i mask26 = _mm256_set1_epi64x((1 << 26) - 1);
+  const __m256i mask25 = _mm256_set1_epi64x((1 << 25) - 1);
+  __m256i c;
+  int k;
+
+
+  GE_X4_UNROLL
+  for (k = 0; k < 10; ++k) {
+    const int i = order[k];
+    if (i & 1) {
+      c = _mm256_srli_epi64(h->v[i], 25);
+      h->v[i] = _mm256_and_si256(h->v[i], mask25);
+    } else {
+      c = _mm256_srli_epi64(h->v[i], 26);
+      h->v[i] = _mm256_and_si256(h->v[i], mask26);
+    }
+    h->v[i + 1] = _mm256_add_epi64(h->v[i + 1], c);
+  }
+
+  /* h0 += 19 * carry9 */
+  c = _mm256_srli_epi64(h->v[9], 25);
+  h->v[9] = _mm256_and_si256(h->v[9], mask25);
+  h->v[0] = _mm256_add_epi64(h->v[0], _mm256_add_epi64(c, _mm256_add_epi64(_mm256_slli_epi64(c, 1), _mm256_slli_epi64(c, 4))));
+
+  c = _mm256_srli_epi64(h->v[0], 26);
+  h->v[0] = _mm256_and_si256(h->v[0], mask26);
+  h->v[1] = _mm256_add_epi64(h->v[1], c);
+}
+
+/* h = f + g (not carried) */
+GE_X4_TARGET static inline void fe_x4_add(fe_x4 *h, const fe_x4 *f, const fe_x4 *g) {
+  int i;
+  GE_X4_UNROLL
+  for (i = 0; i < 10; ++i)
+    h->v[i] = _mm256_add_epi64(f->v[i], g->v[i]);
+}
+
+/* h = f - g, carried (g must be carried) */
+GE_X4_TARGET static inline void fe_x4_sub(fe_x4 *h, const fe_x4 *f, const fe_x4 *g) {
+  int i;
+  GE_X4_UNROLL
+  for (i = 0; i < 10; ++i)
+    h->v[i] = _mm256_sub_epi64(_mm256_add_epi64(f->v[i], fe_x4_limb_bias(i, 2)), g->v[i]);
+  fe_x4_carry(h);
+}
+
+/* h = f * g, carried */
+GE_X4_TARGET static void fe_x4_mul(fe_x4 *h, const fe_x4 *f, const fe_x4 *g) {
+  const __m256i nineteen = _mm256_set1_epi64x(19);
+  __m256i f2[10];
+  __m256i g19[10];
+  __m256i t[10];
+  int i, j;
+
+
+  GE_X4_UNROLL
+  for (i = 0; i < 10; ++i) {
+    f2[i] = (i & 1) ? _mm256_slli_epi64(f->v[i], 1) : f->v[i];
+    g19[i] = _mm256_mul_epu32(g->v[i], nineteen);
+    t[i] = _mm256_setzero_si256();
+  }
+
+  /* h_k = sum_{i+j=k} f_i g_j + 19 * sum_{i+j=k+10} f_i g_j, with products of two odd limbs doubled */
+  GE_X4_UNROLL
+  for (i = 0; i < 10; ++i) {
+    GE_X4_UNROLL
+    for (j = 0; j < 10; ++j) {
+      const __m256i fi = (i & 1) && (j & 1) ? f2[i] : f->v[i];
+      if (i + j < 10)
+        t[i + j] = _mm256_add_epi64(t[i + j], _mm256_mul_epu32(fi, g->v[j]));
+      else
+        t[i + j - 10] = _mm256_add_epi64(t[i + j - 10], _mm256_mul_epu32(fi, g19[j]));
+    }
+  }
+
+
+  GE_X4_UNROLL
+  for (i = 0; i < 10; ++i)
+    h->v[i] = t[i];
+  fe_x4_carry(h);
+}
+
+/* h = f^2, carried (f must be carried) */
+GE_X4_TARGET static void fe_x4_sq(fe_x4 *h, const fe_x4 *f) {
+  const __m256i nineteen = _mm256_set1_epi64x(19);
+  __m256i f2[10];
+  __m256i f4[10];
+  __m256i f19[10];
+  __m256i t[10];
+  int i, j;
+
+  GE_X4_UNROLL
+  for (i = 0; i < 10; ++i) {
+    f2[i] = _mm256_slli_epi64(f->v[i], 1);
+    f4[i] = _mm256_slli_epi64(f->v[i], 2);
+    f19[i] = _mm256_mul_epu32(f->v[i], nineteen);
+    t[i] = _mm256_setzero_si256();
+  }
+
+  /* as fe_x4_mul(), but each cross term f_i f_j (i < j) is counted once, doubled */
+  GE_X4_UNROLL
+  for (i = 0; i < 10; ++i) {
+    GE_X4_UNROLL
+    for (j = i; j < 10; ++j) {
+      const int doubled = (i != j) + ((i & 1) && (j & 1));
+      const __m256i fi = doubled == 0 ? f->v[i] : doubled == 1 ? f2[i] : f4[i];
+      if (i + j < 10)
+        t[i + j] = _mm256_add_epi64(t[i + j], _mm256_mul_epu32(fi, f->v[j]));
+      else
+        t[i + j - 10] = _mm256_add_epi64(t[i + j - 10], _mm256_mul_epu32(fi, f19[j]));
+    }
+  }
+
+  GE_X4_UNROLL
+  for (i = 0; i < 10; ++i)
+    h->v[i] = t[i];
+  fe_x4_carry(h);
+}
+
+/* h = f^(2^n), carried */
+GE_X4_TARGET static void fe_x4_sq_n(fe_x4 *h, const fe_x4 *f, int n) {
+  int i;
+  fe_x4_sq(h, f);
+  for (i = 1; i < n; ++i)
+    fe_x4_sq(h, h);
+}
+
+/* load one coordinate of four points (ref10 limbs are signed, so a multiple of p is added before carrying) */
+GE_X4_TARGET static void fe_x4_load(fe_x4 *h, const int32_t *f0, const int32_t *f1, const int32_t *f2, const int32_t *f3) {
+  int i;
+  GE_X4_UNROLL
+  for (i = 0; i < 10; ++i)
+    h->v[i] = _mm256_add_epi64(_mm256_set_epi64x(f3[i], f2[i], f1[i], f0[i]), fe_x4_limb_bias(i, 8));
+  fe_x4_carry(h);
+}
+
+/* store one coordinate of four points, with limbs rebalanced to ref10's signed ranges (|h| <= 2^25, 2^24) */
+GE_X4_TARGET static void fe_x4_store(int32_t *f0, int32_t *f1, int32_t *f2, int32_t *f3, fe_x4 *h) {
+  uint64_t lanes[4];
+  __m256i c;
+  int i;
+
+  GE_X4_UNROLL
+  for (i = 0; i < 10; ++i) {
+    const int bits = (i & 1) ? 25 : 26;
+    c = _mm256_srli_epi64(_mm256_add_epi64(h->v[i], _mm256_set1_epi64x(1 << (bits - 1))), bits);
+    h->v[i] = _mm256_sub_epi64(h->v[i], _mm256_slli_epi64(c, bits));
+    if (i < 9)
+      h->v[i + 1] = _mm256_add_epi64(h->v[i + 1], c);
+    else
+      h->v[0] = _mm256_add_epi64(h->v[0], _mm256_mul_epu32(c, _mm256_set1_epi64x(19)));
+  }
+
+  GE_X4_UNROLL
+  for (i = 0; i < 10; ++i) {
+    _mm256_storeu_si256((__m256i*)lanes, h->v[i]);
+    f0[i] = (int32_t)lanes[0];
+    f1[i] = (int32_t)lanes[1];
+    f2[i] = (int32_t)lanes[2];
+    f3[i] = (int32_t)lanes[3];
+  }
+}
+
+#define FE_X4_LOAD(h, p, field) fe_x4_load(h, p[0]->field, p[1]->field, p[2]->field, p[3]->field)
+#define FE_X4_STORE(p, field, h) fe_x4_store(p[0]->field, p[1]->field, p[2]->field, p[3]->field, h)
+
+GE_X4_TARGET static void ge_p3_add_cached_x4_avx2(ge_p3 *const r[4], const ge_cached *const q[4]) {
+  fe_x4 pX, pY, pZ, pT;
+  fe_x4 qa, qb;
+  fe_x4 a, b, c, d;
+  fe_x4 X, Y, Z, T;
+
+  FE_X4_LOAD(&pX, r, X);
+  FE_X4_LOAD(&pY, r, Y);
+
+  /* ge_add */
+  fe_x4_add(&a, &pY, &pX);
+  fe_x4_sub(&b, &pY, &pX);
+  FE_X4_LOAD(&qa, q, YplusX);
+  FE_X4_LOAD(&qb, q, YminusX);
+  fe_x4_mul(&a, &a, &qa);
+  fe_x4_mul(&b, &b, &qb);
+
+  FE_X4_LOAD(&pT, r, T);
+  FE_X4_LOAD(&qa, q, T2d);
+  fe_x4_mul(&c, &qa, &pT);
+  FE_X4_LOAD(&pZ, r, Z);
+  FE_X4_LOAD(&qb, q, Z);
+  fe_x4_mul(&d, &pZ, &qb);
+
+  fe_x4_add(&d, &d, &d);
+  fe_x4_carry(&d);
+  fe_x4_sub(&X, &a, &b);
+  fe_x4_add(&Y, &a, &b);
+  fe_x4_add(&Z, &d, &c);
+  fe_x4_carry(&Z);
+  fe_x4_sub(&T, &d, &c);
+
+  /* ge_p1p1_to_p3 */
+  fe_x4_mul(&pX, &X, &T);
+  fe_x4_mul(&pY, &Y, &Z);
+  fe_x4_mul(&pZ, &Z, &T);
+  fe_x4_mul(&pT, &X, &Y);
+
+  FE_X4_STORE(r, X, &pX);
+  FE_X4_STORE(r, Y, &pY);
+  FE_X4_STORE(r, Z, &pZ);
+  FE_X4_STORE(r, T, &pT);
+}
+
+GE_X4_TARGET static void fe_pow22523_x4_avx2(fe out[4], fe z[4]) {
+  fe_x4 z4, t0, t1, t2;
+
+  fe_x4_load(&z4, z[0], z[1], z[2], z[3]);
+
+  /* From fe_pow22523.c */
+  fe_x4_sq(&t0, &z4);
+  fe_x4_sq_n(&t1, &t0, 2);
+  fe_x4_mul(&t1, &z4, &t1);
+  fe_x4_mul(&t0, &t0, &t1);
+  fe_x4_sq(&t0, &t0);
+  fe_x4_mul(&t0, &t1, &t0);
+  fe_x4_sq_n(&t1, &t0, 5);
+  fe_x4_mul(&t0, &t1, &t0);
+  fe_x4_sq_n(&t1, &t0, 10);
+  fe_x4_mul(&t1, &t1, &t0);
+  fe_x4_sq_n(&t2, &t1, 20);
+  fe_x4_mul(&t1, &t2, &t1);
+  fe_x4_sq_n(&t1, &t1, 10);
+  fe_x4_mul(&t0, &t1, &t0);
+  fe_x4_sq_n(&t1, &t0, 50);
+  fe_x4_mul(&t1, &t1, &t0);
+  fe_x4_sq_n(&t2, &t1, 100);
+  fe_x4_mul(&t1, &t2, &t1);
+  fe_x4_sq_n(&t1, &t1, 50);
+  fe_x4_mul(&t0, &t1, &t0);
+  fe_x4_sq_n(&t0, &t0, 2);
+  fe_x4_mul(&t0, &t0, &z4);
+  /* End fe_pow22523.c */
+
+  fe_x4_store(out[0], out[1], out[2], out[3], &t0);
+}
+
+/* 4-way batched scalar multiplication mod l
+ *
+ * sc_muladd() from crypto-ops.c, one lane per 64-bit AVX2 lane: limb vector i holds 21-bit limb i of each lane's
+ * scalar. Inputs are at most 25 bits per limb and every value that gets multiplied (input limbs, and limbs that are
+ * folded down by 2^252 = -(l - 2^252)) has been carried to a few more than 21 bits, so the products fit
+ * _mm256_mul_epi32's signed 32x32 -> 64 bit multiply. Sums stay below 2^62 in magnitude.
+ */
+
+/* as GE_X4_UNROLL, for the 12 limbs (and 24 product limbs) of a scalar */
+#define SC_X4_UNROLL _Pragma("GCC unroll 24")
+
+/* x >> 21 (arithmetic) for |x| < 2^62; AVX2 has no 64-bit arithmetic shift */
+GE_X4_TARGET static inline __m256i sc_x4_sra21(__m256i x) {
+  const __m256i bias = _mm256_set1_epi64x((int64_t)1 << 62);
+  return _mm256_sub_epi64(_mm256_srli_epi64(_mm256_add_epi64(x, bias), 21), _mm256_set1_epi64x((int64_t)1 << 41));
+}
+
+/* carry s[i] into s[i + 1], leaving s[i] in [-2^20, 2^20) (rounded) or [0, 2^21) (floored) */
+GE_X4_TARGET static inline void sc_x4_carry(__m256i *s, int i, int round) {
+  const __m256i carry = sc_x4_sra21(round ? _mm256_add_epi64(s[i], _mm256_set1_epi64x(1 << 20)) : s[i]);
+  s[i + 1] = _mm256_add_epi64(s[i + 1], carry);
+  s[i] = _mm256_sub_epi64(s[i], _mm256_slli_epi64(carry, 21));
+}
+
+/* fold limb i (i >= 12) into limbs i-12, ..., i-7 and clear it */
+GE_X4_TARGET static inline void sc_x4_fold(__m256i *s, int i) {
+  const __m256i t = s[i];
+  s[i - 12] = _mm256_add_epi64(s[i - 12], _mm256_mul_epi32(t, _mm256_set1_epi64x(666643)));
+  s[i - 11] = _mm256_add_epi64(s[i - 11], _mm256_mul_epi32(t, _mm256_set1_epi64x(470296)));
+  s[i - 10] = _mm256_add_epi64(s[i - 10], _mm256_mul_epi32(t, _mm256_set1_epi64x(654183)));
+  s[i - 9] = _mm256_sub_epi64(s[i - 9], _mm256_mul_epi32(t, _mm256_set1_epi64x(997805)));
+  s[i - 8] = _mm256_add_epi64(s[i - 8], _mm256_mul_epi32(t, _mm256_set1_epi64x(136657)));
+  s[i - 7] = _mm256_sub_epi64(s[i - 7], _mm256_mul_epi32(t, _mm256_set1_epi64x(683901)));
+  s[i] = _mm256_setzero_si256();
+}
+
+/* 4x4 transpose of 64-bit words: rows (one per lane) <-> columns (one word index per vector) */
+GE_X4_TARGET static inline void sc_x4_transpose(__m256i w[4]) {
+  const __m256i t0 = _mm256_unpacklo_epi64(w[0], w[1]);
+  const __m256i t1 = _mm256_unpackhi_epi64(w[0], w[1]);
+  const __m256i t2 = _mm256_unpacklo_epi64(w[2], w[3]);
+  const __m256i t3 = _mm256_unpackhi_epi64(w[2], w[3]);
+  w[0] = _mm256_permute2x128_si256(t0, t2, 0x20);
+  w[1] = _mm256_permute2x128_si256(t1, t3, 0x20);
+  w[2] = _mm256_permute2x128_si256(t0, t2, 0x31);
+  w[3] = _mm256_permute2x128_si256(t1, t3, 0x31);
+}
+
+/* limb i is bits [21i, 21i + 21) of the little-endian scalar (limb 11 is the top 25 bits) */
+GE_X4_TARGET static void sc_x4_load(__m256i v[12], const unsigned char *const a[4]) {
+  const __m256i mask21 = _mm256_set1_epi64x((1 << 21) - 1);
+  __m256i w[4];
+  int i;
+
+  for (i = 0; i < 4; ++i)
+    w[i] = _mm256_loadu_si256((const __m256i*)a[i]);
+  sc_x4_transpose(w);
+
+  SC_X4_UNROLL
+  for (i = 0; i < 12; ++i) {
+    const int word = 21 * i / 64;
+    const int shift = 21 * i % 64;
+    __m256i limb = _mm256_srli_epi64(w[word], shift);
+    if (shift > 64 - 21 && word < 3)
+      limb = _mm256_or_si256(limb, _mm256_slli_epi64(w[word + 1], 64 - shift));
+    v[i] = i < 11 ? _mm256_and_si256(limb, mask21) : limb;
+  }
+}
+
+/* limbs must be carried (limb i in [0, 2^21), limb 11 in [0, 2^19)) */
+GE_X4_TARGET static void sc_x4_store(unsigned char *const out[4], const __m256i v[12]) {
+  __m256i w[4];
+  int i;
+
+  for (i = 0; i < 4; ++i)
+    w[i] = _mm256_setzero_si256();
+
+  SC_X4_UNROLL
+  for (i = 0; i < 12; ++i) {
+    const int word = 21 * i / 64;
+    const int shift = 21 * i % 64;
+    w[word] = _mm256_or_si256(w[word], _mm256_slli_epi64(v[i], shift));
+    if (shift > 64 - 21 && word < 3)
+      w[word + 1] = _mm256_or_si256(w[word + 1], _mm256_srli_epi64(v[i], 64 - shift));
+  }
+
+  sc_x4_transpose(w);
+  for (i = 0; i < 4; ++i)
+    _mm256_storeu_si256((__m256i*)out[i], w[i]);
+}
+
+/* out[i] = a[i] * b[i] + c[i] mod l (c may be NULL for c[i] = 0) */
+GE_X4_TARGET static void sc_muladd_x4_avx2(unsigned char *const out[4], const unsigned char *const a[4],
+  const unsigned char *const b[4], const unsigned char *const c[4]) {
+  __m256i av[12], bv[12];
+  __m256i s[24];
+  int i, j;
+
+  /* all inputs are loaded before any output is stored, so outputs may alias inputs */
+  sc_x4_load(av, a);
+  sc_x4_load(bv, b);
+  if (c) {
+    sc_x4_load(s, c);
+  } else {
+    SC_X4_UNROLL
+    for (i = 0; i < 12; ++i)
+      s[i] = _mm256_setzero_si256();
+  }
+  for (i = 12; i < 24; ++i)
+    s[i] = _mm256_setzero_si256();
+
+  /* s_k = c_k + sum_{i+j=k} a_i b_j */
+  SC_X4_UNROLL
+  for (i = 0; i < 12; ++i) {
+    SC_X4_UNROLL
+    for (j = 0; j < 12; ++j)
+      s[i + j] = _mm256_add_epi64(s[i + j], _mm256_mul_epi32(av[i], bv[j]));
+  }
+
+  /* From sc_muladd */
+  SC_X4_UNROLL
+  for (i = 0; i <= 22; i += 2)
+    sc_x4_carry(s, i, 1);
+  SC_X4_UNROLL
+  for (i = 1; i <= 21; i += 2)
+    sc_x4_carry(s, i, 1);
+
+  SC_X4_UNROLL
+  for (i = 23; i >= 18; --i)
+    sc_x4_fold(s, i);
+
+  SC_X4_UNROLL
+  for (i = 6; i <= 16; i += 2)
+    sc_x4_carry(s, i, 1);
+  SC_X4_UNROLL
+  for (i = 7; i <= 15; i += 2)
+    sc_x4_carry(s, i, 1);
+
+  SC_X4_UNROLL
+  for (i = 17; i >= 12; --i)
+    sc_x4_fold(s, i);
+
+  SC_X4_UNROLL
+  for (i = 0; i <= 10; i += 2)
+    sc_x4_carry(s, i, 1);
+  SC_X4_UNROLL
+  for (i = 1; i <= 11; i += 2)
+    sc_x4_carry(s, i, 1);
+
+  sc_x4_fold(s, 12);
+
+  SC_X4_UNROLL
+  for (i = 0; i <= 11; ++i)
+    sc_x4_carry(s, i, 0);
+
+  sc_x4_fold(s, 12);
+
+  SC_X4_UNROLL
+  for (i = 0; i <= 10; ++i)
+    sc_x4_carry(s, i, 0);
+  /* End sc_muladd */
+
+  sc_x4_store(out, s);
+}
+
+#undef SC_X4_UNROLL
+#undef FE_X4_LOAD
+#undef FE_X4_STORE
+#endif
+
+int ge_x4_avx2_supported(void) {
+#if defined(GE_X4_AVX2)
+  static int supported = -1;
+  if (supported < 0) {
+    __builtin_cpu_init();
+    supported = __builtin_cpu_supports("avx2") ? 1 : 0;
+  }
+  return supported;
+#else
+  return 0;
+#endif
+}
+
+int fe_pow22523_x4(fe out[4], fe z[4]) {
+#if defined(GE_X4_AVX2)
+  if (ge_x4_avx2_supported()) {
+    fe_pow22523_x4_avx2(out, z);
+    return 1;
+  }
+#endif
+  (void)out;
+  (void)z;
+  return 0;
+}
+
+void ge_p3_add_cached_x4(ge_p3 *const r[4], const ge_cached *const q[4], int use_simd) {
+  ge_p1p1 t;
+  int i;
+
+#if defined(GE_X4_AVX2)
+  if (use_simd && ge_x4_avx2_supported()) {
+    ge_p3_add_cached_x4_avx2(r, q);
+    return;
+  }
+#endif
+
+  for (i = 0; i < 4; ++i) {
+    ge_add(&t, r[i], q[i]);
+    ge_p1p1_to_p3(r[i], &t);
+  }
+}
+
+void sc_muladd_x4(unsigned char *const s[4], const unsigned char *const a[4], const unsigned char *const b[4],
+  const unsigned char *const c[4], int use_simd) {
+  int i;
+
+#if defined(GE_X4_AVX2)
+  if (use_simd && ge_x4_avx2_supported()) {
+    sc_muladd_x4_avx2(s, a, b, c);
+    return;
+  }
+#endif
+
+  for (i = 0; i < 4; ++i) {
+    if (c)
+      sc_muladd(s[i], a[i], b[i], c[i]);
+    else
+      sc_mul(s[i], a[i], b[i]);
+  }
+}
+
+void sc_mul_x4(unsigned char *const s[4], const unsigned char *const a[4], const unsigned char *const b[4],
+  int use_simd) {
+  sc_muladd_x4(s, a, b, NULL, use_simd);
+}
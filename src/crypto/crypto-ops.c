@@ -42,6 +42,7 @@ static void fe_mul(fe, const fe, const fe);
 static void fe_sq(fe, const fe);
 static void ge_p3_dbl(ge_p1p1 *, const ge_p3 *);
 static void fe_divpowm1(fe, const fe, const fe);
+static void fe_divpowm1_prepare(fe, fe, const fe, const fe);
 
 /* Common functions */
 
@@ -1328,12 +1329,11 @@ void ge_double_scalarmult_base_vartime_p3(ge_p3 *r3, const unsigned char *a, con
 
 /* From ge_frombytes.c, modified */
 
-int ge_frombytes_vartime(ge_p3 *h, const unsigned char *s) {
-  fe u;
-  fe v;
-  fe vxx;
-  fe check;
+/* ge_frombytes_vartime() is split in two around the exponentiation, so ge_frombytes_vartime_batch() can do that part
+   four points at a time */
 
+/* h->Y, h->Z, u = y^2-1, v = dy^2+1 */
+static int ge_frombytes_vartime_begin(ge_p3 *h, fe u, fe v, const unsigned char *s) {
   /* From fe_frombytes.c */
 
   int64_t h0 = load_4(s);
@@ -1394,8 +1394,13 @@ int ge_frombytes_vartime(ge_p3 *h, const unsigned char *s) {
   fe_mul(v, u, fe_d);
   fe_sub(u, u, h->Z);       /* u = y^2-1 */
   fe_add(v, v, h->Z);       /* v = dy^2+1 */
+  return 0;
+}
 
-  fe_divpowm1(h->X, u, v); /* x = uv^3(uv^7)^((q-5)/8) */
+/* checks the candidate x = uv^3(uv^7)^((q-5)/8) in h->X, and finishes h */
+static int ge_frombytes_vartime_end(ge_p3 *h, const fe u, const fe v, const unsigned char *s) {
+  fe vxx;
+  fe check;
 
   fe_sq(vxx, h->X);
   fe_mul(vxx, vxx, v);
@@ -1420,6 +1425,62 @@ int ge_frombytes_vartime(ge_p3 *h, const unsigned char *s) {
   return 0;
 }
 
+int ge_frombytes_vartime(ge_p3 *h, const unsigned char *s) {
+  fe u;
+  fe v;
+
+  if (ge_frombytes_vartime_begin(h, u, v, s) != 0) {
+    return -1;
+  }
+  fe_divpowm1(h->X, u, v); /* x = uv^3(uv^7)^((q-5)/8) */
+  return ge_frombytes_vartime_end(h, u, v, s);
+}
+
+int ge_frombytes_vartime_batch(ge_p3 *h, const unsigned char *s, size_t n, int use_simd) {
+  fe u[4], v[4], v3[4], uv7[4];
+  int valid[4];
+  int result = 0;
+  size_t i = 0;
+  size_t j;
+
+  if (use_simd && ge_x4_avx2_supported()) {
+    for (; i + 4 <= n; i += 4) {
+      for (j = 0; j < 4; ++j) {
+        valid[j] = ge_frombytes_vartime_begin(&h[i + j], u[j], v[j], s + 32 * (i + j)) == 0;
+        if (!valid[j]) {
+          /* keep the lane well-defined */
+          fe_1(u[j]);
+          fe_1(v[j]);
+        }
+        fe_divpowm1_prepare(v3[j], uv7[j], u[j], v[j]);
+      }
+
+      if (!fe_pow22523_x4(uv7, uv7)) {
+        break;
+      }
+
+      for (j = 0; j < 4; ++j) {
+        if (!valid[j]) {
+          result = -1;
+          continue;
+        }
+        fe_mul(uv7[j], uv7[j], v3[j]);
+        fe_mul(h[i + j].X, uv7[j], u[j]);
+        if (ge_frombytes_vartime_end(&h[i + j], u[j], v[j], s + 32 * (i + j)) != 0) {
+          result = -1;
+        }
+      }
+    }
+  }
+
+  for (; i < n; ++i) {
+    if (ge_frombytes_vartime(&h[i], s + 32 * i) != 0) {
+      result = -1;
+    }
+  }
+  return result;
+}
+
 /* From ge_madd.c */
 
 /*
@@ -1604,20 +1665,20 @@ static void ge_precomp_cmov(ge_precomp *t, const ge_precomp *u, unsigned char b)
   fe_cmov(t->xy2d, u->xy2d, b);
 }
 
-static void select(ge_precomp *t, int pos, signed char b) {
+static void select(ge_precomp *t, const ge_precomp row[8], signed char b) {
   ge_precomp minust;
   unsigned char bnegative = negative(b);
   unsigned char babs = b - (((-bnegative) & b) << 1);
 
   ge_precomp_0(t);
-  ge_precomp_cmov(t, &ge_base[pos][0], equal(babs, 1));
-  ge_precomp_cmov(t, &ge_base[pos][1], equal(babs, 2));
-  ge_precomp_cmov(t, &ge_base[pos][2], equal(babs, 3));
-  ge_precomp_cmov(t, &ge_base[pos][3], equal(babs, 4));
-  ge_precomp_cmov(t, &ge_base[pos][4], equal(babs, 5));
-  ge_precomp_cmov(t, &ge_base[pos][5], equal(babs, 6));
-  ge_precomp_cmov(t, &ge_base[pos][6], equal(babs, 7));
-  ge_precomp_cmov(t, &ge_base[pos][7], equal(babs, 8));
+  ge_precomp_cmov(t, &row[0], equal(babs, 1));
+  ge_precomp_cmov(t, &row[1], equal(babs, 2));
+  ge_precomp_cmov(t, &row[2], equal(babs, 3));
+  ge_precomp_cmov(t, &row[3], equal(babs, 4));
+  ge_precomp_cmov(t, &row[4], equal(babs, 5));
+  ge_precomp_cmov(t, &row[5], equal(babs, 6));
+  ge_precomp_cmov(t, &row[6], equal(babs, 7));
+  ge_precomp_cmov(t, &row[7], equal(babs, 8));
   fe_copy(minust.yplusx, t->yminusx);
   fe_copy(minust.yminusx, t->yplusx);
   fe_neg(minust.xy2d, t->xy2d);
@@ -1634,6 +1695,20 @@ Preconditions:
 */
 
 void ge_scalarmult_base(ge_p3 *h, const unsigned char *a) {
+  ge_scalarmult_base_table(h, a, ge_base);
+}
+
+/*
+h = a * P
+where table[i][j] = (j+1) * 256^i * P (see ge_precomp_table_init())
+
+Same constant-time algorithm as ge_scalarmult_base(), for any base point with a precomputed table.
+
+Preconditions:
+  a[31] <= 127
+*/
+
+void ge_scalarmult_base_table(ge_p3 *h, const unsigned char *a, const ge_precomp table[32][8]) {
   signed char e[64];
   signed char carry;
   ge_p1p1 r;
@@ -1660,7 +1735,7 @@ void ge_scalarmult_base(ge_p3 *h, const unsigned char *a) {
 
   ge_p3_0(h);
   for (i = 1; i < 64; i += 2) {
-    select(&t, i / 2, e[i]);
+    select(&t, table[i / 2], e[i]);
     ge_madd(&r, h, &t); ge_p1p1_to_p3(h, &r);
   }
 
@@ -1670,11 +1745,63 @@ void ge_scalarmult_base(ge_p3 *h, const unsigned char *a) {
   ge_p2_dbl(&r, &s); ge_p1p1_to_p3(h, &r);
 
   for (i = 0; i < 64; i += 2) {
-    select(&t, i / 2, e[i]);
+    select(&t, table[i / 2], e[i]);
     ge_madd(&r, h, &t); ge_p1p1_to_p3(h, &r);
   }
 }
 
+/*
+r = p in affine precomputed form (y+x, y-x, 2dxy)
+*/
+
+static void ge_p3_to_precomp(ge_precomp *r, const ge_p3 *p) {
+  fe recip;
+  fe x;
+  fe y;
+  fe xy;
+
+  fe_invert(recip, p->Z);
+  fe_mul(x, p->X, recip);
+  fe_mul(y, p->Y, recip);
+  fe_add(r->yplusx, y, x);
+  fe_sub(r->yminusx, y, x);
+  fe_mul(xy, x, y);
+  fe_mul(r->xy2d, xy, fe_d2);
+}
+
+/*
+table[i][j] = (j+1) * 256^i * p, the layout of ge_base (for ge_scalarmult_base_table())
+
+Costs 256 field inversions, so tables should be made once per base point.
+*/
+
+void ge_precomp_table_init(ge_precomp table[32][8], const ge_p3 *p) {
+  ge_p3 row_base = *p;
+  ge_p3 multiple;
+  ge_cached row_base_cached;
+  ge_p1p1 r;
+  ge_p2 s;
+  int i, j, k;
+
+  for (i = 0; i < 32; ++i) {
+    /* (j+1) * 256^i * p */
+    ge_p3_to_cached(&row_base_cached, &row_base);
+    multiple = row_base;
+    ge_p3_to_precomp(&table[i][0], &multiple);
+    for (j = 1; j < 8; ++j) {
+      ge_add(&r, &multiple, &row_base_cached); ge_p1p1_to_p3(&multiple, &r);
+      ge_p3_to_precomp(&table[i][j], &multiple);
+    }
+
+    /* 256^(i+1) * p */
+    ge_p3_to_p2(&s, &row_base);
+    for (k = 0; k < 7; ++k) {
+      ge_p2_dbl(&r, &s); ge_p1p1_to_p2(&s, &r);
+    }
+    ge_p2_dbl(&r, &s); ge_p1p1_to_p3(&row_base, &r);
+  }
+}
+
 /* From ge_sub.c */
 
 /*
@@ -1710,6 +1837,42 @@ void ge_tobytes(unsigned char *s, const ge_p2 *h) {
   s[31] ^= fe_isnegative(x) << 7;
 }
 
+#define GE_TOBYTES_BATCH 64
+
+void ge_tobytes_batch(unsigned char *s, const ge_p2 *h, size_t n) {
+  fe prefix[GE_TOBYTES_BATCH]; /* prefix[i] = Z_0*...*Z_i */
+  fe recip;
+  fe z_inv;
+  fe x;
+  fe y;
+  size_t base, count, i;
+
+  for (base = 0; base < n; base += count) {
+    count = n - base < GE_TOBYTES_BATCH ? n - base : GE_TOBYTES_BATCH;
+
+    fe_copy(prefix[0], h[base].Z);
+    for (i = 1; i < count; ++i) {
+      fe_mul(prefix[i], prefix[i - 1], h[base + i].Z);
+    }
+
+    /* one inversion per group: recip = 1/(Z_0*...*Z_i), walking i down */
+    fe_invert(recip, prefix[count - 1]);
+    for (i = count; i-- > 0;) {
+      if (i > 0) {
+        fe_mul(z_inv, recip, prefix[i - 1]);
+        fe_mul(recip, recip, h[base + i].Z);
+      } else {
+        fe_copy(z_inv, recip);
+      }
+
+      fe_mul(x, h[base + i].X, z_inv);
+      fe_mul(y, h[base + i].Y, z_inv);
+      fe_tobytes(s + 32 * (base + i), y);
+      s[32 * (base + i) + 31] ^= fe_isnegative(x) << 7;
+    }
+  }
+}
+
 /* From sc_reduce.c */
 
 /*
@@ -1953,15 +2116,19 @@ void sc_reduce(unsigned char *s) {
 
 /* New code */
 
-static void fe_divpowm1(fe r, const fe u, const fe v) {
-  fe v3, uv7, t0, t1, t2;
-  int i;
-
+static void fe_divpowm1_prepare(fe v3, fe uv7, const fe u, const fe v) {
   fe_sq(v3, v);
   fe_mul(v3, v3, v); /* v3 = v^3 */
   fe_sq(uv7, v3);
   fe_mul(uv7, uv7, v);
   fe_mul(uv7, uv7, u); /* uv7 = uv^7 */
+}
+
+static void fe_divpowm1(fe r, const fe u, const fe v) {
+  fe v3, uv7, t0, t1, t2;
+  int i;
+
+  fe_divpowm1_prepare(v3, uv7, u, v);
 
   /*fe_pow22523(uv7, uv7);*/
 
@@ -2156,6 +2323,111 @@ void ge_scalarmult_p3(ge_p3 *r3, const unsigned char *a, const ge_p3 *A) {
   }
 }
 
+/*
+table[i][j] = (j+1) * 256^i * p in projective cached form (the layout of ge_base, without normalizing)
+
+Costs no field inversions, so unlike ge_precomp_table_init() it pays off after a few scalar multiplications of the
+same point (e.g. one enote pubkey scanned with many view keys).
+*/
+
+void ge_cached_table_init(ge_cached table[32][8], const ge_p3 *p) {
+  ge_p3 row_base = *p;
+  ge_p3 multiple;
+  ge_p1p1 r;
+  ge_p2 s;
+  int i, j, k;
+
+  for (i = 0; i < 32; ++i) {
+    /* (j+1) * 256^i * p */
+    ge_p3_to_cached(&table[i][0], &row_base);
+    multiple = row_base;
+    for (j = 1; j < 8; ++j) {
+      ge_add(&r, &multiple, &table[i][0]); ge_p1p1_to_p3(&multiple, &r);
+      ge_p3_to_cached(&table[i][j], &multiple);
+    }
+
+    /* 256^(i+1) * p */
+    ge_p3_to_p2(&s, &row_base);
+    for (k = 0; k < 7; ++k) {
+      ge_p2_dbl(&r, &s); ge_p1p1_to_p2(&s, &r);
+    }
+    ge_p2_dbl(&r, &s); ge_p1p1_to_p3(&row_base, &r);
+  }
+}
+
+static void select_cached(ge_cached *t, const ge_cached row[8], signed char b) {
+  ge_cached minust;
+  unsigned char bnegative = negative(b);
+  unsigned char babs = b - (((-bnegative) & b) << 1);
+
+  ge_cached_0(t);
+  ge_cached_cmov(t, &row[0], equal(babs, 1));
+  ge_cached_cmov(t, &row[1], equal(babs, 2));
+  ge_cached_cmov(t, &row[2], equal(babs, 3));
+  ge_cached_cmov(t, &row[3], equal(babs, 4));
+  ge_cached_cmov(t, &row[4], equal(babs, 5));
+  ge_cached_cmov(t, &row[5], equal(babs, 6));
+  ge_cached_cmov(t, &row[6], equal(babs, 7));
+  ge_cached_cmov(t, &row[7], equal(babs, 8));
+  fe_copy(minust.YplusX, t->YminusX);
+  fe_copy(minust.YminusX, t->YplusX);
+  fe_copy(minust.Z, t->Z);
+  fe_neg(minust.T2d, t->T2d);
+  ge_cached_cmov(t, &minust, bnegative);
+}
+
+/*
+h = a * P
+where table[i][j] = (j+1) * 256^i * P (see ge_cached_table_init())
+
+Same constant-time algorithm as ge_scalarmult_base_table(), with projective table entries.
+
+Preconditions:
+  a[31] <= 127
+*/
+
+void ge_scalarmult_cached_table(ge_p3 *h, const unsigned char *a, const ge_cached table[32][8]) {
+  signed char e[64];
+  signed char carry;
+  ge_p1p1 r;
+  ge_p2 s;
+  ge_cached t;
+  int i;
+
+  for (i = 0; i < 32; ++i) {
+    e[2 * i + 0] = (a[i] >> 0) & 15;
+    e[2 * i + 1] = (a[i] >> 4) & 15;
+  }
+  /* each e[i] is between 0 and 15 */
+  /* e[63] is between 0 and 7 */
+
+  carry = 0;
+  for (i = 0; i < 63; ++i) {
+    e[i] += carry;
+    carry = e[i] + 8;
+    carry >>= 4;
+    e[i] -= carry << 4;
+  }
+  e[63] += carry;
+  /* each e[i] is between -8 and 8 */
+
+  ge_p3_0(h);
+  for (i = 1; i < 64; i += 2) {
+    select_cached(&t, table[i / 2], e[i]);
+    ge_add(&r, h, &t); ge_p1p1_to_p3(h, &r);
+  }
+
+  ge_p3_dbl(&r, h);  ge_p1p1_to_p2(&s, &r);
+  ge_p2_dbl(&r, &s); ge_p1p1_to_p2(&s, &r);
+  ge_p2_dbl(&r, &s); ge_p1p1_to_p2(&s, &r);
+  ge_p2_dbl(&r, &s); ge_p1p1_to_p3(h, &r);
+
+  for (i = 0; i < 64; i += 2) {
+    select_cached(&t, table[i / 2], e[i]);
+    ge_add(&r, h, &t); ge_p1p1_to_p3(h, &r);
+  }
+}
+
 void ge_double_scalarmult_precomp_vartime2(ge_p2 *r, const unsigned char *a, const ge_dsmp Ai, const unsigned char *b, const ge_dsmp Bi) {
   signed char aslide[256];
   signed char bslide[256];
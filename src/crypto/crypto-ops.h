@@ -30,6 +30,7 @@
 
 #pragma once
 
+#include <stddef.h>
 #include <stdint.h>
 
 /* From fe.h */
@@ -89,6 +90,8 @@ void ge_double_scalarmult_base_vartime_p3(ge_p3 *, const unsigned char *, const
 extern const fe fe_sqrtm1;
 extern const fe fe_d;
 int ge_frombytes_vartime(ge_p3 *, const unsigned char *);
+/* decompress n points from 32-byte encodings at s; returns -1 if any is invalid (use_simd: see ge_p3_add_cached_x4()) */
+int ge_frombytes_vartime_batch(ge_p3 *h, const unsigned char *s, size_t n, int use_simd);
 
 /* From ge_p1p1_to_p2.c */
 
@@ -119,10 +122,15 @@ void ge_p3_tobytes(unsigned char *, const ge_p3 *);
 
 extern const ge_precomp ge_base[32][8];
 void ge_scalarmult_base(ge_p3 *, const unsigned char *);
+/* same as ge_scalarmult_base() for the base point of 'table' (made with ge_precomp_table_init()) */
+void ge_scalarmult_base_table(ge_p3 *, const unsigned char *, const ge_precomp table[32][8]);
+void ge_precomp_table_init(ge_precomp table[32][8], const ge_p3 *);
 
 /* From ge_tobytes.c */
 
 void ge_tobytes(unsigned char *, const ge_p2 *);
+/* compress n points to 32-byte encodings at s, sharing one field inversion per group of points */
+void ge_tobytes_batch(unsigned char *s, const ge_p2 *h, size_t n);
 
 /* From sc_reduce.c */
 
@@ -132,6 +140,10 @@ void sc_reduce(unsigned char *);
 
 void ge_scalarmult(ge_p2 *, const unsigned char *, const ge_p3 *);
 void ge_scalarmult_p3(ge_p3 *, const unsigned char *, const ge_p3 *);
+/* table[i][j] = (j+1) * 256^i * p in cached form; no inversions, so cheap enough to make per point */
+void ge_cached_table_init(ge_cached table[32][8], const ge_p3 *p);
+/* same as ge_scalarmult_base_table() for the point of 'table' (made with ge_cached_table_init()) */
+void ge_scalarmult_cached_table(ge_p3 *h, const unsigned char *a, const ge_cached table[32][8]);
 void ge_double_scalarmult_precomp_vartime(ge_p2 *, const unsigned char *, const ge_p3 *, const unsigned char *, const ge_dsmp);
 void ge_triple_scalarmult_precomp_vartime(ge_p2 *, const unsigned char *, const ge_dsmp, const unsigned char *, const ge_dsmp, const unsigned char *, const ge_dsmp);
 void ge_double_scalarmult_precomp_vartime2(ge_p2 *, const unsigned char *, const ge_dsmp, const unsigned char *, const ge_dsmp);
@@ -166,6 +178,20 @@ void fe_invert(fe out, const fe z);
 
 int ge_p3_is_point_at_infinity_vartime(const ge_p3 *p);
 
+/* From crypto-ops-x4.c */
+
+int ge_x4_avx2_supported(void);
+/* r[i] = r[i] + q[i] for four independent additions; uses the AVX2 backend if 'use_simd' and the CPU supports it */
+void ge_p3_add_cached_x4(ge_p3 *const r[4], const ge_cached *const q[4], int use_simd);
+/* out[i] = z[i]^((q-5)/8) for four field elements; returns 0 (and does nothing) without the AVX2 backend */
+int fe_pow22523_x4(fe out[4], fe z[4]);
+/* s[i] = a[i] * b[i] + c[i] mod l for four independent scalars (c may be NULL: s[i] = a[i] * b[i]); uses the AVX2
+   backend if 'use_simd' and the CPU supports it; outputs may alias inputs */
+void sc_muladd_x4(unsigned char *const s[4], const unsigned char *const a[4], const unsigned char *const b[4],
+  const unsigned char *const c[4], int use_simd);
+void sc_mul_x4(unsigned char *const s[4], const unsigned char *const a[4], const unsigned char *const b[4],
+  int use_simd);
+
 // miscellaneous
 void slide(signed char *r, const unsigned char *a);
 void ge_p2_0(ge_p2 *);
@@ -29,6 +29,7 @@
 // Parts of this file are originally copyright (c) 2012-2013 The Cryptonote developers
 
 #include <unistd.h>
+#include <algorithm>
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
@@ -202,6 +203,39 @@ namespace crypto {
     return true;
   }
 
+  bool crypto_ops::generate_key_derivations(const public_key *keys, std::size_t num_keys, const secret_key &key2, key_derivation *derivations, bool *valid) {
+    // group size matches the inversion sharing inside ge_tobytes_batch()
+    static constexpr std::size_t batch_size = 64;
+    ge_p3 points[batch_size];
+    ge_p2 results[batch_size];
+    ge_p2 point2;
+    ge_p1p1 point3;
+    bool all_valid = true;
+    assert(sc_check(&key2) == 0);
+    for (std::size_t base = 0; base < num_keys; base += batch_size) {
+      const std::size_t count = std::min(batch_size, num_keys - base);
+      // decompress the whole group at once, falling back to one key at a time to find the invalid ones
+      if (ge_frombytes_vartime_batch(points, reinterpret_cast<const unsigned char*>(&keys[base]), count, 1) == 0) {
+        std::fill(valid + base, valid + base + count, true);
+      } else {
+        for (std::size_t i = 0; i < count; ++i)
+          valid[base + i] = ge_frombytes_vartime(&points[i], &keys[base + i]) == 0;
+      }
+      for (std::size_t i = 0; i < count; ++i) {
+        if (!valid[base + i]) {
+          all_valid = false;
+          ge_p2_0(&results[i]);
+          continue;
+        }
+        ge_scalarmult(&point2, &unwrap(key2), &points[i]);
+        ge_mul8(&point3, &point2);
+        ge_p1p1_to_p2(&results[i], &point3);
+      }
+      ge_tobytes_batch(reinterpret_cast<unsigned char*>(&derivations[base]), results, count);
+    }
+    return all_valid;
+  }
+
   void crypto_ops::derivation_to_scalar(const key_derivation &derivation, size_t output_index, ec_scalar &res) {
     struct {
       key_derivation derivation;
@@ -261,6 +295,42 @@ namespace crypto {
     return true;
   }
 
+  bool crypto_ops::derive_subaddress_public_keys(const public_key *out_keys, const key_derivation *derivations, const std::size_t *output_indices, std::size_t num_keys, public_key *derived_keys, bool *valid) {
+    // group size matches the inversion sharing inside ge_tobytes_batch()
+    static constexpr std::size_t batch_size = 64;
+    ge_p3 points[batch_size];
+    ge_p2 results[batch_size];
+    ec_scalar scalar;
+    ge_p3 point2;
+    ge_cached point3;
+    ge_p1p1 point4;
+    bool all_valid = true;
+    for (std::size_t base = 0; base < num_keys; base += batch_size) {
+      const std::size_t count = std::min(batch_size, num_keys - base);
+      // decompress the whole group at once, falling back to one key at a time to find the invalid ones
+      if (ge_frombytes_vartime_batch(points, reinterpret_cast<const unsigned char*>(&out_keys[base]), count, 1) == 0) {
+        std::fill(valid + base, valid + base + count, true);
+      } else {
+        for (std::size_t i = 0; i < count; ++i)
+          valid[base + i] = ge_frombytes_vartime(&points[i], &out_keys[base + i]) == 0;
+      }
+      for (std::size_t i = 0; i < count; ++i) {
+        if (!valid[base + i]) {
+          all_valid = false;
+          ge_p2_0(&results[i]);
+          continue;
+        }
+        derivation_to_scalar(derivations[base + i], output_indices[base + i], scalar);
+        ge_scalarmult_base(&point2, &scalar);
+        ge_p3_to_cached(&point3, &point2);
+        ge_sub(&point4, &points[i], &point3);
+        ge_p1p1_to_p2(&results[i], &point4);
+      }
+      ge_tobytes_batch(reinterpret_cast<unsigned char*>(&derived_keys[base]), results, count);
+    }
+    return all_valid;
+  }
+
   struct s_comm {
     hash h;
     ec_point key;
@@ -749,4 +819,88 @@ POP_WARNINGS
     sc_sub(&h, &h, &sum);
     return sc_isnonzero(&h) == 0;
   }
+
+  bool crypto_ops::check_ring_signatures(const ring_signature_check *checks, std::size_t num_checks, bool *valid) {
+    std::size_t num_members = 0, max_members = 0;
+    for (std::size_t n = 0; n < num_checks; ++n) {
+      num_members += checks[n].pubs_count;
+      max_members = std::max(max_members, checks[n].pubs_count);
+    }
+    boost::shared_ptr<rs_comm> buf(reinterpret_cast<rs_comm *>(malloc(rs_comm_size(max_members))), free);
+    if (!buf) {
+      std::fill(valid, valid + num_checks, false);
+      return false;
+    }
+
+    // decompress the ring members of every signature together, falling back to one key at a time to find the invalid ones
+    std::vector<public_key> members;
+    members.reserve(num_members);
+    for (std::size_t n = 0; n < num_checks; ++n) {
+      for (std::size_t i = 0; i < checks[n].pubs_count; ++i) {
+#if !defined(NDEBUG)
+        assert(check_key(*checks[n].pubs[i]));
+#endif
+        members.push_back(*checks[n].pubs[i]);
+      }
+    }
+    std::vector<ge_p3> member_points(num_members);
+    std::vector<char> member_valid(num_members, 1);
+    if (num_members > 0 && ge_frombytes_vartime_batch(member_points.data(), reinterpret_cast<const unsigned char*>(members.data()), num_members, 1) != 0) {
+      for (std::size_t k = 0; k < num_members; ++k)
+        member_valid[k] = ge_frombytes_vartime(&member_points[k], &members[k]) == 0;
+    }
+
+    // L_i = r_i*G + c_i*P_i and R_i = r_i*Hp(P_i) + c_i*I for every member of every ring; the points of
+    // all the rings share field inversions when compressed
+    std::vector<ge_p2> comm_points(2 * num_members);
+    std::vector<ec_scalar> sums(num_checks);
+    std::size_t offset = 0;
+    for (std::size_t n = 0; n < num_checks; ++n) {
+      const ring_signature_check &check = checks[n];
+      ge_p3 image_unp;
+      ge_dsmp image_pre;
+      valid[n] = ge_frombytes_vartime(&image_unp, &*check.image) == 0;
+      if (valid[n])
+        ge_dsm_precomp(image_pre, &image_unp);
+      sc_0(&sums[n]);
+      for (std::size_t i = 0; i < check.pubs_count; ++i) {
+        ge_p2 &L = comm_points[2 * (offset + i)];
+        ge_p2 &R = comm_points[2 * (offset + i) + 1];
+        if (valid[n] && (sc_check(&check.sig[i].c) != 0 || sc_check(&check.sig[i].r) != 0 || !member_valid[offset + i]))
+          valid[n] = false;
+        if (!valid[n]) {
+          ge_p2_0(&L);
+          ge_p2_0(&R);
+          continue;
+        }
+        ge_p3 tmp3;
+        ge_double_scalarmult_base_vartime(&L, &check.sig[i].c, &member_points[offset + i], &check.sig[i].r);
+        hash_to_ec(*check.pubs[i], tmp3);
+        ge_double_scalarmult_precomp_vartime(&R, &check.sig[i].r, &tmp3, &check.sig[i].c, image_pre);
+        sc_add(&sums[n], &sums[n], &check.sig[i].c);
+      }
+      offset += check.pubs_count;
+    }
+    std::vector<ec_point_pair> comms(num_members);
+    ge_tobytes_batch(reinterpret_cast<unsigned char*>(comms.data()), comm_points.data(), comm_points.size());
+
+    // challenge: H(prefix, L_0, R_0, ...) == sum(c_i), per ring
+    bool all_valid = true;
+    offset = 0;
+    for (std::size_t n = 0; n < num_checks; ++n) {
+      const ring_signature_check &check = checks[n];
+      if (valid[n]) {
+        ec_scalar h;
+        buf->h = *check.prefix_hash;
+        if (check.pubs_count > 0)
+          memcpy(buf->ab, &comms[offset], check.pubs_count * sizeof(ec_point_pair));
+        hash_to_scalar(buf.get(), rs_comm_size(check.pubs_count), h);
+        sc_sub(&h, &h, &sums[n]);
+        valid[n] = sc_isnonzero(&h) == 0;
+      }
+      all_valid = all_valid && valid[n];
+      offset += check.pubs_count;
+    }
+    return all_valid;
+  }
 }
@@ -99,6 +99,16 @@ namespace crypto {
   void hash_to_scalar(const void *data, size_t length, ec_scalar &res);
   void random32_unbiased(unsigned char *bytes);
 
+  /* One ring signature for check_ring_signatures(): the arguments of check_ring_signature().
+   */
+  struct ring_signature_check {
+    const hash *prefix_hash;
+    const key_image *image;
+    const public_key *const *pubs;
+    std::size_t pubs_count;
+    const signature *sig;
+  };
+
   static_assert(sizeof(ec_point) == 32 && sizeof(ec_scalar) == 32 &&
     sizeof(public_key) == 32 && sizeof(secret_key) == 32 &&
     sizeof(key_derivation) == 32 && sizeof(key_image) == 32 &&
@@ -118,6 +128,8 @@ namespace crypto {
     friend bool secret_key_to_public_key(const secret_key &, public_key &);
     static bool generate_key_derivation(const public_key &, const secret_key &, key_derivation &);
     friend bool generate_key_derivation(const public_key &, const secret_key &, key_derivation &);
+    static bool generate_key_derivations(const public_key *, std::size_t, const secret_key &, key_derivation *, bool *);
+    friend bool generate_key_derivations(const public_key *, std::size_t, const secret_key &, key_derivation *, bool *);
     static void derivation_to_scalar(const key_derivation &derivation, size_t output_index, ec_scalar &res);
     friend void derivation_to_scalar(const key_derivation &derivation, size_t output_index, ec_scalar &res);
     static bool derive_public_key(const key_derivation &, std::size_t, const public_key &, public_key &);
@@ -126,6 +138,8 @@ namespace crypto {
     friend void derive_secret_key(const key_derivation &, std::size_t, const secret_key &, secret_key &);
     static bool derive_subaddress_public_key(const public_key &, const key_derivation &, std::size_t, public_key &);
     friend bool derive_subaddress_public_key(const public_key &, const key_derivation &, std::size_t, public_key &);
+    static bool derive_subaddress_public_keys(const public_key *, const key_derivation *, const std::size_t *, std::size_t, public_key *, bool *);
+    friend bool derive_subaddress_public_keys(const public_key *, const key_derivation *, const std::size_t *, std::size_t, public_key *, bool *);
     static void generate_signature(const hash &, const public_key &, const secret_key &, signature &);
     friend void generate_signature(const hash &, const public_key &, const secret_key &, signature &);
     static bool check_signature(const hash &, const public_key &, const signature &);
@@ -146,6 +160,8 @@ namespace crypto {
       const public_key *const *, std::size_t, const signature *);
     friend bool check_ring_signature(const hash &, const key_image &,
       const public_key *const *, std::size_t, const signature *);
+    static bool check_ring_signatures(const ring_signature_check *, std::size_t, bool *);
+    friend bool check_ring_signatures(const ring_signature_check *, std::size_t, bool *);
   };
 
   void generate_random_bytes_thread_safe(size_t N, uint8_t *bytes);
@@ -219,6 +235,16 @@ namespace crypto {
   inline bool generate_key_derivation(const public_key &key1, const secret_key &key2, key_derivation &derivation) {
     return crypto_ops::generate_key_derivation(key1, key2, derivation);
   }
+  /* Batched form of generate_key_derivation() for many tx pubkeys and one view key.
+   * Keys are decompressed in groups and the resulting points share field inversions on compression,
+   * so this is cheaper than one call per key.
+   * valid[i] is false (and derivations[i] left as the identity) if keys[i] does not decompress.
+   * Returns true if every key was valid.
+   */
+  inline bool generate_key_derivations(const public_key *keys, std::size_t num_keys, const secret_key &key2,
+    key_derivation *derivations, bool *valid) {
+    return crypto_ops::generate_key_derivations(keys, num_keys, key2, derivations, valid);
+  }
   inline bool derive_public_key(const key_derivation &derivation, std::size_t output_index,
     const public_key &base, public_key &derived_key) {
     return crypto_ops::derive_public_key(derivation, output_index, base, derived_key);
@@ -233,6 +259,15 @@ namespace crypto {
   inline bool derive_subaddress_public_key(const public_key &out_key, const key_derivation &derivation, std::size_t output_index, public_key &result) {
     return crypto_ops::derive_subaddress_public_key(out_key, derivation, output_index, result);
   }
+  /* Batched form of derive_subaddress_public_key() for many (output key, derivation, output index) triples.
+   * Output keys are decompressed in groups and the results share field inversions on compression.
+   * valid[i] is false (and results[i] left as the identity) if out_keys[i] does not decompress.
+   * Returns true if every output key was valid.
+   */
+  inline bool derive_subaddress_public_keys(const public_key *out_keys, const key_derivation *derivations,
+    const std::size_t *output_indices, std::size_t num_keys, public_key *results, bool *valid) {
+    return crypto_ops::derive_subaddress_public_keys(out_keys, derivations, output_indices, num_keys, results, valid);
+  }
 
   /* Generation and checking of a standard signature.
    */
@@ -277,6 +312,14 @@ namespace crypto {
     const signature *sig) {
     return crypto_ops::check_ring_signature(prefix_hash, image, pubs, pubs_count, sig);
   }
+  /* Batched form of check_ring_signature() for many rings, e.g. every pre-RingCT input of a block.
+   * The ring members of all the rings are decompressed together, and the L/R points of all the rings
+   * share field inversions on compression; each ring's challenge is still hashed and checked on its own.
+   * valid[i] is set to whether checks[i] verifies. Returns true if all of them do.
+   */
+  inline bool check_ring_signatures(const ring_signature_check *checks, std::size_t num_checks, bool *valid) {
+    return crypto_ops::check_ring_signatures(checks, num_checks, valid);
+  }
 
   /* Variants with vector<const public_key *> parameters.
    */
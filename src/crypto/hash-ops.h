@@ -99,3 +99,5 @@ uint64_t rx_seedheight(const uint64_t height);
 void rx_seedheights(const uint64_t height, uint64_t *seed_height, uint64_t *next_height);
 void rx_slow_hash(const uint64_t mainheight, const uint64_t seedheight, const char *seedhash, const void *data, size_t length, char *hash, int miners, int is_alt);
 void rx_reorg(const uint64_t split_height);
+void rx_set_next_seedhash(const uint64_t seedheight, const char *seedhash, const int max_dataset_init_threads);
+void rx_stop_mining(void);
@@ -0,0 +1,215 @@
+// Copyright (c) 2021, The Monero Project
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of
+//    conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list
+//    of conditions and the following disclaimer in the documentation and/or other
+//    materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be
+//    used to endorse or promote products derived from this software without specific
+//    prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+// THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <stdint.h>
+#include <string.h>
+
+#include "int-util.h"
+#include "keccak.h"
+
+/* 4-way batched Keccak (256-bit digests, as in cn_fast_hash)
+ *
+ * Verifiers hash many short, independent inputs (proof messages, aggregation coefficients). Here four of them are
+ * absorbed side by side, one per 64-bit lane of an AVX2 register: Keccak state word i is one vector holding word i
+ * of each of the four lanes' states. Lanes may have different lengths; every lane's digest is read out right after
+ * its last block is permuted, and later permutations of a finished lane are ignored.
+ */
+
+#define KECCAK_X4_RATE 136
+#define KECCAK_X4_RATE_WORDS (KECCAK_X4_RATE / 8)
+#define KECCAK_X4_DIGEST_WORDS 4
+
+extern const uint64_t keccakf_rndc[24];
+extern const int keccakf_rotc[24];
+extern const int keccakf_piln[24];
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define KECCAK_X4_AVX2 1
+#endif
+
+#if defined(KECCAK_X4_AVX2)
+#include <immintrin.h>
+
+#define KECCAK_X4_TARGET __attribute__((target("avx2")))
+/* the state loops must be fully unrolled so the rotation counts and indices are constants (not the default at -O2) */
+#define KECCAK_X4_UNROLL _Pragma("GCC unroll 25")
+
+KECCAK_X4_TARGET static inline __m256i rotl_x4(const __m256i x, const int n) {
+  return _mm256_or_si256(_mm256_slli_epi64(x, n), _mm256_srli_epi64(x, 64 - n));
+}
+
+KECCAK_X4_TARGET static void keccakf_x4_avx2(uint64_t st[4][25]) {
+  __m256i a[25], bc[5], t;
+  int i, j, round;
+
+  KECCAK_X4_UNROLL
+  for (i = 0; i < 25; ++i)
+    a[i] = _mm256_set_epi64x((long long)st[3][i], (long long)st[2][i], (long long)st[1][i], (long long)st[0][i]);
+
+  for (round = 0; round < KECCAK_ROUNDS; ++round) {
+    /* Theta */
+    KECCAK_X4_UNROLL
+    for (i = 0; i < 5; ++i)
+      bc[i] = _mm256_xor_si256(_mm256_xor_si256(_mm256_xor_si256(a[i], a[i + 5]), _mm256_xor_si256(a[i + 10], a[i + 15])),
+        a[i + 20]);
+
+    KECCAK_X4_UNROLL
+    for (i = 0; i < 5; ++i) {
+      t = _mm256_xor_si256(bc[(i + 4) % 5], rotl_x4(bc[(i + 1) % 5], 1));
+      KECCAK_X4_UNROLL
+      for (j = 0; j < 25; j += 5)
+        a[j + i] = _mm256_xor_si256(a[j + i], t);
+    }
+
+    /* Rho Pi */
+    t = a[1];
+    KECCAK_X4_UNROLL
+    for (i = 0; i < 24; ++i) {
+      j = keccakf_piln[i];
+      bc[0] = a[j];
+      a[j] = rotl_x4(t, keccakf_rotc[i]);
+      t = bc[0];
+    }
+
+    /* Chi */
+    KECCAK_X4_UNROLL
+    for (j = 0; j < 25; j += 5) {
+      KECCAK_X4_UNROLL
+      for (i = 0; i < 5; ++i)
+        bc[i] = a[j + i];
+      KECCAK_X4_UNROLL
+      for (i = 0; i < 5; ++i)
+        a[j + i] = _mm256_xor_si256(a[j + i], _mm256_andnot_si256(bc[(i + 1) % 5], bc[(i + 2) % 5]));
+    }
+
+    /* Iota */
+    a[0] = _mm256_xor_si256(a[0], _mm256_set1_epi64x((long long)keccakf_rndc[round]));
+  }
+
+  KECCAK_X4_UNROLL
+  for (i = 0; i < 25; ++i) {
+    uint64_t lanes[4];
+    _mm256_storeu_si256((__m256i*)lanes, a[i]);
+    st[0][i] = lanes[0];
+    st[1][i] = lanes[1];
+    st[2][i] = lanes[2];
+    st[3][i] = lanes[3];
+  }
+}
+#endif
+
+int keccak_x4_avx2_supported(void) {
+#if defined(KECCAK_X4_AVX2)
+  static int supported = -1;
+  if (supported < 0) {
+    __builtin_cpu_init();
+    supported = __builtin_cpu_supports("avx2") ? 1 : 0;
+  }
+  return supported;
+#else
+  return 0;
+#endif
+}
+
+void keccakf_x4(uint64_t st[4][25]) {
+  int i;
+
+#if defined(KECCAK_X4_AVX2)
+  if (keccak_x4_avx2_supported()) {
+    keccakf_x4_avx2(st);
+    return;
+  }
+#endif
+
+  for (i = 0; i < 4; ++i)
+    keccakf(st[i], KECCAK_ROUNDS);
+}
+
+/* xor block 'block' of a message (padded as in keccak()) into a state */
+static void keccak_x4_absorb_block(uint64_t st[25], const uint8_t *in, const size_t inlen, const size_t block) {
+  uint8_t temp[KECCAK_X4_RATE];
+  const size_t offset = block * KECCAK_X4_RATE;
+  const uint8_t *block_in = in + offset;
+  size_t i;
+
+  if (inlen - offset < KECCAK_X4_RATE) {
+    /* last block: remaining bytes, then padding */
+    const size_t rest = inlen - offset;
+    if (rest > 0)
+      memcpy(temp, block_in, rest);
+    memset(temp + rest, 0, KECCAK_X4_RATE - rest);
+    temp[rest] |= 0x01;
+    temp[KECCAK_X4_RATE - 1] |= 0x80;
+    block_in = temp;
+  }
+
+  for (i = 0; i < KECCAK_X4_RATE_WORDS; ++i) {
+    uint64_t word;
+    memcpy(&word, block_in + i * 8, 8);
+    st[i] ^= swap64le(word);
+  }
+}
+
+void keccak_batch(const uint8_t *const *in, const size_t *inlen, uint8_t *const *md, const size_t n) {
+  uint64_t st[4][25];
+  size_t num_blocks[4];
+  size_t max_blocks, base, block, lane, lanes;
+
+  for (base = 0; base < n; base += 4) {
+    lanes = n - base < 4 ? n - base : 4;
+
+    /* a lone input gains nothing from the wide permutation */
+    if (lanes == 1 || !keccak_x4_avx2_supported()) {
+      for (lane = 0; lane < lanes; ++lane)
+        keccak(in[base + lane], inlen[base + lane], md[base + lane], KECCAK_X4_DIGEST_WORDS * 8);
+      continue;
+    }
+
+    memset(st, 0, sizeof(st));
+    max_blocks = 0;
+    for (lane = 0; lane < lanes; ++lane) {
+      num_blocks[lane] = inlen[base + lane] / KECCAK_X4_RATE + 1;
+      if (num_blocks[lane] > max_blocks)
+        max_blocks = num_blocks[lane];
+    }
+
+    for (block = 0; block < max_blocks; ++block) {
+      for (lane = 0; lane < lanes; ++lane) {
+        if (block < num_blocks[lane])
+          keccak_x4_absorb_block(st[lane], in[base + lane], inlen[base + lane], block);
+      }
+
+      keccakf_x4(st);
+
+      for (lane = 0; lane < lanes; ++lane) {
+        if (block + 1 == num_blocks[lane])
+          memcpy_swap64le(md[base + lane], st[lane], KECCAK_X4_DIGEST_WORDS);
+      }
+    }
+  }
+}
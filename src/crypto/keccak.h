@@ -37,4 +37,11 @@ void keccak1600(const uint8_t *in, size_t inlen, uint8_t *md);
 void keccak_init(KECCAK_CTX * ctx);
 void keccak_update(KECCAK_CTX * ctx, const uint8_t *in, size_t inlen);
 void keccak_finish(KECCAK_CTX * ctx, uint8_t *md);
+
+// From keccak-x4.c
+int keccak_x4_avx2_supported(void);
+// permute four states at once (AVX2 when the CPU supports it)
+void keccakf_x4(uint64_t st[4][25]);
+// md[i] = keccak(in[i], inlen[i], md[i], 32) for n inputs, hashed four at a time
+void keccak_batch(const uint8_t *const *in, const size_t *inlen, uint8_t *const *md, const size_t n);
 #endif
@@ -35,6 +35,10 @@
 #include <stdlib.h>
 #include <unistd.h>
 #include <limits.h>
+#if defined(__linux__)
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#endif
 
 #include "randomx.h"
 #include "c_threads.h"
@@ -56,15 +60,40 @@ typedef struct rx_state {
   randomx_cache *rs_cache;
 } rx_state;
 
+/* Mining (and sync PoW checking) VMs use the dataset of their own NUMA node,
+ * and the dataset for the next seed is built in the background, ahead of the
+ * seed switch, then swapped in. */
+#define RX_MAX_NUMA_NODES	8
+#define RX_DATASET_ITEM_SIZE	64
+#define RX_NEXT_SEED_NICE	10
+
+typedef struct rx_numa_dataset {
+  randomx_dataset *rd_dataset;
+  uint64_t rd_height;
+  randomx_dataset *rd_next;	/* ready for rd_next_height, or a spare */
+  uint64_t rd_next_height;
+  char rd_next_hash[HASH_SIZE];
+} rx_numa_dataset;
+
 static CTHR_MUTEX_TYPE rx_mutex = CTHR_MUTEX_INIT;
 static CTHR_MUTEX_TYPE rx_dataset_mutex = CTHR_MUTEX_INIT;
+static CTHR_MUTEX_TYPE rx_next_mutex = CTHR_MUTEX_INIT;
 
 static rx_state rx_s[2] = {{CTHR_MUTEX_INIT,{0},0,0},{CTHR_MUTEX_INIT,{0},0,0}};
 
-static randomx_dataset *rx_dataset;
+static rx_numa_dataset rx_datasets[RX_MAX_NUMA_NODES];
 static int rx_dataset_nomem;
-static uint64_t rx_dataset_height;
 static THREADV randomx_vm *rx_vm = NULL;
+static THREADV randomx_dataset *rx_vm_dataset = NULL;
+static THREADV unsigned int rx_vm_node = 0;
+
+static CTHR_THREAD_TYPE rx_next_thread;
+static int rx_next_thread_started;
+static int rx_next_running;
+static uint64_t rx_next_height = 1;	/* set to an invalid seed height */
+static char rx_next_hash[HASH_SIZE];
+static int rx_next_threads;
+static randomx_cache *rx_next_cache;	/* only used by the rx_next_seedthread */
 
 static void local_abort(const char *msg)
 {
@@ -156,17 +185,91 @@ static unsigned int get_seedhash_epoch_blocks(void)
   return blocks;
 }
 
+static unsigned int rx_numa_node_count(void) {
+  static unsigned int count = 0;
+
+  if (count) {
+    return count;
+  }
+
+#if defined(__linux__)
+  {
+    char path[64];
+    unsigned int n = 0;
+    while (n < RX_MAX_NUMA_NODES) {
+      snprintf(path, sizeof(path), "/sys/devices/system/node/node%u", n);
+      if (access(path, F_OK) != 0)
+        break;
+      ++n;
+    }
+    count = n ? n : 1;
+  }
+#else
+  count = 1;
+#endif
+
+  return count;
+}
+
+static unsigned int rx_current_numa_node(void) {
+#if defined(__linux__) && defined(SYS_getcpu)
+  unsigned int cpu, node;
+  if (rx_numa_node_count() > 1 && syscall(SYS_getcpu, &cpu, &node, NULL) == 0 && node < rx_numa_node_count())
+    return node;
+#endif
+  return 0;
+}
+
+/* pages of the dataset go to the node when first written, i.e. by randomx_init_dataset */
+static void rx_bind_dataset(randomx_dataset *dataset, const unsigned int node) {
+#if defined(__linux__) && defined(SYS_mbind)
+  if (rx_numa_node_count() > 1) {
+    const uintptr_t page = 4096;
+    const uintptr_t start = ((uintptr_t)randomx_get_dataset_memory(dataset) + page - 1) & ~(page - 1);
+    const uintptr_t end = ((uintptr_t)randomx_get_dataset_memory(dataset) + randomx_dataset_item_count() * RX_DATASET_ITEM_SIZE) & ~(page - 1);
+    unsigned long nodemask = 1UL << node;
+    /* MPOL_PREFERRED, so a full node spills over instead of failing */
+    if (end > start && syscall(SYS_mbind, start, end - start, 1, &nodemask, sizeof(nodemask) * CHAR_BIT, 0) != 0)
+      mdebug(RX_LOGCAT, "Couldn't bind RandomX dataset to its NUMA node");
+  }
+#endif
+}
+
+static randomx_dataset *rx_alloc_dataset(const unsigned int node) {
+  randomx_dataset *dataset = NULL;
+  if (!(disabled_flags() & RANDOMX_FLAG_LARGE_PAGES)) {
+    dataset = randomx_alloc_dataset(RANDOMX_FLAG_LARGE_PAGES);
+    if (dataset == NULL) {
+      mdebug(RX_LOGCAT, "Couldn't use largePages for RandomX dataset");
+    }
+  }
+  if (dataset == NULL)
+    dataset = randomx_alloc_dataset(RANDOMX_FLAG_DEFAULT);
+  if (dataset != NULL)
+    rx_bind_dataset(dataset, node);
+  return dataset;
+}
+
 void rx_reorg(const uint64_t split_height) {
   int i;
+  unsigned int node;
   CTHR_MUTEX_LOCK(rx_mutex);
   for (i=0; i<2; i++) {
     if (split_height <= rx_s[i].rs_height) {
-      if (rx_s[i].rs_height == rx_dataset_height)
-        rx_dataset_height = 1;
+      for (node=0; node<RX_MAX_NUMA_NODES; node++) {
+        if (rx_s[i].rs_height == rx_datasets[node].rd_height)
+          rx_datasets[node].rd_height = 1;
+        if (rx_s[i].rs_height == rx_datasets[node].rd_next_height)
+          rx_datasets[node].rd_next_height = 1;
+      }
       rx_s[i].rs_height = 1;	/* set to an invalid seed height */
     }
   }
   CTHR_MUTEX_UNLOCK(rx_mutex);
+  CTHR_MUTEX_LOCK(rx_next_mutex);
+  if (split_height <= rx_next_height)
+    rx_next_height = 1;
+  CTHR_MUTEX_UNLOCK(rx_next_mutex);
 }
 
 uint64_t rx_seedheight(const uint64_t height) {
@@ -183,6 +286,7 @@ void rx_seedheights(const uint64_t height, uint64_t *seedheight, uint64_t *nexth
 }
 
 typedef struct seedinfo {
+  randomx_dataset *si_dataset;
   randomx_cache *si_cache;
   unsigned long si_start;
   unsigned long si_count;
@@ -190,11 +294,11 @@ typedef struct seedinfo {
 
 static CTHR_THREAD_RTYPE rx_seedthread(void *arg) {
   seedinfo *si = arg;
-  randomx_init_dataset(rx_dataset, si->si_cache, si->si_start, si->si_count);
+  randomx_init_dataset(si->si_dataset, si->si_cache, si->si_start, si->si_count);
   CTHR_THREAD_RETURN;
 }
 
-static void rx_initdata(randomx_cache *rs_cache, const int miners, const uint64_t seedheight) {
+static void rx_initdata(randomx_dataset *rs_dataset, randomx_cache *rs_cache, const int miners) {
   if (miners > 1) {
     unsigned long delta = randomx_dataset_item_count() / miners;
     unsigned long start = 0;
@@ -210,27 +314,198 @@ static void rx_initdata(randomx_cache *rs_cache, const int miners, const uint64_
       local_abort("Couldn't allocate RandomX mining threadlist");
     }
     for (i=0; i<miners-1; i++) {
+      si[i].si_dataset = rs_dataset;
       si[i].si_cache = rs_cache;
       si[i].si_start = start;
       si[i].si_count = delta;
       start += delta;
     }
+    si[i].si_dataset = rs_dataset;
     si[i].si_cache = rs_cache;
     si[i].si_start = start;
     si[i].si_count = randomx_dataset_item_count() - start;
     for (i=1; i<miners; i++) {
       CTHR_THREAD_CREATE(st[i], rx_seedthread, &si[i]);
     }
-    randomx_init_dataset(rx_dataset, rs_cache, 0, si[0].si_count);
+    randomx_init_dataset(rs_dataset, rs_cache, 0, si[0].si_count);
     for (i=1; i<miners; i++) {
       CTHR_THREAD_JOIN(st[i]);
     }
     free(st);
     free(si);
   } else {
-    randomx_init_dataset(rx_dataset, rs_cache, 0, randomx_dataset_item_count());
+    randomx_init_dataset(rs_dataset, rs_cache, 0, randomx_dataset_item_count());
+  }
+}
+
+static randomx_cache *rx_alloc_cache(void) {
+  randomx_flags flags = enabled_flags() & ~disabled_flags();
+  randomx_cache *cache = NULL;
+  if (!(disabled_flags() & RANDOMX_FLAG_LARGE_PAGES)) {
+    cache = randomx_alloc_cache(flags | RANDOMX_FLAG_LARGE_PAGES);
+    if (cache == NULL) {
+      mdebug(RX_LOGCAT, "Couldn't use largePages for RandomX cache");
+    }
+  }
+  if (cache == NULL) {
+    cache = randomx_alloc_cache(flags);
+    if (cache == NULL)
+      local_abort("Couldn't allocate RandomX cache");
+  }
+  return cache;
+}
+
+/* rx_sp->rs_mutex must be held */
+static void rx_update_cache(rx_state *rx_sp, const uint64_t seedheight, const char *seedhash) {
+  randomx_cache *cache = rx_sp->rs_cache;
+  if (cache == NULL)
+    cache = rx_alloc_cache();
+  if (rx_sp->rs_height != seedheight || rx_sp->rs_cache == NULL || memcmp(seedhash, rx_sp->rs_hash, HASH_SIZE)) {
+    randomx_init_cache(cache, seedhash, HASH_SIZE);
+    rx_sp->rs_cache = cache;
+    rx_sp->rs_height = seedheight;
+    memcpy(rx_sp->rs_hash, seedhash, HASH_SIZE);
+  }
+}
+
+/* the node's dataset, for the seed; rx_dataset_mutex must be held */
+static randomx_dataset *rx_node_dataset(const unsigned int node, randomx_cache *rs_cache, const int miners, const uint64_t seedheight, const char *seedhash) {
+  rx_numa_dataset *rd = &rx_datasets[node];
+  if (rd->rd_dataset != NULL && rd->rd_height == seedheight)
+    return rd->rd_dataset;
+  if (rd->rd_next != NULL && rd->rd_next_height == seedheight && !memcmp(rd->rd_next_hash, seedhash, HASH_SIZE)) {
+    /* built in the background: VMs still hashing with the old dataset are
+     * left alone, it is kept as the spare for the seed after */
+    randomx_dataset *old = rd->rd_dataset;
+    rd->rd_dataset = rd->rd_next;
+    rd->rd_height = seedheight;
+    rd->rd_next = old;
+    rd->rd_next_height = 1;
+    return rd->rd_dataset;
+  }
+  if (rx_dataset_nomem)
+    return NULL;
+  if (rd->rd_dataset == NULL) {
+    rd->rd_dataset = rx_alloc_dataset(node);
+    if (rd->rd_dataset == NULL)
+      return NULL;
+  }
+  /* first use, or the seed changed before the background thread was done */
+  rx_initdata(rd->rd_dataset, rs_cache, miners);
+  rd->rd_height = seedheight;
+  return rd->rd_dataset;
+}
+
+/* Builds the cache, and datasets in use, for the seed off to the side, then
+ * swaps them in: nothing hashing is blocked while they are built. */
+static void rx_prepare_seed(const uint64_t seedheight, const char *seedhash, const int threads) {
+  const int toggle = (seedheight & get_seedhash_epoch_blocks()) != 0;
+  randomx_cache *cache = rx_next_cache;
+  rx_state *rx_sp;
+  unsigned int node;
+
+  if (cache == NULL)
+    cache = rx_alloc_cache();
+  randomx_init_cache(cache, seedhash, HASH_SIZE);
+
+  /* datasets only for the nodes that have one in use */
+  for (node=0; node<rx_numa_node_count(); node++) {
+    rx_numa_dataset *rd = &rx_datasets[node];
+    randomx_dataset *next;
+    CTHR_MUTEX_LOCK(rx_dataset_mutex);
+    if (rd->rd_dataset == NULL || rd->rd_height == seedheight || (rd->rd_next != NULL && rd->rd_next_height == seedheight)) {
+      CTHR_MUTEX_UNLOCK(rx_dataset_mutex);
+      continue;
+    }
+    next = rd->rd_next;
+    rd->rd_next = NULL;
+    rd->rd_next_height = 1;
+    CTHR_MUTEX_UNLOCK(rx_dataset_mutex);
+
+    if (next == NULL)
+      next = rx_alloc_dataset(node);
+    if (next == NULL) {
+      mdebug(RX_LOGCAT, "Couldn't allocate RandomX dataset for the next seed, it will be built when needed");
+      continue;
+    }
+    rx_initdata(next, cache, threads);
+
+    CTHR_MUTEX_LOCK(rx_dataset_mutex);
+    if (rd->rd_dataset != NULL && rd->rd_next == NULL) {
+      rd->rd_next = next;
+      rd->rd_next_height = seedheight;
+      memcpy(rd->rd_next_hash, seedhash, HASH_SIZE);
+      next = NULL;
+    }
+    CTHR_MUTEX_UNLOCK(rx_dataset_mutex);
+    /* mining stopped meanwhile */
+    if (next != NULL)
+      randomx_release_dataset(next);
+  }
+
+  /* the slot's previous cache is two epochs old: it is kept as the spare,
+   * in case a VM still points to it */
+  CTHR_MUTEX_LOCK(rx_mutex);
+  rx_sp = &rx_s[toggle];
+  CTHR_MUTEX_LOCK(rx_sp->rs_mutex);
+  CTHR_MUTEX_UNLOCK(rx_mutex);
+  if (rx_sp->rs_height != seedheight || rx_sp->rs_cache == NULL || memcmp(seedhash, rx_sp->rs_hash, HASH_SIZE)) {
+    randomx_cache *old = rx_sp->rs_cache;
+    rx_sp->rs_cache = cache;
+    rx_sp->rs_height = seedheight;
+    memcpy(rx_sp->rs_hash, seedhash, HASH_SIZE);
+    cache = old;
   }
-  rx_dataset_height = seedheight;
+  CTHR_MUTEX_UNLOCK(rx_sp->rs_mutex);
+  rx_next_cache = cache;
+}
+
+static void rx_lower_thread_priority(void) {
+#if defined(_WIN32)
+  SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_BELOW_NORMAL);
+#elif defined(__linux__) && defined(SYS_gettid)
+  /* per thread on Linux, and inherited by the dataset init threads */
+  if (setpriority(PRIO_PROCESS, (id_t)syscall(SYS_gettid), RX_NEXT_SEED_NICE) != 0)
+    mdebug(RX_LOGCAT, "Couldn't lower the priority of the RandomX seed thread");
+#endif
+}
+
+static CTHR_THREAD_RTYPE rx_next_seedthread(void *arg) {
+  uint64_t seedheight;
+  char seedhash[HASH_SIZE];
+  int threads;
+
+  CTHR_MUTEX_LOCK(rx_next_mutex);
+  seedheight = rx_next_height;
+  memcpy(seedhash, rx_next_hash, HASH_SIZE);
+  threads = rx_next_threads;
+  CTHR_MUTEX_UNLOCK(rx_next_mutex);
+
+  rx_lower_thread_priority();
+  rx_prepare_seed(seedheight, seedhash, threads);
+
+  CTHR_MUTEX_LOCK(rx_next_mutex);
+  rx_next_running = 0;
+  CTHR_MUTEX_UNLOCK(rx_next_mutex);
+  CTHR_THREAD_RETURN;
+}
+
+void rx_set_next_seedhash(const uint64_t seedheight, const char *seedhash, const int max_dataset_init_threads) {
+  CTHR_MUTEX_LOCK(rx_next_mutex);
+  if (rx_next_running || (rx_next_height == seedheight && !memcmp(rx_next_hash, seedhash, HASH_SIZE))) {
+    CTHR_MUTEX_UNLOCK(rx_next_mutex);
+    return;
+  }
+  /* the previous thread is done */
+  if (rx_next_thread_started)
+    CTHR_THREAD_JOIN(rx_next_thread);
+  rx_next_height = seedheight;
+  memcpy(rx_next_hash, seedhash, HASH_SIZE);
+  rx_next_threads = max_dataset_init_threads > 1 ? max_dataset_init_threads : 1;
+  rx_next_running = 1;
+  rx_next_thread_started = 1;
+  CTHR_THREAD_CREATE(rx_next_thread, rx_next_seedthread, NULL);
+  CTHR_MUTEX_UNLOCK(rx_next_mutex);
 }
 
 void rx_slow_hash(const uint64_t mainheight, const uint64_t seedheight, const char *seedhash, const void *data, size_t length,
@@ -239,7 +514,6 @@ void rx_slow_hash(const uint64_t mainheight, const uint64_t seedheight, const ch
   int toggle = (s_height & get_seedhash_epoch_blocks()) != 0;
   randomx_flags flags = enabled_flags() & ~disabled_flags();
   rx_state *rx_sp;
-  randomx_cache *cache;
 
   CTHR_MUTEX_LOCK(rx_mutex);
 
@@ -262,25 +536,12 @@ void rx_slow_hash(const uint64_t mainheight, const uint64_t seedheight, const ch
   CTHR_MUTEX_LOCK(rx_sp->rs_mutex);
   CTHR_MUTEX_UNLOCK(rx_mutex);
 
-  cache = rx_sp->rs_cache;
-  if (cache == NULL) {
-    if (!(disabled_flags() & RANDOMX_FLAG_LARGE_PAGES)) {
-      cache = randomx_alloc_cache(flags | RANDOMX_FLAG_LARGE_PAGES);
-      if (cache == NULL) {
-        mdebug(RX_LOGCAT, "Couldn't use largePages for RandomX cache");
-      }
-    }
-    if (cache == NULL) {
-      cache = randomx_alloc_cache(flags);
-      if (cache == NULL)
-        local_abort("Couldn't allocate RandomX cache");
-    }
-  }
-  if (rx_sp->rs_height != seedheight || rx_sp->rs_cache == NULL || memcmp(seedhash, rx_sp->rs_hash, HASH_SIZE)) {
-    randomx_init_cache(cache, seedhash, HASH_SIZE);
-    rx_sp->rs_cache = cache;
-    rx_sp->rs_height = seedheight;
-    memcpy(rx_sp->rs_hash, seedhash, HASH_SIZE);
+  rx_update_cache(rx_sp, seedheight, seedhash);
+  if (rx_vm != NULL && rx_vm_dataset != NULL && !miners) {
+    /* a mining VM can't be moved back to the cache, and its dataset may be for another seed */
+    randomx_destroy_vm(rx_vm);
+    rx_vm = NULL;
+    rx_vm_dataset = NULL;
   }
   if (rx_vm == NULL) {
     if ((flags & RANDOMX_FLAG_JIT) && !miners) {
@@ -290,22 +551,10 @@ void rx_slow_hash(const uint64_t mainheight, const uint64_t seedheight, const ch
       miners = 0;
     }
     if (miners) {
+      rx_vm_node = rx_current_numa_node();
       CTHR_MUTEX_LOCK(rx_dataset_mutex);
-      if (!rx_dataset_nomem) {
-        if (rx_dataset == NULL) {
-          if (!(disabled_flags() & RANDOMX_FLAG_LARGE_PAGES)) {
-            rx_dataset = randomx_alloc_dataset(RANDOMX_FLAG_LARGE_PAGES);
-            if (rx_dataset == NULL) {
-              mdebug(RX_LOGCAT, "Couldn't use largePages for RandomX dataset");
-            }
-          }
-          if (rx_dataset == NULL)
-            rx_dataset = randomx_alloc_dataset(RANDOMX_FLAG_DEFAULT);
-          if (rx_dataset != NULL)
-            rx_initdata(rx_sp->rs_cache, miners, seedheight);
-        }
-      }
-      if (rx_dataset != NULL)
+      rx_vm_dataset = rx_node_dataset(rx_vm_node, rx_sp->rs_cache, miners, seedheight, seedhash);
+      if (rx_vm_dataset != NULL)
         flags |= RANDOMX_FLAG_FULL_MEM;
       else {
         miners = 0;
@@ -317,26 +566,26 @@ void rx_slow_hash(const uint64_t mainheight, const uint64_t seedheight, const ch
       CTHR_MUTEX_UNLOCK(rx_dataset_mutex);
     }
     if (!(disabled_flags() & RANDOMX_FLAG_LARGE_PAGES)) {
-      rx_vm = randomx_create_vm(flags | RANDOMX_FLAG_LARGE_PAGES, rx_sp->rs_cache, rx_dataset);
+      rx_vm = randomx_create_vm(flags | RANDOMX_FLAG_LARGE_PAGES, rx_sp->rs_cache, rx_vm_dataset);
       if(rx_vm == NULL) { //large pages failed
         mdebug(RX_LOGCAT, "Couldn't use largePages for RandomX VM");
       }
     }
     if (rx_vm == NULL)
-      rx_vm = randomx_create_vm(flags, rx_sp->rs_cache, rx_dataset);
+      rx_vm = randomx_create_vm(flags, rx_sp->rs_cache, rx_vm_dataset);
     if(rx_vm == NULL) {//fallback if everything fails
       flags = RANDOMX_FLAG_DEFAULT | (miners ? RANDOMX_FLAG_FULL_MEM : 0);
-      rx_vm = randomx_create_vm(flags, rx_sp->rs_cache, rx_dataset);
+      rx_vm = randomx_create_vm(flags, rx_sp->rs_cache, rx_vm_dataset);
     }
     if (rx_vm == NULL)
       local_abort("Couldn't allocate RandomX VM");
-  } else if (miners) {
+  } else if (miners && rx_vm_dataset != NULL) {
+    randomx_dataset *dataset;
     CTHR_MUTEX_LOCK(rx_dataset_mutex);
-    if (rx_dataset != NULL && rx_dataset_height != seedheight)
-      rx_initdata(cache, miners, seedheight);
-    else if (rx_dataset == NULL) {
-      /* this is a no-op if the cache hasn't changed */
-      randomx_vm_set_cache(rx_vm, rx_sp->rs_cache);
+    dataset = rx_node_dataset(rx_vm_node, rx_sp->rs_cache, miners, seedheight, seedhash);
+    if (dataset != NULL && dataset != rx_vm_dataset) {
+      randomx_vm_set_dataset(rx_vm, dataset);
+      rx_vm_dataset = dataset;
     }
     CTHR_MUTEX_UNLOCK(rx_dataset_mutex);
   } else {
@@ -359,15 +608,23 @@ void rx_slow_hash_free_state(void) {
   if (rx_vm != NULL) {
     randomx_destroy_vm(rx_vm);
     rx_vm = NULL;
+    rx_vm_dataset = NULL;
   }
 }
 
 void rx_stop_mining(void) {
+  unsigned int node;
   CTHR_MUTEX_LOCK(rx_dataset_mutex);
-  if (rx_dataset != NULL) {
-    randomx_dataset *rd = rx_dataset;
-    rx_dataset = NULL;
-    randomx_release_dataset(rd);
+  for (node=0; node<RX_MAX_NUMA_NODES; node++) {
+    rx_numa_dataset *rd = &rx_datasets[node];
+    if (rd->rd_dataset != NULL) {
+      randomx_release_dataset(rd->rd_dataset);
+      rd->rd_dataset = NULL;
+    }
+    if (rd->rd_next != NULL) {
+      randomx_release_dataset(rd->rd_next);
+      rd->rd_next = NULL;
+    }
   }
   rx_dataset_nomem = 0;
   CTHR_MUTEX_UNLOCK(rx_dataset_mutex);
@@ -95,6 +95,13 @@ static inline int use_v4_jit(void)
 #endif
 }
 
+/*
+ * Height of the CryptonightR program compiled into this thread's JIT buffer, if hp_jitfunc_height_valid, so hashing
+ * again at the same height (mining, alt blocks, re-checking a block) skips the compile and its two mprotect calls
+ */
+static THREADV uint64_t hp_jitfunc_height = 0;
+static THREADV int hp_jitfunc_height_valid = 0;
+
 #if defined(__x86_64__) || defined(__aarch64__)
 static inline int force_software_aes(void)
 {
@@ -324,12 +331,16 @@ static inline int force_software_aes(void)
   { \
     for (int i = 0; i < 4; ++i) \
       V4_REG_LOAD(r + i, (uint8_t*)(state.hs.w + 12) + sizeof(v4_reg) * i); \
-    v4_random_math_init(code, height); \
-    if (jit) \
+    if (!jit) \
+      v4_random_math_init(code, height); \
+    else if (!hp_jitfunc_height_valid || hp_jitfunc_height != height) \
     { \
+      v4_random_math_init(code, height); \
       int ret = v4_generate_JIT_code(code, hp_jitfunc, 4096); \
       if (ret < 0) \
         local_abort("Error generating CryptonightR code"); \
+      hp_jitfunc_height = height; \
+      hp_jitfunc_height_valid = 1; \
     } \
   } while (0)
 
@@ -801,6 +812,7 @@ void cn_slow_hash_allocate_state(void)
         hp_jitfunc_memory = malloc(4096 + 4095);
     }
     hp_jitfunc = (v4_random_math_JIT_func)((size_t)(hp_jitfunc_memory + 4095) & ~4095);
+    hp_jitfunc_height_valid = 0;
 }
 
 /**
@@ -839,6 +851,7 @@ void cn_slow_hash_free_state(void)
     hp_jitfunc = NULL;
     hp_jitfunc_memory = NULL;
     hp_jitfunc_allocated = 0;
+    hp_jitfunc_height_valid = 0;
 }
 
 /**
@@ -41,6 +41,18 @@ namespace crypto {
         return monero_crypto_generate_key_derivation(out.data, tx_pub.data, view_sec.data) == 0;
       }
 
+      inline
+      bool generate_key_derivations(const public_key *tx_pubs, std::size_t num_keys, const secret_key &view_sec, key_derivation *out, bool *valid)
+      {
+        bool all_valid = true;
+        for (std::size_t i = 0; i < num_keys; ++i)
+        {
+          valid[i] = generate_key_derivation(tx_pubs[i], view_sec, out[i]);
+          all_valid = all_valid && valid[i];
+        }
+        return all_valid;
+      }
+
       inline
       bool derive_subaddress_public_key(const public_key &output_pub, const key_derivation &d, std::size_t index, public_key &out)
       {
@@ -48,9 +60,23 @@ namespace crypto {
         derivation_to_scalar(d, index, scalar);
         return monero_crypto_generate_subaddress_public_key(out.data, output_pub.data, scalar.data) == 0;
       }
+
+      inline
+      bool derive_subaddress_public_keys(const public_key *output_pubs, const key_derivation *ds, const std::size_t *indices, std::size_t num_keys, public_key *out, bool *valid)
+      {
+        bool all_valid = true;
+        for (std::size_t i = 0; i < num_keys; ++i)
+        {
+          valid[i] = derive_subaddress_public_key(output_pubs[i], ds[i], indices[i], out[i]);
+          all_valid = all_valid && valid[i];
+        }
+        return all_valid;
+      }
 #else
     using ::crypto::generate_key_derivation;
+    using ::crypto::generate_key_derivations;
     using ::crypto::derive_subaddress_public_key;
+    using ::crypto::derive_subaddress_public_keys;
 #endif
   }
 }
@@ -53,6 +53,8 @@ namespace cryptonote
       return 1024 * 1024 * 2; // 2 MB
     case cryptonote::NOTIFY_RESPONSE_GET_OBJECTS::ID:
       return 1024 * 1024 * 128; // 128 MB (max packet is a bit less than 100 MB though)
+    case cryptonote::NOTIFY_RESPONSE_GET_OBJECTS_COMPRESSED::ID:
+      return 1024 * 1024 * 128; // 128 MB, compressed data is smaller (the payload is limited when decompressing)
     case cryptonote::NOTIFY_REQUEST_CHAIN::ID:
       return 512 * 1024; // 512 kB
     case cryptonote::NOTIFY_RESPONSE_CHAIN_ENTRY::ID:
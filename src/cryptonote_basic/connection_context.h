@@ -36,6 +36,7 @@
 #include "net/net_utils_base.h"
 #include "copyable_atomic.h"
 #include "crypto/hash.h"
+#include "sync_span_estimator.h"
 
 namespace cryptonote
 {
@@ -77,6 +78,8 @@ namespace cryptonote
     int m_expect_response;
     uint64_t m_expect_height;
     size_t m_num_requested;
+    sync_span_estimator m_sync_span_estimator; //!< download time of this peer's spans, to size its requests
+    uint64_t m_sync_span_blocks{0}; //!< blocks in the outstanding span request
     epee::copyable_atomic m_new_stripe_notification{0};
     epee::copyable_atomic m_idle_peer_notification{0};
   };
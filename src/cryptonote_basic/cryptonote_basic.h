@@ -193,6 +193,7 @@ namespace cryptonote
     // hash cash
     mutable std::atomic<bool> hash_valid;
     mutable std::atomic<bool> prunable_hash_valid;
+    mutable std::atomic<bool> prefix_hash_valid;
     mutable std::atomic<bool> blob_size_valid;
 
   public:
@@ -202,6 +203,7 @@ namespace cryptonote
     // hash cash
     mutable crypto::hash hash;
     mutable crypto::hash prunable_hash;
+    mutable crypto::hash prefix_hash; // only set when parsed from a blob
     mutable size_t blob_size;
 
     bool pruned;
@@ -219,10 +221,13 @@ namespace cryptonote
     void set_hash_valid(bool v) const { hash_valid.store(v,std::memory_order_release); }
     bool is_prunable_hash_valid() const { return prunable_hash_valid.load(std::memory_order_acquire); }
     void set_prunable_hash_valid(bool v) const { prunable_hash_valid.store(v,std::memory_order_release); }
+    bool is_prefix_hash_valid() const { return prefix_hash_valid.load(std::memory_order_acquire); }
+    void set_prefix_hash_valid(bool v) const { prefix_hash_valid.store(v,std::memory_order_release); }
     bool is_blob_size_valid() const { return blob_size_valid.load(std::memory_order_acquire); }
     void set_blob_size_valid(bool v) const { blob_size_valid.store(v,std::memory_order_release); }
     void set_hash(const crypto::hash &h) const { hash = h; set_hash_valid(true); }
     void set_prunable_hash(const crypto::hash &h) const { prunable_hash = h; set_prunable_hash_valid(true); }
+    void set_prefix_hash(const crypto::hash &h) const { prefix_hash = h; set_prefix_hash_valid(true); }
     void set_blob_size(size_t sz) const { blob_size = sz; set_blob_size_valid(true); }
 
     BEGIN_SERIALIZE_OBJECT()
@@ -230,6 +235,7 @@ namespace cryptonote
       {
         set_hash_valid(false);
         set_prunable_hash_valid(false);
+        set_prefix_hash_valid(false);
         set_blob_size_valid(false);
       }
 
@@ -305,10 +311,17 @@ namespace cryptonote
     template<bool W, template <bool> class Archive>
     bool serialize_base(Archive<W> &ar)
     {
+      const auto start_pos = ar.getpos();
+
       FIELDS(*static_cast<transaction_prefix *>(this))
 
+      if (std::is_same<Archive<W>, binary_archive<W>>())
+        prefix_size = ar.getpos() - start_pos;
+
       if (version == 1)
       {
+        if (std::is_same<Archive<W>, binary_archive<W>>())
+          unprunable_size = ar.getpos() - start_pos;
       }
       else
       {
@@ -319,6 +332,9 @@ namespace cryptonote
           bool r = rct_signatures.serialize_rctsig_base(ar, vin.size(), vout.size());
           if (!r || !ar.good()) return false;
           ar.end_object();
+
+          if (std::is_same<Archive<W>, binary_archive<W>>())
+            unprunable_size = ar.getpos() - start_pos;
         }
       }
       if (!typename Archive<W>::is_saving())
@@ -334,6 +350,7 @@ namespace cryptonote
     transaction_prefix(t),
     hash_valid(false),
     prunable_hash_valid(false),
+    prefix_hash_valid(false),
     blob_size_valid(false),
     signatures(t.signatures),
     rct_signatures(t.rct_signatures),
@@ -356,6 +373,11 @@ namespace cryptonote
       prunable_hash = t.prunable_hash;
       set_prunable_hash_valid(true);
     }
+    if (t.is_prefix_hash_valid())
+    {
+      prefix_hash = t.prefix_hash;
+      set_prefix_hash_valid(true);
+    }
   }
 
   inline transaction &transaction::operator=(const transaction &t)
@@ -364,6 +386,7 @@ namespace cryptonote
 
     set_hash_valid(false);
     set_prunable_hash_valid(false);
+    set_prefix_hash_valid(false);
     set_blob_size_valid(false);
     signatures = t.signatures;
     rct_signatures = t.rct_signatures;
@@ -377,6 +400,11 @@ namespace cryptonote
       prunable_hash = t.prunable_hash;
       set_prunable_hash_valid(true);
     }
+    if (t.is_prefix_hash_valid())
+    {
+      prefix_hash = t.prefix_hash;
+      set_prefix_hash_valid(true);
+    }
     if (t.is_blob_size_valid())
     {
       blob_size = t.blob_size;
@@ -407,6 +435,7 @@ namespace cryptonote
     rct_signatures.type = rct::RCTTypeNull;
     set_hash_valid(false);
     set_prunable_hash_valid(false);
+    set_prefix_hash_valid(false);
     set_blob_size_valid(false);
     pruned = false;
     unprunable_size = 0;
@@ -418,6 +447,7 @@ namespace cryptonote
   {
     set_hash_valid(false);
     set_prunable_hash_valid(false);
+    set_prefix_hash_valid(false);
     set_blob_size_valid(false);
   }
 
@@ -76,6 +76,8 @@ static std::atomic<unsigned int> default_decimal_point(CRYPTONOTE_DISPLAY_DECIMA
 
 static std::atomic<uint64_t> tx_hashes_calculated_count(0);
 static std::atomic<uint64_t> tx_hashes_cached_count(0);
+static std::atomic<uint64_t> tx_prefix_hashes_calculated_count(0);
+static std::atomic<uint64_t> tx_prefix_hashes_cached_count(0);
 static std::atomic<uint64_t> block_hashes_calculated_count(0);
 static std::atomic<uint64_t> block_hashes_cached_count(0);
 
@@ -138,6 +140,64 @@ namespace cryptonote
     get_transaction_prefix_hash(tx, h, hwdev);
     return h;
   }
+  //---------------------------------------------------------------
+  void get_transaction_prefix_hash(const transaction& tx, crypto::hash& h)
+  {
+    if (tx.is_prefix_hash_valid())
+    {
+#ifdef ENABLE_HASH_CASH_INTEGRITY_CHECK
+      get_transaction_prefix_hash(static_cast<const transaction_prefix&>(tx), h);
+      CHECK_AND_ASSERT_THROW_MES(tx.prefix_hash == h, "tx prefix hash cash integrity failure");
+#endif
+      h = tx.prefix_hash;
+      ++tx_prefix_hashes_cached_count;
+      return;
+    }
+    ++tx_prefix_hashes_calculated_count;
+    get_transaction_prefix_hash(static_cast<const transaction_prefix&>(tx), h);
+  }
+  //---------------------------------------------------------------
+  crypto::hash get_transaction_prefix_hash(const transaction& tx)
+  {
+    crypto::hash h = null_hash;
+    get_transaction_prefix_hash(tx, h);
+    return h;
+  }
+  //---------------------------------------------------------------
+  static void set_transaction_hashes_from_blob(const transaction& tx, const blobdata_ref& tx_blob)
+  {
+    // binary serialization is canonical (varints are checked on read), so the parsed blob hashes
+    // the same as a re-serialization of the tx would, without paying for one
+    const unsigned int prefix_size = tx.prefix_size;
+    const unsigned int unprunable_size = tx.unprunable_size;
+    if ((tx.version > 1 && tx.vin.empty()) || prefix_size > unprunable_size || unprunable_size > tx_blob.size())
+      return;
+
+    crypto::hash hashes[3];
+    get_blob_hash(blobdata_ref(tx_blob.data(), prefix_size), hashes[0]);
+    tx.set_prefix_hash(hashes[0]);
+    ++tx_prefix_hashes_calculated_count;
+
+    if (tx.version == 1)
+    {
+      tx.set_hash(get_blob_hash(tx_blob));
+    }
+    else
+    {
+      get_blob_hash(blobdata_ref(tx_blob.data() + prefix_size, unprunable_size - prefix_size), hashes[1]);
+      if (tx.rct_signatures.type == rct::RCTTypeNull)
+      {
+        hashes[2] = crypto::null_hash;
+      }
+      else
+      {
+        get_blob_hash(blobdata_ref(tx_blob.data() + unprunable_size, tx_blob.size() - unprunable_size), hashes[2]);
+        tx.set_prunable_hash(hashes[2]);
+      }
+      tx.set_hash(cn_fast_hash(hashes, sizeof(hashes)));
+    }
+    ++tx_hashes_calculated_count;
+  }
   
   bool expand_transaction_1(transaction &tx, bool base_only)
   {
@@ -200,6 +260,7 @@ namespace cryptonote
     CHECK_AND_ASSERT_MES(r, false, "Failed to parse transaction from blob");
     CHECK_AND_ASSERT_MES(expand_transaction_1(tx, false), false, "Failed to expand transaction data");
     tx.invalidate_hashes();
+    set_transaction_hashes_from_blob(tx, tx_blob);
     tx.set_blob_size(tx_blob.size());
     return true;
   }
@@ -214,6 +275,42 @@ namespace cryptonote
     return true;
   }
   //---------------------------------------------------------------
+  bool parse_tx_base_lazily_from_blob(const blobdata_ref& tx_blob, transaction& tx)
+  {
+    if (is_v1_tx(tx_blob))
+      return parse_and_validate_tx_from_blob(tx_blob, tx);
+
+    binary_archive<false> ba{epee::strspan<std::uint8_t>(tx_blob)};
+    bool r = tx.serialize_base(ba);
+    CHECK_AND_ASSERT_MES(r && ba.good(), false, "Failed to parse transaction from blob");
+    CHECK_AND_ASSERT_MES(expand_transaction_1(tx, true), false, "Failed to expand transaction data");
+    tx.invalidate_hashes();
+    // the prunable part is still in the blob, past unprunable_size, and the hashes cover it as it is there
+    set_transaction_hashes_from_blob(tx, tx_blob);
+    tx.set_blob_size(tx_blob.size());
+    return true;
+  }
+  //---------------------------------------------------------------
+  bool expand_tx_prunable_from_blob(const blobdata_ref& tx_blob, transaction& tx)
+  {
+    if (!tx.pruned)
+      return true;
+    const size_t unprunable_size = tx.unprunable_size;
+    CHECK_AND_ASSERT_MES(tx.version > 1 && unprunable_size <= tx_blob.size(), false, "Transaction was not parsed from this blob");
+
+    binary_archive<false> ba{epee::strspan<std::uint8_t>(tx_blob.substr(unprunable_size))};
+    if (!tx.vin.empty() && tx.rct_signatures.type != rct::RCTTypeNull)
+    {
+      const size_t mixin = tx.vin[0].type() == typeid(txin_to_key) ? boost::get<txin_to_key>(tx.vin[0]).key_offsets.size() - 1 : 0;
+      bool r = tx.rct_signatures.p.serialize_rctsig_prunable(ba, tx.rct_signatures.type, tx.vin.size(), tx.vout.size(), mixin);
+      CHECK_AND_ASSERT_MES(r, false, "Failed to parse transaction prunable data from blob");
+    }
+    CHECK_AND_ASSERT_MES(::serialization::check_stream_state(ba), false, "Failed to parse transaction prunable data from blob");
+    tx.pruned = false;
+    CHECK_AND_ASSERT_MES(expand_transaction_1(tx, false), false, "Failed to expand transaction data");
+    return true;
+  }
+  //---------------------------------------------------------------
   bool parse_and_validate_tx_prefix_from_blob(const blobdata_ref& tx_blob, transaction_prefix& tx)
   {
     binary_archive<false> ba{epee::strspan<std::uint8_t>(tx_blob)};
@@ -229,6 +326,8 @@ namespace cryptonote
     CHECK_AND_ASSERT_MES(r, false, "Failed to parse transaction from blob");
     CHECK_AND_ASSERT_MES(expand_transaction_1(tx, false), false, "Failed to expand transaction data");
     tx.invalidate_hashes();
+    set_transaction_hashes_from_blob(tx, tx_blob);
+    tx.set_blob_size(tx_blob.size());
     //TODO: validate tx
 
     return get_transaction_hash(tx, tx_hash);
@@ -889,26 +988,46 @@ namespace cryptonote
     return false;
   }
   //---------------------------------------------------------------
-  boost::optional<subaddress_receive_info> is_out_to_acc_precomp(const std::unordered_map<crypto::public_key, subaddress_index>& subaddresses, const crypto::public_key& out_key, const crypto::key_derivation& derivation, const std::vector<crypto::key_derivation>& additional_derivations, size_t output_index, hw::device &hwdev)
+  template <typename FindT>
+  static boost::optional<subaddress_receive_info> is_out_to_acc_precomp_impl(const FindT& find_subaddress, const crypto::public_key& out_key, const crypto::key_derivation& derivation, const std::vector<crypto::key_derivation>& additional_derivations, size_t output_index, hw::device &hwdev)
   {
     // try the shared tx pubkey
     crypto::public_key subaddress_spendkey;
     hwdev.derive_subaddress_public_key(out_key, derivation, output_index, subaddress_spendkey);
-    auto found = subaddresses.find(subaddress_spendkey);
-    if (found != subaddresses.end())
-      return subaddress_receive_info{ found->second, derivation };
+    const subaddress_index* found = find_subaddress(subaddress_spendkey);
+    if (found)
+      return subaddress_receive_info{ *found, derivation };
     // try additional tx pubkeys if available
     if (!additional_derivations.empty())
     {
       CHECK_AND_ASSERT_MES(output_index < additional_derivations.size(), boost::none, "wrong number of additional derivations");
       hwdev.derive_subaddress_public_key(out_key, additional_derivations[output_index], output_index, subaddress_spendkey);
-      found = subaddresses.find(subaddress_spendkey);
-      if (found != subaddresses.end())
-        return subaddress_receive_info{ found->second, additional_derivations[output_index] };
+      found = find_subaddress(subaddress_spendkey);
+      if (found)
+        return subaddress_receive_info{ *found, additional_derivations[output_index] };
     }
     return boost::none;
   }
   //---------------------------------------------------------------
+  boost::optional<subaddress_receive_info> is_out_to_acc_precomp(const std::unordered_map<crypto::public_key, subaddress_index>& subaddresses, const crypto::public_key& out_key, const crypto::key_derivation& derivation, const std::vector<crypto::key_derivation>& additional_derivations, size_t output_index, hw::device &hwdev)
+  {
+    const auto find_subaddress = [&subaddresses](const crypto::public_key& spendkey) -> const subaddress_index*
+    {
+      const auto found = subaddresses.find(spendkey);
+      return found != subaddresses.end() ? &found->second : nullptr;
+    };
+    return is_out_to_acc_precomp_impl(find_subaddress, out_key, derivation, additional_derivations, output_index, hwdev);
+  }
+  //---------------------------------------------------------------
+  boost::optional<subaddress_receive_info> is_out_to_acc_precomp(const subaddress_table& subaddresses, const crypto::public_key& out_key, const crypto::key_derivation& derivation, const std::vector<crypto::key_derivation>& additional_derivations, size_t output_index, hw::device &hwdev)
+  {
+    const auto find_subaddress = [&subaddresses](const crypto::public_key& spendkey) -> const subaddress_index*
+    {
+      return subaddresses.find(spendkey);
+    };
+    return is_out_to_acc_precomp_impl(find_subaddress, out_key, derivation, additional_derivations, output_index, hwdev);
+  }
+  //---------------------------------------------------------------
   bool lookup_acc_outs(const account_keys& acc, const transaction& tx, std::vector<size_t>& outs, uint64_t& money_transfered)
   {
     crypto::public_key tx_pub_key = get_tx_pub_key_from_extra(tx);
@@ -1389,10 +1508,12 @@ namespace cryptonote
     return std::binary_search(begin, end, amount);
   }
   //---------------------------------------------------------------
-  void get_hash_stats(uint64_t &tx_hashes_calculated, uint64_t &tx_hashes_cached, uint64_t &block_hashes_calculated, uint64_t & block_hashes_cached)
+  void get_hash_stats(uint64_t &tx_hashes_calculated, uint64_t &tx_hashes_cached, uint64_t &tx_prefix_hashes_calculated, uint64_t &tx_prefix_hashes_cached, uint64_t &block_hashes_calculated, uint64_t & block_hashes_cached)
   {
     tx_hashes_calculated = tx_hashes_calculated_count;
     tx_hashes_cached = tx_hashes_cached_count;
+    tx_prefix_hashes_calculated = tx_prefix_hashes_calculated_count;
+    tx_prefix_hashes_cached = tx_prefix_hashes_cached_count;
     block_hashes_calculated = block_hashes_calculated_count;
     block_hashes_cached = block_hashes_cached_count;
   }
@@ -0,0 +1,117 @@
+// Copyright (c) 2021, The Monero Project
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of
+//    conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list
+//    of conditions and the following disclaimer in the documentation and/or other
+//    materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be
+//    used to endorse or promote products derived from this software without specific
+//    prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+// THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <cstring>
+#include "subaddress_table.h"
+
+namespace cryptonote
+{
+  //---------------------------------------------------------------
+  subaddress_table::subaddress_table()
+  {
+  }
+  //---------------------------------------------------------------
+  void subaddress_table::clear()
+  {
+    m_fingerprints.clear();
+    m_slot_entries.clear();
+    m_entries.clear();
+  }
+  //---------------------------------------------------------------
+  uint64_t subaddress_table::fingerprint(const crypto::public_key &spend_pubkey)
+  {
+    uint64_t fp;
+    memcpy(&fp, spend_pubkey.data, sizeof(fp));
+    return fp == 0 ? 1 : fp;
+  }
+  //---------------------------------------------------------------
+  void subaddress_table::reserve(size_t num_entries)
+  {
+    size_t num_slots = 8;
+    while (num_slots < 2 * num_entries)
+      num_slots *= 2;
+    if (num_slots <= m_fingerprints.size())
+      return;
+
+    m_fingerprints.assign(num_slots, 0);
+    m_slot_entries.assign(num_slots, 0);
+    for (size_t entry = 0; entry < m_entries.size(); ++entry)
+      place(fingerprint(m_entries[entry].first), entry);
+  }
+  //---------------------------------------------------------------
+  void subaddress_table::place(uint64_t fp, uint32_t entry)
+  {
+    const size_t slot_mask = m_fingerprints.size() - 1;
+    size_t slot = fp & slot_mask;
+    while (m_fingerprints[slot] != 0)
+      slot = (slot + 1) & slot_mask;
+    m_fingerprints[slot] = fp;
+    m_slot_entries[slot] = entry;
+  }
+  //---------------------------------------------------------------
+  void subaddress_table::insert(const crypto::public_key &spend_pubkey, const subaddress_index &index)
+  {
+    const entry_t *existing = find_entry(spend_pubkey);
+    if (existing)
+    {
+      m_entries[existing - m_entries.data()].second = index;
+      return;
+    }
+
+    m_entries.emplace_back(spend_pubkey, index);
+    if (m_fingerprints.size() < 2 * m_entries.size())
+      reserve(m_entries.size());  // places every entry, including the new one
+    else
+      place(fingerprint(spend_pubkey), m_entries.size() - 1);
+  }
+  //---------------------------------------------------------------
+  const subaddress_index *subaddress_table::find(const crypto::public_key &spend_pubkey) const
+  {
+    const entry_t *entry = find_entry(spend_pubkey);
+    return entry ? &entry->second : nullptr;
+  }
+  //---------------------------------------------------------------
+  const subaddress_table::entry_t *subaddress_table::find_entry(const crypto::public_key &spend_pubkey) const
+  {
+    if (m_fingerprints.empty())
+      return nullptr;
+
+    // slots fill in probe order and are never freed, so the first empty slot ends the probe
+    const uint64_t fp = fingerprint(spend_pubkey);
+    const size_t slot_mask = m_fingerprints.size() - 1;
+    for (size_t slot = fp & slot_mask; m_fingerprints[slot] != 0; slot = (slot + 1) & slot_mask)
+    {
+      if (m_fingerprints[slot] != fp)
+        continue;
+      const entry_t &entry = m_entries[m_slot_entries[slot]];
+      if (entry.first == spend_pubkey)
+        return &entry;
+    }
+    return nullptr;
+  }
+}
@@ -0,0 +1,86 @@
+// Copyright (c) 2021, The Monero Project
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of
+//    conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list
+//    of conditions and the following disclaimer in the documentation and/or other
+//    materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be
+//    used to endorse or promote products derived from this software without specific
+//    prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+// THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "crypto/crypto.h"
+#include "serialization/serialization.h"
+#include "subaddress_index.h"
+
+namespace cryptonote
+{
+  /**
+   * Open-addressing map from subaddress spend pubkeys to subaddress indices, for view scanning
+   * - slots hold a 64-bit fingerprint of the key (its first 8 bytes, which are uniformly distributed)
+   *   and probe linearly; load is kept at most 1/2, so a probe is usually one or two slots long
+   * - a lookup only touches the stored key on a fingerprint match, so the usual miss (an output to
+   *   someone else) reads one contiguous run of 8-byte slots, where std::unordered_map chases a
+   *   bucket and then its nodes
+   * - entries can be added or updated but not removed; clear() and re-insert to drop any
+   */
+  class subaddress_table
+  {
+  public:
+    subaddress_table();
+
+    void clear();
+    size_t size() const { return m_entries.size(); }
+
+    /// add a key, or update the index of a key already present
+    void insert(const crypto::public_key &spend_pubkey, const subaddress_index &index);
+
+    /// replace the contents with a map's (e.g. wallet2::m_subaddresses)
+    template <typename MapT>
+    void assign(const MapT &subaddresses)
+    {
+      clear();
+      reserve(subaddresses.size());
+      for (const auto &entry: subaddresses)
+        insert(entry.first, entry.second);
+    }
+
+    /// @return the key's index, or null if the key is not in the table
+    const subaddress_index *find(const crypto::public_key &spend_pubkey) const;
+
+  private:
+    typedef std::pair<crypto::public_key, subaddress_index> entry_t;
+
+    static uint64_t fingerprint(const crypto::public_key &spend_pubkey);
+    void reserve(size_t num_entries);
+    void place(uint64_t fp, uint32_t entry);
+    const entry_t *find_entry(const crypto::public_key &spend_pubkey) const;
+
+    std::vector<uint64_t> m_fingerprints;  // 0 = empty slot; the size is a power of 2
+    std::vector<uint32_t> m_slot_entries;  // entry of each slot
+    std::vector<entry_t> m_entries;
+  };
+}
@@ -0,0 +1,116 @@
+// Copyright (c) 2021, The Monero Project
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of
+//    conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list
+//    of conditions and the following disclaimer in the documentation and/or other
+//    materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be
+//    used to endorse or promote products derived from this software without specific
+//    prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+// THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <algorithm>
+#include <cmath>
+
+#include "sync_span_estimator.h"
+
+// weight left to the previous spans when a span is added
+#define SYNC_SPAN_ESTIMATOR_DECAY 0.8
+// relative spread of span sizes under which latency and transfer time are not told apart
+#define SYNC_SPAN_ESTIMATOR_MIN_SPREAD 0.05
+
+namespace cryptonote
+{
+
+//------------------------------------------------------------------
+sync_span_estimator::sync_span_estimator():
+  m_weight(0.0),
+  m_blocks(0.0),
+  m_seconds(0.0),
+  m_blocks2(0.0),
+  m_blocks_seconds(0.0)
+{
+}
+//------------------------------------------------------------------
+void sync_span_estimator::add_span(uint64_t blocks, double seconds)
+{
+  if (blocks == 0 || !(seconds >= 0.0))
+    return;
+
+  const double n = blocks;
+  m_weight = m_weight * SYNC_SPAN_ESTIMATOR_DECAY + 1.0;
+  m_blocks = m_blocks * SYNC_SPAN_ESTIMATOR_DECAY + n;
+  m_seconds = m_seconds * SYNC_SPAN_ESTIMATOR_DECAY + seconds;
+  m_blocks2 = m_blocks2 * SYNC_SPAN_ESTIMATOR_DECAY + n * n;
+  m_blocks_seconds = m_blocks_seconds * SYNC_SPAN_ESTIMATOR_DECAY + n * seconds;
+}
+//------------------------------------------------------------------
+double sync_span_estimator::get_seconds_per_block() const
+{
+  if (!has_estimate())
+    return 0.0;
+
+  const double mean_blocks = m_blocks / m_weight;
+  const double variance = m_blocks2 / m_weight - mean_blocks * mean_blocks;
+  const double mean_seconds = m_seconds / m_weight;
+  if (variance > 0.0 && std::sqrt(variance) >= SYNC_SPAN_ESTIMATOR_MIN_SPREAD * mean_blocks)
+  {
+    const double slope = (m_blocks_seconds / m_weight - mean_blocks * mean_seconds) / variance;
+    const double intercept = mean_seconds - slope * mean_blocks;
+    // a fit with no latency or no transfer time is noise, fall back to the plain ratio
+    if (slope > 0.0 && intercept >= 0.0)
+      return slope;
+  }
+  return mean_seconds / mean_blocks;
+}
+//------------------------------------------------------------------
+double sync_span_estimator::get_rtt() const
+{
+  if (!has_estimate())
+    return 0.0;
+  return std::max(0.0, (m_seconds - get_seconds_per_block() * m_blocks) / m_weight);
+}
+//------------------------------------------------------------------
+double sync_span_estimator::get_expected_seconds(uint64_t blocks) const
+{
+  if (!has_estimate())
+    return 0.0;
+  return get_rtt() + blocks * get_seconds_per_block();
+}
+//------------------------------------------------------------------
+size_t sync_span_estimator::get_span_blocks(double target_seconds, size_t min_blocks, size_t max_blocks, size_t default_blocks) const
+{
+  min_blocks = std::max<size_t>(min_blocks, 1);
+  max_blocks = std::max(max_blocks, min_blocks);
+  if (!has_estimate())
+    return std::min(std::max(default_blocks, min_blocks), max_blocks);
+
+  const double seconds_per_block = get_seconds_per_block();
+  if (seconds_per_block <= 0.0)
+    return max_blocks;
+  const double blocks = (target_seconds - get_rtt()) / seconds_per_block;
+  if (blocks <= min_blocks)
+    return min_blocks;
+  if (blocks >= max_blocks)
+    return max_blocks;
+  return static_cast<size_t>(blocks + 0.5);
+}
+
+}
@@ -0,0 +1,93 @@
+// Copyright (c) 2021, The Monero Project
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of
+//    conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list
+//    of conditions and the following disclaimer in the documentation and/or other
+//    materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be
+//    used to endorse or promote products derived from this software without specific
+//    prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+// THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace cryptonote
+{
+  /**
+   * @brief estimates how long a peer takes to send a span of blocks
+   *
+   * Models a span's download time as rtt + blocks * seconds_per_block,
+   * fitted by least squares over the spans the peer sent, with older spans
+   * weighing exponentially less so the estimate follows changing links.
+   * While all spans had about the same size, the fit can not tell latency
+   * from transfer time, and the whole time is put down to the blocks, which
+   * errs towards smaller spans.  Not thread safe.
+   */
+  class sync_span_estimator
+  {
+  public:
+    sync_span_estimator();
+
+    /**
+     * @brief feeds back a span received from the peer
+     *
+     * @param blocks the number of blocks in the span
+     * @param seconds the time from the request to the response
+     */
+    void add_span(uint64_t blocks, double seconds);
+
+    //! true once a span was measured
+    bool has_estimate() const { return m_weight > 0.0; }
+
+    //! estimated round trip (seconds)
+    double get_rtt() const;
+
+    //! estimated transfer time per block (seconds)
+    double get_seconds_per_block() const;
+
+    /**
+     * @brief gets the expected time to download a span from the peer
+     *
+     * @return the time in seconds, 0 if there is no estimate yet
+     */
+    double get_expected_seconds(uint64_t blocks) const;
+
+    /**
+     * @brief gets the number of blocks the peer should send in about a given time
+     *
+     * @param target_seconds the time a span should take
+     * @param min_blocks the smallest span
+     * @param max_blocks the largest span
+     * @param default_blocks returned until a span was measured
+     */
+    size_t get_span_blocks(double target_seconds, size_t min_blocks, size_t max_blocks, size_t default_blocks) const;
+
+  private:
+    // decayed sums over the spans: weights, blocks, seconds, blocks^2, blocks*seconds
+    double m_weight;
+    double m_blocks;
+    double m_seconds;
+    double m_blocks2;
+    double m_blocks_seconds;
+  };
+}
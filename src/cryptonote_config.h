@@ -107,6 +107,7 @@
 #define CRYPTONOTE_DANDELIONPP_MIN_EPOCH         10 // minutes
 #define CRYPTONOTE_DANDELIONPP_EPOCH_RANGE       30 // seconds
 #define CRYPTONOTE_DANDELIONPP_FLUSH_AVERAGE      5 // seconds average for poisson distributed fluff flush
+#define CRYPTONOTE_DANDELIONPP_STEM_BATCH_WINDOW  5 // milliseconds stem txs wait to share one notification per stem peer
 #define CRYPTONOTE_DANDELIONPP_EMBARGO_AVERAGE   39 // seconds (see tx_pool.cpp for more info)
 
 // see src/cryptonote_protocol/levin_notify.cpp
@@ -152,7 +153,12 @@
 #define P2P_IDLE_CONNECTION_KILL_INTERVAL               (5*60) //5 minutes
 
 #define P2P_SUPPORT_FLAG_FLUFFY_BLOCKS                  0x01
+#define P2P_SUPPORT_FLAG_ZSTD_SPANS                     0x02
+#ifdef HAVE_ZSTD
+#define P2P_SUPPORT_FLAGS                               (P2P_SUPPORT_FLAG_FLUFFY_BLOCKS | P2P_SUPPORT_FLAG_ZSTD_SPANS)
+#else
 #define P2P_SUPPORT_FLAGS                               P2P_SUPPORT_FLAG_FLUFFY_BLOCKS
+#endif
 
 #define RPC_IP_FAILS_BEFORE_BLOCK                       3
 
@@ -188,6 +194,7 @@
 #define HASH_OF_HASHES_STEP                     512
 
 #define DEFAULT_TXPOOL_MAX_WEIGHT               648000000ull // 3 days at 300000, in bytes
+#define TXPOOL_PARSED_TX_INDEX_MAX_BYTES        (64 * 1024 * 1024) // blob bytes of pool txes kept parsed for fluffy blocks
 
 #define BULLETPROOF_MAX_OUTPUTS                 16
 
@@ -242,6 +249,7 @@ namespace config
   const char HASH_KEY_TRIPTYCH_TRANSCRIPT[] = "triptych transcript";
   const char HASH_KEY_GROOTLE_TRANSCRIPT[] = "grootle transcript";
   const char HASH_KEY_CONCISE_GROOTLE_TRANSCRIPT[] = "concise grootle transcript";
+  const char HASH_KEY_AGGREGATE_GROOTLE_TRANSCRIPT[] = "aggregate concise grootle transcript";
   const char HASH_KEY_SP_COMPOSITION_PROOF_TRANSCRIPT[] = "seraphis composition proof transcript";
   const char HASH_KEY_GROOTLE_Hi[] = "grootle Hi";
   const char HASH_KEY_SERAPHIS_U[] = "seraphis U";
@@ -252,6 +260,7 @@ namespace config
   const char HASH_KEY_SERAPHIS_VIEW_TAG[] = "seraphis enote view tag";
   const char HASH_KEY_SERAPHIS_AMOUNT_ENC[] = "seraphis enote amount encoding";
   const char HASH_KEY_SERAPHIS_SQUASHED_ENOTE[] = "seraphis squashed enote";
+  const char HASH_KEY_SERAPHIS_LEDGER_STATE[] = "seraphis ledger state";
   const char HASH_KEY_MULTISIG_BINONCE_MERGE_FACTOR[] = "multisig binonce merge factor";
 
   namespace testnet
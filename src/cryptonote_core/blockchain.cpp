@@ -76,8 +76,8 @@ using namespace crypto;
 
 using namespace cryptonote;
 using epee::string_tools::pod_to_hex;
-extern "C" void slow_hash_allocate_state();
-extern "C" void slow_hash_free_state();
+extern "C" void cn_slow_hash_allocate_state();
+extern "C" void cn_slow_hash_free_state();
 
 DISABLE_VS_WARNINGS(4267)
 
@@ -86,10 +86,19 @@ DISABLE_VS_WARNINGS(4267)
 // used to overestimate the block reward when estimating a per kB to use
 #define BLOCK_REWARD_OVERESTIMATE (10 * 1000000000000)
 
+// number of incoming blocks whose ring members are fetched together, one window ahead of verification
+#define RING_MEMBER_PREFETCH_BLOCKS 4
+
+// number of txes whose verified ring signatures are remembered, so txes from the pool are not verified again when mined
+#define RING_SIGNATURE_CACHE_MAX_ENTRIES 16384
+
+// number of outputs kept for get_outs, which wallets mostly ask about recent outputs as decoys
+#define OUTPUT_LOOKUP_CACHE_MAX_ENTRIES 65536
+
 //------------------------------------------------------------------
 Blockchain::Blockchain(tx_memory_pool& tx_pool) :
-  m_db(), m_tx_pool(tx_pool), m_hardfork(NULL), m_timestamps_and_difficulties_height(0), m_reset_timestamps_and_difficulties_height(true), m_current_block_cumul_weight_limit(0), m_current_block_cumul_weight_median(0),
-  m_enforce_dns_checkpoints(false), m_max_prepare_blocks_threads(4), m_db_sync_on_blocks(true), m_db_sync_threshold(1), m_db_sync_mode(db_async), m_db_default_sync(false), m_fast_sync(true), m_show_time_stats(false), m_sync_counter(0), m_bytes_to_sync(0), m_cancel(false),
+  m_db(), m_tx_pool(tx_pool), m_hardfork(NULL), m_timestamps_and_difficulties_height(0), m_reset_timestamps_and_difficulties_height(true), m_current_block_cumul_weight_limit(0), m_current_block_cumul_weight_median(0), m_ring_signature_cache(RING_SIGNATURE_CACHE_MAX_ENTRIES), m_output_lookup_cache(OUTPUT_LOOKUP_CACHE_MAX_ENTRIES),
+  m_enforce_dns_checkpoints(false), m_max_prepare_blocks_threads(4), m_sync_pow_dataset(false), m_sync_pow_dataset_used(false), m_db_sync_on_blocks(true), m_db_sync_threshold(1), m_db_sync_mode(db_async), m_db_default_sync(false), m_fast_sync(true), m_show_time_stats(false), m_sync_counter(0), m_bytes_to_sync(0), m_sync_batch_num_blocks(0), m_sync_batch_controller(BLOCKS_SYNCHRONIZING_DEFAULT_COUNT / 2, BLOCKS_SYNCHRONIZING_MAX_COUNT), m_cancel(false),
   m_long_term_block_weights_window(CRYPTONOTE_LONG_TERM_BLOCK_WEIGHT_WINDOW_SIZE),
   m_long_term_effective_median_block_weight(0),
   m_long_term_block_weights_cache_tip_hash(crypto::null_hash),
@@ -98,6 +107,7 @@ Blockchain::Blockchain(tx_memory_pool& tx_pool) :
   m_difficulty_for_next_block(1),
   m_btc_valid(false),
   m_batch_success(true),
+  m_db_top_hash(crypto::null_hash),
   m_prepare_height(0)
 {
   LOG_PRINT_L3("Blockchain::" << __func__);
@@ -129,6 +139,13 @@ bool Blockchain::have_tx_keyimg_as_spent(const crypto::key_image &key_im) const
   return  m_db->has_key_image(key_im);
 }
 //------------------------------------------------------------------
+void Blockchain::have_tx_keyimgs_as_spent(const epee::span<const crypto::key_image> &key_images, std::vector<bool> &spent) const
+{
+  LOG_PRINT_L3("Blockchain::" << __func__);
+  // WARNING: this function does not take m_blockchain_lock, see have_tx_keyimg_as_spent
+  m_db->has_key_images(key_images, spent);
+}
+//------------------------------------------------------------------
 // This function makes sure that each "input" in an input (mixins) exists
 // and collects the public key for each from the transaction it was included in
 // via the visitor passed to it.
@@ -361,6 +378,11 @@ bool Blockchain::init(BlockchainDB* db, const network_type nettype, bool offline
     m_db->fixup();
   }
 
+  TIME_MEASURE_START(warm_up);
+  warm_up_block_info();
+  TIME_MEASURE_FINISH(warm_up);
+  MINFO("Block info warmed up in " << warm_up << " ms");
+
   db_rtxn_guard rtxn_guard(m_db);
 
   // check how far behind we are
@@ -456,6 +478,7 @@ bool Blockchain::init(BlockchainDB* db, const network_type nettype, bool offline
     if (!update_next_cumulative_weight_limit())
       return false;
   }
+  m_db_top_hash = m_db->top_block_hash();
   return true;
 }
 //------------------------------------------------------------------
@@ -469,6 +492,34 @@ bool Blockchain::init(BlockchainDB* db, HardFork*& hf, const network_type nettyp
   return res;
 }
 //------------------------------------------------------------------
+bool Blockchain::update_from_db()
+{
+  LOG_PRINT_L3("Blockchain::" << __func__);
+  CRITICAL_REGION_LOCAL(m_blockchain_lock);
+  db_rtxn_guard rtxn_guard(m_db);
+
+  uint64_t top_height;
+  const crypto::hash top_hash = m_db->top_block_hash(&top_height);
+  if (top_hash == m_db_top_hash)
+    return false;
+
+  if (!m_db->block_exists(m_db_top_hash))
+  {
+    MINFO("Block " << m_db_top_hash << " was popped by the writer");
+    m_output_lookup_cache.clear();
+  }
+  m_db_top_hash = top_hash;
+
+  m_timestamps_and_difficulties_height = 0;
+  m_reset_timestamps_and_difficulties_height = true;
+  invalidate_block_template_cache();
+  m_hardfork->init();
+  update_next_cumulative_weight_limit();
+
+  MDEBUG("Followed the db to block " << top_hash << " at height " << top_height);
+  return true;
+}
+//------------------------------------------------------------------
 bool Blockchain::store_blockchain()
 {
   LOG_PRINT_L3("Blockchain::" << __func__);
@@ -643,6 +694,8 @@ block Blockchain::pop_block_from_blockchain()
     MWARNING(pruned << " pruned txes could not be added back to the txpool");
 
   m_blocks_longhash_table.clear();
+  clear_ring_member_prefetch();
+  m_output_lookup_cache.clear();
   m_scan_table.clear();
   m_blocks_txs_check.clear();
 
@@ -668,6 +721,7 @@ bool Blockchain::reset_and_set_genesis_block(const block& b)
   m_timestamps_and_difficulties_height = 0;
   m_reset_timestamps_and_difficulties_height = true;
   invalidate_block_template_cache();
+  m_output_lookup_cache.clear();
   m_db->reset();
   m_db->drop_alt_blocks();
   m_hardfork->init();
@@ -2290,36 +2344,91 @@ bool Blockchain::get_outs(const COMMAND_RPC_GET_OUTPUTS_BIN::request& req, COMMA
   CRITICAL_REGION_LOCAL(m_blockchain_lock);
 
   res.outs.clear();
-  res.outs.reserve(req.outputs.size());
+  res.outs.resize(req.outputs.size());
+
+  const uint8_t hf_version = m_hardfork->get_current_version();
+  auto fill = [&](size_t i, const cached_output &o) {
+    res.outs[i] = {o.data.pubkey, o.data.commitment, is_tx_spendtime_unlocked(o.data.unlock_time, hf_version), o.data.height, req.get_txid ? o.txid : crypto::null_hash};
+  };
+
+  // serve what we can from the cache, the rest is looked up in (amount, index) order so
+  // neighbouring outputs are read off the same pages, and only once if asked several times
+  std::vector<size_t> misses;
+  cached_output o;
+  for (size_t i = 0; i < req.outputs.size(); ++i)
+  {
+    if (m_output_lookup_cache.get(req.outputs[i].amount, req.outputs[i].index, req.get_txid, o))
+      fill(i, o);
+    else
+      misses.push_back(i);
+  }
+  if (misses.empty())
+    return true;
+  std::sort(misses.begin(), misses.end(), [&req](size_t a, size_t b) {
+    const auto &oa = req.outputs[a], &ob = req.outputs[b];
+    return oa.amount < ob.amount || (oa.amount == ob.amount && oa.index < ob.index);
+  });
+
+  std::vector<uint64_t> amounts, offsets;
+  amounts.reserve(misses.size());
+  offsets.reserve(misses.size());
+  for (size_t i: misses)
+  {
+    if (!amounts.empty() && amounts.back() == req.outputs[i].amount && offsets.back() == req.outputs[i].index)
+      continue;
+    amounts.push_back(req.outputs[i].amount);
+    offsets.push_back(req.outputs[i].index);
+  }
 
-  std::vector<cryptonote::output_data_t> data;
   try
   {
-    std::vector<uint64_t> amounts, offsets;
-    amounts.reserve(req.outputs.size());
-    offsets.reserve(req.outputs.size());
-    for (const auto &i: req.outputs)
-    {
-      amounts.push_back(i.amount);
-      offsets.push_back(i.index);
-    }
+    std::vector<cryptonote::output_data_t> data;
     m_db->get_output_key(epee::span<const uint64_t>(amounts.data(), amounts.size()), offsets, data);
-    if (data.size() != req.outputs.size())
+    if (data.size() != offsets.size())
     {
-      MERROR("Unexpected output data size: expected " << req.outputs.size() << ", got " << data.size());
+      MERROR("Unexpected output data size: expected " << offsets.size() << ", got " << data.size());
       return false;
     }
-    const uint8_t hf_version = m_hardfork->get_current_version();
-    for (const auto &t: data)
-      res.outs.push_back({t.pubkey, t.commitment, is_tx_spendtime_unlocked(t.unlock_time, hf_version), t.height, crypto::null_hash});
 
+    std::vector<crypto::hash> txids(offsets.size(), crypto::null_hash);
     if (req.get_txid)
     {
-      for (size_t i = 0; i < req.outputs.size(); ++i)
+      // one cursor per amount
+      std::vector<uint64_t> amount_offsets;
+      std::vector<tx_out_index> indices;
+      for (size_t start = 0; start < offsets.size(); )
       {
-        tx_out_index toi = m_db->get_output_tx_and_index(req.outputs[i].amount, req.outputs[i].index);
-        res.outs[i].txid = toi.first;
+        size_t end = start;
+        while (end < offsets.size() && amounts[end] == amounts[start])
+          ++end;
+        amount_offsets.assign(offsets.begin() + start, offsets.begin() + end);
+        m_db->get_output_tx_and_index(amounts[start], amount_offsets, indices);
+        if (indices.size() != amount_offsets.size())
+        {
+          MERROR("Unexpected output index size: expected " << amount_offsets.size() << ", got " << indices.size());
+          return false;
+        }
+        for (size_t j = start; j < end; ++j)
+          txids[j] = indices[j - start].first;
+        start = end;
+      }
+    }
+
+    size_t n = 0;
+    for (size_t m = 0; m < misses.size(); ++m)
+    {
+      const size_t i = misses[m];
+      if (m > 0 && req.outputs[i].amount == req.outputs[misses[m - 1]].amount && req.outputs[i].index == req.outputs[misses[m - 1]].index)
+      {
+        res.outs[i] = res.outs[misses[m - 1]];
+        continue;
       }
+      o.data = data[n];
+      o.txid = txids[n];
+      o.has_txid = req.get_txid;
+      m_output_lookup_cache.put(amounts[n], offsets[n], o);
+      fill(i, o);
+      ++n;
     }
   }
   catch (const std::exception &e)
@@ -2371,12 +2480,8 @@ bool Blockchain::get_output_distribution(uint64_t amount, uint64_t from_height,
     return false;
   if (amount == 0)
   {
-    std::vector<uint64_t> heights;
-    heights.reserve(to_height + 1 - start_height);
     const uint64_t real_start_height = start_height > 0 ? start_height-1 : start_height;
-    for (uint64_t h = real_start_height; h <= to_height; ++h)
-      heights.push_back(h);
-    distribution = m_db->get_block_cumulative_rct_outputs(heights);
+    distribution = m_db->get_block_cumulative_rct_outputs_range(real_start_height, to_height);
     if (start_height > 0)
     {
       base = distribution[0];
@@ -2622,29 +2727,30 @@ bool Blockchain::get_split_transactions_blobs(const t_ids_container& txs_ids, t_
   CRITICAL_REGION_LOCAL(m_blockchain_lock);
 
   reserve_container(txs, txs_ids.size());
-  for (const auto& tx_hash : txs_ids)
+  try
   {
-    try
+    std::vector<split_tx_blob> blobs;
+    m_db->get_split_tx_blobs(epee::span<const crypto::hash>(txs_ids.data(), txs_ids.size()), blobs);
+    for (size_t i = 0; i < blobs.size(); ++i)
     {
-      cryptonote::blobdata tx;
-      if (m_db->get_pruned_tx_blob(tx_hash, tx))
+      const crypto::hash &tx_hash = txs_ids[i];
+      split_tx_blob &blob = blobs[i];
+      if (!blob.found)
       {
-        txs.push_back(std::make_tuple(tx_hash, std::move(tx), crypto::null_hash, cryptonote::blobdata()));
-        if (!is_v1_tx(std::get<1>(txs.back())) && !m_db->get_prunable_tx_hash(tx_hash, std::get<2>(txs.back())))
-        {
-          MERROR("Prunable data hash not found for " << tx_hash);
-          return false;
-        }
-        if (!m_db->get_prunable_tx_blob(tx_hash, std::get<3>(txs.back())))
-          std::get<3>(txs.back()).clear();
-      }
-      else
         missed_txs.push_back(tx_hash);
+        continue;
+      }
+      if (!blob.has_prunable_hash && !is_v1_tx(blob.pruned))
+      {
+        MERROR("Prunable data hash not found for " << tx_hash);
+        return false;
+      }
+      txs.push_back(std::make_tuple(tx_hash, std::move(blob.pruned), blob.has_prunable_hash ? blob.prunable_hash : crypto::null_hash, std::move(blob.prunable)));
     }
-    catch (const std::exception& e)
-    {
-      return false;
-    }
+  }
+  catch (const std::exception& e)
+  {
+    return false;
   }
   return true;
 }
@@ -2777,6 +2883,37 @@ bool Blockchain::find_blockchain_supplement(const uint64_t req_start_block, cons
   return true;
 }
 //------------------------------------------------------------------
+bool Blockchain::find_blockchain_supplement(const uint64_t req_start_block, const std::list<crypto::hash>& qblock_ids, bool pruned, bool get_miner_tx_hash, size_t max_block_count, size_t max_tx_count, const std::function<bool(uint64_t total_height, uint64_t start_height, const std::vector<block_blob_refs>&)> &f) const
+{
+  LOG_PRINT_L3("Blockchain::" << __func__);
+  CRITICAL_REGION_LOCAL(m_blockchain_lock);
+
+  // the txn is only opened once the lock is held: a writer holding the lock may be waiting on readers to resize the map
+  db_rtxn_guard rtxn_guard(m_db);
+  uint64_t start_height = 0;
+
+  if(req_start_block > 0)
+  {
+    if (req_start_block >= m_db->height())
+    {
+      return false;
+    }
+    start_height = req_start_block;
+  }
+  else
+  {
+    if(!find_blockchain_supplement(qblock_ids, start_height))
+    {
+      return false;
+    }
+  }
+
+  std::vector<block_blob_refs> blocks;
+  if (!m_db->get_block_blob_refs_from(start_height, 3, max_block_count, max_tx_count, FIND_BLOCKCHAIN_SUPPLEMENT_MAX_SIZE, blocks, pruned, true, get_miner_tx_hash))
+    return false;
+  return f(get_current_blockchain_height(), start_height, blocks);
+}
+//------------------------------------------------------------------
 bool Blockchain::add_block_as_invalid(const block& bl, const crypto::hash& h)
 {
   LOG_PRINT_L3("Blockchain::" << __func__);
@@ -3149,13 +3286,16 @@ bool Blockchain::check_tx_outputs(const transaction& tx, tx_verification_context
 bool Blockchain::have_tx_keyimges_as_spent(const transaction &tx) const
 {
   LOG_PRINT_L3("Blockchain::" << __func__);
+  std::vector<crypto::key_image> key_images;
+  key_images.reserve(tx.vin.size());
   for (const txin_v& in: tx.vin)
   {
     CHECKED_GET_SPECIFIC_VARIANT(in, const txin_to_key, in_to_key, true);
-    if(have_tx_keyimg_as_spent(in_to_key.k_image))
-      return true;
+    key_images.push_back(in_to_key.k_image);
   }
-  return false;
+  std::vector<bool> spent;
+  have_tx_keyimgs_as_spent(epee::to_span(key_images), spent);
+  return std::find(spent.begin(), spent.end(), true) != spent.end();
 }
 bool Blockchain::expand_transaction_2(transaction &tx, const crypto::hash &tx_prefix_hash, const std::vector<std::vector<rct::ctkey>> &pubkeys) const
 {
@@ -3250,7 +3390,7 @@ bool Blockchain::expand_transaction_2(transaction &tx, const crypto::hash &tx_pr
 //        check_tx_input() rather than here, and use this function simply
 //        to iterate the inputs as necessary (splitting the task
 //        using threads, etc.)
-bool Blockchain::check_tx_inputs(transaction& tx, tx_verification_context &tvc, uint64_t* pmax_used_block_height) const
+bool Blockchain::check_tx_inputs(transaction& tx, tx_verification_context &tvc, uint64_t* pmax_used_block_height, ring_signature_batch *deferred_ring_signatures) const
 {
   PERF_TIMER(check_tx_inputs);
   LOG_PRINT_L3("Blockchain::" << __func__);
@@ -3390,12 +3530,22 @@ bool Blockchain::check_tx_inputs(transaction& tx, tx_verification_context &tvc,
   }
 
   std::vector<std::vector<rct::ctkey>> pubkeys(tx.vin.size());
-  std::vector < uint64_t > results;
-  results.resize(tx.vin.size(), 0);
 
-  tools::threadpool& tpool = tools::threadpool::getInstance();
-  tools::threadpool::waiter waiter(tpool);
-  int threads = tpool.get_max_concurrency();
+  // ring signatures are either deferred to the caller's batch, or verified
+  // here in chunks once every input has been checked
+  ring_signature_batch local_ring_signatures;
+  ring_signature_batch &ring_signatures = deferred_ring_signatures ? *deferred_ring_signatures : local_ring_signatures;
+  const crypto::hash tx_hash = get_transaction_hash(tx);
+
+  // look all the key images up at once, rather than one DB search per input
+  std::vector<crypto::key_image> key_images;
+  key_images.reserve(tx.vin.size());
+  for (const auto& txin : tx.vin)
+    if (txin.type() == typeid(txin_to_key))
+      key_images.push_back(boost::get<txin_to_key>(txin).k_image);
+  std::vector<bool> key_images_spent;
+  have_tx_keyimgs_as_spent(epee::to_span(key_images), key_images_spent);
+  size_t key_image_index = 0;
 
   uint64_t max_used_block_height = 0;
   if (!pmax_used_block_height)
@@ -3410,7 +3560,7 @@ bool Blockchain::check_tx_inputs(transaction& tx, tx_verification_context &tvc,
     // make sure tx output has key offset(s) (is signed to be used)
     CHECK_AND_ASSERT_MES(in_to_key.key_offsets.size(), false, "empty in_to_key.key_offsets in transaction with id " << get_transaction_hash(tx));
 
-    if(have_tx_keyimg_as_spent(in_to_key.k_image))
+    if(key_images_spent[key_image_index++])
     {
       MERROR_VER("Key image already spent in blockchain: " << epee::string_tools::pod_to_hex(in_to_key.k_image));
       tvc.m_double_spend = true;
@@ -3437,35 +3587,10 @@ bool Blockchain::check_tx_inputs(transaction& tx, tx_verification_context &tvc,
     }
 
     if (tx.version == 1)
-    {
-      if (threads > 1)
-      {
-        // ND: Speedup
-        // 1. Thread ring signature verification if possible.
-        tpool.submit(&waiter, boost::bind(&Blockchain::check_ring_signature, this, std::cref(tx_prefix_hash), std::cref(in_to_key.k_image), std::cref(pubkeys[sig_index]), std::cref(tx.signatures[sig_index]), std::ref(results[sig_index])), true);
-      }
-      else
-      {
-        check_ring_signature(tx_prefix_hash, in_to_key.k_image, pubkeys[sig_index], tx.signatures[sig_index], results[sig_index]);
-        if (!results[sig_index])
-        {
-          MERROR_VER("Failed to check ring signature for tx " << get_transaction_hash(tx) << "  vin key with k_image: " << in_to_key.k_image << "  sig_index: " << sig_index);
-
-          if (pmax_used_block_height)  // a default value of NULL is used when called from Blockchain::handle_block_to_main_chain()
-          {
-            MERROR_VER("*pmax_used_block_height: " << *pmax_used_block_height);
-          }
-
-          return false;
-        }
-      }
-    }
+      ring_signatures.v1().add(tx_hash, tx_prefix_hash, in_to_key.k_image, std::move(pubkeys[sig_index]), tx.signatures[sig_index]);
 
     sig_index++;
   }
-  if (tx.version == 1 && threads > 1)
-    if (!waiter.wait())
-      return false;
 
   // enforce min output age
   if (hf_version >= HF_VERSION_ENFORCE_MIN_AGE)
@@ -3476,17 +3601,10 @@ bool Blockchain::check_tx_inputs(transaction& tx, tx_verification_context &tvc,
 
   if (tx.version == 1)
   {
-    if (threads > 1)
+    if (!deferred_ring_signatures)
     {
-      // save results to table, passed or otherwise
-      bool failed = false;
-      for (size_t i = 0; i < tx.vin.size(); i++)
-      {
-        if(!failed && !results[i])
-          failed = true;
-      }
-
-      if (failed)
+      std::vector<crypto::hash> failed_txs;
+      if (!local_ring_signatures.verify(failed_txs))
       {
         MERROR_VER("Failed to check ring signatures!");
         return false;
@@ -3571,10 +3689,28 @@ bool Blockchain::check_tx_inputs(transaction& tx, tx_verification_context &tvc,
         }
       }
 
-      if (!rct::verRctNonSemanticsSimple(rv))
+      // skip the signatures if they were already verified against these same ring members, e.g. in the pool
+      const crypto::hash ring_signature_key = ring_signature_cache::get_key(tx_hash, rv.mixRing);
+      if (m_ring_signature_cache.has(ring_signature_key))
       {
-        MERROR_VER("Failed to check ringct signatures!");
-        return false;
+        MDEBUG("Ring signatures of tx " << tx_hash << " already verified");
+      }
+      else if (deferred_ring_signatures)
+      {
+        if (!deferred_ring_signatures->rct().add(tx_hash, rv))
+        {
+          MERROR_VER("Failed to check ringct signatures!");
+          return false;
+        }
+      }
+      else
+      {
+        if (!rct::verRctNonSemanticsSimple(rv))
+        {
+          MERROR_VER("Failed to check ringct signatures!");
+          return false;
+        }
+        m_ring_signature_cache.add(ring_signature_key);
       }
       break;
     }
@@ -3661,20 +3797,6 @@ bool Blockchain::check_tx_inputs(transaction& tx, tx_verification_context &tvc,
   return true;
 }
 
-//------------------------------------------------------------------
-void Blockchain::check_ring_signature(const crypto::hash &tx_prefix_hash, const crypto::key_image &key_image, const std::vector<rct::ctkey> &pubkeys, const std::vector<crypto::signature>& sig, uint64_t &result) const
-{
-  std::vector<const crypto::public_key *> p_output_keys;
-  p_output_keys.reserve(pubkeys.size());
-  for (auto &key : pubkeys)
-  {
-    // rct::key and crypto::public_key have the same structure, avoid object ctor/memcpy
-    p_output_keys.push_back(&(const crypto::public_key&)key.dest);
-  }
-
-  result = crypto::check_ring_signature(tx_prefix_hash, key_image, p_output_keys, sig.data()) ? 1 : 0;
-}
-
 //------------------------------------------------------------------
 uint64_t Blockchain::get_dynamic_base_fee(uint64_t block_reward, size_t median_block_weight, uint8_t version)
 {
@@ -4042,6 +4164,9 @@ leave:
     return false;
   }
 
+  // ring members of incoming blocks are fetched one window ahead
+  apply_ring_member_prefetch(blockchain_height);
+
   // warn users if they're running an old version
   if (!seen_future_version && bl.major_version > m_hardfork->get_ideal_version())
   {
@@ -4176,6 +4301,7 @@ leave:
   size_t cumulative_block_weight = coinbase_weight;
 
   std::vector<std::pair<transaction, blobdata>> txs;
+  ring_signature_batch ring_signatures;
   key_images_container keys;
 
   uint64_t fee_summary = 0;
@@ -4257,8 +4383,9 @@ leave:
 #endif
     {
       // validate that transaction inputs and the keys spending them are correct.
+      // ring signatures are verified for the whole block once every tx has been checked
       tx_verification_context tvc;
-      if(!check_tx_inputs(tx, tvc))
+      if(!check_tx_inputs(tx, tvc, NULL, &ring_signatures))
       {
         MERROR_VER("Block with id: " << id  << " has at least one transaction (id: " << tx_id << ") with wrong inputs.");
 
@@ -4295,6 +4422,26 @@ leave:
     cumulative_block_weight += tx_weight;
   }
 
+  if (ring_signatures.size() > 0)
+  {
+    TIME_MEASURE_START(rs);
+    std::vector<crypto::hash> failed_txs;
+    if (!ring_signatures.verify(failed_txs))
+    {
+      for (const crypto::hash &tx_id: failed_txs)
+        MERROR_VER("Block with id: " << id  << " has at least one transaction (id: " << tx_id << ") with wrong ring signatures.");
+
+      //TODO: why is this done?  make sure that keeping invalid blocks makes sense.
+      add_block_as_invalid(bl, id);
+      MERROR_VER("Block with id " << id << " added as invalid because of wrong inputs in transactions");
+      bvc.m_verifivation_failed = true;
+      return_tx_to_pool(txs);
+      goto leave;
+    }
+    TIME_MEASURE_FINISH(rs);
+    t_checktx += rs;
+  }
+
   // if we were syncing pruned blocks
   if (n_pruned > 0)
   {
@@ -4401,6 +4548,15 @@ leave:
   invalidate_block_template_cache();
 
   const uint8_t new_hf_version = get_current_hard_fork_version();
+  if (new_hf_version >= RX_BLOCK_VERSION)
+  {
+    // the next seed block is known some blocks before the switch: get its cache, and the
+    // datasets in use, ready in the background so hashing doesn't stall at the switch
+    uint64_t seed_height, next_height;
+    crypto::rx_seedheights(new_height, &seed_height, &next_height);
+    if (next_height != seed_height && next_height < new_height)
+      prepare_block_longhash_seed(next_height, get_block_id_by_height(next_height), m_max_prepare_blocks_threads);
+  }
   if (new_hf_version != hf_version)
   {
     // the genesis block is added before everything's setup, and the txpool is empty
@@ -4468,6 +4624,39 @@ uint64_t Blockchain::get_next_long_term_block_weight(uint64_t block_weight) cons
   return long_term_block_weight;
 }
 //------------------------------------------------------------------
+void Blockchain::warm_up_block_info() const
+{
+  LOG_PRINT_L3("Blockchain::" << __func__);
+
+  const uint64_t height = m_db->height();
+  const uint64_t window = std::max<uint64_t>({m_long_term_block_weights_window, CRYPTONOTE_REWARD_BLOCKS_WINDOW, DIFFICULTY_BLOCKS_COUNT});
+  const uint64_t start_height = height - std::min(height, window);
+
+  tools::threadpool& tpool = tools::threadpool::getInstance();
+  tools::threadpool::waiter waiter(tpool);
+  const uint64_t threads = tpool.get_max_concurrency();
+  const uint64_t chunk = std::max<uint64_t>((height - start_height + threads - 1) / threads, 1);
+  for (uint64_t h = start_height; h < height; h += chunk)
+  {
+    const size_t count = std::min(chunk, height - h);
+    tpool.submit(&waiter, [this, h, count]() {
+      try { m_db->get_long_term_block_weights(h, count); }
+      catch (const std::exception &e) { MDEBUG("Failed to warm up block info at height " << h << ": " << e.what()); }
+    }, true);
+  }
+  for (const std::pair<const uint64_t, difficulty_type>& i : m_checkpoints.get_difficulty_points())
+  {
+    if (i.first >= height)
+      break;
+    const uint64_t checkpoint_height = i.first;
+    tpool.submit(&waiter, [this, checkpoint_height]() {
+      try { m_db->get_block_cumulative_difficulty(checkpoint_height); }
+      catch (const std::exception &e) { MDEBUG("Failed to warm up block info at height " << checkpoint_height << ": " << e.what()); }
+    }, true);
+  }
+  waiter.wait();
+}
+//------------------------------------------------------------------
 bool Blockchain::update_next_cumulative_weight_limit(uint64_t *long_term_effective_median_block_weight)
 {
   PERF_TIMER(update_next_cumulative_weight_limit);
@@ -4665,24 +4854,47 @@ void Blockchain::set_enforce_dns_checkpoints(bool enforce_checkpoints)
 }
 
 //------------------------------------------------------------------
-void Blockchain::block_longhash_worker(uint64_t height, const epee::span<const block> &blocks, std::unordered_map<crypto::hash, crypto::hash> &map) const
+void Blockchain::block_longhash_worker(uint64_t height, const epee::span<const block> &blocks, std::unordered_map<crypto::hash, crypto::hash> &map, int miners) const
 {
   TIME_MEASURE_START(t);
-  slow_hash_allocate_state();
+
+  // the pool's threads keep their CryptoNight scratchpad (and CryptonightR JIT buffer) from one batch to the next
+  // while syncing blocks from before RandomX, and release it at the first batch that doesn't need it
+  if (!blocks.empty() && blocks.begin()->major_version < RX_BLOCK_VERSION)
+    cn_slow_hash_allocate_state();
+  else
+    cn_slow_hash_free_state();
+  rx_slow_hash_allocate_state();
 
   for (const auto & block : blocks)
   {
     if (m_cancel)
        break;
     crypto::hash id = get_block_hash(block);
-    crypto::hash pow = get_block_longhash(this, block, height++, 0);
+    crypto::hash pow = get_block_longhash(this, block, height++, miners);
     map.emplace(id, pow);
   }
 
-  slow_hash_free_state();
+  rx_slow_hash_free_state();
   TIME_MEASURE_FINISH(t);
 }
 
+//------------------------------------------------------------------
+void Blockchain::set_sync_pow_dataset(bool enabled, bool release_dataset)
+{
+  CRITICAL_REGION_LOCAL(m_blockchain_lock);
+  if (!enabled && m_sync_pow_dataset_used)
+  {
+    if (release_dataset)
+    {
+      MINFO("Releasing the RandomX dataset used while syncing");
+      release_block_longhash_dataset();
+    }
+    m_sync_pow_dataset_used = false;
+  }
+  m_sync_pow_dataset = enabled;
+}
+
 //------------------------------------------------------------------
 bool Blockchain::cleanup_handle_incoming_blocks(bool force_sync)
 {
@@ -4697,6 +4909,10 @@ bool Blockchain::cleanup_handle_incoming_blocks(bool force_sync)
     if (m_batch_success)
     {
       m_db->batch_stop();
+      // single blocks are new blocks being relayed, not sync batches
+      uint64_t commit_ms, dirty_bytes;
+      if (m_sync_batch_num_blocks > 1 && m_db->get_last_batch_commit_cost(commit_ms, dirty_bytes))
+        m_sync_batch_controller.add_batch(m_sync_batch_num_blocks, commit_ms, dirty_bytes);
       if (m_reset_timestamps_and_difficulties_height)
       {
         m_timestamps_and_difficulties_height = 0;
@@ -4742,6 +4958,7 @@ bool Blockchain::cleanup_handle_incoming_blocks(bool force_sync)
 
   TIME_MEASURE_FINISH(t1);
   m_blocks_longhash_table.clear();
+  clear_ring_member_prefetch();
   m_scan_table.clear();
   m_blocks_txs_check.clear();
 
@@ -4778,6 +4995,79 @@ void Blockchain::output_scan_worker(const uint64_t amount, const std::vector<uin
   }
 }
 
+//------------------------------------------------------------------
+void Blockchain::fetch_ring_members(ring_member_prefetch_window &window) const
+{
+  for (const auto &offsets : window.offset_map)
+    output_scan_worker(offsets.first, offsets.second, window.tx_map.at(offsets.first));
+}
+//------------------------------------------------------------------
+void Blockchain::start_ring_member_prefetch()
+{
+  if (m_ring_member_prefetch.empty())
+    return;
+  ring_member_prefetch_window &window = m_ring_member_prefetch.front();
+  if (window.fetched || window.waiter)
+    return;
+
+  tools::threadpool& tpool = tools::threadpool::getInstance();
+  if (tpool.get_max_concurrency() <= 1 || !m_db->can_thread_bulk_indices())
+    return;
+
+  // the window stays in place until it is applied or cleared, both of which wait for the fetch
+  window.waiter.reset(new tools::threadpool::waiter(tpool));
+  tpool.submit(window.waiter.get(), [this, &window]() { fetch_ring_members(window); }, true);
+}
+//------------------------------------------------------------------
+void Blockchain::apply_ring_member_prefetch(uint64_t height)
+{
+  while (!m_ring_member_prefetch.empty() && m_ring_member_prefetch.front().start_height <= height)
+  {
+    ring_member_prefetch_window &window = m_ring_member_prefetch.front();
+    if (window.waiter)
+      window.waiter->wait();
+    else if (!window.fetched)
+      fetch_ring_members(window);
+
+    for (const ring_member_prefetch_input &input : window.inputs)
+    {
+      auto its = m_scan_table.find(input.tx_prefix_hash);
+      if (its == m_scan_table.end())
+        continue;
+
+      // the offsets are sorted, so the outputs found are a prefix of them
+      const std::vector<uint64_t> &offsets = window.offset_map.at(input.amount);
+      const std::vector<output_data_t> &found = window.tx_map.at(input.amount);
+      std::vector<output_data_t> outputs;
+      outputs.reserve(input.absolute_offsets.size());
+      for (const uint64_t offset_needed : input.absolute_offsets)
+      {
+        const auto it = std::lower_bound(offsets.begin(), offsets.end(), offset_needed);
+        const size_t pos = it - offsets.begin();
+        if (it == offsets.end() || *it != offset_needed || pos >= found.size())
+          break;
+        outputs.push_back(found[pos]);
+      }
+
+      its->second.emplace(input.k_image, std::move(outputs));
+    }
+
+    m_ring_member_prefetch.pop_front();
+  }
+
+  start_ring_member_prefetch();
+}
+//------------------------------------------------------------------
+void Blockchain::clear_ring_member_prefetch()
+{
+  for (ring_member_prefetch_window &window : m_ring_member_prefetch)
+  {
+    if (window.waiter)
+      window.waiter->wait();
+  }
+  m_ring_member_prefetch.clear();
+}
+
 uint64_t Blockchain::prevalidate_block_hashes(uint64_t height, const std::vector<crypto::hash> &hashes, const std::vector<uint64_t> &weights)
 {
   // new: . . . . . X X X X X . . . . . .
@@ -4964,6 +5254,7 @@ bool Blockchain::prepare_handle_incoming_blocks(const std::vector<block_complete
     m_blockchain_lock.lock();
   }
   m_batch_success = true;
+  m_sync_batch_num_blocks = blocks_entry.size();
 
   const uint64_t height = m_db->height();
   if ((height + blocks_entry.size()) < m_blocks_hash_check.size())
@@ -5037,6 +5328,17 @@ bool Blockchain::prepare_handle_incoming_blocks(const std::vector<block_complete
       m_prepare_height = height;
       m_prepare_nblocks = blocks_entry.size();
       m_prepare_blocks = &blocks;
+
+      // the dataset is shared by all workers, so it can only be used if the batch has a single seed
+      int pow_miners = 0;
+      if (m_sync_pow_dataset && rx_seedheight(height) == rx_seedheight(height + blocks_entry.size() - 1))
+      {
+        if (!m_sync_pow_dataset_used)
+          MINFO("Using the RandomX dataset to check PoW while syncing");
+        m_sync_pow_dataset_used = true;
+        pow_miners = threads;
+      }
+
       for (unsigned int i = 0; i < threads; i++)
       {
         unsigned nblocks = batches;
@@ -5044,7 +5346,7 @@ bool Blockchain::prepare_handle_incoming_blocks(const std::vector<block_complete
           ++nblocks;
         if (nblocks == 0)
           break;
-        tpool.submit(&waiter, boost::bind(&Blockchain::block_longhash_worker, this, thread_height, epee::span<const block>(&blocks[thread_height - height], nblocks), std::ref(maps[i])), true);
+        tpool.submit(&waiter, boost::bind(&Blockchain::block_longhash_worker, this, thread_height, epee::span<const block>(&blocks[thread_height - height], nblocks), std::ref(maps[i]), pow_miners), true);
         thread_height += nblocks;
       }
 
@@ -5074,6 +5376,7 @@ bool Blockchain::prepare_handle_incoming_blocks(const std::vector<block_complete
   m_fake_scan_time = 0;
   m_fake_pow_calc_time = 0;
 
+  clear_ring_member_prefetch();
   m_scan_table.clear();
 
   TIME_MEASURE_FINISH(prepare);
@@ -5084,28 +5387,33 @@ bool Blockchain::prepare_handle_incoming_blocks(const std::vector<block_complete
 
   TIME_MEASURE_START(scantable);
 
-  // [input] stores all unique amounts found
-  std::vector < uint64_t > amounts;
-  // [input] stores all absolute_offsets for each amount
-  std::map<uint64_t, std::vector<uint64_t>> offset_map;
-  // [output] stores all output_data_t for each absolute_offset
-  std::map<uint64_t, std::vector<output_data_t>> tx_map;
   std::vector<std::pair<cryptonote::transaction, crypto::hash>> txes(total_txs);
 
 #define SCAN_TABLE_QUIT(m) \
         do { \
             MERROR_VER(m) ;\
+            clear_ring_member_prefetch(); \
             m_scan_table.clear(); \
             return false; \
         } while(0); \
 
-  // generate sorted tables for all amounts and absolute offsets
+  // group the inputs of the incoming blocks by window, with sorted tables of
+  // all amounts and absolute offsets each window needs
   size_t tx_index = 0, block_index = 0;
+  std::unordered_set<crypto::key_image> tx_key_images;
   for (const auto &entry : blocks_entry)
   {
     if (m_cancel)
       return false;
 
+    if (block_index % RING_MEMBER_PREFETCH_BLOCKS == 0)
+    {
+      m_ring_member_prefetch.emplace_back();
+      m_ring_member_prefetch.back().start_height = height + block_index;
+      m_ring_member_prefetch.back().fetched = false;
+    }
+    ring_member_prefetch_window &window = m_ring_member_prefetch.back();
+
     for (const auto &tx_blob : entry.txs)
     {
       if (tx_index >= txes.size())
@@ -5123,136 +5431,63 @@ bool Blockchain::prepare_handle_incoming_blocks(const std::vector<block_complete
         SCAN_TABLE_QUIT("Duplicate tx found from incoming blocks.");
 
       m_scan_table.emplace(tx_prefix_hash, std::unordered_map<crypto::key_image, std::vector<output_data_t>>());
-      its = m_scan_table.find(tx_prefix_hash);
-      assert(its != m_scan_table.end());
 
-      // get all amounts from tx.vin(s)
+      tx_key_images.clear();
       for (const auto &txin : tx.vin)
       {
         const txin_to_key &in_to_key = boost::get < txin_to_key > (txin);
 
         // check for duplicate
-        auto it = its->second.find(in_to_key.k_image);
-        if (it != its->second.end())
+        if (!tx_key_images.insert(in_to_key.k_image).second)
           SCAN_TABLE_QUIT("Duplicate key_image found from incoming blocks.");
 
-        amounts.push_back(in_to_key.amount);
-      }
-
-      // sort and remove duplicate amounts from amounts list
-      std::sort(amounts.begin(), amounts.end());
-      auto last = std::unique(amounts.begin(), amounts.end());
-      amounts.erase(last, amounts.end());
-
-      // add amount to the offset_map and tx_map
-      for (const uint64_t &amount : amounts)
-      {
-        if (offset_map.find(amount) == offset_map.end())
-          offset_map.emplace(amount, std::vector<uint64_t>());
-
-        if (tx_map.find(amount) == tx_map.end())
-          tx_map.emplace(amount, std::vector<output_data_t>());
-      }
+        window.inputs.push_back({tx_prefix_hash, in_to_key.k_image, in_to_key.amount, relative_output_offsets_to_absolute(in_to_key.key_offsets)});
 
-      // add new absolute_offsets to offset_map
-      for (const auto &txin : tx.vin)
-      {
-        const txin_to_key &in_to_key = boost::get < txin_to_key > (txin);
         // no need to check for duplicate here.
-        auto absolute_offsets = relative_output_offsets_to_absolute(in_to_key.key_offsets);
-        for (const auto & offset : absolute_offsets)
-          offset_map[in_to_key.amount].push_back(offset);
-
+        std::vector<uint64_t> &offsets = window.offset_map[in_to_key.amount];
+        offsets.insert(offsets.end(), window.inputs.back().absolute_offsets.begin(), window.inputs.back().absolute_offsets.end());
       }
     }
     ++block_index;
   }
 
   // sort and remove duplicate absolute_offsets in offset_map
-  for (auto &offsets : offset_map)
+  for (ring_member_prefetch_window &window : m_ring_member_prefetch)
   {
-    std::sort(offsets.second.begin(), offsets.second.end());
-    auto last = std::unique(offsets.second.begin(), offsets.second.end());
-    offsets.second.erase(last, offsets.second.end());
+    for (auto &offsets : window.offset_map)
+    {
+      std::sort(offsets.second.begin(), offsets.second.end());
+      auto last = std::unique(offsets.second.begin(), offsets.second.end());
+      offsets.second.erase(last, offsets.second.end());
+      window.tx_map.emplace(offsets.first, std::vector<output_data_t>());
+    }
   }
 
-  // gather all the output keys
+  // gather the output keys of the first window now; the other windows are
+  // fetched in the background, one window ahead of the blocks being verified
+  ring_member_prefetch_window &first_window = m_ring_member_prefetch.front();
   threads = tpool.get_max_concurrency();
   if (!m_db->can_thread_bulk_indices())
     threads = 1;
 
-  if (threads > 1 && amounts.size() > 1)
+  if (threads > 1 && first_window.offset_map.size() > 1)
   {
     tools::threadpool::waiter waiter(tpool);
 
-    for (size_t i = 0; i < amounts.size(); i++)
+    for (const auto &offsets : first_window.offset_map)
     {
-      uint64_t amount = amounts[i];
-      tpool.submit(&waiter, boost::bind(&Blockchain::output_scan_worker, this, amount, std::cref(offset_map[amount]), std::ref(tx_map[amount])), true);
+      tpool.submit(&waiter, boost::bind(&Blockchain::output_scan_worker, this, offsets.first, std::cref(offsets.second), std::ref(first_window.tx_map[offsets.first])), true);
     }
     if (!waiter.wait())
       return false;
   }
   else
   {
-    for (size_t i = 0; i < amounts.size(); i++)
-    {
-      uint64_t amount = amounts[i];
-      output_scan_worker(amount, offset_map[amount], tx_map[amount]);
-    }
+    fetch_ring_members(first_window);
   }
+  first_window.fetched = true;
 
-  // now generate a table for each tx_prefix and k_image hashes
-  tx_index = 0;
-  for (const auto &entry : blocks_entry)
-  {
-    if (m_cancel)
-      return false;
-
-    for (size_t i = 0; i < entry.txs.size(); ++i)
-    {
-      if (tx_index >= txes.size())
-        SCAN_TABLE_QUIT("tx_index is out of sync");
-      const transaction &tx = txes[tx_index].first;
-      const crypto::hash &tx_prefix_hash = txes[tx_index].second;
-      ++tx_index;
-
-      auto its = m_scan_table.find(tx_prefix_hash);
-      if (its == m_scan_table.end())
-        SCAN_TABLE_QUIT("Tx not found on scan table from incoming blocks.");
-
-      for (const auto &txin : tx.vin)
-      {
-        const txin_to_key &in_to_key = boost::get < txin_to_key > (txin);
-        auto needed_offsets = relative_output_offsets_to_absolute(in_to_key.key_offsets);
-
-        std::vector<output_data_t> outputs;
-        for (const uint64_t & offset_needed : needed_offsets)
-        {
-          size_t pos = 0;
-          bool found = false;
-
-          for (const uint64_t &offset_found : offset_map[in_to_key.amount])
-          {
-            if (offset_needed == offset_found)
-            {
-              found = true;
-              break;
-            }
-
-            ++pos;
-          }
-
-          if (found && pos < tx_map[in_to_key.amount].size())
-            outputs.push_back(tx_map[in_to_key.amount].at(pos));
-          else
-            break;
-        }
-
-        its->second.emplace(in_to_key.k_image, outputs);
-      }
-    }
-  }
+  apply_ring_member_prefetch(height);
 
   TIME_MEASURE_FINISH(scantable);
   if (total_txs > 0)
@@ -42,7 +42,10 @@
 #include <boost/multi_index/hashed_index.hpp>
 #include <boost/multi_index/member.hpp>
 #include <atomic>
+#include <deque>
 #include <functional>
+#include <map>
+#include <memory>
 #include <unordered_map>
 #include <unordered_set>
 
@@ -51,12 +54,16 @@
 #include "string_tools.h"
 #include "rolling_median.h"
 #include "cryptonote_basic/cryptonote_basic.h"
+#include "common/threadpool.h"
 #include "common/powerof.h"
 #include "common/util.h"
 #include "cryptonote_protocol/cryptonote_protocol_defs.h"
 #include "rpc/core_rpc_server_commands_defs.h"
 #include "cryptonote_basic/difficulty.h"
 #include "cryptonote_tx_utils.h"
+#include "ring_signature_batch.h"
+#include "sync_batch_controller.h"
+#include "output_lookup_cache.h"
 #include "cryptonote_basic/verification_context.h"
 #include "crypto/hash.h"
 #include "checkpoints/checkpoints.h"
@@ -287,6 +294,17 @@ namespace cryptonote
      */
     bool have_tx_keyimg_as_spent(const crypto::key_image &key_im) const;
 
+    /**
+     * @brief check which of a set of key images are already spent on the blockchain
+     *
+     * Looks the key images up together, which is cheaper than one
+     * have_tx_keyimg_as_spent call per key image.
+     *
+     * @param key_images the key images to search for
+     * @param spent return-by-reference spent[i] is true if key_images[i] is spent
+     */
+    void have_tx_keyimgs_as_spent(const epee::span<const crypto::key_image> &key_images, std::vector<bool> &spent) const;
+
     /**
      * @brief get the current height of the blockchain
      *
@@ -493,6 +511,17 @@ namespace cryptonote
      */
     bool find_blockchain_supplement(const uint64_t req_start_block, const std::list<crypto::hash>& qblock_ids, std::vector<std::pair<std::pair<cryptonote::blobdata, crypto::hash>, std::vector<std::pair<crypto::hash, cryptonote::blobdata> > > >& blocks, uint64_t& total_height, uint64_t& start_height, bool pruned, bool get_miner_tx_hash, size_t max_block_count, size_t max_tx_count) const;
 
+    /**
+     * @brief get recent block and transaction blobs relative to a foreign chain, without copying them
+     *
+     * As above, but the blobs are referenced in the database and handed to
+     * the callback, which runs under the blockchain lock and a read
+     * transaction; the references are not valid once it returns.
+     *
+     * @return false if no block was found in common, req_start_block is past the top or the database can't reference blobs, else the callback's result
+     */
+    bool find_blockchain_supplement(const uint64_t req_start_block, const std::list<crypto::hash>& qblock_ids, bool pruned, bool get_miner_tx_hash, size_t max_block_count, size_t max_tx_count, const std::function<bool(uint64_t total_height, uint64_t start_height, const std::vector<block_blob_refs>&)> &f) const;
+
     /**
      * @brief retrieves a set of blocks and their transactions, and possibly other transactions
      *
@@ -541,6 +570,11 @@ namespace cryptonote
      */
     bool get_outs(const COMMAND_RPC_GET_OUTPUTS_BIN::request& req, COMMAND_RPC_GET_OUTPUTS_BIN::response& res) const;
 
+    /**
+     * @brief gets how many outputs get_outs found in its cache, and how many it had to look up
+     */
+    void get_output_lookup_cache_stats(uint64_t &hits, uint64_t &misses) const { hits = m_output_lookup_cache.get_hits(); misses = m_output_lookup_cache.get_misses(); }
+
     /**
      * @brief gets an output's key and unlocked state
      *
@@ -579,6 +613,18 @@ namespace cryptonote
     bool get_tx_outputs_gindexs(const crypto::hash& tx_id, std::vector<uint64_t>& indexs) const;
     bool get_tx_outputs_gindexs(const crypto::hash& tx_id, size_t n_txes, std::vector<std::vector<uint64_t>>& indexs) const;
 
+    /**
+     * @brief picks up blocks another process committed to the db
+     *
+     * For a read-only db written by another daemon: when its top block
+     * changed, the state cached from the chain (hard fork votes, weight
+     * limits, difficulties, block template) is dropped or recomputed, and
+     * the output cache is cleared if the old top block was popped.
+     *
+     * @return true if the top block changed since the last call
+     */
+    bool update_from_db();
+
     /**
      * @brief stores the blockchain
      *
@@ -822,6 +868,31 @@ namespace cryptonote
      */
     void set_show_time_stats(bool stats) { m_show_time_stats = stats; }
 
+    /**
+     * @brief set whether to check the PoW of synced blocks with the full RandomX dataset
+     *
+     * The dataset needs over 2 GB of memory, but hashes much faster than the
+     * light mode cache, so it pays off when syncing many blocks.
+     *
+     * @param enabled the new setting
+     * @param release_dataset when turning it off, whether to free the dataset (not if a miner uses it)
+     */
+    void set_sync_pow_dataset(bool enabled, bool release_dataset = true);
+
+    /**
+     * @brief gets how many blocks to add per database batch while syncing
+     *
+     * The number is tuned from the measured cost of past commits.
+     *
+     * @param default_blocks the number to use until a batch was measured
+     */
+    size_t get_sync_batch_blocks(size_t default_blocks) const { return m_sync_batch_controller.get_batch_blocks(default_blocks); }
+
+    /**
+     * @brief gets sync throughput and database commit latency figures
+     */
+    sync_batch_stats get_sync_batch_stats() const { return m_sync_batch_controller.get_stats(); }
+
     /**
      * @brief gets the hardfork voting state object
      *
@@ -1003,9 +1074,10 @@ namespace cryptonote
      * @param height the height of the first block
      * @param blocks the blocks to be hashed
      * @param map return-by-reference the hashes for each block
+     * @param miners number of threads to initialize the RandomX dataset with, 0 for light mode
      */
     void block_longhash_worker(uint64_t height, const epee::span<const block> &blocks,
-        std::unordered_map<crypto::hash, crypto::hash> &map) const;
+        std::unordered_map<crypto::hash, crypto::hash> &map, int miners) const;
 
     /**
      * @brief returns a set of known alternate chains
@@ -1101,6 +1173,32 @@ namespace cryptonote
 
     typedef std::unordered_map<crypto::hash, block_extended_info> blocks_ext_by_hash;
 
+    /**
+     * @brief an input of an incoming tx, with the ring members it needs
+     */
+    struct ring_member_prefetch_input
+    {
+      crypto::hash tx_prefix_hash;
+      crypto::key_image k_image;
+      uint64_t amount;
+      std::vector<uint64_t> absolute_offsets;
+    };
+
+    /**
+     * @brief the ring members of a window of consecutive incoming blocks
+     *
+     * offset_map holds the sorted, unique offsets needed for each amount;
+     * tx_map receives the outputs found for them, in the same order.
+     */
+    struct ring_member_prefetch_window
+    {
+      uint64_t start_height;
+      std::vector<ring_member_prefetch_input> inputs;
+      std::map<uint64_t, std::vector<uint64_t>> offset_map;
+      std::map<uint64_t, std::vector<output_data_t>> tx_map;
+      std::unique_ptr<tools::threadpool::waiter> waiter; // set while fetched in the background
+      bool fetched;
+    };
 
     BlockchainDB* m_db;
 
@@ -1114,6 +1212,11 @@ namespace cryptonote
 
     // metadata containers
     std::unordered_map<crypto::hash, std::unordered_map<crypto::key_image, std::vector<output_data_t>>> m_scan_table;
+    std::deque<ring_member_prefetch_window> m_ring_member_prefetch;
+    // txes whose ring signatures were verified, keyed by tx and ring members
+    mutable ring_signature_cache m_ring_signature_cache;
+    // outputs recently served to get_outs, cleared when blocks are popped
+    mutable output_lookup_cache m_output_lookup_cache;
     std::unordered_map<crypto::hash, crypto::hash> m_blocks_longhash_table;
 
     // Keccak hashes for each block and for fast pow checking
@@ -1128,10 +1231,14 @@ namespace cryptonote
     bool m_db_sync_on_blocks;
     uint64_t m_db_sync_threshold;
     uint64_t m_max_prepare_blocks_threads;
+    bool m_sync_pow_dataset; //!< whether synced blocks' PoW is checked with the RandomX dataset
+    bool m_sync_pow_dataset_used; //!< whether a sync batch has allocated the RandomX dataset
     uint64_t m_fake_pow_calc_time;
     uint64_t m_fake_scan_time;
     uint64_t m_sync_counter;
     uint64_t m_bytes_to_sync;
+    size_t m_sync_batch_num_blocks; //!< blocks in the batch started by prepare_handle_incoming_blocks
+    sync_batch_controller m_sync_batch_controller;
     std::vector<uint64_t> m_timestamps;
     std::vector<difficulty_type> m_difficulties;
     uint64_t m_timestamps_and_difficulties_height;
@@ -1179,6 +1286,8 @@ namespace cryptonote
 
     bool m_batch_success;
 
+    crypto::hash m_db_top_hash; //!< top block at init or at the last update_from_db()
+
     /* `boost::function` is used because the implementation never allocates if
        the callable object has a single `std::shared_ptr` or `std::weap_ptr`
        internally. Whereas, the libstdc++ `std::function` will allocate. */
@@ -1248,16 +1357,19 @@ namespace cryptonote
      * If pmax_related_block_height is not NULL, its value is set to the height
      * of the most recent block which contains an output used in any input set
      *
-     * Currently this function calls ring signature validation for each
-     * transaction.
+     * If deferred_ring_signatures is not NULL, the ring signatures of pre-rct
+     * and simple rct transactions are added to it instead of being verified,
+     * and the caller must verify the batch before accepting the transaction.
+     * Otherwise they are verified here.
      *
      * @param tx the transaction to validate
      * @param tvc returned information about tx verification
      * @param pmax_related_block_height return-by-pointer the height of the most recent block in the input set
+     * @param deferred_ring_signatures batch to collect the ring signatures in, or NULL to verify them now
      *
      * @return false if any validation step fails, otherwise true
      */
-    bool check_tx_inputs(transaction& tx, tx_verification_context &tvc, uint64_t* pmax_used_block_height = NULL) const;
+    bool check_tx_inputs(transaction& tx, tx_verification_context &tvc, uint64_t* pmax_used_block_height = NULL, ring_signature_batch *deferred_ring_signatures = NULL) const;
 
     /**
      * @brief performs a blockchain reorganization according to the longest chain rule
@@ -1501,6 +1613,17 @@ namespace cryptonote
      */
     bool complete_timestamps_vector(uint64_t start_height, std::vector<uint64_t>& timestamps) const;
 
+    /**
+     * @brief reads the block info the startup caches need, in parallel
+     *
+     * The difficulty and weight caches read the top of the chain one block
+     * at a time, which stalls on every page when the page cache is cold.
+     * Reading those ranges (and the difficulty checkpoints) from several
+     * threads first brings them in with many reads in flight.  Errors are
+     * ignored, the caches are built as usual afterwards.
+     */
+    void warm_up_block_info() const;
+
     /**
      * @brief calculate the block weight limit for the next block to be added
      *
@@ -1511,6 +1634,37 @@ namespace cryptonote
     bool update_next_cumulative_weight_limit(uint64_t *long_term_effective_median_block_weight = NULL);
     void return_tx_to_pool(std::vector<std::pair<transaction, blobdata>> &txs);
 
+    /**
+     * @brief reads the ring members of a window of incoming blocks from the db
+     *
+     * Each amount's offsets are read in a single sorted pass.
+     *
+     * @param window the window to fetch
+     */
+    void fetch_ring_members(ring_member_prefetch_window &window) const;
+
+    /**
+     * @brief starts fetching the next window of ring members in the background
+     *
+     * Does nothing if the db can not be read from several threads, in which
+     * case the window is fetched when it is needed.
+     */
+    void start_ring_member_prefetch();
+
+    /**
+     * @brief moves the prefetched ring members of the windows starting at or below a height to the scan table
+     *
+     * Waits for a window still being fetched, then starts fetching the next one.
+     *
+     * @param height the height of the block about to be verified
+     */
+    void apply_ring_member_prefetch(uint64_t height);
+
+    /**
+     * @brief drops all prefetched ring members, waiting for any background fetch first
+     */
+    void clear_ring_member_prefetch();
+
     /**
      * @brief make sure a transaction isn't attempting a double-spend
      *
@@ -1521,18 +1675,6 @@ namespace cryptonote
      */
     bool check_for_double_spend(const transaction& tx, key_images_container& keys_this_block) const;
 
-    /**
-     * @brief validates a transaction input's ring signature
-     *
-     * @param tx_prefix_hash the transaction prefix' hash
-     * @param key_image the key image generated from the true input
-     * @param pubkeys the public keys for each input in the ring signature
-     * @param sig the signature generated for each input in the ring signature
-     * @param result false if the ring signature is invalid, otherwise true
-     */
-    void check_ring_signature(const crypto::hash &tx_prefix_hash, const crypto::key_image &key_image,
-        const std::vector<rct::ctkey> &pubkeys, const std::vector<crypto::signature> &sig, uint64_t &result) const;
-
     /**
      * @brief loads block hashes from compiled-in data set
      *
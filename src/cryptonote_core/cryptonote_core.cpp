@@ -40,6 +40,7 @@ using namespace epee;
 #include "common/updates.h"
 #include "common/download.h"
 #include "common/threadpool.h"
+#include "common/metrics.h"
 #include "common/command_line.h"
 #include "cryptonote_basic/events.h"
 #include "warnings.h"
@@ -47,6 +48,7 @@ using namespace epee;
 #include "cryptonote_config.h"
 #include "misc_language.h"
 #include "file_io_utils.h"
+#include "profile_tools.h"
 #include <csignal>
 #include "checkpoints/checkpoints.h"
 #include "ringct/rctTypes.h"
@@ -71,6 +73,14 @@ DISABLE_VS_WARNINGS(4355)
 // basically at least how many bytes the block itself serializes to without the miner tx
 #define BLOCK_SIZE_SANITY_LEEWAY 100
 
+namespace
+{
+  tools::MetricsHistogram incoming_tx_batch_size("monero_core_incoming_tx_batch_size",
+    "Number of transactions per handle_incoming_txs call");
+  tools::MetricsHistogram incoming_tx_batch_seconds("monero_core_incoming_tx_batch_seconds",
+    "Duration of handle_incoming_txs calls, including the wait for the incoming tx lock", 1e-9);
+}
+
 namespace cryptonote
 {
   const command_line::arg_descriptor<bool, false> arg_testnet_on  = {
@@ -115,6 +125,11 @@ namespace cryptonote
     "offline"
   , "Do not listen for peers, nor connect to any"
   };
+  const command_line::arg_descriptor<bool> arg_rpc_replica = {
+    "rpc-replica"
+  , "Serve restricted RPC from the database of another monerod on this host, opened read only and followed as it "
+    "commits (implies --offline; no p2p, mining or verification). Run several on different RPC ports to scale RPC"
+  };
   const command_line::arg_descriptor<bool> arg_disable_dns_checkpoints = {
     "disable-dns-checkpoints"
   , "Do not retrieve checkpoints from DNS"
@@ -128,6 +143,10 @@ namespace cryptonote
     "sync-pruned-blocks"
   , "Allow syncing from nodes with only pruned blocks"
   };
+  const command_line::arg_descriptor<bool> arg_no_sync_compression  = {
+    "no-sync-compression"
+  , "Do not ask peers for compressed block spans while syncing, nor compress spans for them"
+  };
 
   static const command_line::arg_descriptor<bool> arg_test_drop_download = {
     "test-drop-download"
@@ -158,6 +177,10 @@ namespace cryptonote
   , "Max number of threads to use when preparing block hashes in groups."
   , 4
   };
+  static const command_line::arg_descriptor<bool> arg_sync_pow_dataset  = {
+    "sync-pow-dataset"
+  , "Check PoW with the full RandomX dataset (over 2 GB of RAM) while syncing, much faster than light mode. It is freed once synced."
+  };
   static const command_line::arg_descriptor<uint64_t> arg_show_time_stats  = {
     "show-time-stats"
   , "Show time-stats when processing blocks/txs and disk synchronization."
@@ -168,6 +191,11 @@ namespace cryptonote
   , "How many blocks to sync at once during chain synchronization (0 = adaptive)."
   , 0
   };
+  static const command_line::arg_descriptor<size_t> arg_block_sync_pipeline_memory  = {
+    "block-sync-pipeline-memory"
+  , "Max bytes of transactions from upcoming blocks to verify in the background while syncing (0 to disable)."
+  , 64 * 1024 * 1024
+  };
   static const command_line::arg_descriptor<std::string> arg_check_updates = {
     "check-updates"
   , "Check for new versions of monero: [disabled|notify|download|update]"
@@ -232,6 +260,8 @@ namespace cryptonote
                 return cryptonote::get_block_longhash(&m_blockchain_storage, b, hash, height, seed_hash, threads);
               }),
               m_starter_message_showed(false),
+              m_rpc_replica(false),
+              m_replica_txpool_count(0),
               m_target_blockchain_height(0),
               m_checkpoints_path(""),
               m_last_dns_checkpoints_update(0),
@@ -239,7 +269,12 @@ namespace cryptonote
               m_disable_dns_checkpoints(false),
               m_update_download(0),
               m_nettype(UNDEFINED),
-              m_update_available(false)
+              m_update_available(false),
+              m_sync_pipeline_memory_budget(0),
+              m_sync_pipeline_blocks(NULL),
+              m_sync_pipeline_next(0),
+              m_sync_pipeline_added(0),
+              m_sync_pipeline_bytes(0)
   {
     m_checkpoints_updating.clear();
     set_cryptonote_protocol(pprotocol);
@@ -333,16 +368,20 @@ namespace cryptonote
     command_line::add_arg(desc, arg_dns_checkpoints);
     command_line::add_arg(desc, arg_prep_blocks_threads);
     command_line::add_arg(desc, arg_fast_block_sync);
+    command_line::add_arg(desc, arg_sync_pow_dataset);
     command_line::add_arg(desc, arg_show_time_stats);
     command_line::add_arg(desc, arg_block_sync_size);
+    command_line::add_arg(desc, arg_block_sync_pipeline_memory);
     command_line::add_arg(desc, arg_check_updates);
     command_line::add_arg(desc, arg_fluffy_blocks);
     command_line::add_arg(desc, arg_no_fluffy_blocks);
     command_line::add_arg(desc, arg_test_dbg_lock_sleep);
     command_line::add_arg(desc, arg_offline);
+    command_line::add_arg(desc, arg_rpc_replica);
     command_line::add_arg(desc, arg_disable_dns_checkpoints);
     command_line::add_arg(desc, arg_block_download_max_size);
     command_line::add_arg(desc, arg_sync_pruned_blocks);
+    command_line::add_arg(desc, arg_no_sync_compression);
     command_line::add_arg(desc, arg_max_txpool_weight);
     command_line::add_arg(desc, arg_block_notify);
     command_line::add_arg(desc, arg_prune_blockchain);
@@ -386,7 +425,8 @@ namespace cryptonote
     set_enforce_dns_checkpoints(command_line::get_arg(vm, arg_dns_checkpoints));
     test_drop_download_height(command_line::get_arg(vm, arg_test_drop_download_height));
     m_fluffy_blocks_enabled = !get_arg(vm, arg_no_fluffy_blocks);
-    m_offline = get_arg(vm, arg_offline);
+    m_rpc_replica = get_arg(vm, arg_rpc_replica);
+    m_offline = get_arg(vm, arg_offline) || m_rpc_replica;
     m_disable_dns_checkpoints = get_arg(vm, arg_disable_dns_checkpoints);
 
     if (!command_line::is_arg_defaulted(vm, arg_fluffy_blocks))
@@ -446,6 +486,12 @@ namespace cryptonote
     return true;
   }
   //-----------------------------------------------------------------------------------------------
+  bool core::get_txpool_backlog_histogram(std::vector<tx_backlog_fee_bucket>& histogram, bool include_sensitive_txes) const
+  {
+    m_mempool.get_transaction_backlog_histogram(histogram, include_sensitive_txes);
+    return true;
+  }
+  //-----------------------------------------------------------------------------------------------
   bool core::get_transactions(const std::vector<crypto::hash>& txs_ids, std::vector<transaction>& txs, std::vector<crypto::hash>& missed_txs, bool pruned) const
   {
     return m_blockchain_storage.get_transactions(txs_ids, txs, missed_txs, pruned);
@@ -517,6 +563,7 @@ namespace cryptonote
 
     folder /= db->get_db_name();
     MGINFO("Loading blockchain from folder " << folder.string() << " ...");
+    TIME_MEASURE_START(db_open_time);
 
     const std::string filename = folder.string();
     // default to fast:async:1 if overridden
@@ -611,15 +658,26 @@ namespace cryptonote
       if (db_salvage)
         db_flags |= DBF_SALVAGE;
 
+      // the writer adds key images the replica's filter would never see, so replicas look them all up
+      if (m_rpc_replica)
+        db_flags = DBF_RDONLY;
+      db->set_spent_key_filter_size(m_rpc_replica ? 0 : command_line::get_arg(vm, cryptonote::arg_db_spent_key_filter_size));
+      db->set_undo_log_depth(command_line::get_arg(vm, cryptonote::arg_db_undo_log_depth));
       db->open(filename, db_flags);
       if(!db->m_open)
         return false;
+      if (m_rpc_replica && db->height() == 0)
+      {
+        LOG_ERROR("An RPC replica needs a database already written by another monerod, none found in " << filename);
+        return false;
+      }
     }
     catch (const DB_ERROR& e)
     {
       LOG_ERROR("Error opening database: " << e.what());
       return false;
     }
+    TIME_MEASURE_FINISH(db_open_time);
 
     m_blockchain_storage.set_user_options(blocks_threads,
         sync_on_blocks, sync_threshold, sync_mode, fast_sync);
@@ -673,30 +731,44 @@ namespace cryptonote
       0
     };
     const difficulty_type fixed_difficulty = command_line::get_arg(vm, arg_fixed_difficulty);
+    TIME_MEASURE_START(blockchain_init_time);
     r = m_blockchain_storage.init(db.release(), m_nettype, m_offline, regtest ? &regtest_test_options : test_options, fixed_difficulty, get_checkpoints);
     CHECK_AND_ASSERT_MES(r, false, "Failed to initialize blockchain storage");
+    TIME_MEASURE_FINISH(blockchain_init_time);
 
+    TIME_MEASURE_START(txpool_init_time);
     r = m_mempool.init(max_txpool_weight, m_nettype == FAKECHAIN);
     CHECK_AND_ASSERT_MES(r, false, "Failed to initialize memory pool");
 
     // now that we have a valid m_blockchain_storage, we can clean out any
     // transactions in the pool that do not conform to the current fork
-    m_mempool.validate(m_blockchain_storage.get_current_hard_fork_version());
+    if (!m_rpc_replica)
+      m_mempool.validate(m_blockchain_storage.get_current_hard_fork_version());
+    m_replica_txpool_count = m_blockchain_storage.get_txpool_tx_count(true);
+    TIME_MEASURE_FINISH(txpool_init_time);
 
     bool show_time_stats = command_line::get_arg(vm, arg_show_time_stats) != 0;
     m_blockchain_storage.set_show_time_stats(show_time_stats);
+    m_blockchain_storage.set_sync_pow_dataset(command_line::get_arg(vm, arg_sync_pow_dataset));
     CHECK_AND_ASSERT_MES(r, false, "Failed to initialize blockchain storage");
 
     block_sync_size = command_line::get_arg(vm, arg_block_sync_size);
     if (block_sync_size > BLOCKS_SYNCHRONIZING_MAX_COUNT)
       MERROR("Error --block-sync-size cannot be greater than " << BLOCKS_SYNCHRONIZING_MAX_COUNT);
+    m_sync_pipeline_memory_budget = command_line::get_arg(vm, arg_block_sync_pipeline_memory);
 
     MGINFO("Loading checkpoints");
+    TIME_MEASURE_START(checkpoints_time);
 
     // load json & DNS checkpoints, and verify them
     // with respect to what blocks we already have
+    // a replica leaves checkpoint enforcement (which may pop blocks) to the writer
     const bool skip_dns_checkpoints = !command_line::get_arg(vm, arg_dns_checkpoints);
-    CHECK_AND_ASSERT_MES(update_checkpoints(skip_dns_checkpoints), false, "One or more checkpoints loaded from json or dns conflicted with existing checkpoints.");
+    if (!m_rpc_replica)
+      CHECK_AND_ASSERT_MES(update_checkpoints(skip_dns_checkpoints), false, "One or more checkpoints loaded from json or dns conflicted with existing checkpoints.");
+    TIME_MEASURE_FINISH(checkpoints_time);
+    MGINFO("Startup phases: database open " << db_open_time << " ms, blockchain " << blockchain_init_time << " ms, txpool "
+        << txpool_init_time << " ms, checkpoints " << checkpoints_time << " ms");
 
    // DNS versions checking
     if (check_updates_string == "disabled" || not allow_dns)
@@ -718,7 +790,11 @@ namespace cryptonote
     if (!keep_alt_blocks && !m_blockchain_storage.get_db().is_read_only())
       m_blockchain_storage.get_db().drop_alt_blocks();
 
-    if (prune_blockchain)
+    if (prune_blockchain && m_rpc_replica)
+    {
+      MWARNING("Ignoring --" << arg_prune_blockchain.name << " on an RPC replica, the writer prunes the database");
+    }
+    else if (prune_blockchain)
     {
       // display a message if the blockchain is not pruned yet
       if (!m_blockchain_storage.get_blockchain_pruning_seed())
@@ -797,7 +873,8 @@ namespace cryptonote
     bool r;
     if (tx_blob.prunable_hash == crypto::null_hash)
     {
-      r = parse_tx_from_blob(tx, tx_hash, tx_blob.blob);
+      // the prunable part is only decoded in handle_incoming_tx_post, for txes we do not have yet
+      r = parse_tx_base_lazily_from_blob(tx_blob.blob, tx) && get_transaction_hash(tx, tx_hash);
     }
     else
     {
@@ -846,6 +923,13 @@ namespace cryptonote
   //-----------------------------------------------------------------------------------------------
   bool core::handle_incoming_tx_post(const tx_blob_entry& tx_blob, tx_verification_context& tvc, cryptonote::transaction &tx, crypto::hash &tx_hash)
   {
+    if (tx_blob.prunable_hash == crypto::null_hash && !expand_tx_prunable_from_blob(tx_blob.blob, tx))
+    {
+      LOG_PRINT_L1("WRONG TRANSACTION BLOB, Failed to parse " << tx_hash << ", rejected");
+      tvc.m_verifivation_failed = true;
+      return false;
+    }
+
     if(!check_tx_syntax(tx))
     {
       LOG_PRINT_L1("WRONG TRANSACTION BLOB, Failed to check tx " << tx_hash << " syntax, rejected");
@@ -889,6 +973,7 @@ namespace cryptonote
     }
 
     std::vector<const rct::rctSig*> rvv;
+    std::vector<size_t> rvv_tx_info_index;
     for (size_t n = 0; n < tx_info.size(); ++n)
     {
       if (!check_tx_semantic(*tx_info[n].tx, keeped_by_block))
@@ -941,7 +1026,10 @@ namespace cryptonote
             tx_info[n].result = false;
             break;
           }
+          if (keeped_by_block && take_sync_pipeline_verified(tx_info[n].tx_hash))
+            break; // already verified while an earlier block was being added
           rvv.push_back(&rv); // delayed batch verification
+          rvv_tx_info_index.push_back(n);
           break;
         default:
           MERROR_VER("Unknown rct type: " << rv.type);
@@ -953,27 +1041,139 @@ namespace cryptonote
     }
     if (!rvv.empty() && !rct::verRctSemanticsSimple(rvv))
     {
-      LOG_PRINT_L1("One transaction among this group has bad semantics, verifying one at a time");
+      // bisect rather than re-verify one at a time, so a few bad txes can't force a batch back to O(n) single checks
+      LOG_PRINT_L1("One transaction among this group has bad semantics, bisecting the group to find it");
       ret = false;
-      const bool assumed_bad = rvv.size() == 1; // if there's only one tx, it must be the bad one
-      for (size_t n = 0; n < tx_info.size(); ++n)
+      for (const size_t failed: rct::findRctSemanticsSimpleFailures(rvv, true))
       {
-        if (!tx_info[n].result)
-          continue;
-        if (tx_info[n].tx->rct_signatures.type != rct::RCTTypeBulletproof && tx_info[n].tx->rct_signatures.type != rct::RCTTypeBulletproof2 && tx_info[n].tx->rct_signatures.type != rct::RCTTypeCLSAG)
-          continue;
-        if (assumed_bad || !rct::verRctSemanticsSimple(tx_info[n].tx->rct_signatures))
-        {
-          set_semantics_failed(tx_info[n].tx_hash);
-          tx_info[n].tvc.m_verifivation_failed = true;
-          tx_info[n].result = false;
-        }
+        const size_t n = rvv_tx_info_index[failed];
+        set_semantics_failed(tx_info[n].tx_hash);
+        tx_info[n].tvc.m_verifivation_failed = true;
+        tx_info[n].result = false;
       }
     }
 
     return ret;
   }
   //-----------------------------------------------------------------------------------------------
+  void core::start_sync_pipeline(const std::vector<block_complete_entry> &blocks_entry)
+  {
+    stop_sync_pipeline();
+    if (m_sync_pipeline_memory_budget == 0 || blocks_entry.size() < 2)
+      return;
+    if (get_blockchain_storage().is_within_compiled_block_hash_area())
+      return; // semantics are not checked there anyway
+
+    boost::unique_lock<boost::mutex> lock(m_sync_pipeline_lock);
+    m_sync_pipeline_blocks = &blocks_entry;
+    m_sync_pipeline_next = 0;
+    m_sync_pipeline_added = 0;
+    m_sync_pipeline_sizes.clear();
+    m_sync_pipeline_bytes = 0;
+    m_sync_pipeline_waiter.reset(new tools::threadpool::waiter(tools::threadpool::getInstance()));
+  }
+  //-----------------------------------------------------------------------------------------------
+  void core::advance_sync_pipeline(bool consumed)
+  {
+    std::vector<const block_complete_entry*> to_verify;
+    tools::threadpool::waiter *waiter;
+    tools::threadpool &tpool = tools::threadpool::getInstance();
+
+    boost::unique_lock<boost::mutex> lock(m_sync_pipeline_lock);
+    if (!m_sync_pipeline_blocks)
+      return;
+    const std::vector<block_complete_entry> &blocks_entry = *m_sync_pipeline_blocks;
+
+    // blocks being added have had their txes handled already, their budget is free again
+    if (consumed)
+      ++m_sync_pipeline_added;
+    while (!m_sync_pipeline_sizes.empty() && m_sync_pipeline_next - m_sync_pipeline_sizes.size() < m_sync_pipeline_added)
+    {
+      m_sync_pipeline_bytes -= m_sync_pipeline_sizes.front();
+      m_sync_pipeline_sizes.pop_front();
+    }
+
+    // the first block's txes are handled right away, so there is nothing to gain there,
+    // and there's no point in queueing more blocks than the threadpool can work on at once
+    const size_t max_ahead = std::max<size_t>(1, tpool.get_max_concurrency());
+    m_sync_pipeline_next = std::max(m_sync_pipeline_next, std::max<size_t>(m_sync_pipeline_added, 1));
+    while (m_sync_pipeline_next < blocks_entry.size() && m_sync_pipeline_sizes.size() < max_ahead)
+    {
+      const block_complete_entry &block_entry = blocks_entry[m_sync_pipeline_next];
+      size_t bytes = 0;
+      for (const tx_blob_entry &tx_blob: block_entry.txs)
+        bytes += tx_blob.blob.size();
+      if (!m_sync_pipeline_sizes.empty() && m_sync_pipeline_bytes + bytes > m_sync_pipeline_memory_budget)
+        break;
+
+      m_sync_pipeline_sizes.push_back(bytes);
+      m_sync_pipeline_bytes += bytes;
+      ++m_sync_pipeline_next;
+      if (!block_entry.txs.empty())
+        to_verify.push_back(&block_entry);
+    }
+    waiter = m_sync_pipeline_waiter.get();
+    lock.unlock();
+
+    // the tasks take the lock themselves, and may run inline here
+    // the waiter stays valid: only stop_sync_pipeline(), on this same sync thread, releases it
+    for (const block_complete_entry *block_entry: to_verify)
+      tpool.submit(waiter, [this, block_entry] { verify_sync_pipeline_block(*block_entry); });
+  }
+  //-----------------------------------------------------------------------------------------------
+  void core::stop_sync_pipeline()
+  {
+    std::unique_ptr<tools::threadpool::waiter> waiter;
+    {
+      boost::unique_lock<boost::mutex> lock(m_sync_pipeline_lock);
+      waiter = std::move(m_sync_pipeline_waiter);
+      m_sync_pipeline_blocks = NULL;
+    }
+    if (waiter)
+      waiter->wait();
+
+    boost::unique_lock<boost::mutex> lock(m_sync_pipeline_lock);
+    m_sync_pipeline_sizes.clear();
+    m_sync_pipeline_bytes = 0;
+    m_sync_pipeline_verified.clear();
+  }
+  //-----------------------------------------------------------------------------------------------
+  void core::verify_sync_pipeline_block(const block_complete_entry &block_entry)
+  {
+    // only the context free, expensive part: the rest is cheap, or needs the chain up to this block
+    std::vector<transaction> txes(block_entry.txs.size());
+    std::vector<crypto::hash> tx_hashes;
+    std::vector<const rct::rctSig*> rvv;
+    for (size_t n = 0; n < block_entry.txs.size(); ++n)
+    {
+      const tx_blob_entry &tx_blob = block_entry.txs[n];
+      if (tx_blob.prunable_hash != crypto::null_hash)
+        continue; // no prunable data to verify
+      crypto::hash tx_hash;
+      if (!parse_tx_from_blob(txes[n], tx_hash, tx_blob.blob) || txes[n].version < 2)
+        continue;
+      const rct::rctSig &rv = txes[n].rct_signatures;
+      if ((rv.type != rct::RCTTypeBulletproof && rv.type != rct::RCTTypeBulletproof2 && rv.type != rct::RCTTypeCLSAG) ||
+          !is_canonical_bulletproof_layout(rv.p.bulletproofs))
+        continue;
+      tx_hashes.push_back(tx_hash);
+      rvv.push_back(&rv);
+    }
+
+    // on failure, the txes are verified again as the block is added, where the culprit is found
+    if (rvv.empty() || !rct::verRctSemanticsSimple(rvv))
+      return;
+
+    boost::unique_lock<boost::mutex> lock(m_sync_pipeline_lock);
+    m_sync_pipeline_verified.insert(tx_hashes.begin(), tx_hashes.end());
+  }
+  //-----------------------------------------------------------------------------------------------
+  bool core::take_sync_pipeline_verified(const crypto::hash &tx_hash)
+  {
+    boost::unique_lock<boost::mutex> lock(m_sync_pipeline_lock);
+    return m_sync_pipeline_verified.erase(tx_hash) != 0;
+  }
+  //-----------------------------------------------------------------------------------------------
   bool core::handle_incoming_txs(const epee::span<const tx_blob_entry> tx_blobs, epee::span<tx_verification_context> tvc, relay_method tx_relay, bool relayed)
   {
     TRY_ENTRY();
@@ -984,6 +1184,23 @@ namespace cryptonote
       return false;
     }
 
+    if (m_rpc_replica)
+    {
+      MERROR("Transactions cannot be added on a read-only RPC replica");
+      for (tx_verification_context &tvc_entry : tvc)
+      {
+        tvc_entry = {};
+        tvc_entry.m_verifivation_failed = true;
+      }
+      return false;
+    }
+
+    incoming_tx_batch_size.add(tx_blobs.size());
+    const uint64_t start_ns = epee::misc_utils::get_ns_count();
+    const auto record_time = epee::misc_utils::create_scope_leave_handler([start_ns]() {
+      incoming_tx_batch_seconds.add(epee::misc_utils::get_ns_count() - start_ns);
+    });
+
     std::vector<txpool_event> results(tx_blobs.size());
 
     CRITICAL_REGION_LOCAL(m_incoming_tx_lock);
@@ -1178,11 +1395,7 @@ namespace cryptonote
   //-----------------------------------------------------------------------------------------------
   bool core::are_key_images_spent(const std::vector<crypto::key_image>& key_im, std::vector<bool> &spent) const
   {
-    spent.clear();
-    for(auto& ki: key_im)
-    {
-      spent.push_back(m_blockchain_storage.have_tx_keyimg_as_spent(ki));
-    }
+    m_blockchain_storage.have_tx_keyimgs_as_spent(epee::to_span(key_im), spent);
     return true;
   }
   //-----------------------------------------------------------------------------------------------
@@ -1192,10 +1405,8 @@ namespace cryptonote
     size_t res = 0;
     if (block_sync_size > 0)
       res = block_sync_size;
-    else if (height >= quick_height)
-      res = BLOCKS_SYNCHRONIZING_DEFAULT_COUNT;
     else
-      res = BLOCKS_SYNCHRONIZING_DEFAULT_COUNT_PRE_V4;
+      res = m_blockchain_storage.get_sync_batch_blocks(height >= quick_height ? BLOCKS_SYNCHRONIZING_DEFAULT_COUNT : BLOCKS_SYNCHRONIZING_DEFAULT_COUNT_PRE_V4);
 
     static size_t max_block_size = 0;
     if (max_block_size == 0)
@@ -1468,6 +1679,12 @@ namespace cryptonote
   bool core::handle_block_found(block& b, block_verification_context &bvc)
   {
     bvc = {};
+    if (m_rpc_replica)
+    {
+      MERROR("Blocks cannot be added on a read-only RPC replica");
+      bvc.m_verifivation_failed = true;
+      return false;
+    }
     m_miner.pause();
     std::vector<block_complete_entry> blocks;
     try
@@ -1527,6 +1744,8 @@ namespace cryptonote
   //-----------------------------------------------------------------------------------------------
   void core::on_synchronized()
   {
+    // a running miner keeps using the dataset, and frees it when it stops
+    m_blockchain_storage.set_sync_pow_dataset(false, !m_miner.is_mining());
     m_miner.on_synchronized();
   }
   //-----------------------------------------------------------------------------------------------
@@ -1549,6 +1768,8 @@ namespace cryptonote
       cleanup_handle_incoming_blocks(false);
       return false;
     }
+    start_sync_pipeline(blocks_entry);
+    advance_sync_pipeline(false);
     return true;
   }
 
@@ -1556,6 +1777,7 @@ namespace cryptonote
   bool core::cleanup_handle_incoming_blocks(bool force_sync)
   {
     bool success = false;
+    stop_sync_pipeline();
     try {
       success = m_blockchain_storage.cleanup_handle_incoming_blocks(force_sync);
     }
@@ -1571,6 +1793,9 @@ namespace cryptonote
 
     bvc = {};
 
+    // txes of the next blocks can be verified while this one is added
+    advance_sync_pipeline(true);
+
     if (!check_incoming_block_size(block_blob))
     {
       bvc.m_verifivation_failed = true;
@@ -1678,6 +1903,11 @@ namespace cryptonote
     return m_mempool.get_transaction(id, tx, tx_category);
   }  
   //-----------------------------------------------------------------------------------------------
+  std::shared_ptr<const txpool_parsed_tx> core::get_pool_parsed_transaction(const crypto::hash &id, relay_category tx_category) const
+  {
+    return m_mempool.get_parsed_transaction(id, tx_category);
+  }
+  //-----------------------------------------------------------------------------------------------
   bool core::pool_has_tx(const crypto::hash &id) const
   {
     return m_mempool.have_tx(id, relay_category::legacy);
@@ -1724,12 +1954,28 @@ namespace cryptonote
     return true;
   }
   //-----------------------------------------------------------------------------------------------
+  bool core::log_spent_key_filter_stats()
+  {
+    key_image_filter_stats stats;
+    if (!m_blockchain_storage.get_db().get_spent_key_filter_stats(stats) || stats.lookups == 0)
+      return true;
+
+    MINFO("Spent key image filter: " << stats.num_keys << " key images in " << stats.memory_bytes / (1024 * 1024) << " MB, "
+        << stats.lookups << " lookups, " << stats.negatives << " answered without the database, false positive rate "
+        << stats.false_positive_rate() * 100 << "%, average lookup "
+        << (stats.filter_samples ? stats.filter_ns / stats.filter_samples : 0) << " ns in the filter, "
+        << (stats.db_samples ? stats.db_ns / stats.db_samples : 0) << " ns in the database");
+    return true;
+  }
+  //-----------------------------------------------------------------------------------------------
   bool core::on_idle()
   {
     if(!m_starter_message_showed)
     {
       std::string main_message;
-      if (m_offline)
+      if (m_rpc_replica)
+        main_message = "The daemon is a read-only RPC replica, following the database of another daemon.";
+      else if (m_offline)
         main_message = "The daemon is running offline and will not attempt to sync to the Monero network.";
       else
         main_message = "The daemon will start synchronizing with the network. This may take a long time to complete.";
@@ -1745,12 +1991,20 @@ namespace cryptonote
       m_starter_message_showed = true;
     }
 
+    // a replica writes nothing: all the periodic work below belongs to the writer
+    if (m_rpc_replica)
+    {
+      update_replica();
+      return true;
+    }
+
     relay_txpool_transactions(); // txpool handles periodic DB checking
     m_check_updates_interval.do_call(boost::bind(&core::check_updates, this));
     m_check_disk_space_interval.do_call(boost::bind(&core::check_disk_space, this));
     m_block_rate_interval.do_call(boost::bind(&core::check_block_rate, this));
     m_blockchain_pruning_interval.do_call(boost::bind(&core::update_blockchain_pruning, this));
     m_diff_recalc_interval.do_call(boost::bind(&core::recalculate_difficulties, this));
+    m_spent_key_filter_stats_interval.do_call(boost::bind(&core::log_spent_key_filter_stats, this));
     m_miner.on_idle();
     m_mempool.on_idle();
     return true;
@@ -1906,6 +2160,24 @@ namespace cryptonote
     return true;
   }
   //-----------------------------------------------------------------------------------------------
+  void core::update_replica()
+  {
+    try
+    {
+      const bool new_top = m_blockchain_storage.update_from_db();
+      const uint64_t txpool_count = m_blockchain_storage.get_txpool_tx_count(true);
+      if (new_top || txpool_count != m_replica_txpool_count)
+      {
+        m_mempool.reload_from_db();
+        m_replica_txpool_count = txpool_count;
+      }
+    }
+    catch (const std::exception &e)
+    {
+      MERROR("Failed to follow the database: " << e.what());
+    }
+  }
+  //-----------------------------------------------------------------------------------------------
   bool core::check_disk_space()
   {
     uint64_t free_space = get_free_space();
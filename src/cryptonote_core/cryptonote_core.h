@@ -31,6 +31,8 @@
 #pragma once
 
 #include <ctime>
+#include <deque>
+#include <memory>
 
 #include <boost/function.hpp>
 #include <boost/program_options/options_description.hpp>
@@ -43,6 +45,7 @@
 #include "storages/portable_storage_template_helper.h"
 #include "common/download.h"
 #include "common/command_line.h"
+#include "common/threadpool.h"
 #include "tx_pool.h"
 #include "blockchain.h"
 #include "cryptonote_basic/miner.h"
@@ -70,8 +73,10 @@ namespace cryptonote
   extern const command_line::arg_descriptor<bool, false> arg_regtest_on;
   extern const command_line::arg_descriptor<difficulty_type> arg_fixed_difficulty;
   extern const command_line::arg_descriptor<bool> arg_offline;
+  extern const command_line::arg_descriptor<bool> arg_rpc_replica;
   extern const command_line::arg_descriptor<size_t> arg_block_download_max_size;
   extern const command_line::arg_descriptor<bool> arg_sync_pruned_blocks;
+  extern const command_line::arg_descriptor<bool> arg_no_sync_compression;
 
   /************************************************************************/
   /*                                                                      */
@@ -494,6 +499,14 @@ namespace cryptonote
       * @note see tx_memory_pool::get_txpool_backlog
       */
      bool get_txpool_backlog(std::vector<tx_backlog_entry>& backlog, bool include_sensitive_txes = false) const;
+
+     /**
+      * @copydoc tx_memory_pool::get_transaction_backlog_histogram
+      * @param include_sensitive_txes include private transactions
+      *
+      * @note see tx_memory_pool::get_transaction_backlog_histogram
+      */
+     bool get_txpool_backlog_histogram(std::vector<tx_backlog_fee_bucket>& histogram, bool include_sensitive_txes = false) const;
      
      /**
       * @copydoc tx_memory_pool::get_transactions
@@ -518,6 +531,13 @@ namespace cryptonote
       */
      bool get_pool_transaction(const crypto::hash& id, cryptonote::blobdata& tx, relay_category tx_category) const;
 
+     /**
+      * @copydoc tx_memory_pool::get_parsed_transaction
+      *
+      * @note see tx_memory_pool::get_parsed_transaction
+      */
+     std::shared_ptr<const txpool_parsed_tx> get_pool_parsed_transaction(const crypto::hash& id, relay_category tx_category) const;
+
      /**
       * @copydoc tx_memory_pool::get_pool_transactions_and_spent_keys_info
       * @param include_sensitive_txes include private transactions
@@ -832,6 +852,17 @@ namespace cryptonote
       */
      bool offline() const { return m_offline; }
 
+     /**
+      * @brief get whether the core is a read-only RPC replica
+      *
+      * A replica opens a database written by another daemon read only,
+      * follows that daemon's commits, and never adds blocks or transactions
+      * itself.
+      *
+      * @return whether the core is a read-only RPC replica
+      */
+     bool rpc_replica() const { return m_rpc_replica; }
+
      /**
       * @brief get the blockchain pruning seed
       *
@@ -982,6 +1013,44 @@ namespace cryptonote
      struct tx_verification_batch_info { const cryptonote::transaction *tx; crypto::hash tx_hash; tx_verification_context &tvc; bool &result; };
      bool handle_incoming_tx_accumulated_batch(std::vector<tx_verification_batch_info> &tx_info, bool keeped_by_block);
 
+     /**
+      * @brief starts verifying the rct semantics of upcoming blocks' txes in the background
+      *
+      * While block k is added, the txes of blocks k+1.. are checked on the
+      * threadpool, bounded by the sync pipeline memory budget.
+      *
+      * @param blocks_entry the blocks about to be added, must outlive stop_sync_pipeline()
+      */
+     void start_sync_pipeline(const std::vector<block_complete_entry> &blocks_entry);
+
+     /**
+      * @brief schedules more blocks of the sync pipeline, if within budget
+      *
+      * @param consumed whether the next block is now being added
+      */
+     void advance_sync_pipeline(bool consumed);
+
+     /**
+      * @brief waits for background verification to finish and forgets its results
+      */
+     void stop_sync_pipeline();
+
+     /**
+      * @brief verifies the rct semantics of one block's txes, remembering them if they pass
+      *
+      * @param block_entry the block whose txes to check
+      */
+     void verify_sync_pipeline_block(const block_complete_entry &block_entry);
+
+     /**
+      * @brief checks, and forgets, whether a tx's rct semantics were verified by the sync pipeline
+      *
+      * @param tx_hash the hash of the tx
+      *
+      * @return true if the tx was verified ahead of time
+      */
+     bool take_sync_pipeline_verified(const crypto::hash &tx_hash);
+
      /**
       * @copydoc miner::on_block_chain_update
       *
@@ -1042,6 +1111,15 @@ namespace cryptonote
       */
      bool check_updates();
 
+     /**
+      * @brief picks up what the writer committed since the last call, on an RPC replica
+      *
+      * Refreshes the blockchain's cached state when the top block changed,
+      * and reloads the pool when the top block or the number of pool
+      * transactions changed.
+      */
+     void update_replica();
+
      /**
       * @brief checks free disk space
       *
@@ -1063,6 +1141,13 @@ namespace cryptonote
       */
      bool recalculate_difficulties();
 
+     /**
+      * @brief logs how well the spent key image filter answers lookups
+      *
+      * @return true
+      */
+     bool log_spent_key_filter_stats();
+
      bool m_test_drop_download = true; //!< whether or not to drop incoming blocks (for testing)
 
      uint64_t m_test_drop_download_height = 0; //!< height under which to drop incoming blocks, if doing so
@@ -1088,6 +1173,7 @@ namespace cryptonote
      epee::math_helper::once_a_time_seconds<90, false> m_block_rate_interval; //!< interval for checking block rate
      epee::math_helper::once_a_time_seconds<60*60*5, true> m_blockchain_pruning_interval; //!< interval for incremental blockchain pruning
      epee::math_helper::once_a_time_seconds<60*60*24*7, false> m_diff_recalc_interval; //!< interval for recalculating difficulties
+     epee::math_helper::once_a_time_seconds<60*60, false> m_spent_key_filter_stats_interval; //!< interval for logging spent key filter stats
 
      std::atomic<bool> m_starter_message_showed; //!< has the "daemon will sync now" message been shown?
 
@@ -1111,6 +1197,16 @@ namespace cryptonote
      std::unordered_set<crypto::hash> bad_semantics_txes[2];
      boost::mutex bad_semantics_txes_lock;
 
+     size_t m_sync_pipeline_memory_budget; //!< max bytes of tx blobs verified ahead of the block being added
+     const std::vector<block_complete_entry> *m_sync_pipeline_blocks; //!< blocks being added, or NULL
+     size_t m_sync_pipeline_next; //!< index of the next block to schedule
+     size_t m_sync_pipeline_added; //!< number of blocks handed to handle_incoming_block so far
+     std::deque<size_t> m_sync_pipeline_sizes; //!< tx blob bytes of scheduled blocks not yet added
+     size_t m_sync_pipeline_bytes; //!< sum of m_sync_pipeline_sizes
+     std::unique_ptr<tools::threadpool::waiter> m_sync_pipeline_waiter;
+     std::unordered_set<crypto::hash> m_sync_pipeline_verified; //!< txes with rct semantics verified ahead
+     boost::mutex m_sync_pipeline_lock;
+
      enum {
        UPDATES_DISABLED,
        UPDATES_NOTIFY,
@@ -1124,6 +1220,8 @@ namespace cryptonote
 
      bool m_fluffy_blocks_enabled;
      bool m_offline;
+     bool m_rpc_replica;
+     uint64_t m_replica_txpool_count; //!< pool size in the db when the replica last loaded the pool
 
     /* `boost::function` is used because the implementation never allocates if
        the callable object has a single `std::shared_ptr` or `std::weap_ptr`
@@ -727,4 +727,14 @@ namespace cryptonote
   {
     rx_reorg(split_height);
   }
+
+  void prepare_block_longhash_seed(const uint64_t seed_height, const crypto::hash& seed_hash, const int threads)
+  {
+    rx_set_next_seedhash(seed_height, seed_hash.data, threads);
+  }
+
+  void release_block_longhash_dataset()
+  {
+    rx_stop_mining();
+  }
 }
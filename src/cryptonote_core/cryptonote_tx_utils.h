@@ -148,6 +148,8 @@ namespace cryptonote
     const uint64_t seed_height, const crypto::hash& seed_hash);
   crypto::hash get_block_longhash(const Blockchain *pb, const block& b, const uint64_t height, const int miners);
   void get_block_longhash_reorg(const uint64_t split_height);
+  void prepare_block_longhash_seed(const uint64_t seed_height, const crypto::hash& seed_hash, const int threads);
+  void release_block_longhash_dataset();
 
 }
 
@@ -0,0 +1,100 @@
+// Copyright (c) 2021, The Monero Project
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of
+//    conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list
+//    of conditions and the following disclaimer in the documentation and/or other
+//    materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be
+//    used to endorse or promote products derived from this software without specific
+//    prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+// THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <boost/thread/lock_guard.hpp>
+
+#include "output_lookup_cache.h"
+
+namespace cryptonote
+{
+
+//------------------------------------------------------------------
+output_lookup_cache::output_lookup_cache(size_t max_entries):
+  m_max_entries(max_entries),
+  m_hits(0),
+  m_misses(0)
+{
+}
+//------------------------------------------------------------------
+bool output_lookup_cache::get(uint64_t amount, uint64_t index, bool need_txid, cached_output &out)
+{
+  boost::lock_guard<boost::mutex> lock(m_lock);
+  const auto i = m_entries.find({amount, index});
+  if (i == m_entries.end() || (need_txid && !i->second->second.has_txid))
+  {
+    ++m_misses;
+    return false;
+  }
+  m_lru.splice(m_lru.begin(), m_lru, i->second);
+  out = i->second->second;
+  ++m_hits;
+  return true;
+}
+//------------------------------------------------------------------
+void output_lookup_cache::put(uint64_t amount, uint64_t index, const cached_output &out)
+{
+  if (m_max_entries == 0)
+    return;
+  boost::lock_guard<boost::mutex> lock(m_lock);
+  const key_t key{amount, index};
+  const auto i = m_entries.find(key);
+  if (i != m_entries.end())
+  {
+    i->second->second = out;
+    m_lru.splice(m_lru.begin(), m_lru, i->second);
+    return;
+  }
+  if (m_entries.size() >= m_max_entries)
+  {
+    m_entries.erase(m_lru.back().first);
+    m_lru.pop_back();
+  }
+  m_lru.emplace_front(key, out);
+  m_entries.emplace(key, m_lru.begin());
+}
+//------------------------------------------------------------------
+void output_lookup_cache::clear()
+{
+  boost::lock_guard<boost::mutex> lock(m_lock);
+  m_entries.clear();
+  m_lru.clear();
+}
+//------------------------------------------------------------------
+uint64_t output_lookup_cache::get_hits() const
+{
+  boost::lock_guard<boost::mutex> lock(m_lock);
+  return m_hits;
+}
+//------------------------------------------------------------------
+uint64_t output_lookup_cache::get_misses() const
+{
+  boost::lock_guard<boost::mutex> lock(m_lock);
+  return m_misses;
+}
+
+}
@@ -0,0 +1,109 @@
+// Copyright (c) 2021, The Monero Project
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of
+//    conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list
+//    of conditions and the following disclaimer in the documentation and/or other
+//    materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be
+//    used to endorse or promote products derived from this software without specific
+//    prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+// THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <boost/thread/mutex.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <unordered_map>
+
+#include "blockchain_db/blockchain_db.h"
+
+namespace cryptonote
+{
+  /**
+   * @brief an output as served to get_outs, with the txid when it was looked up
+   */
+  struct cached_output
+  {
+    output_data_t data;
+    crypto::hash txid;
+    bool has_txid;
+  };
+
+  /**
+   * @brief a bounded LRU cache of outputs by (amount, global index)
+   *
+   * Decoy selection heavily favours recent outputs, so the same few
+   * thousands of outputs are asked for over and over by wallets.  Outputs
+   * are immutable once in the chain, but a popped block can take some away
+   * and a later block reuse their indices, so the cache has to be cleared
+   * whenever blocks are popped.  Thread safe.
+   */
+  class output_lookup_cache
+  {
+  public:
+    /**
+     * @param max_entries the number of outputs kept at most
+     */
+    explicit output_lookup_cache(size_t max_entries);
+
+    /**
+     * @brief looks an output up, making it the most recently used
+     *
+     * @param need_txid whether an entry without a txid counts as a miss
+     *
+     * @return true if found, false otherwise
+     */
+    bool get(uint64_t amount, uint64_t index, bool need_txid, cached_output &out);
+
+    /**
+     * @brief adds or replaces an output, evicting the least recently used if full
+     */
+    void put(uint64_t amount, uint64_t index, const cached_output &out);
+
+    void clear();
+
+    uint64_t get_hits() const;
+    uint64_t get_misses() const;
+
+  private:
+    struct key_t
+    {
+      uint64_t amount;
+      uint64_t index;
+      bool operator==(const key_t &other) const { return amount == other.amount && index == other.index; }
+    };
+    struct key_hash
+    {
+      size_t operator()(const key_t &k) const { return std::hash<uint64_t>()(k.index * 0x9e3779b97f4a7c15ull ^ k.amount); }
+    };
+    typedef std::list<std::pair<key_t, cached_output>> lru_list;
+
+    const size_t m_max_entries;
+
+    mutable boost::mutex m_lock;
+    lru_list m_lru; //!< most recently used first
+    std::unordered_map<key_t, lru_list::iterator, key_hash> m_entries;
+    uint64_t m_hits;
+    uint64_t m_misses;
+  };
+}
@@ -0,0 +1,261 @@
+// Copyright (c) 2021, The Monero Project
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of
+//    conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list
+//    of conditions and the following disclaimer in the documentation and/or other
+//    materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be
+//    used to endorse or promote products derived from this software without specific
+//    prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+// THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+#include "misc_log_ex.h"
+#include "common/perf_timer.h"
+#include "common/threadpool.h"
+#include "device/device.hpp"
+#include "ringct/rctSigs.h"
+#include "ring_signature_batch.h"
+
+#undef MONERO_DEFAULT_LOG_CATEGORY
+#define MONERO_DEFAULT_LOG_CATEGORY "verify"
+
+namespace cryptonote
+{
+
+//------------------------------------------------------------------
+void v1_ring_signature_checks::add(const crypto::hash &owner, const crypto::hash &tx_prefix_hash, const crypto::key_image &key_image,
+    std::vector<rct::ctkey> &&pubkeys, const std::vector<crypto::signature> &signatures)
+{
+  m_checks.push_back({owner, tx_prefix_hash, key_image, std::move(pubkeys), &signatures});
+}
+//------------------------------------------------------------------
+void v1_ring_signature_checks::verify_range(const size_t begin, const size_t end, std::vector<uint8_t> &results) const
+{
+  // one batched call for the range, so the rings share point decompression and compression
+  std::vector<const crypto::public_key *> p_output_keys;
+  std::vector<crypto::ring_signature_check> sig_checks;
+  std::vector<size_t> check_indices;
+  for (size_t i = begin; i < end; ++i)
+  {
+    const check &c = m_checks[i];
+    results[i] = 0;
+    if (c.signatures->size() != c.pubkeys.size())
+      continue;
+
+    for (const rct::ctkey &key : c.pubkeys)
+    {
+      // rct::key and crypto::public_key have the same structure, avoid object ctor/memcpy
+      p_output_keys.push_back(&(const crypto::public_key&)key.dest);
+    }
+    check_indices.push_back(i);
+  }
+
+  // p_output_keys is complete now, so pointers into it stay valid
+  size_t offset = 0;
+  for (const size_t i : check_indices)
+  {
+    const check &c = m_checks[i];
+    sig_checks.push_back({&c.tx_prefix_hash, &c.key_image, p_output_keys.data() + offset, c.pubkeys.size(), c.signatures->data()});
+    offset += c.pubkeys.size();
+  }
+
+  std::unique_ptr<bool[]> valid(new bool[sig_checks.size()]);
+  crypto::check_ring_signatures(sig_checks.data(), sig_checks.size(), valid.get());
+  for (size_t n = 0; n < check_indices.size(); ++n)
+    results[check_indices[n]] = valid[n] ? 1 : 0;
+}
+//------------------------------------------------------------------
+bool rct_ring_signature_checks::add(const crypto::hash &owner, const rct::rctSig &rv)
+{
+  CHECK_AND_ASSERT_MES(rv.type == rct::RCTTypeSimple || rv.type == rct::RCTTypeBulletproof || rv.type == rct::RCTTypeBulletproof2 || rv.type == rct::RCTTypeCLSAG,
+      false, "rct_ring_signature_checks::add called on non simple rctSig");
+  const rct::keyV &pseudoOuts = rct::is_rct_bulletproof(rv.type) ? rv.p.pseudoOuts : rv.pseudoOuts;
+  CHECK_AND_ASSERT_MES(pseudoOuts.size() == rv.mixRing.size(), false, "Mismatched sizes of pseudoOuts and mixRing");
+  const size_t n_sigs = rv.type == rct::RCTTypeCLSAG ? rv.p.CLSAGs.size() : rv.p.MGs.size();
+  CHECK_AND_ASSERT_MES(n_sigs == rv.mixRing.size(), false, "Mismatched sizes of ring signatures and mixRing");
+
+  rct::key message;
+  try
+  {
+    message = rct::get_pre_mlsag_hash(rv, hw::get_device("default"));
+  }
+  catch (const std::exception &e)
+  {
+    MERROR("Failed to get pre-MLSAG hash: " << e.what());
+    return false;
+  }
+
+  m_checks.reserve(m_checks.size() + n_sigs);
+  for (size_t i = 0; i < n_sigs; ++i)
+    m_checks.push_back({owner, message, &rv, i});
+  return true;
+}
+//------------------------------------------------------------------
+void rct_ring_signature_checks::verify_range(const size_t begin, const size_t end, std::vector<uint8_t> &results) const
+{
+  for (size_t i = begin; i < end; ++i)
+  {
+    const check &c = m_checks[i];
+    const rct::rctSig &rv = *c.rv;
+    const rct::key &pseudoOut = rct::is_rct_bulletproof(rv.type) ? rv.p.pseudoOuts[c.input] : rv.pseudoOuts[c.input];
+    try
+    {
+      if (rv.type == rct::RCTTypeCLSAG)
+        results[i] = rct::verRctCLSAGSimple(c.message, rv.p.CLSAGs[c.input], rv.mixRing[c.input], pseudoOut) ? 1 : 0;
+      else
+        results[i] = rct::verRctMGSimple(c.message, rv.p.MGs[c.input], rv.mixRing[c.input], pseudoOut) ? 1 : 0;
+    }
+    // we can get deep throws from ge_frombytes_vartime if input isn't valid
+    catch (const std::exception &e)
+    {
+      LOG_PRINT_L1("Error verifying ring signature for input " << c.input << ": " << e.what());
+      results[i] = 0;
+    }
+    catch (...)
+    {
+      results[i] = 0;
+    }
+  }
+}
+//------------------------------------------------------------------
+ring_signature_cache::ring_signature_cache(size_t max_entries):
+  m_max_entries(max_entries)
+{
+}
+//------------------------------------------------------------------
+crypto::hash ring_signature_cache::get_key(const crypto::hash &tx_hash, const rct::ctkeyM &mix_ring)
+{
+  std::string data(reinterpret_cast<const char*>(&tx_hash), sizeof(tx_hash));
+  for (const rct::ctkeyV &ring : mix_ring)
+    data.append(reinterpret_cast<const char*>(ring.data()), ring.size() * sizeof(rct::ctkey));
+  return crypto::cn_fast_hash(data.data(), data.size());
+}
+//------------------------------------------------------------------
+bool ring_signature_cache::has(const crypto::hash &key) const
+{
+  boost::lock_guard<boost::mutex> lock(m_lock);
+  return m_entries.find(key) != m_entries.end();
+}
+//------------------------------------------------------------------
+void ring_signature_cache::add(const crypto::hash &key)
+{
+  boost::lock_guard<boost::mutex> lock(m_lock);
+  if (m_max_entries == 0 || !m_entries.insert(key).second)
+    return;
+  m_order.push_back(key);
+  if (m_order.size() > m_max_entries)
+  {
+    m_entries.erase(m_order.front());
+    m_order.pop_front();
+  }
+}
+//------------------------------------------------------------------
+void ring_signature_cache::clear()
+{
+  boost::lock_guard<boost::mutex> lock(m_lock);
+  m_entries.clear();
+  m_order.clear();
+}
+//------------------------------------------------------------------
+void ring_signature_batch::add_check_set(std::unique_ptr<signature_check_set> checks)
+{
+  m_extra.push_back(std::move(checks));
+}
+//------------------------------------------------------------------
+std::vector<const signature_check_set*> ring_signature_batch::get_check_sets() const
+{
+  std::vector<const signature_check_set*> check_sets{&m_v1, &m_rct};
+  for (const auto &checks : m_extra)
+    check_sets.push_back(checks.get());
+  return check_sets;
+}
+//------------------------------------------------------------------
+size_t ring_signature_batch::size() const
+{
+  size_t n = 0;
+  for (const signature_check_set *checks : get_check_sets())
+    n += checks->size();
+  return n;
+}
+//------------------------------------------------------------------
+bool ring_signature_batch::verify(std::vector<crypto::hash> &failed_owners) const
+{
+  PERF_TIMER(ring_signature_batch_verify);
+  failed_owners.clear();
+
+  const std::vector<const signature_check_set*> check_sets = get_check_sets();
+  std::vector<std::vector<uint8_t>> results(check_sets.size());
+
+  tools::threadpool& tpool = tools::threadpool::getInstance();
+  tools::threadpool::waiter waiter(tpool);
+  const size_t threads = std::max<size_t>(1, tpool.get_max_concurrency());
+
+  for (size_t s = 0; s < check_sets.size(); ++s)
+  {
+    const signature_check_set &checks = *check_sets[s];
+    const size_t n = checks.size();
+    results[s].resize(n, 0);
+    if (n == 0)
+      continue;
+
+    // one task per chunk; chunks shrink when there are too few checks to keep every thread busy
+    const size_t chunk = std::max<size_t>(1, std::min(checks.chunk_size(), (n + threads - 1) / threads));
+    for (size_t begin = 0; begin < n; begin += chunk)
+    {
+      const size_t end = std::min(n, begin + chunk);
+      std::vector<uint8_t> &set_results = results[s];
+      if (threads > 1)
+        tpool.submit(&waiter, [&checks, &set_results, begin, end]{ checks.verify_range(begin, end, set_results); }, true);
+      else
+        checks.verify_range(begin, end, set_results);
+    }
+  }
+  if (!waiter.wait())
+    return false;
+
+  for (size_t s = 0; s < check_sets.size(); ++s)
+  {
+    for (size_t i = 0; i < results[s].size(); ++i)
+    {
+      if (!results[s][i])
+        failed_owners.push_back(check_sets[s]->owner(i));
+    }
+  }
+  std::sort(failed_owners.begin(), failed_owners.end(), [](const crypto::hash &a, const crypto::hash &b) {
+    return memcmp(&a, &b, sizeof(a)) < 0;
+  });
+  failed_owners.erase(std::unique(failed_owners.begin(), failed_owners.end()), failed_owners.end());
+
+  return failed_owners.empty();
+}
+//------------------------------------------------------------------
+void ring_signature_batch::clear()
+{
+  m_v1.clear();
+  m_rct.clear();
+  for (const auto &checks : m_extra)
+    checks->clear();
+}
+
+}
@@ -0,0 +1,264 @@
+// Copyright (c) 2021, The Monero Project
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of
+//    conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list
+//    of conditions and the following disclaimer in the documentation and/or other
+//    materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be
+//    used to endorse or promote products derived from this software without specific
+//    prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+// THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <boost/thread/mutex.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <unordered_set>
+#include <vector>
+
+#include "crypto/crypto.h"
+#include "crypto/hash.h"
+#include "ringct/rctTypes.h"
+
+namespace cryptonote
+{
+  /**
+   * @brief a list of independent signature checks, verified in chunks
+   *
+   * Each check is tagged with its owner (the hash of the transaction it came
+   * from) so that a failure can be traced back to a transaction.  Checks are
+   * handed to verify_range() in contiguous ranges, one threadpool task per
+   * range, so a proof system with a batch verifier (e.g. the Triptych/Grootle
+   * proofs in src/mock_tx) can verify a whole range at once.
+   */
+  class signature_check_set
+  {
+  public:
+    virtual ~signature_check_set() = default;
+
+    /**
+     * @brief gets the number of checks in the set
+     */
+    virtual size_t size() const = 0;
+
+    /**
+     * @brief gets the largest number of checks one threadpool task should verify
+     *
+     * Neighbouring checks usually share data (a transaction's message and
+     * rings), so bigger chunks keep that data hot; smaller chunks spread the
+     * work over more threads.
+     */
+    virtual size_t chunk_size() const = 0;
+
+    /**
+     * @brief gets the owner of a check
+     *
+     * @param i the index of the check
+     */
+    virtual const crypto::hash& owner(const size_t i) const = 0;
+
+    /**
+     * @brief verifies the checks in [begin, end)
+     *
+     * Called concurrently for disjoint ranges, and must not throw.
+     *
+     * @param begin index of the first check
+     * @param end index past the last check
+     * @param results set results[i] to 1 for each passing check in the range, 0 otherwise
+     */
+    virtual void verify_range(const size_t begin, const size_t end, std::vector<uint8_t> &results) const = 0;
+
+    /**
+     * @brief removes all checks
+     */
+    virtual void clear() = 0;
+  };
+
+  /**
+   * @brief pre-rct ring signatures, one check per input
+   */
+  class v1_ring_signature_checks final : public signature_check_set
+  {
+  public:
+    /**
+     * @brief adds the ring signature of one input
+     *
+     * @param owner the hash of the transaction
+     * @param tx_prefix_hash the transaction prefix' hash
+     * @param key_image the input's key image
+     * @param pubkeys the public keys of the ring members
+     * @param signatures the input's signatures, which must outlive the check
+     */
+    void add(const crypto::hash &owner, const crypto::hash &tx_prefix_hash, const crypto::key_image &key_image,
+        std::vector<rct::ctkey> &&pubkeys, const std::vector<crypto::signature> &signatures);
+
+    size_t size() const override { return m_checks.size(); }
+    size_t chunk_size() const override { return 16; }
+    const crypto::hash& owner(const size_t i) const override { return m_checks[i].owner; }
+    void verify_range(const size_t begin, const size_t end, std::vector<uint8_t> &results) const override;
+    void clear() override { m_checks.clear(); }
+
+  private:
+    struct check
+    {
+      crypto::hash owner;
+      crypto::hash tx_prefix_hash;
+      crypto::key_image key_image;
+      std::vector<rct::ctkey> pubkeys;
+      const std::vector<crypto::signature> *signatures;
+    };
+
+    std::vector<check> m_checks;
+  };
+
+  /**
+   * @brief MLSAG/CLSAG ring signatures of simple rct transactions, one check per input
+   */
+  class rct_ring_signature_checks final : public signature_check_set
+  {
+  public:
+    /**
+     * @brief adds the ring signatures of every input of a transaction
+     *
+     * The signature's mixRing must already be expanded.  Nothing is added if
+     * the signature is not a simple rct type or its sizes do not match.
+     *
+     * @param owner the hash of the transaction
+     * @param rv the transaction's rct signature, which must outlive the checks
+     *
+     * @return false if the signature is malformed, otherwise true
+     */
+    bool add(const crypto::hash &owner, const rct::rctSig &rv);
+
+    size_t size() const override { return m_checks.size(); }
+    size_t chunk_size() const override { return 4; }
+    const crypto::hash& owner(const size_t i) const override { return m_checks[i].owner; }
+    void verify_range(const size_t begin, const size_t end, std::vector<uint8_t> &results) const override;
+    void clear() override { m_checks.clear(); }
+
+  private:
+    struct check
+    {
+      crypto::hash owner;
+      rct::key message;
+      const rct::rctSig *rv;
+      size_t input;
+    };
+
+    std::vector<check> m_checks;
+  };
+
+  /**
+   * @brief a bounded set of transactions whose ring signatures passed verification
+   *
+   * An entry is keyed by the transaction hash and by the ring members the
+   * signatures were checked against, so it stays valid across blocks: a
+   * transaction verified in the pool need not be verified again when it is
+   * mined, as long as its rings still resolve to the same outputs.  The
+   * oldest entry is evicted when the cache is full.  Thread safe.
+   */
+  class ring_signature_cache
+  {
+  public:
+    /**
+     * @param max_entries the number of entries kept
+     */
+    explicit ring_signature_cache(size_t max_entries);
+
+    /**
+     * @brief gets the cache key for a transaction and its resolved rings
+     *
+     * @param tx_hash the hash of the transaction
+     * @param mix_ring the transaction's expanded mixRing
+     */
+    static crypto::hash get_key(const crypto::hash &tx_hash, const rct::ctkeyM &mix_ring);
+
+    /**
+     * @brief checks whether a key was recorded as verified
+     */
+    bool has(const crypto::hash &key) const;
+
+    /**
+     * @brief records a key as verified, evicting the oldest entry if full
+     */
+    void add(const crypto::hash &key);
+
+    /**
+     * @brief removes all entries
+     */
+    void clear();
+
+  private:
+    mutable boost::mutex m_lock;
+    size_t m_max_entries;
+    std::unordered_set<crypto::hash> m_entries;
+    std::deque<crypto::hash> m_order;
+  };
+
+  /**
+   * @brief collects the ring signature checks of many transactions and verifies them together
+   *
+   * Used to verify all the ring signatures of a block at once, instead of
+   * transaction by transaction.  Other proof systems can be verified in the
+   * same pass by registering their own signature_check_set.
+   */
+  class ring_signature_batch final
+  {
+  public:
+    v1_ring_signature_checks& v1() { return m_v1; }
+    rct_ring_signature_checks& rct() { return m_rct; }
+
+    /**
+     * @brief registers an extra set of checks, verified along with the ring signatures
+     *
+     * @param checks the set to register
+     */
+    void add_check_set(std::unique_ptr<signature_check_set> checks);
+
+    /**
+     * @brief gets the total number of checks in all sets
+     */
+    size_t size() const;
+
+    /**
+     * @brief verifies all the checks on the threadpool
+     *
+     * @param failed_owners return-by-reference owners of the failing checks, sorted and without duplicates
+     *
+     * @return false if any check fails, otherwise true
+     */
+    bool verify(std::vector<crypto::hash> &failed_owners) const;
+
+    /**
+     * @brief removes all checks from all sets; registered sets stay registered
+     */
+    void clear();
+
+  private:
+    std::vector<const signature_check_set*> get_check_sets() const;
+
+    v1_ring_signature_checks m_v1;
+    rct_ring_signature_checks m_rct;
+    std::vector<std::unique_ptr<signature_check_set>> m_extra;
+  };
+}
@@ -0,0 +1,123 @@
+// Copyright (c) 2021, The Monero Project
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of
+//    conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list
+//    of conditions and the following disclaimer in the documentation and/or other
+//    materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be
+//    used to endorse or promote products derived from this software without specific
+//    prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+// THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <algorithm>
+#include <boost/thread/lock_guard.hpp>
+
+#include "misc_log_ex.h"
+#include "misc_os_dependent.h"
+#include "sync_batch_controller.h"
+
+#undef MONERO_DEFAULT_LOG_CATEGORY
+#define MONERO_DEFAULT_LOG_CATEGORY "blockchain"
+
+// commits faster than this let the batch grow
+#define SYNC_BATCH_FAST_COMMIT_MS 250
+// commits slower than this halve the batch
+#define SYNC_BATCH_SLOW_COMMIT_MS 2000
+// batches dirtying more than this halve the batch, to bound memory and the next fsync
+#define SYNC_BATCH_MAX_DIRTY_BYTES (512 * 1024 * 1024)
+// weight of the newest batch in the throughput average
+#define SYNC_BATCH_THROUGHPUT_ALPHA 0.2
+
+namespace cryptonote
+{
+
+//------------------------------------------------------------------
+sync_batch_controller::sync_batch_controller(size_t min_blocks, size_t max_blocks):
+  m_min_blocks(std::max<size_t>(min_blocks, 1)),
+  m_max_blocks(std::max(max_blocks, m_min_blocks)),
+  m_batch_blocks(0),
+  m_batches(0),
+  m_last_batch_time(0),
+  m_blocks_per_second(0.0),
+  m_commit_ms_histogram(NUM_HISTOGRAM_BUCKETS, 0)
+{
+}
+//------------------------------------------------------------------
+size_t sync_batch_controller::get_batch_blocks(size_t default_blocks) const
+{
+  boost::lock_guard<boost::mutex> lock(m_lock);
+  return m_batch_blocks ? m_batch_blocks : default_blocks;
+}
+//------------------------------------------------------------------
+void sync_batch_controller::add_batch(size_t blocks, uint64_t commit_ms, uint64_t dirty_bytes)
+{
+  if (blocks == 0)
+    return;
+
+  const uint64_t now = epee::misc_utils::get_tick_count();
+
+  boost::lock_guard<boost::mutex> lock(m_lock);
+
+  ++m_batches;
+  size_t bucket = 0;
+  while (bucket + 1 < NUM_HISTOGRAM_BUCKETS && commit_ms >= (1ull << bucket))
+    ++bucket;
+  ++m_commit_ms_histogram[bucket];
+
+  // throughput covers the whole cycle between two commits: download, verification and commit
+  if (m_last_batch_time && now > m_last_batch_time)
+  {
+    const double bps = blocks * 1000.0 / (now - m_last_batch_time);
+    m_blocks_per_second = m_blocks_per_second > 0.0 ? m_blocks_per_second + SYNC_BATCH_THROUGHPUT_ALPHA * (bps - m_blocks_per_second) : bps;
+  }
+  m_last_batch_time = now;
+
+  const size_t previous = m_batch_blocks;
+  if (m_batch_blocks == 0)
+    m_batch_blocks = std::min(std::max(blocks, m_min_blocks), m_max_blocks);
+
+  if (commit_ms > SYNC_BATCH_SLOW_COMMIT_MS || dirty_bytes > SYNC_BATCH_MAX_DIRTY_BYTES)
+  {
+    m_batch_blocks = std::max(m_batch_blocks / 2, m_min_blocks);
+  }
+  else if (commit_ms < SYNC_BATCH_FAST_COMMIT_MS && blocks * 2 >= m_batch_blocks)
+  {
+    // only grow on batches that were close to the target: a short one (e.g. near the top
+    // of the chain) says little about how a full one would commit
+    m_batch_blocks = std::min(m_batch_blocks + std::max<size_t>(m_batch_blocks / 4, 1), m_max_blocks);
+  }
+
+  if (m_batch_blocks != previous)
+    MDEBUG("Sync batch target now " << m_batch_blocks << " blocks (last batch: " << blocks << " blocks, commit " <<
+        commit_ms << " ms, " << dirty_bytes / 1024 << " kB dirty)");
+}
+//------------------------------------------------------------------
+sync_batch_stats sync_batch_controller::get_stats() const
+{
+  boost::lock_guard<boost::mutex> lock(m_lock);
+  sync_batch_stats stats;
+  stats.batch_blocks = m_batch_blocks;
+  stats.blocks_per_second = m_blocks_per_second;
+  stats.batches = m_batches;
+  stats.commit_ms_histogram = m_commit_ms_histogram;
+  return stats;
+}
+
+}
@@ -0,0 +1,99 @@
+// Copyright (c) 2021, The Monero Project
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of
+//    conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list
+//    of conditions and the following disclaimer in the documentation and/or other
+//    materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be
+//    used to endorse or promote products derived from this software without specific
+//    prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+// THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <boost/thread/mutex.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace cryptonote
+{
+  /**
+   * @brief sync throughput and database commit figures, as reported by sync_batch_controller
+   */
+  struct sync_batch_stats
+  {
+    size_t batch_blocks;                           //!< the current target of blocks per batch, 0 until the first batch
+    double blocks_per_second;                      //!< smoothed sync throughput
+    uint64_t batches;                              //!< number of batches committed
+    std::vector<uint64_t> commit_ms_histogram;     //!< commit latencies: entry i counts commits under 2^i ms, the last entry the rest
+  };
+
+  /**
+   * @brief tunes how many blocks are added per database batch while syncing
+   *
+   * Each committed batch reports its size, the time it took to commit and
+   * the volume of pages it dirtied.  Batches that commit quickly grow the
+   * target by a quarter; a slow commit, or one that dirtied too much, halves
+   * it.  A fast disk thus ends up with large batches that amortize
+   * the per-commit overhead, while a slow one stays with small batches that
+   * do not stall the node.  Thread safe.
+   */
+  class sync_batch_controller
+  {
+  public:
+    static constexpr size_t NUM_HISTOGRAM_BUCKETS = 16;
+
+    /**
+     * @param min_blocks the smallest target
+     * @param max_blocks the largest target
+     */
+    sync_batch_controller(size_t min_blocks, size_t max_blocks);
+
+    /**
+     * @brief gets the number of blocks the next batch should have
+     *
+     * @param default_blocks returned until a batch was measured
+     */
+    size_t get_batch_blocks(size_t default_blocks) const;
+
+    /**
+     * @brief feeds back the cost of a committed batch
+     *
+     * @param blocks the number of blocks in the batch
+     * @param commit_ms how long the commit took
+     * @param dirty_bytes how many bytes of pages the batch dirtied
+     */
+    void add_batch(size_t blocks, uint64_t commit_ms, uint64_t dirty_bytes);
+
+    sync_batch_stats get_stats() const;
+
+  private:
+    const size_t m_min_blocks;
+    const size_t m_max_blocks;
+
+    mutable boost::mutex m_lock;
+    size_t m_batch_blocks;
+    uint64_t m_batches;
+    uint64_t m_last_batch_time;
+    double m_blocks_per_second;
+    std::vector<uint64_t> m_commit_ms_histogram;
+  };
+}
@@ -29,6 +29,7 @@
 // Parts of this file are originally copyright (c) 2012-2013 The Cryptonote developers
 
 #include <algorithm>
+#include <cmath>
 #include <boost/filesystem.hpp>
 #include <unordered_set>
 #include <vector>
@@ -125,10 +126,22 @@ namespace cryptonote
       if (candidate < next_check.load(std::memory_order_relaxed))
         next_check = candidate;
     }
+    uint32_t get_fee_histogram_bucket(double fee_per_byte)
+    {
+      if (!(fee_per_byte >= 1.0))
+        return 0;
+      const double bucket = std::log2(fee_per_byte) * TXPOOL_FEE_HISTOGRAM_STEPS_PER_OCTAVE;
+      return std::min<double>(bucket, TXPOOL_FEE_HISTOGRAM_BUCKETS - 1);
+    }
+
+    double get_fee_histogram_bucket_floor(size_t bucket)
+    {
+      return bucket ? std::exp2(bucket / (double)TXPOOL_FEE_HISTOGRAM_STEPS_PER_OCTAVE) : 0.0;
+    }
   }
   //---------------------------------------------------------------------------------
   //---------------------------------------------------------------------------------
-  tx_memory_pool::tx_memory_pool(Blockchain& bchs): m_blockchain(bchs), m_cookie(0), m_txpool_max_weight(DEFAULT_TXPOOL_MAX_WEIGHT), m_txpool_weight(0), m_mine_stem_txes(false), m_next_check(std::time(nullptr))
+  tx_memory_pool::tx_memory_pool(Blockchain& bchs): m_blockchain(bchs), m_cookie(0), m_txpool_max_weight(DEFAULT_TXPOOL_MAX_WEIGHT), m_txpool_weight(0), m_mine_stem_txes(false), m_parsed_tx_index_bytes(0), m_fee_histogram_all(), m_fee_histogram_broadcasted(), m_next_check(std::time(nullptr))
   {
     // class code expects unsigned values throughout
     if (m_next_check < time_t(0))
@@ -282,6 +295,7 @@ namespace cryptonote
 
           m_blockchain.add_txpool_tx(id, blob, meta);
           m_txs_by_fee_and_receive_time.emplace(std::pair<double, std::time_t>(fee / (double)(tx_weight ? tx_weight : 1), receive_time), id);
+          add_to_fee_histogram(id, meta);
           lock.commit();
         }
         catch (const std::exception &e)
@@ -353,6 +367,7 @@ namespace cryptonote
           m_blockchain.remove_txpool_tx(id);
           m_blockchain.add_txpool_tx(id, blob, meta);
           m_txs_by_fee_and_receive_time.emplace(std::pair<double, std::time_t>(fee / (double)(tx_weight ? tx_weight : 1), receive_time), id);
+          add_to_fee_histogram(id, meta);
         }
         lock.commit();
       }
@@ -362,6 +377,7 @@ namespace cryptonote
         return false;
       }
       tvc.m_added_to_pool = true;
+      index_parsed_tx(tx, id, blob, meta.get_relay_method());
 
       static_assert(unsigned(relay_method::none) == 0, "expected relay_method::none value to be zero");
       if(meta.fee > 0 && tx_relay != relay_method::forward)
@@ -370,6 +386,7 @@ namespace cryptonote
 
     tvc.m_verifivation_failed = false;
     m_txpool_weight += tx_weight;
+    m_template_candidates.erase(id);
 
     ++m_cookie;
 
@@ -444,6 +461,8 @@ namespace cryptonote
         m_blockchain.remove_txpool_tx(txid);
         m_txpool_weight -= meta.weight;
         remove_transaction_keyimages(tx, txid);
+        unindex_parsed_tx(txid);
+        remove_from_fee_histogram(txid);
         MINFO("Pruned tx " << txid << " from txpool: weight: " << meta.weight << ", fee/byte: " << it->first.first);
         m_txs_by_fee_and_receive_time.erase(it--);
         changed = true;
@@ -540,10 +559,15 @@ namespace cryptonote
       }
       txblob = m_blockchain.get_txpool_tx_blob(id, relay_category::all);
       auto ci = m_parsed_tx_cache.find(id);
+      const std::shared_ptr<const txpool_parsed_tx> indexed = get_parsed_transaction(id, relay_category::all);
       if (ci != m_parsed_tx_cache.end())
       {
         tx = ci->second;
       }
+      else if (indexed)
+      {
+        tx = indexed->tx;
+      }
       else if (!(meta.pruned ? parse_and_validate_tx_base_from_blob(txblob, tx) : parse_and_validate_tx_from_blob(txblob, tx)))
       {
         MERROR("Failed to parse tx from txpool");
@@ -565,6 +589,8 @@ namespace cryptonote
       m_txpool_weight -= tx_weight;
       remove_transaction_keyimages(tx, id);
       lock.commit();
+      unindex_parsed_tx(id);
+      remove_from_fee_histogram(id);
     }
     catch (const std::exception &e)
     {
@@ -706,7 +732,7 @@ namespace cryptonote
       return true;
     }, false, relay_category::all);
 
-    if (!remove.empty())
+    if (!remove.empty() && !m_blockchain.get_db().is_read_only())
     {
       LockedTXN lock(m_blockchain.get_db());
       for (const std::pair<crypto::hash, uint64_t> &entry: remove)
@@ -727,6 +753,8 @@ namespace cryptonote
             m_blockchain.remove_txpool_tx(txid);
             m_txpool_weight -= entry.second;
             remove_transaction_keyimages(tx, txid);
+            unindex_parsed_tx(txid);
+            remove_from_fee_histogram(txid);
           }
         }
         catch (const std::exception &e)
@@ -849,6 +877,14 @@ namespace cryptonote
             meta.last_relayed_time = std::chrono::system_clock::to_time_t(now);
 
           m_blockchain.update_txpool_tx(hash, meta);
+          add_to_fee_histogram(hash, meta); // may now be broadcasted
+          m_template_candidates.erase(hash); // the relay method decides whether it may be mined
+          {
+            boost::unique_lock<boost::shared_mutex> index_lock(m_parsed_tx_index_lock);
+            const auto indexed = m_parsed_tx_index.find(hash);
+            if (indexed != m_parsed_tx_index.end())
+              indexed->second.second = meta.get_relay_method();
+          }
         }
       }
       catch (const std::exception &e)
@@ -858,6 +894,7 @@ namespace cryptonote
       }
     }
     lock.commit();
+    ++m_cookie; // relay state is visible to readers of the pool
     set_if_less(m_next_check, time_t(next_relay));
   }
   //---------------------------------------------------------------------------------
@@ -890,27 +927,71 @@ namespace cryptonote
   //------------------------------------------------------------------
   void tx_memory_pool::get_transaction_hashes(std::vector<crypto::hash>& txs, bool include_sensitive) const
   {
-    CRITICAL_REGION_LOCAL(m_transactions_lock);
-    CRITICAL_REGION_LOCAL1(m_blockchain);
+    const std::shared_ptr<const txpool_snapshot> snapshot = get_snapshot();
     const relay_category category = include_sensitive ? relay_category::all : relay_category::broadcasted;
-    txs.reserve(m_blockchain.get_txpool_tx_count(include_sensitive));
-    m_blockchain.for_all_txpool_txes([&txs](const crypto::hash &txid, const txpool_tx_meta_t &meta, const cryptonote::blobdata_ref *bd){
-      txs.push_back(txid);
-      return true;
-    }, false, category);
+    txs.reserve(snapshot->txes.size());
+    for (const auto &entry : snapshot->txes)
+    {
+      if (entry.second.matches(category))
+        txs.push_back(entry.first);
+    }
   }
   //------------------------------------------------------------------
   void tx_memory_pool::get_transaction_backlog(std::vector<tx_backlog_entry>& backlog, bool include_sensitive) const
   {
-    CRITICAL_REGION_LOCAL(m_transactions_lock);
-    CRITICAL_REGION_LOCAL1(m_blockchain);
+    const std::shared_ptr<const txpool_snapshot> snapshot = get_snapshot();
     const uint64_t now = time(NULL);
     const relay_category category = include_sensitive ? relay_category::all : relay_category::broadcasted;
-    backlog.reserve(m_blockchain.get_txpool_tx_count(include_sensitive));
-    m_blockchain.for_all_txpool_txes([&backlog, now](const crypto::hash &txid, const txpool_tx_meta_t &meta, const cryptonote::blobdata_ref *bd){
-      backlog.push_back({meta.weight, meta.fee, meta.receive_time - now});
-      return true;
-    }, false, category);
+    backlog.reserve(snapshot->txes.size());
+    for (const auto &entry : snapshot->txes)
+    {
+      const txpool_tx_meta_t &meta = entry.second;
+      if (meta.matches(category))
+        backlog.push_back({meta.weight, meta.fee, meta.receive_time - now});
+    }
+  }
+  //------------------------------------------------------------------
+  void tx_memory_pool::get_transaction_backlog_histogram(std::vector<tx_backlog_fee_bucket>& histogram, bool include_sensitive) const
+  {
+    CRITICAL_REGION_LOCAL(m_transactions_lock);
+    const auto &buckets = include_sensitive ? m_fee_histogram_all : m_fee_histogram_broadcasted;
+    for (size_t i = buckets.size(); i-- > 0; )
+    {
+      if (!buckets[i].txs)
+        continue;
+      const double max_fee_per_byte = i + 1 < buckets.size() ? get_fee_histogram_bucket_floor(i + 1) : std::numeric_limits<double>::max();
+      histogram.push_back({get_fee_histogram_bucket_floor(i), max_fee_per_byte, buckets[i].weight, buckets[i].txs});
+    }
+  }
+  //------------------------------------------------------------------
+  void tx_memory_pool::add_to_fee_histogram(const crypto::hash &id, const txpool_tx_meta_t &meta)
+  {
+    remove_from_fee_histogram(id);
+    const fee_histogram_entry entry{get_fee_histogram_bucket(meta.fee / (double)(meta.weight ? meta.weight : 1)), meta.weight, meta.matches(relay_category::broadcasted)};
+    m_fee_histogram_txes.emplace(id, entry);
+    m_fee_histogram_all[entry.bucket].weight += entry.weight;
+    ++m_fee_histogram_all[entry.bucket].txs;
+    if (entry.broadcasted)
+    {
+      m_fee_histogram_broadcasted[entry.bucket].weight += entry.weight;
+      ++m_fee_histogram_broadcasted[entry.bucket].txs;
+    }
+  }
+  //------------------------------------------------------------------
+  void tx_memory_pool::remove_from_fee_histogram(const crypto::hash &id)
+  {
+    const auto it = m_fee_histogram_txes.find(id);
+    if (it == m_fee_histogram_txes.end())
+      return;
+    const fee_histogram_entry &entry = it->second;
+    m_fee_histogram_all[entry.bucket].weight -= entry.weight;
+    --m_fee_histogram_all[entry.bucket].txs;
+    if (entry.broadcasted)
+    {
+      m_fee_histogram_broadcasted[entry.bucket].weight -= entry.weight;
+      --m_fee_histogram_broadcasted[entry.bucket].txs;
+    }
+    m_fee_histogram_txes.erase(it);
   }
   //------------------------------------------------------------------
   void tx_memory_pool::get_block_template_backlog(std::vector<tx_block_template_backlog_entry>& backlog, bool include_sensitive) const
@@ -941,15 +1022,19 @@ namespace cryptonote
   //------------------------------------------------------------------
   void tx_memory_pool::get_transaction_stats(struct txpool_stats& stats, bool include_sensitive) const
   {
-    CRITICAL_REGION_LOCAL(m_transactions_lock);
-    CRITICAL_REGION_LOCAL1(m_blockchain);
+    const std::shared_ptr<const txpool_snapshot> snapshot = get_snapshot();
     const uint64_t now = time(NULL);
     const relay_category category = include_sensitive ? relay_category::all : relay_category::broadcasted;
     std::map<uint64_t, txpool_histo> agebytes;
-    stats.txs_total = m_blockchain.get_txpool_tx_count(include_sensitive);
+    stats.txs_total = 0;
     std::vector<uint32_t> weights;
-    weights.reserve(stats.txs_total);
-    m_blockchain.for_all_txpool_txes([&stats, &weights, now, &agebytes](const crypto::hash &txid, const txpool_tx_meta_t &meta, const cryptonote::blobdata_ref *bd){
+    weights.reserve(snapshot->txes.size());
+    for (const auto &entry : snapshot->txes)
+    {
+      const txpool_tx_meta_t &meta = entry.second;
+      if (!meta.matches(category))
+        continue;
+      ++stats.txs_total;
       weights.push_back(meta.weight);
       stats.bytes_total += meta.weight;
       if (!stats.bytes_min || meta.weight < stats.bytes_min)
@@ -970,8 +1055,7 @@ namespace cryptonote
       agebytes[age].bytes += meta.weight;
       if (meta.double_spend_seen)
         ++stats.num_double_spends;
-      return true;
-    }, false, category);
+    }
 
     stats.bytes_med = epee::misc_utils::median(weights);
     if (stats.txs_total > 1)
@@ -1025,6 +1109,43 @@ namespace cryptonote
     }
   }
   //------------------------------------------------------------------
+  std::shared_ptr<const txpool_snapshot> tx_memory_pool::get_snapshot() const
+  {
+    std::shared_ptr<const txpool_snapshot> snapshot = std::atomic_load(&m_snapshot);
+    if (snapshot && snapshot->cookie == m_cookie)
+      return snapshot;
+
+    CRITICAL_REGION_LOCAL(m_transactions_lock);
+    CRITICAL_REGION_LOCAL1(m_blockchain);
+
+    // another reader may have built it while we waited for the locks
+    snapshot = std::atomic_load(&m_snapshot);
+    if (snapshot && snapshot->cookie == m_cookie)
+      return snapshot;
+
+    std::shared_ptr<txpool_snapshot> fresh = std::make_shared<txpool_snapshot>();
+    fresh->cookie = m_cookie;
+    fresh->txes.reserve(m_txs_by_fee_and_receive_time.size());
+    for (const auto &entry : m_txs_by_fee_and_receive_time)
+    {
+      try
+      {
+        txpool_tx_meta_t meta;
+        if (m_blockchain.get_txpool_tx_meta(entry.second, meta))
+          fresh->txes.emplace_back(entry.second, meta);
+      }
+      catch (const std::exception &e)
+      {
+        MERROR("Failed to get txpool transaction metadata: " << e.what());
+        // continue
+      }
+    }
+
+    snapshot = std::move(fresh);
+    std::atomic_store(&m_snapshot, snapshot);
+    return snapshot;
+  }
+  //------------------------------------------------------------------
   //TODO: investigate whether boolean return is appropriate
   bool tx_memory_pool::get_transactions_and_spent_keys_info(std::vector<tx_info>& tx_infos, std::vector<spent_key_image_info>& key_image_infos, bool include_sensitive_data) const
   {
@@ -1168,6 +1289,51 @@ namespace cryptonote
     }
   }
   //---------------------------------------------------------------------------------
+  std::shared_ptr<const txpool_parsed_tx> tx_memory_pool::get_parsed_transaction(const crypto::hash& id, relay_category tx_category) const
+  {
+    boost::shared_lock<boost::shared_mutex> lock(m_parsed_tx_index_lock);
+    const auto it = m_parsed_tx_index.find(id);
+    if (it == m_parsed_tx_index.end() || !matches_category(it->second.second, tx_category))
+      return nullptr;
+    return it->second.first;
+  }
+  //---------------------------------------------------------------------------------
+  void tx_memory_pool::index_parsed_tx(const transaction &tx, const crypto::hash &id, const cryptonote::blobdata &blob, relay_method tx_relay)
+  {
+    {
+      boost::unique_lock<boost::shared_mutex> lock(m_parsed_tx_index_lock);
+      const auto it = m_parsed_tx_index.find(id);
+      if (it != m_parsed_tx_index.end())
+      {
+        it->second.second = tx_relay;
+        return;
+      }
+      if (tx.pruned || m_parsed_tx_index_bytes + blob.size() > TXPOOL_PARSED_TX_INDEX_MAX_BYTES)
+        return;
+    }
+
+    // copy and hash outside the lock, readers do not wait on this
+    auto entry = std::make_shared<txpool_parsed_tx>();
+    entry->blob = blob;
+    entry->tx = tx;
+    entry->tx.set_hash(id);
+    entry->prefix_hash = get_transaction_prefix_hash(tx);
+
+    boost::unique_lock<boost::shared_mutex> lock(m_parsed_tx_index_lock);
+    if (m_parsed_tx_index.emplace(id, std::make_pair(std::move(entry), tx_relay)).second)
+      m_parsed_tx_index_bytes += blob.size();
+  }
+  //---------------------------------------------------------------------------------
+  void tx_memory_pool::unindex_parsed_tx(const crypto::hash &id)
+  {
+    boost::unique_lock<boost::shared_mutex> lock(m_parsed_tx_index_lock);
+    const auto it = m_parsed_tx_index.find(id);
+    if (it == m_parsed_tx_index.end())
+      return;
+    m_parsed_tx_index_bytes -= it->second.first->blob.size();
+    m_parsed_tx_index.erase(it);
+  }
+  //---------------------------------------------------------------------------------
   bool tx_memory_pool::on_blockchain_inc(uint64_t new_block_height, const crypto::hash& top_block_id)
   {
     CRITICAL_REGION_LOCAL(m_transactions_lock);
@@ -1418,12 +1584,52 @@ namespace cryptonote
     return ss.str();
   }
   //---------------------------------------------------------------------------------
-  //TODO: investigate whether boolean return is appropriate
+  tx_memory_pool::template_candidate* tx_memory_pool::get_template_candidate(const crypto::hash &txid)
+  {
+    auto it = m_template_candidates.find(txid);
+    if (it != m_template_candidates.end())
+      return &it->second;
+
+    txpool_tx_meta_t meta;
+    if (!m_blockchain.get_txpool_tx_meta(txid, meta))
+      return NULL;
+
+    template_candidate candidate;
+    candidate.weight = meta.weight;
+    candidate.fee = meta.fee;
+    candidate.relay = meta.get_relay_method();
+    candidate.eligible = (meta.matches(relay_category::legacy) || (m_mine_stem_txes && candidate.relay == relay_method::stem)) && !meta.pruned;
+    candidate.checked = false;
+    candidate.ready = false;
+    return &m_template_candidates.emplace(txid, std::move(candidate)).first->second;
+  }
+  //---------------------------------------------------------------------------------
   bool tx_memory_pool::fill_block_template(block &bl, size_t median_weight, uint64_t already_generated_coins, size_t &total_weight, uint64_t &fee, uint64_t &expected_reward, uint8_t version)
   {
     CRITICAL_REGION_LOCAL(m_transactions_lock);
     CRITICAL_REGION_LOCAL1(m_blockchain);
 
+    // readiness of pool txes only changes with the chain, so candidates are kept until the top block changes
+    const crypto::hash top_hash = m_blockchain.get_tail_id();
+    if (top_hash != m_template_candidates_top_hash || m_template_candidates.size() > 2 * m_txs_by_fee_and_receive_time.size() + 64)
+    {
+      m_template_candidates.clear();
+      m_template_candidates_top_hash = top_hash;
+    }
+
+    // nothing changed since the last template: hand it out again
+    const block_template_cache &cached = m_block_template_cache;
+    if (cached.valid && cached.cookie == m_cookie && cached.top_hash == top_hash && cached.median_weight == median_weight &&
+        cached.already_generated_coins == already_generated_coins && cached.version == version)
+    {
+      bl.tx_hashes.insert(bl.tx_hashes.end(), cached.tx_hashes.begin(), cached.tx_hashes.end());
+      total_weight = cached.total_weight;
+      fee = cached.fee;
+      expected_reward = cached.expected_reward;
+      LOG_PRINT_L2("Block template reused with " << cached.tx_hashes.size() << " txes, weight " << total_weight);
+      return true;
+    }
+
     uint64_t best_coinbase = 0, coinbase = 0;
     total_weight = 0;
     fee = 0;
@@ -1440,6 +1646,7 @@ namespace cryptonote
     size_t max_total_weight_v5 = 2 * median_weight - CRYPTONOTE_COINBASE_BLOB_RESERVED_SIZE;
     size_t max_total_weight = version >= 5 ? max_total_weight_v5 : max_total_weight_pre_v5;
     std::unordered_set<crypto::key_image> k_images;
+    std::vector<crypto::hash> tx_hashes;
 
     LOG_PRINT_L2("Filling block template, median weight " << median_weight << ", " << m_txs_by_fee_and_receive_time.size() << " txes in the pool");
 
@@ -1448,8 +1655,8 @@ namespace cryptonote
     auto sorted_it = m_txs_by_fee_and_receive_time.begin();
     for (; sorted_it != m_txs_by_fee_and_receive_time.end(); ++sorted_it)
     {
-      txpool_tx_meta_t meta;
-      if (!m_blockchain.get_txpool_tx_meta(sorted_it->second, meta))
+      template_candidate *candidate = get_template_candidate(sorted_it->second);
+      if (!candidate)
       {
         static bool warned = false;
         if (!warned)
@@ -1457,21 +1664,16 @@ namespace cryptonote
         warned = true;
         continue;
       }
-      LOG_PRINT_L2("Considering " << sorted_it->second << ", weight " << meta.weight << ", current block weight " << total_weight << "/" << max_total_weight << ", current coinbase " << print_money(best_coinbase) << ", relay method " << (unsigned)meta.get_relay_method());
+      LOG_PRINT_L2("Considering " << sorted_it->second << ", weight " << candidate->weight << ", current block weight " << total_weight << "/" << max_total_weight << ", current coinbase " << print_money(best_coinbase) << ", relay method " << (unsigned)candidate->relay);
 
-      if (!meta.matches(relay_category::legacy) && !(m_mine_stem_txes && meta.get_relay_method() == relay_method::stem))
-      {
-        LOG_PRINT_L2("  tx relay method is " << (unsigned)meta.get_relay_method());
-        continue;
-      }
-      if (meta.pruned)
+      if (!candidate->eligible)
       {
-        LOG_PRINT_L2("  tx is pruned");
+        LOG_PRINT_L2("  tx relay method is " << (unsigned)candidate->relay << ", or tx is pruned");
         continue;
       }
 
       // Can not exceed maximum block weight
-      if (max_total_weight < total_weight + meta.weight)
+      if (max_total_weight < total_weight + candidate->weight)
       {
         LOG_PRINT_L2("  would exceed maximum block weight");
         continue;
@@ -1483,12 +1685,12 @@ namespace cryptonote
         // If we're getting lower coinbase tx,
         // stop including more tx
         uint64_t block_reward;
-        if(!get_block_reward(median_weight, total_weight + meta.weight, already_generated_coins, block_reward, version))
+        if(!get_block_reward(median_weight, total_weight + candidate->weight, already_generated_coins, block_reward, version))
         {
           LOG_PRINT_L2("  would exceed maximum block weight");
           continue;
         }
-        coinbase = block_reward + fee + meta.fee;
+        coinbase = block_reward + fee + candidate->fee;
         if (coinbase < template_accept_threshold(best_coinbase))
         {
           LOG_PRINT_L2("  would decrease coinbase to " << print_money(coinbase));
@@ -1506,61 +1708,93 @@ namespace cryptonote
         }
       }
 
-      // "local" and "stem" txes are filtered above
-      cryptonote::blobdata txblob = m_blockchain.get_txpool_tx_blob(sorted_it->second, relay_category::all);
+      if (!candidate->checked)
+      {
+        txpool_tx_meta_t meta;
+        if (!m_blockchain.get_txpool_tx_meta(sorted_it->second, meta))
+        {
+          LOG_PRINT_L2("  failed to find tx meta");
+          continue;
+        }
 
-      cryptonote::transaction tx;
+        // "local" and "stem" txes are filtered above
+        cryptonote::blobdata txblob = m_blockchain.get_txpool_tx_blob(sorted_it->second, relay_category::all);
 
-      // Skip transactions that are not ready to be
-      // included into the blockchain or that are
-      // missing key images
-      const cryptonote::txpool_tx_meta_t original_meta = meta;
-      bool ready = false;
-      try
-      {
-        ready = is_transaction_ready_to_go(meta, sorted_it->second, txblob, tx);
-      }
-      catch (const std::exception &e)
-      {
-        MERROR("Failed to check transaction readiness: " << e.what());
-        // continue, not fatal
-      }
-      if (memcmp(&original_meta, &meta, sizeof(meta)))
-      {
+        cryptonote::transaction tx;
+
+        // Skip transactions that are not ready to be
+        // included into the blockchain or that are
+        // missing key images
+        const cryptonote::txpool_tx_meta_t original_meta = meta;
+        bool ready = false;
         try
-	{
-	  m_blockchain.update_txpool_tx(sorted_it->second, meta);
-	}
+        {
+          ready = is_transaction_ready_to_go(meta, sorted_it->second, txblob, tx);
+        }
         catch (const std::exception &e)
-	{
-	  MERROR("Failed to update tx meta: " << e.what());
-	  // continue, not fatal
-	}
+        {
+          MERROR("Failed to check transaction readiness: " << e.what());
+          // continue, not fatal
+        }
+        if (memcmp(&original_meta, &meta, sizeof(meta)))
+        {
+          try
+          {
+            m_blockchain.update_txpool_tx(sorted_it->second, meta);
+          }
+          catch (const std::exception &e)
+          {
+            MERROR("Failed to update tx meta: " << e.what());
+            // continue, not fatal
+          }
+        }
+
+        candidate->checked = true;
+        candidate->ready = ready;
+        if (ready)
+        {
+          for (const txin_v &in : tx.vin)
+            candidate->key_images.push_back(boost::get<txin_to_key>(in).k_image);
+        }
       }
-      if (!ready)
+      if (!candidate->ready)
       {
         LOG_PRINT_L2("  not ready to go");
         continue;
       }
-      if (have_key_images(k_images, tx))
+      if (std::any_of(candidate->key_images.begin(), candidate->key_images.end(),
+          [&k_images](const crypto::key_image &ki) { return k_images.count(ki) != 0; }))
       {
         LOG_PRINT_L2("  key images already seen");
         continue;
       }
 
-      bl.tx_hashes.push_back(sorted_it->second);
-      total_weight += meta.weight;
-      fee += meta.fee;
+      tx_hashes.push_back(sorted_it->second);
+      total_weight += candidate->weight;
+      fee += candidate->fee;
       best_coinbase = coinbase;
-      append_key_images(k_images, tx);
+      k_images.insert(candidate->key_images.begin(), candidate->key_images.end());
       LOG_PRINT_L2("  added, new block weight " << total_weight << "/" << max_total_weight << ", coinbase " << print_money(best_coinbase));
     }
     lock.commit();
 
     expected_reward = best_coinbase;
-    LOG_PRINT_L2("Block template filled with " << bl.tx_hashes.size() << " txes, weight "
+    LOG_PRINT_L2("Block template filled with " << tx_hashes.size() << " txes, weight "
         << total_weight << "/" << max_total_weight << ", coinbase " << print_money(best_coinbase)
         << " (including " << print_money(fee) << " in fees)");
+
+    m_block_template_cache.valid = true;
+    m_block_template_cache.cookie = m_cookie;
+    m_block_template_cache.top_hash = top_hash;
+    m_block_template_cache.median_weight = median_weight;
+    m_block_template_cache.already_generated_coins = already_generated_coins;
+    m_block_template_cache.version = version;
+    m_block_template_cache.tx_hashes = tx_hashes;
+    m_block_template_cache.total_weight = total_weight;
+    m_block_template_cache.fee = fee;
+    m_block_template_cache.expected_reward = expected_reward;
+
+    bl.tx_hashes.insert(bl.tx_hashes.end(), tx_hashes.begin(), tx_hashes.end());
     return true;
   }
   //---------------------------------------------------------------------------------
@@ -1609,6 +1843,7 @@ namespace cryptonote
           continue;
         }
         m_blockchain.update_txpool_tx(e.txid, e.meta);
+        add_to_fee_histogram(e.txid, e.meta);
         ++added;
       }
       catch (const std::exception &e)
@@ -1635,6 +1870,9 @@ namespace cryptonote
     m_txs_by_fee_and_receive_time.clear();
     m_spent_key_images.clear();
     m_txpool_weight = 0;
+    m_fee_histogram_txes.clear();
+    m_fee_histogram_all.fill(fee_histogram_bucket());
+    m_fee_histogram_broadcasted.fill(fee_histogram_bucket());
     std::vector<crypto::hash> remove;
 
     // first add the not kept by block, then the kept by block,
@@ -1658,6 +1896,7 @@ namespace cryptonote
           return false;
         }
         m_txs_by_fee_and_receive_time.emplace(std::pair<double, time_t>(meta.fee / (double)meta.weight, meta.receive_time), txid);
+        add_to_fee_histogram(txid, meta);
         m_txpool_weight += meta.weight;
         return true;
       }, true, relay_category::all);
@@ -1684,11 +1923,28 @@ namespace cryptonote
 
     m_mine_stem_txes = mine_stem_txes;
     m_cookie = 0;
+    std::atomic_store(&m_snapshot, std::shared_ptr<const txpool_snapshot>());
+    m_template_candidates.clear();
+    m_block_template_cache.valid = false;
+    {
+      boost::unique_lock<boost::shared_mutex> index_lock(m_parsed_tx_index_lock);
+      m_parsed_tx_index.clear();
+      m_parsed_tx_index_bytes = 0;
+    }
 
     // Ignore deserialization error
     return true;
   }
 
+  //---------------------------------------------------------------------------------
+  bool tx_memory_pool::reload_from_db()
+  {
+    CRITICAL_REGION_LOCAL(m_transactions_lock);
+    const uint64_t cookie = m_cookie;
+    const bool r = init(m_txpool_max_weight, m_mine_stem_txes);
+    m_cookie = cookie + 1;
+    return r;
+  }
   //---------------------------------------------------------------------------------
   bool tx_memory_pool::deinit()
   {
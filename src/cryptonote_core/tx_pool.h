@@ -31,13 +31,17 @@
 #pragma once
 #include "include_base_utils.h"
 
+#include <array>
 #include <atomic>
+#include <memory>
 #include <set>
 #include <tuple>
+#include <vector>
 #include <unordered_map>
 #include <unordered_set>
 #include <queue>
 #include <boost/serialization/version.hpp>
+#include <boost/thread/shared_mutex.hpp>
 #include <boost/utility.hpp>
 
 #include "span.h"
@@ -80,6 +84,35 @@ namespace cryptonote
   //! container for sorting transactions by fee per unit size
   typedef std::set<tx_by_fee_and_receive_time_entry, txCompare> sorted_tx_container;
 
+  //! the pool fee histogram has this many buckets per doubling of the fee per byte
+  constexpr const unsigned TXPOOL_FEE_HISTOGRAM_STEPS_PER_OCTAVE = 16;
+  //! fee histogram buckets, covering 1 to 2^64 atomic units per byte
+  constexpr const size_t TXPOOL_FEE_HISTOGRAM_BUCKETS = 64 * TXPOOL_FEE_HISTOGRAM_STEPS_PER_OCTAVE;
+
+  /**
+   * @brief an immutable copy of the pool's transaction metadata at one point in time
+   *
+   * Snapshots are shared between readers without holding any lock; the pool
+   * builds a new one on demand after it changes.
+   */
+  struct txpool_snapshot
+  {
+    uint64_t cookie; //!< the pool cookie when the snapshot was taken
+    std::vector<std::pair<crypto::hash, txpool_tx_meta_t>> txes; //!< every tx, ordered by fee per byte, highest first
+  };
+
+  /**
+   * @brief a verified pool transaction kept parsed, for fluffy block reconstruction
+   *
+   * Entries are immutable once built and shared with readers.
+   */
+  struct txpool_parsed_tx
+  {
+    cryptonote::blobdata blob;
+    transaction tx; //!< parsed from blob, with its hash set
+    crypto::hash prefix_hash;
+  };
+
   /**
    * @brief Transaction pool, handles transactions which are not part of a block
    *
@@ -212,6 +245,16 @@ namespace cryptonote
      */
     bool init(size_t max_txpool_weight = 0, bool mine_stem_txes = false);
 
+    /**
+     * @brief rebuilds the in-memory pool state from the db, which another process writes
+     *
+     * Used by read-only RPC replicas. Unlike init(), the cookie moves on, so
+     * callers caching on it see the change.
+     *
+     * @return true on success, false otherwise
+     */
+    bool reload_from_db();
+
     /**
      * @brief attempts to save the transaction pool state to disk
      *
@@ -265,6 +308,17 @@ namespace cryptonote
      */
     void get_transaction_backlog(std::vector<tx_backlog_entry>& backlog, bool include_sensitive = false) const;
 
+    /**
+     * @brief get the pool weight and tx count per fee-per-byte bucket
+     *
+     * The histogram is kept up to date as txes enter and leave the pool,
+     * so this costs O(buckets) regardless of the pool size.
+     *
+     * @param histogram return-by-reference the non empty buckets, highest fee first
+     * @param include_sensitive count stempool, anonymity-pool, and unrelayed txes
+     */
+    void get_transaction_backlog_histogram(std::vector<tx_backlog_fee_bucket>& histogram, bool include_sensitive = false) const;
+
     /**
      * @brief get (hash, weight, fee) for all transactions in the pool - the minimum required information to create a block template
      *
@@ -330,6 +384,20 @@ namespace cryptonote
      */
     bool get_transaction(const crypto::hash& h, cryptonote::blobdata& txblob, relay_category tx_category) const;
 
+    /**
+     * @brief get a parsed transaction from the pool without taking the pool lock
+     *
+     * Only transactions verified on their way into the pool since it was
+     * loaded are kept parsed, up to a memory budget, so callers should fall
+     * back to get_transaction() when this returns NULL.
+     *
+     * @param h the hash of the transaction to get
+     * @param tx_category the relay category the transaction must be in
+     *
+     * @return the parsed transaction, or NULL
+     */
+    std::shared_ptr<const txpool_parsed_tx> get_parsed_transaction(const crypto::hash& h, relay_category tx_category) const;
+
     /**
      * @brief get a list of all relayable transactions and their hashes
      *
@@ -392,6 +460,18 @@ namespace cryptonote
       */
     uint64_t cookie() const { return m_cookie; }
 
+    /**
+     * @brief get a snapshot of the pool's transaction metadata
+     *
+     * Returns the cached snapshot without taking the pool or blockchain locks
+     * if the pool has not changed since it was taken; otherwise takes them
+     * once to build a new one.  Readers may keep the snapshot as long as they
+     * like, the pool never modifies it.
+     *
+     * @return the snapshot
+     */
+    std::shared_ptr<const txpool_snapshot> get_snapshot() const;
+
     /**
      * @brief get the cumulative txpool weight in bytes
      *
@@ -596,6 +676,9 @@ private:
 
     std::atomic<uint64_t> m_cookie; //!< incremented at each change
 
+    //! latest snapshot, accessed with std::atomic_load/std::atomic_store
+    mutable std::shared_ptr<const txpool_snapshot> m_snapshot;
+
     /**
      * @brief get an iterator to a transaction in the sorted container
      *
@@ -624,6 +707,79 @@ private:
 
     std::unordered_map<crypto::hash, transaction> m_parsed_tx_cache;
 
+    //! verified pool txes kept parsed, with their relay method; only needs its own lock to read
+    std::unordered_map<crypto::hash, std::pair<std::shared_ptr<const txpool_parsed_tx>, relay_method>> m_parsed_tx_index;
+    mutable boost::shared_mutex m_parsed_tx_index_lock;
+    size_t m_parsed_tx_index_bytes; //!< sum of the indexed blob sizes
+
+    //! add a tx to m_parsed_tx_index if within budget, or update its relay method
+    void index_parsed_tx(const transaction &tx, const crypto::hash &id, const cryptonote::blobdata &blob, relay_method tx_relay);
+    //! remove a tx from m_parsed_tx_index
+    void unindex_parsed_tx(const crypto::hash &id);
+
+    struct fee_histogram_bucket
+    {
+      uint64_t weight;
+      uint64_t txs;
+    };
+
+    //! where a pool tx is counted in the fee histogram
+    struct fee_histogram_entry
+    {
+      uint32_t bucket;
+      uint64_t weight;
+      bool broadcasted;
+    };
+
+    std::unordered_map<crypto::hash, fee_histogram_entry> m_fee_histogram_txes;
+    std::array<fee_histogram_bucket, TXPOOL_FEE_HISTOGRAM_BUCKETS> m_fee_histogram_all; //!< every pool tx
+    std::array<fee_histogram_bucket, TXPOOL_FEE_HISTOGRAM_BUCKETS> m_fee_histogram_broadcasted; //!< txes matching relay_category::broadcasted
+
+    //! count a tx in the fee histogram, replacing its previous entry if any
+    void add_to_fee_histogram(const crypto::hash &id, const txpool_tx_meta_t &meta);
+    //! stop counting a tx in the fee histogram
+    void remove_from_fee_histogram(const crypto::hash &id);
+
+    //! what fill_block_template found out about a pool tx, valid until the top block changes
+    struct template_candidate
+    {
+      uint64_t weight;
+      uint64_t fee;
+      relay_method relay;
+      bool eligible; //!< may be mined given its relay method, and is not pruned
+      bool checked; //!< whether ready and key_images are set
+      bool ready;
+      std::vector<crypto::key_image> key_images;
+    };
+
+    //! the last filled template, reused while the pool, chain and parameters stay the same
+    struct block_template_cache
+    {
+      bool valid{false};
+      uint64_t cookie;
+      crypto::hash top_hash;
+      size_t median_weight;
+      uint64_t already_generated_coins;
+      uint8_t version;
+      std::vector<crypto::hash> tx_hashes;
+      size_t total_weight;
+      uint64_t fee;
+      uint64_t expected_reward;
+    };
+
+    /**
+     * @brief get the cached template data of a pool tx, reading its metadata if not cached
+     *
+     * @param txid the hash of the transaction
+     *
+     * @return the candidate, or NULL if the tx's metadata could not be found
+     */
+    template_candidate* get_template_candidate(const crypto::hash &txid);
+
+    std::unordered_map<crypto::hash, template_candidate> m_template_candidates;
+    crypto::hash m_template_candidates_top_hash{crypto::null_hash};
+    block_template_cache m_block_template_cache;
+
     //! Next timestamp that a DB check for relayable txes is allowed
     std::atomic<time_t> m_next_check;
   };
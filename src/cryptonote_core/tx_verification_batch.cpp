@@ -0,0 +1,218 @@
+// Copyright (c) 2021, The Monero Project
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of
+//    conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list
+//    of conditions and the following disclaimer in the documentation and/or other
+//    materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be
+//    used to endorse or promote products derived from this software without specific
+//    prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+// THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <memory>
+#include <unordered_set>
+
+#include "misc_log_ex.h"
+#include "cryptonote_basic/cryptonote_format_utils.h"
+#include "ringct/rctOps.h"
+#include "ringct/rctSigs.h"
+#include "tx_verification_batch.h"
+
+#undef MONERO_DEFAULT_LOG_CATEGORY
+#define MONERO_DEFAULT_LOG_CATEGORY "verify"
+
+namespace cryptonote
+{
+
+//------------------------------------------------------------------
+bool check_tx_semantics_stateless(const transaction &tx, const uint8_t hf_version)
+{
+  if (tx.vin.empty() || !check_inputs_types_supported(tx) || !check_outs_valid(tx) || !check_money_overflow(tx))
+    return false;
+  if (tx.version > 1 && tx.rct_signatures.outPk.size() != tx.vout.size())
+    return false;
+  if (tx.version == 1)
+  {
+    uint64_t amount_in = 0;
+    get_inputs_money_amount(tx, amount_in);
+    if (amount_in <= get_outs_money_amount(tx))
+      return false;
+  }
+
+  std::unordered_set<crypto::key_image> key_images;
+  for (const txin_v &in : tx.vin)
+  {
+    CHECKED_GET_SPECIFIC_VARIANT(in, const txin_to_key, tokey_in, false);
+    if (!key_images.insert(tokey_in.k_image).second)
+      return false;
+    if (hf_version >= 6)
+    {
+      for (size_t n = 1; n < tokey_in.key_offsets.size(); ++n)
+        if (tokey_in.key_offsets[n] == 0)
+          return false;
+    }
+    if (!(rct::scalarmultKey(rct::ki2rct(tokey_in.k_image), rct::curveOrder()) == rct::identity()))
+      return false;
+  }
+
+  return true;
+}
+//------------------------------------------------------------------
+bool expand_rct_signatures(transaction &tx, const rct::ctkeyM &ring_members)
+{
+  rct::rctSig &rv = tx.rct_signatures;
+  rv.message = rct::hash2rct(get_transaction_prefix_hash(tx));
+
+  if (rv.type == rct::RCTTypeFull)
+  {
+    // mixRing is stored by ring member, then by input
+    if (ring_members.empty() || ring_members[0].empty())
+      return false;
+    rv.mixRing.assign(ring_members[0].size(), {});
+    for (const std::vector<rct::ctkey> &ring : ring_members)
+    {
+      if (ring.size() != ring_members[0].size())
+        return false;
+      for (size_t m = 0; m < ring.size(); ++m)
+        rv.mixRing[m].push_back(ring[m]);
+    }
+    if (rv.p.MGs.size() != 1)
+      return false;
+    rv.p.MGs[0].II.resize(tx.vin.size());
+    for (size_t n = 0; n < tx.vin.size(); ++n)
+      rv.p.MGs[0].II[n] = rct::ki2rct(boost::get<txin_to_key>(tx.vin[n]).k_image);
+    return true;
+  }
+
+  rv.mixRing = ring_members;
+  if (rv.type == rct::RCTTypeSimple || rv.type == rct::RCTTypeBulletproof || rv.type == rct::RCTTypeBulletproof2)
+  {
+    if (rv.p.MGs.size() != tx.vin.size())
+      return false;
+    for (size_t n = 0; n < tx.vin.size(); ++n)
+      rv.p.MGs[n].II.assign(1, rct::ki2rct(boost::get<txin_to_key>(tx.vin[n]).k_image));
+    return true;
+  }
+  if (rv.type == rct::RCTTypeCLSAG)
+  {
+    if (rv.p.CLSAGs.size() != tx.vin.size())
+      return false;
+    for (size_t n = 0; n < tx.vin.size(); ++n)
+      rv.p.CLSAGs[n].I = rct::ki2rct(boost::get<txin_to_key>(tx.vin[n]).k_image);
+    return true;
+  }
+
+  return false;
+}
+//------------------------------------------------------------------
+bool check_v1_ring_signatures(const transaction &tx, const rct::ctkeyM &ring_members)
+{
+  if (tx.signatures.size() != tx.vin.size() || ring_members.size() != tx.vin.size())
+    return false;
+
+  const crypto::hash prefix_hash = get_transaction_prefix_hash(tx);
+  std::vector<const crypto::public_key*> pubkeys;
+  for (size_t n = 0; n < tx.vin.size(); ++n)
+  {
+    const std::vector<rct::ctkey> &ring = ring_members[n];
+    if (tx.signatures[n].size() != ring.size())
+      return false;
+
+    for (const rct::ctkey &member : ring)
+      pubkeys.push_back(&rct::rct2pk(member.dest));
+  }
+
+  // all the inputs in one batched call
+  std::vector<crypto::ring_signature_check> checks;
+  checks.reserve(tx.vin.size());
+  size_t offset = 0;
+  for (size_t n = 0; n < tx.vin.size(); ++n)
+  {
+    const txin_to_key &in = boost::get<txin_to_key>(tx.vin[n]);
+    checks.push_back({&prefix_hash, &in.k_image, pubkeys.data() + offset, ring_members[n].size(), tx.signatures[n].data()});
+    offset += ring_members[n].size();
+  }
+
+  std::unique_ptr<bool[]> valid(new bool[checks.size()]);
+  return crypto::check_ring_signatures(checks.data(), checks.size(), valid.get());
+}
+//------------------------------------------------------------------
+tx_verification_result verify_tx_batch(const tx_verification_batch &batch)
+{
+  tx_verification_result result{batch.batch_id, std::vector<uint8_t>(batch.txs.size(), 0)};
+  std::vector<transaction> txs(batch.txs.size());
+  std::vector<uint8_t> &ok = result.verdicts;
+
+  // parse and context free checks; each ring must match its input's offsets
+  for (size_t i = 0; i < txs.size(); ++i)
+  {
+    const tx_verification_job &job = batch.txs[i];
+    if (!parse_and_validate_tx_from_blob(job.tx_blob, txs[i]) || !check_tx_semantics_stateless(txs[i], batch.hf_version))
+      continue;
+    if (job.ring_members.size() != txs[i].vin.size())
+      continue;
+    bool rings_match = true;
+    for (size_t n = 0; n < txs[i].vin.size() && rings_match; ++n)
+      rings_match = job.ring_members[n].size() == boost::get<txin_to_key>(txs[i].vin[n]).key_offsets.size();
+    ok[i] = rings_match;
+  }
+
+  // range proofs and amount balance, batched over the simple rct txs
+  std::vector<const rct::rctSig*> rv_batch;
+  std::vector<size_t> rv_batch_txs;
+  for (size_t i = 0; i < txs.size(); ++i)
+  {
+    if (!ok[i] || txs[i].version == 1)
+      continue;
+    if (!expand_rct_signatures(txs[i], batch.txs[i].ring_members))
+      ok[i] = 0;
+    else if (txs[i].rct_signatures.type == rct::RCTTypeFull)
+      ok[i] = rct::verRct(txs[i].rct_signatures, true);
+    else
+    {
+      rv_batch.push_back(&txs[i].rct_signatures);
+      rv_batch_txs.push_back(i);
+    }
+  }
+  // if the batch fails, find the txs that failed it
+  if (!rv_batch.empty() && !rct::verRctSemanticsSimple(rv_batch))
+  {
+    for (const size_t i : rv_batch_txs)
+      ok[i] = rct::verRctSemanticsSimple(txs[i].rct_signatures);
+  }
+
+  // ring signatures
+  for (size_t i = 0; i < txs.size(); ++i)
+  {
+    if (!ok[i])
+      continue;
+    if (txs[i].version == 1)
+      ok[i] = check_v1_ring_signatures(txs[i], batch.txs[i].ring_members);
+    else if (txs[i].rct_signatures.type == rct::RCTTypeFull)
+      ok[i] = rct::verRct(txs[i].rct_signatures, false);
+    else
+      ok[i] = rct::verRctNonSemanticsSimple(txs[i].rct_signatures);
+  }
+
+  return result;
+}
+//------------------------------------------------------------------
+
+}
@@ -0,0 +1,128 @@
+// Copyright (c) 2021, The Monero Project
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of
+//    conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list
+//    of conditions and the following disclaimer in the documentation and/or other
+//    materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be
+//    used to endorse or promote products derived from this software without specific
+//    prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+// THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "cryptonote_basic/blobdatatype.h"
+#include "cryptonote_basic/cryptonote_basic.h"
+#include "ringct/rctTypes.h"
+#include "serialization/containers.h"
+#include "serialization/serialization.h"
+#include "serialization/string.h"
+
+namespace cryptonote
+{
+  /**
+   * @brief a transaction with everything needed to verify it without chain state
+   *
+   * The ring members are resolved by whoever builds the job (they come from
+   * the database), so the job can be verified anywhere, e.g. by a remote
+   * worker that has no database of its own.
+   */
+  struct tx_verification_job
+  {
+    blobdata tx_blob;
+    rct::ctkeyM ring_members;  // by input, then by ring member
+
+    BEGIN_SERIALIZE_OBJECT()
+      FIELD(tx_blob)
+      FIELD(ring_members)
+    END_SERIALIZE()
+  };
+
+  /**
+   * @brief a batch of transactions verified together, at one hard fork version
+   */
+  struct tx_verification_batch
+  {
+    uint64_t batch_id;
+    uint8_t hf_version;
+    std::vector<tx_verification_job> txs;
+
+    BEGIN_SERIALIZE_OBJECT()
+      VARINT_FIELD(batch_id)
+      FIELD(hf_version)
+      FIELD(txs)
+    END_SERIALIZE()
+  };
+
+  /**
+   * @brief the verdicts of a batch, one per transaction (1 = valid) in batch order
+   */
+  struct tx_verification_result
+  {
+    uint64_t batch_id;
+    std::vector<uint8_t> verdicts;
+
+    BEGIN_SERIALIZE_OBJECT()
+      VARINT_FIELD(batch_id)
+      FIELD(verdicts)
+    END_SERIALIZE()
+  };
+
+  /**
+   * @brief checks the context free rules of a transaction (as core::check_tx_semantic(), minus the weight limit)
+   *
+   * @param tx the transaction
+   * @param hf_version the hard fork version the transaction is verified at
+   */
+  bool check_tx_semantics_stateless(const transaction &tx, uint8_t hf_version);
+
+  /**
+   * @brief fills in the ringct fields that are not serialized (as Blockchain::expand_transaction_2())
+   *
+   * @param tx the transaction, whose rct_signatures are expanded in place
+   * @param ring_members the resolved ring members, by input then by ring member
+   *
+   * @return false if the signature's shape does not match the transaction
+   */
+  bool expand_rct_signatures(transaction &tx, const rct::ctkeyM &ring_members);
+
+  /**
+   * @brief checks the pre-ringct ring signatures of a transaction
+   *
+   * @param tx the transaction
+   * @param ring_members the resolved ring members, by input then by ring member
+   */
+  bool check_v1_ring_signatures(const transaction &tx, const rct::ctkeyM &ring_members);
+
+  /**
+   * @brief verifies a batch: parse, semantics, range proofs (batched), ring signatures
+   *
+   * Does not check key images against the spent set, or anything else that
+   * needs chain state; that stays with the caller.
+   *
+   * @param batch the batch
+   *
+   * @return the batch's verdicts
+   */
+  tx_verification_result verify_tx_batch(const tx_verification_batch &batch);
+}
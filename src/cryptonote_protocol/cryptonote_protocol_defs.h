@@ -186,6 +186,25 @@ namespace cryptonote
     typedef epee::misc_utils::struct_init<request_t> request;
   };
 
+  /************************************************************************/
+  /* NOTIFY_RESPONSE_GET_OBJECTS, compressed, sent to peers that asked    */
+  /* for compression and support it (P2P_SUPPORT_FLAG_ZSTD_SPANS)         */
+  /************************************************************************/
+  struct NOTIFY_RESPONSE_GET_OBJECTS_COMPRESSED
+  {
+    const static int ID = BC_COMMANDS_POOL_BASE + 11;
+
+    struct request_t
+    {
+      std::string payload; // zstd frame of a binary serialized NOTIFY_RESPONSE_GET_OBJECTS::request
+
+      BEGIN_KV_SERIALIZE_MAP()
+        KV_SERIALIZE(payload)
+      END_KV_SERIALIZE_MAP()
+    };
+    typedef epee::misc_utils::struct_init<request_t> request;
+  };
+
   /************************************************************************/
   /*                                                                      */
   /************************************************************************/
@@ -218,10 +237,12 @@ namespace cryptonote
     {
       std::vector<crypto::hash> blocks;
       bool prune;
+      bool compress; // the response may be a NOTIFY_RESPONSE_GET_OBJECTS_COMPRESSED
 
       BEGIN_KV_SERIALIZE_MAP()
         KV_SERIALIZE_CONTAINER_POD_AS_BLOB(blocks)
         KV_SERIALIZE_OPT(prune, false)
+        KV_SERIALIZE_OPT(compress, false)
       END_KV_SERIALIZE_MAP()
     };
     typedef epee::misc_utils::struct_init<request_t> request;
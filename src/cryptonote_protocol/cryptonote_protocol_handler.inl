@@ -44,6 +44,7 @@
 #include "net/network_throttle-detail.hpp"
 #include "common/pruning.h"
 #include "common/util.h"
+#include "sync_compression.h"
 
 #undef MONERO_DEFAULT_LOG_CATEGORY
 #define MONERO_DEFAULT_LOG_CATEGORY "net.cn"
@@ -53,7 +54,8 @@
   do { \
     const auto level = el::Level::Info; \
     const char *cat = "net.p2p.msg"; \
-    if (ELPP->vRegistry()->allowed(level, cat)) { \
+    static el::base::LogSite mlog_site; \
+    if (mlog_site.allowed(level, cat, true)) { \
       init; \
       if (test) \
         el::base::Writer(level, el::Color::Default, __FILE__, __LINE__, ELPP_FUNC, el::base::DispatchAction::NormalLog).construct(cat) << x; \
@@ -73,6 +75,12 @@
 #define PASSIVE_PEER_KICK_TIME (60 * 1000000) // microseconds
 #define DROP_ON_SYNC_WEDGE_THRESHOLD (30 * 1000000000ull) // nanoseconds
 #define LAST_ACTIVITY_STALL_THRESHOLD (2.0f) // seconds
+#define SYNC_SPAN_TARGET_TIME (2 * 1000000) // microseconds, spans are sized to take about this long from their peer
+#define SYNC_SPAN_MIN_BLOCKS 4
+#define SYNC_SPAN_STALL_FACTOR (3.0f) // a span taking that many times longer than its peer's estimate is stalled
+#define SYNC_SPAN_STALL_MIN_TIME (2 * 1000000) // microseconds
+#define SYNC_COMPRESSION_MIN_BYTES (64 * 1024) // smaller spans are sent uncompressed
+#define SYNC_COMPRESSION_LEVEL 1
 #define DROP_PEERS_ON_SCORE -2
 
 namespace cryptonote
@@ -111,6 +119,7 @@ namespace cryptonote
 
     m_block_download_max_size = command_line::get_arg(vm, cryptonote::arg_block_download_max_size);
     m_sync_pruned_blocks = command_line::get_arg(vm, cryptonote::arg_sync_pruned_blocks);
+    m_sync_compression = sync_compression_available() && !command_line::get_arg(vm, cryptonote::arg_no_sync_compression);
 
     return true;
   }
@@ -118,6 +127,7 @@ namespace cryptonote
   template<class t_core>
   bool t_cryptonote_protocol_handler<t_core>::deinit()
   {
+    m_sync_compression_waiter.wait();
     return true;
   }
   //------------------------------------------------------------------------------------------------------------------------
@@ -714,8 +724,14 @@ namespace cryptonote
       size_t tx_idx = 0;
       for(auto& tx_hash: new_block.tx_hashes)
       {
+        // the parsed pool index needs no pool lock, so try it first
+        const std::shared_ptr<const txpool_parsed_tx> indexed = m_core.get_pool_parsed_transaction(tx_hash, relay_category::broadcasted);
         cryptonote::blobdata txblob;
-        if(m_core.get_pool_transaction(tx_hash, txblob, relay_category::broadcasted))
+        if(indexed)
+        {
+          have_tx.push_back({indexed->blob, crypto::null_hash});
+        }
+        else if(m_core.get_pool_transaction(tx_hash, txblob, relay_category::broadcasted))
         {
           have_tx.push_back({txblob, crypto::null_hash});
         }
@@ -1082,6 +1098,43 @@ namespace cryptonote
       return 1;
     }
     context.m_last_request_time = boost::posix_time::microsec_clock::universal_time();
+
+    // big spans for peers that asked for compression are compressed on the threadpool, so this
+    // connection's thread can move on meanwhile
+    size_t blocks_size = 0;
+    for (const auto &element : rsp.blocks)
+    {
+      blocks_size += element.block.size();
+      for (const auto &tx : element.txs)
+        blocks_size += tx.blob.size();
+    }
+    if (arg.compress && m_sync_compression && blocks_size >= SYNC_COMPRESSION_MIN_BYTES)
+    {
+      const boost::uuids::uuid connection_id = context.m_connection_id;
+      const auto response = std::make_shared<NOTIFY_RESPONSE_GET_OBJECTS::request>(std::move(rsp));
+      tools::threadpool::getInstance().submit(&m_sync_compression_waiter, [this, connection_id, response](){
+        const epee::byte_slice blob = epee::serialization::store_t_to_binary(*response);
+        NOTIFY_RESPONSE_GET_OBJECTS_COMPRESSED::request compressed;
+        const bool use_compressed = sync_compress({blob.data(), blob.size()}, SYNC_COMPRESSION_LEVEL, compressed.payload)
+          && compressed.payload.size() < blob.size();
+        m_p2p->for_connection(connection_id, [&](cryptonote_connection_context& context, nodetool::peerid_type peer_id, uint32_t f)->bool{
+          if (use_compressed)
+          {
+            MLOG_P2P_MESSAGE("-->>NOTIFY_RESPONSE_GET_OBJECTS_COMPRESSED: blocks.size()=" << response->blocks.size()
+                << ", " << blob.size() << " -> " << compressed.payload.size() << " bytes");
+            post_notify<NOTIFY_RESPONSE_GET_OBJECTS_COMPRESSED>(compressed, context);
+          }
+          else
+          {
+            MLOG_P2P_MESSAGE("-->>NOTIFY_RESPONSE_GET_OBJECTS: blocks.size()=" << response->blocks.size() << " (not compressible)");
+            post_notify<NOTIFY_RESPONSE_GET_OBJECTS>(*response, context);
+          }
+          return true;
+        });
+      }, true);
+      return 1;
+    }
+
     MLOG_P2P_MESSAGE("-->>NOTIFY_RESPONSE_GET_OBJECTS: blocks.size()="
                      << rsp.blocks.size() << ", rsp.m_current_blockchain_height=" << rsp.current_blockchain_height
                      << ", missed_ids.size()=" << rsp.missed_ids.size());
@@ -1106,6 +1159,25 @@ namespace cryptonote
     return avg / m_avg_buffer.size();
   }
 
+  template<class t_core>
+  int t_cryptonote_protocol_handler<t_core>::handle_response_get_objects_compressed(int command, NOTIFY_RESPONSE_GET_OBJECTS_COMPRESSED::request& arg, cryptonote_connection_context& context)
+  {
+    MLOG_P2P_MESSAGE("Received NOTIFY_RESPONSE_GET_OBJECTS_COMPRESSED (" << arg.payload.size() << " bytes)");
+
+    std::string blob;
+    NOTIFY_RESPONSE_GET_OBJECTS::request rsp;
+    if (!sync_decompress(arg.payload, cryptonote_connection_context::get_max_bytes(NOTIFY_RESPONSE_GET_OBJECTS::ID), blob)
+        || !epee::serialization::load_t_from_binary(rsp, epee::strspan<uint8_t>(blob), &default_levin_limits))
+    {
+      LOG_ERROR_CCONTEXT("sent invalid NOTIFY_RESPONSE_GET_OBJECTS_COMPRESSED, dropping connection");
+      drop_connection(context, false, false);
+      ++m_sync_bad_spans_downloaded;
+      return 1;
+    }
+    MDEBUG(context << " decompressed span: " << arg.payload.size() << " -> " << blob.size() << " bytes");
+    return handle_response_get_objects(NOTIFY_RESPONSE_GET_OBJECTS::ID, rsp, context);
+  }
+  //------------------------------------------------------------------------------------------------------------------------
   template<class t_core>
   int t_cryptonote_protocol_handler<t_core>::handle_response_get_objects(int command, NOTIFY_RESPONSE_GET_OBJECTS::request& arg, cryptonote_connection_context& context)
   {
@@ -1304,6 +1376,8 @@ namespace cryptonote
       // add that new span to the block queue
       const boost::posix_time::time_duration dt = now - request_time;
       const float rate = size * 1e6 / (dt.total_microseconds() + 1);
+      if (!request_time.is_special())
+        context.m_sync_span_estimator.add_span(arg.blocks.size(), dt.total_microseconds() / 1e6);
       MDEBUG(context << " adding span: " << arg.blocks.size() << " at height " << start_height << ", " << dt.total_microseconds()/1e6 << " seconds, " << (rate/1024) << " kB/s, size now " << (m_block_queue.get_data_size() + blocks_size) / 1048576.f << " MB");
       m_block_queue.add_blocks(start_height, arg.blocks, context.m_connection_id, context.m_remote_address, rate, blocks_size);
 
@@ -1885,6 +1959,26 @@ skip:
           return true;
         }
 
+        // reassign early if the downloading peer takes much longer than its own past spans say it should,
+        // unless we expect to be slower still
+        if (dt >= SYNC_SPAN_STALL_MIN_TIME && connection_id != context.m_connection_id)
+        {
+          double expected_seconds = 0;
+          uint64_t span_blocks = 0;
+          m_p2p->for_connection(connection_id, [&](cryptonote_connection_context& ctx, nodetool::peerid_type peer_id, uint32_t f)->bool{
+            span_blocks = ctx.m_sync_span_blocks;
+            expected_seconds = ctx.m_sync_span_estimator.get_expected_seconds(span_blocks);
+            return true;
+          });
+          const double our_expected_seconds = context.m_sync_span_estimator.get_expected_seconds(span_blocks);
+          if (expected_seconds > 0 && dt / 1e6 > SYNC_SPAN_STALL_FACTOR * expected_seconds && our_expected_seconds < dt / 1e6)
+          {
+            MDEBUG(context << " we should download it as it's taking " << dt/1e6 << " seconds, expected "
+                << expected_seconds << " from its peer, " << our_expected_seconds << " from us");
+            return true;
+          }
+        }
+
         // in standby, be ready to double download early since we're idling anyway
         // let the fastest peer trigger first
         const double dl_speed = context.m_max_speed_down;
@@ -2189,7 +2283,13 @@ skip:
       NOTIFY_REQUEST_GET_OBJECTS::request req;
       bool is_next = false;
       size_t count = 0;
-      const size_t count_limit = m_core.get_block_sync_size(m_core.get_current_blockchain_height());
+      // size spans so this peer sends them in about SYNC_SPAN_TARGET_TIME, from the time its last spans took:
+      // fast peers get the full sync size (--block-sync-size, or the tuned batch size), which is the upper bound,
+      // and slow ones get smaller spans so they don't hold up the queue as long
+      const size_t block_sync_size = m_core.get_block_sync_size(m_core.get_current_blockchain_height());
+      const size_t count_limit = context.m_sync_span_estimator.get_span_blocks(SYNC_SPAN_TARGET_TIME / 1e6,
+          SYNC_SPAN_MIN_BLOCKS, std::min<size_t>(block_sync_size, CURRENCY_PROTOCOL_MAX_OBJECT_REQUEST_COUNT),
+          block_sync_size);
       std::pair<uint64_t, uint64_t> span = std::make_pair(0, 0);
       if (force_next_span)
       {
@@ -2309,6 +2409,15 @@ skip:
 
         req.prune = should_ask_for_pruned_data(context, span.first, span.second, true);
 
+        // ask for a compressed span if the peer can make one
+        if (m_sync_compression)
+        {
+          m_p2p->for_connection(context.m_connection_id, [&req](cryptonote_connection_context& ctx, nodetool::peerid_type peer_id, uint32_t support_flags)->bool{
+            req.compress = (support_flags & P2P_SUPPORT_FLAG_ZSTD_SPANS) != 0;
+            return true;
+          });
+        }
+
         // if we need to ask for full data and that peer does not have the right stripe, we can't ask it
         if (!req.prune && context.m_pruning_seed)
         {
@@ -2324,6 +2433,7 @@ skip:
         context.m_last_request_time = boost::posix_time::microsec_clock::universal_time();
         context.m_expect_height = span.first;
         context.m_expect_response = NOTIFY_RESPONSE_GET_OBJECTS::ID;
+        context.m_sync_span_blocks = req.blocks.size();
         MLOG_P2P_MESSAGE("-->>NOTIFY_REQUEST_GET_OBJECTS: blocks.size()=" << req.blocks.size()
             << "requested blocks count=" << count << " / " << count_limit << " from " << span.first << ", first hash " << req.blocks.front());
         //epee::net_utils::network_throttle_manager::get_global_throttle_inreq().logger_handle_net("log/dr-monero/net/req-all.data", sec, get_avg_block_size());
@@ -33,6 +33,7 @@
 #include <boost/uuid/uuid_io.hpp>
 #include <chrono>
 #include <deque>
+#include <map>
 #include <stdexcept>
 #include <utility>
 
@@ -85,6 +86,11 @@ namespace levin
     using fluff_duration = crypto::random_poisson_subseconds::result_type;
     constexpr const fluff_duration fluff_average_out{fluff_duration{fluff_average_in} / 2};
 
+    /*! Stem txs for the same peer within this window go out in one
+        notification. It is far below the fluff and embargo delays, and only
+        matters when txs arrive faster than the window. */
+    constexpr const std::chrono::milliseconds stem_batch_window{CRYPTONOTE_DANDELIONPP_STEM_BATCH_WINDOW};
+
     /*! Select a randomized duration from 0 to `range`. The precision will be to
         the systems `steady_clock`. As an example, supplying 3 seconds to this
         function will select a duration from [0, 3] seconds, and the increments
@@ -269,7 +275,9 @@ namespace levin
           noise(std::move(noise_in)),
           next_epoch(io_service),
           flush_txs(io_service),
+          flush_stems(io_service),
           strand(io_service),
+          stem_txs(),
           map(),
           channels(),
           connection_count(0),
@@ -286,6 +294,7 @@ namespace levin
       const epee::byte_slice noise; //!< `!empty()` means zone is using noise channels
       boost::asio::steady_timer next_epoch;
       boost::asio::steady_timer flush_txs;
+      boost::asio::steady_timer flush_stems;
       boost::asio::io_service::strand strand;
       struct context_t {
         std::vector<cryptonote::blobdata> fluff_txs;
@@ -293,6 +302,7 @@ namespace levin
         bool m_is_income;
       };
       boost::unordered_map<boost::uuids::uuid, context_t> contexts;
+      boost::unordered_map<boost::uuids::uuid, std::vector<cryptonote::blobdata>> stem_txs; //!< Stem txs waiting for `flush_stems`, by stem
       net::dandelionpp::connection_map map;//!< Tracks outgoing uuid's for noise channels or Dandelion++ stems
       std::deque<noise_channel> channels;  //!< Never touch after init; only update elements on `noise_channel.strand`
       std::atomic<std::size_t> connection_count; //!< Only update in strand, can be read at any time
@@ -393,10 +403,18 @@ namespace levin
 	   network is therefore replacing the sybil protection of Dandelion++.
 	   Dandelion++ stem phase over i2p/tor is also worth investigating
 	   (with/without "noise"?). */
+        // connections flushing the same txs (the common case for a burst) share one serialized notification
+        std::map<std::vector<blobdata>, epee::byte_slice> messages;
         for (auto& connection : connections)
         {
           std::sort(connection.first.begin(), connection.first.end()); // don't leak receive order
-          make_payload_send_txs(*zone_->p2p, std::move(connection.first), connection.second, zone_->pad_txs, true);
+          auto message = messages.find(connection.first);
+          if (message == messages.end())
+          {
+            epee::byte_slice blob = make_tx_message(std::vector<blobdata>{connection.first}, zone_->pad_txs, true).finalize_notify(NOTIFY_NEW_TRANSACTIONS::ID);
+            message = messages.emplace(std::move(connection.first), std::move(blob)).first;
+          }
+          zone_->p2p->send(message->second.clone(), connection.second);
         }
 
         if (next_flush != std::chrono::steady_clock::time_point::max())
@@ -535,6 +553,60 @@ namespace levin
       }
     };
 
+    //! Sends the txs batched for each stem in one notification, and fluffs the txs of stems that failed.
+    struct stem_flush
+    {
+      std::shared_ptr<detail::zone> zone_;
+      i_core_events* core_;
+
+      //! \pre Called within `zone->strand`.
+      static void queue(std::shared_ptr<detail::zone> zone, i_core_events* core)
+      {
+        assert(zone != nullptr);
+        assert(zone->strand.running_in_this_thread());
+
+        detail::zone& this_zone = *zone;
+        this_zone.flush_stems.expires_from_now(stem_batch_window);
+        this_zone.flush_stems.async_wait(this_zone.strand.wrap(stem_flush{std::move(zone), core}));
+      }
+
+      void operator()(const boost::system::error_code error)
+      {
+        if (!zone_ || !core_ || !zone_->p2p)
+          return;
+
+        assert(zone_->strand.running_in_this_thread());
+
+        if (error && error != boost::system::errc::operation_canceled)
+          throw boost::system::system_error{error, "stem_flush timer failed"};
+
+        auto stems = std::move(zone_->stem_txs);
+        zone_->stem_txs.clear();
+        for (auto& stem : stems)
+        {
+          if (make_payload_send_txs(*zone_->p2p, std::vector<blobdata>{stem.second}, stem.first, zone_->pad_txs, false))
+          {
+            MDEBUG("Sent " << stem.second.size() << " transaction(s) to " << stem.first << " using Dandelion++ stem");
+            continue;
+          }
+
+          // connection list may be outdated, try again once (the sources are mixed by now)
+          update_channels::run(zone_, get_out_connections(*zone_->p2p, core_));
+          const boost::uuids::uuid destination = zone_->map.get_stem(boost::uuids::nil_uuid());
+          if (!destination.is_nil() && destination != stem.first &&
+            make_payload_send_txs(*zone_->p2p, std::vector<blobdata>{stem.second}, destination, zone_->pad_txs, false))
+          {
+            MDEBUG("Sent " << stem.second.size() << " transaction(s) to " << destination << " using Dandelion++ stem");
+            continue;
+          }
+
+          MERROR("Unable to send transaction(s) via Dandelion++ stem");
+          core_->on_transactions_relayed(epee::to_span(stem.second), relay_method::fluff);
+          fluff_notify::run(zone_, epee::to_span(stem.second), boost::uuids::nil_uuid());
+        }
+      }
+    };
+
     //! Checks fluff status for this node, and then does stem or fluff for txes
     struct dandelionpp_notify
     {
@@ -555,11 +627,18 @@ namespace levin
           for (int tries = 2; 0 < tries; tries--)
           {
             const boost::uuids::uuid destination = zone_->map.get_stem(source_);
-            if (!destination.is_nil() && make_payload_send_txs(*zone_->p2p, std::vector<blobdata>{txs_}, destination, zone_->pad_txs, false))
+            if (!destination.is_nil())
             {
-              /* Source is intentionally omitted in debug log for privacy - a
-                 nil uuid indicates source is that node. */
-              MDEBUG("Sent " << txs_.size() << " transaction(s) to " << destination << " using Dandelion++ stem");
+              /* Queue for the stem, so that txs arriving together share one
+                 notification. Source is intentionally omitted in debug log
+                 for privacy - a nil uuid indicates source is that node. */
+              MDEBUG("Queueing " << txs_.size() << " transaction(s) for " << destination << " using Dandelion++ stem");
+              const bool queue_flush = zone_->stem_txs.empty();
+              std::vector<blobdata>& stem_txs = zone_->stem_txs[destination];
+              stem_txs.reserve(stem_txs.size() + txs_.size());
+              std::move(txs_.begin(), txs_.end(), std::back_inserter(stem_txs));
+              if (queue_flush)
+                stem_flush::queue(std::move(zone_), core_);
               return;
             }
 
@@ -795,6 +874,7 @@ namespace levin
 
     for (noise_channel& channel : zone_->channels)
       channel.next_noise.cancel();
+    zone_->flush_stems.cancel();
   }
 
   void notify::run_fluff()
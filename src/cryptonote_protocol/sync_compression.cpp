@@ -0,0 +1,80 @@
+// Copyright (c) 2021, The Monero Project
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of
+//    conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list
+//    of conditions and the following disclaimer in the documentation and/or other
+//    materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be
+//    used to endorse or promote products derived from this software without specific
+//    prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+// THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+#include "sync_compression.h"
+
+namespace cryptonote
+{
+  bool sync_compression_available() noexcept
+  {
+#ifdef HAVE_ZSTD
+    return true;
+#else
+    return false;
+#endif
+  }
+
+  bool sync_compress(const epee::span<const std::uint8_t> data, int level, std::string &out)
+  {
+#ifdef HAVE_ZSTD
+    out.resize(ZSTD_compressBound(data.size()));
+    const size_t size = ZSTD_compress(&out[0], out.size(), data.data(), data.size(), level);
+    if (ZSTD_isError(size))
+    {
+      out.clear();
+      return false;
+    }
+    out.resize(size);
+    return true;
+#else
+    return false;
+#endif
+  }
+
+  bool sync_decompress(const std::string &data, std::size_t max_size, std::string &out)
+  {
+#ifdef HAVE_ZSTD
+    const unsigned long long content_size = ZSTD_getFrameContentSize(data.data(), data.size());
+    if (content_size == ZSTD_CONTENTSIZE_UNKNOWN || content_size == ZSTD_CONTENTSIZE_ERROR || content_size > max_size)
+      return false;
+    out.resize(content_size);
+    const size_t size = ZSTD_decompress(out.empty() ? nullptr : &out[0], out.size(), data.data(), data.size());
+    if (ZSTD_isError(size) || size != content_size)
+    {
+      out.clear();
+      return false;
+    }
+    return true;
+#else
+    return false;
+#endif
+  }
+}
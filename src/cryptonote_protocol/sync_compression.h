@@ -0,0 +1,61 @@
+// Copyright (c) 2021, The Monero Project
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of
+//    conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list
+//    of conditions and the following disclaimer in the documentation and/or other
+//    materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be
+//    used to endorse or promote products derived from this software without specific
+//    prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+// THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "span.h"
+
+namespace cryptonote
+{
+  //! true if this build can compress block sync payloads (with zstd)
+  bool sync_compression_available() noexcept;
+
+  /**
+   * @brief compresses a sync payload into a single zstd frame
+   *
+   * @param data the payload
+   * @param level the zstd level (low levels are fast enough to keep up with a fast link)
+   * @param out the frame
+   * @return false if compression is not available or failed
+   */
+  bool sync_compress(const epee::span<const std::uint8_t> data, int level, std::string &out);
+
+  /**
+   * @brief decompresses a zstd frame made by sync_compress()
+   *
+   * @param data the frame
+   * @param max_size the largest payload accepted: frames that do not state their payload size, or state a
+   *   larger one, are refused before anything is allocated
+   * @param out the payload
+   * @return false if compression is not available, or the frame is invalid or too large
+   */
+  bool sync_decompress(const std::string &data, std::size_t max_size, std::string &out);
+}
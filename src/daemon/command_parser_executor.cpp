@@ -1077,4 +1077,25 @@ show_list:
   return true;
 }
 
+bool t_command_parser_executor::perf_histograms(const std::vector<std::string>& args)
+{
+  std::string mode;
+  bool clear = false;
+
+  for (const std::string &arg: args)
+  {
+    if (arg == "on" || arg == "off")
+      mode = arg;
+    else if (arg == "clear")
+      clear = true;
+    else
+    {
+      std::cout << "Invalid syntax: expected [on|off] [clear]. For more details, use the help command." << std::endl;
+      return true;
+    }
+  }
+
+  return m_executor.perf_histograms(mode, clear);
+}
+
 } // namespace daemonize
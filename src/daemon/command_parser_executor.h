@@ -156,6 +156,8 @@ public:
   bool set_bootstrap_daemon(const std::vector<std::string>& args);
 
   bool flush_cache(const std::vector<std::string>& args);
+
+  bool perf_histograms(const std::vector<std::string>& args);
 };
 
 } // namespace daemonize
@@ -336,6 +336,12 @@ t_command_server::t_command_server(
     , "flush_cache [bad-txs] [bad-blocks]"
     , "Flush the specified cache(s)."
     );
+    m_command_lookup.set_handler(
+      "perf_histograms"
+    , std::bind(&t_command_parser_executor::perf_histograms, &m_parser, p::_1)
+    , "perf_histograms [on|off] [clear]"
+    , "Print the timing histograms gathered by the performance timers, after optionally switching them from logging to histograms (on) or back (off). Use clear to start them over after printing."
+    );
 }
 
 bool t_command_server::process_command_str(const std::string& cmd)
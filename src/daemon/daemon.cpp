@@ -82,7 +82,7 @@ public:
       boost::program_options::variables_map const & vm
     )
     : core{vm}
-    , protocol{vm, core, command_line::get_arg(vm, cryptonote::arg_offline)}
+    , protocol{vm, core, command_line::get_arg(vm, cryptonote::arg_offline) || command_line::get_arg(vm, cryptonote::arg_rpc_replica)}
     , p2p{vm, protocol}
     , zmq{nullptr}
   {
@@ -90,7 +90,9 @@ public:
     protocol.set_p2p_endpoint(p2p.get());
     core.set_protocol(protocol.get());
 
-    const auto restricted = command_line::get_arg(vm, cryptonote::core_rpc_server::arg_restricted_rpc);
+    // a replica only serves the restricted set: the rest either writes or needs p2p
+    const bool replica = core.get().rpc_replica();
+    const auto restricted = replica || command_line::get_arg(vm, cryptonote::core_rpc_server::arg_restricted_rpc);
     const auto main_rpc_port = command_line::get_arg(vm, cryptonote::core_rpc_server::arg_rpc_bind_port);
     const auto restricted_rpc_port_arg = cryptonote::core_rpc_server::arg_rpc_restricted_bind_port;
     const bool has_restricted_rpc_port_arg = !command_line::is_arg_defaulted(vm, restricted_rpc_port_arg);
@@ -102,7 +104,11 @@ public:
       rpcs.emplace_back(new t_rpc{vm, core, p2p, true, restricted_rpc_port, "restricted", true});
     }
 
-    if (!command_line::get_arg(vm, daemon_args::arg_zmq_rpc_disabled))
+    if (replica)
+    {
+      MGINFO("ZMQ RPC disabled on a read-only RPC replica");
+    }
+    else if (!command_line::get_arg(vm, daemon_args::arg_zmq_rpc_disabled))
     {
       zmq.reset(new zmq_internals{core, p2p});
 
@@ -442,6 +442,29 @@ static float get_sync_percentage(const cryptonote::COMMAND_RPC_GET_INFO::respons
   return get_sync_percentage(ires.height, ires.target_height);
 }
 
+// upper bound of the bucket holding the given fraction of commits, as a string
+static std::string get_commit_latency_percentile(const std::vector<uint64_t> &histogram, double fraction)
+{
+  uint64_t total = 0;
+  for (const uint64_t n: histogram)
+    total += n;
+  if (total == 0)
+    return "n/a";
+  uint64_t seen = 0;
+  for (size_t i = 0; i < histogram.size(); ++i)
+  {
+    seen += histogram[i];
+    if (seen >= total * fraction)
+      return i + 1 < histogram.size() ? "<" + std::to_string(1ull << i) + " ms" : ">=" + std::to_string(1ull << (i - 1)) + " ms";
+  }
+  return "n/a";
+}
+
+static double get_hit_rate(uint64_t hits, uint64_t misses)
+{
+  return hits + misses ? 100.0 * hits / (hits + misses) : 0.0;
+}
+
 bool t_rpc_command_executor::show_status() {
   cryptonote::COMMAND_RPC_GET_INFO::request ireq;
   cryptonote::COMMAND_RPC_GET_INFO::response ires;
@@ -540,6 +563,25 @@ bool t_rpc_command_executor::show_status() {
     ;
   }
 
+  if (ires.sync_batch_blocks && ires.height < net_height)
+  {
+    str << boost::format(", syncing %.1f blocks/s in batches of %llu, commit latency p50 %s, p99 %s")
+      % ires.sync_blocks_per_second
+      % (unsigned long long)ires.sync_batch_blocks
+      % get_commit_latency_percentile(ires.db_commit_ms_histogram, 0.5)
+      % get_commit_latency_percentile(ires.db_commit_ms_histogram, 0.99)
+    ;
+  }
+
+  // restricted RPC does not disclose hash cache stats either
+  if (ires.tx_hashes_calculated + ires.tx_hashes_cached > 0)
+  {
+    str << boost::format(", tx hash cache hits %.1f%% (prefix %.1f%%)")
+      % get_hit_rate(ires.tx_hashes_cached, ires.tx_hashes_calculated)
+      % get_hit_rate(ires.tx_prefix_hashes_cached, ires.tx_prefix_hashes_calculated)
+    ;
+  }
+
   tools::success_msg_writer() << str.str();
 
   return true;
@@ -2469,6 +2511,44 @@ bool t_rpc_command_executor::flush_cache(bool bad_txs, bool bad_blocks)
     return true;
 }
 
+bool t_rpc_command_executor::perf_histograms(const std::string &mode, bool clear)
+{
+    cryptonote::COMMAND_RPC_PERF_HISTOGRAMS::request req;
+    cryptonote::COMMAND_RPC_PERF_HISTOGRAMS::response res;
+    std::string fail_message = "Unsuccessful";
+    epee::json_rpc::error error_resp;
+
+    req.mode = mode;
+    req.clear = clear;
+
+    if (m_is_rpc)
+    {
+        if (!m_rpc_client->json_rpc_request(req, res, "perf_histograms", fail_message.c_str()))
+        {
+            return true;
+        }
+    }
+    else
+    {
+        if (!m_rpc_server->on_perf_histograms(req, res, error_resp) || res.status != CORE_RPC_STATUS_OK)
+        {
+            tools::fail_msg_writer() << make_error(fail_message, res.status);
+            return true;
+        }
+    }
+
+    tools::success_msg_writer() << "Performance timer histograms are " << (res.enabled ? "on" : "off");
+    for (const auto &h: res.histograms)
+    {
+        tools::msg_writer() << h.category << " " << h.name << ": " << h.count << " calls, " << h.total_ns / 1000 << " us total, "
+            << h.total_ns / std::max<uint64_t>(h.count, 1) << " ns mean";
+        for (const auto &b: h.buckets)
+            tools::msg_writer() << "  < " << std::setw(12) << b.limit_ns << " ns: " << b.count;
+    }
+
+    return true;
+}
+
 bool t_rpc_command_executor::rpc_payments()
 {
     cryptonote::COMMAND_RPC_ACCESS_DATA::request req;
@@ -174,6 +174,8 @@ public:
   bool rpc_payments();
 
   bool flush_cache(bool bad_txs, bool invalid_blocks);
+
+  bool perf_histograms(const std::string &mode, bool clear);
 };
 
 } // namespace daemonize
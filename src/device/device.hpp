@@ -157,6 +157,17 @@ namespace hw {
         /*                               SUB ADDRESS                               */
         /* ======================================================================= */
         virtual bool  derive_subaddress_public_key(const crypto::public_key &pub, const crypto::key_derivation &derivation, const std::size_t output_index,  crypto::public_key &derived_pub) = 0;
+        // batched derive_subaddress_public_key(): valid[i] reports the result for pubs[i], returns true if all succeeded
+        virtual bool  derive_subaddress_public_keys(const crypto::public_key *pubs, const crypto::key_derivation *derivations, const std::size_t *output_indices, std::size_t num_pubs, crypto::public_key *derived_pubs, bool *valid)
+        {
+            bool all_valid = true;
+            for (std::size_t i = 0; i < num_pubs; ++i)
+            {
+                valid[i] = derive_subaddress_public_key(pubs[i], derivations[i], output_indices[i], derived_pubs[i]);
+                all_valid = all_valid && valid[i];
+            }
+            return all_valid;
+        }
         virtual crypto::public_key  get_subaddress_spend_public_key(const cryptonote::account_keys& keys, const cryptonote::subaddress_index& index) = 0;
         virtual std::vector<crypto::public_key>  get_subaddress_spend_public_keys(const cryptonote::account_keys &keys, uint32_t account, uint32_t begin, uint32_t end) = 0;
         virtual cryptonote::account_public_address  get_subaddress(const cryptonote::account_keys& keys, const cryptonote::subaddress_index &index) = 0;
@@ -171,6 +182,17 @@ namespace hw {
         virtual bool  sc_secret_add( crypto::secret_key &r, const crypto::secret_key &a, const crypto::secret_key &b) = 0;
         virtual crypto::secret_key  generate_keys(crypto::public_key &pub, crypto::secret_key &sec, const crypto::secret_key& recovery_key = crypto::secret_key(), bool recover = false) = 0;
         virtual bool  generate_key_derivation(const crypto::public_key &pub, const crypto::secret_key &sec, crypto::key_derivation &derivation) = 0;
+        // batched generate_key_derivation(): valid[i] reports the result for pubs[i], returns true if all succeeded
+        virtual bool  generate_key_derivations(const crypto::public_key *pubs, std::size_t num_pubs, const crypto::secret_key &sec, crypto::key_derivation *derivations, bool *valid)
+        {
+            bool all_valid = true;
+            for (std::size_t i = 0; i < num_pubs; ++i)
+            {
+                valid[i] = generate_key_derivation(pubs[i], sec, derivations[i]);
+                all_valid = all_valid && valid[i];
+            }
+            return all_valid;
+        }
         virtual bool  conceal_derivation(crypto::key_derivation &derivation, const crypto::public_key &tx_pub_key, const std::vector<crypto::public_key> &additional_tx_pub_keys, const crypto::key_derivation &main_derivation, const std::vector<crypto::key_derivation> &additional_derivations) = 0;
         virtual bool  derivation_to_scalar(const crypto::key_derivation &derivation, const size_t output_index, crypto::ec_scalar &res) = 0;
         virtual bool  derive_secret_key(const crypto::key_derivation &derivation, const std::size_t output_index, const crypto::secret_key &sec,  crypto::secret_key &derived_sec) = 0;
@@ -233,6 +255,8 @@ namespace hw {
         virtual bool clsag_prepare(const rct::key &p, const rct::key &z, rct::key &I, rct::key &D, const rct::key &H, rct::key &a, rct::key &aG, rct::key &aH) = 0;
         virtual bool clsag_hash(const rct::keyV &data, rct::key &hash) = 0;
         virtual bool clsag_sign(const rct::key &c, const rct::key &a, const rct::key &p, const rct::key &z, const rct::key &mu_P, const rct::key &mu_C, rct::key &s) = 0;
+        // true when clsag_hash is a plain hash_to_scalar, so the signer may hash rounds from a saved prefix state
+        virtual bool  has_clsag_hash_prefix(void) const { return false; }
 
         virtual bool  close_tx(void) = 0;
 
@@ -124,6 +124,10 @@ namespace hw {
             return crypto::wallet::derive_subaddress_public_key(out_key, derivation, output_index,derived_key);
         }
 
+        bool device_default::derive_subaddress_public_keys(const crypto::public_key *out_keys, const crypto::key_derivation *derivations, const std::size_t *output_indices, std::size_t num_keys, crypto::public_key *derived_keys, bool *valid) {
+            return crypto::wallet::derive_subaddress_public_keys(out_keys, derivations, output_indices, num_keys, derived_keys, valid);
+        }
+
         crypto::public_key device_default::get_subaddress_spend_public_key(const cryptonote::account_keys& keys, const cryptonote::subaddress_index &index) {
             if (index.is_zero())
               return keys.m_account_address.m_spend_public_key;
@@ -143,8 +147,7 @@ namespace hw {
         std::vector<crypto::public_key>  device_default::get_subaddress_spend_public_keys(const cryptonote::account_keys &keys, uint32_t account, uint32_t begin, uint32_t end) {
             CHECK_AND_ASSERT_THROW_MES(begin <= end, "begin > end");
 
-            std::vector<crypto::public_key> pkeys;
-            pkeys.reserve(end - begin);
+            std::vector<crypto::public_key> pkeys(end - begin);
             cryptonote::subaddress_index index = {account, begin};
 
             ge_p3 p3;
@@ -153,28 +156,38 @@ namespace hw {
                 "ge_frombytes_vartime failed to convert spend public key");
             ge_p3_to_cached(&cached, &p3);
 
-            for (uint32_t idx = begin; idx < end; ++idx)
+            // keep each group's sums in projective coordinates and compress them together, so they share one field
+            // inversion (group size matches the inversion sharing inside ge_tobytes_batch())
+            static constexpr uint32_t batch_size = 64;
+            ge_p2 results[batch_size];
+            for (uint32_t base = begin; base < end; base += batch_size)
             {
-                index.minor = idx;
-                if (index.is_zero())
+                const uint32_t count = std::min(batch_size, end - base);
+                for (uint32_t i = 0; i < count; ++i)
                 {
-                    pkeys.push_back(keys.m_account_address.m_spend_public_key);
-                    continue;
+                    index.minor = base + i;
+                    if (index.is_zero())
+                    {
+                        // B itself, patched in below
+                        ge_p2_0(&results[i]);
+                        continue;
+                    }
+                    crypto::secret_key m = get_subaddress_secret_key(keys.m_view_secret_key, index);
+
+                    // M = m*G
+                    ge_scalarmult_base(&p3, (const unsigned char*)m.data);
+
+                    // D = B + M
+                    ge_p1p1 p1p1;
+                    ge_add(&p1p1, &p3, &cached);
+                    ge_p1p1_to_p2(&results[i], &p1p1);
                 }
-                crypto::secret_key m = get_subaddress_secret_key(keys.m_view_secret_key, index);
-
-                // M = m*G
-                ge_scalarmult_base(&p3, (const unsigned char*)m.data);
-
-                // D = B + M
-                crypto::public_key D;
-                ge_p1p1 p1p1;
-                ge_add(&p1p1, &p3, &cached);
-                ge_p1p1_to_p3(&p3, &p1p1);
-                ge_p3_tobytes((unsigned char*)D.data, &p3);
-
-                pkeys.push_back(D);
+                ge_tobytes_batch((unsigned char*)pkeys[base - begin].data, results, count);
             }
+
+            index.minor = begin;
+            if (index.is_zero() && begin < end)
+                pkeys[0] = keys.m_account_address.m_spend_public_key;
             return pkeys;
         }
 
@@ -240,6 +253,10 @@ namespace hw {
             return crypto::wallet::generate_key_derivation(key1, key2, derivation);
         }
 
+        bool device_default::generate_key_derivations(const crypto::public_key *pubs, std::size_t num_pubs, const crypto::secret_key &sec, crypto::key_derivation *derivations, bool *valid) {
+            return crypto::wallet::generate_key_derivations(pubs, num_pubs, sec, derivations, valid);
+        }
+
         bool device_default::derivation_to_scalar(const crypto::key_derivation &derivation, const size_t output_index, crypto::ec_scalar &res){
             crypto::derivation_to_scalar(derivation,output_index, res);
             return true;
@@ -38,12 +38,15 @@ extern "C"
 #include "crypto/crypto-ops.h"
 }
 #include "cryptonote_config.h"
+#include "grootle_generators.h"
 #include "misc_log_ex.h"
+#include "mock_tx_phase_timers.h"
 #include "mock_tx_utils.h"
 #include "ringct/multiexp.h"
 #include "ringct/rctOps.h"
 #include "ringct/rctTypes.h"
 #include "seraphis_crypto_utils.h"
+#include "seraphis_transcript.h"
 
 //third party headers
 
@@ -60,13 +63,9 @@ namespace sp
 
 /// File-scope data
 
-// config (todo: move to config file)
-const char HASH_KEY_GROOTLE_Hi_A[] = "grootle Hi A";
-const char HASH_KEY_GROOTLE_Hi_B[] = "grootle Hi B";
-
-// generators
-static ge_p3 Hi_A_p3[GROOTLE_MAX_MN];
-static ge_p3 Hi_B_p3[GROOTLE_MAX_MN];
+// generators (Hi_A, Hi_B are baked in at build time)
+static const ge_p3 (&Hi_A_p3)[GROOTLE_MAX_MN] = grootle_Hi_A_p3;
+static const ge_p3 (&Hi_B_p3)[GROOTLE_MAX_MN] = grootle_Hi_B_p3;
 static ge_p3 G_p3;
 
 // Useful scalar and group constants
@@ -91,23 +90,7 @@ static void init_gens()
     static bool init_done = false;
     if (init_done) return;
 
-    // Build Hi generators
-    // H_i = keccak_to_pt("grootle Hi", i)
-    const std::string Hi_A_salt(HASH_KEY_GROOTLE_Hi_A);
-    for (std::size_t i = 0; i < GROOTLE_MAX_MN; ++i)
-    {
-        std::string hash = Hi_A_salt + tools::get_varint_data(i);
-        hash_to_p3(Hi_A_p3[i], rct::hash2rct(crypto::cn_fast_hash(hash.data(), hash.size())));
-    }
-
-    const std::string Hi_B_salt(HASH_KEY_GROOTLE_Hi_B);
-    for (std::size_t i = 0; i < GROOTLE_MAX_MN; ++i)
-    {
-        std::string hash = Hi_B_salt + tools::get_varint_data(i);
-        hash_to_p3(Hi_B_p3[i], rct::hash2rct(crypto::cn_fast_hash(hash.data(), hash.size())));
-    }
-
-    // get G
+    // get G (Hi_A, Hi_B are precomputed, see grootle_generators.h)
     G_p3 = get_G_p3_gen();
 
     init_done = true;
@@ -197,10 +180,19 @@ static void grootle_matrix_commitment(const rct::key &x,  //blinding factor
 //-------------------------------------------------------------------------------------------------------------------
 // Initialize transcript
 //-------------------------------------------------------------------------------------------------------------------
-static void transcript_init(rct::key &transcript)
+static void transcript_init(SpTranscript &transcript_inout)
 {
-    std::string salt(config::HASH_KEY_GROOTLE_TRANSCRIPT);
-    rct::hash_to_scalar(transcript, salt.data(), salt.size());
+    // H("domain-sep") is a constant
+    static const rct::key domain_separator{
+            []()
+            {
+                SpTranscript salt;
+                salt.absorb_string(config::HASH_KEY_GROOTLE_TRANSCRIPT);
+                return salt.challenge();
+            }()
+        };
+
+    transcript_inout.absorb(domain_separator);
 }
 //-------------------------------------------------------------------------------------------------------------------
 // Fiat-Shamir challenge
@@ -209,56 +201,42 @@ static void transcript_init(rct::key &transcript)
 // note: in Triptych notation, c == xi
 //-------------------------------------------------------------------------------------------------------------------
 static rct::key compute_challenge(const rct::key &message,
-    const rct::keyM &M,
-    const rct::keyV &C_offsets,
+    const rct::KeyMatrix &M,
+    const epee::span<const rct::key> C_offsets,
     const rct::key &A,
     const rct::key &B,
     const rct::keyM &X)
 {
-    for (const auto &tuple : M)
-        CHECK_AND_ASSERT_THROW_MES(tuple.size() == C_offsets.size(), "Transcript challenge inputs have incorrect size!");
+    CHECK_AND_ASSERT_THROW_MES(M.cols() == C_offsets.size(), "Transcript challenge inputs have incorrect size!");
 
     // initialize transcript message
-    rct::key challenge;
-    transcript_init(challenge);
-
-    // collect challenge string
-    std::string hash;
+    SpTranscript transcript;
+    transcript_init(transcript);
 
+    // absorb challenge elements
     std::size_t m{0};
     if (X.size())
         m = X[0].size();
 
-    hash.reserve(((M.size() + 1)*C_offsets.size() + m*X.size() + 4)*sizeof(rct::key));
-    hash = std::string((const char*) challenge.bytes, sizeof(challenge));
-    hash += std::string((const char*) message.bytes, sizeof(message));
-    for (const auto &tuple : M)
-    {
-        for (const auto &key : tuple)
-            hash += std::string((const char*) key.bytes, sizeof(key));
-    }
-    for (const auto &offset : C_offsets)
-    {
-        hash += std::string((const char*) offset.bytes, sizeof(offset));
-    }
-    hash += std::string((const char*) A.bytes, sizeof(A));
-    hash += std::string((const char*) B.bytes, sizeof(B));
+    transcript.absorb(message);
+    transcript.absorb(M);
+    transcript.absorb(C_offsets);
+    transcript.absorb(A);
+    transcript.absorb(B);
     for (std::size_t alpha = 0; alpha < X.size(); ++alpha)
     {
         for (std::size_t j = 0; j < m; ++j)
-        {
-            hash += std::string((const char*) X[alpha][j].bytes, sizeof(X[alpha][j]));
-        }
+            transcript.absorb(X[alpha][j]);
     }
-    CHECK_AND_ASSERT_THROW_MES(hash.size() > 1, "Bad hash input size!");
-    rct::hash_to_scalar(challenge, hash.data(), hash.size());
+
+    const rct::key challenge{transcript.challenge()};
 
     CHECK_AND_ASSERT_THROW_MES(!(challenge == ZERO), "Transcript challenge must be nonzero!");
 
     return challenge;
 }
 //-------------------------------------------------------------------------------------------------------------------
-GrootleProof grootle_prove(const rct::keyM &M, // [vec<tuple of commitments>]
+GrootleProof grootle_prove(const rct::KeyMatrix &M, // [vec<tuple of commitments>]
     const std::size_t l,        // secret index into {{M}}
     const rct::keyV &C_offsets,  // offsets for commitment to zero at index l
     const std::vector<crypto::secret_key> &privkeys,  // privkeys of commitments to zero in 'M[l] - C_offsets'
@@ -266,6 +244,8 @@ GrootleProof grootle_prove(const rct::keyM &M, // [vec<tuple of commitments>]
     const std::size_t m,
     const rct::key &message)    // message to insert in Fiat-Shamir transform hash
 {
+    MOCK_TX_PHASE_TIMER(MEMBERSHIP_PROOF_PROVE);
+
     /// input checks and initialization
     CHECK_AND_ASSERT_THROW_MES(n > 1, "Must have n > 1!");
     CHECK_AND_ASSERT_THROW_MES(m > 1, "Must have m > 1!");
@@ -274,18 +254,16 @@ GrootleProof grootle_prove(const rct::keyM &M, // [vec<tuple of commitments>]
     // ref set size
     const std::size_t N = std::pow(n, m);
 
-    CHECK_AND_ASSERT_THROW_MES(M.size() == N, "Ref set vector is wrong size!");
+    CHECK_AND_ASSERT_THROW_MES(M.rows() == N, "Ref set vector is wrong size!");
 
     // number of parallel commitments to zero
     const std::size_t num_keys = C_offsets.size();
 
     CHECK_AND_ASSERT_THROW_MES(privkeys.size() == num_keys, "Private key vector is wrong size!");
-
-    for (const auto &tuple : M)
-        CHECK_AND_ASSERT_THROW_MES(tuple.size() == num_keys, "Commitment tuple is wrong size!");
+    CHECK_AND_ASSERT_THROW_MES(M.cols() == num_keys, "Commitment tuple is wrong size!");
 
     // commitment to zero signing keys
-    CHECK_AND_ASSERT_THROW_MES(l < M.size(), "Signing index out of bounds!");
+    CHECK_AND_ASSERT_THROW_MES(l < M.rows(), "Signing index out of bounds!");
 
     for (std::size_t alpha = 0; alpha < num_keys; ++alpha)
     {
@@ -333,7 +311,7 @@ GrootleProof grootle_prove(const rct::keyM &M, // [vec<tuple of commitments>]
     }
     grootle_matrix_commitment(rA, a, a_sq, data);  //A = dual_matrix_commit(r_A, a, -a^2)
     CHECK_AND_ASSERT_THROW_MES(data.size() == 1 + 2*m*n, "Matrix commitment returned unexpected size!");
-    proof.A = rct::straus(data);
+    proof.A = rct::multiexp_auto(data);
     CHECK_AND_ASSERT_THROW_MES(!(proof.A == IDENTITY), "Linear combination unexpectedly returned zero!");
 
     // B: commit to decomposition bits: {sigma, a*(1-2*sigma)}
@@ -357,7 +335,7 @@ GrootleProof grootle_prove(const rct::keyM &M, // [vec<tuple of commitments>]
     }
     grootle_matrix_commitment(rB, sigma, a_sigma, data);  //B = dual_matrix_commit(r_B, sigma, a*(1-2*sigma))
     CHECK_AND_ASSERT_THROW_MES(data.size() == 1 + 2*m*n, "Matrix commitment returned unexpected size!");
-    proof.B = rct::straus(data);
+    proof.B = rct::multiexp_auto(data);
     CHECK_AND_ASSERT_THROW_MES(!(proof.B == IDENTITY), "Linear combination unexpectedly returned zero!");
 
     // done: store (1/8)*commitment
@@ -366,32 +344,10 @@ GrootleProof grootle_prove(const rct::keyM &M, // [vec<tuple of commitments>]
 
 
     /// one-of-many sub-proof: polynomial 'p' coefficients
-    rct::keyM p = rct::keyMInit(m + 1, N);
+    rct::keyM p;
+    one_of_many_coefficients(a, decomp_l, n, m, p);
     CHECK_AND_ASSERT_THROW_MES(p.size() == N, "Bad matrix size!");
     CHECK_AND_ASSERT_THROW_MES(p[0].size() == m + 1, "Bad matrix size!");
-    std::vector<std::size_t> decomp_k;
-    rct::keyV pre_convolve_temp;
-    decomp_k.resize(m);
-    pre_convolve_temp.resize(2);
-    for (std::size_t k = 0; k < N; ++k)
-    {
-        decompose(k, n, m, decomp_k);
-
-        for (std::size_t j = 0; j < m+1; ++j)
-        {
-            p[k][j] = ZERO;
-        }
-        p[k][0] = a[0][decomp_k[0]];
-        p[k][1] = kronecker_delta(decomp_l[0], decomp_k[0]);
-
-        for (std::size_t j = 1; j < m; ++j)
-        {
-            pre_convolve_temp[0] = a[j][decomp_k[j]];
-            pre_convolve_temp[1] = kronecker_delta(decomp_l[j], decomp_k[j]);
-
-            p[k] = convolve(p[k], pre_convolve_temp, m);
-        }
-    }
 
 
     /// one-of-many sub-proof initial values: {{rho}}, {{X}}
@@ -428,7 +384,7 @@ GrootleProof grootle_prove(const rct::keyM &M, // [vec<tuple of commitments>]
 
             // X[alpha][j] += rho[alpha][j]*G
             // note: addKeys1(X, rho, P) -> X = rho*G + P
-            addKeys1(proof.X[alpha][j], rho[alpha][j], rct::straus(data_X));
+            addKeys1(proof.X[alpha][j], rho[alpha][j], rct::multiexp_auto(data_X));
             CHECK_AND_ASSERT_THROW_MES(!(proof.X[alpha][j] == IDENTITY), "Proof coefficient element should not be zero!");
         }
     }
@@ -448,7 +404,7 @@ GrootleProof grootle_prove(const rct::keyM &M, // [vec<tuple of commitments>]
     /// one-of-many sub-proof challenges
 
     // xi: challenge
-    const rct::key xi{compute_challenge(message, M, C_offsets, proof.A, proof.B, proof.X)};
+    const rct::key xi{compute_challenge(message, M, epee::to_span(C_offsets), proof.A, proof.B, proof.X)};
 
     // xi^j: challenge powers
     rct::keyV xi_pow = powers_of_scalar(xi, m + 1);
@@ -503,8 +459,8 @@ GrootleProof grootle_prove(const rct::keyM &M, // [vec<tuple of commitments>]
 }
 //-------------------------------------------------------------------------------------------------------------------
 rct::pippenger_prep_data get_grootle_verification_data(const std::vector<const GrootleProof*> &proofs,
-    const std::vector<rct::keyM> &M,
-    const rct::keyM &proof_offsets,
+    const std::vector<rct::KeyMatrix> &M,
+    const rct::KeyMatrix &proof_offsets,
     const std::size_t n,
     const std::size_t m,
     const rct::keyV &messages,
@@ -525,23 +481,19 @@ rct::pippenger_prep_data get_grootle_verification_data(const std::vector<const G
     const std::size_t N = std::pow(n, m);
 
     CHECK_AND_ASSERT_THROW_MES(M.size() == N_proofs, "Public key vector is wrong size!");
-    for (const rct::keyM &proof_M : M)
-        CHECK_AND_ASSERT_THROW_MES(proof_M.size() == N, "Public key vector is wrong size!");
+    for (const rct::KeyMatrix &proof_M : M)
+        CHECK_AND_ASSERT_THROW_MES(proof_M.rows() == N, "Public key vector is wrong size!");
 
     // inputs line up with proofs
-    CHECK_AND_ASSERT_THROW_MES(proof_offsets.size() == N_proofs, "Commitment offsets don't match with input proofs!");
+    CHECK_AND_ASSERT_THROW_MES(proof_offsets.rows() == N_proofs, "Commitment offsets don't match with input proofs!");
     CHECK_AND_ASSERT_THROW_MES(messages.size() == N_proofs, "Incorrect number of messages!");
 
     // commitment offsets must line up with input set
-    const std::size_t num_keys = proof_offsets[0].size();
+    const std::size_t num_keys = proof_offsets.cols();
     CHECK_AND_ASSERT_THROW_MES(num_keys > 0, "Unsufficient signing keys in proof!");
 
-    for (const auto &C_offsets : proof_offsets)
-        CHECK_AND_ASSERT_THROW_MES(C_offsets.size() == num_keys, "Incorrect number of commitment offsets!");
-
-    for (const rct::keyM &proof_M : M)
-        for (const rct::keyV &tuple : proof_M)
-            CHECK_AND_ASSERT_THROW_MES(tuple.size() == num_keys, "Incorrect number of input keys!");
+    for (const rct::KeyMatrix &proof_M : M)
+        CHECK_AND_ASSERT_THROW_MES(proof_M.cols() == num_keys, "Incorrect number of input keys!");
 
 
     /// Per-proof checks
@@ -605,6 +557,9 @@ rct::pippenger_prep_data get_grootle_verification_data(const std::vector<const G
 
     /// per-proof data assembly
     std::size_t skipped_offset_sets{0};
+    rct::KeyMatrix f{m, n};
+    rct::keyV f_prefix_temp;
+    rct::keyV t;
 
     for (std::size_t i_proofs = 0; i_proofs < N_proofs; ++i_proofs)
     {
@@ -628,8 +583,8 @@ rct::pippenger_prep_data get_grootle_verification_data(const std::vector<const G
         w2_sw.resize(num_keys);
         while (w1 == ZERO || w2 == ZERO)
         {
-            w1 = small_scalar_gen(32);
-            w2 = small_scalar_gen(32);
+            w1 = minus_small_scalar_gen(DEFAULT_BATCH_WEIGHT_SIZE);  //negated: A's multiexp scalar (-w1) is small
+            w2 = small_scalar_gen(DEFAULT_BATCH_WEIGHT_SIZE);
 
             for (std::size_t alpha = 0; alpha < num_keys; ++alpha)
             {
@@ -674,7 +629,6 @@ rct::pippenger_prep_data get_grootle_verification_data(const std::vector<const G
         }
 
         // Reconstruct the f-matrix
-        rct::keyM f = rct::keyMInit(n, m);
         for (std::size_t j = 0; j < m; ++j)
         {
             // f[j][0] = xi - sum(f[j][i]) [from i = [1, n)]
@@ -740,7 +694,7 @@ rct::pippenger_prep_data get_grootle_verification_data(const std::vector<const G
         //std::vector<rct::MultiexpData> Magg_data;  //aggregate with strauss
         //Magg_data.resize(num_keys);
         rct::key sum_t = ZERO;
-        rct::key t_k;
+        one_of_many_f_products(f, n, m, f_prefix_temp, t);  // t_k = mul_all_j(f[j][decomp_k[j]])
         for (std::size_t k = 0; k < N; ++k)
         {
             // aggregate the keys at this layer
@@ -750,19 +704,9 @@ rct::pippenger_prep_data get_grootle_verification_data(const std::vector<const G
             }
             multi_exp_vartime_p3(sw, M[i_proofs][k], Key_agg_temp);  //aggregate with custom multiexp function
 
-            // compute the coefficient
-            t_k = ONE;
-            std::vector<std::size_t> decomp_k;
-            decomp_k.resize(m);
-            decompose(k, n, m, decomp_k);
-
-            for (std::size_t j = 0; j < m; ++j)
-            {
-                sc_mul(t_k.bytes, t_k.bytes, f[j][decomp_k[j]].bytes);  // mul_all_j(f[j][decomp_k[j]])
-            }
-
-            sc_mul(temp.bytes, w2.bytes, t_k.bytes);  // w2*t_k
-            sc_add(sum_t.bytes, sum_t.bytes, t_k.bytes);  // sum_k( t_k )
+            // the coefficient
+            sc_mul(temp.bytes, w2.bytes, t[k].bytes);  // w2*t_k
+            sc_add(sum_t.bytes, sum_t.bytes, t[k].bytes);  // sum_k( t_k )
 
             // add the element
             //data.emplace_back(temp, rct::straus_p3(Magg_data));
@@ -849,8 +793,8 @@ rct::pippenger_prep_data get_grootle_verification_data(const std::vector<const G
 }
 //-------------------------------------------------------------------------------------------------------------------
 bool grootle_verify(const std::vector<const GrootleProof*> &proofs,
-    const std::vector<rct::keyM> &M,
-    const rct::keyM &proof_offsets,
+    const std::vector<rct::KeyMatrix> &M,
+    const rct::KeyMatrix &proof_offsets,
     const std::size_t n,
     const std::size_t m,
     const rct::keyV &messages,
@@ -36,8 +36,9 @@
 //   in the set that is unknown to verifiers
 // - uses 'aggregation coefficients', a size reduction technique used in CLSAG/Triptych/Lelantus-Spark-CP-proofs
 // - allows proof batching (around (2*n*m)/(n^m + 2*n*m) amortization speedup possible)
-//   - limitations: assumes each proof uses a different reference set (proofs with the same ref set could be MUCH
-//     faster), can only batch proofs with the same decomposition (n^m) and number of parallel commitments (tuple size)
+//   - limitations: the default batch verifier assumes each proof uses a different reference set (proofs with the same
+//     ref set could be MUCH faster; use the 'shared_refs' verifier for those), can only batch proofs with the same
+//     decomposition (n^m) and number of parallel commitments (tuple size)
 //
 // note: to prove DL of a point in S with respect to G directly, set its offset equal to the identity element I
 //
@@ -54,14 +55,23 @@
 
 //local headers
 #include "ringct/rctTypes.h"
+#include "serialization/containers.h"
+#include "serialization/serialization.h"
 
 //third party headers
 
 //standard headers
+#include <array>
+#include <cstdint>
+#include <functional>
 #include <vector>
 
 //forward declarations
-namespace rct { struct pippenger_prep_data; }
+namespace rct
+{
+    struct pippenger_prep_data;
+    class straus_point_cache;
+}
 
 
 namespace sp
@@ -70,6 +80,16 @@ namespace sp
 /// Maximum matrix entries
 constexpr std::size_t GROOTLE_MAX_MN{128};
 
+/// Size (bytes) of the random weights that combine proofs in batch verification (Grootle and other Seraphis proofs)
+/// - 128 bits: a batch with an invalid proof passes with probability ~2^-128
+constexpr std::size_t DEFAULT_BATCH_WEIGHT_SIZE{16};
+
+/// Reference set size of a decomposition: n^m
+constexpr std::size_t grootle_ref_set_size(const std::size_t n, const std::size_t m)
+{
+    return m == 0 ? 1 : n*grootle_ref_set_size(n, m - 1);
+}
+
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////////////////////// Types ////////////////////////////////////////////////////
@@ -85,6 +105,15 @@ struct GrootleProof
     rct::keyM X;
     rct::key zA;
     rct::keyV z;
+
+    BEGIN_SERIALIZE_OBJECT()
+        FIELD(A)
+        FIELD(B)
+        FIELD(f)
+        FIELD(X)
+        FIELD(zA)
+        FIELD(z)
+    END_SERIALIZE()
 };
 
 ////
@@ -96,6 +125,57 @@ struct ConciseGrootleProof
     rct::keyM f;
     rct::keyV X;
     rct::key zA, z;
+
+    BEGIN_SERIALIZE_OBJECT()
+        FIELD(A)
+        FIELD(B)
+        FIELD(f)
+        FIELD(X)
+        FIELD(zA)
+        FIELD(z)
+    END_SERIALIZE()
+};
+
+////
+// concise Grootle proof with a compile-time decomposition n^m
+// - same proof and transcript as ConciseGrootleProof, stored in fixed-size arrays (no heap allocations)
+// - prove/verify are only instantiated for the decompositions in use: 2^7, 3^5, 8^3 (use ConciseGrootleProof
+//   for anything else)
+///
+template <std::size_t n, std::size_t m>
+struct ConciseGrootleProofFixed
+{
+    static_assert(n > 1 && m > 1 && n*m <= GROOTLE_MAX_MN, "Bad concise Grootle decomposition!");
+
+    rct::key A, B;
+    std::array<std::array<rct::key, n - 1>, m> f;
+    std::array<rct::key, m> X;
+    rct::key zA, z;
+};
+
+////
+// aggregated concise Grootle proof: membership of k inputs, each in its own reference set, in one proof
+// - A/B commit to the decomposition matrices of all inputs at once (needs k*m*n <= GROOTLE_MAX_MN)
+// - the inputs' commitment-to-zero tuples are chained with powers of the aggregation coefficient, the same way a
+//   concise proof combines the keys of one tuple, so {X}, zA and z are shared too; only f grows with k
+//   - input u's key alpha gets coefficient mu^(u*num_keys + alpha)
+// - size: 2 + k*m*(n - 1) + m + 2 keys, vs k*(m*(n - 1) + m + 4) keys for k concise proofs
+///
+struct AggregateConciseGrootleProof
+{
+    rct::key A, B;
+    rct::keyM f;  // (k*m) x (n - 1): input u's row j is f[u*m + j]
+    rct::keyV X;
+    rct::key zA, z;
+
+    BEGIN_SERIALIZE_OBJECT()
+        FIELD(A)
+        FIELD(B)
+        FIELD(f)
+        FIELD(X)
+        FIELD(zA)
+        FIELD(z)
+    END_SERIALIZE()
 };
 
 
@@ -114,7 +194,7 @@ struct ConciseGrootleProof
 * param: message - message to insert in Fiat-Shamir transform hash
 * return: Grootle proof
 */
-GrootleProof grootle_prove(const rct::keyM &M,
+GrootleProof grootle_prove(const rct::KeyMatrix &M,
     const std::size_t l,
     const rct::keyV &C_offsets,
     const std::vector<crypto::secret_key> &privkeys,
@@ -132,7 +212,7 @@ GrootleProof grootle_prove(const rct::keyM &M,
 * param: message - message to insert in Fiat-Shamir transform hash
 * return: Grootle proof
 */
-ConciseGrootleProof concise_grootle_prove(const rct::keyM &M,
+ConciseGrootleProof concise_grootle_prove(const rct::KeyMatrix &M,
     const std::size_t l,
     const rct::keyV &C_offsets,
     const std::vector<crypto::secret_key> &privkeys,
@@ -152,15 +232,15 @@ ConciseGrootleProof concise_grootle_prove(const rct::keyM &M,
 * return: true/false on verification result
 */
 rct::pippenger_prep_data get_grootle_verification_data(const std::vector<const GrootleProof*> &proofs,
-    const std::vector<rct::keyM> &M,
-    const rct::keyM &proof_offsets,
+    const std::vector<rct::KeyMatrix> &M,
+    const rct::KeyMatrix &proof_offsets,
     const std::size_t n,
     const std::size_t m,
     const rct::keyV &messages,
     const std::size_t small_weighting_size);
 bool grootle_verify(const std::vector<const GrootleProof*> &proofs,
-    const std::vector<rct::keyM> &M,
-    const rct::keyM &proof_offsets,
+    const std::vector<rct::KeyMatrix> &M,
+    const rct::KeyMatrix &proof_offsets,
     const std::size_t n,
     const std::size_t m,
     const rct::keyV &messages,
@@ -173,19 +253,211 @@ bool grootle_verify(const std::vector<const GrootleProof*> &proofs,
 * param: n - decomp input set: n^m
 * param: m - ...
 * param: message - (per-proof) message to insert in Fiat-Shamir transform hash
+* param: small_weighting_size - size (bytes) of the random weights that combine proofs in the batch
+* param: num_threads - max number of threads for one proof's ref set terms and for the multiexp (0 = threadpool max
+*   concurrency; 1 = serial)
+*   - a proof's ref set is only split across threads if it is very large (thousands of members), so a lone big proof
+*     doesn't verify on one core
 * return: true/false on verification result
 */
 rct::pippenger_prep_data get_concise_grootle_verification_data(const std::vector<const ConciseGrootleProof*> &proofs,
-    const std::vector<rct::keyM> &M,
-    const rct::keyM &proof_offsets,
+    const std::vector<rct::KeyMatrix> &M,
+    const rct::KeyMatrix &proof_offsets,
+    const std::size_t n,
+    const std::size_t m,
+    const rct::keyV &messages,
+    const std::size_t small_weighting_size = DEFAULT_BATCH_WEIGHT_SIZE,
+    const std::size_t num_threads = 1);
+/// called before each proof is processed, to wait until that proof's entries of 'M' and 'M_p3' are filled in (so callers
+/// can fetch later proofs' ref sets while earlier proofs are processed)
+using ConciseGrootleRefSetWaiter = std::function<void(const std::size_t proof_index)>;
+/**
+* brief: get_concise_grootle_verification_data - as above, with pre-decompressed ref set keys
+*   - the keys in 'M' are still needed for the transcript
+* param: M_p3 - (per-proof) decompressed keys of 'M', flattened: M_p3[proof][k*tuple_size + alpha] = M[proof][k][alpha]
+* param: wait_for_ref_set - if set, 'M' and 'M_p3' only need one (possibly empty) entry per proof up front, and each
+*   proof's entries are only read after waiting for them
+*/
+rct::pippenger_prep_data get_concise_grootle_verification_data(const std::vector<const ConciseGrootleProof*> &proofs,
+    const std::vector<rct::KeyMatrix> &M,
+    const std::vector<std::vector<ge_p3>> &M_p3,
+    const rct::KeyMatrix &proof_offsets,
+    const std::size_t n,
+    const std::size_t m,
+    const rct::keyV &messages,
+    const ConciseGrootleRefSetWaiter &wait_for_ref_set = nullptr);
+/**
+* brief: get_concise_grootle_verification_data - as above, with each proof's ref set terms pre-aggregated by a straus
+*   multiexp that reuses precomputed multiples of ref set keys seen in earlier calls (e.g. hot ledger enotes)
+*   - pays off when the same keys recur across many ref sets; for batches of unrelated ref sets, prefer the plain
+*     overloads (pippenger over all the ref set keys is cheaper than straus per proof)
+* param: M_ids - (per-proof) cache ids of the keys in 'M_p3' (same layout; rct::straus_point_cache::NO_ID: don't cache)
+* inoutparam: M_cache - precomputed multiples of ref set keys
+*/
+rct::pippenger_prep_data get_concise_grootle_verification_data(const std::vector<const ConciseGrootleProof*> &proofs,
+    const std::vector<rct::KeyMatrix> &M,
+    const std::vector<std::vector<ge_p3>> &M_p3,
+    const std::vector<std::vector<uint64_t>> &M_ids,
+    rct::straus_point_cache &M_cache,
+    const rct::KeyMatrix &proof_offsets,
+    const std::size_t n,
+    const std::size_t m,
+    const rct::keyV &messages,
+    const ConciseGrootleRefSetWaiter &wait_for_ref_set = nullptr);
+/**
+* brief: get_concise_grootle_verification_data - as above, with ref set keys that are already in cached form (e.g. kept
+*   that way by the ledger), so the returned multiexp data carries a pippenger cache for them and no ref set key is
+*   decompressed or converted during verification
+* param: M_cached - (per-proof) cached forms of the keys in 'M_p3' (same layout)
+*/
+rct::pippenger_prep_data get_concise_grootle_verification_data(const std::vector<const ConciseGrootleProof*> &proofs,
+    const std::vector<rct::KeyMatrix> &M,
+    const std::vector<std::vector<ge_p3>> &M_p3,
+    const std::vector<std::vector<ge_cached>> &M_cached,
+    const rct::KeyMatrix &proof_offsets,
     const std::size_t n,
     const std::size_t m,
     const rct::keyV &messages);
 bool concise_grootle_verify(const std::vector<const ConciseGrootleProof*> &proofs,
-    const std::vector<rct::keyM> &M,
-    const rct::keyM &proof_offsets,
+    const std::vector<rct::KeyMatrix> &M,
+    const rct::KeyMatrix &proof_offsets,
     const std::size_t n,
     const std::size_t m,
+    const rct::keyV &messages,
+    const std::size_t small_weighting_size = DEFAULT_BATCH_WEIGHT_SIZE,
+    const std::size_t num_threads = 0);
+/**
+* brief: concise_grootle_verify_shared_refs - verify a batch of concise grootle proofs whose reference sets overlap
+*   - ref set keys shared between proofs (identical ref sets, or overlapping subsets) are only added to the
+*     multiexp once, with their scalars summed, so the per-proof cost drops as more keys are shared
+*   - there is a lookup cost for each ref set key, so prefer the plain verifier for batches with disjoint ref sets
+* param: proofs - batch of proofs to verify
+* param: M - (per-proof) vec<[vec<tuple of commitments>]>
+* param: proof_offsets - (per-proof) offsets for commitments to zero at unknown indices in each proof
+* param: n - decomp input set: n^m
+* param: m - ...
+* param: message - (per-proof) message to insert in Fiat-Shamir transform hash
+* return: true/false on verification result
+*/
+rct::pippenger_prep_data get_concise_grootle_verification_data_shared_refs(
+    const std::vector<const ConciseGrootleProof*> &proofs,
+    const std::vector<rct::KeyMatrix> &M,
+    const rct::KeyMatrix &proof_offsets,
+    const std::size_t n,
+    const std::size_t m,
+    const rct::keyV &messages,
+    const std::size_t small_weighting_size = DEFAULT_BATCH_WEIGHT_SIZE);
+bool concise_grootle_verify_shared_refs(const std::vector<const ConciseGrootleProof*> &proofs,
+    const std::vector<rct::KeyMatrix> &M,
+    const rct::KeyMatrix &proof_offsets,
+    const std::size_t n,
+    const std::size_t m,
+    const rct::keyV &messages,
+    const std::size_t small_weighting_size = DEFAULT_BATCH_WEIGHT_SIZE);
+/**
+* brief: aggregate_concise_grootle_prove - create an aggregated concise grootle proof for k inputs
+* param: M - (per-input) [vec<tuple of commitments>]
+* param: l - (per-input) secret index into {{M}}
+* param: C_offsets - (per-input) offsets for commitment to zero at index l
+* param: privkeys - (per-input) privkeys of commitments to zero in 'M[l] - C_offsets'
+* param: n - decomp input set: n^m
+* param: m - ...
+* param: message - message to insert in Fiat-Shamir transform hash
+* return: aggregated Grootle proof
+*/
+AggregateConciseGrootleProof aggregate_concise_grootle_prove(const std::vector<rct::KeyMatrix> &M,
+    const std::vector<std::size_t> &l,
+    const rct::KeyMatrix &C_offsets,
+    const std::vector<std::vector<crypto::secret_key>> &privkeys,
+    const std::size_t n,
+    const std::size_t m,
+    const rct::key &message);
+/**
+* brief: aggregate_concise_grootle_verify - verify a batch of aggregated concise grootle proofs
+*   - proofs in a batch may cover different numbers of inputs
+* param: proofs - batch of proofs to verify
+* param: M - (per-proof, per-input) [vec<tuple of commitments>]
+* param: proof_offsets - (per-proof, per-input) offsets for commitments to zero at unknown indices
+* param: n - decomp input set: n^m
+* param: m - ...
+* param: messages - (per-proof) message to insert in Fiat-Shamir transform hash
+* param: small_weighting_size - size (bytes) of the random weights that combine proofs in the batch
+* return: true/false on verification result
+*/
+rct::pippenger_prep_data get_aggregate_concise_grootle_verification_data(
+    const std::vector<const AggregateConciseGrootleProof*> &proofs,
+    const std::vector<std::vector<rct::KeyMatrix>> &M,
+    const std::vector<rct::KeyMatrix> &proof_offsets,
+    const std::size_t n,
+    const std::size_t m,
+    const rct::keyV &messages,
+    const std::size_t small_weighting_size = DEFAULT_BATCH_WEIGHT_SIZE);
+bool aggregate_concise_grootle_verify(const std::vector<const AggregateConciseGrootleProof*> &proofs,
+    const std::vector<std::vector<rct::KeyMatrix>> &M,
+    const std::vector<rct::KeyMatrix> &proof_offsets,
+    const std::size_t n,
+    const std::size_t m,
+    const rct::keyV &messages,
+    const std::size_t small_weighting_size = DEFAULT_BATCH_WEIGHT_SIZE);
+/**
+* brief: concise_grootle_prove - create a concise grootle proof with a compile-time decomposition
+*   - instantiated for n^m = 2^7, 3^5, 8^3
+* type: n - decomp input set: n^m
+* type: m - ...
+* param: M - [vec<tuple of commitments>]
+* param: l - secret index into {{M}}
+* param: C_offsets - offsets for commitment to zero at index l
+* param: privkeys - privkeys of commitments to zero in 'M[l] - C_offsets'
+* param: message - message to insert in Fiat-Shamir transform hash
+* return: Grootle proof
+*/
+template <std::size_t n, std::size_t m>
+ConciseGrootleProofFixed<n, m> concise_grootle_prove(const rct::KeyMatrix &M,
+    const std::size_t l,
+    const rct::keyV &C_offsets,
+    const std::vector<crypto::secret_key> &privkeys,
+    const rct::key &message);
+/**
+* brief: concise_grootle_verify - verify a batch of concise grootle proofs with a compile-time decomposition
+*   - instantiated for n^m = 2^7, 3^5, 8^3
+* type: n - decomp input set: n^m
+* type: m - ...
+* param: proofs - batch of proofs to verify
+* param: M - (per-proof) vec<[vec<tuple of commitments>]>
+* param: proof_offsets - (per-proof) offsets for commitments to zero at unknown indices in each proof
+* param: message - (per-proof) message to insert in Fiat-Shamir transform hash
+* return: true/false on verification result
+*/
+template <std::size_t n, std::size_t m>
+rct::pippenger_prep_data get_concise_grootle_verification_data(
+    const std::vector<const ConciseGrootleProofFixed<n, m>*> &proofs,
+    const std::vector<rct::KeyMatrix> &M,
+    const rct::KeyMatrix &proof_offsets,
+    const rct::keyV &messages);
+template <std::size_t n, std::size_t m>
+bool concise_grootle_verify(const std::vector<const ConciseGrootleProofFixed<n, m>*> &proofs,
+    const std::vector<rct::KeyMatrix> &M,
+    const rct::KeyMatrix &proof_offsets,
     const rct::keyV &messages);
+/**
+* brief: to_dynamic_concise_grootle_proof - copy a fixed-size proof into the dynamic layout
+* param: proof -
+* return: the same proof as a ConciseGrootleProof (verifiable with the dynamic API)
+*/
+template <std::size_t n, std::size_t m>
+ConciseGrootleProof to_dynamic_concise_grootle_proof(const ConciseGrootleProofFixed<n, m> &proof)
+{
+    ConciseGrootleProof dynamic_proof;
+    dynamic_proof.A = proof.A;
+    dynamic_proof.B = proof.B;
+    dynamic_proof.f.reserve(m);
+    for (const std::array<rct::key, n - 1> &f_row : proof.f)
+        dynamic_proof.f.emplace_back(f_row.begin(), f_row.end());
+    dynamic_proof.X.assign(proof.X.begin(), proof.X.end());
+    dynamic_proof.zA = proof.zA;
+    dynamic_proof.z = proof.z;
+
+    return dynamic_proof;
+}
 
 } //namespace sp
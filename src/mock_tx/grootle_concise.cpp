@@ -37,19 +37,28 @@ extern "C"
 {
 #include "crypto/crypto-ops.h"
 }
+#include "common/numa_topology.h"
+#include "common/threadpool.h"
 #include "cryptonote_config.h"
+#include "grootle_generators.h"
 #include "misc_log_ex.h"
+#include "mock_tx_phase_timers.h"
 #include "mock_tx_utils.h"
 #include "ringct/multiexp.h"
 #include "ringct/rctOps.h"
 #include "ringct/rctTypes.h"
 #include "seraphis_crypto_utils.h"
+#include "seraphis_scratch_arena.h"
+#include "seraphis_transcript.h"
 
 //third party headers
 
 //standard headers
+#include <algorithm>
+#include <array>
 #include <cmath>
 #include <mutex>
+#include <unordered_map>
 #include <vector>
 
 #undef MONERO_DEFAULT_LOG_CATEGORY
@@ -60,13 +69,9 @@ namespace sp
 
 /// File-scope data
 
-// config (todo: move to config file)
-const char HASH_KEY_GROOTLE_Hi_A[] = "grootle Hi A";
-const char HASH_KEY_GROOTLE_Hi_B[] = "grootle Hi B";
-
-// generators
-static ge_p3 Hi_A_p3[GROOTLE_MAX_MN];
-static ge_p3 Hi_B_p3[GROOTLE_MAX_MN];
+// generators (Hi_A, Hi_B are baked in at build time)
+static const ge_p3 (&Hi_A_p3)[GROOTLE_MAX_MN] = grootle_Hi_A_p3;
+static const ge_p3 (&Hi_B_p3)[GROOTLE_MAX_MN] = grootle_Hi_B_p3;
 static ge_p3 G_p3;
 
 // Useful scalar and group constants
@@ -77,7 +82,8 @@ static const rct::key TWO = { {0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0
     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00} };
 
 // misc
-static std::shared_ptr<rct::pippenger_cached_data> generator_cache;
+static std::shared_ptr<tools::numa_replicated<rct::fixed_base_cached_data>> generator_cache;  //one copy per NUMA node
+static std::size_t generator_cache_mn{0};
 static std::mutex init_mutex;
 
 
@@ -91,63 +97,63 @@ static void init_gens()
     static bool init_done = false;
     if (init_done) return;
 
-    // Build Hi generators
-    // H_i = keccak_to_pt("grootle Hi", i)
-    const std::string Hi_A_salt(HASH_KEY_GROOTLE_Hi_A);
-    for (std::size_t i = 0; i < GROOTLE_MAX_MN; ++i)
-    {
-        std::string hash = Hi_A_salt + tools::get_varint_data(i);
-        hash_to_p3(Hi_A_p3[i], rct::hash2rct(crypto::cn_fast_hash(hash.data(), hash.size())));
-    }
-
-    const std::string Hi_B_salt(HASH_KEY_GROOTLE_Hi_B);
-    for (std::size_t i = 0; i < GROOTLE_MAX_MN; ++i)
-    {
-        std::string hash = Hi_B_salt + tools::get_varint_data(i);
-        hash_to_p3(Hi_B_p3[i], rct::hash2rct(crypto::cn_fast_hash(hash.data(), hash.size())));
-    }
-
-    // get G
+    // get G (Hi_A, Hi_B are precomputed, see grootle_generators.h)
     G_p3 = get_G_p3_gen();
 
     init_done = true;
 }
 //-------------------------------------------------------------------------------------------------------------------
-// Initialize cache for fixed generators: Hi_A, Hi_B, G
-// - The cache pre-converts ge_p3 points to ge_cached, for the first N terms in a pippinger multiexponentiation.
-// - When doing the multiexp, you specify how many of those N terms are actually used (i.e. 'cache_size').
+// Initialize fixed-base tables for fixed generators: Hi_A, Hi_B, G
+// - The tables store 2^(8*j) * gen for every window j, so the generator terms of a verification can be evaluated with
+//   rct::fixed_base_multiexp_p3() (no doublings, no per-verification point conversions).
 // - Here: alternate Hi_A, Hi_B to allow variable m*n (the number of Hi_A gens used always equals number of Hi_B gens used).
-// cached: G, Hi_A[0], Hi_B[0], Hi_A[1], Hi_B[1], ..., Hi_A[GROOTLE_MAX_MN], Hi_B[GROOTLE_MAX_MN]
+// cached: G, Hi_A[0], Hi_B[0], Hi_A[1], Hi_B[1], ..., Hi_A[mn - 1], Hi_B[mn - 1]
 //-------------------------------------------------------------------------------------------------------------------
-static std::shared_ptr<rct::pippenger_cached_data> get_pippinger_cache_init()
+static std::shared_ptr<rct::fixed_base_cached_data> get_fixed_base_cache_init(const std::size_t mn)
 {
-    init_gens();
-
-    std::vector<rct::MultiexpData> data;
-    data.reserve(1 + 2*GROOTLE_MAX_MN);
+    std::vector<ge_p3> gens;
+    gens.reserve(1 + 2*mn);
 
     // G
-    data.emplace_back(ZERO, G_p3);
+    gens.emplace_back(G_p3);
 
     // alternate Hi_A, Hi_B
-    for (std::size_t i = 0; i < GROOTLE_MAX_MN; ++i)
+    for (std::size_t i = 0; i < mn; ++i)
     {
-        data.emplace_back(ZERO, Hi_A_p3[i]);
-        data.emplace_back(ZERO, Hi_B_p3[i]);
+        gens.emplace_back(Hi_A_p3[i]);
+        gens.emplace_back(Hi_B_p3[i]);
     }
-    CHECK_AND_ASSERT_THROW_MES(data.size() == 1 + 2*GROOTLE_MAX_MN, "Bad generator vector size!");
+    CHECK_AND_ASSERT_THROW_MES(gens.size() == 1 + 2*mn, "Bad generator vector size!");
 
-    // initialize multiexponentiation cache
-    return rct::pippenger_init_cache(data, 0, 0);
+    // initialize fixed-base tables
+    return rct::fixed_base_init_cache(gens);
 }
 //-------------------------------------------------------------------------------------------------------------------
+// Get fixed-base tables covering at least 'mn' generator pairs
+// - tables are only built as far as they are needed: a full table (GROOTLE_MAX_MN pairs) takes longer to build than
+//   the verifications that usually need it
 //-------------------------------------------------------------------------------------------------------------------
-static void init_static()
+static std::shared_ptr<rct::fixed_base_cached_data> get_generator_cache(const std::size_t mn)
 {
+    CHECK_AND_ASSERT_THROW_MES(mn <= GROOTLE_MAX_MN, "Too many generators requested!");
+
     init_gens();
 
-    // pippinger cache of stable generators
-    generator_cache = get_pippinger_cache_init();
+    std::shared_ptr<tools::numa_replicated<rct::fixed_base_cached_data>> replicas;
+    {
+        std::lock_guard<std::mutex> lock(init_mutex);
+
+        if (generator_cache_mn < mn)
+        {
+            generator_cache = std::make_shared<tools::numa_replicated<rct::fixed_base_cached_data>>(
+                get_fixed_base_cache_init(mn), rct::fixed_base_copy_cache);
+            generator_cache_mn = mn;
+        }
+        replicas = generator_cache;
+    }
+
+    // the calling thread's NUMA node copy (made outside the lock on first use from that node)
+    return replicas->get();
 }
 //-------------------------------------------------------------------------------------------------------------------
 // commit to 2 matrices of equal size
@@ -196,48 +202,45 @@ static void grootle_matrix_commitment(const rct::key &x,  //blinding factor
 //-------------------------------------------------------------------------------------------------------------------
 // Initialize transcript
 //-------------------------------------------------------------------------------------------------------------------
-static void transcript_init(rct::key &transcript_out)
+static void transcript_init(SpTranscript &transcript_inout)
 {
-    std::string salt(config::HASH_KEY_CONCISE_GROOTLE_TRANSCRIPT);
-    rct::hash_to_scalar(transcript_out, salt.data(), salt.size());
+    // H("domain-sep") is a constant
+    static const rct::key domain_separator{
+            []()
+            {
+                SpTranscript salt;
+                salt.absorb_string(config::HASH_KEY_CONCISE_GROOTLE_TRANSCRIPT);
+                return salt.challenge();
+            }()
+        };
+
+    transcript_inout.absorb(domain_separator);
 }
 //-------------------------------------------------------------------------------------------------------------------
 // Base aggregation coefficient for concise structure
 // mu = H(H("domain-sep"), message, {{M}}, {C_offsets}, A, B)
 //-------------------------------------------------------------------------------------------------------------------
 static rct::key compute_base_aggregation_coefficient(const rct::key &message,
-    const rct::keyM &M,
-    const rct::keyV &C_offsets,
+    const rct::KeyMatrix &M,
+    const epee::span<const rct::key> C_offsets,
     const rct::key &A,
     const rct::key &B)
 {
-    for (const rct::keyV &tuple : M)
-        CHECK_AND_ASSERT_THROW_MES(tuple.size() == C_offsets.size(), "Transcript challenge inputs have incorrect size!");
+    CHECK_AND_ASSERT_THROW_MES(M.cols() == C_offsets.size(), "Transcript challenge inputs have incorrect size!");
 
     // initialize transcript message
-    rct::key challenge;
-    transcript_init(challenge);
+    SpTranscript transcript;
+    transcript_init(transcript);
 
-    // collect challenge string
-    std::string hash;
-    hash.reserve(((M.size() + 1)*C_offsets.size() + 4)*sizeof(rct::key));
-    hash = std::string(reinterpret_cast<const char*>(challenge.bytes), sizeof(challenge));
-    hash.append(reinterpret_cast<const char*>(message.bytes), sizeof(message));
-    for (const rct::keyV &tuple : M)
-    {
-        for (const rct::key &key : tuple)
-            hash.append(reinterpret_cast<const char*>(key.bytes), sizeof(key));
-    }
-    for (const rct::key &offset : C_offsets)
-    {
-        hash.append(reinterpret_cast<const char*>(offset.bytes), sizeof(offset));
-    }
-    hash.append(reinterpret_cast<const char*>(A.bytes), sizeof(A));
-    hash.append(reinterpret_cast<const char*>(B.bytes), sizeof(B));
-    CHECK_AND_ASSERT_THROW_MES(hash.size() > 1, "Bad hash input size!");
+    // absorb challenge elements
+    transcript.absorb(message);
+    transcript.absorb(M);
+    transcript.absorb(C_offsets);
+    transcript.absorb(A);
+    transcript.absorb(B);
 
     // challenge
-    rct::hash_to_scalar(challenge, hash.data(), hash.size());
+    const rct::key challenge{transcript.challenge()};
 
     CHECK_AND_ASSERT_THROW_MES(!(challenge == ZERO), "Transcript challenge must be nonzero!");
 
@@ -250,25 +253,25 @@ static rct::key compute_base_aggregation_coefficient(const rct::key &message,
 // note: in practice, this extends the concise structure's aggregation coefficient (i.e. message = mu)
 // note2: in Triptych notation, c == xi
 //-------------------------------------------------------------------------------------------------------------------
-static rct::key compute_challenge(const rct::key &message, const rct::keyV &X)
+static rct::key compute_challenge(const rct::key &message, const rct::key *X, const std::size_t num_X)
 {
-    rct::key challenge;
-    std::string hash;
-    hash.reserve((X.size() + 1)*sizeof(rct::key));
-    hash = std::string(reinterpret_cast<const char*>(message.bytes), sizeof(message));
-    for (const rct::key &x : X)
-    {
-        hash.append(reinterpret_cast<const char*>(x.bytes), sizeof(x));
-    }
-    CHECK_AND_ASSERT_THROW_MES(hash.size() > 1, "Bad hash input size!");
-    rct::hash_to_scalar(challenge, hash.data(), hash.size());
+    SpTranscript transcript;
+    transcript.absorb(message);
+    if (num_X > 0)
+        transcript.absorb_bytes(X, num_X*sizeof(rct::key));
+    const rct::key challenge{transcript.challenge()};
 
     CHECK_AND_ASSERT_THROW_MES(!(challenge == ZERO), "Transcript challenge must be nonzero!");
 
     return challenge;
 }
 //-------------------------------------------------------------------------------------------------------------------
-ConciseGrootleProof concise_grootle_prove(const rct::keyM &M, // [vec<tuple of commitments>]
+static rct::key compute_challenge(const rct::key &message, const rct::keyV &X)
+{
+    return compute_challenge(message, X.data(), X.size());
+}
+//-------------------------------------------------------------------------------------------------------------------
+ConciseGrootleProof concise_grootle_prove(const rct::KeyMatrix &M, // [vec<tuple of commitments>]
     const std::size_t l,        // secret index into {{M}}
     const rct::keyV &C_offsets,  // offsets for commitment to zero at index l
     const std::vector<crypto::secret_key> &privkeys,  // privkeys of commitments to zero in 'M[l] - C_offsets'
@@ -276,6 +279,8 @@ ConciseGrootleProof concise_grootle_prove(const rct::keyM &M, // [vec<tuple of c
     const std::size_t m,
     const rct::key &message)    // message to insert in Fiat-Shamir transform hash
 {
+    MOCK_TX_PHASE_TIMER(MEMBERSHIP_PROOF_PROVE);
+
     /// input checks and initialization
     CHECK_AND_ASSERT_THROW_MES(n > 1, "Must have n > 1!");
     CHECK_AND_ASSERT_THROW_MES(m > 1, "Must have m > 1!");
@@ -284,18 +289,17 @@ ConciseGrootleProof concise_grootle_prove(const rct::keyM &M, // [vec<tuple of c
     // ref set size
     const std::size_t N = std::pow(n, m);
 
-    CHECK_AND_ASSERT_THROW_MES(M.size() == N, "Ref set vector is wrong size!");
+    CHECK_AND_ASSERT_THROW_MES(M.rows() == N, "Ref set vector is wrong size!");
 
     // number of parallel commitments to zero
     const std::size_t num_keys = C_offsets.size();
 
     CHECK_AND_ASSERT_THROW_MES(privkeys.size() == num_keys, "Private key vector is wrong size!");
 
-    for (const rct::keyV &tuple : M)
-        CHECK_AND_ASSERT_THROW_MES(tuple.size() == num_keys, "Commitment tuple is wrong size!");
+    CHECK_AND_ASSERT_THROW_MES(M.cols() == num_keys, "Commitment tuple is wrong size!");
 
     // commitment to zero signing keys
-    CHECK_AND_ASSERT_THROW_MES(l < M.size(), "Signing index out of bounds!");
+    CHECK_AND_ASSERT_THROW_MES(l < M.rows(), "Signing index out of bounds!");
 
     for (std::size_t alpha = 0; alpha < num_keys; ++alpha)
     {
@@ -343,7 +347,7 @@ ConciseGrootleProof concise_grootle_prove(const rct::keyM &M, // [vec<tuple of c
     }
     grootle_matrix_commitment(rA, a, a_sq, data);  //A = dual_matrix_commit(r_A, a, -a^2)
     CHECK_AND_ASSERT_THROW_MES(data.size() == 1 + 2*m*n, "Matrix commitment returned unexpected size!");
-    proof.A = rct::straus(data);
+    proof.A = rct::multiexp_auto(data);
     CHECK_AND_ASSERT_THROW_MES(!(proof.A == IDENTITY), "Linear combination unexpectedly returned zero!");
 
     // B: commit to decomposition bits: {sigma, a*(1-2*sigma)}
@@ -367,7 +371,7 @@ ConciseGrootleProof concise_grootle_prove(const rct::keyM &M, // [vec<tuple of c
     }
     grootle_matrix_commitment(rB, sigma, a_sigma, data);  //B = dual_matrix_commit(r_B, sigma, a*(1-2*sigma))
     CHECK_AND_ASSERT_THROW_MES(data.size() == 1 + 2*m*n, "Matrix commitment returned unexpected size!");
-    proof.B = rct::straus(data);
+    proof.B = rct::multiexp_auto(data);
     CHECK_AND_ASSERT_THROW_MES(!(proof.B == IDENTITY), "Linear combination unexpectedly returned zero!");
 
     // done: store (1/8)*commitment
@@ -376,32 +380,10 @@ ConciseGrootleProof concise_grootle_prove(const rct::keyM &M, // [vec<tuple of c
 
 
     /// one-of-many sub-proof: polynomial 'p' coefficients
-    rct::keyM p = rct::keyMInit(m + 1, N);
+    rct::keyM p;
+    one_of_many_coefficients(a, decomp_l, n, m, p);
     CHECK_AND_ASSERT_THROW_MES(p.size() == N, "Bad matrix size!");
     CHECK_AND_ASSERT_THROW_MES(p[0].size() == m + 1, "Bad matrix size!");
-    std::vector<std::size_t> decomp_k;
-    rct::keyV pre_convolve_temp;
-    decomp_k.resize(m);
-    pre_convolve_temp.resize(2);
-    for (std::size_t k = 0; k < N; ++k)
-    {
-        decompose(k, n, m, decomp_k);
-
-        for (std::size_t j = 0; j < m+1; ++j)
-        {
-            p[k][j] = ZERO;
-        }
-        p[k][0] = a[0][decomp_k[0]];
-        p[k][1] = kronecker_delta(decomp_l[0], decomp_k[0]);
-
-        for (std::size_t j = 1; j < m; ++j)
-        {
-            pre_convolve_temp[0] = a[j][decomp_k[j]];
-            pre_convolve_temp[1] = kronecker_delta(decomp_l[j], decomp_k[j]);
-
-            p[k] = convolve(p[k], pre_convolve_temp, m);
-        }
-    }
 
 
     /// one-of-many sub-proof initial values: {rho}, mu, {X}
@@ -416,7 +398,7 @@ ConciseGrootleProof concise_grootle_prove(const rct::keyM &M, // [vec<tuple of c
 
     // mu: base aggregation coefficient
     const rct::key mu{
-            compute_base_aggregation_coefficient(message, M, C_offsets, proof.A, proof.B)
+            compute_base_aggregation_coefficient(message, M, epee::to_span(C_offsets), proof.A, proof.B)
         };
 
     // mu^alpha: powers of the aggregation coefficient
@@ -444,7 +426,7 @@ ConciseGrootleProof concise_grootle_prove(const rct::keyM &M, // [vec<tuple of c
 
         // X[j] += rho[j]*G
         // note: addKeys1(X, rho, P) -> X = rho*G + P
-        rct::addKeys1(proof.X[j], rho[j], rct::straus(data_X));
+        rct::addKeys1(proof.X[j], rho[j], rct::multiexp_auto(data_X));
         CHECK_AND_ASSERT_THROW_MES(!(proof.X[j] == IDENTITY), "Proof coefficient element should not be zero!");
     }
 
@@ -511,12 +493,108 @@ ConciseGrootleProof concise_grootle_prove(const rct::keyM &M, // [vec<tuple of c
     return proof;
 }
 //-------------------------------------------------------------------------------------------------------------------
-rct::pippenger_prep_data get_concise_grootle_verification_data(const std::vector<const ConciseGrootleProof*> &proofs,
-    const std::vector<rct::keyM> &M,
-    const rct::keyM &proof_offsets,
+// Smallest ref set (members x tuple size) whose per-proof work is split across threads: below this, handing chunks to
+//   the threadpool costs more than it saves
+//-------------------------------------------------------------------------------------------------------------------
+static constexpr std::size_t MIN_PARALLEL_REF_SET_TERMS{4096};
+//-------------------------------------------------------------------------------------------------------------------
+// Chunk size that gives each of 'num_threads' threads one chunk of [0, size) (0 = let parallel_for pick)
+//-------------------------------------------------------------------------------------------------------------------
+static std::size_t parallel_grain(const std::size_t size, const std::size_t num_threads)
+{
+    return num_threads == 0 ? 0 : (size + num_threads - 1)/num_threads;
+}
+//-------------------------------------------------------------------------------------------------------------------
+// Decompress one proof's ref set keys in contiguous chunks of members on the threadpool
+//-------------------------------------------------------------------------------------------------------------------
+static void decompress_ref_set_mt(const rct::KeyMatrix &proof_M,
+    const std::size_t num_threads,
+    std::vector<ge_p3> &points_out)
+{
+    const std::size_t num_keys{proof_M.cols()};
+    points_out.resize(proof_M.size());
+
+    CHECK_AND_ASSERT_THROW_MES(tools::parallel_for(0, proof_M.rows(), parallel_grain(proof_M.rows(), num_threads),
+            [&proof_M, &points_out, num_keys](const std::size_t k_begin, const std::size_t k_end)
+            {
+                rct::decompress_points({proof_M.data() + k_begin*num_keys, (k_end - k_begin)*num_keys},
+                    points_out.data() + k_begin*num_keys);
+            }
+        ), "Failed to decompress ref set keys!");
+}
+//-------------------------------------------------------------------------------------------------------------------
+// Fill one proof's ref set terms in contiguous chunks of members on the threadpool
+// - M[k][alpha]: w2*t_k*mu^alpha, at terms_out[k*num_keys + alpha]
+// - returns sum_k( t_k )
+//-------------------------------------------------------------------------------------------------------------------
+static rct::key concise_grootle_ref_set_terms_mt(const rct::keyV &t,
+    const rct::key &w2,
+    const rct::keyV &mu_pow,
+    const ge_p3 *ref_set_points,
+    const std::size_t num_keys,
+    const std::size_t num_threads,
+    rct::MultiexpData *terms_out)
+{
+    rct::key sum_t = ZERO;
+
+    CHECK_AND_ASSERT_THROW_MES(tools::parallel_reduce(0, t.size(), parallel_grain(t.size(), num_threads), sum_t,
+            [&](const std::size_t k_begin, const std::size_t k_end) -> rct::key
+            {
+                rct::key chunk_sum_t = ZERO;
+                rct::key t_k;
+                rct::key temp;
+
+                for (std::size_t k = k_begin; k < k_end; ++k)
+                {
+                    sc_add(chunk_sum_t.bytes, chunk_sum_t.bytes, t[k].bytes);  // sum_k( t_k )
+
+                    sc_mul(t_k.bytes, w2.bytes, t[k].bytes);  // w2*t_k
+
+                    for (std::size_t alpha = 0; alpha < num_keys; ++alpha)
+                    {
+                        sc_mul(temp.bytes, t_k.bytes, mu_pow[alpha].bytes);  // w2*t_k*mu^alpha
+                        terms_out[k*num_keys + alpha] = {temp, ref_set_points[k*num_keys + alpha]};
+                    }
+                }
+
+                return chunk_sum_t;
+            },
+            [](rct::key sum, const rct::key &chunk_sum) -> rct::key
+            {
+                sc_add(sum.bytes, sum.bytes, chunk_sum.bytes);
+                return sum;
+            }
+        ), "Failed to assemble ref set terms!");
+
+    return sum_t;
+}
+//-------------------------------------------------------------------------------------------------------------------
+// Assemble multiexp data for a batch of concise Grootle proofs
+// - if 'merge_shared_keys' is set, ref set keys that appear in more than one place (e.g. proofs with identical or
+//   overlapping ref sets) only get one multiexp element, and their scalars are summed
+// - if 'M_cache' is set, each proof's ref set terms are pre-aggregated with straus into one multiexp element, using
+//   the cache's precomputed multiples for keys it has seen before (requires 'M_p3' and 'M_ids')
+// - if 'M_cached' is set, all ref set terms go at the front of 'data' and are covered by a pippenger cache copied from
+//   the caller's pre-converted points, so the multiexp converts none of them (requires 'M_p3')
+// - proofs are combined with random weights of 'small_weighting_size' bytes
+// - for big enough ref sets (and without 'merge_shared_keys'), each proof's ref set decompression, f-products and ref
+//   set terms are split across up to 'num_threads' threads (0 = threadpool max concurrency; 1 = serial)
+//-------------------------------------------------------------------------------------------------------------------
+static rct::pippenger_prep_data get_concise_grootle_verification_data_impl(
+    const std::vector<const ConciseGrootleProof*> &proofs,
+    const std::vector<rct::KeyMatrix> &M,
+    const std::vector<std::vector<ge_p3>> *M_p3,
+    const std::vector<std::vector<ge_cached>> *M_cached,
+    const std::vector<std::vector<uint64_t>> *M_ids,
+    rct::straus_point_cache *M_cache,
+    const rct::KeyMatrix &proof_offsets,
     const std::size_t n,
     const std::size_t m,
-    const rct::keyV &messages)
+    const rct::keyV &messages,
+    const bool merge_shared_keys,
+    const std::size_t small_weighting_size,
+    const ConciseGrootleRefSetWaiter &wait_for_ref_set,
+    const std::size_t num_threads)
 {
     /// Global checks
     const std::size_t N_proofs = proofs.size();
@@ -526,27 +604,57 @@ rct::pippenger_prep_data get_concise_grootle_verification_data(const std::vector
     CHECK_AND_ASSERT_THROW_MES(n > 1, "Must have n > 1!");
     CHECK_AND_ASSERT_THROW_MES(m > 1, "Must have m > 1!");
     CHECK_AND_ASSERT_THROW_MES(m*n <= GROOTLE_MAX_MN, "Size parameters are too large!");
+    CHECK_AND_ASSERT_THROW_MES(small_weighting_size >= 1 && small_weighting_size <= 32,
+        "Small weight variable size is invalid!");
 
     // anonymity set size
     const std::size_t N = std::pow(n, m);
 
+    // (ref sets that are waited for are checked as each proof is reached)
     CHECK_AND_ASSERT_THROW_MES(M.size() == N_proofs, "Public key vector is wrong size!");
-    for (const rct::keyM &proof_M : M)
-        CHECK_AND_ASSERT_THROW_MES(proof_M.size() == N, "Public key vector is wrong size!");
+    CHECK_AND_ASSERT_THROW_MES(!wait_for_ref_set || (M_p3 && !M_cached && !merge_shared_keys),
+        "Ref sets can only be waited for with decompressed keys!");
+    for (const rct::KeyMatrix &proof_M : M)
+        CHECK_AND_ASSERT_THROW_MES(wait_for_ref_set || proof_M.rows() == N, "Public key vector is wrong size!");
 
     // inputs line up with proofs
-    CHECK_AND_ASSERT_THROW_MES(proof_offsets.size() == N_proofs, "Commitment offsets don't match with input proofs!");
+    CHECK_AND_ASSERT_THROW_MES(proof_offsets.rows() == N_proofs, "Commitment offsets don't match with input proofs!");
     CHECK_AND_ASSERT_THROW_MES(messages.size() == N_proofs, "Incorrect number of messages!");
 
     // commitment offsets must line up with input sets
-    const std::size_t num_keys = proof_offsets[0].size();
+    const std::size_t num_keys = proof_offsets.cols();
+
+    for (const rct::KeyMatrix &proof_M : M)
+        CHECK_AND_ASSERT_THROW_MES(wait_for_ref_set || proof_M.cols() == num_keys, "Incorrect number of input keys!");
+
+    // decompressed keys (optional) must line up with input sets
+    if (M_p3)
+    {
+        CHECK_AND_ASSERT_THROW_MES(M_p3->size() == N_proofs, "Decompressed public key vector is wrong size!");
+        for (const std::vector<ge_p3> &proof_M_p3 : *M_p3)
+        {
+            CHECK_AND_ASSERT_THROW_MES(wait_for_ref_set || proof_M_p3.size() == N*num_keys,
+                "Decompressed public key vector is wrong size!");
+        }
+    }
 
-    for (const rct::keyV &C_offsets : proof_offsets)
-        CHECK_AND_ASSERT_THROW_MES(C_offsets.size() == num_keys, "Incorrect number of commitment offsets!");
+    // cached ref set keys (optional) need decompressed keys and ids that line up with them
+    if (M_cache)
+    {
+        CHECK_AND_ASSERT_THROW_MES(M_p3 && M_ids && !merge_shared_keys, "Cached ref set keys need decompressed keys!");
+        CHECK_AND_ASSERT_THROW_MES(M_ids->size() == N_proofs, "Public key id vector is wrong size!");
+        for (const std::vector<uint64_t> &proof_M_ids : *M_ids)
+            CHECK_AND_ASSERT_THROW_MES(proof_M_ids.size() == N*num_keys, "Public key id vector is wrong size!");
+    }
 
-    for (const rct::keyM &proof_M : M)
-        for (const rct::keyV &tuple : proof_M)
-            CHECK_AND_ASSERT_THROW_MES(tuple.size() == num_keys, "Incorrect number of input keys!");
+    // pre-converted ref set keys (optional) need decompressed keys that line up with them
+    if (M_cached)
+    {
+        CHECK_AND_ASSERT_THROW_MES(M_p3 && !M_cache && !merge_shared_keys, "Pre-converted ref set keys need decompressed keys!");
+        CHECK_AND_ASSERT_THROW_MES(M_cached->size() == N_proofs, "Pre-converted public key vector is wrong size!");
+        for (const std::vector<ge_cached> &proof_M_cached : *M_cached)
+            CHECK_AND_ASSERT_THROW_MES(proof_M_cached.size() == N*num_keys, "Pre-converted public key vector is wrong size!");
+    }
 
 
     /// Per-proof checks
@@ -572,53 +680,95 @@ rct::pippenger_prep_data get_concise_grootle_verification_data(const std::vector
     }
 
     // prepare context
-    init_static();
+    // - temporaries are borrowed from this thread's scratch arena, and 'data' is taken from the multiexp data pool (the
+    //   caller can recycle it once the batch is checked), so steady-state calls do not allocate
+    const std::shared_ptr<rct::fixed_base_cached_data> gen_cache{get_generator_cache(m*n)};
+    SpScratchFrame scratch{sp_thread_scratch_arena()};
     rct::key temp;  //common variable shuttle so only one needs to be allocated
 
 
     /// setup 'data': for aggregate multi-exponentiation computation across all proofs
 
-    // per-index storage:
+    // generator scalars (evaluated separately with fixed-base tables):
     // 0                                  G                             (zA*G, z*G)
     // 1                  2*m*n           alternate(Hi_A[i], Hi_B[i])   {f, f*(xi - f)}
-    //    <per-proof, start at 2*m*n + 1>
+    //
+    // per-index storage:
+    // 0                                  sum of generator terms        (1)
+    //    <per-proof, start at 1>
     // 0                  num_keys-1      M[0][alpha]                   (f-coefficients)
     // ...
     // (N-1)*num_keys     N*num_keys-1    M[N-1][alpha]
     // ... other proof data: A, B, {C_offsets}, {X}
-    std::vector<rct::MultiexpData> data;
-    std::size_t max_size{(1 + 2*m*n) + N_proofs*(N*num_keys + 2 + num_keys + m)};
-    data.reserve(max_size);
-    data.resize(1 + 2*m*n); // start with common/batched elements
+    // (with cached ref set keys, each proof's M[k][alpha] terms are one element: straus(M terms))
+    // (with pre-converted ref set keys, all proofs' M[k][alpha] terms come first and the generator element follows them)
+    rct::keyV &gen_scalars = scratch.keys(1 + 2*m*n);
+    std::fill(gen_scalars.begin(), gen_scalars.end(), ZERO);
+    const std::size_t ref_set_elements{M_cache ? 1 : N*num_keys};
+    std::size_t max_size{1 + N_proofs*(ref_set_elements + 2 + num_keys + m)};
+    std::vector<rct::MultiexpData> data{rct::take_multiexp_data_buffer(max_size)};
+    const std::size_t generator_position{M_cached ? N_proofs*N*num_keys : 0};
+    std::size_t ref_set_position{0};
+    data.resize(generator_position + 1); // start with common/batched element (set at the end)
     std::size_t offset{0};
 
-    // prep terms: G, {Hi_A, Hi_B}
-    data[0] = {ZERO, G_p3};
-    offset = 1;
-    for (std::size_t i = 0; i < m*n; ++i)
-    {
-        data[offset + 2*i    ] = {ZERO, Hi_A_p3[i]};
-        data[offset + 2*i + 1] = {ZERO, Hi_B_p3[i]};
-    }
-
 
     /// per-proof data assembly
     std::size_t skipped_offsets{0};
 
+    // positions of ref set keys in 'data' (only used when merging shared keys)
+    std::unordered_map<rct::key, std::size_t> ref_key_positions;
+    std::size_t merged_ref_keys{0};
+    if (merge_shared_keys)
+        ref_key_positions.reserve(N_proofs*N*num_keys);
+
+    // batch-decompressed points (ref set keys, and {A, B, X})
+    // - when merging shared keys, each ref set key is decompressed on first use instead
+    const bool decompress_ref_sets{!M_p3 && !merge_shared_keys};
+    const bool parallel_ref_sets{num_threads != 1 && !merge_shared_keys && N*num_keys >= MIN_PARALLEL_REF_SET_TERMS};
+    rct::keyV &batch_keys = scratch.keys(0);
+    std::vector<ge_p3> &ref_set_p3 = scratch.points();
+    std::vector<ge_p3> &proof8_points = scratch.points();
+    std::vector<rct::MultiexpData> &ref_set_data = scratch.multiexp_data();
+    if (M_cache)
+        ref_set_data.reserve(N*num_keys);
+
+    // f-matrix, one-of-many coefficients {t_k}, and challenge powers (scratch reused between proofs)
+    rct::KeyMatrix &f = scratch.key_matrix(m, n);
+    rct::keyV &f_prefix_temp = scratch.keys(0);
+    rct::keyV &t = scratch.keys(0);
+    rct::keyV &mu_pow = scratch.keys(0);
+    rct::keyV &minus_xi_pow = scratch.keys(0);
+
     for (std::size_t proof_i = 0; proof_i < N_proofs; ++proof_i)
     {
+        if (wait_for_ref_set)
+        {
+            wait_for_ref_set(proof_i);
+            CHECK_AND_ASSERT_THROW_MES(M[proof_i].rows() == N && M[proof_i].cols() == num_keys,
+                "Public key vector is wrong size!");
+            CHECK_AND_ASSERT_THROW_MES((*M_p3)[proof_i].size() == N*num_keys,
+                "Decompressed public key vector is wrong size!");
+        }
+
         const ConciseGrootleProof &proof = *(proofs[proof_i]);
-        const rct::keyM &proof_M = M[proof_i];
+        const rct::KeyMatrix &proof_M = M[proof_i];
+
+        if (decompress_ref_sets && parallel_ref_sets)
+            decompress_ref_set_mt(proof_M, num_threads, ref_set_p3);
+        else if (decompress_ref_sets)
+            rct::decompress_points({proof_M.data(), proof_M.size()}, ref_set_p3);
 
         // random weights
         // - to allow verifiying batches of proofs, must weight each proof's components randomly so an adversary doesn't
         //   gain an advantage if >1 of their proofs are being validated in a batch
+        // - w1 is a negated small scalar, so A's multiexp scalar (-w1) is small
         rct::key w1 = ZERO;  // decomp:        w1*[ A + xi*B == dual_matrix_commit(zA, f, f*(xi - f)) ]
         rct::key w2 = ZERO;  // main stuff:    w2*[ ... - zG == 0 ]
         while (w1 == ZERO || w2 == ZERO)
         {
-            w1 = small_scalar_gen(32);
-            w2 = small_scalar_gen(32);
+            w1 = minus_small_scalar_gen(small_weighting_size);
+            w2 = small_scalar_gen(small_weighting_size);
         }
 
         // Transcript challenges
@@ -632,26 +782,23 @@ rct::pippenger_prep_data get_concise_grootle_verification_data(const std::vector
         const rct::key xi{compute_challenge(mu, proof.X)};
 
         // Aggregation coefficient powers
-        rct::keyV mu_pow = powers_of_scalar(mu, num_keys);
+        powers_of_scalar(mu, num_keys, false, mu_pow);
 
         // Challenge powers (negated)
-        rct::keyV minus_xi_pow = powers_of_scalar(xi, m, true);
+        powers_of_scalar(xi, m, true, minus_xi_pow);
 
-        // Recover proof elements
-        ge_p3 A_p3;
-        ge_p3 B_p3;
-        std::vector<ge_p3> X_p3;
-        X_p3.resize(m);
+        // Recover proof elements: A, B, {X}
+        batch_keys.clear();
+        batch_keys.push_back(proof.A);
+        batch_keys.push_back(proof.B);
+        batch_keys.insert(batch_keys.end(), proof.X.begin(), proof.X.end());
+        rct::scalarmult8_points(batch_keys, proof8_points);
 
-        scalarmult8(A_p3, proof.A);
-        scalarmult8(B_p3, proof.B);
-        for (std::size_t j = 0; j < m; ++j)
-        {
-            scalarmult8(X_p3[j], proof.X[j]);
-        }
+        const ge_p3 &A_p3 = proof8_points[0];
+        const ge_p3 &B_p3 = proof8_points[1];
+        const ge_p3 *X_p3 = proof8_points.data() + 2;
 
         // Reconstruct the f-matrix
-        rct::keyM f = rct::keyMInit(n, m);
         for (std::size_t j = 0; j < m; ++j)
         {
             // f[j][0] = xi - sum(f[j][i]) [from i = [1, n)]
@@ -672,7 +819,7 @@ rct::pippenger_prep_data get_concise_grootle_verification_data(const std::vector
         //   w1* [ A + xi*B == zA * G + ... f[j][i] * Hi_A[j][i] ... + ... f[j][i] * (xi - f[j][i]) * Hi_B[j][i] ... ]
         //       [          == dual_matrix_commit(zA, f, f*(xi - f))                                                 ]
         // G: w1*zA
-        sc_muladd(data[0].scalar.bytes, w1.bytes, proof.zA.bytes, data[0].scalar.bytes);  // w1*zA
+        sc_muladd(gen_scalars[0].bytes, w1.bytes, proof.zA.bytes, gen_scalars[0].bytes);  // w1*zA
         offset = 1;
 
         rct::key Hi_temp;
@@ -682,13 +829,13 @@ rct::pippenger_prep_data get_concise_grootle_verification_data(const std::vector
             {
                 // Hi_A: w1*f[j][i]
                 sc_mul(Hi_temp.bytes, w1.bytes, f[j][i].bytes);  // w1*f[j][i]
-                sc_add(data[offset + 2*(j*n + i)].scalar.bytes, data[offset + 2*(j*n + i)].scalar.bytes, Hi_temp.bytes);
+                sc_add(gen_scalars[offset + 2*(j*n + i)].bytes, gen_scalars[offset + 2*(j*n + i)].bytes, Hi_temp.bytes);
 
                 // Hi_B: w1*f[j][i]*(xi - f[j][i]) -> w1*xi*f[j][i] - w1*f[j][i]*f[j][i]
                 sc_mul(temp.bytes, xi.bytes, Hi_temp.bytes);  //w1*xi*f[j][i]
                 sc_mul(Hi_temp.bytes, f[j][i].bytes, Hi_temp.bytes);  //w1*f[j][i]*f[j][i]
                 sc_sub(temp.bytes, temp.bytes, Hi_temp.bytes);  //[] - []
-                sc_add(data[offset + 2*(j*n + i) + 1].scalar.bytes, data[offset + 2*(j*n + i) + 1].scalar.bytes, temp.bytes);
+                sc_add(gen_scalars[offset + 2*(j*n + i) + 1].bytes, gen_scalars[offset + 2*(j*n + i) + 1].bytes, temp.bytes);
             }
         }
 
@@ -713,30 +860,83 @@ rct::pippenger_prep_data get_concise_grootle_verification_data(const std::vector
         // M[k][alpha]: w2*t_k*mu^alpha
         rct::key sum_t = ZERO;
         rct::key t_k;
-        for (std::size_t k = 0; k < N; ++k)
+        ref_set_data.clear();
+        if (parallel_ref_sets)
         {
-            t_k = ONE;
-            std::vector<std::size_t> decomp_k;
-            decomp_k.resize(m);
-            decompose(k, n, m, decomp_k);
+            // each chunk of members fills its own slots
+            one_of_many_f_products_mt(f, n, m, num_threads, t);  // t_k = mul_all_j(f[j][decomp_k[j]])
 
-            for (std::size_t j = 0; j < m; ++j)
+            rct::MultiexpData *ref_set_terms;
+            if (M_cached)
             {
-                sc_mul(t_k.bytes, t_k.bytes, f[j][decomp_k[j]].bytes);  // mul_all_j(f[j][decomp_k[j]])
+                ref_set_terms = data.data() + ref_set_position;
+                ref_set_position += N*num_keys;
+            }
+            else if (M_cache)
+            {
+                ref_set_data.resize(N*num_keys);
+                ref_set_terms = ref_set_data.data();
+            }
+            else
+            {
+                data.resize(data.size() + N*num_keys);
+                ref_set_terms = data.data() + data.size() - N*num_keys;
             }
 
-            sc_add(sum_t.bytes, sum_t.bytes, t_k.bytes);  // sum_k( t_k )
-
-            // borrow the t_k variable...
-            sc_mul(t_k.bytes, w2.bytes, t_k.bytes);  // w2*t_k
-
-            for (std::size_t alpha = 0; alpha < num_keys; ++alpha)
+            sum_t = concise_grootle_ref_set_terms_mt(t,
+                w2,
+                mu_pow,
+                M_p3 ? (*M_p3)[proof_i].data() : ref_set_p3.data(),
+                num_keys,
+                num_threads,
+                ref_set_terms);
+        }
+        else
+        {
+            one_of_many_f_products(f, n, m, f_prefix_temp, t);  // t_k = mul_all_j(f[j][decomp_k[j]])
+            for (std::size_t k = 0; k < N; ++k)
             {
-                sc_mul(temp.bytes, t_k.bytes, mu_pow[alpha].bytes);  // w2*t_k*mu^alpha
-                data.emplace_back(temp, proof_M[k][alpha]);
+                sc_add(sum_t.bytes, sum_t.bytes, t[k].bytes);  // sum_k( t_k )
+
+                sc_mul(t_k.bytes, w2.bytes, t[k].bytes);  // w2*t_k
+
+                for (std::size_t alpha = 0; alpha < num_keys; ++alpha)
+                {
+                    sc_mul(temp.bytes, t_k.bytes, mu_pow[alpha].bytes);  // w2*t_k*mu^alpha
+
+                    if (merge_shared_keys)
+                    {
+                        // shared key: add this proof's scalar to the key's existing element
+                        const auto key_position = ref_key_positions.find(proof_M[k][alpha]);
+                        if (key_position != ref_key_positions.end())
+                        {
+                            sc_add(data[key_position->second].scalar.bytes,
+                                data[key_position->second].scalar.bytes,
+                                temp.bytes);
+                            ++merged_ref_keys;
+                            continue;
+                        }
+
+                        ref_key_positions[proof_M[k][alpha]] = data.size();
+                    }
+
+                    if (M_cached)
+                        data[ref_set_position++] = {temp, (*M_p3)[proof_i][k*num_keys + alpha]};
+                    else if (M_cache)
+                        ref_set_data.emplace_back(temp, (*M_p3)[proof_i][k*num_keys + alpha]);
+                    else if (M_p3)
+                        data.emplace_back(temp, (*M_p3)[proof_i][k*num_keys + alpha]);
+                    else if (decompress_ref_sets)
+                        data.emplace_back(temp, ref_set_p3[k*num_keys + alpha]);
+                    else
+                        data.emplace_back(temp, proof_M[k][alpha]);
+                }
             }
         }
 
+        if (M_cache)
+            data.emplace_back(ONE, rct::straus_p3(ref_set_data, (*M_ids)[proof_i], *M_cache));
+
         // {C_offsets}
         //   ... - w2*sum_k( t_k )*sum_{alpha}(mu^alpha*C_offsets[alpha]) ...
         // 
@@ -772,27 +972,114 @@ rct::pippenger_prep_data get_concise_grootle_verification_data(const std::vector
         // G: -w2*z
         sc_mul(temp.bytes, MINUS_ONE.bytes, proof.z.bytes);
         sc_mul(temp.bytes, temp.bytes, w2.bytes);
-        sc_add(data[0].scalar.bytes, data[0].scalar.bytes, temp.bytes);
+        sc_add(gen_scalars[0].bytes, gen_scalars[0].bytes, temp.bytes);
     }
 
 
+    /// Generator terms: G, {Hi_A, Hi_B}
+    data[generator_position] = {ONE, rct::fixed_base_multiexp_p3(gen_scalars, gen_cache)};
+
+
     /// Final check
-    CHECK_AND_ASSERT_THROW_MES(data.size() == max_size - skipped_offsets, "Final proof data is incorrect size!");
+    CHECK_AND_ASSERT_THROW_MES(data.size() == max_size - skipped_offsets - merged_ref_keys,
+        "Final proof data is incorrect size!");
 
 
     /// return multiexp data for caller to deal with
-    return rct::pippenger_prep_data{std::move(data), generator_cache, 1 + 2*m*n};
+    if (M_cached)
+    {
+        std::vector<epee::span<const ge_cached>> ref_set_cached;
+        ref_set_cached.reserve(N_proofs);
+        for (const std::vector<ge_cached> &proof_M_cached : *M_cached)
+            ref_set_cached.emplace_back(epee::to_span(proof_M_cached));
+
+        return rct::pippenger_prep_data{std::move(data), rct::pippenger_init_cache(ref_set_cached), generator_position};
+    }
+
+    return rct::pippenger_prep_data{std::move(data), nullptr, 0};
 }
 //-------------------------------------------------------------------------------------------------------------------
-bool concise_grootle_verify(const std::vector<const ConciseGrootleProof*> &proofs,
-    const std::vector<rct::keyM> &M,
-    const rct::keyM &proof_offsets,
+rct::pippenger_prep_data get_concise_grootle_verification_data(const std::vector<const ConciseGrootleProof*> &proofs,
+    const std::vector<rct::KeyMatrix> &M,
+    const rct::KeyMatrix &proof_offsets,
+    const std::size_t n,
+    const std::size_t m,
+    const rct::keyV &messages,
+    const std::size_t small_weighting_size,
+    const std::size_t num_threads)
+{
+    return get_concise_grootle_verification_data_impl(proofs, M, nullptr, nullptr, nullptr, nullptr, proof_offsets, n, m, messages, false,
+        small_weighting_size, nullptr, num_threads);
+}
+//-------------------------------------------------------------------------------------------------------------------
+rct::pippenger_prep_data get_concise_grootle_verification_data(const std::vector<const ConciseGrootleProof*> &proofs,
+    const std::vector<rct::KeyMatrix> &M,
+    const std::vector<std::vector<ge_p3>> &M_p3,
+    const rct::KeyMatrix &proof_offsets,
+    const std::size_t n,
+    const std::size_t m,
+    const rct::keyV &messages,
+    const ConciseGrootleRefSetWaiter &wait_for_ref_set)
+{
+    return get_concise_grootle_verification_data_impl(proofs, M, &M_p3, nullptr, nullptr, nullptr, proof_offsets, n, m, messages, false,
+        DEFAULT_BATCH_WEIGHT_SIZE, wait_for_ref_set, 1);
+}
+//-------------------------------------------------------------------------------------------------------------------
+rct::pippenger_prep_data get_concise_grootle_verification_data(const std::vector<const ConciseGrootleProof*> &proofs,
+    const std::vector<rct::KeyMatrix> &M,
+    const std::vector<std::vector<ge_p3>> &M_p3,
+    const std::vector<std::vector<uint64_t>> &M_ids,
+    rct::straus_point_cache &M_cache,
+    const rct::KeyMatrix &proof_offsets,
+    const std::size_t n,
+    const std::size_t m,
+    const rct::keyV &messages,
+    const ConciseGrootleRefSetWaiter &wait_for_ref_set)
+{
+    return get_concise_grootle_verification_data_impl(proofs, M, &M_p3, nullptr, &M_ids, &M_cache, proof_offsets, n, m, messages, false,
+        DEFAULT_BATCH_WEIGHT_SIZE, wait_for_ref_set, 1);
+}
+//-------------------------------------------------------------------------------------------------------------------
+rct::pippenger_prep_data get_concise_grootle_verification_data(const std::vector<const ConciseGrootleProof*> &proofs,
+    const std::vector<rct::KeyMatrix> &M,
+    const std::vector<std::vector<ge_p3>> &M_p3,
+    const std::vector<std::vector<ge_cached>> &M_cached,
+    const rct::KeyMatrix &proof_offsets,
     const std::size_t n,
     const std::size_t m,
     const rct::keyV &messages)
+{
+    return get_concise_grootle_verification_data_impl(proofs, M, &M_p3, &M_cached, nullptr, nullptr, proof_offsets, n, m, messages, false,
+        DEFAULT_BATCH_WEIGHT_SIZE, nullptr, 1);
+}
+//-------------------------------------------------------------------------------------------------------------------
+rct::pippenger_prep_data get_concise_grootle_verification_data_shared_refs(
+    const std::vector<const ConciseGrootleProof*> &proofs,
+    const std::vector<rct::KeyMatrix> &M,
+    const rct::KeyMatrix &proof_offsets,
+    const std::size_t n,
+    const std::size_t m,
+    const rct::keyV &messages,
+    const std::size_t small_weighting_size)
+{
+    return get_concise_grootle_verification_data_impl(proofs, M, nullptr, nullptr, nullptr, nullptr, proof_offsets, n, m, messages, true,
+        small_weighting_size, nullptr, 1);
+}
+//-------------------------------------------------------------------------------------------------------------------
+bool concise_grootle_verify(const std::vector<const ConciseGrootleProof*> &proofs,
+    const std::vector<rct::KeyMatrix> &M,
+    const rct::KeyMatrix &proof_offsets,
+    const std::size_t n,
+    const std::size_t m,
+    const rct::keyV &messages,
+    const std::size_t small_weighting_size,
+    const std::size_t num_threads)
 {
     // build and verify multiexp
-    if (!check_pippenger_data(get_concise_grootle_verification_data(proofs, M, proof_offsets, n, m, messages)))
+    if (!check_pippenger_data(
+            get_concise_grootle_verification_data(proofs, M, proof_offsets, n, m, messages, small_weighting_size,
+                num_threads),
+            num_threads))
     {
         MERROR("Concise Grootle proof: verification failed!");
         return false;
@@ -801,4 +1088,1219 @@ bool concise_grootle_verify(const std::vector<const ConciseGrootleProof*> &proof
     return true;
 }
 //-------------------------------------------------------------------------------------------------------------------
+bool concise_grootle_verify_shared_refs(const std::vector<const ConciseGrootleProof*> &proofs,
+    const std::vector<rct::KeyMatrix> &M,
+    const rct::KeyMatrix &proof_offsets,
+    const std::size_t n,
+    const std::size_t m,
+    const rct::keyV &messages,
+    const std::size_t small_weighting_size)
+{
+    // build and verify multiexp
+    if (!check_pippenger_data(get_concise_grootle_verification_data_shared_refs(proofs,
+            M,
+            proof_offsets,
+            n,
+            m,
+            messages,
+            small_weighting_size)))
+    {
+        MERROR("Concise Grootle proof (shared ref sets): verification failed!");
+        return false;
+    }
+
+    return true;
+}
+//-------------------------------------------------------------------------------------------------------------------
+// Aggregated proofs: one concise proof for the membership of k inputs (see AggregateConciseGrootleProof)
+//-------------------------------------------------------------------------------------------------------------------
+static void aggregate_transcript_init(SpTranscript &transcript_inout)
+{
+    // H("domain-sep") is a constant
+    static const rct::key domain_separator{
+            []()
+            {
+                SpTranscript salt;
+                salt.absorb_string(config::HASH_KEY_AGGREGATE_GROOTLE_TRANSCRIPT);
+                return salt.challenge();
+            }()
+        };
+
+    transcript_inout.absorb(domain_separator);
+}
+//-------------------------------------------------------------------------------------------------------------------
+// Base aggregation coefficient for an aggregated proof
+// mu = H(H("domain-sep"), message, k, {{M}}_0, ..., {{M}}_{k-1}, {{C_offsets}}, A, B)
+//-------------------------------------------------------------------------------------------------------------------
+static rct::key compute_aggregate_base_aggregation_coefficient(const rct::key &message,
+    const std::vector<rct::KeyMatrix> &M,
+    const rct::KeyMatrix &C_offsets,
+    const rct::key &A,
+    const rct::key &B)
+{
+    CHECK_AND_ASSERT_THROW_MES(M.size() == C_offsets.rows(), "Transcript challenge inputs have incorrect size!");
+
+    // initialize transcript message
+    SpTranscript transcript;
+    aggregate_transcript_init(transcript);
+
+    // absorb challenge elements
+    transcript.absorb(message);
+    transcript.absorb_varint(M.size());
+    for (const rct::KeyMatrix &input_M : M)
+    {
+        CHECK_AND_ASSERT_THROW_MES(input_M.cols() == C_offsets.cols(), "Transcript challenge inputs have incorrect size!");
+        transcript.absorb(input_M);
+    }
+    transcript.absorb(C_offsets);
+    transcript.absorb(A);
+    transcript.absorb(B);
+
+    // challenge
+    const rct::key challenge{transcript.challenge()};
+
+    CHECK_AND_ASSERT_THROW_MES(!(challenge == ZERO), "Transcript challenge must be nonzero!");
+
+    return challenge;
+}
+//-------------------------------------------------------------------------------------------------------------------
+AggregateConciseGrootleProof aggregate_concise_grootle_prove(const std::vector<rct::KeyMatrix> &M, // (per-input) ref sets
+    const std::vector<std::size_t> &l,  // (per-input) secret index into {{M}}
+    const rct::KeyMatrix &C_offsets,  // (per-input) offsets for commitment to zero at index l
+    const std::vector<std::vector<crypto::secret_key>> &privkeys,  // (per-input) privkeys of 'M[l] - C_offsets'
+    const std::size_t n,        // decomp input set: n^m
+    const std::size_t m,
+    const rct::key &message)    // message to insert in Fiat-Shamir transform hash
+{
+    MOCK_TX_PHASE_TIMER(MEMBERSHIP_PROOF_PROVE);
+
+    /// input checks and initialization
+    const std::size_t num_inputs = M.size();
+
+    CHECK_AND_ASSERT_THROW_MES(num_inputs > 0, "Must have at least one input!");
+    CHECK_AND_ASSERT_THROW_MES(n > 1, "Must have n > 1!");
+    CHECK_AND_ASSERT_THROW_MES(m > 1, "Must have m > 1!");
+    CHECK_AND_ASSERT_THROW_MES(num_inputs*m*n <= GROOTLE_MAX_MN, "Too many inputs to aggregate for this decomposition!");
+
+    // ref set size
+    const std::size_t N = std::pow(n, m);
+
+    // number of parallel commitments to zero (per input)
+    const std::size_t num_keys = C_offsets.cols();
+
+    CHECK_AND_ASSERT_THROW_MES(l.size() == num_inputs, "Signing index vector is wrong size!");
+    CHECK_AND_ASSERT_THROW_MES(C_offsets.rows() == num_inputs, "Commitment offsets are wrong size!");
+    CHECK_AND_ASSERT_THROW_MES(privkeys.size() == num_inputs, "Private key vector is wrong size!");
+
+    for (std::size_t u = 0; u < num_inputs; ++u)
+    {
+        CHECK_AND_ASSERT_THROW_MES(M[u].rows() == N, "Ref set vector is wrong size!");
+        CHECK_AND_ASSERT_THROW_MES(M[u].cols() == num_keys, "Commitment tuple is wrong size!");
+        CHECK_AND_ASSERT_THROW_MES(privkeys[u].size() == num_keys, "Private key vector is wrong size!");
+        CHECK_AND_ASSERT_THROW_MES(l[u] < N, "Signing index out of bounds!");
+
+        for (std::size_t alpha = 0; alpha < num_keys; ++alpha)
+        {
+            // verify: commitment to zero C_zero = M - C_offset = k*G
+            rct::key C_zero_temp;
+            rct::subKeys(C_zero_temp, M[u][l[u]][alpha], C_offsets[u][alpha]);
+            CHECK_AND_ASSERT_THROW_MES(rct::scalarmultBase(rct::sk2rct(privkeys[u][alpha])) == C_zero_temp,
+                "Bad commitment key!");
+        }
+    }
+
+    // statically initialize Grootle proof generators
+    init_gens();
+
+
+    /// Aggregated concise Grootle proof
+    AggregateConciseGrootleProof proof;
+
+
+    /// Decomposition sub-proof commitments: A, B (one matrix row per input digit: input u's row j is u*m + j)
+    const std::size_t num_rows = num_inputs*m;
+    std::vector<rct::MultiexpData> data;
+
+    // Matrix masks
+    rct::key rA = rct::skGen();
+    rct::key rB = rct::skGen();
+
+    // A: commit to zero-sum values: {a, -a^2}
+    rct::keyM a = rct::keyMInit(n, num_rows);
+    rct::keyM a_sq = a;
+    for (std::size_t r = 0; r < num_rows; ++r)
+    {
+        a[r][0] = ZERO;
+        for (std::size_t i = 1; i < n; ++i)
+        {
+            // a
+            a[r][i] = rct::skGen();
+            sc_sub(a[r][0].bytes, a[r][0].bytes, a[r][i].bytes);  //a[r][0] = - sum(a[1,..,n])
+
+            // -a^2
+            sc_mul(a_sq[r][i].bytes, a[r][i].bytes, a[r][i].bytes);
+            sc_mul(a_sq[r][i].bytes, MINUS_ONE.bytes, a_sq[r][i].bytes);
+        }
+
+        // -(a[r][0])^2
+        sc_mul(a_sq[r][0].bytes, a[r][0].bytes, a[r][0].bytes);
+        sc_mul(a_sq[r][0].bytes, MINUS_ONE.bytes, a_sq[r][0].bytes);
+    }
+    grootle_matrix_commitment(rA, a, a_sq, data);  //A = dual_matrix_commit(r_A, a, -a^2)
+    CHECK_AND_ASSERT_THROW_MES(data.size() == 1 + 2*num_rows*n, "Matrix commitment returned unexpected size!");
+    proof.A = rct::multiexp_auto(data);
+    CHECK_AND_ASSERT_THROW_MES(!(proof.A == IDENTITY), "Linear combination unexpectedly returned zero!");
+
+    // B: commit to decomposition bits: {sigma, a*(1-2*sigma)}
+    std::vector<std::vector<std::size_t>> decomp_l(num_inputs, std::vector<std::size_t>(m));
+    rct::keyM sigma = rct::keyMInit(n, num_rows);
+    rct::keyM a_sigma = sigma;
+    for (std::size_t u = 0; u < num_inputs; ++u)
+    {
+        decompose(l[u], n, m, decomp_l[u]);
+
+        for (std::size_t j = 0; j < m; ++j)
+        {
+            const std::size_t r = u*m + j;
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                // sigma
+                sigma[r][i] = kronecker_delta(decomp_l[u][j], i);
+
+                // a*(1-2*sigma)
+                sc_mulsub(a_sigma[r][i].bytes, TWO.bytes, sigma[r][i].bytes, ONE.bytes);  //1-2*sigma
+                sc_mul(a_sigma[r][i].bytes, a_sigma[r][i].bytes, a[r][i].bytes);  //a*(1-2*sigma)
+            }
+        }
+    }
+    grootle_matrix_commitment(rB, sigma, a_sigma, data);  //B = dual_matrix_commit(r_B, sigma, a*(1-2*sigma))
+    CHECK_AND_ASSERT_THROW_MES(data.size() == 1 + 2*num_rows*n, "Matrix commitment returned unexpected size!");
+    proof.B = rct::multiexp_auto(data);
+    CHECK_AND_ASSERT_THROW_MES(!(proof.B == IDENTITY), "Linear combination unexpectedly returned zero!");
+
+    // done: store (1/8)*commitment
+    proof.A = rct::scalarmultKey(proof.A, rct::INV_EIGHT);
+    proof.B = rct::scalarmultKey(proof.B, rct::INV_EIGHT);
+
+
+    /// one-of-many sub-proofs: per-input polynomial 'p' coefficients
+    std::vector<rct::keyM> p(num_inputs);
+    rct::keyM a_input;
+    for (std::size_t u = 0; u < num_inputs; ++u)
+    {
+        a_input.assign(a.begin() + u*m, a.begin() + (u + 1)*m);
+        one_of_many_coefficients(a_input, decomp_l[u], n, m, p[u]);
+        CHECK_AND_ASSERT_THROW_MES(p[u].size() == N, "Bad matrix size!");
+        CHECK_AND_ASSERT_THROW_MES(p[u][0].size() == m + 1, "Bad matrix size!");
+    }
+    for (rct::keyV &a_row : a_input)
+        memwipe(a_row.data(), a_row.size()*sizeof(rct::key));
+
+
+    /// one-of-many sub-proof initial values: {rho}, mu, {X}
+
+    // {rho}: proof entropy
+    rct::keyV rho;
+    rho.reserve(m);
+    for (std::size_t j = 0; j < m; ++j)
+    {
+        rho.push_back(rct::skGen());
+    }
+
+    // mu: base aggregation coefficient
+    const rct::key mu{compute_aggregate_base_aggregation_coefficient(message, M, C_offsets, proof.A, proof.B)};
+
+    // mu^(u*num_keys + alpha): powers of the aggregation coefficient, chained across the inputs
+    rct::keyV mu_pow = powers_of_scalar(mu, num_inputs*num_keys);
+
+    // commitments to zero 'M[k][alpha] - C_offset[alpha]' of all inputs (the same for every X[j])
+    std::vector<ge_p3> C_zero_nominal_p3(num_inputs*N*num_keys);
+    for (std::size_t u = 0; u < num_inputs; ++u)
+    {
+        for (std::size_t k = 0; k < N; ++k)
+        {
+            for (std::size_t alpha = 0; alpha < num_keys; ++alpha)
+                sp::sub_keys_p3(M[u][k][alpha], C_offsets[u][alpha], C_zero_nominal_p3[(u*N + k)*num_keys + alpha]);
+        }
+    }
+
+    // {X}: 'encodings' of all inputs' [p] (i.e. of the real signing indices in the referenced tuple sets)
+    proof.X = rct::keyV(m);
+    rct::key c_zero_nominal_prefix_temp;
+    std::vector<rct::MultiexpData> data_X;
+    data_X.reserve(num_inputs*N*num_keys);
+    for (std::size_t j = 0; j < m; ++j)
+    {
+        data_X.clear();
+
+        for (std::size_t u = 0; u < num_inputs; ++u)
+        {
+            for (std::size_t k = 0; k < N; ++k)
+            {
+                // X[j] += p_u[k][j] * sum_{alpha}( mu^(u*num_keys + alpha) * (M_u[k][alpha] - C_offset_u[alpha]) )
+                for (std::size_t alpha = 0; alpha < num_keys; ++alpha)
+                {
+                    sc_mul(c_zero_nominal_prefix_temp.bytes, mu_pow[u*num_keys + alpha].bytes, p[u][k][j].bytes);
+                    data_X.push_back({c_zero_nominal_prefix_temp, C_zero_nominal_p3[(u*N + k)*num_keys + alpha]});
+                }
+            }
+        }
+
+        // X[j] += rho[j]*G
+        rct::addKeys1(proof.X[j], rho[j], rct::multiexp_auto(data_X));
+        CHECK_AND_ASSERT_THROW_MES(!(proof.X[j] == IDENTITY), "Proof coefficient element should not be zero!");
+    }
+
+    // done: store (1/8)*X
+    for (std::size_t j = 0; j < m; ++j)
+    {
+        rct::scalarmultKey(proof.X[j], proof.X[j], rct::INV_EIGHT);
+    }
+
+
+    /// one-of-many sub-proof challenges
+
+    // xi: challenge
+    const rct::key xi{compute_challenge(mu, proof.X)};
+
+    // xi^j: challenge powers
+    rct::keyV xi_pow = powers_of_scalar(xi, m + 1);
+
+
+    /// aggregated proof final components/responses
+
+    // f-matrix: encapsulate the indices {l}
+    proof.f = rct::keyMInit(n - 1, num_rows);
+    for (std::size_t r = 0; r < num_rows; ++r)
+    {
+        for (std::size_t i = 1; i < n; ++i)
+        {
+            sc_muladd(proof.f[r][i - 1].bytes, sigma[r][i].bytes, xi.bytes, a[r][i].bytes);
+            CHECK_AND_ASSERT_THROW_MES(!(proof.f[r][i - 1] == ZERO), "Proof matrix element should not be zero!");
+        }
+    }
+
+    // z-terms: responses
+    // zA = rB*xi + rA
+    sc_muladd(proof.zA.bytes, rB.bytes, xi.bytes, rA.bytes);
+    CHECK_AND_ASSERT_THROW_MES(!(proof.zA == ZERO), "Proof scalar element should not be zero!");
+
+    // z = (sum_{u, alpha}( mu^(u*num_keys + alpha)*privkey_u[alpha] ))*xi^m -
+    //     rho[0]*xi^0 - ... - rho[m - 1]*xi^(m - 1)
+    proof.z = ZERO;
+    for (std::size_t u = 0; u < num_inputs; ++u)
+    {
+        for (std::size_t alpha = 0; alpha < num_keys; ++alpha)
+        {
+            sc_muladd(proof.z.bytes, mu_pow[u*num_keys + alpha].bytes, &(privkeys[u][alpha]), proof.z.bytes);
+        }
+    }
+    sc_mul(proof.z.bytes, proof.z.bytes, xi_pow[m].bytes);  //z *= xi^m
+
+    for (std::size_t j = 0; j < m; ++j)
+    {
+        sc_mulsub(proof.z.bytes, rho[j].bytes, xi_pow[j].bytes, proof.z.bytes);  //z -= rho[j]*xi^j
+    }
+    CHECK_AND_ASSERT_THROW_MES(!(proof.z == ZERO), "Proof scalar element should not be zero!");
+
+
+    /// cleanup: clear secret prover data
+    memwipe(&rA, sizeof(rct::key));
+    memwipe(&rB, sizeof(rct::key));
+    for (std::size_t r = 0; r < num_rows; ++r)
+    {
+        memwipe(a[r].data(), a[r].size()*sizeof(rct::key));
+    }
+    memwipe(rho.data(), rho.size()*sizeof(rct::key));
+
+    return proof;
+}
+//-------------------------------------------------------------------------------------------------------------------
+rct::pippenger_prep_data get_aggregate_concise_grootle_verification_data(
+    const std::vector<const AggregateConciseGrootleProof*> &proofs,
+    const std::vector<std::vector<rct::KeyMatrix>> &M,
+    const std::vector<rct::KeyMatrix> &proof_offsets,
+    const std::size_t n,
+    const std::size_t m,
+    const rct::keyV &messages,
+    const std::size_t small_weighting_size)
+{
+    /// Global checks
+    const std::size_t N_proofs = proofs.size();
+
+    CHECK_AND_ASSERT_THROW_MES(N_proofs > 0, "Must have at least one proof to verify!");
+
+    CHECK_AND_ASSERT_THROW_MES(n > 1, "Must have n > 1!");
+    CHECK_AND_ASSERT_THROW_MES(m > 1, "Must have m > 1!");
+    CHECK_AND_ASSERT_THROW_MES(m*n <= GROOTLE_MAX_MN, "Size parameters are too large!");
+    CHECK_AND_ASSERT_THROW_MES(small_weighting_size >= 1 && small_weighting_size <= 32,
+        "Small weight variable size is invalid!");
+
+    // anonymity set size
+    const std::size_t N = std::pow(n, m);
+
+    // inputs line up with proofs
+    CHECK_AND_ASSERT_THROW_MES(M.size() == N_proofs, "Public key vector is wrong size!");
+    CHECK_AND_ASSERT_THROW_MES(proof_offsets.size() == N_proofs, "Commitment offsets don't match with input proofs!");
+    CHECK_AND_ASSERT_THROW_MES(messages.size() == N_proofs, "Incorrect number of messages!");
+
+
+    /// Per-proof checks
+    std::size_t max_rows{0};
+    std::size_t max_size{1};
+    for (std::size_t proof_i = 0; proof_i < N_proofs; ++proof_i)
+    {
+        CHECK_AND_ASSERT_THROW_MES(proofs[proof_i], "Proof unexpectedly doesn't exist!");
+        const AggregateConciseGrootleProof &proof = *(proofs[proof_i]);
+
+        // each input's ref set lines up with its commitment offsets
+        const std::size_t num_inputs = M[proof_i].size();
+        const std::size_t num_keys = proof_offsets[proof_i].cols();
+
+        CHECK_AND_ASSERT_THROW_MES(num_inputs > 0, "Proof has no inputs!");
+        CHECK_AND_ASSERT_THROW_MES(num_inputs*m*n <= GROOTLE_MAX_MN, "Too many inputs aggregated for this decomposition!");
+        CHECK_AND_ASSERT_THROW_MES(proof_offsets[proof_i].rows() == num_inputs,
+            "Commitment offsets don't match with proof inputs!");
+        for (const rct::KeyMatrix &input_M : M[proof_i])
+        {
+            CHECK_AND_ASSERT_THROW_MES(input_M.rows() == N, "Public key vector is wrong size!");
+            CHECK_AND_ASSERT_THROW_MES(input_M.cols() == num_keys, "Incorrect number of input keys!");
+        }
+
+        CHECK_AND_ASSERT_THROW_MES(proof.X.size() == m, "Bad proof vector size (X)!");
+        CHECK_AND_ASSERT_THROW_MES(proof.f.size() == num_inputs*m, "Bad proof matrix size (f)!");
+        for (const rct::keyV &f_row : proof.f)
+        {
+            CHECK_AND_ASSERT_THROW_MES(f_row.size() == n - 1, "Bad proof matrix size (f internal)!");
+            for (const rct::key &f_element : f_row)
+            {
+                CHECK_AND_ASSERT_THROW_MES(sc_check(f_element.bytes) == 0, "Bad scalar element in proof (f internal)!");
+                CHECK_AND_ASSERT_THROW_MES(!(f_element == ZERO), "Proof matrix element should not be zero!");
+            }
+        }
+        CHECK_AND_ASSERT_THROW_MES(sc_check(proof.zA.bytes) == 0, "Bad scalar element in proof (zA)!");
+        CHECK_AND_ASSERT_THROW_MES(!(proof.zA == ZERO), "Proof scalar element should not be zero (zA)!");
+        CHECK_AND_ASSERT_THROW_MES(sc_check(proof.z.bytes) == 0, "Bad scalar element in proof (z)!");
+        CHECK_AND_ASSERT_THROW_MES(!(proof.z == ZERO), "Proof scalar element should not be zero (z)!");
+
+        max_rows = std::max(max_rows, num_inputs*m);
+        max_size += num_inputs*N*num_keys + 2 + num_inputs*num_keys + m;
+    }
+
+    // prepare context
+    const std::shared_ptr<rct::fixed_base_cached_data> gen_cache{get_generator_cache(max_rows*n)};
+    rct::key temp;  //common variable shuttle so only one needs to be allocated
+
+
+    /// setup 'data': for aggregate multi-exponentiation computation across all proofs
+
+    // generator scalars (evaluated separately with fixed-base tables):
+    // 0                                  G                             (zA*G, z*G)
+    // 1                  2*k*m*n         alternate(Hi_A[i], Hi_B[i])   {f, f*(xi - f)} (all inputs' rows)
+    //
+    // per-index storage:
+    // 0                                  sum of generator terms        (1)
+    //    <per-proof, start at 1>
+    // A, B
+    //    <per-input>
+    // 0                  N*num_keys-1    M_u[k][alpha]                 (f-coefficients)
+    // ... {C_offsets_u}
+    //    </per-input>
+    // {X}
+    rct::keyV gen_scalars(1 + 2*max_rows*n, ZERO);
+    std::vector<rct::MultiexpData> data;
+    data.reserve(max_size);
+    data.resize(1); // start with common/batched element (set at the end)
+    std::size_t skipped_offsets{0};
+
+    // scratch reused between proofs and inputs
+    rct::keyV batch_keys;
+    std::vector<ge_p3> proof8_points;
+    std::vector<ge_p3> ref_set_p3;
+    rct::KeyMatrix f{m, n};
+    rct::keyV f_prefix_temp;
+    rct::keyV t;
+    rct::keyV mu_pow;
+    rct::keyV minus_xi_pow;
+
+
+    /// per-proof data assembly
+    for (std::size_t proof_i = 0; proof_i < N_proofs; ++proof_i)
+    {
+        const AggregateConciseGrootleProof &proof = *(proofs[proof_i]);
+        const std::vector<rct::KeyMatrix> &proof_M = M[proof_i];
+        const rct::KeyMatrix &offsets = proof_offsets[proof_i];
+        const std::size_t num_inputs = proof_M.size();
+        const std::size_t num_keys = offsets.cols();
+
+        // random weights (see get_concise_grootle_verification_data_impl())
+        rct::key w1 = ZERO;  // decomp:        w1*[ A + xi*B == dual_matrix_commit(zA, f, f*(xi - f)) ]
+        rct::key w2 = ZERO;  // main stuff:    w2*[ ... - zG == 0 ]
+        while (w1 == ZERO || w2 == ZERO)
+        {
+            w1 = minus_small_scalar_gen(small_weighting_size);
+            w2 = small_scalar_gen(small_weighting_size);
+        }
+
+        // Transcript challenges
+        const rct::key mu{
+                compute_aggregate_base_aggregation_coefficient(messages[proof_i], proof_M, offsets, proof.A, proof.B)
+            };
+        const rct::key xi{compute_challenge(mu, proof.X)};
+
+        // Aggregation coefficient powers (chained across the inputs)
+        powers_of_scalar(mu, num_inputs*num_keys, false, mu_pow);
+
+        // Challenge powers (negated)
+        powers_of_scalar(xi, m, true, minus_xi_pow);
+
+        // Recover proof elements: A, B, {X}
+        batch_keys.clear();
+        batch_keys.push_back(proof.A);
+        batch_keys.push_back(proof.B);
+        batch_keys.insert(batch_keys.end(), proof.X.begin(), proof.X.end());
+        rct::scalarmult8_points(batch_keys, proof8_points);
+
+        const ge_p3 &A_p3 = proof8_points[0];
+        const ge_p3 &B_p3 = proof8_points[1];
+        const ge_p3 *X_p3 = proof8_points.data() + 2;
+
+        // G: w1*zA
+        sc_muladd(gen_scalars[0].bytes, w1.bytes, proof.zA.bytes, gen_scalars[0].bytes);
+
+        // A, B
+        // A: -w1    * A
+        // B: -w1*xi * B
+        sc_mul(temp.bytes, MINUS_ONE.bytes, w1.bytes);
+        data.emplace_back(temp, A_p3);  // -w1 * A
+
+        sc_mul(temp.bytes, temp.bytes, xi.bytes);
+        data.emplace_back(temp, B_p3);  // -w1*xi * B
+
+        for (std::size_t u = 0; u < num_inputs; ++u)
+        {
+            // Reconstruct input u's f-matrix, and its matrix commitment terms on rows u*m, ..., u*m + m - 1
+            for (std::size_t j = 0; j < m; ++j)
+            {
+                const std::size_t r = u*m + j;
+
+                // f[j][0] = xi - sum(f[j][i]) [from i = [1, n)]
+                f[j][0] = xi;
+                for (std::size_t i = 1; i < n; ++i)
+                {
+                    f[j][i] = proof.f[r][i - 1];
+                    sc_sub(f[j][0].bytes, f[j][0].bytes, f[j][i].bytes);
+                }
+                CHECK_AND_ASSERT_THROW_MES(!(f[j][0] == ZERO), "Proof matrix element should not be zero!");
+
+                rct::key Hi_temp;
+                for (std::size_t i = 0; i < n; ++i)
+                {
+                    // Hi_A: w1*f[j][i]
+                    sc_mul(Hi_temp.bytes, w1.bytes, f[j][i].bytes);
+                    sc_add(gen_scalars[1 + 2*(r*n + i)].bytes, gen_scalars[1 + 2*(r*n + i)].bytes, Hi_temp.bytes);
+
+                    // Hi_B: w1*f[j][i]*(xi - f[j][i]) -> w1*xi*f[j][i] - w1*f[j][i]*f[j][i]
+                    sc_mul(temp.bytes, xi.bytes, Hi_temp.bytes);
+                    sc_mul(Hi_temp.bytes, f[j][i].bytes, Hi_temp.bytes);
+                    sc_sub(temp.bytes, temp.bytes, Hi_temp.bytes);
+                    sc_add(gen_scalars[1 + 2*(r*n + i) + 1].bytes, gen_scalars[1 + 2*(r*n + i) + 1].bytes, temp.bytes);
+                }
+            }
+
+            // {{M_u}}
+            //   t_k = mul_all_j(f[j][decomp_k[j]])
+            // M_u[k][alpha]: w2*t_k*mu^(u*num_keys + alpha)
+            one_of_many_f_products(f, n, m, f_prefix_temp, t);
+            rct::decompress_points({proof_M[u].data(), proof_M[u].size()}, ref_set_p3);
+
+            rct::key sum_t = ZERO;
+            rct::key t_k;
+            for (std::size_t k = 0; k < N; ++k)
+            {
+                sc_add(sum_t.bytes, sum_t.bytes, t[k].bytes);  // sum_k( t_k )
+                sc_mul(t_k.bytes, w2.bytes, t[k].bytes);  // w2*t_k
+
+                for (std::size_t alpha = 0; alpha < num_keys; ++alpha)
+                {
+                    sc_mul(temp.bytes, t_k.bytes, mu_pow[u*num_keys + alpha].bytes);  // w2*t_k*mu^(u*num_keys + alpha)
+                    data.emplace_back(temp, ref_set_p3[k*num_keys + alpha]);
+                }
+            }
+
+            // {C_offsets_u}
+            // offsets[u][alpha]: -w2*sum_t*mu^(u*num_keys + alpha)
+            sc_mul(temp.bytes, MINUS_ONE.bytes, w2.bytes);
+            sc_mul(temp.bytes, temp.bytes, sum_t.bytes);  //-w2*sum_t
+            rct::key shuttle;
+
+            for (std::size_t alpha = 0; alpha < num_keys; ++alpha)
+            {
+                // optimization: skip if offset == identity
+                if (offsets[u][alpha] == rct::identity())
+                {
+                    ++skipped_offsets;
+                    continue;
+                }
+
+                sc_mul(shuttle.bytes, temp.bytes, mu_pow[u*num_keys + alpha].bytes);
+                data.emplace_back(shuttle, offsets[u][alpha]);
+            }
+        }
+
+        // {X}
+        //   w2*[ ... - sum_j( xi^j*X[j] ) - z G ] == 0
+        for (std::size_t j = 0; j < m; ++j)
+        {
+            // X[j]: -w2*xi^j
+            sc_mul(temp.bytes, w2.bytes, minus_xi_pow[j].bytes);
+            data.emplace_back(temp, X_p3[j]);
+        }
+
+        // G: -w2*z
+        sc_mul(temp.bytes, MINUS_ONE.bytes, proof.z.bytes);
+        sc_mul(temp.bytes, temp.bytes, w2.bytes);
+        sc_add(gen_scalars[0].bytes, gen_scalars[0].bytes, temp.bytes);
+    }
+
+
+    /// Generator terms: G, {Hi_A, Hi_B}
+    data[0] = {ONE, rct::fixed_base_multiexp_p3(gen_scalars, gen_cache)};
+
+
+    /// Final check
+    CHECK_AND_ASSERT_THROW_MES(data.size() == max_size - skipped_offsets, "Final proof data is incorrect size!");
+
+
+    /// return multiexp data for caller to deal with
+    return rct::pippenger_prep_data{std::move(data), nullptr, 0};
+}
+//-------------------------------------------------------------------------------------------------------------------
+bool aggregate_concise_grootle_verify(const std::vector<const AggregateConciseGrootleProof*> &proofs,
+    const std::vector<std::vector<rct::KeyMatrix>> &M,
+    const std::vector<rct::KeyMatrix> &proof_offsets,
+    const std::size_t n,
+    const std::size_t m,
+    const rct::keyV &messages,
+    const std::size_t small_weighting_size)
+{
+    // build and verify multiexp
+    if (!check_pippenger_data(get_aggregate_concise_grootle_verification_data(proofs,
+            M,
+            proof_offsets,
+            n,
+            m,
+            messages,
+            small_weighting_size)))
+    {
+        MERROR("Aggregated concise Grootle proof: verification failed!");
+        return false;
+    }
+
+    return true;
+}
+//-------------------------------------------------------------------------------------------------------------------
+// Fixed-size proofs: same algorithms as above with the decomposition known at compile time
+// - matrices are arrays of rows, so the decomposition loops have constant bounds and get unrolled
+//-------------------------------------------------------------------------------------------------------------------
+template <std::size_t n, std::size_t m>
+using grootle_matrix_fixed = std::array<std::array<rct::key, n>, m>;
+//-------------------------------------------------------------------------------------------------------------------
+// C = x G + {M_A}->Hi_A + {M_B}->Hi_B (see grootle_matrix_commitment())
+//-------------------------------------------------------------------------------------------------------------------
+template <std::size_t n, std::size_t m>
+static void grootle_matrix_commitment_fixed(const rct::key &x,  //blinding factor
+    const grootle_matrix_fixed<n, m> &M_priv_A,  //matrix A
+    const grootle_matrix_fixed<n, m> &M_priv_B,  //matrix B
+    std::vector<rct::MultiexpData> &data_out)
+{
+    data_out.resize(1 + 2*m*n);
+
+    // mask: x G
+    data_out[0] = {x, G_p3};
+
+    // map M_A onto Hi_A, M_B onto Hi_B
+    for (std::size_t j = 0; j < m; ++j)
+    {
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            data_out[1 + j*n + i] = {M_priv_A[j][i], Hi_A_p3[j*n + i]};
+            data_out[1 + m*n + j*n + i] = {M_priv_B[j][i], Hi_B_p3[j*n + i]};
+        }
+    }
+}
+//-------------------------------------------------------------------------------------------------------------------
+// Little-endian base-n digits of 'val' (see decompose())
+//-------------------------------------------------------------------------------------------------------------------
+template <std::size_t n, std::size_t m>
+static void decompose_fixed(std::size_t val, std::array<std::size_t, m> &digits_out)
+{
+    for (std::size_t j = 0; j < m; ++j)
+    {
+        digits_out[j] = val % n;
+        val /= n;
+    }
+}
+//-------------------------------------------------------------------------------------------------------------------
+// Step to the digits of 'val + 1' (mixed-radix counter, cheaper than decomposing each index)
+//-------------------------------------------------------------------------------------------------------------------
+template <std::size_t n, std::size_t m>
+static void increment_decomposition_fixed(std::array<std::size_t, m> &digits_inout)
+{
+    for (std::size_t j = 0; j < m; ++j)
+    {
+        if (++digits_inout[j] < n)
+            return;
+        digits_inout[j] = 0;
+    }
+}
+//-------------------------------------------------------------------------------------------------------------------
+// t_k = prod_j( f[j][decomp_k[j]] ) for all k, sharing the products of k's high digits (see one_of_many_f_products())
+//-------------------------------------------------------------------------------------------------------------------
+template <std::size_t n, std::size_t m>
+static void one_of_many_f_products_fixed(const grootle_matrix_fixed<n, m> &f, rct::keyV &t_out)
+{
+    constexpr std::size_t N{grootle_ref_set_size(n, m)};
+    t_out.resize(N);
+
+    std::array<rct::key, m + 1> prefix;
+    std::array<std::size_t, m> decomp_k;
+    std::size_t first_stale{1};
+    prefix[0] = ONE;
+    decomp_k.fill(0);
+    for (std::size_t k = 0; k < N; ++k)
+    {
+        for (std::size_t t = first_stale; t <= m; ++t)
+            sc_mul(prefix[t].bytes, prefix[t - 1].bytes, f[m - t][decomp_k[m - t]].bytes);
+
+        t_out[k] = prefix[m];
+
+        std::size_t c{0};
+        while (c < m && decomp_k[c] == n - 1)
+            ++c;
+        first_stale = c < m ? m - c : 1;
+
+        increment_decomposition_fixed<n, m>(decomp_k);
+    }
+}
+//-------------------------------------------------------------------------------------------------------------------
+template <std::size_t n, std::size_t m>
+ConciseGrootleProofFixed<n, m> concise_grootle_prove(const rct::KeyMatrix &M, // [vec<tuple of commitments>]
+    const std::size_t l,        // secret index into {{M}}
+    const rct::keyV &C_offsets,  // offsets for commitment to zero at index l
+    const std::vector<crypto::secret_key> &privkeys,  // privkeys of commitments to zero in 'M[l] - C_offsets'
+    const rct::key &message)    // message to insert in Fiat-Shamir transform hash
+{
+    /// input checks and initialization
+    constexpr std::size_t N{grootle_ref_set_size(n, m)};
+
+    CHECK_AND_ASSERT_THROW_MES(M.rows() == N, "Ref set vector is wrong size!");
+
+    // number of parallel commitments to zero
+    const std::size_t num_keys = C_offsets.size();
+
+    CHECK_AND_ASSERT_THROW_MES(privkeys.size() == num_keys, "Private key vector is wrong size!");
+
+    CHECK_AND_ASSERT_THROW_MES(M.cols() == num_keys, "Commitment tuple is wrong size!");
+
+    // commitment to zero signing keys
+    CHECK_AND_ASSERT_THROW_MES(l < M.rows(), "Signing index out of bounds!");
+
+    for (std::size_t alpha = 0; alpha < num_keys; ++alpha)
+    {
+        // verify: commitment to zero C_zero = M - C_offset = k*G
+        rct::key C_zero_temp;
+        rct::subKeys(C_zero_temp, M[l][alpha], C_offsets[alpha]);
+        CHECK_AND_ASSERT_THROW_MES(rct::scalarmultBase(rct::sk2rct(privkeys[alpha])) == C_zero_temp, "Bad commitment key!");
+    }
+
+    // statically initialize Grootle proof generators
+    init_gens();
+
+
+    /// Concise Grootle proof
+    ConciseGrootleProofFixed<n, m> proof;
+
+
+    /// Decomposition sub-proof commitments: A, B
+    std::vector<rct::MultiexpData> data;
+
+    // Matrix masks
+    rct::key rA = rct::skGen();
+    rct::key rB = rct::skGen();
+
+    // A: commit to zero-sum values: {a, -a^2}
+    grootle_matrix_fixed<n, m> a;
+    grootle_matrix_fixed<n, m> a_sq;
+    for (std::size_t j = 0; j < m; ++j)
+    {
+        a[j][0] = ZERO;
+        for (std::size_t i = 1; i < n; ++i)
+        {
+            // a
+            a[j][i] = rct::skGen();
+            sc_sub(a[j][0].bytes, a[j][0].bytes, a[j][i].bytes);  //a[j][0] = - sum(a[1,..,n])
+
+            // -a^2
+            sc_mul(a_sq[j][i].bytes, a[j][i].bytes, a[j][i].bytes);
+            sc_mul(a_sq[j][i].bytes, MINUS_ONE.bytes, a_sq[j][i].bytes);
+        }
+
+        // -(a[j][0])^2
+        sc_mul(a_sq[j][0].bytes, a[j][0].bytes, a[j][0].bytes);
+        sc_mul(a_sq[j][0].bytes, MINUS_ONE.bytes, a_sq[j][0].bytes);
+    }
+    grootle_matrix_commitment_fixed<n, m>(rA, a, a_sq, data);  //A = dual_matrix_commit(r_A, a, -a^2)
+    proof.A = rct::multiexp_auto(data);
+    CHECK_AND_ASSERT_THROW_MES(!(proof.A == IDENTITY), "Linear combination unexpectedly returned zero!");
+
+    // B: commit to decomposition bits: {sigma, a*(1-2*sigma)}
+    std::array<std::size_t, m> decomp_l;
+    decompose_fixed<n, m>(l, decomp_l);
+
+    grootle_matrix_fixed<n, m> sigma;
+    grootle_matrix_fixed<n, m> a_sigma;
+    for (std::size_t j = 0; j < m; ++j)
+    {
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            // sigma
+            sigma[j][i] = kronecker_delta(decomp_l[j], i);
+
+            // a*(1-2*sigma)
+            sc_mulsub(a_sigma[j][i].bytes, TWO.bytes, sigma[j][i].bytes, ONE.bytes);  //1-2*sigma
+            sc_mul(a_sigma[j][i].bytes, a_sigma[j][i].bytes, a[j][i].bytes);  //a*(1-2*sigma)
+        }
+    }
+    grootle_matrix_commitment_fixed<n, m>(rB, sigma, a_sigma, data);  //B = dual_matrix_commit(r_B, sigma, a*(1-2*sigma))
+    proof.B = rct::multiexp_auto(data);
+    CHECK_AND_ASSERT_THROW_MES(!(proof.B == IDENTITY), "Linear combination unexpectedly returned zero!");
+
+    // done: store (1/8)*commitment
+    proof.A = rct::scalarmultKey(proof.A, rct::INV_EIGHT);
+    proof.B = rct::scalarmultKey(proof.B, rct::INV_EIGHT);
+
+
+    /// one-of-many sub-proof: polynomial 'p' coefficients
+    // - p[k] = prod_j( a[j][decomp_k[j]] + delta(decomp_l[j], decomp_k[j])*x ) (see one_of_many_coefficients())
+    // - partial[t] is the product of the factors for digits m-1, ..., m-t of k, shared by all k with those digits
+    std::vector<std::array<rct::key, m + 1>> p(N);
+    std::array<std::array<rct::key, m + 1>, m + 1> partial;
+    std::array<std::size_t, m> decomp_k;
+    std::size_t first_stale{1};
+    rct::key delta_temp;
+    partial[0][0] = rct::identity();
+    decomp_k.fill(0);
+    for (std::size_t k = 0; k < N; ++k)
+    {
+        for (std::size_t t = first_stale; t <= m; ++t)
+        {
+            const std::size_t j{m - t};
+            delta_temp = kronecker_delta(decomp_l[j], decomp_k[j]);
+
+            sc_mul(partial[t][t].bytes, partial[t - 1][t - 1].bytes, delta_temp.bytes);
+            for (std::size_t i = t - 1; i > 0; --i)
+            {
+                sc_mul(partial[t][i].bytes, partial[t - 1][i].bytes, a[j][decomp_k[j]].bytes);
+                sc_muladd(partial[t][i].bytes, partial[t - 1][i - 1].bytes, delta_temp.bytes, partial[t][i].bytes);
+            }
+            sc_mul(partial[t][0].bytes, partial[t - 1][0].bytes, a[j][decomp_k[j]].bytes);
+        }
+
+        p[k] = partial[m];
+
+        // the highest digit that changes on increment is the lowest one that isn't n-1
+        std::size_t c{0};
+        while (c < m && decomp_k[c] == n - 1)
+            ++c;
+        first_stale = c < m ? m - c : 1;
+
+        increment_decomposition_fixed<n, m>(decomp_k);
+    }
+
+
+    /// one-of-many sub-proof initial values: {rho}, mu, {X}
+
+    // {rho}: proof entropy
+    std::array<rct::key, m> rho;
+    for (std::size_t j = 0; j < m; ++j)
+    {
+        rho[j] = rct::skGen();
+    }
+
+    // mu: base aggregation coefficient
+    const rct::key mu{
+            compute_base_aggregation_coefficient(message, M, epee::to_span(C_offsets), proof.A, proof.B)
+        };
+
+    // mu^alpha: powers of the aggregation coefficient
+    const rct::keyV mu_pow = powers_of_scalar(mu, num_keys);
+
+    // C_zero_nominal[k][alpha] = M[k][alpha] - C_offset[alpha] (the same for every X[j])
+    std::vector<ge_p3> C_zero_nominal_p3(N*num_keys);
+    for (std::size_t k = 0; k < N; ++k)
+    {
+        for (std::size_t alpha = 0; alpha < num_keys; ++alpha)
+            sp::sub_keys_p3(M[k][alpha], C_offsets[alpha], C_zero_nominal_p3[k*num_keys + alpha]);
+    }
+
+    // {X}: 'encodings' of [p] (i.e. of the real signing index 'l' in the referenced tuple set)
+    std::vector<rct::MultiexpData> data_X(N*num_keys);
+    for (std::size_t j = 0; j < m; ++j)
+    {
+        for (std::size_t k = 0; k < N; ++k)
+        {
+            // X[j] += p[k][j] * sum_{alpha}( mu^alpha * (M[k][alpha] - C_offset[alpha]) )
+            for (std::size_t alpha = 0; alpha < num_keys; ++alpha)
+            {
+                rct::MultiexpData &X_element = data_X[k*num_keys + alpha];
+                sc_mul(X_element.scalar.bytes, mu_pow[alpha].bytes, p[k][j].bytes);  // p[k][j] * mu^alpha
+                X_element.point = C_zero_nominal_p3[k*num_keys + alpha];
+            }
+        }
+
+        // X[j] += rho[j]*G
+        // note: addKeys1(X, rho, P) -> X = rho*G + P
+        rct::addKeys1(proof.X[j], rho[j], rct::multiexp_auto(data_X));
+        CHECK_AND_ASSERT_THROW_MES(!(proof.X[j] == IDENTITY), "Proof coefficient element should not be zero!");
+
+        // done: store (1/8)*X
+        rct::scalarmultKey(proof.X[j], proof.X[j], rct::INV_EIGHT);
+    }
+
+
+    /// one-of-many sub-proof challenges
+
+    // xi: challenge
+    const rct::key xi{compute_challenge(mu, proof.X.data(), m)};
+
+    // xi^j: challenge powers
+    std::array<rct::key, m + 1> xi_pow;
+    xi_pow[0] = ONE;
+    for (std::size_t j = 1; j <= m; ++j)
+    {
+        sc_mul(xi_pow[j].bytes, xi_pow[j - 1].bytes, xi.bytes);
+    }
+
+
+    /// concise grootle proof final components/responses
+
+    // f-matrix: encapsulate index 'l'
+    for (std::size_t j = 0; j < m; ++j)
+    {
+        for (std::size_t i = 1; i < n; ++i)
+        {
+            sc_muladd(proof.f[j][i - 1].bytes, sigma[j][i].bytes, xi.bytes, a[j][i].bytes);
+            CHECK_AND_ASSERT_THROW_MES(!(proof.f[j][i - 1] == ZERO), "Proof matrix element should not be zero!");
+        }
+    }
+
+    // z-terms: responses
+    // zA = rB*xi + rA
+    sc_muladd(proof.zA.bytes, rB.bytes, xi.bytes, rA.bytes);
+    CHECK_AND_ASSERT_THROW_MES(!(proof.zA == ZERO), "Proof scalar element should not be zero!");
+
+    // z = (sum_{alpha}( mu^{alpha}*privkey[alpha] ))*xi^m -
+    //     rho[0]*xi^0 - ... - rho[m - 1]*xi^(m - 1)
+    proof.z = ZERO;
+    for (std::size_t alpha = 0; alpha < num_keys; ++alpha)
+    {
+        sc_muladd(proof.z.bytes, mu_pow[alpha].bytes, &(privkeys[alpha]), proof.z.bytes);  //z += mu^alpha*privkey[alpha]
+    }
+    sc_mul(proof.z.bytes, proof.z.bytes, xi_pow[m].bytes);  //z *= xi^m
+
+    for (std::size_t j = 0; j < m; ++j)
+    {
+        sc_mulsub(proof.z.bytes, rho[j].bytes, xi_pow[j].bytes, proof.z.bytes);  //z -= rho[j]*xi^j
+    }
+    CHECK_AND_ASSERT_THROW_MES(!(proof.z == ZERO), "Proof scalar element should not be zero!");
+
+
+    /// cleanup: clear secret prover data
+    memwipe(&rA, sizeof(rct::key));
+    memwipe(&rB, sizeof(rct::key));
+    memwipe(a.data(), sizeof(a));
+    memwipe(rho.data(), sizeof(rho));
+
+    return proof;
+}
+//-------------------------------------------------------------------------------------------------------------------
+template <std::size_t n, std::size_t m>
+rct::pippenger_prep_data get_concise_grootle_verification_data(
+    const std::vector<const ConciseGrootleProofFixed<n, m>*> &proofs,
+    const std::vector<rct::KeyMatrix> &M,
+    const rct::KeyMatrix &proof_offsets,
+    const rct::keyV &messages)
+{
+    /// Global checks
+    const std::size_t N_proofs = proofs.size();
+
+    CHECK_AND_ASSERT_THROW_MES(N_proofs > 0, "Must have at least one proof to verify!");
+
+    // anonymity set size
+    constexpr std::size_t N{grootle_ref_set_size(n, m)};
+
+    CHECK_AND_ASSERT_THROW_MES(M.size() == N_proofs, "Public key vector is wrong size!");
+    for (const rct::KeyMatrix &proof_M : M)
+        CHECK_AND_ASSERT_THROW_MES(proof_M.rows() == N, "Public key vector is wrong size!");
+
+    // inputs line up with proofs
+    CHECK_AND_ASSERT_THROW_MES(proof_offsets.rows() == N_proofs, "Commitment offsets don't match with input proofs!");
+    CHECK_AND_ASSERT_THROW_MES(messages.size() == N_proofs, "Incorrect number of messages!");
+
+    // commitment offsets must line up with input sets
+    const std::size_t num_keys = proof_offsets.cols();
+
+    for (const rct::KeyMatrix &proof_M : M)
+        CHECK_AND_ASSERT_THROW_MES(proof_M.cols() == num_keys, "Incorrect number of input keys!");
+
+
+    /// Per-proof checks (the proof layout fixes the vector/matrix sizes)
+    for (const ConciseGrootleProofFixed<n, m> *p: proofs)
+    {
+        CHECK_AND_ASSERT_THROW_MES(p, "Proof unexpectedly doesn't exist!");
+        const ConciseGrootleProofFixed<n, m> &proof = *p;
+
+        for (std::size_t j = 0; j < m; ++j)
+        {
+            for (std::size_t i = 0; i < n - 1; ++i)
+            {
+                CHECK_AND_ASSERT_THROW_MES(sc_check(proof.f[j][i].bytes) == 0, "Bad scalar element in proof (f internal)!");
+            }
+        }
+        CHECK_AND_ASSERT_THROW_MES(sc_check(proof.zA.bytes) == 0, "Bad scalar element in proof (zA)!");
+        CHECK_AND_ASSERT_THROW_MES(!(proof.zA == ZERO), "Proof scalar element should not be zero (zA)!");
+        CHECK_AND_ASSERT_THROW_MES(sc_check(proof.z.bytes) == 0, "Bad scalar element in proof (z)!");
+        CHECK_AND_ASSERT_THROW_MES(!(proof.z == ZERO), "Proof scalar element should not be zero (z)!");
+    }
+
+    // prepare context (temporaries from the scratch arena, as in get_concise_grootle_verification_data_impl())
+    const std::shared_ptr<rct::fixed_base_cached_data> gen_cache{get_generator_cache(m*n)};
+    SpScratchFrame scratch{sp_thread_scratch_arena()};
+    rct::key temp;  //common variable shuttle so only one needs to be allocated
+
+
+    /// setup 'data': for aggregate multi-exponentiation computation across all proofs
+    // - same layout as get_concise_grootle_verification_data_impl()
+    rct::keyV &gen_scalars = scratch.keys(1 + 2*m*n);
+    std::fill(gen_scalars.begin(), gen_scalars.end(), ZERO);
+    const std::size_t max_size{1 + N_proofs*(N*num_keys + 2 + num_keys + m)};
+    std::vector<rct::MultiexpData> data{rct::take_multiexp_data_buffer(max_size)};
+    data.resize(1); // start with common/batched element (set at the end)
+    std::size_t skipped_offsets{0};
+
+
+    /// per-proof data assembly
+    rct::keyV &mu_pow = scratch.keys(0);
+    rct::keyV &t = scratch.keys(0);
+    rct::keyV &batch_keys = scratch.keys(0);
+    std::vector<ge_p3> &ref_set_p3 = scratch.points();
+    std::vector<ge_p3> &proof8_points = scratch.points();
+
+    for (std::size_t proof_i = 0; proof_i < N_proofs; ++proof_i)
+    {
+        const ConciseGrootleProofFixed<n, m> &proof = *(proofs[proof_i]);
+        const rct::KeyMatrix &proof_M = M[proof_i];
+
+        // decompress the ref set in one batch (its keys are contiguous)
+        rct::decompress_points({proof_M.data(), proof_M.size()}, ref_set_p3);
+
+        // random weights
+        // - to allow verifiying batches of proofs, must weight each proof's components randomly so an adversary doesn't
+        //   gain an advantage if >1 of their proofs are being validated in a batch
+        // - w1 is a negated small scalar, so A's multiexp scalar (-w1) is small
+        rct::key w1 = ZERO;  // decomp:        w1*[ A + xi*B == dual_matrix_commit(zA, f, f*(xi - f)) ]
+        rct::key w2 = ZERO;  // main stuff:    w2*[ ... - zG == 0 ]
+        while (w1 == ZERO || w2 == ZERO)
+        {
+            w1 = minus_small_scalar_gen(DEFAULT_BATCH_WEIGHT_SIZE);
+            w2 = small_scalar_gen(DEFAULT_BATCH_WEIGHT_SIZE);
+        }
+
+        // Transcript challenges
+        const rct::key mu{
+                compute_base_aggregation_coefficient(messages[proof_i],
+                    proof_M,
+                    proof_offsets[proof_i],
+                    proof.A,
+                    proof.B)
+            };
+        const rct::key xi{compute_challenge(mu, proof.X.data(), m)};
+
+        // Aggregation coefficient powers
+        powers_of_scalar(mu, num_keys, false, mu_pow);
+
+        // Challenge powers (negated)
+        std::array<rct::key, m> minus_xi_pow;
+        minus_xi_pow[0] = MINUS_ONE;
+        for (std::size_t j = 1; j < m; ++j)
+        {
+            sc_mul(minus_xi_pow[j].bytes, minus_xi_pow[j - 1].bytes, xi.bytes);
+        }
+
+        // Recover proof elements: A, B, {X}
+        batch_keys.clear();
+        batch_keys.push_back(proof.A);
+        batch_keys.push_back(proof.B);
+        batch_keys.insert(batch_keys.end(), proof.X.begin(), proof.X.end());
+        rct::scalarmult8_points(batch_keys, proof8_points);
+
+        const ge_p3 &A_p3 = proof8_points[0];
+        const ge_p3 &B_p3 = proof8_points[1];
+        const ge_p3 *X_p3 = proof8_points.data() + 2;
+
+        // Reconstruct the f-matrix
+        grootle_matrix_fixed<n, m> f;
+        for (std::size_t j = 0; j < m; ++j)
+        {
+            // f[j][0] = xi - sum(f[j][i]) [from i = [1, n)]
+            f[j][0] = xi;
+
+            for (std::size_t i = 1; i < n; ++i)
+            {
+                // note: indexing between f-matrix and proof.f is off by 1 because
+                //       'f[j][0] = xi - sum(f_{j,i})' is only implied by the proof, not recorded in it
+                CHECK_AND_ASSERT_THROW_MES(!(proof.f[j][i - 1] == ZERO), "Proof matrix element should not be zero!");
+                f[j][i] = proof.f[j][i - 1];
+                sc_sub(f[j][0].bytes, f[j][0].bytes, f[j][i].bytes);
+            }
+            CHECK_AND_ASSERT_THROW_MES(!(f[j][0] == ZERO), "Proof matrix element should not be zero!");
+        }
+
+        // Matrix commitment
+        //   w1* [ A + xi*B == zA * G + ... f[j][i] * Hi_A[j][i] ... + ... f[j][i] * (xi - f[j][i]) * Hi_B[j][i] ... ]
+        // G: w1*zA
+        sc_muladd(gen_scalars[0].bytes, w1.bytes, proof.zA.bytes, gen_scalars[0].bytes);  // w1*zA
+
+        rct::key Hi_temp;
+        for (std::size_t j = 0; j < m; ++j)
+        {
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                // Hi_A: w1*f[j][i]
+                sc_mul(Hi_temp.bytes, w1.bytes, f[j][i].bytes);  // w1*f[j][i]
+                sc_add(gen_scalars[1 + 2*(j*n + i)].bytes, gen_scalars[1 + 2*(j*n + i)].bytes, Hi_temp.bytes);
+
+                // Hi_B: w1*f[j][i]*(xi - f[j][i]) -> w1*xi*f[j][i] - w1*f[j][i]*f[j][i]
+                sc_mul(temp.bytes, xi.bytes, Hi_temp.bytes);  //w1*xi*f[j][i]
+                sc_mul(Hi_temp.bytes, f[j][i].bytes, Hi_temp.bytes);  //w1*f[j][i]*f[j][i]
+                sc_sub(temp.bytes, temp.bytes, Hi_temp.bytes);  //[] - []
+                sc_add(gen_scalars[1 + 2*(j*n + i) + 1].bytes, gen_scalars[1 + 2*(j*n + i) + 1].bytes, temp.bytes);
+            }
+        }
+
+        // A, B
+        // A: -w1    * A
+        // B: -w1*xi * B
+        sc_mul(temp.bytes, MINUS_ONE.bytes, w1.bytes);
+        data.emplace_back(temp, A_p3);  // -w1 * A
+
+        sc_mul(temp.bytes, temp.bytes, xi.bytes);
+        data.emplace_back(temp, B_p3);  // -w1*xi * B
+
+        // {{M}}
+        //   t_k = mul_all_j(f[j][decomp_k[j]])
+        // M[k][alpha]: w2*t_k*mu^alpha
+        rct::key sum_t = ZERO;
+        rct::key t_k;
+        one_of_many_f_products_fixed<n, m>(f, t);  // t_k = mul_all_j(f[j][decomp_k[j]])
+        for (std::size_t k = 0; k < N; ++k)
+        {
+            sc_add(sum_t.bytes, sum_t.bytes, t[k].bytes);  // sum_k( t_k )
+
+            sc_mul(t_k.bytes, w2.bytes, t[k].bytes);  // w2*t_k
+
+            for (std::size_t alpha = 0; alpha < num_keys; ++alpha)
+            {
+                sc_mul(temp.bytes, t_k.bytes, mu_pow[alpha].bytes);  // w2*t_k*mu^alpha
+                data.emplace_back(temp, ref_set_p3[k*num_keys + alpha]);
+            }
+        }
+
+        // {C_offsets}
+        // proof_offsets[proof_i][alpha]: -w2*sum_t*mu^alpha
+        sc_mul(temp.bytes, MINUS_ONE.bytes, w2.bytes);
+        sc_mul(temp.bytes, temp.bytes, sum_t.bytes);  //-w2*sum_t
+        rct::key shuttle;
+
+        for (std::size_t alpha = 0; alpha < num_keys; ++alpha)
+        {
+            // optimization: skip if offset == identity
+            if (proof_offsets[proof_i][alpha] == rct::identity())
+            {
+                ++skipped_offsets;
+                continue;
+            }
+
+            sc_mul(shuttle.bytes, temp.bytes, mu_pow[alpha].bytes);  //-w2*sum_t*mu^alpha
+            data.emplace_back(shuttle, proof_offsets[proof_i][alpha]);
+        }
+
+        // {X}
+        // X[j]: -w2*xi^j
+        for (std::size_t j = 0; j < m; ++j)
+        {
+            sc_mul(temp.bytes, w2.bytes, minus_xi_pow[j].bytes);
+            data.emplace_back(temp, X_p3[j]);
+        }
+
+        // G: -w2*z
+        sc_mul(temp.bytes, MINUS_ONE.bytes, proof.z.bytes);
+        sc_mul(temp.bytes, temp.bytes, w2.bytes);
+        sc_add(gen_scalars[0].bytes, gen_scalars[0].bytes, temp.bytes);
+    }
+
+
+    /// Generator terms: G, {Hi_A, Hi_B}
+    data[0] = {ONE, rct::fixed_base_multiexp_p3(gen_scalars, gen_cache)};
+
+
+    /// Final check
+    CHECK_AND_ASSERT_THROW_MES(data.size() == max_size - skipped_offsets, "Final proof data is incorrect size!");
+
+
+    /// return multiexp data for caller to deal with
+    return rct::pippenger_prep_data{std::move(data), nullptr, 0};
+}
+//-------------------------------------------------------------------------------------------------------------------
+template <std::size_t n, std::size_t m>
+bool concise_grootle_verify(const std::vector<const ConciseGrootleProofFixed<n, m>*> &proofs,
+    const std::vector<rct::KeyMatrix> &M,
+    const rct::KeyMatrix &proof_offsets,
+    const rct::keyV &messages)
+{
+    // build and verify multiexp
+    if (!check_pippenger_data(get_concise_grootle_verification_data<n, m>(proofs, M, proof_offsets, messages)))
+    {
+        MERROR("Concise Grootle proof: verification failed!");
+        return false;
+    }
+
+    return true;
+}
+//-------------------------------------------------------------------------------------------------------------------
+// Fixed-size proof instantiations: 2^7, 3^5, 8^3
+//-------------------------------------------------------------------------------------------------------------------
+#define INSTANTIATE_CONCISE_GROOTLE_FIXED(n, m)                                                                       \
+    template ConciseGrootleProofFixed<n, m> concise_grootle_prove<n, m>(const rct::KeyMatrix&,                        \
+        const std::size_t,                                                                                            \
+        const rct::keyV&,                                                                                             \
+        const std::vector<crypto::secret_key>&,                                                                       \
+        const rct::key&);                                                                                             \
+    template rct::pippenger_prep_data get_concise_grootle_verification_data<n, m>(                                    \
+        const std::vector<const ConciseGrootleProofFixed<n, m>*>&,                                                    \
+        const std::vector<rct::KeyMatrix>&,                                                                           \
+        const rct::KeyMatrix&,                                                                                        \
+        const rct::keyV&);                                                                                            \
+    template bool concise_grootle_verify<n, m>(const std::vector<const ConciseGrootleProofFixed<n, m>*>&,             \
+        const std::vector<rct::KeyMatrix>&,                                                                           \
+        const rct::KeyMatrix&,                                                                                        \
+        const rct::keyV&);
+
+INSTANTIATE_CONCISE_GROOTLE_FIXED(2, 7)
+INSTANTIATE_CONCISE_GROOTLE_FIXED(3, 5)
+INSTANTIATE_CONCISE_GROOTLE_FIXED(8, 3)
+
+#undef INSTANTIATE_CONCISE_GROOTLE_FIXED
+//-------------------------------------------------------------------------------------------------------------------
 } //namespace sp
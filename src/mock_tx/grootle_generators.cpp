@@ -0,0 +1,86 @@
+// Copyright (c) 2021, The Monero Project
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of
+//    conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list
+//    of conditions and the following disclaimer in the documentation and/or other
+//    materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be
+//    used to endorse or promote products derived from this software without specific
+//    prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+// THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// NOT FOR PRODUCTION
+
+//paired header
+#include "grootle_generators.h"
+
+//local headers
+#include "common/varint.h"
+#include "crypto/crypto.h"
+extern "C"
+{
+#include "crypto/crypto-ops.h"
+}
+#include "misc_log_ex.h"
+#include "ringct/rctOps.h"
+
+//third party headers
+
+//standard headers
+#include <string>
+
+#undef MONERO_DEFAULT_LOG_CATEGORY
+#define MONERO_DEFAULT_LOG_CATEGORY "grootle"
+
+namespace sp
+{
+
+/// File-scope data
+
+// config (todo: move to config file)
+const char HASH_KEY_GROOTLE_Hi_A[] = "grootle Hi A";
+const char HASH_KEY_GROOTLE_Hi_B[] = "grootle Hi B";
+
+
+//-------------------------------------------------------------------------------------------------------------------
+// H_i = keccak_to_pt(salt || varint(i))
+//-------------------------------------------------------------------------------------------------------------------
+static void make_grootle_gen(const char *salt, const std::size_t index, ge_p3 &gen_out)
+{
+    std::string hash{salt};
+    hash += tools::get_varint_data(index);
+    hash_to_p3(gen_out, rct::hash2rct(crypto::cn_fast_hash(hash.data(), hash.size())));
+}
+//-------------------------------------------------------------------------------------------------------------------
+void make_grootle_Hi_A_p3(const std::size_t index, ge_p3 &gen_out)
+{
+    CHECK_AND_ASSERT_THROW_MES(index < GROOTLE_MAX_MN, "Grootle generator index out of range!");
+
+    make_grootle_gen(HASH_KEY_GROOTLE_Hi_A, index, gen_out);
+}
+//-------------------------------------------------------------------------------------------------------------------
+void make_grootle_Hi_B_p3(const std::size_t index, ge_p3 &gen_out)
+{
+    CHECK_AND_ASSERT_THROW_MES(index < GROOTLE_MAX_MN, "Grootle generator index out of range!");
+
+    make_grootle_gen(HASH_KEY_GROOTLE_Hi_B, index, gen_out);
+}
+//-------------------------------------------------------------------------------------------------------------------
+} //namespace sp
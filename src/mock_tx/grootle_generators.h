@@ -0,0 +1,70 @@
+// Copyright (c) 2021, The Monero Project
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of
+//    conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list
+//    of conditions and the following disclaimer in the documentation and/or other
+//    materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be
+//    used to endorse or promote products derived from this software without specific
+//    prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+// THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// NOT FOR PRODUCTION
+
+// Precomputed Grootle generators
+// - Hi_A[i] = keccak_to_pt(H("grootle Hi A" || varint(i)))
+// - Hi_B[i] = keccak_to_pt(H("grootle Hi B" || varint(i)))
+// - the data table is generated offline by 'make_grootle_generators_data' (see 'make_grootle_generators_data.cpp')
+
+
+#pragma once
+
+//local headers
+extern "C"
+{
+#include "crypto/crypto-ops.h"
+}
+#include "grootle.h"
+
+//third party headers
+
+//standard headers
+
+//forward declarations
+
+
+namespace sp
+{
+
+/// baked generators (generated: see 'grootle_generators_data.cpp')
+extern const ge_p3 grootle_Hi_A_p3[GROOTLE_MAX_MN];
+extern const ge_p3 grootle_Hi_B_p3[GROOTLE_MAX_MN];
+
+/**
+* brief: make_grootle_Hi_A_p3 - derive Hi_A generator from its hash-to-point definition
+* brief: make_grootle_Hi_B_p3 - derive Hi_B generator from its hash-to-point definition
+*   - used to build (and test) the baked tables; hot paths should use the tables directly
+* param: index - generator index
+* outparam: gen_out - generator
+*/
+void make_grootle_Hi_A_p3(const std::size_t index, ge_p3 &gen_out);
+void make_grootle_Hi_B_p3(const std::size_t index, ge_p3 &gen_out);
+
+} //namespace sp
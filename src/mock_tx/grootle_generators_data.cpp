@@ -0,0 +1,1594 @@
+// Copyright (c) 2021, The Monero Project
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of
+//    conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list
+//    of conditions and the following disclaimer in the documentation and/or other
+//    materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be
+//    used to endorse or promote products derived from this software without specific
+//    prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+// THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// NOT FOR PRODUCTION
+
+// GENERATED FILE - DO NOT EDIT
+// - produced by 'make_grootle_generators_data' (see 'make_grootle_generators_data.cpp')
+
+//paired header
+#include "grootle_generators.h"
+
+//local headers
+extern "C"
+{
+#include "crypto/crypto-ops.h"
+}
+#include "grootle.h"
+
+//third party headers
+
+//standard headers
+
+
+namespace sp
+{
+
+const ge_p3 grootle_Hi_A_p3[GROOTLE_MAX_MN] = {
+    {
+        {-15928283, -13174045, 14167020, 10567761, -26274358, -8233615, 21664193, 10012949, 32045870, 7941148},
+        {-5613387, -3019432, -27978197, 14102983, 29059132, 11773101, 13219270, 1014005, 15334426, 715724},
+        {20636290, 11498142, 8448551, -14681313, -14583647, 3375667, -23347830, -9540744, 15189417, 7610254},
+        {-29528874, -13044345, -3409134, -5408817, 27171526, 5686407, 17315625, 1306257, 17747557, -1683582}
+    },
+    {
+        {28643962, -2703068, 30405206, -7257121, -18709882, -9732255, -3510341, 989647, -20129803, -16110067},
+        {-13017112, 4205148, 186083, 10112151, -3647872, -13295109, 4685089, -1337050, -20884097, 2436548},
+        {24630278, 15705963, -27405307, 11440848, -2835261, 3416346, 18142549, 3755047, -18763267, -7825652},
+        {-12810652, 13234587, -8878290, 42671, -25724712, 4723997, -31651037, 9346066, -4058922, -2069215}
+    },
+    {
+        {-7362979, -12320179, 14685670, -16269106, -30241370, -8114687, 3866941, -14152910, -6023984, 11618188},
+        {-9654084, -3672622, 23702238, 6298975, -25613949, -12267497, 21931252, 737771, 1621454, 3923102},
+        {-1210022, -9437010, 2899975, -4511091, -424354, -6974048, -18580702, -1550341, 21049209, 12060503},
+        {-27762638, 9032447, -14241540, 7194232, 5720415, -3634701, -17830899, 3588101, -5327747, 16743951}
+    },
+    {
+        {5690586, 1913219, 3205068, -6674343, -29088656, 1647253, -1795578, -742470, -31981124, 7586943},
+        {29477185, -8188538, -10520237, -3429495, -9833004, 5861570, -13378739, -5867878, 29403871, -9027597},
+        {-7073283, 14756591, -31011359, 13939526, 9336198, -9914589, 16730770, -16109292, 21022098, -3008259},
+        {18466382, -5829462, 28057574, 5518214, 10812965, -9189514, -2673178, -5096894, 7159666, -4849685}
+    },
+    {
+        {23584485, -7700625, 25314934, 10543009, -18815842, -8783526, 1226695, 1695923, 27216934, -3897853},
+        {-11078553, 15381989, 17939223, 15368951, 10466020, 8472318, 19405557, 10218069, -22495716, 16702363},
+        {3583470, 5156527, -22474051, -453075, 23944853, -2640469, -31649807, 14066409, 4327736, 9483880},
+        {10229549, 11597757, 6239976, 10599630, 12789816, -1650701, 23258840, 2184832, -32457657, -14081528}
+    },
+    {
+        {-28760639, 15041117, 22276592, -15694822, 30322308, -1437408, 28629819, -3931784, -7699428, 16620550},
+        {-18461644, 3800329, 27539746, 16298001, 5916772, 4423900, 2838183, 14058568, -5219190, 6596386},
+        {-32879959, 16467226, -29594160, 8047571, -17996801, 6702782, 25962738, -14225709, 24236641, 7236040},
+        {-22199478, -5395150, 3804952, -15460885, 22219934, -4792160, 17678799, 1055446, 27831305, -15221055}
+    },
+    {
+        {-17515271, 10649815, 15813411, 9567985, 20523187, 11502150, -28458916, 10544040, 15368550, 11661181},
+        {32941389, 13052871, -21257410, 5747575, 9727803, -13029359, 26993408, 10045504, 10599548, 15618447},
+        {-4508198, -13775350, 33035038, 15839016, -25841310, -10531839, -12222554, -9404864, 29994988, 12382339},
+        {7475697, 12129540, -11865009, -12615, 17965748, 15193866, 9511690, 1417326, -16135834, 14973853}
+    },
+    {
+        {9628379, -5749729, -26248742, 804682, -20646339, -3714340, -11678174, -1323667, 30655212, 3184364},
+        {26963134, 551181, 27210333, -16214732, 13565750, 13926127, 8340198, -3225761, 20751427, 5287671},
+        {26569924, 9317103, -8211345, -3051688, -25585926, 5899619, 13030386, 15975515, 11929195, -8065323},
+        {-2547086, -14233459, -27613454, 5782400, -10595159, -14519980, -13436, -211892, -25525359, -602025}
+    },
+    {
+        {27786613, -6397426, 31933926, 11048766, 3355977, -961555, 20226662, 12039936, 32670956, -3364753},
+        {13218035, 8764022, 23214785, 14641265, 28497206, 2153408, 7732030, -7247134, -26503557, 7095112},
+        {-30647570, -7105076, 32115597, -13982265, -33280752, 3629040, -2161999, -2891608, -14882069, -3638436},
+        {5557120, -4459130, 29530460, -16757273, 21438808, 5545209, 18734255, -1953039, 30589362, -9202745}
+    },
+    {
+        {410236, 7911126, -14183010, 12381829, -27733464, 7395594, -10454988, -8323927, 20687965, -10694534},
+        {19741776, -8267117, 13524440, -2623524, -28959972, 10274781, -28110910, 6665990, -22029118, -2903829},
+        {-17122942, -8869995, -5251864, -14618398, 32777141, -15270534, -24675951, 14280941, -18242244, -11098865},
+        {-7794115, -14040322, -15802053, -7203074, 8958134, -14344550, -18500124, 11951070, 5551330, -11931857}
+    },
+    {
+        {13938826, 4048778, 11714043, 4153439, -5244807, -7132266, 8725586, 5638604, -18918602, -13430499},
+        {8838702, -10043581, 16104014, 8681590, -10709610, -8435750, -791026, -10579806, -14931218, -14737927},
+        {20691202, 15689842, -21934933, -7762744, 18909601, 5855769, -29277757, 15453080, 13392908, 6530077},
+        {-13585238, 13013230, 13579281, 14415348, -22158571, 9581403, -5380819, -1456320, 25413864, 3294188}
+    },
+    {
+        {-8685023, -11092932, -13350484, 7083330, 19218626, -12642252, -1397544, 14451974, 26720768, -13179855},
+        {4169388, 9770128, -9741133, 5729701, 8840442, 12926870, -3093461, -2349956, -13117837, 5377713},
+        {-28185170, -977846, 13355668, 11666094, -20606350, -13077233, -28332368, 6307195, -21220618, 10351969},
+        {-14353027, 10364832, 18995973, 10038412, 11637351, 15887511, -18445907, 5723623, 5946114, 1981319}
+    },
+    {
+        {8507464, -2318656, 25983341, 12969957, -1735944, 2980579, -8951424, -9375654, -22242939, -4600549},
+        {-30988802, -9382691, -27266777, 16689267, -24393171, 12055410, -11789082, -4066976, -2701184, 11760939},
+        {-641933, -15125829, -23413148, 280076, -10851312, 11103317, 33467237, 6268039, 32231536, 8490986},
+        {33462759, 8083962, 31500781, -15104972, 27126620, -6691160, -30631154, -6810314, -4597576, 11682274}
+    },
+    {
+        {17831618, -1724077, 27958836, 12993720, -7573730, -11464140, -29770862, 5022376, -19586748, -12503985},
+        {-12126061, -8644810, -27161039, -14934674, 24667312, -15506635, -13203719, -1198164, -5581614, -2801166},
+        {17873770, -14712609, -7287418, 16698505, -28505215, 7962469, -11215724, 15088160, 22059038, -11655649},
+        {-23979743, 12537480, -29543540, 3624333, 16203555, -2192118, 19996818, 12496292, 30059702, -5998398}
+    },
+    {
+        {-18042676, 2054096, 17008750, 7197921, -24539800, -2151114, 5717108, -12783763, -16665280, -14380863},
+        {23847351, -1274114, 28787767, 2151111, 10955099, 7872166, -24258845, 9704458, 52247, 8428938},
+        {7485486, 6845475, -21147944, 6674494, -30639958, -13044653, 24431425, 8877292, -31128647, 2254609},
+        {24447735, 1524472, -24669001, -11985831, 14752446, -13094622, 25012382, 13128600, 28684799, 12496730}
+    },
+    {
+        {174932, 5586116, 18362579, 11390034, 32710852, 9648885, 16171658, -12458498, -14951515, 11105270},
+        {-3509971, 14906748, 14432107, -16465398, 18308444, 6752567, -12524919, -16214947, -29543069, -7190043},
+        {29441419, -5999645, 19203087, 12505992, -16186298, 11545012, -31871155, -4124963, -18730970, 8438655},
+        {-4753724, -13090166, -22699283, -14178697, 30322000, -2637658, -17342418, 9549152, -31927541, 7039312}
+    },
+    {
+        {-3005505, 11787367, 21402559, 3222504, 4022750, -11895937, 5497308, 12545420, -4165308, -5873696},
+        {-25276251, -716655, 3409210, 3446902, 1305245, -9048881, -8165813, -5220099, 14749236, 5190522},
+        {-3467384, 7396647, -16376114, -12091599, -5517090, 9986276, -18881301, -7557385, 31458485, -6050473},
+        {-14267708, -9121179, -1588472, -10566838, -13568563, -2001451, 19012256, -15148635, 14574669, 1436126}
+    },
+    {
+        {-7991810, -12597509, -28752922, -10617764, -18912872, 2856275, -24758758, 1475680, 488525, 9268366},
+        {-28599055, -16042552, 3658568, -16670132, 12006324, -16748049, 2191495, -5298631, 21482723, -16443003},
+        {-31624983, -4853193, -1059457, -13546382, 17297288, -12868320, 31118151, 3397087, 21073320, 8174880},
+        {7140856, 8407194, 11709767, -9239291, -29019702, -2398225, -4162397, -864261, -16623822, -10472374}
+    },
+    {
+        {-25554175, -3013015, 10352077, 9282821, -29910762, -6314424, 843048, 10981257, -15319060, -10120089},
+        {22490982, -9753174, 13054581, 6589421, -28988481, 10623624, 29301944, 8070166, -28483156, 797960},
+        {26226403, 740900, 23300433, 14928523, -27288706, -8708998, -16094944, 8785753, -27529436, 11074013},
+        {-8215861, -1850322, -17578746, -11113464, 333314, 6651597, 2439038, -8473546, -10110679, -10917329}
+    },
+    {
+        {17590429, -3850336, 6382426, -4242809, -8844441, 15780208, -239676, -2401400, -21418673, -4199997},
+        {-3094839, 3775567, -11788517, -6488225, -20863752, -8916579, 31774071, -15110157, 2719784, -10403427},
+        {13718933, 16324399, -699839, -1714261, 3053153, -3570871, -914544, 8333989, 7425954, -15250094},
+        {15863906, -8497949, 5580624, -16268434, -4104709, 11305962, 31794776, 15227239, -18945070, 180130}
+    },
+    {
+        {-31616907, 4053601, 10006451, -3444443, -24331186, 347432, -4519250, -13041647, 21438580, -15021567},
+        {-18555898, 7076731, -19949248, 9130085, 25915077, -15207428, 27440301, 13524511, 1339128, -14547267},
+        {-29958812, 15650225, 29612062, -12099708, -31275876, 187639, 18536619, -9768149, -19236674, 2559094},
+        {23766405, -608289, 23601731, 5267951, 16619632, -4381525, -4421730, -1231400, -5355691, -547766}
+    },
+    {
+        {-382727, 15137316, -26076011, 13910360, 31819825, 12045533, -26272082, -9458059, 8136912, 2113175},
+        {31195892, 394426, -13067296, -1102464, 19762079, -6836185, 19371142, -10768289, -20545942, 4175206},
+        {5400376, 15478909, 10018769, -7629735, -18960436, -15673642, 6097460, -3314279, -3397671, 11214658},
+        {-21186489, -11838869, -27072261, -15094252, -16902779, -10844107, 8466719, 2595346, -21457764, -212207}
+    },
+    {
+        {-7108384, -7120519, 23637545, -10652049, 14650879, 15514085, -7854686, 7956753, 3224835, -13014004},
+        {-26495240, 11932241, -12000956, -10739698, -2227206, 15560454, -25911386, 8841522, -14656424, -348581},
+        {-21614024, 2943967, 18431757, 6576582, 10420466, -13764161, 977220, 2733320, -30196044, 9801334},
+        {1016564, -395610, 14691676, 6489583, -6521526, 11728902, -14768726, -16118995, -25103143, -1075046}
+    },
+    {
+        {4350919, 2907750, 13509382, -13779431, 13481336, -6010150, 1128547, -9845460, -25874062, -5993114},
+        {5404955, -11895310, 5578611, 13493862, -29557483, 13333464, 6072642, 6262722, 1672194, -2802107},
+        {24131841, 8082852, 31451139, -6529604, 3564804, 9135737, 17757973, 211239, -11495634, -10962838},
+        {24639202, 11074985, -14056757, 11333604, -18628493, -16143975, -218072, 6141777, 1399590, 6624196}
+    },
+    {
+        {-10857476, 5554979, -10973553, -12570051, -32316029, -12213219, -30839520, -11879106, -2671278, -4157217},
+        {19242876, 15100021, -8443300, 9306216, -23672493, 1199661, -7046103, -5298880, 7295827, 13332946},
+        {28358471, -8519684, -15490785, -6099830, -14445558, -327790, -12791451, 16554518, -5522163, -11103087},
+        {13757409, 12267814, -15780916, -8658175, -12974618, 7034895, -9321584, -12672210, -9270385, -5124607}
+    },
+    {
+        {24422770, 1049426, -3627612, 14959481, 20637013, -6849811, 22444688, -11077750, 24380461, -4902849},
+        {-20114684, 6657496, 17401858, 15546392, 115130, 2154075, -6502851, 9730745, -9337326, 7235191},
+        {8489458, 14428890, 26448857, -3094228, -23569005, -4253757, -33033526, -13893002, -31442647, -12343014},
+        {10080644, 8583475, -12599976, -6338347, 3472260, -9998959, 22952221, 6435148, 11973092, 542259}
+    },
+    {
+        {10204772, -2581778, -5791815, -3383362, 24217930, -9882994, 12584825, -15245583, -23883238, -8652910},
+        {-3593650, 2535672, 1460128, 11316520, 30053505, -1517120, 4678387, 14168981, -9478128, 13443110},
+        {14375071, -13346423, -22114997, 11018951, 11605370, -13025376, -26059387, 5183651, 18516212, 98674},
+        {-19555203, -3037399, 29013411, 2332836, 13187081, 11801314, 14366827, -15247774, 10088008, -13248026}
+    },
+    {
+        {-4206434, 7648483, 23358815, 14137372, -11296122, -10892521, 28767777, 11162275, 31814984, 15641847},
+        {12925273, 6278793, 4435190, -2493046, 21069178, 16514348, 18376814, 6980894, -22242030, 2599735},
+        {23683661, -3356365, 13517728, -562720, -13054860, -11159374, -22086017, -7837689, -31486268, 5898744},
+        {19834684, -10825654, -29290215, -6041138, -15498445, 14560150, -24024741, 117615, 9977521, 13953587}
+    },
+    {
+        {-21053263, 16377705, -33270588, -9590092, 14403651, 8820900, 523478, -8873630, -12852937, 7967466},
+        {-17311189, 250251, -31931303, 10996662, -24324920, 5179763, -9944185, 3008010, -19144652, 3795771},
+        {31245920, 4364504, -15453563, -12554238, 1717621, 4471480, 13349369, -9489496, 11679559, -5980909},
+        {13627913, 10555835, -32838122, 3795890, 15243033, 581980, -496036, -178505, 9927305, 6791802}
+    },
+    {
+        {-8900249, 3223641, 21672681, -13774862, -17590886, 15337888, -24301214, -11021777, -23845855, 4841276},
+        {-7957494, 6138291, 5650559, -9852975, -21120661, 12225036, 20051216, -6189288, 29169934, 5363511},
+        {21507408, -1325266, -29837910, 10025064, -33090423, -13786379, 14048105, -12984105, -2915278, 16160725},
+        {23899129, 6298780, 24248587, 5179921, -30985395, 11146631, 13123192, -9037936, -721945, 12781855}
+    },
+    {
+        {-31745179, 5598567, 29138389, -4618036, 1269519, 8382276, -14297442, 4635868, -31125589, -5597386},
+        {28319866, 4096009, -14637398, -10152864, 32937596, 3550123, 9405694, 15383768, 15833791, -12884618},
+        {-13669028, -10007240, 22940670, 6215749, 10021512, 11972593, 29443374, 15472878, 33438744, 13115103},
+        {31969268, -5912013, 17371754, -2602892, -31769021, 16771592, -29978428, 2631759, -2362985, -6893422}
+    },
+    {
+        {-3283222, -13869256, 14961617, -11832643, -20518009, 1682017, 18360703, 6400382, -19915200, 15110044},
+        {29833170, -6814671, -6684621, -6054093, -5971606, 14610001, 7749288, -1561887, -16000365, -12048323},
+        {-5780094, 11803747, -695716, 1204627, -28829996, 16204627, 26481847, 10736596, -28385865, -8301363},
+        {-16312198, -1205954, -8495730, -10810577, -5056027, -2229685, -10101586, -9616894, -15742623, 2647522}
+    },
+    {
+        {-17833346, 11396456, 11636957, 9028756, -16244288, 11024279, 20183270, -9446458, 28647307, 14742277},
+        {1705019, -12702775, -28923705, -4253740, -15855138, 14419227, 32573792, -2446706, -4633799, -9563708},
+        {-20193414, -2828427, -32659851, -9573317, 9976962, 9138285, 23699690, 16356247, -24385016, -91895},
+        {-4779374, -11217167, -31231547, 3413297, -19256342, -15027719, -28688425, -11547002, 16785755, 1418344}
+    },
+    {
+        {-32603205, -8221802, -4868106, 11060698, 28515203, -16105793, 10026498, 2337633, 19659079, 12586364},
+        {-18572948, -4446176, 10614496, 6174914, 30353806, -12042579, 31541044, 10444957, 9866545, 900469},
+        {23698949, 3133476, -1239116, -9652451, 21157423, -16598230, -28495036, 1943740, -2668269, 5308175},
+        {-1130594, -5041029, 2878069, -1356961, 1599723, -519391, 5690135, -13895489, -10182334, 15722317}
+    },
+    {
+        {-18701014, 1668772, -20193501, 15079333, -24543772, 152334, -1748754, -9297266, -31704837, -15655062},
+        {-23743874, -8001150, 6632823, -2771833, 20816453, -15102637, 20454572, -11082189, -29453366, 12766846},
+        {2939541, -16636845, 30715205, 9403511, 25106392, -12706712, -16623808, 564032, 19166641, 15883925},
+        {19844378, -2859362, 28447021, -6454966, -10625851, 14850910, 27171925, -9155999, 623432, 897921}
+    },
+    {
+        {30760152, -7625178, -8636964, 372281, 25163240, -8340657, -17130169, 8697808, 1624123, 734187},
+        {-31925534, 16356905, 28712032, -6267956, -10917241, 15083332, -29468355, 7484590, 13073913, 14459701},
+        {1982426, 13199109, 12678626, -12291711, -4635007, 11904750, -8132904, -12353461, 18061323, 5885993},
+        {-26964175, 16432337, -5800811, -13962336, 23864241, 6462640, -23516602, -4499595, 525409, 14146148}
+    },
+    {
+        {-15823055, 15155160, 31534153, -11538756, 4877664, -2217506, -32315059, -14053752, -14761536, 10220074},
+        {-14437359, 15470835, 3603444, -13778714, -16684056, 14995260, 27752151, -11662402, -30240896, -5677773},
+        {-31641705, 4415644, -17782826, 13638028, 20516553, -1938024, -2729379, -5835533, -15515493, -12143877},
+        {9262880, -10208895, 10144698, 8057174, -24016111, 9765931, -28802309, -3217127, 6380320, -3356911}
+    },
+    {
+        {-10755728, 132447, 22604325, -9083101, -21382453, 4806054, -3025950, 13015682, 16712636, -14774296},
+        {-25597992, -12022701, -9831818, 7141985, -12047299, 5292121, 11749477, -4949886, 22849320, -6804225},
+        {29556849, -3983570, 30877846, -16638587, -31769907, -13797557, 7685829, 12019484, 653170, -7026193},
+        {-1292692, 16562463, 23833095, 1575550, 20303205, 9857948, 3277726, 11045083, 6319259, -15763339}
+    },
+    {
+        {3600089, -1486496, 15928087, -2896171, -24995243, -13325707, 15775781, 6650229, 27338215, 16628036},
+        {-8072665, 1436345, -18379019, -5679117, -5775159, -9949150, 8014147, 9040814, -7500813, -1853845},
+        {-7851858, 7505718, 17005774, 12492752, -30005853, 10564720, -13589698, -5288065, 30001036, 16713299},
+        {-10352785, 488525, 20531045, -5646490, 14660814, -14585288, -12849539, -2364562, -32979617, -11997378}
+    },
+    {
+        {-30614197, -3452559, 21037071, 4988049, 17063644, 13706527, 14703971, 1234264, 7888307, -9428002},
+        {-24741004, 8589202, -20603460, -10300311, -32361854, 13375345, 32138512, 13191336, 33363253, -14165334},
+        {26837894, 7810676, 27488679, -12256000, -817041, 15473043, -22765173, 3601968, 18397596, 7617089},
+        {-16988826, -9227288, 3519058, -5280379, -33462038, 11370021, 31166900, 853406, 22885028, 1508076}
+    },
+    {
+        {-14593421, 16702693, 32116183, -14290237, -28991005, -13682533, 27265667, -5444970, -12891606, -7726001},
+        {-1987966, 5223356, -15244049, -4057802, 28222370, -6012597, -4073170, 3376171, 8204163, 7261704},
+        {7289717, 318260, 1882264, 2403083, 19235645, 9543083, -7589667, 11, 8556557, 12608110},
+        {-13806932, -12474436, 5403140, -15869910, 17810764, 7525012, 26858104, -15306948, 3384715, -2544306}
+    },
+    {
+        {-29906233, 13147645, -1679016, -3477507, -8914111, -3051681, -16039651, -7079470, -2520191, 4379402},
+        {23797289, 4607014, -8632149, -4055149, -24730727, 2971841, 20082388, -13221764, -1098363, -15078080},
+        {-2183191, -14565801, -9715063, 12904849, -18407957, 11205188, 23308279, 569541, -27771218, 13772532},
+        {16715609, 14246879, -12437306, -3912941, -100441, 4187298, -21059078, -733533, 9291072, -16092103}
+    },
+    {
+        {12581792, 11954200, 26992959, -4455687, 26846316, -760472, 13760177, 400063, 27136295, 15146844},
+        {31103043, 13248475, -7855456, -1598354, -31064069, -3045503, 9589604, 4633415, -6916751, -15948853},
+        {9749897, 1024293, -15845896, 12792560, -18399990, -8283972, 27044301, 7835823, 9161155, -1912420},
+        {-8068503, -8185677, -24353266, 13055147, -32986725, -906657, 24034631, -9875310, 7572744, -1605784}
+    },
+    {
+        {-23476025, -6302228, 951938, 10425532, -6781245, -1115652, -8412732, -10368003, -20017339, -11982633},
+        {22888673, -5829944, 13466485, 1152173, 18367100, 7290929, -8541216, -14160124, -20184385, 14292235},
+        {-2017152, 4889139, -27518871, -601589, 14814466, -950462, 5741721, -11624325, -25748819, -5568030},
+        {-6128044, -173610, 1828090, -14709219, -15461157, 8337364, -5394328, 4299426, 1433386, -107694}
+    },
+    {
+        {27696821, 7098951, 23919284, 14258792, 17461275, 13357098, 12179199, -9748594, -16539769, 1079531},
+        {-22751989, 12248510, 22816288, -5866133, -27427744, -9955312, 523839, -7902807, 27284309, -9650324},
+        {-4029365, 1328496, -33180955, 9427232, 12814229, -4376315, 28252284, 7836490, 27047257, -6251353},
+        {-1758348, 832713, -16452075, -3452333, 3228231, -14413623, -21620230, -5362953, -6811778, 16054586}
+    },
+    {
+        {3913023, 12489500, 26843790, -8437773, 10497601, 11098396, -30450818, 15248662, -16700759, 13043602},
+        {-1388459, -14682889, -7627345, -14004006, -33288361, -14066447, -28489272, 8782428, 19688709, 5356744},
+        {18724898, -10989441, 26706621, -6278146, 17777778, -550554, -4669467, -196106, -15239074, -2701639},
+        {832856, -6191352, 19345521, 11616721, -19742274, -121871, 32212909, 2047045, -23006207, 7772900}
+    },
+    {
+        {2499856, -8631577, 24162977, -11007851, -2276854, -6309065, -14922584, -3002674, -14512179, -1867691},
+        {-33209627, -8667972, -22633005, 250540, -27204230, -16170689, -12603952, 571135, 1818882, -11340629},
+        {-8351900, 16521581, 19374710, -13270877, -5905750, 13386746, 26456500, -462995, -24550746, 6745406},
+        {-30064995, 14774554, -20352052, 11528861, 19450107, 8203905, -12667044, 13943890, 31218731, 14539882}
+    },
+    {
+        {-17225789, 10420042, -31165903, 1356390, -5366788, 8948894, 3576739, -8140082, 16650704, 12882340},
+        {-20896125, -325788, 6398937, 772573, -29793558, 12462833, -2374167, 10509522, -14486052, -2064913},
+        {16523882, 5992156, 21776715, -13237348, -30172049, -16333464, 14460049, -5577966, 25777770, -9416456},
+        {11354304, -16346748, 9240598, -6160088, 24824770, 429272, 6638480, 15303828, 6240120, -7688312}
+    },
+    {
+        {19871552, 12422337, 6537796, 9770068, -6363688, 8360042, -5059170, 5409076, 5053204, -1523905},
+        {25948385, 10307804, 3457602, -4583264, 8627128, -1705292, -8657993, 14921192, -16625999, 12248268},
+        {29806422, -5579591, -9833747, -12641183, 5956806, -8245279, 10293163, 14799270, -30748154, -10332061},
+        {-9951687, -12461708, -22693072, -1933119, 22996463, 600821, 22830113, -6588052, -28530517, -2484295}
+    },
+    {
+        {-13377291, 16197173, 8267134, 10388904, -20896351, 5916228, -17102464, 15844196, 1934236, -9825133},
+        {4771887, 12650957, -3973767, 2471268, 29207631, -5081516, -17069294, 3399752, -14152281, 3349255},
+        {30052187, 8573571, 25569131, 5217611, -23324642, -2719550, 1628180, -16384578, 4144045, 10253450},
+        {-17503027, -8967077, -19079452, 11678046, -13923574, -2117807, -22453729, 2622464, -17801849, 7061416}
+    },
+    {
+        {-5011652, -10783026, 9383555, 11127941, -11515896, -12428620, -7129180, 4151949, 13322760, 7583502},
+        {-31525568, -15950335, 6614107, 9942531, -4924052, 11832286, -23959981, 10472296, 32435112, 9290056},
+        {-7806721, -6575499, -32074738, 16294165, 11503466, 3407930, 28165251, 9775388, 29721097, -361091},
+        {-17879004, -6181589, 17598260, 9099057, -16948012, -13267221, -33164941, -3986384, -16284158, -2664969}
+    },
+    {
+        {-12343824, -13404567, -3681564, 12484861, -4669833, 6857354, 19970078, -15882843, -3384867, -7904558},
+        {-18082980, 13354897, -20252889, -438185, -20302338, -8204564, 21332770, -2554428, 31097702, 10951494},
+        {1690998, 12777782, 30222283, -10787413, -23188093, -1937310, -25409882, 15288413, -18397414, 2248253},
+        {15129493, -7300395, 32203253, 183513, -9346563, -4113558, -439033, -6394775, 16020018, -15933510}
+    },
+    {
+        {11786282, -9659918, 13741587, -10511698, -29280155, 3683245, -26100537, -4186132, 16500787, -139789},
+        {33151472, 5104549, -30091420, -10998333, -17083773, 15399427, -10854467, 4152961, 2008129, -6870234},
+        {9085119, -15962368, -15896245, -3666312, -30879232, -126894, -22707851, -7204095, 26576006, 13800120},
+        {-11941291, -9927845, 21282629, -7482539, -2824215, -15977313, 24195286, 2389856, -8208506, -14034416}
+    },
+    {
+        {-17387521, 5418096, -30623256, -6114463, 3410430, 6810688, 24664309, -10809727, -26042884, -2362979},
+        {8123441, -14816530, -4843871, -14542858, -1081981, -1363048, 32283404, 11682612, -2136854, 10640973},
+        {-14549769, 6289611, -13956265, -7203698, 31976906, -2459025, 15932356, 3316314, -4699195, 1100202},
+        {-26357921, -2547164, -5671471, -15477547, -16257336, -3283793, 31850509, -2327520, -21121061, 13465295}
+    },
+    {
+        {13514820, -2225497, -24302826, 2380741, 22208003, 16301593, 26932244, 6894563, -28991076, 9763726},
+        {-19558388, -2985912, -13799395, 7898794, -2971896, -8944613, -24364351, 4499752, 32497779, 3320293},
+        {-22149374, 9424536, -4327832, -11399507, 15665025, -7286525, 32321320, 8622577, 6137637, -2943163},
+        {16869765, 5767253, 20566016, -7661696, -18488626, -802018, -27204491, 7524644, 21683597, 1286141}
+    },
+    {
+        {-8714135, 3524510, 15870358, 7198961, -10591294, -11900913, 29247610, -13821246, -2688283, 7604693},
+        {308079, 11720057, -14895091, 3439523, 18638548, -14530108, -19069485, -10566571, 30264462, -10182963},
+        {-5410703, 7932296, 10818218, -7808087, -3289376, 10333330, 25638300, -9783409, -13995957, 12782794},
+        {17624703, 13270105, -32482355, 5826601, 30314175, -8667070, 968985, -15883992, -13555416, -16163816}
+    },
+    {
+        {3457803, -14073849, -13227278, 1626209, -14174876, 13093045, 31434522, -6301058, 6938875, 2518485},
+        {-9654982, 11184048, -22161873, 13431295, -27137302, 11133684, -117109, 9243680, 4341231, -3468362},
+        {32306139, -14111441, -6042533, 5389412, 25032100, 6133667, 21073886, -208707, 27898058, -6051043},
+        {18559037, -8317673, -2443783, -10955253, -26001880, -7000986, -20793037, 1768084, -32174020, -15799696}
+    },
+    {
+        {26110717, 7654217, -31904892, 7118758, -996894, 7180523, -28523008, -13400841, -3838834, 16193462},
+        {-33247954, 6295674, 7088085, 6073931, 16231337, 9882599, 21006175, -8949175, 12536096, -5336301},
+        {28734878, 12773842, 16500474, -4347899, 30600376, 3954312, -16579889, 3171790, -9555880, -11582765},
+        {12898355, -3338162, 26249436, 1747372, 11710723, 4259426, -11839538, -4258787, -3439982, -13242872}
+    },
+    {
+        {27025714, 13902294, 3225797, 6156759, -1560281, 3541190, -19230963, -14246227, -12986630, 8144766},
+        {19980180, 16000893, -13713943, -15477955, -26401659, 11695795, 3442071, -11119861, 16529593, -9229513},
+        {17904618, 9035793, 4386986, -10244828, -1613965, 8545562, -4158134, -2866044, -10126873, 14733367},
+        {27428055, 6407809, 7951295, 14145812, 1108835, 929689, 3946822, -10316242, 9707031, 14648634}
+    },
+    {
+        {-16862704, -16515674, -22480048, 13895353, 14563873, -15710578, 17885732, -15600918, 16283316, 1455388},
+        {-23407402, -9801561, 4014852, 4657558, -14414509, 1809128, -14305530, 1458253, -11546888, -7981324},
+        {18305846, -14016942, 5013739, 14663555, -12787391, 14277987, 27268011, -2966275, 4771006, 4274641},
+        {30686984, -2335711, -26812002, -8275594, 8496025, 4728267, 22339596, 1729998, -33153219, -1110804}
+    },
+    {
+        {28324713, 15797694, 2694786, -11612001, -25726439, 15263210, -10194572, -12381679, -7513905, 1007218},
+        {-2935518, 2136430, 20852055, 2162736, 28062810, -5225243, -11879913, -10138903, 8136472, 12231498},
+        {-21164580, 14109382, -15312201, 593321, 6570669, 8862514, 16855708, -14340733, 11348942, -6539833},
+        {2954036, -16200080, -12978472, -791464, 31364700, -16507375, -8295187, 4662922, 29907884, -11785669}
+    },
+    {
+        {30019635, -4139397, 4298843, -5377330, 7692072, -15717475, 28221887, -77699, 24121367, -11217522},
+        {8530085, 2142799, 27826641, 13473288, 1231416, -3285156, 20169918, 10417326, 10822388, -11720440},
+        {-7671699, -620548, 30430230, 7314918, 22250363, 13301953, -23532230, -3878990, 8508850, 4946851},
+        {-27910505, -181690, -17009193, 15191997, -12187910, -11939237, -5856345, -4494779, -3254129, -6078919}
+    },
+    {
+        {-2207099, 8958645, -5443336, -14739487, -10612676, 4707149, -19880136, -7980353, 28845405, -4684607},
+        {30476083, -8297582, 6515694, 917907, -7376862, -15525688, 4545477, 745511, -25080166, -6582391},
+        {-10239206, 1744832, -31291764, -14739373, -15527679, 15416137, -24556697, 4160448, -1685754, 5009046},
+        {-27546733, -4100607, -27797307, 6645429, -17481510, -1408344, 16590904, 6345700, -29292054, 1326057}
+    },
+    {
+        {5016012, 9474783, 6844602, 9818552, 4803825, 14590063, 23845003, 2568300, 26078268, 1377213},
+        {8636603, -10950239, 7762672, 12981738, -31569248, -8477761, -12481093, 5020022, -842105, -11300890},
+        {13326015, -741294, 15869986, -4925852, 11534970, 7545023, -12397564, -10254252, 29632423, 7249495},
+        {5983991, -13239928, -9108863, -6697587, -15955241, -8417798, 27593884, -16184233, -11722455, 5318685}
+    },
+    {
+        {21424638, -8685523, 21347957, -6853969, -10183195, -815843, 17475819, 9678228, -9125208, 6133147},
+        {17598119, 15542504, 18301099, 7680489, -13951746, -11639645, -1967574, -13492829, 14983722, 4944890},
+        {-11928411, 3798447, 25546055, 626818, 12720704, -12269273, -15667836, 8265938, -28951789, -6595694},
+        {-11705275, -6034175, -4218790, 2672045, -8863266, 3728936, -15744882, 1319566, -7353322, 885881}
+    },
+    {
+        {-32345737, -11108000, -19055374, -4399398, 8819548, -15926656, -3962172, -12951943, -17586443, 13332055},
+        {-3292835, -13590924, 4773492, -10449632, 9917930, 3341919, 23882940, 2399802, -22759457, -3187775},
+        {15568950, 13991962, 6810179, -3159129, -10082346, -9002408, 10516039, 5350940, -33061495, 3607061},
+        {-3436427, 9713506, 1889963, -16301639, 20083722, 4548609, 19965503, 8343092, 4512800, -2444363}
+    },
+    {
+        {30048315, -1129499, -8243356, -10923051, -21306525, 723944, -14973019, -15850260, 21207879, 6050463},
+        {-11572314, -2768621, 15442126, 15175638, -222150, 4806673, -20343381, 3365555, 13075869, 4873121},
+        {24510809, 7737633, -21954892, -6021520, -6338044, -8273669, 22065585, 2013005, 17856077, 896118},
+        {14461948, -10402963, -22658817, -15687686, 7127193, 13071086, -14423476, -7457268, 30087458, -354779}
+    },
+    {
+        {-23318096, 3693363, 12929481, 2530629, -17270205, -2974153, -27991828, -16070794, -16691819, 11098859},
+        {3024534, -13115948, 14844199, -6467322, -17700662, -13109878, -32566326, -5574252, -29656111, 13552897},
+        {-26451212, 15227479, -14216806, 3176802, -30887300, -9545515, -457869, 11862043, 19611679, 13474807},
+        {16648474, -9635647, -22425907, 1717857, 1681930, 14644997, -3166608, -3930861, 11264573, -15852073}
+    },
+    {
+        {-16554750, -8421508, 8908392, -6842785, 18000394, 13018367, -32622460, 13874184, 19073648, -13270850},
+        {-4818529, 1050772, 3735597, 16464011, -29432878, 11203704, 19690035, 14383881, -32533930, -9585242},
+        {-4963910, 15821784, -21696908, -3008128, 17371998, 9178317, 27997661, 15947752, -23403573, -11981053},
+        {-24375217, -16678356, 24329889, -8918825, -30822322, -2085528, 3583096, 13763643, -9395830, -6372662}
+    },
+    {
+        {11822831, -3280932, -13756999, -6005927, -14280013, 526759, 25628482, 6376, 31812216, -11198945},
+        {17448188, -14648942, 4107941, -11007257, -32158664, 4565520, -13580307, -4326436, -12359996, 8816316},
+        {16237096, -5678763, -17931341, -10942083, -14620803, 12793216, -4630293, -6357863, -8724813, 10287218},
+        {32453741, 9187409, -27839379, -12156483, 2121686, -15999800, 11953409, 3265314, -5709413, 13752422}
+    },
+    {
+        {-7114959, -8482190, 24480901, 4956963, -1923143, 9863936, -30803607, -10108355, -23894102, 13208758},
+        {-23116632, 13897915, 22695530, 8658975, 22486041, 2976994, 24427003, -16003215, -6618220, 3535393},
+        {3937310, 4692133, -16393346, -9298503, -18626570, 2871966, -16895377, 12149893, -5901990, -3229764},
+        {8678382, -7166295, -4131621, -6969813, 33328761, 9435015, -20295585, -12297775, 16475881, -6775435}
+    },
+    {
+        {-3233017, 7366123, -32530093, -4982807, -7516939, 14788406, 33148174, 13188161, -28966774, 10802197},
+        {27695193, -13948160, -2697719, -6666537, 538147, -16277026, -5466063, -7941184, 5115485, 9740517},
+        {-13196117, -4066158, 24704462, -4177054, -19237664, -3721137, -25099321, 12144528, -16563824, -4583733},
+        {-32592489, 10303310, 31577676, -2244855, 24139755, 7798032, 32025701, -316638, -9422983, 9156061}
+    },
+    {
+        {-2209420, -10349885, 4809752, -9822514, 26619228, -13461909, -16940955, 545267, 9254013, -1988347},
+        {-22634877, -4708400, 32343522, 6368813, -11231288, -11085157, 10509937, 3860909, 9586623, -5277368},
+        {23903439, 10772921, -23173390, -1770220, -4618332, -3337132, 32000299, 9066051, -32812182, 11216703},
+        {33118302, -14782566, -6229367, 2899411, 25263660, -5376768, -7159393, 6404580, -12152052, 9099734}
+    },
+    {
+        {-29923498, -136759, 23765436, -6027930, 5914837, 3338838, 971160, -2947749, -30728248, 16744925},
+        {26003197, -11214513, -29986605, -8085230, 3094183, 3363429, 18225174, -2759586, 29619939, 11954901},
+        {-12250332, 9032116, 31216275, -11942567, -32662059, 3962358, -11473121, 8246609, -3508318, -9391883},
+        {-26736932, 760388, -18906664, 6923709, -11819705, -5559249, -3309870, 4354230, -18464185, 13191068}
+    },
+    {
+        {19233048, 14106353, -18317732, -6812254, 23548489, -10143988, -19621144, 14333959, 26498007, -12552525},
+        {28236369, -6105370, -16510414, -7704808, -32887839, 4118743, -19567494, 10291544, -33261629, 3636059},
+        {3669949, 541365, -2522324, -10783831, 24003931, -15331086, 19332717, 4042841, -2575470, -2341324},
+        {18725982, -12998652, 11884067, -6774255, 31572044, -7445636, -11253720, -3680798, -15388325, -15944122}
+    },
+    {
+        {20981720, -4125864, -24628934, 2138064, 19962452, -8124695, -15124402, -15582776, 1510208, 13245684},
+        {-22493800, 11256850, -23582710, -4475034, -32154003, -7221535, -22097327, 12697560, 13995416, -4333112},
+        {-2486462, 8323213, -15790267, -16470524, 33502891, 947009, -20191995, 13842631, 13942132, -10673286},
+        {8631834, -5472832, -16963884, 4542464, 17311893, -2554428, 2399818, 4835556, 9580348, 5852823}
+    },
+    {
+        {-7753500, -15459163, -6278899, 4142517, 7935616, 2567321, -3617330, -7739670, -20836920, 10318048},
+        {-19964549, 9147983, 19691703, -10204391, 14012629, 13532111, -23522646, 1148668, -24701326, 4785520},
+        {17692798, 14278982, 15848071, 6747422, 5217204, 3732471, -17874706, -16230227, -24564827, 14973168},
+        {2634853, -14180455, -25360410, 1620657, 10289635, -12773901, 13969685, -1570677, -19156672, 457214}
+    },
+    {
+        {19146331, -6845047, -656096, 15456009, -1495057, 626584, -33095444, 4765924, -14616346, -8487816},
+        {4434027, -13243256, 17945972, -14262197, -29931463, 10965497, 15705237, -6123889, -27199521, 4949530},
+        {-15984663, -8286164, -15992422, 6746154, 3487878, -12576451, -10591222, -12989951, 3785796, 7925459},
+        {6408876, -7868738, -13513743, -7041615, 7706078, 866749, -8303266, -15601700, 9616189, 3588270}
+    },
+    {
+        {-21782521, 13234469, 23105854, 5061895, -20644666, 11270060, -23763702, -5373841, 4182391, -2470570},
+        {3987508, 14015405, 10062942, 7095958, -821999, -14748863, -1153137, 6293418, -19161960, -5146764},
+        {4601197, 11864551, -7760457, 7292435, 30587870, 10667917, -12421431, -2738902, 26068345, -574291},
+        {-29511702, -13438061, -2413250, -6034538, -18671064, -1169653, -29030926, 12193956, 16843300, 11926863}
+    },
+    {
+        {-13916003, 13988076, -28055763, 6477206, 25693418, -15911149, -23562314, 14022620, -3924395, 3756771},
+        {16647820, -13553737, -8319188, 2758104, -10605392, -648801, 16125746, 14489821, 26785388, 11773430},
+        {21563699, -708416, 3120851, -8448993, 28059429, -13839395, 9843166, 7608010, 29682341, -11736147},
+        {4592694, 1606217, -12027968, -11824001, -21740925, 2265990, -22726461, -2174888, 20288157, 2795049}
+    },
+    {
+        {16817347, -14402746, 9752941, 12381428, -22182924, 5780740, 19452983, -16003299, 1663878, -9721990},
+        {-30488665, 7241708, -27318283, 15947609, -23108311, -15152972, 31519192, 16280999, -27870716, 16481352},
+        {27827371, 6537175, 25333810, -11128673, -25134041, 6939779, 25498155, -9545384, 20390577, -9505767},
+        {-20813706, 11582546, -13687959, 13806463, 13169924, 5781028, 17915076, -14595855, -19600196, 15610566}
+    },
+    {
+        {-17226710, -3618989, -4409691, -1046557, -28319019, -15672210, 9543211, -951987, 22422313, 10140033},
+        {4461385, -3048626, -8656549, -13962266, -19279818, 15922434, 25600865, 3431133, -1382563, -10297729},
+        {-29393228, 14559877, -4635339, -2508661, -29118546, -13575574, 198429, 15699757, -20001199, 2334793},
+        {-21991668, 3477659, 27670590, -3048858, 6978942, 4022440, 27776953, -13181445, 7344306, 13958408}
+    },
+    {
+        {-25341598, 11493198, -7869538, -7497992, 14306613, -15146892, 33349485, -10511714, -16994033, 15579612},
+        {18469843, -4608011, -10820129, 8999980, -10957994, -666469, 24161045, -2944246, 26025273, -7385199},
+        {-33426444, 14977540, 10691131, 15952020, -17000668, -935919, 31065912, -16588221, -30363021, -11656871},
+        {1278188, -5983666, 5423891, -14003628, -6810818, 15271332, -28685192, -12868041, 31433405, -13267037}
+    },
+    {
+        {-18860302, -13573140, -11319195, -682860, 23904947, -6904789, 28725681, -15955417, -5419188, 15036154},
+        {12887895, -12984035, 13077032, -15696055, -30481588, -8045982, 22732, -131274, 18654803, 11619024},
+        {-20016214, 11501765, 7196945, -9007351, 8479579, -7232032, -19922762, -832278, -17012308, -15745574},
+        {5574458, -9966263, 18502789, 16058199, -4278441, 1544707, -22698252, -4251488, -2522115, 11299198}
+    },
+    {
+        {-20184819, -10747423, 30397113, -1346914, 19048444, -7728050, -30879967, 12416150, -12556998, 11180304},
+        {14088025, -13127643, -15444069, -16650758, 31701109, -14771761, -6095098, -8138832, 31133405, -1767720},
+        {2220384, -15845768, 21916658, 14596352, 14384466, -10673839, -2286281, -9705216, -21384308, 583851},
+        {19584196, 6975587, -11683664, 10899767, 9686533, -6027399, -12308541, 6609065, -8777177, -16163429}
+    },
+    {
+        {28773917, -4654037, -16022555, -14682021, -29100331, -2877144, 30028714, -12937085, -32544273, -10484887},
+        {2382925, -7206733, 24635931, -1551393, -22199381, 3056236, -702192, 15600544, -15801657, -5698529},
+        {-28567765, 16306596, -25412101, -7085037, 8791602, -11119432, -15822389, 6789389, 3079044, 8162309},
+        {9261331, -5946685, -9686588, 278802, 18245554, 166839, -25230478, 2232144, -18471205, -16074144}
+    },
+    {
+        {-24394508, 10841097, -11860352, 3602567, -3912004, -10396649, 19031211, 5719679, 2521669, -13435735},
+        {14006569, 13449732, -27674123, 3151876, 30078071, 9526935, 9637722, 1796102, 19133279, 12391060},
+        {-22191242, 3200552, 29123495, 10151641, 8030127, -8989230, 33384924, -4533235, -32186419, 7014720},
+        {82829, 4867413, 8933177, 7113049, 29552034, -7310205, -27991495, 6692745, -5035259, 1077587}
+    },
+    {
+        {4914550, 6790610, -6406188, -6893267, 16711725, -11327031, 23556628, 9579434, 25997111, -11827284},
+        {-11441414, 12389891, 27919235, 13384668, 15853736, -4717502, -26026280, 15124988, -22868436, 2258433},
+        {-9639960, -16709960, 8676452, -4432143, -11972546, -1087022, -30590485, 4394900, 6465496, -4583120},
+        {-19092708, 12097097, 6704714, -6039792, 29290579, -6972656, 25058895, 12683715, -21495754, 10576296}
+    },
+    {
+        {-29162509, -9378192, 2212039, 13032891, -27786702, -5147429, 18154834, 2112149, -19489195, -5899730},
+        {-3927327, 5695441, 8699415, -2405659, -23301091, -13253958, 27142065, 2852890, -29361422, -3712504},
+        {-6153971, -11091884, -24792888, -3012994, 28004761, 5448931, -28625293, 13014984, 29758510, 5196435},
+        {-24365561, 1919011, -3905822, -3959363, 28389043, 7262468, 32324745, 12901406, -9813077, 6712740}
+    },
+    {
+        {-30948682, 3156569, -23019909, -9178720, -15511793, -289656, -11305433, -13056778, -18641204, -7432698},
+        {-32247986, 321514, -3606519, -16732460, 3802837, 9545812, -30024031, -1413918, -9858143, -8649761},
+        {6952481, -8839366, 4180289, 5762338, -28686856, 11242730, -29098327, -14327099, -15571913, 6521242},
+        {14496324, 3329670, 6647073, 6920197, -13897702, 12228111, 18279604, 3434610, -24291740, 16553525}
+    },
+    {
+        {-3046861, -2237909, 23496721, -9216671, -10604767, 15119666, -30077792, -6682682, 30975284, 8632361},
+        {-13394243, 2621562, -30493784, 13351689, -7838432, -16524776, 30180451, 7156027, 32783439, 16599643},
+        {-27626872, -2433651, 21094324, 7740250, -19604867, 8700347, 23215123, -13456616, 12495985, 11531910},
+        {29110166, 13256782, -13048673, -5513551, -24397613, -8146001, 10268398, 11093553, -8658287, 8010331}
+    },
+    {
+        {3503099, -2741448, -17382370, -15731404, -2083779, 9316679, -7405099, -7831599, 22553590, -12348635},
+        {-27231215, 12570916, 31225931, 871726, -31754198, -4893240, -12369772, 15370031, 28811986, 12468590},
+        {16429359, -15779385, 11310171, 10028899, -23969572, 4580769, 24808995, 1495332, -781149, -16185323},
+        {-13315930, -7286203, 20124146, 10709916, 18188338, 12847321, -14464748, -15148770, 24570518, 6335995}
+    },
+    {
+        {7867812, 243692, -23372048, 12216749, 30843968, 11746145, 1483205, -14770485, -10135966, 5227542},
+        {20011737, 13490288, 32350319, 16418072, 17537377, -3279398, -33547008, -1070270, -24282033, -14741025},
+        {-23812307, -13698413, -20357266, 7073032, 4281833, -2254222, -29624609, -2700691, -29298551, -670363},
+        {-18018096, -10508171, 6131998, -10655783, 4072502, -15860515, -4797352, -8426158, -29763032, -12588296}
+    },
+    {
+        {18963964, -8133568, -18763879, -11846610, -16096968, 15670466, 4180483, -2065484, -14998192, 13907142},
+        {14356741, -15690738, -13058343, -14126394, 4358732, 6793364, -15964455, 7201468, 29364097, -10174425},
+        {-3810580, -15952114, -6677711, 5613147, 954841, 6004503, -20072097, -9839838, 9387353, -10761318},
+        {14054955, 4673791, -5368214, 5755125, -25697952, -15148966, 10417362, 4199795, -25871860, 9724623}
+    },
+    {
+        {30860574, 10515654, -14259116, -14938824, 5038564, -11040229, 30006930, -1554030, 26114152, -16447988},
+        {9283284, -15705838, 28558671, 12595813, -22264793, -13649161, 11159486, -8646400, -31945184, -4611480},
+        {10683941, 6282950, 3399280, -685093, -20937267, -5908248, 9469162, -4797584, -27901011, 9154017},
+        {-3352875, 7610039, -1663728, 10901989, 31777404, -10944573, 31123147, -16627410, 18076579, -10032327}
+    },
+    {
+        {-23600374, 12354738, 12443882, -11844776, -29131339, 11124986, -636391, 4246129, -14699014, -9477159},
+        {25879333, 194513, -8231673, -1373340, -23491533, -5143091, -22307100, -14050940, -12227253, -7548411},
+        {-20276272, -4732761, 13153428, 6532795, 8935625, 3667370, 24877047, -3789434, -24071815, 9168335},
+        {31670442, 4672309, 30875065, -10778673, -7150049, -6778977, -16489196, -5654255, -6485987, -2010988}
+    },
+    {
+        {-26156710, 16105584, -15138908, 5187619, 2802702, 12483473, -20632210, 2842493, 16380735, 11255922},
+        {10051810, -13421745, -26249201, -14044831, 19145165, 12186976, 18615587, -12452097, 22435747, 13483513},
+        {-24088020, -4128167, 10693079, -16657532, -16714825, -14049057, 28372222, -2683730, -25290386, -15745558},
+        {-4765941, -2823122, 2312547, -10392803, -22860514, -394755, -32158184, 11893171, 17521073, -4949501}
+    },
+    {
+        {-29437134, -4083104, -6905567, 64881, -16598059, -4260125, 12457403, -6662780, 12544641, -13766202},
+        {12378305, -1821659, 8301653, -14639170, 8976262, -6312450, 5231031, 3658724, -17761370, -11955272},
+        {-29219200, -11695957, 5049123, 16457722, -727294, 4514769, -20824381, 4978156, 5600137, 11812943},
+        {-24461905, -6746492, 13643671, 15450815, 8327886, -9546014, 10892314, -4549366, -20522857, 674023}
+    },
+    {
+        {33117172, -521934, -32467566, 1272356, -3539085, 15277541, -23034296, 5259895, 23923795, 9171594},
+        {-30979379, -7335473, -9907870, 11953006, -32126128, 9120682, 16932968, 10624566, -31484078, -8517257},
+        {-21896057, 5800316, -1841882, -3865151, 27190443, 15584882, 3066332, 5184694, 22872453, 8379489},
+        {-23471310, 12172191, 22314636, -13983505, 22523062, -6790355, 8220527, 14504689, -28847067, -11938767}
+    },
+    {
+        {31864457, -1534239, 18472512, -4573493, -3881469, 4998620, 20105085, -16239461, -13058233, 13816058},
+        {-8944549, 5928758, -23405956, -5906958, -20452978, 3090267, 13444645, 7251997, -20374366, 3338096},
+        {-28961603, 9026693, -9671718, -4425537, -7289473, -10297019, -27845080, -14177498, 30390840, -6360928},
+        {12211436, -16437871, -19359249, -16454024, 3143247, -7977391, 6805808, 13149292, -459249, -7340079}
+    },
+    {
+        {-11271294, 8815063, 13373537, -14378530, -20073885, -1894198, -33084808, -4721398, -22868137, 15793960},
+        {-13021605, -14940182, -30117061, 7026644, -7129589, 11970268, -5553526, 15312027, -4007086, 6709293},
+        {2934093, 2049481, -25192489, -11729080, -4354023, 4453385, 25170153, -13716541, -11400486, 9232134},
+        {-1045483, 4966672, 6525668, 10720677, 11905684, 1881114, -12751293, -4702760, -24727233, -8746612}
+    },
+    {
+        {32046421, 16025351, -23716144, -10837061, 25126165, 608378, 27600233, -13488915, -26666187, -3465568},
+        {-19295725, 9942417, -9925088, -170991, 11810958, 10150321, -18737252, -10708626, -23609379, 14593077},
+        {-9079823, -85493, -3676514, -11433297, 7409186, 12888184, -26455222, 4510862, -17589104, -4052413},
+        {5603687, 13262545, -14748414, -13521552, -13843348, -6817309, -15594633, -2584262, -31841346, 2144881}
+    },
+    {
+        {-14648227, -2811356, 6909969, 4808385, -11726864, -5158871, 15633652, -2701964, -19654092, -5336754},
+        {-25076705, 10914136, -26603817, 12793034, 31249168, 14709152, -31424843, 618346, 20461521, 1533345},
+        {-30887991, -8890025, 20669439, -509178, -14234704, -4782304, 21356838, -8599410, -22180454, 4871132},
+        {-19456403, 10775342, -702547, 10182511, -19161832, 5358185, -18610474, 10038813, 4822853, -14294413}
+    },
+    {
+        {-3888427, -1442760, -25106130, 3304141, 19009396, -9782997, -3364152, -2213307, -27321517, 4894771},
+        {-32001102, -3295454, 18255795, -11058863, 15684295, 1778779, 20322096, 3615002, 9292433, 6323832},
+        {20577618, -13748750, -28493855, -9340466, 26856544, -14819922, 19523224, -555234, -18379031, -210802},
+        {29832352, -13524912, -33303795, -4616926, -7797556, -11162864, 13930746, -14623336, 28185119, -10662890}
+    },
+    {
+        {-6024565, 3945419, 16327829, 1281497, -13008661, 6060422, 33121715, 12648096, 12576212, 1598484},
+        {-22266922, 12940222, -5569477, -8369941, -11867698, -984335, 13939466, 10766895, -24813217, -15674929},
+        {25788383, -5494587, 32105607, -7181495, -15127154, 5376604, 22947700, 10223869, 12105037, -12359128},
+        {25537096, -2715134, 33096632, -2252509, -2810583, 3286384, -29941001, -10780563, 27269802, -15852419}
+    },
+    {
+        {-28987478, 330998, 4963837, 5402963, -3428023, 3241450, -1694603, 10313512, -30280691, -13626848},
+        {-14775461, -13526336, -29410969, -13620023, 28009718, -9983369, 23183619, 14528887, -1586580, -12416426},
+        {29025694, 11747124, 15740525, 10050152, -27457648, 12565926, -26927985, -526908, 21234352, -15762685},
+        {-24824998, -12104913, 19112665, -4591257, 880438, -9396905, 35092, -5957121, 32252540, 16119857}
+    },
+    {
+        {-17625532, 10217686, 25638003, 5030383, 31606136, -4845006, -2586858, 852997, 9558192, -3368002},
+        {32004161, 14036369, -30873298, 5842720, 32966823, 2342418, -30153398, 12238143, -1520162, -14392537},
+        {-21120810, 9916907, -22259116, -6078103, -20266571, 9151924, 2530966, 10835021, -26799756, -10650196},
+        {-15061847, -7742886, -13869575, 14274239, -32447265, -7930720, 27467193, -5312251, 30415209, 15192513}
+    },
+    {
+        {15137702, 15830657, -31776568, 12814329, 2883658, -16670312, 23002147, 10936173, -12297428, -8721092},
+        {-24416120, -7819209, -29959746, 16174049, -3233547, 7550493, 10129718, -9722930, -13757198, 8209755},
+        {-7590037, 14360279, -18653535, 10018814, 22845151, -2780906, 11484505, 1435930, -2103688, -10350318},
+        {-14273073, -4214450, 27102698, -3358528, -27780556, -2199393, 17615704, 16454281, 27387893, 2678870}
+    },
+    {
+        {-19784306, 7323964, 30208820, -758598, 11163556, -5826989, -20239357, 3688163, -23636821, -3998188},
+        {27007483, 818195, 1697923, -4763611, -18234461, -14134743, -28086645, -14169705, -25919643, -14956381},
+        {-4928978, 1715618, 10698431, -9601626, 20399418, -10244058, -12685577, 4096428, -25241362, 15190680},
+        {-6934771, -8054079, 17150036, -7229520, -32175564, 10141346, 10714731, 7541224, -8834665, -5613769}
+    },
+    {
+        {10884521, -13310625, 19416423, 13265436, -27063012, 14949770, -14354074, 10181967, -8809072, -4440745},
+        {13883865, 3928921, -20707712, -910321, 22441823, 63075, -6045918, 13814109, 998144, -5343761},
+        {-16326347, -3689277, -25956255, -651028, 32396916, -3211520, 19377578, 2363049, 15119286, 7865878},
+        {-11569125, 2237986, -20601734, 660575, 5834564, 14244622, -18043842, 11320738, 30064185, -13285798}
+    },
+    {
+        {-19066167, 10678836, -25933033, -12294948, -28346939, 12485851, 19601963, 7903731, 496316, 11390837},
+        {-21280003, 11026574, 20034357, 8078864, 3021454, -6742437, -31728060, -428265, -19551284, -6305185},
+        {574640, -865824, -20945365, -14853887, -27092244, -10672668, 20924361, 14423129, -13277634, -4399975},
+        {-2017352, -6186202, -22822501, -2471489, 25618640, 14308415, -6644052, 16131439, 10990889, -7968603}
+    },
+    {
+        {-16954043, -12602076, 9217135, -10305450, -734379, -2561315, -21897229, -5773343, 15994672, -3272961},
+        {26933083, -15634967, -19996855, -11622403, -3538546, 13287489, 12449675, -1079019, -28604874, -10383265},
+        {16532071, -8331412, 3756534, 3802754, -6481265, 4643071, -21439960, 14161279, -19487546, 15820397},
+        {27255021, 1511434, 10746905, -9278251, 23282406, -16537, -14021732, 15921082, 23540641, 12409197}
+    },
+    {
+        {25177249, -5141660, 27309953, 5762592, -9905761, -9068015, 26756940, -61623, 9608372, -2954014},
+        {3207818, 16672632, 15620652, -7758875, -15595546, 6666463, 5151032, 4915636, -15106947, 10347954},
+        {5513602, 6065047, -7284506, 11931101, -24324664, -14481825, -20561414, 11324496, -3612522, 3298357},
+        {-18707232, -1982785, -190830, -7176605, 7806804, -8438697, 3063676, -8496369, 122534, 1554040}
+    },
+    {
+        {-29150246, 7347661, 23805538, 12419907, -25112577, -7258916, -22114432, 12348547, 11007307, 2899246},
+        {-30042517, -15843285, -7109994, -11172310, 29238236, 2431336, -4851551, 7349867, 24809533, -15535668},
+        {29120078, -8379042, 30984618, 1169657, -29978552, -3853709, -14851949, 8104522, -9386905, -9252554},
+        {-28552102, 9179713, -24379164, -12509322, -4163330, -15705137, 18716842, -13992752, 28470840, 6455103}
+    },
+    {
+        {-27009679, 8686508, -15352266, -15727349, 16541545, 172674, 22167513, 6110646, -31957446, -8968872},
+        {1742516, -2563528, 7849417, -3332171, -27673438, 5804069, 23482634, 5838255, -17628295, 7471313},
+        {-11474339, 8173147, -13485637, -7330498, 7367848, 16343826, 22048295, 11182572, 13461509, -703398},
+        {-20371890, 3952418, -13785507, 7487281, -3489323, -7863249, 8753775, 2104094, 6736961, 6660099}
+    },
+    {
+        {2221840, -6173066, 25998424, 12099392, -18008945, 14877298, -9715240, 3356596, 26009087, -1426973},
+        {-6534629, 9779545, 15469959, 11456530, 5340397, -7268947, 13253360, 5143642, -14665859, 4052126},
+        {-8757102, 997574, -11335676, 11124079, 29563013, -10521130, 29418805, 12849832, 8977503, -15419413},
+        {-29643318, 7226572, -32567333, 3365008, -24616798, 1970993, 3287093, 16700179, -8496634, 15479958}
+    },
+    {
+        {-2018376, -4174122, 9718019, -6201891, 11591910, 6145308, -33028273, -2094857, 12469135, -3156367},
+        {3887067, -15528545, 27111997, -10336524, 14204095, -7656682, -28222064, 11841550, 4350739, -12350462},
+        {16626723, 9637148, 23988650, 1600699, 846621, -2020925, 6432160, 8152888, -7136611, 7462226},
+        {-1538326, -8597536, 9378705, -4824879, -1502747, -813318, 11218597, 83753, 5553718, -585527}
+    },
+    {
+        {-15323323, 60905, -26813612, -16561336, 19565885, 15673575, -33072398, 960644, 11729930, 14131588},
+        {17101133, -7319761, 30613094, 9909902, 10013394, -3227072, 14470265, 5575369, -12339044, 13434657},
+        {28032856, 4055242, -29813159, 545323, 22203602, 14924893, -32680633, 7754682, 10754000, 373089},
+        {-32720241, 13636388, -8618003, -16643143, -3628407, -16455679, -20978227, 3728161, 550405, 2104428}
+    },
+    {
+        {-8483395, -8317129, -12843092, 8884323, -20811003, -11015816, 22885587, 4027268, 30986574, 9832992},
+        {9091024, -15494535, -801372, 3134195, -6877157, -290026, 26626871, 7792913, 27314326, 12915976},
+        {-10025262, -11457272, 10423496, -1082856, 781559, 7096961, 20487229, 393886, -27636904, 1338146},
+        {-17236607, 2958641, 32801595, 7025221, -13635905, -438498, -11986852, 5765829, -18103727, -960547}
+    },
+    {
+        {19016458, 12555768, -26469801, 12819348, 27941914, 16526963, 16892612, -11434182, -29571912, 1464314},
+        {-12021006, 2457419, 30082854, -8125527, -30952847, -8359063, 16369012, 16697922, -12909113, -13110853},
+        {-28042141, 13584081, -5538912, 8339916, 28618923, -10547713, 24305165, 6544125, 10966459, 568669},
+        {26038739, -3834843, 6616183, -10304248, -18264985, -11868018, 17277193, -7258380, -20395989, 15985761}
+    },
+    {
+        {-3057607, 2731282, 28048285, -9063929, -23434639, -16619079, 27137942, -9013635, 24825869, -4450433},
+        {1216030, 4087133, -32791010, 14164297, 2208680, 1860286, 18961507, 4151125, -17558192, 8230902},
+        {16406781, 8404882, -20350426, 2036259, -18331843, -8029120, -24252836, 5278201, -17285400, -10105292},
+        {-26210150, -10346555, -24281918, -12496483, 33385579, 5014600, 9047210, 2410020, -23049707, -16518451}
+    },
+    {
+        {14459386, -1597874, 28582501, 2935621, -13874147, -5200215, 33121447, 8695867, -13813803, -1274555},
+        {16862861, 946727, -581317, 3674590, -14789860, 14187358, 15482669, -11388797, 10757988, -3251618},
+        {-24929141, -6913726, -16267329, 12994469, -17160126, 13211953, -9114432, 12861289, 2050069, -3028363},
+        {15586575, -2329788, -11729934, -15251263, 29982738, -13383009, -3493279, 15142777, -17264330, 5457357}
+    },
+    {
+        {-18526901, -12047363, 16732411, -14080745, 23366708, 4839709, -2929942, -6309145, -31058614, 14896592},
+        {10252029, 16177127, 31981262, -12424243, -2265810, -3479663, -11255302, 10013189, -6116768, -12760819},
+        {20065537, -5726407, 2436054, 13070544, -7312011, -2987132, 3627080, 12686219, -29443544, 1118137},
+        {11382581, -74655, -26802117, 14190713, -20456399, -12311, -21112887, 15928187, 6062142, 10302599}
+    },
+    {
+        {-30566917, 14046047, 21902289, -16411617, 55683, -1699768, 20715650, -8089271, 10816893, 15354670},
+        {26418812, -7036199, -4089868, -13913773, -21526071, 11736528, -13902761, -12979844, 26333317, 3275100},
+        {9573288, 12658501, -27223625, 11430146, 10686353, 2402307, -24255415, 8835778, 21803642, -9113768},
+        {-25790488, -14250405, -29306741, 12025836, 10436992, 8898170, 14530685, -4926680, -3684252, 9876422}
+    },
+    {
+        {1237538, -9850252, -791955, -15551174, -25508068, 11717776, 8007171, 10847701, -26053916, 1139680},
+        {-32721685, 8218916, -17925062, 1999575, -28485119, 8257202, -26361325, -14401064, 6981031, -9384366},
+        {-14684078, 4443185, -32634790, 12702360, -17190892, -5112804, 6599088, -10858206, 1037391, -2879988},
+        {4671531, -3598378, -1574783, -2736840, 20406204, 6557133, -22772176, 9426051, -27917971, -7452139}
+    },
+    {
+        {-25706448, -34856, 23595318, -5688789, -23765622, 10194337, -16702577, 6548656, 26054757, -16155701},
+        {1394409, 4041884, 14625271, -11590620, -31306501, 8934529, -25068534, -14849323, 5153122, -2443236},
+        {29887825, -435436, 9018215, -6696511, 8803653, -208529, -6815672, -5341411, 3575088, 3565655},
+        {14225409, -1170041, -21710557, -136743, -201272, -3678432, 824003, 9896054, -31439715, -4306744}
+    },
+    {
+        {28982061, 10652471, 25410070, -10450209, -15125822, -15609001, -16366656, 15343579, -3628027, 10614173},
+        {17888685, -3907738, 30244871, 13765934, 24648169, -12294461, 33067236, 16623304, 26423130, 14859857},
+        {12826873, 6094337, 6577065, -14637865, -4321632, -3796003, -5414133, 15395160, 12780416, 106942},
+        {-1126210, -15064469, -17121819, 3010080, -5332972, 16761602, 30608107, 12604501, -4879330, -12813858}
+    },
+    {
+        {30217027, 6254737, -3092176, 12507617, 17590302, 7026662, 26873077, -1740584, -6665353, 10980742},
+        {-20285608, 1687890, -10983636, 5558663, -15185790, -9359810, 32970661, 12360521, 25425154, -9304849},
+        {-1169393, 12983177, 19707119, 10321390, 16838426, 7505138, -27620143, -6558553, -26525219, -12347197},
+        {-9294051, -14097251, -8537045, 2501004, -6326673, 1134707, 3591139, 1854607, 14219408, 3401797}
+    },
+};
+
+const ge_p3 grootle_Hi_B_p3[GROOTLE_MAX_MN] = {
+    {
+        {3238247, 2471600, -19444001, -6891389, -28834216, 13391114, 31649869, -8336292, 763883, 5827467},
+        {-19921712, -12047295, 20144111, 12621703, 1382867, -15093127, -26089523, 14836472, -25410301, -8071594},
+        {-3942907, 13122936, -26968886, -4972298, 24966412, -55403, 25557594, 5720978, -3715977, -9098289},
+        {11965592, -4488122, 2555908, -6381019, 2160811, -15570402, -25888044, 3349973, 5178271, -12559787}
+    },
+    {
+        {2814539, -6597250, 6019168, 5071822, -25252966, 7211290, -6249643, -14260063, 10397398, 15160777},
+        {-15382322, -3978461, -826502, -5330264, -23844003, 13519668, -31476755, -13756675, 1124373, 5644600},
+        {15621483, -2237312, 13540330, -9124886, 3142346, 11423596, 31769308, 7166195, -1493151, 7102767},
+        {16670366, -14194732, 24482306, 1508939, 33209585, -2191516, 16232641, 13095653, -21865517, 4299268}
+    },
+    {
+        {-19751305, 8706717, -21972461, 1967666, 14251899, 12480913, -30942834, 10188254, 26668493, 2498396},
+        {-32436611, 10604762, 1246615, 9236408, 31477276, 16177315, -21919987, 16616768, -24019030, 9209421},
+        {14353817, 13277008, -33516710, -14655191, 4007575, -462145, -26945614, -14318466, 6355155, -15440789},
+        {-1430007, -11953553, 32904311, 15030702, -21553358, 16182753, -7680800, -6557777, -30527443, -60174}
+    },
+    {
+        {-22531061, -14562272, 20590866, -6159902, -29265577, -8859238, 12260685, -10116962, -32088950, 486849},
+        {16327420, 11159371, 31646147, 10470352, 808392, 8291045, -23653604, 14367247, -12052143, -13221548},
+        {14316593, -10681197, -6243912, -15876763, -17306815, -12884126, -8833912, 8864057, -26832877, -5697287},
+        {-4230465, 11872579, -5211636, 1326817, 3199927, -8564476, -25207334, -945100, 1541749, -9176818}
+    },
+    {
+        {-24306921, -8790880, -19420170, 8704757, 2034580, 13573119, -20268669, -15457506, -26453363, -7788934},
+        {-21733308, -1408771, -30670946, -13684424, -18875451, -935413, 21492279, -733429, -29390081, -13999636},
+        {12132760, 5993583, 1935386, 10160296, -1368359, -1814593, -20957263, 5137695, -24555951, -9041920},
+        {33089994, -5388237, 10885505, 16683071, -32299609, 10535813, 6073690, -15183314, 18974465, -887297}
+    },
+    {
+        {15787696, 6386774, 15979771, -13637240, -6804924, -14924396, -5735507, 5161942, 24118053, -10774573},
+        {-129655, -11382405, -15746225, -14105807, -5648431, -3582343, 16050561, 5782962, -30816013, 14441166},
+        {22313383, 7970299, 33183343, 12680683, 18098933, -13834364, -24681452, -8677944, -16044198, -12033628},
+        {-31990564, -14869441, -10302889, 14756102, 19639144, 10499423, -27325025, -15936170, 16084095, 9742673}
+    },
+    {
+        {-5058628, -2863202, 21415502, -11016716, -14083714, 8874660, 9120826, 560604, -8697806, -10487124},
+        {6783433, 8446162, 29781297, 4777256, -9281973, 201311, 28337596, -11486120, -11596801, -2340476},
+        {8893588, 2681329, 20097733, -4678935, 2852045, -9395832, -31303534, 8100012, -587024, -16442041},
+        {-25260969, 13262929, -32678524, -6112674, 27528304, 2012742, 5109187, -6134861, -27589216, 11627994}
+    },
+    {
+        {25957201, -15811076, -26173547, 9498319, -26878576, 14933326, -31316236, -15210434, 268151, -13789189},
+        {29097437, 12454145, 23531742, 4610768, -33175111, -13238477, 16156248, -882457, -23158333, 5957703},
+        {-22734230, -3638449, -19704702, 9306004, -24100587, 1436032, 32092222, 8443168, 20712913, 3882928},
+        {23214494, 14254756, 16591042, 9319170, -17625077, -13414518, -13159236, -10713414, -23803269, -16365320}
+    },
+    {
+        {30056978, -3385876, 32806603, 3538673, 5468268, 12884137, 26169046, 14904825, 3369912, -1203097},
+        {-6668748, -4655151, -10197050, -12648425, 12547319, 11747925, 8329945, -13292395, 14742384, -3544243},
+        {-15650160, 44987, -19191989, 13650224, -21774979, -5483336, 15478500, -12009354, 15228795, -1269465},
+        {28947792, -11360978, 25880451, 8640159, 32739740, -2385199, -25708720, -9313760, 28001195, -5860725}
+    },
+    {
+        {-6847707, 1428525, -25618216, -11630299, -12101670, -9492558, -9729620, 16320769, -1319024, -13691090},
+        {16602115, 11410098, -29174251, 11077510, -4297118, 10537152, 18721163, 5140238, 31874799, -8538036},
+        {-17362641, -8649543, -25034812, -13869410, 5449581, -9642325, 19888514, 4864472, 2222544, -344599},
+        {-10649410, -3291901, -7014646, -718406, 22803520, 1160906, 6894990, -4325413, -17045762, -10408000}
+    },
+    {
+        {24036885, -15157707, 19341555, 14712480, -19164321, -5410693, 14401357, -7531893, 3356839, 1312342},
+        {27242059, -14267905, -23274888, -10403864, -30755533, 12083603, -23743483, 7717545, 30180131, 4645119},
+        {14613393, -6617646, -5600201, 7323700, 26961258, -15884611, 13665836, -13754632, 4201442, -2561478},
+        {8599147, -8657632, 27794906, -14636954, -29295664, -1720912, -5063859, -6702562, -24426289, 14698476}
+    },
+    {
+        {-18055020, -7118968, -28581046, -14842324, -10727113, 6776539, -18784679, 3087566, -30534345, 7518511},
+        {-19354223, -10887982, 27485551, 2871253, -30669173, -5541013, -10358252, -2288514, 30623912, -5494299},
+        {28559238, -6693120, -17603274, 1334591, -17241021, -16470453, -14122437, 11404056, -17551011, -1680555},
+        {-32710590, 129065, -12845074, -13362350, 2974551, -15455298, -17203714, 2472222, 10063465, -5856529}
+    },
+    {
+        {-31051652, -4546663, 21285649, -15839174, 31791406, 6939752, 9823567, -2802761, 24087394, 267739},
+        {6966248, -15700293, -18570226, -9695430, -22876846, -15939463, -15898593, 882194, 3393011, 13013499},
+        {31275607, 4487633, -31938686, -14260834, 22069178, 4670341, -24967148, -6649059, 1067719, 10160716},
+        {-33031393, 3713313, -19938129, 4538227, -4890595, 15493263, 23399479, -4682651, -2998891, -1672909}
+    },
+    {
+        {12526237, -14290282, 23130852, -13009452, 10465948, -8124446, -31918481, 5471063, 2893501, 9732912},
+        {29766281, 11269333, -20292017, -9052324, 3107604, -4981892, -7862418, -15150174, 7261713, 9622660},
+        {-19886031, -8506430, 30799845, -1693083, 25894526, -5983002, 31214959, 10943673, 21380789, -9614612},
+        {9147235, 10548939, -207462, 9717580, 23710012, -6478571, -29385440, 6585000, 6876200, 15443249}
+    },
+    {
+        {-2480494, 16443898, 11622503, 16561550, -15997451, -14517653, 6802379, -14233875, 6608453, 742782},
+        {3775180, -11431914, -21681138, -14131882, 20786609, -5401251, -9953648, -5307794, 2222079, -727277},
+        {15652505, -15949843, 7984126, 14004984, -5946999, 13716781, -7373559, -3357376, -5108927, 7659930},
+        {-19271644, -3176108, -3851836, 3395875, 64774, -6140222, 7557192, -1586249, -18748918, 4174246}
+    },
+    {
+        {-17965594, -9114498, -27928879, -342863, 17564674, -1462580, 14116403, 549563, 1749296, -9355515},
+        {-18698344, -16096956, 12537547, -373431, 12090370, -16258725, 5513078, -15530022, -22962970, 1628134},
+        {-19789635, -8777121, 17869988, 7077308, -27246503, 15712274, -13377995, 13774657, 14693665, 15439417},
+        {8597518, 16511436, -26808376, -16628503, 5410171, 4727965, -6650390, -8014692, -20956971, -15673954}
+    },
+    {
+        {21984465, 7867510, 11790530, 6586568, -10160698, -13909284, -9468141, 5871558, -24433669, 14538731},
+        {21785886, -14687580, -24568808, -2614425, -7558933, -8913717, 4592316, -6219181, 12456393, -13975226},
+        {13198505, -6745920, 13330670, 14183190, -25726485, -6090804, 19774124, 11263107, -17630726, 12847350},
+        {-4947744, 3429794, -8392354, 8844342, 19681882, 12049830, -2995576, 2997883, -29669128, -2372744}
+    },
+    {
+        {10473353, -9311387, 4067052, -1274976, -5189982, 7325032, -5935474, -11586864, -11433112, 5300440},
+        {-25895382, 13408719, -11969575, -10003996, 19738909, -15923640, -30937469, -9380337, -33047639, 10514745},
+        {18869077, 1651959, 25671583, 8763645, 3315974, -12007676, -13948885, 12434141, -30079381, 9049077},
+        {-5477552, -5822730, 27060103, 6337943, 13139137, 1816875, -11731808, -3847955, 1536331, 12217470}
+    },
+    {
+        {-18999431, -11170828, 17516509, 13015552, 11763403, -4004143, 3668557, -5139060, 24145486, 9390245},
+        {-32922425, -15442486, -27210433, 1666055, 29956563, -11556343, 18906788, -2460790, -5352900, 10945472},
+        {14336597, 2699890, -22258360, -14585410, 32890825, -12963509, -9202927, -1144645, 14056845, -5317298},
+        {3520780, -13978563, -32017904, 2168182, 13043102, 9982639, -2978667, 13808253, 5993559, 9330799}
+    },
+    {
+        {-27770773, 13871921, 14304586, 3452456, 19702431, -11418575, 16658330, 14006848, -3135825, 2285643},
+        {-2967092, 13692495, -33141156, 9608739, -24765725, 11945791, -18965883, -2485178, -15183528, 5081966},
+        {29858957, -3930917, 23077455, -761310, 15175317, 12154784, -26129730, -11931398, 15871247, -14619146},
+        {-19225841, 5268711, 432073, 3218893, -4248961, -12420995, 3557243, -8914520, -12337539, 8694657}
+    },
+    {
+        {-24430237, 15968947, 7987978, -13852490, 30746767, -16477218, 18236735, 9725647, -26386007, 7836667},
+        {16655228, 8828341, 22329459, -15796275, 24459488, -14670163, -18114793, 2483457, 16806898, 10043292},
+        {-32530964, 10032961, -16631595, -15778277, -28417668, -11448228, 23068576, 2452348, 21009640, -16133081},
+        {-1728445, -6611010, 22734233, 3669131, -11902288, -3076776, 12688623, 16009738, 9272128, -10413908}
+    },
+    {
+        {-19918403, -15983635, 10777238, -1794323, 11258098, 15662588, -27933942, -8001138, 12083282, 9290683},
+        {-33127391, 7033400, -12287308, -5412688, 1438586, 10371332, -30933522, 123992, -12460795, 11283889},
+        {7811778, 3841377, -30967030, -10453661, -32853340, 748809, -18893486, -16399212, 27222838, 8078272},
+        {10864749, 7488264, -19525614, 9425087, -21487004, -10971180, 12598669, 1853499, -33019212, 8083051}
+    },
+    {
+        {-2426919, -14500673, 15619494, 16560431, -3368795, 10815914, 28410255, 3156047, 12146363, -15721246},
+        {-10323270, -14958597, 28132320, 16655372, -33052768, -6341712, -4618824, -12577725, 16383354, 9606423},
+        {32345011, 11336767, 7137596, 10503076, 9967761, 9205126, 15170770, 5225501, 29945603, 6150013},
+        {-24233989, 6116323, -19778317, -1368935, 23600151, 9928745, 3688385, 10268890, 16849339, 5801981}
+    },
+    {
+        {-28808326, -3310430, 33448335, 14099176, -28022446, 11192425, -23840312, -6274642, 32097808, -16134796},
+        {7463869, 15989777, -29772566, -5043329, 31280235, -7037529, -5825342, -7557396, 18872097, -168545},
+        {8528887, 7272645, -20933266, 11299706, -3503414, -16661563, -4615795, -10945237, 4158620, -4860746},
+        {24827565, -11554441, -33309714, -8147663, -17704572, -5119153, 20025980, 5605449, -13757564, 2952941}
+    },
+    {
+        {-20238978, -7336284, -19791523, -14845283, 8355827, -5070435, 7340636, -15027125, -709099, 10618629},
+        {19912358, -5676607, 28624993, 1102670, -11848725, -2667578, 18007421, 1940839, -17808772, 2471405},
+        {25133691, -8803651, 1332477, -6203355, 3915656, 1127776, 3371419, 4797360, -5592054, -12443029},
+        {31165420, 10517409, -9109179, -13481355, -21810433, -3716681, 14830323, -10877465, 16213706, 7928558}
+    },
+    {
+        {2238903, 7606731, 5943206, -13299876, 353544, 10789323, -14045909, -1467951, 11826399, -16481389},
+        {26871041, 5557654, -13390122, -5519811, 4022984, -3247797, 470614, 10235220, 2671264, 4044445},
+        {-33332628, -2017854, -849565, -1409872, -22333737, -6999346, 15597869, -16553165, -13956407, 10818834},
+        {29185421, 1070003, -29967685, 6958608, -23321821, -7609118, -13998297, -15261454, -11766107, -12235666}
+    },
+    {
+        {-11816494, -14706266, -16205358, 14132766, 7012715, 10249478, -24742996, 989794, -4905975, 228872},
+        {16177646, 12399010, 9707042, -15490460, 29988521, -9517675, -22971055, 15374797, -29285972, 2217693},
+        {-18881918, -15004256, 10718902, 2548164, -13211910, -8733463, 30556197, -13677043, 7850001, 5444616},
+        {22070158, 14538762, -3784427, 221688, -20908176, 9328888, -1476705, 9932012, 30259740, 5415844}
+    },
+    {
+        {266387, -11782185, -20794462, -5458308, 9508553, -5045239, 4248472, -13339314, -4474530, 10194409},
+        {-25527519, 6199119, 6382423, 11864673, 28322902, 16059007, -27492753, 7949598, 32253100, 15425332},
+        {26336929, 3649823, -8801948, 13971149, -10932529, -10550627, -23699623, -2063561, -33100622, -3189083},
+        {-9485069, 16348242, -8495448, 6774182, -12400958, 11247945, -14334939, -6075651, 30280484, -12147063}
+    },
+    {
+        {-16183166, -7228157, -32767300, 1551323, -20608796, 14509383, -26039835, 15062087, -18945840, -2537182},
+        {-28069834, -7144416, -3556283, 15356628, 32514472, 14228792, -31291162, 1129666, 21396607, -8149943},
+        {-31963090, -15347758, -699517, 15227973, 12306320, 3618683, -8360410, -7663380, -20415692, 12269551},
+        {20439917, -7158892, -9533506, 9254647, -27119317, -6594346, 12565907, 2708582, 22344773, -16249810}
+    },
+    {
+        {-3219352, 8071195, 23847765, -14803422, -4457092, 12451687, 3527559, -9982739, 28670372, 11826264},
+        {32600654, -2332614, 3990985, 16009725, 3933349, -458790, -32097522, -9150470, -11488326, -2636959},
+        {-16251566, 6716117, -28018743, -1648723, 10023133, 16185196, 16264136, 14014908, 28247578, 8903835},
+        {3386287, 8026371, -15810277, -11583697, -14183310, 10242903, -31153553, -6435050, -8537134, 12000625}
+    },
+    {
+        {2720723, -7246987, 20916489, 6622382, -7792901, -2632176, -3278145, -15793848, 30434538, 13751311},
+        {-32245090, 2568208, -24557429, 8648643, 9767181, 3145141, -13577592, -15663768, 3210254, 16615683},
+        {28908991, 9072215, -10494212, -6094531, 31402054, 12858182, 16730648, -9972632, -26774844, 10098937},
+        {-14633935, 14288825, 12729317, 8279101, -7992183, 7186871, 15148720, -12398869, -17699167, -10643699}
+    },
+    {
+        {-29916358, -3105419, -19222543, 8931121, 30016793, 15586449, -12770808, 13683872, 13604615, 7770126},
+        {3454223, 16704873, -1143569, 7454074, 10565606, -14129046, -32598991, -13249983, -11009543, -16549860},
+        {-30510966, 13725747, 22307703, 7477186, -7078731, 13721691, -13369352, 1493994, 16741910, -4069696},
+        {15313913, 6019154, -16602826, -14660595, 27494982, -6571691, 19594368, 10955192, 32406627, -12225489}
+    },
+    {
+        {-9317207, 459540, 13878620, -438012, 16234721, -4591731, -15692982, 14058897, 33538162, -16507376},
+        {-3915089, 15430094, 25541215, 3720385, -27972400, -16116420, 11037313, -7569626, -25376508, 9570337},
+        {-29474090, -1878966, 13006500, 13123662, -5494225, 14335234, 12583263, 4776078, -10597089, -7449238},
+        {-22599317, -6365700, -32265905, -13401677, 19838294, 6319993, 16235057, 5317379, -13727642, -11902547}
+    },
+    {
+        {-21849967, -15111786, 14836708, 2398579, 5634693, 2167183, -333844, -3218375, -5773659, 7343355},
+        {9765989, 12858049, -28475730, 16386588, -22843611, -5630594, -2021662, -15478457, -9254467, 3440340},
+        {10715625, 7001985, 30730177, 11014790, -18477160, 5461434, -31733017, -8251544, 30391242, 11677424},
+        {6607285, 6842775, -32011545, -2879716, 30960629, -4387998, -26520513, -6890235, 1154795, -16539074}
+    },
+    {
+        {14784378, -4259499, 17234875, -11681653, 208512, -11493084, 15783229, -14786461, 25266799, 4634269},
+        {22714508, -832667, -19469548, 15392207, 6952360, -8338224, 31505889, 4820386, 2295351, -11770780},
+        {3679766, -14262028, 1474755, -9188572, 24798225, 4023400, 3631806, 14293379, -25099661, -9158891},
+        {14769700, -7724375, -24977905, -8117923, 18988710, 11020237, 26976458, -9956807, -6668531, -7178496}
+    },
+    {
+        {31693066, -9131795, -8823147, -5619042, -14250170, 4950726, -9823671, -7046156, 28390251, 2621546},
+        {24285360, 14338626, 4378801, -7663685, -30620923, 11930515, -8398671, 8118624, -26042847, 3471221},
+        {10197321, 2225853, 12068666, -7098555, -32294161, -5974393, -31493020, -3114148, -3193662, -950063},
+        {16679248, 4355025, 28783536, -1330383, 22140764, -6508175, 17153688, 7693815, -14510081, -7786185}
+    },
+    {
+        {21208182, -2551300, 17282548, -12248426, 1715149, -15002505, -31438930, 7991934, -14397908, 3523762},
+        {-25396040, -4918506, -18156690, 14220486, 16744218, 15106447, 28617047, -12851642, 16333221, 514749},
+        {-23810803, -14162131, -30254205, -2356334, 12156524, 13707578, -16496649, 13943664, -22643755, -6814568},
+        {-21336011, -12999934, 17652305, 4705558, -2417449, 6098377, -25610763, -2564317, -16017937, 10753376}
+    },
+    {
+        {3411658, 12124332, -28386817, 6719376, -22729630, -8496703, -18334994, 7991490, 20322207, -4723985},
+        {4160678, -10258478, 2514038, -2487284, -2315390, -5301859, 15705078, 4509136, 27898283, 2136133},
+        {-17991015, 13499327, 23794848, -11714380, -28528222, 12887679, 28249005, -829556, 5384378, 149038},
+        {19495477, -8989138, 3785207, 3606964, 31875373, 5081720, 17645463, 15077696, 21236277, -5387466}
+    },
+    {
+        {-20413536, -1193545, -14583700, 4086912, 32938711, -11340491, 19896244, -678650, -10900652, -15745594},
+        {21499889, -2303167, 30726863, 4230593, -14030687, 12792361, -170808, 11872268, -26501344, -7945945},
+        {2453562, 13711055, 8471300, -4292836, 2722923, -5453384, 30939761, 224909, -22198088, -9527794},
+        {-10860514, -15214418, -32465394, -15913867, 2615154, 2775958, -17396883, 171722, -369881, 1982459}
+    },
+    {
+        {-12185825, -2554787, 28829128, 5081015, 26166735, 15879878, -30451527, 2936932, 13536555, 2775040},
+        {13228987, -13436220, 27992803, 6366871, 7866740, -8454199, 9928532, 1037563, -6988216, 3385837},
+        {-7129461, 2279957, 26016814, -2615412, -11279652, 3948530, 31534357, -11249989, 32417244, -1309396},
+        {-1022775, 5338906, 12599792, 15965994, 4740245, -11886262, -22864219, 13157362, -27330919, -157136}
+    },
+    {
+        {12814676, -246920, 17410489, -8420355, -18600759, 3692751, -5991105, 10702693, -18979354, 4744087},
+        {-7688338, 13358549, -11701848, 12158266, -9325355, 5060063, -23784744, 14343544, 3125361, -14146767},
+        {-23105139, 16432121, 30608097, -1012253, 23310229, 12930360, 14258316, -12917519, -32951046, 874151},
+        {-29569443, -2971292, 31618079, -1126569, 19674950, -7549900, 32773874, 3379021, -16633999, 11411489}
+    },
+    {
+        {33173176, 6660884, 22764544, -7368012, -21809869, -5972414, 27225974, 13912125, 27684304, 6307249},
+        {17772420, 183384, -14247937, 7816594, 33536699, 4773104, 23883777, -15098759, 1067325, 8071019},
+        {18512770, 16487502, -23486477, 5722085, 7523523, 9537765, -18704052, 8296594, 20667853, 4901777},
+        {22756507, 6373954, 22858632, -3678541, -20844150, -8617210, -1800613, 6372379, 20506362, 12372860}
+    },
+    {
+        {5532012, -340994, 25059746, 13639560, 12231510, 9041666, -28275562, -11021918, -21026358, -9452177},
+        {-25981035, -5948205, 18797535, 57426, 32547549, 3247480, -1414203, -11605889, -25503965, -8019541},
+        {13828976, -14395529, -15645678, -12779414, 11746247, 12812621, -203191, 9931519, 21809952, 16471493},
+        {-6335670, -4989164, -9997896, -7777442, -27334431, -11854689, 16402670, -15096232, 30546931, 15341598}
+    },
+    {
+        {22648833, -8996405, -11708396, 9003395, 22665193, -9332235, 31116065, 1076707, -9944087, -12474564},
+        {-28974050, 16615436, -19736958, 4731655, 3024658, 12286013, -1379675, 13768435, -26974493, -7095889},
+        {6497923, 8144333, -483955, -7677284, -33239729, -48829, -2030226, -10633297, -12993701, 4861388},
+        {-31220343, 10671768, 21990393, -6005345, 16689496, 8425332, 2652331, -13117491, 31139933, -4783670}
+    },
+    {
+        {-8264572, -10422279, -20920295, 14062980, -24354274, -8400498, 9265852, -280384, 8722195, 8524304},
+        {-32041794, -11539196, -25242566, 2174117, -10785065, 1413925, 32384700, 10768198, -28241158, 8732774},
+        {-26317322, 15033668, -17454114, -12723660, 7520534, -16152430, -26716105, -11014864, 6887151, -8166386},
+        {-1212426, -2952651, 19350028, 1479565, -2850740, -11376583, -14014097, 15770258, -28381626, -356200}
+    },
+    {
+        {22810076, 5618073, -11296164, 2056147, 10996227, -2675371, -24609420, -2906519, -8859086, 3817496},
+        {224805, -13656693, -20879546, -16482387, -31700082, 16118188, 6084761, -3596103, 7062211, -11332012},
+        {11375437, 16225428, 19914443, 9764723, 26026723, 8697607, 15608919, -1672648, 1560172, 10412188},
+        {21276098, -869819, 2310268, 5850656, 24124345, -2723794, 32150760, 13863930, 477084, -8668155}
+    },
+    {
+        {20528689, 16603393, -33078675, 11942881, -4646717, -5433790, -9984842, 1920544, -19187855, 14666189},
+        {15414707, -1614263, 2549702, -6837689, -21764718, -2943780, -14981992, 2640745, -27615566, -16111053},
+        {6082670, -9406515, 17465194, -11943227, 23317506, 14021872, -29907757, 5260103, -800739, 8289406},
+        {6982054, -10609728, -19111180, -10747183, -11106042, -5450638, 13363898, -1599977, -25657241, 2878608}
+    },
+    {
+        {-22629961, 229758, 25079447, 9797677, 2691674, 13467101, -5012983, 12771768, 15171256, 7335189},
+        {-3056771, 12419697, 8379644, 15390632, -30914836, -8045937, -20580988, 11512723, -29803515, -5176045},
+        {2316874, -11803495, -2467460, -2731509, 18189135, -15776129, 17011862, -6957588, 6650818, 1593397},
+        {26503488, -11716747, -5399992, 13254776, -19439553, 15289281, 25477457, 1226096, -1857699, -4387394}
+    },
+    {
+        {17239681, -7345060, -17462017, -14232290, -29586161, -6311562, 9885793, -13935962, -7461225, 8256152},
+        {13938378, 10175018, -14458032, 9973635, 25944703, 14910282, -31567220, -8308992, 5301364, -8670080},
+        {-20425364, 2867889, -6652970, -6214972, -28937954, -14672119, -5797048, -13559646, 8565886, -752095},
+        {-26612563, 5871837, 22466518, 2618806, 14641522, -1905423, -20308994, -204762, -3176494, 13009366}
+    },
+    {
+        {-2076296, -6172588, 31145511, -1778929, -8948471, 6414047, -22813885, 4799517, 2538181, -10124191},
+        {12649670, 8922097, 18081964, 11860181, -2130363, -9745074, -4574219, 8245110, 12454793, -9226891},
+        {18198046, -4423498, -2180270, -4304906, -32124492, -4336060, 16324496, -3939535, 13140231, 15112698},
+        {-28240332, 13489736, -21281958, 2997339, 5049145, -13733108, 509931, 623861, 28092403, -8999719}
+    },
+    {
+        {25381342, 12431078, 15594946, 1906218, 8713078, 4440451, -15071822, 2500075, -4324492, -8935974},
+        {32148246, -8724470, 23792228, -11971234, 11763485, -12119262, 25855787, 2902420, -7745162, -6354109},
+        {-15676749, 8125557, -11652343, 15291402, 25116403, -762285, 4751387, -8541717, 15892338, -11273528},
+        {-14340328, 8051896, -26841662, -11626110, -32491465, 6925901, 29783568, 453620, -5543249, -3932920}
+    },
+    {
+        {-31920331, -16159727, 11843970, 5868742, -2584959, 8124961, 5043223, 2184723, -14872929, -11907314},
+        {-509126, -701717, -24169881, -9598958, 10958868, -3106371, 32729788, 16157835, 482652, -7763660},
+        {33014271, 5627082, 5322687, -202842, 5840596, 1568634, 23105544, -10933566, -9308466, -4447784},
+        {30098234, -13038554, 12396268, -5700233, -16684332, 6836471, 16711468, 11710752, 3896686, -2488352}
+    },
+    {
+        {-4309191, 14625061, -24300438, -14372971, 10276974, -8997508, -13974907, -7651223, 10189497, 9564300},
+        {9429804, 15718645, 20533802, 12711911, -31394073, -9053108, -31702817, -13330017, -6246028, 11678379},
+        {-9688469, 10604144, 2000126, -7337068, -11601658, -7320627, 21842860, -1318640, -9595813, -6382877},
+        {7391517, 12292168, 31807225, 4220655, -30812342, -16532116, -10905291, 4926643, 30828575, -11817082}
+    },
+    {
+        {-23982526, 9502210, -10277481, 7486492, 32587550, 15183602, -20457002, -7615015, 2191696, 12178667},
+        {16845843, -2969973, -5888924, 7361452, -3475761, 4121258, -10253039, -16046022, 31941394, -5640109},
+        {-30427843, 15361071, -13960118, 8802935, -31458404, 10424235, 23309410, 10770437, -33184465, 16527627},
+        {-30519903, 4439031, 21210736, 11093196, 2732283, -15589745, 33164403, -5109590, 12577154, -11090103}
+    },
+    {
+        {-12256109, -10396856, 28146960, -8570969, 27061161, -15254684, -26129452, -1413174, -6741310, -6904171},
+        {20621044, -2159616, 6941118, 8570624, 29326689, -14316050, 14202156, 14104117, -7113589, -11413593},
+        {11686938, 7499049, 30417014, -12932749, -12882243, -13897529, 15488101, -2726183, -28160460, 5012962},
+        {-18012177, -8583674, 15788078, 5821659, -24740829, 9713726, -22826941, 9057583, 14892931, 11213610}
+    },
+    {
+        {-13810429, 11054891, 32730644, 10723293, -5196680, -2456247, -27669637, -4607453, 27378811, -14855127},
+        {6560632, -11232389, 158532, 12495958, 27042567, 7141320, -15011292, -6245716, 2191709, -12809530},
+        {-24609304, 1241774, -30268173, 8127207, 5747059, 405494, 28795472, -12983962, 29132410, -10513749},
+        {17455328, 8168321, -10438435, -11060030, -6147886, 14596094, 23591929, 15855257, 24382894, 9752262}
+    },
+    {
+        {27161470, -15550578, 19586495, 1709737, -22703238, 15931498, -722954, -10934927, -19981589, 9835436},
+        {1320936, -6191213, -15253150, -3733273, 8397643, 519609, -12814239, -11092637, 17490681, -11757145},
+        {-24849834, 9808821, -10687232, -9517633, -11181295, -14788513, 13898710, -13280570, -10084393, 4112257},
+        {26443646, 9292907, 10378161, -6970088, 28300286, -9671753, -18684113, -1830235, 1419776, -15876376}
+    },
+    {
+        {5339888, 3299101, 32514779, -10754273, 28654048, -3903434, 8319113, -5221986, -17174437, -10372108},
+        {24809972, 7998436, -3894149, -12102959, 24238620, 1832170, 480852, -12195424, 16587490, 12767360},
+        {31576997, -2799665, -7169251, -11541037, 20433518, 2683612, -7189494, -9904085, 8298444, 9336644},
+        {-6826869, -13355640, 19125050, 13603793, 21593967, 2632272, 27066022, -11779649, -25008452, -2227436}
+    },
+    {
+        {31020234, -10668477, 29763149, -473379, 21817163, -1662571, 21119776, 8512648, 29371792, -6059574},
+        {3366514, 10718286, -20491030, -117407, 32143127, -13529453, 11213574, 3355156, 28367764, 10261730},
+        {2504091, -11299924, 27191676, 2263779, 13588234, 2829750, 2861601, 1513276, 970045, 14847949},
+        {7000958, 10592285, -8076453, -3227595, 16790518, 5467467, -26683830, -3289638, 23793414, -3997989}
+    },
+    {
+        {14946111, 79738, -766665, -9489700, 17488456, -6043928, 4695036, -4702194, -33326435, -12380883},
+        {4911431, -13603328, 26041218, -10498213, 11321718, -1255861, -30969395, 386479, -28068414, 427274},
+        {-26392578, 6103129, -31849257, -412153, -7849567, 7024092, 14231690, 12560487, -30474245, -144464},
+        {2584520, -7115283, -13316275, 12436436, -21143648, -15692287, -25024185, -16165811, 25136131, -9444007}
+    },
+    {
+        {32722101, -10677060, 3620510, -14844400, 27852749, 10688393, -7131181, 5803344, -51189, 11918543},
+        {-27309696, 4961319, 7121812, -11807564, 11339447, 15942873, -13599440, -1307567, -32891369, 13182118},
+        {30558930, 4143472, -24062139, -4805710, -12203203, 3017956, 23153726, -16031627, -12532890, -3261412},
+        {-30454885, -715810, -10491357, -5512535, 33469056, -12015396, -13961831, 16022055, -112945, 1998282}
+    },
+    {
+        {16996086, 16006560, 8524215, 16687654, 2898718, -14124946, 13029018, -9726358, -27474962, -11151396},
+        {12190321, 6987451, 31221491, -9250329, -16338050, 16342036, 23044228, 5115530, 30879808, -1185411},
+        {74108, 468246, 31010152, 6560731, -26153104, -9029834, -15711508, 4786240, 28459588, -10178071},
+        {29815497, -6363128, 31614757, 2018290, -18513658, 6378990, 30872215, 3736011, -5012068, 13474803}
+    },
+    {
+        {-28687479, 7971645, -7575482, -8537725, 24166148, -15144259, -31721032, -12088096, 7861221, 127291},
+        {-4106767, 11045658, 30005340, -5711947, 3691284, -3058641, -24819344, -8453890, 22044995, -9459946},
+        {6437337, 11300583, 21809054, -4425066, -4074713, 11800905, 32185802, -4367943, 7991588, 5888674},
+        {19314473, -12909601, -22953895, -216488, -29397857, 14152277, 12728506, -10379382, 12145288, 4668107}
+    },
+    {
+        {11795742, -8926078, 33043594, -13933184, -978584, -2940939, -5778290, -6032337, 25224498, -16172485},
+        {-21422264, -7618263, -33037514, -3491649, -23638184, 4369067, -18980804, 219959, -11776793, 6803958},
+        {27752606, -5733476, -7558057, 15845091, -32599035, -5280467, -17426788, 4071958, -23667728, 15236314},
+        {26715881, -10882983, 1317566, 7616864, -16061606, -16490816, -19162087, 16522923, 6516411, 1567131}
+    },
+    {
+        {16254731, 10263554, 16915304, -3296161, -6089131, 13452359, -26302419, -9367841, -4223965, 8889644},
+        {15592104, 10320324, 14564190, 14897832, 6662581, 1032817, -22413379, 7256423, -647809, 579811},
+        {9814365, -5747966, 12000480, -1194591, 187909, -9416428, 4773170, -11627987, 20418674, -6926475},
+        {26820866, 11679032, -21072689, 5008446, 3799422, 8557263, 9266863, 11537582, -23506887, 3806325}
+    },
+    {
+        {-28892161, 7176536, -14444019, 4153293, 14131757, -5665251, 20565461, -12045731, 14413832, 3318275},
+        {32364541, 885186, 21474106, -973006, 28784504, -1749407, 11846911, 15116433, 7433411, 6446446},
+        {15662417, 532983, 3841805, 2692168, -17496871, -6550038, -12915993, -16747307, 9677252, 9777971},
+        {-3723745, -14177284, 5618287, -13108445, 32968939, -16067144, 25687285, -16681127, 19014693, 7638847}
+    },
+    {
+        {-21530396, 14064214, -26563350, 16477098, -6369375, -15231836, 27232742, -9876740, 6068882, -5326434},
+        {-446209, -6245749, 2961065, 9899977, 27616367, -6979872, -27549136, -11510161, 20473880, 1827442},
+        {3705385, 10933730, 11564103, -14777296, -14176268, -11024875, -33030753, 9116343, -11752584, -7170228},
+        {-13025013, 14541537, 3098497, 3517554, -4751133, 8308075, 2938907, -14760543, -25996861, 14888911}
+    },
+    {
+        {27144286, -1523853, -13767701, 6073095, 19121582, 2161996, 30802070, -1226756, 20483437, -784063},
+        {-22745391, 5799993, 18232076, 10524811, 31575080, -3636272, -6284289, 2811856, -13501598, -16014298},
+        {31038691, 3744347, 7165876, -5388055, -23908849, 6100543, 5718828, 465966, -12596849, -1149136},
+        {-20668198, 2269788, 15742863, 6831622, -22079597, -16406659, 22995513, -6187775, -1997375, -8046002}
+    },
+    {
+        {-21196553, -5335174, -5822022, -13206216, -25136086, 9907905, 21645608, -5083084, -8674497, 12907991},
+        {21033461, 4332227, -32054816, 1420247, 26812221, 14452719, -3248738, 12289094, 22640705, 9639868},
+        {-3584542, -79907, -27606781, -5499884, 349409, -14382739, 17840377, -14957301, -25917315, -4593346},
+        {26224815, -1984916, 8281186, -13071788, 21873332, 9835387, 12567458, 16619744, -11729229, 15291018}
+    },
+    {
+        {-2123640, 5621328, 13262754, -14292460, 8804857, 16064009, 15813628, -10871883, 14530637, -1515285},
+        {-15518448, -15773633, 1273700, -15392099, 31952635, 3673115, -19979115, -10484278, 17587945, 13955832},
+        {13049921, -5271163, 15315741, 4992361, 12391234, -10256169, -16861247, 4876775, -18379368, -15638952},
+        {-25611997, -16147780, -30637399, 14783071, -4036291, 13973591, 7614915, -14050178, 1824642, 2032783}
+    },
+    {
+        {2411859, 32230, 25778118, -12643198, -15100919, -8762741, 29101935, 5983614, -17851165, -3192527},
+        {3341751, -4689611, 22354292, 7924581, -27083650, -8153817, 14362489, -3658267, 27816823, 1892742},
+        {19958631, 199884, 25224999, 8723583, -15400157, -14374158, 16630841, -14158131, 8357497, 15998163},
+        {6373225, 9921678, -23492453, -7871688, -14213489, 16317320, -17261198, 3880065, 17126349, 12396709}
+    },
+    {
+        {-7494826, -1961403, 32859452, 1054578, 26532391, -7713367, 18328139, 4967441, 16544633, -12553921},
+        {19911463, -5674764, 17898879, -1707783, -4005753, 13623886, -20561914, -1106220, 27346208, -5043653},
+        {-16347811, 1693335, 21852483, 8673798, 9437953, -11470058, -8812778, -6476744, -1113967, 10620529},
+        {-27625009, -12333110, 30623910, 2191264, -24436913, -12888913, -20627349, -9481631, -4496174, 10609666}
+    },
+    {
+        {-7827603, 901659, 25074786, 14081289, 28244065, 11007505, 12990632, -6736131, -11570934, -8865433},
+        {21451716, 2278981, 19522959, -4284498, 24982393, 7058745, 9566814, 13048789, -20487144, -5296677},
+        {-22803824, -7608050, -27830706, 9678785, -1722543, 6914535, -16849752, -13004540, -32156003, 4264910},
+        {-15451696, -15691076, -25218991, -10010422, -21376389, -3785069, -9454992, -12455719, -4669657, -7604365}
+    },
+    {
+        {-2844848, -4879279, -17786179, 15521705, -9986347, 13274090, -24028334, 21851, -10853101, -7637510},
+        {-7435086, 8411257, -27388814, 6050514, -8602231, -13301291, 16025194, -882630, -6785475, 10643569},
+        {24312282, -6499929, 23867150, -13783487, -12993944, 5947409, 30462905, -13076632, 7730012, -6128570},
+        {15376468, 9547844, 5253761, 5804229, -21047992, 15136111, -32408814, -5953161, -5384629, -2679068}
+    },
+    {
+        {23603871, 8316558, -5442272, -2397891, -15292935, -4379979, -19972698, 6843689, 23765692, -10368594},
+        {-6182882, 9103430, 5532979, 15900320, 26570853, 11792322, -1759197, -4385493, 16905120, 4900170},
+        {340796, -10508468, -30600647, 11746119, 27146372, 12180460, 28761037, 3595991, 10963088, 2786889},
+        {-13899306, -16651648, -12855939, -16656553, -32699074, -9793644, -8269343, 561075, 899217, -13973375}
+    },
+    {
+        {26745329, -13311082, -15117761, 10771582, 6151103, -15523349, 1860530, -14037734, -22700222, 8273162},
+        {-3082820, 13100424, 21199766, -3147098, -25773346, 1176223, -31506496, -10742382, 31690006, -13866773},
+        {9479016, 16118807, -16244799, -15076781, 30527903, -1862283, -22820909, 2060819, 12530232, 14190948},
+        {-25886111, 12240008, -3635732, -15825313, -276841, -6828385, -32157645, -13403260, -7294863, 2620522}
+    },
+    {
+        {6218089, 13370882, -10064237, 2892392, 2702284, -10269239, 6571830, 3810939, -26506167, -5194206},
+        {-21202382, 13484998, -8341851, 10944404, 13735932, -16352719, 7274466, -12780311, 23472453, -1580092},
+        {29428963, -14797914, 8275206, 6143379, 7986176, 13371028, 12370116, -8209820, -6442104, -13940914},
+        {33292425, -13540065, 20611706, -4515842, 28787884, -416734, -8096470, 3935064, 8466991, 3797523}
+    },
+    {
+        {-31467965, 7971652, -19119640, -11866580, 29678689, -4207376, -4682900, -1696407, 29686385, 8000371},
+        {-27475560, -15626651, -6227684, 12100713, 18743637, -12754874, -30841984, 1050406, 29156592, -9761942},
+        {-18603829, 195641, 6568300, -6212493, -11654523, 1813494, -31860759, 5279424, 27862845, -11296566},
+        {9590062, 8663534, 11715088, 13944902, 15128, 11940735, -1650188, -9285340, 6583396, 16158545}
+    },
+    {
+        {1106569, -8431191, -15079632, 15450681, 4617771, -2577793, 33305464, -9171043, -6151126, 5767538},
+        {-3989328, 2071855, -2799567, -16552395, -23210989, -12672126, -8872869, 13018896, 19774515, -10116551},
+        {-13943484, -16652643, 162829, -4635633, 9423902, 13633668, -23530018, 5188047, -19786429, 4984882},
+        {-28542694, -12655972, -12445444, -5011678, 1750357, -14882315, -31901976, -16157816, 32890566, -13103328}
+    },
+    {
+        {-20061108, 4749150, -19482762, -4225908, -24808324, 10579442, -8147956, -2896694, 10184157, 1989394},
+        {-4381220, -204484, -21152781, -15248652, -10331000, -298974, -16279579, 15225349, 28962102, 9579499},
+        {32642720, -2155046, 11987716, 15477107, -33165160, 16340117, -4125677, -10080089, -4291241, 5789728},
+        {6307022, -10525905, 24982149, -16001838, -33192800, -10684358, -20499107, -11237407, 4175995, -13149993}
+    },
+    {
+        {758170, 10495546, 28596406, 1820807, -16434291, 5850544, -1527886, 3974608, 223623, -5204844},
+        {-9789873, 975909, 15048863, 4717201, -23978891, 844754, -14116064, -3579200, -19852497, -157275},
+        {24918637, 3981406, 14342562, -1220030, 28921919, 9177444, -7166414, 5527181, -21072518, -1855539},
+        {-24367599, 16295138, 2501108, 3665923, -27383809, 1191494, 28493178, 1906286, 29092569, 10399521}
+    },
+    {
+        {16343411, -15425500, -8329058, 9733349, -23756499, 15815513, -9849521, 7523819, -1489834, 12517859},
+        {-2938519, 641323, 26770030, -5108393, 21183870, -5222717, -18675956, -2125690, -15910064, 14671239},
+        {21262570, 16197265, 32132336, -6548867, -9533711, 6177284, 5122525, 3300943, 32691641, -12543436},
+        {-10194325, -5946734, -28867114, -5716641, -25119561, -225803, -19528645, 8055144, 7808516, -12852547}
+    },
+    {
+        {2052630, -6852690, -32790850, -4844117, -19850439, 8570287, -20747631, -16269708, 9907486, 9992641},
+        {-31019111, 12604823, -22682732, 15091185, -7031978, 14071423, -10382718, -10822969, -133679, -2311223},
+        {32073340, 12437994, 7113336, 13768386, -8662404, 10181804, -8074921, 10667244, -3253704, -6247966},
+        {22464508, -11527484, 30571775, -5776796, -15474328, 15531974, -25646887, -2787110, 29676602, -2836014}
+    },
+    {
+        {-20982037, 13903392, -4334017, 2291630, -5702804, 13011870, -7933233, 6798203, 24065543, -5428292},
+        {11718479, -12822401, -30964316, -14366096, -19830382, 10213927, 22628293, 8023814, -19297657, 9951312},
+        {15183960, -13630033, -23780359, 8660952, 32058755, -6311727, -17520890, 7282744, -20347601, 13220383},
+        {-27260297, 15383415, 11772182, -1752995, -6608345, 3895736, -22821643, 1068492, -29311166, 14299622}
+    },
+    {
+        {8998141, -4564995, -18215540, 8866003, -25819211, -679003, 26471166, -9188212, -26820734, -14876506},
+        {-8145601, 16718507, -21041899, 15630720, 15882465, -12095832, -9238398, -13378838, 4738888, -14328936},
+        {-29483640, -14952983, -7745206, -3893739, -680149, 3533706, 15387444, 5931172, -23410479, 7409937},
+        {-29605344, -14323037, 19217001, -8069455, -16082931, -1756700, -28677314, 15109191, -22649054, -4004668}
+    },
+    {
+        {7726319, -6287524, 12498130, -11655461, -5109272, 7797158, 5854222, -208796, 27841945, -7436064},
+        {-31662015, 16737614, 5558811, -5808654, 12181761, 3505123, 10894390, 5748694, 11789872, -4520168},
+        {7279220, -5389611, 9811890, 10498924, -8669483, 4039189, -32069970, 5764583, -13185918, -3475662},
+        {-16596009, -8127275, 22016718, -4388996, -26522000, 10891149, -6194067, 3163140, 27879693, -13891721}
+    },
+    {
+        {-27833041, 4885237, -6495482, -6851664, 22425049, 10970622, -23204850, -7821008, 30304054, -12031847},
+        {-9305654, 10391070, -22893711, 5246067, 25387014, 13941011, 2927301, 12868737, -7307211, 7075962},
+        {-22035728, 6268195, 4922923, -13887608, -31218318, -8994240, 22584404, -4025705, -6813776, -11037516},
+        {25760516, 2921372, -9245508, -10851044, -14636094, 6761634, -29933672, -2968803, -17439080, -16144548}
+    },
+    {
+        {20295301, 30030, 20979594, -9399228, -25389069, -16528122, -27401177, -14837139, 29802868, -2140182},
+        {-5001024, -15427441, 20033111, 3699408, 22679457, 14742932, 8856464, 7981670, -16319621, -16774844},
+        {-30187384, 4862805, 9503502, -10544382, 15015881, -12324039, -33033776, 10187642, 11644479, 14288507},
+        {1047054, -3201391, -9331200, 16292609, -15337669, -8905476, -5167266, 8692724, -6936140, -1695907}
+    },
+    {
+        {-14462259, -12330204, -7924187, 7560086, -12713804, -13302254, 10692393, -6324732, 22771421, 510328},
+        {10972736, 9411773, 27713849, 10699702, -6501808, 5592069, 5348774, -7025701, 5992580, 6012539},
+        {9685593, 4913453, 29565038, 3970279, -29369379, -8398639, 27388901, 9750890, 22378240, -9481612},
+        {27406859, 9499004, 28220537, -16214394, 16142723, 8582937, 18156243, 8115185, -6857590, 5618853}
+    },
+    {
+        {5452346, -15849919, 22900605, 9111043, -11733341, 2682096, 3152338, 1496384, 21083060, -16281763},
+        {30405366, 12858924, -2235024, 934228, -30281582, -5576207, 32426638, -8192163, 7283390, -13357264},
+        {-4653015, -3364778, -23035729, 15786454, 17824237, 12667028, -15669896, -29927, -28662120, -175806},
+        {33189812, 13818255, 19759740, 3986861, -19075904, 13203499, -24071307, -2806763, -28135234, 12690842}
+    },
+    {
+        {-5853002, 2782498, 23338286, 14010606, -909399, -8089165, -25431338, -7310278, 10579841, 3054132},
+        {10915270, 292548, 32721523, -10169936, 32920954, -5023580, -12581587, 2009112, 25932260, 2245193},
+        {-19361713, -10840455, -26387081, -1689594, 17322819, -13220443, 19708394, -8470932, 5619986, -15550913},
+        {-24406507, -2505678, -26414612, -13442271, -25925820, 12752660, -8446146, 15751707, -13951320, 9620342}
+    },
+    {
+        {16429294, -7456442, -11525256, 7376425, 28803235, -2068826, 28254457, -15399595, -19347016, 4301550},
+        {25244851, -1436882, -16704232, -14409877, -33157602, 12848642, -7440822, 1379723, -1842805, 5990712},
+        {5518335, 6019227, 32152975, 14091165, 4949007, 11452277, 14798149, -7829991, -20602647, -13403476},
+        {6348002, -7164168, -30351387, -12853853, 8117651, -8569405, -7834570, -7121549, -29248727, -11281578}
+    },
+    {
+        {15560488, 10004174, -7880044, -7250015, 17865089, 4486271, 22607588, -15674324, 19073045, -4323265},
+        {-7845148, 10693573, 15011220, 11233518, -21291323, 16119132, 27991434, -441799, 5553569, -8027021},
+        {-32812535, -3503887, 15505440, 2907764, 32827822, -1028805, -25772844, -8468017, 15885114, 5515624},
+        {-707559, 14038989, 10299363, -14313248, 21282143, 4262871, 28184259, 9152049, 15648440, 12052391}
+    },
+    {
+        {-28371351, 9261893, -6753140, -1278747, -28571990, 2403091, 27822723, -7390561, 16852015, 11171824},
+        {31222470, 15236782, 14148705, -11851205, -16199444, -7634191, -5208283, 8665776, -18136495, -15410940},
+        {-8260416, -15912469, 15709014, 14758484, -17713071, 16096874, -16190523, -3030096, 7845581, 13058978},
+        {470368, -8282043, 12317227, 4671742, 27293020, -8976996, -16198910, 12219546, -15229369, -13513562}
+    },
+    {
+        {-10717728, 16381947, 29468971, 9280965, 5168877, -14212030, -15630027, 12289420, 19829261, -4676548},
+        {5441985, 4945271, 12320047, 13761983, -24104389, 5160763, -10590136, 1350410, 5479932, -9402456},
+        {-22661790, 9182263, 25580403, -13584654, 14396770, 6872858, -25658730, 3530414, -11141477, 6189783},
+        {-31093558, -12632731, -28463718, 8670473, -19387475, -1311419, 11416659, -14465698, -14243827, 12838955}
+    },
+    {
+        {-10779157, 4303032, 19979955, -2874496, 4408686, -6361404, 26623843, -5784238, 9601870, 14390328},
+        {-28564548, -7036331, 25005765, -6286156, 7069269, 12800544, 10300765, -11609335, 2502184, -5306213},
+        {-12451356, -16069113, 14350621, 16130318, 16812435, 6313641, 26727116, -2271200, -15615889, -1217008},
+        {5234047, -11272739, 866885, 2465390, 13964357, 8931676, -24248163, -16172554, 31733137, 6590070}
+    },
+    {
+        {-18894012, -1232358, 17084909, -7156569, 24808051, 16528026, 31332432, 9237311, 14983590, -4723621},
+        {-25560953, -3666375, -22857885, -2598566, 21348985, -10609382, -9842570, -1629282, -26552390, 9611839},
+        {8137670, 13860642, -19391096, -6367742, 1440286, 15061109, -13236000, 1498422, 2747415, -12988077},
+        {27032997, 14643620, -20827587, 8369407, -6973820, 8535446, 9048457, 11351460, 13764317, 13897515}
+    },
+    {
+        {-31453487, 14176848, 3829784, 6559981, 14021251, 3037618, 13371950, -10687198, -29149061, -7070275},
+        {2965135, -14474450, -7588249, 11669370, 17493725, 535068, 26750817, 7296446, -6767289, -11743601},
+        {-30623115, 12889665, -13651798, -308473, 19292232, -15044282, 24206410, 15867331, -20501817, -11548721},
+        {3529622, 7495391, -550024, -16359304, 30973315, -9275907, 14934232, 9292068, 14785745, 2223442}
+    },
+    {
+        {-28558733, -8166148, 19738333, -1238809, 27579843, -15899141, -25063472, 14407588, 20807416, -6392423},
+        {1287130, -15670119, 26351488, 15036326, -13212685, -7005823, 26987169, 15595931, 9496501, -11018817},
+        {-7003048, -9207259, -5885517, -11721880, -14620021, -9838060, -8951388, -12850136, -30614310, -1992642},
+        {14417899, 4587356, -24194632, -7565578, -10679523, 9646265, -19057271, -10994462, 5751942, 6261487}
+    },
+    {
+        {11391760, 484393, -16149770, 12893315, 27043369, 1491413, -32689681, -8314199, -33438508, -8787883},
+        {-12366653, 768102, -13272633, -2170468, -22396364, -3603143, 1275807, 13162304, -29980108, 6610183},
+        {32274902, -10393768, -16579234, -15658173, -33002894, 12019314, -15392269, 15917732, 26169843, 2995207},
+        {-31562048, 8290558, 25293478, -15730441, -9077134, -312923, -11595202, -10573566, -20339677, 5067275}
+    },
+    {
+        {-16160673, -15339289, -8406784, 4681934, -11574389, -11426493, -4612802, 3623752, -23649632, 5875587},
+        {32338119, 6991358, 17826870, -15212365, -21228994, -6953847, 6364838, -7576429, 17585240, -7683360},
+        {-9089095, -1202001, -25178742, -16112269, -9875365, 9567192, -3093395, 13999648, 28822610, 11120439},
+        {19570825, -2612867, -26884776, -14462286, -1054759, -13968751, 1877153, -7909466, 29170943, -7078688}
+    },
+    {
+        {-30557655, 8131949, 3923487, 8089578, 21932560, 9829419, -14361708, -5585421, -10610952, -4432742},
+        {20526740, -7228310, 13800616, -9003494, -14902271, -9850508, 29157363, 10374161, 18156680, 4072293},
+        {-14894508, 7978629, 25530204, 1956148, 20407700, -12142452, 30992023, -13405334, -32610458, -90088},
+        {13337422, 11369053, -24404648, 7313456, 1703231, -13885259, 11705947, 7672367, 24101431, 1982023}
+    },
+    {
+        {2203255, 1194538, -12640839, 3265167, 26667346, 12724443, 26665217, 13417330, 20981473, 15701013},
+        {12075952, 1997177, 29903827, 9225597, 9287432, -7655066, -31573408, -10676794, 28952270, 10602639},
+        {-7769081, 6582294, -4056006, -4688728, 13875860, 15583958, -3718781, -5576446, 18119066, -14526558},
+        {-1466863, -5426096, 12492447, -14398000, 7575983, -8001000, -28972930, 1122238, -17268448, -984539}
+    },
+    {
+        {19710300, 15678429, -16192871, 628624, -32382331, -6831469, 10827965, -6201999, 24282609, 2193490},
+        {9618063, 6628014, -30332873, -14768933, -23268572, 8794356, 18998947, -1813665, 21708575, -6392108},
+        {32335458, -1509007, 9027940, -12947681, 7292180, -10733117, -29768965, -12989502, -19057395, 11937982},
+        {-2522794, 11736799, -19753479, -16358355, -21539134, -11395866, 7306991, -15296189, -17880547, -11890536}
+    },
+    {
+        {-29102029, -14823967, 9817418, 14362709, 15187273, -10808482, -28173625, -13144646, -31460987, 20083},
+        {-318674, 1483994, 32842212, 8184903, 27406727, -14111648, 14390471, 10221217, -450688, 8507398},
+        {-24910148, 893584, 23713223, 8849130, -31870443, 885327, -5410544, -12042115, 21534181, -11917688},
+        {-9232344, -11465895, 13210907, -8248430, 4367979, 14881170, 23959969, 7758776, 3617483, 10263555}
+    },
+    {
+        {14296309, 14412295, -19531307, -15184054, 1218268, -615611, -10938291, 2235243, -354676, 3337837},
+        {31916425, 14167857, -32690565, 13685883, -5163036, -7940753, 24087208, 8189639, 8663267, 13535556},
+        {14557052, -11334262, -6201014, 403314, 11617976, 16358956, 11122653, 9862636, 28413358, -15267874},
+        {-31395342, -11830616, -28579412, -16610808, -28746758, -1494008, 24565908, 9486511, 9541809, 7461811}
+    },
+    {
+        {-1184633, -7927137, -21170556, 15395689, 8207613, -3556409, -3934200, 13661850, -31024241, 4114187},
+        {-11077986, -5261640, -25005083, 992308, -21965708, 5552682, 4678607, -3590485, 33298411, -12641608},
+        {-14653641, -5275204, -6039872, 4029970, 8273718, 11149791, -16326584, -3362092, 21129861, -1567401},
+        {-31196920, -4808299, -27828624, 16490096, 8698253, -2989688, 16658745, 4633167, 2655075, 13737773}
+    },
+    {
+        {29189860, 1179051, -27480073, 11292518, -22500762, -1641316, 23857577, 7750289, 9438100, -1774559},
+        {-23345952, -12757658, 30718321, 10518218, 12724251, 15335438, -12205594, -5938068, -9077005, 6177523},
+        {-20414010, 11347283, -8643667, 1420034, 20835922, -16114101, -20547747, 16118598, -27463893, 10439243},
+        {-1598079, 9863438, 11825915, -10828672, 16267571, 2099800, -2675568, -8321112, -6189311, 13290752}
+    },
+    {
+        {-28997947, -16540073, 24194676, 15037334, -8611829, 4774488, -21536771, 7466708, -9808846, -1476262},
+        {-25788738, -12810362, 32066529, 14327719, -22640920, -16538600, 639996, -12070204, 7966979, 14073881},
+        {-368138, 6070675, -12781103, 5772198, 12532092, 6792832, -5651922, 11831059, -27198793, -3201394},
+        {-21252738, -13810554, -22356169, -15782216, 31390436, -16427225, -15452773, 8970351, -5396757, -11419877}
+    },
+    {
+        {25982890, -5253089, -2903463, 2663780, -2152601, 14524751, -17430262, 15784644, -8201561, -5643826},
+        {-14871080, -7305440, -17905240, 7176969, -2344041, -13971653, -24078669, -5364832, -7932705, -8223202},
+        {-25250031, -2063454, 28172289, -2038595, 31921001, 9182057, 9717659, -8645420, -17841453, 13698645},
+        {11852697, -1722233, -5032597, -4281073, -17669892, -4131884, 11265314, 14985103, 28077312, 2343390}
+    },
+    {
+        {10502514, -9337975, 28324177, 1501004, -10275910, 10163137, -25997893, 2719882, -21969779, -11030401},
+        {7248430, 16273729, 21593192, -4026353, 25960131, -8107221, 18828269, -676044, 22689186, 431473},
+        {1458896, -13932055, -25949136, -4524366, -20075177, 11501384, 17282623, 7406489, -23213038, -15769471},
+        {-2620484, 9583238, 23199347, -11824331, -25703871, -15913654, 5083061, -8689717, -9737351, -16045616}
+    },
+    {
+        {-22533873, 3971007, -11117405, 1346125, 14979173, 667412, -9394180, 5050684, -9643024, -2001570},
+        {9964817, 3734595, -28618804, -7205589, 17379459, 4811673, -18268830, -14923103, -17325838, 13741942},
+        {-27142939, -9993513, -18376978, -15495258, 30985363, 4553964, 28579463, -659613, -29467771, -10330336},
+        {23937104, -12354601, -10404504, -1403099, 30096893, 12561514, -32802130, 15506052, -12194790, 12847261}
+    },
+    {
+        {25797779, 6593064, 9438415, -4491703, 9323996, -13891425, -3268365, 16775361, -6768410, 10616545},
+        {30110432, 6150738, 11033596, -6166025, 30904407, -4888338, 30115907, 13514014, 26093849, -5413630},
+        {-29406007, 7821542, -12574555, 11850148, 14854423, 10280760, 1150969, -720912, 33498220, -1125089},
+        {-21748778, -15895395, 8185404, 14024201, -24345637, 12693663, 4956066, -9286710, -1468575, -3010243}
+    },
+    {
+        {26525978, -8100649, -2814873, -3034309, -12858438, -10053546, -27560041, -9904885, 17896469, 8406605},
+        {-21496151, -13698560, 13426698, 3636383, 192685, 14330801, -13750301, 5122281, -14702286, -7903604},
+        {16238325, -16375339, -31605681, -10668851, 4251161, -191743, 6648702, 4513867, 22336337, 13055324},
+        {11902288, 3504652, -4296569, -16520579, -14118543, 5326753, -10758654, 5421451, 30624986, -14194505}
+    },
+    {
+        {8976361, -2583825, -10468555, 2902220, -29692585, -8614234, -16409093, -1027278, 13427251, -923668},
+        {-20201965, -10514326, -17424131, 1293343, -16799069, -15329803, -10657105, -13083970, 20907329, 3142040},
+        {31976626, -1773525, -23757974, -1512239, -20197708, -8157685, 278125, -1941461, 27420233, -9886550},
+        {10970535, -8718802, -4470007, -6949360, -279989, -7473610, -6782276, 9405100, 10026652, -13547944}
+    },
+    {
+        {21525891, -5723538, -16289357, -16715744, -23907331, -16223911, 4370995, 10587250, 22311339, 15989648},
+        {-32157098, -4245757, -5575677, 3248422, -3388970, 301369, 24523738, -9833946, -2092401, 10398613},
+        {31832042, -10557751, -10507175, 9632587, 28548742, 8738852, -3551417, -10994781, 12463289, 10707632},
+        {4213804, -1622369, -2397360, 6518414, -18801167, -8966388, 32258576, -4290528, 17308768, 15303906}
+    },
+    {
+        {32685028, -4591122, -20454913, -16702038, -20648573, 8647520, -25164504, 14027395, 20464767, -13529835},
+        {4364460, 3835597, 3135756, 15845277, 9002163, 1798438, -20851655, -10906484, 22173248, 12587884},
+        {5661392, -5576339, -21701336, 919810, 25556410, -2016861, -10381569, 5666363, -1993378, -3437882},
+        {-28199570, -13717528, -809272, -9105294, -3706524, 9550522, -27251410, -2268107, -30390765, -4881320}
+    },
+    {
+        {10436911, -10644566, 8917516, -10249013, -27579556, 16714623, -1326943, -5909512, 33131434, 3366559},
+        {-13518700, 15627316, -32344026, 4484361, 25321128, 2773183, 28682931, -8470169, 23494028, 11255843},
+        {29447339, 13513774, 872435, 9046145, 16328844, 8613134, 30019821, 8654519, 26554197, 213074},
+        {28357625, -42617, 20972477, -15415242, 18192022, -12598823, 4954852, 7399473, -22425037, 14440402}
+    },
+    {
+        {-20248269, 12490964, 25172831, 1693558, 8003863, -6219879, -22180998, 11146871, 9294725, -614289},
+        {-19624229, 13613287, -33091639, -15139051, 19161402, 458441, 5286133, -12911813, -5693297, 6612127},
+        {-1489834, 15171158, -31586172, -4991771, 24952372, -2173463, 31648648, 2609726, 23187657, -12476704},
+        {28922770, -4719893, -19743548, -9463372, -2009628, -15764492, 25579066, 16195301, 23740447, 8688921}
+    },
+    {
+        {-5209848, 12980435, -26525814, -2409100, -9136893, 11635836, -20008658, -7610454, 16259483, 4134997},
+        {-29461868, 12298768, -26038999, -13871929, 19625880, -10236005, -16969927, -10599279, 30320896, 1881229},
+        {-14996805, -886615, 1522930, -12804129, 31003353, 3359324, 24827642, -3832727, -25347166, 263843},
+        {13328248, -11409113, -13682973, -10685130, -30789414, 8850202, 29167064, -11845599, 2026837, 14177669}
+    },
+    {
+        {-12714912, -13204220, 17707511, 99752, 28284991, -6622644, -21975663, -12785700, 27106001, -14130058},
+        {-7032142, 139504, 16549054, 5979138, 5871187, -3899820, -8736619, -2733055, 922918, -3934893},
+        {-8237272, -14726715, -16737289, 8624633, -33236584, -10993661, -5049902, 8993665, -29469692, -10219191},
+        {5263648, -7372275, 2224141, -15787760, 32565869, 16522331, 16449233, 8686019, -11479125, 5928045}
+    },
+    {
+        {-10062270, -14741999, 24122852, 6641457, -14760965, -2867106, -8202004, -14387703, -25753213, 12440026},
+        {-27956093, -13411492, 18879982, -7587857, 10466746, -12454174, -1278005, -3067001, 4929164, -13634585},
+        {19021725, 6698967, -13709149, 2237073, 26586309, 5486814, 22453049, 7197602, 12038249, -8916830},
+        {1503104, -10729157, -3413607, 6983511, -25348569, 14746696, 18387631, 2009491, -7233731, -12379661}
+    },
+    {
+        {-20263669, 10783262, 6763402, -3840324, -23437190, 4237751, -27071235, 11890632, -25763812, 3947647},
+        {14712500, -10676992, -20419789, 12504207, 4077551, 9474579, 12662332, 12769096, -31050867, -6158479},
+        {26636150, -9309511, -17584498, 9491410, 25662147, -9275605, 9000356, 1908222, -5324243, -1870896},
+        {2475058, -1930917, -11092099, -16115683, 7226403, 5040270, -3115624, 7679432, -16541260, 9107129}
+    },
+    {
+        {4292395, -10753903, 8345266, 269629, 27594801, 5794656, -16554324, -11307679, 4771955, -2950437},
+        {-6402515, -3725413, -6190190, 1322519, 13840904, 13334643, 13612586, 11129467, 12444792, 8559420},
+        {-8052880, -6832964, 17308424, -9154696, -9692119, -5864739, -8795015, -400468, -30957916, 3447202},
+        {12294740, -3439432, 18573868, 763255, 18104795, -14845768, 33500054, -5450741, -11667180, 1879428}
+    },
+    {
+        {11232732, 2373867, 26995137, 3231915, 23456035, 208888, 4231552, -16634362, 20875343, 1174268},
+        {6010788, 11810627, 31866623, 6827339, 29644434, -4429880, -8860133, -6244843, 28752542, 3294960},
+        {993061, -8858516, -27652305, -2137202, 18617525, 10948833, 432705, -2057588, 8419663, -6041566},
+        {-10136299, -5518054, -12151664, 14619159, -31175426, -4730980, -19251702, -4676394, 16199032, 8795052}
+    },
+    {
+        {-18986413, -14729535, 8996052, 8525670, -20615947, -9247772, 25326939, 6233318, 29501161, -2943123},
+        {963198, 9794152, 25185025, -15268495, -30862858, 5204802, -27262473, 7081632, 3913368, -6106116},
+        {2352633, -4477981, 6439460, -7350588, 20350123, -14530016, 1458798, 7736232, -2911317, 3069802},
+        {1118842, -1078229, -32823022, -1858587, -31810683, -13859146, 2051015, 6657807, 20502054, -9179650}
+    },
+    {
+        {-9900653, 15494639, -11265832, -7424958, -26144132, -5522408, 10804590, 2424487, 16035360, 12890766},
+        {-20150120, -4801738, 18470928, -7001356, -25177039, 5448128, -32064912, -3342374, 22592062, -11822914},
+        {-23607265, -16409893, 28663481, 14149714, -7445559, 4313670, -28023958, -14276866, 22757522, -7831051},
+        {15404564, 2500413, 28166177, -2017896, -14700404, -10079808, -9166249, 9972533, 23430060, 6838273}
+    },
+    {
+        {1111040, 13841646, 12700824, 44885, 5042510, 13451469, 11354069, -15097824, 25320728, 4945230},
+        {22540377, 6541810, -5252794, 15112082, 31839145, -16244605, 10146587, 15428843, 24966639, 3056825},
+        {-4015646, 14117421, -4598251, -12778533, 8044283, 13341913, 15868694, 8332920, -32117062, -3502075},
+        {30385605, 351317, 24410327, 14207813, -30569113, 3064308, 10625014, 16687635, -2768138, 13183440}
+    },
+};
+
+} //namespace sp
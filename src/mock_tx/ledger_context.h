@@ -33,14 +33,23 @@
 
 //local headers
 #include "crypto/crypto.h"
+extern "C"
+{
+#include "crypto/crypto-ops.h"
+}
+#include "mock_tx_utils.h"
 #include "ringct/rctTypes.h"
+#include "span.h"
 
 //third party headers
 
 //standard headers
+#include <exception>
+#include <future>
 #include <vector>
 
 //forward declarations
+namespace rct { class straus_point_cache; }
 namespace mock_tx
 {
     struct MockENoteSpV1;
@@ -64,6 +73,20 @@ public:
     */
     virtual bool linking_tag_exists_sp_v1(const crypto::key_image &linking_tag) const = 0;
     /**
+    * brief: linking_tags_exist_sp_v1 - checks which of a set of Seraphis linking tags exist in the ledger
+    *   - default: one linking_tag_exists_sp_v1() call per tag; ledgers can look tags up together
+    * param: linking_tags -
+    * outparam: exist_out - exist_out[i] is true if linking_tags[i] exists in the ledger
+    */
+    virtual void linking_tags_exist_sp_v1(const std::vector<crypto::key_image> &linking_tags,
+        std::vector<bool> &exist_out) const
+    {
+        exist_out.clear();
+        exist_out.reserve(linking_tags.size());
+        for (const crypto::key_image &linking_tag : linking_tags)
+            exist_out.push_back(linking_tag_exists_sp_v1(linking_tag));
+    }
+    /**
     * brief: get_reference_set_sp_v1 - gets Seraphis enotes stored in the ledger
     * param: indices -
     * outparam: enotes_out - 
@@ -76,14 +99,94 @@ public:
     * outparam: referenced_enotes_components - {{enote address, enote amount commitment}}
     */
     virtual void get_reference_set_components_sp_v1(const std::vector<std::size_t> &indices,
-        rct::keyM &referenced_enotes_components) const = 0;
+        rct::KeyMatrix &referenced_enotes_components) const = 0;
     /**
     * brief: get_reference_set_components_sp_v2 - gets Seraphis squashed enotes stored in the ledger
     * param: indices -
     * outparam: referenced_enotes_components - {{squashed enote}}
     */
     virtual void get_reference_set_components_sp_v2(const std::vector<std::size_t> &indices,
-        rct::keyM &referenced_enotes_components) const = 0;
+        rct::KeyMatrix &referenced_enotes_components) const = 0;
+    /**
+    * brief: get_reference_set_components_sp_v2_ranges - gets Seraphis squashed enotes stored in the ledger, from runs of
+    *   consecutive ledger indices (e.g. binned reference sets)
+    *   - default: expand the runs and call get_reference_set_components_sp_v2(); ledgers can copy/scan each run at once
+    * param: ranges -
+    * outparam: referenced_enotes_components - {{squashed enote}}, in range order
+    */
+    virtual void get_reference_set_components_sp_v2_ranges(const epee::span<const LedgerIndexRange> ranges,
+        rct::KeyMatrix &referenced_enotes_components) const
+    {
+        std::vector<std::size_t> indices;
+        for (const LedgerIndexRange &range : ranges)
+        {
+            for (std::size_t offset{0}; offset < range.m_count; ++offset)
+                indices.push_back(range.m_first + offset);
+        }
+
+        get_reference_set_components_sp_v2(indices, referenced_enotes_components);
+    }
+    /**
+    * brief: get_reference_set_components_sp_v2_p3 - gets Seraphis squashed enotes stored in the ledger, and their
+    *   decompressed form (so verifiers don't need to decompress hot enotes over and over)
+    * param: indices -
+    * outparam: referenced_enotes_components - {{squashed enote}}
+    * outparam: referenced_enotes_points - {squashed enote (decompressed)}
+    */
+    virtual void get_reference_set_components_sp_v2_p3(const std::vector<std::size_t> &indices,
+        rct::KeyMatrix &referenced_enotes_components,
+        std::vector<ge_p3> &referenced_enotes_points) const = 0;
+    /**
+    * brief: get_reference_set_components_sp_v2_p3_async - start getting Seraphis squashed enotes and their decompressed
+    *   form (see get_reference_set_components_sp_v2_p3()), so a verifier can overlap ledger reads with its crypto
+    *   - default: fetch right away on the calling thread; ledgers with slow reads (e.g. on disk) fetch in the background
+    *   - the inputs and outparams must stay alive (and untouched) until the returned future is ready
+    * param: indices -
+    * outparam: referenced_enotes_components - {{squashed enote}}
+    * outparam: referenced_enotes_points - {squashed enote (decompressed)}
+    * return: future that is ready once the outparams are set (rethrows fetch errors from get())
+    */
+    virtual std::future<void> get_reference_set_components_sp_v2_p3_async(const std::vector<std::size_t> &indices,
+        rct::KeyMatrix &referenced_enotes_components,
+        std::vector<ge_p3> &referenced_enotes_points) const
+    {
+        std::promise<void> fetched;
+
+        try
+        {
+            get_reference_set_components_sp_v2_p3(indices, referenced_enotes_components, referenced_enotes_points);
+            fetched.set_value();
+        }
+        catch (...)
+        {
+            fetched.set_exception(std::current_exception());
+        }
+
+        return fetched.get_future();
+    }
+    /**
+    * brief: get_squashed_enote_straus_cache_sp_v2 - gets the ledger's cache of straus multiples for squashed enotes
+    *   (keyed by ledger index), for verifiers that pre-aggregate ref sets made of hot enotes
+    * return: the cache, or nullptr if the ledger doesn't keep one
+    */
+    virtual rct::straus_point_cache* get_squashed_enote_straus_cache_sp_v2() const { return nullptr; }
+    /**
+    * brief: try_get_reference_set_components_sp_v2_cached - gets Seraphis squashed enotes stored in the ledger, with
+    *   their decompressed and cached (ge_cached) forms, for ledgers that store squashed enotes pre-converted
+    *   - verifiers can hand the cached forms straight to pippenger (no decompression or conversion per verification)
+    * param: indices -
+    * outparam: referenced_enotes_components - {{squashed enote}}
+    * outparam: referenced_enotes_points - {squashed enote (decompressed)}
+    * outparam: referenced_enotes_cached - {squashed enote (cached form)}
+    * return: false if the ledger doesn't store pre-converted squashed enotes (outparams untouched)
+    */
+    virtual bool try_get_reference_set_components_sp_v2_cached(const std::vector<std::size_t> &indices,
+        rct::KeyMatrix &referenced_enotes_components,
+        std::vector<ge_p3> &referenced_enotes_points,
+        std::vector<ge_cached> &referenced_enotes_cached) const
+    {
+        return false;
+    }
     /**
     * brief: add_transaction_sp_concise_v1 - add a MockTxSpConciseV1 transaction to the ledger
     * param: tx_to_add -
@@ -104,6 +207,32 @@ public:
     * param: tx_to_add -
     */
     virtual void add_transaction_sp_squashed_v1(const MockTxSpSquashedV1 &tx_to_add) = 0;
+    /**
+    * brief: add_enote_sp_v1 - add a Seraphis v1 enote to the ledger (e.g. a reference set member of a mock tx)
+    * param: enote -
+    * return: index in the ledger of the enote just added
+    */
+    virtual std::size_t add_enote_sp_v1(const MockENoteSpV1 &enote) = 0;
+    /**
+    * brief: add_enote_sp_v2 - add a Seraphis v1 enote to the ledger (and store the squashed enote)
+    * param: enote -
+    * return: index in the ledger of the enote just added
+    */
+    virtual std::size_t add_enote_sp_v2(const MockENoteSpV1 &enote) = 0;
+    /**
+    * brief: add_enotes_sp_v1 - add a set of Seraphis v1 enotes to the ledger in one step, at consecutive indices
+    * param: enotes -
+    * return: index in the ledger of the first enote just added
+    */
+    virtual std::size_t add_enotes_sp_v1(const std::vector<MockENoteSpV1> &enotes) = 0;
+    /**
+    * brief: add_enotes_sp_v2 - add a set of Seraphis v1 enotes to the ledger in one step, at consecutive indices (and
+    *   store their squashed enotes)
+    * param: enotes -
+    * param: num_threads - max number of threads for squashing the enotes (0 = threadpool max concurrency; 1 = serial)
+    * return: index in the ledger of the first enote just added
+    */
+    virtual std::size_t add_enotes_sp_v2(const std::vector<MockENoteSpV1> &enotes, const std::size_t num_threads) = 0;
 };
 
 template<typename TxType>
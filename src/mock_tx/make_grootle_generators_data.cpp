@@ -0,0 +1,141 @@
+// Copyright (c) 2021, The Monero Project
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of
+//    conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list
+//    of conditions and the following disclaimer in the documentation and/or other
+//    materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be
+//    used to endorse or promote products derived from this software without specific
+//    prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+// THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// NOT FOR PRODUCTION
+
+// Offline generator for 'grootle_generators_data.cpp'.
+// usage: make_grootle_generators_data > grootle_generators_data.cpp
+// - rerun whenever GROOTLE_MAX_MN or the generator definitions in 'grootle_generators.cpp' change
+
+//local headers
+extern "C"
+{
+#include "crypto/crypto-ops.h"
+}
+#include "grootle.h"
+#include "grootle_generators.h"
+
+//third party headers
+
+//standard headers
+#include <cstdio>
+
+
+//-------------------------------------------------------------------------------------------------------------------
+static void print_fe(const fe f)
+{
+    std::printf("{");
+    for (int i = 0; i < 10; ++i)
+        std::printf("%s%d", i ? ", " : "", static_cast<int>(f[i]));
+    std::printf("}");
+}
+//-------------------------------------------------------------------------------------------------------------------
+static void print_table(const char *name, void (*make_gen)(const std::size_t, ge_p3&))
+{
+    std::printf("const ge_p3 %s[GROOTLE_MAX_MN] = {\n", name);
+    for (std::size_t i = 0; i < sp::GROOTLE_MAX_MN; ++i)
+    {
+        ge_p3 gen;
+        make_gen(i, gen);
+
+        std::printf("    {\n        ");
+        print_fe(gen.X);
+        std::printf(",\n        ");
+        print_fe(gen.Y);
+        std::printf(",\n        ");
+        print_fe(gen.Z);
+        std::printf(",\n        ");
+        print_fe(gen.T);
+        std::printf("\n    },\n");
+    }
+    std::printf("};\n");
+}
+//-------------------------------------------------------------------------------------------------------------------
+int main()
+{
+    std::printf("%s", R"(// Copyright (c) 2021, The Monero Project
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of
+//    conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list
+//    of conditions and the following disclaimer in the documentation and/or other
+//    materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be
+//    used to endorse or promote products derived from this software without specific
+//    prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+// THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// NOT FOR PRODUCTION
+
+// GENERATED FILE - DO NOT EDIT
+// - produced by 'make_grootle_generators_data' (see 'make_grootle_generators_data.cpp')
+
+//paired header
+#include "grootle_generators.h"
+
+//local headers
+extern "C"
+{
+#include "crypto/crypto-ops.h"
+}
+#include "grootle.h"
+
+//third party headers
+
+//standard headers
+
+
+namespace sp
+{
+
+)");
+
+    print_table("grootle_Hi_A_p3", &sp::make_grootle_Hi_A_p3);
+    std::printf("\n");
+    print_table("grootle_Hi_B_p3", &sp::make_grootle_Hi_B_p3);
+    std::printf("\n} //namespace sp\n");
+
+    return 0;
+}
+//-------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,119 @@
+// Copyright (c) 2021, The Monero Project
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this list of
+//    conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list
+//    of conditions and the following disclaimer in the documentation and/or other
+//    materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its contributors may be
+//    used to endorse or promote products derived from this software without specific
+//    prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+// THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// NOT FOR PRODUCTION
+
+//paired header
+#include "mock_decoy_selection.h"
+
+//local headers
+#include "crypto/crypto.h"
+#include "cryptonote_config.h"
+#include "misc_log_ex.h"
+
+//third party headers
+
+//standard headers
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <set>
+#include <vector>
+
+#undef MONERO_DEFAULT_LOG_CATEGORY
+#define MONERO_DEFAULT_LOG_CATEGORY "mock_tx"
+
+namespace mock_tx
+{
+
+/// wallet2's decoy selection parameters (see tools::gamma_picker)
+static constexpr double GAMMA_SHAPE{19.28};
+static constexpr double GAMMA_SCALE{1/1.61};
+static constexpr std::uint64_t DEFAULT_UNLOCK_TIME{CRYPTONOTE_DEFAULT_TX_SPENDABLE_AGE * DIFFICULTY_TARGET_V2};
+static constexpr std::uint64_t RECENT_SPEND_WINDOW{15 * DIFFICULTY_TARGET_V2};
+
+//-------------------------------------------------------------------------------------------------------------------
+MockGammaDecoySelector::MockGammaDecoySelector(const std::size_t num_ledger_enotes,
+    const std::size_t enotes_per_block) :
+        m_gamma{GAMMA_SHAPE, GAMMA_SCALE},
+        m_enotes_per_block{enotes_per_block}
+{
+    CHECK_AND_ASSERT_THROW_MES(m_enotes_per_block > 0, "Decoy selector needs at least one enote per block.");
+
+    // the last blocks of the simulated chain are still locked (the last block may be partial)
+    const std::size_t num_blocks{(num_ledger_enotes + m_enotes_per_block - 1) / m_enotes_per_block};
+    const std::size_t num_unlocked_blocks{
+            num_blocks > CRYPTONOTE_DEFAULT_TX_SPENDABLE_AGE ? num_blocks - CRYPTONOTE_DEFAULT_TX_SPENDABLE_AGE : 0
+        };
+    m_num_unlocked_enotes = num_unlocked_blocks * m_enotes_per_block;
+
+    CHECK_AND_ASSERT_THROW_MES(m_num_unlocked_enotes > 0, "Decoy selector's simulated chain has no unlocked enotes.");
+
+    m_average_enote_time = DIFFICULTY_TARGET_V2 / static_cast<double>(m_enotes_per_block);
+}
+//-------------------------------------------------------------------------------------------------------------------
+bool MockGammaDecoySelector::try_pick(std::size_t &ledger_index_out)
+{
+    // age of the pick, in seconds before the first unlocked enote (see tools::gamma_picker::pick())
+    double x{std::exp(m_gamma(m_engine))};
+
+    if (x > DEFAULT_UNLOCK_TIME)
+        x -= DEFAULT_UNLOCK_TIME;
+    else
+        x = crypto::rand_idx(RECENT_SPEND_WINDOW);
+
+    const double enote_offset{x / m_average_enote_time};
+    if (enote_offset >= m_num_unlocked_enotes)
+        return false;
+
+    // random enote of the block that holds the pick
+    const std::size_t picked_index{m_num_unlocked_enotes - 1 - static_cast<std::size_t>(enote_offset)};
+    ledger_index_out = picked_index - picked_index % m_enotes_per_block + crypto::rand_idx(m_enotes_per_block);
+
+    return true;
+}
+//-------------------------------------------------------------------------------------------------------------------
+void MockGammaDecoySelector::pick_distinct(const std::size_t num_decoys, std::vector<std::size_t> &ledger_indices_out)
+{
+    CHECK_AND_ASSERT_THROW_MES(num_decoys <= m_num_unlocked_enotes, "Not enough unlocked enotes to pick decoys from.");
+
+    // the gamma distribution is concentrated on recent blocks, so give up if a small chain can't supply enough
+    std::set<std::size_t> ledger_indices;
+    std::size_t ledger_index;
+
+    for (std::size_t attempt{0}; ledger_indices.size() < num_decoys; ++attempt)
+    {
+        CHECK_AND_ASSERT_THROW_MES(attempt < 1000*(num_decoys + 1), "Failed to pick enough distinct decoys.");
+
+        if (try_pick(ledger_index))
+            ledger_indices.insert(ledger_index);
+    }
+
+    ledger_indices_out.assign(ledger_indices.begin(), ledger_indices.end());
+}
+//-------------------------------------------------------------------------------------------------------------------
+} //namespace mock_tx
@@ -0,0 +1,106 @@
+// Copyright (c) 2021, The Monero Project
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this list of
+//    conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list
+//    of conditions and the following disclaimer in the documentation and/or other
+//    materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its contributors may be
+//    used to endorse or promote products derived from this software without specific
+//    prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+// THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// Decoy selection over a simulated chain, following wallet2's gamma distribution.
+// NOT FOR PRODUCTION
+
+#pragma once
+
+//local headers
+#include "crypto/crypto.h"
+
+//third party headers
+
+//standard headers
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <vector>
+
+//forward declarations
+
+
+namespace mock_tx
+{
+
+////
+// MockGammaDecoySelector - picks decoy ledger indices like wallet2's gamma_picker, over a simulated chain where the
+//   first 'num_ledger_enotes' enotes of a mock ledger are split into blocks of 'enotes_per_block' enotes
+// - a pick is 'x' seconds older than the chain tip, with log(x) ~ gamma(19.28, 1/1.61) (Miller et al.), then lands on
+//   a random enote of that block
+// - enotes in the last CRYPTONOTE_DEFAULT_TX_SPENDABLE_AGE blocks are locked and never picked
+///
+class MockGammaDecoySelector final
+{
+public:
+//constructors
+    /// mainnet-like average (rounded) of enotes per block
+    static constexpr std::size_t DEFAULT_ENOTES_PER_BLOCK{40};
+
+    /**
+    * brief: construct for a simulated chain
+    * param: num_ledger_enotes - number of enotes in the simulated chain (ledger indices [0, num_ledger_enotes))
+    * param: enotes_per_block -
+    */
+    MockGammaDecoySelector(const std::size_t num_ledger_enotes,
+        const std::size_t enotes_per_block = DEFAULT_ENOTES_PER_BLOCK);
+
+//member functions
+    /**
+    * brief: try_pick - pick one decoy ledger index
+    * outparam: ledger_index_out -
+    * return: false if the pick is older than the simulated chain (like wallet2, the caller should just pick again)
+    */
+    bool try_pick(std::size_t &ledger_index_out);
+    /**
+    * brief: pick_distinct - pick distinct decoy ledger indices
+    * param: num_decoys -
+    * outparam: ledger_indices_out - sorted ascending
+    */
+    void pick_distinct(const std::size_t num_decoys, std::vector<std::size_t> &ledger_indices_out);
+
+    /// number of enotes that can be picked
+    std::size_t get_num_unlocked_enotes() const { return m_num_unlocked_enotes; }
+
+private:
+    /// random engine for std::gamma_distribution, backed by crypto::rand()
+    struct gamma_engine
+    {
+        typedef std::uint64_t result_type;
+        static constexpr result_type min() { return 0; }
+        static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+        result_type operator()() { return crypto::rand<result_type>(); }
+    } m_engine;
+
+    std::gamma_distribution<double> m_gamma;
+    std::size_t m_enotes_per_block;
+    std::size_t m_num_unlocked_enotes;
+    /// seconds between enotes
+    double m_average_enote_time;
+};
+
+} //namespace mock_tx
@@ -33,19 +33,40 @@
 
 //local headers
 #include "crypto/crypto.h"
+extern "C"
+{
+#include "crypto/crypto-ops.h"
+#include "crypto/keccak.h"
+}
+#include "cryptonote_config.h"
 #include "misc_log_ex.h"
 #include "mock_sp_core_utils.h"
 #include "mock_sp_transaction_component_types.h"
+#include "mock_sp_transaction_utils.h"
 #include "mock_sp_txtype_concise_v1.h"
 #include "mock_sp_txtype_merge_v1.h"
 #include "mock_sp_txtype_plain_v1.h"
 #include "mock_sp_txtype_squashed_v1.h"
+#include "mock_tx_utils.h"
+#include "ringct/rctOps.h"
 #include "ringct/rctTypes.h"
+#include "span.h"
 
 //third party headers
+#include <boost/thread/locks.hpp>
+#include <boost/thread/shared_mutex.hpp>
 
 //standard headers
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <list>
 #include <mutex>
+#include <string>
+#include <type_traits>
 #include <vector>
 
 #undef MONERO_DEFAULT_LOG_CATEGORY
@@ -53,78 +74,340 @@
 
 namespace mock_tx
 {
+
+/// ledger snapshot header (the ledger columns follow it, see MockLedgerContext::save())
+struct MockLedgerSnapshotHeader final
+{
+    char m_magic[8];
+    std::uint32_t m_version;
+    std::uint32_t m_flags;
+    std::uint32_t m_ge_p3_size;
+    std::uint32_t m_ge_cached_size;
+    std::uint64_t m_num_enotes;
+    std::uint64_t m_num_linking_tags;
+    /// commitment to the squashed enotes and linking tags (see MockLedgerContext::get_state_commitment())
+    rct::key m_state_commitment;
+};
+static_assert(sizeof(MockLedgerSnapshotHeader) % 8 == 0, "Ledger snapshot columns must stay 8-byte aligned.");
+
+static constexpr char MOCK_LEDGER_SNAPSHOT_MAGIC[8]{'M', 'O', 'C', 'K', 'L', 'D', 'G', 'R'};
+static constexpr std::uint32_t MOCK_LEDGER_SNAPSHOT_VERSION{2};
+/// snapshot flag: the converted squashed enote columns are present
+static constexpr std::uint32_t MOCK_LEDGER_SNAPSHOT_FLAG_CONVERTED{1};
+/// snapshot flags: the encoded amount, view tag, and squashed enote flag columns are absent / the onetime address and
+///   amount commitment columns are absent too (see MockLedgerStorageMode)
+static constexpr std::uint32_t MOCK_LEDGER_SNAPSHOT_FLAG_NO_FULL_ENOTES{2};
+static constexpr std::uint32_t MOCK_LEDGER_SNAPSHOT_FLAG_NO_ENOTE_COMPONENTS{4};
+
+//-------------------------------------------------------------------------------------------------------------------
+// size of a snapshot with the given header
+//-------------------------------------------------------------------------------------------------------------------
+static std::uint64_t ledger_snapshot_size(const MockLedgerSnapshotHeader &header)
+{
+    std::uint64_t enote_bytes{sizeof(rct::key)};
+    if (!(header.m_flags & MOCK_LEDGER_SNAPSHOT_FLAG_NO_ENOTE_COMPONENTS))
+        enote_bytes += 2*sizeof(rct::key);
+    if (!(header.m_flags & MOCK_LEDGER_SNAPSHOT_FLAG_NO_FULL_ENOTES))
+        enote_bytes += sizeof(rct::xmr_amount) + 2;
+    if (header.m_flags & MOCK_LEDGER_SNAPSHOT_FLAG_CONVERTED)
+        enote_bytes += sizeof(ge_p3) + sizeof(ge_cached);
+
+    return sizeof(MockLedgerSnapshotHeader) +
+        header.m_num_enotes*enote_bytes +
+        header.m_num_linking_tags*sizeof(crypto::key_image);
+}
+//-------------------------------------------------------------------------------------------------------------------
+// put linking tags in their canonical (bytewise) order
+//-------------------------------------------------------------------------------------------------------------------
+static bool linking_tag_less(const crypto::key_image &a, const crypto::key_image &b)
+{
+    return memcmp(a.data, b.data, sizeof(crypto::key_image)) < 0;
+}
+//-------------------------------------------------------------------------------------------------------------------
+// H("domain-sep", num enotes, {squashed enotes}, num linking tags, {sorted linking tags})
+//-------------------------------------------------------------------------------------------------------------------
+template <typename AllocatorT>
+static rct::key ledger_state_commitment(const std::vector<rct::key, AllocatorT> &squashed_enotes,
+    const std::vector<crypto::key_image> &sorted_linking_tags)
+{
+    static const std::string domain_separator{config::HASH_KEY_SERAPHIS_LEDGER_STATE};
+
+    const std::uint64_t num_enotes{squashed_enotes.size()};
+    const std::uint64_t num_linking_tags{sorted_linking_tags.size()};
+
+    KECCAK_CTX ctx;
+    keccak_init(&ctx);
+    keccak_update(&ctx, reinterpret_cast<const uint8_t*>(domain_separator.data()), domain_separator.size());
+    keccak_update(&ctx, reinterpret_cast<const uint8_t*>(&num_enotes), sizeof(num_enotes));
+    keccak_update(&ctx, reinterpret_cast<const uint8_t*>(squashed_enotes.data()), num_enotes*sizeof(rct::key));
+    keccak_update(&ctx, reinterpret_cast<const uint8_t*>(&num_linking_tags), sizeof(num_linking_tags));
+    keccak_update(&ctx,
+        reinterpret_cast<const uint8_t*>(sorted_linking_tags.data()),
+        num_linking_tags*sizeof(crypto::key_image));
+
+    rct::key commitment;
+    keccak_finish(&ctx, commitment.bytes);
+
+    return commitment;
+}
+//-------------------------------------------------------------------------------------------------------------------
+// write one ledger column to a snapshot
+//-------------------------------------------------------------------------------------------------------------------
+template <typename T, typename AllocatorT>
+static void write_ledger_snapshot_column(std::ofstream &snapshot, const std::vector<T, AllocatorT> &column)
+{
+    static_assert(std::is_trivially_copyable<T>::value, "Ledger snapshot columns must be flat.");
+
+    snapshot.write(reinterpret_cast<const char*>(column.data()), column.size()*sizeof(T));
+}
+//-------------------------------------------------------------------------------------------------------------------
+// read one ledger column from a snapshot
+//-------------------------------------------------------------------------------------------------------------------
+template <typename T, typename AllocatorT>
+static bool read_ledger_snapshot_column(std::ifstream &snapshot,
+    const std::size_t count,
+    std::vector<T, AllocatorT> &column_out)
+{
+    static_assert(std::is_trivially_copyable<T>::value, "Ledger snapshot columns must be flat.");
+
+    column_out.resize(count);
+    snapshot.read(reinterpret_cast<char*>(column_out.data()), count*sizeof(T));
+
+    return snapshot.good();
+}
+//-------------------------------------------------------------------------------------------------------------------
 //-------------------------------------------------------------------------------------------------------------------
 bool MockLedgerContext::linking_tag_exists_sp_v1(const crypto::key_image &linking_tag) const
 {
-    std::lock_guard<std::mutex> lock{m_ledger_mutex};
+    boost::shared_lock<boost::shared_mutex> lock{get_linking_tag_shard(linking_tag).m_mutex};
 
     return linking_tag_exists_sp_v1_impl(linking_tag);
 }
 //-------------------------------------------------------------------------------------------------------------------
+void MockLedgerContext::linking_tags_exist_sp_v1(const std::vector<crypto::key_image> &linking_tags,
+    std::vector<bool> &exist_out) const
+{
+    exist_out.assign(linking_tags.size(), false);
+
+    // group the tags by shard, then check each group under one lock
+    std::array<std::vector<std::size_t>, LINKING_TAG_SHARD_COUNT> tags_per_shard;
+    for (std::size_t tag_index{0}; tag_index < linking_tags.size(); ++tag_index)
+        tags_per_shard[get_linking_tag_shard_index(linking_tags[tag_index])].push_back(tag_index);
+
+    std::vector<crypto::key_image> shard_tags;
+    std::vector<bool> shard_tags_exist;
+
+    for (std::size_t shard_index{0}; shard_index < LINKING_TAG_SHARD_COUNT; ++shard_index)
+    {
+        if (tags_per_shard[shard_index].empty())
+            continue;
+
+        shard_tags.clear();
+        for (const std::size_t tag_index : tags_per_shard[shard_index])
+            shard_tags.push_back(linking_tags[tag_index]);
+
+        {
+            const LinkingTagShard &shard{m_sp_linking_tag_shards[shard_index]};
+            boost::shared_lock<boost::shared_mutex> lock{shard.m_mutex};
+
+            shard.m_linking_tags.contains_batch(epee::to_span(shard_tags), shard_tags_exist);
+        }
+
+        for (std::size_t i{0}; i < shard_tags.size(); ++i)
+            exist_out[tags_per_shard[shard_index][i]] = shard_tags_exist[i];
+    }
+}
+//-------------------------------------------------------------------------------------------------------------------
 void MockLedgerContext::get_reference_set_sp_v1(const std::vector<std::size_t> &indices,
     std::vector<MockENoteSpV1> &enotes_out) const
 {
-    std::lock_guard<std::mutex> lock{m_ledger_mutex};
+    CHECK_AND_ASSERT_THROW_MES(stores_full_enotes(), "Tried to get enotes from a ledger that doesn't store them.");
 
-    std::vector<MockENoteSpV1> enotes_temp;
-    enotes_temp.reserve(indices.size());
+    boost::shared_lock<boost::shared_mutex> lock{m_ledger_mutex};
 
     for (const std::size_t index : indices)
+        CHECK_AND_ASSERT_THROW_MES(index < get_num_enotes_impl(), "Tried to get enote that doesn't exist.");
+
+    std::vector<MockENoteSpV1> enotes_temp;
+    enotes_temp.resize(indices.size());
+
+    for (std::size_t i{0}; i < indices.size(); ++i)
     {
-        CHECK_AND_ASSERT_THROW_MES(index < m_sp_enotes.size(), "Tried to get enote that doesn't exist.");
-        enotes_temp.push_back(m_sp_enotes.at(index));
+        enotes_temp[i].m_onetime_address = m_sp_enote_onetime_addresses[indices[i]];
+        enotes_temp[i].m_amount_commitment = m_sp_enote_amount_commitments[indices[i]];
+        enotes_temp[i].m_encoded_amount = m_sp_enote_encoded_amounts[indices[i]];
+        enotes_temp[i].m_view_tag = m_sp_enote_view_tags[indices[i]];
     }
 
     enotes_out = std::move(enotes_temp);
 }
 //-------------------------------------------------------------------------------------------------------------------
 void MockLedgerContext::get_reference_set_components_sp_v1(const std::vector<std::size_t> &indices,
-    rct::keyM &referenced_enotes_components_out) const
+    rct::KeyMatrix &referenced_enotes_components_out) const
 {
-    std::lock_guard<std::mutex> lock{m_ledger_mutex};
+    CHECK_AND_ASSERT_THROW_MES(stores_enote_components(),
+        "Tried to get enote components from a ledger that only stores squashed enotes.");
 
-    rct::keyM referenced_enotes_components_temp;
-    referenced_enotes_components_temp.reserve(indices.size());
+    boost::shared_lock<boost::shared_mutex> lock{m_ledger_mutex};
 
     for (const std::size_t index : indices)
     {
-        CHECK_AND_ASSERT_THROW_MES(index < m_sp_enotes.size(), "Tried to get components of an enote that doesn't exist.");
-        referenced_enotes_components_temp.emplace_back(
-                rct::keyV{m_sp_enotes.at(index).m_onetime_address, m_sp_enotes.at(index).m_amount_commitment}
-            );
+        CHECK_AND_ASSERT_THROW_MES(index < get_num_enotes_impl(),
+            "Tried to get components of an enote that doesn't exist.");
     }
 
-    referenced_enotes_components_out = std::move(referenced_enotes_components_temp);
+    // all indices were checked, so fill the output in place (reuses its allocation)
+    referenced_enotes_components_out.resize(indices.size(), 2);
+
+    for (std::size_t i{0}; i < indices.size(); ++i)
+    {
+        referenced_enotes_components_out[i][0] = m_sp_enote_onetime_addresses[indices[i]];
+        referenced_enotes_components_out[i][1] = m_sp_enote_amount_commitments[indices[i]];
+    }
 }
 //-------------------------------------------------------------------------------------------------------------------
 void MockLedgerContext::get_reference_set_components_sp_v2(const std::vector<std::size_t> &indices,
-        rct::keyM &referenced_enotes_components_out) const
+        rct::KeyMatrix &referenced_enotes_components_out) const
 {
-    std::lock_guard<std::mutex> lock{m_ledger_mutex};
+    boost::shared_lock<boost::shared_mutex> lock{m_ledger_mutex};
 
     // gets squashed enotes
-    rct::keyM referenced_enotes_components_temp;
-    referenced_enotes_components_temp.reserve(indices.size());
+    for (const std::size_t index : indices)
+    {
+        CHECK_AND_ASSERT_THROW_MES(squashed_enote_exists_impl(index),
+            "Tried to get squashed enote that doesn't exist.");
+    }
+
+    referenced_enotes_components_out.resize(indices.size(), 1);
+
+    for (std::size_t i{0}; i < indices.size(); ++i)
+        referenced_enotes_components_out[i][0] = m_sp_squashed_enotes[indices[i]];
+}
+//-------------------------------------------------------------------------------------------------------------------
+void MockLedgerContext::get_reference_set_components_sp_v2_ranges(const epee::span<const LedgerIndexRange> ranges,
+    rct::KeyMatrix &referenced_enotes_components_out) const
+{
+    boost::shared_lock<boost::shared_mutex> lock{m_ledger_mutex};
+
+    // gets squashed enotes, one run at a time
+    std::size_t num_enotes{0};
+
+    for (const LedgerIndexRange &range : ranges)
+    {
+        CHECK_AND_ASSERT_THROW_MES(squashed_enotes_exist_impl(range),
+            "Tried to get squashed enote that doesn't exist.");
+        num_enotes += range.m_count;
+    }
+
+    // one key per row, so each run is one contiguous copy
+    referenced_enotes_components_out.resize(num_enotes, 1);
+    rct::key *position{referenced_enotes_components_out.data()};
+
+    for (const LedgerIndexRange &range : ranges)
+    {
+        const rct::key *run{m_sp_squashed_enotes.data() + range.m_first};
+        position = std::copy(run, run + range.m_count, position);
+    }
+}
+//-------------------------------------------------------------------------------------------------------------------
+void MockLedgerContext::get_reference_set_components_sp_v2_p3(const std::vector<std::size_t> &indices,
+    rct::KeyMatrix &referenced_enotes_components_out,
+    std::vector<ge_p3> &referenced_enotes_points_out) const
+{
+    boost::shared_lock<boost::shared_mutex> lock{m_ledger_mutex};
+
+    // gets squashed enotes and their decompressed points
+    rct::KeyMatrix referenced_enotes_components_temp{indices.size(), 1};
+    std::vector<ge_p3> referenced_enotes_points_temp;
+    std::vector<std::size_t> cache_misses;
+    referenced_enotes_points_temp.resize(indices.size());
 
     for (const std::size_t index : indices)
     {
-        CHECK_AND_ASSERT_THROW_MES(m_sp_squashed_enotes.find(index) != m_sp_squashed_enotes.end(),
+        CHECK_AND_ASSERT_THROW_MES(squashed_enote_exists_impl(index),
             "Tried to get squashed enote that doesn't exist.");
-        referenced_enotes_components_temp.emplace_back(
-                rct::keyV{m_sp_squashed_enotes.at(index)}
-            );
+    }
+
+    for (std::size_t i{0}; i < indices.size(); ++i)
+        referenced_enotes_components_temp[i][0] = m_sp_squashed_enotes[indices[i]];
+
+    // 1. cached points (from this thread's NUMA node cache)
+    SquashedEnoteCache &cache{get_squashed_enote_cache()};
+    {
+        std::lock_guard<std::mutex> cache_lock{cache.m_mutex};
+
+        for (std::size_t i{0}; i < indices.size(); ++i)
+        {
+            if (!try_get_cached_squashed_enote_p3_impl(cache, indices[i], referenced_enotes_points_temp[i]))
+                cache_misses.push_back(i);
+        }
+    }
+
+    // 2. decompress the rest without holding the cache lock
+    for (const std::size_t i : cache_misses)
+    {
+        CHECK_AND_ASSERT_THROW_MES(ge_frombytes_vartime(&referenced_enotes_points_temp[i],
+                referenced_enotes_components_temp[i][0].bytes) == 0,
+            "Failed to decompress squashed enote.");
+    }
+
+    // 3. cache the new points
+    if (cache_misses.size() > 0)
+    {
+        std::lock_guard<std::mutex> cache_lock{cache.m_mutex};
+
+        for (const std::size_t i : cache_misses)
+            cache_squashed_enote_p3_impl(cache, indices[i], referenced_enotes_points_temp[i]);
     }
 
     referenced_enotes_components_out = std::move(referenced_enotes_components_temp);
+    referenced_enotes_points_out = std::move(referenced_enotes_points_temp);
+}
+//-------------------------------------------------------------------------------------------------------------------
+bool MockLedgerContext::try_get_reference_set_components_sp_v2_cached(const std::vector<std::size_t> &indices,
+    rct::KeyMatrix &referenced_enotes_components_out,
+    std::vector<ge_p3> &referenced_enotes_points_out,
+    std::vector<ge_cached> &referenced_enotes_cached_out) const
+{
+    if (!m_store_converted_squashed_enotes)
+        return false;
+
+    boost::shared_lock<boost::shared_mutex> lock{m_ledger_mutex};
+
+    // gets squashed enotes and their stored conversions
+    for (const std::size_t index : indices)
+    {
+        CHECK_AND_ASSERT_THROW_MES(squashed_enote_exists_impl(index),
+            "Tried to get squashed enote that doesn't exist.");
+    }
+
+    referenced_enotes_components_out.resize(indices.size(), 1);
+    referenced_enotes_points_out.resize(indices.size());
+    referenced_enotes_cached_out.resize(indices.size());
+
+    for (std::size_t i{0}; i < indices.size(); ++i)
+    {
+        referenced_enotes_components_out[i][0] = m_sp_squashed_enotes[indices[i]];
+        referenced_enotes_points_out[i] = m_sp_squashed_enote_p3s[indices[i]];
+        referenced_enotes_cached_out[i] = m_sp_squashed_enote_cacheds[indices[i]];
+    }
+
+    return true;
 }
 //-------------------------------------------------------------------------------------------------------------------
 void MockLedgerContext::add_transaction_sp_concise_v1(const MockTxSpConciseV1 &tx_to_add)
 {
-    std::lock_guard<std::mutex> lock{m_ledger_mutex};
+    // collect the linking tags before taking the ledger lock
+    std::vector<crypto::key_image> linking_tags;
+    linking_tags.reserve(tx_to_add.m_input_images.size());
+    for (const auto &input_image : tx_to_add.m_input_images)
+        linking_tags.push_back(input_image.m_key_image);
+
+    boost::unique_lock<boost::shared_mutex> lock{m_ledger_mutex};
+    const LinkingTagShardLocks linking_tag_locks{lock_linking_tag_shards()};
 
     // add linking tags
-    for (const auto &input_image : tx_to_add.m_input_images)
-        this->add_linking_tag_sp_v1_impl(input_image.m_key_image);
+    this->add_linking_tags_sp_v1_impl(linking_tags);
 
     // add new enotes
     for (const auto &output_enote : tx_to_add.m_outputs)
@@ -135,11 +418,17 @@ void MockLedgerContext::add_transaction_sp_concise_v1(const MockTxSpConciseV1 &t
 //-------------------------------------------------------------------------------------------------------------------
 void MockLedgerContext::add_transaction_sp_merge_v1(const MockTxSpMergeV1 &tx_to_add)
 {
-    std::lock_guard<std::mutex> lock{m_ledger_mutex};
+    // collect the linking tags before taking the ledger lock
+    std::vector<crypto::key_image> linking_tags;
+    linking_tags.reserve(tx_to_add.m_input_images.size());
+    for (const auto &input_image : tx_to_add.m_input_images)
+        linking_tags.push_back(input_image.m_key_image);
+
+    boost::unique_lock<boost::shared_mutex> lock{m_ledger_mutex};
+    const LinkingTagShardLocks linking_tag_locks{lock_linking_tag_shards()};
 
     // add linking tags
-    for (const auto &input_image : tx_to_add.m_input_images)
-        this->add_linking_tag_sp_v1_impl(input_image.m_key_image);
+    this->add_linking_tags_sp_v1_impl(linking_tags);
 
     // add new enotes
     for (const auto &output_enote : tx_to_add.m_outputs)
@@ -150,11 +439,17 @@ void MockLedgerContext::add_transaction_sp_merge_v1(const MockTxSpMergeV1 &tx_to
 //-------------------------------------------------------------------------------------------------------------------
 void MockLedgerContext::add_transaction_sp_plain_v1(const MockTxSpPlainV1 &tx_to_add)
 {
-    std::lock_guard<std::mutex> lock{m_ledger_mutex};
+    // collect the linking tags before taking the ledger lock
+    std::vector<crypto::key_image> linking_tags;
+    linking_tags.reserve(tx_to_add.m_input_images.size());
+    for (const auto &input_image : tx_to_add.m_input_images)
+        linking_tags.push_back(input_image.m_key_image);
+
+    boost::unique_lock<boost::shared_mutex> lock{m_ledger_mutex};
+    const LinkingTagShardLocks linking_tag_locks{lock_linking_tag_shards()};
 
     // add linking tags
-    for (const auto &input_image : tx_to_add.m_input_images)
-        this->add_linking_tag_sp_v1_impl(input_image.m_key_image);
+    this->add_linking_tags_sp_v1_impl(linking_tags);
 
     // add new enotes
     for (const auto &output_enote : tx_to_add.m_outputs)
@@ -165,72 +460,632 @@ void MockLedgerContext::add_transaction_sp_plain_v1(const MockTxSpPlainV1 &tx_to
 //-------------------------------------------------------------------------------------------------------------------
 void MockLedgerContext::add_transaction_sp_squashed_v1(const MockTxSpSquashedV1 &tx_to_add)
 {
-    std::lock_guard<std::mutex> lock{m_ledger_mutex};
+    // squash the new enotes and collect the linking tags before taking the ledger lock
+    rct::keyV squashed_enotes;
+    make_squashed_enotes_sp_v1(tx_to_add.m_outputs, squashed_enotes, 0);
 
-    // add linking tags
+    std::vector<crypto::key_image> linking_tags;
+    linking_tags.reserve(tx_to_add.m_input_images.size());
     for (const auto &input_image : tx_to_add.m_input_images)
-        this->add_linking_tag_sp_v1_impl(input_image.m_key_image);
+        linking_tags.push_back(input_image.m_key_image);
+
+    boost::unique_lock<boost::shared_mutex> lock{m_ledger_mutex};
+    const LinkingTagShardLocks linking_tag_locks{lock_linking_tag_shards()};
+
+    // add linking tags
+    this->add_linking_tags_sp_v1_impl(linking_tags);
 
     // add new enotes
-    for (const auto &output_enote : tx_to_add.m_outputs)
-        this->add_enote_sp_v2_impl(output_enote);
+    for (std::size_t output_index{0}; output_index < tx_to_add.m_outputs.size(); ++output_index)
+        this->add_enote_sp_v2_impl(tx_to_add.m_outputs[output_index], squashed_enotes[output_index]);
 
     // note: for mock ledger, don't store the whole tx
 }
 //-------------------------------------------------------------------------------------------------------------------
 void MockLedgerContext::add_linking_tag_sp_v1(const crypto::key_image &linking_tag)
 {
-    std::lock_guard<std::mutex> lock{m_ledger_mutex};
+    boost::unique_lock<boost::shared_mutex> lock{get_linking_tag_shard(linking_tag).m_mutex};
 
     add_linking_tag_sp_v1_impl(linking_tag);
 }
 //-------------------------------------------------------------------------------------------------------------------
 std::size_t MockLedgerContext::add_enote_sp_v1(const MockENoteSpV1 &enote)
 {
-    std::lock_guard<std::mutex> lock{m_ledger_mutex};
+    boost::unique_lock<boost::shared_mutex> lock{m_ledger_mutex};
 
     return add_enote_sp_v1_impl(enote);
 }
 //-------------------------------------------------------------------------------------------------------------------
 std::size_t MockLedgerContext::add_enote_sp_v2(const MockENoteSpV1 &enote)
 {
-    std::lock_guard<std::mutex> lock{m_ledger_mutex};
+    boost::unique_lock<boost::shared_mutex> lock{m_ledger_mutex};
 
     return add_enote_sp_v2_impl(enote);
 }
 //-------------------------------------------------------------------------------------------------------------------
+std::size_t MockLedgerContext::add_enotes_sp_v1(const std::vector<MockENoteSpV1> &enotes)
+{
+    boost::unique_lock<boost::shared_mutex> lock{m_ledger_mutex};
+
+    const std::size_t first_index{get_num_enotes_impl()};
+
+    for (const MockENoteSpV1 &enote : enotes)
+        add_enote_sp_v1_impl(enote);
+
+    return first_index;
+}
+//-------------------------------------------------------------------------------------------------------------------
+std::size_t MockLedgerContext::add_enotes_sp_v2(const std::vector<MockENoteSpV1> &enotes,
+    const std::size_t num_threads)
+{
+    // squash the enotes (no need to hold the ledger lock)
+    rct::keyV squashed_enotes;
+    make_squashed_enotes_sp_v1(enotes, squashed_enotes, num_threads);
+
+    // add them
+    boost::unique_lock<boost::shared_mutex> lock{m_ledger_mutex};
+
+    const std::size_t first_index{get_num_enotes_impl()};
+
+    for (std::size_t i{0}; i < enotes.size(); ++i)
+        add_enote_sp_v2_impl(enotes[i], squashed_enotes[i]);
+
+    return first_index;
+}
+//-------------------------------------------------------------------------------------------------------------------
+void MockLedgerContext::clear_squashed_enote_cache()
+{
+    for (SquashedEnoteCache &cache : m_sp_squashed_enote_caches)
+    {
+        std::lock_guard<std::mutex> cache_lock{cache.m_mutex};
+
+        cache.m_enotes.clear();
+        cache.m_order.clear();
+    }
+
+    if (m_sp_squashed_enote_straus_cache)
+    {
+        m_sp_squashed_enote_straus_cache->clear();
+        m_sp_squashed_enote_straus_cache->reset_stats();
+    }
+}
+//-------------------------------------------------------------------------------------------------------------------
+std::size_t MockLedgerContext::get_num_enotes() const
+{
+    boost::shared_lock<boost::shared_mutex> lock{m_ledger_mutex};
+
+    return get_num_enotes_impl();
+}
+//-------------------------------------------------------------------------------------------------------------------
+std::size_t MockLedgerContext::get_enote_storage_bytes(const MockLedgerStorageMode storage_mode,
+    const bool store_converted_squashed_enotes)
+{
+    std::size_t enote_bytes{sizeof(rct::key)};
+    if (storage_mode != MockLedgerStorageMode::SQUASHED_ONLY)
+        enote_bytes += 2*sizeof(rct::key);
+    if (storage_mode == MockLedgerStorageMode::FULL)
+        enote_bytes += sizeof(rct::xmr_amount) + sizeof(unsigned char) + sizeof(char);
+    if (store_converted_squashed_enotes)
+        enote_bytes += sizeof(ge_p3) + sizeof(ge_cached);
+
+    return enote_bytes;
+}
+//-------------------------------------------------------------------------------------------------------------------
+std::size_t MockLedgerContext::get_storage_bytes() const
+{
+    boost::shared_lock<boost::shared_mutex> lock{m_ledger_mutex};
+
+    std::size_t storage_bytes{
+            m_sp_enote_onetime_addresses.capacity()*sizeof(rct::key) +
+            m_sp_enote_amount_commitments.capacity()*sizeof(rct::key) +
+            m_sp_enote_encoded_amounts.capacity()*sizeof(rct::xmr_amount) +
+            m_sp_enote_view_tags.capacity()*sizeof(unsigned char) +
+            m_sp_squashed_enotes.capacity()*sizeof(rct::key) +
+            m_sp_squashed_enote_flags.capacity()*sizeof(char) +
+            m_sp_squashed_enote_p3s.capacity()*sizeof(ge_p3) +
+            m_sp_squashed_enote_cacheds.capacity()*sizeof(ge_cached)
+        };
+
+    for (const LinkingTagShard &shard : m_sp_linking_tag_shards)
+    {
+        boost::shared_lock<boost::shared_mutex> shard_lock{shard.m_mutex};
+        storage_bytes += shard.m_linking_tags.get_storage_bytes();
+    }
+
+    return storage_bytes;
+}
+//-------------------------------------------------------------------------------------------------------------------
+bool MockLedgerContext::save(const std::string &path) const
+{
+    boost::shared_lock<boost::shared_mutex> lock{m_ledger_mutex};
+
+    // collect the linking tags
+    std::vector<crypto::key_image> linking_tags;
+
+    for (const LinkingTagShard &shard : m_sp_linking_tag_shards)
+    {
+        boost::shared_lock<boost::shared_mutex> shard_lock{shard.m_mutex};
+        shard.m_linking_tags.get_linking_tags(linking_tags);
+    }
+    std::sort(linking_tags.begin(), linking_tags.end(), linking_tag_less);
+
+    // header
+    MockLedgerSnapshotHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.m_magic, MOCK_LEDGER_SNAPSHOT_MAGIC, sizeof(header.m_magic));
+    header.m_version = MOCK_LEDGER_SNAPSHOT_VERSION;
+    header.m_flags = m_store_converted_squashed_enotes ? MOCK_LEDGER_SNAPSHOT_FLAG_CONVERTED : 0;
+    if (!stores_full_enotes())
+        header.m_flags |= MOCK_LEDGER_SNAPSHOT_FLAG_NO_FULL_ENOTES;
+    if (!stores_enote_components())
+        header.m_flags |= MOCK_LEDGER_SNAPSHOT_FLAG_NO_ENOTE_COMPONENTS;
+    header.m_ge_p3_size = sizeof(ge_p3);
+    header.m_ge_cached_size = sizeof(ge_cached);
+    header.m_num_enotes = get_num_enotes_impl();
+    header.m_num_linking_tags = linking_tags.size();
+    header.m_state_commitment = ledger_state_commitment(m_sp_squashed_enotes, linking_tags);
+
+    // columns (byte-size columns last, so every wider column stays aligned; columns the ledger doesn't keep are empty)
+    std::ofstream snapshot{path, std::ios::binary | std::ios::trunc};
+    if (!snapshot)
+        return false;
+
+    snapshot.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    write_ledger_snapshot_column(snapshot, m_sp_enote_onetime_addresses);
+    write_ledger_snapshot_column(snapshot, m_sp_enote_amount_commitments);
+    write_ledger_snapshot_column(snapshot, m_sp_enote_encoded_amounts);
+    write_ledger_snapshot_column(snapshot, m_sp_squashed_enotes);
+    if (m_store_converted_squashed_enotes)
+    {
+        write_ledger_snapshot_column(snapshot, m_sp_squashed_enote_p3s);
+        write_ledger_snapshot_column(snapshot, m_sp_squashed_enote_cacheds);
+    }
+    write_ledger_snapshot_column(snapshot, linking_tags);
+    write_ledger_snapshot_column(snapshot, m_sp_enote_view_tags);
+    write_ledger_snapshot_column(snapshot, m_sp_squashed_enote_flags);
+
+    snapshot.close();
+    return snapshot.good();
+}
+//-------------------------------------------------------------------------------------------------------------------
+rct::key MockLedgerContext::get_state_commitment() const
+{
+    boost::shared_lock<boost::shared_mutex> lock{m_ledger_mutex};
+
+    std::vector<crypto::key_image> linking_tags;
+
+    for (const LinkingTagShard &shard : m_sp_linking_tag_shards)
+    {
+        boost::shared_lock<boost::shared_mutex> shard_lock{shard.m_mutex};
+        shard.m_linking_tags.get_linking_tags(linking_tags);
+    }
+    std::sort(linking_tags.begin(), linking_tags.end(), linking_tag_less);
+
+    return ledger_state_commitment(m_sp_squashed_enotes, linking_tags);
+}
+//-------------------------------------------------------------------------------------------------------------------
+bool MockLedgerContext::load(const std::string &path)
+{
+    return load_impl(path, nullptr);
+}
+//-------------------------------------------------------------------------------------------------------------------
+bool MockLedgerContext::load(const std::string &path, const rct::key &expected_state_commitment)
+{
+    return load_impl(path, &expected_state_commitment);
+}
+//-------------------------------------------------------------------------------------------------------------------
+bool MockLedgerContext::load_impl(const std::string &path, const rct::key *expected_state_commitment)
+{
+    std::ifstream snapshot{path, std::ios::binary | std::ios::ate};
+    if (!snapshot)
+        return false;
+    const std::uint64_t file_size{static_cast<std::uint64_t>(snapshot.tellg())};
+    snapshot.seekg(0);
+
+    // header (check it matches the file before allocating anything)
+    MockLedgerSnapshotHeader header;
+    if (file_size < sizeof(header) ||
+        !snapshot.read(reinterpret_cast<char*>(&header), sizeof(header)))
+        return false;
+    if (memcmp(header.m_magic, MOCK_LEDGER_SNAPSHOT_MAGIC, sizeof(header.m_magic)) != 0 ||
+        header.m_version != MOCK_LEDGER_SNAPSHOT_VERSION ||
+        header.m_ge_p3_size != sizeof(ge_p3) ||
+        header.m_ge_cached_size != sizeof(ge_cached) ||
+        ledger_snapshot_size(header) != file_size)
+        return false;
+    const bool checkpointed{expected_state_commitment != nullptr};
+    if (checkpointed && !(header.m_state_commitment == *expected_state_commitment))
+        return false;
+
+    const bool snapshot_has_converted{(header.m_flags & MOCK_LEDGER_SNAPSHOT_FLAG_CONVERTED) != 0};
+    const bool snapshot_has_full_enotes{
+            (header.m_flags & (MOCK_LEDGER_SNAPSHOT_FLAG_NO_FULL_ENOTES | MOCK_LEDGER_SNAPSHOT_FLAG_NO_ENOTE_COMPONENTS))
+                == 0
+        };
+    const bool snapshot_has_components{(header.m_flags & MOCK_LEDGER_SNAPSHOT_FLAG_NO_ENOTE_COMPONENTS) == 0};
+    const std::size_t num_enotes{static_cast<std::size_t>(header.m_num_enotes)};
+
+    // the snapshot must have every column this ledger keeps
+    if ((stores_full_enotes() && !snapshot_has_full_enotes) ||
+        (stores_enote_components() && !snapshot_has_components))
+        return false;
+
+    // columns (no locks needed until they are swapped in)
+    LedgerColumn<rct::key> onetime_addresses;
+    LedgerColumn<rct::key> amount_commitments;
+    LedgerColumn<rct::xmr_amount> encoded_amounts;
+    LedgerColumn<unsigned char> view_tags;
+    LedgerColumn<rct::key> squashed_enotes;
+    LedgerColumn<char> squashed_enote_flags;
+    LedgerColumn<ge_p3> squashed_enote_p3s;
+    LedgerColumn<ge_cached> squashed_enote_cacheds;
+    std::vector<crypto::key_image> linking_tags;
+
+    const std::size_t num_component_enotes{snapshot_has_components ? num_enotes : 0};
+    const std::size_t num_full_enotes{snapshot_has_full_enotes ? num_enotes : 0};
+
+    if (!read_ledger_snapshot_column(snapshot, num_component_enotes, onetime_addresses) ||
+        !read_ledger_snapshot_column(snapshot, num_component_enotes, amount_commitments) ||
+        !read_ledger_snapshot_column(snapshot, num_full_enotes, encoded_amounts) ||
+        !read_ledger_snapshot_column(snapshot, num_enotes, squashed_enotes))
+        return false;
+    if (snapshot_has_converted)
+    {
+        // a checkpoint doesn't cover the converted squashed enotes, they are recomputed below
+        if (m_store_converted_squashed_enotes && !checkpointed)
+        {
+            if (!read_ledger_snapshot_column(snapshot, num_enotes, squashed_enote_p3s) ||
+                !read_ledger_snapshot_column(snapshot, num_enotes, squashed_enote_cacheds))
+                return false;
+        }
+        else
+            snapshot.seekg(num_enotes*(sizeof(ge_p3) + sizeof(ge_cached)), std::ios::cur);
+    }
+    if (!read_ledger_snapshot_column(snapshot, static_cast<std::size_t>(header.m_num_linking_tags), linking_tags) ||
+        !read_ledger_snapshot_column(snapshot, num_full_enotes, view_tags) ||
+        !read_ledger_snapshot_column(snapshot, num_full_enotes, squashed_enote_flags))
+        return false;
+
+    // the columns must match the header's commitment (checked before any enotes are squashed or converted)
+    if (!std::is_sorted(linking_tags.begin(), linking_tags.end(), linking_tag_less) ||
+        !(ledger_state_commitment(squashed_enotes, linking_tags) == header.m_state_commitment))
+        return false;
+
+    // a checkpoint only vouches for the squashed enotes and linking tags, so with one, everything membership proofs
+    //   read must follow from them: enotes without a squashed enote are refused, and kept enote components must
+    //   squash to their squashed enote
+    if (checkpointed)
+    {
+        if (snapshot_has_full_enotes &&
+                std::find(squashed_enote_flags.begin(), squashed_enote_flags.end(), 0) != squashed_enote_flags.end())
+            return false;
+
+        if (stores_enote_components())
+        {
+            std::atomic<bool> components_match{true};
+            const bool checked{
+                    run_indexed_jobs(num_enotes, 0,
+                        [&](const std::size_t index)
+                        {
+                            rct::key squashed_enote;
+                            try
+                            {
+                                seraphis_squashed_enote_Q(onetime_addresses[index],
+                                    amount_commitments[index],
+                                    squashed_enote);
+                            }
+                            catch (...)
+                            {
+                                components_match = false;
+                                return;
+                            }
+
+                            if (!(squashed_enote == squashed_enotes[index]))
+                                components_match = false;
+                        })
+                };
+            if (!checked || !components_match)
+                return false;
+        }
+    }
+
+    // drop the columns this ledger doesn't keep (squashing the enotes that don't have a squashed enote yet)
+    bool squashed_new_enotes{false};
+    if (!stores_full_enotes() && snapshot_has_full_enotes)
+    {
+        for (std::size_t index{0}; index < num_enotes; ++index)
+        {
+            if (squashed_enote_flags[index])
+                continue;
+
+            seraphis_squashed_enote_Q(onetime_addresses[index], amount_commitments[index], squashed_enotes[index]);
+            squashed_new_enotes = true;
+        }
+
+        LedgerColumn<rct::xmr_amount>{}.swap(encoded_amounts);
+        LedgerColumn<unsigned char>{}.swap(view_tags);
+        LedgerColumn<char>{}.swap(squashed_enote_flags);
+    }
+    if (!stores_enote_components() && snapshot_has_components)
+    {
+        LedgerColumn<rct::key>{}.swap(onetime_addresses);
+        LedgerColumn<rct::key>{}.swap(amount_commitments);
+    }
+
+    // convert the squashed enotes if the snapshot doesn't have them converted (or has identities for the enotes that
+    //   were just squashed, or is loaded against a checkpoint)
+    if (m_store_converted_squashed_enotes && (!snapshot_has_converted || squashed_new_enotes || checkpointed))
+    {
+        squashed_enote_p3s.resize(num_enotes);
+        squashed_enote_cacheds.resize(num_enotes);
+
+        for (std::size_t index{0}; index < num_enotes; ++index)
+        {
+            if (stores_full_enotes() && !squashed_enote_flags[index])
+                squashed_enote_p3s[index] = ge_p3_identity;
+            else if (ge_frombytes_vartime(&squashed_enote_p3s[index], squashed_enotes[index].bytes) != 0)
+                return false;
+            ge_p3_to_cached(&squashed_enote_cacheds[index], &squashed_enote_p3s[index]);
+        }
+    }
+
+    // rebuild the linking tag shards (a repeated tag means the snapshot is corrupt)
+    std::array<LinkingTagSet, LINKING_TAG_SHARD_COUNT> linking_tag_sets;
+    std::array<std::vector<crypto::key_image>, LINKING_TAG_SHARD_COUNT> tags_per_shard;
+    for (const crypto::key_image &linking_tag : linking_tags)
+        tags_per_shard[get_linking_tag_shard_index(linking_tag)].push_back(linking_tag);
+
+    for (std::size_t shard_index{0}; shard_index < LINKING_TAG_SHARD_COUNT; ++shard_index)
+    {
+        if (linking_tag_sets[shard_index].insert_batch(epee::to_span(tags_per_shard[shard_index])) !=
+                tags_per_shard[shard_index].size())
+            return false;
+    }
+
+    // what is swapped in must be exactly what the checkpoint commits to
+    if (checkpointed && !(ledger_state_commitment(squashed_enotes, linking_tags) == *expected_state_commitment))
+        return false;
+
+    // swap in the new contents
+    {
+        boost::unique_lock<boost::shared_mutex> lock{m_ledger_mutex};
+        LinkingTagShardLocks shard_locks{lock_linking_tag_shards()};
+
+        for (std::size_t shard_index{0}; shard_index < LINKING_TAG_SHARD_COUNT; ++shard_index)
+            m_sp_linking_tag_shards[shard_index].m_linking_tags = std::move(linking_tag_sets[shard_index]);
+
+        m_sp_enote_onetime_addresses = std::move(onetime_addresses);
+        m_sp_enote_amount_commitments = std::move(amount_commitments);
+        m_sp_enote_encoded_amounts = std::move(encoded_amounts);
+        m_sp_enote_view_tags = std::move(view_tags);
+        m_sp_squashed_enotes = std::move(squashed_enotes);
+        m_sp_squashed_enote_flags = std::move(squashed_enote_flags);
+        m_sp_squashed_enote_p3s = std::move(squashed_enote_p3s);
+        m_sp_squashed_enote_cacheds = std::move(squashed_enote_cacheds);
+
+        // cached decompressions (and straus multiples) refer to the old enotes
+        clear_squashed_enote_cache();
+    }
+
+    return true;
+}
+//-------------------------------------------------------------------------------------------------------------------
+//-------------------------------------------------------------------------------------------------------------------
+std::size_t MockLedgerContext::get_linking_tag_shard_index(const crypto::key_image &linking_tag)
+{
+    // note: use a byte not consumed by LinkingTagSet's slot hash (the first 8 bytes), so each shard's set still sees
+    //       well-distributed hashes
+    return static_cast<unsigned char>(linking_tag.data[sizeof(std::uint64_t)]) & (LINKING_TAG_SHARD_COUNT - 1);
+}
+//-------------------------------------------------------------------------------------------------------------------
+MockLedgerContext::LinkingTagShard& MockLedgerContext::get_linking_tag_shard(const crypto::key_image &linking_tag)
+{
+    return m_sp_linking_tag_shards[get_linking_tag_shard_index(linking_tag)];
+}
+//-------------------------------------------------------------------------------------------------------------------
+const MockLedgerContext::LinkingTagShard& MockLedgerContext::get_linking_tag_shard(
+    const crypto::key_image &linking_tag) const
+{
+    return m_sp_linking_tag_shards[get_linking_tag_shard_index(linking_tag)];
+}
+//-------------------------------------------------------------------------------------------------------------------
+MockLedgerContext::LinkingTagShardLocks MockLedgerContext::lock_linking_tag_shards()
+{
+    LinkingTagShardLocks locks;
+
+    for (std::size_t shard_index{0}; shard_index < LINKING_TAG_SHARD_COUNT; ++shard_index)
+        locks[shard_index] = boost::unique_lock<boost::shared_mutex>{m_sp_linking_tag_shards[shard_index].m_mutex};
+
+    return locks;
+}
 //-------------------------------------------------------------------------------------------------------------------
 bool MockLedgerContext::linking_tag_exists_sp_v1_impl(const crypto::key_image &linking_tag) const
 {
-    return m_sp_linking_tags.find(linking_tag) != m_sp_linking_tags.end();
+    return get_linking_tag_shard(linking_tag).m_linking_tags.contains(linking_tag);
 }
 //-------------------------------------------------------------------------------------------------------------------
 void MockLedgerContext::add_linking_tag_sp_v1_impl(const crypto::key_image &linking_tag)
 {
-    CHECK_AND_ASSERT_THROW_MES(!linking_tag_exists_sp_v1_impl(linking_tag),
+    CHECK_AND_ASSERT_THROW_MES(get_linking_tag_shard(linking_tag).m_linking_tags.insert(linking_tag),
         "Tried to add linking tag that already linking_tag_exists_sp_v1.");
+}
+//-------------------------------------------------------------------------------------------------------------------
+void MockLedgerContext::add_linking_tags_sp_v1_impl(const std::vector<crypto::key_image> &linking_tags)
+{
+    // group the tags by shard
+    std::array<std::vector<crypto::key_image>, LINKING_TAG_SHARD_COUNT> tags_per_shard;
+    for (const crypto::key_image &linking_tag : linking_tags)
+        tags_per_shard[get_linking_tag_shard_index(linking_tag)].push_back(linking_tag);
+
+    // check none of the tags exist yet or repeat, so a failed add doesn't leave some of them in the ledger
+    std::vector<bool> shard_tags_exist;
+
+    for (std::size_t shard_index{0}; shard_index < LINKING_TAG_SHARD_COUNT; ++shard_index)
+    {
+        std::vector<crypto::key_image> &shard_tags{tags_per_shard[shard_index]};
+
+        std::sort(shard_tags.begin(), shard_tags.end(),
+                [](const crypto::key_image &a, const crypto::key_image &b) -> bool
+                {
+                    return memcmp(a.data, b.data, sizeof(crypto::key_image)) < 0;
+                }
+            );
+        CHECK_AND_ASSERT_THROW_MES(std::adjacent_find(shard_tags.begin(), shard_tags.end()) == shard_tags.end(),
+            "Tried to add linking tag that already linking_tag_exists_sp_v1.");
+
+        m_sp_linking_tag_shards[shard_index].m_linking_tags.contains_batch(epee::to_span(shard_tags), shard_tags_exist);
+        CHECK_AND_ASSERT_THROW_MES(std::find(shard_tags_exist.begin(), shard_tags_exist.end(), true) ==
+                shard_tags_exist.end(),
+            "Tried to add linking tag that already linking_tag_exists_sp_v1.");
+    }
+
+    // add each shard's tags in one batch
+    for (std::size_t shard_index{0}; shard_index < LINKING_TAG_SHARD_COUNT; ++shard_index)
+        m_sp_linking_tag_shards[shard_index].m_linking_tags.insert_batch(epee::to_span(tags_per_shard[shard_index]));
+}
+//-------------------------------------------------------------------------------------------------------------------
+std::size_t MockLedgerContext::get_num_enotes_impl() const
+{
+    // note: the squashed enote column is kept in every storage mode
+    return m_sp_squashed_enotes.size();
+}
+//-------------------------------------------------------------------------------------------------------------------
+bool MockLedgerContext::squashed_enote_exists_impl(const std::size_t index) const
+{
+    if (!stores_full_enotes())
+        return index < m_sp_squashed_enotes.size();
 
-    m_sp_linking_tags.insert(linking_tag);
+    return index < m_sp_squashed_enote_flags.size() && m_sp_squashed_enote_flags[index];
+}
+//-------------------------------------------------------------------------------------------------------------------
+bool MockLedgerContext::squashed_enotes_exist_impl(const LedgerIndexRange &range) const
+{
+    if (range.m_count > m_sp_squashed_enotes.size() ||
+        range.m_first > m_sp_squashed_enotes.size() - range.m_count)
+        return false;
+
+    if (!stores_full_enotes())
+        return true;
+
+    const auto run_begin = m_sp_squashed_enote_flags.begin() + range.m_first;
+    return std::find(run_begin, run_begin + range.m_count, 0) == run_begin + range.m_count;
 }
 //-------------------------------------------------------------------------------------------------------------------
 std::size_t MockLedgerContext::add_enote_sp_v1_impl(const MockENoteSpV1 &enote)
 {
-    m_sp_enotes[m_sp_enotes.size()] = enote;
+    // every enote has a squashed enote if full enotes aren't stored
+    if (!stores_full_enotes())
+        return add_enote_sp_v2_impl(enote);
+
+    m_sp_enote_onetime_addresses.emplace_back(enote.m_onetime_address);
+    m_sp_enote_amount_commitments.emplace_back(enote.m_amount_commitment);
+    m_sp_enote_encoded_amounts.emplace_back(enote.m_encoded_amount);
+    m_sp_enote_view_tags.emplace_back(enote.m_view_tag);
 
-    return m_sp_enotes.size() - 1;
+    // no squashed enote (keep the squashed column aligned with the enote columns)
+    m_sp_squashed_enotes.emplace_back(rct::zero());
+    m_sp_squashed_enote_flags.emplace_back(false);
+
+    if (m_store_converted_squashed_enotes)
+    {
+        m_sp_squashed_enote_p3s.emplace_back(ge_p3_identity);
+        m_sp_squashed_enote_cacheds.emplace_back();
+        ge_p3_to_cached(&m_sp_squashed_enote_cacheds.back(), &ge_p3_identity);
+    }
+
+    return get_num_enotes_impl() - 1;
 }
 //-------------------------------------------------------------------------------------------------------------------
 std::size_t MockLedgerContext::add_enote_sp_v2_impl(const MockENoteSpV1 &enote)
 {
-    // add the enote
-    m_sp_enotes[m_sp_enotes.size()] = enote;
+    rct::key squashed_enote;
+    seraphis_squashed_enote_Q(enote.m_onetime_address, enote.m_amount_commitment, squashed_enote);
+
+    return add_enote_sp_v2_impl(enote, squashed_enote);
+}
+//-------------------------------------------------------------------------------------------------------------------
+std::size_t MockLedgerContext::add_enote_sp_v2_impl(const MockENoteSpV1 &enote, const rct::key &squashed_enote)
+{
+    std::size_t index{get_num_enotes_impl()};
+
+    if (stores_full_enotes())
+    {
+        // add the enote
+        index = add_enote_sp_v1_impl(enote);
+
+        // add the squashed enote
+        m_sp_squashed_enotes[index] = squashed_enote;
+        m_sp_squashed_enote_flags[index] = true;
+    }
+    else
+    {
+        // add the squashed enote, and the enote components if they are kept
+        if (stores_enote_components())
+        {
+            m_sp_enote_onetime_addresses.emplace_back(enote.m_onetime_address);
+            m_sp_enote_amount_commitments.emplace_back(enote.m_amount_commitment);
+        }
+        m_sp_squashed_enotes.emplace_back(squashed_enote);
+
+        if (m_store_converted_squashed_enotes)
+        {
+            m_sp_squashed_enote_p3s.emplace_back();
+            m_sp_squashed_enote_cacheds.emplace_back();
+        }
+    }
+
+    if (m_store_converted_squashed_enotes)
+    {
+        CHECK_AND_ASSERT_THROW_MES(ge_frombytes_vartime(&m_sp_squashed_enote_p3s[index], squashed_enote.bytes) == 0,
+            "Failed to decompress squashed enote.");
+        ge_p3_to_cached(&m_sp_squashed_enote_cacheds[index], &m_sp_squashed_enote_p3s[index]);
+    }
+
+    return index;
+}
+//-------------------------------------------------------------------------------------------------------------------
+MockLedgerContext::SquashedEnoteCache& MockLedgerContext::get_squashed_enote_cache() const
+{
+    return m_sp_squashed_enote_caches[
+        std::min(tools::get_current_numa_node(), m_sp_squashed_enote_caches.size() - 1)
+    ];
+}
+//-------------------------------------------------------------------------------------------------------------------
+bool MockLedgerContext::try_get_cached_squashed_enote_p3_impl(SquashedEnoteCache &cache,
+    const std::size_t index,
+    ge_p3 &squashed_enote_p3_out) const
+{
+    auto cached = cache.m_enotes.find(index);
+    if (cached == cache.m_enotes.end())
+        return false;
+
+    // cache hit: move to front of the LRU list
+    cache.m_order.splice(cache.m_order.begin(), cache.m_order, cached->second.second);
+    squashed_enote_p3_out = cached->second.first;
 
-    // add the squashed enote
-    seraphis_squashed_enote_Q(enote.m_onetime_address,
-        enote.m_amount_commitment,
-        m_sp_squashed_enotes[m_sp_enotes.size() - 1]);
+    return true;
+}
+//-------------------------------------------------------------------------------------------------------------------
+void MockLedgerContext::cache_squashed_enote_p3_impl(SquashedEnoteCache &cache,
+    const std::size_t index,
+    const ge_p3 &squashed_enote_p3) const
+{
+    if (m_sp_squashed_enote_cache_limit == 0)
+        return;
+
+    // another reader may have cached this enote (or an index may repeat in one lookup)
+    if (cache.m_enotes.find(index) != cache.m_enotes.end())
+        return;
+
+    // evict the least recently used enote if the cache is full
+    if (cache.m_enotes.size() >= m_sp_squashed_enote_cache_limit)
+    {
+        cache.m_enotes.erase(cache.m_order.back());
+        cache.m_order.pop_back();
+    }
 
-    return m_sp_enotes.size() - 1;
+    cache.m_order.push_front(index);
+    cache.m_enotes[index] = {squashed_enote_p3, cache.m_order.begin()};
 }
 //-------------------------------------------------------------------------------------------------------------------
 } //namespace mock_tx
@@ -29,22 +29,36 @@
 // Mock ledger context: for testing
 // note: In a real ledger, new enotes and new linking tags from a tx must be committed in ONE atomic operation. Otherwise,
 //       the order of linking tags and enotes may be misaligned.
+// - Reads take shared locks so concurrent validators don't serialize on the ledger; linking tags are sharded so
+//   linking tag lookups only touch one shard's lock.
 // NOT FOR PRODUCTION
 
 #pragma once
 
 //local headers
+#include "common/huge_page_allocator.h"
+#include "common/numa_topology.h"
 #include "crypto/crypto.h"
+extern "C"
+{
+#include "crypto/crypto-ops.h"
+}
 #include "ledger_context.h"
+#include "mock_linking_tag_set.h"
 #include "mock_sp_transaction_component_types.h"
+#include "ringct/multiexp.h"
 #include "ringct/rctTypes.h"
 
 //third party headers
+#include <boost/thread/shared_mutex.hpp>
 
 //standard headers
+#include <array>
+#include <list>
+#include <memory>
 #include <mutex>
+#include <string>
 #include <unordered_map>
-#include <unordered_set>
 #include <vector>
 
 //forward declarations
@@ -61,9 +75,58 @@ namespace mock_tx
 namespace mock_tx
 {
 
+/// mock ledger column storage (see tools::huge_page_allocator)
+template <typename T>
+using LedgerColumn = std::vector<T, tools::huge_page_allocator<T>>;
+
+////
+// MockLedgerStorageMode - which enote data a MockLedgerContext keeps in memory
+// - squashed tx validation only reads squashed enotes, so a validation-only node can drop the rest (the full enotes
+//   can live on disk, e.g. in a MockLedgerContextLMDB or a ledger snapshot)
+// - in the compact modes every enote is stored squashed (enotes added without one are squashed when added)
+///
+enum class MockLedgerStorageMode : unsigned char
+{
+    /// full enotes and squashed enotes (106 bytes per enote)
+    FULL,
+    /// squashed enotes, plus onetime addresses and amount commitments for serving scanners and non-squashed ref
+    /// sets (96 bytes per enote)
+    SQUASHED_WITH_COMPONENTS,
+    /// squashed enotes only (32 bytes per enote)
+    SQUASHED_ONLY
+};
+
 class MockLedgerContext final : public LedgerContext
 {
 public:
+    /// default max number of decompressed squashed enotes to cache
+    static constexpr std::size_t DEFAULT_SQUASHED_ENOTE_CACHE_LIMIT{8192};
+
+//constructors
+    /// default constructor
+    MockLedgerContext() = default;
+    /**
+    * brief: construct with a custom bound on the decompressed squashed enote cache
+    * param: squashed_enote_cache_limit - max number of decompressed squashed enotes to cache (0 = no caching)
+    * param: straus_cache_limit - max number of squashed enotes to keep straus multiples for (0 = no straus cache)
+    * param: store_converted_squashed_enotes - also store every squashed enote decompressed and in cached form
+    *   - memory: +160 bytes (ge_p3) +160 bytes (ge_cached) per enote, on top of the 32-byte compressed key (~11x)
+    *   - in exchange, ref set gathers feed pippenger with no decompression, LRU lookup, or conversion
+    * param: storage_mode - which enote data to keep (see MockLedgerStorageMode)
+    */
+    explicit MockLedgerContext(const std::size_t squashed_enote_cache_limit,
+        const std::size_t straus_cache_limit = 0,
+        const bool store_converted_squashed_enotes = false,
+        const MockLedgerStorageMode storage_mode = MockLedgerStorageMode::FULL) :
+        m_storage_mode{storage_mode},
+        m_sp_squashed_enote_cache_limit{squashed_enote_cache_limit},
+        m_store_converted_squashed_enotes{store_converted_squashed_enotes}
+    {
+        if (straus_cache_limit > 0)
+            m_sp_squashed_enote_straus_cache.reset(new rct::straus_point_cache{straus_cache_limit});
+    }
+
+//member functions
     /**
     * brief: linking_tag_exists_sp_v1 - checks if a Seraphis linking tag exists in the ledger
     * param: linking_tag -
@@ -71,7 +134,16 @@ public:
     */
     bool linking_tag_exists_sp_v1(const crypto::key_image &linking_tag) const override;
     /**
+    * brief: linking_tags_exist_sp_v1 - checks which of a set of Seraphis linking tags exist in the ledger
+    *   - each shard is locked once for all of its tags
+    * param: linking_tags -
+    * outparam: exist_out - exist_out[i] is true if linking_tags[i] exists in the ledger
+    */
+    void linking_tags_exist_sp_v1(const std::vector<crypto::key_image> &linking_tags,
+        std::vector<bool> &exist_out) const override;
+    /**
     * brief: get_reference_set_sp_v1 - gets Seraphis enotes stored in the ledger
+    *   - throws unless the ledger stores full enotes (MockLedgerStorageMode::FULL)
     * param: indices -
     * outparam: enotes_out - 
     */
@@ -79,18 +151,61 @@ public:
         std::vector<MockENoteSpV1> &enotes_out) const override;
     /**
     * brief: get_reference_set_components_sp_v1 - gets components of Seraphis enotes stored in the ledger
+    *   - throws if the ledger only stores squashed enotes (MockLedgerStorageMode::SQUASHED_ONLY)
     * param: indices -
     * outparam: referenced_enotes_components_out - {{enote address, enote amount commitment}}
     */
     void get_reference_set_components_sp_v1(const std::vector<std::size_t> &indices,
-        rct::keyM &referenced_enotes_components_out) const override;
+        rct::KeyMatrix &referenced_enotes_components_out) const override;
     /**
     * brief: get_reference_set_components_sp_v2 - gets Seraphis squashed enotes stored in the ledger
     * param: indices -
     * outparam: referenced_enotes_components_out - {{squashed enote}}
     */
     void get_reference_set_components_sp_v2(const std::vector<std::size_t> &indices,
-        rct::keyM &referenced_enotes_components_out) const override;
+        rct::KeyMatrix &referenced_enotes_components_out) const override;
+    /**
+    * brief: get_reference_set_components_sp_v2_ranges - gets Seraphis squashed enotes stored in the ledger, from runs of
+    *   consecutive ledger indices
+    *   - each run is bounds-checked once, then copied straight out of the squashed enote array
+    * param: ranges -
+    * outparam: referenced_enotes_components_out - {{squashed enote}}, in range order
+    */
+    void get_reference_set_components_sp_v2_ranges(const epee::span<const LedgerIndexRange> ranges,
+        rct::KeyMatrix &referenced_enotes_components_out) const override;
+    /**
+    * brief: get_reference_set_components_sp_v2_p3 - gets Seraphis squashed enotes stored in the ledger, and their
+    *   decompressed form
+    *   - decompressed enotes are kept in a bounded LRU cache
+    * param: indices -
+    * outparam: referenced_enotes_components_out - {{squashed enote}}
+    * outparam: referenced_enotes_points_out - {squashed enote (decompressed)}
+    */
+    void get_reference_set_components_sp_v2_p3(const std::vector<std::size_t> &indices,
+        rct::KeyMatrix &referenced_enotes_components_out,
+        std::vector<ge_p3> &referenced_enotes_points_out) const override;
+    /**
+    * brief: get_squashed_enote_straus_cache_sp_v2 - gets the ledger's cache of straus multiples for squashed enotes
+    * return: the cache, or nullptr if it is disabled
+    */
+    rct::straus_point_cache* get_squashed_enote_straus_cache_sp_v2() const override
+    {
+        return m_sp_squashed_enote_straus_cache.get();
+    }
+    /**
+    * brief: try_get_reference_set_components_sp_v2_cached - gets Seraphis squashed enotes stored in the ledger, with
+    *   their decompressed and cached forms
+    *   - only available if the ledger was constructed to store converted squashed enotes
+    * param: indices -
+    * outparam: referenced_enotes_components_out - {{squashed enote}}
+    * outparam: referenced_enotes_points_out - {squashed enote (decompressed)}
+    * outparam: referenced_enotes_cached_out - {squashed enote (cached form)}
+    * return: false if converted squashed enotes aren't stored
+    */
+    bool try_get_reference_set_components_sp_v2_cached(const std::vector<std::size_t> &indices,
+        rct::KeyMatrix &referenced_enotes_components_out,
+        std::vector<ge_p3> &referenced_enotes_points_out,
+        std::vector<ge_cached> &referenced_enotes_cached_out) const override;
     /**
     * brief: add_transaction_sp_concise_v1 - add a MockTxSpConciseV1 transaction to the ledger
     * param: tx_to_add -
@@ -118,33 +233,194 @@ public:
     void add_linking_tag_sp_v1(const crypto::key_image &linking_tag);
     /**
     * brief: add_enote_sp_v1 - add a Seraphis v1 enote to the ledger
+    *   - squashed anyway if the ledger doesn't store full enotes
     * param: enote -
     * return: index in the ledger of the enote just added
     */
-    std::size_t add_enote_sp_v1(const MockENoteSpV1 &enote);
+    std::size_t add_enote_sp_v1(const MockENoteSpV1 &enote) override;
     /**
     * brief: add_enote_sp_v1 - add a Seraphis v1 enote to the ledger (and store the squashed enote)
     * param: enote -
     * return: index in the ledger of the enote just added
     */
-    std::size_t add_enote_sp_v2(const MockENoteSpV1 &enote);
+    std::size_t add_enote_sp_v2(const MockENoteSpV1 &enote) override;
+    /**
+    * brief: add_enotes_sp_v1 - add a set of Seraphis v1 enotes to the ledger in one step, at consecutive indices
+    * param: enotes -
+    * return: index in the ledger of the first enote just added
+    */
+    std::size_t add_enotes_sp_v1(const std::vector<MockENoteSpV1> &enotes) override;
+    /**
+    * brief: add_enotes_sp_v2 - add a set of Seraphis v1 enotes to the ledger in one step, at consecutive indices (and
+    *   store their squashed enotes)
+    *   - the squashed enotes are computed in parallel before taking the ledger lock
+    * param: enotes -
+    * param: num_threads - max number of threads for squashing the enotes (0 = threadpool max concurrency; 1 = serial)
+    * return: index in the ledger of the first enote just added
+    */
+    std::size_t add_enotes_sp_v2(const std::vector<MockENoteSpV1> &enotes, const std::size_t num_threads) override;
+    /**
+    * brief: clear_squashed_enote_cache - drop all cached decompressed squashed enotes (and their straus multiples)
+    *   - lets a ledger that is reused across measurements start each one with a cold cache
+    */
+    void clear_squashed_enote_cache();
+    /**
+    * brief: get_num_enotes - get the number of enotes in the ledger
+    * return: number of enotes
+    */
+    std::size_t get_num_enotes() const;
+    /// get which enote data the ledger keeps
+    MockLedgerStorageMode get_storage_mode() const { return m_storage_mode; }
+    /**
+    * brief: get_enote_storage_bytes - get the bytes a ledger stores per enote
+    *   - column bytes only (excluding spare column capacity, and the decompressed squashed enote caches)
+    * param: storage_mode -
+    * param: store_converted_squashed_enotes -
+    * return: bytes per enote
+    */
+    static std::size_t get_enote_storage_bytes(const MockLedgerStorageMode storage_mode,
+        const bool store_converted_squashed_enotes);
+    /**
+    * brief: get_storage_bytes - get the bytes allocated for the ledger's enote and linking tag columns
+    * return: bytes allocated (including spare column capacity)
+    */
+    std::size_t get_storage_bytes() const;
+    /**
+    * brief: save - write the ledger's enotes, squashed enotes, and linking tags to a snapshot file
+    *   - flat format: a fixed-size header, then one array per ledger column at 8-byte aligned offsets (so the file
+    *     can be mapped and read in place); converted squashed enotes are included if the ledger stores them, and
+    *     enote columns are only included if the ledger's storage mode keeps them
+    *   - snapshots are native-endian and only meant to be loaded on the same kind of machine
+    * param: path -
+    * return: false if the file couldn't be written
+    */
+    bool save(const std::string &path) const;
+    /**
+    * brief: get_state_commitment - commit to the ledger's squashed enotes and linking tags
+    *   - H("domain-sep", num enotes, {squashed enotes}, num linking tags, {linking tags in bytewise order})
+    *   - publish it with a checkpoint so new validators can bootstrap from a snapshot (see load()) instead of
+    *     replaying every tx below the checkpoint
+    *   - enotes a full ledger hasn't squashed yet are squashed when loaded into a compact ledger, so the compact
+    *     ledger's commitment can differ from the snapshot's (and such a snapshot can't be loaded against a
+    *     checkpoint)
+    * return: the commitment (also stored in snapshots written by save())
+    */
+    rct::key get_state_commitment() const;
+    /**
+    * brief: load - replace the ledger's contents with a snapshot written by save()
+    *   - converted squashed enotes are read from the snapshot if it has them, otherwise recomputed (only if this
+    *     ledger stores them)
+    *   - the decompressed squashed enote cache is cleared; the ledger is unchanged if loading fails
+    *   - a snapshot can be loaded into a ledger that keeps the same or less enote data (enotes without a squashed
+    *     enote are squashed if the ledger doesn't store full enotes), but not into one that keeps more
+    * param: path -
+    * return: false if the file couldn't be read or isn't a valid snapshot
+    */
+    bool load(const std::string &path);
+    /**
+    * brief: load - replace the ledger's contents with a snapshot whose state commitment matches a trusted checkpoint
+    *   - the snapshot's contents are assumed valid (no proofs are re-verified), so only use a commitment from a
+    *     trusted source
+    *   - nothing membership proofs read is taken from the snapshot unless the commitment covers it: converted
+    *     squashed enotes are recomputed, enote components (if this ledger keeps them) must squash to their squashed
+    *     enote, and snapshots with enotes that have no squashed enote are refused
+    *   - encoded amounts and view tags are not covered (they only matter to wallets scanning the ledger)
+    * param: path -
+    * param: expected_state_commitment - get_state_commitment() of the ledger the snapshot was saved from
+    * return: false if load(path) would fail, the snapshot doesn't match the expected commitment, or it has data the
+    *   commitment doesn't cover
+    */
+    bool load(const std::string &path, const rct::key &expected_state_commitment);
 
 private:
-    /// implementations of the above, without internally locking the ledger mutex
+    /// number of linking tag shards (power of 2)
+    static constexpr std::size_t LINKING_TAG_SHARD_COUNT{16};
+
+    /// set of linking tags with its own lock
+    struct LinkingTagShard final
+    {
+        mutable boost::shared_mutex m_mutex;
+        LinkingTagSet m_linking_tags;
+    };
+
+    /// write locks on every linking tag shard
+    using LinkingTagShardLocks = std::array<boost::unique_lock<boost::shared_mutex>, LINKING_TAG_SHARD_COUNT>;
+
+    /// get the shard that owns a linking tag
+    static std::size_t get_linking_tag_shard_index(const crypto::key_image &linking_tag);
+    LinkingTagShard& get_linking_tag_shard(const crypto::key_image &linking_tag);
+    const LinkingTagShard& get_linking_tag_shard(const crypto::key_image &linking_tag) const;
+    /// write-lock all linking tag shards (in shard order)
+    LinkingTagShardLocks lock_linking_tag_shards();
+
+    /// LRU cache of decompressed squashed enotes with its own lock (most recently used at the front of the list)
+    struct SquashedEnoteCache final
+    {
+        std::mutex m_mutex;
+        std::list<std::size_t> m_order;
+        std::unordered_map<std::size_t, std::pair<ge_p3, std::list<std::size_t>::iterator>> m_enotes;
+    };
+
+    /// get the decompressed squashed enote cache of the calling thread's NUMA node
+    SquashedEnoteCache& get_squashed_enote_cache() const;
+
+    /// load a snapshot (checking its state commitment against the expected one if provided)
+    bool load_impl(const std::string &path, const rct::key *expected_state_commitment);
+
+    /// implementations of the above, without internally locking the ledger mutex or linking tag shards
     bool linking_tag_exists_sp_v1_impl(const crypto::key_image &linking_tag) const;
     void add_linking_tag_sp_v1_impl(const crypto::key_image &linking_tag);
+    void add_linking_tags_sp_v1_impl(const std::vector<crypto::key_image> &linking_tags);
+    std::size_t get_num_enotes_impl() const;
+    bool squashed_enote_exists_impl(const std::size_t index) const;
+    bool squashed_enotes_exist_impl(const LedgerIndexRange &range) const;
+    /// the storage mode keeps onetime addresses and amount commitments / keeps full enotes (and squashed enote flags)
+    bool stores_enote_components() const { return m_storage_mode != MockLedgerStorageMode::SQUASHED_ONLY; }
+    bool stores_full_enotes() const { return m_storage_mode == MockLedgerStorageMode::FULL; }
     std::size_t add_enote_sp_v1_impl(const MockENoteSpV1 &enote);
     std::size_t add_enote_sp_v2_impl(const MockENoteSpV1 &enote);
+    std::size_t add_enote_sp_v2_impl(const MockENoteSpV1 &enote, const rct::key &squashed_enote);
+    /// squashed enote cache helpers, without internally locking the cache mutex
+    bool try_get_cached_squashed_enote_p3_impl(SquashedEnoteCache &cache,
+        const std::size_t index,
+        ge_p3 &squashed_enote_p3_out) const;
+    void cache_squashed_enote_p3_impl(SquashedEnoteCache &cache,
+        const std::size_t index,
+        const ge_p3 &squashed_enote_p3) const;
 
-    /// Ledger mutex (mutable for use in const member functions)
-    mutable std::mutex m_ledger_mutex;
+    /// Ledger mutex for enotes (mutable for use in const member functions)
+    /// - lock order: ledger mutex -> linking tag shards (in shard order) -> squashed enote cache mutex
+    mutable boost::shared_mutex m_ledger_mutex;
 
     /// Seraphis linking tags
-    std::unordered_set<crypto::key_image> m_sp_linking_tags;
-    /// Seraphis v1 ENotes
-    std::unordered_map<std::size_t, MockENoteSpV1> m_sp_enotes;
-    /// Seraphis squashed enotes
-    std::unordered_map<std::size_t, rct::key> m_sp_squashed_enotes;
+    std::array<LinkingTagShard, LINKING_TAG_SHARD_COUNT> m_sp_linking_tag_shards;
+    /// which enote columns are kept (see MockLedgerStorageMode)
+    MockLedgerStorageMode m_storage_mode{MockLedgerStorageMode::FULL};
+    /// Seraphis v1 ENotes (structure of arrays indexed by ledger index, for cache-friendly reference set gathers)
+    /// - columns of big ledgers are backed by huge pages if enabled (ref set gathers are random reads)
+    /// - onetime addresses and amount commitments are empty if squashed-only, the rest if not full
+    LedgerColumn<rct::key> m_sp_enote_onetime_addresses;
+    LedgerColumn<rct::key> m_sp_enote_amount_commitments;
+    LedgerColumn<rct::xmr_amount> m_sp_enote_encoded_amounts;
+    LedgerColumn<unsigned char> m_sp_enote_view_tags;
+    /// Seraphis squashed enotes (indexed by ledger index; only set where the squashed enote flag is set, or everywhere
+    ///   if the ledger doesn't store full enotes, in which case the flags are empty)
+    LedgerColumn<rct::key> m_sp_squashed_enotes;
+    LedgerColumn<char> m_sp_squashed_enote_flags;
+    /// Seraphis squashed enotes, decompressed and in cached form (optional; same indexing, identity where not set)
+    bool m_store_converted_squashed_enotes{false};
+    LedgerColumn<ge_p3> m_sp_squashed_enote_p3s;
+    LedgerColumn<ge_cached> m_sp_squashed_enote_cacheds;
+
+    /// LRU caches of decompressed Seraphis squashed enotes, one per NUMA node (mutable: filled by const lookups)
+    /// - each holds up to the cache limit, filled by threads on its node, so lookups read node-local memory and
+    ///   threads on different nodes don't contend on one cache mutex
+    /// - each has its own mutex, since lookups under a shared ledger lock still update the cache
+    std::size_t m_sp_squashed_enote_cache_limit{DEFAULT_SQUASHED_ENOTE_CACHE_LIMIT};
+    mutable std::vector<SquashedEnoteCache> m_sp_squashed_enote_caches =
+        std::vector<SquashedEnoteCache>(tools::get_numa_node_count());
+    /// straus multiples of Seraphis squashed enotes, keyed by ledger index (optional; has its own lock)
+    std::unique_ptr<rct::straus_point_cache> m_sp_squashed_enote_straus_cache;
 };
 
 } //namespace mock_tx
@@ -0,0 +1,717 @@
+// Copyright (c) 2021, The Monero Project
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of
+//    conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list
+//    of conditions and the following disclaimer in the documentation and/or other
+//    materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be
+//    used to endorse or promote products derived from this software without specific
+//    prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+// THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// NOT FOR PRODUCTION
+
+//paired header
+#include "mock_ledger_context_lmdb.h"
+
+//local headers
+#include "crypto/crypto.h"
+extern "C"
+{
+#include "crypto/crypto-ops.h"
+}
+#include "misc_log_ex.h"
+#include "mock_sp_core_utils.h"
+#include "mock_sp_transaction_component_types.h"
+#include "mock_sp_transaction_utils.h"
+#include "mock_sp_txtype_concise_v1.h"
+#include "mock_sp_txtype_merge_v1.h"
+#include "mock_sp_txtype_plain_v1.h"
+#include "mock_sp_txtype_squashed_v1.h"
+#include "mock_tx_utils.h"
+#include "ringct/rctTypes.h"
+#include "span.h"
+
+//third party headers
+#include <lmdb.h>
+
+//standard headers
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+#undef MONERO_DEFAULT_LOG_CATEGORY
+#define MONERO_DEFAULT_LOG_CATEGORY "mock_tx"
+
+namespace mock_tx
+{
+
+/// size of a packed v1 enote: Ko | C | enc(a) | view_tag
+static constexpr std::size_t SP_ENOTE_V1_PACKED_SIZE{32 + 32 + sizeof(rct::xmr_amount) + 1};
+/// number of background reference set fetch threads (fetches are mostly waiting on page faults)
+static constexpr std::size_t NUM_FETCH_THREADS{4};
+
+/// max number of dummy enotes to add per write transaction (LMDB limits the dirty pages of one transaction)
+static constexpr std::size_t MAX_DUMMY_ENOTES_PER_TXN{100000};
+
+//-------------------------------------------------------------------------------------------------------------------
+// throw if an LMDB call failed
+//-------------------------------------------------------------------------------------------------------------------
+static void check_lmdb_result(const int result, const char *description)
+{
+    CHECK_AND_ASSERT_THROW_MES(result == MDB_SUCCESS,
+        "Mock LMDB ledger: " << description << " failed: " << mdb_strerror(result));
+}
+//-------------------------------------------------------------------------------------------------------------------
+// LMDB transaction that aborts unless committed
+//-------------------------------------------------------------------------------------------------------------------
+class LMDBTxnGuard final
+{
+public:
+    LMDBTxnGuard(MDB_env *env, const unsigned int flags)
+    {
+        check_lmdb_result(mdb_txn_begin(env, nullptr, flags, &m_txn), "begin transaction");
+    }
+    LMDBTxnGuard(const LMDBTxnGuard&) = delete;
+    LMDBTxnGuard& operator=(const LMDBTxnGuard&) = delete;
+
+    ~LMDBTxnGuard()
+    {
+        if (m_txn != nullptr)
+            mdb_txn_abort(m_txn);
+    }
+
+    MDB_txn* get() const { return m_txn; }
+
+    void commit()
+    {
+        const int result{mdb_txn_commit(m_txn)};
+        m_txn = nullptr;
+        check_lmdb_result(result, "commit transaction");
+    }
+
+private:
+    MDB_txn *m_txn{nullptr};
+};
+//-------------------------------------------------------------------------------------------------------------------
+// get a value from a table; returns false if the key is not in the table
+//-------------------------------------------------------------------------------------------------------------------
+static bool try_get_lmdb_value(MDB_txn *txn, const MDB_dbi dbi, MDB_val key, MDB_val &value_out)
+{
+    const int result{mdb_get(txn, dbi, &key, &value_out)};
+    if (result == MDB_NOTFOUND)
+        return false;
+
+    check_lmdb_result(result, "get value");
+    return true;
+}
+//-------------------------------------------------------------------------------------------------------------------
+// get the values of runs of consecutive integer keys, in range order
+// - each run costs one cursor seek, then steps to the next key
+//-------------------------------------------------------------------------------------------------------------------
+static void get_lmdb_values_by_range(MDB_txn *txn,
+    const MDB_dbi dbi,
+    const epee::span<const LedgerIndexRange> ranges,
+    const std::function<void(const std::size_t, const MDB_val&)> &handle_value)
+{
+    MDB_cursor *cursor;
+    check_lmdb_result(mdb_cursor_open(txn, dbi, &cursor), "open cursor");
+
+    try
+    {
+        std::size_t position{0};
+
+        for (const LedgerIndexRange &range : ranges)
+        {
+            std::size_t index{range.m_first};
+            MDB_val key{sizeof(index), &index};
+            MDB_val value;
+            MDB_cursor_op op{MDB_SET_KEY};
+
+            for (std::size_t offset{0}; offset < range.m_count; ++offset)
+            {
+                const int result{mdb_cursor_get(cursor, &key, &value, op)};
+                CHECK_AND_ASSERT_THROW_MES(result != MDB_NOTFOUND, "Tried to get a ledger element that doesn't exist.");
+                check_lmdb_result(result, "get value by range");
+
+                // MDB_NEXT lands on the next stored key, which must be the next index of the run
+                std::size_t found_index;
+                CHECK_AND_ASSERT_THROW_MES(key.mv_size == sizeof(found_index), "Stored key has the wrong size.");
+                memcpy(&found_index, key.mv_data, sizeof(found_index));
+                CHECK_AND_ASSERT_THROW_MES(found_index == range.m_first + offset,
+                    "Tried to get a ledger element that doesn't exist.");
+
+                handle_value(position, value);
+                ++position;
+                op = MDB_NEXT;
+            }
+        }
+    }
+    catch (...)
+    {
+        mdb_cursor_close(cursor);
+        throw;
+    }
+
+    mdb_cursor_close(cursor);
+}
+//-------------------------------------------------------------------------------------------------------------------
+// get the values of a set of integer keys, in key-set order (reference sets are often clustered)
+//-------------------------------------------------------------------------------------------------------------------
+static void get_lmdb_values_by_range(MDB_txn *txn,
+    const MDB_dbi dbi,
+    const std::vector<std::size_t> &indices,
+    const std::function<void(const std::size_t, const MDB_val&)> &handle_value)
+{
+    std::vector<LedgerIndexRange> ranges;
+    get_ledger_index_ranges(indices, ranges);
+
+    get_lmdb_values_by_range(txn, dbi, epee::to_span(ranges), handle_value);
+}
+//-------------------------------------------------------------------------------------------------------------------
+// unpack a v1 enote from the enote table
+//-------------------------------------------------------------------------------------------------------------------
+static void unpack_sp_enote_v1(const MDB_val &value, MockENoteSpV1 &enote_out)
+{
+    CHECK_AND_ASSERT_THROW_MES(value.mv_size == SP_ENOTE_V1_PACKED_SIZE, "Stored enote has the wrong size.");
+
+    const unsigned char *packed_enote{static_cast<const unsigned char*>(value.mv_data)};
+    memcpy(enote_out.m_onetime_address.bytes, packed_enote, 32);
+    memcpy(enote_out.m_amount_commitment.bytes, packed_enote + 32, 32);
+    memcpy(&enote_out.m_encoded_amount, packed_enote + 64, sizeof(rct::xmr_amount));
+    enote_out.m_view_tag = packed_enote[64 + sizeof(rct::xmr_amount)];
+}
+//-------------------------------------------------------------------------------------------------------------------
+// unpack a squashed enote from the squashed enote table
+//-------------------------------------------------------------------------------------------------------------------
+static void unpack_sp_squashed_enote(const MDB_val &value, rct::key &squashed_enote_out)
+{
+    CHECK_AND_ASSERT_THROW_MES(value.mv_size == sizeof(rct::key), "Stored squashed enote has the wrong size.");
+
+    memcpy(squashed_enote_out.bytes, value.mv_data, sizeof(rct::key));
+}
+//-------------------------------------------------------------------------------------------------------------------
+MockLedgerContextLMDB::MockLedgerContextLMDB(const std::string &db_path, const std::size_t map_size)
+{
+    check_lmdb_result(mdb_env_create(&m_env), "create environment");
+
+    try
+    {
+        check_lmdb_result(mdb_env_set_maxdbs(m_env, 3), "set max tables");
+        check_lmdb_result(mdb_env_set_mapsize(m_env, map_size), "set map size");
+
+        // - MDB_NOTLS: read transactions may be used by any thread (e.g. threadpool workers)
+        // - MDB_NOSYNC: a mock ledger doesn't need durability
+        // - MDB_NORDAHEAD: reference set lookups are random reads
+        check_lmdb_result(mdb_env_open(m_env, db_path.c_str(), MDB_NOTLS | MDB_NOSYNC | MDB_NORDAHEAD, 0664),
+            "open environment");
+
+        LMDBTxnGuard txn{m_env, 0};
+        check_lmdb_result(mdb_dbi_open(txn.get(), "sp_linking_tags", MDB_CREATE, &m_sp_linking_tags),
+            "open linking tag table");
+        check_lmdb_result(mdb_dbi_open(txn.get(), "sp_enotes", MDB_CREATE | MDB_INTEGERKEY, &m_sp_enotes),
+            "open enote table");
+        check_lmdb_result(mdb_dbi_open(txn.get(),
+                "sp_squashed_enotes",
+                MDB_CREATE | MDB_INTEGERKEY,
+                &m_sp_squashed_enotes),
+            "open squashed enote table");
+        txn.commit();
+    }
+    catch (...)
+    {
+        mdb_env_close(m_env);
+        throw;
+    }
+}
+//-------------------------------------------------------------------------------------------------------------------
+MockLedgerContextLMDB::~MockLedgerContextLMDB()
+{
+    // finish queued fetches before closing the environment
+    {
+        std::lock_guard<std::mutex> lock{m_fetch_mutex};
+        m_stop_fetching = true;
+    }
+    m_fetch_cv.notify_all();
+
+    for (std::thread &fetch_thread : m_fetch_threads)
+        fetch_thread.join();
+
+    mdb_env_close(m_env);
+}
+//-------------------------------------------------------------------------------------------------------------------
+bool MockLedgerContextLMDB::linking_tag_exists_sp_v1(const crypto::key_image &linking_tag) const
+{
+    LMDBTxnGuard txn{m_env, MDB_RDONLY};
+
+    MDB_val value;
+    return try_get_lmdb_value(txn.get(),
+        m_sp_linking_tags,
+        {sizeof(crypto::key_image), const_cast<crypto::key_image*>(&linking_tag)},
+        value);
+}
+//-------------------------------------------------------------------------------------------------------------------
+void MockLedgerContextLMDB::linking_tags_exist_sp_v1(const std::vector<crypto::key_image> &linking_tags,
+    std::vector<bool> &exist_out) const
+{
+    exist_out.assign(linking_tags.size(), false);
+    if (linking_tags.empty())
+        return;
+
+    // probe in key order (the table uses byte-wise key comparisons) so the cursor only moves forward
+    std::vector<std::size_t> probe_order(linking_tags.size());
+    for (std::size_t tag_index{0}; tag_index < probe_order.size(); ++tag_index)
+        probe_order[tag_index] = tag_index;
+    std::sort(probe_order.begin(), probe_order.end(),
+            [&linking_tags](const std::size_t a, const std::size_t b) -> bool
+            {
+                return memcmp(&linking_tags[a], &linking_tags[b], sizeof(crypto::key_image)) < 0;
+            }
+        );
+
+    LMDBTxnGuard txn{m_env, MDB_RDONLY};
+    MDB_cursor *cursor;
+    check_lmdb_result(mdb_cursor_open(txn.get(), m_sp_linking_tags, &cursor), "open cursor");
+
+    MDB_val key, value;
+    bool positioned{false};
+    bool at_end{false};
+    for (const std::size_t tag_index : probe_order)
+    {
+        const crypto::key_image &linking_tag{linking_tags[tag_index]};
+
+        // the cursor is on the first stored tag not below the previous probe; if that tag is not below this
+        //   probe either, no stored tag lies in between and there is no need to search again
+        if (positioned)
+        {
+            if (at_end)
+                continue;
+
+            const int cmp{memcmp(&linking_tag, key.mv_data, sizeof(crypto::key_image))};
+            if (cmp <= 0)
+            {
+                exist_out[tag_index] = cmp == 0;
+                continue;
+            }
+        }
+
+        key = {sizeof(crypto::key_image), const_cast<crypto::key_image*>(&linking_tag)};
+        const int result{mdb_cursor_get(cursor, &key, &value, MDB_SET_RANGE)};
+        positioned = true;
+        if (result == MDB_NOTFOUND)
+        {
+            at_end = true;
+            continue;
+        }
+        if (result != MDB_SUCCESS)
+            mdb_cursor_close(cursor);
+        check_lmdb_result(result, "find linking tag");
+
+        exist_out[tag_index] = memcmp(&linking_tag, key.mv_data, sizeof(crypto::key_image)) == 0;
+    }
+
+    mdb_cursor_close(cursor);
+}
+//-------------------------------------------------------------------------------------------------------------------
+void MockLedgerContextLMDB::get_reference_set_sp_v1(const std::vector<std::size_t> &indices,
+    std::vector<MockENoteSpV1> &enotes_out) const
+{
+    LMDBTxnGuard txn{m_env, MDB_RDONLY};
+
+    std::vector<MockENoteSpV1> enotes_temp;
+    enotes_temp.resize(indices.size());
+
+    get_lmdb_values_by_range(txn.get(), m_sp_enotes, indices,
+            [&enotes_temp](const std::size_t i, const MDB_val &value)
+            {
+                unpack_sp_enote_v1(value, enotes_temp[i]);
+            }
+        );
+
+    enotes_out = std::move(enotes_temp);
+}
+//-------------------------------------------------------------------------------------------------------------------
+void MockLedgerContextLMDB::get_reference_set_components_sp_v1(const std::vector<std::size_t> &indices,
+    rct::KeyMatrix &referenced_enotes_components_out) const
+{
+    LMDBTxnGuard txn{m_env, MDB_RDONLY};
+
+    rct::KeyMatrix referenced_enotes_components_temp{indices.size(), 2};
+    MockENoteSpV1 enote;
+
+    get_lmdb_values_by_range(txn.get(), m_sp_enotes, indices,
+            [&referenced_enotes_components_temp, &enote](const std::size_t i, const MDB_val &value)
+            {
+                unpack_sp_enote_v1(value, enote);
+                referenced_enotes_components_temp[i][0] = enote.m_onetime_address;
+                referenced_enotes_components_temp[i][1] = enote.m_amount_commitment;
+            }
+        );
+
+    referenced_enotes_components_out = std::move(referenced_enotes_components_temp);
+}
+//-------------------------------------------------------------------------------------------------------------------
+void MockLedgerContextLMDB::get_reference_set_components_sp_v2(const std::vector<std::size_t> &indices,
+    rct::KeyMatrix &referenced_enotes_components_out) const
+{
+    LMDBTxnGuard txn{m_env, MDB_RDONLY};
+
+    rct::KeyMatrix referenced_enotes_components_temp{indices.size(), 1};
+
+    get_lmdb_values_by_range(txn.get(), m_sp_squashed_enotes, indices,
+            [&referenced_enotes_components_temp](const std::size_t i, const MDB_val &value)
+            {
+                unpack_sp_squashed_enote(value, referenced_enotes_components_temp[i][0]);
+            }
+        );
+
+    referenced_enotes_components_out = std::move(referenced_enotes_components_temp);
+}
+//-------------------------------------------------------------------------------------------------------------------
+void MockLedgerContextLMDB::get_reference_set_components_sp_v2_ranges(const epee::span<const LedgerIndexRange> ranges,
+    rct::KeyMatrix &referenced_enotes_components_out) const
+{
+    LMDBTxnGuard txn{m_env, MDB_RDONLY};
+
+    std::size_t num_enotes{0};
+    for (const LedgerIndexRange &range : ranges)
+    {
+        CHECK_AND_ASSERT_THROW_MES(range.m_count <= std::numeric_limits<std::size_t>::max() - num_enotes,
+            "Tried to get too many squashed enotes.");
+        num_enotes += range.m_count;
+    }
+
+    rct::KeyMatrix referenced_enotes_components_temp{num_enotes, 1};
+
+    get_lmdb_values_by_range(txn.get(), m_sp_squashed_enotes, ranges,
+            [&referenced_enotes_components_temp](const std::size_t i, const MDB_val &value)
+            {
+                unpack_sp_squashed_enote(value, referenced_enotes_components_temp[i][0]);
+            }
+        );
+
+    referenced_enotes_components_out = std::move(referenced_enotes_components_temp);
+}
+//-------------------------------------------------------------------------------------------------------------------
+void MockLedgerContextLMDB::get_reference_set_components_sp_v2_p3(const std::vector<std::size_t> &indices,
+    rct::KeyMatrix &referenced_enotes_components_out,
+    std::vector<ge_p3> &referenced_enotes_points_out) const
+{
+    // gets squashed enotes (in one read transaction)
+    rct::KeyMatrix referenced_enotes_components_temp;
+    this->get_reference_set_components_sp_v2(indices, referenced_enotes_components_temp);
+
+    // decompress them (no need to hold the read transaction open)
+    std::vector<ge_p3> referenced_enotes_points_temp;
+    referenced_enotes_points_temp.resize(indices.size());
+
+    for (std::size_t i{0}; i < indices.size(); ++i)
+    {
+        CHECK_AND_ASSERT_THROW_MES(ge_frombytes_vartime(&referenced_enotes_points_temp[i],
+                referenced_enotes_components_temp[i][0].bytes) == 0,
+            "Failed to decompress squashed enote.");
+    }
+
+    referenced_enotes_components_out = std::move(referenced_enotes_components_temp);
+    referenced_enotes_points_out = std::move(referenced_enotes_points_temp);
+}
+//-------------------------------------------------------------------------------------------------------------------
+std::future<void> MockLedgerContextLMDB::get_reference_set_components_sp_v2_p3_async(
+    const std::vector<std::size_t> &indices,
+    rct::KeyMatrix &referenced_enotes_components_out,
+    std::vector<ge_p3> &referenced_enotes_points_out) const
+{
+    std::packaged_task<void()> fetch_task{
+            [this, &indices, &referenced_enotes_components_out, &referenced_enotes_points_out]()
+            {
+                this->get_reference_set_components_sp_v2_p3(indices,
+                    referenced_enotes_components_out,
+                    referenced_enotes_points_out);
+            }
+        };
+    std::future<void> fetched{fetch_task.get_future()};
+
+    {
+        std::lock_guard<std::mutex> lock{m_fetch_mutex};
+
+        if (m_fetch_threads.empty())
+        {
+            for (std::size_t thread_index{0}; thread_index < NUM_FETCH_THREADS; ++thread_index)
+                m_fetch_threads.emplace_back([this]() { this->run_fetch_thread(); });
+        }
+
+        m_fetch_queue.emplace_back(std::move(fetch_task));
+    }
+    m_fetch_cv.notify_one();
+
+    return fetched;
+}
+//-------------------------------------------------------------------------------------------------------------------
+void MockLedgerContextLMDB::add_transaction_sp_concise_v1(const MockTxSpConciseV1 &tx_to_add)
+{
+    LMDBTxnGuard txn{m_env, 0};
+
+    // add linking tags
+    for (const auto &input_image : tx_to_add.m_input_images)
+        this->add_linking_tag_sp_v1_impl(txn.get(), input_image.m_key_image);
+
+    // add new enotes
+    for (const auto &output_enote : tx_to_add.m_outputs)
+        this->add_enote_sp_v1_impl(txn.get(), output_enote);
+
+    // note: for mock ledger, don't store the whole tx
+    txn.commit();
+}
+//-------------------------------------------------------------------------------------------------------------------
+void MockLedgerContextLMDB::add_transaction_sp_merge_v1(const MockTxSpMergeV1 &tx_to_add)
+{
+    LMDBTxnGuard txn{m_env, 0};
+
+    // add linking tags
+    for (const auto &input_image : tx_to_add.m_input_images)
+        this->add_linking_tag_sp_v1_impl(txn.get(), input_image.m_key_image);
+
+    // add new enotes
+    for (const auto &output_enote : tx_to_add.m_outputs)
+        this->add_enote_sp_v1_impl(txn.get(), output_enote);
+
+    // note: for mock ledger, don't store the whole tx
+    txn.commit();
+}
+//-------------------------------------------------------------------------------------------------------------------
+void MockLedgerContextLMDB::add_transaction_sp_plain_v1(const MockTxSpPlainV1 &tx_to_add)
+{
+    LMDBTxnGuard txn{m_env, 0};
+
+    // add linking tags
+    for (const auto &input_image : tx_to_add.m_input_images)
+        this->add_linking_tag_sp_v1_impl(txn.get(), input_image.m_key_image);
+
+    // add new enotes
+    for (const auto &output_enote : tx_to_add.m_outputs)
+        this->add_enote_sp_v1_impl(txn.get(), output_enote);
+
+    // note: for mock ledger, don't store the whole tx
+    txn.commit();
+}
+//-------------------------------------------------------------------------------------------------------------------
+void MockLedgerContextLMDB::add_transaction_sp_squashed_v1(const MockTxSpSquashedV1 &tx_to_add)
+{
+    // squash the new enotes before opening the write transaction
+    rct::keyV squashed_enotes;
+    make_squashed_enotes_sp_v1(tx_to_add.m_outputs, squashed_enotes, 0);
+
+    LMDBTxnGuard txn{m_env, 0};
+
+    // add linking tags
+    for (const auto &input_image : tx_to_add.m_input_images)
+        this->add_linking_tag_sp_v1_impl(txn.get(), input_image.m_key_image);
+
+    // add new enotes
+    for (std::size_t output_index{0}; output_index < tx_to_add.m_outputs.size(); ++output_index)
+        this->add_enote_sp_v2_impl(txn.get(), tx_to_add.m_outputs[output_index], squashed_enotes[output_index]);
+
+    // note: for mock ledger, don't store the whole tx
+    txn.commit();
+}
+//-------------------------------------------------------------------------------------------------------------------
+void MockLedgerContextLMDB::add_linking_tag_sp_v1(const crypto::key_image &linking_tag)
+{
+    LMDBTxnGuard txn{m_env, 0};
+
+    add_linking_tag_sp_v1_impl(txn.get(), linking_tag);
+    txn.commit();
+}
+//-------------------------------------------------------------------------------------------------------------------
+std::size_t MockLedgerContextLMDB::add_enote_sp_v1(const MockENoteSpV1 &enote)
+{
+    LMDBTxnGuard txn{m_env, 0};
+
+    const std::size_t index{add_enote_sp_v1_impl(txn.get(), enote)};
+    txn.commit();
+
+    return index;
+}
+//-------------------------------------------------------------------------------------------------------------------
+std::size_t MockLedgerContextLMDB::add_enote_sp_v2(const MockENoteSpV1 &enote)
+{
+    rct::key squashed_enote;
+    seraphis_squashed_enote_Q(enote.m_onetime_address, enote.m_amount_commitment, squashed_enote);
+
+    LMDBTxnGuard txn{m_env, 0};
+
+    const std::size_t index{add_enote_sp_v2_impl(txn.get(), enote, squashed_enote)};
+    txn.commit();
+
+    return index;
+}
+//-------------------------------------------------------------------------------------------------------------------
+std::size_t MockLedgerContextLMDB::add_enotes_sp_v1(const std::vector<MockENoteSpV1> &enotes)
+{
+    LMDBTxnGuard txn{m_env, 0};
+
+    const std::size_t first_index{get_num_enotes_impl(txn.get())};
+
+    for (const MockENoteSpV1 &enote : enotes)
+        add_enote_sp_v1_impl(txn.get(), enote);
+
+    txn.commit();
+
+    return first_index;
+}
+//-------------------------------------------------------------------------------------------------------------------
+std::size_t MockLedgerContextLMDB::add_enotes_sp_v2(const std::vector<MockENoteSpV1> &enotes,
+    const std::size_t num_threads)
+{
+    // squash the enotes before opening the write transaction
+    rct::keyV squashed_enotes;
+    make_squashed_enotes_sp_v1(enotes, squashed_enotes, num_threads);
+
+    // add them
+    LMDBTxnGuard txn{m_env, 0};
+
+    const std::size_t first_index{get_num_enotes_impl(txn.get())};
+
+    for (std::size_t i{0}; i < enotes.size(); ++i)
+        add_enote_sp_v2_impl(txn.get(), enotes[i], squashed_enotes[i]);
+
+    txn.commit();
+
+    return first_index;
+}
+//-------------------------------------------------------------------------------------------------------------------
+void MockLedgerContextLMDB::add_dummy_enotes_sp_v2(const MockENoteSpV1 &enote, const std::size_t num_enotes)
+{
+    add_dummy_enotes_sp_v2(std::vector<MockENoteSpV1>{enote}, num_enotes);
+}
+//-------------------------------------------------------------------------------------------------------------------
+void MockLedgerContextLMDB::add_dummy_enotes_sp_v2(const std::vector<MockENoteSpV1> &enote_pool,
+    const std::size_t num_enotes)
+{
+    CHECK_AND_ASSERT_THROW_MES(enote_pool.size() > 0 || num_enotes == 0,
+        "Tried to add dummy enotes from an empty pool.");
+
+    rct::keyV squashed_enote_pool;
+    make_squashed_enotes_sp_v1(enote_pool, squashed_enote_pool, 0);
+
+    std::size_t num_added{0};
+
+    while (num_added < num_enotes)
+    {
+        const std::size_t chunk_size{std::min(num_enotes - num_added, MAX_DUMMY_ENOTES_PER_TXN)};
+        LMDBTxnGuard txn{m_env, 0};
+
+        for (std::size_t i{num_added}; i < num_added + chunk_size; ++i)
+        {
+            add_enote_sp_v2_impl(txn.get(),
+                enote_pool[i % enote_pool.size()],
+                squashed_enote_pool[i % enote_pool.size()]);
+        }
+
+        txn.commit();
+        num_added += chunk_size;
+    }
+}
+//-------------------------------------------------------------------------------------------------------------------
+std::size_t MockLedgerContextLMDB::get_num_enotes() const
+{
+    LMDBTxnGuard txn{m_env, MDB_RDONLY};
+
+    return get_num_enotes_impl(txn.get());
+}
+//-------------------------------------------------------------------------------------------------------------------
+//-------------------------------------------------------------------------------------------------------------------
+void MockLedgerContextLMDB::add_linking_tag_sp_v1_impl(MDB_txn *txn, const crypto::key_image &linking_tag)
+{
+    MDB_val key{sizeof(crypto::key_image), const_cast<crypto::key_image*>(&linking_tag)};
+    MDB_val value{0, nullptr};
+    const int result{mdb_put(txn, m_sp_linking_tags, &key, &value, MDB_NOOVERWRITE)};
+
+    CHECK_AND_ASSERT_THROW_MES(result != MDB_KEYEXIST, "Tried to add linking tag that already exists.");
+    check_lmdb_result(result, "add linking tag");
+}
+//-------------------------------------------------------------------------------------------------------------------
+std::size_t MockLedgerContextLMDB::add_enote_sp_v1_impl(MDB_txn *txn, const MockENoteSpV1 &enote)
+{
+    std::size_t index{get_num_enotes_impl(txn)};
+
+    unsigned char packed_enote[SP_ENOTE_V1_PACKED_SIZE];
+    memcpy(packed_enote, enote.m_onetime_address.bytes, 32);
+    memcpy(packed_enote + 32, enote.m_amount_commitment.bytes, 32);
+    memcpy(packed_enote + 64, &enote.m_encoded_amount, sizeof(rct::xmr_amount));
+    packed_enote[64 + sizeof(rct::xmr_amount)] = enote.m_view_tag;
+
+    // note: indices only increase, so use MDB_APPEND
+    MDB_val key{sizeof(index), &index};
+    MDB_val value{SP_ENOTE_V1_PACKED_SIZE, packed_enote};
+    check_lmdb_result(mdb_put(txn, m_sp_enotes, &key, &value, MDB_APPEND), "add enote");
+
+    return index;
+}
+//-------------------------------------------------------------------------------------------------------------------
+std::size_t MockLedgerContextLMDB::add_enote_sp_v2_impl(MDB_txn *txn,
+    const MockENoteSpV1 &enote,
+    const rct::key &squashed_enote)
+{
+    // add the enote
+    std::size_t index{add_enote_sp_v1_impl(txn, enote)};
+
+    // add the squashed enote
+    MDB_val key{sizeof(index), &index};
+    MDB_val value{sizeof(rct::key), const_cast<rct::key*>(&squashed_enote)};
+    check_lmdb_result(mdb_put(txn, m_sp_squashed_enotes, &key, &value, MDB_APPEND), "add squashed enote");
+
+    return index;
+}
+//-------------------------------------------------------------------------------------------------------------------
+void MockLedgerContextLMDB::run_fetch_thread() const
+{
+    while (true)
+    {
+        std::packaged_task<void()> fetch_task;
+
+        {
+            std::unique_lock<std::mutex> lock{m_fetch_mutex};
+            m_fetch_cv.wait(lock, [this]() { return m_stop_fetching || !m_fetch_queue.empty(); });
+
+            if (m_fetch_queue.empty())
+                return;
+
+            fetch_task = std::move(m_fetch_queue.front());
+            m_fetch_queue.pop_front();
+        }
+
+        // errors are stored in the task's future
+        fetch_task();
+    }
+}
+//-------------------------------------------------------------------------------------------------------------------
+std::size_t MockLedgerContextLMDB::get_num_enotes_impl(MDB_txn *txn) const
+{
+    MDB_stat table_stats;
+    check_lmdb_result(mdb_stat(txn, m_sp_enotes, &table_stats), "get enote table stats");
+
+    return table_stats.ms_entries;
+}
+//-------------------------------------------------------------------------------------------------------------------
+} //namespace mock_tx
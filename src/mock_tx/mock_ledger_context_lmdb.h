@@ -0,0 +1,260 @@
+// Copyright (c) 2021, The Monero Project
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of
+//    conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list
+//    of conditions and the following disclaimer in the documentation and/or other
+//    materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be
+//    used to endorse or promote products derived from this software without specific
+//    prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+// THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// Mock ledger context backed by an LMDB database: for benchmarking validation against ledgers too big for memory
+// - Seraphis enotes, squashed enotes, and linking tags are stored in dedicated tables keyed by ledger index (or by the
+//   linking tag itself).
+// - Each reference set lookup is served by one read transaction; each added tx is committed in one write transaction,
+//   so a tx's linking tags and enotes are added atomically.
+// NOT FOR PRODUCTION
+
+#pragma once
+
+//local headers
+#include "crypto/crypto.h"
+extern "C"
+{
+#include "crypto/crypto-ops.h"
+}
+#include "ledger_context.h"
+#include "ringct/rctTypes.h"
+
+//third party headers
+#include <lmdb.h>
+
+//standard headers
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+//forward declarations
+namespace mock_tx
+{
+    struct MockENoteSpV1;
+    class MockTxSpConciseV1;
+    class MockTxSpMergeV1;
+    class MockTxSpPlainV1;
+    class MockTxSpSquashedV1;
+}
+
+
+namespace mock_tx
+{
+
+class MockLedgerContextLMDB final : public LedgerContext
+{
+public:
+//constructors
+    /**
+    * brief: open (or create) an LMDB-backed mock ledger
+    * param: db_path - directory of the database (must exist)
+    * param: map_size - max size of the database in bytes (space is only used as the database grows)
+    */
+    explicit MockLedgerContextLMDB(const std::string &db_path, const std::size_t map_size = std::size_t{1} << 36);
+    /// disable copies (the ledger owns an LMDB environment)
+    MockLedgerContextLMDB(const MockLedgerContextLMDB&) = delete;
+
+//overloaded operators
+    /// disable copy assignment
+    MockLedgerContextLMDB& operator=(const MockLedgerContextLMDB&) = delete;
+
+//destructor
+    ~MockLedgerContextLMDB();
+
+//member functions
+    /**
+    * brief: linking_tag_exists_sp_v1 - checks if a Seraphis linking tag exists in the ledger
+    * param: linking_tag -
+    * return: true/false on check result
+    */
+    bool linking_tag_exists_sp_v1(const crypto::key_image &linking_tag) const override;
+    /**
+    * brief: linking_tags_exist_sp_v1 - checks which of a set of Seraphis linking tags exist in the ledger
+    *   - tags are probed in key order with one cursor in one read transaction
+    * param: linking_tags -
+    * outparam: exist_out - exist_out[i] is true if linking_tags[i] exists in the ledger
+    */
+    void linking_tags_exist_sp_v1(const std::vector<crypto::key_image> &linking_tags,
+        std::vector<bool> &exist_out) const override;
+    /**
+    * brief: get_reference_set_sp_v1 - gets Seraphis enotes stored in the ledger
+    * param: indices -
+    * outparam: enotes_out - 
+    */
+    void get_reference_set_sp_v1(const std::vector<std::size_t> &indices,
+        std::vector<MockENoteSpV1> &enotes_out) const override;
+    /**
+    * brief: get_reference_set_components_sp_v1 - gets components of Seraphis enotes stored in the ledger
+    * param: indices -
+    * outparam: referenced_enotes_components_out - {{enote address, enote amount commitment}}
+    */
+    void get_reference_set_components_sp_v1(const std::vector<std::size_t> &indices,
+        rct::KeyMatrix &referenced_enotes_components_out) const override;
+    /**
+    * brief: get_reference_set_components_sp_v2 - gets Seraphis squashed enotes stored in the ledger
+    * param: indices -
+    * outparam: referenced_enotes_components_out - {{squashed enote}}
+    */
+    void get_reference_set_components_sp_v2(const std::vector<std::size_t> &indices,
+        rct::KeyMatrix &referenced_enotes_components_out) const override;
+    /**
+    * brief: get_reference_set_components_sp_v2_ranges - gets Seraphis squashed enotes stored in the ledger, from runs of
+    *   consecutive ledger indices (one cursor scan per run)
+    * param: ranges -
+    * outparam: referenced_enotes_components_out - {{squashed enote}}, in range order
+    */
+    void get_reference_set_components_sp_v2_ranges(const epee::span<const LedgerIndexRange> ranges,
+        rct::KeyMatrix &referenced_enotes_components_out) const override;
+    /**
+    * brief: get_reference_set_components_sp_v2_p3 - gets Seraphis squashed enotes stored in the ledger, and their
+    *   decompressed form
+    *   - enotes are decompressed on every lookup (no cache), as a disk-backed node without a point cache would
+    * param: indices -
+    * outparam: referenced_enotes_components_out - {{squashed enote}}
+    * outparam: referenced_enotes_points_out - {squashed enote (decompressed)}
+    */
+    void get_reference_set_components_sp_v2_p3(const std::vector<std::size_t> &indices,
+        rct::KeyMatrix &referenced_enotes_components_out,
+        std::vector<ge_p3> &referenced_enotes_points_out) const override;
+    /**
+    * brief: get_reference_set_components_sp_v2_p3_async - start getting Seraphis squashed enotes and their decompressed
+    *   form on a ledger fetch thread
+    *   - fetch threads are started on first use; they are separate from the common threadpool so a threadpool worker
+    *     can wait on a fetch without taking a worker from the pool
+    * param: indices -
+    * outparam: referenced_enotes_components_out - {{squashed enote}}
+    * outparam: referenced_enotes_points_out - {squashed enote (decompressed)}
+    * return: future that is ready once the outparams are set
+    */
+    std::future<void> get_reference_set_components_sp_v2_p3_async(const std::vector<std::size_t> &indices,
+        rct::KeyMatrix &referenced_enotes_components_out,
+        std::vector<ge_p3> &referenced_enotes_points_out) const override;
+    /**
+    * brief: add_transaction_sp_concise_v1 - add a MockTxSpConciseV1 transaction to the ledger
+    * param: tx_to_add -
+    */
+    void add_transaction_sp_concise_v1(const MockTxSpConciseV1 &tx_to_add) override;
+    /**
+    * brief: add_transaction_sp_merge_v1 - add a MockTxSpMergeV1 transaction to the ledger
+    * param: tx_to_add -
+    */
+    void add_transaction_sp_merge_v1(const MockTxSpMergeV1 &tx_to_add) override;
+    /**
+    * brief: add_transaction_sp_plain_v1 - add a MockTxSpPlainV1 transaction to the ledger
+    * param: tx_to_add -
+    */
+    void add_transaction_sp_plain_v1(const MockTxSpPlainV1 &tx_to_add) override;
+    /**
+    * brief: add_transaction_sp_squashed_v1 - add a MockTxSpSquashedV1 transaction to the ledger
+    * param: tx_to_add -
+    */
+    void add_transaction_sp_squashed_v1(const MockTxSpSquashedV1 &tx_to_add) override;
+    /**
+    * brief: add_linking_tag_sp_v1 - add a Seraphis linking tag to the ledger
+    * param: linking_tag -
+    */
+    void add_linking_tag_sp_v1(const crypto::key_image &linking_tag);
+    /**
+    * brief: add_enote_sp_v1 - add a Seraphis v1 enote to the ledger
+    * param: enote -
+    * return: index in the ledger of the enote just added
+    */
+    std::size_t add_enote_sp_v1(const MockENoteSpV1 &enote) override;
+    /**
+    * brief: add_enote_sp_v2 - add a Seraphis v1 enote to the ledger (and store the squashed enote)
+    * param: enote -
+    * return: index in the ledger of the enote just added
+    */
+    std::size_t add_enote_sp_v2(const MockENoteSpV1 &enote) override;
+    /**
+    * brief: add_enotes_sp_v1 - add a set of Seraphis v1 enotes to the ledger in one step, at consecutive indices
+    * param: enotes -
+    * return: index in the ledger of the first enote just added
+    */
+    std::size_t add_enotes_sp_v1(const std::vector<MockENoteSpV1> &enotes) override;
+    /**
+    * brief: add_enotes_sp_v2 - add a set of Seraphis v1 enotes to the ledger in one step, at consecutive indices (and
+    *   store their squashed enotes)
+    *   - the squashed enotes are computed in parallel before opening the write transaction
+    * param: enotes -
+    * param: num_threads - max number of threads for squashing the enotes (0 = threadpool max concurrency; 1 = serial)
+    * return: index in the ledger of the first enote just added
+    */
+    std::size_t add_enotes_sp_v2(const std::vector<MockENoteSpV1> &enotes, const std::size_t num_threads) override;
+    /**
+    * brief: add_dummy_enotes_sp_v2 - append copies of one enote and its squashed enote to the ledger
+    *   - for pre-populating big benchmark ledgers (avoids recomputing the squashed enote for every copy)
+    * param: enote -
+    * param: num_enotes - number of copies to add
+    */
+    void add_dummy_enotes_sp_v2(const MockENoteSpV1 &enote, const std::size_t num_enotes);
+    /**
+    * brief: add_dummy_enotes_sp_v2 - append enotes from a pool (cycling through it) and their squashed enotes to the
+    *   ledger
+    *   - a pool of distinct enotes gives decoy-selection benchmarks distinct points without making each enote
+    * param: enote_pool -
+    * param: num_enotes - number of enotes to add
+    */
+    void add_dummy_enotes_sp_v2(const std::vector<MockENoteSpV1> &enote_pool, const std::size_t num_enotes);
+    /**
+    * brief: get_num_enotes - get the number of enotes in the ledger
+    * return: number of enotes
+    */
+    std::size_t get_num_enotes() const;
+
+private:
+    /// implementations of the above, inside a caller's write transaction
+    void add_linking_tag_sp_v1_impl(MDB_txn *txn, const crypto::key_image &linking_tag);
+    std::size_t add_enote_sp_v1_impl(MDB_txn *txn, const MockENoteSpV1 &enote);
+    std::size_t add_enote_sp_v2_impl(MDB_txn *txn, const MockENoteSpV1 &enote, const rct::key &squashed_enote);
+    std::size_t get_num_enotes_impl(MDB_txn *txn) const;
+    /// run queued fetches until the ledger is destroyed
+    void run_fetch_thread() const;
+
+    /// LMDB environment
+    MDB_env *m_env{nullptr};
+
+    /// Seraphis linking tags {linking tag : empty}
+    MDB_dbi m_sp_linking_tags;
+    /// Seraphis v1 ENotes {ledger index : Ko | C | enc(a) | view_tag}
+    MDB_dbi m_sp_enotes;
+    /// Seraphis squashed enotes {ledger index : squashed enote}
+    MDB_dbi m_sp_squashed_enotes;
+
+    /// background reference set fetches (read transactions are thread-independent with MDB_NOTLS)
+    mutable std::mutex m_fetch_mutex;
+    mutable std::condition_variable m_fetch_cv;
+    mutable std::deque<std::packaged_task<void()>> m_fetch_queue;
+    mutable std::vector<std::thread> m_fetch_threads;
+    mutable bool m_stop_fetching{false};
+};
+
+} //namespace mock_tx
@@ -0,0 +1,231 @@
+// Copyright (c) 2021, The Monero Project
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this list of
+//    conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list
+//    of conditions and the following disclaimer in the documentation and/or other
+//    materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its contributors may be
+//    used to endorse or promote products derived from this software without specific
+//    prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+// THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// NOT FOR PRODUCTION
+
+//paired header
+#include "mock_linking_tag_set.h"
+
+//local headers
+#include "crypto/crypto.h"
+#include "span.h"
+
+//third party headers
+
+//standard headers
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#undef MONERO_DEFAULT_LOG_CATEGORY
+#define MONERO_DEFAULT_LOG_CATEGORY "mock_tx"
+
+namespace mock_tx
+{
+
+/// smallest slot array
+static constexpr std::size_t MIN_LINKING_TAG_SLOTS{16};
+/// number of tags whose home slots are prefetched together by the batch functions
+static constexpr std::size_t LINKING_TAG_PREFETCH_GROUP_SIZE{16};
+
+//-------------------------------------------------------------------------------------------------------------------
+// the empty slot marker
+//-------------------------------------------------------------------------------------------------------------------
+static bool is_zero_tag(const crypto::key_image &linking_tag)
+{
+    static const crypto::key_image zero_tag{};
+
+    return memcmp(linking_tag.data, zero_tag.data, sizeof(crypto::key_image)) == 0;
+}
+//-------------------------------------------------------------------------------------------------------------------
+// hint that a slot will be read soon
+//-------------------------------------------------------------------------------------------------------------------
+static void prefetch_slot(const crypto::key_image &slot)
+{
+#if defined(__GNUC__)
+    __builtin_prefetch(&slot);
+#else
+    (void) slot;
+#endif
+}
+//-------------------------------------------------------------------------------------------------------------------
+void LinkingTagSet::reserve(const std::size_t num_tags)
+{
+    if (2*num_tags > m_slots.size())
+        grow(num_tags);
+}
+//-------------------------------------------------------------------------------------------------------------------
+bool LinkingTagSet::contains(const crypto::key_image &linking_tag) const
+{
+    if (is_zero_tag(linking_tag))
+        return m_has_zero_tag;
+
+    if (m_slots.empty())
+        return false;
+
+    // linear probe until the tag or an empty slot
+    const std::size_t slot_mask{m_slots.size() - 1};
+
+    for (std::size_t slot{get_slot(linking_tag)}; ; slot = (slot + 1) & slot_mask)
+    {
+        if (m_slots[slot] == linking_tag)
+            return true;
+        if (is_zero_tag(m_slots[slot]))
+            return false;
+    }
+}
+//-------------------------------------------------------------------------------------------------------------------
+void LinkingTagSet::contains_batch(const epee::span<const crypto::key_image> linking_tags,
+    std::vector<bool> &exist_out) const
+{
+    exist_out.assign(linking_tags.size(), false);
+
+    for (std::size_t group_begin{0}; group_begin < linking_tags.size(); group_begin += LINKING_TAG_PREFETCH_GROUP_SIZE)
+    {
+        const std::size_t group_end{
+                std::min(group_begin + LINKING_TAG_PREFETCH_GROUP_SIZE, linking_tags.size())
+            };
+
+        if (!m_slots.empty())
+        {
+            for (std::size_t tag_index{group_begin}; tag_index < group_end; ++tag_index)
+                prefetch_slot(m_slots[get_slot(linking_tags[tag_index])]);
+        }
+
+        for (std::size_t tag_index{group_begin}; tag_index < group_end; ++tag_index)
+            exist_out[tag_index] = contains(linking_tags[tag_index]);
+    }
+}
+//-------------------------------------------------------------------------------------------------------------------
+bool LinkingTagSet::insert(const crypto::key_image &linking_tag)
+{
+    if (is_zero_tag(linking_tag))
+    {
+        if (m_has_zero_tag)
+            return false;
+
+        m_has_zero_tag = true;
+        ++m_num_tags;
+        return true;
+    }
+
+    // keep the load factor at or below 1/2 (counting a possible zero tag is harmless)
+    reserve(m_num_tags + 1);
+
+    return insert_nonzero_impl(linking_tag);
+}
+//-------------------------------------------------------------------------------------------------------------------
+std::size_t LinkingTagSet::insert_batch(const epee::span<const crypto::key_image> linking_tags)
+{
+    // grow once for the whole batch
+    reserve(m_num_tags + linking_tags.size());
+
+    std::size_t num_inserted{0};
+
+    for (std::size_t group_begin{0}; group_begin < linking_tags.size(); group_begin += LINKING_TAG_PREFETCH_GROUP_SIZE)
+    {
+        const std::size_t group_end{
+                std::min(group_begin + LINKING_TAG_PREFETCH_GROUP_SIZE, linking_tags.size())
+            };
+
+        for (std::size_t tag_index{group_begin}; tag_index < group_end; ++tag_index)
+            prefetch_slot(m_slots[get_slot(linking_tags[tag_index])]);
+
+        for (std::size_t tag_index{group_begin}; tag_index < group_end; ++tag_index)
+        {
+            if (insert(linking_tags[tag_index]))
+                ++num_inserted;
+        }
+    }
+
+    return num_inserted;
+}
+//-------------------------------------------------------------------------------------------------------------------
+void LinkingTagSet::get_linking_tags(std::vector<crypto::key_image> &linking_tags_inout) const
+{
+    linking_tags_inout.reserve(linking_tags_inout.size() + m_num_tags);
+
+    if (m_has_zero_tag)
+        linking_tags_inout.emplace_back();
+
+    for (const crypto::key_image &linking_tag : m_slots)
+    {
+        if (!is_zero_tag(linking_tag))
+            linking_tags_inout.emplace_back(linking_tag);
+    }
+}
+//-------------------------------------------------------------------------------------------------------------------
+std::size_t LinkingTagSet::get_slot(const crypto::key_image &linking_tag) const
+{
+    // the tag is uniformly random, so its first bytes are already a good hash
+    std::uint64_t hash;
+    memcpy(&hash, linking_tag.data, sizeof(hash));
+
+    return static_cast<std::size_t>(hash) & (m_slots.size() - 1);
+}
+//-------------------------------------------------------------------------------------------------------------------
+bool LinkingTagSet::insert_nonzero_impl(const crypto::key_image &linking_tag)
+{
+    const std::size_t slot_mask{m_slots.size() - 1};
+
+    for (std::size_t slot{get_slot(linking_tag)}; ; slot = (slot + 1) & slot_mask)
+    {
+        if (m_slots[slot] == linking_tag)
+            return false;
+
+        if (is_zero_tag(m_slots[slot]))
+        {
+            m_slots[slot] = linking_tag;
+            ++m_num_tags;
+            return true;
+        }
+    }
+}
+//-------------------------------------------------------------------------------------------------------------------
+void LinkingTagSet::grow(const std::size_t num_tags)
+{
+    std::size_t num_slots{std::max(m_slots.size(), MIN_LINKING_TAG_SLOTS)};
+    while (num_slots < 2*num_tags)
+        num_slots *= 2;
+
+    if (num_slots == m_slots.size())
+        return;
+
+    // move the tags to their slots in the larger array
+    std::vector<crypto::key_image> old_slots{std::move(m_slots)};
+    m_slots.assign(num_slots, crypto::key_image{});
+    m_num_tags = m_has_zero_tag ? 1 : 0;
+
+    for (const crypto::key_image &linking_tag : old_slots)
+    {
+        if (!is_zero_tag(linking_tag))
+            insert_nonzero_impl(linking_tag);
+    }
+}
+//-------------------------------------------------------------------------------------------------------------------
+} //namespace mock_tx
@@ -0,0 +1,113 @@
+// Copyright (c) 2021, The Monero Project
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this list of
+//    conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list
+//    of conditions and the following disclaimer in the documentation and/or other
+//    materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its contributors may be
+//    used to endorse or promote products derived from this software without specific
+//    prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+// THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// Flat hash set of linking tags (key images), for mock ledgers.
+// NOT FOR PRODUCTION
+
+#pragma once
+
+//local headers
+#include "crypto/crypto.h"
+#include "span.h"
+
+//third party headers
+
+//standard headers
+#include <cstdint>
+#include <vector>
+
+//forward declarations
+
+
+namespace mock_tx
+{
+
+////
+// LinkingTagSet - open-addressing set of linking tags
+// - linking tags are uniformly random 32-byte keys, so a tag's first 8 bytes are used directly as its hash (no
+//   hashing or rehashing of keys); collisions are resolved by linear probing
+// - slots are one flat array of tags, with the all-zero tag as the empty marker (a real all-zero tag is tracked by
+//   a flag)
+// - the batch functions prefetch the home slots of a group of tags before probing them
+///
+class LinkingTagSet final
+{
+public:
+//member functions
+    /// number of tags in the set
+    std::size_t size() const { return m_num_tags; }
+    /// make room for at least this many tags without growing
+    void reserve(const std::size_t num_tags);
+    /// bytes allocated for the slots
+    std::size_t get_storage_bytes() const { return m_slots.capacity()*sizeof(crypto::key_image); }
+
+    /**
+    * brief: contains - check if a tag is in the set
+    * param: linking_tag -
+    * return: true if the tag is in the set
+    */
+    bool contains(const crypto::key_image &linking_tag) const;
+    /**
+    * brief: contains_batch - check which of a set of tags are in the set
+    * param: linking_tags -
+    * outparam: exist_out - exist_out[i] is true if linking_tags[i] is in the set
+    */
+    void contains_batch(const epee::span<const crypto::key_image> linking_tags, std::vector<bool> &exist_out) const;
+    /**
+    * brief: insert - add a tag to the set
+    * param: linking_tag -
+    * return: false if the tag was already in the set
+    */
+    bool insert(const crypto::key_image &linking_tag);
+    /**
+    * brief: insert_batch - add a set of tags to the set
+    * param: linking_tags -
+    * return: number of tags that were not already in the set (duplicates in the batch count once)
+    */
+    std::size_t insert_batch(const epee::span<const crypto::key_image> linking_tags);
+    /**
+    * brief: get_linking_tags - get every tag in the set (in no particular order)
+    * inoutparam: linking_tags_inout - the tags are appended to this
+    */
+    void get_linking_tags(std::vector<crypto::key_image> &linking_tags_inout) const;
+
+private:
+    /// home slot of a tag
+    std::size_t get_slot(const crypto::key_image &linking_tag) const;
+    /// insert a nonzero tag without growing (there must be a free slot)
+    bool insert_nonzero_impl(const crypto::key_image &linking_tag);
+    /// grow the slot array so it can hold 'num_tags' tags
+    void grow(const std::size_t num_tags);
+
+    /// tag slots (size is 0 or a power of 2; all-zero = empty)
+    std::vector<crypto::key_image> m_slots;
+    /// the all-zero tag is in the set (it can't be stored in a slot)
+    bool m_has_zero_tag{false};
+    std::size_t m_num_tags{0};
+};
+
+} //namespace mock_tx
@@ -32,15 +32,19 @@
 #include "mock_rct_clsag.h"
 
 //local headers
+#include "common/perf_timer.h"
 #include "crypto/crypto.h"
 #include "ledger_context.h"
 #include "misc_log_ex.h"
 #include "mock_ledger_context.h"
 #include "mock_rct_base.h"
 #include "mock_rct_components.h"
+#include "mock_tx_phase_timers.h"
 #include "mock_tx_utils.h"
+#include "mock_tx_verification_cost.h"
 #include "ringct/bulletproofs_plus.h"
 #include "ringct/rctTypes.h"
+#include "seraphis_crypto_utils.h"
 
 //third party headers
 
@@ -135,11 +139,30 @@ std::size_t MockTxCLSAG::get_size_bytes() const
     return size;
 }
 //-------------------------------------------------------------------------------------------------------------------
+MockTxVerificationOps MockTxCLSAG::estimate_verification_ops() const
+{
+    MockTxVerificationOps ops;
+
+    // semantics: linking tags are in the prime subgroup
+    ops += get_linking_tag_semantics_verification_ops(m_input_images.size());
+
+    // amount balance and range proofs
+    ops += get_balance_check_verification_ops(m_input_images.size(), m_outputs.size(), m_outputs.size());
+    if (m_balance_proof.get() != nullptr)
+        ops += get_bpp_verification_ops(m_balance_proof->m_bpp_proofs);
+
+    // membership/ownership proofs
+    for (const MockRctProofV1 &tx_proof : m_tx_proofs)
+        ops += get_clsag_verification_ops(tx_proof.m_referenced_enotes_converted.size());
+
+    return ops;
+}
+//-------------------------------------------------------------------------------------------------------------------
 template <>
 std::shared_ptr<MockTxCLSAG> make_mock_tx<MockTxCLSAG>(const MockTxParamPack &params,
     const std::vector<rct::xmr_amount> &in_amounts,
     const std::vector<rct::xmr_amount> &out_amounts,
-    std::shared_ptr<MockLedgerContext> ledger_context)
+    std::shared_ptr<LedgerContext> ledger_context)
 {
     CHECK_AND_ASSERT_THROW_MES(in_amounts.size() > 0, "Tried to make tx without any inputs.");
     CHECK_AND_ASSERT_THROW_MES(out_amounts.size() > 0, "Tried to make tx without any outputs.");
@@ -187,19 +210,28 @@ std::shared_ptr<MockTxCLSAG> make_mock_tx<MockTxCLSAG>(const MockTxParamPack &pa
 }
 //-------------------------------------------------------------------------------------------------------------------
 template <>
-bool validate_mock_txs<MockTxCLSAG>(const std::vector<std::shared_ptr<MockTxCLSAG>> &txs_to_validate,
-    const std::shared_ptr<const LedgerContext> ledger_context)
+bool try_get_mock_txs_batch_validation_data<MockTxCLSAG>(
+    const std::vector<std::shared_ptr<MockTxCLSAG>> &txs_to_validate,
+    const std::size_t begin_index,
+    const std::size_t end_index,
+    const std::shared_ptr<const LedgerContext> ledger_context,
+    std::vector<rct::pippenger_prep_data> &prep_datas_out)
 {
+    CHECK_AND_ASSERT_THROW_MES(begin_index <= end_index && end_index <= txs_to_validate.size(),
+        "Invalid tx range for batch validation data.");
+
     std::vector<const rct::BulletproofPlus*> range_proofs;
-    range_proofs.reserve(txs_to_validate.size()*10);
+    range_proofs.reserve((end_index - begin_index)*10);
 
-    for (const auto &tx : txs_to_validate)
+    for (std::size_t tx_index{begin_index}; tx_index < end_index; ++tx_index)
     {
+        const std::shared_ptr<MockTxCLSAG> &tx{txs_to_validate[tx_index]};
+
         if (tx.get() == nullptr)
             return false;
 
         // validate unbatchable parts of tx
-        if (!tx->validate(ledger_context, true))
+        if (!validate_mock_tx(*tx, ledger_context, true))
             return false;
 
         // gather range proofs
@@ -212,8 +244,40 @@ bool validate_mock_txs<MockTxCLSAG>(const std::vector<std::shared_ptr<MockTxCLSA
             range_proofs.push_back(&range_proof);
     }
 
+    // collect range proof pippenger data
+    prep_datas_out.resize(1);
+
+    MOCK_TX_PHASE_TIMER(RANGE_PROOF_DATA);
+    return rct::try_get_bulletproof_plus_verification_data(range_proofs, prep_datas_out[0]);
+}
+//-------------------------------------------------------------------------------------------------------------------
+template <>
+bool validate_mock_txs<MockTxCLSAG>(const std::vector<std::shared_ptr<MockTxCLSAG>> &txs_to_validate,
+    const std::shared_ptr<const LedgerContext> ledger_context,
+    const std::size_t num_threads)
+{
+    PERF_TIMER(validate_mock_txs_clsag);
+
+    // prepare for batch-verification (in parallel: each shard of txs gets its own range proof batch)
+    auto try_get_shard_data =
+        [&txs_to_validate, &ledger_context](const std::size_t begin,
+            const std::size_t end,
+            std::vector<rct::pippenger_prep_data> &shard_prep_datas_out) -> bool
+        {
+            return try_get_mock_txs_batch_validation_data<MockTxCLSAG>(txs_to_validate,
+                begin,
+                end,
+                ledger_context,
+                shard_prep_datas_out);
+        };
+
+    std::vector<rct::pippenger_prep_data> prep_datas;
+
+    if (!try_get_batch_validation_data_sharded(txs_to_validate.size(), num_threads, try_get_shard_data, prep_datas))
+        return false;
+
     // batch verify range proofs
-    if (!rct::bulletproof_plus_VERIFY(range_proofs))
+    if (!sp::check_pippenger_data(prep_datas, num_threads))
         return false;
 
     return true;
@@ -40,12 +40,15 @@ extern "C"
 #include "device/device.hpp"
 #include "misc_log_ex.h"
 #include "mock_rct_base.h"
+#include "mock_tx_phase_timers.h"
 #include "mock_tx_utils.h"
 #include "ringct/bulletproofs_plus.h"
+#include "ringct/multiexp.h"
 #include "ringct/rctOps.h"
 #include "ringct/rctSigs.h"
 #include "ringct/rctTypes.h"
 #include "ringct/triptych.h"
+#include "seraphis_crypto_utils.h"
 
 //third party headers
 
@@ -197,6 +200,8 @@ std::size_t MockRctBalanceProofV1::get_size_bytes() const
 std::vector<MockInputRctV1> gen_mock_rct_inputs_v1(const std::vector<rct::xmr_amount> &amounts,
     const std::size_t ref_set_size)
 {
+    MOCK_TX_PHASE_TIMER(REF_SET_BUILD);
+
     CHECK_AND_ASSERT_THROW_MES(ref_set_size > 0, "Tried to create inputs with no ref set size.");
 
     std::vector<MockInputRctV1> inputs;
@@ -360,6 +365,7 @@ void make_v1_tx_input_proofs_rct_v1(const std::vector<MockInputRctV1> &inputs_to
 
         // create CLSAG proof and save it
         MockRctProofV1 mock_clsag_proof;
+        MOCK_TX_PHASE_TIMER(MEMBERSHIP_PROOF_PROVE);
         mock_clsag_proof.m_clsag_proof = rct::proveRctCLSAGSimple(
                 rct::zero(),                  // empty message for mockup
                 referenced_enotes_converted,  // vector of pairs <Ko_i, C_i> for referenced enotes
@@ -423,6 +429,7 @@ void make_v2_tx_input_proofs_rct_v1(const std::vector<MockInputRctV1> &inputs_to
         mock_Triptych_proof.m_ref_set_decomp_m = ref_set_decomp_m;
 
         // create Triptych proof
+        MOCK_TX_PHASE_TIMER(MEMBERSHIP_PROOF_PROVE);
         mock_Triptych_proof.m_triptych_proof = rct::triptych_prove(
                 mock_Triptych_proof.m_onetime_addresses,                     // one-time pubkeys Ko
                 mock_Triptych_proof.m_commitments,                           // output commitments C
@@ -667,27 +674,48 @@ bool validate_mock_tx_rct_proofs_v1(const std::vector<MockRctProofV1> &proofs,
     return true;
 }
 //-------------------------------------------------------------------------------------------------------------------
-bool validate_mock_tx_rct_proofs_v2(const std::vector<MockRctProofV2> &proofs)
+bool try_get_mock_tx_rct_proofs_v2_validation_data(const std::vector<MockRctProofV2> &proofs,
+    std::vector<rct::pippenger_prep_data> &prep_datas_out)
 {
-    // verify input membership/ownership/unspentness proofs
+    MOCK_TX_PHASE_TIMER(MEMBERSHIP_PROOF_DATA);
+
+    prep_datas_out.clear();
+    prep_datas_out.reserve(proofs.size());
+
+    // one data set per input: all inputs define separate rings, but the data sets can still be summed in one multiexp
     for (std::size_t input_index{0}; input_index < proofs.size(); ++input_index)
     {
         std::vector<const rct::TriptychProof*> proof;
         proof.emplace_back(&(proofs[input_index].m_triptych_proof));
 
-        // note: only verify one triptych proof at a time (not batchable in my approach where all inputs define separate rings)
-        if (!rct::triptych_verify(
-                proofs[input_index].m_onetime_addresses,
-                proofs[input_index].m_commitments,
-                rct::keyV{proofs[input_index].m_pseudo_amount_commitment},
-                proof,
-                proofs[input_index].m_ref_set_decomp_n,
-                proofs[input_index].m_ref_set_decomp_m,
-                rct::keyV{rct::zero()}))  // empty message for mockup
-            return false;
+        try
+        {
+            prep_datas_out.emplace_back(rct::get_triptych_verification_data(
+                    proofs[input_index].m_onetime_addresses,
+                    proofs[input_index].m_commitments,
+                    rct::keyV{proofs[input_index].m_pseudo_amount_commitment},
+                    proof,
+                    proofs[input_index].m_ref_set_decomp_n,
+                    proofs[input_index].m_ref_set_decomp_m,
+                    rct::keyV{rct::zero()}));  // empty message for mockup
+        }
+        catch (...) { return false; }
     }
 
     return true;
 }
 //-------------------------------------------------------------------------------------------------------------------
+bool validate_mock_tx_rct_proofs_v2(const std::vector<MockRctProofV2> &proofs, const bool defer_batchable)
+{
+    // verify input membership/ownership/unspentness proofs
+    if (defer_batchable)
+        return true;
+
+    std::vector<rct::pippenger_prep_data> prep_datas;
+    if (!try_get_mock_tx_rct_proofs_v2_validation_data(proofs, prep_datas))
+        return false;
+
+    return sp::check_pippenger_data(prep_datas);
+}
+//-------------------------------------------------------------------------------------------------------------------
 } //namespace mock_tx
@@ -42,6 +42,7 @@
 #include <vector>
 
 //forward declarations
+namespace rct { struct pippenger_prep_data; }
 
 
 namespace mock_tx
@@ -375,12 +376,21 @@ bool validate_mock_tx_rct_amount_balance_v1(const std::vector<MockENoteImageRctV
 bool validate_mock_tx_rct_proofs_v1(const std::vector<MockRctProofV1> &proofs,
     const std::vector<MockENoteImageRctV1> &images);
 /**
+* brief: try_get_mock_tx_rct_proofs_v2_validation_data - get pippenger data for a set of V2 RCT proofs from a tx
+*   - one data set per Triptych proof (each input has its own reference set)
+* param: proofs -
+* outparam: prep_datas_out - pippenger data sets that sum to the identity if all proofs are valid
+* return: false if a proof is malformed
+*/
+bool try_get_mock_tx_rct_proofs_v2_validation_data(const std::vector<MockRctProofV2> &proofs,
+    std::vector<rct::pippenger_prep_data> &prep_datas_out);
+/**
 * brief: validate_mock_tx_rct_proofs_v2 - validate a set of V2 RCT proofs from a tx
 *   - Triptych proofs for: membership, ownership, unspentness
 * param: proofs -
-* param: images -
+* param: defer_batchable - skip the Triptych proofs (they can be batch verified across txs)
 * return: true/false on verification result
 */
-bool validate_mock_tx_rct_proofs_v2(const std::vector<MockRctProofV2> &proofs);
+bool validate_mock_tx_rct_proofs_v2(const std::vector<MockRctProofV2> &proofs, const bool defer_batchable);
 
 } //namespace mock_tx
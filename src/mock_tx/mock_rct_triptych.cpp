@@ -32,14 +32,18 @@
 #include "mock_rct_triptych.h"
 
 //local headers
+#include "common/perf_timer.h"
 #include "crypto/crypto.h"
 #include "misc_log_ex.h"
 #include "mock_rct_base.h"
 #include "mock_rct_components.h"
+#include "mock_tx_phase_timers.h"
 #include "mock_tx_utils.h"
+#include "mock_tx_verification_cost.h"
 #include "ringct/bulletproofs_plus.h"
 #include "ringct/rctOps.h"
 #include "ringct/rctTypes.h"
+#include "seraphis_crypto_utils.h"
 
 //third party headers
 
@@ -100,7 +104,7 @@ bool MockTxTriptych::validate_tx_amount_balance(const bool defer_batchable) cons
 bool MockTxTriptych::validate_tx_input_proofs(const std::shared_ptr<const LedgerContext> ledger_context,
     const bool defer_batchable) const
 {
-    if (!validate_mock_tx_rct_proofs_v2(m_tx_proofs))
+    if (!validate_mock_tx_rct_proofs_v2(m_tx_proofs, defer_batchable))
         return false;
 
     return true;
@@ -135,11 +139,30 @@ std::size_t MockTxTriptych::get_size_bytes() const
     return size;
 }
 //-------------------------------------------------------------------------------------------------------------------
+MockTxVerificationOps MockTxTriptych::estimate_verification_ops() const
+{
+    MockTxVerificationOps ops;
+
+    // semantics: linking tags are in the prime subgroup
+    ops += get_linking_tag_semantics_verification_ops(m_input_images.size());
+
+    // amount balance and range proofs
+    ops += get_balance_check_verification_ops(m_input_images.size(), m_outputs.size(), m_outputs.size());
+    if (m_balance_proof.get() != nullptr)
+        ops += get_bpp_verification_ops(m_balance_proof->m_bpp_proofs);
+
+    // membership/ownership proofs
+    for (const MockRctProofV2 &tx_proof : m_tx_proofs)
+        ops += get_triptych_verification_ops(tx_proof.m_ref_set_decomp_n, tx_proof.m_ref_set_decomp_m);
+
+    return ops;
+}
+//-------------------------------------------------------------------------------------------------------------------
 template <>
 std::shared_ptr<MockTxTriptych> make_mock_tx<MockTxTriptych>(const MockTxParamPack &params,
     const std::vector<rct::xmr_amount> &in_amounts,
     const std::vector<rct::xmr_amount> &out_amounts,
-    std::shared_ptr<MockLedgerContext> ledger_context)
+    std::shared_ptr<LedgerContext> ledger_context)
 {
     CHECK_AND_ASSERT_THROW_MES(in_amounts.size() > 0, "Tried to make tx without any inputs.");
     CHECK_AND_ASSERT_THROW_MES(out_amounts.size() > 0, "Tried to make tx without any outputs.");
@@ -190,21 +213,42 @@ std::shared_ptr<MockTxTriptych> make_mock_tx<MockTxTriptych>(const MockTxParamPa
 }
 //-------------------------------------------------------------------------------------------------------------------
 template <>
-bool validate_mock_txs<MockTxTriptych>(const std::vector<std::shared_ptr<MockTxTriptych>> &txs_to_validate,
-    const std::shared_ptr<const LedgerContext> ledger_context)
+bool try_get_mock_txs_batch_validation_data<MockTxTriptych>(
+    const std::vector<std::shared_ptr<MockTxTriptych>> &txs_to_validate,
+    const std::size_t begin_index,
+    const std::size_t end_index,
+    const std::shared_ptr<const LedgerContext> ledger_context,
+    std::vector<rct::pippenger_prep_data> &prep_datas_out)
 {
+    CHECK_AND_ASSERT_THROW_MES(begin_index <= end_index && end_index <= txs_to_validate.size(),
+        "Invalid tx range for batch validation data.");
+
     std::vector<const rct::BulletproofPlus*> range_proofs;
-    range_proofs.reserve(txs_to_validate.size()*10);
+    range_proofs.reserve((end_index - begin_index)*10);
+
+    // range proofs first, then one Triptych data set per input
+    prep_datas_out.clear();
+    prep_datas_out.resize(1);
+    std::vector<rct::pippenger_prep_data> input_prep_datas;
 
-    for (const auto &tx : txs_to_validate)
+    for (std::size_t tx_index{begin_index}; tx_index < end_index; ++tx_index)
     {
+        const std::shared_ptr<MockTxTriptych> &tx{txs_to_validate[tx_index]};
+
         if (tx.get() == nullptr)
             return false;
 
         // validate unbatchable parts of tx
-        if (!tx->validate(ledger_context, true))
+        if (!validate_mock_tx(*tx, ledger_context, true))
+            return false;
+
+        // gather Triptych proof data
+        if (!try_get_mock_tx_rct_proofs_v2_validation_data(tx->get_tx_proofs(), input_prep_datas))
             return false;
 
+        for (rct::pippenger_prep_data &input_prep_data : input_prep_datas)
+            prep_datas_out.emplace_back(std::move(input_prep_data));
+
         // gather range proofs
         const std::shared_ptr<MockRctBalanceProofV1> balance_proof{tx->get_balance_proof()};
 
@@ -215,8 +259,38 @@ bool validate_mock_txs<MockTxTriptych>(const std::vector<std::shared_ptr<MockTxT
             range_proofs.push_back(&range_proof);
     }
 
-    // batch verify range proofs
-    if (!rct::bulletproof_plus_VERIFY(range_proofs))
+    // collect range proof pippenger data
+    MOCK_TX_PHASE_TIMER(RANGE_PROOF_DATA);
+    return rct::try_get_bulletproof_plus_verification_data(range_proofs, prep_datas_out[0]);
+}
+//-------------------------------------------------------------------------------------------------------------------
+template <>
+bool validate_mock_txs<MockTxTriptych>(const std::vector<std::shared_ptr<MockTxTriptych>> &txs_to_validate,
+    const std::shared_ptr<const LedgerContext> ledger_context,
+    const std::size_t num_threads)
+{
+    PERF_TIMER(validate_mock_txs_triptych);
+
+    // prepare for batch-verification (in parallel: each shard of txs gets its own range proof batch and Triptych data sets)
+    auto try_get_shard_data =
+        [&txs_to_validate, &ledger_context](const std::size_t begin,
+            const std::size_t end,
+            std::vector<rct::pippenger_prep_data> &shard_prep_datas_out) -> bool
+        {
+            return try_get_mock_txs_batch_validation_data<MockTxTriptych>(txs_to_validate,
+                begin,
+                end,
+                ledger_context,
+                shard_prep_datas_out);
+        };
+
+    std::vector<rct::pippenger_prep_data> prep_datas;
+
+    if (!try_get_batch_validation_data_sharded(txs_to_validate.size(), num_threads, try_get_shard_data, prep_datas))
+        return false;
+
+    // batch verify range proofs and Triptych proofs
+    if (!sp::check_pippenger_data(prep_datas, num_threads))
         return false;
 
     return true;
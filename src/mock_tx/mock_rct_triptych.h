@@ -49,7 +49,6 @@
 namespace mock_tx
 {
     class LedgerContext;
-    class MockLedgerContext;
 }
 
 
@@ -94,8 +93,8 @@ public:
     bool validate(const std::shared_ptr<const LedgerContext> ledger_context,
         const bool defer_batchable = false) const override
     {
-        // punt to the parent class
-        return this->MockTx::validate(ledger_context, defer_batchable);
+        // same steps as the parent class, statically dispatched
+        return validate_mock_tx(*this, ledger_context, defer_batchable);
     }
 
     /// get size of tx
@@ -104,12 +103,21 @@ public:
     /// get a short description of the tx type
     std::string get_descriptor() const override { return "Triptych"; }
 
+    /// estimate the work to verify the tx
+    MockTxVerificationOps estimate_verification_ops() const override;
+
     /// get balance proof
     const std::shared_ptr<MockRctBalanceProofV1> get_balance_proof() const { return m_balance_proof; }
 
+    /// get input proofs
+    const std::vector<MockRctProofV2>& get_tx_proofs() const { return m_tx_proofs; }
+
     //get_tx_byte_blob()
 
 private:
+    template <typename MockTxType>
+    friend bool validate_mock_tx(const MockTxType&, const std::shared_ptr<const LedgerContext>&, const bool);
+
     /// validate pieces of the tx
     bool validate_tx_semantics() const override;
     bool validate_tx_linking_tags(const std::shared_ptr<const LedgerContext> ledger_context) const override;
@@ -139,14 +147,34 @@ template <>
 std::shared_ptr<MockTxTriptych> make_mock_tx<MockTxTriptych>(const MockTxParamPack &params,
     const std::vector<rct::xmr_amount> &in_amounts,
     const std::vector<rct::xmr_amount> &out_amounts,
-    std::shared_ptr<MockLedgerContext> ledger_context);
+    std::shared_ptr<LedgerContext> ledger_context);
+/**
+* brief: try_get_mock_txs_batch_validation_data - validate the unbatchable parts of a range of MockTxTriptych
+*   transactions, and collect their batchable parts as pippenger data sets (function specialization)
+* param: txs_to_validate -
+* param: begin_index - first tx of the range
+* param: end_index - one past the last tx of the range
+* param: ledger_context -
+* outparam: prep_datas_out - pippenger data sets for the range's batchable proofs
+* return: false if a tx failed its unbatchable checks or its batch data couldn't be collected
+*/
+template <>
+bool try_get_mock_txs_batch_validation_data<MockTxTriptych>(
+    const std::vector<std::shared_ptr<MockTxTriptych>> &txs_to_validate,
+    const std::size_t begin_index,
+    const std::size_t end_index,
+    const std::shared_ptr<const LedgerContext> ledger_context,
+    std::vector<rct::pippenger_prep_data> &prep_datas_out);
 /**
 * brief: validate_mock_txs - validate a set of MockTxTriptych transactions (function specialization)
 * param: txs_to_validate -
+* param: ledger_context -
+* param: num_threads - max number of threads to use (0 = threadpool max concurrency; 1 = serial)
 * return: true/false on validation result
 */
 template <>
 bool validate_mock_txs<MockTxTriptych>(const std::vector<std::shared_ptr<MockTxTriptych>> &txs_to_validate,
-    const std::shared_ptr<const LedgerContext> ledger_context);
+    const std::shared_ptr<const LedgerContext> ledger_context,
+    const std::size_t num_threads);
 
 } //namespace mock_tx
@@ -92,17 +92,41 @@ void MockInputProposalSp::get_key_image(crypto::key_image &key_image_out) const
 void MockInputProposalSp::to_enote_image_base(const crypto::secret_key &address_mask,
     const crypto::secret_key &commitment_mask,
     MockENoteImageSp &image_inout) const
+{
+    // KI = k_a X + k_a U
+    crypto::key_image key_image;
+    this->get_key_image(key_image);
+
+    this->to_enote_image_base(address_mask, commitment_mask, key_image, image_inout);
+}
+//-------------------------------------------------------------------------------------------------------------------
+void MockInputProposalSp::to_enote_image_base(const crypto::secret_key &address_mask,
+    const crypto::secret_key &commitment_mask,
+    const crypto::key_image &key_image,
+    MockENoteImageSp &image_inout) const
 {
     // Ko' = t_k G + Ko
     sp::mask_key(address_mask, get_enote_base().m_onetime_address, image_inout.m_masked_address);
     // C' = t_c G + C
     sp::mask_key(commitment_mask, get_enote_base().m_amount_commitment, image_inout.m_masked_commitment);
     // KI = k_a X + k_a U
-    this->get_key_image(image_inout.m_key_image);
+    image_inout.m_key_image = key_image;
+}
+//-------------------------------------------------------------------------------------------------------------------
+void MockInputProposalSp::to_enote_image_squashed_base(const crypto::secret_key &address_mask,
+    const crypto::secret_key &commitment_mask,
+    MockENoteImageSp &image_inout) const
+{
+    // KI = k_a X + k_a U
+    crypto::key_image key_image;
+    this->get_key_image(key_image);
+
+    this->to_enote_image_squashed_base(address_mask, commitment_mask, key_image, image_inout);
 }
 //-------------------------------------------------------------------------------------------------------------------
 void MockInputProposalSp::to_enote_image_squashed_base(const crypto::secret_key &address_mask,
     const crypto::secret_key &commitment_mask,
+    const crypto::key_image &key_image,
     MockENoteImageSp &image_inout) const
 {
     // Ko' = t_k G + H(Ko,C) Ko
@@ -113,7 +137,7 @@ void MockInputProposalSp::to_enote_image_squashed_base(const crypto::secret_key
     // C' = t_c G + C
     sp::mask_key(commitment_mask, get_enote_base().m_amount_commitment, image_inout.m_masked_commitment);
     // KI = k_a X + k_a U
-    this->get_key_image(image_inout.m_key_image);
+    image_inout.m_key_image = key_image;
 }
 //-------------------------------------------------------------------------------------------------------------------
 void MockInputProposalSp::gen_base(const rct::xmr_amount amount)
@@ -165,6 +165,11 @@ struct MockInputProposalSp
     virtual void to_enote_image_base(const crypto::secret_key &address_mask,
         const crypto::secret_key &commitment_mask,
         MockENoteImageSp &image_inout) const final;
+    /// overload with this input's key image already made (e.g. by make_seraphis_key_images() for all inputs at once)
+    virtual void to_enote_image_base(const crypto::secret_key &address_mask,
+        const crypto::secret_key &commitment_mask,
+        const crypto::key_image &key_image,
+        MockENoteImageSp &image_inout) const final;
 
     /**
     * brief: to_enote_image_squashed_base - convert this input to an enote image in the squashed enote model
@@ -175,6 +180,11 @@ struct MockInputProposalSp
     virtual void to_enote_image_squashed_base(const crypto::secret_key &address_mask,
         const crypto::secret_key &commitment_mask,
         MockENoteImageSp &image_inout) const final;
+    /// overload with this input's key image already made
+    virtual void to_enote_image_squashed_base(const crypto::secret_key &address_mask,
+        const crypto::secret_key &commitment_mask,
+        const crypto::key_image &key_image,
+        MockENoteImageSp &image_inout) const final;
 
     /**
     * brief: gen_base - generate a Seraphis Input (all random)
@@ -36,6 +36,7 @@
 extern "C"
 {
 #include "crypto/crypto-ops.h"
+#include "crypto/siphash.h"
 }
 #include "cryptonote_config.h"
 #include "device/device.hpp"
@@ -50,6 +51,8 @@ extern "C"
 //third party headers
 
 //standard headers
+#include <algorithm>
+#include <cstring>
 #include <string>
 #include <vector>
 
@@ -58,6 +61,10 @@ extern "C"
 
 namespace mock_tx
 {
+
+/// number of enotes squashed together by seraphis_squashed_enotes_Q() (they share one field inversion)
+static constexpr std::size_t SQUASHED_ENOTE_BATCH_GROUP_SIZE{64};
+
 //-------------------------------------------------------------------------------------------------------------------
 void make_seraphis_key_image(const crypto::secret_key &y, const crypto::secret_key &z, crypto::key_image &key_image_out)
 {
@@ -67,7 +74,7 @@ void make_seraphis_key_image(const crypto::secret_key &y, const crypto::secret_k
     // KI = (z/y)*U
     rct::key temp = sp::invert(rct::sk2rct(y)); // 1/y
     sc_mul(temp.bytes, &z, temp.bytes); // z*(1/y)
-    rct::scalarmultKey(temp, sp::get_U_gen(), temp); // (z/y)*U
+    sp::scalarmult_U(temp, temp); // (z/y)*U
 
     key_image_out = rct::rct2ki(temp);
 }
@@ -84,6 +91,37 @@ void make_seraphis_key_image(const crypto::secret_key &y, const rct::key &zU, cr
     key_image_out = rct::rct2ki(temp);
 }
 //-------------------------------------------------------------------------------------------------------------------
+void make_seraphis_key_images(const std::vector<crypto::secret_key> &y,
+    const std::vector<crypto::secret_key> &z,
+    std::vector<crypto::key_image> &key_images_out)
+{
+    CHECK_AND_ASSERT_THROW_MES(y.size() == z.size(), "Key set size mismatch for making key images!");
+
+    // 1/y_i (one inversion for all of them)
+    rct::keyV y_inv;
+    y_inv.reserve(y.size());
+    for (std::size_t i{0}; i < y.size(); ++i)
+    {
+        CHECK_AND_ASSERT_THROW_MES(sc_isnonzero(&z[i]), "z must be nonzero for making a key image!");
+        CHECK_AND_ASSERT_THROW_MES(sc_isnonzero(&y[i]), "y must be nonzero for making a key image!");
+        y_inv.emplace_back(rct::sk2rct(y[i]));
+    }
+    auto y_inv_wiper = epee::misc_utils::create_scope_leave_handler([&]{
+        memwipe(y_inv.data(), y_inv.size()*sizeof(rct::key));
+    });
+    sp::invert_batch(y_inv);
+
+    // KI_i = (z_i/y_i)*U
+    key_images_out.resize(y.size());
+    rct::key temp;
+    for (std::size_t i{0}; i < y.size(); ++i)
+    {
+        sc_mul(temp.bytes, &z[i], y_inv[i].bytes); // z_i*(1/y_i)
+        sp::scalarmult_U(temp, temp); // (z_i/y_i)*U
+        key_images_out[i] = rct::rct2ki(temp);
+    }
+}
+//-------------------------------------------------------------------------------------------------------------------
 void make_seraphis_key_image_from_parts(const crypto::secret_key &k_a_sender,
     const crypto::secret_key &k_a_recipient,
     const rct::key &k_bU,
@@ -99,7 +137,7 @@ void make_seraphis_key_image_from_parts(const crypto::secret_key &k_a_sender,
 void make_seraphis_spendbase(const crypto::secret_key &spendbase_privkey, rct::key &spendbase_pubkey_out)
 {
     // spendbase = k_{b, recipient} U
-    rct::scalarmultKey(spendbase_pubkey_out, sp::get_U_gen(), rct::sk2rct(spendbase_privkey));
+    sp::scalarmult_U(rct::sk2rct(spendbase_privkey), spendbase_pubkey_out);
 }
 //-------------------------------------------------------------------------------------------------------------------
 void make_seraphis_spendkey(const crypto::secret_key &k_a, const crypto::secret_key &k_b, rct::key &spendkey_out)
@@ -116,7 +154,7 @@ void extend_seraphis_spendkey(const crypto::secret_key &k_a_extender, rct::key &
     // K = k_a_extender X + K_original
     rct::key address_temp;
 
-    rct::scalarmultKey(address_temp, sp::get_X_gen(), rct::sk2rct(k_a_extender));
+    sp::scalarmult_X(rct::sk2rct(k_a_extender), address_temp);
     rct::addKeys(spendkey_inout, address_temp, spendkey_inout);
 }
 //-------------------------------------------------------------------------------------------------------------------
@@ -124,17 +162,15 @@ void make_seraphis_squash_prefix(const rct::key &onetime_address,
     const rct::key &amount_commitment,
     crypto::secret_key &squash_prefix_out)
 {
-    static std::string domain_separator{config::HASH_KEY_SERAPHIS_SQUASHED_ENOTE};
+    static const sp::SpDomainHasher domain_hasher{config::HASH_KEY_SERAPHIS_SQUASHED_ENOTE};
 
     // H("domain-sep", Ko, C)
-    std::string hash;
-    hash.reserve(domain_separator.size() + 2*sizeof(rct::key));
-    hash += domain_separator;
-    hash.append((const char*) onetime_address.bytes, sizeof(rct::key));
-    hash.append((const char*) amount_commitment.bytes, sizeof(rct::key));
+    unsigned char hash[2*sizeof(rct::key)];
+    memcpy(hash, onetime_address.bytes, sizeof(rct::key));
+    memcpy(hash + sizeof(rct::key), amount_commitment.bytes, sizeof(rct::key));
 
     // hash to the result
-    crypto::hash_to_scalar(hash.data(), hash.size(), squash_prefix_out);
+    domain_hasher.hash_to_scalar(hash, sizeof(hash), reinterpret_cast<unsigned char*>(squash_prefix_out.data));
 }
 //-------------------------------------------------------------------------------------------------------------------
 void squash_seraphis_address(const rct::key &onetime_address,
@@ -159,12 +195,100 @@ void seraphis_squashed_enote_Q(const rct::key &onetime_address,
     rct::addKeys(squashed_enote_out, squashed_enote_out, amount_commitment);
 }
 //-------------------------------------------------------------------------------------------------------------------
+void seraphis_squashed_enotes_Q(const rct::keyV &onetime_addresses,
+    const rct::keyV &amount_commitments,
+    rct::keyV &squashed_enotes_out,
+    const std::size_t num_threads)
+{
+    CHECK_AND_ASSERT_THROW_MES(onetime_addresses.size() == amount_commitments.size(),
+        "Squashed enote batch has mismatched onetime addresses and amount commitments.");
+
+    const std::size_t num_enotes{onetime_addresses.size()};
+    const std::size_t num_groups{(num_enotes + SQUASHED_ENOTE_BATCH_GROUP_SIZE - 1) / SQUASHED_ENOTE_BATCH_GROUP_SIZE};
+    squashed_enotes_out.resize(num_enotes);
+
+    CHECK_AND_ASSERT_THROW_MES(run_indexed_jobs(num_groups, num_threads,
+                [&](const std::size_t group_index)
+                {
+                    const std::size_t begin{group_index * SQUASHED_ENOTE_BATCH_GROUP_SIZE};
+                    const std::size_t group_size{
+                            std::min(num_enotes - begin, SQUASHED_ENOTE_BATCH_GROUP_SIZE)
+                        };
+
+                    // 1. decompress Ko and C (throws on bad points, like seraphis_squashed_enote_Q())
+                    ge_p3 onetime_addresses_p3[SQUASHED_ENOTE_BATCH_GROUP_SIZE];
+                    ge_p3 amount_commitments_p3[SQUASHED_ENOTE_BATCH_GROUP_SIZE];
+                    CHECK_AND_ASSERT_THROW_MES(ge_frombytes_vartime_batch(onetime_addresses_p3,
+                            onetime_addresses[begin].bytes, group_size, 1) == 0,
+                        "Failed to decompress onetime address.");
+                    CHECK_AND_ASSERT_THROW_MES(ge_frombytes_vartime_batch(amount_commitments_p3,
+                            amount_commitments[begin].bytes, group_size, 1) == 0,
+                        "Failed to decompress amount commitment.");
+
+                    // 2. H(Ko,C) Ko + C, left in projective form
+                    ge_p2 squashed_enotes_p2[SQUASHED_ENOTE_BATCH_GROUP_SIZE];
+                    crypto::secret_key squash_prefix;
+                    ge_p3 squashed_address_p3;
+                    ge_cached amount_commitment_cached;
+                    ge_p1p1 temp_p1p1;
+
+                    for (std::size_t i{0}; i < group_size; ++i)
+                    {
+                        make_seraphis_squash_prefix(onetime_addresses[begin + i],
+                            amount_commitments[begin + i],
+                            squash_prefix);
+                        ge_scalarmult_p3(&squashed_address_p3, &squash_prefix, &onetime_addresses_p3[i]);
+                        ge_p3_to_cached(&amount_commitment_cached, &amount_commitments_p3[i]);
+                        ge_add(&temp_p1p1, &squashed_address_p3, &amount_commitment_cached);
+                        ge_p1p1_to_p2(&squashed_enotes_p2[i], &temp_p1p1);
+                    }
+
+                    // 3. compress with one shared field inversion
+                    ge_tobytes_batch(squashed_enotes_out[begin].bytes, squashed_enotes_p2, group_size);
+                }
+            ),
+        "Failed to make squashed enotes.");
+}
+//-------------------------------------------------------------------------------------------------------------------
 void make_seraphis_enote_pubkey(const crypto::secret_key &enote_privkey, const rct::key &DH_base, rct::key &enote_pubkey_out)
 {
     // R_t = r_t K^{DH}_t
     rct::scalarmultKey(enote_pubkey_out, DH_base, rct::sk2rct(enote_privkey));
 }
 //-------------------------------------------------------------------------------------------------------------------
+void make_seraphis_recipient_precomp_v1(const rct::key &recipient_DH_base,
+    const rct::key &recipient_view_key,
+    SpRecipientPrecompV1 &precomp_out)
+{
+    ge_p3 DH_base_p3;
+    ge_p3 view_key_p3;
+    CHECK_AND_ASSERT_THROW_MES(ge_frombytes_vartime(&DH_base_p3, recipient_DH_base.bytes) == 0,
+        "Recipient DH base is not a valid point.");
+    CHECK_AND_ASSERT_THROW_MES(ge_frombytes_vartime(&view_key_p3, recipient_view_key.bytes) == 0,
+        "Recipient view key is not a valid point.");
+
+    precomp_out.m_recipient_DH_base = recipient_DH_base;
+    precomp_out.m_recipient_view_key = recipient_view_key;
+    ge_precomp_table_init(precomp_out.m_DH_base_table, &DH_base_p3);
+    ge_precomp_table_init(precomp_out.m_view_key_table, &view_key_p3);
+}
+//-------------------------------------------------------------------------------------------------------------------
+void make_seraphis_enote_pubkey(const crypto::secret_key &enote_privkey,
+    const SpRecipientPrecompV1 &recipient_precomp,
+    rct::key &enote_pubkey_out)
+{
+    // R_t = r_t K^{DH}_t
+    rct::key privkey_reduced;
+    ge_p3 enote_pubkey_p3;
+    auto a_wiper = epee::misc_utils::create_scope_leave_handler([&]{
+        memwipe(&privkey_reduced, sizeof(rct::key));
+    });
+
+    sc_reduce32copy(privkey_reduced.bytes, rct::sk2rct(enote_privkey).bytes);  //ge_scalarmult_base_table() requires a[31] <= 127
+    ge_scalarmult_base_table(&enote_pubkey_p3, privkey_reduced.bytes, recipient_precomp.m_DH_base_table);
+    ge_p3_tobytes(enote_pubkey_out.bytes, &enote_pubkey_p3);
+}
+//-------------------------------------------------------------------------------------------------------------------
 void make_seraphis_sender_receiver_secret(const crypto::secret_key &privkey,
     const rct::key &DH_key,
     const std::size_t output_index,
@@ -187,28 +311,62 @@ void make_seraphis_sender_receiver_secret(const crypto::key_derivation &sender_r
     const std::size_t output_index,
     rct::key &sender_receiver_secret_out)
 {
-    static std::string salt{config::HASH_KEY_SERAPHIS_SENDER_RECEIVER_SECRET};
+    static const sp::SpDomainHasher domain_hasher{config::HASH_KEY_SERAPHIS_SENDER_RECEIVER_SECRET};
 
     // q_t = H(8 * r_t * k^{vr} * K^{DH}, t) => H("domain sep", 8 * privkey * DH_key, output_index)
-    sp::domain_separate_derivation_hash(salt,
+    sp::domain_separate_derivation_hash(domain_hasher,
         sender_receiver_DH_derivation,
         output_index,
         sender_receiver_secret_out);
 }
 //-------------------------------------------------------------------------------------------------------------------
+void make_seraphis_sender_receiver_derivation(const crypto::secret_key &enote_privkey,
+    const SpRecipientPrecompV1 &recipient_precomp,
+    crypto::key_derivation &sender_receiver_DH_derivation_out)
+{
+    // 8 * r_t * K^{vr}
+    rct::key privkey_reduced;
+    ge_p3 temp_p3;
+    ge_p2 temp_p2;
+    ge_p1p1 temp_p1p1;
+    auto a_wiper = epee::misc_utils::create_scope_leave_handler([&]{
+        memwipe(&privkey_reduced, sizeof(rct::key));
+        memwipe(&temp_p3, sizeof(ge_p3));
+        memwipe(&temp_p2, sizeof(ge_p2));
+        memwipe(&temp_p1p1, sizeof(ge_p1p1));
+    });
+
+    sc_reduce32copy(privkey_reduced.bytes, rct::sk2rct(enote_privkey).bytes);  //ge_scalarmult_base_table() requires a[31] <= 127
+    ge_scalarmult_base_table(&temp_p3, privkey_reduced.bytes, recipient_precomp.m_view_key_table);
+    ge_p3_to_p2(&temp_p2, &temp_p3);
+    ge_mul8(&temp_p1p1, &temp_p2);
+    ge_p1p1_to_p2(&temp_p2, &temp_p1p1);
+    ge_tobytes(reinterpret_cast<unsigned char*>(&sender_receiver_DH_derivation_out), &temp_p2);
+}
+//-------------------------------------------------------------------------------------------------------------------
 void make_seraphis_sender_address_extension(const crypto::secret_key &sender_receiver_secret,
     crypto::secret_key &sender_address_extension_out)
 {
-    static std::string salt{config::HASH_KEY_SERAPHIS_SENDER_ADDRESS_EXTENSION};
+    static const sp::SpDomainHasher domain_hasher{config::HASH_KEY_SERAPHIS_SENDER_ADDRESS_EXTENSION};
 
     // k_{a, sender} = H("domain-sep", q_t)
-    sp::domain_separate_rct_hash(salt, rct::sk2rct(sender_receiver_secret), sender_address_extension_out);
+    sp::domain_separate_rct_hash(domain_hasher, rct::sk2rct(sender_receiver_secret), sender_address_extension_out);
+}
+//-------------------------------------------------------------------------------------------------------------------
+SpViewTagHash get_seraphis_view_tag_hash(const unsigned char tx_validation_rules_version)
+{
+    // note: add a case when a new rules version adopts a different view tag hash
+    CHECK_AND_ASSERT_THROW_MES(tx_validation_rules_version == 1,
+        "Unknown tx validation rules version for view tag hash.");
+
+    return SpViewTagHash::KECCAK;
 }
 //-------------------------------------------------------------------------------------------------------------------
 unsigned char make_seraphis_view_tag(const crypto::secret_key &privkey,
     const rct::key &DH_key,
     const std::size_t output_index,
-    hw::device &hwdev)
+    hw::device &hwdev,
+    const SpViewTagHash view_tag_hash)
 {
     // 8 * privkey * DH_key
     crypto::key_derivation derivation;
@@ -219,39 +377,87 @@ unsigned char make_seraphis_view_tag(const crypto::secret_key &privkey,
     hwdev.generate_key_derivation(rct::rct2pk(DH_key), privkey, derivation);
 
     // tag_t = H("domain-sep", derivation, t)
-    unsigned char view_tag{make_seraphis_view_tag(derivation, output_index)};
+    unsigned char view_tag{make_seraphis_view_tag(derivation, output_index, view_tag_hash)};
 
     return view_tag;
 }
 //-------------------------------------------------------------------------------------------------------------------
 unsigned char make_seraphis_view_tag(const crypto::key_derivation &sender_receiver_DH_derivation,
-    const std::size_t output_index)
+    const std::size_t output_index,
+    const SpViewTagHash view_tag_hash)
 {
-    static std::string salt{config::HASH_KEY_SERAPHIS_VIEW_TAG};
+    return static_cast<unsigned char>(
+            make_seraphis_view_tag_wide(sender_receiver_DH_derivation, output_index, 1, view_tag_hash)
+        );
+}
+//-------------------------------------------------------------------------------------------------------------------
+std::size_t get_seraphis_view_tag_max_bytes(const SpViewTagHash view_tag_hash)
+{
+    // bytes of hash output available for a tag (capped at the width of the tag's integer type)
+    return view_tag_hash == SpViewTagHash::HALFSIPHASH ? 4 : 8;
+}
+//-------------------------------------------------------------------------------------------------------------------
+std::uint64_t make_seraphis_view_tag_wide(const crypto::key_derivation &sender_receiver_DH_derivation,
+    const std::size_t output_index,
+    const std::size_t view_tag_bytes,
+    const SpViewTagHash view_tag_hash)
+{
+    static const sp::SpDomainHasher domain_hasher{config::HASH_KEY_SERAPHIS_VIEW_TAG};
+
+    CHECK_AND_ASSERT_THROW_MES(view_tag_bytes >= 1 && view_tag_bytes <= get_seraphis_view_tag_max_bytes(view_tag_hash),
+        "Invalid view tag width for the view tag hash.");
 
     // tag_t = H("domain-sep", derivation, t)
     // note: the view tag is not a secret, so it doesn't need to be memory-safe (e.g. with crypto::secret_key)
     //   - using crypto::secret_key can slow down view-key scanning if scanning is multithreaded (due to memlock)
-    // TODO: consider using a simpler/cheaper hash function for view tags
-    rct::key view_tag_scalar;
+    unsigned char hash_result[8];
 
-    sp::domain_separate_derivation_hash(salt,
-        sender_receiver_DH_derivation,
-        output_index,
-        view_tag_scalar);
+    if (view_tag_hash == SpViewTagHash::KECCAK)
+    {
+        rct::key view_tag_scalar;
+
+        sp::domain_separate_derivation_hash(domain_hasher,
+            sender_receiver_DH_derivation,
+            output_index,
+            view_tag_scalar);
+
+        // note: the scalar's low bytes are uniform; only its top byte is biased by the reduction
+        memcpy(hash_result, view_tag_scalar.bytes, sizeof(hash_result));
+    }
+    else
+    {
+        // siphash variants: H[derivation prefix]("domain-sep", t)
+        char hash[sizeof(config::HASH_KEY_SERAPHIS_VIEW_TAG) - 1 + (sizeof(std::size_t) * 8 + 6) / 7];
+        memcpy(hash, config::HASH_KEY_SERAPHIS_VIEW_TAG, sizeof(config::HASH_KEY_SERAPHIS_VIEW_TAG) - 1);
+        char *end = hash + sizeof(config::HASH_KEY_SERAPHIS_VIEW_TAG) - 1;
+        tools::write_varint(end, output_index);
+
+        // note: siphash reads its key from the first 16 bytes of the derivation, halfsiphash from the first 8
+        if (view_tag_hash == SpViewTagHash::SIPHASH)
+            siphash(hash, end - hash, &sender_receiver_DH_derivation, hash_result, 8);
+        else if (view_tag_hash == SpViewTagHash::HALFSIPHASH)
+            halfsiphash(hash, end - hash, &sender_receiver_DH_derivation, hash_result, 4);
+        else
+            CHECK_AND_ASSERT_THROW_MES(false, "Unknown view tag hash.");
+    }
 
-    return static_cast<unsigned char>(view_tag_scalar.bytes[0]);
+    // tag_t = first 'view_tag_bytes' bytes of the hash (little-endian)
+    std::uint64_t view_tag{0};
+    for (std::size_t i{0}; i < view_tag_bytes; ++i)
+        view_tag |= static_cast<std::uint64_t>(hash_result[i]) << (8 * i);
+
+    return view_tag;
 }
 //-------------------------------------------------------------------------------------------------------------------
 rct::xmr_amount enc_dec_seraphis_amount(const crypto::secret_key &sender_receiver_secret,
     const rct::key &baked_key,
     const rct::xmr_amount original)
 {
-    static std::string salt{config::HASH_KEY_SERAPHIS_AMOUNT_ENC};
+    static const sp::SpDomainHasher domain_hasher{config::HASH_KEY_SERAPHIS_AMOUNT_ENC};
 
     // ret = H("domain-sep", q_t, [OPTIONAL: baked_key]) XOR_64 original
     crypto::secret_key hash_result;
-    sp::domain_separate_rct_hash_with_extra(salt, rct::sk2rct(sender_receiver_secret), baked_key, hash_result);
+    sp::domain_separate_rct_hash_with_extra(domain_hasher, rct::sk2rct(sender_receiver_secret), baked_key, hash_result);
 
     rct::xmr_amount mask{0};
     rct::xmr_amount temp{0};
@@ -269,10 +475,10 @@ void make_seraphis_amount_commitment_mask(const crypto::secret_key &sender_recei
     const rct::key &baked_key,
     crypto::secret_key &mask_out)
 {
-    static std::string salt{config::HASH_KEY_SERAPHIS_AMOUNT_COMMITMENT_BLINDING_FACTOR};
+    static const sp::SpDomainHasher domain_hasher{config::HASH_KEY_SERAPHIS_AMOUNT_COMMITMENT_BLINDING_FACTOR};
 
     // x_t = H("domain-sep", q_t, [OPTIONAL: baked_key])
-    sp::domain_separate_rct_hash_with_extra(salt, rct::sk2rct(sender_receiver_secret), baked_key, mask_out);
+    sp::domain_separate_rct_hash_with_extra(domain_hasher, rct::sk2rct(sender_receiver_secret), baked_key, mask_out);
 }
 //-------------------------------------------------------------------------------------------------------------------
 bool try_get_seraphis_nominal_spend_key(const crypto::key_derivation &sender_receiver_DH_derivation,
@@ -280,10 +486,32 @@ bool try_get_seraphis_nominal_spend_key(const crypto::key_derivation &sender_rec
     const rct::key &onetime_address,
     const unsigned char view_tag,
     rct::key &sender_receiver_secret_out,
-    rct::key &nominal_spend_key_out)
+    rct::key &nominal_spend_key_out,
+    const SpViewTagHash view_tag_hash)
+{
+    return try_get_seraphis_nominal_spend_key_wide(sender_receiver_DH_derivation,
+        output_index,
+        onetime_address,
+        view_tag,
+        1,
+        sender_receiver_secret_out,
+        nominal_spend_key_out,
+        view_tag_hash);
+}
+//-------------------------------------------------------------------------------------------------------------------
+bool try_get_seraphis_nominal_spend_key_wide(const crypto::key_derivation &sender_receiver_DH_derivation,
+    const std::size_t output_index,
+    const rct::key &onetime_address,
+    const std::uint64_t view_tag,
+    const std::size_t view_tag_bytes,
+    rct::key &sender_receiver_secret_out,
+    rct::key &nominal_spend_key_out,
+    const SpViewTagHash view_tag_hash)
 {
     // tag'_t
-    unsigned char nominal_view_tag{make_seraphis_view_tag(sender_receiver_DH_derivation, output_index)};
+    const std::uint64_t nominal_view_tag{
+            make_seraphis_view_tag_wide(sender_receiver_DH_derivation, output_index, view_tag_bytes, view_tag_hash)
+        };
 
     // check that recomputed tag matches original tag; short-circuit on failure
     if (nominal_view_tag != view_tag)
@@ -329,4 +557,98 @@ bool try_get_seraphis_amount(const crypto::secret_key &sender_receiver_secret,
     }
 }
 //-------------------------------------------------------------------------------------------------------------------
+void try_get_seraphis_amounts(const std::vector<SpAmountRecoveryRecord> &records,
+    std::vector<rct::xmr_amount> &amounts_out,
+    std::vector<bool> &recovered_out)
+{
+    const std::size_t num_records{records.size()};
+    amounts_out.assign(num_records, 0);
+    recovered_out.assign(num_records, false);
+
+    if (num_records == 0)
+        return;
+
+    // a'_i = dec(enc(a_i)), x'_i
+    std::vector<crypto::secret_key> nominal_masks(num_records);
+    for (std::size_t record_index{0}; record_index < num_records; ++record_index)
+    {
+        const SpAmountRecoveryRecord &record = records[record_index];
+
+        amounts_out[record_index] =
+            enc_dec_seraphis_amount(record.m_sender_receiver_secret, record.m_baked_key, record.m_encoded_amount);
+        make_seraphis_amount_commitment_mask(record.m_sender_receiver_secret,
+            record.m_baked_key,
+            nominal_masks[record_index]);
+    }
+
+    // batch check: sum_i( r_i * (x'_i G + a'_i H - C_i) ) == 0
+    // - C_i: -r_i (a negated small weight)
+    // - G: sum_i( r_i * x'_i )
+    // - H: sum_i( r_i * a'_i )
+    bool batch_valid{false};
+
+    if (num_records > 1)
+    {
+        try
+        {
+            std::vector<rct::MultiexpData> data;
+            data.reserve(2 + num_records);
+            data.resize(2);  // G and H (set at the end)
+
+            rct::keyV commitments;
+            commitments.reserve(num_records);
+            for (const SpAmountRecoveryRecord &record : records)
+                commitments.push_back(record.m_amount_commitment);
+
+            std::vector<ge_p3> commitments_p3;
+            rct::decompress_points(commitments, commitments_p3);
+
+            rct::key G_scalar{rct::zero()};
+            rct::key H_scalar{rct::zero()};
+            rct::key minus_weight;
+
+            for (std::size_t record_index{0}; record_index < num_records; ++record_index)
+            {
+                minus_weight = sp::minus_small_scalar_gen(sp::DEFAULT_BATCH_WEIGHT_SIZE);
+
+                sc_mulsub(G_scalar.bytes,
+                    minus_weight.bytes,
+                    rct::sk2rct(nominal_masks[record_index]).bytes,
+                    G_scalar.bytes);  // + r_i * x'_i
+                sc_mulsub(H_scalar.bytes,
+                    minus_weight.bytes,
+                    rct::d2h(amounts_out[record_index]).bytes,
+                    H_scalar.bytes);  // + r_i * a'_i
+                data.emplace_back(minus_weight, commitments_p3[record_index]);  // -r_i * C_i
+            }
+
+            data[0] = {G_scalar, rct::G};
+            data[1] = {H_scalar, rct::H};
+
+            batch_valid = sp::check_pippenger_data(rct::pippenger_prep_data{std::move(data), nullptr, 0}, 1);
+        }
+        catch (...)
+        {
+            // an invalid commitment: find the good enotes one at a time
+            batch_valid = false;
+        }
+    }
+
+    if (batch_valid)
+    {
+        recovered_out.assign(num_records, true);
+        return;
+    }
+
+    // per-enote checks: C'_i = x'_i G + a'_i H ?= C_i
+    for (std::size_t record_index{0}; record_index < num_records; ++record_index)
+    {
+        if (rct::commit(amounts_out[record_index], rct::sk2rct(nominal_masks[record_index])) ==
+            records[record_index].m_amount_commitment)
+            recovered_out[record_index] = true;
+        else
+            amounts_out[record_index] = 0;
+    }
+}
+//-------------------------------------------------------------------------------------------------------------------
 } //namespace mock_tx
@@ -44,6 +44,7 @@ extern "C"
 //third party headers
 
 //standard headers
+#include <cstdint>
 #include <vector>
 
 //forward declarations
@@ -52,6 +53,29 @@ extern "C"
 namespace mock_tx
 {
 
+////
+// SpViewTagHash - hash function used to make view tags (tag_t is the first byte of the hash output)
+// - view tags are checked for every enote during view-key scanning, so the hash is a speed/robustness tradeoff
+// - the siphash variants are keyed with a prefix of the derivation instead of hashing the full derivation
+///
+enum class SpViewTagHash : unsigned char
+{
+    /// H_n("domain-sep", derivation, t)  (keccak, reduced to a scalar)
+    KECCAK,
+    /// siphash-2-4[derivation[0:16]]("domain-sep", t)  (8-byte output)
+    SIPHASH,
+    /// halfsiphash-2-4[derivation[0:8]]("domain-sep", t)  (4-byte output)
+    HALFSIPHASH
+};
+
+/**
+* brief: get_seraphis_view_tag_hash - get the view tag hash function for a tx validation rules version
+*   - version 1: keccak
+* param: tx_validation_rules_version -
+* return: view tag hash for that version
+*/
+SpViewTagHash get_seraphis_view_tag_hash(const unsigned char tx_validation_rules_version);
+
 /**
 * brief: make_seraphis_key_image - create a Seraphis key image from private keys 'y' and 'z'
 *   KI = (z/y)*U
@@ -70,6 +94,17 @@ void make_seraphis_key_image(const crypto::secret_key &y, const crypto::secret_k
 */
 void make_seraphis_key_image(const crypto::secret_key &y, const rct::key &zU, crypto::key_image &key_image_out);
 /**
+* brief: make_seraphis_key_images - create many Seraphis key images from private keys 'y' and 'z'
+*   KI_i = (z_i/y_i)*U
+*   - all the 'y' keys share one inversion (see sp::invert_batch())
+* param: y - private keys 'y_i'
+* param: z - private keys 'z_i'
+* outparam: key_images_out - KI_i
+*/
+void make_seraphis_key_images(const std::vector<crypto::secret_key> &y,
+    const std::vector<crypto::secret_key> &z,
+    std::vector<crypto::key_image> &key_images_out);
+/**
 * brief: make_seraphis_key_image - create a Seraphis key image from sender/recipient pieces
 *   KI = (k_{b. recipient} / (k_{a, sender} + k_{a, recipient})) * U
 * param: k_a_sender - private key derived from sender (e.g. created from sender-recipient secret q_t)
@@ -134,6 +169,47 @@ void seraphis_squashed_enote_Q(const rct::key &onetime_address,
     const rct::key &amount_commitment,
     rct::key &squashed_enote_out);
 /**
+* brief: seraphis_squashed_enotes_Q - make 'squashed' enotes for a batch of enotes (e.g. a tx's or block's outputs)
+*   Q_i = H(Ko_i,C_i) Ko_i + C_i
+*   - same results as seraphis_squashed_enote_Q(), but points are decompressed four at a time and each group of
+*     results is compressed with one shared field inversion; groups are spread across threads
+* param: onetime_addresses - {Ko}
+* param: amount_commitments - {C}
+* outparam: squashed_enotes_out - {Q}
+* param: num_threads - max number of threads (0 = threadpool max concurrency; 1 = serial)
+*/
+void seraphis_squashed_enotes_Q(const rct::keyV &onetime_addresses,
+    const rct::keyV &amount_commitments,
+    rct::keyV &squashed_enotes_out,
+    const std::size_t num_threads = 1);
+////
+// SpRecipientPrecompV1 - fixed-base tables for one recipient's DH base and view key
+// - a sender who pays the same recipients over and over (e.g. batched payouts) can make this once per address and
+//   keep it; each enote to that address then costs two table-based mults (same cost as r_t G) instead of two
+//   variable-base scalarmults against K^{DH} and K^{vr}
+// - ~60kB per recipient
+///
+struct SpRecipientPrecompV1 final
+{
+    /// K^{DH}
+    rct::key m_recipient_DH_base;
+    /// K^{vr}
+    rct::key m_recipient_view_key;
+    /// tables for K^{DH} and K^{vr} (see ge_precomp_table_init())
+    ge_precomp m_DH_base_table[32][8];
+    ge_precomp m_view_key_table[32][8];
+};
+
+/**
+* brief: make_seraphis_recipient_precomp_v1 - make the fixed-base tables for a recipient
+* param: recipient_DH_base - K^{DH}
+* param: recipient_view_key - K^{vr}
+* outparam: precomp_out -
+*/
+void make_seraphis_recipient_precomp_v1(const rct::key &recipient_DH_base,
+    const rct::key &recipient_view_key,
+    SpRecipientPrecompV1 &precomp_out);
+/**
 * brief: make_seraphis_enote_pubkey - enote pubkey R_t
 *   R_t = r_t K^{DH}_recipient
 * param: enote_privkey - r_t
@@ -142,6 +218,15 @@ void seraphis_squashed_enote_Q(const rct::key &onetime_address,
 */
 void make_seraphis_enote_pubkey(const crypto::secret_key &enote_privkey, const rct::key &DH_base, rct::key &enote_pubkey_out);
 /**
+* brief: make_seraphis_enote_pubkey - overload with the recipient's precomputed tables
+* param: enote_privkey - r_t
+* param: recipient_precomp - tables for K^{DH}_recipient
+* outparam: enote_pubkey_out - R_t
+*/
+void make_seraphis_enote_pubkey(const crypto::secret_key &enote_privkey,
+    const SpRecipientPrecompV1 &recipient_precomp,
+    rct::key &enote_pubkey_out);
+/**
 * brief: make_seraphis_sender_receiver_secret - sender-receiver secret q_t for an output at index 't' in the tx that created it
 *    q_t = H(8 * r_t * k^{vr} * K^{DH}, t) => H("domain sep", 8 * privkey * DH_key, output_index)
 * param: privkey - [sender: r_t] [recipient: k^{vr}]
@@ -167,6 +252,17 @@ void make_seraphis_sender_receiver_secret(const crypto::key_derivation &sender_r
     const std::size_t output_index,
     rct::key &sender_receiver_secret_out);
 /**
+* brief: make_seraphis_sender_receiver_derivation - sender-side DH derivation with the recipient's precomputed tables
+*    8 * r_t * K^{vr}
+*   - same result as hw::device::generate_key_derivation(K^{vr}, r_t)
+* param: enote_privkey - r_t
+* param: recipient_precomp - tables for K^{vr}
+* outparam: sender_receiver_DH_derivation_out - 8 * r_t * K^{vr}
+*/
+void make_seraphis_sender_receiver_derivation(const crypto::secret_key &enote_privkey,
+    const SpRecipientPrecompV1 &recipient_precomp,
+    crypto::key_derivation &sender_receiver_DH_derivation_out);
+/**
 * brief: make_seraphis_sender_address_extension - extension for transforming a recipient spendkey into an enote one-time address
 *    k_{a, sender} = H("domain-sep", q_t)
 * param: sender_receiver_secret - q_t
@@ -181,21 +277,46 @@ void make_seraphis_sender_address_extension(const crypto::secret_key &sender_rec
 * param: DH_key - [sender: K^{vr}] [sender-change-2out: k^{vr}*K^{DH}_other] [recipient: R_t]
 * param: output_index - t (index of the enote within its tx)
 * param: hwdev - abstract reference to a hardware-specific implemention of crypto ops
+* param: view_tag_hash - hash function H
 * return: tag_t
 */
 unsigned char make_seraphis_view_tag(const crypto::secret_key &privkey,
     const rct::key &DH_key,
     const std::size_t output_index,
-    hw::device &hwdev);
+    hw::device &hwdev,
+    const SpViewTagHash view_tag_hash = SpViewTagHash::KECCAK);
 /**
 * brief: make_seraphis_view_tag - overload for when the derivation is known by caller
 *    tag_t = H("domain-sep", 8 * privkey * DH_key, t)
 * param: sender_receiver_DH_derivation - privkey * DH_key
 * param: output_index - t
+* param: view_tag_hash - hash function H
 * return: tag_t
 */
 unsigned char make_seraphis_view_tag(const crypto::key_derivation &sender_receiver_DH_derivation,
-    const std::size_t output_index);
+    const std::size_t output_index,
+    const SpViewTagHash view_tag_hash = SpViewTagHash::KECCAK);
+/**
+* brief: get_seraphis_view_tag_max_bytes - widest view tag a view tag hash can produce
+* param: view_tag_hash -
+* return: max view tag width in bytes (8 for keccak and siphash, 4 for halfsiphash)
+*/
+std::size_t get_seraphis_view_tag_max_bytes(const SpViewTagHash view_tag_hash);
+/**
+* brief: make_seraphis_view_tag_wide - multi-byte view tag; a non-owned enote passes the tag check with
+*   probability 2^(-8 * view_tag_bytes)
+*    tag_t = H("domain-sep", 8 * privkey * DH_key, t)[0 : view_tag_bytes]  (little-endian)
+*   - with view_tag_bytes = 1 this is the single-byte tag from make_seraphis_view_tag()
+* param: sender_receiver_DH_derivation - privkey * DH_key
+* param: output_index - t
+* param: view_tag_bytes - tag width in [1, get_seraphis_view_tag_max_bytes(view_tag_hash)]
+* param: view_tag_hash - hash function H
+* return: tag_t
+*/
+std::uint64_t make_seraphis_view_tag_wide(const crypto::key_derivation &sender_receiver_DH_derivation,
+    const std::size_t output_index,
+    const std::size_t view_tag_bytes,
+    const SpViewTagHash view_tag_hash = SpViewTagHash::KECCAK);
 /**
 * brief: enc_dec_seraphis_amount - encode/decode an amount
 * param: sender_receiver_secret - q_t
@@ -225,6 +346,7 @@ void make_seraphis_amount_commitment_mask(const crypto::secret_key &sender_recei
 * outparam: sender_receiver_secret_out - q_t
 *   - note: this is 'rct::key' instead of 'crypto::secret_key' for better performance in multithreaded environments
 * outparam: nominal_spend_key_out - K'^s_t = Ko_t - H(q_t) X
+* param: view_tag_hash - hash function used to make the view tag
 * return: true if successfully recomputed the view tag
 */
 bool try_get_seraphis_nominal_spend_key(const crypto::key_derivation &sender_receiver_DH_derivation,
@@ -232,7 +354,28 @@ bool try_get_seraphis_nominal_spend_key(const crypto::key_derivation &sender_rec
     const rct::key &onetime_address,
     const unsigned char view_tag,
     rct::key &sender_receiver_secret_out,
-    rct::key &nominal_spend_key_out);
+    rct::key &nominal_spend_key_out,
+    const SpViewTagHash view_tag_hash = SpViewTagHash::KECCAK);
+/**
+* brief: try_get_seraphis_nominal_spend_key_wide - try_get_seraphis_nominal_spend_key() for a multi-byte view tag
+* param: sender_receiver_DH_derivation - 8 * privkey * DH_key
+* param: output_index - t
+* param: onetime_address - Ko_t
+* param: view_tag - tag_t
+* param: view_tag_bytes - width of tag_t
+* outparam: sender_receiver_secret_out - q_t
+* outparam: nominal_spend_key_out - K'^s_t = Ko_t - H(q_t) X
+* param: view_tag_hash - hash function used to make the view tag
+* return: true if successfully recomputed the view tag
+*/
+bool try_get_seraphis_nominal_spend_key_wide(const crypto::key_derivation &sender_receiver_DH_derivation,
+    const std::size_t output_index,
+    const rct::key &onetime_address,
+    const std::uint64_t view_tag,
+    const std::size_t view_tag_bytes,
+    rct::key &sender_receiver_secret_out,
+    rct::key &nominal_spend_key_out,
+    const SpViewTagHash view_tag_hash = SpViewTagHash::KECCAK);
 /**
 * brief: try_get_seraphis_amount - test recreating the amount commitment; if it is recreate-able, return the amount
 * param: sender_receiver_secret - q_t
@@ -248,4 +391,34 @@ bool try_get_seraphis_amount(const crypto::secret_key &sender_receiver_secret,
     const rct::xmr_amount encoded_amount,
     rct::xmr_amount &amount_out);
 
+/// an owned enote's amount fields, for recovering many amounts at once
+struct SpAmountRecoveryRecord final
+{
+    /// q_t
+    crypto::secret_key m_sender_receiver_secret;
+    /// extra key baked into amount encoding and amount commitment mask (zero if unwanted)
+    rct::key m_baked_key;
+    /// C = x G + a H
+    rct::key m_amount_commitment;
+    /// enc(a)
+    rct::xmr_amount m_encoded_amount;
+};
+
+/**
+* brief: try_get_seraphis_amounts - try_get_seraphis_amount() for many enotes, with the recomputed amount commitments
+*   checked together in one multiexp
+*   - sum_i( r_i * (x'_i G + a'_i H - C_i) ) ?= 0, with random 128-bit weights r_i, instead of two scalar mults and a
+*     compression per enote
+*   - if the batch fails (or a commitment is not a valid point), each enote is checked on its own, so one bad enote
+*     does not hide the others' amounts
+*   - the weights only bind the commitments' prime-order parts, so the enotes must come from validated txs (their
+*     amount commitments are 8*V from the range proofs, which have no torsion)
+* param: records -
+* outparam: amounts_out - a'_i for each record (0 if not recovered)
+* outparam: recovered_out - true for each record whose amount commitment was recreated
+*/
+void try_get_seraphis_amounts(const std::vector<SpAmountRecoveryRecord> &records,
+    std::vector<rct::xmr_amount> &amounts_out,
+    std::vector<bool> &recovered_out);
+
 } //namespace mock_tx
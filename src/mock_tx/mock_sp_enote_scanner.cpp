@@ -0,0 +1,497 @@
+// Copyright (c) 2021, The Monero Project
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of
+//    conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list
+//    of conditions and the following disclaimer in the documentation and/or other
+//    materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be
+//    used to endorse or promote products derived from this software without specific
+//    prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+// THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// NOT FOR PRODUCTION
+
+//paired header
+#include "mock_sp_enote_scanner.h"
+
+//local headers
+#include "common/varint.h"
+#include "crypto/crypto.h"
+extern "C"
+{
+#include "crypto/crypto-ops.h"
+#include "crypto/keccak.h"
+}
+#include "cryptonote_config.h"
+#include "memwipe.h"
+#include "misc_language.h"
+#include "misc_log_ex.h"
+#include "mock_sp_core_utils.h"
+#include "mock_tx_utils.h"
+#include "ringct/rctTypes.h"
+
+//third party headers
+
+//standard headers
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#undef MONERO_DEFAULT_LOG_CATEGORY
+#define MONERO_DEFAULT_LOG_CATEGORY "mock_tx"
+
+namespace mock_tx
+{
+
+/// "domain-sep" || derivation || varint(t)
+static constexpr std::size_t VIEW_TAG_HASH_MAX_SIZE{sizeof(config::HASH_KEY_SERAPHIS_VIEW_TAG) - 1 +
+    sizeof(crypto::key_derivation) + (sizeof(std::size_t) * 8 + 6) / 7};
+
+//-------------------------------------------------------------------------------------------------------------------
+// scan 'num_records' records in chunks balanced across threads; chunk hits are merged in record order
+//-------------------------------------------------------------------------------------------------------------------
+template <typename HitT, typename ChunkScannerT>
+static void scan_chunks_in_order(const std::size_t num_records,
+    const std::size_t chunk_size,
+    const std::size_t num_threads,
+    const ChunkScannerT &scan_chunk,
+    std::vector<HitT> &hits_out)
+{
+    CHECK_AND_ASSERT_THROW_MES(chunk_size > 0, "enote scanner: chunk size must be positive.");
+
+    hits_out.clear();
+
+    const std::size_t num_chunks{(num_records + chunk_size - 1) / chunk_size};
+    std::vector<std::vector<HitT>> chunk_hits(num_chunks);
+
+    CHECK_AND_ASSERT_THROW_MES(run_indexed_jobs_stealing(num_chunks, num_threads,
+            [&](const std::size_t chunk_index)
+            {
+                const std::size_t begin{chunk_index * chunk_size};
+                scan_chunk(begin, std::min(begin + chunk_size, num_records), chunk_hits[chunk_index]);
+            }),
+        "enote scanner: scanning a chunk failed.");
+
+    for (const std::vector<HitT> &hits : chunk_hits)
+        hits_out.insert(hits_out.end(), hits.begin(), hits.end());
+}
+//-------------------------------------------------------------------------------------------------------------------
+// view tags tag'_i for derivations[i] with output index output_index_of(i)
+// - keccak tags are hashed four at a time; the siphash variants are cheap enough one at a time
+//-------------------------------------------------------------------------------------------------------------------
+template <typename OutputIndexT>
+static void make_view_tags_batch(const std::vector<crypto::key_derivation> &derivations,
+    const OutputIndexT &output_index_of,
+    const SpViewTagHash view_tag_hash,
+    std::vector<unsigned char> &view_tags_out)
+{
+    static const std::size_t salt_size{sizeof(config::HASH_KEY_SERAPHIS_VIEW_TAG) - 1};
+    const std::size_t chunk_size{derivations.size()};
+
+    view_tags_out.resize(chunk_size);
+
+    if (view_tag_hash != SpViewTagHash::KECCAK)
+    {
+        for (std::size_t i{0}; i < chunk_size; ++i)
+            view_tags_out[i] = make_seraphis_view_tag(derivations[i], output_index_of(i), view_tag_hash);
+
+        return;
+    }
+
+    // tag'_t = H("domain-sep", derivation, t)
+    std::vector<unsigned char> hash_inputs(chunk_size * VIEW_TAG_HASH_MAX_SIZE);
+    std::vector<const uint8_t*> hash_in(chunk_size);
+    std::vector<std::size_t> hash_inlen(chunk_size);
+    std::vector<rct::key> view_tag_scalars(chunk_size);
+    std::vector<uint8_t*> hash_md(chunk_size);
+
+    auto inputs_wiper = epee::misc_utils::create_scope_leave_handler([&]{
+        memwipe(hash_inputs.data(), hash_inputs.size());
+    });
+
+    for (std::size_t i{0}; i < chunk_size; ++i)
+    {
+        unsigned char *const input{hash_inputs.data() + i * VIEW_TAG_HASH_MAX_SIZE};
+        memcpy(input, config::HASH_KEY_SERAPHIS_VIEW_TAG, salt_size);
+        memcpy(input + salt_size, &derivations[i], sizeof(crypto::key_derivation));
+        char *varint_end{reinterpret_cast<char*>(input + salt_size + sizeof(crypto::key_derivation))};
+        tools::write_varint(varint_end, output_index_of(i));
+
+        hash_in[i] = input;
+        hash_inlen[i] = reinterpret_cast<unsigned char*>(varint_end) - input;
+        hash_md[i] = view_tag_scalars[i].bytes;
+    }
+
+    keccak_batch(hash_in.data(), hash_inlen.data(), hash_md.data(), chunk_size);
+
+    for (std::size_t i{0}; i < chunk_size; ++i)
+    {
+        sc_reduce32(view_tag_scalars[i].bytes);
+        view_tags_out[i] = static_cast<unsigned char>(view_tag_scalars[i].bytes[0]);
+    }
+}
+//-------------------------------------------------------------------------------------------------------------------
+// scan records [begin, end); hits are appended in record order
+//-------------------------------------------------------------------------------------------------------------------
+static void scan_chunk_batched(const crypto::secret_key &view_privkey,
+    const SpViewTagHash view_tag_hash,
+    const std::vector<SpEnoteScanRecord> &records,
+    const std::size_t begin,
+    const std::size_t end,
+    std::vector<SpEnoteScanHit> &hits_out)
+{
+    const std::size_t chunk_size{end - begin};
+
+    // 1. decompress R_t
+    // - the batch path rejects the whole chunk if any point is bad, so fall back to per-point decompression
+    std::vector<unsigned char> pubkey_bytes(chunk_size * sizeof(rct::key));
+    for (std::size_t i{0}; i < chunk_size; ++i)
+        memcpy(pubkey_bytes.data() + i * sizeof(rct::key), records[begin + i].m_enote_pubkey.bytes, sizeof(rct::key));
+
+    std::vector<ge_p3> pubkeys(chunk_size);
+    std::vector<char> pubkey_valid(chunk_size, 1);
+    if (ge_frombytes_vartime_batch(pubkeys.data(), pubkey_bytes.data(), chunk_size, 1) != 0)
+    {
+        for (std::size_t i{0}; i < chunk_size; ++i)
+            pubkey_valid[i] = ge_frombytes_vartime(&pubkeys[i], records[begin + i].m_enote_pubkey.bytes) == 0;
+    }
+
+    // 2. 8 * k^{vr} * R_t (invalid points get the identity so the batch below stays dense)
+    std::vector<ge_p2> derivation_points(chunk_size);
+    ge_p1p1 temp_p1p1;
+    for (std::size_t i{0}; i < chunk_size; ++i)
+    {
+        if (!pubkey_valid[i])
+        {
+            ge_p2_0(&derivation_points[i]);
+            continue;
+        }
+
+        ge_scalarmult(&derivation_points[i], &view_privkey, &pubkeys[i]);
+        ge_mul8(&temp_p1p1, &derivation_points[i]);
+        ge_p1p1_to_p2(&derivation_points[i], &temp_p1p1);
+    }
+
+    // 3. compress the derivations with one field inversion per group
+    std::vector<crypto::key_derivation> derivations(chunk_size);
+    ge_tobytes_batch(reinterpret_cast<unsigned char*>(derivations.data()), derivation_points.data(), chunk_size);
+
+    auto derivations_wiper = epee::misc_utils::create_scope_leave_handler([&]{
+        memwipe(derivations.data(), derivations.size() * sizeof(crypto::key_derivation));
+        memwipe(derivation_points.data(), derivation_points.size() * sizeof(ge_p2));
+    });
+
+    // 4. tag'_t
+    std::vector<unsigned char> nominal_view_tags;
+    make_view_tags_batch(derivations,
+        [&records, begin](const std::size_t i) -> std::size_t { return records[begin + i].m_output_index; },
+        view_tag_hash,
+        nominal_view_tags);
+
+    // 5. full recovery only for view tag matches
+    for (std::size_t i{0}; i < chunk_size; ++i)
+    {
+        if (!pubkey_valid[i])
+            continue;
+
+        if (nominal_view_tags[i] != records[begin + i].m_view_tag)
+            continue;
+
+        SpEnoteScanHit hit;
+        hit.m_record_index = begin + i;
+
+        // note: this re-checks the view tag; it's a single hash per hit
+        if (try_get_seraphis_nominal_spend_key(derivations[i],
+                records[begin + i].m_output_index,
+                records[begin + i].m_onetime_address,
+                records[begin + i].m_view_tag,
+                hit.m_sender_receiver_secret,
+                hit.m_nominal_spend_key,
+                view_tag_hash))
+            hits_out.emplace_back(hit);
+    }
+}
+//-------------------------------------------------------------------------------------------------------------------
+void SeraphisEnoteScanner::scan(const std::vector<SpEnoteScanRecord> &records,
+    std::vector<SpEnoteScanHit> &hits_out,
+    const std::size_t num_threads) const
+{
+    scan_chunks_in_order(records.size(),
+        DEFAULT_SCAN_CHUNK_SIZE,
+        num_threads,
+        [&](const std::size_t begin, const std::size_t end, std::vector<SpEnoteScanHit> &chunk_hits_out)
+        {
+            scan_chunk_batched(m_view_privkey, m_view_tag_hash, records, begin, end, chunk_hits_out);
+        },
+        hits_out);
+}
+//-------------------------------------------------------------------------------------------------------------------
+void scan_enotes_cn_parallel(const crypto::secret_key &view_privkey,
+    const crypto::public_key &spend_pubkey,
+    const std::vector<CnEnoteScanRecord> &records,
+    const std::size_t chunk_size,
+    const std::size_t num_threads,
+    std::vector<CnEnoteScanHit> &hits_out)
+{
+    scan_chunks_in_order(records.size(),
+        chunk_size,
+        num_threads,
+        [&](const std::size_t begin, const std::size_t end, std::vector<CnEnoteScanHit> &chunk_hits_out)
+        {
+            crypto::key_derivation derivation;
+            crypto::public_key nominal_spend_key;
+            auto a_wiper = epee::misc_utils::create_scope_leave_handler([&]{
+                memwipe(&derivation, sizeof(crypto::key_derivation));
+            });
+
+            for (std::size_t record_index{begin}; record_index < end; ++record_index)
+            {
+                // K'^s = Ko_t - H(k^v R, t) G
+                if (!crypto::generate_key_derivation(records[record_index].m_tx_pubkey, view_privkey, derivation))
+                    continue;
+                if (!crypto::derive_subaddress_public_key(records[record_index].m_onetime_address,
+                        derivation,
+                        records[record_index].m_output_index,
+                        nominal_spend_key))
+                    continue;
+
+                if (nominal_spend_key == spend_pubkey)
+                    chunk_hits_out.emplace_back(CnEnoteScanHit{record_index});
+            }
+        },
+        hits_out);
+}
+//-------------------------------------------------------------------------------------------------------------------
+void scan_enotes_cn_parallel(const crypto::secret_key &view_privkey,
+    const crypto::public_key &spend_pubkey,
+    const CnEnoteScanColumns &columns,
+    const std::size_t chunk_size,
+    const std::size_t num_threads,
+    std::vector<CnEnoteScanHit> &hits_out)
+{
+    scan_chunks_in_order(columns.m_num_enotes,
+        chunk_size,
+        num_threads,
+        [&](const std::size_t begin, const std::size_t end, std::vector<CnEnoteScanHit> &chunk_hits_out)
+        {
+            // one derivation per run of enotes with the same R; the runs' first keys are gathered for the batch
+            std::vector<std::size_t> run_of_enote(end - begin);
+            std::vector<crypto::public_key> run_pubkeys;
+            run_pubkeys.reserve(end - begin);
+
+            for (std::size_t enote_index{begin}; enote_index < end; ++enote_index)
+            {
+                if (enote_index == begin ||
+                        memcmp(&columns.m_tx_pubkeys[enote_index],
+                            &columns.m_tx_pubkeys[enote_index - 1],
+                            sizeof(crypto::public_key)) != 0)
+                    run_pubkeys.emplace_back(columns.m_tx_pubkeys[enote_index]);
+
+                run_of_enote[enote_index - begin] = run_pubkeys.size() - 1;
+            }
+
+            std::vector<crypto::key_derivation> derivations(run_pubkeys.size());
+            std::unique_ptr<bool[]> derivations_valid{new bool[run_pubkeys.size()]};
+            crypto::key_derivation additional_derivation;
+            crypto::public_key nominal_spend_key;
+            auto a_wiper = epee::misc_utils::create_scope_leave_handler([&]{
+                memwipe(derivations.data(), derivations.size() * sizeof(crypto::key_derivation));
+                memwipe(&additional_derivation, sizeof(crypto::key_derivation));
+            });
+
+            // k^v R
+            crypto::generate_key_derivations(run_pubkeys.data(),
+                run_pubkeys.size(),
+                view_privkey,
+                derivations.data(),
+                derivations_valid.get());
+
+            const auto is_owned = [&](const crypto::key_derivation &derivation, const std::size_t enote_index) -> bool
+            {
+                // K'^s = Ko_t - H(k^v R, t) G
+                return crypto::derive_subaddress_public_key(columns.m_onetime_addresses[enote_index],
+                        derivation,
+                        columns.m_output_indices[enote_index],
+                        nominal_spend_key) &&
+                    nominal_spend_key == spend_pubkey;
+            };
+
+            for (std::size_t enote_index{begin}; enote_index < end; ++enote_index)
+            {
+                const std::size_t run_index{run_of_enote[enote_index - begin]};
+
+                if (derivations_valid[run_index] && is_owned(derivations[run_index], enote_index))
+                {
+                    chunk_hits_out.emplace_back(CnEnoteScanHit{enote_index});
+                    continue;
+                }
+
+                // k^v R_t
+                if (columns.m_additional_pubkeys &&
+                        columns.m_additional_pubkeys[enote_index] != crypto::null_pkey &&
+                        crypto::generate_key_derivation(columns.m_additional_pubkeys[enote_index],
+                            view_privkey,
+                            additional_derivation) &&
+                        is_owned(additional_derivation, enote_index))
+                    chunk_hits_out.emplace_back(CnEnoteScanHit{enote_index});
+            }
+        },
+        hits_out);
+}
+//-------------------------------------------------------------------------------------------------------------------
+void scan_enotes_sp_parallel(const crypto::secret_key &view_privkey,
+    const std::vector<SpEnoteScanRecord> &records,
+    const std::size_t chunk_size,
+    const std::size_t num_threads,
+    std::vector<SpEnoteScanHit> &hits_out,
+    const SpViewTagHash view_tag_hash)
+{
+    scan_chunks_in_order(records.size(),
+        chunk_size,
+        num_threads,
+        [&](const std::size_t begin, const std::size_t end, std::vector<SpEnoteScanHit> &chunk_hits_out)
+        {
+            crypto::key_derivation derivation;
+            auto a_wiper = epee::misc_utils::create_scope_leave_handler([&]{
+                memwipe(&derivation, sizeof(crypto::key_derivation));
+            });
+
+            SpEnoteScanHit hit;
+
+            for (std::size_t record_index{begin}; record_index < end; ++record_index)
+            {
+                // 8 * k^{vr} * R_t
+                if (!crypto::generate_key_derivation(rct::rct2pk(records[record_index].m_enote_pubkey),
+                        view_privkey,
+                        derivation))
+                    continue;
+
+                if (try_get_seraphis_nominal_spend_key(derivation,
+                        records[record_index].m_output_index,
+                        records[record_index].m_onetime_address,
+                        records[record_index].m_view_tag,
+                        hit.m_sender_receiver_secret,
+                        hit.m_nominal_spend_key,
+                        view_tag_hash))
+                {
+                    hit.m_record_index = record_index;
+                    chunk_hits_out.emplace_back(hit);
+                }
+            }
+        },
+        hits_out);
+}
+//-------------------------------------------------------------------------------------------------------------------
+void scan_enotes_sp_multi_account(const std::vector<crypto::secret_key> &view_privkeys,
+    const std::vector<SpEnoteScanRecord> &records,
+    const std::size_t num_threads,
+    std::vector<SpMultiAccountScanHit> &hits_out,
+    const SpViewTagHash view_tag_hash)
+{
+    const std::size_t num_accounts{view_privkeys.size()};
+
+    if (num_accounts == 0)
+    {
+        hits_out.clear();
+        return;
+    }
+
+    // keep roughly DEFAULT_SCAN_CHUNK_SIZE account-enotes per chunk
+    const std::size_t chunk_size{std::max<std::size_t>(DEFAULT_SCAN_CHUNK_SIZE / num_accounts, 1)};
+
+    scan_chunks_in_order(records.size(),
+        chunk_size,
+        num_threads,
+        [&](const std::size_t begin, const std::size_t end, std::vector<SpMultiAccountScanHit> &chunk_hits_out)
+        {
+            // (j+1) * 256^i * R_t (public, so no wiping needed)
+            struct ScalarmultTable final { ge_cached rows[32][8]; };
+            std::unique_ptr<ScalarmultTable> table{new ScalarmultTable};
+
+            ge_p3 enote_pubkey;
+            ge_p3 temp_p3;
+            ge_p1p1 temp_p1p1;
+            std::vector<ge_p2> derivation_points(num_accounts);
+            std::vector<crypto::key_derivation> derivations(num_accounts);
+            std::vector<unsigned char> nominal_view_tags;
+            SpMultiAccountScanHit hit;
+
+            auto a_wiper = epee::misc_utils::create_scope_leave_handler([&]{
+                memwipe(&temp_p3, sizeof(ge_p3));
+                memwipe(&temp_p1p1, sizeof(ge_p1p1));
+                memwipe(derivation_points.data(), derivation_points.size() * sizeof(ge_p2));
+                memwipe(derivations.data(), derivations.size() * sizeof(crypto::key_derivation));
+            });
+
+            for (std::size_t record_index{begin}; record_index < end; ++record_index)
+            {
+                const SpEnoteScanRecord &record{records[record_index]};
+
+                // 1. decompress R_t once and expand it into the shared table
+                if (ge_frombytes_vartime(&enote_pubkey, record.m_enote_pubkey.bytes) != 0)
+                    continue;
+
+                ge_cached_table_init(table->rows, &enote_pubkey);
+
+                // 2. 8 * k^{vr}_a * R_t for every account
+                for (std::size_t account_index{0}; account_index < num_accounts; ++account_index)
+                {
+                    ge_scalarmult_cached_table(&temp_p3, &view_privkeys[account_index], table->rows);
+                    ge_p3_to_p2(&derivation_points[account_index], &temp_p3);
+                    ge_mul8(&temp_p1p1, &derivation_points[account_index]);
+                    ge_p1p1_to_p2(&derivation_points[account_index], &temp_p1p1);
+                }
+
+                // 3. compress the derivations with one field inversion per group
+                ge_tobytes_batch(reinterpret_cast<unsigned char*>(derivations.data()),
+                    derivation_points.data(),
+                    num_accounts);
+
+                // 4. tag'_t for every account
+                make_view_tags_batch(derivations,
+                    [&record](const std::size_t) -> std::size_t { return record.m_output_index; },
+                    view_tag_hash,
+                    nominal_view_tags);
+
+                // 5. full recovery only for view tag matches
+                for (std::size_t account_index{0}; account_index < num_accounts; ++account_index)
+                {
+                    if (nominal_view_tags[account_index] != record.m_view_tag)
+                        continue;
+
+                    if (try_get_seraphis_nominal_spend_key(derivations[account_index],
+                            record.m_output_index,
+                            record.m_onetime_address,
+                            record.m_view_tag,
+                            hit.m_sender_receiver_secret,
+                            hit.m_nominal_spend_key,
+                            view_tag_hash))
+                    {
+                        hit.m_account_index = account_index;
+                        hit.m_record_index = record_index;
+                        chunk_hits_out.emplace_back(hit);
+                    }
+                }
+            }
+        },
+        hits_out);
+}
+//-------------------------------------------------------------------------------------------------------------------
+} //namespace mock_tx
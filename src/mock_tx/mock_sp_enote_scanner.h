@@ -0,0 +1,231 @@
+// Copyright (c) 2021, The Monero Project
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of
+//    conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list
+//    of conditions and the following disclaimer in the documentation and/or other
+//    materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be
+//    used to endorse or promote products derived from this software without specific
+//    prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+// THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// NOT FOR PRODUCTION
+
+// View-key scanning over many enotes (batched Seraphis scanner, multi-account scanner, and parallel per-enote scan
+//   drivers)
+
+
+#pragma once
+
+//local headers
+#include "crypto/crypto.h"
+#include "mock_sp_core_utils.h"
+#include "ringct/rctTypes.h"
+
+//third party headers
+
+//standard headers
+#include <cstdint>
+#include <vector>
+
+//forward declarations
+
+
+namespace mock_tx
+{
+
+/// records per scan chunk: small enough that a chunk's records and scratch space stay in L1/L2
+constexpr std::size_t DEFAULT_SCAN_CHUNK_SIZE{256};
+
+/// the per-enote data a view-key scanner needs, laid out contiguously for batch processing
+struct SpEnoteScanRecord final
+{
+    /// R_t
+    rct::key m_enote_pubkey;
+    /// Ko_t
+    rct::key m_onetime_address;
+    /// tag_t
+    unsigned char m_view_tag;
+    /// t
+    std::size_t m_output_index;
+};
+
+/// an enote whose view tag matched, with the nominal spend key recovered
+struct SpEnoteScanHit final
+{
+    /// index of the enote in the scanned records
+    std::size_t m_record_index;
+    /// q_t
+    rct::key m_sender_receiver_secret;
+    /// K'^s_t = Ko_t - H(q_t) X
+    rct::key m_nominal_spend_key;
+};
+
+/// a view tag match for one of several scanned accounts
+struct SpMultiAccountScanHit final
+{
+    /// index of the account's view key in the scanned view keys
+    std::size_t m_account_index;
+    /// index of the enote in the scanned records
+    std::size_t m_record_index;
+    /// q_t
+    rct::key m_sender_receiver_secret;
+    /// K'^s_t = Ko_t - H(q_t) X
+    rct::key m_nominal_spend_key;
+};
+
+/// the per-enote data a cryptonote view-key scanner needs
+struct CnEnoteScanRecord final
+{
+    /// R (tx pubkey)
+    crypto::public_key m_tx_pubkey;
+    /// Ko_t
+    crypto::public_key m_onetime_address;
+    /// t
+    std::size_t m_output_index;
+};
+
+/// a cryptonote enote owned by the scanning wallet
+struct CnEnoteScanHit final
+{
+    /// index of the enote in the scanned records
+    std::size_t m_record_index;
+};
+
+/// the per-enote data a cryptonote view-key scanner needs, as parallel columns (e.g. a mapped enote stream)
+struct CnEnoteScanColumns final
+{
+    /// R for each enote
+    const crypto::public_key *m_tx_pubkeys;
+    /// R_t for each enote, null_pkey where the tx has none (may be null if no enote has one)
+    const crypto::public_key *m_additional_pubkeys;
+    /// Ko_t for each enote
+    const crypto::public_key *m_onetime_addresses;
+    /// t for each enote
+    const std::uint32_t *m_output_indices;
+    std::size_t m_num_enotes;
+};
+
+////
+// SeraphisEnoteScanner
+// - scans records in chunks: decompress R_t in a batch, compute 8 * k^{vr} * R_t for every record, compress
+//   the derivations with a shared field inversion, then hash the view tags (keccak tags four at a time)
+// - only records whose view tag matches pay for the sender-receiver secret and nominal spend key
+// - results match try_get_seraphis_nominal_spend_key() on each record; records with invalid R_t are skipped
+///
+class SeraphisEnoteScanner final
+{
+public:
+//constructors
+    explicit SeraphisEnoteScanner(const crypto::secret_key &view_privkey,
+        const SpViewTagHash view_tag_hash = SpViewTagHash::KECCAK) :
+            m_view_privkey{view_privkey},
+            m_view_tag_hash{view_tag_hash}
+    {}
+
+//member functions
+    /**
+    * brief: scan - find the records whose view tag matches, and recover their nominal spend keys
+    * param: records -
+    * param: num_threads - max number of threads (0 = threadpool max concurrency; 1 = serial)
+    * outparam: hits_out - view tag matches, in record order
+    */
+    void scan(const std::vector<SpEnoteScanRecord> &records,
+        std::vector<SpEnoteScanHit> &hits_out,
+        const std::size_t num_threads = 1) const;
+
+//member variables
+private:
+    /// k^{vr}
+    crypto::secret_key m_view_privkey;
+    /// hash function used to make the scanned enotes' view tags
+    SpViewTagHash m_view_tag_hash;
+};
+
+/**
+* brief: scan_enotes_cn_parallel - find the cryptonote enotes owned by a wallet, one enote at a time
+*   - splits the records into chunks that are balanced across threads with work stealing
+*   - owned: Ko_t - H(k^v R, t) G == K^s
+* param: view_privkey - k^v
+* param: spend_pubkey - K^s
+* param: records -
+* param: chunk_size - records per chunk
+* param: num_threads - max number of threads (0 = threadpool max concurrency; 1 = serial)
+* outparam: hits_out - owned enotes, in record (ledger) order
+*/
+void scan_enotes_cn_parallel(const crypto::secret_key &view_privkey,
+    const crypto::public_key &spend_pubkey,
+    const std::vector<CnEnoteScanRecord> &records,
+    const std::size_t chunk_size,
+    const std::size_t num_threads,
+    std::vector<CnEnoteScanHit> &hits_out);
+/**
+* brief: scan_enotes_cn_parallel - find the cryptonote enotes owned by a wallet, reading the columns in place
+*   - derivations are batched per chunk, once per run of enotes that share R (a tx's enotes are adjacent in ledger order)
+*   - enotes with R_t are also checked against k^v R_t
+*   - owned: Ko_t - H(k^v R, t) G == K^s
+* param: view_privkey - k^v
+* param: spend_pubkey - K^s
+* param: columns -
+* param: chunk_size - enotes per chunk
+* param: num_threads - max number of threads (0 = threadpool max concurrency; 1 = serial)
+* outparam: hits_out - owned enotes, in column (ledger) order
+*/
+void scan_enotes_cn_parallel(const crypto::secret_key &view_privkey,
+    const crypto::public_key &spend_pubkey,
+    const CnEnoteScanColumns &columns,
+    const std::size_t chunk_size,
+    const std::size_t num_threads,
+    std::vector<CnEnoteScanHit> &hits_out);
+/**
+* brief: scan_enotes_sp_parallel - find the Seraphis enotes whose view tag matches, one enote at a time
+*   with try_get_seraphis_nominal_spend_key()
+*   - splits the records into chunks that are balanced across threads with work stealing
+* param: view_privkey - k^{vr}
+* param: records -
+* param: chunk_size - records per chunk
+* param: num_threads - max number of threads (0 = threadpool max concurrency; 1 = serial)
+* outparam: hits_out - view tag matches, in record (ledger) order
+* param: view_tag_hash - hash function used to make the scanned enotes' view tags
+*/
+void scan_enotes_sp_parallel(const crypto::secret_key &view_privkey,
+    const std::vector<SpEnoteScanRecord> &records,
+    const std::size_t chunk_size,
+    const std::size_t num_threads,
+    std::vector<SpEnoteScanHit> &hits_out,
+    const SpViewTagHash view_tag_hash = SpViewTagHash::KECCAK);
+/**
+* brief: scan_enotes_sp_multi_account - scan each enote for many accounts at once (e.g. a light-wallet server)
+*   - each R_t is decompressed once and expanded into a table of its multiples that every view key reuses, so
+*     8 * k^{vr}_a * R_t costs additions only (no doublings) per account
+*   - per enote, the accounts' derivations are compressed with a shared inversion and their view tags hashed in a batch
+*   - enotes are split into chunks that are balanced across threads with work stealing
+* param: view_privkeys - k^{vr}_a for each account a
+* param: records -
+* param: num_threads - max number of threads (0 = threadpool max concurrency; 1 = serial)
+* outparam: hits_out - view tag matches, in record (ledger) order, then account order
+* param: view_tag_hash - hash function used to make the scanned enotes' view tags
+*/
+void scan_enotes_sp_multi_account(const std::vector<crypto::secret_key> &view_privkeys,
+    const std::vector<SpEnoteScanRecord> &records,
+    const std::size_t num_threads,
+    std::vector<SpMultiAccountScanHit> &hits_out,
+    const SpViewTagHash view_tag_hash = SpViewTagHash::KECCAK);
+
+} //namespace mock_tx
@@ -134,6 +134,27 @@ MockENoteSpV1 MockDestinationSpV1::to_enote_v1(const std::size_t output_index, r
     return enote;
 }
 //-------------------------------------------------------------------------------------------------------------------
+MockENoteSpV1 MockDestinationSpV1::to_enote_v1(const std::size_t output_index,
+    const SpRecipientPrecompV1 &recipient_precomp,
+    rct::key &enote_pubkey_out) const
+{
+    CHECK_AND_ASSERT_THROW_MES(recipient_precomp.m_recipient_DH_base == m_recipient_DHkey &&
+            recipient_precomp.m_recipient_view_key == m_recipient_viewkey,
+        "Recipient precomputation does not match the destination.");
+
+    MockENoteSpV1 enote;
+
+    enote.make(m_enote_privkey,
+        recipient_precomp,
+        m_recipient_spendkey,
+        m_amount,
+        output_index,
+        false,
+        enote_pubkey_out);
+
+    return enote;
+}
+//-------------------------------------------------------------------------------------------------------------------
 void MockDestinationSpV1::gen(const rct::xmr_amount amount)
 {
     // gen base of destination
@@ -158,6 +179,39 @@ MockTxProposalSpV1::MockTxProposalSpV1(std::vector<MockDestinationSpV1> destinat
         m_tx_supplement);
 }
 //-------------------------------------------------------------------------------------------------------------------
+const SpRecipientPrecompV1& MockRecipientPrecompCacheSpV1::get_or_make(const rct::key &recipient_DH_base,
+    const rct::key &recipient_view_key)
+{
+    std::unique_ptr<SpRecipientPrecompV1> &precomp{m_precomps[recipient_view_key]};
+
+    if (!precomp || !(precomp->m_recipient_DH_base == recipient_DH_base))
+    {
+        std::unique_ptr<SpRecipientPrecompV1> new_precomp{new SpRecipientPrecompV1{}};
+        make_seraphis_recipient_precomp_v1(recipient_DH_base, recipient_view_key, *new_precomp);
+        precomp = std::move(new_precomp);
+    }
+
+    return *precomp;
+}
+//-------------------------------------------------------------------------------------------------------------------
+MockTxProposalSpV1::MockTxProposalSpV1(std::vector<MockDestinationSpV1> destinations,
+    MockRecipientPrecompCacheSpV1 &recipient_precomp_cache_inout)
+{
+    // destinations should be randomly ordered
+    std::shuffle(destinations.begin(), destinations.end(), crypto::random_device{});
+    m_destinations = std::move(destinations);
+
+    // make outputs (with cached recipient tables)
+    // make tx supplement
+    // prepare for range proofs
+    make_v1_tx_outputs_sp_v1(m_destinations,
+        recipient_precomp_cache_inout,
+        m_outputs,
+        m_output_amounts,
+        m_output_amount_commitment_blinding_factors,
+        m_tx_supplement);
+}
+//-------------------------------------------------------------------------------------------------------------------
 rct::key MockTxProposalSpV1::get_proposal_prefix(const std::string &version_string) const
 {
     CHECK_AND_ASSERT_THROW_MES(m_outputs.size() > 0, "Tried to get proposal prefix for a tx proposal with no outputs!");
@@ -34,12 +34,16 @@
 //local headers
 #include "crypto/crypto.h"
 #include "mock_sp_base_types.h"
+#include "mock_sp_core_utils.h"
 #include "mock_sp_transaction_component_types.h"
 #include "ringct/rctTypes.h"
 
 //third party headers
 
 //standard headers
+#include <memory>
+#include <unordered_map>
+#include <vector>
 
 //forward declarations
 
@@ -77,6 +81,10 @@ struct MockDestinationSpV1 final : public MockDestinationSp
 
     /// convert this destination into a v1 enote
     MockENoteSpV1 to_enote_v1(const std::size_t output_index, rct::key &enote_pubkey_out) const;
+    /// convert this destination into a v1 enote, using the recipient's precomputed tables (must match this destination)
+    MockENoteSpV1 to_enote_v1(const std::size_t output_index,
+        const SpRecipientPrecompV1 &recipient_precomp,
+        rct::key &enote_pubkey_out) const;
 
     /**
     * brief: gen - generate a V1 Destination (random)
@@ -85,6 +93,28 @@ struct MockDestinationSpV1 final : public MockDestinationSp
     void gen(const rct::xmr_amount amount);
 };
 
+////
+// MockRecipientPrecompCacheSpV1 - a sender's precomputed recipient tables (see SpRecipientPrecompV1)
+// - kept by the sender across tx builds, so each repeat recipient (e.g. in batched payouts) is only prepared once
+// - keyed by the recipient's view key K^{vr}; an entry whose DH base doesn't match the requested one is remade
+///
+class MockRecipientPrecompCacheSpV1 final
+{
+public:
+    /// get the tables for a recipient, making them if not cached
+    const SpRecipientPrecompV1& get_or_make(const rct::key &recipient_DH_base, const rct::key &recipient_view_key);
+
+    /// number of cached recipients
+    std::size_t size() const { return m_precomps.size(); }
+
+    /// drop all cached recipients
+    void clear() { m_precomps.clear(); }
+
+private:
+    /// tables are large (~60kB), so they are stored behind pointers
+    std::unordered_map<rct::key, std::unique_ptr<SpRecipientPrecompV1>> m_precomps;
+};
+
 ////
 // MockMembershipReferenceSetSpV1 - Records info about a membership reference set, for producing a membership proof
 ///
@@ -138,6 +168,9 @@ struct MockTxProposalSpV1 final
 
     /// normal constructor: make a tx proposal from destinations (a.k.a. outlays)
     MockTxProposalSpV1(std::vector<MockDestinationSpV1> destinations);
+    /// normal constructor, with the sender's precomputed recipient tables (updated with any new recipients)
+    MockTxProposalSpV1(std::vector<MockDestinationSpV1> destinations,
+        MockRecipientPrecompCacheSpV1 &recipient_precomp_cache_inout);
 
 //member functions
     /// message to be signed by input spend proofs
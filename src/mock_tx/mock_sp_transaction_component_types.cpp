@@ -54,6 +54,48 @@
 namespace mock_tx
 {
 //-------------------------------------------------------------------------------------------------------------------
+// make the parts of a v1 enote that follow from the sender-receiver derivation
+//-------------------------------------------------------------------------------------------------------------------
+static void make_enote_v1_from_derivation(const crypto::key_derivation &sender_receiver_DH_derivation,
+    const crypto::secret_key &enote_privkey,
+    const rct::key &recipient_spend_key,
+    const rct::xmr_amount amount,
+    const std::size_t enote_index,
+    const bool lock_amounts_to_DH_key,
+    const SpViewTagHash view_tag_hash,
+    MockENoteSpV1 &enote_inout)
+{
+    // q_t: sender-receiver shared secret
+    rct::key sender_receiver_secret;
+    auto a_wiper = epee::misc_utils::create_scope_leave_handler([&]{
+        memwipe(&sender_receiver_secret, sizeof(rct::key));
+    });
+    make_seraphis_sender_receiver_secret(sender_receiver_DH_derivation, enote_index, sender_receiver_secret);
+
+    // make extra key for locking ENote amounts to the recipient's DH base key (DH_base = DH_base_key * G)
+    rct::key extra_key_amounts{rct::zero()};
+    if (lock_amounts_to_DH_key)
+        rct::scalarmultBase(extra_key_amounts, rct::sk2rct(enote_privkey));
+
+    // x_t: amount commitment mask (blinding factor)
+    crypto::secret_key amount_mask;
+    make_seraphis_amount_commitment_mask(rct::rct2sk(sender_receiver_secret), extra_key_amounts, amount_mask);
+
+    // k_{a, sender, t}: extension to add to user's spend key
+    crypto::secret_key k_a_extender;
+    make_seraphis_sender_address_extension(rct::rct2sk(sender_receiver_secret), k_a_extender);
+
+    // make the base of the enote (Ko_t, C_t)
+    enote_inout.make_base_with_address_extension(k_a_extender, recipient_spend_key, amount_mask, amount);
+
+    // enc(a_t): encoded amount
+    enote_inout.m_encoded_amount =
+        enc_dec_seraphis_amount(rct::rct2sk(sender_receiver_secret), extra_key_amounts, amount);
+
+    // view_tag_t: view tag
+    enote_inout.m_view_tag = make_seraphis_view_tag(sender_receiver_DH_derivation, enote_index, view_tag_hash);
+}
+//-------------------------------------------------------------------------------------------------------------------
 void MockENoteSpV1::make(const crypto::secret_key &enote_privkey,
     const rct::key &recipient_DH_base,
     const rct::key &recipient_view_key,
@@ -61,20 +103,125 @@ void MockENoteSpV1::make(const crypto::secret_key &enote_privkey,
     const rct::xmr_amount amount,
     const std::size_t enote_index,
     const bool lock_amounts_to_DH_key,
-    rct::key &enote_pubkey_out)
+    rct::key &enote_pubkey_out,
+    const SpViewTagHash view_tag_hash)
 {
     // note: t = enote_index
 
-    // r_t: sender-receiver shared secret
+    // 8 r_t K^{vr}: sender-receiver DH derivation (shared by the sender-receiver secret and the view tag)
+    crypto::key_derivation derivation;
+    auto a_wiper = epee::misc_utils::create_scope_leave_handler([&]{
+        memwipe(&derivation, sizeof(crypto::key_derivation));
+    });
+    hw::get_device("default").generate_key_derivation(rct::rct2pk(recipient_view_key), enote_privkey, derivation);
+
+    // Ko_t, C_t, enc(a_t), view_tag_t
+    make_enote_v1_from_derivation(derivation,
+        enote_privkey,
+        recipient_spend_key,
+        amount,
+        enote_index,
+        lock_amounts_to_DH_key,
+        view_tag_hash,
+        *this);
+
+    // R_t: enote pubkey to send back to caller
+    make_seraphis_enote_pubkey(enote_privkey, recipient_DH_base, enote_pubkey_out);
+}
+//-------------------------------------------------------------------------------------------------------------------
+void MockENoteSpV1::make(const crypto::secret_key &enote_privkey,
+    const SpRecipientPrecompV1 &recipient_precomp,
+    const rct::key &recipient_spend_key,
+    const rct::xmr_amount amount,
+    const std::size_t enote_index,
+    const bool lock_amounts_to_DH_key,
+    rct::key &enote_pubkey_out,
+    const SpViewTagHash view_tag_hash)
+{
+    // note: t = enote_index
+
+    // 8 r_t K^{vr}: sender-receiver DH derivation
+    crypto::key_derivation derivation;
+    auto a_wiper = epee::misc_utils::create_scope_leave_handler([&]{
+        memwipe(&derivation, sizeof(crypto::key_derivation));
+    });
+    make_seraphis_sender_receiver_derivation(enote_privkey, recipient_precomp, derivation);
+
+    // Ko_t, C_t, enc(a_t), view_tag_t
+    make_enote_v1_from_derivation(derivation,
+        enote_privkey,
+        recipient_spend_key,
+        amount,
+        enote_index,
+        lock_amounts_to_DH_key,
+        view_tag_hash,
+        *this);
+
+    // R_t: enote pubkey to send back to caller
+    make_seraphis_enote_pubkey(enote_privkey, recipient_precomp, enote_pubkey_out);
+}
+//-------------------------------------------------------------------------------------------------------------------
+void MockENoteSpV1::gen()
+{
+    // generate a dummy enote: random pieces, completely unspendable
+
+    // gen base of enote
+    this->gen_base();
+
+    // memo
+    m_encoded_amount = rct::randXmrAmount(rct::xmr_amount{static_cast<rct::xmr_amount>(-1)});
+    m_view_tag = crypto::rand_idx(static_cast<unsigned char>(-1));
+}
+//-------------------------------------------------------------------------------------------------------------------
+void MockENoteSpV1::append_to_string(std::string &str_inout) const
+{
+    // append all enote contents to the string
+    // - assume the input string has enouch capacity
+    str_inout.append((const char*) m_onetime_address.bytes, sizeof(rct::key));
+    str_inout.append((const char*) m_amount_commitment.bytes, sizeof(rct::key));
+    for (int i{7}; i >= 0; --i)
+    {
+        str_inout += static_cast<char>(m_encoded_amount >> i*8);
+    }
+    str_inout += static_cast<char>(m_view_tag);
+}
+//-------------------------------------------------------------------------------------------------------------------
+void MockENoteSpV1View::append_to_string(std::string &str_inout) const
+{
+    // append all enote contents to the string (the encoded amount is big-endian in the string)
+    str_inout.append((const char*) m_onetime_address.bytes, sizeof(rct::key));
+    str_inout.append((const char*) m_amount_commitment.bytes, sizeof(rct::key));
+    for (int i{7}; i >= 0; --i)
+    {
+        str_inout += static_cast<char>(m_encoded_amount[i]);
+    }
+    str_inout += static_cast<char>(m_view_tag);
+}
+//-------------------------------------------------------------------------------------------------------------------
+void MockENoteSpV2::make(const crypto::secret_key &enote_privkey,
+    const rct::key &recipient_DH_base,
+    const rct::key &recipient_view_key,
+    const rct::key &recipient_spend_key,
+    const rct::xmr_amount amount,
+    const std::size_t enote_index,
+    const bool lock_amounts_to_DH_key,
+    const std::size_t view_tag_bytes,
+    rct::key &enote_pubkey_out,
+    const SpViewTagHash view_tag_hash)
+{
+    // note: t = enote_index
+
+    // 8 r_t K^{vr}: sender-receiver DH derivation
+    crypto::key_derivation derivation;
     rct::key sender_receiver_secret;
     auto a_wiper = epee::misc_utils::create_scope_leave_handler([&]{
+        memwipe(&derivation, sizeof(crypto::key_derivation));
         memwipe(&sender_receiver_secret, sizeof(rct::key));
     });
-    make_seraphis_sender_receiver_secret(enote_privkey,
-        recipient_view_key,
-        enote_index,
-        hw::get_device("default"),
-        sender_receiver_secret);
+    hw::get_device("default").generate_key_derivation(rct::rct2pk(recipient_view_key), enote_privkey, derivation);
+
+    // q_t: sender-receiver shared secret
+    make_seraphis_sender_receiver_secret(derivation, enote_index, sender_receiver_secret);
 
     // make extra key for locking ENote amounts to the recipient's DH base key (DH_base = DH_base_key * G)
     rct::key extra_key_amounts{rct::zero()};
@@ -96,28 +243,30 @@ void MockENoteSpV1::make(const crypto::secret_key &enote_privkey,
     m_encoded_amount = enc_dec_seraphis_amount(rct::rct2sk(sender_receiver_secret), extra_key_amounts, amount);
 
     // view_tag_t: view tag
-    m_view_tag = make_seraphis_view_tag(enote_privkey,
-        recipient_view_key,
-        enote_index,
-        hw::get_device("default"));
+    m_view_tag = make_seraphis_view_tag_wide(derivation, enote_index, view_tag_bytes, view_tag_hash);
+    m_view_tag_bytes = static_cast<unsigned char>(view_tag_bytes);
 
     // R_t: enote pubkey to send back to caller
     make_seraphis_enote_pubkey(enote_privkey, recipient_DH_base, enote_pubkey_out);
 }
 //-------------------------------------------------------------------------------------------------------------------
-void MockENoteSpV1::gen()
+void MockENoteSpV2::gen(const std::size_t view_tag_bytes)
 {
     // generate a dummy enote: random pieces, completely unspendable
+    CHECK_AND_ASSERT_THROW_MES(view_tag_bytes >= 1 && view_tag_bytes <= 8, "Invalid view tag width.");
 
     // gen base of enote
     this->gen_base();
 
     // memo
     m_encoded_amount = rct::randXmrAmount(rct::xmr_amount{static_cast<rct::xmr_amount>(-1)});
-    m_view_tag = crypto::rand_idx(static_cast<unsigned char>(-1));
+    m_view_tag = crypto::rand<std::uint64_t>();
+    if (view_tag_bytes < 8)
+        m_view_tag &= (std::uint64_t{1} << (8 * view_tag_bytes)) - 1;
+    m_view_tag_bytes = static_cast<unsigned char>(view_tag_bytes);
 }
 //-------------------------------------------------------------------------------------------------------------------
-void MockENoteSpV1::append_to_string(std::string &str_inout) const
+void MockENoteSpV2::append_to_string(std::string &str_inout) const
 {
     // append all enote contents to the string
     // - assume the input string has enouch capacity
@@ -127,7 +276,10 @@ void MockENoteSpV1::append_to_string(std::string &str_inout) const
     {
         str_inout += static_cast<char>(m_encoded_amount >> i*8);
     }
-    str_inout += static_cast<char>(m_view_tag);
+    for (std::size_t i{0}; i < m_view_tag_bytes; ++i)
+    {
+        str_inout += static_cast<char>(m_view_tag >> i*8);
+    }
 }
 //-------------------------------------------------------------------------------------------------------------------
 std::size_t MockMembershipProofSpV1::get_size_bytes() const
@@ -161,7 +313,9 @@ std::size_t MockMembershipProofSpV2::get_size_bytes() const
 //-------------------------------------------------------------------------------------------------------------------
 std::size_t MockImageProofSpV1::get_size_bytes() const
 {
-    return 32 * (3 + m_composition_proof.r_i.size() + m_composition_proof.K_t1.size());
+    // A_K_t2, A_KI, r_a, r_b, {A_K_t1}, {r_i}, {K_t1}
+    return 32 * (4 + m_composition_proof.A_K_t1.size() + m_composition_proof.r_i.size() +
+        m_composition_proof.K_t1.size());
 }
 //-------------------------------------------------------------------------------------------------------------------
 std::size_t MockBalanceProofSpV1::get_size_bytes(const bool include_commitments /*=false*/) const
@@ -205,4 +359,23 @@ std::size_t MockSupplementSpV1::get_size_bytes() const
     return 32 * m_output_enote_pubkeys.size();
 }
 //-------------------------------------------------------------------------------------------------------------------
+bool try_restore_bpp_commitments(const rct::keyV &commitments, std::vector<rct::BulletproofPlus> &range_proofs_inout)
+{
+    std::size_t commitment_index{0};
+
+    for (rct::BulletproofPlus &range_proof : range_proofs_inout)
+    {
+        for (rct::key &V : range_proof.V)
+        {
+            if (commitment_index >= commitments.size())
+                return false;
+
+            V = rct::scalarmultKey(commitments[commitment_index], rct::INV_EIGHT);
+            ++commitment_index;
+        }
+    }
+
+    return commitment_index == commitments.size();
+}
+//-------------------------------------------------------------------------------------------------------------------
 } //namespace mock_tx
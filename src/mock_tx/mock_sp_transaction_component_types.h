@@ -35,12 +35,17 @@
 #include "crypto/crypto.h"
 #include "grootle.h"
 #include "mock_sp_base_types.h"
+#include "mock_sp_core_utils.h"
 #include "ringct/rctTypes.h"
+#include "serialization/containers.h"
+#include "serialization/crypto.h"
+#include "serialization/serialization.h"
 #include "seraphis_composition_proof.h"
 
 //third party headers
 
 //standard headers
+#include <cstdint>
 
 //forward declarations
 
@@ -48,6 +53,56 @@
 namespace mock_tx
 {
 
+/// BP+ commitments aren't saved in tx blobs (they are the tx's amount commitments, scaled by 1/8), only how many each
+/// proof has; the commitments are restored with try_restore_bpp_commitments()
+template <bool W, template <bool> class Archive>
+bool serialize_bpp_num_commitments(Archive<W> &ar, std::vector<rct::BulletproofPlus> &range_proofs)
+{
+    for (rct::BulletproofPlus &range_proof : range_proofs)
+    {
+        std::size_t num_commitments{range_proof.V.size()};
+        VARINT_FIELD_N("num_commitments", num_commitments)
+
+        if (!W)
+        {
+            // a proof of M commitments has log2(64 * M') L terms, where M' is M rounded up to a power of 2
+            if (num_commitments == 0 ||
+                range_proof.L.size() >= 32 ||
+                num_commitments > (std::size_t{1} << range_proof.L.size()) / 64)
+                return false;
+            range_proof.V.resize(num_commitments);
+        }
+    }
+
+    return true;
+}
+
+/// ledger enote indices are saved in tx blobs as delta varints (first index, then the difference from each index to the
+/// next); reference sets are sorted and often clustered, so most differences fit in one byte
+template <bool W, template <bool> class Archive>
+bool serialize_ledger_enote_indices(Archive<W> &ar, std::vector<std::size_t> &ledger_enote_indices)
+{
+    std::size_t num_indices{ledger_enote_indices.size()};
+    VARINT_FIELD_N("num_indices", num_indices)
+
+    if (!W)
+        ledger_enote_indices.clear();
+
+    std::size_t previous_index{0};
+    for (std::size_t i{0}; i < num_indices; ++i)
+    {
+        // note: differences wrap around, so unsorted indices still round-trip (sorting is a semantics check)
+        std::size_t index_delta{W ? ledger_enote_indices[i] - previous_index : 0};
+        VARINT_FIELD_N("index_delta", index_delta)
+
+        if (!W)
+            ledger_enote_indices.push_back(previous_index + index_delta);
+        previous_index += index_delta;
+    }
+
+    return true;
+}
+
 ////
 // MockENoteSpV1 - v1 enote
 ///
@@ -68,6 +123,7 @@ struct MockENoteSpV1 final : public MockENoteSp
     * param: enote_index - t, index of the enote in its tx
     * param: lock_amounts_to_DH_key - if true, then compute r_t G and bake it into the amount encoding and commitment mask
     * outparam: enote_pubkey_out - the enote's pubkey
+    * param: view_tag_hash - hash function for the view tag
     */
     void make(const crypto::secret_key &enote_privkey,
         const rct::key &recipient_DH_base,
@@ -76,7 +132,27 @@ struct MockENoteSpV1 final : public MockENoteSp
         const rct::xmr_amount amount,
         const std::size_t enote_index,
         const bool lock_amounts_to_DH_key,
-        rct::key &enote_pubkey_out);
+        rct::key &enote_pubkey_out,
+        const SpViewTagHash view_tag_hash = SpViewTagHash::KECCAK);
+    /**
+    * brief: make - make a v1 enote with the recipient's precomputed tables (same result as the overload above)
+    * param: enote_privkey - r_t
+    * param: recipient_precomp - tables for K^{DH} and K^{vr}
+    * param: recipient_spend_key - K^s
+    * param: amount - a
+    * param: enote_index - t, index of the enote in its tx
+    * param: lock_amounts_to_DH_key - if true, then compute r_t G and bake it into the amount encoding and commitment mask
+    * outparam: enote_pubkey_out - the enote's pubkey
+    * param: view_tag_hash - hash function for the view tag
+    */
+    void make(const crypto::secret_key &enote_privkey,
+        const SpRecipientPrecompV1 &recipient_precomp,
+        const rct::key &recipient_spend_key,
+        const rct::xmr_amount amount,
+        const std::size_t enote_index,
+        const bool lock_amounts_to_DH_key,
+        rct::key &enote_pubkey_out,
+        const SpViewTagHash view_tag_hash = SpViewTagHash::KECCAK);
     /**
     * brief: append_to_string - convert enote to a string and append to existing string
     *   str += Ko | C | enc(a) | view_tag
@@ -88,6 +164,65 @@ struct MockENoteSpV1 final : public MockENoteSp
     void gen();
 
     static std::size_t get_size_bytes() { return get_size_bytes_base() + 8 + 1; }
+
+    BEGIN_SERIALIZE_OBJECT()
+        FIELD(m_onetime_address)
+        FIELD(m_amount_commitment)
+        FIELD(m_encoded_amount)
+        FIELD(m_view_tag)
+    END_SERIALIZE()
+};
+
+////
+// MockENoteSpV2 - v2 enote: v1 with a multi-byte view tag
+// - non-owned enotes pass the view tag check with probability 2^(-8 * tag width) instead of 1/256, so view-key
+//   scanners skip almost all nominal spend key recoveries, at the cost of (tag width - 1) extra bytes per enote
+// - the tag width would be fixed by the tx version in a real protocol; it is stored here so enotes of different
+//   widths can share the mockup (and is not counted in the enote size)
+///
+struct MockENoteSpV2 final : public MockENoteSp
+{
+    /// enc(a)
+    rct::xmr_amount m_encoded_amount;
+    /// tag_t (the low 'm_view_tag_bytes' bytes are used)
+    std::uint64_t m_view_tag;
+    /// width of tag_t in bytes
+    unsigned char m_view_tag_bytes;
+
+    /**
+    * brief: make - make a v2 enote
+    * param: enote_privkey - r_t
+    * param: recipient_DH_base - K^{DH}   [change in 2-out: other recipient's K^{DH}]
+    * param: recipient_view_key - K^{vr}  [change in 2-out: k^{vr}_local * K^{DH}_other_recipient]
+    * param: recipient_spend_key - K^s
+    * param: amount - a
+    * param: enote_index - t, index of the enote in its tx
+    * param: lock_amounts_to_DH_key - if true, then compute r_t G and bake it into the amount encoding and commitment mask
+    * param: view_tag_bytes - tag width in [1, get_seraphis_view_tag_max_bytes(view_tag_hash)]
+    * outparam: enote_pubkey_out - the enote's pubkey
+    * param: view_tag_hash - hash function for the view tag
+    */
+    void make(const crypto::secret_key &enote_privkey,
+        const rct::key &recipient_DH_base,
+        const rct::key &recipient_view_key,
+        const rct::key &recipient_spend_key,
+        const rct::xmr_amount amount,
+        const std::size_t enote_index,
+        const bool lock_amounts_to_DH_key,
+        const std::size_t view_tag_bytes,
+        rct::key &enote_pubkey_out,
+        const SpViewTagHash view_tag_hash = SpViewTagHash::KECCAK);
+    /**
+    * brief: append_to_string - convert enote to a string and append to existing string
+    *   str += Ko | C | enc(a) | view_tag (little-endian, tag width bytes)
+    * inoutparam: str_inout - enote contents concatenated to a string
+    */
+    void append_to_string(std::string &str_inout) const override;
+
+    /// generate a dummy v2 enote (all random; completely unspendable)
+    void gen(const std::size_t view_tag_bytes);
+
+    std::size_t get_size_bytes() const { return get_size_bytes_base() + 8 + m_view_tag_bytes; }
 };
 
 ////
@@ -96,7 +231,50 @@ struct MockENoteSpV1 final : public MockENoteSp
 struct MockENoteImageSpV1 final : public MockENoteImageSp
 {
     static std::size_t get_size_bytes() { return get_size_bytes_base(); }
+
+    BEGIN_SERIALIZE_OBJECT()
+        FIELD(m_masked_address)
+        FIELD(m_masked_commitment)
+        FIELD(m_key_image)
+    END_SERIALIZE()
+};
+
+////
+// MockENoteSpV1View - v1 enote as laid out in a tx blob
+// - a tx blob's outputs are back-to-back records of this layout, so they can be read in place (see
+//   MockTxSpSquashedV1View)
+///
+struct MockENoteSpV1View final
+{
+    /// Ko
+    rct::key m_onetime_address;
+    /// C
+    rct::key m_amount_commitment;
+    /// enc(a) (little-endian)
+    unsigned char m_encoded_amount[8];
+    /// tag_t
+    unsigned char m_view_tag;
+
+    /// same as MockENoteSpV1::append_to_string()
+    void append_to_string(std::string &str_inout) const;
 };
+static_assert(sizeof(MockENoteSpV1View) == 32*2 + 8 + 1 && alignof(MockENoteSpV1View) == 1,
+    "MockENoteSpV1View must match the blob layout of MockENoteSpV1.");
+
+////
+// MockENoteImageSpV1View - v1 enote image as laid out in a tx blob (see MockENoteSpV1View)
+///
+struct MockENoteImageSpV1View final
+{
+    /// Ko'
+    rct::key m_masked_address;
+    /// C'
+    rct::key m_masked_commitment;
+    /// KI
+    crypto::key_image m_key_image;
+};
+static_assert(sizeof(MockENoteImageSpV1View) == 32*3 && alignof(MockENoteImageSpV1View) == 1,
+    "MockENoteImageSpV1View must match the blob layout of MockENoteImageSpV1.");
 
 ////
 // MockMembershipProofSpV1 - Membership Proof V1
@@ -113,6 +291,14 @@ struct MockMembershipProofSpV1 final
     std::size_t m_ref_set_decomp_m;
 
     std::size_t get_size_bytes() const;
+
+    BEGIN_SERIALIZE_OBJECT()
+        FIELD(m_concise_grootle_proof)
+        if (!serialize_ledger_enote_indices(ar, m_ledger_enote_indices))
+            return false;
+        VARINT_FIELD(m_ref_set_decomp_n)
+        VARINT_FIELD(m_ref_set_decomp_m)
+    END_SERIALIZE()
 };
 
 ////
@@ -130,6 +316,14 @@ struct MockMembershipProofSpV2 final
     std::size_t m_ref_set_decomp_m;
 
     std::size_t get_size_bytes() const;
+
+    BEGIN_SERIALIZE_OBJECT()
+        FIELD(m_grootle_proof)
+        if (!serialize_ledger_enote_indices(ar, m_ledger_enote_indices))
+            return false;
+        VARINT_FIELD(m_ref_set_decomp_n)
+        VARINT_FIELD(m_ref_set_decomp_m)
+    END_SERIALIZE()
 };
 
 ////
@@ -142,6 +336,10 @@ struct MockImageProofSpV1 final
     sp::SpCompositionProof m_composition_proof;
 
     std::size_t get_size_bytes() const;
+
+    BEGIN_SERIALIZE_OBJECT()
+        FIELD(m_composition_proof)
+    END_SERIALIZE()
 };
 
 ////
@@ -157,6 +355,13 @@ struct MockBalanceProofSpV1 final
     rct::key m_remainder_blinding_factor;
 
     std::size_t get_size_bytes(const bool include_commitments = false) const;
+
+    BEGIN_SERIALIZE_OBJECT()
+        FIELD(m_bpp_proofs)
+        if (!serialize_bpp_num_commitments(ar, m_bpp_proofs))
+            return false;
+        FIELD(m_remainder_blinding_factor)
+    END_SERIALIZE()
 };
 
 ////
@@ -170,6 +375,12 @@ struct MockBalanceProofSpV2 final
     std::vector<rct::BulletproofPlus> m_bpp_proofs;
 
     std::size_t get_size_bytes(const bool include_commitments = false) const;
+
+    BEGIN_SERIALIZE_OBJECT()
+        FIELD(m_bpp_proofs)
+        if (!serialize_bpp_num_commitments(ar, m_bpp_proofs))
+            return false;
+    END_SERIALIZE()
 };
 
 ////
@@ -187,6 +398,18 @@ struct MockSupplementSpV1 final
     //TODO - encoded payment ID: none in mockup
 
     std::size_t get_size_bytes() const;
+
+    BEGIN_SERIALIZE_OBJECT()
+        FIELD(m_output_enote_pubkeys)
+    END_SERIALIZE()
 };
 
+/**
+* brief: try_restore_bpp_commitments - restore the commitments of BP+ proofs that were parsed from a tx blob
+* param: commitments - the commitments proven by the range proofs, in proof order (unscaled)
+* inoutparam: range_proofs_inout - proofs with the number of commitments each proves already set; get (1/8)*C
+* return: false if the proofs don't prove exactly 'commitments'
+*/
+bool try_restore_bpp_commitments(const rct::keyV &commitments, std::vector<rct::BulletproofPlus> &range_proofs_inout);
+
 } //namespace mock_tx
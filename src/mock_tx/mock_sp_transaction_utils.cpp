@@ -42,16 +42,19 @@ extern "C"
 #include "grootle.h"
 #include "misc_language.h"
 #include "misc_log_ex.h"
+#include "mock_decoy_selection.h"
 #include "mock_ledger_context.h"
 #include "mock_sp_core_utils.h"
 #include "mock_sp_transaction_builder_types.h"
 #include "mock_sp_transaction_component_types.h"
+#include "mock_tx_phase_timers.h"
 #include "mock_tx_utils.h"
 #include "ringct/bulletproofs_plus.h"
 #include "ringct/rctOps.h"
 #include "ringct/rctTypes.h"
 #include "seraphis_composition_proof.h"
 #include "seraphis_crypto_utils.h"
+#include "seraphis_transcript.h"
 
 //third party headers
 
@@ -67,6 +70,35 @@ extern "C"
 namespace mock_tx
 {
 //-------------------------------------------------------------------------------------------------------------------
+// image proof message for owned enotes or in-place enote views (they are hashed the same way)
+//-------------------------------------------------------------------------------------------------------------------
+template <typename OutputEnotesT>
+static rct::key get_tx_image_proof_message_sp_v1_impl(const std::string &version_string,
+    const OutputEnotesT &output_enotes,
+    const MockSupplementSpV1 &tx_supplement)
+{
+    rct::key hash_result;
+    std::string hash;
+    hash.reserve(sizeof(CRYPTONOTE_NAME) +
+        version_string.size() +
+        output_enotes.size()*MockENoteSpV1::get_size_bytes() +
+        tx_supplement.m_output_enote_pubkeys.size());
+    hash = CRYPTONOTE_NAME;
+    hash += version_string;
+    for (const auto &output_enote : output_enotes)
+    {
+        output_enote.append_to_string(hash);
+    }
+    for (const auto &enote_pubkey : tx_supplement.m_output_enote_pubkeys)
+    {
+        hash.append((const char*) enote_pubkey.bytes, sizeof(enote_pubkey));
+    }
+
+    rct::hash_to_scalar(hash_result, hash.data(), hash.size());
+
+    return hash_result;
+}
+//-------------------------------------------------------------------------------------------------------------------
 // create t_k and t_c for an enote image
 //-------------------------------------------------------------------------------------------------------------------
 static void prepare_image_masks_sp_v1(crypto::secret_key &image_address_mask_out,
@@ -174,6 +206,24 @@ static void prepare_image_masks_all_sp_v2(const std::vector<MockInputProposalSpV
 //-------------------------------------------------------------------------------------------------------------------
 // sort order: key images ascending with byte-wise comparisons
 //-------------------------------------------------------------------------------------------------------------------
+static void make_input_key_images_sp_v1(const std::vector<MockInputProposalSpV1> &input_proposals,
+    std::vector<crypto::key_image> &key_images_out)
+{
+    // KI_i = (k_{b, i} / k_{a, i}) U, with one inversion for all the inputs
+    std::vector<crypto::secret_key> enote_view_privkeys;
+    std::vector<crypto::secret_key> spendbase_privkeys;
+    enote_view_privkeys.reserve(input_proposals.size());
+    spendbase_privkeys.reserve(input_proposals.size());
+
+    for (const MockInputProposalSpV1 &input_proposal : input_proposals)
+    {
+        enote_view_privkeys.emplace_back(input_proposal.m_enote_view_privkey);
+        spendbase_privkeys.emplace_back(input_proposal.m_spendbase_privkey);
+    }
+
+    make_seraphis_key_images(enote_view_privkeys, spendbase_privkeys, key_images_out);
+}
+//-------------------------------------------------------------------------------------------------------------------
 static std::vector<std::size_t> get_sort_order_for_sp_images_v1(const std::vector<MockENoteImageSpV1> &images)
 {
     std::vector<std::size_t> original_indices;
@@ -211,55 +261,121 @@ static auto convert_skv_to_rctv(const std::vector<crypto::secret_key> &skv, rct:
     return a_wiper;
 }
 //-------------------------------------------------------------------------------------------------------------------
+// random ref set members for tx inputs, with the real spend at a random index (dummy enotes are made in parallel)
+//-------------------------------------------------------------------------------------------------------------------
+static void gen_mock_sp_membership_ref_set_members(const std::vector<MockENoteSpV1> &input_enotes,
+    const std::size_t ref_set_decomp_n,
+    const std::size_t ref_set_decomp_m,
+    const std::size_t num_threads,
+    std::vector<MockMembershipReferenceSetSpV1> &reference_sets_out)
+{
+    const std::size_t ref_set_size{ref_set_size_from_decomp(ref_set_decomp_n, ref_set_decomp_m)};  // n^m
+
+    reference_sets_out.clear();
+    reference_sets_out.resize(input_enotes.size());
+
+    for (std::size_t input_index{0}; input_index < input_enotes.size(); ++input_index)
+    {
+        reference_sets_out[input_index].m_ref_set_decomp_n = ref_set_decomp_n;
+        reference_sets_out[input_index].m_ref_set_decomp_m = ref_set_decomp_m;
+        reference_sets_out[input_index].m_real_spend_index_in_set = crypto::rand_idx(ref_set_size);  // pi
+
+        reference_sets_out[input_index].m_ledger_enote_indices.resize(ref_set_size);
+        reference_sets_out[input_index].m_referenced_enotes.resize(ref_set_size);
+    }
+
+    CHECK_AND_ASSERT_THROW_MES(run_indexed_jobs(input_enotes.size()*ref_set_size, num_threads,
+                [&](const std::size_t member_index)
+                {
+                    MockMembershipReferenceSetSpV1 &reference_set{reference_sets_out[member_index / ref_set_size]};
+                    const std::size_t ref_index{member_index % ref_set_size};
+
+                    // add real input at pi
+                    if (ref_index == reference_set.m_real_spend_index_in_set)
+                        reference_set.m_referenced_enotes[ref_index] = input_enotes[member_index / ref_set_size];
+                    // add dummy enote
+                    else
+                        reference_set.m_referenced_enotes[ref_index].gen();
+                }
+            ),
+        "Failed to make reference set members.");
+}
+//-------------------------------------------------------------------------------------------------------------------
 //-------------------------------------------------------------------------------------------------------------------
 rct::key get_tx_membership_proof_message_sp_v1(const std::vector<std::size_t> &enote_ledger_indices)
 {
-    rct::key hash_result;
-    std::string hash;
-    hash.reserve(sizeof(CRYPTONOTE_NAME) + enote_ledger_indices.size()*((sizeof(std::size_t) * 8 + 6) / 7));
+    sp::SpTranscript transcript;
     // project name
-    hash = CRYPTONOTE_NAME;
-    // all referenced enote ledger indices
-    char converted_index[(sizeof(std::size_t) * 8 + 6) / 7];
-    char* end;
+    transcript.absorb_string(CRYPTONOTE_NAME);
+    // all referenced enote ledger indices (as delta varints, like in tx blobs)
+    std::size_t previous_index{0};
     for (const std::size_t index : enote_ledger_indices)
     {
         // TODO: append real ledger references
-        end = converted_index;
-        tools::write_varint(end, index);
-        assert(end <= converted_index + sizeof(converted_index));
-        hash.append(converted_index, end - converted_index);
+        transcript.absorb_varint(index - previous_index);
+        previous_index = index;
     }
 
-    rct::hash_to_scalar(hash_result, hash.data(), hash.size());
+    return transcript.challenge();
+}
+//-------------------------------------------------------------------------------------------------------------------
+void get_tx_membership_proof_messages_sp_v1(const std::vector<const std::vector<std::size_t>*> &enote_ledger_indices,
+    rct::keyV &messages_out)
+{
+    // collect each proof's hash input (see get_tx_membership_proof_message_sp_v1())
+    std::vector<std::string> hash_inputs;
+    hash_inputs.reserve(enote_ledger_indices.size());
 
-    return hash_result;
+    for (const std::vector<std::size_t> *proof_indices : enote_ledger_indices)
+    {
+        CHECK_AND_ASSERT_THROW_MES(proof_indices, "Enote ledger indices unexpectedly don't exist.");
+
+        hash_inputs.emplace_back(CRYPTONOTE_NAME);
+        std::string &hash{hash_inputs.back()};
+        hash.reserve(sizeof(CRYPTONOTE_NAME) + proof_indices->size()*((sizeof(std::size_t) * 8 + 6) / 7));
+
+        std::size_t previous_index{0};
+        for (const std::size_t index : *proof_indices)
+        {
+            tools::write_varint(std::back_inserter(hash), index - previous_index);
+            previous_index = index;
+        }
+    }
+
+    // hash them together
+    rct::hash_to_scalar_batch(messages_out, hash_inputs);
 }
 //-------------------------------------------------------------------------------------------------------------------
 rct::key get_tx_image_proof_message_sp_v1(const std::string &version_string,
     const std::vector<MockENoteSpV1> &output_enotes,
     const MockSupplementSpV1 &tx_supplement)
 {
-    rct::key hash_result;
-    std::string hash;
-    hash.reserve(sizeof(CRYPTONOTE_NAME) +
-        version_string.size() +
-        output_enotes.size()*MockENoteSpV1::get_size_bytes() +
-        tx_supplement.m_output_enote_pubkeys.size());
-    hash = CRYPTONOTE_NAME;
-    hash += version_string;
-    for (const auto &output_enote : output_enotes)
-    {
-        output_enote.append_to_string(hash);
-    }
-    for (const auto &enote_pubkey : tx_supplement.m_output_enote_pubkeys)
+    return get_tx_image_proof_message_sp_v1_impl(version_string, output_enotes, tx_supplement);
+}
+//-------------------------------------------------------------------------------------------------------------------
+rct::key get_tx_image_proof_message_sp_v1(const std::string &version_string,
+    const epee::span<const MockENoteSpV1View> output_enotes,
+    const MockSupplementSpV1 &tx_supplement)
+{
+    return get_tx_image_proof_message_sp_v1_impl(version_string, output_enotes, tx_supplement);
+}
+//-------------------------------------------------------------------------------------------------------------------
+void make_squashed_enotes_sp_v1(const std::vector<MockENoteSpV1> &enotes,
+    rct::keyV &squashed_enotes_out,
+    const std::size_t num_threads)
+{
+    rct::keyV onetime_addresses;
+    rct::keyV amount_commitments;
+    onetime_addresses.reserve(enotes.size());
+    amount_commitments.reserve(enotes.size());
+
+    for (const MockENoteSpV1 &enote : enotes)
     {
-        hash.append((const char*) enote_pubkey.bytes, sizeof(enote_pubkey));
+        onetime_addresses.emplace_back(enote.m_onetime_address);
+        amount_commitments.emplace_back(enote.m_amount_commitment);
     }
 
-    rct::hash_to_scalar(hash_result, hash.data(), hash.size());
-
-    return hash_result;
+    seraphis_squashed_enotes_Q(onetime_addresses, amount_commitments, squashed_enotes_out, num_threads);
 }
 //-------------------------------------------------------------------------------------------------------------------
 void sort_tx_inputs_sp_v1(const std::vector<MockMembershipProofSortableSpV1> &tx_membership_proofs_sortable,
@@ -442,7 +558,11 @@ void prepare_input_commitment_factors_for_balance_proof_v2(
     }
 }
 //-------------------------------------------------------------------------------------------------------------------
-void make_v1_tx_outputs_sp_v1(const std::vector<MockDestinationSpV1> &destinations,
+// make v1 tx outputs, with a caller-provided way to turn each destination into an enote
+//-------------------------------------------------------------------------------------------------------------------
+template <typename MakeEnoteFuncT>
+static void make_v1_tx_outputs_sp_v1_impl(const std::vector<MockDestinationSpV1> &destinations,
+    MakeEnoteFuncT &&make_enote_func,
     std::vector<MockENoteSpV1> &outputs_out,
     std::vector<rct::xmr_amount> &output_amounts_out,
     std::vector<crypto::secret_key> &output_amount_commitment_blinding_factors_out,
@@ -459,7 +579,7 @@ void make_v1_tx_outputs_sp_v1(const std::vector<MockDestinationSpV1> &destinatio
     for (std::size_t dest_index{0}; dest_index < destinations.size(); ++dest_index)
     {
         // build output set
-        outputs_out.emplace_back(destinations[dest_index].to_enote_v1(dest_index, temp_enote_pubkeys[dest_index]));
+        outputs_out.emplace_back(make_enote_func(dest_index, temp_enote_pubkeys[dest_index]));
 
         // prepare for range proofs
         output_amounts_out.emplace_back(destinations[dest_index].m_amount);
@@ -485,6 +605,46 @@ void make_v1_tx_outputs_sp_v1(const std::vector<MockDestinationSpV1> &destinatio
         tx_supplement_inout.m_output_enote_pubkeys.size() == destinations.size(), "Invalid number of enote pubkeys in destination set.");
 }
 //-------------------------------------------------------------------------------------------------------------------
+void make_v1_tx_outputs_sp_v1(const std::vector<MockDestinationSpV1> &destinations,
+    std::vector<MockENoteSpV1> &outputs_out,
+    std::vector<rct::xmr_amount> &output_amounts_out,
+    std::vector<crypto::secret_key> &output_amount_commitment_blinding_factors_out,
+    MockSupplementSpV1 &tx_supplement_inout)
+{
+    make_v1_tx_outputs_sp_v1_impl(destinations,
+        [&destinations](const std::size_t dest_index, rct::key &enote_pubkey_out) -> MockENoteSpV1
+        {
+            return destinations[dest_index].to_enote_v1(dest_index, enote_pubkey_out);
+        },
+        outputs_out,
+        output_amounts_out,
+        output_amount_commitment_blinding_factors_out,
+        tx_supplement_inout);
+}
+//-------------------------------------------------------------------------------------------------------------------
+void make_v1_tx_outputs_sp_v1(const std::vector<MockDestinationSpV1> &destinations,
+    MockRecipientPrecompCacheSpV1 &recipient_precomp_cache_inout,
+    std::vector<MockENoteSpV1> &outputs_out,
+    std::vector<rct::xmr_amount> &output_amounts_out,
+    std::vector<crypto::secret_key> &output_amount_commitment_blinding_factors_out,
+    MockSupplementSpV1 &tx_supplement_inout)
+{
+    make_v1_tx_outputs_sp_v1_impl(destinations,
+        [&destinations, &recipient_precomp_cache_inout](const std::size_t dest_index, rct::key &enote_pubkey_out)
+            -> MockENoteSpV1
+        {
+            const MockDestinationSpV1 &destination{destinations[dest_index]};
+
+            return destination.to_enote_v1(dest_index,
+                recipient_precomp_cache_inout.get_or_make(destination.m_recipient_DHkey, destination.m_recipient_viewkey),
+                enote_pubkey_out);
+        },
+        outputs_out,
+        output_amounts_out,
+        output_amount_commitment_blinding_factors_out,
+        tx_supplement_inout);
+}
+//-------------------------------------------------------------------------------------------------------------------
 void make_v1_tx_image_sp_v1(const MockInputProposalSpV1 &input_proposal,
     MockENoteImageSpV1 &input_image_out,
     crypto::secret_key &image_address_mask_out,
@@ -560,11 +720,15 @@ void make_v1_tx_images_sp_v1(const std::vector<MockInputProposalSpV1> &input_pro
 
     input_images_out.resize(input_proposals.size());
 
+    std::vector<crypto::key_image> key_images;
+    make_input_key_images_sp_v1(input_proposals, key_images);
+
     // make input images
     for (std::size_t input_index{0}; input_index < input_proposals.size(); ++input_index)
     {
         input_proposals[input_index].to_enote_image_base(image_address_masks_out[input_index],
             image_amount_masks_out[input_index],
+            key_images[input_index],
             input_images_out[input_index]);
     }
 }
@@ -586,11 +750,15 @@ void make_v1_tx_images_sp_v2(const std::vector<MockInputProposalSpV1> &input_pro
 
     input_images_out.resize(input_proposals.size());
 
+    std::vector<crypto::key_image> key_images;
+    make_input_key_images_sp_v1(input_proposals, key_images);
+
     // make input images
     for (std::size_t input_index{0}; input_index < input_proposals.size(); ++input_index)
     {
         input_proposals[input_index].to_enote_image_squashed_base(image_address_masks_out[input_index],
             image_amount_masks_out[input_index],
+            key_images[input_index],
             input_images_out[input_index]);
     }
 }
@@ -614,11 +782,15 @@ void make_v1_tx_images_sp_v3(const std::vector<MockInputProposalSpV1> &input_pro
 
     input_images_out.resize(input_proposals.size());
 
+    std::vector<crypto::key_image> key_images;
+    make_input_key_images_sp_v1(input_proposals, key_images);
+
     // make input images
     for (std::size_t input_index{0}; input_index < input_proposals.size(); ++input_index)
     {
         input_proposals[input_index].to_enote_image_base(image_address_masks_out[input_index],
             image_amount_masks_out[input_index],
+            key_images[input_index],
             input_images_out[input_index]);
     }
 }
@@ -676,7 +848,8 @@ void make_v1_tx_image_proofs_sp_v1(const std::vector<MockInputProposalSpV1> &inp
     const std::vector<MockENoteImageSpV1> &input_images,
     const std::vector<crypto::secret_key> &image_address_masks,
     const rct::key &message,
-    std::vector<MockImageProofSpV1> &tx_image_proofs_out)
+    std::vector<MockImageProofSpV1> &tx_image_proofs_out,
+    const std::size_t num_threads)
 {
     // for plain image proofs
 
@@ -686,14 +859,18 @@ void make_v1_tx_image_proofs_sp_v1(const std::vector<MockInputProposalSpV1> &inp
 
     tx_image_proofs_out.resize(input_proposals.size());
 
-    for (std::size_t input_index{0}; input_index < input_proposals.size(); ++input_index)
-    {
-        make_v1_tx_image_proof_sp_v1(input_proposals[input_index],
-            input_images[input_index],
-            image_address_masks[input_index],
-            message,
-            tx_image_proofs_out[input_index]);
-    }
+    auto prove_input =
+        [&](const std::size_t input_index)
+        {
+            make_v1_tx_image_proof_sp_v1(input_proposals[input_index],
+                input_images[input_index],
+                image_address_masks[input_index],
+                message,
+                tx_image_proofs_out[input_index]);
+        };
+
+    CHECK_AND_ASSERT_THROW_MES(run_indexed_jobs(input_proposals.size(), num_threads, prove_input),
+        "Failed to make image proofs.");
 }
 //-------------------------------------------------------------------------------------------------------------------
 void make_v1_tx_image_proofs_sp_v2(const std::vector<MockInputProposalSpV1> &input_proposals,
@@ -736,7 +913,8 @@ void make_v1_tx_image_proofs_sp_v3(const std::vector<MockInputProposalSpV1> &inp
     const std::vector<MockENoteImageSpV1> &input_images,
     const std::vector<crypto::secret_key> &image_address_masks,
     const rct::key &message,
-    std::vector<MockImageProofSpV1> &tx_image_proofs_out)
+    std::vector<MockImageProofSpV1> &tx_image_proofs_out,
+    const std::size_t num_threads)
 {
     // for squashed enote model
 
@@ -746,14 +924,18 @@ void make_v1_tx_image_proofs_sp_v3(const std::vector<MockInputProposalSpV1> &inp
 
     tx_image_proofs_out.resize(input_proposals.size());
 
-    for (std::size_t input_index{0}; input_index < input_proposals.size(); ++input_index)
-    {
-        make_v1_tx_image_proof_sp_v2(input_proposals[input_index],
-            input_images[input_index],
-            image_address_masks[input_index],
-            message,
-            tx_image_proofs_out[input_index]);
-    }
+    auto prove_input =
+        [&](const std::size_t input_index)
+        {
+            make_v1_tx_image_proof_sp_v2(input_proposals[input_index],
+                input_images[input_index],
+                image_address_masks[input_index],
+                message,
+                tx_image_proofs_out[input_index]);
+        };
+
+    CHECK_AND_ASSERT_THROW_MES(run_indexed_jobs(input_proposals.size(), num_threads, prove_input),
+        "Failed to make image proofs.");
 }
 //-------------------------------------------------------------------------------------------------------------------
 void make_v1_tx_balance_proof_sp_v1(const std::vector<rct::xmr_amount> &output_amounts,
@@ -897,8 +1079,7 @@ void make_v1_tx_membership_proof_sp_v1(const MockMembershipReferenceSetSpV1 &mem
     /// prepare to make proof
 
     // public keys referenced by proof
-    rct::keyM referenced_enotes;
-    referenced_enotes.resize(ref_set_size, rct::keyV(2));
+    rct::KeyMatrix referenced_enotes{ref_set_size, 2};
 
     for (std::size_t ref_index{0}; ref_index < ref_set_size; ++ref_index)
     {
@@ -988,8 +1169,7 @@ void make_v1_tx_membership_proof_sp_v2(const MockMembershipReferenceSetSpV1 &mem
     /// prepare to make proof
 
     // public keys referenced by proof
-    rct::keyM referenced_enotes;
-    referenced_enotes.resize(ref_set_size, rct::keyV(1));
+    rct::KeyMatrix referenced_enotes{ref_set_size, 1};
 
     for (std::size_t ref_index{0}; ref_index < ref_set_size; ++ref_index)
     {
@@ -1070,8 +1250,7 @@ void make_v2_tx_membership_proof_sp_v1(const MockMembershipReferenceSetSpV1 &mem
     /// prepare to make proof
 
     // public keys referenced by proof
-    rct::keyM referenced_enotes;
-    referenced_enotes.resize(ref_set_size, rct::keyV(2));
+    rct::KeyMatrix referenced_enotes{ref_set_size, 2};
 
     for (std::size_t ref_index{0}; ref_index < ref_set_size; ++ref_index)
     {
@@ -1113,25 +1292,31 @@ void make_v2_tx_membership_proof_sp_v1(const MockMembershipReferenceSetSpV1 &mem
 void make_v1_tx_membership_proofs_sp_v1(const std::vector<MockMembershipReferenceSetSpV1> &membership_ref_sets,
     const std::vector<crypto::secret_key> &image_address_masks,
     const std::vector<crypto::secret_key> &image_amount_masks,
-    std::vector<MockMembershipProofSortableSpV1> &tx_membership_proofs_out)
+    std::vector<MockMembershipProofSortableSpV1> &tx_membership_proofs_out,
+    const std::size_t num_threads)
 {
     CHECK_AND_ASSERT_THROW_MES(membership_ref_sets.size() == image_address_masks.size(), "Input components size mismatch");
     CHECK_AND_ASSERT_THROW_MES(membership_ref_sets.size() == image_amount_masks.size(), "Input components size mismatch");
 
     tx_membership_proofs_out.resize(membership_ref_sets.size());
 
-    for (std::size_t input_index{0}; input_index < membership_ref_sets.size(); ++input_index)
-    {
-        make_v1_tx_membership_proof_sp_v1(membership_ref_sets[input_index],
-            image_address_masks[input_index],
-            image_amount_masks[input_index],
-            tx_membership_proofs_out[input_index]);
-    }
+    auto prove_input =
+        [&](const std::size_t input_index)
+        {
+            make_v1_tx_membership_proof_sp_v1(membership_ref_sets[input_index],
+                image_address_masks[input_index],
+                image_amount_masks[input_index],
+                tx_membership_proofs_out[input_index]);
+        };
+
+    CHECK_AND_ASSERT_THROW_MES(run_indexed_jobs(membership_ref_sets.size(), num_threads, prove_input),
+        "Failed to make membership proofs.");
 }
 //-------------------------------------------------------------------------------------------------------------------
 void make_v1_tx_membership_proofs_sp_v1(const std::vector<MockMembershipReferenceSetSpV1> &membership_ref_sets,
     const std::vector<MockTxPartialInputSpV1> &partial_inputs,
-    std::vector<MockMembershipProofSortableSpV1> &tx_membership_proofs_out)
+    std::vector<MockMembershipProofSortableSpV1> &tx_membership_proofs_out,
+    const std::size_t num_threads)
 {
     CHECK_AND_ASSERT_THROW_MES(membership_ref_sets.size() == partial_inputs.size(), "Input components size mismatch");
 
@@ -1143,17 +1328,25 @@ void make_v1_tx_membership_proofs_sp_v1(const std::vector<MockMembershipReferenc
                 m_referenced_enotes[membership_ref_sets[input_index].m_real_spend_index_in_set].m_onetime_address ==
             partial_inputs[input_index].m_input_enote.m_onetime_address, 
             "Membership ref set real spend doesn't match partial input's enote.");
-
-        make_v1_tx_membership_proof_sp_v1(membership_ref_sets[input_index],
-            partial_inputs[input_index].m_image_address_mask,
-            partial_inputs[input_index].m_image_amount_mask,
-            tx_membership_proofs_out[input_index]);
     }
+
+    auto prove_input =
+        [&](const std::size_t input_index)
+        {
+            make_v1_tx_membership_proof_sp_v1(membership_ref_sets[input_index],
+                partial_inputs[input_index].m_image_address_mask,
+                partial_inputs[input_index].m_image_amount_mask,
+                tx_membership_proofs_out[input_index]);
+        };
+
+    CHECK_AND_ASSERT_THROW_MES(run_indexed_jobs(membership_ref_sets.size(), num_threads, prove_input),
+        "Failed to make membership proofs.");
 }
 //-------------------------------------------------------------------------------------------------------------------
 void make_v1_tx_membership_proofs_sp_v1(const std::vector<MockMembershipReferenceSetSpV1> &membership_ref_sets,
     const MockTxPartialSpV1 &partial_tx,
-    std::vector<MockMembershipProofSpV1> &tx_membership_proofs_out)
+    std::vector<MockMembershipProofSpV1> &tx_membership_proofs_out,
+    const std::size_t num_threads)
 {
     // note: ref sets are assumed to be pre-sorted, so sortable membership proofs are not needed
     CHECK_AND_ASSERT_THROW_MES(membership_ref_sets.size() == partial_tx.m_image_address_masks.size(),
@@ -1163,19 +1356,24 @@ void make_v1_tx_membership_proofs_sp_v1(const std::vector<MockMembershipReferenc
 
     tx_membership_proofs_out.resize(membership_ref_sets.size());
 
-    for (std::size_t input_index{0}; input_index < membership_ref_sets.size(); ++input_index)
-    {
-        make_v1_tx_membership_proof_sp_v1(membership_ref_sets[input_index],
-            partial_tx.m_image_address_masks[input_index],
-            partial_tx.m_image_amount_masks[input_index],
-            tx_membership_proofs_out[input_index]);
-    }
+    auto prove_input =
+        [&](const std::size_t input_index)
+        {
+            make_v1_tx_membership_proof_sp_v1(membership_ref_sets[input_index],
+                partial_tx.m_image_address_masks[input_index],
+                partial_tx.m_image_amount_masks[input_index],
+                tx_membership_proofs_out[input_index]);
+        };
+
+    CHECK_AND_ASSERT_THROW_MES(run_indexed_jobs(membership_ref_sets.size(), num_threads, prove_input),
+        "Failed to make membership proofs.");
 }
 //-------------------------------------------------------------------------------------------------------------------
 void make_v1_tx_membership_proofs_sp_v2(const std::vector<MockMembershipReferenceSetSpV1> &membership_ref_sets,
     const std::vector<crypto::secret_key> &image_address_masks,
     const std::vector<crypto::secret_key> &image_amount_masks,
-    std::vector<MockMembershipProofSortableSpV1> &tx_membership_proofs_out)
+    std::vector<MockMembershipProofSortableSpV1> &tx_membership_proofs_out,
+    const std::size_t num_threads)
 {
     // for squashed enote model
 
@@ -1184,18 +1382,23 @@ void make_v1_tx_membership_proofs_sp_v2(const std::vector<MockMembershipReferenc
 
     tx_membership_proofs_out.resize(membership_ref_sets.size());
 
-    for (std::size_t input_index{0}; input_index < membership_ref_sets.size(); ++input_index)
-    {
-        make_v1_tx_membership_proof_sp_v2(membership_ref_sets[input_index],
-            image_address_masks[input_index],
-            image_amount_masks[input_index],
-            tx_membership_proofs_out[input_index]);
-    }
+    auto prove_input =
+        [&](const std::size_t input_index)
+        {
+            make_v1_tx_membership_proof_sp_v2(membership_ref_sets[input_index],
+                image_address_masks[input_index],
+                image_amount_masks[input_index],
+                tx_membership_proofs_out[input_index]);
+        };
+
+    CHECK_AND_ASSERT_THROW_MES(run_indexed_jobs(membership_ref_sets.size(), num_threads, prove_input),
+        "Failed to make membership proofs.");
 }
 //-------------------------------------------------------------------------------------------------------------------
 void make_v2_tx_membership_proofs_sp_v1(const std::vector<MockMembershipReferenceSetSpV1> &membership_ref_sets,
     const std::vector<MockTxPartialInputSpV1> &partial_inputs,
-    std::vector<MockMembershipProofSortableSpV2> &tx_membership_proofs_out)
+    std::vector<MockMembershipProofSortableSpV2> &tx_membership_proofs_out,
+    const std::size_t num_threads)
 {
     CHECK_AND_ASSERT_THROW_MES(membership_ref_sets.size() == partial_inputs.size(), "Input components size mismatch");
 
@@ -1207,27 +1410,41 @@ void make_v2_tx_membership_proofs_sp_v1(const std::vector<MockMembershipReferenc
                 m_referenced_enotes[membership_ref_sets[input_index].m_real_spend_index_in_set].m_onetime_address ==
             partial_inputs[input_index].m_input_enote.m_onetime_address, 
             "Membership ref set real spend doesn't match partial input's enote.");
-
-        make_v2_tx_membership_proof_sp_v1(membership_ref_sets[input_index],
-            partial_inputs[input_index].m_image_address_mask,
-            partial_inputs[input_index].m_image_amount_mask,
-            tx_membership_proofs_out[input_index]);
     }
+
+    auto prove_input =
+        [&](const std::size_t input_index)
+        {
+            make_v2_tx_membership_proof_sp_v1(membership_ref_sets[input_index],
+                partial_inputs[input_index].m_image_address_mask,
+                partial_inputs[input_index].m_image_amount_mask,
+                tx_membership_proofs_out[input_index]);
+        };
+
+    CHECK_AND_ASSERT_THROW_MES(run_indexed_jobs(membership_ref_sets.size(), num_threads, prove_input),
+        "Failed to make membership proofs.");
 }
 //-------------------------------------------------------------------------------------------------------------------
 void make_v1_tx_partial_inputs_sp_v1(const std::vector<MockInputProposalSpV1> &input_proposals,
     const rct::key &proposal_prefix,
     const MockTxProposalSpV1 &tx_proposal,
-    std::vector<MockTxPartialInputSpV1> &partial_inputs_out)
+    std::vector<MockTxPartialInputSpV1> &partial_inputs_out,
+    const std::size_t num_threads)
 {
     CHECK_AND_ASSERT_THROW_MES(input_proposals.size() > 0, "Can't make partial tx inputs without any input proposals");
 
     partial_inputs_out.clear();
-    partial_inputs_out.reserve(input_proposals.size());
+    partial_inputs_out.resize(input_proposals.size());
 
-    // make all inputs
-    for (std::size_t input_index{0}; input_index < input_proposals.size(); ++input_index)
-        partial_inputs_out.emplace_back(input_proposals[input_index], proposal_prefix);
+    // make all inputs (each partial input makes its own image proof)
+    auto make_input =
+        [&](const std::size_t input_index)
+        {
+            partial_inputs_out[input_index] = MockTxPartialInputSpV1{input_proposals[input_index], proposal_prefix};
+        };
+
+    CHECK_AND_ASSERT_THROW_MES(run_indexed_jobs(input_proposals.size(), num_threads, make_input),
+        "Failed to make partial inputs.");
 }
 //-------------------------------------------------------------------------------------------------------------------
 bool balance_check_in_out_amnts_sp_v1(const std::vector<MockInputProposalSpV1> &input_proposals,
@@ -1271,7 +1488,8 @@ std::vector<MockMembershipReferenceSetSpV1> gen_mock_sp_membership_ref_sets_v1(
     const std::vector<MockInputProposalSpV1> &input_proposals,
     const std::size_t ref_set_decomp_n,
     const std::size_t ref_set_decomp_m,
-    std::shared_ptr<MockLedgerContext> ledger_context_inout)
+    std::shared_ptr<LedgerContext> ledger_context_inout,
+    const std::size_t num_threads)
 {
     std::vector<MockENoteSpV1> input_enotes;
     input_enotes.reserve(input_proposals.size());
@@ -1281,47 +1499,114 @@ std::vector<MockMembershipReferenceSetSpV1> gen_mock_sp_membership_ref_sets_v1(
         input_enotes.emplace_back(input_proposal.m_enote);
     }
 
-    return gen_mock_sp_membership_ref_sets_v1(input_enotes, ref_set_decomp_n, ref_set_decomp_m, ledger_context_inout);
+    return gen_mock_sp_membership_ref_sets_v1(input_enotes,
+        ref_set_decomp_n,
+        ref_set_decomp_m,
+        ledger_context_inout,
+        num_threads);
 }
 //-------------------------------------------------------------------------------------------------------------------
 std::vector<MockMembershipReferenceSetSpV1> gen_mock_sp_membership_ref_sets_v1(
     const std::vector<MockENoteSpV1> &input_enotes,
     const std::size_t ref_set_decomp_n,
     const std::size_t ref_set_decomp_m,
-    std::shared_ptr<MockLedgerContext> ledger_context_inout)
+    std::shared_ptr<LedgerContext> ledger_context_inout,
+    const std::size_t num_threads)
 {
+    MOCK_TX_PHASE_TIMER(REF_SET_BUILD);
+
     std::vector<MockMembershipReferenceSetSpV1> reference_sets;
-    reference_sets.resize(input_enotes.size());
+    gen_mock_sp_membership_ref_set_members(input_enotes,
+        ref_set_decomp_n,
+        ref_set_decomp_m,
+        num_threads,
+        reference_sets);
 
-    std::size_t ref_set_size{ref_set_size_from_decomp(ref_set_decomp_n, ref_set_decomp_m)};  // n^m
+    // insert all referenced enotes into mock ledger in one step
+    // note: in a real context, you would instead 'get' the enotes' indices from the ledger, and error if not found
+    std::vector<MockENoteSpV1> ledger_enotes;
 
-    for (std::size_t input_index{0}; input_index < input_enotes.size(); ++input_index)
+    for (const MockMembershipReferenceSetSpV1 &reference_set : reference_sets)
     {
-        reference_sets[input_index].m_ref_set_decomp_n = ref_set_decomp_n;
-        reference_sets[input_index].m_ref_set_decomp_m = ref_set_decomp_m;
-        reference_sets[input_index].m_real_spend_index_in_set = crypto::rand_idx(ref_set_size);  // pi
+        ledger_enotes.insert(ledger_enotes.end(),
+            reference_set.m_referenced_enotes.begin(),
+            reference_set.m_referenced_enotes.end());
+    }
 
-        reference_sets[input_index].m_ledger_enote_indices.resize(ref_set_size);
-        reference_sets[input_index].m_referenced_enotes.resize(ref_set_size);
+    std::size_t ledger_index{ledger_context_inout->add_enotes_sp_v1(ledger_enotes)};
 
-        for (std::size_t ref_index{0}; ref_index < ref_set_size; ++ref_index)
-        {
-            // add real input at pi
-            if (ref_index == reference_sets[input_index].m_real_spend_index_in_set)
-            {
-                reference_sets[input_index].m_referenced_enotes[ref_index] = input_enotes[input_index];
-            }
-            // add dummy enote
-            else
-            {
-                reference_sets[input_index].m_referenced_enotes[ref_index].gen();
-            }
+    for (MockMembershipReferenceSetSpV1 &reference_set : reference_sets)
+    {
+        for (std::size_t &ledger_enote_index : reference_set.m_ledger_enote_indices)
+            ledger_enote_index = ledger_index++;
+    }
 
-            // insert referenced enote into mock ledger
-            // note: in a real context, you would instead 'get' the enote's index from the ledger, and error if not found
-            reference_sets[input_index].m_ledger_enote_indices[ref_index] =
-                ledger_context_inout->add_enote_sp_v1(reference_sets[input_index].m_referenced_enotes[ref_index]);
-        }
+    return reference_sets;
+}
+//-------------------------------------------------------------------------------------------------------------------
+std::vector<MockMembershipReferenceSetSpV1> gen_mock_sp_membership_shared_ref_sets_v1(
+    const std::vector<MockENoteSpV1> &input_enotes,
+    const std::size_t ref_set_decomp_n,
+    const std::size_t ref_set_decomp_m,
+    std::shared_ptr<LedgerContext> ledger_context_inout,
+    const std::size_t num_threads)
+{
+    MOCK_TX_PHASE_TIMER(REF_SET_BUILD);
+
+    const std::size_t ref_set_size{ref_set_size_from_decomp(ref_set_decomp_n, ref_set_decomp_m)};  // n^m
+    CHECK_AND_ASSERT_THROW_MES(input_enotes.size() <= ref_set_size,
+        "Shared reference set is too small for the number of inputs.");
+
+    // real spends: a distinct random index for each input
+    std::vector<std::size_t> real_spend_indices;
+    std::vector<const MockENoteSpV1*> real_enotes(ref_set_size, nullptr);
+    real_spend_indices.reserve(input_enotes.size());
+
+    for (const MockENoteSpV1 &input_enote : input_enotes)
+    {
+        std::size_t real_spend_index{crypto::rand_idx(ref_set_size)};
+        while (real_enotes[real_spend_index] != nullptr)
+            real_spend_index = crypto::rand_idx(ref_set_size);
+
+        real_spend_indices.push_back(real_spend_index);
+        real_enotes[real_spend_index] = &input_enote;
+    }
+
+    // shared members: real inputs at their indices, dummy enotes elsewhere
+    std::vector<MockENoteSpV1> shared_enotes;
+    shared_enotes.resize(ref_set_size);
+
+    CHECK_AND_ASSERT_THROW_MES(run_indexed_jobs(ref_set_size, num_threads,
+                [&](const std::size_t ref_index)
+                {
+                    if (real_enotes[ref_index] != nullptr)
+                        shared_enotes[ref_index] = *(real_enotes[ref_index]);
+                    else
+                        shared_enotes[ref_index].gen();
+                }
+            ),
+        "Failed to make reference set members.");
+
+    // insert the shared members into mock ledger in one step
+    // note: in a real context, you would instead 'get' the enotes' indices from the ledger, and error if not found
+    const std::size_t first_ledger_index{ledger_context_inout->add_enotes_sp_v1(shared_enotes)};
+
+    std::vector<std::size_t> shared_ledger_indices;
+    shared_ledger_indices.resize(ref_set_size);
+    for (std::size_t ref_index{0}; ref_index < ref_set_size; ++ref_index)
+        shared_ledger_indices[ref_index] = first_ledger_index + ref_index;
+
+    // one ref set per input, all referencing the shared members
+    std::vector<MockMembershipReferenceSetSpV1> reference_sets;
+    reference_sets.resize(input_enotes.size());
+
+    for (std::size_t input_index{0}; input_index < input_enotes.size(); ++input_index)
+    {
+        reference_sets[input_index].m_ref_set_decomp_n = ref_set_decomp_n;
+        reference_sets[input_index].m_ref_set_decomp_m = ref_set_decomp_m;
+        reference_sets[input_index].m_ledger_enote_indices = shared_ledger_indices;
+        reference_sets[input_index].m_referenced_enotes = shared_enotes;
+        reference_sets[input_index].m_real_spend_index_in_set = real_spend_indices[input_index];
     }
 
     return reference_sets;
@@ -1331,7 +1616,9 @@ std::vector<MockMembershipReferenceSetSpV1> gen_mock_sp_membership_ref_sets_v2(
     const std::vector<MockInputProposalSpV1> &input_proposals,
     const std::size_t ref_set_decomp_n,
     const std::size_t ref_set_decomp_m,
-    std::shared_ptr<MockLedgerContext> ledger_context_inout)
+    std::shared_ptr<LedgerContext> ledger_context_inout,
+    const std::size_t ref_set_bin_size,
+    const std::size_t num_threads)
 {
     // for squashed enote model
 
@@ -1343,51 +1630,112 @@ std::vector<MockMembershipReferenceSetSpV1> gen_mock_sp_membership_ref_sets_v2(
         input_enotes.emplace_back(input_proposal.m_enote);
     }
 
-    return gen_mock_sp_membership_ref_sets_v2(input_enotes, ref_set_decomp_n, ref_set_decomp_m, ledger_context_inout);
+    return gen_mock_sp_membership_ref_sets_v2(input_enotes,
+        ref_set_decomp_n,
+        ref_set_decomp_m,
+        ledger_context_inout,
+        ref_set_bin_size,
+        num_threads);
 }
 //-------------------------------------------------------------------------------------------------------------------
 std::vector<MockMembershipReferenceSetSpV1> gen_mock_sp_membership_ref_sets_v2(
     const std::vector<MockENoteSpV1> &input_enotes,
     const std::size_t ref_set_decomp_n,
     const std::size_t ref_set_decomp_m,
-    std::shared_ptr<MockLedgerContext> ledger_context_inout)
+    std::shared_ptr<LedgerContext> ledger_context_inout,
+    const std::size_t ref_set_bin_size,
+    const std::size_t num_threads)
 {
+    MOCK_TX_PHASE_TIMER(REF_SET_BUILD);
+
     // for squashed enote model
 
     std::vector<MockMembershipReferenceSetSpV1> reference_sets;
-    reference_sets.resize(input_enotes.size());
+    gen_mock_sp_membership_ref_set_members(input_enotes,
+        ref_set_decomp_n,
+        ref_set_decomp_m,
+        num_threads,
+        reference_sets);
 
-    std::size_t ref_set_size{ref_set_size_from_decomp(ref_set_decomp_n, ref_set_decomp_m)};  // n^m
+    // filler enote for the gaps between bins (not referenced by any ref set)
+    MockENoteSpV1 filler_enote;
+    if (ref_set_bin_size > 0)
+        filler_enote.gen();
 
-    for (std::size_t input_index{0}; input_index < input_enotes.size(); ++input_index)
-    {
-        reference_sets[input_index].m_ref_set_decomp_n = ref_set_decomp_n;
-        reference_sets[input_index].m_ref_set_decomp_m = ref_set_decomp_m;
-        reference_sets[input_index].m_real_spend_index_in_set = crypto::rand_idx(ref_set_size);  // pi
-
-        reference_sets[input_index].m_ledger_enote_indices.resize(ref_set_size);
-        reference_sets[input_index].m_referenced_enotes.resize(ref_set_size);
+    // lay out the referenced enotes (and filler enotes) to insert into mock ledger, and where each one lands
+    std::vector<MockENoteSpV1> ledger_enotes;
 
-        for (std::size_t ref_index{0}; ref_index < ref_set_size; ++ref_index)
+    for (MockMembershipReferenceSetSpV1 &reference_set : reference_sets)
+    {
+        for (std::size_t ref_index{0}; ref_index < reference_set.m_referenced_enotes.size(); ++ref_index)
         {
-            // add real input at pi
-            if (ref_index == reference_sets[input_index].m_real_spend_index_in_set)
+            // start a new bin: skip past a random number of filler enotes
+            if (ref_set_bin_size > 0 &&
+                ref_index > 0 &&
+                ref_index % ref_set_bin_size == 0)
             {
-                reference_sets[input_index].m_referenced_enotes[ref_index] = input_enotes[input_index];
-            }
-            // add dummy enote
-            else
-            {
-                reference_sets[input_index].m_referenced_enotes[ref_index].gen();
+                ledger_enotes.insert(ledger_enotes.end(), crypto::rand_idx(ref_set_bin_size) + 1, filler_enote);
             }
 
-            // insert referenced enote into mock ledger (also, record squashed enote)
-            // note: in a real context, you would instead 'get' the enote's index from the ledger, and error if not found
-            reference_sets[input_index].m_ledger_enote_indices[ref_index] =
-                ledger_context_inout->add_enote_sp_v2(reference_sets[input_index].m_referenced_enotes[ref_index]);
+            // note: offset from the first index added (fixed up below)
+            reference_set.m_ledger_enote_indices[ref_index] = ledger_enotes.size();
+            ledger_enotes.emplace_back(reference_set.m_referenced_enotes[ref_index]);
         }
     }
 
+    // insert them into mock ledger in one step (also, record squashed enotes)
+    // note: in a real context, you would instead 'get' the enotes' indices from the ledger, and error if not found
+    const std::size_t first_ledger_index{ledger_context_inout->add_enotes_sp_v2(ledger_enotes, num_threads)};
+
+    for (MockMembershipReferenceSetSpV1 &reference_set : reference_sets)
+    {
+        for (std::size_t &ledger_enote_index : reference_set.m_ledger_enote_indices)
+            ledger_enote_index += first_ledger_index;
+    }
+
+    return reference_sets;
+}
+//-------------------------------------------------------------------------------------------------------------------
+std::vector<MockMembershipReferenceSetSpV1> gen_mock_sp_membership_ref_sets_v2_gamma(
+    const std::vector<MockENoteSpV1> &input_enotes,
+    const std::size_t ref_set_decomp_n,
+    const std::size_t ref_set_decomp_m,
+    const std::size_t num_decoy_ledger_enotes,
+    std::shared_ptr<LedgerContext> ledger_context_inout)
+{
+    MOCK_TX_PHASE_TIMER(REF_SET_BUILD);
+
+    // for squashed enote model
+
+    const std::size_t ref_set_size{ref_set_size_from_decomp(ref_set_decomp_n, ref_set_decomp_m)};  // n^m
+    CHECK_AND_ASSERT_THROW_MES(ref_set_size > 0, "Tried to make empty reference sets.");
+
+    MockGammaDecoySelector decoy_selector{num_decoy_ledger_enotes};
+
+    // insert the real spends into mock ledger (also, record squashed enotes)
+    // note: in a real context, the real spends would already be somewhere in the ledger
+    const std::size_t first_real_ledger_index{ledger_context_inout->add_enotes_sp_v2(input_enotes, 1)};
+    CHECK_AND_ASSERT_THROW_MES(first_real_ledger_index >= num_decoy_ledger_enotes,
+        "Mock ledger has fewer enotes than the decoy selector's simulated chain.");
+
+    std::vector<MockMembershipReferenceSetSpV1> reference_sets;
+    reference_sets.resize(input_enotes.size());
+
+    for (std::size_t input_index{0}; input_index < input_enotes.size(); ++input_index)
+    {
+        MockMembershipReferenceSetSpV1 &reference_set{reference_sets[input_index]};
+        reference_set.m_ref_set_decomp_n = ref_set_decomp_n;
+        reference_set.m_ref_set_decomp_m = ref_set_decomp_m;
+
+        // decoys (sorted), then the real spend (newest)
+        decoy_selector.pick_distinct(ref_set_size - 1, reference_set.m_ledger_enote_indices);
+        reference_set.m_ledger_enote_indices.push_back(first_real_ledger_index + input_index);
+        reference_set.m_real_spend_index_in_set = ref_set_size - 1;  // pi
+
+        ledger_context_inout->get_reference_set_sp_v1(reference_set.m_ledger_enote_indices,
+            reference_set.m_referenced_enotes);
+    }
+
     return reference_sets;
 }
 //-------------------------------------------------------------------------------------------------------------------
@@ -38,6 +38,7 @@
 #include "mock_sp_transaction_builder_types.h"
 #include "mock_sp_transaction_component_types.h"
 #include "ringct/rctTypes.h"
+#include "span.h"
 
 //third party headers
 
@@ -61,6 +62,14 @@ namespace mock_tx
 */
 rct::key get_tx_membership_proof_message_sp_v1(const std::vector<std::size_t> &enote_ledger_indices);
 /**
+* brief: get_tx_membership_proof_messages_sp_v1 - messages for a batch of membership proofs
+*   - same as get_tx_membership_proof_message_sp_v1() on each proof's indices, but the messages are hashed together
+* param - enote_ledger_indices - (per-proof) enote ledger indices
+* outparam: messages_out - one message per proof
+*/
+void get_tx_membership_proof_messages_sp_v1(const std::vector<const std::vector<std::size_t>*> &enote_ledger_indices,
+    rct::keyV &messages_out);
+/**
 * brief: get_tx_image_proof_message_sp_v1 - message for tx image proofs
 *   - H(crypto project name, version string, output enotes, enote pubkeys)
 * param: version_string -
@@ -71,6 +80,19 @@ rct::key get_tx_membership_proof_message_sp_v1(const std::vector<std::size_t> &e
 rct::key get_tx_image_proof_message_sp_v1(const std::string &version_string,
     const std::vector<MockENoteSpV1> &output_enotes,
     const MockSupplementSpV1 &tx_supplement);
+rct::key get_tx_image_proof_message_sp_v1(const std::string &version_string,
+    const epee::span<const MockENoteSpV1View> output_enotes,
+    const MockSupplementSpV1 &tx_supplement);
+/**
+* brief: make_squashed_enotes_sp_v1 - make the squashed enotes of a set of enotes in one batch
+*   (see seraphis_squashed_enotes_Q())
+* param: enotes -
+* outparam: squashed_enotes_out - {Q}
+* param: num_threads - max number of threads (0 = threadpool max concurrency; 1 = serial)
+*/
+void make_squashed_enotes_sp_v1(const std::vector<MockENoteSpV1> &enotes,
+    rct::keyV &squashed_enotes_out,
+    const std::size_t num_threads = 1);
 /**
 * brief: sort_tx_inputs_sp_v1 - sort tx inputs
 *   sort order: key images ascending with byte-wise comparisons
@@ -149,6 +171,22 @@ void make_v1_tx_outputs_sp_v1(const std::vector<MockDestinationSpV1> &destinatio
     std::vector<crypto::secret_key> &output_amount_commitment_blinding_factors_out,
     MockSupplementSpV1 &tx_supplement_inout);
 /**
+* brief: make_v1_tx_outputs_sp_v1 - make v1 tx outputs with the sender's precomputed recipient tables
+*   - repeat recipients cost fixed-base mults instead of variable-base scalarmults against K^{DH} and K^{vr}
+* param: destinations -
+* inoutparam: recipient_precomp_cache_inout - tables for each recipient (new recipients are added)
+* outparam: outputs_out -
+* outparam: output_amounts_out -
+* outparam: output_amount_commitment_blinding_factors_out -
+* inoutparam: tx_supplement_inout -
+*/
+void make_v1_tx_outputs_sp_v1(const std::vector<MockDestinationSpV1> &destinations,
+    MockRecipientPrecompCacheSpV1 &recipient_precomp_cache_inout,
+    std::vector<MockENoteSpV1> &outputs_out,
+    std::vector<rct::xmr_amount> &output_amounts_out,
+    std::vector<crypto::secret_key> &output_amount_commitment_blinding_factors_out,
+    MockSupplementSpV1 &tx_supplement_inout);
+/**
 * brief: make_v1_tx_image_sp_v1 - make all v1 input images for a tx EXCEPT LAST
 * param: input_proposal -
 * outparam: input_image_out -
@@ -273,12 +311,14 @@ void make_v1_tx_image_proof_sp_v2(const MockInputProposalSpV1 &input_proposal,
 * param: image_address_masks -
 * param: message -
 * outparam: tx_image_proofs_out -
+* param: num_threads - max number of threads for proving independent inputs (0 = threadpool max concurrency; 1 = serial)
 */
 void make_v1_tx_image_proofs_sp_v1(const std::vector<MockInputProposalSpV1> &input_proposals,
     const std::vector<MockENoteImageSpV1> &input_images,
     const std::vector<crypto::secret_key> &image_address_masks,
     const rct::key &message,
-    std::vector<MockImageProofSpV1> &tx_image_proofs_out);
+    std::vector<MockImageProofSpV1> &tx_image_proofs_out,
+    const std::size_t num_threads = 1);
 /**
 * brief: make_v1_tx_image_proofs_sp_v2 - make v1 tx input image proof with merged seraphis composition proof for all inputs
 *   note: all inputs must be 'owned' by same signer, since all input image proof privkeys must be known to make a proof
@@ -301,12 +341,14 @@ void make_v1_tx_image_proofs_sp_v2(const std::vector<MockInputProposalSpV1> &inp
 * param: image_address_masks -
 * param: message -
 * outparam: tx_image_proofs_out -
+* param: num_threads - max number of threads for proving independent inputs (0 = threadpool max concurrency; 1 = serial)
 */
 void make_v1_tx_image_proofs_sp_v3(const std::vector<MockInputProposalSpV1> &input_proposals,
     const std::vector<MockENoteImageSpV1> &input_images,
     const std::vector<crypto::secret_key> &image_address_masks,
     const rct::key &message,
-    std::vector<MockImageProofSpV1> &tx_image_proofs_out);
+    std::vector<MockImageProofSpV1> &tx_image_proofs_out,
+    const std::size_t num_threads = 1);
 /**
 * brief: make_v1_tx_balance_proof_sp_v1 - make v1 tx balance proof (BP+ for range proofs; balance is implicit)
 * param: output_amounts -
@@ -392,17 +434,21 @@ void make_v2_tx_membership_proof_sp_v1(const MockMembershipReferenceSetSpV1 &mem
 * param: image_address_masks -
 * param: image_amount_masks -
 * outparam: tx_membership_proofs_out -
+* param: num_threads - max number of threads for proving independent inputs (0 = threadpool max concurrency; 1 = serial)
 */
 void make_v1_tx_membership_proofs_sp_v1(const std::vector<MockMembershipReferenceSetSpV1> &membership_ref_sets,
     const std::vector<crypto::secret_key> &image_address_masks,
     const std::vector<crypto::secret_key> &image_amount_masks,
-    std::vector<MockMembershipProofSortableSpV1> &tx_membership_proofs_out);
+    std::vector<MockMembershipProofSortableSpV1> &tx_membership_proofs_out,
+    const std::size_t num_threads = 1);
 void make_v1_tx_membership_proofs_sp_v1(const std::vector<MockMembershipReferenceSetSpV1> &membership_ref_sets,
     const std::vector<MockTxPartialInputSpV1> &partial_inputs,
-    std::vector<MockMembershipProofSortableSpV1> &tx_membership_proofs_out);
+    std::vector<MockMembershipProofSortableSpV1> &tx_membership_proofs_out,
+    const std::size_t num_threads = 1);
 void make_v1_tx_membership_proofs_sp_v1(const std::vector<MockMembershipReferenceSetSpV1> &membership_ref_sets,
     const MockTxPartialSpV1 &partial_tx,
-    std::vector<MockMembershipProofSpV1> &tx_membership_proofs_out);
+    std::vector<MockMembershipProofSpV1> &tx_membership_proofs_out,
+    const std::size_t num_threads = 1);
 /**
 * brief: make_v1_tx_membership_proofs_sp_v2 - make v1 membership proofs (concise grootle: 1 per input)
 *   (squashed enote model)
@@ -410,26 +456,31 @@ void make_v1_tx_membership_proofs_sp_v1(const std::vector<MockMembershipReferenc
 * param: image_address_masks -
 * param: image_amount_masks -
 * outparam: tx_membership_proofs_out -
+* param: num_threads - max number of threads for proving independent inputs (0 = threadpool max concurrency; 1 = serial)
 */
 void make_v1_tx_membership_proofs_sp_v2(const std::vector<MockMembershipReferenceSetSpV1> &membership_ref_sets,
     const std::vector<crypto::secret_key> &image_address_masks,
     const std::vector<crypto::secret_key> &image_amount_masks,
-    std::vector<MockMembershipProofSortableSpV1> &tx_membership_proofs_out);
+    std::vector<MockMembershipProofSortableSpV1> &tx_membership_proofs_out,
+    const std::size_t num_threads = 1);
 //todo
 void make_v2_tx_membership_proofs_sp_v1(const std::vector<MockMembershipReferenceSetSpV1> &membership_ref_sets,
     const std::vector<MockTxPartialInputSpV1> &partial_inputs,
-    std::vector<MockMembershipProofSortableSpV2> &tx_membership_proofs_out);
+    std::vector<MockMembershipProofSortableSpV2> &tx_membership_proofs_out,
+    const std::size_t num_threads = 1);
 /**
 * brief: make_v1_tx_partial_inputs_sp_v1 - make a full set of v1 partial inputs
 * param: input_proposals -
 * param: proposal_prefix -
 * param: tx_proposal -
 * outparam: partial_inputs_out -
+* param: num_threads - max number of threads for making independent inputs (each makes its image proof) (0 = threadpool max concurrency; 1 = serial)
 */
 void make_v1_tx_partial_inputs_sp_v1(const std::vector<MockInputProposalSpV1> &input_proposals,
     const rct::key &proposal_prefix,
     const MockTxProposalSpV1 &tx_proposal,
-    std::vector<MockTxPartialInputSpV1> &partial_inputs_out);
+    std::vector<MockTxPartialInputSpV1> &partial_inputs_out,
+    const std::size_t num_threads = 1);
 /**
 * brief: balance_check_in_out_amnts_sp_v1 - wrapper on balance_check_in_out_amnts()
 * param: input_proposals -
@@ -449,41 +500,91 @@ std::vector<MockInputProposalSpV1> gen_mock_sp_input_proposals_v1(const std::vec
 /**
 * brief: gen_mock_sp_membership_ref_sets_v1 - create random reference sets for tx inputs, with real spend at a random index,
 *   and update mock ledger to include all members of the reference set
+*   - dummy enotes are made in parallel, then all members are added to the ledger in one step
 * param: input_proposals -
 * param: ref_set_decomp_n -
 * param: ref_set_decomp_m -
 * inoutparam: ledger_context_inout -
+* param: num_threads - max number of threads for making dummy enotes (0 = threadpool max concurrency; 1 = serial)
 * return: set of membership proof reference sets
 */
 std::vector<MockMembershipReferenceSetSpV1> gen_mock_sp_membership_ref_sets_v1(
     const std::vector<MockInputProposalSpV1> &input_proposals,
     const std::size_t ref_set_decomp_n,
     const std::size_t ref_set_decomp_m,
-    std::shared_ptr<MockLedgerContext> ledger_context_inout);
+    std::shared_ptr<LedgerContext> ledger_context_inout,
+    const std::size_t num_threads = 1);
 std::vector<MockMembershipReferenceSetSpV1> gen_mock_sp_membership_ref_sets_v1(
     const std::vector<MockENoteSpV1> &input_enotes,
     const std::size_t ref_set_decomp_n,
     const std::size_t ref_set_decomp_m,
-    std::shared_ptr<MockLedgerContext> ledger_context_inout);
+    std::shared_ptr<LedgerContext> ledger_context_inout,
+    const std::size_t num_threads = 1);
+/**
+* brief: gen_mock_sp_membership_shared_ref_sets_v1 - create one random reference set shared by all tx inputs, with each
+*   input's real spend at its own random index, and update mock ledger to include all members of the reference set
+*   - every returned ref set has the same ledger indices and enotes, so verifiers can evaluate the ref set's part of
+*     the membership proofs once for the whole tx
+* param: input_enotes -
+* param: ref_set_decomp_n -
+* param: ref_set_decomp_m -
+* inoutparam: ledger_context_inout -
+* param: num_threads - max number of threads for making dummy enotes (0 = threadpool max concurrency; 1 = serial)
+* return: set of membership proof reference sets (one per input)
+*/
+std::vector<MockMembershipReferenceSetSpV1> gen_mock_sp_membership_shared_ref_sets_v1(
+    const std::vector<MockENoteSpV1> &input_enotes,
+    const std::size_t ref_set_decomp_n,
+    const std::size_t ref_set_decomp_m,
+    std::shared_ptr<LedgerContext> ledger_context_inout,
+    const std::size_t num_threads = 1);
 /**
 * brief: gen_mock_sp_membership_ref_sets_v2 - create random reference sets for tx inputs, with real spend at a random index,
 *   and update mock ledger to include all members of the reference set (including squashed enotes)
+*   - binned: each ref set is made of bins of 'ref_set_bin_size' consecutive ledger enotes, with a random gap of
+*     1 to 'ref_set_bin_size' filler enotes between bins (like the clustered runs a binned decoy selector produces)
+*   - dummy enotes are made and squashed in parallel, then all members are added to the ledger in one step
 * param: input_proposals -
 * param: ref_set_decomp_n -
 * param: ref_set_decomp_m -
 * inoutparam: ledger_context_inout -
+* param: ref_set_bin_size - number of enotes per bin (0 = each ref set is one run of consecutive ledger enotes)
+* param: num_threads - max number of threads for making dummy enotes (0 = threadpool max concurrency; 1 = serial)
 * return: set of membership proof reference sets
 */
 std::vector<MockMembershipReferenceSetSpV1> gen_mock_sp_membership_ref_sets_v2(
     const std::vector<MockInputProposalSpV1> &input_proposals,
     const std::size_t ref_set_decomp_n,
     const std::size_t ref_set_decomp_m,
-    std::shared_ptr<MockLedgerContext> ledger_context_inout);
+    std::shared_ptr<LedgerContext> ledger_context_inout,
+    const std::size_t ref_set_bin_size = 0,
+    const std::size_t num_threads = 1);
 std::vector<MockMembershipReferenceSetSpV1> gen_mock_sp_membership_ref_sets_v2(
     const std::vector<MockENoteSpV1> &input_enotes,
     const std::size_t ref_set_decomp_n,
     const std::size_t ref_set_decomp_m,
-    std::shared_ptr<MockLedgerContext> ledger_context_inout);
+    std::shared_ptr<LedgerContext> ledger_context_inout,
+    const std::size_t ref_set_bin_size = 0,
+    const std::size_t num_threads = 1);
+/**
+* brief: gen_mock_sp_membership_ref_sets_v2_gamma - create reference sets for tx inputs whose decoys are picked from
+*   enotes already in the mock ledger with wallet2's gamma distribution (see MockGammaDecoySelector)
+*   - decoys come from the first 'num_decoy_ledger_enotes' ledger enotes, treated as a simulated chain
+*   - the real spends are appended to the ledger (after any decoy candidates), so each one is the newest member of its
+*     ref set; members are in ledger order
+* param: input_enotes -
+* param: ref_set_decomp_n -
+* param: ref_set_decomp_m -
+* param: num_decoy_ledger_enotes -
+* inoutparam: ledger_context_inout -
+* return: set of membership proof reference sets
+*/
+std::vector<MockMembershipReferenceSetSpV1> gen_mock_sp_membership_ref_sets_v2_gamma(
+    const std::vector<MockENoteSpV1> &input_enotes,
+    const std::size_t ref_set_decomp_n,
+    const std::size_t ref_set_decomp_m,
+    const std::size_t num_decoy_ledger_enotes,
+    std::shared_ptr<LedgerContext> ledger_context_inout);
 /**
 * brief: gen_mock_sp_destinations_v1 - create random mock destinations
 * param: out_amounts -
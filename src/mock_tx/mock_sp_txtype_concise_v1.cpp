@@ -32,6 +32,7 @@
 #include "mock_sp_txtype_concise_v1.h"
 
 //local headers
+#include "common/perf_timer.h"
 #include "ledger_context.h"
 #include "misc_log_ex.h"
 #include "mock_ledger_context.h"
@@ -40,10 +41,15 @@
 #include "mock_sp_transaction_component_types.h"
 #include "mock_sp_transaction_utils.h"
 #include "mock_sp_validators.h"
+#include "mock_tx_phase_timers.h"
 #include "mock_tx_utils.h"
+#include "mock_tx_verification_cost.h"
 #include "ringct/bulletproofs_plus.h"
+#include "ringct/multiexp.h"
+#include "ringct/rctOps.h"
 #include "ringct/rctTypes.h"
 #include "seraphis_crypto_utils.h"
+#include "serialization/binary_utils.h"
 
 //third party headers
 
@@ -63,7 +69,8 @@ MockTxSpConciseV1::MockTxSpConciseV1(const std::vector<MockInputProposalSpV1> &i
     const std::size_t max_rangeproof_splits,
     const std::vector<MockDestinationSpV1> &destinations,
     const std::vector<MockMembershipReferenceSetSpV1> &membership_ref_sets,
-    const MockTxSpConciseV1::ValidationRulesVersion validation_rules_version)
+    const MockTxSpConciseV1::ValidationRulesVersion validation_rules_version,
+    const std::size_t num_threads)
 {
     CHECK_AND_ASSERT_THROW_MES(input_proposals.size() > 0, "Tried to make tx without any inputs.");
     CHECK_AND_ASSERT_THROW_MES(destinations.size() > 0, "Tried to make tx without any outputs.");
@@ -81,14 +88,17 @@ MockTxSpConciseV1::MockTxSpConciseV1(const std::vector<MockInputProposalSpV1> &i
 
     // partial inputs
     std::vector<MockTxPartialInputSpV1> partial_inputs;
-    make_v1_tx_partial_inputs_sp_v1(input_proposals, proposal_prefix, tx_proposal, partial_inputs);
+    make_v1_tx_partial_inputs_sp_v1(input_proposals, proposal_prefix, tx_proposal, partial_inputs, num_threads);
 
     // partial tx
     MockTxPartialSpV1 partial_tx{tx_proposal, partial_inputs, max_rangeproof_splits, version_string};
 
     // membership proofs
     std::vector<MockMembershipProofSortableSpV1> tx_membership_proofs_sortable;
-    make_v1_tx_membership_proofs_sp_v1(membership_ref_sets, partial_inputs, tx_membership_proofs_sortable);
+    make_v1_tx_membership_proofs_sp_v1(membership_ref_sets,
+        partial_inputs,
+        tx_membership_proofs_sortable,
+        num_threads);
 
     // sort the membership proofs so they line up with input images
     std::vector<MockMembershipProofSpV1> tx_membership_proofs;
@@ -98,6 +108,31 @@ MockTxSpConciseV1::MockTxSpConciseV1(const std::vector<MockInputProposalSpV1> &i
     *this = MockTxSpConciseV1{std::move(partial_tx), std::move(tx_membership_proofs), validation_rules_version};
 }
 //-------------------------------------------------------------------------------------------------------------------
+MockTxSpConciseV1::MockTxSpConciseV1(const std::string &tx_blob)
+{
+    CHECK_AND_ASSERT_THROW_MES(::serialization::parse_binary(tx_blob, *this), "Failed to parse MockTxSpConciseV1 blob.");
+    CHECK_AND_ASSERT_THROW_MES(m_tx_era_version == TxGenerationSp &&
+        m_tx_format_version == TxStructureVersionSp::TxTypeSpConciseV1 &&
+        m_tx_validation_rules_version >= ValidationRulesVersion::MIN &&
+        m_tx_validation_rules_version <= ValidationRulesVersion::MAX, "Unsupported MockTxSpConciseV1 version.");
+
+    // BP+ commitments: output commitments
+    rct::keyV range_proof_commitments;
+    range_proof_commitments.reserve(m_outputs.size());
+    for (const MockENoteSpV1 &output : m_outputs)
+        range_proof_commitments.emplace_back(output.m_amount_commitment);
+
+    CHECK_AND_ASSERT_THROW_MES(try_restore_bpp_commitments(range_proof_commitments, m_balance_proof->m_bpp_proofs),
+        "MockTxSpConciseV1 range proofs don't match its amount commitments.");
+    CHECK_AND_ASSERT_THROW_MES(validate_tx_semantics(), "Failed to assemble MockTxSpConciseV1.");
+}
+//-------------------------------------------------------------------------------------------------------------------
+void MockTxSpConciseV1::get_tx_byte_blob(std::string &tx_blob_out) const
+{
+    CHECK_AND_ASSERT_THROW_MES(::serialization::dump_binary(const_cast<MockTxSpConciseV1&>(*this), tx_blob_out),
+        "Failed to serialize MockTxSpConciseV1.");
+}
+//-------------------------------------------------------------------------------------------------------------------
 bool MockTxSpConciseV1::validate_tx_semantics() const
 {
     // validate component counts (num inputs/outputs/etc.)
@@ -178,20 +213,23 @@ bool MockTxSpConciseV1::validate_tx_input_proofs(const std::shared_ptr<const Led
         }
     }
 
-    // ownership proof (and proof that key images are well-formed)
-    std::string version_string;
-    version_string.reserve(3);
-    this->MockTx::get_versioning_string(version_string);
+    // ownership proofs (and proofs that key images are well-formed) (can be deferred for batching)
+    if (!defer_batchable)
+    {
+        std::string version_string;
+        version_string.reserve(3);
+        this->MockTx::get_versioning_string(version_string);
 
-    rct::key image_proofs_message{
-            get_tx_image_proof_message_sp_v1(version_string, m_outputs, m_supplement)
-        };
+        rct::key image_proofs_message{
+                get_tx_image_proof_message_sp_v1(version_string, m_outputs, m_supplement)
+            };
 
-    if (!validate_mock_tx_sp_composition_proofs_v1(m_image_proofs,
-        m_input_images,
-        image_proofs_message))
-    {
-        return false;
+        if (!validate_mock_tx_sp_composition_proofs_v1(m_image_proofs,
+            m_input_images,
+            image_proofs_message))
+        {
+            return false;
+        }
     }
 
     return true;
@@ -232,11 +270,42 @@ std::size_t MockTxSpConciseV1::get_size_bytes() const
     return size;
 }
 //-------------------------------------------------------------------------------------------------------------------
+MockTxVerificationOps MockTxSpConciseV1::estimate_verification_ops() const
+{
+    MockTxVerificationOps ops;
+
+    // semantics: linking tags are in the prime subgroup
+    ops += get_linking_tag_semantics_verification_ops(m_input_images.size());
+
+    // amount balance (with a remainder blinding factor) and range proofs
+    ops += get_balance_check_verification_ops(m_input_images.size(), m_outputs.size(), m_outputs.size());
+    if (m_balance_proof.get() != nullptr)
+    {
+        if (!(m_balance_proof->m_remainder_blinding_factor == rct::zero()))
+            ops.m_generator_points += 1;
+        ops += get_bpp_verification_ops(m_balance_proof->m_bpp_proofs);
+    }
+
+    // membership proofs (ref set members: {Ko, C})
+    for (const MockMembershipProofSpV1 &membership_proof : m_membership_proofs)
+    {
+        ops += get_concise_grootle_verification_ops(2,
+            membership_proof.m_ref_set_decomp_n,
+            membership_proof.m_ref_set_decomp_m);
+    }
+
+    // ownership/key-image-legitimacy proofs
+    for (std::size_t image_proof_index{0}; image_proof_index < m_image_proofs.size(); ++image_proof_index)
+        ops += get_sp_composition_verification_ops(1);
+
+    return ops;
+}
+//-------------------------------------------------------------------------------------------------------------------
 template <>
 std::shared_ptr<MockTxSpConciseV1> make_mock_tx<MockTxSpConciseV1>(const MockTxParamPack &params,
     const std::vector<rct::xmr_amount> &in_amounts,
     const std::vector<rct::xmr_amount> &out_amounts,
-    std::shared_ptr<MockLedgerContext> ledger_context_inout)
+    std::shared_ptr<LedgerContext> ledger_context_inout)
 {
     CHECK_AND_ASSERT_THROW_MES(in_amounts.size() > 0, "Tried to make tx without any inputs.");
     CHECK_AND_ASSERT_THROW_MES(out_amounts.size() > 0, "Tried to make tx without any outputs.");
@@ -259,36 +328,56 @@ std::shared_ptr<MockTxSpConciseV1> make_mock_tx<MockTxSpConciseV1>(const MockTxP
         input_enotes.emplace_back(input_proposal.m_enote);
 
     std::vector<MockMembershipReferenceSetSpV1> membership_ref_sets{
-            gen_mock_sp_membership_ref_sets_v1(input_enotes,
+            params.shared_ref_set
+            ? gen_mock_sp_membership_shared_ref_sets_v1(input_enotes,
+                params.ref_set_decomp_n,
+                params.ref_set_decomp_m,
+                ledger_context_inout,
+                params.num_threads)
+            : gen_mock_sp_membership_ref_sets_v1(input_enotes,
                 params.ref_set_decomp_n,
                 params.ref_set_decomp_m,
-                ledger_context_inout)
+                ledger_context_inout,
+                params.num_threads)
         };
 
     // make tx
     return std::make_shared<MockTxSpConciseV1>(input_proposals, params.max_rangeproof_splits, destinations,
-        membership_ref_sets, MockTxSpConciseV1::ValidationRulesVersion::ONE);
+        membership_ref_sets, MockTxSpConciseV1::ValidationRulesVersion::ONE, params.num_threads);
 }
 //-------------------------------------------------------------------------------------------------------------------
 template <>
-bool validate_mock_txs<MockTxSpConciseV1>(const std::vector<std::shared_ptr<MockTxSpConciseV1>> &txs_to_validate,
-    const std::shared_ptr<const LedgerContext> ledger_context)
+bool try_get_mock_txs_batch_validation_data<MockTxSpConciseV1>(
+    const std::vector<std::shared_ptr<MockTxSpConciseV1>> &txs_to_validate,
+    const std::size_t begin_index,
+    const std::size_t end_index,
+    const std::shared_ptr<const LedgerContext> ledger_context,
+    std::vector<rct::pippenger_prep_data> &prep_datas_out)
 {
+    CHECK_AND_ASSERT_THROW_MES(begin_index <= end_index && end_index <= txs_to_validate.size(),
+        "Invalid tx range for batch validation data.");
+
     std::vector<const MockMembershipProofSpV1*> membership_proof_ptrs;
     std::vector<const MockENoteImageSpV1*> input_image_ptrs;
     std::vector<const rct::BulletproofPlus*> range_proof_ptrs;
-    membership_proof_ptrs.reserve(txs_to_validate.size()*20);  //heuristic... (most tx have 1-2 inputs)
-    input_image_ptrs.reserve(txs_to_validate.size()*20);
-    range_proof_ptrs.reserve(txs_to_validate.size());
+    std::vector<const MockImageProofSpV1*> image_proof_ptrs;
+    rct::keyV image_proof_messages;
+    membership_proof_ptrs.reserve((end_index - begin_index)*20);  //heuristic... (most tx have 1-2 inputs)
+    input_image_ptrs.reserve((end_index - begin_index)*20);
+    range_proof_ptrs.reserve(end_index - begin_index);
+    image_proof_ptrs.reserve((end_index - begin_index)*20);
+    image_proof_messages.reserve((end_index - begin_index)*20);
+    std::string version_string;
 
-    // prepare for batch-verification
-    for (const auto &tx : txs_to_validate)
+    for (std::size_t tx_index{begin_index}; tx_index < end_index; ++tx_index)
     {
+        const std::shared_ptr<MockTxSpConciseV1> &tx{txs_to_validate[tx_index]};
+
         if (!tx)
             return false;
 
         // validate unbatchable parts of tx
-        if (!tx->validate(ledger_context, true))
+        if (!validate_mock_tx(*tx, ledger_context, true))
             return false;
 
         // gather membership proof pieces
@@ -298,6 +387,17 @@ bool validate_mock_txs<MockTxSpConciseV1>(const std::vector<std::shared_ptr<Mock
         for (const auto &input_image : tx->m_input_images)
             input_image_ptrs.push_back(&(input_image));
 
+        // gather composition proof pieces (all of a tx's proofs share its image proof message)
+        version_string.clear();
+        tx->MockTx::get_versioning_string(version_string);
+
+        for (const auto &image_proof : tx->m_image_proofs)
+            image_proof_ptrs.push_back(&image_proof);
+
+        image_proof_messages.resize(image_proof_ptrs.size(),
+                get_tx_image_proof_message_sp_v1(version_string, tx->m_outputs, tx->m_supplement)
+            );
+
         // gather range proofs
         const std::shared_ptr<const MockBalanceProofSpV1> balance_proof{tx->m_balance_proof};
 
@@ -309,27 +409,76 @@ bool validate_mock_txs<MockTxSpConciseV1>(const std::vector<std::shared_ptr<Mock
     }
 
     // batch verification: collect pippenger data sets
-    std::vector<rct::pippenger_prep_data> prep_datas;
-    prep_datas.resize(2);
+    prep_datas_out.resize(3);
 
     // membership proofs
     if (!try_get_mock_tx_sp_membership_proofs_v1_validation_data(membership_proof_ptrs,
         input_image_ptrs,
         ledger_context,
-        prep_datas[0]))
+        prep_datas_out[0]))
     {
         return false;
     }
 
-    // range proofs
-    if (!rct::try_get_bulletproof_plus_verification_data(range_proof_ptrs, prep_datas[1]))
-        return false;
+    // range proofs, and amount balances (folded into the range proof data set)
+    {
+        MOCK_TX_PHASE_TIMER(RANGE_PROOF_DATA);
+        if (!rct::try_get_bulletproof_plus_verification_data(range_proof_ptrs, prep_datas_out[1]))
+            return false;
+
+        for (std::size_t tx_index{begin_index}; tx_index < end_index; ++tx_index)
+        {
+            const auto *tx{txs_to_validate[tx_index].get()};
 
-    // batch verify
-    if (!sp::check_pippenger_data(prep_datas))
+            get_mock_tx_sp_amount_balance_validation_data(tx->m_input_images,
+                tx->m_outputs,
+                tx->m_balance_proof->m_remainder_blinding_factor,
+                prep_datas_out[1]);
+        }
+    }
+
+    // composition proofs
+    if (!try_get_mock_tx_sp_composition_proofs_v1_validation_data(image_proof_ptrs,
+        input_image_ptrs,
+        image_proof_messages,
+        prep_datas_out[2]))
+    {
         return false;
+    }
 
     return true;
 }
 //-------------------------------------------------------------------------------------------------------------------
+template <>
+bool validate_mock_txs<MockTxSpConciseV1>(const std::vector<std::shared_ptr<MockTxSpConciseV1>> &txs_to_validate,
+    const std::shared_ptr<const LedgerContext> ledger_context,
+    const std::size_t num_threads)
+{
+    PERF_TIMER(validate_mock_txs_sp_concise_v1);
+
+    // prepare for batch-verification (in parallel: each shard of txs gets its own pippenger data sets)
+    auto try_get_shard_data =
+        [&txs_to_validate, &ledger_context](const std::size_t begin,
+            const std::size_t end,
+            std::vector<rct::pippenger_prep_data> &shard_prep_datas_out) -> bool
+        {
+            return try_get_mock_txs_batch_validation_data<MockTxSpConciseV1>(txs_to_validate,
+                begin,
+                end,
+                ledger_context,
+                shard_prep_datas_out);
+        };
+
+    std::vector<rct::pippenger_prep_data> prep_datas;
+
+    if (!try_get_batch_validation_data_sharded(txs_to_validate.size(), num_threads, try_get_shard_data, prep_datas))
+        return false;
+
+    // batch verify (then give the data sets' storage back to this thread's multiexp data pool)
+    const bool batch_valid{sp::check_pippenger_data(prep_datas, num_threads)};
+    rct::recycle_pippenger_prep_data(prep_datas);
+
+    return batch_valid;
+}
+//-------------------------------------------------------------------------------------------------------------------
 } //namespace mock_tx
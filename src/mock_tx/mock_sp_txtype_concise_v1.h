@@ -60,6 +60,7 @@ namespace mock_tx
 class MockTxSpConciseV1 final : public MockTx
 {
     friend class MockLedgerContext;
+    friend class MockLedgerContextLMDB;
 
 public:
 //member types
@@ -118,10 +119,11 @@ public:
         const std::size_t max_rangeproof_splits,
         const std::vector<MockDestinationSpV1> &destinations,
         const std::vector<MockMembershipReferenceSetSpV1> &membership_ref_sets,
-        const ValidationRulesVersion validation_rules_version);
+        const ValidationRulesVersion validation_rules_version,
+        const std::size_t num_threads = 1);
 
-    /// normal constructor: from existing tx byte blob
-    //mock tx doesn't do this
+    /// normal constructor: from existing tx byte blob (throws if the blob is not a valid MockTxSpConciseV1)
+    explicit MockTxSpConciseV1(const std::string &tx_blob);
 
 //destructor: default
 
@@ -130,8 +132,8 @@ public:
     bool validate(const std::shared_ptr<const LedgerContext> ledger_context,
         const bool defer_batchable = false) const override
     {
-        // punt to the parent class
-        return this->MockTx::validate(ledger_context, defer_batchable);
+        // same steps as the parent class, statically dispatched
+        return validate_mock_tx(*this, ledger_context, defer_batchable);
     }
 
     /// get size of tx
@@ -140,6 +142,9 @@ public:
     /// get a short description of the tx type
     std::string get_descriptor() const override { return "Sp-Concise"; }
 
+    /// estimate the work to verify the tx
+    MockTxVerificationOps estimate_verification_ops() const override;
+
     /// get the tx version string: era | format | validation rules
     static void get_versioning_string(const unsigned char tx_validation_rules_version,
         std::string &version_string)
@@ -152,7 +157,24 @@ public:
     /// get balance proof
     const std::shared_ptr<const MockBalanceProofSpV1> get_balance_proof() const { return m_balance_proof; }
 
-    //get_tx_byte_blob()
+    /// get the tx as a byte blob
+    void get_tx_byte_blob(std::string &tx_blob_out) const;
+
+    BEGIN_SERIALIZE_OBJECT()
+        FIELD(m_tx_era_version)
+        FIELD(m_tx_format_version)
+        FIELD(m_tx_validation_rules_version)
+        FIELD(m_input_images)
+        FIELD(m_outputs)
+        if (!W)
+            m_balance_proof = std::make_shared<MockBalanceProofSpV1>();
+        if (m_balance_proof.get() == nullptr)
+            return false;
+        FIELD_N("m_balance_proof", *m_balance_proof)
+        FIELD(m_image_proofs)
+        FIELD(m_membership_proofs)
+        FIELD(m_supplement)
+    END_SERIALIZE()
 
     /// validate pieces of the tx
     bool validate_tx_semantics() const override;
@@ -188,15 +210,34 @@ template <>
 std::shared_ptr<MockTxSpConciseV1> make_mock_tx<MockTxSpConciseV1>(const MockTxParamPack &params,
     const std::vector<rct::xmr_amount> &in_amounts,
     const std::vector<rct::xmr_amount> &out_amounts,
-    std::shared_ptr<MockLedgerContext> ledger_context_inout);
+    std::shared_ptr<LedgerContext> ledger_context_inout);
+/**
+* brief: try_get_mock_txs_batch_validation_data - validate the unbatchable parts of a range of MockTxSpConciseV1
+*   transactions, and collect their batchable parts as pippenger data sets (function specialization)
+* param: txs_to_validate -
+* param: begin_index - first tx of the range
+* param: end_index - one past the last tx of the range
+* param: ledger_context -
+* outparam: prep_datas_out - pippenger data sets for the range's batchable proofs
+* return: false if a tx failed its unbatchable checks or its batch data couldn't be collected
+*/
+template <>
+bool try_get_mock_txs_batch_validation_data<MockTxSpConciseV1>(
+    const std::vector<std::shared_ptr<MockTxSpConciseV1>> &txs_to_validate,
+    const std::size_t begin_index,
+    const std::size_t end_index,
+    const std::shared_ptr<const LedgerContext> ledger_context,
+    std::vector<rct::pippenger_prep_data> &prep_datas_out);
 /**
 * brief: validate_mock_txs - validate a set of MockTxSpConciseV1 transactions (function specialization)
 * param: txs_to_validate -
 * param: ledger_context -
+* param: num_threads - max number of threads to use (0 = threadpool max concurrency; 1 = serial)
 * return: true/false on validation result
 */
 template <>
 bool validate_mock_txs<MockTxSpConciseV1>(const std::vector<std::shared_ptr<MockTxSpConciseV1>> &txs_to_validate,
-    const std::shared_ptr<const LedgerContext> ledger_context);
+    const std::shared_ptr<const LedgerContext> ledger_context,
+    const std::size_t num_threads);
 
 } //namespace mock_tx
@@ -32,6 +32,7 @@
 #include "mock_sp_txtype_merge_v1.h"
 
 //local headers
+#include "common/perf_timer.h"
 #include "ledger_context.h"
 #include "misc_log_ex.h"
 #include "mock_ledger_context.h"
@@ -40,10 +41,14 @@
 #include "mock_sp_transaction_component_types.h"
 #include "mock_sp_transaction_utils.h"
 #include "mock_sp_validators.h"
+#include "mock_tx_phase_timers.h"
 #include "mock_tx_utils.h"
+#include "mock_tx_verification_cost.h"
 #include "ringct/bulletproofs_plus.h"
+#include "ringct/rctOps.h"
 #include "ringct/rctTypes.h"
 #include "seraphis_crypto_utils.h"
+#include "serialization/binary_utils.h"
 
 //third party headers
 
@@ -63,7 +68,8 @@ MockTxSpMergeV1::MockTxSpMergeV1(const std::vector<MockInputProposalSpV1> &input
     const std::size_t max_rangeproof_splits,
     const std::vector<MockDestinationSpV1> &destinations,
     const std::vector<MockMembershipReferenceSetSpV1> &membership_ref_sets,
-    const MockTxSpMergeV1::ValidationRulesVersion validation_rules_version)
+    const MockTxSpMergeV1::ValidationRulesVersion validation_rules_version,
+    const std::size_t num_threads)
 {
     CHECK_AND_ASSERT_THROW_MES(input_proposals.size() > 0, "Tried to make tx without any inputs.");
     CHECK_AND_ASSERT_THROW_MES(destinations.size() > 0, "Tried to make tx without any outputs.");
@@ -121,7 +127,8 @@ MockTxSpMergeV1::MockTxSpMergeV1(const std::vector<MockInputProposalSpV1> &input
     make_v1_tx_membership_proofs_sp_v1(membership_ref_sets_sorted,
         image_address_masks,
         image_amount_masks,
-        tx_membership_proofs_sortable);
+        tx_membership_proofs_sortable,
+        num_threads);
     sort_v1_tx_membership_proofs_sp_v1(input_images, tx_membership_proofs_sortable, tx_membership_proofs);
 
     *this = MockTxSpMergeV1{std::move(input_images), std::move(outputs),
@@ -129,6 +136,31 @@ MockTxSpMergeV1::MockTxSpMergeV1(const std::vector<MockInputProposalSpV1> &input
         std::move(tx_supplement), MockTxSpMergeV1::ValidationRulesVersion::ONE};
 }
 //-------------------------------------------------------------------------------------------------------------------
+MockTxSpMergeV1::MockTxSpMergeV1(const std::string &tx_blob)
+{
+    CHECK_AND_ASSERT_THROW_MES(::serialization::parse_binary(tx_blob, *this), "Failed to parse MockTxSpMergeV1 blob.");
+    CHECK_AND_ASSERT_THROW_MES(m_tx_era_version == TxGenerationSp &&
+        m_tx_format_version == TxStructureVersionSp::TxTypeSpMergeV1 &&
+        m_tx_validation_rules_version >= ValidationRulesVersion::MIN &&
+        m_tx_validation_rules_version <= ValidationRulesVersion::MAX, "Unsupported MockTxSpMergeV1 version.");
+
+    // BP+ commitments: output commitments
+    rct::keyV range_proof_commitments;
+    range_proof_commitments.reserve(m_outputs.size());
+    for (const MockENoteSpV1 &output : m_outputs)
+        range_proof_commitments.emplace_back(output.m_amount_commitment);
+
+    CHECK_AND_ASSERT_THROW_MES(try_restore_bpp_commitments(range_proof_commitments, m_balance_proof->m_bpp_proofs),
+        "MockTxSpMergeV1 range proofs don't match its amount commitments.");
+    CHECK_AND_ASSERT_THROW_MES(validate_tx_semantics(), "Failed to assemble MockTxSpMergeV1.");
+}
+//-------------------------------------------------------------------------------------------------------------------
+void MockTxSpMergeV1::get_tx_byte_blob(std::string &tx_blob_out) const
+{
+    CHECK_AND_ASSERT_THROW_MES(::serialization::dump_binary(const_cast<MockTxSpMergeV1&>(*this), tx_blob_out),
+        "Failed to serialize MockTxSpMergeV1.");
+}
+//-------------------------------------------------------------------------------------------------------------------
 bool MockTxSpMergeV1::validate_tx_semantics() const
 {
     // validate component counts (num inputs/outputs/etc.)
@@ -185,24 +217,32 @@ bool MockTxSpMergeV1::validate_tx_amount_balance(const bool defer_batchable) con
 bool MockTxSpMergeV1::validate_tx_input_proofs(const std::shared_ptr<const LedgerContext> ledger_context,
     const bool defer_batchable) const
 {
-    // membership proofs (can be deferred for batching)
-    if (!defer_batchable)
-    {
-        std::vector<const MockMembershipProofSpV1*> membership_proof_ptrs;
-        std::vector<const MockENoteImageSpV1*> input_image_ptrs;
-        membership_proof_ptrs.reserve(m_membership_proofs.size());
-        input_image_ptrs.reserve(m_input_images.size());
+    // membership proofs and the merged ownership proof can be deferred for batching
+    if (defer_batchable)
+        return true;
 
-        for (const auto &membership_proof : m_membership_proofs)
-            membership_proof_ptrs.push_back(&membership_proof);
+    std::vector<const MockMembershipProofSpV1*> membership_proof_ptrs;
+    std::vector<const MockENoteImageSpV1*> input_image_ptrs;
+    membership_proof_ptrs.reserve(m_membership_proofs.size());
+    input_image_ptrs.reserve(m_input_images.size());
 
-        for (const auto &input_image : m_input_images)
-            input_image_ptrs.push_back(&input_image);
+    for (const auto &membership_proof : m_membership_proofs)
+        membership_proof_ptrs.push_back(&membership_proof);
 
-        if (!validate_mock_tx_sp_membership_proofs_v1(membership_proof_ptrs, input_image_ptrs, ledger_context))
-        {
-            return false;
-        }
+    for (const auto &input_image : m_input_images)
+        input_image_ptrs.push_back(&input_image);
+
+    // both proof types go into a single multiexp
+    std::vector<rct::pippenger_prep_data> prep_datas;
+    prep_datas.resize(2);
+
+    // membership proofs
+    if (!try_get_mock_tx_sp_membership_proofs_v1_validation_data(membership_proof_ptrs,
+        input_image_ptrs,
+        ledger_context,
+        prep_datas[0]))
+    {
+        return false;
     }
 
     // ownership proof (and proof that key images are well-formed)
@@ -210,17 +250,17 @@ bool MockTxSpMergeV1::validate_tx_input_proofs(const std::shared_ptr<const Ledge
     version_string.reserve(3);
     this->MockTx::get_versioning_string(version_string);
 
-    rct::key image_proof_message{
-            get_tx_image_proof_message_sp_v1(version_string, m_outputs, m_supplement)
-        };
-
-    if (!validate_mock_tx_sp_composition_proof_merged_v1(m_image_proof_merged,
-        m_input_images,
-        image_proof_message))
+    if (!try_get_mock_tx_sp_composition_proofs_merged_v1_validation_data({&m_image_proof_merged},
+        {input_image_ptrs},
+        {get_tx_image_proof_message_sp_v1(version_string, m_outputs, m_supplement)},
+        prep_datas[1]))
     {
         return false;
     }
 
+    if (!sp::check_pippenger_data(prep_datas))
+        return false;
+
     return true;
 }
 //-------------------------------------------------------------------------------------------------------------------
@@ -257,11 +297,37 @@ std::size_t MockTxSpMergeV1::get_size_bytes() const
     return size;
 }
 //-------------------------------------------------------------------------------------------------------------------
+MockTxVerificationOps MockTxSpMergeV1::estimate_verification_ops() const
+{
+    MockTxVerificationOps ops;
+
+    // semantics: linking tags are in the prime subgroup
+    ops += get_linking_tag_semantics_verification_ops(m_input_images.size());
+
+    // amount balance and range proofs
+    ops += get_balance_check_verification_ops(m_input_images.size(), m_outputs.size(), m_outputs.size());
+    if (m_balance_proof.get() != nullptr)
+        ops += get_bpp_verification_ops(m_balance_proof->m_bpp_proofs);
+
+    // membership proofs (ref set members: {Ko, C})
+    for (const MockMembershipProofSpV1 &membership_proof : m_membership_proofs)
+    {
+        ops += get_concise_grootle_verification_ops(2,
+            membership_proof.m_ref_set_decomp_n,
+            membership_proof.m_ref_set_decomp_m);
+    }
+
+    // ownership/key-image-legitimacy proof for all inputs
+    ops += get_sp_composition_verification_ops(m_input_images.size());
+
+    return ops;
+}
+//-------------------------------------------------------------------------------------------------------------------
 template <>
 std::shared_ptr<MockTxSpMergeV1> make_mock_tx<MockTxSpMergeV1>(const MockTxParamPack &params,
     const std::vector<rct::xmr_amount> &in_amounts,
     const std::vector<rct::xmr_amount> &out_amounts,
-    std::shared_ptr<MockLedgerContext> ledger_context_inout)
+    std::shared_ptr<LedgerContext> ledger_context_inout)
 {
     CHECK_AND_ASSERT_THROW_MES(in_amounts.size() > 0, "Tried to make tx without any inputs.");
     CHECK_AND_ASSERT_THROW_MES(out_amounts.size() > 0, "Tried to make tx without any outputs.");
@@ -284,36 +350,58 @@ std::shared_ptr<MockTxSpMergeV1> make_mock_tx<MockTxSpMergeV1>(const MockTxParam
         input_enotes.emplace_back(input_proposal.m_enote);
 
     std::vector<MockMembershipReferenceSetSpV1> membership_ref_sets{
-            gen_mock_sp_membership_ref_sets_v1(input_enotes,
+            params.shared_ref_set
+            ? gen_mock_sp_membership_shared_ref_sets_v1(input_enotes,
                 params.ref_set_decomp_n,
                 params.ref_set_decomp_m,
-                ledger_context_inout)
+                ledger_context_inout,
+                params.num_threads)
+            : gen_mock_sp_membership_ref_sets_v1(input_enotes,
+                params.ref_set_decomp_n,
+                params.ref_set_decomp_m,
+                ledger_context_inout,
+                params.num_threads)
         };
 
     // make tx
     return std::make_shared<MockTxSpMergeV1>(input_proposals, params.max_rangeproof_splits, destinations,
-        membership_ref_sets, MockTxSpMergeV1::ValidationRulesVersion::ONE);
+        membership_ref_sets, MockTxSpMergeV1::ValidationRulesVersion::ONE, params.num_threads);
 }
 //-------------------------------------------------------------------------------------------------------------------
 template <>
-bool validate_mock_txs<MockTxSpMergeV1>(const std::vector<std::shared_ptr<MockTxSpMergeV1>> &txs_to_validate,
-    const std::shared_ptr<const LedgerContext> ledger_context)
+bool try_get_mock_txs_batch_validation_data<MockTxSpMergeV1>(
+    const std::vector<std::shared_ptr<MockTxSpMergeV1>> &txs_to_validate,
+    const std::size_t begin_index,
+    const std::size_t end_index,
+    const std::shared_ptr<const LedgerContext> ledger_context,
+    std::vector<rct::pippenger_prep_data> &prep_datas_out)
 {
+    CHECK_AND_ASSERT_THROW_MES(begin_index <= end_index && end_index <= txs_to_validate.size(),
+        "Invalid tx range for batch validation data.");
+
     std::vector<const MockMembershipProofSpV1*> membership_proof_ptrs;
     std::vector<const MockENoteImageSpV1*> input_image_ptrs;
     std::vector<const rct::BulletproofPlus*> range_proof_ptrs;
-    membership_proof_ptrs.reserve(txs_to_validate.size()*20);  //heuristic... (most tx have 1-2 inputs)
-    input_image_ptrs.reserve(txs_to_validate.size()*20);
-    range_proof_ptrs.reserve(txs_to_validate.size());
+    std::vector<const MockImageProofSpV1*> image_proof_ptrs;
+    std::vector<std::vector<const MockENoteImageSpV1*>> image_proof_input_image_ptrs;
+    rct::keyV image_proof_messages;
+    membership_proof_ptrs.reserve((end_index - begin_index)*20);  //heuristic... (most tx have 1-2 inputs)
+    input_image_ptrs.reserve((end_index - begin_index)*20);
+    range_proof_ptrs.reserve(end_index - begin_index);
+    image_proof_ptrs.reserve(end_index - begin_index);
+    image_proof_input_image_ptrs.reserve(end_index - begin_index);
+    image_proof_messages.reserve(end_index - begin_index);
+    std::string version_string;
 
-    // prepare for batch-verification
-    for (const auto &tx : txs_to_validate)
+    for (std::size_t tx_index{begin_index}; tx_index < end_index; ++tx_index)
     {
+        const std::shared_ptr<MockTxSpMergeV1> &tx{txs_to_validate[tx_index]};
+
         if (!tx)
             return false;
 
         // validate unbatchable parts of tx
-        if (!tx->validate(ledger_context, true))
+        if (!validate_mock_tx(*tx, ledger_context, true))
             return false;
 
         // gather membership proof pieces
@@ -323,6 +411,17 @@ bool validate_mock_txs<MockTxSpMergeV1>(const std::vector<std::shared_ptr<MockTx
         for (const auto &input_image : tx->m_input_images)
             input_image_ptrs.push_back(&(input_image));
 
+        // gather composition proof pieces (one merged proof per tx, with the tx's image proof message)
+        version_string.clear();
+        tx->MockTx::get_versioning_string(version_string);
+
+        image_proof_ptrs.push_back(&(tx->m_image_proof_merged));
+        image_proof_input_image_ptrs.emplace_back(input_image_ptrs.end() - tx->m_input_images.size(),
+            input_image_ptrs.end());
+        image_proof_messages.push_back(
+                get_tx_image_proof_message_sp_v1(version_string, tx->m_outputs, tx->m_supplement)
+            );
+
         // gather range proofs
         const std::shared_ptr<const MockBalanceProofSpV2> balance_proof{tx->m_balance_proof};
 
@@ -334,24 +433,74 @@ bool validate_mock_txs<MockTxSpMergeV1>(const std::vector<std::shared_ptr<MockTx
     }
 
     // batch verification: collect pippenger data sets
-    std::vector<rct::pippenger_prep_data> prep_datas;
-    prep_datas.resize(2);
+    prep_datas_out.resize(3);
 
     // membership proofs
     if (!try_get_mock_tx_sp_membership_proofs_v1_validation_data(membership_proof_ptrs,
         input_image_ptrs,
         ledger_context,
-        prep_datas[0]))
+        prep_datas_out[0]))
+    {
+        return false;
+    }
+
+    // range proofs, and amount balances (folded into the range proof data set)
+    {
+        MOCK_TX_PHASE_TIMER(RANGE_PROOF_DATA);
+        if (!rct::try_get_bulletproof_plus_verification_data(range_proof_ptrs, prep_datas_out[1]))
+            return false;
+
+        for (std::size_t tx_index{begin_index}; tx_index < end_index; ++tx_index)
+        {
+            const auto *tx{txs_to_validate[tx_index].get()};
+
+            // no remainder in this balance proof type
+            get_mock_tx_sp_amount_balance_validation_data(tx->m_input_images,
+                tx->m_outputs,
+                rct::zero(),
+                prep_datas_out[1]);
+        }
+    }
+
+    // composition proofs
+    if (!try_get_mock_tx_sp_composition_proofs_merged_v1_validation_data(image_proof_ptrs,
+        image_proof_input_image_ptrs,
+        image_proof_messages,
+        prep_datas_out[2]))
     {
         return false;
     }
 
-    // range proofs
-    if (!rct::try_get_bulletproof_plus_verification_data(range_proof_ptrs, prep_datas[1]))
+    return true;
+}
+//-------------------------------------------------------------------------------------------------------------------
+template <>
+bool validate_mock_txs<MockTxSpMergeV1>(const std::vector<std::shared_ptr<MockTxSpMergeV1>> &txs_to_validate,
+    const std::shared_ptr<const LedgerContext> ledger_context,
+    const std::size_t num_threads)
+{
+    PERF_TIMER(validate_mock_txs_sp_merge_v1);
+
+    // prepare for batch-verification (in parallel: each shard of txs gets its own pippenger data sets)
+    auto try_get_shard_data =
+        [&txs_to_validate, &ledger_context](const std::size_t begin,
+            const std::size_t end,
+            std::vector<rct::pippenger_prep_data> &shard_prep_datas_out) -> bool
+        {
+            return try_get_mock_txs_batch_validation_data<MockTxSpMergeV1>(txs_to_validate,
+                begin,
+                end,
+                ledger_context,
+                shard_prep_datas_out);
+        };
+
+    std::vector<rct::pippenger_prep_data> prep_datas;
+
+    if (!try_get_batch_validation_data_sharded(txs_to_validate.size(), num_threads, try_get_shard_data, prep_datas))
         return false;
 
     // batch verify
-    if (!sp::check_pippenger_data(prep_datas))
+    if (!sp::check_pippenger_data(prep_datas, num_threads))
         return false;
 
     return true;
@@ -32,6 +32,8 @@
 #include "mock_sp_txtype_squashed_v1.h"
 
 //local headers
+#include "common/perf_timer.h"
+#include "common/varint.h"
 #include "ledger_context.h"
 #include "misc_log_ex.h"
 #include "mock_ledger_context.h"
@@ -40,10 +42,15 @@
 #include "mock_sp_transaction_component_types.h"
 #include "mock_sp_transaction_utils.h"
 #include "mock_sp_validators.h"
+#include "mock_tx_phase_timers.h"
 #include "mock_tx_utils.h"
+#include "mock_tx_verification_cost.h"
 #include "ringct/bulletproofs_plus.h"
+#include "ringct/rctOps.h"
 #include "ringct/rctTypes.h"
 #include "seraphis_crypto_utils.h"
+#include "serialization/binary_utils.h"
+#include "span.h"
 
 //third party headers
 
@@ -59,11 +66,156 @@
 namespace mock_tx
 {
 //-------------------------------------------------------------------------------------------------------------------
+// view 'num records' followed by that many fixed-size records at the front of a tx blob, then advance the blob
+//-------------------------------------------------------------------------------------------------------------------
+template <typename RecordT>
+static epee::span<const RecordT> view_blob_records(epee::span<const std::uint8_t> &blob_inout)
+{
+    const std::uint8_t *blob_it{blob_inout.begin()};
+    const std::uint8_t *blob_end{blob_inout.end()};
+    std::size_t num_records;
+
+    CHECK_AND_ASSERT_THROW_MES(tools::read_varint(blob_it, blob_end, num_records) > 0,
+        "Tx blob view: failed to read a record count.");
+    blob_inout.remove_prefix(blob_it - blob_inout.begin());
+    CHECK_AND_ASSERT_THROW_MES(num_records <= blob_inout.size() / sizeof(RecordT),
+        "Tx blob view: blob too short for its records.");
+
+    const epee::span<const RecordT> records{reinterpret_cast<const RecordT*>(blob_inout.data()), num_records};
+    blob_inout.remove_prefix(num_records*sizeof(RecordT));
+
+    return records;
+}
+//-------------------------------------------------------------------------------------------------------------------
+// access txs and tx views the same way for batch validation
+//-------------------------------------------------------------------------------------------------------------------
+static const MockTxSpSquashedV1* get_tx_ptr(const std::shared_ptr<MockTxSpSquashedV1> &tx)
+{
+    return tx.get();
+}
+static const MockTxSpSquashedV1View* get_tx_ptr(const MockTxSpSquashedV1View &tx_view)
+{
+    return &tx_view;
+}
+static void get_versioning_string(const MockTxSpSquashedV1 &tx, std::string &version_string)
+{
+    tx.MockTx::get_versioning_string(version_string);
+}
+static void get_versioning_string(const MockTxSpSquashedV1View &tx_view, std::string &version_string)
+{
+    MockTxSpSquashedV1::get_versioning_string(tx_view.m_tx_validation_rules_version, version_string);
+}
+//-------------------------------------------------------------------------------------------------------------------
+// validate the unbatchable parts of a range of txs (or tx views), and collect their batchable parts
+//-------------------------------------------------------------------------------------------------------------------
+template <typename TxT, typename InputImageT>
+static bool try_get_mock_txs_batch_validation_data_impl(const std::vector<TxT> &txs_to_validate,
+    const std::size_t begin_index,
+    const std::size_t end_index,
+    const std::shared_ptr<const LedgerContext> ledger_context,
+    std::vector<rct::pippenger_prep_data> &prep_datas_out)
+{
+    CHECK_AND_ASSERT_THROW_MES(begin_index <= end_index && end_index <= txs_to_validate.size(),
+        "Invalid tx range for batch validation data.");
+
+    std::vector<const MockMembershipProofSpV1*> membership_proof_ptrs;
+    std::vector<const InputImageT*> input_image_ptrs;
+    std::vector<const rct::BulletproofPlus*> range_proof_ptrs;
+    std::vector<const MockImageProofSpV1*> image_proof_ptrs;
+    rct::keyV image_proof_messages;
+    membership_proof_ptrs.reserve((end_index - begin_index)*20);  //heuristic... (most tx have 1-2 inputs)
+    input_image_ptrs.reserve((end_index - begin_index)*20);
+    range_proof_ptrs.reserve(end_index - begin_index);
+    image_proof_ptrs.reserve((end_index - begin_index)*20);
+    image_proof_messages.reserve((end_index - begin_index)*20);
+    std::string version_string;
+
+    for (std::size_t tx_index{begin_index}; tx_index < end_index; ++tx_index)
+    {
+        const auto *tx{get_tx_ptr(txs_to_validate[tx_index])};
+
+        if (!tx)
+            return false;
+
+        // validate unbatchable parts of tx
+        if (!tx->validate(ledger_context, true))
+            return false;
+
+        // gather membership proof pieces
+        for (const auto &membership_proof : tx->m_membership_proofs)
+            membership_proof_ptrs.push_back(&membership_proof);
+
+        for (const auto &input_image : tx->m_input_images)
+            input_image_ptrs.push_back(&(input_image));
+
+        // gather composition proof pieces (all of a tx's proofs share its image proof message)
+        version_string.clear();
+        get_versioning_string(*tx, version_string);
+
+        for (const auto &image_proof : tx->m_image_proofs)
+            image_proof_ptrs.push_back(&image_proof);
+
+        image_proof_messages.resize(image_proof_ptrs.size(),
+                get_tx_image_proof_message_sp_v1(version_string, tx->m_outputs, tx->m_supplement)
+            );
+
+        // gather range proofs
+        const std::shared_ptr<const MockBalanceProofSpV1> balance_proof{tx->m_balance_proof};
+
+        if (balance_proof.get() == nullptr)
+            return false;
+
+        for (const auto &range_proof : balance_proof->m_bpp_proofs)
+            range_proof_ptrs.push_back(&range_proof);
+    }
+
+    // batch verification: collect pippenger data sets
+    prep_datas_out.resize(3);
+
+    // membership proofs
+    if (!try_get_mock_tx_sp_membership_proofs_v2_validation_data(membership_proof_ptrs,
+        input_image_ptrs,
+        ledger_context,
+        prep_datas_out[0]))
+    {
+        return false;
+    }
+
+    // range proofs, and amount balances (folded into the range proof data set)
+    {
+        MOCK_TX_PHASE_TIMER(RANGE_PROOF_DATA);
+        if (!rct::try_get_bulletproof_plus_verification_data(range_proof_ptrs, prep_datas_out[1]))
+            return false;
+
+        for (std::size_t tx_index{begin_index}; tx_index < end_index; ++tx_index)
+        {
+            const auto *tx{get_tx_ptr(txs_to_validate[tx_index])};
+
+            get_mock_tx_sp_amount_balance_validation_data(tx->m_input_images,
+                tx->m_outputs,
+                tx->m_balance_proof->m_remainder_blinding_factor,
+                prep_datas_out[1]);
+        }
+    }
+
+    // composition proofs
+    if (!try_get_mock_tx_sp_composition_proofs_v1_validation_data(image_proof_ptrs,
+        input_image_ptrs,
+        image_proof_messages,
+        prep_datas_out[2]))
+    {
+        return false;
+    }
+
+    return true;
+}
+//-------------------------------------------------------------------------------------------------------------------
 MockTxSpSquashedV1::MockTxSpSquashedV1(const std::vector<MockInputProposalSpV1> &input_proposals,
     const std::size_t max_rangeproof_splits,
     const std::vector<MockDestinationSpV1> &destinations,
     const std::vector<MockMembershipReferenceSetSpV1> &membership_ref_sets,
-    const MockTxSpSquashedV1::ValidationRulesVersion validation_rules_version)
+    const MockTxSpSquashedV1::ValidationRulesVersion validation_rules_version,
+    const std::size_t num_threads)
 {
     CHECK_AND_ASSERT_THROW_MES(input_proposals.size() > 0, "Tried to make tx without any inputs.");
     CHECK_AND_ASSERT_THROW_MES(destinations.size() > 0, "Tried to make tx without any outputs.");
@@ -124,11 +276,13 @@ MockTxSpSquashedV1::MockTxSpSquashedV1(const std::vector<MockInputProposalSpV1>
         input_images,
         image_address_masks,
         image_proofs_message,
-        tx_image_proofs);
+        tx_image_proofs,
+        num_threads);
     make_v1_tx_membership_proofs_sp_v2(membership_ref_sets_sorted,
         image_address_masks,
         image_amount_masks,
-        tx_membership_proofs_sortable);
+        tx_membership_proofs_sortable,
+        num_threads);
     sort_v1_tx_membership_proofs_sp_v1(input_images, tx_membership_proofs_sortable, tx_membership_proofs);
 
     *this = MockTxSpSquashedV1{std::move(input_images), std::move(outputs),
@@ -136,6 +290,33 @@ MockTxSpSquashedV1::MockTxSpSquashedV1(const std::vector<MockInputProposalSpV1>
         std::move(tx_supplement), MockTxSpSquashedV1::ValidationRulesVersion::ONE};
 }
 //-------------------------------------------------------------------------------------------------------------------
+MockTxSpSquashedV1::MockTxSpSquashedV1(const std::string &tx_blob)
+{
+    CHECK_AND_ASSERT_THROW_MES(::serialization::parse_binary(tx_blob, *this), "Failed to parse MockTxSpSquashedV1 blob.");
+    CHECK_AND_ASSERT_THROW_MES(m_tx_era_version == TxGenerationSp &&
+        m_tx_format_version == TxStructureVersionSp::TxTypeSpSquashedV1 &&
+        m_tx_validation_rules_version >= ValidationRulesVersion::MIN &&
+        m_tx_validation_rules_version <= ValidationRulesVersion::MAX, "Unsupported MockTxSpSquashedV1 version.");
+
+    // BP+ commitments: input image commitments, then output commitments
+    rct::keyV range_proof_commitments;
+    range_proof_commitments.reserve(m_input_images.size() + m_outputs.size());
+    for (const MockENoteImageSpV1 &input_image : m_input_images)
+        range_proof_commitments.emplace_back(input_image.m_masked_commitment);
+    for (const MockENoteSpV1 &output : m_outputs)
+        range_proof_commitments.emplace_back(output.m_amount_commitment);
+
+    CHECK_AND_ASSERT_THROW_MES(try_restore_bpp_commitments(range_proof_commitments, m_balance_proof->m_bpp_proofs),
+        "MockTxSpSquashedV1 range proofs don't match its amount commitments.");
+    CHECK_AND_ASSERT_THROW_MES(validate_tx_semantics(), "Failed to assemble MockTxSpSquashedV1.");
+}
+//-------------------------------------------------------------------------------------------------------------------
+void MockTxSpSquashedV1::get_tx_byte_blob(std::string &tx_blob_out) const
+{
+    CHECK_AND_ASSERT_THROW_MES(::serialization::dump_binary(const_cast<MockTxSpSquashedV1&>(*this), tx_blob_out),
+        "Failed to serialize MockTxSpSquashedV1.");
+}
+//-------------------------------------------------------------------------------------------------------------------
 bool MockTxSpSquashedV1::validate_tx_semantics() const
 {
     // validate component counts (num inputs/outputs/etc.)
@@ -196,42 +377,55 @@ bool MockTxSpSquashedV1::validate_tx_amount_balance(const bool defer_batchable)
 bool MockTxSpSquashedV1::validate_tx_input_proofs(const std::shared_ptr<const LedgerContext> ledger_context,
     const bool defer_batchable) const
 {
-    // membership proofs (can be deferred for batching)
-    if (!defer_batchable)
-    {
-        std::vector<const MockMembershipProofSpV1*> membership_proof_ptrs;
-        std::vector<const MockENoteImageSpV1*> input_image_ptrs;
-        membership_proof_ptrs.reserve(m_membership_proofs.size());
-        input_image_ptrs.reserve(m_input_images.size());
+    // membership proofs and ownership proofs can be deferred for batching
+    if (defer_batchable)
+        return true;
 
-        for (const auto &membership_proof : m_membership_proofs)
-            membership_proof_ptrs.push_back(&membership_proof);
+    std::vector<const MockMembershipProofSpV1*> membership_proof_ptrs;
+    std::vector<const MockImageProofSpV1*> image_proof_ptrs;
+    std::vector<const MockENoteImageSpV1*> input_image_ptrs;
+    membership_proof_ptrs.reserve(m_membership_proofs.size());
+    image_proof_ptrs.reserve(m_image_proofs.size());
+    input_image_ptrs.reserve(m_input_images.size());
 
-        for (const auto &input_image : m_input_images)
-            input_image_ptrs.push_back(&input_image);
+    for (const auto &membership_proof : m_membership_proofs)
+        membership_proof_ptrs.push_back(&membership_proof);
 
-        if (!validate_mock_tx_sp_membership_proofs_v2(membership_proof_ptrs, input_image_ptrs, ledger_context))
-        {
-            return false;
-        }
+    for (const auto &image_proof : m_image_proofs)
+        image_proof_ptrs.push_back(&image_proof);
+
+    for (const auto &input_image : m_input_images)
+        input_image_ptrs.push_back(&input_image);
+
+    // both proof types go into a single multiexp
+    std::vector<rct::pippenger_prep_data> prep_datas;
+    prep_datas.resize(2);
+
+    // membership proofs
+    if (!try_get_mock_tx_sp_membership_proofs_v2_validation_data(membership_proof_ptrs,
+        input_image_ptrs,
+        ledger_context,
+        prep_datas[0]))
+    {
+        return false;
     }
 
-    // ownership proof (and proof that key images are well-formed)
+    // ownership proofs (and proofs that key images are well-formed)
     std::string version_string;
     version_string.reserve(3);
     this->MockTx::get_versioning_string(version_string);
 
-    rct::key image_proofs_message{
-            get_tx_image_proof_message_sp_v1(version_string, m_outputs, m_supplement)
-        };
-
-    if (!validate_mock_tx_sp_composition_proofs_v1(m_image_proofs,
-        m_input_images,
-        image_proofs_message))
+    if (!try_get_mock_tx_sp_composition_proofs_v1_validation_data(image_proof_ptrs,
+        input_image_ptrs,
+        rct::keyV(image_proof_ptrs.size(), get_tx_image_proof_message_sp_v1(version_string, m_outputs, m_supplement)),
+        prep_datas[1]))
     {
         return false;
     }
 
+    if (!sp::check_pippenger_data(prep_datas))
+        return false;
+
     return true;
 }
 //-------------------------------------------------------------------------------------------------------------------
@@ -270,11 +464,45 @@ std::size_t MockTxSpSquashedV1::get_size_bytes() const
     return size;
 }
 //-------------------------------------------------------------------------------------------------------------------
+MockTxVerificationOps MockTxSpSquashedV1::estimate_verification_ops() const
+{
+    MockTxVerificationOps ops;
+
+    // semantics: linking tags are in the prime subgroup
+    ops += get_linking_tag_semantics_verification_ops(m_input_images.size());
+
+    // amount balance (with a remainder blinding factor) and range proofs (inputs and outputs are range proofed)
+    ops += get_balance_check_verification_ops(m_input_images.size(),
+        m_outputs.size(),
+        m_input_images.size() + m_outputs.size());
+    if (m_balance_proof.get() != nullptr)
+    {
+        if (!(m_balance_proof->m_remainder_blinding_factor == rct::zero()))
+            ops.m_generator_points += 1;
+        ops += get_bpp_verification_ops(m_balance_proof->m_bpp_proofs);
+    }
+
+    // membership proofs (ref set members: squashed enotes Q; offsets: Q' = Ko' + C')
+    for (const MockMembershipProofSpV1 &membership_proof : m_membership_proofs)
+    {
+        ops += get_concise_grootle_verification_ops(1,
+            membership_proof.m_ref_set_decomp_n,
+            membership_proof.m_ref_set_decomp_m);
+        ops.m_decompressions += 2;
+    }
+
+    // ownership/key-image-legitimacy proofs
+    for (std::size_t image_proof_index{0}; image_proof_index < m_image_proofs.size(); ++image_proof_index)
+        ops += get_sp_composition_verification_ops(1);
+
+    return ops;
+}
+//-------------------------------------------------------------------------------------------------------------------
 template <>
 std::shared_ptr<MockTxSpSquashedV1> make_mock_tx<MockTxSpSquashedV1>(const MockTxParamPack &params,
     const std::vector<rct::xmr_amount> &in_amounts,
     const std::vector<rct::xmr_amount> &out_amounts,
-    std::shared_ptr<MockLedgerContext> ledger_context_inout)
+    std::shared_ptr<LedgerContext> ledger_context_inout)
 {
     CHECK_AND_ASSERT_THROW_MES(in_amounts.size() > 0, "Tried to make tx without any inputs.");
     CHECK_AND_ASSERT_THROW_MES(out_amounts.size() > 0, "Tried to make tx without any outputs.");
@@ -296,78 +524,256 @@ std::shared_ptr<MockTxSpSquashedV1> make_mock_tx<MockTxSpSquashedV1>(const MockT
     for (const auto &input_proposal : input_proposals)
         input_enotes.emplace_back(input_proposal.m_enote);
 
-    std::vector<MockMembershipReferenceSetSpV1> membership_ref_sets{
-            gen_mock_sp_membership_ref_sets_v2(input_enotes,
-                params.ref_set_decomp_n,
-                params.ref_set_decomp_m,
-                ledger_context_inout)
-        };
+    std::vector<MockMembershipReferenceSetSpV1> membership_ref_sets;
+
+    if (params.ref_set_gamma_decoy_enotes > 0)
+    {
+        membership_ref_sets = gen_mock_sp_membership_ref_sets_v2_gamma(input_enotes,
+            params.ref_set_decomp_n,
+            params.ref_set_decomp_m,
+            params.ref_set_gamma_decoy_enotes,
+            ledger_context_inout);
+    }
+    else
+    {
+        membership_ref_sets = gen_mock_sp_membership_ref_sets_v2(input_enotes,
+            params.ref_set_decomp_n,
+            params.ref_set_decomp_m,
+            ledger_context_inout,
+            params.ref_set_bin_size,
+            params.num_threads);
+    }
 
     // make tx
     return std::make_shared<MockTxSpSquashedV1>(input_proposals, params.max_rangeproof_splits, destinations,
-        membership_ref_sets, MockTxSpSquashedV1::ValidationRulesVersion::ONE);
+        membership_ref_sets, MockTxSpSquashedV1::ValidationRulesVersion::ONE, params.num_threads);
+}
+//-------------------------------------------------------------------------------------------------------------------
+template <>
+bool try_get_mock_txs_batch_validation_data<MockTxSpSquashedV1>(
+    const std::vector<std::shared_ptr<MockTxSpSquashedV1>> &txs_to_validate,
+    const std::size_t begin_index,
+    const std::size_t end_index,
+    const std::shared_ptr<const LedgerContext> ledger_context,
+    std::vector<rct::pippenger_prep_data> &prep_datas_out)
+{
+    return try_get_mock_txs_batch_validation_data_impl<std::shared_ptr<MockTxSpSquashedV1>, MockENoteImageSpV1>(
+        txs_to_validate,
+        begin_index,
+        end_index,
+        ledger_context,
+        prep_datas_out);
 }
 //-------------------------------------------------------------------------------------------------------------------
 template <>
 bool validate_mock_txs<MockTxSpSquashedV1>(const std::vector<std::shared_ptr<MockTxSpSquashedV1>> &txs_to_validate,
-    const std::shared_ptr<const LedgerContext> ledger_context)
+    const std::shared_ptr<const LedgerContext> ledger_context,
+    const std::size_t num_threads)
 {
-    std::vector<const MockMembershipProofSpV1*> membership_proof_ptrs;
-    std::vector<const MockENoteImageSpV1*> input_image_ptrs;
-    std::vector<const rct::BulletproofPlus*> range_proof_ptrs;
-    membership_proof_ptrs.reserve(txs_to_validate.size()*20);  //heuristic... (most tx have 1-2 inputs)
-    input_image_ptrs.reserve(txs_to_validate.size()*20);
-    range_proof_ptrs.reserve(txs_to_validate.size());
+    PERF_TIMER(validate_mock_txs_sp_squashed_v1);
+
+    // prepare for batch-verification (in parallel: each shard of txs gets its own pippenger data sets)
+    auto try_get_shard_data =
+        [&txs_to_validate, &ledger_context](const std::size_t begin,
+            const std::size_t end,
+            std::vector<rct::pippenger_prep_data> &shard_prep_datas_out) -> bool
+        {
+            return try_get_mock_txs_batch_validation_data<MockTxSpSquashedV1>(txs_to_validate,
+                begin,
+                end,
+                ledger_context,
+                shard_prep_datas_out);
+        };
+
+    std::vector<rct::pippenger_prep_data> prep_datas;
+
+    if (!try_get_batch_validation_data_sharded(txs_to_validate.size(), num_threads, try_get_shard_data, prep_datas))
+        return false;
+
+    // batch verify
+    if (!sp::check_pippenger_data(prep_datas, num_threads))
+        return false;
 
-    // prepare for batch-verification
-    for (const auto &tx : txs_to_validate)
+    return true;
+}
+//-------------------------------------------------------------------------------------------------------------------
+MockTxSpSquashedV1View::MockTxSpSquashedV1View(epee::span<const std::uint8_t> &txs_blob_inout)
+{
+    // versions (one byte each)
+    CHECK_AND_ASSERT_THROW_MES(txs_blob_inout.size() >= 3, "Tx blob view: blob too short for its versions.");
+    CHECK_AND_ASSERT_THROW_MES(txs_blob_inout[0] == TxGenerationSp &&
+        txs_blob_inout[1] == TxStructureVersionSp::TxTypeSpSquashedV1 &&
+        txs_blob_inout[2] >= MockTxSpSquashedV1::ValidationRulesVersion::MIN &&
+        txs_blob_inout[2] <= MockTxSpSquashedV1::ValidationRulesVersion::MAX,
+        "Tx blob view: unsupported MockTxSpSquashedV1 version.");
+    m_tx_validation_rules_version = txs_blob_inout[2];
+    txs_blob_inout.remove_prefix(3);
+
+    // input images and outputs (in place)
+    m_input_images = view_blob_records<MockENoteImageSpV1View>(txs_blob_inout);
+    m_outputs = view_blob_records<MockENoteSpV1View>(txs_blob_inout);
+
+    // proofs and supplement
+    binary_archive<false> ar{txs_blob_inout};
+    m_balance_proof = std::make_shared<MockBalanceProofSpV1>();
+
+    CHECK_AND_ASSERT_THROW_MES(::do_serialize(ar, *m_balance_proof) &&
+        ::do_serialize(ar, m_image_proofs) &&
+        ::do_serialize(ar, m_membership_proofs) &&
+        ::do_serialize(ar, m_supplement) &&
+        ar.good(), "Tx blob view: failed to parse MockTxSpSquashedV1 proofs.");
+    txs_blob_inout.remove_prefix(ar.getpos());
+
+    // BP+ commitments: input image commitments, then output commitments
+    rct::keyV range_proof_commitments;
+    range_proof_commitments.reserve(m_input_images.size() + m_outputs.size());
+    for (const MockENoteImageSpV1View &input_image : m_input_images)
+        range_proof_commitments.emplace_back(input_image.m_masked_commitment);
+    for (const MockENoteSpV1View &output : m_outputs)
+        range_proof_commitments.emplace_back(output.m_amount_commitment);
+
+    CHECK_AND_ASSERT_THROW_MES(try_restore_bpp_commitments(range_proof_commitments, m_balance_proof->m_bpp_proofs),
+        "Tx blob view: range proofs don't match the amount commitments.");
+    CHECK_AND_ASSERT_THROW_MES(validate_tx_semantics(), "Tx blob view: invalid MockTxSpSquashedV1 semantics.");
+}
+//-------------------------------------------------------------------------------------------------------------------
+bool MockTxSpSquashedV1View::validate(const std::shared_ptr<const LedgerContext> ledger_context,
+    const bool defer_batchable) const
+{
+    return validate_mock_tx(*this, ledger_context, defer_batchable);
+}
+//-------------------------------------------------------------------------------------------------------------------
+bool MockTxSpSquashedV1View::validate_tx_semantics() const
+{
+    // same checks as MockTxSpSquashedV1::validate_tx_semantics()
+    if (!validate_mock_tx_sp_semantics_component_counts_v3(m_input_images.size(),
+        m_membership_proofs.size(),
+        m_image_proofs.size(),
+        m_outputs.size(),
+        m_supplement.m_output_enote_pubkeys.size(),
+        m_balance_proof))
     {
-        if (!tx)
-            return false;
+        return false;
+    }
 
-        // validate unbatchable parts of tx
-        if (!tx->validate(ledger_context, true))
-            return false;
+    if (!validate_mock_tx_sp_semantics_ref_set_size_v1(m_membership_proofs))
+        return false;
 
-        // gather membership proof pieces
-        for (const auto &membership_proof : tx->m_membership_proofs)
-            membership_proof_ptrs.push_back(&membership_proof);
+    if (!validate_mock_tx_sp_semantics_input_images_v1(m_input_images))
+        return false;
 
-        for (const auto &input_image : tx->m_input_images)
-            input_image_ptrs.push_back(&(input_image));
+    if (!validate_mock_tx_sp_semantics_sorting_v1(m_membership_proofs, m_input_images))
+        return false;
 
-        // gather range proofs
-        const std::shared_ptr<const MockBalanceProofSpV1> balance_proof{tx->m_balance_proof};
+    return true;
+}
+//-------------------------------------------------------------------------------------------------------------------
+bool MockTxSpSquashedV1View::validate_tx_linking_tags(const std::shared_ptr<const LedgerContext> ledger_context) const
+{
+    return validate_mock_tx_sp_linking_tags_v1(m_input_images, ledger_context);
+}
+//-------------------------------------------------------------------------------------------------------------------
+bool MockTxSpSquashedV1View::validate_tx_amount_balance(const bool defer_batchable) const
+{
+    return validate_mock_tx_sp_amount_balance_v3(m_input_images, m_outputs, m_balance_proof, defer_batchable);
+}
+//-------------------------------------------------------------------------------------------------------------------
+bool MockTxSpSquashedV1View::validate_tx_input_proofs(const std::shared_ptr<const LedgerContext> ledger_context,
+    const bool defer_batchable) const
+{
+    // membership proofs and ownership proofs can be deferred for batching
+    if (defer_batchable)
+        return true;
 
-        if (balance_proof.get() == nullptr)
-            return false;
+    std::vector<const MockMembershipProofSpV1*> membership_proof_ptrs;
+    std::vector<const MockImageProofSpV1*> image_proof_ptrs;
+    std::vector<const MockENoteImageSpV1View*> input_image_ptrs;
+    membership_proof_ptrs.reserve(m_membership_proofs.size());
+    image_proof_ptrs.reserve(m_image_proofs.size());
+    input_image_ptrs.reserve(m_input_images.size());
 
-        for (const auto &range_proof : balance_proof->m_bpp_proofs)
-            range_proof_ptrs.push_back(&range_proof);
-    }
+    for (const auto &membership_proof : m_membership_proofs)
+        membership_proof_ptrs.push_back(&membership_proof);
 
-    // batch verification: collect pippenger data sets
+    for (const auto &image_proof : m_image_proofs)
+        image_proof_ptrs.push_back(&image_proof);
+
+    for (const auto &input_image : m_input_images)
+        input_image_ptrs.push_back(&input_image);
+
+    // both proof types go into a single multiexp
     std::vector<rct::pippenger_prep_data> prep_datas;
     prep_datas.resize(2);
 
     // membership proofs
     if (!try_get_mock_tx_sp_membership_proofs_v2_validation_data(membership_proof_ptrs,
-        input_image_ptrs,
-        ledger_context,
-        prep_datas[0]))
+            input_image_ptrs,
+            ledger_context,
+            prep_datas[0]))
     {
         return false;
     }
 
-    // range proofs
-    if (!rct::try_get_bulletproof_plus_verification_data(range_proof_ptrs, prep_datas[1]))
+    // ownership proofs (and proofs that key images are well-formed)
+    std::string version_string;
+    version_string.reserve(3);
+    get_versioning_string(*this, version_string);
+
+    if (!try_get_mock_tx_sp_composition_proofs_v1_validation_data(image_proof_ptrs,
+            input_image_ptrs,
+            rct::keyV(image_proof_ptrs.size(), get_tx_image_proof_message_sp_v1(version_string, m_outputs, m_supplement)),
+            prep_datas[1]))
+    {
         return false;
+    }
 
-    // batch verify
     if (!sp::check_pippenger_data(prep_datas))
         return false;
 
     return true;
 }
 //-------------------------------------------------------------------------------------------------------------------
+std::vector<MockTxSpSquashedV1View> get_mock_tx_sp_squashed_v1_views(epee::span<const std::uint8_t> txs_blob)
+{
+    std::vector<MockTxSpSquashedV1View> tx_views;
+
+    while (!txs_blob.empty())
+        tx_views.emplace_back(txs_blob);
+
+    return tx_views;
+}
+//-------------------------------------------------------------------------------------------------------------------
+bool validate_mock_tx_views(const std::vector<MockTxSpSquashedV1View> &tx_views_to_validate,
+    const std::shared_ptr<const LedgerContext> ledger_context,
+    const std::size_t num_threads)
+{
+    // prepare for batch-verification (in parallel: each shard of tx views gets its own pippenger data sets)
+    auto try_get_shard_data =
+        [&tx_views_to_validate, &ledger_context](const std::size_t begin,
+            const std::size_t end,
+            std::vector<rct::pippenger_prep_data> &shard_prep_datas_out) -> bool
+        {
+            return try_get_mock_txs_batch_validation_data_impl<MockTxSpSquashedV1View, MockENoteImageSpV1View>(
+                tx_views_to_validate,
+                begin,
+                end,
+                ledger_context,
+                shard_prep_datas_out);
+        };
+
+    std::vector<rct::pippenger_prep_data> prep_datas;
+
+    if (!try_get_batch_validation_data_sharded(tx_views_to_validate.size(),
+            num_threads,
+            try_get_shard_data,
+            prep_datas))
+        return false;
+
+    // batch verify
+    if (!sp::check_pippenger_data(prep_datas, num_threads))
+        return false;
+
+    return true;
+}
+//-------------------------------------------------------------------------------------------------------------------
 } //namespace mock_tx
@@ -40,10 +40,12 @@
 #include "mock_sp_transaction_builder_types.h"
 #include "mock_sp_transaction_component_types.h"
 #include "ringct/rctTypes.h"
+#include "span.h"
 
 //third party headers
 
 //standard headers
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <vector>
@@ -61,6 +63,7 @@ namespace mock_tx
 class MockTxSpSquashedV1 final : public MockTx
 {
     friend class MockLedgerContext;
+    friend class MockLedgerContextLMDB;
 
 public:
 //member types
@@ -104,10 +107,11 @@ public:
         const std::size_t max_rangeproof_splits,
         const std::vector<MockDestinationSpV1> &destinations,
         const std::vector<MockMembershipReferenceSetSpV1> &membership_ref_sets,
-        const ValidationRulesVersion validation_rules_version);
+        const ValidationRulesVersion validation_rules_version,
+        const std::size_t num_threads = 1);
 
-    /// normal constructor: from existing tx byte blob
-    //mock tx doesn't do this
+    /// normal constructor: from existing tx byte blob (throws if the blob is not a valid MockTxSpSquashedV1)
+    explicit MockTxSpSquashedV1(const std::string &tx_blob);
 
 //destructor: default
 
@@ -116,8 +120,8 @@ public:
     bool validate(const std::shared_ptr<const LedgerContext> ledger_context,
         const bool defer_batchable = false) const override
     {
-        // punt to the parent class
-        return this->MockTx::validate(ledger_context, defer_batchable);
+        // same steps as the parent class, statically dispatched
+        return validate_mock_tx(*this, ledger_context, defer_batchable);
     }
 
     /// get size of tx
@@ -126,6 +130,9 @@ public:
     /// get a short description of the tx type
     std::string get_descriptor() const override { return "Sp-Squashed"; }
 
+    /// estimate the work to verify the tx
+    MockTxVerificationOps estimate_verification_ops() const override;
+
     /// get the tx version string: era | format | validation rules
     static void get_versioning_string(const unsigned char tx_validation_rules_version,
         std::string &version_string)
@@ -138,7 +145,24 @@ public:
     /// get balance proof
     const std::shared_ptr<const MockBalanceProofSpV1> get_balance_proof() const { return m_balance_proof; }
 
-    //get_tx_byte_blob()
+    /// get the tx as a byte blob
+    void get_tx_byte_blob(std::string &tx_blob_out) const;
+
+    BEGIN_SERIALIZE_OBJECT()
+        FIELD(m_tx_era_version)
+        FIELD(m_tx_format_version)
+        FIELD(m_tx_validation_rules_version)
+        FIELD(m_input_images)
+        FIELD(m_outputs)
+        if (!W)
+            m_balance_proof = std::make_shared<MockBalanceProofSpV1>();
+        if (m_balance_proof.get() == nullptr)
+            return false;
+        FIELD_N("m_balance_proof", *m_balance_proof)
+        FIELD(m_image_proofs)
+        FIELD(m_membership_proofs)
+        FIELD(m_supplement)
+    END_SERIALIZE()
 
     /// validate pieces of the tx
     bool validate_tx_semantics() const override;
@@ -162,6 +186,50 @@ public:
     MockSupplementSpV1 m_supplement;
 };
 
+////
+// MockTxSpSquashedV1View - read-only view of a MockTxSpSquashedV1 byte blob
+// - input images and outputs are read in place from the blob, which must outlive the view (e.g. a block's txs in an
+//   mmap'd buffer)
+// - the proofs vary in shape, so they are parsed into owned objects
+// - validated with the same rules as MockTxSpSquashedV1
+///
+class MockTxSpSquashedV1View final
+{
+public:
+//constructors
+    /// normal constructor: view the tx blob at the front of 'txs_blob_inout', then advance 'txs_blob_inout' past it
+    /// (throws if the blob is not a valid MockTxSpSquashedV1)
+    explicit MockTxSpSquashedV1View(epee::span<const std::uint8_t> &txs_blob_inout);
+
+//member functions
+    /// validate tx (same steps as MockTx::validate())
+    bool validate(const std::shared_ptr<const LedgerContext> ledger_context,
+        const bool defer_batchable = false) const;
+
+    /// validate pieces of the tx
+    bool validate_tx_semantics() const;
+    bool validate_tx_linking_tags(const std::shared_ptr<const LedgerContext> ledger_context) const;
+    bool validate_tx_amount_balance(const bool defer_batchable) const;
+    bool validate_tx_input_proofs(const std::shared_ptr<const LedgerContext> ledger_context,
+        const bool defer_batchable) const;
+
+//member variables
+    /// a tx format's validation rules version
+    unsigned char m_tx_validation_rules_version;
+    /// tx input images (in the blob)
+    epee::span<const MockENoteImageSpV1View> m_input_images;
+    /// tx outputs (in the blob)
+    epee::span<const MockENoteSpV1View> m_outputs;
+    /// balance proof (balance proof and range proofs)
+    std::shared_ptr<MockBalanceProofSpV1> m_balance_proof;
+    /// composition proofs: ownership/key-image-legitimacy for each input
+    std::vector<MockImageProofSpV1> m_image_proofs;
+    /// concise Grootle proofs on squashed enotes: membership for each input
+    std::vector<MockMembershipProofSpV1> m_membership_proofs;
+    /// supplemental data for tx
+    MockSupplementSpV1 m_supplement;
+};
+
 /**
 * brief: make_mock_tx - make a MockTxSpSquashedV1 transaction (function specialization)
 * param: params -
@@ -174,15 +242,50 @@ template <>
 std::shared_ptr<MockTxSpSquashedV1> make_mock_tx<MockTxSpSquashedV1>(const MockTxParamPack &params,
     const std::vector<rct::xmr_amount> &in_amounts,
     const std::vector<rct::xmr_amount> &out_amounts,
-    std::shared_ptr<MockLedgerContext> ledger_context_inout);
+    std::shared_ptr<LedgerContext> ledger_context_inout);
+/**
+* brief: try_get_mock_txs_batch_validation_data - validate the unbatchable parts of a range of MockTxSpSquashedV1
+*   transactions, and collect their batchable parts as pippenger data sets (function specialization)
+* param: txs_to_validate -
+* param: begin_index - first tx of the range
+* param: end_index - one past the last tx of the range
+* param: ledger_context -
+* outparam: prep_datas_out - pippenger data sets for the range's batchable proofs
+* return: false if a tx failed its unbatchable checks or its batch data couldn't be collected
+*/
+template <>
+bool try_get_mock_txs_batch_validation_data<MockTxSpSquashedV1>(
+    const std::vector<std::shared_ptr<MockTxSpSquashedV1>> &txs_to_validate,
+    const std::size_t begin_index,
+    const std::size_t end_index,
+    const std::shared_ptr<const LedgerContext> ledger_context,
+    std::vector<rct::pippenger_prep_data> &prep_datas_out);
 /**
 * brief: validate_mock_txs - validate a set of MockTxSpSquashedV1 transactions (function specialization)
 * param: txs_to_validate -
 * param: ledger_context -
+* param: num_threads - max number of threads to use (0 = threadpool max concurrency; 1 = serial)
 * return: true/false on validation result
 */
 template <>
 bool validate_mock_txs<MockTxSpSquashedV1>(const std::vector<std::shared_ptr<MockTxSpSquashedV1>> &txs_to_validate,
-    const std::shared_ptr<const LedgerContext> ledger_context);
+    const std::shared_ptr<const LedgerContext> ledger_context,
+    const std::size_t num_threads);
+/**
+* brief: get_mock_tx_sp_squashed_v1_views - view each tx in a buffer of back-to-back MockTxSpSquashedV1 blobs
+* param: txs_blob - the tx blobs (must outlive the views)
+* return: one view per tx, in blob order (throws if the buffer isn't a sequence of valid tx blobs)
+*/
+std::vector<MockTxSpSquashedV1View> get_mock_tx_sp_squashed_v1_views(epee::span<const std::uint8_t> txs_blob);
+/**
+* brief: validate_mock_tx_views - batch validate a set of MockTxSpSquashedV1 blob views (same as validate_mock_txs())
+* param: tx_views_to_validate -
+* param: ledger_context -
+* param: num_threads - max number of threads to use (0 = threadpool max concurrency; 1 = serial)
+* return: true/false on validation result
+*/
+bool validate_mock_tx_views(const std::vector<MockTxSpSquashedV1View> &tx_views_to_validate,
+    const std::shared_ptr<const LedgerContext> ledger_context,
+    const std::size_t num_threads = 1);
 
 } //namespace mock_tx
@@ -37,6 +37,7 @@
 #include "ledger_context.h"
 #include "mock_sp_transaction_component_types.h"
 #include "mock_sp_transaction_utils.h"
+#include "mock_tx_phase_timers.h"
 #include "mock_tx_utils.h"
 #include "ringct/bulletproofs_plus.h"
 #include "ringct/multiexp.h"
@@ -44,10 +45,13 @@
 #include "ringct/rctTypes.h"
 #include "seraphis_composition_proof.h"
 #include "seraphis_crypto_utils.h"
+#include "span.h"
 
 //third party headers
 
 //standard headers
+#include <algorithm>
+#include <future>
 #include <memory>
 #include <vector>
 
@@ -56,11 +60,31 @@
 
 namespace mock_tx
 {
+
+/// number of membership proof ref sets fetched ahead of the proof being verified
+static constexpr std::size_t REF_SET_FETCH_DEPTH{4};
+
+/// in-flight ref set fetches; they are waited for before the buffers they fill go away (e.g. when verification throws)
+struct PendingRefSetFetches final
+{
+    std::vector<std::future<void>> m_fetches;
+
+    ~PendingRefSetFetches()
+    {
+        for (std::future<void> &fetch : m_fetches)
+        {
+            if (fetch.valid())
+                fetch.wait();
+        }
+    }
+};
+
 //-------------------------------------------------------------------------------------------------------------------
 // helper for validating v1, v2, v3 balance proofs (balance equality check)
 //-------------------------------------------------------------------------------------------------------------------
-static bool validate_mock_tx_sp_amount_balance_equality_check_v1_v2_v3(const std::vector<MockENoteImageSpV1> &input_images,
-    const std::vector<MockENoteSpV1> &outputs,
+template <typename InputImagesT, typename OutputsT>
+static bool validate_mock_tx_sp_amount_balance_equality_check_v1_v2_v3(const InputImagesT &input_images,
+    const OutputsT &outputs,
     const rct::key &remainder_blinding_factor)
 {
     rct::keyV input_image_amount_commitments;
@@ -79,7 +103,10 @@ static bool validate_mock_tx_sp_amount_balance_equality_check_v1_v2_v3(const std
         output_commitments.emplace_back(rct::scalarmultBase(remainder_blinding_factor));
 
     // sum(input masked commitments) ?= sum(output commitments) + remainder_blinding_factor*G
-    if (!balance_check_equality(input_image_amount_commitments, output_commitments))
+    // - up to a small-order difference, cleared with the cofactor as the batched check does for every weight
+    rct::key difference;
+    rct::subKeys(difference, rct::addKeys(input_image_amount_commitments), rct::addKeys(output_commitments));
+    if (!(rct::scalarmult8(difference) == rct::identity()))
     {
         return false;
     }
@@ -87,6 +114,39 @@ static bool validate_mock_tx_sp_amount_balance_equality_check_v1_v2_v3(const std
     return true;
 }
 //-------------------------------------------------------------------------------------------------------------------
+// balance equality check as batchable multiexp terms, for owned enotes/images or in-place enote/image views
+//-------------------------------------------------------------------------------------------------------------------
+template <typename InputImagesT, typename OutputsT>
+static void get_mock_tx_sp_amount_balance_validation_data_impl(const InputImagesT &input_images,
+    const OutputsT &outputs,
+    const rct::key &remainder_blinding_factor,
+    rct::pippenger_prep_data &prep_data_inout)
+{
+    // random weight: without it, unbalanced txs in one batch could cancel each other out
+    // - inputs get -w and outputs w, so the more numerous terms have small scalars
+    // - w is a multiple of 8, so a small-order difference vanishes under every weight (the plain check clears it too)
+    rct::key minus_w;
+    sc_mul(minus_w.bytes, sp::minus_small_scalar_gen(sp::DEFAULT_BATCH_WEIGHT_SIZE).bytes, rct::EIGHT.bytes);
+    rct::key w;
+    sc_sub(w.bytes, rct::zero().bytes, minus_w.bytes);
+
+    // -w sum(input masked commitments) + w sum(output commitments) + w remainder_blinding_factor G ?= identity
+    std::vector<rct::MultiexpData> &data = prep_data_inout.data;
+    data.reserve(data.size() + input_images.size() + outputs.size() + 1);
+
+    for (const auto &input_image : input_images)
+        data.emplace_back(minus_w, input_image.m_masked_commitment);
+
+    for (const auto &output : outputs)
+        data.emplace_back(w, output.m_amount_commitment);
+
+    if (!(remainder_blinding_factor == rct::zero()))
+    {
+        data.emplace_back(rct::zero(), sp::get_G_p3_gen());
+        sc_mul(data.back().scalar.bytes, w.bytes, remainder_blinding_factor.bytes);
+    }
+}
+//-------------------------------------------------------------------------------------------------------------------
 // helper for validating v1 and v2 balance proofs
 // - the only difference between them is the presence of a 'remainder blinding factor' in v1 proofs
 //-------------------------------------------------------------------------------------------------------------------
@@ -100,8 +160,9 @@ static bool validate_mock_tx_sp_amount_balance_v1_v2(const std::vector<MockENote
     if (range_proofs.size() == 0)
         return false;
 
-    // check that amount commitments balance
-    if (!validate_mock_tx_sp_amount_balance_equality_check_v1_v2_v3(input_images,
+    // check that amount commitments balance (can be batched with the range proofs)
+    if (!defer_batchable &&
+        !validate_mock_tx_sp_amount_balance_equality_check_v1_v2_v3(input_images,
             outputs,
             remainder_blinding_factor))
         return false;
@@ -146,6 +207,385 @@ static bool validate_mock_tx_sp_amount_balance_v1_v2(const std::vector<MockENote
     return true;
 }
 //-------------------------------------------------------------------------------------------------------------------
+// input image semantics for owned input images or in-place input image views
+//-------------------------------------------------------------------------------------------------------------------
+template <typename InputImagesT>
+static bool validate_mock_tx_sp_semantics_input_images_v1_impl(const InputImagesT &input_images)
+{
+    for (const auto &image : input_images)
+    {
+        // input linking tags must be in the prime subgroup: l*KI = identity
+        if (!sp::key_domain_is_prime_subgroup(rct::ki2rct(image.m_key_image)))
+            return false;
+
+        // image parts must not be identity
+        if (rct::ki2rct(image.m_key_image) == rct::identity())
+            return false;
+        if (image.m_masked_address == rct::identity())
+            return false;
+        if (image.m_masked_commitment == rct::identity())
+            return false;
+    }
+
+    return true;
+}
+//-------------------------------------------------------------------------------------------------------------------
+// v1 sorting semantics for owned input images or in-place input image views
+//-------------------------------------------------------------------------------------------------------------------
+template <typename InputImagesT>
+static bool validate_mock_tx_sp_semantics_sorting_v1_impl(const std::vector<MockMembershipProofSpV1> &membership_proofs,
+    const InputImagesT &input_images)
+{
+    // membership proof referenced enote indices should be sorted (ascending)
+    // note: duplicate references are allowed
+    for (const auto &proof : membership_proofs)
+    {
+        for (std::size_t reference_index{1}; reference_index < proof.m_ledger_enote_indices.size(); ++ reference_index)
+        {
+            if (proof.m_ledger_enote_indices[reference_index - 1] > proof.m_ledger_enote_indices[reference_index])
+                return false;
+        }
+    }
+
+    // input images should be sorted by key image with byte-wise comparisons (ascending)
+    for (std::size_t input_index{1}; input_index < input_images.size(); ++input_index)
+    {
+        if (memcmp(&(input_images[input_index - 1].m_key_image),
+                    &(input_images[input_index].m_key_image),
+                    sizeof(crypto::key_image)) > 0)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+//-------------------------------------------------------------------------------------------------------------------
+// linking tag checks for owned input images or in-place input image views
+//-------------------------------------------------------------------------------------------------------------------
+template <typename InputImagesT>
+static bool validate_mock_tx_sp_linking_tags_v1_impl(const InputImagesT &input_images,
+    const std::shared_ptr<const LedgerContext> ledger_context)
+{
+    // sanity check
+    if (ledger_context.get() == nullptr)
+        return false;
+
+    // check no duplicates in tx
+    for (std::size_t input_index{1}; input_index < input_images.size(); ++input_index)
+    {
+        if (input_images[input_index - 1].m_key_image == input_images[input_index].m_key_image)
+            return false;
+    }
+
+    // check no duplicates in ledger context (one batched lookup for all inputs)
+    std::vector<crypto::key_image> linking_tags;
+    linking_tags.reserve(input_images.size());
+    for (const auto &input_image : input_images)
+        linking_tags.push_back(input_image.m_key_image);
+
+    std::vector<bool> linking_tags_exist;
+    ledger_context->linking_tags_exist_sp_v1(linking_tags, linking_tags_exist);
+
+    for (const bool linking_tag_exists : linking_tags_exist)
+    {
+        if (linking_tag_exists)
+            return false;
+    }
+
+    return true;
+}
+//-------------------------------------------------------------------------------------------------------------------
+// v3 balance proofs for owned enotes/images or in-place enote/image views
+//-------------------------------------------------------------------------------------------------------------------
+template <typename InputImagesT, typename OutputsT>
+static bool validate_mock_tx_sp_amount_balance_v3_impl(const InputImagesT &input_images,
+    const OutputsT &outputs,
+    const std::shared_ptr<const MockBalanceProofSpV1> balance_proof,
+    const bool defer_batchable)
+{
+    // sanity check
+    if (balance_proof.get() == nullptr)
+        return false;
+
+    const std::vector<rct::BulletproofPlus> &range_proofs = balance_proof->m_bpp_proofs;
+
+    // sanity check
+    if (range_proofs.size() == 0)
+        return false;
+
+    // check that amount commitments balance (can be batched with the range proofs)
+    if (!defer_batchable &&
+        !validate_mock_tx_sp_amount_balance_equality_check_v1_v2_v3(input_images,
+            outputs,
+            balance_proof->m_remainder_blinding_factor))
+        return false;
+
+    // check that commitments in range proofs line up with input image and output commitments
+    std::size_t range_proof_index{0};
+    std::size_t range_proof_grouping_size = range_proofs[0].V.size();
+
+    for (std::size_t commitment_index{0}; commitment_index < input_images.size() + outputs.size(); ++commitment_index)
+    {
+        // assume range proofs are partitioned into groups of size 'range_proof_grouping_size' (except last one)
+        if (range_proofs[range_proof_index].V.size() == commitment_index - range_proof_index*range_proof_grouping_size)
+            ++range_proof_index;
+
+        // sanity checks
+        if (range_proofs.size() <= range_proof_index)
+            return false;
+        if (range_proofs[range_proof_index].V.size() <= commitment_index - range_proof_index*range_proof_grouping_size)
+            return false;
+
+        // double check that the two stored copies of output commitments match
+        // TODO? don't store commitments in BP+ structure
+        if (commitment_index < input_images.size())
+        {
+            // input image amount commitments are range proofed first
+            if (input_images[commitment_index].m_masked_commitment !=
+                    rct::rct2pk(rct::scalarmult8(range_proofs[range_proof_index].V[commitment_index -
+                        range_proof_index*range_proof_grouping_size])))
+            {
+                return false;
+            }
+        }
+        else
+        {
+            // output commitments are range proofed last
+            if (outputs[commitment_index - input_images.size()].m_amount_commitment !=
+                    rct::rct2pk(rct::scalarmult8(range_proofs[range_proof_index].V[commitment_index -
+                        range_proof_index*range_proof_grouping_size])))
+            {
+                return false;
+            }
+        }
+    }
+
+    // range proofs must be valid
+    if (!defer_batchable)
+    {
+        std::vector<const rct::BulletproofPlus*> range_proof_ptrs;
+        range_proof_ptrs.reserve(range_proofs.size());
+
+        for (const auto &range_proof : range_proofs)
+            range_proof_ptrs.push_back(&range_proof);
+
+        if (!rct::bulletproof_plus_VERIFY(range_proof_ptrs))
+            return false;
+    }
+
+    return true;
+}
+//-------------------------------------------------------------------------------------------------------------------
+// v2 membership proof validation data for owned input images or in-place input image views
+//-------------------------------------------------------------------------------------------------------------------
+template <typename InputImageT>
+static bool try_get_mock_tx_sp_membership_proofs_v2_validation_data_impl(
+    const std::vector<const MockMembershipProofSpV1*> &membership_proofs,
+    const std::vector<const InputImageT*> &input_images,
+    const std::shared_ptr<const LedgerContext> ledger_context,
+    rct::pippenger_prep_data &prep_data_out)
+{
+    MOCK_TX_PHASE_TIMER(MEMBERSHIP_PROOF_DATA);
+    std::size_t num_proofs{membership_proofs.size()};
+
+    // sanity check
+    if (num_proofs != input_images.size() ||
+        num_proofs == 0)
+        return false;
+
+    // batch-validate proofs
+    std::vector<const sp::ConciseGrootleProof*> proofs;
+    std::vector<rct::KeyMatrix> membership_proof_keys;
+    std::vector<std::vector<ge_p3>> membership_proof_points;
+    rct::KeyMatrix offsets{num_proofs, 1};
+    rct::keyV messages;
+    std::vector<const std::vector<std::size_t>*> ledger_indices;
+    proofs.reserve(num_proofs);
+    ledger_indices.reserve(num_proofs);
+    membership_proof_keys.resize(num_proofs);
+    membership_proof_points.resize(num_proofs);
+
+    // ledgers that store squashed enotes pre-converted hand over their cached forms (unless ref sets are pre-aggregated
+    //   with straus multiples instead)
+    rct::straus_point_cache *straus_cache{ledger_context->get_squashed_enote_straus_cache_sp_v2()};
+    std::vector<std::vector<ge_cached>> membership_proof_cached_points;
+    bool use_cached_points{straus_cache == nullptr};
+    if (use_cached_points)
+        membership_proof_cached_points.resize(num_proofs);
+
+    for (std::size_t proof_index{0}; proof_index < num_proofs; ++proof_index)
+    {
+        // sanity check
+        if (!membership_proofs[proof_index] ||
+            !input_images[proof_index])
+            return false;
+
+        proofs.push_back(&(membership_proofs[proof_index]->m_concise_grootle_proof));
+        ledger_indices.push_back(&(membership_proofs[proof_index]->m_ledger_enote_indices));
+
+        // offset (input image masked keys squashed: Q' = Ko' + C')
+        rct::addKeys(offsets[proof_index][0],
+            input_images[proof_index]->m_masked_address,
+            input_images[proof_index]->m_masked_commitment);
+    }
+
+    // get proof keys from enotes stored in the ledger, if it stores their cached forms (this is known at the first proof)
+    if (use_cached_points)
+    {
+        MOCK_TX_PHASE_TIMER(REF_SET_FETCH);
+
+        for (std::size_t proof_index{0}; proof_index < num_proofs; ++proof_index)
+        {
+            if (!ledger_context->try_get_reference_set_components_sp_v2_cached(
+                    membership_proofs[proof_index]->m_ledger_enote_indices,
+                    membership_proof_keys[proof_index],
+                    membership_proof_points[proof_index],
+                    membership_proof_cached_points[proof_index]))
+            {
+                CHECK_AND_ASSERT_THROW_MES(proof_index == 0,
+                    "Ledger stopped providing cached squashed enotes partway through a batch.");
+                use_cached_points = false;
+                break;
+            }
+        }
+    }
+
+    // otherwise, fetch the decompressed keys in the background, a few proofs ahead of the proof being verified
+    // - proof k+1's ref set is read from the ledger while proof k's verification data is assembled
+    // - only the time spent waiting for a fetch counts as fetch time
+    PendingRefSetFetches pending_fetches;
+    sp::ConciseGrootleRefSetWaiter wait_for_ref_set;
+
+    if (!use_cached_points)
+    {
+        pending_fetches.m_fetches.resize(num_proofs);
+
+        auto start_fetch =
+            [&](const std::size_t proof_index)
+            {
+                pending_fetches.m_fetches[proof_index] =
+                    ledger_context->get_reference_set_components_sp_v2_p3_async(
+                        membership_proofs[proof_index]->m_ledger_enote_indices,
+                        membership_proof_keys[proof_index],
+                        membership_proof_points[proof_index]);
+            };
+
+        for (std::size_t proof_index{0}; proof_index < std::min(REF_SET_FETCH_DEPTH, num_proofs); ++proof_index)
+            start_fetch(proof_index);
+
+        wait_for_ref_set =
+            [&, start_fetch](const std::size_t proof_index)
+            {
+                {
+                    MOCK_TX_PHASE_TIMER(REF_SET_FETCH);
+                    pending_fetches.m_fetches[proof_index].get();
+                }
+
+                if (proof_index + REF_SET_FETCH_DEPTH < num_proofs)
+                    start_fetch(proof_index + REF_SET_FETCH_DEPTH);
+            };
+    }
+
+    // proof messages (hashed together)
+    get_tx_membership_proof_messages_sp_v1(ledger_indices, messages);
+
+    // get verification data
+    // - if the ledger keeps straus multiples of its squashed enotes, pre-aggregate each ref set with them (hot enotes
+    //   recur across many ref sets, so their multiples only need to be made once)
+    // - if the ledger stores its squashed enotes in cached form, pippenger uses those forms directly
+    if (straus_cache)
+    {
+        std::vector<std::vector<uint64_t>> membership_proof_point_ids;
+        membership_proof_point_ids.reserve(num_proofs);
+
+        for (const MockMembershipProofSpV1 *membership_proof : membership_proofs)
+        {
+            membership_proof_point_ids.emplace_back(membership_proof->m_ledger_enote_indices.begin(),
+                membership_proof->m_ledger_enote_indices.end());
+        }
+
+        prep_data_out = sp::get_concise_grootle_verification_data(proofs,
+            membership_proof_keys,
+            membership_proof_points,
+            membership_proof_point_ids,
+            *straus_cache,
+            offsets,
+            membership_proofs[0]->m_ref_set_decomp_n,
+            membership_proofs[0]->m_ref_set_decomp_m,
+            messages,
+            wait_for_ref_set);
+    }
+    else if (use_cached_points)
+    {
+        prep_data_out = sp::get_concise_grootle_verification_data(proofs,
+            membership_proof_keys,
+            membership_proof_points,
+            membership_proof_cached_points,
+            offsets,
+            membership_proofs[0]->m_ref_set_decomp_n,
+            membership_proofs[0]->m_ref_set_decomp_m,
+            messages);
+    }
+    else
+    {
+        prep_data_out = sp::get_concise_grootle_verification_data(proofs,
+            membership_proof_keys,
+            membership_proof_points,
+            offsets,
+            membership_proofs[0]->m_ref_set_decomp_n,
+            membership_proofs[0]->m_ref_set_decomp_m,
+            messages,
+            wait_for_ref_set);
+    }
+
+    return true;
+}
+//-------------------------------------------------------------------------------------------------------------------
+// v1 composition proof validation data for owned input images or in-place input image views
+//-------------------------------------------------------------------------------------------------------------------
+template <typename InputImageT>
+static bool try_get_mock_tx_sp_composition_proofs_v1_validation_data_impl(
+    const std::vector<const MockImageProofSpV1*> &image_proofs,
+    const std::vector<const InputImageT*> &input_images,
+    const rct::keyV &image_proofs_messages,
+    rct::pippenger_prep_data &prep_data_out)
+{
+    MOCK_TX_PHASE_TIMER(COMPOSITION_PROOF_DATA);
+    std::size_t num_proofs{image_proofs.size()};
+
+    // sanity check
+    if (num_proofs != input_images.size() ||
+        num_proofs != image_proofs_messages.size() ||
+        num_proofs == 0)
+        return false;
+
+    // batch-validate proofs; these proofs are unmerged (one per input)
+    std::vector<const sp::SpCompositionProof*> proofs;
+    std::vector<rct::keyV> K;
+    std::vector<std::vector<crypto::key_image>> KI;
+    proofs.reserve(num_proofs);
+    K.reserve(num_proofs);
+    KI.reserve(num_proofs);
+
+    for (std::size_t proof_index{0}; proof_index < num_proofs; ++proof_index)
+    {
+        // sanity check
+        if (!image_proofs[proof_index] ||
+            !input_images[proof_index])
+            return false;
+
+        proofs.push_back(&(image_proofs[proof_index]->m_composition_proof));
+        K.push_back({input_images[proof_index]->m_masked_address});
+        KI.push_back({input_images[proof_index]->m_key_image});
+    }
+
+    // get verification data
+    prep_data_out = sp::get_sp_composition_verification_data(proofs, K, KI, image_proofs_messages);
+
+    return true;
+}
+//-------------------------------------------------------------------------------------------------------------------
 //-------------------------------------------------------------------------------------------------------------------
 bool validate_mock_tx_sp_semantics_component_counts_v1(const std::size_t num_input_images,
     const std::size_t num_membership_proofs,
@@ -336,50 +776,24 @@ bool validate_mock_tx_sp_semantics_ref_set_size_v2(const std::vector<MockMembers
 //-------------------------------------------------------------------------------------------------------------------
 bool validate_mock_tx_sp_semantics_input_images_v1(const std::vector<MockENoteImageSpV1> &input_images)
 {
-    for (const auto &image : input_images)
-    {
-        // input linking tags must be in the prime subgroup: l*KI = identity
-        if (!sp::key_domain_is_prime_subgroup(rct::ki2rct(image.m_key_image)))
-            return false;
-
-        // image parts must not be identity
-        if (rct::ki2rct(image.m_key_image) == rct::identity())
-            return false;
-        if (image.m_masked_address == rct::identity())
-            return false;
-        if (image.m_masked_commitment == rct::identity())
-            return false;
-    }
-
-    return true;
+    return validate_mock_tx_sp_semantics_input_images_v1_impl(input_images);
+}
+//-------------------------------------------------------------------------------------------------------------------
+bool validate_mock_tx_sp_semantics_input_images_v1(const epee::span<const MockENoteImageSpV1View> input_images)
+{
+    return validate_mock_tx_sp_semantics_input_images_v1_impl(input_images);
 }
 //-------------------------------------------------------------------------------------------------------------------
 bool validate_mock_tx_sp_semantics_sorting_v1(const std::vector<MockMembershipProofSpV1> &membership_proofs,
     const std::vector<MockENoteImageSpV1> &input_images)
 {
-    // membership proof referenced enote indices should be sorted (ascending)
-    // note: duplicate references are allowed
-    for (const auto &proof : membership_proofs)
-    {
-        for (std::size_t reference_index{1}; reference_index < proof.m_ledger_enote_indices.size(); ++ reference_index)
-        {
-            if (proof.m_ledger_enote_indices[reference_index - 1] > proof.m_ledger_enote_indices[reference_index])
-                return false;
-        }
-    }
-
-    // input images should be sorted by key image with byte-wise comparisons (ascending)
-    for (std::size_t input_index{1}; input_index < input_images.size(); ++input_index)
-    {
-        if (memcmp(&(input_images[input_index - 1].m_key_image),
-                    &(input_images[input_index].m_key_image),
-                    sizeof(crypto::key_image)) > 0)
-        {
-            return false;
-        }
-    }
-
-    return true;
+    return validate_mock_tx_sp_semantics_sorting_v1_impl(membership_proofs, input_images);
+}
+//-------------------------------------------------------------------------------------------------------------------
+bool validate_mock_tx_sp_semantics_sorting_v1(const std::vector<MockMembershipProofSpV1> &membership_proofs,
+    const epee::span<const MockENoteImageSpV1View> input_images)
+{
+    return validate_mock_tx_sp_semantics_sorting_v1_impl(membership_proofs, input_images);
 }
 //-------------------------------------------------------------------------------------------------------------------
 bool validate_mock_tx_sp_semantics_sorting_v2(const std::vector<MockMembershipProofSpV2> &membership_proofs,
@@ -413,25 +827,13 @@ bool validate_mock_tx_sp_semantics_sorting_v2(const std::vector<MockMembershipPr
 bool validate_mock_tx_sp_linking_tags_v1(const std::vector<MockENoteImageSpV1> &input_images,
     const std::shared_ptr<const LedgerContext> ledger_context)
 {
-    // sanity check
-    if (ledger_context.get() == nullptr)
-        return false;
-
-    for (std::size_t input_index{0}; input_index < input_images.size(); ++input_index)
-    {
-        // check no duplicates in tx
-        if (input_index > 0)
-        {
-            if (input_images[input_index - 1].m_key_image == input_images[input_index].m_key_image)
-                return false;
-        }
-
-        // check no duplicates in ledger context
-        if (ledger_context->linking_tag_exists_sp_v1(input_images[input_index].m_key_image))
-            return false;
-    }
-
-    return true;
+    return validate_mock_tx_sp_linking_tags_v1_impl(input_images, ledger_context);
+}
+//-------------------------------------------------------------------------------------------------------------------
+bool validate_mock_tx_sp_linking_tags_v1(const epee::span<const MockENoteImageSpV1View> input_images,
+    const std::shared_ptr<const LedgerContext> ledger_context)
+{
+    return validate_mock_tx_sp_linking_tags_v1_impl(input_images, ledger_context);
 }
 //-------------------------------------------------------------------------------------------------------------------
 bool validate_mock_tx_sp_amount_balance_v1(const std::vector<MockENoteImageSpV1> &input_images,
@@ -473,76 +875,37 @@ bool validate_mock_tx_sp_amount_balance_v3(const std::vector<MockENoteImageSpV1>
     const std::shared_ptr<const MockBalanceProofSpV1> balance_proof,
     const bool defer_batchable)
 {
-    // sanity check
-    if (balance_proof.get() == nullptr)
-        return false;
-
-    const std::vector<rct::BulletproofPlus> &range_proofs = balance_proof->m_bpp_proofs;
-
-    // sanity check
-    if (range_proofs.size() == 0)
-        return false;
-
-    // check that amount commitments balance
-    if (!validate_mock_tx_sp_amount_balance_equality_check_v1_v2_v3(input_images,
+    return validate_mock_tx_sp_amount_balance_v3_impl(input_images, outputs, balance_proof, defer_batchable);
+}
+//-------------------------------------------------------------------------------------------------------------------
+bool validate_mock_tx_sp_amount_balance_v3(const epee::span<const MockENoteImageSpV1View> input_images,
+    const epee::span<const MockENoteSpV1View> outputs,
+    const std::shared_ptr<const MockBalanceProofSpV1> balance_proof,
+    const bool defer_batchable)
+{
+    return validate_mock_tx_sp_amount_balance_v3_impl(input_images, outputs, balance_proof, defer_batchable);
+}
+//-------------------------------------------------------------------------------------------------------------------
+void get_mock_tx_sp_amount_balance_validation_data(const std::vector<MockENoteImageSpV1> &input_images,
+    const std::vector<MockENoteSpV1> &outputs,
+    const rct::key &remainder_blinding_factor,
+    rct::pippenger_prep_data &prep_data_inout)
+{
+    get_mock_tx_sp_amount_balance_validation_data_impl(input_images,
         outputs,
-        balance_proof->m_remainder_blinding_factor))
-        return false;
-
-    // check that commitments in range proofs line up with input image and output commitments
-    std::size_t range_proof_index{0};
-    std::size_t range_proof_grouping_size = range_proofs[0].V.size();
-
-    for (std::size_t commitment_index{0}; commitment_index < input_images.size() + outputs.size(); ++commitment_index)
-    {
-        // assume range proofs are partitioned into groups of size 'range_proof_grouping_size' (except last one)
-        if (range_proofs[range_proof_index].V.size() == commitment_index - range_proof_index*range_proof_grouping_size)
-            ++range_proof_index;
-
-        // sanity checks
-        if (range_proofs.size() <= range_proof_index)
-            return false;
-        if (range_proofs[range_proof_index].V.size() <= commitment_index - range_proof_index*range_proof_grouping_size)
-            return false;
-
-        // double check that the two stored copies of output commitments match
-        // TODO? don't store commitments in BP+ structure
-        if (commitment_index < input_images.size())
-        {
-            // input image amount commitments are range proofed first
-            if (input_images[commitment_index].m_masked_commitment !=
-                    rct::rct2pk(rct::scalarmult8(range_proofs[range_proof_index].V[commitment_index -
-                        range_proof_index*range_proof_grouping_size])))
-            {
-                return false;
-            }
-        }
-        else
-        {
-            // output commitments are range proofed last
-            if (outputs[commitment_index - input_images.size()].m_amount_commitment !=
-                    rct::rct2pk(rct::scalarmult8(range_proofs[range_proof_index].V[commitment_index -
-                        range_proof_index*range_proof_grouping_size])))
-            {
-                return false;
-            }
-        }
-    }
-
-    // range proofs must be valid
-    if (!defer_batchable)
-    {
-        std::vector<const rct::BulletproofPlus*> range_proof_ptrs;
-        range_proof_ptrs.reserve(range_proofs.size());
-
-        for (const auto &range_proof : range_proofs)
-            range_proof_ptrs.push_back(&range_proof);
-
-        if (!rct::bulletproof_plus_VERIFY(range_proof_ptrs))
-            return false;
-    }
-
-    return true;
+        remainder_blinding_factor,
+        prep_data_inout);
+}
+//-------------------------------------------------------------------------------------------------------------------
+void get_mock_tx_sp_amount_balance_validation_data(const epee::span<const MockENoteImageSpV1View> input_images,
+    const epee::span<const MockENoteSpV1View> outputs,
+    const rct::key &remainder_blinding_factor,
+    rct::pippenger_prep_data &prep_data_inout)
+{
+    get_mock_tx_sp_amount_balance_validation_data_impl(input_images,
+        outputs,
+        remainder_blinding_factor,
+        prep_data_inout);
 }
 //-------------------------------------------------------------------------------------------------------------------
 bool try_get_mock_tx_sp_membership_proofs_v1_validation_data(
@@ -551,6 +914,7 @@ bool try_get_mock_tx_sp_membership_proofs_v1_validation_data(
     const std::shared_ptr<const LedgerContext> ledger_context,
     rct::pippenger_prep_data &prep_data_out)
 {
+    MOCK_TX_PHASE_TIMER(MEMBERSHIP_PROOF_DATA);
     std::size_t num_proofs{membership_proofs.size()};
 
     // sanity check
@@ -560,13 +924,17 @@ bool try_get_mock_tx_sp_membership_proofs_v1_validation_data(
 
     // batch-validate proofs
     std::vector<const sp::ConciseGrootleProof*> proofs;
-    std::vector<rct::keyM> membership_proof_keys;
-    rct::keyM offsets;
+    std::vector<rct::KeyMatrix> membership_proof_keys;
+    rct::KeyMatrix offsets{num_proofs, 2};
     rct::keyV messages;
+    std::vector<const std::vector<std::size_t>*> ledger_indices;
     proofs.reserve(num_proofs);
+    ledger_indices.reserve(num_proofs);
     membership_proof_keys.resize(num_proofs);
-    offsets.resize(num_proofs);
-    messages.reserve(num_proofs);
+
+    // proofs that all reference the same ref set (e.g. a tx with a shared ref set) are verified with the ref set's
+    //   multiexp terms merged, so the ref set is only evaluated once
+    bool shared_ref_set{num_proofs > 1};
 
     for (std::size_t proof_index{0}; proof_index < num_proofs; ++proof_index)
     {
@@ -576,25 +944,52 @@ bool try_get_mock_tx_sp_membership_proofs_v1_validation_data(
             return false;
 
         proofs.push_back(&(membership_proofs[proof_index]->m_concise_grootle_proof));
+        ledger_indices.push_back(&(membership_proofs[proof_index]->m_ledger_enote_indices));
 
-        // get proof keys from enotes stored in the ledger
-        ledger_context->get_reference_set_components_sp_v1(membership_proofs[proof_index]->m_ledger_enote_indices,
-            membership_proof_keys[proof_index]);
+        if (proof_index > 0 &&
+            membership_proofs[proof_index]->m_ledger_enote_indices != membership_proofs[0]->m_ledger_enote_indices)
+            shared_ref_set = false;
 
-        // offsets (input image masked keys)
-        offsets[proof_index] = {{input_images[proof_index]->m_masked_address, input_images[proof_index]->m_masked_commitment}};
+        // get proof keys from enotes stored in the ledger (only once for a shared ref set)
+        {
+            MOCK_TX_PHASE_TIMER(REF_SET_FETCH);
+            if (proof_index > 0 && shared_ref_set)
+                membership_proof_keys[proof_index] = membership_proof_keys[0];
+            else
+            {
+                ledger_context->get_reference_set_components_sp_v1(
+                    membership_proofs[proof_index]->m_ledger_enote_indices,
+                    membership_proof_keys[proof_index]);
+            }
+        }
 
-        // proof message
-        messages.push_back(get_tx_membership_proof_message_sp_v1(membership_proofs[proof_index]->m_ledger_enote_indices));
+        // offsets (input image masked keys)
+        offsets[proof_index][0] = input_images[proof_index]->m_masked_address;
+        offsets[proof_index][1] = input_images[proof_index]->m_masked_commitment;
     }
 
+    // proof messages (hashed together)
+    get_tx_membership_proof_messages_sp_v1(ledger_indices, messages);
+
     // get verification data
-    prep_data_out = sp::get_concise_grootle_verification_data(proofs,
-        membership_proof_keys,
-        offsets,
-        membership_proofs[0]->m_ref_set_decomp_n,
-        membership_proofs[0]->m_ref_set_decomp_m,
-        messages);
+    if (shared_ref_set)
+    {
+        prep_data_out = sp::get_concise_grootle_verification_data_shared_refs(proofs,
+            membership_proof_keys,
+            offsets,
+            membership_proofs[0]->m_ref_set_decomp_n,
+            membership_proofs[0]->m_ref_set_decomp_m,
+            messages);
+    }
+    else
+    {
+        prep_data_out = sp::get_concise_grootle_verification_data(proofs,
+            membership_proof_keys,
+            offsets,
+            membership_proofs[0]->m_ref_set_decomp_n,
+            membership_proofs[0]->m_ref_set_decomp_m,
+            messages);
+    }
 
     return true;
 }
@@ -615,54 +1010,22 @@ bool try_get_mock_tx_sp_membership_proofs_v2_validation_data(
     const std::shared_ptr<const LedgerContext> ledger_context,
     rct::pippenger_prep_data &prep_data_out)
 {
-    std::size_t num_proofs{membership_proofs.size()};
-
-    // sanity check
-    if (num_proofs != input_images.size() ||
-        num_proofs == 0)
-        return false;
-
-    // batch-validate proofs
-    std::vector<const sp::ConciseGrootleProof*> proofs;
-    std::vector<rct::keyM> membership_proof_keys;
-    rct::keyM offsets;
-    rct::keyV messages;
-    proofs.reserve(num_proofs);
-    membership_proof_keys.resize(num_proofs);
-    offsets.resize(num_proofs, rct::keyV(1));
-    messages.reserve(num_proofs);
-
-    for (std::size_t proof_index{0}; proof_index < num_proofs; ++proof_index)
-    {
-        // sanity check
-        if (!membership_proofs[proof_index] ||
-            !input_images[proof_index])
-            return false;
-
-        proofs.push_back(&(membership_proofs[proof_index]->m_concise_grootle_proof));
-
-        // get proof keys from enotes stored in the ledger
-        ledger_context->get_reference_set_components_sp_v2(membership_proofs[proof_index]->m_ledger_enote_indices,
-            membership_proof_keys[proof_index]);
-
-        // offset (input image masked keys squashed: Q' = Ko' + C')
-        rct::addKeys(offsets[proof_index][0],
-            input_images[proof_index]->m_masked_address,
-            input_images[proof_index]->m_masked_commitment);
-
-        // proof message
-        messages.push_back(get_tx_membership_proof_message_sp_v1(membership_proofs[proof_index]->m_ledger_enote_indices));
-    }
-
-    // get verification data
-    prep_data_out = sp::get_concise_grootle_verification_data(proofs,
-        membership_proof_keys,
-        offsets,
-        membership_proofs[0]->m_ref_set_decomp_n,
-        membership_proofs[0]->m_ref_set_decomp_m,
-        messages);
-
-    return true;
+    return try_get_mock_tx_sp_membership_proofs_v2_validation_data_impl(membership_proofs,
+        input_images,
+        ledger_context,
+        prep_data_out);
+}
+//-------------------------------------------------------------------------------------------------------------------
+bool try_get_mock_tx_sp_membership_proofs_v2_validation_data(
+    const std::vector<const MockMembershipProofSpV1*> &membership_proofs,
+    const std::vector<const MockENoteImageSpV1View*> &input_images,
+    const std::shared_ptr<const LedgerContext> ledger_context,
+    rct::pippenger_prep_data &prep_data_out)
+{
+    return try_get_mock_tx_sp_membership_proofs_v2_validation_data_impl(membership_proofs,
+        input_images,
+        ledger_context,
+        prep_data_out);
 }
 //-------------------------------------------------------------------------------------------------------------------
 bool validate_mock_tx_sp_membership_proofs_v2(const std::vector<const MockMembershipProofSpV1*> &membership_proofs,
@@ -681,6 +1044,7 @@ bool try_get_mock_tx_sp_membership_proofs_v3_validation_data(
     const std::shared_ptr<const LedgerContext> ledger_context,
     rct::pippenger_prep_data &prep_data_out)
 {
+    MOCK_TX_PHASE_TIMER(MEMBERSHIP_PROOF_DATA);
     std::size_t num_proofs{membership_proofs.size()};
 
     // sanity check
@@ -690,13 +1054,13 @@ bool try_get_mock_tx_sp_membership_proofs_v3_validation_data(
 
     // batch-validate proofs
     std::vector<const sp::GrootleProof*> proofs;
-    std::vector<rct::keyM> membership_proof_keys;
-    rct::keyM offsets;
+    std::vector<rct::KeyMatrix> membership_proof_keys;
+    rct::KeyMatrix offsets{num_proofs, 2};
     rct::keyV messages;
+    std::vector<const std::vector<std::size_t>*> ledger_indices;
     proofs.reserve(num_proofs);
+    ledger_indices.reserve(num_proofs);
     membership_proof_keys.resize(num_proofs);
-    offsets.resize(num_proofs);
-    messages.reserve(num_proofs);
 
     for (std::size_t proof_index{0}; proof_index < num_proofs; ++proof_index)
     {
@@ -706,18 +1070,32 @@ bool try_get_mock_tx_sp_membership_proofs_v3_validation_data(
             return false;
 
         proofs.push_back(&(membership_proofs[proof_index]->m_grootle_proof));
+        ledger_indices.push_back(&(membership_proofs[proof_index]->m_ledger_enote_indices));
 
         // get proof keys from enotes stored in the ledger
-        ledger_context->get_reference_set_components_sp_v1(membership_proofs[proof_index]->m_ledger_enote_indices,
-            membership_proof_keys[proof_index]);
+        // - a ref set shared with the previous proof (e.g. a tx with a shared ref set) is only fetched once
+        {
+            MOCK_TX_PHASE_TIMER(REF_SET_FETCH);
+            if (proof_index > 0 &&
+                membership_proofs[proof_index]->m_ledger_enote_indices ==
+                    membership_proofs[proof_index - 1]->m_ledger_enote_indices)
+                membership_proof_keys[proof_index] = membership_proof_keys[proof_index - 1];
+            else
+            {
+                ledger_context->get_reference_set_components_sp_v1(
+                    membership_proofs[proof_index]->m_ledger_enote_indices,
+                    membership_proof_keys[proof_index]);
+            }
+        }
 
         // offsets (input image masked keys)
-        offsets[proof_index] = {{input_images[proof_index]->m_masked_address, input_images[proof_index]->m_masked_commitment}};
-
-        // proof message
-        messages.push_back(get_tx_membership_proof_message_sp_v1(membership_proofs[proof_index]->m_ledger_enote_indices));
+        offsets[proof_index][0] = input_images[proof_index]->m_masked_address;
+        offsets[proof_index][1] = input_images[proof_index]->m_masked_commitment;
     }
 
+    // proof messages (hashed together)
+    get_tx_membership_proof_messages_sp_v1(ledger_indices, messages);
+
     // get verification data
     prep_data_out = sp::get_grootle_verification_data(proofs,
         membership_proof_keys,
@@ -740,6 +1118,30 @@ bool validate_mock_tx_sp_membership_proofs_v3(const std::vector<const MockMember
     return sp::check_pippenger_data(std::move(prep_data));
 }
 //-------------------------------------------------------------------------------------------------------------------
+bool try_get_mock_tx_sp_composition_proofs_v1_validation_data(
+    const std::vector<const MockImageProofSpV1*> &image_proofs,
+    const std::vector<const MockENoteImageSpV1*> &input_images,
+    const rct::keyV &image_proofs_messages,
+    rct::pippenger_prep_data &prep_data_out)
+{
+    return try_get_mock_tx_sp_composition_proofs_v1_validation_data_impl(image_proofs,
+        input_images,
+        image_proofs_messages,
+        prep_data_out);
+}
+//-------------------------------------------------------------------------------------------------------------------
+bool try_get_mock_tx_sp_composition_proofs_v1_validation_data(
+    const std::vector<const MockImageProofSpV1*> &image_proofs,
+    const std::vector<const MockENoteImageSpV1View*> &input_images,
+    const rct::keyV &image_proofs_messages,
+    rct::pippenger_prep_data &prep_data_out)
+{
+    return try_get_mock_tx_sp_composition_proofs_v1_validation_data_impl(image_proofs,
+        input_images,
+        image_proofs_messages,
+        prep_data_out);
+}
+//-------------------------------------------------------------------------------------------------------------------
 bool validate_mock_tx_sp_composition_proofs_v1(const std::vector<MockImageProofSpV1> &image_proofs,
     const std::vector<MockENoteImageSpV1> &input_images,
     const rct::key &image_proofs_message)
@@ -748,19 +1150,72 @@ bool validate_mock_tx_sp_composition_proofs_v1(const std::vector<MockImageProofS
     if (image_proofs.size() != input_images.size())
         return false;
 
-    // validate each composition proof; these proofs are unmerged (one per input)
-    rct::keyV K;
-    std::vector<crypto::key_image> KI;
+    std::vector<const MockImageProofSpV1*> image_proof_ptrs;
+    std::vector<const MockENoteImageSpV1*> input_image_ptrs;
+    image_proof_ptrs.reserve(image_proofs.size());
+    input_image_ptrs.reserve(input_images.size());
 
-    for (std::size_t input_index{0}; input_index < input_images.size(); ++input_index)
-    {
-        K = {input_images[input_index].m_masked_address};
-        KI = {input_images[input_index].m_key_image};
+    for (const auto &image_proof : image_proofs)
+        image_proof_ptrs.push_back(&image_proof);
+
+    for (const auto &input_image : input_images)
+        input_image_ptrs.push_back(&input_image);
+
+    rct::pippenger_prep_data prep_data;
+    if (!try_get_mock_tx_sp_composition_proofs_v1_validation_data(image_proof_ptrs,
+            input_image_ptrs,
+            rct::keyV(image_proofs.size(), image_proofs_message),
+            prep_data))
+        return false;
+    return sp::check_pippenger_data(std::move(prep_data));
+}
+//-------------------------------------------------------------------------------------------------------------------
+bool try_get_mock_tx_sp_composition_proofs_merged_v1_validation_data(
+    const std::vector<const MockImageProofSpV1*> &image_proofs,
+    const std::vector<std::vector<const MockENoteImageSpV1*>> &input_images,
+    const rct::keyV &image_proofs_messages,
+    rct::pippenger_prep_data &prep_data_out)
+{
+    MOCK_TX_PHASE_TIMER(COMPOSITION_PROOF_DATA);
+    std::size_t num_proofs{image_proofs.size()};
+
+    // sanity check
+    if (num_proofs != input_images.size() ||
+        num_proofs != image_proofs_messages.size() ||
+        num_proofs == 0)
+        return false;
+
+    // batch-validate proofs; each merged proof covers all input images of its tx
+    std::vector<const sp::SpCompositionProof*> proofs;
+    std::vector<rct::keyV> K;
+    std::vector<std::vector<crypto::key_image>> KI;
+    proofs.reserve(num_proofs);
+    K.resize(num_proofs);
+    KI.resize(num_proofs);
 
-        if (!sp::sp_composition_verify(image_proofs[input_index].m_composition_proof, K, KI, image_proofs_message))
+    for (std::size_t proof_index{0}; proof_index < num_proofs; ++proof_index)
+    {
+        // sanity check
+        if (!image_proofs[proof_index])
             return false;
+
+        proofs.push_back(&(image_proofs[proof_index]->m_composition_proof));
+        K[proof_index].reserve(input_images[proof_index].size());
+        KI[proof_index].reserve(input_images[proof_index].size());
+
+        for (const MockENoteImageSpV1 *input_image : input_images[proof_index])
+        {
+            if (!input_image)
+                return false;
+
+            K[proof_index].emplace_back(input_image->m_masked_address);
+            KI[proof_index].emplace_back(input_image->m_key_image);
+        }
     }
 
+    // get verification data
+    prep_data_out = sp::get_sp_composition_verification_data(proofs, K, KI, image_proofs_messages);
+
     return true;
 }
 //-------------------------------------------------------------------------------------------------------------------
@@ -769,21 +1224,19 @@ bool validate_mock_tx_sp_composition_proof_merged_v1(const MockImageProofSpV1 &i
     const rct::key &image_proofs_message)
 {
     // validate the merged composition proof (one proof for all input images)
-    rct::keyV K;
-    std::vector<crypto::key_image> KI;
-    K.reserve(input_images.size());
-    KI.reserve(input_images.size());
-
-    for (std::size_t input_index{0}; input_index < input_images.size(); ++input_index)
-    {
-        K.emplace_back(input_images[input_index].m_masked_address);
-        KI.emplace_back(input_images[input_index].m_key_image);
-    }
+    std::vector<const MockENoteImageSpV1*> input_image_ptrs;
+    input_image_ptrs.reserve(input_images.size());
 
-    if (!sp::sp_composition_verify(image_proof.m_composition_proof, K, KI, image_proofs_message))
-            return false;
+    for (const auto &input_image : input_images)
+        input_image_ptrs.push_back(&input_image);
 
-    return true;
+    rct::pippenger_prep_data prep_data;
+    if (!try_get_mock_tx_sp_composition_proofs_merged_v1_validation_data({&image_proof},
+            {input_image_ptrs},
+            {image_proofs_message},
+            prep_data))
+        return false;
+    return sp::check_pippenger_data(std::move(prep_data));
 }
 //-------------------------------------------------------------------------------------------------------------------
 } //namespace mock_tx
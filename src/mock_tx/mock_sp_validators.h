@@ -34,6 +34,7 @@
 //local headers
 #include "mock_sp_transaction_component_types.h"
 #include "ringct/rctTypes.h"
+#include "span.h"
 
 //third party headers
 
@@ -128,10 +129,12 @@ bool validate_mock_tx_sp_semantics_ref_set_size_v2(const std::vector<MockMembers
 * brief: validate_mock_tx_sp_semantics_input_images_v1 - check key images are well-formed
 *   - key images are in the prime-order EC subgroup: l*KI == identity
 *   - masked address and masked commitment are not identity
+*   - the span version reads input images in place (e.g. from a tx blob)
 * param: input_images -
 * return: true/false on validation result
 */
 bool validate_mock_tx_sp_semantics_input_images_v1(const std::vector<MockENoteImageSpV1> &input_images);
+bool validate_mock_tx_sp_semantics_input_images_v1(const epee::span<const MockENoteImageSpV1View> input_images);
 /**
 * brief: validate_mock_tx_sp_semantics_sorting_v1 - check tx components are properly sorted
 *   - membership proof referenced enote indices are sorted (ascending)
@@ -142,6 +145,8 @@ bool validate_mock_tx_sp_semantics_input_images_v1(const std::vector<MockENoteIm
 */
 bool validate_mock_tx_sp_semantics_sorting_v1(const std::vector<MockMembershipProofSpV1> &membership_proofs,
     const std::vector<MockENoteImageSpV1> &input_images);
+bool validate_mock_tx_sp_semantics_sorting_v1(const std::vector<MockMembershipProofSpV1> &membership_proofs,
+    const epee::span<const MockENoteImageSpV1View> input_images);
 //todo
 bool validate_mock_tx_sp_semantics_sorting_v2(const std::vector<MockMembershipProofSpV2> &membership_proofs,
     const std::vector<MockENoteImageSpV1> &input_images);
@@ -159,11 +164,14 @@ bool validate_mock_tx_sp_semantics_sorting_v2(const std::vector<MockMembershipPr
 */
 bool validate_mock_tx_sp_linking_tags_v1(const std::vector<MockENoteImageSpV1> &input_images,
     const std::shared_ptr<const LedgerContext> ledger_context);
+bool validate_mock_tx_sp_linking_tags_v1(const epee::span<const MockENoteImageSpV1View> input_images,
+    const std::shared_ptr<const LedgerContext> ledger_context);
 /**
 * brief: validate_mock_tx_sp_amount_balance_v1 - check that amounts balance in the tx (inputs = outputs)
 *   - check BP+ range proofs on output commitments
-*     - do not check these if 'defer_batchable' is set; BP+ range proofs can be batch-verified
-*   - check sum(input image masked commitments) == sum(output commitments) + remainder*G
+*   - check 8*sum(input image masked commitments) == 8*(sum(output commitments) + remainder*G)
+*   - do not check either if 'defer_batchable' is set; range proofs and the balance (see
+*     get_mock_tx_sp_amount_balance_validation_data()) can be batch-verified
 * param: input_images -
 * param: outputs -
 * param: balance_proof -
@@ -177,8 +185,8 @@ bool validate_mock_tx_sp_amount_balance_v1(const std::vector<MockENoteImageSpV1>
 /**
 * brief: validate_mock_tx_sp_amount_balance_v2 - check that amounts balance in the tx (inputs = outputs)
 *   - check BP+ range proofs on output commitments
-*     - do not check these if 'defer_batchable' is set; BP+ range proofs can be batch-verified
-*   - check sum(input image masked commitments) == sum(output commitments)
+*   - check 8*sum(input image masked commitments) == 8*sum(output commitments)
+*   - do not check either if 'defer_batchable' is set; range proofs and the balance can be batch-verified
 * param: input_images -
 * param: outputs -
 * param: balance_proof -
@@ -192,8 +200,8 @@ bool validate_mock_tx_sp_amount_balance_v2(const std::vector<MockENoteImageSpV1>
 /**
 * brief: validate_mock_tx_sp_amount_balance_v3 - check that amounts balance in the tx (inputs = outputs)
 *   - check BP+ range proofs on input image amount commitments and output commitments (e.g. for squashed enote model)
-*     - do not check these if 'defer_batchable' is set; BP+ range proofs can be batch-verified
-*   - check sum(input image masked commitments) == sum(output commitments) + remainder*G
+*   - check 8*sum(input image masked commitments) == 8*(sum(output commitments) + remainder*G)
+*   - do not check either if 'defer_batchable' is set; range proofs and the balance can be batch-verified
 * param: input_images -
 * param: outputs -
 * param: balance_proof -
@@ -204,6 +212,28 @@ bool validate_mock_tx_sp_amount_balance_v3(const std::vector<MockENoteImageSpV1>
     const std::vector<MockENoteSpV1> &outputs,
     const std::shared_ptr<const MockBalanceProofSpV1> balance_proof,
     const bool defer_batchable);
+bool validate_mock_tx_sp_amount_balance_v3(const epee::span<const MockENoteImageSpV1View> input_images,
+    const epee::span<const MockENoteSpV1View> outputs,
+    const std::shared_ptr<const MockBalanceProofSpV1> balance_proof,
+    const bool defer_batchable);
+/**
+* brief: get_mock_tx_sp_amount_balance_validation_data - get a tx's balance check as batchable multiexp terms
+*   -w sum(input image masked commitments) + w sum(output commitments) + w remainder*G ?= identity
+*   - w is a random weight per call, so unbalanced txs in a batch can't cancel each other out
+*   - w is a multiple of 8, so a small-order difference is ignored, as in the unbatched check
+* param: input_images -
+* param: outputs -
+* param: remainder_blinding_factor - rct::zero() if the tx's balance proof has no remainder
+* inoutparam: prep_data_inout - data set the terms are appended to (e.g. the batch's range proof data)
+*/
+void get_mock_tx_sp_amount_balance_validation_data(const std::vector<MockENoteImageSpV1> &input_images,
+    const std::vector<MockENoteSpV1> &outputs,
+    const rct::key &remainder_blinding_factor,
+    rct::pippenger_prep_data &prep_data_inout);
+void get_mock_tx_sp_amount_balance_validation_data(const epee::span<const MockENoteImageSpV1View> input_images,
+    const epee::span<const MockENoteSpV1View> outputs,
+    const rct::key &remainder_blinding_factor,
+    rct::pippenger_prep_data &prep_data_inout);
 /**
 * brief: validate_mock_tx_sp_membership_proofs_v1 - check that tx inputs exist in the ledger
 *   - try to get referenced enotes from ledger (NOT txpool)
@@ -235,6 +265,11 @@ bool try_get_mock_tx_sp_membership_proofs_v2_validation_data(
     const std::vector<const MockENoteImageSpV1*> &input_images,
     const std::shared_ptr<const LedgerContext> ledger_context,
     rct::pippenger_prep_data &prep_data_out);
+bool try_get_mock_tx_sp_membership_proofs_v2_validation_data(
+    const std::vector<const MockMembershipProofSpV1*> &membership_proofs,
+    const std::vector<const MockENoteImageSpV1View*> &input_images,
+    const std::shared_ptr<const LedgerContext> ledger_context,
+    rct::pippenger_prep_data &prep_data_out);
 bool validate_mock_tx_sp_membership_proofs_v2(const std::vector<const MockMembershipProofSpV1*> &membership_proofs,
     const std::vector<const MockENoteImageSpV1*> &input_images,
     const std::shared_ptr<const LedgerContext> ledger_context);
@@ -251,11 +286,22 @@ bool validate_mock_tx_sp_membership_proofs_v3(const std::vector<const MockMember
 * brief: validate_mock_tx_sp_composition_proofs_v1 - check that spending tx inputs is authorized by their owners,
 *        and key images are properly constructed
 *   - check Seraphis composition proofs
+*   - the validation data version can batch proofs from different txs (one message per proof)
 * param: image_proofs -
 * param: input_images -
-* param: image_proofs_message -
+* param: image_proofs_message(s) -
 * return: true/false on validation result
 */
+bool try_get_mock_tx_sp_composition_proofs_v1_validation_data(
+    const std::vector<const MockImageProofSpV1*> &image_proofs,
+    const std::vector<const MockENoteImageSpV1*> &input_images,
+    const rct::keyV &image_proofs_messages,
+    rct::pippenger_prep_data &prep_data_out);
+bool try_get_mock_tx_sp_composition_proofs_v1_validation_data(
+    const std::vector<const MockImageProofSpV1*> &image_proofs,
+    const std::vector<const MockENoteImageSpV1View*> &input_images,
+    const rct::keyV &image_proofs_messages,
+    rct::pippenger_prep_data &prep_data_out);
 bool validate_mock_tx_sp_composition_proofs_v1(const std::vector<MockImageProofSpV1> &image_proofs,
     const std::vector<MockENoteImageSpV1> &input_images,
     const rct::key &image_proofs_message);
@@ -263,11 +309,18 @@ bool validate_mock_tx_sp_composition_proofs_v1(const std::vector<MockImageProofS
 * brief: validate_mock_tx_sp_composition_proof_merged_v1 - check that spending tx inputs is authorized by their owners,
 *        and key images are properly constructed
 *   - check merged Seraphis composition proof
-* param: image_proofs -
+*   - the validation data version can batch merged proofs from different txs (one input image set and message per
+*     proof)
+* param: image_proof(s) -
 * param: input_images -
-* param: image_proofs_message -
+* param: image_proofs_message(s) -
 * return: true/false on validation result
 */
+bool try_get_mock_tx_sp_composition_proofs_merged_v1_validation_data(
+    const std::vector<const MockImageProofSpV1*> &image_proofs,
+    const std::vector<std::vector<const MockENoteImageSpV1*>> &input_images,
+    const rct::keyV &image_proofs_messages,
+    rct::pippenger_prep_data &prep_data_out);
 bool validate_mock_tx_sp_composition_proof_merged_v1(const MockImageProofSpV1 &image_proof,
     const std::vector<MockENoteImageSpV1> &input_images,
     const rct::key &image_proofs_message);
@@ -0,0 +1,480 @@
+// Copyright (c) 2021, The Monero Project
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of
+//    conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list
+//    of conditions and the following disclaimer in the documentation and/or other
+//    materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be
+//    used to endorse or promote products derived from this software without specific
+//    prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+// THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// NOT FOR PRODUCTION
+
+//paired header
+#include "mock_squashed_enote_file.h"
+
+//local headers
+#include "ledger_context.h"
+#include "misc_log_ex.h"
+#include "mock_tx_utils.h"
+#include "ringct/rctTypes.h"
+#include "span.h"
+
+//third party headers
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#if defined(HAVE_LINUX_IO_URING_H)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#endif
+
+//standard headers
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#undef MONERO_DEFAULT_LOG_CATEGORY
+#define MONERO_DEFAULT_LOG_CATEGORY "mock_tx"
+
+namespace mock_tx
+{
+
+static constexpr std::size_t FILE_BLOCK_SIZE{MOCK_SQUASHED_ENOTE_FILE_BLOCK_SIZE};
+static constexpr std::size_t ENOTES_PER_BLOCK{FILE_BLOCK_SIZE / sizeof(rct::key)};
+static constexpr char SQUASHED_ENOTE_FILE_MAGIC[8]{'M', 'O', 'C', 'K', 'E', 'N', 'O', 'T'};
+static constexpr std::uint32_t SQUASHED_ENOTE_FILE_VERSION{1};
+
+/// file header (the rest of the first block is zeros)
+struct MockSquashedEnoteFileHeader final
+{
+    char m_magic[8];
+    std::uint32_t m_version;
+    std::uint32_t m_block_size;
+    std::uint64_t m_num_enotes;
+};
+
+#if defined(HAVE_LINUX_IO_URING_H)
+/// io_uring submission and completion rings (set up with raw syscalls, so there is no liburing dependency)
+struct MockSquashedEnoteFile::IoUring final
+{
+    int m_fd{-1};
+    void *m_sq_ring{nullptr};
+    std::size_t m_sq_ring_size{0};
+    void *m_cq_ring{nullptr};
+    std::size_t m_cq_ring_size{0};
+    io_uring_sqe *m_sqes{nullptr};
+    std::size_t m_sqes_size{0};
+
+    unsigned m_sq_entries{0};
+    unsigned *m_sq_tail{nullptr};
+    unsigned m_sq_mask{0};
+    unsigned *m_sq_array{nullptr};
+    unsigned *m_cq_head{nullptr};
+    unsigned *m_cq_tail{nullptr};
+    unsigned m_cq_mask{0};
+    io_uring_cqe *m_cqes{nullptr};
+
+    ~IoUring()
+    {
+        if (m_sqes)
+            munmap(m_sqes, m_sqes_size);
+        if (m_cq_ring && m_cq_ring != m_sq_ring)
+            munmap(m_cq_ring, m_cq_ring_size);
+        if (m_sq_ring)
+            munmap(m_sq_ring, m_sq_ring_size);
+        if (m_fd >= 0)
+            close(m_fd);
+    }
+};
+#else
+struct MockSquashedEnoteFile::IoUring final {};
+#endif
+
+//-------------------------------------------------------------------------------------------------------------------
+// read one whole block with pread() (retrying interrupted or partial reads)
+//-------------------------------------------------------------------------------------------------------------------
+static void pread_block(const int fd, const std::uint64_t file_offset, unsigned char *block_out)
+{
+    std::size_t num_read{0};
+    while (num_read < FILE_BLOCK_SIZE)
+    {
+        const ssize_t result{pread(fd, block_out + num_read, FILE_BLOCK_SIZE - num_read, file_offset + num_read)};
+        if (result < 0 && errno == EINTR)
+            continue;
+
+        CHECK_AND_ASSERT_THROW_MES(result > 0, "Failed to read squashed enote file block.");
+        num_read += static_cast<std::size_t>(result);
+    }
+}
+
+//-------------------------------------------------------------------------------------------------------------------
+MockSquashedEnoteFile::MockSquashedEnoteFile(const std::string &path,
+    const bool direct_io,
+    const std::size_t queue_depth)
+{
+    CHECK_AND_ASSERT_THROW_MES(queue_depth > 0 && queue_depth <= 4096, "Squashed enote file queue depth is invalid.");
+
+    // open (some file systems, e.g. tmpfs, refuse O_DIRECT)
+#if defined(O_DIRECT)
+    if (direct_io)
+    {
+        m_fd = open(path.c_str(), O_RDONLY | O_CLOEXEC | O_DIRECT);
+        m_direct_io = m_fd >= 0;
+    }
+#endif
+    if (m_fd < 0)
+        m_fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    CHECK_AND_ASSERT_THROW_MES(m_fd >= 0, "Failed to open squashed enote file.");
+
+    try
+    {
+        // read buffers must be block-aligned for direct I/O
+        void *buffers{nullptr};
+        CHECK_AND_ASSERT_THROW_MES(posix_memalign(&buffers, FILE_BLOCK_SIZE, queue_depth*FILE_BLOCK_SIZE) == 0,
+            "Failed to allocate squashed enote file buffers.");
+        m_buffers = static_cast<unsigned char*>(buffers);
+        m_queue_depth = queue_depth;
+
+        // header
+        pread_block(m_fd, 0, m_buffers);
+
+        MockSquashedEnoteFileHeader header;
+        memcpy(&header, m_buffers, sizeof(header));
+        CHECK_AND_ASSERT_THROW_MES(memcmp(header.m_magic, SQUASHED_ENOTE_FILE_MAGIC, sizeof(header.m_magic)) == 0,
+            "Not a squashed enote file.");
+        CHECK_AND_ASSERT_THROW_MES(header.m_version == SQUASHED_ENOTE_FILE_VERSION,
+            "Unsupported squashed enote file version.");
+        CHECK_AND_ASSERT_THROW_MES(header.m_block_size == FILE_BLOCK_SIZE, "Squashed enote file block size mismatch.");
+
+        struct stat file_stat;
+        CHECK_AND_ASSERT_THROW_MES(fstat(m_fd, &file_stat) == 0, "Failed to stat squashed enote file.");
+        const std::uint64_t num_blocks{(header.m_num_enotes + ENOTES_PER_BLOCK - 1) / ENOTES_PER_BLOCK};
+        CHECK_AND_ASSERT_THROW_MES(static_cast<std::uint64_t>(file_stat.st_size) >= (1 + num_blocks)*FILE_BLOCK_SIZE,
+            "Squashed enote file is truncated.");
+        m_num_enotes = header.m_num_enotes;
+
+        // io_uring (optional)
+        m_ring = try_make_io_uring(static_cast<unsigned>(queue_depth));
+#if defined(HAVE_LINUX_IO_URING_H)
+        if (m_ring)
+            m_queue_depth = std::min<std::size_t>(m_queue_depth, m_ring->m_sq_entries);
+#endif
+    }
+    catch (...)
+    {
+        free(m_buffers);
+        close(m_fd);
+        throw;
+    }
+}
+//-------------------------------------------------------------------------------------------------------------------
+MockSquashedEnoteFile::~MockSquashedEnoteFile()
+{
+    m_ring.reset();
+    free(m_buffers);
+    close(m_fd);
+}
+//-------------------------------------------------------------------------------------------------------------------
+std::unique_ptr<MockSquashedEnoteFile::IoUring> MockSquashedEnoteFile::try_make_io_uring(const unsigned entries)
+{
+#if defined(HAVE_LINUX_IO_URING_H)
+    io_uring_params params;
+    memset(&params, 0, sizeof(params));
+
+    std::unique_ptr<MockSquashedEnoteFile::IoUring> ring{new MockSquashedEnoteFile::IoUring{}};
+    ring->m_fd = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+    if (ring->m_fd < 0)
+        return nullptr;
+
+    // map the rings (one mapping for both if the kernel supports it)
+    ring->m_sq_ring_size = params.sq_off.array + params.sq_entries*sizeof(unsigned);
+    ring->m_cq_ring_size = params.cq_off.cqes + params.cq_entries*sizeof(io_uring_cqe);
+    if (params.features & IORING_FEAT_SINGLE_MMAP)
+    {
+        ring->m_sq_ring_size = std::max(ring->m_sq_ring_size, ring->m_cq_ring_size);
+        ring->m_cq_ring_size = ring->m_sq_ring_size;
+    }
+
+    void *sq_ring{mmap(nullptr, ring->m_sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+        ring->m_fd, IORING_OFF_SQ_RING)};
+    if (sq_ring == MAP_FAILED)
+        return nullptr;
+    ring->m_sq_ring = sq_ring;
+
+    if (params.features & IORING_FEAT_SINGLE_MMAP)
+        ring->m_cq_ring = ring->m_sq_ring;
+    else
+    {
+        void *cq_ring{mmap(nullptr, ring->m_cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+            ring->m_fd, IORING_OFF_CQ_RING)};
+        if (cq_ring == MAP_FAILED)
+            return nullptr;
+        ring->m_cq_ring = cq_ring;
+    }
+
+    ring->m_sqes_size = params.sq_entries*sizeof(io_uring_sqe);
+    void *sqes{mmap(nullptr, ring->m_sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+        ring->m_fd, IORING_OFF_SQES)};
+    if (sqes == MAP_FAILED)
+        return nullptr;
+    ring->m_sqes = static_cast<io_uring_sqe*>(sqes);
+
+    unsigned char *const sq_base{static_cast<unsigned char*>(ring->m_sq_ring)};
+    unsigned char *const cq_base{static_cast<unsigned char*>(ring->m_cq_ring)};
+    ring->m_sq_entries = params.sq_entries;
+    ring->m_sq_tail = reinterpret_cast<unsigned*>(sq_base + params.sq_off.tail);
+    ring->m_sq_mask = *reinterpret_cast<unsigned*>(sq_base + params.sq_off.ring_mask);
+    ring->m_sq_array = reinterpret_cast<unsigned*>(sq_base + params.sq_off.array);
+    ring->m_cq_head = reinterpret_cast<unsigned*>(cq_base + params.cq_off.head);
+    ring->m_cq_tail = reinterpret_cast<unsigned*>(cq_base + params.cq_off.tail);
+    ring->m_cq_mask = *reinterpret_cast<unsigned*>(cq_base + params.cq_off.ring_mask);
+    ring->m_cqes = reinterpret_cast<io_uring_cqe*>(cq_base + params.cq_off.cqes);
+
+    return ring;
+#else
+    (void)entries;
+    return nullptr;
+#endif
+}
+//-------------------------------------------------------------------------------------------------------------------
+template <typename OnBlockT>
+void MockSquashedEnoteFile::read_blocks(const std::vector<std::uint64_t> &blocks, OnBlockT &&on_block)
+{
+    // note: enote blocks start after the header block
+#if defined(HAVE_LINUX_IO_URING_H)
+    if (m_ring)
+    {
+        IoUring &ring{*m_ring};
+
+        std::vector<std::size_t> free_buffers;
+        free_buffers.reserve(m_queue_depth);
+        for (std::size_t buffer_index{m_queue_depth}; buffer_index > 0; --buffer_index)
+            free_buffers.push_back(buffer_index - 1);
+
+        // note: READV rather than READ, which needs a newer kernel
+        std::vector<iovec> buffer_iovecs(m_queue_depth);
+        for (std::size_t buffer_index{0}; buffer_index < m_queue_depth; ++buffer_index)
+        {
+            buffer_iovecs[buffer_index].iov_base = m_buffers + buffer_index*FILE_BLOCK_SIZE;
+            buffer_iovecs[buffer_index].iov_len = FILE_BLOCK_SIZE;
+        }
+
+        std::vector<std::size_t> block_buffers(blocks.size());
+        std::size_t next_block{0};
+        std::size_t num_in_flight{0};
+        unsigned num_unsubmitted{0};
+        bool read_failed{false};
+
+        while (next_block < blocks.size() || num_in_flight > 0)
+        {
+            // queue a read for each free buffer (only this thread writes the submission tail)
+            unsigned sq_tail{*ring.m_sq_tail};
+            while (next_block < blocks.size() && !free_buffers.empty())
+            {
+                const std::size_t buffer_index{free_buffers.back()};
+                free_buffers.pop_back();
+                block_buffers[next_block] = buffer_index;
+
+                const unsigned sqe_index{sq_tail & ring.m_sq_mask};
+                io_uring_sqe &sqe{ring.m_sqes[sqe_index]};
+                memset(&sqe, 0, sizeof(sqe));
+                sqe.opcode = IORING_OP_READV;
+                sqe.fd = m_fd;
+                sqe.addr = reinterpret_cast<std::uint64_t>(&buffer_iovecs[buffer_index]);
+                sqe.len = 1;
+                sqe.off = (1 + blocks[next_block])*FILE_BLOCK_SIZE;
+                sqe.user_data = next_block;
+                ring.m_sq_array[sqe_index] = sqe_index;
+
+                ++sq_tail;
+                ++next_block;
+                ++num_in_flight;
+                ++num_unsubmitted;
+            }
+            __atomic_store_n(ring.m_sq_tail, sq_tail, __ATOMIC_RELEASE);
+
+            // submit, and wait for at least one completion
+            const long num_submitted{
+                    syscall(__NR_io_uring_enter, ring.m_fd, num_unsubmitted, 1, IORING_ENTER_GETEVENTS, nullptr, 0)
+                };
+            if (num_submitted < 0)
+            {
+                CHECK_AND_ASSERT_THROW_MES(errno == EINTR || errno == EAGAIN || errno == EBUSY,
+                    "Failed to submit squashed enote file reads.");
+            }
+            else
+                num_unsubmitted -= static_cast<unsigned>(num_submitted);
+
+            // reap completions, in completion order
+            unsigned cq_head{*ring.m_cq_head};
+            const unsigned cq_tail{__atomic_load_n(ring.m_cq_tail, __ATOMIC_ACQUIRE)};
+            for (; cq_head != cq_tail; ++cq_head)
+            {
+                const io_uring_cqe &cqe{ring.m_cqes[cq_head & ring.m_cq_mask]};
+                const std::size_t block_position{static_cast<std::size_t>(cqe.user_data)};
+                const std::size_t buffer_index{block_buffers[block_position]};
+
+                // keep draining after a failure, so no read is left in flight into our buffers
+                if (cqe.res == static_cast<int>(FILE_BLOCK_SIZE))
+                {
+                    if (!read_failed)
+                        on_block(block_position, m_buffers + buffer_index*FILE_BLOCK_SIZE);
+                }
+                else
+                    read_failed = true;
+
+                free_buffers.push_back(buffer_index);
+                --num_in_flight;
+            }
+            __atomic_store_n(ring.m_cq_head, cq_head, __ATOMIC_RELEASE);
+        }
+
+        CHECK_AND_ASSERT_THROW_MES(!read_failed, "Failed to read squashed enote file block.");
+        return;
+    }
+#endif
+
+    // fallback: one block at a time
+    for (std::size_t block_position{0}; block_position < blocks.size(); ++block_position)
+    {
+        pread_block(m_fd, (1 + blocks[block_position])*FILE_BLOCK_SIZE, m_buffers);
+        on_block(block_position, m_buffers);
+    }
+}
+//-------------------------------------------------------------------------------------------------------------------
+void MockSquashedEnoteFile::get_reference_sets_sp_v2(const std::vector<const std::vector<std::size_t>*> &ref_sets,
+    std::vector<rct::KeyMatrix> &referenced_enotes_components_out)
+{
+    // where each requested enote goes, sorted by ledger index (so enotes in the same block are next to each other)
+    struct EnoteTarget final
+    {
+        std::size_t m_ledger_index;
+        std::size_t m_ref_set;
+        std::size_t m_position;
+    };
+
+    std::vector<rct::KeyMatrix> referenced_enotes_components_temp;
+    std::vector<EnoteTarget> targets;
+    referenced_enotes_components_temp.resize(ref_sets.size());
+
+    for (std::size_t ref_set_index{0}; ref_set_index < ref_sets.size(); ++ref_set_index)
+    {
+        CHECK_AND_ASSERT_THROW_MES(ref_sets[ref_set_index], "Reference set unexpectedly doesn't exist.");
+        const std::vector<std::size_t> &indices{*ref_sets[ref_set_index]};
+
+        referenced_enotes_components_temp[ref_set_index].resize(indices.size(), 1);
+        for (std::size_t position{0}; position < indices.size(); ++position)
+        {
+            CHECK_AND_ASSERT_THROW_MES(indices[position] < m_num_enotes, "Tried to get enote that doesn't exist.");
+            targets.push_back({indices[position], ref_set_index, position});
+        }
+    }
+
+    std::sort(targets.begin(), targets.end(),
+            [](const EnoteTarget &a, const EnoteTarget &b) -> bool
+            {
+                return a.m_ledger_index < b.m_ledger_index;
+            }
+        );
+
+    // blocks to read, and the first target of each
+    std::vector<std::uint64_t> blocks;
+    std::vector<std::size_t> block_targets_begin;
+    for (std::size_t target_index{0}; target_index < targets.size(); ++target_index)
+    {
+        const std::uint64_t block{targets[target_index].m_ledger_index / ENOTES_PER_BLOCK};
+        if (blocks.empty() || blocks.back() != block)
+        {
+            blocks.push_back(block);
+            block_targets_begin.push_back(target_index);
+        }
+    }
+    block_targets_begin.push_back(targets.size());
+
+    // read them all, copying enotes out as each block completes
+    this->read_blocks(blocks,
+            [&](const std::size_t block_position, const unsigned char *block_data)
+            {
+                for (std::size_t target_index{block_targets_begin[block_position]};
+                    target_index < block_targets_begin[block_position + 1];
+                    ++target_index)
+                {
+                    const EnoteTarget &target{targets[target_index]};
+                    memcpy(referenced_enotes_components_temp[target.m_ref_set][target.m_position][0].bytes,
+                        block_data + (target.m_ledger_index % ENOTES_PER_BLOCK)*sizeof(rct::key),
+                        sizeof(rct::key));
+                }
+            }
+        );
+
+    referenced_enotes_components_out = std::move(referenced_enotes_components_temp);
+}
+//-------------------------------------------------------------------------------------------------------------------
+void write_mock_squashed_enote_file(const std::string &path,
+    const LedgerContext &ledger_context,
+    const std::size_t num_enotes)
+{
+    std::ofstream file{path, std::ios::binary | std::ios::trunc};
+    CHECK_AND_ASSERT_THROW_MES(file.good(), "Failed to open squashed enote file for writing.");
+
+    // header block
+    std::vector<char> block(FILE_BLOCK_SIZE, 0);
+    MockSquashedEnoteFileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.m_magic, SQUASHED_ENOTE_FILE_MAGIC, sizeof(header.m_magic));
+    header.m_version = SQUASHED_ENOTE_FILE_VERSION;
+    header.m_block_size = FILE_BLOCK_SIZE;
+    header.m_num_enotes = num_enotes;
+    memcpy(block.data(), &header, sizeof(header));
+    file.write(block.data(), block.size());
+
+    // squashed enotes, a chunk at a time
+    static constexpr std::size_t CHUNK_SIZE{ENOTES_PER_BLOCK*256};
+    rct::KeyMatrix chunk;
+    for (std::size_t first_index{0}; first_index < num_enotes; first_index += CHUNK_SIZE)
+    {
+        const LedgerIndexRange range{first_index, std::min(CHUNK_SIZE, num_enotes - first_index)};
+        ledger_context.get_reference_set_components_sp_v2_ranges({&range, 1}, chunk);
+        CHECK_AND_ASSERT_THROW_MES(chunk.rows() == range.m_count && chunk.cols() == 1,
+            "Ledger returned the wrong number of enotes.");
+
+        file.write(reinterpret_cast<const char*>(chunk.data()), chunk.size()*sizeof(rct::key));
+    }
+
+    // pad the last block
+    const std::size_t num_tail_enotes{num_enotes % ENOTES_PER_BLOCK};
+    if (num_tail_enotes > 0)
+    {
+        std::fill(block.begin(), block.end(), 0);
+        file.write(block.data(), (ENOTES_PER_BLOCK - num_tail_enotes)*sizeof(rct::key));
+    }
+    file.flush();
+    CHECK_AND_ASSERT_THROW_MES(file.good(), "Failed to write squashed enote file.");
+}
+//-------------------------------------------------------------------------------------------------------------------
+} //namespace mock_tx
@@ -0,0 +1,138 @@
+// Copyright (c) 2021, The Monero Project
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of
+//    conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list
+//    of conditions and the following disclaimer in the documentation and/or other
+//    materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be
+//    used to endorse or promote products derived from this software without specific
+//    prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+// THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// Flat file of squashed enotes read with batched (io_uring) direct I/O: for comparing ref set reads against LMDB's mmap
+// - The file is a header block followed by the squashed enotes in ledger order, 32 bytes each, padded to whole blocks.
+// - A batch of ref sets is read in one go: every block it touches is submitted up front (up to the queue depth), and
+//   enotes are copied out as their blocks complete, in whatever order the device finishes them.
+// - Without io_uring (other platforms, old kernels, or a sandbox that blocks it), blocks are read with pread().
+// NOT FOR PRODUCTION
+
+#pragma once
+
+//local headers
+#include "ringct/rctTypes.h"
+
+//third party headers
+
+//standard headers
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+//forward declarations
+namespace mock_tx { class LedgerContext; }
+
+
+namespace mock_tx
+{
+
+class MockSquashedEnoteFile final
+{
+public:
+//constructors
+    /**
+    * brief: open a squashed enote file for reading
+    * param: path -
+    * param: direct_io - bypass the page cache (O_DIRECT); falls back to buffered reads if the file system refuses it
+    * param: queue_depth - max number of block reads in flight
+    */
+    MockSquashedEnoteFile(const std::string &path, const bool direct_io = true, const std::size_t queue_depth = 128);
+    /// disable copies (the reader owns a file and an io_uring instance)
+    MockSquashedEnoteFile(const MockSquashedEnoteFile&) = delete;
+
+//overloaded operators
+    /// disable copy assignment
+    MockSquashedEnoteFile& operator=(const MockSquashedEnoteFile&) = delete;
+
+//destructor
+    ~MockSquashedEnoteFile();
+
+//member functions
+    /**
+    * brief: get_reference_sets_sp_v2 - read a batch of ref sets of squashed enotes
+    *   - each block is read once per batch, no matter how many ref sets touch it
+    *   - not thread-safe (one batch at a time per reader)
+    * param: ref_sets - ledger indices of each ref set
+    * outparam: referenced_enotes_components_out - {{{squashed enote}}}, one matrix per ref set
+    */
+    void get_reference_sets_sp_v2(const std::vector<const std::vector<std::size_t>*> &ref_sets,
+        std::vector<rct::KeyMatrix> &referenced_enotes_components_out);
+    /**
+    * brief: get_num_enotes - get the number of squashed enotes in the file
+    * return: number of enotes
+    */
+    std::size_t get_num_enotes() const { return m_num_enotes; }
+    /**
+    * brief: uses_io_uring - check if reads go through io_uring (or through pread())
+    * return: true if reads use io_uring
+    */
+    bool uses_io_uring() const { return m_ring != nullptr; }
+    /**
+    * brief: uses_direct_io - check if reads bypass the page cache
+    * return: true if the file was opened with O_DIRECT
+    */
+    bool uses_direct_io() const { return m_direct_io; }
+
+private:
+    struct IoUring;
+
+    /// set up an io_uring with room for 'entries' in-flight reads (nullptr if io_uring is unavailable)
+    static std::unique_ptr<IoUring> try_make_io_uring(const unsigned entries);
+    /// read a set of blocks; on_block(block position, block data) is called once per block as it completes
+    template <typename OnBlockT>
+    void read_blocks(const std::vector<std::uint64_t> &blocks, OnBlockT &&on_block);
+
+    /// file descriptor
+    int m_fd{-1};
+    /// number of squashed enotes in the file
+    std::size_t m_num_enotes{0};
+    /// true if the file is read with O_DIRECT
+    bool m_direct_io{false};
+    /// max number of block reads in flight
+    std::size_t m_queue_depth{0};
+    /// block-aligned read buffers (one per in-flight read)
+    unsigned char *m_buffers{nullptr};
+    /// io_uring instance (nullptr if unavailable)
+    std::unique_ptr<IoUring> m_ring;
+};
+
+/// file block size (reads are whole, aligned blocks, as direct I/O needs)
+constexpr std::size_t MOCK_SQUASHED_ENOTE_FILE_BLOCK_SIZE{4096};
+
+/**
+* brief: write_mock_squashed_enote_file - write the first 'num_enotes' squashed enotes of a ledger to a flat file
+* param: path - file to (over)write
+* param: ledger_context -
+* param: num_enotes -
+*/
+void write_mock_squashed_enote_file(const std::string &path,
+    const LedgerContext &ledger_context,
+    const std::size_t num_enotes);
+
+} //namespace mock_tx
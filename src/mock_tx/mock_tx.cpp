@@ -33,6 +33,7 @@
 
 //local headers
 #include "ledger_context.h"
+#include "mock_tx_phase_timers.h"
 
 //third party headers
 
@@ -46,19 +47,8 @@ namespace mock_tx
 //-----------------------------------------------------------------
 bool MockTx::validate(const std::shared_ptr<const LedgerContext> ledger_context, const bool defer_batchable) const
 {
-    if (!validate_tx_semantics())
-        return false;
-
-    if (!validate_tx_linking_tags(ledger_context))
-        return false;
-
-    if (!validate_tx_amount_balance(defer_batchable))
-        return false;
-
-    if (!validate_tx_input_proofs(ledger_context, defer_batchable))
-        return false;
-
-    return true;
+    // virtual dispatch of each step (tx types with a known static type use validate_mock_tx<MockTxType>() directly)
+    return validate_mock_tx<MockTx>(*this, ledger_context, defer_batchable);
 }
 //-----------------------------------------------------------------
 } //namespace mock_tx
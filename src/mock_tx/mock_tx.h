@@ -32,26 +32,48 @@
 #pragma once
 
 //local headers
+#include "mock_tx_phase_timers.h"
+#include "mock_tx_verification_cost.h"
 
 //third party headers
+#include "ringct/multiexp.h"
 #include "ringct/rctTypes.h"
 
 //standard headers
+#include <algorithm>
 #include <memory>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 //forward declarations
 namespace mock_tx
 {
     class LedgerContext;
-    class MockLedgerContext;
+    class MockTx;
 }
 
 
 namespace mock_tx
 {
 
+/**
+* brief: validate_mock_tx - validate a tx with its validation steps statically dispatched
+*   - same steps as MockTx::validate(); for a concrete (final) tx type the step calls are direct, so the compiler can
+*     inline them (MockTx::validate() dispatches each step through the vtable)
+*   - with MockTxType = MockTx, the steps are dispatched virtually (for heterogeneous tx containers)
+*   - works for any tx type with the four validation steps, including ones outside the MockTx hierarchy (tx views)
+* type: MockTxType - tx type
+* param: tx - tx to validate
+* param: ledger_context -
+* param: defer_batchable - if set, then batchable validation steps aren't executed
+* return: true/false on validation result
+*/
+template <typename MockTxType>
+bool validate_mock_tx(const MockTxType &tx,
+    const std::shared_ptr<const LedgerContext> &ledger_context,
+    const bool defer_batchable = false);
+
 ////
 // MockTxParamPack - parameter pack for mock tx
 ///
@@ -60,6 +82,16 @@ struct MockTxParamPack
     std::size_t max_rangeproof_splits;
     std::size_t ref_set_decomp_n;
     std::size_t ref_set_decomp_m;
+    /// squashed Seraphis ref sets: number of consecutive ledger enotes per bin (0 = one run per ref set)
+    std::size_t ref_set_bin_size{0};
+    /// squashed Seraphis ref sets: pick decoys with wallet2's gamma distribution from the first this-many ledger enotes
+    ///   (0 = make fresh decoys)
+    std::size_t ref_set_gamma_decoy_enotes{0};
+    /// unsquashed Seraphis ref sets (plain/concise/merge): all inputs reference one shared ref set, each with its real
+    ///   enote at its own index (needs n^m >= number of inputs)
+    bool shared_ref_set{false};
+    /// max number of threads for making ref sets and proving inputs (0 = threadpool max concurrency; 1 = serial)
+    std::size_t num_threads{1};
 };
 
 ////
@@ -89,6 +121,9 @@ public:
     /// get a short description of the tx type
     virtual std::string get_descriptor() const = 0;
 
+    /// estimate the work to verify the tx, without verifying it (e.g. to prioritize or cap txs by verification cost)
+    virtual MockTxVerificationOps estimate_verification_ops() const = 0;
+
     /// get the tx version string: era | format | validation rules
     static void get_versioning_string(const unsigned char tx_era_version,
         const unsigned char tx_format_version,
@@ -107,6 +142,10 @@ public:
     //get_tx_byte_blob()
 
 private:
+    // validation steps (see validate_mock_tx())
+    template <typename MockTxType>
+    friend bool validate_mock_tx(const MockTxType&, const std::shared_ptr<const LedgerContext>&, const bool);
+
     virtual bool validate_tx_semantics() const = 0;
     virtual bool validate_tx_linking_tags(const std::shared_ptr<const LedgerContext> ledger_context) const = 0;
     // e.g. sum(inputs) == sum(outputs), range proofs
@@ -124,6 +163,41 @@ protected:
     unsigned char m_tx_validation_rules_version;
 };
 
+/// validate_mock_tx (declared above)
+template <typename MockTxType>
+bool validate_mock_tx(const MockTxType &tx,
+    const std::shared_ptr<const LedgerContext> &ledger_context,
+    const bool defer_batchable)
+{
+    static_assert(std::is_same<MockTx, MockTxType>::value || std::is_final<MockTxType>::value,
+        "Static dispatch needs a final tx type.");
+
+    {
+        MOCK_TX_PHASE_TIMER(SEMANTICS);
+        if (!tx.validate_tx_semantics())
+            return false;
+    }
+
+    {
+        MOCK_TX_PHASE_TIMER(LINKING_TAGS);
+        if (!tx.validate_tx_linking_tags(ledger_context))
+            return false;
+    }
+
+    {
+        MOCK_TX_PHASE_TIMER(AMOUNT_BALANCE);
+        if (!tx.validate_tx_amount_balance(defer_batchable))
+            return false;
+    }
+
+    {
+        MOCK_TX_PHASE_TIMER(INPUT_PROOFS);
+        if (!tx.validate_tx_input_proofs(ledger_context, defer_batchable))
+            return false;
+    }
+
+    return true;
+}
 /**
 * brief: make_mock_tx - make a mock transaction
 * type: MockTxType - 
@@ -136,15 +210,97 @@ template <typename MockTxType>
 std::shared_ptr<MockTxType> make_mock_tx(const MockTxParamPack &params,
     const std::vector<rct::xmr_amount> &in_amounts,
     const std::vector<rct::xmr_amount> &out_amounts,
-    std::shared_ptr<MockLedgerContext> ledger_context = nullptr);
+    std::shared_ptr<LedgerContext> ledger_context = nullptr);
+/**
+* brief: try_get_mock_txs_batch_validation_data - validate the unbatchable parts of a range of mock txs, and collect
+*   their batchable parts as pippenger data sets (to be checked with sp::check_pippenger_data())
+* type: MockTxType -
+* param: txs_to_validate -
+* param: begin_index - first tx of the range
+* param: end_index - one past the last tx of the range
+* param: ledger_context -
+* outparam: prep_datas_out - pippenger data sets for the range's batchable proofs
+* return: false if a tx failed its unbatchable checks or its batch data couldn't be collected
+*/
+template <typename MockTxType>
+bool try_get_mock_txs_batch_validation_data(const std::vector<std::shared_ptr<MockTxType>> &txs_to_validate,
+    const std::size_t begin_index,
+    const std::size_t end_index,
+    const std::shared_ptr<const LedgerContext> ledger_context,
+    std::vector<rct::pippenger_prep_data> &prep_datas_out);
 /**
 * brief: validate_mock_txs - validate a set of mock tx (use batching if possible)
+*   - the per-tx prepare phase is split across the threadpool, then all batch data is verified at once
 * type: MockTxType - 
 * param: txs_to_validate -
+* param: ledger_context -
+* param: num_threads - max number of threads to use (0 = threadpool max concurrency; 1 = serial)
 * return: true/false on verification result
 */
 template <typename MockTxType>
 bool validate_mock_txs(const std::vector<std::shared_ptr<MockTxType>> &txs_to_validate,
-    const std::shared_ptr<const LedgerContext> ledger_context);
+    const std::shared_ptr<const LedgerContext> ledger_context,
+    const std::size_t num_threads = 0);
+/**
+* brief: validate_mock_txs - validate a set of mock tx in one batch, and find the invalid txs if the batch fails
+*   - each tx's batchable proofs form one pippenger data segment; a failed batch is bisected over the segments, so
+*     a few bad txs cost O(log n) multiexps each instead of re-verifying every tx on its own
+* type: MockTxType -
+* param: txs_to_validate -
+* param: ledger_context -
+* outparam: invalid_tx_indices_out - indices of the invalid txs (sorted)
+* param: num_threads - max number of threads for batch multiexps (0 = threadpool max concurrency; 1 = serial)
+* return: true if all txs are valid
+*/
+template <typename MockTxType>
+bool validate_mock_txs(const std::vector<std::shared_ptr<MockTxType>> &txs_to_validate,
+    const std::shared_ptr<const LedgerContext> ledger_context,
+    std::vector<std::size_t> &invalid_tx_indices_out,
+    const std::size_t num_threads = 0)
+{
+    invalid_tx_indices_out.clear();
+
+    // collect one segment per tx (txs that fail their unbatchable checks are invalid right away)
+    std::vector<std::vector<rct::pippenger_prep_data>> segments;
+    std::vector<std::size_t> segment_tx_indices;
+    segments.reserve(txs_to_validate.size());
+    segment_tx_indices.reserve(txs_to_validate.size());
+
+    for (std::size_t tx_index{0}; tx_index < txs_to_validate.size(); ++tx_index)
+    {
+        std::vector<rct::pippenger_prep_data> tx_prep_datas;
+        bool tx_ok{false};
+
+        try
+        {
+            tx_ok = try_get_mock_txs_batch_validation_data<MockTxType>(txs_to_validate,
+                tx_index,
+                tx_index + 1,
+                ledger_context,
+                tx_prep_datas);
+        }
+        catch (...)
+        {
+            tx_ok = false;
+        }
+
+        if (!tx_ok)
+        {
+            invalid_tx_indices_out.emplace_back(tx_index);
+            continue;
+        }
+
+        segments.emplace_back(std::move(tx_prep_datas));
+        segment_tx_indices.emplace_back(tx_index);
+    }
+
+    // batch-verify the segments and map failures back to txs
+    for (const std::size_t failing_segment : rct::pippenger_find_failing_segments(segments, num_threads))
+        invalid_tx_indices_out.emplace_back(segment_tx_indices[failing_segment]);
+
+    std::sort(invalid_tx_indices_out.begin(), invalid_tx_indices_out.end());
+
+    return invalid_tx_indices_out.empty();
+}
 
 } //namespace mock_tx
@@ -0,0 +1,353 @@
+// Copyright (c) 2021, The Monero Project
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of
+//    conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list
+//    of conditions and the following disclaimer in the documentation and/or other
+//    materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be
+//    used to endorse or promote products derived from this software without specific
+//    prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+// THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// Streaming batch verifier for mock txs: accumulates txs one at a time and batch-verifies them on size or deadline.
+// NOT FOR PRODUCTION
+
+#pragma once
+
+//local headers
+#include "ledger_context.h"
+#include "mock_tx.h"
+#include "ringct/multiexp.h"
+
+//third party headers
+
+//standard headers
+#include <array>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+//forward declarations
+
+
+namespace mock_tx
+{
+
+////
+// MockTxVerificationLane - priority of a tx added to a MockTxBatchVerifier
+///
+enum class MockTxVerificationLane : unsigned char
+{
+    /// relay traffic: fills large batches
+    BULK,
+    /// e.g. txs from our own wallets, or txs of a block being reconstructed: verified without waiting for a bulk flush
+    URGENT
+};
+
+////
+// MockTxUrgentFlushPolicy - how urgent txs get verified early
+///
+enum class MockTxUrgentFlushPolicy : unsigned char
+{
+    /// urgent txs are verified in their own small batch (on the urgent lane's point limit and deadline), and the bulk
+    /// batch keeps filling
+    OWN_BATCH,
+    /// an urgent tx joins the bulk batch and flushes it right away
+    FLUSH_BULK
+};
+
+////
+// MockTxBatchVerifier - verify a stream of mock txs in batches
+// - The unbatchable parts of a tx are checked as soon as it is added. Its batchable parts are kept as a pippenger data
+//   segment, and pending segments are verified together when the batch reaches a point count or latency deadline.
+// - If a batch fails, the failing txs are found by bisecting over the segments (rct::pippenger_find_failing_segments()),
+//   so one bad tx costs O(log n) multiexps instead of re-verifying every tx on its own.
+// - Txs are added to a lane: bulk txs fill the batch described above, while urgent txs are verified early (see
+//   MockTxUrgentFlushPolicy; by default each urgent tx is verified on its own as soon as it is added).
+// - The latency of each tx (from add_tx() until its verification finished) is recorded per lane.
+// - The deadline is only checked when txs are added or flush_if_due() is called (no background thread).
+// - Not thread-safe.
+///
+template <typename MockTxType>
+class MockTxBatchVerifier final
+{
+public:
+//constructors
+    /**
+    * brief: construct a batch verifier
+    * param: ledger_context -
+    * param: max_batch_points - flush once the pending batch has at least this many multiexp points (0 = no limit)
+    * param: max_batch_delay - flush once the oldest pending tx has waited at least this long
+    * param: num_threads - max number of threads for batch multiexps (0 = threadpool max concurrency; 1 = serial)
+    */
+    MockTxBatchVerifier(std::shared_ptr<const LedgerContext> ledger_context,
+        const std::size_t max_batch_points,
+        const std::chrono::milliseconds max_batch_delay,
+        const std::size_t num_threads = 0) :
+            m_ledger_context{std::move(ledger_context)},
+            m_num_threads{num_threads}
+    {
+        m_lanes[lane_index(MockTxVerificationLane::BULK)].m_max_batch_points = max_batch_points;
+        m_lanes[lane_index(MockTxVerificationLane::BULK)].m_max_batch_delay = max_batch_delay;
+    }
+
+//member functions
+    /**
+    * brief: set_urgent_policy - set how urgent txs are verified
+    *   - pending urgent txs are flushed first
+    * param: policy -
+    * param: max_urgent_batch_points - OWN_BATCH: flush the urgent batch at this many multiexp points (0 = no limit)
+    * param: max_urgent_batch_delay - OWN_BATCH: flush the urgent batch once its oldest tx has waited this long (0 =
+    *   verify each urgent tx as soon as it is added)
+    */
+    void set_urgent_policy(const MockTxUrgentFlushPolicy policy,
+        const std::size_t max_urgent_batch_points = 0,
+        const std::chrono::milliseconds max_urgent_batch_delay = std::chrono::milliseconds{0})
+    {
+        PendingBatch &urgent_batch{m_lanes[lane_index(MockTxVerificationLane::URGENT)]};
+        flush_batch(urgent_batch);
+
+        m_urgent_policy = policy;
+        urgent_batch.m_max_batch_points = max_urgent_batch_points;
+        urgent_batch.m_max_batch_delay = max_urgent_batch_delay;
+    }
+    /**
+    * brief: add_tx - add a tx to a lane's pending batch
+    *   - a tx that fails its unbatchable checks is reported as invalid right away
+    *   - flushes the batch if it reached the point limit or deadline, or if an urgent tx flushes the bulk batch
+    * param: tx -
+    * param: lane -
+    * return: false if the tx failed its unbatchable checks
+    */
+    bool add_tx(std::shared_ptr<MockTxType> tx, const MockTxVerificationLane lane = MockTxVerificationLane::BULK)
+    {
+        const std::chrono::steady_clock::time_point add_time{std::chrono::steady_clock::now()};
+
+        std::vector<std::shared_ptr<MockTxType>> tx_wrapper{tx};
+        std::vector<rct::pippenger_prep_data> tx_prep_datas;
+        bool tx_ok{false};
+
+        try
+        {
+            tx_ok = try_get_mock_txs_batch_validation_data<MockTxType>(tx_wrapper,
+                0,
+                1,
+                m_ledger_context,
+                tx_prep_datas);
+        }
+        catch (...)
+        {
+            tx_ok = false;
+        }
+
+        if (!tx_ok)
+        {
+            m_invalid_txs.emplace_back(std::move(tx));
+            m_lane_latencies[lane_index(lane)].emplace_back(std::chrono::steady_clock::now() - add_time);
+            flush_if_due();
+            return false;
+        }
+
+        // urgent txs that flush the bulk batch are added to it
+        const bool flush_bulk_now{
+                lane == MockTxVerificationLane::URGENT && m_urgent_policy == MockTxUrgentFlushPolicy::FLUSH_BULK
+            };
+        PendingBatch &batch{
+                m_lanes[lane_index(flush_bulk_now ? MockTxVerificationLane::BULK : lane)]
+            };
+
+        if (batch.m_txs.size() == 0)
+            batch.m_oldest_pending_time = add_time;
+
+        for (const rct::pippenger_prep_data &prep_data : tx_prep_datas)
+            batch.m_points += prep_data.data.size();
+
+        batch.m_txs.emplace_back(std::move(tx));
+        batch.m_prep_datas.emplace_back(std::move(tx_prep_datas));
+        batch.m_tx_lanes.emplace_back(lane);
+        batch.m_add_times.emplace_back(add_time);
+
+        if (flush_bulk_now || (batch.m_max_batch_points > 0 && batch.m_points >= batch.m_max_batch_points))
+            flush_batch(batch);
+
+        flush_if_due();
+
+        return true;
+    }
+    /**
+    * brief: flush_if_due - flush each lane's pending batch if its oldest tx has reached the lane's deadline (urgent
+    *   lane first)
+    * return: true if a batch was flushed
+    */
+    bool flush_if_due()
+    {
+        bool flushed{false};
+        const std::chrono::steady_clock::time_point now{std::chrono::steady_clock::now()};
+
+        for (const MockTxVerificationLane lane : {MockTxVerificationLane::URGENT, MockTxVerificationLane::BULK})
+        {
+            PendingBatch &batch{m_lanes[lane_index(lane)]};
+            if (batch.m_txs.size() == 0)
+                continue;
+
+            if (now - batch.m_oldest_pending_time < batch.m_max_batch_delay)
+                continue;
+
+            flush_batch(batch);
+            flushed = true;
+        }
+
+        return flushed;
+    }
+    /**
+    * brief: flush - batch-verify all pending txs (urgent lane first)
+    */
+    void flush()
+    {
+        flush_batch(m_lanes[lane_index(MockTxVerificationLane::URGENT)]);
+        flush_batch(m_lanes[lane_index(MockTxVerificationLane::BULK)]);
+    }
+    /**
+    * brief: take_verified_txs - take the txs that finished verification since the last call
+    * outparam: valid_txs_out -
+    * outparam: invalid_txs_out -
+    */
+    void take_verified_txs(std::vector<std::shared_ptr<MockTxType>> &valid_txs_out,
+        std::vector<std::shared_ptr<MockTxType>> &invalid_txs_out)
+    {
+        valid_txs_out = std::move(m_valid_txs);
+        invalid_txs_out = std::move(m_invalid_txs);
+        m_valid_txs.clear();
+        m_invalid_txs.clear();
+    }
+    /**
+    * brief: take_lane_latencies - take the latencies of a lane's txs that finished verification since the last call
+    * param: lane -
+    * outparam: latencies_out - time from add_tx() until each tx's verification finished (in verification order)
+    */
+    void take_lane_latencies(const MockTxVerificationLane lane, std::vector<std::chrono::nanoseconds> &latencies_out)
+    {
+        latencies_out = std::move(m_lane_latencies[lane_index(lane)]);
+        m_lane_latencies[lane_index(lane)].clear();
+    }
+
+    /// number of txs waiting for batch verification
+    std::size_t num_pending_txs() const
+    {
+        std::size_t num_txs{0};
+        for (const PendingBatch &batch : m_lanes)
+            num_txs += batch.m_txs.size();
+
+        return num_txs;
+    }
+    /// number of multiexp points waiting for batch verification
+    std::size_t num_pending_points() const
+    {
+        std::size_t num_points{0};
+        for (const PendingBatch &batch : m_lanes)
+            num_points += batch.m_points;
+
+        return num_points;
+    }
+
+private:
+    /// number of lanes
+    static constexpr std::size_t NUM_LANES{2};
+
+    /// a lane's pending txs and their pippenger data segments (one segment per tx), with its flush policy
+    struct PendingBatch final
+    {
+        std::size_t m_max_batch_points{0};
+        std::chrono::milliseconds m_max_batch_delay{0};
+
+        std::vector<std::shared_ptr<MockTxType>> m_txs;
+        std::vector<std::vector<rct::pippenger_prep_data>> m_prep_datas;
+        /// lane each tx was added to (urgent txs can join the bulk batch)
+        std::vector<MockTxVerificationLane> m_tx_lanes;
+        std::vector<std::chrono::steady_clock::time_point> m_add_times;
+        std::size_t m_points{0};
+        std::chrono::steady_clock::time_point m_oldest_pending_time;
+    };
+
+    static std::size_t lane_index(const MockTxVerificationLane lane)
+    {
+        return static_cast<std::size_t>(lane);
+    }
+
+    /// batch-verify a lane's pending txs
+    void flush_batch(PendingBatch &batch)
+    {
+        if (batch.m_txs.size() == 0)
+            return;
+
+        // one segment per pending tx: a single multiexp if the batch passes, bisection otherwise
+        std::vector<std::size_t> failing_tx_indices;
+        try
+        {
+            failing_tx_indices = rct::pippenger_find_failing_segments(batch.m_prep_datas, m_num_threads);
+        }
+        catch (...)
+        {
+            failing_tx_indices.resize(batch.m_txs.size());
+            for (std::size_t tx_index{0}; tx_index < batch.m_txs.size(); ++tx_index)
+                failing_tx_indices[tx_index] = tx_index;
+        }
+        const std::chrono::steady_clock::time_point verified_time{std::chrono::steady_clock::now()};
+
+        std::size_t failing_pos{0};
+        for (std::size_t tx_index{0}; tx_index < batch.m_txs.size(); ++tx_index)
+        {
+            if (failing_pos < failing_tx_indices.size() && failing_tx_indices[failing_pos] == tx_index)
+            {
+                m_invalid_txs.emplace_back(std::move(batch.m_txs[tx_index]));
+                ++failing_pos;
+            }
+            else
+                m_valid_txs.emplace_back(std::move(batch.m_txs[tx_index]));
+
+            m_lane_latencies[lane_index(batch.m_tx_lanes[tx_index])].emplace_back(
+                    verified_time - batch.m_add_times[tx_index]
+                );
+        }
+
+        batch.m_txs.clear();
+        batch.m_prep_datas.clear();
+        batch.m_tx_lanes.clear();
+        batch.m_add_times.clear();
+        batch.m_points = 0;
+    }
+
+//member variables
+    /// ledger for unbatchable checks and reference set lookups
+    std::shared_ptr<const LedgerContext> m_ledger_context;
+    /// threads for batch multiexps
+    std::size_t m_num_threads;
+
+    /// pending batches (indexed by lane), and how urgent txs are verified early
+    std::array<PendingBatch, NUM_LANES> m_lanes;
+    MockTxUrgentFlushPolicy m_urgent_policy{MockTxUrgentFlushPolicy::OWN_BATCH};
+
+    /// verified txs that haven't been taken yet
+    std::vector<std::shared_ptr<MockTxType>> m_valid_txs;
+    std::vector<std::shared_ptr<MockTxType>> m_invalid_txs;
+    /// latencies of verified txs that haven't been taken yet (indexed by lane)
+    std::array<std::vector<std::chrono::nanoseconds>, NUM_LANES> m_lane_latencies;
+};
+
+} //namespace mock_tx
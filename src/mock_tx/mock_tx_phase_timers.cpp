@@ -0,0 +1,116 @@
+// Copyright (c) 2021, The Monero Project
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this list of
+//    conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list
+//    of conditions and the following disclaimer in the documentation and/or other
+//    materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its contributors may be
+//    used to endorse or promote products derived from this software without specific
+//    prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+// THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// NOT FOR PRODUCTION
+
+//paired header
+#include "mock_tx_phase_timers.h"
+
+//local headers
+
+//third party headers
+
+//standard headers
+#include <atomic>
+#include <cstdint>
+
+#undef MONERO_DEFAULT_LOG_CATEGORY
+#define MONERO_DEFAULT_LOG_CATEGORY "mock_tx"
+
+namespace mock_tx
+{
+
+static constexpr std::size_t NUM_MOCK_TX_PHASES{static_cast<std::size_t>(MockTxValidationPhase::NUM_PHASES)};
+
+/// phase totals (relaxed atomics: timers on different threads only need their adds to be atomic)
+static std::atomic<std::uint64_t> s_phase_ns[NUM_MOCK_TX_PHASES];
+static std::atomic<std::uint64_t> s_phase_calls[NUM_MOCK_TX_PHASES];
+
+//-------------------------------------------------------------------------------------------------------------------
+bool mock_tx_phase_timers_enabled()
+{
+#ifdef MOCK_TX_PHASE_TIMERS
+    return true;
+#else
+    return false;
+#endif
+}
+//-------------------------------------------------------------------------------------------------------------------
+const char* get_mock_tx_phase_name(const MockTxValidationPhase phase)
+{
+    switch (phase)
+    {
+        case MockTxValidationPhase::SEMANTICS: return "semantics";
+        case MockTxValidationPhase::LINKING_TAGS: return "linking tags";
+        case MockTxValidationPhase::AMOUNT_BALANCE: return "amount balance";
+        case MockTxValidationPhase::INPUT_PROOFS: return "input proofs";
+        case MockTxValidationPhase::REF_SET_FETCH: return "ref set fetch";
+        case MockTxValidationPhase::MEMBERSHIP_PROOF_DATA: return "membership proof data";
+        case MockTxValidationPhase::RANGE_PROOF_DATA: return "range proof data";
+        case MockTxValidationPhase::COMPOSITION_PROOF_DATA: return "composition proof data";
+        case MockTxValidationPhase::MULTIEXP: return "multiexp";
+        case MockTxValidationPhase::REF_SET_BUILD: return "ref set build";
+        case MockTxValidationPhase::MEMBERSHIP_PROOF_PROVE: return "membership proof prove";
+        case MockTxValidationPhase::RANGE_PROOF_PROVE: return "range proof prove";
+        case MockTxValidationPhase::COMPOSITION_PROOF_PROVE: return "composition proof prove";
+        default: return "unknown";
+    }
+}
+//-------------------------------------------------------------------------------------------------------------------
+void reset_mock_tx_phase_timings()
+{
+    for (std::size_t phase_index{0}; phase_index < NUM_MOCK_TX_PHASES; ++phase_index)
+    {
+        s_phase_ns[phase_index].store(0, std::memory_order_relaxed);
+        s_phase_calls[phase_index].store(0, std::memory_order_relaxed);
+    }
+}
+//-------------------------------------------------------------------------------------------------------------------
+MockTxPhaseTimings get_mock_tx_phase_timings()
+{
+    MockTxPhaseTimings timings;
+
+    for (std::size_t phase_index{0}; phase_index < NUM_MOCK_TX_PHASES; ++phase_index)
+    {
+        timings.m_ns[phase_index] = s_phase_ns[phase_index].load(std::memory_order_relaxed);
+        timings.m_calls[phase_index] = s_phase_calls[phase_index].load(std::memory_order_relaxed);
+    }
+
+    return timings;
+}
+//-------------------------------------------------------------------------------------------------------------------
+void add_mock_tx_phase_time(const MockTxValidationPhase phase, const std::uint64_t ns)
+{
+    const std::size_t phase_index{static_cast<std::size_t>(phase)};
+    if (phase_index >= NUM_MOCK_TX_PHASES)
+        return;
+
+    s_phase_ns[phase_index].fetch_add(ns, std::memory_order_relaxed);
+    s_phase_calls[phase_index].fetch_add(1, std::memory_order_relaxed);
+}
+//-------------------------------------------------------------------------------------------------------------------
+} //namespace mock_tx
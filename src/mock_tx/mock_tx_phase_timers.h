@@ -0,0 +1,137 @@
+// Copyright (c) 2021, The Monero Project
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this list of
+//    conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list
+//    of conditions and the following disclaimer in the documentation and/or other
+//    materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its contributors may be
+//    used to endorse or promote products derived from this software without specific
+//    prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+// THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// Phase timers for mock tx validation and proving: where validate_mock_txs() and make_mock_tx() spend their time.
+// NOT FOR PRODUCTION
+
+#pragma once
+
+//local headers
+#include "common/perf_timer.h"
+
+//third party headers
+
+//standard headers
+#include <array>
+#include <cstdint>
+
+//forward declarations
+
+
+namespace mock_tx
+{
+
+////
+// MockTxValidationPhase - timed phases of mock tx validation, then of making mock txs
+// - phases may nest: ref set fetches are part of membership proof data assembly, and multiexps done inside
+//   unbatched proof checks are part of those checks (batched validation keeps them apart)
+///
+enum class MockTxValidationPhase : unsigned char
+{
+    /// tx semantics checks (component counts, ref set sizes, sorting, input image semantics)
+    SEMANTICS,
+    /// linking tag lookups in the ledger
+    LINKING_TAGS,
+    /// amount balance checks (and range proofs, if not deferred to a batch)
+    AMOUNT_BALANCE,
+    /// input proof checks that are not deferred to a batch (e.g. CLSAG)
+    INPUT_PROOFS,
+    /// reading ref set members from the ledger
+    REF_SET_FETCH,
+    /// assembling membership proof (Grootle/Triptych) verification data for a batch
+    MEMBERSHIP_PROOF_DATA,
+    /// assembling range proof (BP+) and amount balance verification data for a batch
+    RANGE_PROOF_DATA,
+    /// assembling composition proof verification data for a batch
+    COMPOSITION_PROOF_DATA,
+    /// multiexps that check pippenger data
+    MULTIEXP,
+    /// making ref sets for new txs (picking or making their members, and adding new members to the ledger)
+    REF_SET_BUILD,
+    /// proving membership (Grootle/Triptych proofs, or CLSAG ring signatures)
+    MEMBERSHIP_PROOF_PROVE,
+    /// proving ranges (BP+)
+    RANGE_PROOF_PROVE,
+    /// proving composition (Seraphis image proofs)
+    COMPOSITION_PROOF_PROVE,
+    NUM_PHASES
+};
+
+////
+// MockTxPhaseTimings - total time and number of timed calls per phase
+// - time is summed over threads, so phases that run on several threads can add up to more than the wall time
+///
+struct MockTxPhaseTimings final
+{
+    std::array<std::uint64_t, static_cast<std::size_t>(MockTxValidationPhase::NUM_PHASES)> m_ns{};
+    std::array<std::uint64_t, static_cast<std::size_t>(MockTxValidationPhase::NUM_PHASES)> m_calls{};
+};
+
+/// true if the mock_tx library was built with phase timers (cmake -DMOCK_TX_PHASE_TIMERS=ON)
+bool mock_tx_phase_timers_enabled();
+/// short name of a phase (e.g. for reports)
+const char* get_mock_tx_phase_name(const MockTxValidationPhase phase);
+/// clear the phase totals
+void reset_mock_tx_phase_timings();
+/// read the phase totals since the last reset
+MockTxPhaseTimings get_mock_tx_phase_timings();
+/// add a timed call to a phase's totals
+void add_mock_tx_phase_time(const MockTxValidationPhase phase, const std::uint64_t ns);
+
+////
+// MockTxPhaseTimer - adds the time from its construction to its destruction to a phase's totals
+///
+class MockTxPhaseTimer final
+{
+public:
+    explicit MockTxPhaseTimer(const MockTxValidationPhase phase) :
+        m_phase{phase},
+        m_start_ticks{tools::get_tick_count()}
+    {}
+
+    ~MockTxPhaseTimer()
+    {
+        add_mock_tx_phase_time(m_phase, tools::ticks_to_ns(tools::get_tick_count() - m_start_ticks));
+    }
+
+    MockTxPhaseTimer(const MockTxPhaseTimer&) = delete;
+    MockTxPhaseTimer& operator=(const MockTxPhaseTimer&) = delete;
+
+private:
+    const MockTxValidationPhase m_phase;
+    const std::uint64_t m_start_ticks;
+};
+
+/// time the rest of the enclosing scope as a phase (compiled out unless MOCK_TX_PHASE_TIMERS is defined)
+#ifdef MOCK_TX_PHASE_TIMERS
+#define MOCK_TX_PHASE_TIMER(phase) \
+    ::mock_tx::MockTxPhaseTimer mock_tx_phase_timer_##phase{::mock_tx::MockTxValidationPhase::phase}
+#else
+#define MOCK_TX_PHASE_TIMER(phase) do {} while (0)
+#endif
+
+} //namespace mock_tx
@@ -0,0 +1,539 @@
+// Copyright (c) 2021, The Monero Project
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of
+//    conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list
+//    of conditions and the following disclaimer in the documentation and/or other
+//    materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be
+//    used to endorse or promote products derived from this software without specific
+//    prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+// THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// Mock mempool for Seraphis mock txs: dedup, linking tag conflicts among pending txs, and batch-verified admission.
+// NOT FOR PRODUCTION
+
+#pragma once
+
+//local headers
+#include "crypto/crypto.h"
+#include "crypto/hash.h"
+#include "ledger_context.h"
+#include "mock_sp_transaction_utils.h"
+#include "mock_tx.h"
+#include "mock_tx_batch_verifier.h"
+
+//third party headers
+
+//standard headers
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+//forward declarations
+
+
+namespace mock_tx
+{
+
+////
+// MockTxPoolSubmitResult - outcome of submitting a tx to a MockTxPool
+///
+enum class MockTxPoolSubmitResult : unsigned char
+{
+    /// the tx claimed its linking tags and is waiting for batch verification
+    PENDING,
+    /// the tx is already in the pool
+    DUPLICATE,
+    /// another tx in the pool spends one of the tx's linking tags (the first one seen wins)
+    CONFLICT,
+    /// one of the tx's linking tags is in the ledger
+    SPENT
+};
+
+////
+// MockTxPoolStats - counts of what happened to the txs submitted to a MockTxPool
+///
+struct MockTxPoolStats final
+{
+    std::size_t m_submitted{0};
+    std::size_t m_duplicates{0};
+    std::size_t m_conflicts{0};
+    std::size_t m_spent{0};
+    /// txs that failed verification
+    std::size_t m_invalid{0};
+    /// txs that passed verification
+    std::size_t m_admitted{0};
+    /// pool txs that were dropped because a tx added to the ledger spent one of their linking tags
+    std::size_t m_evicted{0};
+    /// pool txs that were added to the ledger
+    std::size_t m_included{0};
+};
+
+////
+// MockTxPool - pool of Seraphis mock txs waiting to be added to a ledger
+// - A tx's pool id is H(image proof message, linking tags), so resubmissions of a tx are found without looking at its
+//   proofs.
+// - Pending linking tags are indexed in sharded maps (tag -> id of the pool tx that spends it), each with its own
+//   lock. A submitted tx claims all of its tags at once (locking their shards in shard order), so exactly one of a set
+//   of conflicting txs gets in, even if they are submitted at the same time from different threads.
+// - Submitted txs wait in a queue until process_admissions() feeds them to a MockTxBatchVerifier (bulk lane). Txs
+//   that pass are admitted; txs that fail are dropped and their linking tags are released.
+// - add_tx_to_ledger() adds a tx to the ledger, then drops every pool tx that spends one of its linking tags (the tx
+//   itself if it came from the pool, and any conflicting txs).
+// - submit_tx(), add_tx_to_ledger(), and the getters are thread-safe. process_admissions() may be called from any
+//   thread, but only runs on one thread at a time.
+///
+template <typename MockTxType>
+class MockTxPool final
+{
+public:
+//constructors
+    /**
+    * brief: construct a tx pool
+    * param: ledger_context -
+    * param: max_batch_points - verify pending txs once they have at least this many multiexp points (0 = no limit)
+    * param: max_batch_delay - verify pending txs once the oldest one has waited at least this long
+    * param: num_threads - max number of threads for batch multiexps (0 = threadpool max concurrency; 1 = serial)
+    */
+    MockTxPool(std::shared_ptr<LedgerContext> ledger_context,
+        const std::size_t max_batch_points,
+        const std::chrono::milliseconds max_batch_delay,
+        const std::size_t num_threads = 0) :
+            m_ledger_context{std::move(ledger_context)},
+            m_verifier{m_ledger_context, max_batch_points, max_batch_delay, num_threads}
+    {}
+
+//member functions
+    /**
+    * brief: submit_tx - submit a tx to the pool
+    *   - the tx is not verified here (see process_admissions())
+    * param: tx -
+    * return: PENDING if the tx claimed its linking tags and was queued for verification
+    */
+    MockTxPoolSubmitResult submit_tx(std::shared_ptr<MockTxType> tx)
+    {
+        ++m_stats.m_submitted;
+
+        std::vector<crypto::key_image> linking_tags;
+        get_linking_tags(*tx, linking_tags);
+        const crypto::hash tx_id{get_tx_id(*tx, linking_tags)};
+
+        // reserve the id (catches resubmissions that race with this one)
+        {
+            TxShard &tx_shard{get_tx_shard(tx_id)};
+            std::lock_guard<std::mutex> lock{tx_shard.m_mutex};
+
+            if (!tx_shard.m_txs.emplace(tx_id, TxEntry{tx, linking_tags, false}).second)
+            {
+                ++m_stats.m_duplicates;
+                return MockTxPoolSubmitResult::DUPLICATE;
+            }
+        }
+
+        // txs that spend ledger linking tags can't get in
+        std::vector<bool> spent;
+        m_ledger_context->linking_tags_exist_sp_v1(linking_tags, spent);
+
+        if (std::find(spent.begin(), spent.end(), true) != spent.end())
+        {
+            erase_tx(tx_id);
+            ++m_stats.m_spent;
+            return MockTxPoolSubmitResult::SPENT;
+        }
+
+        // claim the linking tags (first seen wins)
+        if (!claim_linking_tags(tx_id, linking_tags))
+        {
+            erase_tx(tx_id);
+            ++m_stats.m_conflicts;
+            return MockTxPoolSubmitResult::CONFLICT;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock{m_submitted_mutex};
+            m_submitted_txs.emplace_back(tx_id, std::move(tx));
+        }
+
+        return MockTxPoolSubmitResult::PENDING;
+    }
+    /**
+    * brief: process_admissions - feed the submitted txs to the batch verifier, and admit the ones it verified
+    *   - returns right away if another thread is processing admissions
+    * param: force_flush - verify every pending tx now (otherwise only on the verifier's point limit or deadline)
+    * return: number of txs that finished verification
+    */
+    std::size_t process_admissions(const bool force_flush = false)
+    {
+        std::unique_lock<std::mutex> admission_lock{m_admission_mutex, std::try_to_lock};
+        if (!admission_lock.owns_lock())
+            return 0;
+
+        std::vector<std::pair<crypto::hash, std::shared_ptr<MockTxType>>> submitted_txs;
+        {
+            std::lock_guard<std::mutex> lock{m_submitted_mutex};
+            submitted_txs.swap(m_submitted_txs);
+        }
+
+        for (std::pair<crypto::hash, std::shared_ptr<MockTxType>> &submitted_tx : submitted_txs)
+        {
+            m_verifying_tx_ids.emplace(submitted_tx.second.get(), submitted_tx.first);
+            m_verifier.add_tx(std::move(submitted_tx.second), MockTxVerificationLane::BULK);
+        }
+
+        if (force_flush)
+            m_verifier.flush();
+        else
+            m_verifier.flush_if_due();
+
+        std::vector<std::shared_ptr<MockTxType>> valid_txs;
+        std::vector<std::shared_ptr<MockTxType>> invalid_txs;
+        m_verifier.take_verified_txs(valid_txs, invalid_txs);
+
+        // admit valid txs that weren't evicted while they were being verified
+        for (const std::shared_ptr<MockTxType> &valid_tx : valid_txs)
+        {
+            const crypto::hash tx_id{take_verifying_tx_id(*valid_tx)};
+            TxShard &tx_shard{get_tx_shard(tx_id)};
+            std::lock_guard<std::mutex> lock{tx_shard.m_mutex};
+
+            const auto entry{tx_shard.m_txs.find(tx_id)};
+            if (entry == tx_shard.m_txs.end() || entry->second.m_tx != valid_tx)
+                continue;
+
+            entry->second.m_admitted = true;
+            ++m_stats.m_admitted;
+        }
+
+        // drop invalid txs and release their linking tags
+        for (const std::shared_ptr<MockTxType> &invalid_tx : invalid_txs)
+        {
+            const crypto::hash tx_id{take_verifying_tx_id(*invalid_tx)};
+            if (remove_tx(tx_id, invalid_tx.get()))
+                ++m_stats.m_invalid;
+        }
+
+        return valid_txs.size() + invalid_txs.size();
+    }
+    /**
+    * brief: add_tx_to_ledger - add a tx to the ledger, then drop the pool txs that spend any of its linking tags
+    *   - the tx does not need to come from the pool (e.g. a tx from someone else's block)
+    *   - throws if the ledger rejects the tx (the pool is unchanged)
+    * param: tx -
+    * return: number of pool txs that were evicted (not counting the tx itself)
+    */
+    std::size_t add_tx_to_ledger(const MockTxType &tx)
+    {
+        mock_tx::add_tx_to_ledger<MockTxType>(m_ledger_context, tx);
+
+        std::vector<crypto::key_image> linking_tags;
+        get_linking_tags(tx, linking_tags);
+        const crypto::hash tx_id{get_tx_id(tx, linking_tags)};
+
+        // find the pool txs that spend the new ledger tags
+        std::vector<crypto::hash> owner_ids;
+        for (const crypto::key_image &linking_tag : linking_tags)
+        {
+            LinkingTagShard &tag_shard{get_linking_tag_shard(linking_tag)};
+            std::lock_guard<std::mutex> lock{tag_shard.m_mutex};
+
+            const auto owner{tag_shard.m_owners.find(linking_tag)};
+            if (owner != tag_shard.m_owners.end() &&
+                std::find(owner_ids.begin(), owner_ids.end(), owner->second) == owner_ids.end())
+                owner_ids.emplace_back(owner->second);
+        }
+
+        std::size_t num_evicted{0};
+        for (const crypto::hash &owner_id : owner_ids)
+        {
+            if (!remove_tx(owner_id, nullptr))
+                continue;
+
+            if (owner_id == tx_id)
+                ++m_stats.m_included;
+            else
+            {
+                ++m_stats.m_evicted;
+                ++num_evicted;
+            }
+        }
+
+        return num_evicted;
+    }
+    /**
+    * brief: get_admitted_txs - get the txs that passed verification and are still in the pool (in no particular order)
+    * outparam: admitted_txs_out -
+    */
+    void get_admitted_txs(std::vector<std::shared_ptr<MockTxType>> &admitted_txs_out) const
+    {
+        admitted_txs_out.clear();
+
+        for (const TxShard &tx_shard : m_tx_shards)
+        {
+            std::lock_guard<std::mutex> lock{tx_shard.m_mutex};
+
+            for (const auto &entry : tx_shard.m_txs)
+            {
+                if (entry.second.m_admitted)
+                    admitted_txs_out.emplace_back(entry.second.m_tx);
+            }
+        }
+    }
+
+    /// number of txs in the pool (admitted and waiting for verification)
+    std::size_t num_txs() const
+    {
+        std::size_t num_txs{0};
+        for (const TxShard &tx_shard : m_tx_shards)
+        {
+            std::lock_guard<std::mutex> lock{tx_shard.m_mutex};
+            num_txs += tx_shard.m_txs.size();
+        }
+
+        return num_txs;
+    }
+    /// number of txs that passed verification and are still in the pool
+    std::size_t num_admitted_txs() const
+    {
+        std::size_t num_txs{0};
+        for (const TxShard &tx_shard : m_tx_shards)
+        {
+            std::lock_guard<std::mutex> lock{tx_shard.m_mutex};
+            for (const auto &entry : tx_shard.m_txs)
+                num_txs += entry.second.m_admitted ? 1 : 0;
+        }
+
+        return num_txs;
+    }
+    /// counts of what happened to submitted txs so far
+    MockTxPoolStats get_stats() const
+    {
+        MockTxPoolStats stats;
+        stats.m_submitted = m_stats.m_submitted;
+        stats.m_duplicates = m_stats.m_duplicates;
+        stats.m_conflicts = m_stats.m_conflicts;
+        stats.m_spent = m_stats.m_spent;
+        stats.m_invalid = m_stats.m_invalid;
+        stats.m_admitted = m_stats.m_admitted;
+        stats.m_evicted = m_stats.m_evicted;
+        stats.m_included = m_stats.m_included;
+
+        return stats;
+    }
+
+private:
+    /// number of tx and linking tag shards (power of 2)
+    static constexpr std::size_t SHARD_COUNT{16};
+
+    /// a pool tx
+    struct TxEntry final
+    {
+        std::shared_ptr<MockTxType> m_tx;
+        std::vector<crypto::key_image> m_linking_tags;
+        /// passed verification
+        bool m_admitted;
+    };
+
+    /// pool txs with their own lock
+    struct TxShard final
+    {
+        mutable std::mutex m_mutex;
+        std::unordered_map<crypto::hash, TxEntry> m_txs;
+    };
+
+    /// pending linking tags (tag -> id of the pool tx that spends it) with their own lock
+    struct LinkingTagShard final
+    {
+        std::mutex m_mutex;
+        std::unordered_map<crypto::key_image, crypto::hash> m_owners;
+    };
+
+    /// MockTxPoolStats, counted from many threads
+    struct AtomicStats final
+    {
+        std::atomic<std::size_t> m_submitted{0};
+        std::atomic<std::size_t> m_duplicates{0};
+        std::atomic<std::size_t> m_conflicts{0};
+        std::atomic<std::size_t> m_spent{0};
+        std::atomic<std::size_t> m_invalid{0};
+        std::atomic<std::size_t> m_admitted{0};
+        std::atomic<std::size_t> m_evicted{0};
+        std::atomic<std::size_t> m_included{0};
+    };
+
+    static void get_linking_tags(const MockTxType &tx, std::vector<crypto::key_image> &linking_tags_out)
+    {
+        linking_tags_out.clear();
+        linking_tags_out.reserve(tx.m_input_images.size());
+
+        for (const auto &input_image : tx.m_input_images)
+            linking_tags_out.emplace_back(input_image.m_key_image);
+    }
+
+    /// pool id of a tx: H(image proof message, linking tags)
+    static crypto::hash get_tx_id(const MockTxType &tx, const std::vector<crypto::key_image> &linking_tags)
+    {
+        std::string version_string;
+        version_string.reserve(3);
+        tx.MockTx::get_versioning_string(version_string);
+
+        std::string id_data;
+        id_data.reserve(sizeof(rct::key) + linking_tags.size()*sizeof(crypto::key_image));
+
+        const rct::key image_proof_message{
+                get_tx_image_proof_message_sp_v1(version_string, tx.m_outputs, tx.m_supplement)
+            };
+        id_data.append(reinterpret_cast<const char*>(image_proof_message.bytes), sizeof(rct::key));
+        for (const crypto::key_image &linking_tag : linking_tags)
+            id_data.append(linking_tag.data, sizeof(crypto::key_image));
+
+        return crypto::cn_fast_hash(id_data.data(), id_data.size());
+    }
+
+    // note: use a byte not consumed by std::hash<> of the keys (the first 8 bytes), so each shard's map still sees
+    //       well-distributed hashes
+    static std::size_t get_shard_index(const char *key_data)
+    {
+        return static_cast<unsigned char>(key_data[sizeof(std::uint64_t)]) & (SHARD_COUNT - 1);
+    }
+    TxShard& get_tx_shard(const crypto::hash &tx_id)
+    {
+        return m_tx_shards[get_shard_index(tx_id.data)];
+    }
+    LinkingTagShard& get_linking_tag_shard(const crypto::key_image &linking_tag)
+    {
+        return m_linking_tag_shards[get_shard_index(linking_tag.data)];
+    }
+
+    /// lock the shards that own a set of linking tags (in shard order, so concurrent claims can't deadlock)
+    std::vector<std::unique_lock<std::mutex>> lock_linking_tag_shards(
+        const std::vector<crypto::key_image> &linking_tags)
+    {
+        std::vector<std::size_t> shard_indices;
+        shard_indices.reserve(linking_tags.size());
+        for (const crypto::key_image &linking_tag : linking_tags)
+            shard_indices.emplace_back(get_shard_index(linking_tag.data));
+
+        std::sort(shard_indices.begin(), shard_indices.end());
+        shard_indices.erase(std::unique(shard_indices.begin(), shard_indices.end()), shard_indices.end());
+
+        std::vector<std::unique_lock<std::mutex>> locks;
+        locks.reserve(shard_indices.size());
+        for (const std::size_t shard_index : shard_indices)
+            locks.emplace_back(m_linking_tag_shards[shard_index].m_mutex);
+
+        return locks;
+    }
+
+    /// claim all of a tx's linking tags, or none of them if any is already claimed
+    bool claim_linking_tags(const crypto::hash &tx_id, const std::vector<crypto::key_image> &linking_tags)
+    {
+        const std::vector<std::unique_lock<std::mutex>> locks{lock_linking_tag_shards(linking_tags)};
+
+        for (const crypto::key_image &linking_tag : linking_tags)
+        {
+            if (get_linking_tag_shard(linking_tag).m_owners.count(linking_tag) > 0)
+                return false;
+        }
+
+        for (const crypto::key_image &linking_tag : linking_tags)
+            get_linking_tag_shard(linking_tag).m_owners.emplace(linking_tag, tx_id);
+
+        return true;
+    }
+
+    /// erase a tx's entry (its linking tags must not be claimed)
+    void erase_tx(const crypto::hash &tx_id)
+    {
+        TxShard &tx_shard{get_tx_shard(tx_id)};
+        std::lock_guard<std::mutex> lock{tx_shard.m_mutex};
+
+        tx_shard.m_txs.erase(tx_id);
+    }
+
+    /// remove a tx from the pool and release its linking tags (if 'expected_tx' is set, only if it's that tx)
+    bool remove_tx(const crypto::hash &tx_id, const MockTxType *expected_tx)
+    {
+        std::vector<crypto::key_image> linking_tags;
+        {
+            TxShard &tx_shard{get_tx_shard(tx_id)};
+            std::lock_guard<std::mutex> lock{tx_shard.m_mutex};
+
+            const auto entry{tx_shard.m_txs.find(tx_id)};
+            if (entry == tx_shard.m_txs.end() || (expected_tx != nullptr && entry->second.m_tx.get() != expected_tx))
+                return false;
+
+            linking_tags = std::move(entry->second.m_linking_tags);
+            tx_shard.m_txs.erase(entry);
+        }
+
+        const std::vector<std::unique_lock<std::mutex>> locks{lock_linking_tag_shards(linking_tags)};
+        for (const crypto::key_image &linking_tag : linking_tags)
+        {
+            LinkingTagShard &tag_shard{get_linking_tag_shard(linking_tag)};
+            const auto owner{tag_shard.m_owners.find(linking_tag)};
+            if (owner != tag_shard.m_owners.end() && owner->second == tx_id)
+                tag_shard.m_owners.erase(owner);
+        }
+
+        return true;
+    }
+
+    /// get and forget the pool id of a tx handed to the verifier
+    crypto::hash take_verifying_tx_id(const MockTxType &tx)
+    {
+        const auto verifying_tx_id{m_verifying_tx_ids.find(&tx)};
+        if (verifying_tx_id == m_verifying_tx_ids.end())
+            return crypto::null_hash;
+
+        const crypto::hash tx_id{verifying_tx_id->second};
+        m_verifying_tx_ids.erase(verifying_tx_id);
+
+        return tx_id;
+    }
+
+//member variables
+    /// ledger for linking tag checks and tx inclusion
+    std::shared_ptr<LedgerContext> m_ledger_context;
+
+    /// pool txs (sharded by id), and the pending linking tags they spend (sharded by tag)
+    std::array<TxShard, SHARD_COUNT> m_tx_shards;
+    std::array<LinkingTagShard, SHARD_COUNT> m_linking_tag_shards;
+
+    /// txs that claimed their linking tags and haven't been handed to the verifier
+    std::mutex m_submitted_mutex;
+    std::vector<std::pair<crypto::hash, std::shared_ptr<MockTxType>>> m_submitted_txs;
+
+    /// admission: the batch verifier and the pool ids of the txs it holds (a tx can be resubmitted after it was
+    ///   evicted, so the same tx may be in the verifier twice)
+    std::mutex m_admission_mutex;
+    MockTxBatchVerifier<MockTxType> m_verifier;
+    std::unordered_multimap<const MockTxType*, crypto::hash> m_verifying_tx_ids;
+
+    AtomicStats m_stats;
+};
+
+} //namespace mock_tx
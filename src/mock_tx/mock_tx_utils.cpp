@@ -32,8 +32,11 @@
 #include "mock_tx_utils.h"
 
 //local headers
+#include "common/threadpool.h"
 #include "misc_log_ex.h"
+#include "mock_tx_phase_timers.h"
 #include "ringct/bulletproofs_plus.h"
+#include "ringct/multiexp.h"
 #include "ringct/rctOps.h"
 #include "ringct/rctTypes.h"
 
@@ -41,6 +44,11 @@
 #include "boost/multiprecision/cpp_int.hpp"
 
 //standard headers
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <limits>
 #include <vector>
 
 #undef MONERO_DEFAULT_LOG_CATEGORY
@@ -70,6 +78,19 @@ std::size_t ref_set_size_from_decomp(const std::size_t ref_set_decomp_n, const s
     return ref_set_size;
 }
 //-------------------------------------------------------------------------------------------------------------------
+void get_ledger_index_ranges(const std::vector<std::size_t> &indices, std::vector<LedgerIndexRange> &ranges_out)
+{
+    ranges_out.clear();
+
+    for (const std::size_t index : indices)
+    {
+        if (!ranges_out.empty() && ranges_out.back().m_first + ranges_out.back().m_count == index)
+            ++ranges_out.back().m_count;
+        else
+            ranges_out.push_back({index, 1});
+    }
+}
+//-------------------------------------------------------------------------------------------------------------------
 std::size_t compute_rangeproof_grouping_size(const std::size_t num_amounts, const std::size_t max_num_splits)
 {
     // if there are 'n' amounts, split them into power-of-2 groups up to 'max num splits' times
@@ -118,11 +139,134 @@ bool balance_check_equality(const rct::keyV &commitment_set1, const rct::keyV &c
     return rct::equalKeys(rct::addKeys(commitment_set1), rct::addKeys(commitment_set2));
 }
 //-------------------------------------------------------------------------------------------------------------------
+bool run_indexed_jobs(const std::size_t num_jobs,
+    std::size_t num_threads,
+    const std::function<void(const std::size_t)> &job)
+{
+    tools::threadpool &tpool{tools::threadpool::getInstance()};
+
+    if (num_threads == 0)
+        num_threads = tpool.get_max_concurrency();
+
+    if (num_threads <= 1 || num_jobs <= 1)
+    {
+        for (std::size_t job_index{0}; job_index < num_jobs; ++job_index)
+            job(job_index);
+        return true;
+    }
+
+    // contiguous shards of jobs, at most one shard per thread
+    return tools::parallel_for(0, num_jobs, (num_jobs + num_threads - 1) / num_threads,
+            [&job](const std::size_t begin, const std::size_t end)
+            {
+                for (std::size_t job_index{begin}; job_index < end; ++job_index)
+                    job(job_index);
+            }
+        );
+}
+//-------------------------------------------------------------------------------------------------------------------
+bool run_indexed_jobs_stealing(const std::size_t num_jobs,
+    std::size_t num_threads,
+    const std::function<void(const std::size_t)> &job)
+{
+    tools::threadpool &tpool{tools::threadpool::getInstance()};
+
+    if (num_threads == 0)
+        num_threads = tpool.get_max_concurrency();
+
+    if (num_threads <= 1 || num_jobs <= 1)
+    {
+        for (std::size_t job_index{0}; job_index < num_jobs; ++job_index)
+            job(job_index);
+        return true;
+    }
+
+    CHECK_AND_ASSERT_THROW_MES(num_jobs <= std::numeric_limits<std::uint32_t>::max(),
+        "run indexed jobs stealing: too many jobs.");
+
+    // each worker's remaining jobs [begin, end), packed as (begin << 32) | end so owner and thieves can update the
+    //   range with one CAS
+    const auto pack = [](const std::uint64_t begin, const std::uint64_t end) -> std::uint64_t
+    {
+        return (begin << 32) | end;
+    };
+
+    const std::size_t num_workers{std::min(num_threads, num_jobs)};
+    std::vector<std::atomic<std::uint64_t>> ranges(num_workers);
+
+    for (std::size_t worker_index{0}; worker_index < num_workers; ++worker_index)
+    {
+        ranges[worker_index].store(pack(worker_index*num_jobs/num_workers, (worker_index + 1)*num_jobs/num_workers));
+    }
+
+    // owner: take the front job of its own range
+    const auto pop_front = [&ranges, &pack](const std::size_t worker_index, std::size_t &job_index_out) -> bool
+    {
+        std::uint64_t range{ranges[worker_index].load()};
+        while ((range >> 32) < (range & 0xFFFFFFFF))
+        {
+            if (ranges[worker_index].compare_exchange_weak(range, pack((range >> 32) + 1, range & 0xFFFFFFFF)))
+            {
+                job_index_out = range >> 32;
+                return true;
+            }
+        }
+        return false;
+    };
+
+    // thief: move the back half of a victim's range into the thief's (empty) range
+    const auto steal = [&ranges, &pack, num_workers](const std::size_t worker_index) -> bool
+    {
+        for (std::size_t offset{1}; offset < num_workers; ++offset)
+        {
+            std::atomic<std::uint64_t> &victim{ranges[(worker_index + offset) % num_workers]};
+            std::uint64_t range{victim.load()};
+
+            while ((range >> 32) < (range & 0xFFFFFFFF))
+            {
+                const std::uint64_t begin{range >> 32};
+                const std::uint64_t end{range & 0xFFFFFFFF};
+                const std::uint64_t split{end - (end - begin + 1)/2};
+
+                if (victim.compare_exchange_weak(range, pack(begin, split)))
+                {
+                    ranges[worker_index].store(pack(split, end));
+                    return true;
+                }
+            }
+        }
+        return false;
+    };
+
+    tools::threadpool::waiter waiter(tpool);
+
+    for (std::size_t worker_index{0}; worker_index < num_workers; ++worker_index)
+    {
+        tpool.submit(&waiter,
+                [&job, &pop_front, &steal, worker_index]()
+                {
+                    std::size_t job_index;
+
+                    do
+                    {
+                        while (pop_front(worker_index, job_index))
+                            job(job_index);
+                    } while (steal(worker_index));
+                }
+            );
+    }
+
+    return waiter.wait();
+}
+//-------------------------------------------------------------------------------------------------------------------
 void make_bpp_rangeproofs(const std::vector<rct::xmr_amount> &amounts,
     const std::vector<rct::key> &amount_commitment_blinding_factors,
     const std::size_t max_rangeproof_splits,
-    std::vector<rct::BulletproofPlus> &range_proofs_out)
+    std::vector<rct::BulletproofPlus> &range_proofs_out,
+    std::size_t num_threads)
 {
+    MOCK_TX_PHASE_TIMER(RANGE_PROOF_PROVE);
+
     /// range proofs
     // - for output amount commitments
     CHECK_AND_ASSERT_THROW_MES(amounts.size() == amount_commitment_blinding_factors.size(),
@@ -134,32 +278,32 @@ void make_bpp_rangeproofs(const std::vector<rct::xmr_amount> &amounts,
     // make the range proofs
     range_proofs_out.clear();
 
-    for (std::size_t output_index{0}; output_index < amounts.size(); output_index += split_size)
-    {
-        // initialization step
-        if (output_index == 0)
-        {
-            CHECK_AND_ASSERT_THROW_MES(split_size > 0, "Cannot aggregate 0 bulletproofs together.");
-            range_proofs_out.reserve(amounts.size() / split_size + 1);
-        }
+    if (amounts.empty())
+        return;
 
-        // aggregate 'split_size' bulleproofs together at a time (with leftovers aggregated in final proof)
-        std::vector<rct::xmr_amount> amounts_group;
-        std::vector<rct::key> amount_commitment_blinding_factors_group;
-        amounts_group.reserve(split_size);
-        amount_commitment_blinding_factors_group.reserve(split_size);
+    CHECK_AND_ASSERT_THROW_MES(split_size > 0, "Cannot aggregate 0 bulletproofs together.");
+    const std::size_t num_groups{(amounts.size() + split_size - 1) / split_size};
+    range_proofs_out.resize(num_groups);
 
-        for (std::size_t chunk_index{output_index};
-            chunk_index < (output_index + split_size) && chunk_index < amounts.size();
-            ++chunk_index)
+    // aggregate 'split_size' bulleproofs together at a time (with leftovers aggregated in final proof)
+    auto prove_group =
+        [&](const std::size_t group_index)
         {
-            amounts_group.emplace_back(amounts[chunk_index]);
-            amount_commitment_blinding_factors_group.emplace_back(amount_commitment_blinding_factors[chunk_index]);
-        }
+            const std::size_t output_index{group_index * split_size};
+            const std::size_t group_end{std::min(output_index + split_size, amounts.size())};
 
-        range_proofs_out.emplace_back(
-            rct::bulletproof_plus_PROVE(amounts_group, amount_commitment_blinding_factors_group));
-    }
+            const std::vector<rct::xmr_amount> amounts_group{amounts.begin() + output_index,
+                amounts.begin() + group_end};
+            const std::vector<rct::key> amount_commitment_blinding_factors_group{
+                amount_commitment_blinding_factors.begin() + output_index,
+                amount_commitment_blinding_factors.begin() + group_end};
+
+            range_proofs_out[group_index] =
+                rct::bulletproof_plus_PROVE(amounts_group, amount_commitment_blinding_factors_group);
+        };
+
+    // the groups are independent: each group's proof goes in its own slot, so the output order matches the serial path
+    CHECK_AND_ASSERT_THROW_MES(run_indexed_jobs(num_groups, num_threads, prove_group), "Failed to make range proofs.");
 }
 //-------------------------------------------------------------------------------------------------------------------
 bool balance_check_in_out_amnts(const std::vector<rct::xmr_amount> &input_amounts,
@@ -178,4 +322,55 @@ bool balance_check_in_out_amnts(const std::vector<rct::xmr_amount> &input_amount
     return input_sum == output_sum;
 }
 //-------------------------------------------------------------------------------------------------------------------
+bool try_get_batch_validation_data_sharded(const std::size_t batch_size,
+    std::size_t num_threads,
+    const std::function<bool(const std::size_t, const std::size_t, std::vector<rct::pippenger_prep_data>&)>
+        &try_get_shard_data,
+    std::vector<rct::pippenger_prep_data> &prep_datas_out)
+{
+    prep_datas_out.clear();
+
+    // an empty batch is for the shard function to judge
+    if (num_threads == 1 || batch_size <= 1 || tools::threadpool::getInstance().get_max_concurrency() <= 1)
+        return try_get_shard_data(0, batch_size, prep_datas_out);
+
+    // prepare shards in parallel, and merge their data in shard order
+    // - with no thread limit, the shards are sized for balance since txs vary in cost (e.g. number of inputs)
+    struct shard_result
+    {
+        bool succeeded{true};
+        std::vector<rct::pippenger_prep_data> prep_datas;
+    };
+    shard_result result;
+
+    if (!tools::parallel_reduce(0,
+            batch_size,
+            num_threads ? (batch_size + num_threads - 1) / num_threads : 0,
+            result,
+            [&try_get_shard_data](const std::size_t begin, const std::size_t end) -> shard_result
+            {
+                shard_result shard;
+                shard.succeeded = try_get_shard_data(begin, end, shard.prep_datas);
+                return shard;
+            },
+            [](shard_result merged, shard_result &&shard) -> shard_result
+            {
+                merged.succeeded = merged.succeeded && shard.succeeded;
+                if (merged.succeeded)
+                {
+                    for (rct::pippenger_prep_data &prep_data : shard.prep_datas)
+                        merged.prep_datas.emplace_back(std::move(prep_data));
+                }
+                return merged;
+            }
+        ))
+        return false;
+
+    if (!result.succeeded)
+        return false;
+
+    prep_datas_out = std::move(result.prep_datas);
+    return true;
+}
+//-------------------------------------------------------------------------------------------------------------------
 } //namespace mock_tx
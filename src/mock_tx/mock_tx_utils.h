@@ -33,11 +33,13 @@
 
 //local headers
 #include "crypto/crypto.h"
+#include "ringct/multiexp.h"
 #include "ringct/rctTypes.h"
 
 //third party headers
 
 //standard headers
+#include <functional>
 #include <vector>
 
 //forward declarations
@@ -60,6 +62,13 @@ static inline const unsigned char *operator &(const crypto::ec_scalar &scalar)
 namespace mock_tx
 {
 
+/// a run of consecutive ledger indices: [m_first, m_first + m_count)
+struct LedgerIndexRange final
+{
+    std::size_t m_first;
+    std::size_t m_count;
+};
+
 /**
 * brief: ref_set_size_from_decomp - compute n^m from decomposition of a reference set
 * param: ref_set_decomp_n -
@@ -70,6 +79,14 @@ namespace mock_tx
 */
 std::size_t ref_set_size_from_decomp(const std::size_t ref_set_decomp_n, const std::size_t ref_set_decomp_m);
 /**
+* brief: get_ledger_index_ranges - split ledger indices into runs of consecutive indices, in order
+*   - e.g. [3, 4, 5, 9, 9, 10] -> [(3, 3), (9, 1), (9, 2)]
+*   - lets ledgers gather a reference set with one seek per run instead of one lookup per index
+* param: indices -
+* outparam: ranges_out -
+*/
+void get_ledger_index_ranges(const std::vector<std::size_t> &indices, std::vector<LedgerIndexRange> &ranges_out);
+/**
 * brief: compute_rangeproof_grouping_size - compute max number of amounts to aggregate in one range proof at a time
 *   - given a number of amounts, split them into power-of-2 groups up to 'max num splits' times; e.g. ...
 *     n = 7, split = 1: [4, 3]
@@ -82,16 +99,45 @@ std::size_t ref_set_size_from_decomp(const std::size_t ref_set_decomp_n, const s
 */
 std::size_t compute_rangeproof_grouping_size(const std::size_t num_amounts, const std::size_t max_num_splits);
 /**
+* brief: run_indexed_jobs - run job(index) for every index in [0, num_jobs), in up to 'num_threads' threadpool shards
+*   - jobs must be independent; each should write only to its own pre-sized output slot, so results (and their order)
+*     don't depend on the number of threads
+*   - serial mode runs the jobs in order on the calling thread and lets exceptions propagate
+* param: num_jobs -
+* param: num_threads - max number of threads (0 = threadpool max concurrency; 1 = serial)
+* param: job -
+* return: false if a job threw (threaded mode)
+*/
+bool run_indexed_jobs(const std::size_t num_jobs,
+    std::size_t num_threads,
+    const std::function<void(const std::size_t)> &job);
+/**
+* brief: run_indexed_jobs_stealing - run job(index) for every index in [0, num_jobs), balancing uneven jobs across
+*   up to 'num_threads' threadpool workers with work stealing
+*   - each worker starts with a contiguous range of jobs and takes jobs from its front; a worker that runs dry steals
+*     the back half of another worker's remaining range
+*   - same contract as run_indexed_jobs(); prefer this when job costs vary (e.g. scanning chunks with few/many hits)
+* param: num_jobs -
+* param: num_threads - max number of threads (0 = threadpool max concurrency; 1 = serial)
+* param: job -
+* return: false if a job threw (threaded mode)
+*/
+bool run_indexed_jobs_stealing(const std::size_t num_jobs,
+    std::size_t num_threads,
+    const std::function<void(const std::size_t)> &job);
+/**
 * brief: make_bpp_rangeproofs - make BP+ range proofs
 * param: amounts -
 * param: amount_commitment_blinding_factors -
 * param: max_rangeproof_splits -
 * outparam: range_proofs_out - set of amount commitments with range proofs
+* param: num_threads - max number of threads for proving independent groups (0 = threadpool max concurrency; 1 = serial)
 */
 void make_bpp_rangeproofs(const std::vector<rct::xmr_amount> &amounts,
     const std::vector<rct::key> &amount_commitment_blinding_factors,
     const std::size_t max_rangeproof_splits,
-    std::vector<rct::BulletproofPlus> &range_proofs_out);
+    std::vector<rct::BulletproofPlus> &range_proofs_out,
+    std::size_t num_threads = 1);
 /**
 * brief: balance_check_equality - balance check between two commitment sets using an equality test
 *   - i.e. sum(inputs) ?= sum(outputs)
@@ -109,5 +155,20 @@ bool balance_check_equality(const rct::keyV &commitment_set1, const rct::keyV &c
 */
 bool balance_check_in_out_amnts(const std::vector<rct::xmr_amount> &input_amounts,
     const std::vector<rct::xmr_amount> &output_amounts);
+/**
+* brief: try_get_batch_validation_data_sharded - split a batch into contiguous shards and prepare each shard's
+*   batch-verification data in parallel (tools::parallel_reduce)
+* param: batch_size - number of elements in the batch (e.g. txs)
+* param: num_threads - max number of shards (0 = a few per threadpool thread, to balance uneven txs; 1 = serial)
+* param: try_get_shard_data - f(begin, end, shard_prep_datas_out): validate elements [begin, end) and collect their
+*   pippenger data; returns false on failure
+* outparam: prep_datas_out - pippenger data of all shards, merged in shard order
+* return: true if all shards succeeded
+*/
+bool try_get_batch_validation_data_sharded(const std::size_t batch_size,
+    std::size_t num_threads,
+    const std::function<bool(const std::size_t, const std::size_t, std::vector<rct::pippenger_prep_data>&)>
+        &try_get_shard_data,
+    std::vector<rct::pippenger_prep_data> &prep_datas_out);
 
 } //namespace mock_tx
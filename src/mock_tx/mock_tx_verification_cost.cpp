@@ -0,0 +1,191 @@
+// Copyright (c) 2021, The Monero Project
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this list of
+//    conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list
+//    of conditions and the following disclaimer in the documentation and/or other
+//    materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its contributors may be
+//    used to endorse or promote products derived from this software without specific
+//    prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+// THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// NOT FOR PRODUCTION
+
+//paired header
+#include "mock_tx_verification_cost.h"
+
+//local headers
+#include "mock_tx_utils.h"
+#include "ringct/rctTypes.h"
+
+//third party headers
+
+//standard headers
+#include <vector>
+
+#undef MONERO_DEFAULT_LOG_CATEGORY
+#define MONERO_DEFAULT_LOG_CATEGORY "mock_tx"
+
+namespace mock_tx
+{
+//-------------------------------------------------------------------------------------------------------------------
+MockTxVerificationOps get_bpp_verification_ops(const std::vector<rct::BulletproofPlus> &range_proofs)
+{
+    MockTxVerificationOps ops;
+
+    for (const rct::BulletproofPlus &range_proof : range_proofs)
+    {
+        // 2^rounds = 64 * (number of commitments, padded to a power of 2)
+        const std::size_t rounds{range_proof.L.size()};
+
+        // V, A, A1, B, L, R
+        ops.m_multiexp_points += range_proof.V.size() + 3 + 2*rounds;
+        ops.m_decompressions += range_proof.V.size() + 3 + 2*rounds;
+
+        // G, H, Gi, Hi
+        ops.m_generator_points += 2 + 2*(std::size_t{1} << rounds);
+
+        // hash(V), y, z, one challenge per round, e
+        ops.m_hashes += 4 + rounds;
+    }
+
+    return ops;
+}
+//-------------------------------------------------------------------------------------------------------------------
+MockTxVerificationOps get_clsag_verification_ops(const std::size_t ref_set_size)
+{
+    MockTxVerificationOps ops;
+
+    // per member: L = s G + c_p P + c_c C, R = s Hp(P) + c_p I + c_c D
+    ops.m_multiexp_points += 5*ref_set_size;
+    ops.m_generator_points += ref_set_size;
+
+    // P, C per member; I, D, C offset
+    ops.m_decompressions += 2*ref_set_size + 3;
+
+    // mu_P, mu_C; Hp(P) and a round challenge per member
+    ops.m_hashes += 2 + 2*ref_set_size;
+
+    return ops;
+}
+//-------------------------------------------------------------------------------------------------------------------
+MockTxVerificationOps get_triptych_verification_ops(const std::size_t ref_set_decomp_n,
+    const std::size_t ref_set_decomp_m)
+{
+    const std::size_t ref_set_size{ref_set_size_from_decomp(ref_set_decomp_n, ref_set_decomp_m)};
+    MockTxVerificationOps ops;
+
+    // M, P per member; X, Y per digit; A, B, C, D, J, K, C offset
+    ops.m_multiexp_points += 2*ref_set_size + 2*ref_set_decomp_m + 7;
+    ops.m_decompressions += 2*ref_set_size + 2*ref_set_decomp_m + 7;
+
+    // G, H, U, Hi
+    ops.m_generator_points += 3 + ref_set_decomp_n*ref_set_decomp_m;
+
+    // mu, challenge
+    ops.m_hashes += 2;
+
+    return ops;
+}
+//-------------------------------------------------------------------------------------------------------------------
+MockTxVerificationOps get_grootle_verification_ops(const std::size_t num_keys,
+    const std::size_t ref_set_decomp_n,
+    const std::size_t ref_set_decomp_m)
+{
+    const std::size_t ref_set_size{ref_set_size_from_decomp(ref_set_decomp_n, ref_set_decomp_m)};
+    MockTxVerificationOps ops;
+
+    // M per member and key; offsets; X per key and digit; A, B
+    ops.m_multiexp_points += num_keys*ref_set_size + num_keys + num_keys*ref_set_decomp_m + 2;
+    ops.m_decompressions += num_keys*ref_set_size + num_keys + num_keys*ref_set_decomp_m + 2;
+
+    // G, Hi_A, Hi_B
+    ops.m_generator_points += 1 + 2*ref_set_decomp_n*ref_set_decomp_m;
+
+    // challenge
+    ops.m_hashes += 1;
+
+    return ops;
+}
+//-------------------------------------------------------------------------------------------------------------------
+MockTxVerificationOps get_concise_grootle_verification_ops(const std::size_t num_keys,
+    const std::size_t ref_set_decomp_n,
+    const std::size_t ref_set_decomp_m)
+{
+    const std::size_t ref_set_size{ref_set_size_from_decomp(ref_set_decomp_n, ref_set_decomp_m)};
+    MockTxVerificationOps ops;
+
+    // M per member and key; offsets; X per digit; A, B
+    ops.m_multiexp_points += num_keys*ref_set_size + num_keys + ref_set_decomp_m + 2;
+    ops.m_decompressions += num_keys*ref_set_size + num_keys + ref_set_decomp_m + 2;
+
+    // G, Hi_A, Hi_B
+    ops.m_generator_points += 1 + 2*ref_set_decomp_n*ref_set_decomp_m;
+
+    // base aggregation coefficient, challenge
+    ops.m_hashes += 2;
+
+    return ops;
+}
+//-------------------------------------------------------------------------------------------------------------------
+MockTxVerificationOps get_sp_composition_verification_ops(const std::size_t num_keys)
+{
+    MockTxVerificationOps ops;
+
+    // A_K_t2, A_KI; A_K_t1, K_t1 (twice), KI, K per key
+    ops.m_multiexp_points += 2 + 5*num_keys;
+    ops.m_decompressions += 2 + 4*num_keys;
+
+    // G, X, U
+    ops.m_generator_points += 3;
+
+    // mu_a, mu_b, message, challenge
+    ops.m_hashes += 4;
+
+    return ops;
+}
+//-------------------------------------------------------------------------------------------------------------------
+MockTxVerificationOps get_balance_check_verification_ops(const std::size_t num_input_commitments,
+    const std::size_t num_output_commitments,
+    const std::size_t num_range_proofed_commitments)
+{
+    MockTxVerificationOps ops;
+
+    // sum(inputs) ?= sum(outputs)
+    ops.m_decompressions += num_input_commitments + num_output_commitments;
+
+    // C ?= 8 * V for each range proofed commitment
+    ops.m_multiexp_points += num_range_proofed_commitments;
+    ops.m_decompressions += num_range_proofed_commitments;
+
+    return ops;
+}
+//-------------------------------------------------------------------------------------------------------------------
+MockTxVerificationOps get_linking_tag_semantics_verification_ops(const std::size_t num_linking_tags)
+{
+    MockTxVerificationOps ops;
+
+    // one scalar mult per tag (l*KI or 8*KI)
+    ops.m_multiexp_points += num_linking_tags;
+    ops.m_decompressions += num_linking_tags;
+
+    return ops;
+}
+//-------------------------------------------------------------------------------------------------------------------
+} //namespace mock_tx
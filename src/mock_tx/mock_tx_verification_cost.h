@@ -0,0 +1,161 @@
+// Copyright (c) 2021, The Monero Project
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this list of
+//    conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list
+//    of conditions and the following disclaimer in the documentation and/or other
+//    materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its contributors may be
+//    used to endorse or promote products derived from this software without specific
+//    prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+// THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// Verification cost model for mock txs: expected work to verify a tx, estimated from its proof shapes.
+// NOT FOR PRODUCTION
+
+#pragma once
+
+//local headers
+#include "ringct/rctTypes.h"
+
+//third party headers
+
+//standard headers
+#include <vector>
+
+//forward declarations
+
+
+namespace mock_tx
+{
+
+////
+// MockTxVerificationOps - expected number of expensive operations to verify a tx (or a proof)
+// - counts follow the proof verifiers' structure (terms per proof, transcript challenges), not an instrumented run
+// - ref set members are counted as decompressed even if a ledger keeps them decompressed
+///
+struct MockTxVerificationOps final
+{
+    /// points with per-tx bases in multiexponentiations and scalar multiplications
+    std::size_t m_multiexp_points{0};
+    /// generator points (fixed bases with precomputed tables, so cheaper per point)
+    std::size_t m_generator_points{0};
+    /// hashes (transcript challenges, aggregation coefficients, hashes to points)
+    std::size_t m_hashes{0};
+    /// point decompressions
+    std::size_t m_decompressions{0};
+
+    MockTxVerificationOps& operator+=(const MockTxVerificationOps &other)
+    {
+        m_multiexp_points += other.m_multiexp_points;
+        m_generator_points += other.m_generator_points;
+        m_hashes += other.m_hashes;
+        m_decompressions += other.m_decompressions;
+        return *this;
+    }
+};
+
+////
+// MockTxVerificationCostModel - linear cost model over MockTxVerificationOps
+// - defaults were fitted with performance_tests --check-mock-tx-cost-model over
+//   tests/performance_tests/sweeps/cost_model.json (in-memory ledger; ~13% mean error); refit them on other hardware
+// - decompressions fit to 0: they track multiexp points almost 1:1, so their cost is folded into those points
+// - hashes absorb fixed per-proof overhead (transcripts, allocations), hence the large cost per hash
+///
+struct MockTxVerificationCostModel final
+{
+    double m_ns_per_multiexp_point{15000};
+    double m_ns_per_generator_point{15000};
+    double m_ns_per_hash{130000};
+    double m_ns_per_decompression{0};
+
+    /// estimated verification time of a tx (ns)
+    double estimate_ns(const MockTxVerificationOps &ops) const
+    {
+        return m_ns_per_multiexp_point * ops.m_multiexp_points +
+            m_ns_per_generator_point * ops.m_generator_points +
+            m_ns_per_hash * ops.m_hashes +
+            m_ns_per_decompression * ops.m_decompressions;
+    }
+};
+
+/**
+* brief: get_bpp_verification_ops - estimate the work to verify a set of BP+ range proofs
+* param: range_proofs -
+* return: ops
+*/
+MockTxVerificationOps get_bpp_verification_ops(const std::vector<rct::BulletproofPlus> &range_proofs);
+/**
+* brief: get_clsag_verification_ops - estimate the work to verify a CLSAG (not batchable: scalar mults per member)
+* param: ref_set_size -
+* return: ops
+*/
+MockTxVerificationOps get_clsag_verification_ops(const std::size_t ref_set_size);
+/**
+* brief: get_triptych_verification_ops - estimate the work to verify a Triptych proof
+* param: ref_set_decomp_n -
+* param: ref_set_decomp_m -
+* return: ops
+*/
+MockTxVerificationOps get_triptych_verification_ops(const std::size_t ref_set_decomp_n,
+    const std::size_t ref_set_decomp_m);
+/**
+* brief: get_grootle_verification_ops - estimate the work to verify a Grootle proof
+* param: num_keys - keys per ref set member
+* param: ref_set_decomp_n -
+* param: ref_set_decomp_m -
+* return: ops
+*/
+MockTxVerificationOps get_grootle_verification_ops(const std::size_t num_keys,
+    const std::size_t ref_set_decomp_n,
+    const std::size_t ref_set_decomp_m);
+/**
+* brief: get_concise_grootle_verification_ops - estimate the work to verify a concise Grootle proof
+* param: num_keys - keys per ref set member
+* param: ref_set_decomp_n -
+* param: ref_set_decomp_m -
+* return: ops
+*/
+MockTxVerificationOps get_concise_grootle_verification_ops(const std::size_t num_keys,
+    const std::size_t ref_set_decomp_n,
+    const std::size_t ref_set_decomp_m);
+/**
+* brief: get_sp_composition_verification_ops - estimate the work to verify a Seraphis composition proof
+* param: num_keys - keys proven by the proof (1 per input, or all inputs for a merged proof)
+* return: ops
+*/
+MockTxVerificationOps get_sp_composition_verification_ops(const std::size_t num_keys);
+/**
+* brief: get_balance_check_verification_ops - estimate the work to check that amount commitments balance, and that
+*   range proof commitments match them
+* param: num_input_commitments -
+* param: num_output_commitments -
+* param: num_range_proofed_commitments -
+* return: ops
+*/
+MockTxVerificationOps get_balance_check_verification_ops(const std::size_t num_input_commitments,
+    const std::size_t num_output_commitments,
+    const std::size_t num_range_proofed_commitments);
+/**
+* brief: get_linking_tag_semantics_verification_ops - estimate the work to check linking tags are in the prime subgroup
+* param: num_linking_tags -
+* return: ops
+*/
+MockTxVerificationOps get_linking_tag_semantics_verification_ops(const std::size_t num_linking_tags);
+
+} //namespace mock_tx
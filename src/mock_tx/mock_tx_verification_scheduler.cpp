@@ -0,0 +1,229 @@
+// Copyright (c) 2021, The Monero Project
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of
+//    conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list
+//    of conditions and the following disclaimer in the documentation and/or other
+//    materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be
+//    used to endorse or promote products derived from this software without specific
+//    prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+// THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// NOT FOR PRODUCTION
+
+//paired header
+#include "mock_tx_verification_scheduler.h"
+
+//local headers
+#include "ledger_context.h"
+#include "mock_rct_clsag.h"
+#include "mock_rct_triptych.h"
+#include "mock_sp_txtype_concise_v1.h"
+#include "mock_sp_txtype_merge_v1.h"
+#include "mock_sp_txtype_plain_v1.h"
+#include "mock_sp_txtype_squashed_v1.h"
+#include "mock_tx.h"
+#include "mock_tx_utils.h"
+#include "ringct/multiexp.h"
+#include "seraphis_crypto_utils.h"
+
+//third party headers
+
+//standard headers
+#include <chrono>
+#include <map>
+#include <memory>
+#include <tuple>
+#include <vector>
+
+#undef MONERO_DEFAULT_LOG_CATEGORY
+#define MONERO_DEFAULT_LOG_CATEGORY "mock_tx"
+
+namespace mock_tx
+{
+
+/// group key: family, ref set decomposition n, m
+using MockTxGroupKey = std::tuple<MockTxBatchFamily, std::size_t, std::size_t>;
+
+//-------------------------------------------------------------------------------------------------------------------
+// Decomposition of a tx's membership proofs (all proofs of a tx share one decomposition)
+// - txs without membership proofs are put in group n = m = 0 (they fail their semantics checks)
+//-------------------------------------------------------------------------------------------------------------------
+template <typename MockMembershipProofType>
+static MockTxGroupKey get_sp_group_key(const MockTxBatchFamily family,
+    const std::vector<MockMembershipProofType> &membership_proofs)
+{
+    if (membership_proofs.size() == 0)
+        return MockTxGroupKey{family, 0, 0};
+
+    return MockTxGroupKey{family, membership_proofs[0].m_ref_set_decomp_n, membership_proofs[0].m_ref_set_decomp_m};
+}
+//-------------------------------------------------------------------------------------------------------------------
+// Group key of a tx
+// - RCT txs only batch their range proofs, so they don't need a shared decomposition
+//-------------------------------------------------------------------------------------------------------------------
+static MockTxGroupKey get_group_key(const MockTx &tx)
+{
+    if (dynamic_cast<const MockTxCLSAG*>(&tx))
+        return MockTxGroupKey{MockTxBatchFamily::RCT_CLSAG, 0, 0};
+    if (dynamic_cast<const MockTxTriptych*>(&tx))
+        return MockTxGroupKey{MockTxBatchFamily::RCT_TRIPTYCH, 0, 0};
+    if (const MockTxSpPlainV1 *tx_plain = dynamic_cast<const MockTxSpPlainV1*>(&tx))
+        return get_sp_group_key(MockTxBatchFamily::SP_PLAIN_V1, tx_plain->m_membership_proofs);
+    if (const MockTxSpConciseV1 *tx_concise = dynamic_cast<const MockTxSpConciseV1*>(&tx))
+        return get_sp_group_key(MockTxBatchFamily::SP_CONCISE_V1, tx_concise->m_membership_proofs);
+    if (const MockTxSpMergeV1 *tx_merge = dynamic_cast<const MockTxSpMergeV1*>(&tx))
+        return get_sp_group_key(MockTxBatchFamily::SP_MERGE_V1, tx_merge->m_membership_proofs);
+    if (const MockTxSpSquashedV1 *tx_squashed = dynamic_cast<const MockTxSpSquashedV1*>(&tx))
+        return get_sp_group_key(MockTxBatchFamily::SP_SQUASHED_V1, tx_squashed->m_membership_proofs);
+
+    return MockTxGroupKey{MockTxBatchFamily::UNKNOWN, 0, 0};
+}
+//-------------------------------------------------------------------------------------------------------------------
+// Batch-verify one group of txs of the same type
+// - same steps as validate_mock_txs(), with each phase timed
+//-------------------------------------------------------------------------------------------------------------------
+template <typename MockTxType>
+static void validate_group(const std::vector<std::shared_ptr<MockTx>> &txs_to_validate,
+    const std::shared_ptr<const LedgerContext> ledger_context,
+    const std::size_t num_threads,
+    MockTxVerificationGroupReport &report_inout)
+{
+    std::vector<std::shared_ptr<MockTxType>> group_txs;
+    group_txs.reserve(report_inout.m_tx_indices.size());
+
+    for (const std::size_t tx_index : report_inout.m_tx_indices)
+        group_txs.emplace_back(std::static_pointer_cast<MockTxType>(txs_to_validate[tx_index]));
+
+    // prepare for batch-verification (in parallel: each shard of txs gets its own pippenger data sets)
+    auto try_get_shard_data =
+        [&group_txs, &ledger_context](const std::size_t begin,
+            const std::size_t end,
+            std::vector<rct::pippenger_prep_data> &shard_prep_datas_out) -> bool
+        {
+            return try_get_mock_txs_batch_validation_data<MockTxType>(group_txs,
+                begin,
+                end,
+                ledger_context,
+                shard_prep_datas_out);
+        };
+
+    std::vector<rct::pippenger_prep_data> prep_datas;
+
+    const auto prepare_start = std::chrono::steady_clock::now();
+    report_inout.m_valid =
+        try_get_batch_validation_data_sharded(group_txs.size(), num_threads, try_get_shard_data, prep_datas);
+    const auto prepare_end = std::chrono::steady_clock::now();
+
+    report_inout.m_prepare_time =
+        std::chrono::duration_cast<std::chrono::microseconds>(prepare_end - prepare_start);
+
+    if (!report_inout.m_valid)
+        return;
+
+    for (const rct::pippenger_prep_data &prep_data : prep_datas)
+        report_inout.m_num_multiexp_points += prep_data.data.size();
+
+    // batch verify: one combined pippenger problem for the group
+    report_inout.m_valid = sp::check_pippenger_data(prep_datas, num_threads);
+
+    report_inout.m_verify_time =
+        std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - prepare_end);
+}
+//-------------------------------------------------------------------------------------------------------------------
+bool validate_mock_txs_scheduled(const std::vector<std::shared_ptr<MockTx>> &txs_to_validate,
+    const std::shared_ptr<const LedgerContext> ledger_context,
+    std::vector<MockTxVerificationGroupReport> &group_reports_out,
+    const std::size_t num_threads)
+{
+    group_reports_out.clear();
+
+    // bucket txs by group key (ordered map: deterministic report order)
+    std::map<MockTxGroupKey, std::vector<std::size_t>> groups;
+    bool all_txs_valid{true};
+
+    for (std::size_t tx_index{0}; tx_index < txs_to_validate.size(); ++tx_index)
+    {
+        const MockTxGroupKey group_key{
+                txs_to_validate[tx_index]
+                ? get_group_key(*txs_to_validate[tx_index])
+                : MockTxGroupKey{MockTxBatchFamily::UNKNOWN, 0, 0}
+            };
+
+        groups[group_key].emplace_back(tx_index);
+    }
+
+    // verify each group
+    group_reports_out.reserve(groups.size());
+
+    for (auto &group : groups)
+    {
+        group_reports_out.emplace_back();
+        MockTxVerificationGroupReport &report{group_reports_out.back()};
+
+        report.m_family = std::get<0>(group.first);
+        report.m_ref_set_decomp_n = std::get<1>(group.first);
+        report.m_ref_set_decomp_m = std::get<2>(group.first);
+        report.m_tx_indices = std::move(group.second);
+        report.m_num_multiexp_points = 0;
+        report.m_valid = false;
+        report.m_prepare_time = std::chrono::microseconds{0};
+        report.m_verify_time = std::chrono::microseconds{0};
+
+        try
+        {
+            switch (report.m_family)
+            {
+                case MockTxBatchFamily::RCT_CLSAG:
+                    validate_group<MockTxCLSAG>(txs_to_validate, ledger_context, num_threads, report);
+                    break;
+                case MockTxBatchFamily::RCT_TRIPTYCH:
+                    validate_group<MockTxTriptych>(txs_to_validate, ledger_context, num_threads, report);
+                    break;
+                case MockTxBatchFamily::SP_PLAIN_V1:
+                    validate_group<MockTxSpPlainV1>(txs_to_validate, ledger_context, num_threads, report);
+                    break;
+                case MockTxBatchFamily::SP_CONCISE_V1:
+                    validate_group<MockTxSpConciseV1>(txs_to_validate, ledger_context, num_threads, report);
+                    break;
+                case MockTxBatchFamily::SP_MERGE_V1:
+                    validate_group<MockTxSpMergeV1>(txs_to_validate, ledger_context, num_threads, report);
+                    break;
+                case MockTxBatchFamily::SP_SQUASHED_V1:
+                    validate_group<MockTxSpSquashedV1>(txs_to_validate, ledger_context, num_threads, report);
+                    break;
+                default:
+                    // unknown tx types can't be validated
+                    report.m_valid = false;
+                    break;
+            }
+        }
+        catch (...)
+        {
+            report.m_valid = false;
+        }
+
+        all_txs_valid = all_txs_valid && report.m_valid;
+    }
+
+    return all_txs_valid;
+}
+//-------------------------------------------------------------------------------------------------------------------
+} //namespace mock_tx
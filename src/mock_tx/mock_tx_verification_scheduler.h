@@ -0,0 +1,105 @@
+// Copyright (c) 2021, The Monero Project
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of
+//    conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list
+//    of conditions and the following disclaimer in the documentation and/or other
+//    materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be
+//    used to endorse or promote products derived from this software without specific
+//    prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+// THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// Verification scheduler for mixed mock tx batches: groups txs by batchable proof family and batch-verifies each group.
+// NOT FOR PRODUCTION
+
+#pragma once
+
+//local headers
+#include "ledger_context.h"
+#include "mock_tx.h"
+
+//third party headers
+
+//standard headers
+#include <chrono>
+#include <memory>
+#include <vector>
+
+//forward declarations
+
+
+namespace mock_tx
+{
+
+////
+// MockTxBatchFamily - tx types whose batchable proofs can share one pippenger problem
+///
+enum class MockTxBatchFamily : unsigned char
+{
+    RCT_CLSAG,
+    RCT_TRIPTYCH,
+    SP_PLAIN_V1,
+    SP_CONCISE_V1,
+    SP_MERGE_V1,
+    SP_SQUASHED_V1,
+    /// tx types the scheduler doesn't know (always invalid)
+    UNKNOWN
+};
+
+////
+// MockTxVerificationGroupReport - result of verifying one group of compatible txs
+// - a group is all txs with the same batch family and membership proof decomposition n^m (grootle/triptych batching
+//   needs a shared decomposition); n = m = 0 for families without one
+///
+struct MockTxVerificationGroupReport final
+{
+    /// group key
+    MockTxBatchFamily m_family;
+    std::size_t m_ref_set_decomp_n;
+    std::size_t m_ref_set_decomp_m;
+    /// indices of the group's txs in the scheduled tx set (sorted)
+    std::vector<std::size_t> m_tx_indices;
+    /// number of multiexp elements in the group's pippenger problem
+    std::size_t m_num_multiexp_points;
+    /// verification result for the whole group
+    bool m_valid;
+    /// time spent validating unbatchable parts and collecting pippenger data
+    std::chrono::microseconds m_prepare_time;
+    /// time spent on the group's batch multiexp
+    std::chrono::microseconds m_verify_time;
+};
+
+/**
+* brief: validate_mock_txs_scheduled - validate a mixed set of mock txs, batching each group of compatible txs
+*   - txs are bucketed by batch family and decomposition; each bucket is checked with one combined pippenger
+*     multiexp (see validate_mock_txs())
+*   - a failed group is reported as a whole (use validate_mock_txs() with 'invalid_tx_indices_out' on the group to
+*     find the bad txs)
+* param: txs_to_validate -
+* param: ledger_context -
+* outparam: group_reports_out - one report per group (ordered by family, then decomposition)
+* param: num_threads - max number of threads to use per group (0 = threadpool max concurrency; 1 = serial)
+* return: true if all txs are valid
+*/
+bool validate_mock_txs_scheduled(const std::vector<std::shared_ptr<MockTx>> &txs_to_validate,
+    const std::shared_ptr<const LedgerContext> ledger_context,
+    std::vector<MockTxVerificationGroupReport> &group_reports_out,
+    const std::size_t num_threads = 0);
+
+} //namespace mock_tx
@@ -42,10 +42,14 @@ extern "C"
 #include "misc_language.h"
 #include "misc_log_ex.h"
 #include "mock_sp_core_utils.h"
+#include "mock_tx_phase_timers.h"
 #include "mock_tx_utils.h"
+#include "ringct/multiexp.h"
 #include "ringct/rctOps.h"
 #include "ringct/rctTypes.h"
 #include "seraphis_crypto_utils.h"
+#include "seraphis_scratch_arena.h"
+#include "seraphis_transcript.h"
 
 //third party headers
 
@@ -61,10 +65,19 @@ namespace sp
 //-------------------------------------------------------------------------------------------------------------------
 // Initialize transcript
 //-------------------------------------------------------------------------------------------------------------------
-static void transcript_init(rct::key &transcript)
+static void transcript_init(SpTranscript &transcript_inout)
 {
-    std::string salt(config::HASH_KEY_SP_COMPOSITION_PROOF_TRANSCRIPT);
-    rct::hash_to_scalar(transcript, salt.data(), salt.size());
+    // H("domain-sep") is a constant
+    static const rct::key domain_separator{
+            []()
+            {
+                SpTranscript salt;
+                salt.absorb_string(config::HASH_KEY_SP_COMPOSITION_PROOF_TRANSCRIPT);
+                return salt.challenge();
+            }()
+        };
+
+    transcript_inout.absorb(domain_separator);
 }
 //-------------------------------------------------------------------------------------------------------------------
 // Aggregation coefficient 'mu_a' for concise structure
@@ -81,26 +94,16 @@ static rct::key compute_base_aggregation_coefficient_a(const rct::key &message,
     CHECK_AND_ASSERT_THROW_MES(K_t1.size() == KI.size(), "Transcript challenge inputs have incorrect size!");
 
     // initialize transcript message
-    rct::key challenge;
-    transcript_init(challenge);
-
-    // collect challenge string
-    std::string hash;
-    hash.reserve((2*(K_t1.size()) + 2)*sizeof(rct::key));
-    hash = std::string((const char*) challenge.bytes, sizeof(challenge));
-    hash.append((const char*) message.bytes, sizeof(message));
-    for (const auto &Kt1 : K_t1)
-    {
-        hash.append((const char*) Kt1.bytes, sizeof(Kt1));
-    }
-    for (const auto &Ki : KI)
-    {
-        hash.append((const char*) &Ki, sizeof(Ki));
-    }
-    CHECK_AND_ASSERT_THROW_MES(hash.size() > 1, "Bad hash input size!");
+    SpTranscript transcript;
+    transcript_init(transcript);
+
+    // absorb challenge elements
+    transcript.absorb(message);
+    transcript.absorb(K_t1);
+    transcript.absorb(KI);
 
     // challenge
-    rct::hash_to_scalar(challenge, hash.data(), hash.size());
+    const rct::key challenge{transcript.challenge()};
 
     CHECK_AND_ASSERT_THROW_MES(sc_isnonzero(challenge.bytes), "Transcript challenge must be nonzero!");
 
@@ -115,11 +118,7 @@ static rct::key compute_base_aggregation_coefficient_a(const rct::key &message,
 static rct::key compute_base_aggregation_coefficient_b(const rct::key &mu_a)
 {
     rct::key challenge;
-    std::string hash;
-    hash.reserve(1*sizeof(rct::key));
-    hash = std::string((const char*) mu_a.bytes, sizeof(mu_a));
-    CHECK_AND_ASSERT_THROW_MES(hash.size() > 1, "Bad hash input size!");
-    rct::hash_to_scalar(challenge, hash.data(), hash.size());
+    rct::hash_to_scalar(challenge, mu_a.bytes, sizeof(mu_a));
 
     CHECK_AND_ASSERT_THROW_MES(sc_isnonzero(challenge.bytes), "Transcript challenge must be nonzero!");
 
@@ -134,16 +133,10 @@ static rct::key compute_base_aggregation_coefficient_b(const rct::key &mu_a)
 //-------------------------------------------------------------------------------------------------------------------
 static rct::key compute_challenge_message(const rct::key &message, const rct::keyV &K)
 {
-    rct::key challenge;
-    std::string hash;
-    hash.reserve((K.size() + 1)*sizeof(rct::key));
-    hash = std::string((const char*) message.bytes, sizeof(message));
-    for (std::size_t i = 0; i < K.size(); ++i)
-    {
-        hash.append((const char*) K[i].bytes, sizeof(K[i]));
-    }
-    CHECK_AND_ASSERT_THROW_MES(hash.size() > 1, "Bad hash input size!");
-    rct::hash_to_scalar(challenge, hash.data(), hash.size());
+    SpTranscript transcript;
+    transcript.absorb(message);
+    transcript.absorb(K);
+    const rct::key challenge{transcript.challenge()};
 
     CHECK_AND_ASSERT_THROW_MES(sc_isnonzero(challenge.bytes), "Transcript challenge must be nonzero!");
 
@@ -158,31 +151,41 @@ static rct::key compute_challenge(const rct::key &message,
     const rct::key &KI_proofkey,
     const rct::keyV &K_t1_proofkeys)
 {
-    rct::key challenge;
-    std::string hash;
-    hash.reserve((K_t1_proofkeys.size() + 3)*sizeof(rct::key));
-    hash = std::string((const char*) message.bytes, sizeof(message));
-    hash.append((const char*) K_t2_proofkey.bytes, sizeof(K_t2_proofkey));
-    hash.append((const char*) KI_proofkey.bytes, sizeof(KI_proofkey));
-    for (std::size_t i = 0; i < K_t1_proofkeys.size(); ++i)
-    {
-        hash.append((const char*) K_t1_proofkeys[i].bytes, sizeof(K_t1_proofkeys[i]));
-    }
-    CHECK_AND_ASSERT_THROW_MES(hash.size() > 1, "Bad hash input size!");
-    rct::hash_to_scalar(challenge, hash.data(), hash.size());
+    SpTranscript transcript;
+    transcript.absorb(message);
+    transcript.absorb(K_t2_proofkey);
+    transcript.absorb(KI_proofkey);
+    transcript.absorb(K_t1_proofkeys);
+    const rct::key challenge{transcript.challenge()};
 
     CHECK_AND_ASSERT_THROW_MES(sc_isnonzero(challenge.bytes), "Transcript challenge must be nonzero!");
 
     return challenge;
 }
 //-------------------------------------------------------------------------------------------------------------------
+// Inverses of the 'y' keys (one field inversion for all of them)
+// y_inv_i = 1 / y_i
+//-------------------------------------------------------------------------------------------------------------------
+static rct::keyV invert_y_keys(const std::vector<crypto::secret_key> &y)
+{
+    rct::keyV y_inv;
+    y_inv.reserve(y.size());
+
+    for (const crypto::secret_key &y_i : y)
+        y_inv.emplace_back(rct::sk2rct(y_i));
+
+    invert_batch(y_inv);
+
+    return y_inv;
+}
+//-------------------------------------------------------------------------------------------------------------------
 // Proof responses
 // r_a = alpha_a - c * sum_i(mu_a^i * (x_i / y_i))
 // r_b = alpha_b - c * sum_i(mu_b^i * (z_i / y_i))
 // r_i = alpha_i - c * (1 / y_i)
 //-------------------------------------------------------------------------------------------------------------------
 static void compute_responses(const std::vector<crypto::secret_key> &x,
-    const std::vector<crypto::secret_key> &y,
+    const rct::keyV &y_inv,
     const std::vector<crypto::secret_key> &z,
     const rct::keyV &mu_a_pows,
     const rct::keyV &mu_b_pows,
@@ -197,7 +200,7 @@ static void compute_responses(const std::vector<crypto::secret_key> &x,
     /// input checks
     const std::size_t num_keys{x.size()};
 
-    CHECK_AND_ASSERT_THROW_MES(num_keys == y.size(), "Not enough keys!");
+    CHECK_AND_ASSERT_THROW_MES(num_keys == y_inv.size(), "Not enough keys!");
     CHECK_AND_ASSERT_THROW_MES(num_keys == z.size(), "Not enough keys!");
     CHECK_AND_ASSERT_THROW_MES(num_keys == mu_a_pows.size(), "Not enough keys!");
     CHECK_AND_ASSERT_THROW_MES(num_keys == mu_b_pows.size(), "Not enough keys!");
@@ -217,8 +220,7 @@ static void compute_responses(const std::vector<crypto::secret_key> &x,
     r_sum_temp = rct::zero();
     for (std::size_t i{0}; i < num_keys; ++i)
     {
-        r_temp = invert(rct::sk2rct(y[i]));  // 1 / y_i
-        sc_mul(r_temp.bytes, r_temp.bytes, &x[i]);  // x_i / y_i
+        sc_mul(r_temp.bytes, y_inv[i].bytes, &x[i]);  // x_i / y_i
         sc_mul(r_temp.bytes, r_temp.bytes, mu_a_pows[i].bytes);  // mu_a^i * x_i / y_i
         sc_add(r_sum_temp.bytes, r_sum_temp.bytes, r_temp.bytes);  // sum_i(...)
     }
@@ -228,8 +230,7 @@ static void compute_responses(const std::vector<crypto::secret_key> &x,
     r_sum_temp = rct::zero();
     for (std::size_t i{0}; i < num_keys; ++i)
     {
-        r_temp = invert(rct::sk2rct(y[i]));  // 1 / y_i
-        sc_mul(r_temp.bytes, r_temp.bytes, &z[i]);  // z_i / y_i
+        sc_mul(r_temp.bytes, y_inv[i].bytes, &z[i]);  // z_i / y_i
         sc_mul(r_temp.bytes, r_temp.bytes, mu_b_pows[i].bytes);  // mu_b^i * z_i / y_i
         sc_add(r_sum_temp.bytes, r_sum_temp.bytes, r_temp.bytes);  // sum_i(...)
     }
@@ -240,8 +241,7 @@ static void compute_responses(const std::vector<crypto::secret_key> &x,
 
     for (std::size_t i{0}; i < num_keys; ++i)
     {
-        r_temp = invert(rct::sk2rct(y[i]));  // 1 / y_i
-        sc_mulsub(r_i_out[i].bytes, challenge.bytes, r_temp.bytes, alpha_i[i].bytes);  // alpha_i - c * (1 / y_i)
+        sc_mulsub(r_i_out[i].bytes, challenge.bytes, y_inv[i].bytes, alpha_i[i].bytes);  // alpha_i - c * (1 / y_i)
     }
 }
 //-------------------------------------------------------------------------------------------------------------------
@@ -250,15 +250,46 @@ static void compute_responses(const std::vector<crypto::secret_key> &x,
 // K_t1_i = (1/y_i) * K_i
 // return: (1/8)*K_t1_i
 //-------------------------------------------------------------------------------------------------------------------
-static void compute_K_t1_for_proof(const crypto::secret_key &y_i,
+static void compute_K_t1_for_proof(const rct::key &y_inv_i,
     const rct::key &K_i,
     rct::key &K_t1_out)
 {
-    K_t1_out = invert(rct::sk2rct(y_i));  // borrow the variable
-    sc_mul(K_t1_out.bytes, K_t1_out.bytes, rct::INV_EIGHT.bytes);
+    sc_mul(K_t1_out.bytes, y_inv_i.bytes, rct::INV_EIGHT.bytes);  // borrow the variable
     rct::scalarmultKey(K_t1_out, K_i, K_t1_out);
 }
 //-------------------------------------------------------------------------------------------------------------------
+// Commitment to a signature opener
+//   - multiplied by (1/8) for storage (and use in byte-aware contexts)
+// return: (1/8)*alpha*base
+//-------------------------------------------------------------------------------------------------------------------
+static void compute_stored_commitment(const rct::key &alpha, const rct::key &base, rct::key &commitment_out)
+{
+    sc_mul(commitment_out.bytes, alpha.bytes, rct::INV_EIGHT.bytes);  // borrow the variable
+
+    // fixed generators have precomputed tables
+    if (base == rct::G)
+        rct::scalarmultBase(commitment_out, commitment_out);
+    else if (base == get_U_gen())
+        scalarmult_U(commitment_out, commitment_out);
+    else
+        rct::scalarmultKey(commitment_out, base, commitment_out);
+}
+//-------------------------------------------------------------------------------------------------------------------
+// Signature opener with its commitment
+//   - commitment is multiplied by (1/8) for storage (and use in byte-aware contexts)
+// return: alpha, (1/8)*alpha*base
+//-------------------------------------------------------------------------------------------------------------------
+static void generate_proof_commitment(const rct::key &base, rct::key &alpha_out, rct::key &commitment_out)
+{
+    CHECK_AND_ASSERT_THROW_MES(!(base == rct::identity()), "Bad base for generating proof nonce!");
+
+    do
+    {
+        alpha_out = rct::skGen();
+        compute_stored_commitment(alpha_out, base, commitment_out);
+    } while (alpha_out == rct::zero() || commitment_out == rct::identity());
+}
+//-------------------------------------------------------------------------------------------------------------------
 // MuSig2--style bi-nonce signing merge factor
 // rho_e = H("domain-sep", m, alpha_1_1, ..., alpha_1_N, alpha_2_1, ..., alpha_2_N)
 //-------------------------------------------------------------------------------------------------------------------
@@ -266,25 +297,237 @@ static rct::key multisig_binonce_merge_factor(const rct::key &message,
     const rct::keyV &nonces_1,
     const rct::keyV &nonces_2)
 {
-    rct::key merge_factor;
-
     // build hash
-    std::string hash;
-    hash.reserve(sizeof(config::HASH_KEY_MULTISIG_BINONCE_MERGE_FACTOR) + 1 + nonces_1.size() + nonces_2.size());
-    hash = config::HASH_KEY_MULTISIG_BINONCE_MERGE_FACTOR;
-    hash.append((const char*) message.bytes, sizeof(message));
-    for (const auto &nonce_1 : nonces_1)
+    SpTranscript transcript;
+    transcript.absorb_string(config::HASH_KEY_MULTISIG_BINONCE_MERGE_FACTOR);
+    transcript.absorb(message);
+    transcript.absorb(nonces_1);
+    transcript.absorb(nonces_2);
+
+    return transcript.challenge();
+}
+//-------------------------------------------------------------------------------------------------------------------
+// Multisig KI component nonce
+// return: alpha, (1/8)*alpha*U
+//-------------------------------------------------------------------------------------------------------------------
+static void make_multisig_KI_nonce(crypto::secret_key &alpha_out, rct::key &nonce_pub_out)
+{
+    rct::key alpha_inv8;
+
+    do
+    {
+        alpha_out = rct::rct2sk(rct::skGen());
+        sc_mul(alpha_inv8.bytes, &alpha_out, rct::INV_EIGHT.bytes);
+        scalarmult_U(alpha_inv8, nonce_pub_out);
+    } while (alpha_out == rct::rct2sk(rct::zero()) || nonce_pub_out == rct::identity());
+
+    memwipe(alpha_inv8.bytes, sizeof(alpha_inv8));
+}
+//-------------------------------------------------------------------------------------------------------------------
+// Input checks for a multisig partial signature
+//-------------------------------------------------------------------------------------------------------------------
+static void check_multisig_partial_sig_inputs(const SpCompositionProofMultisigProposal &proposal,
+    const std::vector<crypto::secret_key> &x,
+    const std::vector<crypto::secret_key> &y,
+    const std::vector<crypto::secret_key> &z_e,
+    const rct::keyV &signer_nonces_pub_1,
+    const rct::keyV &signer_nonces_pub_2,
+    const crypto::secret_key &local_nonce_1_priv,
+    const crypto::secret_key &local_nonce_2_priv)
+{
+    const std::size_t num_keys{proposal.K.size()};
+    const std::size_t num_signers{signer_nonces_pub_1.size()};
+
+    CHECK_AND_ASSERT_THROW_MES(num_keys > 0, "Not enough keys to make a proof!");
+    CHECK_AND_ASSERT_THROW_MES(num_keys == proposal.KI.size(), "Input key sets not the same size (K ?= KI)!");
+    CHECK_AND_ASSERT_THROW_MES(num_keys == proposal.signature_nonces_K_t1.size(), "Input key sets not the same size (K ?= KI)!");
+    CHECK_AND_ASSERT_THROW_MES(num_keys == x.size(), "Input key sets not the same size (K ?= x)!");
+    CHECK_AND_ASSERT_THROW_MES(num_keys == y.size(), "Input key sets not the same size (K ?= y)!");
+    CHECK_AND_ASSERT_THROW_MES(num_keys == z_e.size(), "Input key sets not the same size (K ?= z)!");
+
+    for (std::size_t i{0}; i < num_keys; ++i)
+    {
+        CHECK_AND_ASSERT_THROW_MES(!(proposal.K[i] == rct::identity()), "Bad proof key (K[i] identity)!");
+        CHECK_AND_ASSERT_THROW_MES(!(rct::ki2rct(proposal.KI[i]) == rct::identity()), "Bad proof key (KI[i] identity)!");
+
+        // x == 0 is allowed
+        CHECK_AND_ASSERT_THROW_MES(sc_check(&x[i]) == 0, "Bad private key (x[i])!");
+        CHECK_AND_ASSERT_THROW_MES(sc_isnonzero(&y[i]), "Bad private key (y[i] zero)!");
+        CHECK_AND_ASSERT_THROW_MES(sc_check(&y[i]) == 0, "Bad private key (y[i])!");
+        CHECK_AND_ASSERT_THROW_MES(sc_isnonzero(&z_e[i]), "Bad private key (z[i] zero)!");
+        CHECK_AND_ASSERT_THROW_MES(sc_check(&z_e[i]) == 0, "Bad private key (z[i])!");
+    }
+
+    CHECK_AND_ASSERT_THROW_MES(num_signers == signer_nonces_pub_2.size(), "Signer nonces mismatch!");
+
+    CHECK_AND_ASSERT_THROW_MES(sc_check(&local_nonce_1_priv) == 0, "Bad private key (local_nonce_1_priv)!");
+    CHECK_AND_ASSERT_THROW_MES(sc_isnonzero(&local_nonce_1_priv), "Bad private key (local_nonce_1_priv zero)!");
+    CHECK_AND_ASSERT_THROW_MES(sc_check(&local_nonce_2_priv) == 0, "Bad private key (local_nonce_2_priv)!");
+    CHECK_AND_ASSERT_THROW_MES(sc_isnonzero(&local_nonce_2_priv), "Bad private key (local_nonce_2_priv zero)!");
+}
+//-------------------------------------------------------------------------------------------------------------------
+// Make a multisig partial signature from checked inputs
+// - y_inv: inverses of the 'y' keys (y_inv_i = 1 / y_i)
+//-------------------------------------------------------------------------------------------------------------------
+static SpCompositionProofMultisigPartial make_multisig_partial_sig(const SpCompositionProofMultisigProposal &proposal,
+    const std::vector<crypto::secret_key> &x,
+    const rct::keyV &y_inv,
+    const std::vector<crypto::secret_key> &z_e,
+    const rct::keyV &signer_nonces_pub_1,
+    const rct::keyV &signer_nonces_pub_2,
+    const crypto::secret_key &local_nonce_1_priv,
+    const crypto::secret_key &local_nonce_2_priv)
+{
+    const std::size_t num_keys{proposal.K.size()};
+    const std::size_t num_signers{signer_nonces_pub_1.size()};
+
+    // prepare participant nonces
+    rct::keyV signer_nonces_pub_1_mul8;
+    rct::keyV signer_nonces_pub_2_mul8;
+    signer_nonces_pub_1_mul8.reserve(num_signers);
+    signer_nonces_pub_2_mul8.reserve(num_signers);
+
+    for (std::size_t e{0}; e < num_signers; ++e)
+    {
+        signer_nonces_pub_1_mul8.emplace_back(rct::scalarmult8(signer_nonces_pub_1[e]));
+        signer_nonces_pub_2_mul8.emplace_back(rct::scalarmult8(signer_nonces_pub_2[e]));
+        CHECK_AND_ASSERT_THROW_MES(!(signer_nonces_pub_1_mul8.back() == rct::identity()), "Bad signer nonce (alpha_1 identity)!");
+        CHECK_AND_ASSERT_THROW_MES(!(signer_nonces_pub_2_mul8.back() == rct::identity()), "Bad signer nonce (alpha_2 identity)!");
+    }
+
+    // sort participant nonces so binonce merge factor is deterministic
+    std::vector<std::size_t> signer_nonces_pub_original_indices;
+    signer_nonces_pub_original_indices.resize(num_signers);
+
+    for (std::size_t e{0}; e < num_signers; ++e)
     {
-        hash.append((const char*) nonce_1.bytes, sizeof(rct::key));
+        signer_nonces_pub_original_indices[e] = e;
     }
-    for (const auto &nonce_2 : nonces_2)
+
+    std::sort(signer_nonces_pub_original_indices.begin(), signer_nonces_pub_original_indices.end(),
+            [&signer_nonces_pub_1_mul8](const std::size_t &index_1, const std::size_t &index_2) -> bool
+            {
+                return memcmp(signer_nonces_pub_1_mul8[index_1].bytes, signer_nonces_pub_1_mul8[index_2].bytes,
+                    sizeof(rct::key)) < 0;
+            }
+        );
+
+    rct::keyV signer_nonces_pub_1_mul8_temp{std::move(signer_nonces_pub_1_mul8)};
+    rct::keyV signer_nonces_pub_2_mul8_temp{std::move(signer_nonces_pub_2_mul8)};
+    signer_nonces_pub_1_mul8.clear();
+    signer_nonces_pub_2_mul8.clear();
+    signer_nonces_pub_1_mul8.reserve(num_signers);
+    signer_nonces_pub_2_mul8.reserve(num_signers);
+
+    for (std::size_t e{0}; e < num_signers; ++e)
     {
-        hash.append((const char*) nonce_2.bytes, sizeof(rct::key));
+        signer_nonces_pub_1_mul8.emplace_back(signer_nonces_pub_1_mul8_temp[signer_nonces_pub_original_indices[e]]);
+        signer_nonces_pub_2_mul8.emplace_back(signer_nonces_pub_2_mul8_temp[signer_nonces_pub_original_indices[e]]);
+    }
+
+    // check that the local signer's signature opening is in the input set of opening nonces
+    bool found_local_nonce{false};
+    rct::key local_nonce_1_pub;
+    rct::key local_nonce_2_pub;
+    scalarmult_U(rct::sk2rct(local_nonce_1_priv), local_nonce_1_pub);
+    scalarmult_U(rct::sk2rct(local_nonce_2_priv), local_nonce_2_pub);
+
+    for (std::size_t e{0}; e < num_signers; ++e)
+    {
+        if (local_nonce_1_pub == signer_nonces_pub_1_mul8[e] &&
+            local_nonce_2_pub == signer_nonces_pub_2_mul8[e])
+        {
+            found_local_nonce = true;
+            break;
+        }
     }
+    CHECK_AND_ASSERT_THROW_MES(found_local_nonce, "Local signer's opening nonces not in input set!");
+
+
+    /// prepare partial signature
+    SpCompositionProofMultisigPartial partial_sig;
+
+    // make K_t1
+    partial_sig.K_t1.resize(num_keys);
+
+    for (std::size_t i{0}; i < num_keys; ++i)
+    {
+        // K_t1_i = (1/8) * (1/y_i) * K_i
+        compute_K_t1_for_proof(y_inv[i], proposal.K[i], partial_sig.K_t1[i]);
+    }
+
+    // set partial sig pieces
+    partial_sig.KI = proposal.KI;
+    partial_sig.K = proposal.K;
+    partial_sig.message = proposal.message;
+
+
+    /// challenge message and aggregation coefficients
+    rct::key mu_a{compute_base_aggregation_coefficient_a(partial_sig.message, partial_sig.K_t1, partial_sig.KI)};
+    rct::keyV mu_a_pows{powers_of_scalar(mu_a, num_keys)};
+
+    rct::key mu_b{compute_base_aggregation_coefficient_b(mu_a)};
+    rct::keyV mu_b_pows{powers_of_scalar(mu_b, num_keys)};
+
+    rct::key m{compute_challenge_message(mu_b, partial_sig.K)};
+
+    rct::key binonce_merge_factor{multisig_binonce_merge_factor(m, signer_nonces_pub_1_mul8, signer_nonces_pub_2_mul8)};
+
+
+    /// signature openers (commitments stored with (1/8))
+
+    // alpha_a * G
+    compute_stored_commitment(proposal.signature_nonce_K_t2, rct::G, partial_sig.A_K_t2);
+
+    // alpha_b * U
+    // - MuSig2-style merged nonces from all multisig participants
+
+    // alpha_b_1 = sum(alpha_b_1_e * U)
+    rct::key alpha_b_pub{rct::addKeys(signer_nonces_pub_1_mul8)};
+
+    // alpha_b_2 * U = rho * sum(alpha_b_2_e * U)
+    // rho = H(m, {alpha_b_1_e * U}, {alpha_b_2_e * U})
+    rct::key alpha_b_2_pub{rct::addKeys(signer_nonces_pub_2_mul8)};
+    rct::scalarmultKey(alpha_b_2_pub, alpha_b_2_pub, binonce_merge_factor);
+
+    // alpha_b * U = alpha_b_1 + alpha_b_2
+    rct::addKeys(alpha_b_pub, alpha_b_pub, alpha_b_2_pub);
+    rct::scalarmultKey(partial_sig.A_KI, alpha_b_pub, rct::INV_EIGHT);
+
+    // alpha_i[i] * K_i
+    partial_sig.A_K_t1.resize(num_keys);
+
+    for (std::size_t i{0}; i < num_keys; ++i)
+    {
+        compute_stored_commitment(proposal.signature_nonces_K_t1[i], partial_sig.K[i], partial_sig.A_K_t1[i]);
+    }
+
+
+    /// compute proof challenge
+    const rct::key c{compute_challenge(m, partial_sig.A_K_t2, partial_sig.A_KI, partial_sig.A_K_t1)};
+
+
+    /// responses
+    crypto::secret_key merged_nonce_KI_priv;  // alpha_1_local + rho * alpha_2_local
+    sc_muladd(&merged_nonce_KI_priv, &local_nonce_2_priv, binonce_merge_factor.bytes, &local_nonce_1_priv);
+
+    compute_responses(x,
+            y_inv,
+            z_e,  // for partial signature
+            mu_a_pows,
+            mu_b_pows,
+            proposal.signature_nonce_K_t2,
+            rct::sk2rct(merged_nonce_KI_priv),  // for partial signature
+            proposal.signature_nonces_K_t1,
+            c,
+            partial_sig.r_a,
+            partial_sig.r_b_partial,  // partial response
+            partial_sig.r_i
+        );
 
-    rct::hash_to_scalar(merge_factor, hash.data(), hash.size());
 
-    return merge_factor;
+    /// done
+    return partial_sig;
 }
 //-------------------------------------------------------------------------------------------------------------------
 //-------------------------------------------------------------------------------------------------------------------
@@ -294,6 +537,8 @@ SpCompositionProof sp_composition_prove(const rct::keyV &K,
     const std::vector<crypto::secret_key> &z,
     const rct::key &message)
 {
+    MOCK_TX_PHASE_TIMER(COMPOSITION_PROOF_PROVE);
+
     /// input checks and initialization
     const std::size_t num_keys{K.size()};
 
@@ -326,6 +571,12 @@ SpCompositionProof sp_composition_prove(const rct::keyV &K,
 
     SpCompositionProof proof;
 
+    // 1/y_i (used for K_t1 and the responses)
+    rct::keyV y_inv{invert_y_keys(y)};
+    auto y_inv_wiper = epee::misc_utils::create_scope_leave_handler([&]{
+        memwipe(y_inv.data(), y_inv.size()*sizeof(rct::key));
+    });
+
     // make K_t1 and KI
     std::vector<crypto::key_image> KI;
     proof.K_t1.resize(num_keys);
@@ -334,41 +585,40 @@ SpCompositionProof sp_composition_prove(const rct::keyV &K,
     for (std::size_t i{0}; i < num_keys; ++i)
     {
         // K_t1_i = (1/8) * (1/y_i) * K_i
-        compute_K_t1_for_proof(y[i], K[i], proof.K_t1[i]);
+        compute_K_t1_for_proof(y_inv[i], K[i], proof.K_t1[i]);
 
-        // KI = (z_i / y_i) * U
+        // KI = (z_i / y_i) * U (reusing 1/y_i)
         // note: plain KI is used in all byte-aware contexts
-        mock_tx::make_seraphis_key_image(y[i], z[i], KI[i]);
+        sc_mul(temp_K.bytes, &z[i], y_inv[i].bytes);
+        scalarmult_U(temp_K, temp_K);
+        KI[i] = rct::rct2ki(temp_K);
     }
 
 
-    /// signature openers
+    /// signature openers (commitments stored with (1/8))
 
     // alpha_a * G
-    crypto::secret_key alpha_a;
-    rct::key alpha_a_pub;
-
-    generate_proof_nonce(rct::G, alpha_a, alpha_a_pub);
+    rct::key alpha_a;
+    generate_proof_commitment(rct::G, alpha_a, proof.A_K_t2);
 
     // alpha_b * U
-    crypto::secret_key alpha_b;
-    rct::key alpha_b_pub;
-
-    generate_proof_nonce(U_gen, alpha_b, alpha_b_pub);
+    rct::key alpha_b;
+    generate_proof_commitment(U_gen, alpha_b, proof.A_KI);
 
     // alpha_i[i] * K_i
     rct::keyV alpha_i;
-    rct::keyV alpha_i_pub;
     alpha_i.resize(num_keys);
-    alpha_i_pub.resize(num_keys);
+    proof.A_K_t1.resize(num_keys);
     auto a_wiper = epee::misc_utils::create_scope_leave_handler([&]{
         // cleanup: clear secret prover data at the end
+        memwipe(&alpha_a, sizeof(rct::key));
+        memwipe(&alpha_b, sizeof(rct::key));
         memwipe(alpha_i.data(), alpha_i.size()*sizeof(rct::key));
     });
 
     for (std::size_t i{0}; i < num_keys; ++i)
     {
-        generate_proof_nonce(K[i], alpha_i[i], alpha_i_pub[i]);
+        generate_proof_commitment(K[i], alpha_i[i], proof.A_K_t1[i]);
     }
 
 
@@ -383,19 +633,19 @@ SpCompositionProof sp_composition_prove(const rct::keyV &K,
 
 
     /// compute proof challenge
-    proof.c = compute_challenge(m, alpha_a_pub, alpha_b_pub, alpha_i_pub);
+    const rct::key c{compute_challenge(m, proof.A_K_t2, proof.A_KI, proof.A_K_t1)};
 
 
     /// responses
     compute_responses(x,
-        y,
+        y_inv,
         z,
         mu_a_pows,
         mu_b_pows,
-        rct::sk2rct(alpha_a),
-        rct::sk2rct(alpha_b),
+        alpha_a,
+        alpha_b,
         alpha_i,
-        proof.c,
+        c,
         proof.r_a,
         proof.r_b,
         proof.r_i);
@@ -409,126 +659,185 @@ bool sp_composition_verify(const SpCompositionProof &proof,
     const rct::keyV &K,
     const std::vector<crypto::key_image> &KI,
     const rct::key &message)
+{
+    return check_pippenger_data(get_sp_composition_verification_data({&proof}, {K}, {KI}, {message}));
+}
+//-------------------------------------------------------------------------------------------------------------------
+rct::pippenger_prep_data get_sp_composition_verification_data(const std::vector<const SpCompositionProof*> &proofs,
+    const std::vector<rct::keyV> &K,
+    const std::vector<std::vector<crypto::key_image>> &KI,
+    const rct::keyV &messages)
 {
     /// input checks and initialization
-    const std::size_t num_keys{K.size()};
+    const std::size_t num_proofs{proofs.size()};
 
-    CHECK_AND_ASSERT_THROW_MES(num_keys > 0, "Proof has no keys!");
-    CHECK_AND_ASSERT_THROW_MES(num_keys == KI.size(), "Input key sets not the same size (KI)!");
-    CHECK_AND_ASSERT_THROW_MES(num_keys == proof.K_t1.size(), "Input key sets not the same size (K_t1)!");
-    CHECK_AND_ASSERT_THROW_MES(num_keys == proof.r_i.size(), "Insufficient proof responses!");
+    CHECK_AND_ASSERT_THROW_MES(num_proofs > 0, "Must have at least one proof to verify!");
+    CHECK_AND_ASSERT_THROW_MES(num_proofs == K.size(), "Input key sets not the same size (K)!");
+    CHECK_AND_ASSERT_THROW_MES(num_proofs == KI.size(), "Input key sets not the same size (KI)!");
+    CHECK_AND_ASSERT_THROW_MES(num_proofs == messages.size(), "Input key sets not the same size (messages)!");
 
-    CHECK_AND_ASSERT_THROW_MES(sc_isnonzero(proof.r_a.bytes), "Bad response (r_a zero)!");
-    CHECK_AND_ASSERT_THROW_MES(sc_check(proof.r_a.bytes) == 0, "Bad resonse (r_a)!");
+    std::size_t total_keys{0};
 
-    for (std::size_t i{0}; i < num_keys; ++i)
+    for (std::size_t proof_index{0}; proof_index < num_proofs; ++proof_index)
     {
-        CHECK_AND_ASSERT_THROW_MES(sc_isnonzero(proof.r_i[i].bytes), "Bad response (r[i] zero)!");
-        CHECK_AND_ASSERT_THROW_MES(sc_check(proof.r_i[i].bytes) == 0, "Bad resonse (r[i])!");
+        CHECK_AND_ASSERT_THROW_MES(proofs[proof_index], "Proof unexpectedly doesn't exist!");
+        const SpCompositionProof &proof = *(proofs[proof_index]);
+        const std::size_t num_keys{K[proof_index].size()};
 
-        CHECK_AND_ASSERT_THROW_MES(!(rct::ki2rct(KI[i]) == rct::identity()), "Invalid key image!");
-    }
+        CHECK_AND_ASSERT_THROW_MES(num_keys > 0, "Proof has no keys!");
+        CHECK_AND_ASSERT_THROW_MES(num_keys == KI[proof_index].size(), "Input key sets not the same size (KI)!");
+        CHECK_AND_ASSERT_THROW_MES(num_keys == proof.K_t1.size(), "Input key sets not the same size (K_t1)!");
+        CHECK_AND_ASSERT_THROW_MES(num_keys == proof.A_K_t1.size(), "Insufficient proof commitments!");
+        CHECK_AND_ASSERT_THROW_MES(num_keys == proof.r_i.size(), "Insufficient proof responses!");
 
+        CHECK_AND_ASSERT_THROW_MES(sc_isnonzero(proof.r_a.bytes), "Bad response (r_a zero)!");
+        CHECK_AND_ASSERT_THROW_MES(sc_check(proof.r_a.bytes) == 0, "Bad resonse (r_a)!");
+        CHECK_AND_ASSERT_THROW_MES(sc_check(proof.r_b.bytes) == 0, "Bad resonse (r_b)!");
 
-    /// challenge message and aggregation coefficients
-    rct::key mu_a = compute_base_aggregation_coefficient_a(message, proof.K_t1, KI);
-    rct::keyV mu_a_pows = powers_of_scalar(mu_a, num_keys);
-
-    rct::key mu_b = compute_base_aggregation_coefficient_b(mu_a);
-    rct::keyV mu_b_pows = powers_of_scalar(mu_b, num_keys);
+        for (std::size_t i{0}; i < num_keys; ++i)
+        {
+            CHECK_AND_ASSERT_THROW_MES(sc_isnonzero(proof.r_i[i].bytes), "Bad response (r[i] zero)!");
+            CHECK_AND_ASSERT_THROW_MES(sc_check(proof.r_i[i].bytes) == 0, "Bad resonse (r[i])!");
 
-    rct::key m = compute_challenge_message(mu_b, K);
+            CHECK_AND_ASSERT_THROW_MES(!(rct::ki2rct(KI[proof_index][i]) == rct::identity()), "Invalid key image!");
+        }
 
+        total_keys += num_keys;
+    }
 
-    /// challenge pieces
 
-    // K_t2 part: [r_a * G + c * sum_i(mu_a^i * K_t2[i])]
-    // KI part:   [r_b * U + c * sum_i(mu_b^i * KI[i]  )]
-    // K_t1[i] parts: [r[i] * K[i] + c * K_t1[i]]
-    rct::keyV K_t2_coeff;
-    rct::keyV KI_privkeys;
-    rct::keyV K_t1_privkeys;
-    std::vector<ge_p3> K_t2_p3;
-    std::vector<ge_p3> KI_part_p3;
-    std::vector<ge_p3> K_t1_p3;
-    rct::keyV challenge_parts_i;
+    /// setup 'data': for aggregate multi-exponentiation computation across all proofs
+
+    // per-index storage:
+    // 0        G                             (sum of r_a terms)
+    // 1        U                             (sum of r_b terms)
+    // 2        X                             (sum of K_t2 terms)
+    //    <per-proof, start at 3>
+    // 0        A_K_t2
+    // 1        A_KI
+    // ...      {A_K_t1[i], K_t1[i], KI[i], K[i]}
+    // - 'data' is taken from the multiexp data pool and the challenge powers are borrowed from the scratch arena, so
+    //   steady-state calls do not allocate (if the caller recycles the returned data once it is checked)
+    const std::size_t max_size{3 + 2*num_proofs + 4*total_keys};
+    std::vector<rct::MultiexpData> data{rct::take_multiexp_data_buffer(max_size)};
+    data.resize(3);  // start with common/batched elements (set at the end)
+
+    SpScratchFrame scratch{sp_thread_scratch_arena()};
+    rct::keyV &mu_a_pows = scratch.keys(0);
+    rct::keyV &mu_b_pows = scratch.keys(0);
+
+    rct::key G_scalar{rct::zero()};
+    rct::key U_scalar{rct::zero()};
+    rct::key X_scalar{rct::zero()};
+    rct::key temp;
+    rct::key temp2;
     ge_p3 temp_p3;
-    ge_cached temp_cache;
-    ge_cached X_cache;
-    ge_p1p1 temp_p1p1;
-    K_t2_coeff.reserve(num_keys + 1);
-    KI_privkeys.reserve(num_keys + 1);
-    K_t1_privkeys.resize(2);
-    K_t2_p3.resize(num_keys);   // note: no '+ 1' because G is implied
-    KI_part_p3.resize(num_keys + 1);
-    K_t1_p3.resize(2);
-    challenge_parts_i.resize(num_keys);
-
-    temp_p3 = get_X_p3_gen();
-    ge_p3_to_cached(&X_cache, &temp_p3); // cache X for use below
-    K_t1_privkeys[1] = proof.c; // prep outside loop
 
-    for (std::size_t i{0}; i < num_keys; ++i)
+
+    /// per-proof data assembly
+    for (std::size_t proof_index{0}; proof_index < num_proofs; ++proof_index)
     {
-        // c * mu_a^i
-        K_t2_coeff.push_back(mu_a_pows[i]);
-        sc_mul(K_t2_coeff.back().bytes, K_t2_coeff.back().bytes, proof.c.bytes);
+        const SpCompositionProof &proof = *(proofs[proof_index]);
+        const rct::keyV &proof_K = K[proof_index];
+        const std::vector<crypto::key_image> &proof_KI = KI[proof_index];
+        const std::size_t num_keys{proof_K.size()};
+
+        // random weights
+        // - to allow verifiying batches of proofs, must weight each proof's components randomly so an adversary doesn't
+        //   gain an advantage if >1 of their proofs are being validated in a batch
+        // - the weights are negated small scalars, so the nonce commitments' multiexp scalars (-w) are small
+        rct::key w_a{rct::zero()};  // K_t2:    w_a*[ r_a * G + c * sum_i(mu_a^i * K_t2[i]) - A_K_t2 ] == 0
+        rct::key w_b{rct::zero()};  // KI:      w_b*[ r_b * U + c * sum_i(mu_b^i * KI[i]  ) - A_KI   ] == 0
+        while (w_a == rct::zero() || w_b == rct::zero())
+        {
+            w_a = minus_small_scalar_gen(DEFAULT_BATCH_WEIGHT_SIZE);
+            w_b = minus_small_scalar_gen(DEFAULT_BATCH_WEIGHT_SIZE);
+        }
 
-        // c * mu_b^i
-        KI_privkeys.push_back(mu_b_pows[i]);
-        sc_mul(KI_privkeys.back().bytes, KI_privkeys.back().bytes, proof.c.bytes);
+        // challenge message and aggregation coefficients
+        const rct::key mu_a{compute_base_aggregation_coefficient_a(messages[proof_index], proof.K_t1, proof_KI)};
+        powers_of_scalar(mu_a, num_keys, false, mu_a_pows);
 
-        // get K_t1, multiply by cofactor as part of deserialization, and check it is non-identity
-        rct::scalarmult8(K_t1_p3[1], proof.K_t1[i]);
-        CHECK_AND_ASSERT_THROW_MES(!(ge_p3_is_point_at_infinity_vartime(&K_t1_p3[1])), "Invalid proof element K_t1!");
+        const rct::key mu_b{compute_base_aggregation_coefficient_b(mu_a)};
+        powers_of_scalar(mu_b, num_keys, false, mu_b_pows);
 
-        // get KI
-        CHECK_AND_ASSERT_THROW_MES(ge_frombytes_vartime(&KI_part_p3[i], rct::ki2rct(KI[i]).bytes) == 0,
-            "ge_frombytes_vartime failed!");
+        const rct::key m{compute_challenge_message(mu_b, proof_K)};
 
-        // get K
-        CHECK_AND_ASSERT_THROW_MES(ge_frombytes_vartime(&K_t1_p3[0], K[i].bytes) == 0,
-            "ge_frombytes_vartime failed!");
+        // challenge
+        const rct::key c{compute_challenge(m, proof.A_K_t2, proof.A_KI, proof.A_K_t1)};
 
-        // temp: K_t1 - KI
-        ge_p3_to_cached(&temp_cache, &KI_part_p3[i]);
-        ge_sub(&temp_p1p1, &K_t1_p3[1], &temp_cache);
-        ge_p1p1_to_p3(&temp_p3, &temp_p1p1);
+        // w_a * c, w_b * c
+        rct::key w_a_c;
+        rct::key w_b_c;
+        sc_mul(w_a_c.bytes, w_a.bytes, c.bytes);
+        sc_mul(w_b_c.bytes, w_b.bytes, c.bytes);
 
-        // K_t2 = (K_t1 - KI) - X
-        ge_sub(&temp_p1p1, &temp_p3, &X_cache);
-        ge_p1p1_to_p3(&K_t2_p3[i], &temp_p1p1);
+        // G: w_a * r_a
+        sc_muladd(G_scalar.bytes, w_a.bytes, proof.r_a.bytes, G_scalar.bytes);
 
-        // privkey for K_t1 part
-        K_t1_privkeys[0] = proof.r_i[i];
+        // U: w_b * r_b
+        sc_muladd(U_scalar.bytes, w_b.bytes, proof.r_b.bytes, U_scalar.bytes);
 
-        // compute 'K_t1[i]' piece
-        multi_exp_vartime(K_t1_privkeys, K_t1_p3, challenge_parts_i[i]);
-    }
+        // A_K_t2: -w_a
+        // A_KI:   -w_b
+        // note: multiply stored commitments by cofactor as part of deserialization
+        sc_mul(temp.bytes, MINUS_ONE.bytes, w_a.bytes);
+        rct::scalarmult8(temp_p3, proof.A_K_t2);
+        data.emplace_back(temp, temp_p3);
 
-    // K_t2: r_a * G + ...
-    K_t2_coeff.push_back(proof.r_a);
-    //G implied, not stored in 'K_t2_p3'
+        sc_mul(temp.bytes, MINUS_ONE.bytes, w_b.bytes);
+        rct::scalarmult8(temp_p3, proof.A_KI);
+        data.emplace_back(temp, temp_p3);
 
-    // KI: r_b * U + ...
-    KI_privkeys.push_back(proof.r_b);
-    KI_part_p3[num_keys] = get_U_p3_gen();
+        for (std::size_t i{0}; i < num_keys; ++i)
+        {
+            // K_t1[i]: w_i*[ r_i * K[i] + c * K_t1[i] - A_K_t1[i] ] == 0
+            rct::key w_i{rct::zero()};
+            while (w_i == rct::zero())
+                w_i = minus_small_scalar_gen(DEFAULT_BATCH_WEIGHT_SIZE);
+
+            // w_a*c*mu_a^i (K_t2[i] = K_t1[i] - X - KI[i])
+            sc_mul(temp2.bytes, w_a_c.bytes, mu_a_pows[i].bytes);
+
+            // X: -w_a*c*mu_a^i
+            sc_sub(X_scalar.bytes, X_scalar.bytes, temp2.bytes);
+
+            // A_K_t1[i]: -w_i
+            sc_mul(temp.bytes, MINUS_ONE.bytes, w_i.bytes);
+            rct::scalarmult8(temp_p3, proof.A_K_t1[i]);
+            data.emplace_back(temp, temp_p3);
+
+            // K_t1[i]: w_a*c*mu_a^i + w_i*c
+            // - get K_t1, multiply by cofactor as part of deserialization, and check it is non-identity
+            sc_muladd(temp.bytes, w_i.bytes, c.bytes, temp2.bytes);
+            rct::scalarmult8(temp_p3, proof.K_t1[i]);
+            CHECK_AND_ASSERT_THROW_MES(!(ge_p3_is_point_at_infinity_vartime(&temp_p3)), "Invalid proof element K_t1!");
+            data.emplace_back(temp, temp_p3);
+
+            // KI[i]: -w_a*c*mu_a^i + w_b*c*mu_b^i
+            sc_mul(temp.bytes, w_b_c.bytes, mu_b_pows[i].bytes);
+            sc_sub(temp.bytes, temp.bytes, temp2.bytes);
+            data.emplace_back(temp, rct::ki2rct(proof_KI[i]));
+
+            // K[i]: w_i*r_i
+            sc_mul(temp.bytes, w_i.bytes, proof.r_i[i].bytes);
+            data.emplace_back(temp, proof_K[i]);
+        }
+    }
 
-    // compute 'a' piece
-    rct::key challenge_part_a;
-    multi_exp_vartime(K_t2_coeff, K_t2_p3, challenge_part_a);
 
-    // compute 'b' piece
-    rct::key challenge_part_b;
-    multi_exp_vartime(KI_privkeys, KI_part_p3, challenge_part_b);
+    /// Generator terms: G, U, X
+    data[0] = {G_scalar, rct::G};
+    data[1] = {U_scalar, get_U_p3_gen()};
+    data[2] = {X_scalar, get_X_p3_gen()};
 
 
-    /// compute nominal challenge
-    rct::key challenge_nom{compute_challenge(m, challenge_part_a, challenge_part_b, challenge_parts_i)};
+    /// Final check
+    CHECK_AND_ASSERT_THROW_MES(data.size() == max_size, "Final proof data is incorrect size!");
 
 
-    /// validate proof
-    return challenge_nom == proof.c;
+    /// return multiexp data for caller to deal with
+    return rct::pippenger_prep_data{std::move(data), nullptr, 0};
 }
 //-------------------------------------------------------------------------------------------------------------------
 SpCompositionProofMultisigProposal sp_composition_multisig_proposal(const std::vector<crypto::key_image> &KI,
@@ -566,15 +875,12 @@ SpCompositionProofMultisigPrep sp_composition_multisig_init()
     SpCompositionProofMultisigPrep prep;
 
     // alpha_{b,1,e}*U
-    // store with (1/8)
-    rct::key U{get_U_gen()};
-    generate_proof_nonce(U, prep.signature_nonce_1_KI_priv, prep.signature_nonce_1_KI_pub);
-    rct::scalarmultKey(prep.signature_nonce_1_KI_pub, prep.signature_nonce_1_KI_pub, rct::INV_EIGHT);
+    // store with (1/8): (1/8)*alpha*U is one fixed-base scalarmult of (alpha/8)
+    make_multisig_KI_nonce(prep.signature_nonce_1_KI_priv, prep.signature_nonce_1_KI_pub);
 
     // alpha_{b,2,e}*U
     // store with (1/8)
-    generate_proof_nonce(U, prep.signature_nonce_2_KI_priv, prep.signature_nonce_2_KI_pub);
-    rct::scalarmultKey(prep.signature_nonce_2_KI_pub, prep.signature_nonce_2_KI_pub, rct::INV_EIGHT);
+    make_multisig_KI_nonce(prep.signature_nonce_2_KI_priv, prep.signature_nonce_2_KI_pub);
 
     return prep;
 }
@@ -588,187 +894,120 @@ SpCompositionProofMultisigPartial sp_composition_multisig_partial_sig(const SpCo
     const crypto::secret_key &local_nonce_1_priv,
     const crypto::secret_key &local_nonce_2_priv)
 {
-    /// input checks and initialization
-    const std::size_t num_keys{proposal.K.size()};
-    const std::size_t num_signers{signer_nonces_pub_1.size()};
-
-    CHECK_AND_ASSERT_THROW_MES(num_keys > 0, "Not enough keys to make a proof!");
-    CHECK_AND_ASSERT_THROW_MES(num_keys == proposal.KI.size(), "Input key sets not the same size (K ?= KI)!");
-    CHECK_AND_ASSERT_THROW_MES(num_keys == proposal.signature_nonces_K_t1.size(), "Input key sets not the same size (K ?= KI)!");
-    CHECK_AND_ASSERT_THROW_MES(num_keys == x.size(), "Input key sets not the same size (K ?= x)!");
-    CHECK_AND_ASSERT_THROW_MES(num_keys == y.size(), "Input key sets not the same size (K ?= y)!");
-    CHECK_AND_ASSERT_THROW_MES(num_keys == z_e.size(), "Input key sets not the same size (K ?= z)!");
-
-    for (std::size_t i{0}; i < num_keys; ++i)
-    {
-        CHECK_AND_ASSERT_THROW_MES(!(proposal.K[i] == rct::identity()), "Bad proof key (K[i] identity)!");
-        CHECK_AND_ASSERT_THROW_MES(!(rct::ki2rct(proposal.KI[i]) == rct::identity()), "Bad proof key (KI[i] identity)!");
-
-        // x == 0 is allowed
-        CHECK_AND_ASSERT_THROW_MES(sc_check(&x[i]) == 0, "Bad private key (x[i])!");
-        CHECK_AND_ASSERT_THROW_MES(sc_isnonzero(&y[i]), "Bad private key (y[i] zero)!");
-        CHECK_AND_ASSERT_THROW_MES(sc_check(&y[i]) == 0, "Bad private key (y[i])!");
-        CHECK_AND_ASSERT_THROW_MES(sc_isnonzero(&z_e[i]), "Bad private key (z[i] zero)!");
-        CHECK_AND_ASSERT_THROW_MES(sc_check(&z_e[i]) == 0, "Bad private key (z[i])!");
-    }
-
-    CHECK_AND_ASSERT_THROW_MES(num_signers == signer_nonces_pub_2.size(), "Signer nonces mismatch!");
-
-    CHECK_AND_ASSERT_THROW_MES(sc_check(&local_nonce_1_priv) == 0, "Bad private key (local_nonce_1_priv)!");
-    CHECK_AND_ASSERT_THROW_MES(sc_isnonzero(&local_nonce_1_priv), "Bad private key (local_nonce_1_priv zero)!");
-    CHECK_AND_ASSERT_THROW_MES(sc_check(&local_nonce_2_priv) == 0, "Bad private key (local_nonce_2_priv)!");
-    CHECK_AND_ASSERT_THROW_MES(sc_isnonzero(&local_nonce_2_priv), "Bad private key (local_nonce_2_priv zero)!");
-
-    // prepare participant nonces
-    rct::keyV signer_nonces_pub_1_mul8;
-    rct::keyV signer_nonces_pub_2_mul8;
-    signer_nonces_pub_1_mul8.reserve(num_signers);
-    signer_nonces_pub_2_mul8.reserve(num_signers);
-
-    for (std::size_t e{0}; e < num_signers; ++e)
-    {
-        signer_nonces_pub_1_mul8.emplace_back(rct::scalarmult8(signer_nonces_pub_1[e]));
-        signer_nonces_pub_2_mul8.emplace_back(rct::scalarmult8(signer_nonces_pub_2[e]));
-        CHECK_AND_ASSERT_THROW_MES(!(signer_nonces_pub_1_mul8.back() == rct::identity()), "Bad signer nonce (alpha_1 identity)!");
-        CHECK_AND_ASSERT_THROW_MES(!(signer_nonces_pub_2_mul8.back() == rct::identity()), "Bad signer nonce (alpha_2 identity)!");
-    }
-
-    // sort participant nonces so binonce merge factor is deterministic
-    std::vector<std::size_t> signer_nonces_pub_original_indices;
-    signer_nonces_pub_original_indices.resize(num_signers);
-
-    for (std::size_t e{0}; e < num_signers; ++e)
-    {
-        signer_nonces_pub_original_indices[e] = e;
-    }
-
-    std::sort(signer_nonces_pub_original_indices.begin(), signer_nonces_pub_original_indices.end(),
-            [&signer_nonces_pub_1_mul8](const std::size_t &index_1, const std::size_t &index_2) -> bool
-            {
-                return memcmp(signer_nonces_pub_1_mul8[index_1].bytes, signer_nonces_pub_1_mul8[index_2].bytes,
-                    sizeof(rct::key)) < 0;
-            }
-        );
-
-    rct::keyV signer_nonces_pub_1_mul8_temp{std::move(signer_nonces_pub_1_mul8)};
-    rct::keyV signer_nonces_pub_2_mul8_temp{std::move(signer_nonces_pub_2_mul8)};
-    signer_nonces_pub_1_mul8.clear();
-    signer_nonces_pub_2_mul8.clear();
-    signer_nonces_pub_1_mul8.reserve(num_signers);
-    signer_nonces_pub_2_mul8.reserve(num_signers);
-
-    for (std::size_t e{0}; e < num_signers; ++e)
-    {
-        signer_nonces_pub_1_mul8.emplace_back(signer_nonces_pub_1_mul8_temp[signer_nonces_pub_original_indices[e]]);
-        signer_nonces_pub_2_mul8.emplace_back(signer_nonces_pub_2_mul8_temp[signer_nonces_pub_original_indices[e]]);
-    }
-
-    const rct::key U_gen{get_U_gen()};
-
-    // check that the local signer's signature opening is in the input set of opening nonces
-    bool found_local_nonce{false};
-    rct::key local_nonce_1_pub;
-    rct::key local_nonce_2_pub;
-    rct::scalarmultKey(local_nonce_1_pub, U_gen, rct::sk2rct(local_nonce_1_priv));
-    rct::scalarmultKey(local_nonce_2_pub, U_gen, rct::sk2rct(local_nonce_2_priv));
+    check_multisig_partial_sig_inputs(proposal,
+        x,
+        y,
+        z_e,
+        signer_nonces_pub_1,
+        signer_nonces_pub_2,
+        local_nonce_1_priv,
+        local_nonce_2_priv);
+
+    // 1/y_i (used for K_t1 and the responses)
+    rct::keyV y_inv{invert_y_keys(y)};
+    auto y_inv_wiper = epee::misc_utils::create_scope_leave_handler([&]{
+        memwipe(y_inv.data(), y_inv.size()*sizeof(rct::key));
+    });
 
-    for (std::size_t e{0}; e < num_signers; ++e)
+    return make_multisig_partial_sig(proposal,
+        x,
+        y_inv,
+        z_e,
+        signer_nonces_pub_1,
+        signer_nonces_pub_2,
+        local_nonce_1_priv,
+        local_nonce_2_priv);
+}
+//-------------------------------------------------------------------------------------------------------------------
+std::vector<SpCompositionProofMultisigPartial> sp_composition_multisig_partial_sig_batch(
+    const std::vector<const SpCompositionProofMultisigProposal*> &proposals,
+    const std::vector<std::vector<crypto::secret_key>> &x,
+    const std::vector<std::vector<crypto::secret_key>> &y,
+    const std::vector<std::vector<crypto::secret_key>> &z_e,
+    const std::vector<rct::keyV> &signer_nonces_pub_1,
+    const std::vector<rct::keyV> &signer_nonces_pub_2,
+    const std::vector<crypto::secret_key> &local_nonces_1_priv,
+    const std::vector<crypto::secret_key> &local_nonces_2_priv)
+{
+    /// input checks and initialization
+    const std::size_t num_proposals{proposals.size()};
+
+    CHECK_AND_ASSERT_THROW_MES(num_proposals == x.size(), "Batch input sets not the same size (proposals ?= x)!");
+    CHECK_AND_ASSERT_THROW_MES(num_proposals == y.size(), "Batch input sets not the same size (proposals ?= y)!");
+    CHECK_AND_ASSERT_THROW_MES(num_proposals == z_e.size(), "Batch input sets not the same size (proposals ?= z)!");
+    CHECK_AND_ASSERT_THROW_MES(num_proposals == signer_nonces_pub_1.size(),
+        "Batch input sets not the same size (proposals ?= signer nonces 1)!");
+    CHECK_AND_ASSERT_THROW_MES(num_proposals == signer_nonces_pub_2.size(),
+        "Batch input sets not the same size (proposals ?= signer nonces 2)!");
+    CHECK_AND_ASSERT_THROW_MES(num_proposals == local_nonces_1_priv.size(),
+        "Batch input sets not the same size (proposals ?= local nonces 1)!");
+    CHECK_AND_ASSERT_THROW_MES(num_proposals == local_nonces_2_priv.size(),
+        "Batch input sets not the same size (proposals ?= local nonces 2)!");
+
+    std::size_t num_keys_total{0};
+
+    for (std::size_t proposal_index{0}; proposal_index < num_proposals; ++proposal_index)
     {
-        if (local_nonce_1_pub == signer_nonces_pub_1_mul8[e] &&
-            local_nonce_2_pub == signer_nonces_pub_2_mul8[e])
-        {
-            found_local_nonce = true;
-            break;
-        }
+        CHECK_AND_ASSERT_THROW_MES(proposals[proposal_index], "Null proposal in batch!");
+
+        check_multisig_partial_sig_inputs(*proposals[proposal_index],
+            x[proposal_index],
+            y[proposal_index],
+            z_e[proposal_index],
+            signer_nonces_pub_1[proposal_index],
+            signer_nonces_pub_2[proposal_index],
+            local_nonces_1_priv[proposal_index],
+            local_nonces_2_priv[proposal_index]);
+
+        num_keys_total += y[proposal_index].size();
     }
-    CHECK_AND_ASSERT_THROW_MES(found_local_nonce, "Local signer's opening nonces not in input set!");
 
 
-    /// prepare partial signature
-    SpCompositionProofMultisigPartial partial_sig;
+    /// 1/y_i for every proposal (one field inversion for the whole batch)
+    rct::keyV y_inv_all;
+    rct::keyV y_inv;
+    auto y_inv_wiper = epee::misc_utils::create_scope_leave_handler([&]{
+        memwipe(y_inv_all.data(), y_inv_all.size()*sizeof(rct::key));
+        memwipe(y_inv.data(), y_inv.size()*sizeof(rct::key));
+    });
 
-    // make K_t1
-    partial_sig.K_t1.resize(num_keys);
+    y_inv_all.reserve(num_keys_total);
 
-    for (std::size_t i{0}; i < num_keys; ++i)
+    for (const std::vector<crypto::secret_key> &y_proposal : y)
     {
-        // K_t1_i = (1/8) * (1/y_i) * K_i
-        compute_K_t1_for_proof(y[i], proposal.K[i], partial_sig.K_t1[i]);
+        for (const crypto::secret_key &y_i : y_proposal)
+            y_inv_all.emplace_back(rct::sk2rct(y_i));
     }
 
-    // set partial sig pieces
-    partial_sig.KI = proposal.KI;
-    partial_sig.K = proposal.K;
-    partial_sig.message = proposal.message;
+    invert_batch(y_inv_all);
 
 
-    /// challenge message and aggregation coefficients
-    rct::key mu_a{compute_base_aggregation_coefficient_a(partial_sig.message, partial_sig.K_t1, partial_sig.KI)};
-    rct::keyV mu_a_pows{powers_of_scalar(mu_a, num_keys)};
-
-    rct::key mu_b{compute_base_aggregation_coefficient_b(mu_a)};
-    rct::keyV mu_b_pows{powers_of_scalar(mu_b, num_keys)};
-
-    rct::key m{compute_challenge_message(mu_b, partial_sig.K)};
-
-    rct::key binonce_merge_factor{multisig_binonce_merge_factor(m, signer_nonces_pub_1_mul8, signer_nonces_pub_2_mul8)};
-
-
-    /// signature openers
-
-    // alpha_a * G
-    rct::key alpha_a_pub;
-    rct::scalarmultKey(alpha_a_pub, rct::G, proposal.signature_nonce_K_t2);
-
-    // alpha_b * U
-    // - MuSig2-style merged nonces from all multisig participants
-
-    // alpha_b_1 = sum(alpha_b_1_e * U)
-    rct::key alpha_b_pub{rct::addKeys(signer_nonces_pub_1_mul8)};
-
-    // alpha_b_2 * U = rho * sum(alpha_b_2_e * U)
-    // rho = H(m, {alpha_b_1_e * U}, {alpha_b_2_e * U})
-    rct::key alpha_b_2_pub{rct::addKeys(signer_nonces_pub_2_mul8)};
-    rct::scalarmultKey(alpha_b_2_pub, alpha_b_2_pub, binonce_merge_factor);
-
-    // alpha_b * U = alpha_b_1 + alpha_b_2
-    rct::addKeys(alpha_b_pub, alpha_b_pub, alpha_b_2_pub);
+    /// partial signatures
+    std::vector<SpCompositionProofMultisigPartial> partial_sigs;
+    partial_sigs.reserve(num_proposals);
+    std::size_t y_inv_offset{0};
 
-    // alpha_i[i] * K_i
-    rct::keyV alpha_i_pub;
-    alpha_i_pub.resize(num_keys);
-
-    for (std::size_t i{0}; i < num_keys; ++i)
+    for (std::size_t proposal_index{0}; proposal_index < num_proposals; ++proposal_index)
     {
-        rct::scalarmultKey(alpha_i_pub[i], partial_sig.K[i], proposal.signature_nonces_K_t1[i]);
+        const std::size_t num_keys{y[proposal_index].size()};
+        y_inv.assign(y_inv_all.begin() + y_inv_offset, y_inv_all.begin() + y_inv_offset + num_keys);
+        y_inv_offset += num_keys;
+
+        partial_sigs.emplace_back(
+                make_multisig_partial_sig(*proposals[proposal_index],
+                    x[proposal_index],
+                    y_inv,
+                    z_e[proposal_index],
+                    signer_nonces_pub_1[proposal_index],
+                    signer_nonces_pub_2[proposal_index],
+                    local_nonces_1_priv[proposal_index],
+                    local_nonces_2_priv[proposal_index])
+            );
+
+        memwipe(y_inv.data(), y_inv.size()*sizeof(rct::key));
     }
 
-
-    /// compute proof challenge
-    partial_sig.c = compute_challenge(m, alpha_a_pub, alpha_b_pub, alpha_i_pub);
-
-
-    /// responses
-    crypto::secret_key merged_nonce_KI_priv;  // alpha_1_local + rho * alpha_2_local
-    sc_muladd(&merged_nonce_KI_priv, &local_nonce_2_priv, binonce_merge_factor.bytes, &local_nonce_1_priv);
-
-    compute_responses(x,
-            y,
-            z_e,  // for partial signature
-            mu_a_pows,
-            mu_b_pows,
-            proposal.signature_nonce_K_t2,
-            rct::sk2rct(merged_nonce_KI_priv),  // for partial signature
-            proposal.signature_nonces_K_t1,
-            partial_sig.c,
-            partial_sig.r_a,
-            partial_sig.r_b_partial,  // partial response
-            partial_sig.r_i
-        );
-
-
-    /// done
-    return partial_sig;
+    return partial_sigs;
 }
 //-------------------------------------------------------------------------------------------------------------------
 SpCompositionProof sp_composition_prove_multisig_final(const std::vector<SpCompositionProofMultisigPartial> &partial_sigs)
@@ -784,9 +1023,11 @@ SpCompositionProof sp_composition_prove_multisig_final(const std::vector<SpCompo
         CHECK_AND_ASSERT_THROW_MES(num_keys == partial_sigs[sig_index].K.size(), "Input key sets not the same size!");
         CHECK_AND_ASSERT_THROW_MES(num_keys == partial_sigs[sig_index].KI.size(), "Input key sets not the same size!");
         CHECK_AND_ASSERT_THROW_MES(num_keys == partial_sigs[sig_index].K_t1.size(), "Input key sets not the same size!");
+        CHECK_AND_ASSERT_THROW_MES(num_keys == partial_sigs[sig_index].A_K_t1.size(), "Input key sets not the same size!");
         CHECK_AND_ASSERT_THROW_MES(num_keys == partial_sigs[sig_index].r_i.size(), "Input key sets not the same size!");
 
-        CHECK_AND_ASSERT_THROW_MES(partial_sigs[0].c == partial_sigs[sig_index].c, "Input key sets don't match!");
+        CHECK_AND_ASSERT_THROW_MES(partial_sigs[0].A_K_t2 == partial_sigs[sig_index].A_K_t2, "Input key sets don't match!");
+        CHECK_AND_ASSERT_THROW_MES(partial_sigs[0].A_KI == partial_sigs[sig_index].A_KI, "Input key sets don't match!");
         CHECK_AND_ASSERT_THROW_MES(partial_sigs[0].r_a == partial_sigs[sig_index].r_a, "Input key sets don't match!");
         CHECK_AND_ASSERT_THROW_MES(partial_sigs[0].message == partial_sigs[sig_index].message, "Input key sets don't match!");
 
@@ -795,6 +1036,8 @@ SpCompositionProof sp_composition_prove_multisig_final(const std::vector<SpCompo
             CHECK_AND_ASSERT_THROW_MES(partial_sigs[0].K[i] == partial_sigs[sig_index].K[i], "Input key sets don't match!");
             CHECK_AND_ASSERT_THROW_MES(partial_sigs[0].KI[i] == partial_sigs[sig_index].KI[i], "Input key sets don't match!");
             CHECK_AND_ASSERT_THROW_MES(partial_sigs[0].K_t1[i] == partial_sigs[sig_index].K_t1[i], "Input key sets don't match!");
+            CHECK_AND_ASSERT_THROW_MES(partial_sigs[0].A_K_t1[i] == partial_sigs[sig_index].A_K_t1[i],
+                "Input key sets don't match!");
             CHECK_AND_ASSERT_THROW_MES(partial_sigs[0].r_i[i] == partial_sigs[sig_index].r_i[i], "Input key sets don't match!");
         }
     }
@@ -803,7 +1046,9 @@ SpCompositionProof sp_composition_prove_multisig_final(const std::vector<SpCompo
     /// assemble the final proof
     SpCompositionProof proof;
 
-    proof.c = partial_sigs[0].c;
+    proof.A_K_t2 = partial_sigs[0].A_K_t2;
+    proof.A_KI = partial_sigs[0].A_KI;
+    proof.A_K_t1 = partial_sigs[0].A_K_t1;
     proof.r_a = partial_sigs[0].r_a;
 
     proof.r_b = rct::zero();
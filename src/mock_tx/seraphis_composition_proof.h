@@ -38,7 +38,8 @@
 // note: uses 'concise' technique for smaller proofs, with the powers-of-aggregation coefficient approach from Triptych
 // note2: G_0 = G, G_1 = X, G_2 = U (for Seraphis paper notation)
 // note3: in practice, K_i are masked addresses from Seraphis e-note-images, and KI_i are the corresponding linking tags
-// note4: assume key images KI are in the prime subgroup (canonical bytes) and non-identity
+// note4: the proof stores its commitments (instead of the challenge), so proofs can be batch-verified in one multiexp
+// note5: assume key images KI are in the prime subgroup (canonical bytes) and non-identity
 //   - WARNING: the caller must validate KI (and check non-identity); either...
 //     - 1) l*KI == identity
 //     - 2) store (1/8)*KI with proof material (e.g. in a transaction); pass 8*[(1/8)*KI] as input to composition proof
@@ -69,6 +70,8 @@
 //local headers
 #include "crypto/crypto.h"
 #include "ringct/rctTypes.h"
+#include "serialization/containers.h"
+#include "serialization/serialization.h"
 
 //third party headers
 
@@ -76,6 +79,7 @@
 #include <vector>
 
 //forward declarations
+namespace rct { struct pippenger_prep_data; }
 
 
 namespace sp
@@ -90,8 +94,9 @@ namespace sp
 ///
 struct SpCompositionProof
 {
-    // challenge
-    rct::key c;
+    // commitments (stored as (1/8)*commitment): alpha_a*G, alpha_b*U, {alpha_i*K_i}
+    rct::key A_K_t2, A_KI;
+    rct::keyV A_K_t1;
     // condensed responses
     rct::key r_a, r_b;
     // un-condensible responses
@@ -101,6 +106,16 @@ struct SpCompositionProof
     // key images KI: not stored with proof
     // main proof keys K: not stored with proof
     // message m: not stored with proof
+
+    BEGIN_SERIALIZE_OBJECT()
+        FIELD(A_K_t2)
+        FIELD(A_KI)
+        FIELD(A_K_t1)
+        FIELD(r_a)
+        FIELD(r_b)
+        FIELD(r_i)
+        FIELD(K_t1)
+    END_SERIALIZE()
 };
 
 ////
@@ -153,8 +168,9 @@ struct SpCompositionProofMultisigPrep
 ///
 struct SpCompositionProofMultisigPartial
 {
-    // challenge
-    rct::key c;
+    // commitments (stored as (1/8)*commitment)
+    rct::key A_K_t2, A_KI;
+    rct::keyV A_K_t1;
     // condensed response r_a
     rct::key r_a;
     // un-condensible responses
@@ -202,6 +218,20 @@ bool sp_composition_verify(const SpCompositionProof &proof,
     const rct::keyV &K,
     const std::vector<crypto::key_image> &KI,
     const rct::key &message);
+/**
+* brief: get_sp_composition_verification_data - get verification data for a batch of Seraphis composition proofs
+*   - each proof's equations are weighted randomly, so the data can be merged with other pippenger data sets and
+*     checked with one multiexp (see check_pippenger_data())
+* param: proofs - batch of proofs to verify
+* param: K - (per-proof) main proof keys
+* param: KI - (per-proof) proof key images
+* param: messages - (per-proof) message to insert in Fiat-Shamir transform hash
+* return: multiexp data that sums to the identity if all proofs are valid
+*/
+rct::pippenger_prep_data get_sp_composition_verification_data(const std::vector<const SpCompositionProof*> &proofs,
+    const std::vector<rct::keyV> &K,
+    const std::vector<std::vector<crypto::key_image>> &KI,
+    const rct::keyV &messages);
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////
 /////////////////////////////////////////////// Multisig ///////////////////////////////////////////////////
@@ -248,6 +278,31 @@ SpCompositionProofMultisigPartial sp_composition_multisig_partial_sig(const SpCo
     const crypto::secret_key &local_nonce_1_priv,
     const crypto::secret_key &local_nonce_2_priv);
 /**
+* brief: sp_composition_multisig_partial_sig_batch - make local multisig signer's partial signatures for a batch of
+*        Seraphis composition proofs
+*   - same as calling sp_composition_multisig_partial_sig() on each proposal, but the 'y' keys of all proposals are
+*     inverted together (one field inversion for the batch)
+*   - caller must validate the proposals (see sp_composition_multisig_partial_sig())
+* param: proposals - proof proposals to construct proof partial signatures from
+* param: x - (per-proposal) secret keys (x_i)
+* param: y - (per-proposal) secret keys (y_i)
+* param: z_e - (per-proposal) secret keys of multisig signer (z_{e,i})
+* param: signer_nonces_pub_1 - (per-proposal) signature nonce pubkeys alpha_{b,1,e}*U from all signers
+* param: signer_nonces_pub_2 - (per-proposal) signature nonce pubkeys alpha_{b,2,e}*U from all signers
+* param: local_nonces_1_priv - (per-proposal) alpha_{b,1,e} for local signer
+* param: local_nonces_2_priv - (per-proposal) alpha_{b,2,e} for local signer
+* return: partially signed Seraphis composition proofs (one per proposal)
+*/
+std::vector<SpCompositionProofMultisigPartial> sp_composition_multisig_partial_sig_batch(
+    const std::vector<const SpCompositionProofMultisigProposal*> &proposals,
+    const std::vector<std::vector<crypto::secret_key>> &x,
+    const std::vector<std::vector<crypto::secret_key>> &y,
+    const std::vector<std::vector<crypto::secret_key>> &z_e,
+    const std::vector<rct::keyV> &signer_nonces_pub_1,
+    const std::vector<rct::keyV> &signer_nonces_pub_2,
+    const std::vector<crypto::secret_key> &local_nonces_1_priv,
+    const std::vector<crypto::secret_key> &local_nonces_2_priv);
+/**
 * brief: sp_composition_prove_multisig_final - create a Seraphis composition proof from multisig partial signatures
 * param: partial_sigs - partial signatures from enough multisig participants to complete a full proof
 * return: Seraphis composition proof
@@ -32,6 +32,7 @@
 #include "seraphis_crypto_utils.h"
 
 //local headers
+#include "common/threadpool.h"
 #include "common/varint.h"
 #include "crypto/crypto.h"
 extern "C"
@@ -41,11 +42,11 @@ extern "C"
 #include "cryptonote_config.h"
 #include "grootle.h"
 #include "misc_log_ex.h"
+#include "mock_tx_phase_timers.h"
 #include "mock_tx_utils.h"
 #include "ringct/multiexp.h"
 #include "ringct/rctOps.h"
 #include "ringct/rctTypes.h"
-#include "wipeable_string.h"
 
 //third party headers
 #include <boost/lexical_cast.hpp>
@@ -53,6 +54,7 @@ extern "C"
 #include <boost/thread/mutex.hpp>
 
 //standard headers
+#include <algorithm>
 #include <array>
 #include <cmath>
 #include <vector>
@@ -75,6 +77,11 @@ static ge_p3 X_p3;
 static rct::key U;
 static rct::key X;
 
+// fixed-base tables: table[i][j] = (j+1) * 256^i * gen (same layout as ge_base for G)
+static ge_precomp H_table[32][8];
+static ge_precomp U_table[32][8];
+static ge_precomp X_table[32][8];
+
 // Useful scalar and group constants
 static const rct::key ZERO = rct::zero();
 static const rct::key ONE = rct::identity();
@@ -123,9 +130,26 @@ static void init_sp_gens()
     // Build G
     ge_frombytes_vartime(&G_p3, rct::G.bytes);
 
+    // Build fixed-base tables (G already has ge_base)
+    ge_precomp_table_init(H_table, &H_p3);
+    ge_precomp_table_init(U_table, &U_p3);
+    ge_precomp_table_init(X_table, &X_p3);
+
     init_done = true;
 }
 //-------------------------------------------------------------------------------------------------------------------
+// scalar * gen with a fixed-base table (constant time)
+//-------------------------------------------------------------------------------------------------------------------
+static void scalarmult_table(const ge_precomp table[32][8], const rct::key &scalar, rct::key &result_out)
+{
+    rct::key scalar_reduced;
+    ge_p3 result_p3;
+
+    sc_reduce32copy(scalar_reduced.bytes, scalar.bytes);  //ge_scalarmult_base_table() requires a[31] <= 127
+    ge_scalarmult_base_table(&result_p3, scalar_reduced.bytes, table);
+    ge_p3_tobytes(result_out.bytes, &result_p3);
+}
+//-------------------------------------------------------------------------------------------------------------------
 ge_p3 get_G_p3_gen()
 {
     init_sp_gens();
@@ -168,6 +192,27 @@ rct::key get_X_gen()
     return X;
 }
 //-------------------------------------------------------------------------------------------------------------------
+void scalarmult_H(const rct::key &scalar, rct::key &result_out)
+{
+    init_sp_gens();
+
+    scalarmult_table(H_table, scalar, result_out);
+}
+//-------------------------------------------------------------------------------------------------------------------
+void scalarmult_U(const rct::key &scalar, rct::key &result_out)
+{
+    init_sp_gens();
+
+    scalarmult_table(U_table, scalar, result_out);
+}
+//-------------------------------------------------------------------------------------------------------------------
+void scalarmult_X(const rct::key &scalar, rct::key &result_out)
+{
+    init_sp_gens();
+
+    scalarmult_table(X_table, scalar, result_out);
+}
+//-------------------------------------------------------------------------------------------------------------------
 rct::key invert(const rct::key &x)
 {
     CHECK_AND_ASSERT_THROW_MES(!(x == ZERO), "Cannot invert zero!");
@@ -223,6 +268,41 @@ rct::key invert(const rct::key &x)
     return inv;
 }
 //-------------------------------------------------------------------------------------------------------------------
+void invert_batch(rct::keyV &x_inout)
+{
+    if (x_inout.size() == 0)
+        return;
+
+    // prefix products: prefix[i] = x[0]*...*x[i - 1]
+    rct::keyV prefix;
+    prefix.resize(x_inout.size());
+
+    rct::key acc{ONE};
+    for (std::size_t i{0}; i < x_inout.size(); ++i)
+    {
+        CHECK_AND_ASSERT_THROW_MES(!(x_inout[i] == ZERO), "Cannot invert zero!");
+        prefix[i] = acc;
+        sc_mul(acc.bytes, acc.bytes, x_inout[i].bytes);
+    }
+
+    // one inversion: acc = 1/(x[0]*...*x[n - 1])
+    acc = invert(acc);
+
+    // walk back: 1/x[i] = acc*prefix[i], then strip x[i] from acc
+    rct::key temp;
+    for (std::size_t i{x_inout.size()}; i-- > 0;)
+    {
+        sc_mul(temp.bytes, acc.bytes, x_inout[i].bytes);
+        sc_mul(x_inout[i].bytes, acc.bytes, prefix[i].bytes);
+        acc = temp;
+    }
+
+    // the inputs may be secret (e.g. private keys)
+    memwipe(prefix.data(), prefix.size()*sizeof(rct::key));
+    memwipe(&acc, sizeof(rct::key));
+    memwipe(&temp, sizeof(rct::key));
+}
+//-------------------------------------------------------------------------------------------------------------------
 void decompose(const std::size_t val, const std::size_t base, const std::size_t size, std::vector<std::size_t> &r_out)
 {
     CHECK_AND_ASSERT_THROW_MES(base > 1, "Bad decomposition parameters!");
@@ -252,41 +332,252 @@ rct::keyV convolve(const rct::keyV &x, const rct::keyV &y, const std::size_t m)
     CHECK_AND_ASSERT_THROW_MES(x.size() >= m, "Bad convolution parameters!");
     CHECK_AND_ASSERT_THROW_MES(y.size() == 2, "Bad convolution parameters!");
 
-    rct::key temp;
     rct::keyV result;
     result.resize(m + 1, ZERO);
 
-    for (std::size_t i = 0; i < m; ++i)
+    if (m == 0)
+        return result;
+
+    // result[i] = a*x_i (+ b*x_{i-1}): the a terms first, then the b terms on top of them
+    mul_scalars(y[0], x.data(), m, result.data());
+    muladd_scalars(y[1], x.data(), result.data() + 1, m - 1, result.data() + 1);
+    sc_mul(result[m].bytes, y[1].bytes, x[m - 1].bytes);
+
+    return result;
+}
+//-------------------------------------------------------------------------------------------------------------------
+void one_of_many_coefficients(const rct::keyM &a,
+    const std::vector<std::size_t> &decomp_l,
+    const std::size_t n,
+    const std::size_t m,
+    rct::keyM &p_out)
+{
+    CHECK_AND_ASSERT_THROW_MES(n > 1, "Bad one-of-many coefficient parameters!");
+    CHECK_AND_ASSERT_THROW_MES(m > 0, "Bad one-of-many coefficient parameters!");
+    CHECK_AND_ASSERT_THROW_MES(a.size() == m, "Bad one-of-many coefficient parameters!");
+    CHECK_AND_ASSERT_THROW_MES(decomp_l.size() == m, "Bad one-of-many coefficient parameters!");
+    for (const rct::keyV &a_row : a)
+        CHECK_AND_ASSERT_THROW_MES(a_row.size() == n, "Bad one-of-many coefficient parameters!");
+
+    std::size_t N{1};
+    for (std::size_t j = 0; j < m; ++j)
+        N *= n;
+
+    p_out = rct::keyMInit(m + 1, N);
+
+    // partial[t]: product of the factors for digits m-1, ..., m-t of the current k (degree t)
+    // - when k is incremented and its highest changed digit is 'c', only partial[m-c], ..., partial[m] are stale
+    rct::keyM partial = rct::keyMInit(m + 1, m + 1);
+    partial[0][0] = ONE;
+    std::vector<std::size_t> decomp_k(m, 0);
+    std::size_t first_stale{1};
+    rct::key delta_temp;
+
+    for (std::size_t k = 0; k < N; ++k)
     {
-        for (std::size_t j = 0; j < 2; ++j)
+        for (std::size_t t = first_stale; t <= m; ++t)
         {
-            sc_mul(temp.bytes, x[i].bytes, y[j].bytes);
-            sc_add(result[i + j].bytes, result[i + j].bytes, temp.bytes);
+            // partial[t] = partial[t-1] * (a[j][decomp_k[j]] + delta(decomp_l[j], decomp_k[j])*x), with j = m - t
+            const std::size_t j{m - t};
+            const rct::key &a_temp = a[j][decomp_k[j]];
+            const rct::keyV &prev = partial[t - 1];
+            rct::keyV &next = partial[t];
+            delta_temp = kronecker_delta(decomp_l[j], decomp_k[j]);
+
+            sc_mul(next[t].bytes, prev[t - 1].bytes, delta_temp.bytes);
+            for (std::size_t i = t - 1; i > 0; --i)
+            {
+                sc_mul(next[i].bytes, prev[i].bytes, a_temp.bytes);
+                sc_muladd(next[i].bytes, prev[i - 1].bytes, delta_temp.bytes, next[i].bytes);
+            }
+            sc_mul(next[0].bytes, prev[0].bytes, a_temp.bytes);
         }
+
+        p_out[k] = partial[m];
+
+        // increment k's decomposition; the digits below the highest changed one roll over to zero
+        std::size_t c{0};
+        while (c < m && ++decomp_k[c] == n)
+        {
+            decomp_k[c] = 0;
+            ++c;
+        }
+        first_stale = c < m ? m - c : 1;
+    }
+}
+//-------------------------------------------------------------------------------------------------------------------
+// t_k for the k in blocks [block_begin, block_end) of n consecutive k (see one_of_many_f_products())
+//-------------------------------------------------------------------------------------------------------------------
+static void one_of_many_f_products_blocks(const rct::KeyMatrix &f,
+    const std::size_t n,
+    const std::size_t m,
+    const std::size_t block_begin,
+    const std::size_t block_end,
+    rct::keyV &prefix_scratch,
+    rct::key *t_out)
+{
+    // prefix_scratch[t]: product of f[j][decomp_k[j]] for digits j = m-1, ..., m-t of the current k
+    // - only the prefixes below k's highest changed digit are stale after an increment (~n/(n-1) on average), so this
+    //   costs under 2N scalar muls instead of N*m
+    // - the k in a block of n share every digit but the lowest, so each block's t_k are one row of independent muls
+    //   (prefix_scratch[m-1] * f[0][i], done four at a time)
+    prefix_scratch.resize(m + 1);
+    prefix_scratch[0] = ONE;
+    std::vector<std::size_t> decomp_k(m, 0);
+    std::size_t first_stale{1};
+
+    // digits above the lowest one of the first k (all prefixes start stale)
+    std::size_t block_digits{block_begin};
+    for (std::size_t j = 1; j < m; ++j)
+    {
+        decomp_k[j] = block_digits % n;
+        block_digits /= n;
     }
 
-    return result;
+    for (std::size_t block = block_begin; block < block_end; ++block)
+    {
+        for (std::size_t t = first_stale; t < m; ++t)
+        {
+            const std::size_t j{m - t};
+            sc_mul(prefix_scratch[t].bytes, prefix_scratch[t - 1].bytes, f[j][decomp_k[j]].bytes);
+        }
+
+        mul_scalars(prefix_scratch[m - 1], f[0].data(), n, t_out + block*n);
+
+        // increment the digits above the lowest one
+        std::size_t c{1};
+        while (c < m && ++decomp_k[c] == n)
+        {
+            decomp_k[c] = 0;
+            ++c;
+        }
+        first_stale = c < m ? m - c : 1;
+    }
 }
 //-------------------------------------------------------------------------------------------------------------------
-rct::keyV powers_of_scalar(const rct::key &scalar, const std::size_t num_pows, const bool negate_all)
+static std::size_t one_of_many_f_products_size(const rct::KeyMatrix &f, const std::size_t n, const std::size_t m)
 {
-    if (num_pows == 0)
-        return rct::keyV{};
+    CHECK_AND_ASSERT_THROW_MES(n > 1, "Bad one-of-many f-product parameters!");
+    CHECK_AND_ASSERT_THROW_MES(m > 0, "Bad one-of-many f-product parameters!");
+    CHECK_AND_ASSERT_THROW_MES(f.rows() == m, "Bad one-of-many f-product parameters!");
+    CHECK_AND_ASSERT_THROW_MES(f.cols() == n, "Bad one-of-many f-product parameters!");
+
+    std::size_t N{1};
+    for (std::size_t j = 0; j < m; ++j)
+        N *= n;
+
+    return N;
+}
+//-------------------------------------------------------------------------------------------------------------------
+void one_of_many_f_products(const rct::KeyMatrix &f,
+    const std::size_t n,
+    const std::size_t m,
+    rct::keyV &prefix_scratch,
+    rct::keyV &t_out)
+{
+    const std::size_t N{one_of_many_f_products_size(f, n, m)};
+
+    t_out.resize(N);
+    one_of_many_f_products_blocks(f, n, m, 0, N/n, prefix_scratch, t_out.data());
+}
+//-------------------------------------------------------------------------------------------------------------------
+void one_of_many_f_products_mt(const rct::KeyMatrix &f,
+    const std::size_t n,
+    const std::size_t m,
+    const std::size_t num_threads,
+    rct::keyV &t_out)
+{
+    const std::size_t N{one_of_many_f_products_size(f, n, m)};
+    const std::size_t num_blocks{N/n};
+
+    t_out.resize(N);
+
+    // each chunk of blocks rebuilds its first prefixes (m - 1 extra muls per chunk)
+    const std::size_t grain{num_threads == 0 ? 0 : (num_blocks + num_threads - 1)/num_threads};
+    CHECK_AND_ASSERT_THROW_MES(tools::parallel_for(0, num_blocks, grain,
+            [&f, n, m, &t_out](const std::size_t block_begin, const std::size_t block_end)
+            {
+                rct::keyV prefix_scratch;
+                one_of_many_f_products_blocks(f, n, m, block_begin, block_end, prefix_scratch, t_out.data());
+            }
+        ), "one-of-many f-products: a chunk failed.");
+}
+//-------------------------------------------------------------------------------------------------------------------
+void mul_scalars(const rct::key &scalar, const rct::key *scalars, const std::size_t num_scalars, rct::key *result_out)
+{
+    muladd_scalars(scalar, scalars, nullptr, num_scalars, result_out);
+}
+//-------------------------------------------------------------------------------------------------------------------
+void muladd_scalars(const rct::key &scalar,
+    const rct::key *scalars,
+    const rct::key *addends,
+    const std::size_t num_scalars,
+    rct::key *result_out)
+{
+    const unsigned char *lanes_a[4]{scalar.bytes, scalar.bytes, scalar.bytes, scalar.bytes};
+    const unsigned char *lanes_b[4];
+    const unsigned char *lanes_c[4];
+    unsigned char *lanes_out[4];
+    std::size_t i{0};
+
+    for (; i + 4 <= num_scalars; i += 4)
+    {
+        for (std::size_t lane{0}; lane < 4; ++lane)
+        {
+            lanes_b[lane] = scalars[i + lane].bytes;
+            lanes_c[lane] = addends ? addends[i + lane].bytes : nullptr;
+            lanes_out[lane] = result_out[i + lane].bytes;
+        }
+
+        sc_muladd_x4(lanes_out, lanes_a, lanes_b, addends ? lanes_c : nullptr, 1);
+    }
 
+    for (; i < num_scalars; ++i)
+    {
+        if (addends)
+            sc_muladd(result_out[i].bytes, scalar.bytes, scalars[i].bytes, addends[i].bytes);
+        else
+            sc_mul(result_out[i].bytes, scalar.bytes, scalars[i].bytes);
+    }
+}
+//-------------------------------------------------------------------------------------------------------------------
+rct::keyV powers_of_scalar(const rct::key &scalar, const std::size_t num_pows, const bool negate_all)
+{
     rct::keyV pows;
-    pows.resize(num_pows);
+    powers_of_scalar(scalar, num_pows, negate_all, pows);
+
+    return pows;
+}
+//-------------------------------------------------------------------------------------------------------------------
+void powers_of_scalar(const rct::key &scalar, const std::size_t num_pows, const bool negate_all, rct::keyV &pows_out)
+{
+    pows_out.resize(num_pows);
+
+    if (num_pows == 0)
+        return;
 
     if (negate_all)
-        pows[0] = MINUS_ONE;
+        pows_out[0] = MINUS_ONE;
     else
-        pows[0] = ONE;
+        pows_out[0] = ONE;
 
-    for (std::size_t i = 1; i < num_pows; ++i)
+    // the first four powers in sequence, then four independent chains: pows[i..i+3] = scalar^4 * pows[i-4..i-1]
+    for (std::size_t i = 1; i < std::min<std::size_t>(num_pows, 4); ++i)
     {
-        sc_mul(pows[i].bytes, pows[i - 1].bytes, scalar.bytes);
+        sc_mul(pows_out[i].bytes, pows_out[i - 1].bytes, scalar.bytes);
     }
 
-    return pows;
+    if (num_pows <= 4)
+        return;
+
+    rct::key scalar_pow4;
+    sc_mul(scalar_pow4.bytes, scalar.bytes, scalar.bytes);
+    sc_mul(scalar_pow4.bytes, scalar_pow4.bytes, scalar_pow4.bytes);
+
+    for (std::size_t i = 4; i < num_pows; i += 4)
+    {
+        mul_scalars(scalar_pow4, pows_out.data() + i - 4, std::min<std::size_t>(num_pows - i, 4), pows_out.data() + i);
+    }
 }
 //-------------------------------------------------------------------------------------------------------------------
 // WARNING: NOT FOR USE WITH CRYPTOGRAPHIC SECRETS
@@ -312,6 +603,18 @@ rct::key small_scalar_gen(const std::size_t size_bytes)
     return result;
 }
 //-------------------------------------------------------------------------------------------------------------------
+// WARNING: NOT FOR USE WITH CRYPTOGRAPHIC SECRETS
+//-------------------------------------------------------------------------------------------------------------------
+rct::key minus_small_scalar_gen(const std::size_t size_bytes)
+{
+    CHECK_AND_ASSERT_THROW_MES(size_bytes > 0, "Small scalar must have at least one byte!");
+
+    rct::key result{small_scalar_gen(size_bytes)};
+    sc_sub(result.bytes, rct::zero().bytes, result.bytes);
+
+    return result;
+}
+//-------------------------------------------------------------------------------------------------------------------
 void generate_proof_nonce(const rct::key &base, rct::key &nonce_out, rct::key &nonce_pub_out)
 {
     crypto::secret_key temp;
@@ -462,6 +765,11 @@ void multi_exp_vartime(const rct::keyV &privkeys, const std::vector<ge_p3> &pubk
 }
 //-------------------------------------------------------------------------------------------------------------------
 void multi_exp_vartime_p3(const rct::keyV &privkeys, const rct::keyV &pubkeys, ge_p3 &result_out)
+{
+    multi_exp_vartime_p3(privkeys, epee::to_span(pubkeys), result_out);
+}
+//-------------------------------------------------------------------------------------------------------------------
+void multi_exp_vartime_p3(const rct::keyV &privkeys, const epee::span<const rct::key> pubkeys, ge_p3 &result_out)
 {
     std::vector<ge_p3> pubkeys_p3;
     pubkeys_p3.resize(pubkeys.size());
@@ -654,6 +962,96 @@ void multi_exp_vartime_p3(const rct::keyV &privkeys, const std::vector<ge_p3> &p
     }
 }
 //-------------------------------------------------------------------------------------------------------------------
+template <std::size_t N>
+ge_p3 multi_exp_fixed(const rct::MultiexpData *data)
+{
+    static_assert(N > 0 && N <= MULTI_EXP_FIXED_MAX, "Fixed multiexp size is out of range!");
+
+    // recode the scalars (width-5 w-NAF) and precompute each point's odd multiples {1, 3, ..., 15}*P
+    signed char scalar_slides[N][256];
+    ge_dsmp precomps[N];
+    int max_i{-1};
+
+    for (std::size_t element_index{0}; element_index < N; ++element_index)
+    {
+        slide(scalar_slides[element_index], data[element_index].scalar.bytes);
+        ge_dsm_precomp(precomps[element_index], &data[element_index].point);
+
+        for (int i = 255; i > max_i; --i)
+        {
+            if (scalar_slides[element_index][i])
+            {
+                max_i = i;
+                break;
+            }
+        }
+    }
+
+    // all scalars are zero mod l
+    if (max_i < 0)
+        return ge_p3_identity;
+
+    // one doubling chain, adding every element's digit at each position
+    ge_p2 r;
+    ge_p1p1 t;
+    ge_p3 u;
+    ge_p2_0(&r);
+
+    for (int i = max_i; i >= 0; --i)
+    {
+        ge_p2_dbl(&t, &r);
+
+        for (std::size_t element_index{0}; element_index < N; ++element_index)
+        {
+            const signed char digit{scalar_slides[element_index][i]};
+
+            if (digit > 0)
+            {
+                ge_p1p1_to_p3(&u, &t);
+                ge_add(&t, &u, &precomps[element_index][digit/2]);
+            }
+            else if (digit < 0)
+            {
+                ge_p1p1_to_p3(&u, &t);
+                ge_sub(&t, &u, &precomps[element_index][(-digit)/2]);
+            }
+        }
+
+        ge_p1p1_to_p2(&r, &t);
+    }
+
+    ge_p1p1_to_p3(&u, &t);
+    return u;
+}
+//-------------------------------------------------------------------------------------------------------------------
+bool try_multi_exp_fixed(const epee::span<const rct::MultiexpData> data, ge_p3 &result_out)
+{
+    static_assert(MULTI_EXP_FIXED_MAX == 16, "Fixed multiexp dispatch must cover every size up to the max!");
+
+    switch (data.size())
+    {
+#define MULTI_EXP_FIXED_CASE(N) case N: result_out = multi_exp_fixed<N>(data.data()); return true;
+        MULTI_EXP_FIXED_CASE(1)
+        MULTI_EXP_FIXED_CASE(2)
+        MULTI_EXP_FIXED_CASE(3)
+        MULTI_EXP_FIXED_CASE(4)
+        MULTI_EXP_FIXED_CASE(5)
+        MULTI_EXP_FIXED_CASE(6)
+        MULTI_EXP_FIXED_CASE(7)
+        MULTI_EXP_FIXED_CASE(8)
+        MULTI_EXP_FIXED_CASE(9)
+        MULTI_EXP_FIXED_CASE(10)
+        MULTI_EXP_FIXED_CASE(11)
+        MULTI_EXP_FIXED_CASE(12)
+        MULTI_EXP_FIXED_CASE(13)
+        MULTI_EXP_FIXED_CASE(14)
+        MULTI_EXP_FIXED_CASE(15)
+        MULTI_EXP_FIXED_CASE(16)
+#undef MULTI_EXP_FIXED_CASE
+        default: return false;
+    }
+}
+//-------------------------------------------------------------------------------------------------------------------
 void sub_keys_p3(const rct::key &A, const rct::key &B, ge_p3 &result_out)
 {
     ge_p3 B_p3;
@@ -694,53 +1092,92 @@ void mask_key(const crypto::secret_key &mask, const rct::key &key, rct::key &mas
     rct::addKeys1(masked_key_out, rct::sk2rct(mask), key);
 }
 //-------------------------------------------------------------------------------------------------------------------
+SpDomainHasher::SpDomainHasher(const std::string &domain_separator)
+{
+    keccak_init(&m_ctx);
+    keccak_update(&m_ctx, reinterpret_cast<const uint8_t*>(domain_separator.data()), domain_separator.size());
+}
+//-------------------------------------------------------------------------------------------------------------------
+void SpDomainHasher::hash_to_scalar(const void *data, const std::size_t size, unsigned char *scalar_out) const
+{
+    // resume from the domain separator's state (the copy may hold secret data, so wipe it)
+    KECCAK_CTX ctx{m_ctx};
+    keccak_update(&ctx, static_cast<const uint8_t*>(data), size);
+    keccak_finish(&ctx, scalar_out);
+    memwipe(&ctx, sizeof(ctx));
+
+    sc_reduce32(scalar_out);
+}
+//-------------------------------------------------------------------------------------------------------------------
 void domain_separate_rct_hash(const std::string &domain_separator,
     const rct::key &rct_key,
     crypto::secret_key &hash_result_out)
 {
     // H("domain-sep", rct_key)
-    domain_separate_rct_hash_with_extra(domain_separator, rct_key, rct::zero(), hash_result_out);
+    domain_separate_rct_hash_with_extra(SpDomainHasher{domain_separator}, rct_key, rct::zero(), hash_result_out);
 }
 //-------------------------------------------------------------------------------------------------------------------
 void domain_separate_rct_hash_with_extra(const std::string &domain_separator,
     const rct::key &rct_key,
     const rct::key &extra_key,
     crypto::secret_key &hash_result_out)
+{
+    domain_separate_rct_hash_with_extra(SpDomainHasher{domain_separator}, rct_key, extra_key, hash_result_out);
+}
+//-------------------------------------------------------------------------------------------------------------------
+void domain_separate_derivation_hash(const std::string &domain_separator,
+    const crypto::key_derivation &derivation,
+    const std::size_t index,
+    rct::key &hash_result_out)
+{
+    domain_separate_derivation_hash(SpDomainHasher{domain_separator}, derivation, index, hash_result_out);
+}
+//-------------------------------------------------------------------------------------------------------------------
+void domain_separate_rct_hash(const SpDomainHasher &domain_hasher,
+    const rct::key &rct_key,
+    crypto::secret_key &hash_result_out)
+{
+    // H("domain-sep", rct_key)
+    domain_separate_rct_hash_with_extra(domain_hasher, rct_key, rct::zero(), hash_result_out);
+}
+//-------------------------------------------------------------------------------------------------------------------
+void domain_separate_rct_hash_with_extra(const SpDomainHasher &domain_hasher,
+    const rct::key &rct_key,
+    const rct::key &extra_key,
+    crypto::secret_key &hash_result_out)
 {
     // H("domain-sep", rct_key, [OPTIONAL extra_key])
-    epee::wipeable_string hash;
-    hash.reserve(domain_separator.size() + sizeof(rct::key) + (extra_key == rct::zero() ? 0 : sizeof(rct::key)));
-    hash = domain_separator;
-    hash.append((const char*) rct_key.bytes, sizeof(rct::key));
+    unsigned char hash[2*sizeof(rct::key)];
+    memcpy(hash, rct_key.bytes, sizeof(rct::key));
+    std::size_t hash_size{sizeof(rct::key)};
     if (!(extra_key == rct::zero()))
-        hash.append((const char*) extra_key.bytes, sizeof(rct::key));
+    {
+        memcpy(hash + hash_size, extra_key.bytes, sizeof(rct::key));
+        hash_size += sizeof(rct::key);
+    }
 
     // hash to the result
-    crypto::hash_to_scalar(hash.data(), hash.size(), hash_result_out);
+    domain_hasher.hash_to_scalar(hash, hash_size, reinterpret_cast<unsigned char*>(hash_result_out.data));
+    memwipe(hash, sizeof(hash));
 }
 //-------------------------------------------------------------------------------------------------------------------
-void domain_separate_derivation_hash(const std::string &domain_separator,
+void domain_separate_derivation_hash(const SpDomainHasher &domain_hasher,
     const crypto::key_derivation &derivation,
     const std::size_t index,
     rct::key &hash_result_out)
 {
     // derivation_hash = H("domain-sep", derivation, index)
-    epee::wipeable_string hash;
-    hash.reserve(domain_separator.size() + sizeof(rct::key) +
-        ((sizeof(std::size_t) * 8 + 6) / 7));
-    // "domain-sep"
-    hash = domain_separator;
+    unsigned char hash[sizeof(rct::key) + (sizeof(std::size_t) * 8 + 6) / 7];
     // derivation (e.g. a DH shared key)
-    hash.append((const char*) &derivation, sizeof(rct::key));
+    memcpy(hash, &derivation, sizeof(rct::key));
     // index
-    char converted_index[(sizeof(size_t) * 8 + 6) / 7];
-    char* end = converted_index;
+    char *end = reinterpret_cast<char*>(hash) + sizeof(rct::key);
     tools::write_varint(end, index);
-    assert(end <= converted_index + sizeof(converted_index));
-    hash.append(converted_index, end - converted_index);
+    assert(end <= reinterpret_cast<char*>(hash) + sizeof(hash));
 
     // hash to the result
-    rct::hash_to_scalar(hash_result_out, hash.data(), hash.size());
+    domain_hasher.hash_to_scalar(hash, end - reinterpret_cast<char*>(hash), hash_result_out.bytes);
+    memwipe(hash, sizeof(hash));
 }
 //-------------------------------------------------------------------------------------------------------------------
 bool key_domain_is_prime_subgroup(const rct::key &check_key)
@@ -754,22 +1191,76 @@ bool key_domain_is_prime_subgroup(const rct::key &check_key)
     return (ge_p3_is_point_at_infinity_vartime(&check_key_p3) != 0);
 }
 //-------------------------------------------------------------------------------------------------------------------
-bool check_pippenger_data(const std::vector<rct::pippenger_prep_data> &prep_datas)
+bool check_pippenger_data(const std::vector<rct::pippenger_prep_data> &prep_datas, const std::size_t num_threads)
 {
+    MOCK_TX_PHASE_TIMER(MULTIEXP);
+
     // verify all elements sum to zero
-    ge_p3 result = rct::pippenger_p3(prep_datas);
+    // - small uncached data sets (e.g. one composition proof) are gathered on the stack for a fixed-size multiexp
+    ge_p3 result;
+    std::size_t total_size{0};
+    bool cached{false};
+    for (const rct::pippenger_prep_data &prep_data : prep_datas)
+    {
+        total_size += prep_data.data.size();
+        cached = cached || prep_data.cache;
+    }
+
+    if (!cached && total_size > 0 && total_size <= MULTI_EXP_FIXED_MAX)
+    {
+        std::array<rct::MultiexpData, MULTI_EXP_FIXED_MAX> small_data;
+        std::size_t small_size{0};
+        for (const rct::pippenger_prep_data &prep_data : prep_datas)
+        {
+            std::copy(prep_data.data.begin(), prep_data.data.end(), small_data.begin() + small_size);
+            small_size += prep_data.data.size();
+        }
+
+        try_multi_exp_fixed({small_data.data(), small_size}, result);
+    }
+    else
+        result = rct::pippenger_p3_mt(prep_datas, num_threads);
+
     if (ge_p3_is_point_at_infinity_vartime(&result) == 0)
         return false;
 
     return true;
 }
 //-------------------------------------------------------------------------------------------------------------------
-bool check_pippenger_data(rct::pippenger_prep_data prep_data)
+bool check_pippenger_data(rct::pippenger_prep_data prep_data, const std::size_t num_threads)
 {
-    std::vector<rct::pippenger_prep_data> prep_datas;
+    // the data set is consumed here, so its storage goes back to this thread's multiexp data pool afterwards
+    // - the one-element wrapper is kept between calls too (taken out while in use, in case a threadpool wait runs a
+    //   nested check on this thread)
+    static thread_local std::vector<rct::pippenger_prep_data> s_prep_datas;
+    std::vector<rct::pippenger_prep_data> prep_datas{std::move(s_prep_datas)};
+    prep_datas.clear();
     prep_datas.emplace_back(std::move(prep_data));
 
-    return check_pippenger_data(prep_datas);
+    const bool result{check_pippenger_data(prep_datas, num_threads)};
+    rct::recycle_pippenger_prep_data(prep_datas);
+    s_prep_datas = std::move(prep_datas);
+
+    return result;
 }
 //-------------------------------------------------------------------------------------------------------------------
+#define INSTANTIATE_MULTI_EXP_FIXED(N) template ge_p3 multi_exp_fixed<N>(const rct::MultiexpData *data);
+INSTANTIATE_MULTI_EXP_FIXED(1)
+INSTANTIATE_MULTI_EXP_FIXED(2)
+INSTANTIATE_MULTI_EXP_FIXED(3)
+INSTANTIATE_MULTI_EXP_FIXED(4)
+INSTANTIATE_MULTI_EXP_FIXED(5)
+INSTANTIATE_MULTI_EXP_FIXED(6)
+INSTANTIATE_MULTI_EXP_FIXED(7)
+INSTANTIATE_MULTI_EXP_FIXED(8)
+INSTANTIATE_MULTI_EXP_FIXED(9)
+INSTANTIATE_MULTI_EXP_FIXED(10)
+INSTANTIATE_MULTI_EXP_FIXED(11)
+INSTANTIATE_MULTI_EXP_FIXED(12)
+INSTANTIATE_MULTI_EXP_FIXED(13)
+INSTANTIATE_MULTI_EXP_FIXED(14)
+INSTANTIATE_MULTI_EXP_FIXED(15)
+INSTANTIATE_MULTI_EXP_FIXED(16)
+#undef INSTANTIATE_MULTI_EXP_FIXED
+//-------------------------------------------------------------------------------------------------------------------
 } //namespace sp
@@ -37,6 +37,7 @@
 extern "C"
 {
 #include "crypto/crypto-ops.h"
+#include "crypto/keccak.h"
 }
 #include "grootle.h"
 #include "ringct/multiexp.h"
@@ -45,6 +46,7 @@ extern "C"
 //third party headers
 
 //standard headers
+#include <cstddef>
 #include <string>
 #include <vector>
 
@@ -68,12 +70,27 @@ ge_p3 get_X_p3_gen();
 rct::key get_U_gen();
 rct::key get_X_gen();
 /**
+* brief: scalarmult_H/U/X - multiply a fixed generator with its precomputed table
+*   - constant time, and costs the same as a G base mult (ge_scalarmult_base())
+* param: scalar - any 32 bytes (reduced mod l before use)
+* outparam: result_out - scalar * H/U/X
+*/
+void scalarmult_H(const rct::key &scalar, rct::key &result_out);
+void scalarmult_U(const rct::key &scalar, rct::key &result_out);
+void scalarmult_X(const rct::key &scalar, rct::key &result_out);
+/**
 * brief: invert - invert a nonzero scalar
 * param: x - scalar to invert
 * return: (1/x) mod l
 */
 rct::key invert(const rct::key &x);
 /**
+* brief: invert_batch - invert a set of nonzero scalars with one field inversion (Montgomery's trick)
+*   - costs one inversion plus ~3 multiplications per scalar (vs one inversion per scalar)
+* inoutparam: x_inout - scalars to invert; replaced with (1/x[i]) mod l
+*/
+void invert_batch(rct::keyV &x_inout);
+/**
 * brief: invert - decompose an integer with a fixed base and size
 *   val -> [_, _, ... ,_]
 *   - num slots = 'size'
@@ -101,6 +118,61 @@ rct::key kronecker_delta(const std::size_t x, const std::size_t y);
 */
 rct::keyV convolve(const rct::keyV &x, const rct::keyV &y, const std::size_t m);
 /**
+* brief: one_of_many_coefficients - coefficients of the one-of-many polynomials p_k(x), for all k in [0, n^m)
+*   - p_k(x) = prod_j( a[j][decomp_k[j]] + delta(decomp_l[j], decomp_k[j])*x )
+*   - k's digits are walked from most to least significant, and the partial products of the high digits are shared
+*     between all k with the same high digits, so it costs O(n^m * m) scalar ops instead of O(n^m * m^2)
+* param: a - m x n matrix of masks
+* param: decomp_l - decomposition of the real signing index (little endian, m digits)
+* param: n - decomposition base
+* param: m - number of digits
+* outparam: p_out - p_out[k][i] = coefficient of x^i in p_k(x) (n^m x (m + 1))
+*/
+void one_of_many_coefficients(const rct::keyM &a,
+    const std::vector<std::size_t> &decomp_l,
+    const std::size_t n,
+    const std::size_t m,
+    rct::keyM &p_out);
+/**
+* brief: one_of_many_f_products - the one-of-many verification coefficients t_k, for all k in [0, n^m)
+*   - t_k = prod_j( f[j][decomp_k[j]] )
+*   - products of k's high digits are shared between all k with the same high digits (< 2*n^m scalar muls)
+* param: f - m x n proof matrix
+* param: n - decomposition base
+* param: m - number of digits
+* inoutparam: prefix_scratch - scratch space, reusable between calls (resized to m + 1)
+* outparam: t_out - t_out[k] = t_k (resized to n^m)
+*/
+void one_of_many_f_products(const rct::KeyMatrix &f,
+    const std::size_t n,
+    const std::size_t m,
+    rct::keyV &prefix_scratch,
+    rct::keyV &t_out);
+/**
+* brief: one_of_many_f_products_mt - as one_of_many_f_products(), with the k split into contiguous chunks on the threadpool
+*   - for very large reference sets (e.g. 2^12 and up), where the serial loop dominates a single proof's verification
+* param: num_threads - max number of threads (0 = threadpool max concurrency; 1 = serial)
+*/
+void one_of_many_f_products_mt(const rct::KeyMatrix &f,
+    const std::size_t n,
+    const std::size_t m,
+    const std::size_t num_threads,
+    rct::keyV &t_out);
+/**
+* brief: mul_scalars - multiply a set of scalars by one scalar (four at a time with the AVX2 scalar backend)
+* param: scalar - multiplier
+* param: scalars - scalars to multiply
+* param: num_scalars - number of scalars
+* outparam: result_out - result_out[i] = scalar * scalars[i] (may be 'scalars' itself, but not offset from it)
+*/
+void mul_scalars(const rct::key &scalar, const rct::key *scalars, const std::size_t num_scalars, rct::key *result_out);
+/// as above, plus addends: result_out[i] = scalar * scalars[i] + addends[i] (may be 'scalars' or 'addends')
+void muladd_scalars(const rct::key &scalar,
+    const rct::key *scalars,
+    const rct::key *addends,
+    const std::size_t num_scalars,
+    rct::key *result_out);
+/**
 * brief: powers_of_scalar - powers of a scalar
 * param: scalar - scalar to take powers of
 * param: num_pows - number of powers to take (0-indexed)
@@ -108,6 +180,8 @@ rct::keyV convolve(const rct::keyV &x, const rct::keyV &y, const std::size_t m);
 * return: (negate ? -1 : 1)*([scalar^0], [scalar^1], ..., [scalar^{num_pows - 1}])
 */
 rct::keyV powers_of_scalar(const rct::key &scalar, const std::size_t num_pows, const bool negate_all = false);
+/// as above, written into a reusable vector (resized to num_pows)
+void powers_of_scalar(const rct::key &scalar, const std::size_t num_pows, const bool negate_all, rct::keyV &pows_out);
 /**
 * brief: small_scalar_gen - Generate a curve scalar of arbitrary size (in bytes).
 *   WARNING: NOT FOR USE WITH CRYPTOGRAPHIC SECRETS
@@ -116,6 +190,15 @@ rct::keyV powers_of_scalar(const rct::key &scalar, const std::size_t num_pows, c
 */
 rct::key small_scalar_gen(const std::size_t size_bytes);
 /**
+* brief: minus_small_scalar_gen - Generate the negation of a nonzero curve scalar of arbitrary size (in bytes).
+*   - batch verifiers weight equations with '-w' so proof elements that enter the multiexp with scalar '-weight' get
+*     the short scalar 'w' (pippenger skips the windows above it)
+*   WARNING: NOT FOR USE WITH CRYPTOGRAPHIC SECRETS
+* param: size_bytes - size of the scalar to negate
+* return: generated scalar (negated)
+*/
+rct::key minus_small_scalar_gen(const std::size_t size_bytes);
+/**
 * brief: generate_proof_nonce - generate a random scalar and corresponding pubkey for use in a Schnorr-like signature opening
 * param: base - base EC pubkey for the nonce term
 * outparam: nonce_out - private key 'nonce'
@@ -138,7 +221,31 @@ void multi_exp_p3(const rct::keyV &privkeys, const std::vector<ge_p3> &pubkeys,
 void multi_exp_vartime(const rct::keyV &privkeys, const rct::keyV &pubkeys, rct::key &result_out);
 void multi_exp_vartime(const rct::keyV &privkeys, const std::vector<ge_p3> &pubkeys, rct::key &result_out);
 void multi_exp_vartime_p3(const rct::keyV &privkeys, const rct::keyV &pubkeys, ge_p3 &result_out);
+void multi_exp_vartime_p3(const rct::keyV &privkeys, const epee::span<const rct::key> pubkeys, ge_p3 &result_out);
 void multi_exp_vartime_p3(const rct::keyV &privkeys, const std::vector<ge_p3> &pubkeys, ge_p3 &result_out);
+/// largest element count with a fixed-size multiexp (see multi_exp_fixed())
+constexpr std::size_t MULTI_EXP_FIXED_MAX{16};
+/**
+* brief: multi_exp_fixed - vartime EC multiexp over a compile-time number of elements (e.g. one Schnorr-style proof's
+*   verification equation)
+*   - interleaved width-5 w-NAF (slide()), sharing one doubling chain between all elements; precomputed odd multiples
+*     and recoded scalars are kept on the stack, so there is no allocation or runtime algorithm/window selection
+*   - width 5 (8 odd multiples per point) minimizes precomputation plus additions per point for 256-bit scalars, so the
+*     window does not depend on N
+*   - instantiated for N in [1, MULTI_EXP_FIXED_MAX]
+* type: N - number of elements
+* param: data - N elements {scalar, point}
+* return: sum of scalar*point
+*/
+template <std::size_t N>
+ge_p3 multi_exp_fixed(const rct::MultiexpData *data);
+/**
+* brief: try_multi_exp_fixed - multi_exp_fixed() for a data set whose size is only known at runtime
+* param: data - elements {scalar, point}
+* outparam: result_out - sum of scalar*point
+* return: false if the data set is empty or larger than MULTI_EXP_FIXED_MAX (result_out is not set)
+*/
+bool try_multi_exp_fixed(const epee::span<const rct::MultiexpData> data, ge_p3 &result_out);
 /**
 * brief: sub_keys_p3 - subtract two keys and get back a ge_p3 representation of the point
 *   A - B
@@ -166,6 +273,27 @@ void subtract_secret_key_vectors(const std::vector<crypto::secret_key> &keys_A,
 */
 void mask_key(const crypto::secret_key &mask, const rct::key &key, rct::key &masked_key_out);
 /**
+* brief: SpDomainHasher - keccak state with a domain separator already absorbed
+*   - H("domain-sep", data) resumes from a copy of the state, so the separator is neither copied nor re-hashed per call
+*   - meant to be made once per separator (e.g. a function-local static) and shared; hashing does not modify it
+*/
+class SpDomainHasher final
+{
+public:
+    explicit SpDomainHasher(const std::string &domain_separator);
+
+    /**
+    * brief: hash_to_scalar - H("domain-sep", data) reduced mod l
+    * param: data - bytes to hash after the domain separator
+    * param: size - number of bytes in 'data'
+    * outparam: scalar_out - 32-byte result
+    */
+    void hash_to_scalar(const void *data, const std::size_t size, unsigned char *scalar_out) const;
+
+private:
+    KECCAK_CTX m_ctx;
+};
+/**
 * brief: domain_separate_rct_hash - hash a key, with domain separation
 *   H("domain-sep", key)
 * param: domain_separator - domain separator
@@ -185,6 +313,13 @@ void domain_separate_rct_hash_with_extra(const std::string &domain_separator,
     const rct::key &rct_key,
     const rct::key &extra_key,
     crypto::secret_key &hash_result_out);
+void domain_separate_rct_hash(const SpDomainHasher &domain_hasher,
+    const rct::key &rct_key,
+    crypto::secret_key &hash_result_out);
+void domain_separate_rct_hash_with_extra(const SpDomainHasher &domain_hasher,
+    const rct::key &rct_key,
+    const rct::key &extra_key,
+    crypto::secret_key &hash_result_out);
 /**
 * brief: domain_separate_derivation_hash - hash a Diffie-Hellman derivation and index, with domain separation
 *   H("domain-sep", derivation, index)
@@ -197,6 +332,10 @@ void domain_separate_derivation_hash(const std::string &domain_separator,
     const crypto::key_derivation &derivation,
     const std::size_t index,
     rct::key &hash_result_out);
+void domain_separate_derivation_hash(const SpDomainHasher &domain_hasher,
+    const crypto::key_derivation &derivation,
+    const std::size_t index,
+    rct::key &hash_result_out);
 /**
 * brief: key_domain_is_prime_subgroup - check that input key is in prime order EC subgroup
 *   l*K ?= identity
@@ -204,8 +343,15 @@ void domain_separate_derivation_hash(const std::string &domain_separator,
 * result: true if input key is in prime order EC subgroup
 */
 bool key_domain_is_prime_subgroup(const rct::key &check_key);
-//todo
-bool check_pippenger_data(const std::vector<rct::pippenger_prep_data> &prep_datas);
-bool check_pippenger_data(rct::pippenger_prep_data prep_data);
+/**
+* brief: check_pippenger_data - check that multiexp data sums to the identity element
+*   - large multiexps are split across the threadpool (see rct::pippenger_p3_mt())
+*   - up to MULTI_EXP_FIXED_MAX uncached elements (e.g. a single composition proof) use multi_exp_fixed()
+* param: prep_datas - multiexp data to check
+* param: num_threads - max number of threads to use (0 = threadpool max concurrency; 1 = serial)
+* result: true if the multiexp result is the identity
+*/
+bool check_pippenger_data(const std::vector<rct::pippenger_prep_data> &prep_datas, const std::size_t num_threads = 0);
+bool check_pippenger_data(rct::pippenger_prep_data prep_data, const std::size_t num_threads = 0);
 
 } //namespace sp
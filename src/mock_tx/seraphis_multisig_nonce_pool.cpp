@@ -0,0 +1,155 @@
+// Copyright (c) 2021, The Monero Project
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this list of
+//    conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list
+//    of conditions and the following disclaimer in the documentation and/or other
+//    materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its contributors may be
+//    used to endorse or promote products derived from this software without specific
+//    prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+// THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// NOT FOR PRODUCTION
+
+//paired header
+#include "seraphis_multisig_nonce_pool.h"
+
+//local headers
+#include "common/threadpool.h"
+#include "misc_language.h"
+#include "misc_log_ex.h"
+#include "seraphis_composition_proof.h"
+
+//third party headers
+
+//standard headers
+#include <algorithm>
+#include <iterator>
+#include <mutex>
+#include <vector>
+
+#undef MONERO_DEFAULT_LOG_CATEGORY
+#define MONERO_DEFAULT_LOG_CATEGORY "mock_tx"
+
+namespace sp
+{
+
+//-------------------------------------------------------------------------------------------------------------------
+SpCompositionMultisigNoncePool::SpCompositionMultisigNoncePool(const std::size_t target_size,
+    const std::size_t refill_threshold) :
+        m_target_size{target_size},
+        m_refill_threshold{refill_threshold},
+        m_refill_waiter{tools::threadpool::getInstance()}
+{
+    CHECK_AND_ASSERT_THROW_MES(m_refill_threshold <= m_target_size,
+        "multisig nonce pool: refill threshold is above the target size.");
+
+    m_preps.reserve(m_target_size);
+}
+//-------------------------------------------------------------------------------------------------------------------
+SpCompositionMultisigNoncePool::~SpCompositionMultisigNoncePool()
+{
+    m_refill_waiter.wait();
+}
+//-------------------------------------------------------------------------------------------------------------------
+std::size_t SpCompositionMultisigNoncePool::size() const
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+
+    return m_preps.size();
+}
+//-------------------------------------------------------------------------------------------------------------------
+SpCompositionProofMultisigPrep SpCompositionMultisigNoncePool::take_prep()
+{
+    std::vector<SpCompositionProofMultisigPrep> preps{this->take_preps(1)};
+
+    return std::move(preps[0]);
+}
+//-------------------------------------------------------------------------------------------------------------------
+std::vector<SpCompositionProofMultisigPrep> SpCompositionMultisigNoncePool::take_preps(const std::size_t num_preps)
+{
+    std::vector<SpCompositionProofMultisigPrep> preps;
+    preps.reserve(num_preps);
+
+    // take what the pool has
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+
+        const std::size_t num_taken{std::min(num_preps, m_preps.size())};
+        std::move(m_preps.end() - num_taken, m_preps.end(), std::back_inserter(preps));
+        m_preps.resize(m_preps.size() - num_taken);
+    }
+
+    // make the rest inline
+    if (preps.size() < num_preps)
+        m_num_made_inline += num_preps - preps.size();
+
+    while (preps.size() < num_preps)
+        preps.emplace_back(sp_composition_multisig_init());
+
+    this->maybe_schedule_refill();
+
+    return preps;
+}
+//-------------------------------------------------------------------------------------------------------------------
+void SpCompositionMultisigNoncePool::refill()
+{
+    // make the preps without holding the lock, so takes are not blocked
+    std::size_t num_missing;
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        num_missing = m_target_size - std::min(m_target_size, m_preps.size());
+    }
+
+    std::vector<SpCompositionProofMultisigPrep> new_preps;
+    new_preps.reserve(num_missing);
+
+    for (std::size_t prep_index{0}; prep_index < num_missing; ++prep_index)
+        new_preps.emplace_back(sp_composition_multisig_init());
+
+    // a concurrent refill may have filled the pool already (extra preps are wiped when 'new_preps' is released)
+    std::lock_guard<std::mutex> lock{m_mutex};
+    const std::size_t num_kept{std::min(new_preps.size(), m_target_size - std::min(m_target_size, m_preps.size()))};
+    std::move(new_preps.begin(), new_preps.begin() + num_kept, std::back_inserter(m_preps));
+}
+//-------------------------------------------------------------------------------------------------------------------
+void SpCompositionMultisigNoncePool::maybe_schedule_refill()
+{
+    if (this->size() >= m_refill_threshold)
+        return;
+
+    // at most one pending refill
+    bool refill_pending{false};
+    if (!m_refill_pending.compare_exchange_strong(refill_pending, true))
+        return;
+
+    tools::threadpool::getInstance().submit(&m_refill_waiter,
+            [this]()
+            {
+                auto pending_reset = epee::misc_utils::create_scope_leave_handler([this]{
+                    m_refill_pending = false;
+                });
+                this->refill();
+            },
+            true  //leaf task
+        );
+}
+//-------------------------------------------------------------------------------------------------------------------
+} //namespace sp
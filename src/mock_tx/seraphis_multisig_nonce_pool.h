@@ -0,0 +1,112 @@
+// Copyright (c) 2021, The Monero Project
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this list of
+//    conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list
+//    of conditions and the following disclaimer in the documentation and/or other
+//    materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its contributors may be
+//    used to endorse or promote products derived from this software without specific
+//    prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+// THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// Pool of pre-generated multisig nonces for Seraphis composition proofs.
+// NOT FOR PRODUCTION
+
+#pragma once
+
+//local headers
+#include "common/threadpool.h"
+#include "seraphis_composition_proof.h"
+
+//third party headers
+
+//standard headers
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+//forward declarations
+
+
+namespace sp
+{
+
+////
+// SpCompositionMultisigNoncePool - single-use multisig nonces for composition proof signing, made ahead of time
+// - each prep comes from sp_composition_multisig_init(); taking a prep removes it from the pool, so a nonce pair can
+//   only be handed out once
+// - when a take leaves fewer than 'refill_threshold' preps, the pool is topped back up to 'target_size' by a task on
+//   the common threadpool; if the pool is empty, a take makes its prep inline
+// - nonce privkeys are crypto::secret_key (locked in memory and wiped when released); the pool is never serialized
+///
+class SpCompositionMultisigNoncePool final
+{
+public:
+//constructors
+    /// refill_threshold must be <= target_size (0 = never refill in the background)
+    SpCompositionMultisigNoncePool(const std::size_t target_size, const std::size_t refill_threshold);
+    /// a background refill holds a pointer to the pool
+    SpCompositionMultisigNoncePool(const SpCompositionMultisigNoncePool&) = delete;
+    SpCompositionMultisigNoncePool& operator=(const SpCompositionMultisigNoncePool&) = delete;
+
+//destructor
+    /// waits for a pending background refill
+    ~SpCompositionMultisigNoncePool();
+
+//member functions
+    /// number of preps in the pool
+    std::size_t size() const;
+    /// number of preps that were made inline because the pool was empty
+    std::size_t num_made_inline() const { return m_num_made_inline.load(); }
+
+    /**
+    * brief: take_prep - remove one prep from the pool
+    * return: multisig participant's prep work for a Seraphis composition proof
+    */
+    SpCompositionProofMultisigPrep take_prep();
+    /**
+    * brief: take_preps - remove a set of preps from the pool (e.g. to sign a batch of proposals)
+    * param: num_preps -
+    * return: 'num_preps' preps for Seraphis composition proofs
+    */
+    std::vector<SpCompositionProofMultisigPrep> take_preps(const std::size_t num_preps);
+    /**
+    * brief: refill - top the pool up to its target size on the calling thread (e.g. at startup)
+    */
+    void refill();
+
+private:
+    /// start a background refill if the pool is below its threshold and no refill is pending
+    void maybe_schedule_refill();
+
+    const std::size_t m_target_size;
+    const std::size_t m_refill_threshold;
+
+    /// preps in the pool
+    mutable std::mutex m_mutex;
+    std::vector<SpCompositionProofMultisigPrep> m_preps;
+
+    /// background refill state
+    std::atomic<bool> m_refill_pending{false};
+    std::atomic<std::size_t> m_num_made_inline{0};
+    tools::threadpool::waiter m_refill_waiter;
+};
+
+} //namespace sp
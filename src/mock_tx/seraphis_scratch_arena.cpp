@@ -0,0 +1,118 @@
+// Copyright (c) 2021, The Monero Project
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of
+//    conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list
+//    of conditions and the following disclaimer in the documentation and/or other
+//    materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be
+//    used to endorse or promote products derived from this software without specific
+//    prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+// THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// NOT FOR PRODUCTION
+
+//paired header
+#include "seraphis_scratch_arena.h"
+
+//local headers
+#include "crypto/crypto.h"
+#include "ringct/multiexp.h"
+#include "ringct/rctTypes.h"
+
+//third party headers
+
+//standard headers
+#include <cstddef>
+#include <deque>
+#include <vector>
+
+#undef MONERO_DEFAULT_LOG_CATEGORY
+#define MONERO_DEFAULT_LOG_CATEGORY "seraphis"
+
+namespace sp
+{
+//-------------------------------------------------------------------------------------------------------------------
+// Next buffer of a pool (a new one if all are borrowed)
+//-------------------------------------------------------------------------------------------------------------------
+template <typename T>
+static T& borrow_from_pool(std::deque<T> &pool, std::size_t &used_inout)
+{
+    if (used_inout == pool.size())
+        pool.emplace_back();
+
+    return pool[used_inout++];
+}
+//-------------------------------------------------------------------------------------------------------------------
+rct::keyV& SpScratchArena::keys(const std::size_t size)
+{
+    rct::keyV &keys = borrow_from_pool(m_keys, m_used.keys);
+    keys.resize(size);
+
+    return keys;
+}
+//-------------------------------------------------------------------------------------------------------------------
+std::vector<ge_p3>& SpScratchArena::points()
+{
+    std::vector<ge_p3> &points = borrow_from_pool(m_points, m_used.points);
+    points.clear();
+
+    return points;
+}
+//-------------------------------------------------------------------------------------------------------------------
+std::vector<rct::MultiexpData>& SpScratchArena::multiexp_data()
+{
+    std::vector<rct::MultiexpData> &data = borrow_from_pool(m_multiexp_data, m_used.multiexp_data);
+    data.clear();
+
+    return data;
+}
+//-------------------------------------------------------------------------------------------------------------------
+rct::KeyMatrix& SpScratchArena::key_matrix(const std::size_t rows, const std::size_t cols)
+{
+    rct::KeyMatrix &matrix = borrow_from_pool(m_key_matrices, m_used.key_matrices);
+    matrix.resize(rows, cols);
+
+    return matrix;
+}
+//-------------------------------------------------------------------------------------------------------------------
+SpScratchArena::Mark SpScratchArena::mark() const
+{
+    return m_used;
+}
+//-------------------------------------------------------------------------------------------------------------------
+void SpScratchArena::reset(const Mark &mark)
+{
+    // note: called from frame destructors, so a mark from after the current one (a frame that outlived a reset) is
+    //       ignored instead of thrown on
+    if (mark.keys > m_used.keys ||
+        mark.points > m_used.points ||
+        mark.multiexp_data > m_used.multiexp_data ||
+        mark.key_matrices > m_used.key_matrices)
+        return;
+
+    m_used = mark;
+}
+//-------------------------------------------------------------------------------------------------------------------
+SpScratchArena& sp_thread_scratch_arena()
+{
+    static thread_local SpScratchArena arena;
+    return arena;
+}
+//-------------------------------------------------------------------------------------------------------------------
+} //namespace sp
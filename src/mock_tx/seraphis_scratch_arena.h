@@ -0,0 +1,143 @@
+// Copyright (c) 2021, The Monero Project
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of
+//    conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list
+//    of conditions and the following disclaimer in the documentation and/or other
+//    materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be
+//    used to endorse or promote products derived from this software without specific
+//    prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+// THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+// NOT FOR PRODUCTION
+
+// Per-thread scratch buffers for proof verification and proving temporaries
+
+
+#pragma once
+
+//local headers
+#include "crypto/crypto.h"
+#include "ringct/multiexp.h"
+#include "ringct/rctTypes.h"
+
+//third party headers
+
+//standard headers
+#include <cstddef>
+#include <deque>
+#include <vector>
+
+//forward declarations
+
+
+namespace sp
+{
+
+////
+// SpScratchArena - reusable buffers for temporaries (key vectors, points, multiexp data, key matrices)
+// - buffers are handed out in order and returned all at once (by resetting to an earlier mark); a buffer keeps its
+//   storage while it is not in use, so after a warm-up call of each shape, borrowing does not allocate
+// - borrowed references stay valid until the arena is reset to a mark taken before they were borrowed
+// - not thread-safe: each thread should use its own arena (see sp_thread_scratch_arena())
+///
+class SpScratchArena final
+{
+public:
+    ////
+    // Mark - how many buffers of each kind were borrowed
+    ///
+    struct Mark final
+    {
+        std::size_t keys;
+        std::size_t points;
+        std::size_t multiexp_data;
+        std::size_t key_matrices;
+    };
+
+//constructors
+    SpScratchArena() = default;
+
+    SpScratchArena(const SpScratchArena&) = delete;
+    SpScratchArena& operator=(const SpScratchArena&) = delete;
+
+//member functions
+    /// borrow a key vector with 'size' elements (contents unspecified)
+    rct::keyV& keys(const std::size_t size);
+    /// borrow an empty point vector
+    std::vector<ge_p3>& points();
+    /// borrow an empty multiexp data vector
+    std::vector<rct::MultiexpData>& multiexp_data();
+    /// borrow a 'rows' x 'cols' key matrix (contents unspecified)
+    rct::KeyMatrix& key_matrix(const std::size_t rows, const std::size_t cols);
+
+    /// current mark (to reset to later)
+    Mark mark() const;
+    /// give back all buffers borrowed since 'mark' was taken
+    void reset(const Mark &mark);
+    /// give back all buffers
+    void reset() { reset(Mark{0, 0, 0, 0}); }
+
+private:
+    // deques: growing a pool must not move the buffers that are already borrowed
+    std::deque<rct::keyV> m_keys;
+    std::deque<std::vector<ge_p3>> m_points;
+    std::deque<std::vector<rct::MultiexpData>> m_multiexp_data;
+    std::deque<rct::KeyMatrix> m_key_matrices;
+
+    Mark m_used{0, 0, 0, 0};
+};
+
+////
+// SpScratchFrame - borrows from a scratch arena for the lifetime of a scope, then gives everything back
+// - frames nest, so a function with a frame can call other functions with their own frames
+///
+class SpScratchFrame final
+{
+public:
+//constructors
+    explicit SpScratchFrame(SpScratchArena &arena) :
+        m_arena{arena},
+        m_mark{arena.mark()}
+    {}
+
+//destructor
+    ~SpScratchFrame() { m_arena.reset(m_mark); }
+
+    SpScratchFrame(const SpScratchFrame&) = delete;
+    SpScratchFrame& operator=(const SpScratchFrame&) = delete;
+
+//member functions
+    rct::keyV& keys(const std::size_t size) { return m_arena.keys(size); }
+    std::vector<ge_p3>& points() { return m_arena.points(); }
+    std::vector<rct::MultiexpData>& multiexp_data() { return m_arena.multiexp_data(); }
+    rct::KeyMatrix& key_matrix(const std::size_t rows, const std::size_t cols)
+    {
+        return m_arena.key_matrix(rows, cols);
+    }
+
+private:
+    SpScratchArena &m_arena;
+    const SpScratchArena::Mark m_mark;
+};
+
+/// the calling thread's scratch arena
+SpScratchArena& sp_thread_scratch_arena();
+
+} //namespace sp
@@ -0,0 +1,130 @@
+// Copyright (c) 2021, The Monero Project
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of
+//    conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list
+//    of conditions and the following disclaimer in the documentation and/or other
+//    materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be
+//    used to endorse or promote products derived from this software without specific
+//    prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+// THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// NOT FOR PRODUCTION
+
+//paired header
+#include "seraphis_transcript.h"
+
+//local headers
+#include "common/varint.h"
+#include "crypto/crypto.h"
+extern "C"
+{
+#include "crypto/crypto-ops.h"
+#include "crypto/keccak.h"
+}
+#include "ringct/rctTypes.h"
+
+//third party headers
+
+//standard headers
+#include <cstring>
+#include <vector>
+
+
+namespace sp
+{
+//-------------------------------------------------------------------------------------------------------------------
+SpTranscript::SpTranscript()
+{
+    keccak_init(&m_state);
+}
+//-------------------------------------------------------------------------------------------------------------------
+void SpTranscript::absorb_bytes(const void *data, const std::size_t size)
+{
+    keccak_update(&m_state, reinterpret_cast<const uint8_t*>(data), size);
+}
+//-------------------------------------------------------------------------------------------------------------------
+void SpTranscript::absorb_string(const char *str)
+{
+    absorb_bytes(str, std::strlen(str));
+}
+//-------------------------------------------------------------------------------------------------------------------
+void SpTranscript::absorb(const rct::key &key)
+{
+    absorb_bytes(key.bytes, sizeof(key));
+}
+//-------------------------------------------------------------------------------------------------------------------
+void SpTranscript::absorb(const rct::keyV &keys)
+{
+    // keys are contiguous
+    if (keys.size() > 0)
+        absorb_bytes(keys.data(), keys.size()*sizeof(rct::key));
+}
+//-------------------------------------------------------------------------------------------------------------------
+void SpTranscript::absorb(const rct::keyM &keys)
+{
+    for (const rct::keyV &tuple : keys)
+        absorb(tuple);
+}
+//-------------------------------------------------------------------------------------------------------------------
+void SpTranscript::absorb(const epee::span<const rct::key> keys)
+{
+    if (keys.size() > 0)
+        absorb_bytes(keys.data(), keys.size()*sizeof(rct::key));
+}
+//-------------------------------------------------------------------------------------------------------------------
+void SpTranscript::absorb(const rct::KeyMatrix &keys)
+{
+    // same bytes as absorbing the rows one at a time
+    if (keys.size() > 0)
+        absorb_bytes(keys.data(), keys.size()*sizeof(rct::key));
+}
+//-------------------------------------------------------------------------------------------------------------------
+void SpTranscript::absorb(const crypto::key_image &key_image)
+{
+    absorb_bytes(&key_image, sizeof(key_image));
+}
+//-------------------------------------------------------------------------------------------------------------------
+void SpTranscript::absorb(const std::vector<crypto::key_image> &key_images)
+{
+    if (key_images.size() > 0)
+        absorb_bytes(key_images.data(), key_images.size()*sizeof(crypto::key_image));
+}
+//-------------------------------------------------------------------------------------------------------------------
+void SpTranscript::absorb_varint(const std::size_t value)
+{
+    char converted[(sizeof(std::size_t) * 8 + 6) / 7];
+    char *end{converted};
+    tools::write_varint(end, value);
+    absorb_bytes(converted, end - converted);
+}
+//-------------------------------------------------------------------------------------------------------------------
+rct::key SpTranscript::challenge() const
+{
+    // finish a copy of the state, so this transcript can keep absorbing
+    KECCAK_CTX state{m_state};
+    rct::key challenge;
+    keccak_finish(&state, challenge.bytes);
+    sc_reduce32(challenge.bytes);
+
+    return challenge;
+}
+//-------------------------------------------------------------------------------------------------------------------
+} //namespace sp
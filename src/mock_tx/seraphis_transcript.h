@@ -0,0 +1,94 @@
+// Copyright (c) 2021, The Monero Project
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of
+//    conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list
+//    of conditions and the following disclaimer in the documentation and/or other
+//    materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be
+//    used to endorse or promote products derived from this software without specific
+//    prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+// THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+// NOT FOR PRODUCTION
+
+////
+// Streaming Fiat-Shamir transcript for Seraphis proofs
+// - absorbs proof elements straight into a Keccak state, so challenges over large inputs (e.g. Grootle ref sets)
+//   don't need an intermediate string
+// - challenge = H_n(absorbed bytes), identical to rct::hash_to_scalar() over the concatenated bytes
+///
+
+#pragma once
+
+//local headers
+#include "crypto/crypto.h"
+extern "C"
+{
+#include "crypto/keccak.h"
+}
+#include "ringct/rctTypes.h"
+
+//third party headers
+
+//standard headers
+#include <cstddef>
+#include <vector>
+
+//forward declarations
+
+
+namespace sp
+{
+
+class SpTranscript final
+{
+public:
+//constructors
+    /// empty transcript
+    SpTranscript();
+
+//member functions
+    /// absorb raw bytes
+    void absorb_bytes(const void *data, const std::size_t size);
+    /// absorb a C string (without its terminator)
+    void absorb_string(const char *str);
+    /// absorb keys
+    void absorb(const rct::key &key);
+    void absorb(const rct::keyV &keys);
+    void absorb(const rct::keyM &keys);
+    void absorb(const epee::span<const rct::key> keys);
+    void absorb(const rct::KeyMatrix &keys);
+    void absorb(const crypto::key_image &key_image);
+    void absorb(const std::vector<crypto::key_image> &key_images);
+    /// absorb an integer as a varint
+    void absorb_varint(const std::size_t value);
+
+    /**
+    * brief: challenge - get the transcript's challenge
+    *   - does not consume the transcript, so more elements may be absorbed afterwards
+    * return: H_n(absorbed bytes)
+    */
+    rct::key challenge() const;
+
+private:
+    KECCAK_CTX m_state;
+};
+
+} //namespace sp
@@ -253,6 +253,7 @@ namespace nodetool
         m_hide_my_port(false),
         m_igd(no_igd),
         m_offline(false),
+        m_rpc_replica(false),
         is_closing(false),
         m_network_id(),
         m_enable_dns_seed_nodes(true),
@@ -458,6 +459,7 @@ namespace nodetool
     bool m_hide_my_port;
     igd_t m_igd;
     bool m_offline;
+    bool m_rpc_replica;
     bool m_use_ipv6;
     bool m_require_ipv4;
     std::atomic<bool> is_closing;
@@ -552,6 +554,7 @@ namespace nodetool
     extern const command_line::arg_descriptor<int64_t> arg_limit_rate;
     extern const command_line::arg_descriptor<bool> arg_pad_transactions;
     extern const command_line::arg_descriptor<uint32_t> arg_max_connections_per_ip;
+    extern const command_line::arg_descriptor<bool> arg_p2p_io_service_per_thread;
 }
 
 POP_WARNINGS
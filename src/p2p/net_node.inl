@@ -132,6 +132,7 @@ namespace nodetool
     command_line::add_arg(desc, arg_limit_rate);
     command_line::add_arg(desc, arg_pad_transactions);
     command_line::add_arg(desc, arg_max_connections_per_ip);
+    command_line::add_arg(desc, arg_p2p_io_service_per_thread);
   }
   //-----------------------------------------------------------------------------------
   template<class t_payload_net_handler>
@@ -433,7 +434,8 @@ namespace nodetool
       MFATAL("Invalid value for --" << arg_igd.name << ", expected enabled, disabled or delayed");
       return false;
     }
-    m_offline = command_line::get_arg(vm, cryptonote::arg_offline);
+    m_rpc_replica = command_line::get_arg(vm, cryptonote::arg_rpc_replica);
+    m_offline = command_line::get_arg(vm, cryptonote::arg_offline) || m_rpc_replica;
     m_use_ipv6 = command_line::get_arg(vm, arg_p2p_use_ipv6);
     m_require_ipv4 = !command_line::get_arg(vm, arg_p2p_ignore_ipv4);
     public_zone.m_notifier = cryptonote::levin::notify{
@@ -942,6 +944,7 @@ namespace nodetool
     //configure self
 
     public_zone.m_net_server.set_threads_prefix("P2P"); // all zones use these threads/asio::io_service
+    public_zone.m_net_server.set_io_service_per_thread(command_line::get_arg(vm, arg_p2p_io_service_per_thread));
 
     // from here onwards, it's online stuff
     if (m_offline)
@@ -1084,6 +1087,10 @@ namespace nodetool
   {
     TRY_ENTRY();
 
+    // the peer list in the data dir belongs to the daemon whose db a replica follows
+    if (m_rpc_replica)
+      return true;
+
     if (!tools::create_directories_if_necessary(m_config_folder))
     {
       MWARNING("Failed to create data directory \"" << m_config_folder);
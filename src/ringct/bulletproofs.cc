@@ -90,7 +90,7 @@ static inline rct::key multiexp(const std::vector<MultiexpData> &data, size_t Hi
     return HiGi_size <= 232 && data.size() == HiGi_size ? straus(data, straus_HiGi_cache, 0) : pippenger(data, pippenger_HiGi_cache, HiGi_size, get_pippenger_c(data.size()));
   }
   else
-    return data.size() <= 95 ? straus(data, NULL, 0) : pippenger(data, NULL, 0, get_pippenger_c(data.size()));
+    return multiexp_auto(data);
 }
 
 static inline bool is_reduced(const rct::key &scalar)
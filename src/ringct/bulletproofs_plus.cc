@@ -37,10 +37,13 @@
 //  The result is that the roles of `g` and `h` in the preprint are effectively swapped
 //      in this code, taking on the roles of `H` and `G`, respectively. Read carefully!
 
+#include <algorithm>
+#include <atomic>
 #include <stdlib.h>
 #include <boost/thread/mutex.hpp>
 #include <boost/thread/lock_guard.hpp>
 #include "misc_log_ex.h"
+#include "common/numa_topology.h"
 #include "span.h"
 #include "cryptonote_config.h"
 extern "C"
@@ -70,8 +73,11 @@ namespace rct
     // Cached public generators
     static rct::key Hi[maxN*maxM], Gi[maxN*maxM];
     static ge_p3 Hi_p3[maxN*maxM], Gi_p3[maxN*maxM];
-    static std::shared_ptr<straus_cached_data> straus_HiGi_cache;
-    static std::shared_ptr<pippenger_cached_data> pippenger_HiGi_cache;
+    // - the multiexp tables are read by every verification, so each NUMA node gets its own copy
+    static std::unique_ptr<tools::numa_replicated<straus_cached_data>> straus_HiGi_cache;
+    static std::unique_ptr<tools::numa_replicated<pippenger_cached_data>> pippenger_HiGi_cache;
+    static std::shared_ptr<tools::numa_replicated<fixed_base_cached_data>> fixed_base_GHGiHi_cache;
+    static size_t fixed_base_GHGiHi_MN = 0;
 
     // Useful scalar constants
     static const rct::key ZERO = { {0x00, 0x00, 0x00,0x00 , 0x00, 0x00, 0x00,0x00 , 0x00, 0x00, 0x00,0x00 , 0x00, 0x00, 0x00,0x00 , 0x00, 0x00, 0x00,0x00 , 0x00, 0x00, 0x00,0x00 , 0x00, 0x00, 0x00,0x00 , 0x00, 0x00, 0x00,0x00  } }; // 0
@@ -85,6 +91,8 @@ namespace rct
     static rct::key initial_transcript;
 
     static boost::mutex init_mutex;
+    static std::atomic<bool> init_done{false};
+    static boost::mutex fixed_base_mutex;
 
     // Use the generator caches to compute a multiscalar multiplication
     static inline rct::key multiexp(const std::vector<MultiexpData> &data, size_t HiGi_size)
@@ -92,11 +100,11 @@ namespace rct
         if (HiGi_size > 0)
         {
             static_assert(232 <= STRAUS_SIZE_LIMIT, "Straus in precalc mode can only be calculated till STRAUS_SIZE_LIMIT");
-            return HiGi_size <= 232 && data.size() == HiGi_size ? straus(data, straus_HiGi_cache, 0) : pippenger(data, pippenger_HiGi_cache, HiGi_size, get_pippenger_c(data.size()));
+            return HiGi_size <= 232 && data.size() == HiGi_size ? straus(data, straus_HiGi_cache->get(), 0) : pippenger(data, pippenger_HiGi_cache->get(), HiGi_size, get_pippenger_c(data.size()));
         }
         else
         {
-            return data.size() <= 95 ? straus(data, NULL, 0) : pippenger(data, NULL, 0, get_pippenger_c(data.size()));
+            return multiexp_auto(data);
         }
     }
 
@@ -122,11 +130,13 @@ namespace rct
     // Construct public generators
     static void init_exponents()
     {
-        boost::lock_guard<boost::mutex> lock(init_mutex);
-
         // Only needs to be done once
-        static bool init_done = false;
-        if (init_done)
+        // - checked before locking so concurrent provers and verifiers don't contend on the mutex afterwards
+        if (init_done.load(std::memory_order_acquire))
+            return;
+
+        boost::lock_guard<boost::mutex> lock(init_mutex);
+        if (init_done.load(std::memory_order_relaxed))
             return;
 
         std::vector<MultiexpData> data;
@@ -142,8 +152,10 @@ namespace rct
             data.push_back({rct::zero(), Hi_p3[i]});
         }
 
-        straus_HiGi_cache = straus_init_cache(data, STRAUS_SIZE_LIMIT);
-        pippenger_HiGi_cache = pippenger_init_cache(data, 0, PIPPENGER_SIZE_LIMIT);
+        straus_HiGi_cache.reset(new tools::numa_replicated<straus_cached_data>(
+            straus_init_cache(data, STRAUS_SIZE_LIMIT), straus_copy_cache));
+        pippenger_HiGi_cache.reset(new tools::numa_replicated<pippenger_cached_data>(
+            pippenger_init_cache(data, 0, PIPPENGER_SIZE_LIMIT), pippenger_copy_cache));
 
         // Compute 2**64 - 1 for later use in simplifying verification
         TWO_SIXTY_FOUR_MINUS_ONE = TWO;
@@ -159,7 +171,42 @@ namespace rct
         rct::hash_to_p3(initial_transcript_p3, rct::hash2rct(crypto::cn_fast_hash(domain_separator.data(), domain_separator.size())));
         ge_p3_tobytes(initial_transcript.bytes, &initial_transcript_p3);
 
-        init_done = true;
+        init_done.store(true, std::memory_order_release);
+    }
+
+    // Fixed-base tables for the verifier's generator terms: G, H, Gi[0], Hi[0], ..., Gi[MN-1], Hi[MN-1]
+    // - tables are only built as far as they are needed (the full table takes much longer to build than a typical
+    //   verification), and rebuilt when a larger proof shows up
+    static std::shared_ptr<fixed_base_cached_data> get_fixed_base_cache(const size_t MN)
+    {
+        CHECK_AND_ASSERT_THROW_MES(MN <= maxN*maxM, "Too many generators requested");
+
+        std::shared_ptr<tools::numa_replicated<fixed_base_cached_data>> replicas;
+        {
+            boost::lock_guard<boost::mutex> lock(fixed_base_mutex);
+
+            if (fixed_base_GHGiHi_MN < MN)
+            {
+                std::vector<ge_p3> bases;
+                bases.reserve(2 + 2 * MN);
+                bases.resize(2);
+                CHECK_AND_ASSERT_THROW_MES(ge_frombytes_vartime(&bases[0], rct::G.bytes) == 0, "ge_frombytes_vartime failed");
+                CHECK_AND_ASSERT_THROW_MES(ge_frombytes_vartime(&bases[1], rct::H.bytes) == 0, "ge_frombytes_vartime failed");
+                for (size_t i = 0; i < MN; ++i)
+                {
+                    bases.push_back(Gi_p3[i]);
+                    bases.push_back(Hi_p3[i]);
+                }
+
+                fixed_base_GHGiHi_cache = std::make_shared<tools::numa_replicated<fixed_base_cached_data>>(
+                    fixed_base_init_cache(bases), fixed_base_copy_cache);
+                fixed_base_GHGiHi_MN = MN;
+            }
+            replicas = fixed_base_GHGiHi_cache;
+        }
+
+        // the calling thread's node copy (copied outside the lock, on first use from the node)
+        return replicas->get();
     }
 
     // Given two scalar arrays, construct a vector pre-commitment:
@@ -817,8 +864,10 @@ try_again:
     };
 
     // Given a batch of range proofs, determine if they are all valid
-    bool try_get_bulletproof_plus_verification_data(const std::vector<const BulletproofPlus*> &proofs, pippenger_prep_data &prep_data_out)
+    bool try_get_bulletproof_plus_verification_data(const std::vector<const BulletproofPlus*> &proofs, pippenger_prep_data &prep_data_out,
+        const size_t small_weighting_size)
     {
+        CHECK_AND_ASSERT_MES(small_weighting_size >= 1 && small_weighting_size <= 32, false, "Invalid weight size");
         init_exponents();
 
         const size_t logN = 6;
@@ -900,9 +949,11 @@ try_again:
         rct::key temp2;
 
         // Final batch proof data
-        std::vector<MultiexpData> multiexp_data;
-        multiexp_data.reserve(nV + (2 * (max_logM + logN) + 3) * proofs.size() + 2 * maxMN);
-        multiexp_data.resize(2 * maxMN);
+        // - the generator terms (G, H, Gi, Hi) are summed separately and evaluated with fixed-base tables; only their
+        //   sum (at index 0) and the proofs' own points (V, L, R, A, A1, B) go to the main multiexp
+        // - taken from this thread's multiexp data pool, so callers that recycle checked batches reuse its storage
+        std::vector<MultiexpData> multiexp_data{take_multiexp_data_buffer(1 + nV + (2 * (max_logM + logN) + 3) * proofs.size())};
+        multiexp_data.resize(1);
 
         const std::vector<rct::key> inverses = invert(to_invert);
 
@@ -926,7 +977,8 @@ try_again:
 
         int proof_data_index = 0;
         rct::keyV challenges_cache;
-        std::vector<ge_p3> proof8_V, proof8_L, proof8_R;
+        rct::keyV proof_points;
+        std::vector<ge_p3> proof8_points;
 
         // Process each proof and add to the weighted batch
         for (const BulletproofPlus *p: proofs)
@@ -939,24 +991,36 @@ try_again:
             const size_t MN = M*N;
 
             // Random weighting factor must be nonzero, which is exceptionally unlikely!
+            // The weight is the negation of a small scalar, so B's multiexp scalar (-weight) is small and
+            //  pippenger skips its high windows
             rct::key weight = ZERO;
             while (weight == ZERO)
             {
                 weight = rct::skGen();
+                for (size_t byte_index = small_weighting_size; byte_index < 32; ++byte_index)
+                    weight.bytes[byte_index] = 0x00;
             }
+            sc_sub(weight.bytes, ZERO.bytes, weight.bytes);
 
             // Rescale previously offset proof elements
             //
             // This ensures that all such group elements are in the prime-order subgroup.
-            proof8_V.resize(proof.V.size()); for (size_t i = 0; i < proof.V.size(); ++i) rct::scalarmult8(proof8_V[i], proof.V[i]);
-            proof8_L.resize(proof.L.size()); for (size_t i = 0; i < proof.L.size(); ++i) rct::scalarmult8(proof8_L[i], proof.L[i]);
-            proof8_R.resize(proof.R.size()); for (size_t i = 0; i < proof.R.size(); ++i) rct::scalarmult8(proof8_R[i], proof.R[i]);
-            ge_p3 proof8_A1;
-            ge_p3 proof8_B;
-            ge_p3 proof8_A;
-            rct::scalarmult8(proof8_A1, proof.A1);
-            rct::scalarmult8(proof8_B, proof.B);
-            rct::scalarmult8(proof8_A, proof.A);
+            // The points are decompressed in one batch: {V}, {L}, {R}, A1, B, A
+            proof_points.clear();
+            proof_points.insert(proof_points.end(), proof.V.begin(), proof.V.end());
+            proof_points.insert(proof_points.end(), proof.L.begin(), proof.L.end());
+            proof_points.insert(proof_points.end(), proof.R.begin(), proof.R.end());
+            proof_points.push_back(proof.A1);
+            proof_points.push_back(proof.B);
+            proof_points.push_back(proof.A);
+            scalarmult8_points(proof_points, proof8_points);
+
+            const ge_p3 *proof8_V = proof8_points.data();
+            const ge_p3 *proof8_L = proof8_V + proof.V.size();
+            const ge_p3 *proof8_R = proof8_L + proof.L.size();
+            const ge_p3 &proof8_A1 = proof8_R[proof.R.size()];
+            const ge_p3 &proof8_B = proof8_R[proof.R.size() + 1];
+            const ge_p3 &proof8_A = proof8_R[proof.R.size() + 2];
 
             // Compute necessary powers of the y-challenge
             rct::key y_MN = copy(pd.y);
@@ -979,7 +1043,7 @@ try_again:
             sc_sub(temp.bytes, ZERO.bytes, e_squared.bytes);
             sc_mul(temp.bytes, temp.bytes, y_MN_1.bytes);
             sc_mul(temp.bytes, temp.bytes, weight.bytes);
-            for (size_t j = 0; j < proof8_V.size(); j++)
+            for (size_t j = 0; j < proof.V.size(); j++)
             {
                 sc_mul(temp.bytes, temp.bytes, z_squared.bytes);
                 multiexp_data.emplace_back(temp, proof8_V[j]);
@@ -1107,16 +1171,20 @@ try_again:
         }
 
         // Verify all proofs in the weighted batch
-        multiexp_data.emplace_back(G_scalar, rct::G);
-        multiexp_data.emplace_back(H_scalar, rct::H);
+        // generator terms: G, H, Gi[0], Hi[0], ..., Gi[maxMN-1], Hi[maxMN-1]
+        rct::keyV generator_scalars;
+        generator_scalars.reserve(2 + 2 * maxMN);
+        generator_scalars.push_back(G_scalar);
+        generator_scalars.push_back(H_scalar);
         for (size_t i = 0; i < maxMN; ++i)
         {
-            multiexp_data[i * 2] = {Gi_scalars[i], Gi_p3[i]};
-            multiexp_data[i * 2 + 1] = {Hi_scalars[i], Hi_p3[i]};
+            generator_scalars.push_back(Gi_scalars[i]);
+            generator_scalars.push_back(Hi_scalars[i]);
         }
+        multiexp_data[0] = {ONE, fixed_base_multiexp_p3(generator_scalars, get_fixed_base_cache(maxMN))};
 
         // return multiexp data for caller to deal with
-        prep_data_out = rct::pippenger_prep_data{std::move(multiexp_data), pippenger_HiGi_cache, 2 * maxMN};
+        prep_data_out = rct::pippenger_prep_data{std::move(multiexp_data), nullptr, 0};
 
         return true;
     }
@@ -1129,7 +1197,9 @@ try_again:
             return false;;
 
         // verify all elements sum to zero (use optimized multiexp function)
-        if (!(multiexp(prep_data.data, prep_data.cache_size) == rct::identity()))
+        const bool valid = multiexp(prep_data.data, prep_data.cache_size) == rct::identity();
+        recycle_multiexp_data_buffer(std::move(prep_data.data));
+        if (!valid)
         {
             MERROR("Verification failure");
             return false;
@@ -1138,6 +1208,37 @@ try_again:
         return true;
     }
 
+    std::vector<size_t> bulletproof_plus_find_invalid(const std::vector<const BulletproofPlus*> &proofs)
+    {
+        // build one multiexp segment per proof so a failed batch can be bisected down to the offending proofs
+        std::vector<size_t> invalid_proofs;
+        std::vector<size_t> segment_proof_indices;
+        std::vector<std::vector<rct::pippenger_prep_data>> segments;
+        segment_proof_indices.reserve(proofs.size());
+        segments.reserve(proofs.size());
+
+        for (size_t proof_index = 0; proof_index < proofs.size(); ++proof_index)
+        {
+            rct::pippenger_prep_data prep_data;
+            if (!try_get_bulletproof_plus_verification_data({proofs[proof_index]}, prep_data))
+            {
+                invalid_proofs.push_back(proof_index);
+                continue;
+            }
+
+            segment_proof_indices.push_back(proof_index);
+            segments.emplace_back();
+            segments.back().emplace_back(std::move(prep_data));
+        }
+
+        // one multiexp if everything is valid, about log2(n) more per invalid proof otherwise
+        for (const size_t failing_segment : rct::pippenger_find_failing_segments(segments))
+            invalid_proofs.push_back(segment_proof_indices[failing_segment]);
+
+        std::sort(invalid_proofs.begin(), invalid_proofs.end());
+        return invalid_proofs;
+    }
+
     bool bulletproof_plus_VERIFY(const std::vector<BulletproofPlus> &proofs)
     {
         std::vector<const BulletproofPlus*> proof_pointers;
@@ -38,14 +38,20 @@ namespace rct
 
 struct pippenger_prep_data;
 
+// size (bytes) of the random weights that combine proofs in batch verification (128 bits: a batch with an invalid proof
+//   passes with probability ~2^-128)
+constexpr size_t BULLETPROOF_PLUS_BATCH_WEIGHT_SIZE = 16;
+
 BulletproofPlus bulletproof_plus_PROVE(const rct::key &v, const rct::key &gamma);
 BulletproofPlus bulletproof_plus_PROVE(uint64_t v, const rct::key &gamma);
 BulletproofPlus bulletproof_plus_PROVE(const rct::keyV &v, const rct::keyV &gamma);
 BulletproofPlus bulletproof_plus_PROVE(const std::vector<uint64_t> &v, const rct::keyV &gamma);
-bool try_get_bulletproof_plus_verification_data(const std::vector<const BulletproofPlus*> &proofs, pippenger_prep_data &prep_data_out);
+bool try_get_bulletproof_plus_verification_data(const std::vector<const BulletproofPlus*> &proofs, pippenger_prep_data &prep_data_out,
+  size_t small_weighting_size = BULLETPROOF_PLUS_BATCH_WEIGHT_SIZE);
 bool bulletproof_plus_VERIFY(const BulletproofPlus &proof);
 bool bulletproof_plus_VERIFY(const std::vector<const BulletproofPlus*> &proofs);
 bool bulletproof_plus_VERIFY(const std::vector<BulletproofPlus> &proofs);
+std::vector<size_t> bulletproof_plus_find_invalid(const std::vector<const BulletproofPlus*> &proofs);
 
 }
 
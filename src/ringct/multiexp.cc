@@ -28,8 +28,17 @@
 //
 // Adapted from Python code by Sarang Noether
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+
 #include "misc_log_ex.h"
 #include "common/perf_timer.h"
+#include "common/threadpool.h"
 extern "C"
 {
 #include "crypto/crypto-ops.h"
@@ -442,6 +451,21 @@ size_t straus_get_cache_size(const std::shared_ptr<straus_cached_data> &cache)
   return sz;
 }
 
+std::shared_ptr<straus_cached_data> straus_copy_cache(const straus_cached_data &cache)
+{
+  std::shared_ptr<straus_cached_data> copy(new straus_cached_data());
+#ifdef RAW_MEMORY_BLOCK
+  const size_t bytes = sizeof(ge_cached) * ((1<<STRAUS_C)-1) * cache.size;
+  copy->multiples = (ge_cached*)aligned_malloc(bytes, 4096);
+  CHECK_AND_ASSERT_THROW_MES(copy->multiples || bytes == 0, "Out of memory");
+  memcpy(copy->multiples, cache.multiples, bytes);
+  copy->size = cache.size;
+#else
+  copy->multiples = cache.multiples;
+#endif
+  return copy;
+}
+
 ge_p3 straus_p3(const std::vector<MultiexpData> &data, const std::shared_ptr<straus_cached_data> &cache, size_t STEP)
 {
   CHECK_AND_ASSERT_THROW_MES(cache == NULL || cache->size >= data.size(), "Cache is too small");
@@ -564,8 +588,203 @@ rct::key straus(const std::vector<MultiexpData> &data, const std::shared_ptr<str
   return res;
 }
 
+struct straus_point_cache::entry
+{
+  ge_cached multiples[(1<<STRAUS_C)-1];  // multiples[d-1] = d*P
+};
+
+constexpr uint64_t straus_point_cache::NO_ID;
+
+size_t straus_point_cache::size() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_entries.size();
+}
+
+void straus_point_cache::clear()
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_entries.clear();
+  m_order.clear();
+}
+
+straus_point_cache_stats straus_point_cache::get_stats() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  straus_point_cache_stats stats = m_stats;
+  if (stats.misses > 0)
+    stats.saved_ns = stats.hits * (stats.precompute_ns / stats.misses);
+  return stats;
+}
+
+void straus_point_cache::reset_stats()
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_stats = straus_point_cache_stats{};
+}
+
+straus_point_cache::entry_ptr straus_point_cache::find(const uint64_t id)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  const auto it = m_entries.find(id);
+  if (it == m_entries.end())
+  {
+    ++m_stats.misses;
+    return nullptr;
+  }
+  ++m_stats.hits;
+  m_order.splice(m_order.begin(), m_order, it->second.second);
+  return it->second.first;
+}
+
+void straus_point_cache::insert(const uint64_t id, entry_ptr multiples, const uint64_t precompute_ns)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_stats.precompute_ns += precompute_ns;
+  if (m_max_points == 0 || m_entries.find(id) != m_entries.end())
+    return;
+  if (m_entries.size() >= m_max_points)
+  {
+    m_entries.erase(m_order.back());
+    m_order.pop_back();
+    ++m_stats.evictions;
+  }
+  m_order.push_front(id);
+  m_entries.emplace(id, std::make_pair(std::move(multiples), m_order.begin()));
+}
+
+ge_p3 straus_p3(const std::vector<MultiexpData> &data, const std::vector<uint64_t> &point_ids, straus_point_cache &point_cache, size_t STEP)
+{
+  CHECK_AND_ASSERT_THROW_MES(point_ids.size() == data.size(), "Point ids don't line up with multiexp data");
+
+  // gather every point's multiples into a per-call cache, making (and caching) the ones the point cache doesn't have
+  std::shared_ptr<straus_cached_data> local_cache(new straus_cached_data());
+#ifdef RAW_MEMORY_BLOCK
+  local_cache->multiples = (ge_cached*)aligned_realloc(NULL, sizeof(ge_cached) * ((1<<STRAUS_C)-1) * data.size(), 4096);
+  CHECK_AND_ASSERT_THROW_MES(local_cache->multiples, "Out of memory");
+  local_cache->size = data.size();
+#else
+  local_cache->multiples.resize(1<<STRAUS_C);
+  for (size_t i=1;i<1<<STRAUS_C;++i)
+    local_cache->multiples[i].resize(data.size());
+#endif
+
+  ge_p1p1 p1;
+  ge_p3 p3;
+  for (size_t j = 0; j < data.size(); ++j)
+  {
+    straus_point_cache::entry_ptr multiples;
+    if (point_ids[j] != straus_point_cache::NO_ID)
+      multiples = point_cache.find(point_ids[j]);
+
+    if (!multiples)
+    {
+      const auto start = std::chrono::steady_clock::now();
+      std::shared_ptr<straus_point_cache::entry> fresh(new straus_point_cache::entry());
+      ge_p3_to_cached(&fresh->multiples[0], &data[j].point);
+      for (size_t i=2;i<1<<STRAUS_C;++i)
+      {
+        ge_add(&p1, &data[j].point, &fresh->multiples[i-2]);
+        ge_p1p1_to_p3(&p3, &p1);
+        ge_p3_to_cached(&fresh->multiples[i-1], &p3);
+      }
+      multiples = fresh;
+      if (point_ids[j] != straus_point_cache::NO_ID)
+      {
+        const uint64_t elapsed_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now() - start).count();
+        point_cache.insert(point_ids[j], multiples, elapsed_ns);
+      }
+    }
+
+    for (size_t i=1;i<1<<STRAUS_C;++i)
+    {
+#ifdef RAW_MEMORY_BLOCK
+      CACHE_OFFSET(local_cache, j, i) = multiples->multiples[i-1];
+#else
+      local_cache->multiples[i][j] = multiples->multiples[i-1];
+#endif
+    }
+  }
+
+  return straus_p3(data, local_cache, STEP);
+}
+
+// tuned window sizes: (max N, c) in increasing N, the last c also covers larger N; empty: use the built-in table
+static std::mutex pippenger_c_profile_mutex;
+static std::vector<std::pair<size_t, size_t>> pippenger_c_profile;
+
+bool set_pippenger_c_profile(const std::vector<std::pair<size_t, size_t>> &profile)
+{
+  for (size_t i = 0; i < profile.size(); ++i)
+  {
+    if (profile[i].second < 1 || profile[i].second > 9)
+      return false;
+    if (i > 0 && profile[i].first <= profile[i - 1].first)
+      return false;
+  }
+
+  std::lock_guard<std::mutex> lock(pippenger_c_profile_mutex);
+  pippenger_c_profile = profile;
+  return true;
+}
+
+std::vector<std::pair<size_t, size_t>> get_pippenger_c_profile()
+{
+  std::lock_guard<std::mutex> lock(pippenger_c_profile_mutex);
+  return pippenger_c_profile;
+}
+
+bool load_pippenger_c_profile(const std::string &filename)
+{
+  std::ifstream file(filename);
+  if (!file)
+  {
+    MERROR("Failed to open pippenger profile " << filename);
+    return false;
+  }
+
+  // one '<max N> <c>' pair per line, '#' starts a comment
+  std::vector<std::pair<size_t, size_t>> profile;
+  std::string line;
+  while (std::getline(file, line))
+  {
+    line = line.substr(0, line.find('#'));
+    std::istringstream fields(line);
+    size_t max_N, c;
+    if (!(fields >> max_N))
+      continue;
+    if (!(fields >> c))
+    {
+      MERROR("Bad line in pippenger profile " << filename << ": " << line);
+      return false;
+    }
+    profile.emplace_back(max_N, c);
+  }
+
+  if (profile.empty() || !set_pippenger_c_profile(profile))
+  {
+    MERROR("Invalid pippenger profile " << filename);
+    return false;
+  }
+  return true;
+}
+
 size_t get_pippenger_c(size_t N)
 {
+  {
+    std::lock_guard<std::mutex> lock(pippenger_c_profile_mutex);
+    if (!pippenger_c_profile.empty())
+    {
+      for (const auto &entry : pippenger_c_profile)
+      {
+        if (N <= entry.first)
+          return entry.second;
+      }
+      return pippenger_c_profile.back().second;
+    }
+  }
+
   if (N <= 13) return 2;
   if (N <= 29) return 3;
   if (N <= 83) return 4;
@@ -576,6 +795,76 @@ size_t get_pippenger_c(size_t N)
   return 9;
 }
 
+// uncached multiexp crossovers: bos-coster up to max N 'bos_coster', straus up to 'straus', pippenger above; the
+//   defaults are the bulletproofs' fixed rule (straus up to 95, no bos-coster)
+static std::atomic<size_t> multiexp_max_bos_coster_N{0};
+static std::atomic<size_t> multiexp_max_straus_N{95};
+
+bool set_multiexp_crossovers(const size_t max_bos_coster_N, const size_t max_straus_N)
+{
+  if (max_straus_N < max_bos_coster_N)
+    return false;
+
+  multiexp_max_bos_coster_N.store(max_bos_coster_N, std::memory_order_relaxed);
+  multiexp_max_straus_N.store(max_straus_N, std::memory_order_relaxed);
+  return true;
+}
+
+std::pair<size_t, size_t> get_multiexp_crossovers()
+{
+  return {multiexp_max_bos_coster_N.load(std::memory_order_relaxed),
+    multiexp_max_straus_N.load(std::memory_order_relaxed)};
+}
+
+bool load_multiexp_crossovers(const std::string &filename)
+{
+  std::ifstream file(filename);
+  if (!file)
+  {
+    MERROR("Failed to open multiexp profile " << filename);
+    return false;
+  }
+
+  // '<algorithm> <max N>' lines for bos_coster and straus, '#' starts a comment
+  std::pair<size_t, size_t> crossovers{get_multiexp_crossovers()};
+  std::string line;
+  while (std::getline(file, line))
+  {
+    line = line.substr(0, line.find('#'));
+    std::istringstream fields(line);
+    std::string algorithm;
+    size_t max_N;
+    if (!(fields >> algorithm))
+      continue;
+    if (!(fields >> max_N) || (algorithm != "bos_coster" && algorithm != "straus"))
+    {
+      MERROR("Bad line in multiexp profile " << filename << ": " << line);
+      return false;
+    }
+    if (algorithm == "bos_coster")
+      crossovers.first = max_N;
+    else
+      crossovers.second = max_N;
+  }
+
+  if (!set_multiexp_crossovers(crossovers.first, crossovers.second))
+  {
+    MERROR("Invalid multiexp profile " << filename);
+    return false;
+  }
+  return true;
+}
+
+rct::key multiexp_auto(const std::vector<MultiexpData> &data)
+{
+  const size_t N = data.size();
+  if (N <= multiexp_max_bos_coster_N.load(std::memory_order_relaxed))
+    return bos_coster_heap_conv_robust(data);
+  if (N <= multiexp_max_straus_N.load(std::memory_order_relaxed))
+    return straus(data, NULL, 0);
+  return pippenger(data, NULL, 0, get_pippenger_c(N));
+}
+
 struct pippenger_cached_data
 {
   size_t size;
@@ -603,12 +892,249 @@ std::shared_ptr<pippenger_cached_data> pippenger_init_cache(const std::vector<Mu
   return cache;
 }
 
+std::shared_ptr<pippenger_cached_data> pippenger_init_cache(const std::vector<epee::span<const ge_cached>> &cached_points)
+{
+  size_t N = 0;
+  for (const epee::span<const ge_cached> points : cached_points)
+    N += points.size();
+  std::shared_ptr<pippenger_cached_data> cache(new pippenger_cached_data());
+
+  cache->size = N;
+  cache->cached = (ge_cached*)aligned_realloc(cache->cached, N * sizeof(ge_cached), 4096);
+  CHECK_AND_ASSERT_THROW_MES(cache->cached || N == 0, "Out of memory");
+  ge_cached *position = cache->cached;
+  for (const epee::span<const ge_cached> points : cached_points)
+  {
+    if (points.empty())
+      continue;
+    memcpy(position, points.data(), points.size() * sizeof(ge_cached));
+    position += points.size();
+  }
+
+  return cache;
+}
+
 size_t pippenger_get_cache_size(const std::shared_ptr<pippenger_cached_data> &cache)
 {
   return cache->size * sizeof(*cache->cached);
 }
 
-ge_p3 pippenger_p3(const std::vector<pippenger_prep_data> &prep_data, size_t c)
+std::shared_ptr<pippenger_cached_data> pippenger_copy_cache(const pippenger_cached_data &cache)
+{
+  std::shared_ptr<pippenger_cached_data> copy(new pippenger_cached_data());
+  const size_t bytes = cache.size * sizeof(ge_cached);
+  copy->cached = (ge_cached*)aligned_malloc(bytes, 4096);
+  CHECK_AND_ASSERT_THROW_MES(copy->cached || bytes == 0, "Out of memory");
+  memcpy(copy->cached, cache.cached, bytes);
+  copy->size = cache.size;
+  return copy;
+}
+
+static std::atomic<bool> multiexp_simd_enabled{true};
+
+bool multiexp_simd_available()
+{
+  return ge_x4_avx2_supported() != 0;
+}
+
+void set_multiexp_simd(const bool enable)
+{
+  multiexp_simd_enabled = enable;
+}
+
+bool get_multiexp_simd()
+{
+  return multiexp_simd_enabled && multiexp_simd_available();
+}
+
+static std::mutex multiexp_offload_mutex;
+static multiexp_offload_backend multiexp_offload;
+static std::atomic<size_t> multiexp_offload_min_data_size{0};
+
+void set_multiexp_offload(multiexp_offload_backend backend, size_t min_data_size)
+{
+  std::lock_guard<std::mutex> lock(multiexp_offload_mutex);
+  multiexp_offload_min_data_size = backend ? std::max<size_t>(min_data_size, 1) : 0;
+  multiexp_offload = std::move(backend);
+}
+
+size_t get_multiexp_offload_min_data_size()
+{
+  return multiexp_offload_min_data_size;
+}
+
+// run a data set on the offload backend if it is large enough; false if the CPU should do it
+static bool try_multiexp_offload(const std::vector<pippenger_prep_data> &prep_data, const size_t total_data_size,
+  ge_p3 &result_out)
+{
+  // the size check is lock-free, so multiexps below the threshold don't contend on the backend mutex
+  const size_t min_data_size = multiexp_offload_min_data_size;
+  if (min_data_size == 0 || total_data_size < min_data_size)
+    return false;
+
+  multiexp_offload_backend backend;
+  {
+    std::lock_guard<std::mutex> lock(multiexp_offload_mutex);
+    backend = multiexp_offload;
+  }
+  if (!backend)
+    return false;
+
+  MULTIEXP_PERF(PERF_TIMER_UNIT(multiexp_offload, 1000000));
+  return backend(prep_data, result_out);
+}
+
+void decompress_points(const rct::keyV &keys, std::vector<ge_p3> &points_out)
+{
+  decompress_points(epee::to_span(keys), points_out);
+}
+
+void decompress_points(const epee::span<const rct::key> keys, std::vector<ge_p3> &points_out)
+{
+  points_out.resize(keys.size());
+  decompress_points(keys, points_out.data());
+}
+
+void decompress_points(const epee::span<const rct::key> keys, ge_p3 *points_out)
+{
+  static_assert(sizeof(rct::key) == 32, "keys must be packed for batch decompression");
+  if (keys.empty())
+    return;
+  CHECK_AND_ASSERT_THROW_MES(ge_frombytes_vartime_batch(points_out, keys[0].bytes, keys.size(),
+    get_multiexp_simd()) == 0, "ge_frombytes_vartime failed");
+}
+
+void scalarmult8_points(const rct::keyV &keys, std::vector<ge_p3> &points_out)
+{
+  decompress_points(keys, points_out);
+  ge_p2 p2;
+  ge_p1p1 p1;
+  for (ge_p3 &point : points_out)
+  {
+    ge_p3_to_p2(&p2, &point);
+    ge_mul8(&p1, &p2);
+    ge_p1p1_to_p3(&point, &p1);
+  }
+}
+
+// buffers kept per thread: enough for the prep data sets of one batch (one per proof type), without letting a thread
+//   that only consumes batches hoard the buffers of the threads that make them
+static constexpr size_t MULTIEXP_DATA_POOL_SIZE = 8;
+
+static std::vector<std::vector<MultiexpData>>& multiexp_data_pool()
+{
+  static thread_local std::vector<std::vector<MultiexpData>> pool;
+  return pool;
+}
+
+std::vector<MultiexpData> take_multiexp_data_buffer(size_t capacity)
+{
+  std::vector<std::vector<MultiexpData>> &pool = multiexp_data_pool();
+  std::vector<MultiexpData> buffer;
+  if (!pool.empty())
+  {
+    // smallest pooled buffer that is large enough, otherwise the largest one (it will grow once)
+    size_t best = 0;
+    for (size_t i = 1; i < pool.size(); ++i)
+    {
+      const bool fits = pool[i].capacity() >= capacity;
+      const bool best_fits = pool[best].capacity() >= capacity;
+      if ((fits && (!best_fits || pool[i].capacity() < pool[best].capacity())) ||
+          (!fits && !best_fits && pool[i].capacity() > pool[best].capacity()))
+        best = i;
+    }
+    buffer = std::move(pool[best]);
+    if (best + 1 != pool.size())
+      pool[best] = std::move(pool.back());
+    pool.pop_back();
+  }
+  buffer.clear();
+  const size_t old_capacity = buffer.capacity();
+  buffer.reserve(capacity);
+  // a fresh big buffer (e.g. a block's worth of proofs) is read back at random by pippenger: ask for huge pages
+  //   before it is filled (if they are enabled, see aligned_set_huge_pages())
+  if (buffer.capacity() != old_capacity)
+    aligned_advise_huge_pages(buffer.data(), buffer.capacity() * sizeof(MultiexpData));
+  return buffer;
+}
+
+void recycle_multiexp_data_buffer(std::vector<MultiexpData> &&buffer)
+{
+  std::vector<std::vector<MultiexpData>> &pool = multiexp_data_pool();
+  if (buffer.capacity() == 0)
+    return;
+  if (pool.capacity() < MULTIEXP_DATA_POOL_SIZE)
+    pool.reserve(MULTIEXP_DATA_POOL_SIZE);
+
+  if (pool.size() < MULTIEXP_DATA_POOL_SIZE)
+  {
+    pool.emplace_back(std::move(buffer));
+    return;
+  }
+
+  // full pool: keep the larger buffers
+  const auto smallest = std::min_element(pool.begin(), pool.end(),
+    [](const std::vector<MultiexpData> &a, const std::vector<MultiexpData> &b){ return a.capacity() < b.capacity(); });
+  if (smallest->capacity() < buffer.capacity())
+    *smallest = std::move(buffer);
+}
+
+void recycle_pippenger_prep_data(std::vector<pippenger_prep_data> &prep_data)
+{
+  for (pippenger_prep_data &data : prep_data)
+    recycle_multiexp_data_buffer(std::move(data.data));
+  prep_data.clear();
+}
+
+// pending bucket additions, applied four at a time by the SIMD backend
+// - a bucket may only appear once per batch, since the additions must be independent
+struct pippenger_bucket_batch
+{
+  ge_p3 *buckets[4];
+  const ge_cached *points[4];
+  size_t size = 0;
+
+  void push(ge_p3 &bucket, const ge_cached &point)
+  {
+    for (size_t i = 0; i < size; ++i)
+    {
+      if (buckets[i] == &bucket)
+      {
+        flush();
+        break;
+      }
+    }
+    buckets[size] = &bucket;
+    points[size] = &point;
+    if (++size == 4)
+      flush();
+  }
+
+  void flush()
+  {
+    if (size == 4)
+      ge_p3_add_cached_x4(buckets, points, 1);
+    else
+    {
+      for (size_t i = 0; i < size; ++i)
+        add(*buckets[i], *points[i]);
+    }
+    size = 0;
+  }
+};
+
+// multiexp state shared by every window of a pippenger multiexp
+struct pippenger_window_data
+{
+  const std::vector<pippenger_prep_data> *prep_data;
+  size_t c;
+  size_t groups;
+  std::vector<size_t> cache_sizes;
+  std::vector<std::shared_ptr<pippenger_cached_data>> local_caches;
+  std::vector<std::shared_ptr<pippenger_cached_data>> local_caches_2;
+};
+
+static void pippenger_prepare(const std::vector<pippenger_prep_data> &prep_data, size_t c, pippenger_window_data &windows)
 {
   // set c if undefined
   if (c == 0)
@@ -636,10 +1162,14 @@ ge_p3 pippenger_p3(const std::vector<pippenger_prep_data> &prep_data, size_t c)
     ++groups;
   groups = (groups + c - 1) / c;
 
+  windows.prep_data = &prep_data;
+  windows.c = c;
+  windows.groups = groups;
+
   // prepare caches
-  std::vector<size_t> cache_sizes;
-  std::vector<std::shared_ptr<pippenger_cached_data>> local_caches;
-  std::vector<std::shared_ptr<pippenger_cached_data>> local_caches_2;
+  std::vector<size_t> &cache_sizes = windows.cache_sizes;
+  std::vector<std::shared_ptr<pippenger_cached_data>> &local_caches = windows.local_caches;
+  std::vector<std::shared_ptr<pippenger_cached_data>> &local_caches_2 = windows.local_caches_2;
   cache_sizes.reserve(prep_data.size());
   local_caches.reserve(prep_data.size());
   local_caches_2.reserve(prep_data.size());
@@ -647,21 +1177,34 @@ ge_p3 pippenger_p3(const std::vector<pippenger_prep_data> &prep_data, size_t c)
   for (const auto &prep : prep_data)
   {
     // prepare cache for this set of prepared data
-    cache_sizes.push_back(prep.cache_size);
+    // note: without a cache, all points go in the secondary cache (don't convert them twice)
+    cache_sizes.push_back(prep.cache == NULL ? 0 : prep.cache_size);
     if (prep.cache != NULL && prep.cache_size == 0)
       cache_sizes.back() = prep.cache->size;
     CHECK_AND_ASSERT_THROW_MES(prep.cache == NULL || cache_sizes.back() <= prep.cache->size, "Cache is too small");
-    local_caches.emplace_back(prep.cache == NULL ? pippenger_init_cache(prep.data) : prep.cache);
+    local_caches.emplace_back(prep.cache);
     local_caches_2.emplace_back(prep.data.size() > cache_sizes.back() ? pippenger_init_cache(prep.data, cache_sizes.back()) : NULL);
   }
+}
+
+// evaluate windows [k_begin, k_end): result = sum_k( 2^(c*(k - k_begin)) * window_k )
+static ge_p3 pippenger_windows_p3(const pippenger_window_data &windows, const size_t k_begin, const size_t k_end)
+{
+  const std::vector<pippenger_prep_data> &prep_data = *windows.prep_data;
+  const size_t c = windows.c;
+  const std::vector<size_t> &cache_sizes = windows.cache_sizes;
+  const std::vector<std::shared_ptr<pippenger_cached_data>> &local_caches = windows.local_caches;
+  const std::vector<std::shared_ptr<pippenger_cached_data>> &local_caches_2 = windows.local_caches_2;
 
   // multiexp: combine multiexp data from multiple prepared sets
   ge_p3 result = ge_p3_identity;
   bool result_init = false;
   std::unique_ptr<ge_p3[]> buckets{new ge_p3[1<<c]};
   bool buckets_init[1<<9];
+  const bool use_simd = get_multiexp_simd();
+  pippenger_bucket_batch batch;
 
-  for (size_t k = groups; k-- > 0; )
+  for (size_t k = k_end; k-- > k_begin; )
   {
     if (result_init)
     {
@@ -695,10 +1238,13 @@ ge_p3 pippenger_p3(const std::vector<pippenger_prep_data> &prep_data, size_t c)
         CHECK_AND_ASSERT_THROW_MES(bucket < (1u<<c), "bucket overflow");
         if (buckets_init[bucket])
         {
-          if (i < cache_sizes[prep_index])
-            add(buckets[bucket], local_caches[prep_index]->cached[i]);
+          const ge_cached &point = i < cache_sizes[prep_index] ?
+            local_caches[prep_index]->cached[i] :
+            local_caches_2[prep_index]->cached[i - cache_sizes[prep_index]];
+          if (use_simd)
+            batch.push(buckets[bucket], point);
           else
-            add(buckets[bucket], local_caches_2[prep_index]->cached[i - cache_sizes[prep_index]]);
+            add(buckets[bucket], point);
         }
         else
         {
@@ -707,6 +1253,7 @@ ge_p3 pippenger_p3(const std::vector<pippenger_prep_data> &prep_data, size_t c)
         }
       }
     }
+    batch.flush();
 
     // sum the buckets
     ge_p3 pail;
@@ -739,6 +1286,283 @@ ge_p3 pippenger_p3(const std::vector<pippenger_prep_data> &prep_data, size_t c)
   return result;
 }
 
+ge_p3 pippenger_p3(const std::vector<pippenger_prep_data> &prep_data, size_t c)
+{
+  pippenger_window_data windows;
+  pippenger_prepare(prep_data, c, windows);
+
+  return pippenger_windows_p3(windows, 0, windows.groups);
+}
+
+// Multithreaded pippenger:
+//   The windows are split into contiguous ranges, one per thread, and each range is evaluated independently with its
+//   own buckets (tools::parallel_reduce). The partial results are then combined from the highest range down:
+//   result = 2^(c*len(range_t)) * result + partial_t
+//   - the ranges are not leaf tasks, so this may be called from inside a threadpool job
+#define PIPPENGER_MT_MIN_DATA_SIZE 512
+
+ge_p3 pippenger_p3_mt(const std::vector<pippenger_prep_data> &prep_data, size_t num_threads, size_t c)
+{
+  size_t total_data_size{0};
+  for (const auto &prep : prep_data)
+    total_data_size += prep.data.size();
+
+  ge_p3 offload_result;
+  if (c == 0 && try_multiexp_offload(prep_data, total_data_size, offload_result))
+    return offload_result;
+
+  tools::threadpool& tpool = tools::threadpool::getInstance();
+  if (num_threads == 0)
+    num_threads = tpool.get_max_concurrency();
+
+  // small inputs: not worth the thread overhead
+  if (num_threads <= 1 || total_data_size < PIPPENGER_MT_MIN_DATA_SIZE)
+    return pippenger_p3(prep_data, c);
+
+  MULTIEXP_PERF(PERF_TIMER_UNIT(pippenger_p3_mt, 1000000));
+  pippenger_window_data windows;
+  pippenger_prepare(prep_data, c, windows);
+
+  num_threads = std::min(num_threads, windows.groups);
+  if (num_threads <= 1)
+    return pippenger_windows_p3(windows, 0, windows.groups);
+
+  // evaluate window ranges, highest first, so combining them doubles once per window
+  struct partial_result { ge_p3 p; size_t num_windows; };
+  const size_t groups = windows.groups;
+  partial_result result{ge_p3(), 0};
+  const bool r = tools::parallel_reduce(0, groups, (groups + num_threads - 1) / num_threads, result,
+    [&windows, groups](const size_t begin, const size_t end) -> partial_result {
+      return {pippenger_windows_p3(windows, groups - end, groups - begin), end - begin};
+    },
+    [&windows](partial_result high, const partial_result &low) -> partial_result {
+      if (high.num_windows == 0)
+        return low;
+      const size_t shift = windows.c * low.num_windows;
+      ge_p2 p2;
+      ge_p1p1 p1;
+      ge_p3_to_p2(&p2, &high.p);
+      for (size_t i = 0; i < shift; ++i)
+      {
+        ge_p2_dbl(&p1, &p2);
+        if (i == shift - 1)
+          ge_p1p1_to_p3(&high.p, &p1);
+        else
+          ge_p1p1_to_p2(&p2, &p1);
+      }
+      add(high.p, low.p);
+      high.num_windows += low.num_windows;
+      return high;
+    });
+  CHECK_AND_ASSERT_THROW_MES(r, "Multithreaded pippenger failed");
+
+  return result.p;
+}
+
+// Failure localization for batched pippenger checks:
+//   Each segment (e.g. the data of one tx or one proof) must carry its own random weights, so that any set of valid
+//   segments sums to the identity. A failed set is split in half; if the first half passes then the second half must
+//   fail and isn't checked again. One bad segment out of n costs about 1 + log2(n) multiexps.
+static bool pippenger_segments_sum_to_identity(const std::vector<std::vector<pippenger_prep_data>> &segments,
+  size_t begin, size_t end, size_t num_threads)
+{
+  std::vector<pippenger_prep_data> prep_data;
+  size_t data_size = 0;
+  for (size_t i = begin; i < end; ++i)
+  {
+    for (const pippenger_prep_data &segment_data: segments[i])
+    {
+      prep_data.push_back(segment_data);
+      data_size += segment_data.data.size();
+    }
+  }
+  if (data_size == 0)
+    return true;
+
+  const ge_p3 result = pippenger_p3_mt(prep_data, num_threads);
+  return ge_p3_is_point_at_infinity_vartime(&result) != 0;
+}
+
+static void pippenger_bisect_failed_segments(const std::vector<std::vector<pippenger_prep_data>> &segments,
+  size_t begin, size_t end, size_t num_threads, std::vector<size_t> &failing_segments)
+{
+  if (end - begin == 1)
+  {
+    failing_segments.push_back(begin);
+    return;
+  }
+
+  const size_t middle = begin + (end - begin) / 2;
+  if (pippenger_segments_sum_to_identity(segments, begin, middle, num_threads))
+  {
+    pippenger_bisect_failed_segments(segments, middle, end, num_threads, failing_segments);
+    return;
+  }
+
+  pippenger_bisect_failed_segments(segments, begin, middle, num_threads, failing_segments);
+  if (!pippenger_segments_sum_to_identity(segments, middle, end, num_threads))
+    pippenger_bisect_failed_segments(segments, middle, end, num_threads, failing_segments);
+}
+
+std::vector<size_t> pippenger_find_failing_segments(const std::vector<std::vector<pippenger_prep_data>> &segments,
+  size_t num_threads)
+{
+  std::vector<size_t> failing_segments;
+  if (segments.empty() || pippenger_segments_sum_to_identity(segments, 0, segments.size(), num_threads))
+    return failing_segments;
+
+  pippenger_bisect_failed_segments(segments, 0, segments.size(), num_threads, failing_segments);
+  return failing_segments;
+}
+
+// Fixed-base multiexp:
+//   For each base P, precompute the shifts 2^(8*j) * P, j = [0, 32). A scalar is recoded into 32 signed 8-bit
+//   digits, so s*P = sum_j( e_j * 2^(8*j)*P ). All shifted points for all bases share one set of 128 buckets
+//   (bucket[|e| - 1] += sign(e) * 2^(8*j)*P), and the buckets are summed once at the end. There are no doublings,
+//   and each base costs at most 32 additions.
+#define FIXED_BASE_C 8
+#define FIXED_BASE_WINDOWS (256/FIXED_BASE_C)
+#define FIXED_BASE_BUCKETS (1<<(FIXED_BASE_C-1))
+
+struct fixed_base_cached_data
+{
+  size_t size;
+  ge_cached *shifted;
+  fixed_base_cached_data(): size(0), shifted(NULL) {}
+  ~fixed_base_cached_data() { aligned_free(shifted); }
+};
+
+std::shared_ptr<fixed_base_cached_data> fixed_base_init_cache(const std::vector<ge_p3> &bases)
+{
+  MULTIEXP_PERF(PERF_TIMER_START_UNIT(fixed_base_init_cache, 1000000));
+  std::shared_ptr<fixed_base_cached_data> cache(new fixed_base_cached_data());
+
+  cache->size = bases.size();
+  cache->shifted = (ge_cached*)aligned_realloc(cache->shifted, bases.size() * FIXED_BASE_WINDOWS * sizeof(ge_cached), 4096);
+  CHECK_AND_ASSERT_THROW_MES(cache->shifted, "Out of memory");
+
+  ge_p1p1 p1;
+  ge_p2 p2;
+  for (size_t i = 0; i < bases.size(); ++i)
+  {
+    ge_p3 shifted_p3 = bases[i];
+    for (size_t j = 0; j < FIXED_BASE_WINDOWS; ++j)
+    {
+      ge_p3_to_cached(&cache->shifted[i*FIXED_BASE_WINDOWS + j], &shifted_p3);
+      if (j + 1 == FIXED_BASE_WINDOWS)
+        break;
+
+      // 2^8 * P
+      ge_p3_to_p2(&p2, &shifted_p3);
+      for (size_t k = 0; k < FIXED_BASE_C; ++k)
+      {
+        ge_p2_dbl(&p1, &p2);
+        if (k == FIXED_BASE_C - 1)
+          ge_p1p1_to_p3(&shifted_p3, &p1);
+        else
+          ge_p1p1_to_p2(&p2, &p1);
+      }
+    }
+  }
+
+  MULTIEXP_PERF(PERF_TIMER_STOP(fixed_base_init_cache));
+  return cache;
+}
+
+size_t fixed_base_get_cache_size(const std::shared_ptr<fixed_base_cached_data> &cache)
+{
+  return cache->size * FIXED_BASE_WINDOWS * sizeof(*cache->shifted);
+}
+
+std::shared_ptr<fixed_base_cached_data> fixed_base_copy_cache(const fixed_base_cached_data &cache)
+{
+  std::shared_ptr<fixed_base_cached_data> copy(new fixed_base_cached_data());
+  const size_t bytes = cache.size * FIXED_BASE_WINDOWS * sizeof(ge_cached);
+  copy->shifted = (ge_cached*)aligned_malloc(bytes, 4096);
+  CHECK_AND_ASSERT_THROW_MES(copy->shifted || bytes == 0, "Out of memory");
+  memcpy(copy->shifted, cache.shifted, bytes);
+  copy->size = cache.size;
+  return copy;
+}
+
+ge_p3 fixed_base_multiexp_p3(const std::vector<rct::key> &scalars, const std::shared_ptr<fixed_base_cached_data> &cache)
+{
+  CHECK_AND_ASSERT_THROW_MES(cache != NULL, "Fixed-base multiexp requires a cache");
+  CHECK_AND_ASSERT_THROW_MES(scalars.size() <= cache->size, "Cache is too small");
+  MULTIEXP_PERF(PERF_TIMER_UNIT(fixed_base_multiexp, 1000000));
+
+  ge_p3 buckets[FIXED_BASE_BUCKETS];
+  bool buckets_init[FIXED_BASE_BUCKETS];
+  memset(buckets_init, 0, sizeof(buckets_init));
+
+  ge_p1p1 p1;
+  int digits[FIXED_BASE_WINDOWS];
+  for (size_t i = 0; i < scalars.size(); ++i)
+  {
+    // signed radix-2^8 recoding: digits in [-128, 128)
+    // - requires s < 2^255 so the final carry fits in the top digit
+    const unsigned char *bytes = scalars[i].bytes;
+    CHECK_AND_ASSERT_THROW_MES((bytes[31] & 0x80) == 0, "Fixed-base multiexp scalar is too large");
+    int carry = 0;
+    for (size_t j = 0; j < FIXED_BASE_WINDOWS; ++j)
+    {
+      digits[j] = bytes[j] + carry;
+      carry = (digits[j] + FIXED_BASE_BUCKETS) >> FIXED_BASE_C;
+      digits[j] -= carry << FIXED_BASE_C;
+    }
+    digits[FIXED_BASE_WINDOWS - 1] += carry << FIXED_BASE_C;
+
+    for (size_t j = 0; j < FIXED_BASE_WINDOWS; ++j)
+    {
+      const int digit = digits[j];
+      if (digit == 0)
+        continue;
+      const size_t bucket = (digit > 0 ? digit : -digit) - 1;
+      if (!buckets_init[bucket])
+      {
+        buckets[bucket] = ge_p3_identity;
+        buckets_init[bucket] = true;
+      }
+      if (digit > 0)
+        ge_add(&p1, &buckets[bucket], &cache->shifted[i*FIXED_BASE_WINDOWS + j]);
+      else
+        ge_sub(&p1, &buckets[bucket], &cache->shifted[i*FIXED_BASE_WINDOWS + j]);
+      ge_p1p1_to_p3(&buckets[bucket], &p1);
+    }
+  }
+
+  // sum the buckets: result = sum_d( d * bucket[d - 1] )
+  ge_p3 result = ge_p3_identity;
+  ge_p3 pail;
+  bool pail_init = false;
+  bool result_init = false;
+  for (size_t i = FIXED_BASE_BUCKETS; i-- > 0; )
+  {
+    if (buckets_init[i])
+    {
+      if (pail_init)
+        add(pail, buckets[i]);
+      else
+      {
+        pail = buckets[i];
+        pail_init = true;
+      }
+    }
+    if (pail_init)
+    {
+      if (result_init)
+        add(result, pail);
+      else
+      {
+        result = pail;
+        result_init = true;
+      }
+    }
+  }
+
+  return result;
+}
+
 ge_p3 pippenger_p3(std::vector<MultiexpData> data, const std::shared_ptr<pippenger_cached_data> &cache, const size_t cache_size, const size_t c)
 {
   std::vector<pippenger_prep_data> prep_data;
@@ -753,6 +1577,10 @@ ge_p3 pippenger_p3(const std::vector<pippenger_prep_data> &prep_data)
   for (const auto &prep : prep_data)
     total_data_size += prep.data.size();
 
+  ge_p3 offload_result;
+  if (try_multiexp_offload(prep_data, total_data_size, offload_result))
+    return offload_result;
+
   return pippenger_p3(prep_data, get_pippenger_c(total_data_size));
 }
 
@@ -33,6 +33,14 @@
 #ifndef MULTIEXP_H
 #define MULTIEXP_H
 
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 #include "crypto/crypto.h"
 #include "rctTypes.h"
@@ -55,6 +63,7 @@ struct MultiexpData {
 
 struct straus_cached_data;
 struct pippenger_cached_data;
+struct fixed_base_cached_data;
 
 struct pippenger_prep_data final
 {
@@ -63,20 +72,114 @@ struct pippenger_prep_data final
   size_t cache_size;
 };
 
+struct straus_point_cache_stats final
+{
+  uint64_t hits{0};
+  uint64_t misses{0};
+  uint64_t evictions{0};
+  // time spent making multiples for missed points, and the estimated time hits saved (hits * average miss cost)
+  uint64_t precompute_ns{0};
+  uint64_t saved_ns{0};
+
+  double hit_rate() const { return hits + misses > 0 ? static_cast<double>(hits) / (hits + misses) : 0.0; }
+};
+
+// Bounded, thread-safe LRU cache of straus precomputed multiples for points that recur across multiexps (e.g. ledger
+// outputs that appear in many reference sets), keyed by a caller-chosen id (e.g. a ledger index)
+class straus_point_cache final
+{
+public:
+  static constexpr uint64_t NO_ID{static_cast<uint64_t>(-1)};
+
+  explicit straus_point_cache(const size_t max_points): m_max_points(max_points) {}
+
+  size_t max_points() const { return m_max_points; }
+  size_t size() const;
+  void clear();
+  straus_point_cache_stats get_stats() const;
+  void reset_stats();
+
+private:
+  struct entry;
+  using entry_ptr = std::shared_ptr<const entry>;
+
+  friend ge_p3 straus_p3(const std::vector<MultiexpData> &data, const std::vector<uint64_t> &point_ids,
+    straus_point_cache &point_cache, size_t STEP);
+
+  entry_ptr find(const uint64_t id);
+  void insert(const uint64_t id, entry_ptr multiples, const uint64_t precompute_ns);
+
+  const size_t m_max_points;
+  mutable std::mutex m_mutex;
+  std::list<uint64_t> m_order;  // most recently used at the front
+  std::unordered_map<uint64_t, std::pair<entry_ptr, std::list<uint64_t>::iterator>> m_entries;
+  straus_point_cache_stats m_stats;
+};
+
 rct::key bos_coster_heap_conv(std::vector<MultiexpData> data);
 rct::key bos_coster_heap_conv_robust(std::vector<MultiexpData> data);
 std::shared_ptr<straus_cached_data> straus_init_cache(const std::vector<MultiexpData> &data, size_t N =0);
 size_t straus_get_cache_size(const std::shared_ptr<straus_cached_data> &cache);
+// deep copy of a cache, e.g. for a per NUMA node replica (see tools::numa_replicated)
+std::shared_ptr<straus_cached_data> straus_copy_cache(const straus_cached_data &cache);
 ge_p3 straus_p3(const std::vector<MultiexpData> &data, const std::shared_ptr<straus_cached_data> &cache = NULL, size_t STEP = 0);
 rct::key straus(const std::vector<MultiexpData> &data, const std::shared_ptr<straus_cached_data> &cache = NULL, size_t STEP = 0);
+// straus with multiples taken from (and added to) 'point_cache'; point_ids[i] is data[i]'s id (NO_ID: not cached)
+ge_p3 straus_p3(const std::vector<MultiexpData> &data, const std::vector<uint64_t> &point_ids, straus_point_cache &point_cache, size_t STEP = 0);
 std::shared_ptr<pippenger_cached_data> pippenger_init_cache(const std::vector<MultiexpData> &data, size_t start_offset = 0, size_t N =0);
+// cache from points that are already in cached form (e.g. kept by a ledger), concatenated in order: for data sets whose
+//   first elements are those points (no conversions, only a copy)
+std::shared_ptr<pippenger_cached_data> pippenger_init_cache(const std::vector<epee::span<const ge_cached>> &cached_points);
 size_t pippenger_get_cache_size(const std::shared_ptr<pippenger_cached_data> &cache);
+std::shared_ptr<pippenger_cached_data> pippenger_copy_cache(const pippenger_cached_data &cache);
 size_t get_pippenger_c(size_t N);
+// replace get_pippenger_c()'s built-in thresholds with a tuned profile of (max N, c) pairs (empty restores them)
+bool set_pippenger_c_profile(const std::vector<std::pair<size_t, size_t>> &profile);
+std::vector<std::pair<size_t, size_t>> get_pippenger_c_profile();
+bool load_pippenger_c_profile(const std::string &filename);
+// uncached multiexp with the fastest algorithm for its size: bos-coster for N <= max_bos_coster_N, straus for
+//   N <= max_straus_N, pippenger above (see --calibrate-multiexp in the performance tests for measured crossovers)
+rct::key multiexp_auto(const std::vector<MultiexpData> &data);
+bool set_multiexp_crossovers(const size_t max_bos_coster_N, const size_t max_straus_N);
+std::pair<size_t, size_t> get_multiexp_crossovers();
+bool load_multiexp_crossovers(const std::string &filename);
 ge_p3 pippenger_p3(const std::vector<pippenger_prep_data> &prep_data, size_t c);
 ge_p3 pippenger_p3(std::vector<MultiexpData> data, const std::shared_ptr<pippenger_cached_data> &cache = NULL, const size_t cache_size = 0, const size_t c = 0);
 ge_p3 pippenger_p3(const std::vector<pippenger_prep_data> &prep_data);
 rct::key pippenger(std::vector<MultiexpData> data, const std::shared_ptr<pippenger_cached_data> &cache = NULL, const size_t cache_size = 0, const size_t c = 0);
 rct::key pippenger(const std::vector<pippenger_prep_data> &prep_data);
+ge_p3 pippenger_p3_mt(const std::vector<pippenger_prep_data> &prep_data, size_t num_threads = 0, size_t c = 0);
+std::vector<size_t> pippenger_find_failing_segments(const std::vector<std::vector<pippenger_prep_data>> &segments, size_t num_threads = 0);
+std::shared_ptr<fixed_base_cached_data> fixed_base_init_cache(const std::vector<ge_p3> &bases);
+size_t fixed_base_get_cache_size(const std::shared_ptr<fixed_base_cached_data> &cache);
+std::shared_ptr<fixed_base_cached_data> fixed_base_copy_cache(const fixed_base_cached_data &cache);
+ge_p3 fixed_base_multiexp_p3(const std::vector<rct::key> &scalars, const std::shared_ptr<fixed_base_cached_data> &cache);
+// SIMD backend for pippenger bucket additions (on by default when the CPU supports it)
+bool multiexp_simd_available();
+void set_multiexp_simd(const bool enable);
+bool get_multiexp_simd();
+// offload backend for very large multiexps (e.g. a GPU pippenger), selected at runtime
+// - pippenger_p3(prep_data) and pippenger_p3_mt(prep_data, num_threads) (without an explicit c) hand data sets of at
+//   least 'min_data_size' points to the backend; smaller data sets, and data sets the backend declines (it returns
+//   false), run on the CPU
+// - an empty backend removes the current one
+typedef std::function<bool(const std::vector<pippenger_prep_data> &prep_data, ge_p3 &result_out)> multiexp_offload_backend;
+void set_multiexp_offload(multiexp_offload_backend backend, size_t min_data_size);
+// smallest data set handed to the offload backend (0 if there is no backend)
+size_t get_multiexp_offload_min_data_size();
+// decompress a batch of points (four at a time with the SIMD backend); throws if any key is not a valid point
+void decompress_points(const rct::keyV &keys, std::vector<ge_p3> &points_out);
+void decompress_points(const epee::span<const rct::key> keys, std::vector<ge_p3> &points_out);
+// as above, into storage for keys.size() points (e.g. one chunk of a larger batch)
+void decompress_points(const epee::span<const rct::key> keys, ge_p3 *points_out);
+// as decompress_points(), then multiply each point by 8
+void scalarmult8_points(const rct::keyV &keys, std::vector<ge_p3> &points_out);
+// per-thread pool of multiexp data buffers, so verification data can be assembled in the storage of consumed batches
+// - take: an empty buffer with at least the requested capacity (reuses a pooled buffer if there is one)
+// - recycle: give a buffer (or the data of consumed prep data sets) back to the calling thread's pool
+std::vector<MultiexpData> take_multiexp_data_buffer(size_t capacity);
+void recycle_multiexp_data_buffer(std::vector<MultiexpData> &&buffer);
+void recycle_pippenger_prep_data(std::vector<pippenger_prep_data> &prep_data);
 
 }
 
@@ -567,11 +567,43 @@ namespace rct {
         sc_reduce32(hash.bytes);
     }
 
+    void hash_to_scalar_batch(keyV &hashes, const std::vector<std::string> &data) {
+        hashes.resize(data.size());
+
+        std::vector<const uint8_t*> in;
+        std::vector<size_t> inlen;
+        std::vector<uint8_t*> md;
+        in.reserve(data.size());
+        inlen.reserve(data.size());
+        md.reserve(data.size());
+        for (size_t i = 0; i < data.size(); ++i) {
+            in.push_back(reinterpret_cast<const uint8_t*>(data[i].data()));
+            inlen.push_back(data[i].size());
+            md.push_back(hashes[i].bytes);
+        }
+
+        keccak_batch(in.data(), inlen.data(), md.data(), data.size());
+        for (key &hash : hashes)
+            sc_reduce32(hash.bytes);
+    }
+
     //cn_fast_hash for a 32 byte key
     void cn_fast_hash(key & hash, const key & in) {
         keccak((const uint8_t *)in.bytes, 32, hash.bytes, 32);
     }
     
+    hash_prefix::hash_prefix(const key *keys, const size_t n) {
+        keccak_init(&ctx);
+        keccak_update(&ctx, (const uint8_t *)keys, n * sizeof(key));
+    }
+
+    void hash_prefix::hash_to_scalar(key &hash, const key *suffix, const size_t n) const {
+        KECCAK_CTX round = ctx;
+        keccak_update(&round, (const uint8_t *)suffix, n * sizeof(key));
+        keccak_finish(&round, hash.bytes);
+        sc_reduce32(hash.bytes);
+    }
+
     void hash_to_scalar(key & hash, const key & in) {
         cn_fast_hash(hash, in);
         sc_reduce32(hash.bytes);
@@ -176,6 +176,18 @@ namespace rct {
     //for ANSL
     key cn_fast_hash(const key64 keys);
     key hash_to_scalar(const key64 keys);
+    //hash_to_scalar for many independent inputs (hashed four at a time with SIMD keccak where available)
+    void hash_to_scalar_batch(keyV &hashes, const std::vector<std::string> &data);
+    //hash_to_scalar of a fixed run of keys followed by a varying suffix: the prefix is
+    //absorbed once and every hash resumes from a copy of the saved keccak state
+    class hash_prefix
+    {
+    public:
+        hash_prefix(const key *keys, const size_t n);
+        void hash_to_scalar(key &hash, const key *suffix, const size_t n) const;
+    private:
+        KECCAK_CTX ctx;
+    };
 
     void hash_to_p3(ge_p3 &hash8_p3, const key &k);
 
@@ -78,6 +78,25 @@ namespace
 
         return rct::Bulletproof{rct::keyV(n_outs, I), I, I, I, I, I, I, rct::keyV(nrl, I), rct::keyV(nrl, I), I, I, I};
     }
+
+    // run job(i) for i in [0, num_jobs) on the threadpool, each job writing only its own output slots
+    // - hardware devices keep state between the calls of one proof, so they (and single jobs) run serially
+    template <typename F>
+    void run_proving_jobs(const size_t num_jobs, hw::device &hwdev, const F &job)
+    {
+        if (num_jobs <= 1 || hwdev.get_type() != hw::device::device_type::SOFTWARE)
+        {
+            for (size_t i = 0; i < num_jobs; ++i)
+                job(i);
+            return;
+        }
+
+        tools::threadpool& tpool = tools::threadpool::getInstance();
+        tools::threadpool::waiter waiter(tpool);
+        for (size_t i = 0; i < num_jobs; ++i)
+            tpool.submit(&waiter, [&job, i] { job(i); });
+        CHECK_AND_ASSERT_THROW_MES(waiter.wait(), "Failed to make proofs in the thread pool");
+    }
 }
 
 namespace rct {
@@ -264,7 +283,17 @@ namespace rct {
             c_to_hash[2*n+3] = aG;
             c_to_hash[2*n+4] = aH;
         }
-        hwdev.clsag_hash(c_to_hash,c);
+
+        // Every round shares the domain, P, C, C_offset and message prefix
+        const bool prefix_hash = hwdev.has_clsag_hash_prefix();
+        const hash_prefix c_prefix(c_to_hash.data(), prefix_hash ? 2*n+3 : 0);
+        const auto round_hash = [&](key &out) {
+            if (prefix_hash)
+                c_prefix.hash_to_scalar(out, &c_to_hash[2*n+3], 2);
+            else
+                hwdev.clsag_hash(c_to_hash, out);
+        };
+        round_hash(c);
         
         size_t i;
         i = (l + 1) % n;
@@ -303,7 +332,7 @@ namespace rct {
 
             c_to_hash[2*n+3] = L;
             c_to_hash[2*n+4] = R;
-            hwdev.clsag_hash(c_to_hash,c_new);
+            round_hash(c_new);
             copy(c,c_new);
             
             i = (i + 1) % n;
@@ -826,6 +855,68 @@ namespace rct {
         catch (...) { return false; }
     }
 
+    constexpr size_t hash_to_p3_cache::DEFAULT_MAX_POINTS;
+
+    void hash_to_p3_cache::get(ge_dsmp precomp, const key &P) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            const auto it = m_entries.find(P);
+            if (it != m_entries.end())
+            {
+                ++m_stats.hits;
+                m_order.splice(m_order.begin(), m_order, it->second.second);
+                memcpy(precomp, it->second.first.precomp, sizeof(ge_dsmp));
+                return;
+            }
+            ++m_stats.misses;
+        }
+
+        // hash outside the lock, so other verifiers are not held up by a miss
+        entry fresh;
+        ge_p3 hash8_p3;
+        hash_to_p3(hash8_p3, P);
+        ge_dsm_precomp(fresh.precomp, &hash8_p3);
+        memcpy(precomp, fresh.precomp, sizeof(ge_dsmp));
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_max_points == 0 || m_entries.find(P) != m_entries.end())
+            return;
+        if (m_entries.size() >= m_max_points)
+        {
+            m_entries.erase(m_order.back());
+            m_order.pop_back();
+            ++m_stats.evictions;
+        }
+        m_order.push_front(P);
+        m_entries.emplace(P, std::make_pair(fresh, m_order.begin()));
+    }
+
+    size_t hash_to_p3_cache::size() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_entries.size();
+    }
+
+    void hash_to_p3_cache::clear() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_entries.clear();
+        m_order.clear();
+    }
+
+    hash_to_p3_cache_stats hash_to_p3_cache::get_stats() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_stats;
+    }
+
+    void hash_to_p3_cache::reset_stats() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stats = hash_to_p3_cache_stats{};
+    }
+
+    hash_to_p3_cache &get_hash_to_p3_cache() {
+        static hash_to_p3_cache cache;
+        return cache;
+    }
+
     bool verRctCLSAGSimple(const key &message, const clsag &sig, const ctkeyV & pubs, const key & C_offset) {
         try
         {
@@ -891,6 +982,7 @@ namespace rct {
             }
             c_to_hash[2*n+1] = C_offset;
             c_to_hash[2*n+2] = message;
+            const hash_prefix c_prefix(c_to_hash.data(), 2*n+3);
             key c_p; // = c[i]*mu_P
             key c_c; // = c[i]*mu_C
             key c_new;
@@ -899,7 +991,7 @@ namespace rct {
             geDsmp P_precomp;
             geDsmp C_precomp;
             size_t i = 0;
-            ge_p3 hash8_p3;
+            hash_to_p3_cache &hp_cache = get_hash_to_p3_cache();
             geDsmp hash_precomp;
             ge_p3 temp_p3;
             ge_p1p1 temp_p1;
@@ -921,13 +1013,12 @@ namespace rct {
                 addKeys_aGbBcC(L,sig.s[i],c_p,P_precomp.k,c_c,C_precomp.k);
 
                 // Compute R
-                hash_to_p3(hash8_p3,pubs[i].dest);
-                ge_dsm_precomp(hash_precomp.k, &hash8_p3);
+                hp_cache.get(hash_precomp.k, pubs[i].dest);
                 addKeys_aAbBcC(R,sig.s[i],hash_precomp.k,c_p,I_precomp.k,c_c,D_precomp.k);
 
                 c_to_hash[2*n+3] = L;
                 c_to_hash[2*n+4] = R;
-                c_new = hash_to_scalar(c_to_hash);
+                c_prefix.hash_to_scalar(c_new, &c_to_hash[2*n+3], 2);
                 CHECK_AND_ASSERT_MES(!(c_new == rct::zero()), false, "Bad signature hash");
                 copy(c,c_new);
 
@@ -1149,35 +1240,50 @@ namespace rct {
                     outSk[i].mask = masks[i];
                 }
             }
-            else while (amounts_proved < n_amounts)
+            else
             {
-                size_t batch_size = 1;
-                if (rct_config.range_proof_type == RangeProofMultiOutputBulletproof)
-                  while (batch_size * 2 + amounts_proved <= n_amounts && batch_size * 2 <= BULLETPROOF_MAX_OUTPUTS)
-                    batch_size *= 2;
-                rct::keyV C, masks;
-                std::vector<uint64_t> batch_amounts(batch_size);
-                for (i = 0; i < batch_size; ++i)
-                  batch_amounts[i] = outamounts[i + amounts_proved];
-                if (hwdev.get_mode() == hw::device::TRANSACTION_CREATE_FAKE)
+                // lay out the batches, then prove them in parallel (each one into its own slot)
+                std::vector<std::pair<size_t, size_t>> batches; // first amount, batch size
+                while (amounts_proved < n_amounts)
                 {
-                    // use a fake bulletproof for speed
-                    rv.p.bulletproofs.push_back(make_dummy_bulletproof(batch_amounts, C, masks));
+                    size_t batch_size = 1;
+                    if (rct_config.range_proof_type == RangeProofMultiOutputBulletproof)
+                      while (batch_size * 2 + amounts_proved <= n_amounts && batch_size * 2 <= BULLETPROOF_MAX_OUTPUTS)
+                        batch_size *= 2;
+                    batches.emplace_back(amounts_proved, batch_size);
+                    amounts_proved += batch_size;
                 }
-                else
+
+                rv.p.bulletproofs.resize(batches.size());
+                std::vector<rct::keyV> batch_C(batches.size()), batch_masks(batches.size());
+                run_proving_jobs(batches.size(), hwdev, [&](const size_t b)
                 {
-                    const epee::span<const key> keys{&amount_keys[amounts_proved], batch_size};
-                    rv.p.bulletproofs.push_back(proveRangeBulletproof(C, masks, batch_amounts, keys, hwdev));
-                #ifdef DBG
-                    CHECK_AND_ASSERT_THROW_MES(verBulletproof(rv.p.bulletproofs.back()), "verBulletproof failed on newly created proof");
-                #endif
-                }
-                for (i = 0; i < batch_size; ++i)
+                    const size_t first = batches[b].first;
+                    const size_t batch_size = batches[b].second;
+                    const std::vector<uint64_t> batch_amounts(outamounts.begin() + first, outamounts.begin() + first + batch_size);
+                    if (hwdev.get_mode() == hw::device::TRANSACTION_CREATE_FAKE)
+                    {
+                        // use a fake bulletproof for speed
+                        rv.p.bulletproofs[b] = make_dummy_bulletproof(batch_amounts, batch_C[b], batch_masks[b]);
+                    }
+                    else
+                    {
+                        const epee::span<const key> keys{&amount_keys[first], batch_size};
+                        rv.p.bulletproofs[b] = proveRangeBulletproof(batch_C[b], batch_masks[b], batch_amounts, keys, hwdev);
+                    #ifdef DBG
+                        CHECK_AND_ASSERT_THROW_MES(verBulletproof(rv.p.bulletproofs[b]), "verBulletproof failed on newly created proof");
+                    #endif
+                    }
+                });
+
+                for (size_t b = 0; b < batches.size(); ++b)
                 {
-                  rv.outPk[i + amounts_proved].mask = rct::scalarmult8(C[i]);
-                  outSk[i + amounts_proved].mask = masks[i];
+                    for (i = 0; i < batches[b].second; ++i)
+                    {
+                      rv.outPk[i + batches[b].first].mask = rct::scalarmult8(batch_C[b][i]);
+                      outSk[i + batches[b].first].mask = batch_masks[b][i];
+                    }
                 }
-                amounts_proved += batch_size;
             }
         }
 
@@ -1220,17 +1326,19 @@ namespace rct {
             msout->c.resize(inamounts.size());
             msout->mu_p.resize(rv.type == RCTTypeCLSAG ? inamounts.size() : 0);
         }
-        for (i = 0 ; i < inamounts.size(); i++)
+        // the ring signatures are independent given the pseudo-outs and the message (which covers the range proofs),
+        //   so sign the inputs in parallel
+        run_proving_jobs(inamounts.size(), hwdev, [&](const size_t in)
         {
             if (rv.type == RCTTypeCLSAG)
             {
-                rv.p.CLSAGs[i] = proveRctCLSAGSimple(full_message, rv.mixRing[i], inSk[i], a[i], pseudoOuts[i], kLRki ? &(*kLRki)[i]: NULL, msout ? &msout->c[i] : NULL, msout ? &msout->mu_p[i] : NULL, index[i], hwdev);
+                rv.p.CLSAGs[in] = proveRctCLSAGSimple(full_message, rv.mixRing[in], inSk[in], a[in], pseudoOuts[in], kLRki ? &(*kLRki)[in]: NULL, msout ? &msout->c[in] : NULL, msout ? &msout->mu_p[in] : NULL, index[in], hwdev);
             }
             else
             {
-                rv.p.MGs[i] = proveRctMGSimple(full_message, rv.mixRing[i], inSk[i], a[i], pseudoOuts[i], kLRki ? &(*kLRki)[i]: NULL, msout ? &msout->c[i] : NULL, index[i], hwdev);
+                rv.p.MGs[in] = proveRctMGSimple(full_message, rv.mixRing[in], inSk[in], a[in], pseudoOuts[in], kLRki ? &(*kLRki)[in]: NULL, msout ? &msout->c[in] : NULL, index[in], hwdev);
             }
-        }
+        });
         return rv;
     }
 
@@ -1438,6 +1546,38 @@ namespace rct {
       return verRctSemanticsSimple(std::vector<const rctSig*>(1, &rv));
     }
 
+    // [begin, end) is known to hold at least one failing rctSig
+    static void bisectRctSemanticsSimpleFailures(const std::vector<const rctSig*> & rvv, size_t begin, size_t end, std::vector<size_t> &failures)
+    {
+      if (end - begin == 1)
+      {
+        failures.push_back(begin);
+        return;
+      }
+
+      // if the first half passes, the failure must be in the second half, which then needs no check of its own
+      const size_t middle = begin + (end - begin) / 2;
+      if (verRctSemanticsSimple(std::vector<const rctSig*>(rvv.begin() + begin, rvv.begin() + middle)))
+      {
+        bisectRctSemanticsSimpleFailures(rvv, middle, end, failures);
+        return;
+      }
+
+      bisectRctSemanticsSimpleFailures(rvv, begin, middle, failures);
+      if (!verRctSemanticsSimple(std::vector<const rctSig*>(rvv.begin() + middle, rvv.begin() + end)))
+        bisectRctSemanticsSimpleFailures(rvv, middle, end, failures);
+    }
+
+    std::vector<size_t> findRctSemanticsSimpleFailures(const std::vector<const rctSig*> & rvv, bool batch_failed)
+    {
+      std::vector<size_t> failures;
+      if (rvv.empty() || (!batch_failed && verRctSemanticsSimple(rvv)))
+        return failures;
+
+      bisectRctSemanticsSimpleFailures(rvv, 0, rvv.size(), failures);
+      return failures;
+    }
+
     //ver RingCT simple
     //assumes only post-rct style inputs (at least for max anonymity)
     bool verRctNonSemanticsSimple(const rctSig & rv) {
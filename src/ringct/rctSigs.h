@@ -36,6 +36,10 @@
 #define RCTSIGS_H
 
 #include <cstddef>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <unordered_map>
 #include <vector>
 #include <tuple>
 
@@ -82,6 +86,46 @@ namespace rct {
     clsag proveRctCLSAGSimple(const key &, const ctkeyV &, const ctkey &, const key &, const key &, const multisig_kLRki *, key *, key *, unsigned int, hw::device &);
     bool verRctCLSAGSimple(const key &, const clsag &, const ctkeyV &, const key &);
 
+    struct hash_to_p3_cache_stats
+    {
+        uint64_t hits{0};
+        uint64_t misses{0};
+        uint64_t evictions{0};
+
+        double hit_rate() const { return hits + misses > 0 ? static_cast<double>(hits) / (hits + misses) : 0.0; }
+    };
+
+    //Bounded, thread-safe LRU cache of precomputed Hp(P) (the key image base of output P), since popular
+    //   ring members are hashed to a point again in every ring that references them
+    class hash_to_p3_cache
+    {
+    public:
+        static constexpr size_t DEFAULT_MAX_POINTS = 8192;  // ~10 MB of ge_dsmp
+
+        explicit hash_to_p3_cache(const size_t max_points = DEFAULT_MAX_POINTS): m_max_points(max_points) {}
+
+        //precomp = ge_dsm_precomp(hash_to_p3(P)), from the cache if P was seen recently
+        void get(ge_dsmp precomp, const key &P);
+
+        size_t max_points() const { return m_max_points; }
+        size_t size() const;
+        void clear();
+        hash_to_p3_cache_stats get_stats() const;
+        void reset_stats();
+
+    private:
+        struct entry { ge_dsmp precomp; };
+
+        const size_t m_max_points;
+        mutable std::mutex m_mutex;
+        std::list<key> m_order;  // most recently used at the front
+        std::unordered_map<key, std::pair<entry, std::list<key>::iterator>> m_entries;
+        hash_to_p3_cache_stats m_stats;
+    };
+
+    //the cache used by verRctCLSAGSimple
+    hash_to_p3_cache &get_hash_to_p3_cache();
+
     //proveRange and verRange
     //proveRange gives C, and mask such that \sumCi = C
     //   c.f. https://eprint.iacr.org/2015/1098 section 5.1
@@ -131,6 +175,10 @@ namespace rct {
     static inline bool verRct(const rctSig & rv) { return verRct(rv, true) && verRct(rv, false); }
     bool verRctSemanticsSimple(const rctSig & rv);
     bool verRctSemanticsSimple(const std::vector<const rctSig*> & rv);
+    // indices (in order) of the rctSigs in rv that fail verRctSemanticsSimple(), found by bisecting the batch:
+    //   k failures among n cost O(k log n) batch verifications instead of n single ones
+    //   batch_failed: the caller already saw verRctSemanticsSimple(rv) fail, so it is not verified again
+    std::vector<size_t> findRctSemanticsSimpleFailures(const std::vector<const rctSig*> & rv, bool batch_failed = false);
     bool verRctNonSemanticsSimple(const rctSig & rv);
     static inline bool verRctSimple(const rctSig & rv) { return verRctSemanticsSimple(rv) && verRctNonSemanticsSimple(rv); }
     xmr_amount decodeRct(const rctSig & rv, const key & sk, unsigned int i, key & mask, hw::device &hwdev);
@@ -32,6 +32,9 @@
 #include "cryptonote_config.h"
 #include "rctTypes.h"
 #include "int-util.h"
+
+#include <algorithm>
+
 using namespace crypto;
 using namespace std;
 
@@ -40,6 +43,20 @@ using namespace std;
 
 namespace rct {
 
+    KeyMatrix::KeyMatrix(const keyM &rows) : KeyMatrix(rows.size(), rows.empty() ? 0 : rows[0].size()) {
+        for (size_t i = 0; i < m_rows; i++) {
+            CHECK_AND_ASSERT_THROW_MES(rows[i].size() == m_cols, "KeyMatrix rows must all be the same size");
+            std::copy(rows[i].begin(), rows[i].end(), m_keys.begin() + i*m_cols);
+        }
+    }
+
+    keyM KeyMatrix::to_keyM() const {
+        keyM rows(m_rows);
+        for (size_t i = 0; i < m_rows; i++)
+            rows[i].assign(m_keys.begin() + i*m_cols, m_keys.begin() + (i + 1)*m_cols);
+        return rows;
+    }
+
     //dp 
     //Debug printing for the above types
     //Actually use DP(value) and #define DBG    
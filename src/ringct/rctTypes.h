@@ -89,6 +89,44 @@ namespace rct {
     typedef std::vector<key> keyV; //vector of keys
     typedef std::vector<keyV> keyM; //matrix of keys (indexed by column first)
 
+    //matrix of keys in one row-major allocation (rows are spans into it)
+    // - cheaper than keyM for hot paths: no per-row allocations, and the rows are adjacent in memory
+    // - reshaping with resize() keeps the allocation, so a KeyMatrix can be reused as scratch space
+    class KeyMatrix {
+    public:
+        KeyMatrix() : m_rows{0}, m_cols{0} {}
+        KeyMatrix(const std::size_t rows, const std::size_t cols) : m_keys(rows*cols), m_rows{rows}, m_cols{cols} {}
+        //copy a rectangular keyM (throws if the rows differ in size)
+        explicit KeyMatrix(const keyM &rows);
+
+        std::size_t rows() const { return m_rows; }
+        std::size_t cols() const { return m_cols; }
+        bool empty() const { return m_rows == 0; }
+
+        epee::span<key> operator[](const std::size_t row) { return {m_keys.data() + row*m_cols, m_cols}; }
+        epee::span<const key> operator[](const std::size_t row) const { return {m_keys.data() + row*m_cols, m_cols}; }
+
+        //all keys, row after row
+        key *data() { return m_keys.data(); }
+        const key *data() const { return m_keys.data(); }
+        std::size_t size() const { return m_keys.size(); }
+
+        //reshape (existing contents are not preserved in any meaningful layout)
+        void resize(const std::size_t rows, const std::size_t cols) { m_keys.resize(rows*cols); m_rows = rows; m_cols = cols; }
+        void clear() { m_keys.clear(); m_rows = 0; m_cols = 0; }
+
+        keyM to_keyM() const;
+
+        bool operator==(const KeyMatrix &other) const
+        { return m_rows == other.m_rows && m_cols == other.m_cols && m_keys == other.m_keys; }
+        bool operator!=(const KeyMatrix &other) const { return !(*this == other); }
+
+    private:
+        keyV m_keys;
+        std::size_t m_rows;
+        std::size_t m_cols;
+    };
+
     //containers For CT operations
     //if it's  representing a private ctkey then "dest" contains the secret key of the address
     // while "mask" contains a where C = aG + bH is CT pedersen commitment and b is the amount
@@ -356,12 +394,8 @@ namespace rct {
             PREPARE_CUSTOM_VECTOR_SERIALIZATION(inputs, pseudoOuts);
             if (pseudoOuts.size() != inputs)
               return false;
-            for (size_t i = 0; i < inputs; ++i)
-            {
-              FIELDS(pseudoOuts[i])
-              if (inputs - i > 1)
-                ar.delimit_array();
-            }
+            if (!::do_serialize_blob_array(ar, pseudoOuts.data(), inputs))
+              return false;
             ar.end_array();
           }
 
@@ -492,12 +526,8 @@ namespace rct {
               PREPARE_CUSTOM_VECTOR_SERIALIZATION(mixin + 1, CLSAGs[i].s);
               if (CLSAGs[i].s.size() != mixin + 1)
                 return false;
-              for (size_t j = 0; j <= mixin; ++j)
-              {
-                FIELDS(CLSAGs[i].s[j])
-                if (mixin + 1 - j > 1)
-                  ar.delimit_array();
-              }
+              if (!::do_serialize_blob_array(ar, CLSAGs[i].s.data(), mixin + 1))
+                return false;
               ar.end_array();
 
               ar.tag("c1");
@@ -542,12 +572,8 @@ namespace rct {
                 PREPARE_CUSTOM_VECTOR_SERIALIZATION(mg_ss2_elements, MGs[i].ss[j]);
                 if (MGs[i].ss[j].size() != mg_ss2_elements)
                   return false;
-                for (size_t k = 0; k < mg_ss2_elements; ++k)
-                {
-                  FIELDS(MGs[i].ss[j][k])
-                  if (mg_ss2_elements - k > 1)
-                    ar.delimit_array();
-                }
+                if (!::do_serialize_blob_array(ar, MGs[i].ss[j].data(), mg_ss2_elements))
+                  return false;
                 ar.end_array();
   
                 if (mixin + 1 - j > 1)
@@ -572,12 +598,8 @@ namespace rct {
             PREPARE_CUSTOM_VECTOR_SERIALIZATION(inputs, pseudoOuts);
             if (pseudoOuts.size() != inputs)
               return false;
-            for (size_t i = 0; i < inputs; ++i)
-            {
-              FIELDS(pseudoOuts[i])
-              if (inputs - i > 1)
-                ar.delimit_array();
-            }
+            if (!::do_serialize_blob_array(ar, pseudoOuts.data(), inputs))
+              return false;
             ar.end_array();
           }
           return ar.good();
@@ -556,7 +556,7 @@ namespace rct
     }
 
     // Verify a batch of Triptych proofs with common input keys
-    bool triptych_verify(const keyV &M, const keyV &P, const keyV &C_offsets, const std::vector<const TriptychProof *> &proofs, const size_t n, const size_t m, const keyV &messages)
+    pippenger_prep_data get_triptych_verification_data(const keyV &M, const keyV &P, const keyV &C_offsets, const std::vector<const TriptychProof *> &proofs, const size_t n, const size_t m, const keyV &messages)
     {
         // Global checks
         CHECK_AND_ASSERT_THROW_MES(n > 1, "Must have n > 1!");
@@ -813,9 +813,18 @@ namespace rct
             data.push_back({temp,proof.J});
         }
 
-        // Final check
         CHECK_AND_ASSERT_THROW_MES(data.size() == (m*n + 1) + (2*N + 2) + N_proofs*(2*m + 7), "Final proof data is incorrect size!");
-        ge_p3 result = pippenger_p3(data,cache,m*n,get_pippenger_c(data.size()));
+
+        // The first m*n elements are the cached Hi generators
+        return pippenger_prep_data{std::move(data), cache, m*n};
+    }
+
+    bool triptych_verify(const keyV &M, const keyV &P, const keyV &C_offsets, const std::vector<const TriptychProof *> &proofs, const size_t n, const size_t m, const keyV &messages)
+    {
+        const pippenger_prep_data prep_data = get_triptych_verification_data(M,P,C_offsets,proofs,n,m,messages);
+
+        // Final check
+        ge_p3 result = pippenger_p3(prep_data.data,prep_data.cache,prep_data.cache_size,get_pippenger_c(prep_data.data.size()));
         if (ge_p3_is_point_at_infinity_vartime(&result) == 0)
         {
             MERROR("Triptych verification failed!");
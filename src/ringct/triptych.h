@@ -35,6 +35,8 @@
 
 namespace rct
 {
+    struct pippenger_prep_data;
+
     // Invert a nonzero scalar
     key invert(const key &x);
 
@@ -43,5 +45,7 @@ namespace rct
 
     TriptychProof triptych_prove(const keyV &, const keyV &, const key &, const size_t, const key &, const key &, const size_t, const size_t, const key &);
     bool triptych_verify(const keyV &, const keyV &, const keyV &, const std::vector<const TriptychProof *> &, const size_t, const size_t, const keyV &);
+    // Get the final check data of a batch of proofs over one reference set, to combine with other batches (throws on malformed proofs)
+    pippenger_prep_data get_triptych_verification_data(const keyV &, const keyV &, const keyV &, const std::vector<const TriptychProof *> &, const size_t, const size_t, const keyV &);
 }
 
@@ -0,0 +1,189 @@
+// Copyright (c) 2021, The Monero Project
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of
+//    conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list
+//    of conditions and the following disclaimer in the documentation and/or other
+//    materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be
+//    used to endorse or promote products derived from this software without specific
+//    prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+// THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <cstring>
+
+#include "storages/portable_storage_base.h"
+#include "storages/portable_storage_bin_utils.h"
+#include "storages/portable_storage_to_bin.h"
+#include "blocks_bin_writer.h"
+
+// Entries of a portable_storage section are stored sorted by name, so the
+// writers below emit them in that order too, and skip the ones the KV maps
+// skip (empty containers, optional fields at their default).
+
+namespace
+{
+  void write_bytes(epee::byte_stream &out, const epee::span<const uint8_t> bytes)
+  {
+    if (!bytes.empty())
+      out.write(bytes);
+  }
+
+  void write_name(epee::byte_stream &out, const char *name)
+  {
+    const size_t len = strlen(name);
+    out.put(static_cast<uint8_t>(len));
+    out.write(name, len);
+  }
+
+  void write_uint64(epee::byte_stream &out, const char *name, const uint64_t value)
+  {
+    write_name(out, name);
+    out.put(SERIALIZE_TYPE_UINT64);
+    const uint64_t v = CONVERT_POD(value);
+    out.write(reinterpret_cast<const char*>(&v), sizeof(v));
+  }
+
+  void write_bool(epee::byte_stream &out, const char *name, const bool value)
+  {
+    write_name(out, name);
+    out.put(SERIALIZE_TYPE_BOOL);
+    out.put(value ? 1 : 0);
+  }
+
+  void write_string_value(epee::byte_stream &out, const epee::span<const uint8_t> first, const epee::span<const uint8_t> second = {})
+  {
+    epee::serialization::pack_varint(out, first.size() + second.size());
+    write_bytes(out, first);
+    write_bytes(out, second);
+  }
+
+  void write_string(epee::byte_stream &out, const char *name, const epee::span<const uint8_t> value)
+  {
+    write_name(out, name);
+    out.put(SERIALIZE_TYPE_STRING);
+    write_string_value(out, value);
+  }
+
+  void write_array(epee::byte_stream &out, const char *name, const uint8_t type, const size_t count)
+  {
+    write_name(out, name);
+    out.put(type | SERIALIZE_FLAG_ARRAY);
+    epee::serialization::pack_varint(out, count);
+  }
+
+  void write_block(epee::byte_stream &out, const cryptonote::block_blob_refs &block, const bool pruned)
+  {
+    // block_weight is left at 0, and so not stored
+    epee::serialization::pack_varint(out, 1 + (pruned ? 1 : 0) + (block.txs.empty() ? 0 : 1));
+    write_string(out, "block", block.block);
+    if (pruned)
+      write_bool(out, "pruned", true);
+    if (block.txs.empty())
+      return;
+
+    if (pruned)
+    {
+      write_array(out, "txs", SERIALIZE_TYPE_OBJECT, block.txs.size());
+      for (const cryptonote::tx_blob_ref &tx: block.txs)
+      {
+        epee::serialization::pack_varint(out, 2);
+        write_string(out, "blob", tx.pruned);
+        write_string(out, "prunable_hash", epee::as_byte_span(crypto::null_hash));
+      }
+    }
+    else
+    {
+      write_array(out, "txs", SERIALIZE_TYPE_STRING, block.txs.size());
+      for (const cryptonote::tx_blob_ref &tx: block.txs)
+        write_string_value(out, tx.pruned, tx.prunable);
+    }
+  }
+
+  void write_output_indices(epee::byte_stream &out, const std::vector<cryptonote::COMMAND_RPC_GET_BLOCKS_FAST::block_output_indices> &output_indices)
+  {
+    write_array(out, "output_indices", SERIALIZE_TYPE_OBJECT, output_indices.size());
+    for (const auto &block_indices: output_indices)
+    {
+      epee::serialization::pack_varint(out, block_indices.indices.empty() ? 0 : 1);
+      if (block_indices.indices.empty())
+        continue;
+      write_array(out, "indices", SERIALIZE_TYPE_OBJECT, block_indices.indices.size());
+      for (const auto &tx_indices: block_indices.indices)
+      {
+        epee::serialization::pack_varint(out, tx_indices.indices.empty() ? 0 : 1);
+        if (tx_indices.indices.empty())
+          continue;
+        write_array(out, "indices", SERIALIZE_TYPE_UINT64, tx_indices.indices.size());
+        for (uint64_t index: tx_indices.indices)
+        {
+          index = CONVERT_POD(index);
+          out.write(reinterpret_cast<const char*>(&index), sizeof(index));
+        }
+      }
+    }
+  }
+}
+
+namespace cryptonote
+{
+  //------------------------------------------------------------------------------------------------------------------------------
+  void write_get_blocks_fast_response(epee::byte_stream &out, const COMMAND_RPC_GET_BLOCKS_FAST::response &res,
+      const std::vector<block_blob_refs> &blocks, bool pruned)
+  {
+    // reserve once: blobs dominate, plus a generous allowance for names, tags and indices
+    size_t reserve = 256;
+    for (const block_blob_refs &block: blocks)
+    {
+      reserve += block.block.size() + 32;
+      for (const tx_blob_ref &tx: block.txs)
+        reserve += tx.pruned.size() + tx.prunable.size() + (pruned ? 64 : 8);
+    }
+    for (const auto &block_indices: res.output_indices)
+    {
+      reserve += 32;
+      for (const auto &tx_indices: block_indices.indices)
+        reserve += 32 + tx_indices.indices.size() * sizeof(uint64_t);
+    }
+    out.reserve(reserve);
+
+    const uint32_t signature_a = SWAP32LE(PORTABLE_STORAGE_SIGNATUREA);
+    const uint32_t signature_b = SWAP32LE(PORTABLE_STORAGE_SIGNATUREB);
+    out.write(reinterpret_cast<const char*>(&signature_a), sizeof(signature_a));
+    out.write(reinterpret_cast<const char*>(&signature_b), sizeof(signature_b));
+    out.put(PORTABLE_STORAGE_FORMAT_VER);
+
+    epee::serialization::pack_varint(out, 6 + (blocks.empty() ? 0 : 1) + (res.output_indices.empty() ? 0 : 1));
+    if (!blocks.empty())
+    {
+      write_array(out, "blocks", SERIALIZE_TYPE_OBJECT, blocks.size());
+      for (const block_blob_refs &block: blocks)
+        write_block(out, block, pruned);
+    }
+    write_uint64(out, "credits", res.credits);
+    write_uint64(out, "current_height", res.current_height);
+    if (!res.output_indices.empty())
+      write_output_indices(out, res.output_indices);
+    write_uint64(out, "start_height", res.start_height);
+    write_string(out, "status", epee::strspan<uint8_t>(res.status));
+    write_string(out, "top_hash", epee::strspan<uint8_t>(res.top_hash));
+    write_bool(out, "untrusted", res.untrusted);
+  }
+  //------------------------------------------------------------------------------------------------------------------------------
+}
@@ -0,0 +1,55 @@
+// Copyright (c) 2021, The Monero Project
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of
+//    conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list
+//    of conditions and the following disclaimer in the documentation and/or other
+//    materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be
+//    used to endorse or promote products derived from this software without specific
+//    prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+// THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <vector>
+
+#include "byte_stream.h"
+#include "blockchain_db/blockchain_db.h"
+#include "core_rpc_server_commands_defs.h"
+
+namespace cryptonote
+{
+  /**
+   * @brief writes a /get_blocks.bin response in epee's binary format, reading the blobs in place
+   *
+   * The output is what epee::serialization::store_t_to_binary() produces for
+   * `res` with its blocks filled from `blocks`, but the blobs are written
+   * straight from the spans (e.g. database pages) instead of first being
+   * copied into the response and then into a portable_storage tree.
+   * `res.blocks` is ignored; all other fields are written from `res`.
+   *
+   * @param out the stream to append to
+   * @param res the response's other fields
+   * @param blocks the blocks and their transactions' blobs
+   * @param pruned whether to write pruned tx blobs
+   */
+  void write_get_blocks_fast_response(epee::byte_stream &out, const COMMAND_RPC_GET_BLOCKS_FAST::response &res,
+      const std::vector<block_blob_refs> &blocks, bool pruned);
+}
@@ -41,6 +41,8 @@ using namespace epee;
 #include "common/download.h"
 #include "common/util.h"
 #include "common/perf_timer.h"
+#include "common/metrics.h"
+#include "common/threadpool.h"
 #include "int-util.h"
 #include "cryptonote_basic/cryptonote_format_utils.h"
 #include "cryptonote_basic/account.h"
@@ -51,6 +53,8 @@ using namespace epee;
 #include "net/parse.h"
 #include "storages/http_abstract_invoke.h"
 #include "crypto/hash.h"
+#include "rpc/blocks_bin_writer.h"
+#include "rpc/json_response_writer.h"
 #include "rpc/rpc_args.h"
 #include "rpc/rpc_handler.h"
 #include "rpc/rpc_payment_costs.h"
@@ -89,6 +93,7 @@ namespace
       uint64_t count;
       uint64_t time;
       uint64_t credits;
+      time_t since; //!< when it was first called since the last clear
     };
 
     RPCTracker(const char *rpc, tools::LoggingPerformanceTimer &timer): rpc(rpc), timer(timer) {
@@ -98,7 +103,8 @@ namespace
       {
         boost::unique_lock<boost::mutex> lock(mutex);
         auto &e = tracker[rpc];
-        ++e.count;
+        if (e.count++ == 0)
+          e.since = time(NULL);
         e.time += timer.value();
       }
       catch (...) { /* ignore */ }
@@ -162,6 +168,7 @@ namespace cryptonote
     command_line::add_arg(desc, arg_rpc_payment_difficulty);
     command_line::add_arg(desc, arg_rpc_payment_credits);
     command_line::add_arg(desc, arg_rpc_payment_allow_free_loopback);
+    command_line::add_arg(desc, arg_perf_histograms);
   }
   //------------------------------------------------------------------------------------------------------------------------------
   core_rpc_server::core_rpc_server(
@@ -173,6 +180,7 @@ namespace cryptonote
     , m_was_bootstrap_ever_used(false)
     , disable_rpc_ban(false)
     , m_rpc_payment_allow_free_loopback(false)
+    , m_output_distribution_bin_cache_uses(0)
   {}
   //------------------------------------------------------------------------------------------------------------------------------
   bool core_rpc_server::set_bootstrap_daemon(
@@ -289,6 +297,8 @@ namespace cryptonote
       }
     }
     disable_rpc_ban = rpc_config->disable_rpc_ban;
+    if (command_line::get_arg(vm, arg_perf_histograms))
+      tools::set_performance_timer_histograms(true);
     const std::string data_dir{command_line::get_arg(vm, cryptonote::arg_data_dir)};
     std::string address = command_line::get_arg(vm, arg_rpc_payment_address);
     if (!address.empty() && allow_rpc_payment)
@@ -534,6 +544,16 @@ namespace cryptonote
     res.version = restricted ? "" : MONERO_VERSION_FULL;
     res.synchronized = check_core_ready();
     res.busy_syncing = m_p2p.get_payload_object().is_busy_syncing();
+    if (!restricted)
+    {
+      const sync_batch_stats sync_stats = m_core.get_blockchain_storage().get_sync_batch_stats();
+      res.sync_batch_blocks = sync_stats.batch_blocks;
+      res.sync_blocks_per_second = sync_stats.blocks_per_second;
+      res.db_commit_ms_histogram = sync_stats.commit_ms_histogram;
+      uint64_t block_hashes_calculated, block_hashes_cached;
+      get_hash_stats(res.tx_hashes_calculated, res.tx_hashes_cached, res.tx_prefix_hashes_calculated, res.tx_prefix_hashes_cached,
+          block_hashes_calculated, block_hashes_cached);
+    }
 
     res.status = CORE_RPC_STATUS_OK;
     return true;
@@ -668,6 +688,83 @@ namespace cryptonote
     res.status = CORE_RPC_STATUS_OK;
     return true;
   }
+  //------------------------------------------------------------------------------------------------------------------------------
+  bool core_rpc_server::on_get_blocks_bin(const COMMAND_RPC_GET_BLOCKS_FAST::request& req, epee::byte_slice& body, const connection_context *ctx)
+  {
+    bool use_bootstrap_daemon;
+    {
+      boost::shared_lock<boost::shared_mutex> lock(m_bootstrap_daemon_mutex);
+      use_bootstrap_daemon = m_should_use_bootstrap_daemon;
+    }
+    if (!use_bootstrap_daemon && !m_rpc_payment && get_blocks_in_place(req, body, ctx))
+      return true;
+
+    // bootstrap daemons, payments, failures and databases which can't reference blobs take the generic path
+    COMMAND_RPC_GET_BLOCKS_FAST::response res = AUTO_VAL_INIT(res);
+    if (!on_get_blocks(req, res, ctx))
+      return false;
+    return epee::serialization::store_t_to_binary(res, body, 64 * 1024);
+  }
+  //------------------------------------------------------------------------------------------------------------------------------
+  bool core_rpc_server::get_blocks_in_place(const COMMAND_RPC_GET_BLOCKS_FAST::request& req, epee::byte_slice& body, const connection_context *ctx)
+  {
+    // the noop answer is left to on_get_blocks
+    if (!req.block_ids.empty())
+    {
+      uint64_t last_block_height;
+      crypto::hash last_block_hash;
+      m_core.get_blockchain_top(last_block_height, last_block_hash);
+      if (last_block_hash == req.block_ids.front())
+        return false;
+    }
+
+    RPC_TRACKER(get_blocks_in_place);
+
+    // the blobs are written to the response straight from the database's pages, which are only valid inside the callback
+    size_t size = 0, ntxes = 0, nblocks = 0;
+    const bool r = m_core.get_blockchain_storage().find_blockchain_supplement(req.start_height, req.block_ids, req.prune, !req.no_miner_tx, COMMAND_RPC_GET_BLOCKS_FAST_MAX_BLOCK_COUNT, COMMAND_RPC_GET_BLOCKS_FAST_MAX_TX_COUNT,
+        [&](uint64_t current_height, uint64_t start_height, const std::vector<block_blob_refs> &bs) {
+      COMMAND_RPC_GET_BLOCKS_FAST::response res = AUTO_VAL_INIT(res);
+      res.current_height = current_height;
+      res.start_height = start_height;
+      res.output_indices.reserve(bs.size());
+      for (const block_blob_refs &bd: bs)
+      {
+        size += bd.block.size();
+        res.output_indices.push_back(COMMAND_RPC_GET_BLOCKS_FAST::block_output_indices());
+        ntxes += bd.txs.size();
+        res.output_indices.back().indices.reserve(1 + bd.txs.size());
+        if (req.no_miner_tx)
+          res.output_indices.back().indices.push_back(COMMAND_RPC_GET_BLOCKS_FAST::tx_output_indices());
+        for (const tx_blob_ref &tx: bd.txs)
+          size += tx.pruned.size() + tx.prunable.size();
+
+        const size_t n_txes_to_lookup = bd.txs.size() + (req.no_miner_tx ? 0 : 1);
+        if (n_txes_to_lookup > 0)
+        {
+          std::vector<std::vector<uint64_t>> indices;
+          bool r = m_core.get_tx_outputs_gindexs(req.no_miner_tx ? bd.txs.front().hash : bd.miner_tx_hash, n_txes_to_lookup, indices);
+          if (!r || indices.size() != n_txes_to_lookup)
+            return false;
+          for (size_t i = 0; i < indices.size(); ++i)
+            res.output_indices.back().indices.push_back({std::move(indices[i])});
+        }
+      }
+      nblocks = bs.size();
+
+      res.status = CORE_RPC_STATUS_OK;
+      epee::byte_stream out;
+      write_get_blocks_fast_response(out, res, bs, req.prune);
+      body = epee::byte_slice{std::move(out)};
+      return true;
+    });
+    if (!r)
+      return false;
+
+    MDEBUG("on_get_blocks: " << nblocks << " blocks, " << ntxes << " txes, size " << size << ", in place");
+    return true;
+  }
+  //------------------------------------------------------------------------------------------------------------------------------
     bool core_rpc_server::on_get_alt_blocks_hashes(const COMMAND_RPC_GET_ALT_BLOCKS_HASHES::request& req, COMMAND_RPC_GET_ALT_BLOCKS_HASHES::response& res, const connection_context *ctx)
     {
       RPC_TRACKER(get_alt_blocks_hashes);
@@ -786,6 +883,10 @@ namespace cryptonote
       return true;
     }
 
+    uint64_t cache_hits, cache_misses;
+    m_core.get_blockchain_storage().get_output_lookup_cache_stats(cache_hits, cache_misses);
+    MDEBUG("on_get_outs_bin: " << req.outputs.size() << " outs, output cache " << cache_hits << " hits, " << cache_misses << " misses so far");
+
     res.status = CORE_RPC_STATUS_OK;
     return true;
   }
@@ -857,6 +958,17 @@ namespace cryptonote
     return true;
   }
   //------------------------------------------------------------------------------------------------------------------------------
+  bool core_rpc_server::on_get_transactions_json(const COMMAND_RPC_GET_TRANSACTIONS::request& req, epee::byte_slice& body, const connection_context *ctx)
+  {
+    COMMAND_RPC_GET_TRANSACTIONS::response res = AUTO_VAL_INIT(res);
+    if (!on_get_transactions(req, res, ctx))
+      return false;
+    epee::byte_stream out;
+    write_get_transactions_response(out, res);
+    body = epee::byte_slice{std::move(out)};
+    return true;
+  }
+  //------------------------------------------------------------------------------------------------------------------------------
   bool core_rpc_server::on_get_transactions(const COMMAND_RPC_GET_TRANSACTIONS::request& req, COMMAND_RPC_GET_TRANSACTIONS::response& res, const connection_context *ctx)
   {
     RPC_TRACKER(get_transactions);
@@ -1540,6 +1652,17 @@ namespace cryptonote
     return true;
   }
   //------------------------------------------------------------------------------------------------------------------------------
+  bool core_rpc_server::on_get_transaction_pool_json(const COMMAND_RPC_GET_TRANSACTION_POOL::request& req, epee::byte_slice& body, const connection_context *ctx)
+  {
+    COMMAND_RPC_GET_TRANSACTION_POOL::response res = AUTO_VAL_INIT(res);
+    if (!on_get_transaction_pool(req, res, ctx))
+      return false;
+    epee::byte_stream out;
+    write_get_transaction_pool_response(out, res);
+    body = epee::byte_slice{std::move(out)};
+    return true;
+  }
+  //------------------------------------------------------------------------------------------------------------------------------
   bool core_rpc_server::on_get_transaction_pool(const COMMAND_RPC_GET_TRANSACTION_POOL::request& req, COMMAND_RPC_GET_TRANSACTION_POOL::response& res, const connection_context *ctx)
   {
     RPC_TRACKER(get_transaction_pool);
@@ -3143,6 +3266,21 @@ namespace cryptonote
     bool r;
     if (use_bootstrap_daemon_if_necessary<COMMAND_RPC_GET_TRANSACTION_POOL_BACKLOG>(invoke_http_mode::JON_RPC, "get_txpool_backlog", req, res, r))
       return r;
+    if (req.fee_histogram)
+    {
+      std::vector<tx_backlog_fee_bucket> histogram;
+      if (!m_core.get_txpool_backlog_histogram(histogram))
+      {
+        error_resp.code = CORE_RPC_ERROR_CODE_INTERNAL_ERROR;
+        error_resp.message = "Failed to get txpool backlog histogram";
+        return false;
+      }
+      CHECK_PAYMENT_MIN1(req, res, COST_PER_TX_POOL_STATS * histogram.size(), false);
+      res.fee_histogram = std::move(histogram);
+      res.status = CORE_RPC_STATUS_OK;
+      return true;
+    }
+
     size_t n_txes = m_core.get_pool_transactions_count();
     CHECK_PAYMENT_MIN1(req, res, COST_PER_TX_POOL_STATS * n_txes, false);
 
@@ -3197,7 +3335,60 @@ namespace cryptonote
     return true;
   }
   //------------------------------------------------------------------------------------------------------------------------------
-  bool core_rpc_server::on_get_output_distribution_bin(const COMMAND_RPC_GET_OUTPUT_DISTRIBUTION::request& req, COMMAND_RPC_GET_OUTPUT_DISTRIBUTION::response& res, const connection_context *ctx)
+  bool core_rpc_server::on_get_output_distribution_bin(const COMMAND_RPC_GET_OUTPUT_DISTRIBUTION::request& req, epee::byte_slice& body, const connection_context *ctx)
+  {
+    bool use_bootstrap_daemon;
+    {
+      boost::shared_lock<boost::shared_mutex> lock(m_bootstrap_daemon_mutex);
+      use_bootstrap_daemon = m_should_use_bootstrap_daemon;
+    }
+
+    // wallets all ask for the same distributions, so identical requests get the same bytes until the chain changes
+    // - payments and bootstrap daemons make responses per client, so those aren't cached
+    const bool cacheable = !use_bootstrap_daemon && !m_rpc_payment && req.binary;
+    uint64_t to_height = req.to_height;
+    crypto::hash top_hash = crypto::null_hash;
+    static const size_t max_cached = 16;
+    if (cacheable)
+    {
+      uint64_t top_height;
+      m_core.get_blockchain_top(top_height, top_hash);
+      if (to_height == 0)
+        to_height = top_height;
+      const boost::lock_guard<boost::mutex> lock(m_output_distribution_bin_cache_lock);
+      for (output_distribution_bin_cache_entry &e: m_output_distribution_bin_cache)
+      {
+        if (e.top_hash == top_hash && e.amounts == req.amounts && e.from_height == req.from_height && e.to_height == to_height && e.cumulative == req.cumulative && e.compress == req.compress)
+        {
+          e.last_used = ++m_output_distribution_bin_cache_uses;
+          body = e.body.clone();
+          return true;
+        }
+      }
+    }
+
+    // the cached body has to cover the heights it's looked up by
+    COMMAND_RPC_GET_OUTPUT_DISTRIBUTION::request resolved_req = req;
+    resolved_req.to_height = to_height;
+    COMMAND_RPC_GET_OUTPUT_DISTRIBUTION::response res = AUTO_VAL_INIT(res);
+    if (!get_output_distribution_bin(resolved_req, res, ctx))
+      return false;
+    if (!epee::serialization::store_t_to_binary(res, body))
+      return false;
+
+    if (cacheable && res.status == CORE_RPC_STATUS_OK)
+    {
+      const boost::lock_guard<boost::mutex> lock(m_output_distribution_bin_cache_lock);
+      auto &cache = m_output_distribution_bin_cache;
+      cache.erase(std::remove_if(cache.begin(), cache.end(), [&top_hash](const output_distribution_bin_cache_entry &e) { return e.top_hash != top_hash; }), cache.end());
+      if (cache.size() >= max_cached)
+        cache.erase(std::min_element(cache.begin(), cache.end(), [](const output_distribution_bin_cache_entry &e0, const output_distribution_bin_cache_entry &e1) { return e0.last_used < e1.last_used; }));
+      cache.push_back({req.amounts, req.from_height, to_height, req.cumulative, req.compress, top_hash, ++m_output_distribution_bin_cache_uses, body.clone()});
+    }
+    return true;
+  }
+  //------------------------------------------------------------------------------------------------------------------------------
+  bool core_rpc_server::get_output_distribution_bin(const COMMAND_RPC_GET_OUTPUT_DISTRIBUTION::request& req, COMMAND_RPC_GET_OUTPUT_DISTRIBUTION::response& res, const connection_context *ctx)
   {
     RPC_TRACKER(get_output_distribution_bin);
 
@@ -3343,6 +3534,68 @@ namespace cryptonote
     return true;
   }
   //------------------------------------------------------------------------------------------------------------------------------
+  bool core_rpc_server::on_perf_histograms(const COMMAND_RPC_PERF_HISTOGRAMS::request& req, COMMAND_RPC_PERF_HISTOGRAMS::response& res, epee::json_rpc::error& error_resp, const connection_context *ctx)
+  {
+    RPC_TRACKER(perf_histograms);
+    if (req.mode == "on" || req.mode == "off")
+      tools::set_performance_timer_histograms(req.mode == "on");
+    else if (!req.mode.empty())
+    {
+      error_resp.code = CORE_RPC_ERROR_CODE_WRONG_PARAM;
+      error_resp.message = "Invalid mode, expected \"on\" or \"off\"";
+      return false;
+    }
+
+    // report what was gathered before clearing it
+    for (const tools::PerformanceTimerHistogram &h: tools::get_performance_timer_histograms())
+    {
+      res.histograms.push_back({h.name, h.cat, h.count, h.total_ns, {}});
+      for (size_t b = 0; b < h.buckets.size(); ++b)
+        if (h.buckets[b])
+          res.histograms.back().buckets.push_back({tools::performance_timer_bucket_limit_ns(b), h.buckets[b]});
+    }
+    if (req.clear)
+      tools::clear_performance_timer_histograms();
+
+    res.enabled = tools::performance_timer_histograms_enabled();
+    res.status = CORE_RPC_STATUS_OK;
+    return true;
+  }
+  //------------------------------------------------------------------------------------------------------------------------------
+  bool core_rpc_server::on_metrics(const epee::net_utils::http::http_request_info& query_info, epee::net_utils::http::http_response_info& response_info, const connection_context *ctx)
+  {
+    RPC_TRACKER(metrics);
+    tools::PrometheusWriter writer;
+
+    writer.gauge("monero_height", "Height of the blockchain", m_core.get_current_blockchain_height());
+    writer.gauge("monero_txpool_transactions", "Transactions in the pool", m_core.get_pool_transactions_count(true));
+
+    tools::threadpool &tpool = tools::threadpool::getInstance();
+    writer.gauge("monero_threadpool_threads", "Threads in the global threadpool", tpool.get_max_concurrency());
+    writer.gauge("monero_threadpool_queue_length", "Tasks submitted to the global threadpool and not yet started", tpool.get_queue_length());
+
+    uint64_t packets, bytes;
+    {
+      CRITICAL_REGION_LOCAL(epee::net_utils::network_throttle_manager::m_lock_get_global_throttle_in);
+      epee::net_utils::network_throttle_manager::get_global_throttle_in().get_stats(packets, bytes);
+    }
+    writer.counter("monero_p2p_received_bytes_total", "Bytes received on levin (P2P) connections", bytes);
+    writer.counter("monero_p2p_received_packets_total", "Packets received on levin (P2P) connections", packets);
+    {
+      CRITICAL_REGION_LOCAL(epee::net_utils::network_throttle_manager::m_lock_get_global_throttle_out);
+      epee::net_utils::network_throttle_manager::get_global_throttle_out().get_stats(packets, bytes);
+    }
+    writer.counter("monero_p2p_sent_bytes_total", "Bytes sent on levin (P2P) connections", bytes);
+    writer.counter("monero_p2p_sent_packets_total", "Packets sent on levin (P2P) connections", packets);
+
+    // tx batch sizes and times, LMDB write txns, and the PERF_TIMERs (ring signature and range proof checks among them)
+    tools::write_metrics(writer);
+
+    response_info.m_mime_tipe = "text/plain; version=0.0.4";
+    response_info.m_body = writer.str();
+    return true;
+  }
+  //------------------------------------------------------------------------------------------------------------------------------
   bool core_rpc_server::on_rpc_access_submit_nonce(const COMMAND_RPC_ACCESS_SUBMIT_NONCE::request& req, COMMAND_RPC_ACCESS_SUBMIT_NONCE::response& res, epee::json_rpc::error& error_resp, const connection_context *ctx)
   {
     RPC_TRACKER(rpc_access_submit_nonce);
@@ -3454,6 +3707,7 @@ namespace cryptonote
       res.data.back().count = d.second.count;
       res.data.back().time = d.second.time;
       res.data.back().credits = d.second.credits;
+      res.data.back().requests_per_second = d.second.count / (double)std::max<time_t>(time(NULL) - d.second.since, 1);
     }
 
     res.status = CORE_RPC_STATUS_OK;
@@ -3586,4 +3840,10 @@ namespace cryptonote
     , "Allow free access from the loopback address (ie, the local host)"
     , false
     };
+
+  const command_line::arg_descriptor<bool> core_rpc_server::arg_perf_histograms = {
+      "perf-histograms"
+    , "Record PERF_TIMER durations into histograms from startup, for the perf_histograms RPC and /metrics"
+    , false
+    };
 }  // namespace cryptonote
@@ -88,7 +88,7 @@ namespace cryptonote
 // advance which version they will stop working with
 // Don't go over 32767 for any of these
 #define CORE_RPC_VERSION_MAJOR 3
-#define CORE_RPC_VERSION_MINOR 8
+#define CORE_RPC_VERSION_MINOR 13
 #define MAKE_CORE_RPC_VERSION(major,minor) (((major)<<16)|(minor))
 #define CORE_RPC_VERSION MAKE_CORE_RPC_VERSION(CORE_RPC_VERSION_MAJOR, CORE_RPC_VERSION_MINOR)
 
@@ -689,6 +689,13 @@ namespace cryptonote
       bool busy_syncing;
       std::string version;
       bool synchronized;
+      uint64_t sync_batch_blocks;
+      double sync_blocks_per_second;
+      std::vector<uint64_t> db_commit_ms_histogram;
+      uint64_t tx_hashes_calculated;
+      uint64_t tx_hashes_cached;
+      uint64_t tx_prefix_hashes_calculated;
+      uint64_t tx_prefix_hashes_cached;
 
       BEGIN_KV_SERIALIZE_MAP()
         KV_SERIALIZE_PARENT(rpc_access_response_base)
@@ -730,6 +737,13 @@ namespace cryptonote
         KV_SERIALIZE(busy_syncing)
         KV_SERIALIZE(version)
         KV_SERIALIZE(synchronized)
+        KV_SERIALIZE_OPT(sync_batch_blocks, (uint64_t)0)
+        KV_SERIALIZE_OPT(sync_blocks_per_second, 0.0)
+        KV_SERIALIZE(db_commit_ms_histogram)
+        KV_SERIALIZE_OPT(tx_hashes_calculated, (uint64_t)0)
+        KV_SERIALIZE_OPT(tx_hashes_cached, (uint64_t)0)
+        KV_SERIALIZE_OPT(tx_prefix_hashes_calculated, (uint64_t)0)
+        KV_SERIALIZE_OPT(tx_prefix_hashes_cached, (uint64_t)0)
       END_KV_SERIALIZE_MAP()
     };
     typedef epee::misc_utils::struct_init<response_t> response;
@@ -1563,12 +1577,23 @@ namespace cryptonote
     uint64_t time_in_pool;
   };
 
+  struct tx_backlog_fee_bucket
+  {
+    double min_fee_per_byte;
+    double max_fee_per_byte;
+    uint64_t weight;
+    uint64_t txs;
+  };
+
   struct COMMAND_RPC_GET_TRANSACTION_POOL_BACKLOG
   {
     struct request_t: public rpc_access_request_base
     {
+      bool fee_histogram;
+
       BEGIN_KV_SERIALIZE_MAP()
         KV_SERIALIZE_PARENT(rpc_access_request_base)
+        KV_SERIALIZE_OPT(fee_histogram, false)
       END_KV_SERIALIZE_MAP()
     };
     typedef epee::misc_utils::struct_init<request_t> request;
@@ -1576,10 +1601,12 @@ namespace cryptonote
     struct response_t: public rpc_access_response_base
     {
       std::vector<tx_backlog_entry> backlog;
+      std::vector<tx_backlog_fee_bucket> fee_histogram;
 
       BEGIN_KV_SERIALIZE_MAP()
         KV_SERIALIZE_PARENT(rpc_access_response_base)
         KV_SERIALIZE_CONTAINER_POD_AS_BLOB(backlog)
+        KV_SERIALIZE_CONTAINER_POD_AS_BLOB(fee_histogram)
       END_KV_SERIALIZE_MAP()
     };
     typedef epee::misc_utils::struct_init<response_t> response;
@@ -2523,12 +2550,14 @@ namespace cryptonote
       uint64_t count;
       uint64_t time;
       uint64_t credits;
+      double requests_per_second;
 
       BEGIN_KV_SERIALIZE_MAP()
         KV_SERIALIZE(rpc)
         KV_SERIALIZE(count)
         KV_SERIALIZE(time)
         KV_SERIALIZE(credits)
+        KV_SERIALIZE_OPT(requests_per_second, 0.0)
       END_KV_SERIALIZE_MAP()
     };
 
@@ -2696,4 +2725,61 @@ namespace cryptonote
     typedef epee::misc_utils::struct_init<response_t> response;
   };
 
+  struct COMMAND_RPC_PERF_HISTOGRAMS
+  {
+    struct request_t: public rpc_request_base
+    {
+      std::string mode; // "on" or "off" to switch PERF_TIMERs to/from histograms, empty to leave as is
+      bool clear;
+
+      BEGIN_KV_SERIALIZE_MAP()
+        KV_SERIALIZE_PARENT(rpc_request_base)
+        KV_SERIALIZE_OPT(mode, std::string())
+        KV_SERIALIZE_OPT(clear, false)
+      END_KV_SERIALIZE_MAP()
+    };
+    typedef epee::misc_utils::struct_init<request_t> request;
+
+    struct bucket
+    {
+      uint64_t limit_ns; // timings below this, and at or above the previous bucket's limit
+      uint64_t count;
+
+      BEGIN_KV_SERIALIZE_MAP()
+        KV_SERIALIZE(limit_ns)
+        KV_SERIALIZE(count)
+      END_KV_SERIALIZE_MAP()
+    };
+
+    struct entry
+    {
+      std::string name;
+      std::string category;
+      uint64_t count;
+      uint64_t total_ns;
+      std::vector<bucket> buckets; // non-empty buckets only
+
+      BEGIN_KV_SERIALIZE_MAP()
+        KV_SERIALIZE(name)
+        KV_SERIALIZE(category)
+        KV_SERIALIZE(count)
+        KV_SERIALIZE(total_ns)
+        KV_SERIALIZE(buckets)
+      END_KV_SERIALIZE_MAP()
+    };
+
+    struct response_t: public rpc_response_base
+    {
+      bool enabled;
+      std::vector<entry> histograms;
+
+      BEGIN_KV_SERIALIZE_MAP()
+        KV_SERIALIZE_PARENT(rpc_response_base)
+        KV_SERIALIZE(enabled)
+        KV_SERIALIZE(histograms)
+      END_KV_SERIALIZE_MAP()
+    };
+    typedef epee::misc_utils::struct_init<response_t> response;
+  };
+
 }
@@ -0,0 +1,180 @@
+// Copyright (c) 2021, The Monero Project
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of
+//    conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list
+//    of conditions and the following disclaimer in the documentation and/or other
+//    materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be
+//    used to endorse or promote products derived from this software without specific
+//    prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+// THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "serialization/json_object.h"
+#include "json_response_writer.h"
+
+// store_t_to_json() emits the entries of a section sorted by name, so the
+// writers below do too, and skip the ones the KV maps skip (empty containers,
+// optional fields at their default).
+
+namespace
+{
+  typedef rapidjson::Writer<epee::byte_stream> json_writer;
+
+  template<typename T>
+  void write_array(json_writer &dest, const char *name, const std::vector<T> &values)
+  {
+    if (values.empty())
+      return;
+    dest.Key(name);
+    dest.StartArray();
+    for (const T &value: values)
+      cryptonote::json::toJsonValue(dest, value);
+    dest.EndArray();
+  }
+
+  void write_tx_info(json_writer &dest, const cryptonote::tx_info &txi)
+  {
+    dest.StartObject();
+    INSERT_INTO_JSON_OBJECT(dest, blob_size, txi.blob_size);
+    INSERT_INTO_JSON_OBJECT(dest, do_not_relay, txi.do_not_relay);
+    INSERT_INTO_JSON_OBJECT(dest, double_spend_seen, txi.double_spend_seen);
+    INSERT_INTO_JSON_OBJECT(dest, fee, txi.fee);
+    INSERT_INTO_JSON_OBJECT(dest, id_hash, txi.id_hash);
+    INSERT_INTO_JSON_OBJECT(dest, kept_by_block, txi.kept_by_block);
+    INSERT_INTO_JSON_OBJECT(dest, last_failed_height, txi.last_failed_height);
+    INSERT_INTO_JSON_OBJECT(dest, last_failed_id_hash, txi.last_failed_id_hash);
+    INSERT_INTO_JSON_OBJECT(dest, last_relayed_time, txi.last_relayed_time);
+    INSERT_INTO_JSON_OBJECT(dest, max_used_block_height, txi.max_used_block_height);
+    INSERT_INTO_JSON_OBJECT(dest, max_used_block_id_hash, txi.max_used_block_id_hash);
+    INSERT_INTO_JSON_OBJECT(dest, receive_time, txi.receive_time);
+    INSERT_INTO_JSON_OBJECT(dest, relayed, txi.relayed);
+    INSERT_INTO_JSON_OBJECT(dest, tx_blob, txi.tx_blob);
+    INSERT_INTO_JSON_OBJECT(dest, tx_json, txi.tx_json);
+    if (txi.weight != 0)
+    {
+      INSERT_INTO_JSON_OBJECT(dest, weight, txi.weight);
+    }
+    dest.EndObject();
+  }
+
+  void write_spent_key_image_info(json_writer &dest, const cryptonote::spent_key_image_info &ski)
+  {
+    dest.StartObject();
+    INSERT_INTO_JSON_OBJECT(dest, id_hash, ski.id_hash);
+    write_array(dest, "txs_hashes", ski.txs_hashes);
+    dest.EndObject();
+  }
+
+  void write_tx_entry(json_writer &dest, const cryptonote::COMMAND_RPC_GET_TRANSACTIONS::entry &e)
+  {
+    dest.StartObject();
+    INSERT_INTO_JSON_OBJECT(dest, as_hex, e.as_hex);
+    INSERT_INTO_JSON_OBJECT(dest, as_json, e.as_json);
+    if (!e.in_pool)
+    {
+      INSERT_INTO_JSON_OBJECT(dest, block_height, e.block_height);
+      INSERT_INTO_JSON_OBJECT(dest, block_timestamp, e.block_timestamp);
+      INSERT_INTO_JSON_OBJECT(dest, confirmations, e.confirmations);
+    }
+    INSERT_INTO_JSON_OBJECT(dest, double_spend_seen, e.double_spend_seen);
+    INSERT_INTO_JSON_OBJECT(dest, in_pool, e.in_pool);
+    if (!e.in_pool)
+      write_array(dest, "output_indices", e.output_indices);
+    INSERT_INTO_JSON_OBJECT(dest, prunable_as_hex, e.prunable_as_hex);
+    INSERT_INTO_JSON_OBJECT(dest, prunable_hash, e.prunable_hash);
+    INSERT_INTO_JSON_OBJECT(dest, pruned_as_hex, e.pruned_as_hex);
+    if (e.in_pool)
+    {
+      INSERT_INTO_JSON_OBJECT(dest, received_timestamp, e.received_timestamp);
+      INSERT_INTO_JSON_OBJECT(dest, relayed, e.relayed);
+    }
+    INSERT_INTO_JSON_OBJECT(dest, tx_hash, e.tx_hash);
+    dest.EndObject();
+  }
+}
+
+namespace cryptonote
+{
+  //------------------------------------------------------------------------------------------------------------------------------
+  void write_get_transaction_pool_response(epee::byte_stream &out, const COMMAND_RPC_GET_TRANSACTION_POOL::response &res)
+  {
+    // reserve once: the tx json and blob hex dominate
+    size_t reserve = 256 + res.spent_key_images.size() * 256;
+    for (const tx_info &txi: res.transactions)
+      reserve += txi.tx_json.size() * 5 / 4 + txi.tx_blob.size() + 512;
+    out.reserve(reserve);
+
+    json_writer dest{out};
+    dest.StartObject();
+    INSERT_INTO_JSON_OBJECT(dest, credits, res.credits);
+    if (!res.spent_key_images.empty())
+    {
+      dest.Key("spent_key_images");
+      dest.StartArray();
+      for (const spent_key_image_info &ski: res.spent_key_images)
+        write_spent_key_image_info(dest, ski);
+      dest.EndArray();
+    }
+    INSERT_INTO_JSON_OBJECT(dest, status, res.status);
+    INSERT_INTO_JSON_OBJECT(dest, top_hash, res.top_hash);
+    if (!res.transactions.empty())
+    {
+      dest.Key("transactions");
+      dest.StartArray();
+      for (const tx_info &txi: res.transactions)
+        write_tx_info(dest, txi);
+      dest.EndArray();
+    }
+    INSERT_INTO_JSON_OBJECT(dest, untrusted, res.untrusted);
+    dest.EndObject();
+  }
+  //------------------------------------------------------------------------------------------------------------------------------
+  void write_get_transactions_response(epee::byte_stream &out, const COMMAND_RPC_GET_TRANSACTIONS::response &res)
+  {
+    size_t reserve = 256 + res.missed_tx.size() * 72;
+    for (const std::string &s: res.txs_as_hex)
+      reserve += s.size() + 8;
+    for (const std::string &s: res.txs_as_json)
+      reserve += s.size() * 5 / 4;
+    for (const COMMAND_RPC_GET_TRANSACTIONS::entry &e: res.txs)
+      reserve += e.as_hex.size() + e.pruned_as_hex.size() + e.prunable_as_hex.size() + e.as_json.size() * 5 / 4 + 512;
+    out.reserve(reserve);
+
+    json_writer dest{out};
+    dest.StartObject();
+    INSERT_INTO_JSON_OBJECT(dest, credits, res.credits);
+    write_array(dest, "missed_tx", res.missed_tx);
+    INSERT_INTO_JSON_OBJECT(dest, status, res.status);
+    INSERT_INTO_JSON_OBJECT(dest, top_hash, res.top_hash);
+    if (!res.txs.empty())
+    {
+      dest.Key("txs");
+      dest.StartArray();
+      for (const COMMAND_RPC_GET_TRANSACTIONS::entry &e: res.txs)
+        write_tx_entry(dest, e);
+      dest.EndArray();
+    }
+    write_array(dest, "txs_as_hex", res.txs_as_hex);
+    write_array(dest, "txs_as_json", res.txs_as_json);
+    INSERT_INTO_JSON_OBJECT(dest, untrusted, res.untrusted);
+    dest.EndObject();
+  }
+  //------------------------------------------------------------------------------------------------------------------------------
+}
@@ -0,0 +1,57 @@
+// Copyright (c) 2021, The Monero Project
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of
+//    conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list
+//    of conditions and the following disclaimer in the documentation and/or other
+//    materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be
+//    used to endorse or promote products derived from this software without specific
+//    prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+// THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include "byte_stream.h"
+#include "core_rpc_server_commands_defs.h"
+
+namespace cryptonote
+{
+  /**
+   * @brief writes a /get_transaction_pool response as json
+   *
+   * The output is equivalent to what epee::serialization::store_t_to_json()
+   * produces for `res`, but it is streamed with rapidjson straight into `out`
+   * instead of going through a portable_storage tree and a string dump.
+   *
+   * @param out the stream to append to
+   * @param res the response to write
+   */
+  void write_get_transaction_pool_response(epee::byte_stream &out, const COMMAND_RPC_GET_TRANSACTION_POOL::response &res);
+
+  /**
+   * @brief writes a /get_transactions response as json
+   *
+   * @see write_get_transaction_pool_response
+   *
+   * @param out the stream to append to
+   * @param res the response to write
+   */
+  void write_get_transactions_response(epee::byte_stream &out, const COMMAND_RPC_GET_TRANSACTIONS::response &res);
+}
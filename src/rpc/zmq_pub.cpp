@@ -57,6 +57,7 @@
 namespace
 {
   constexpr const char txpool_signal[] = "tx_signal";
+  constexpr const char chain_signal[] = "chain_signal";
 
   using chain_writer =  void(epee::byte_stream&, std::uint64_t, epee::span<const cryptonote::block>);
   using miner_writer =  void(epee::byte_stream&, uint8_t, uint64_t, const crypto::hash&, const crypto::hash&, cryptonote::difficulty_type, uint64_t, uint64_t, const std::vector<cryptonote::tx_block_template_backlog_entry>&);
@@ -325,7 +326,14 @@ namespace
     return count;
   }
 
-  expect<bool> relay_block_pub(void* const relay, void* const pub) noexcept
+  enum class relayed_pub
+  {
+    forwarded, //!< A message serialized by the sender, already sent to `pub`
+    txpool,    //!< Signal to serialize and send the next queued txpool event
+    chain      //!< Signal to serialize and send the next queued chain event
+  };
+
+  expect<relayed_pub> relay_block_pub(void* const relay, void* const pub) noexcept
   {
     zmq_msg_t msg;
     zmq_msg_init(std::addressof(msg));
@@ -339,17 +347,22 @@ namespace
     if (payload == txpool_signal)
     {
       zmq_msg_close(std::addressof(msg));
-      return false;
+      return relayed_pub::txpool;
+    }
+    if (payload == chain_signal)
+    {
+      zmq_msg_close(std::addressof(msg));
+      return relayed_pub::chain;
     }
 
-    // forward block messages (serialized on P2P thread for now)
+    // forward miner data messages (serialized on the caller's thread)
     const expect<void> sent = net::zmq::retry_op(zmq_msg_send, std::addressof(msg), pub, ZMQ_DONTWAIT);
     if (!sent)
     {
       zmq_msg_close(std::addressof(msg));
       return sent.error();
     }
-    return true;
+    return relayed_pub::forwarded;
   }
 } // anonymous
 
@@ -420,14 +433,18 @@ bool zmq_pub::sub_request(boost::string_ref message)
 
 bool zmq_pub::relay_to_pub(void* const relay, void* const pub)
 {
-  const expect<bool> relayed = relay_block_pub(relay, pub);
+  const expect<relayed_pub> relayed = relay_block_pub(relay, pub);
   if (!relayed)
   {
     MERROR("Error relaying ZMQ/Pub: " << relayed.error().message());
     return false;
   }
 
-  if (!*relayed)
+  /* Each event is serialized once per subscribed format, into one buffer
+     whose slices are handed to the PUB socket for all of its subscribers. */
+  switch (*relayed)
+  {
+  case relayed_pub::txpool:
   {
     std::array<std::size_t, 2> subs;
     std::vector<cryptonote::txpool_event> events;
@@ -443,9 +460,30 @@ bool zmq_pub::relay_to_pub(void* const relay, void* const pub)
     auto messages = make_pubs(subs, txpool_contexts, epee::to_span(events));
     send_messages(pub, messages);
     MDEBUG("Sent txpool ZMQ/Pub");
+    break;
   }
-  else
+  case relayed_pub::chain:
+  {
+    std::array<std::size_t, 2> subs;
+    std::pair<std::uint64_t, std::vector<cryptonote::block>> chain;
+    {
+      const boost::lock_guard<boost::mutex> lock{sync_};
+      if (blocks_.empty())
+        return false;
+
+      subs = chain_subs_;
+      chain = std::move(blocks_.front());
+      blocks_.pop_front();
+    }
+    auto messages = make_pubs(subs, chain_contexts, chain.first, epee::to_span(chain.second));
+    send_messages(pub, messages);
     MDEBUG("Sent chain_main ZMQ/Pub");
+    break;
+  }
+  case relayed_pub::forwarded:
+    MDEBUG("Sent miner_data ZMQ/Pub");
+    break;
+  }
 
   return true;
 }
@@ -458,25 +496,25 @@ std::size_t zmq_pub::send_chain_main(const std::uint64_t height, const epee::spa
   /* Block format only sends one block at a time - multiple block notifications
      are less common and only occur on rollbacks. */
 
-  boost::unique_lock<boost::mutex> guard{sync_};
-
-  const auto subs_copy = chain_subs_;
-  guard.unlock();
-
-  for (const std::size_t sub : subs_copy)
   {
-    if (sub)
-    {
-      /* cryptonote_core/blockchain.cpp cannot "give" us the block like core
-         does for txpool events. Since copying the block is expensive anyway,
-         serialization is done right here on the p2p thread (for now). */
-
-        auto messages = make_pubs(subs_copy, chain_contexts, height, blocks);
-        guard.lock();
-        return send_messages(relay_.get(), messages);
-    }
+    const boost::lock_guard<boost::mutex> lock{sync_};
+    if (std::none_of(chain_subs_.begin(), chain_subs_.end(), [](const std::size_t sub) { return sub != 0; }))
+      return 0;
   }
-  return 0;
+
+  /* cryptonote_core/blockchain.cpp cannot "give" us the block like core does
+     for txpool events, but a block (its header, miner tx and tx ids) is much
+     cheaper to copy than to serialize. The copy is serialized on the ZMQ
+     server thread, so the p2p thread never waits on encoding. */
+  std::vector<cryptonote::block> copy{blocks.begin(), blocks.end()};
+
+  const boost::lock_guard<boost::mutex> lock{sync_};
+  const expect<void> sent = net::zmq::retry_op(zmq_send_const, relay_.get(), chain_signal, sizeof(chain_signal) - 1, ZMQ_DONTWAIT);
+  if (sent)
+    blocks_.emplace_back(height, std::move(copy));
+  else
+    MERROR("ZMQ/Pub failure, relay queue error: " << sent.error().message());
+  return bool(sent);
 }
 
 std::size_t zmq_pub::send_miner_data(uint8_t major_version, uint64_t height, const crypto::hash& prev_id, const crypto::hash& seed_hash, difficulty_type diff, uint64_t median_weight, uint64_t already_generated_coins, const std::vector<tx_block_template_backlog_entry>& tx_backlog)
@@ -34,6 +34,7 @@
 #include <cstdint>
 #include <deque>
 #include <memory>
+#include <utility>
 #include <vector>
 
 #include "cryptonote_basic/fwd.h"
@@ -59,6 +60,7 @@ class zmq_pub
 
     net::zmq::socket relay_;
     std::deque<std::vector<txpool_event>> txes_;
+    std::deque<std::pair<std::uint64_t, std::vector<block>>> blocks_;
     std::array<std::size_t, 2> chain_subs_;
     std::array<std::size_t, 1> miner_subs_;
     std::array<std::size_t, 2> txpool_subs_;
@@ -81,12 +83,13 @@ class zmq_pub
     //! Process a client subscription request (from XPUB sockets). Thread-safe.
     bool sub_request(const boost::string_ref message);
 
-    /*! Forward ZMQ messages sent to `relay` via `send_chain_main` or
-      `send_txpool_add` to `pub`. Used by `ZmqServer`. */
+    /*! Forward ZMQ messages sent to `relay` via `send_miner_data` to `pub`,
+      or serialize and send the next event queued by `send_chain_main` or
+      `send_txpool_add`. Used by `ZmqServer`. */
     bool relay_to_pub(void* relay, void* pub);
 
-    /*! Send a `ZMQ_PUB` notification for a change to the main chain.
-        Thread-safe.
+    /*! Send a `ZMQ_PUB` notification for a change to the main chain. The
+        blocks are copied and serialized later by `relay_to_pub`. Thread-safe.
         \return Number of ZMQ messages sent to relay. */
     std::size_t send_chain_main(std::uint64_t height, epee::span<const cryptonote::block> blocks);
 
@@ -0,0 +1,329 @@
+// Copyright (c) 2016-2020, The Monero Project
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of
+//    conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list
+//    of conditions and the following disclaimer in the documentation and/or other
+//    materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be
+//    used to endorse or promote products derived from this software without specific
+//    prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+// THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "zmq_verification.h"
+
+#include <algorithm>
+#include <boost/bind/bind.hpp>
+#include <memory>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+
+#include "misc_log_ex.h"
+#include "serialization/binary_utils.h"
+#include "span.h"
+
+#undef MONERO_DEFAULT_LOG_CATEGORY
+#define MONERO_DEFAULT_LOG_CATEGORY "net.zmq"
+
+namespace cryptonote
+{
+
+namespace
+{
+  constexpr const int num_zmq_threads = 1;
+  constexpr const std::int64_t max_message_size = 64 * 1024 * 1024; // 64 MiB, batches carry their rings
+  constexpr const std::chrono::seconds linger_timeout{2}; // wait period for pending out messages
+  constexpr const std::chrono::seconds default_resend_timeout{60};
+
+  //! `queue_limit` is the high water mark of the jobs direction, `0` keeps the ZMQ default
+  net::zmq::socket init_socket(void* context, int type, const std::string& address, bool bind, int queue_limit = 0)
+  {
+    if (context == nullptr)
+      throw std::logic_error{"NULL context provided"};
+
+    net::zmq::socket out{};
+    out.reset(zmq_socket(context, type));
+    if (!out)
+    {
+      MONERO_LOG_ZMQ_ERROR("Failed to create ZMQ socket");
+      return nullptr;
+    }
+
+    if (zmq_setsockopt(out.get(), ZMQ_MAXMSGSIZE, std::addressof(max_message_size), sizeof(max_message_size)) != 0)
+    {
+      MONERO_LOG_ZMQ_ERROR("Failed to set maximum incoming message size");
+      return nullptr;
+    }
+
+    static constexpr const int linger_value = std::chrono::milliseconds{linger_timeout}.count();
+    if (zmq_setsockopt(out.get(), ZMQ_LINGER, std::addressof(linger_value), sizeof(linger_value)) != 0)
+    {
+      MONERO_LOG_ZMQ_ERROR("Failed to set linger timeout");
+      return nullptr;
+    }
+
+    const int hwm_option = type == ZMQ_PUSH ? ZMQ_SNDHWM : ZMQ_RCVHWM;
+    if (queue_limit && zmq_setsockopt(out.get(), hwm_option, std::addressof(queue_limit), sizeof(queue_limit)) != 0)
+    {
+      MONERO_LOG_ZMQ_ERROR("Failed to set high water mark");
+      return nullptr;
+    }
+
+    if ((bind ? zmq_bind(out.get(), address.c_str()) : zmq_connect(out.get(), address.c_str())) < 0)
+    {
+      MONERO_LOG_ZMQ_ERROR("ZMQ " << (bind ? "bind" : "connect") << " failed");
+      return nullptr;
+    }
+    MINFO("ZMQ verification " << (bind ? "listening at " : "connected to ") << address);
+
+    return out;
+  }
+
+  expect<void> send_blob(const std::string& blob, void* socket)
+  {
+    return net::zmq::send(epee::strspan<std::uint8_t>(blob), socket);
+  }
+} // anonymous
+
+namespace rpc
+{
+
+ZmqVerificationCoordinator::ZmqVerificationCoordinator() :
+    context(zmq_init(num_zmq_threads)),
+    jobs_socket(nullptr),
+    results_socket(nullptr),
+    next_batch_id(0),
+    resend_timeout(default_resend_timeout)
+{
+    if (!context)
+        MONERO_ZMQ_THROW("Unable to create ZMQ context");
+}
+
+ZmqVerificationCoordinator::~ZmqVerificationCoordinator()
+{
+}
+
+bool ZmqVerificationCoordinator::init(const std::string& jobs_address, const std::string& results_address)
+{
+  // batches wait here rather than in the queue of a busy worker
+  jobs_socket = init_socket(context.get(), ZMQ_PUSH, jobs_address, true, 1);
+  results_socket = init_socket(context.get(), ZMQ_PULL, results_address, true);
+  return jobs_socket && results_socket;
+}
+
+expect<std::uint64_t> ZmqVerificationCoordinator::submit(std::vector<tx_verification_job> txs, const std::uint8_t hf_version)
+{
+  MONERO_PRECOND(jobs_socket != nullptr);
+
+  tx_verification_batch batch{next_batch_id, hf_version, std::move(txs)};
+  pending_batch out{};
+  if (!::serialization::dump_binary(batch, out.blob))
+    return {common_error::kInvalidArgument};
+
+  MONERO_CHECK(send_blob(out.blob, jobs_socket.get()));
+  out.sent = std::chrono::steady_clock::now();
+  pending.emplace(batch.batch_id, std::move(out));
+  return next_batch_id++;
+}
+
+expect<tx_verification_result> ZmqVerificationCoordinator::next_result()
+{
+  MONERO_PRECOND(results_socket != nullptr);
+  if (pending.empty())
+    throw std::logic_error{"No verification batch in flight"};
+
+  for (;;)
+  {
+    auto now = std::chrono::steady_clock::now();
+    auto deadline = now + resend_timeout;
+    for (const auto& batch : pending)
+      deadline = std::min(deadline, batch.second.sent + resend_timeout);
+
+    const long wait = std::max<long>(0, std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now).count());
+    zmq_pollitem_t item{results_socket.get(), 0, ZMQ_POLLIN, 0};
+    MONERO_CHECK(net::zmq::retry_op(zmq_poll, std::addressof(item), 1, wait));
+
+    if (item.revents)
+    {
+      expect<std::string> message = net::zmq::receive(results_socket.get(), ZMQ_DONTWAIT);
+      if (!message)
+        return message.error();
+
+      tx_verification_result result{};
+      if (!::serialization::parse_binary(*message, result))
+      {
+        MWARNING("Dropping malformed verification result");
+        continue;
+      }
+      const auto batch = pending.find(result.batch_id);
+      if (batch == pending.end())
+        continue; // answered already, by the worker it was resent to or the original one
+
+      pending.erase(batch);
+      return result;
+    }
+
+    now = std::chrono::steady_clock::now();
+    for (auto& batch : pending)
+    {
+      if (batch.second.sent + resend_timeout <= now)
+      {
+        MWARNING("No verdicts for verification batch " << batch.first << " after "
+          << resend_timeout.count() << " ms, resending it");
+        MONERO_CHECK(send_blob(batch.second.blob, jobs_socket.get()));
+        batch.second.sent = now;
+      }
+    }
+  }
+}
+
+expect<std::vector<std::uint8_t>> ZmqVerificationCoordinator::verify(std::vector<tx_verification_job> txs, const std::uint8_t hf_version, const std::size_t batch_size)
+{
+  MONERO_PRECOND(batch_size != 0);
+
+  // batch id -> index of its first tx
+  std::map<std::uint64_t, std::size_t> offsets;
+  for (std::size_t start = 0; start < txs.size(); start += batch_size)
+  {
+    const std::size_t end = std::min(txs.size(), start + batch_size);
+    std::vector<tx_verification_job> batch{
+      std::make_move_iterator(txs.begin() + start), std::make_move_iterator(txs.begin() + end)
+    };
+    expect<std::uint64_t> id = submit(std::move(batch), hf_version);
+    if (!id)
+      return id.error();
+    offsets.emplace(*id, start);
+  }
+
+  std::vector<std::uint8_t> verdicts(txs.size(), 0);
+  while (!offsets.empty())
+  {
+    expect<tx_verification_result> result = next_result();
+    if (!result)
+      return result.error();
+
+    const auto offset = offsets.find(result->batch_id);
+    if (offset == offsets.end())
+      continue; // submitted by another caller
+    const std::size_t count = std::min(batch_size, txs.size() - offset->second);
+    if (result->verdicts.size() != count)
+      return {common_error::kInvalidArgument};
+    std::copy(result->verdicts.begin(), result->verdicts.end(), verdicts.begin() + offset->second);
+    offsets.erase(offset);
+  }
+  return verdicts;
+}
+
+ZmqVerificationWorker::ZmqVerificationWorker() :
+    context(zmq_init(num_zmq_threads)),
+    socket_pairs(),
+    threads()
+{
+    if (!context)
+        MONERO_ZMQ_THROW("Unable to create ZMQ context");
+}
+
+ZmqVerificationWorker::~ZmqVerificationWorker()
+{
+  stop();
+}
+
+bool ZmqVerificationWorker::init(const std::string& jobs_address, const std::string& results_address, const std::size_t threads)
+{
+  for (std::size_t i = 0; i < threads; ++i)
+  {
+    /* Each thread queues one batch at most, so batches wait at the
+       coordinator (which hands them to idle threads) rather than behind a
+       batch being verified. */
+    socket_pair sockets{
+      init_socket(context.get(), ZMQ_PULL, jobs_address, false, 1),
+      init_socket(context.get(), ZMQ_PUSH, results_address, false)
+    };
+    if (!sockets.jobs || !sockets.results)
+      return false;
+    socket_pairs.push_back(std::move(sockets));
+  }
+  return true;
+}
+
+void ZmqVerificationWorker::run()
+{
+  // each thread takes ownership of its sockets, so `stop()` never touches a socket a thread uses
+  for (socket_pair& sockets : socket_pairs)
+    threads.create_thread(boost::bind(&ZmqVerificationWorker::serve, std::make_shared<socket_pair>(std::move(sockets))));
+  socket_pairs.clear();
+}
+
+void ZmqVerificationWorker::stop()
+{
+  if (!context)
+    return;
+
+  socket_pairs.clear(); // close the sockets of threads never started, or `zmq_term` would wait on them
+  context.reset(); // destroying context terminates all calls
+  threads.join_all();
+}
+
+void ZmqVerificationWorker::serve(const std::shared_ptr<socket_pair> sockets)
+{
+  try
+  {
+    // sockets must close before `zmq_term` will exit.
+    const net::zmq::socket jobs = std::move(sockets->jobs);
+    const net::zmq::socket results = std::move(sockets->results);
+
+    while (1)
+    {
+      const std::string message = MONERO_UNWRAP(net::zmq::receive(jobs.get()));
+
+      tx_verification_batch batch{};
+      if (!::serialization::parse_binary(message, batch))
+      {
+        MWARNING("Dropping malformed verification batch");
+        continue;
+      }
+
+      tx_verification_result result = verify_tx_batch(batch);
+      MDEBUG("Verified batch " << batch.batch_id << " (" << batch.txs.size() << " txs)");
+
+      std::string blob;
+      if (!::serialization::dump_binary(result, blob))
+        throw std::runtime_error{"Failed to serialize verification result"};
+      MONERO_UNWRAP(send_blob(blob, results.get()));
+    }
+  }
+  catch (const std::system_error& e)
+  {
+    if (e.code() != net::zmq::make_error_code(ETERM))
+      MERROR("ZMQ verification worker error: " << e.what());
+  }
+  catch (const std::exception& e)
+  {
+    MERROR("ZMQ verification worker error: " << e.what());
+  }
+  catch (...)
+  {
+    MERROR("Unknown error in ZMQ verification worker");
+  }
+}
+
+}  // namespace rpc
+
+}  // namespace cryptonote
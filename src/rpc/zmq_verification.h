@@ -0,0 +1,139 @@
+// Copyright (c) 2016-2020, The Monero Project
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of
+//    conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list
+//    of conditions and the following disclaimer in the documentation and/or other
+//    materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be
+//    used to endorse or promote products derived from this software without specific
+//    prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+// THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <boost/thread/thread.hpp>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/expect.h"
+#include "cryptonote_core/tx_verification_batch.h"
+#include "net/zmq.h"
+
+namespace cryptonote
+{
+
+namespace rpc
+{
+
+/*! Ships batches of transactions to verification workers and collects their
+    verdicts. Jobs go out on a ZMQ_PUSH socket, which hands each batch to the
+    next worker with room in its queue, so throughput grows with the number of
+    workers connected; verdicts come back on a ZMQ_PULL socket.
+
+    A batch with no verdict after the resend timeout (e.g. its worker died) is
+    sent again; duplicate verdicts are dropped. Not thread safe. */
+class ZmqVerificationCoordinator final
+{
+  public:
+
+    ZmqVerificationCoordinator();
+
+    ~ZmqVerificationCoordinator();
+
+    /*! Binds the job and result sockets. Workers connect to both.
+        \return False on errors. */
+    bool init(const std::string& jobs_address, const std::string& results_address);
+
+    void set_resend_timeout(std::chrono::milliseconds timeout) noexcept { resend_timeout = timeout; }
+
+    /*! Sends `txs` as one batch. Blocks while no worker is connected.
+        \return Id of the batch, reported back in its result. */
+    expect<std::uint64_t> submit(std::vector<tx_verification_job> txs, std::uint8_t hf_version);
+
+    /*! Waits for the verdicts of one of the batches in flight, resending
+        batches that timed out meanwhile.
+        \pre `in_flight() != 0` */
+    expect<tx_verification_result> next_result();
+
+    /*! Splits `txs` into batches of at most `batch_size`, and waits for all
+        their verdicts.
+        \return One verdict per tx (1 = valid), in the order of `txs`. */
+    expect<std::vector<std::uint8_t>> verify(std::vector<tx_verification_job> txs, std::uint8_t hf_version, std::size_t batch_size);
+
+    //! \return Number of batches submitted and not yet answered.
+    std::size_t in_flight() const noexcept { return pending.size(); }
+
+  private:
+    struct pending_batch
+    {
+      std::string blob;
+      std::chrono::steady_clock::time_point sent;
+    };
+
+    net::zmq::context context;
+    net::zmq::socket jobs_socket;
+    net::zmq::socket results_socket;
+
+    std::map<std::uint64_t, pending_batch> pending;
+    std::uint64_t next_batch_id;
+    std::chrono::milliseconds resend_timeout;
+};
+
+/*! Verifies batches from a `ZmqVerificationCoordinator` with
+    `verify_tx_batch()`. Needs no database: batches carry their ring members. */
+class ZmqVerificationWorker final
+{
+  public:
+
+    ZmqVerificationWorker();
+
+    ~ZmqVerificationWorker();
+
+    /*! Connects `threads` job/result socket pairs to a coordinator.
+        \return False on errors. */
+    bool init(const std::string& jobs_address, const std::string& results_address, std::size_t threads);
+
+    //! Starts one thread per socket pair.
+    void run();
+
+    //! Stops and joins the threads; batches being verified are dropped.
+    void stop();
+
+  private:
+    struct socket_pair
+    {
+      net::zmq::socket jobs;
+      net::zmq::socket results;
+    };
+
+    static void serve(std::shared_ptr<socket_pair> sockets);
+
+    net::zmq::context context;
+    std::vector<socket_pair> socket_pairs;
+    boost::thread_group threads;
+};
+
+}  // namespace rpc
+
+}  // namespace cryptonote
@@ -62,6 +62,69 @@ namespace serialization
   }
 }
 
+// blob elements are stored back to back with no per element framing, so a
+// binary archive can move a whole vector (or fixed size array) of them at once
+template <template <bool> class Archive, bool W, typename T>
+bool do_serialize_blob_array(Archive<W> &ar, T *v, size_t n)
+{
+  for (size_t i = 0; i < n; ++i)
+  {
+    if (!::do_serialize(ar, v[i]) || !ar.good())
+      return false;
+    if (n - i > 1)
+      ar.delimit_array();
+  }
+  return true;
+}
+
+template <bool W, typename T>
+bool do_serialize_blob_array(binary_archive<W> &ar, T *v, size_t n)
+{
+  static_assert(std::is_trivially_copyable<T>(), "blob types must be trivially copyable");
+  if (n > std::numeric_limits<size_t>::max() / sizeof(T))
+  {
+    ar.set_fail();
+    return false;
+  }
+  ar.serialize_blob(v, n * sizeof(T));
+  return ar.good();
+}
+
+template <template <bool> class Archive, typename T>
+bool do_serialize_blob_container(Archive<false> &ar, std::vector<T> &v)
+{
+  size_t cnt;
+  ar.begin_array(cnt);
+  if (!ar.good())
+    return false;
+  v.clear();
+
+  // the whole array must be in the buffer before anything is allocated for it
+  if (ar.remaining_bytes() / sizeof(T) < cnt) {
+    ar.set_fail();
+    return false;
+  }
+
+  v.resize(cnt);
+  if (!do_serialize_blob_array(ar, v.data(), cnt))
+    return false;
+  ar.end_array();
+  return true;
+}
+
+template <template <bool> class Archive, typename T>
+bool do_serialize_blob_container(Archive<true> &ar, std::vector<T> &v)
+{
+  size_t cnt = v.size();
+  ar.begin_array(cnt);
+  if (!ar.good())
+    return false;
+  if (!do_serialize_blob_array(ar, v.data(), cnt))
+    return false;
+  ar.end_array();
+  return true;
+}
+
 template <template <bool> class Archive, typename C>
 bool do_serialize_container(Archive<false> &ar, C &v)
 {
@@ -112,3 +175,21 @@ bool do_serialize_container(Archive<true> &ar, C &v)
   ar.end_array();
   return true;
 }
+
+namespace serialization
+{
+  namespace detail
+  {
+    template <template <bool> class Archive, bool W, typename T, typename B>
+    bool do_serialize_vector(Archive<W> &ar, std::vector<T> &v, B)
+    {
+      return do_serialize_container(ar, v);
+    }
+
+    template <bool W, typename T>
+    bool do_serialize_vector(binary_archive<W> &ar, std::vector<T> &v, boost::true_type)
+    {
+      return do_serialize_blob_container(ar, v);
+    }
+  }
+}
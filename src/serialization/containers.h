@@ -30,6 +30,8 @@
 
 #pragma once
 
+#include <limits>
+#include <type_traits>
 #include <vector>
 #include <deque>
 #include <unordered_map>
@@ -38,6 +40,8 @@
 #include <set>
 #include "serialization.h"
 
+template <bool W> struct binary_archive;
+
 template <template <bool> class Archive, class T> bool do_serialize(Archive<false> &ar, std::vector<T> &v);
 template <template <bool> class Archive, class T> bool do_serialize(Archive<true> &ar, std::vector<T> &v);
 
@@ -106,8 +110,8 @@ namespace serialization
 
 #include "container.h"
 
-template <template <bool> class Archive, class T> bool do_serialize(Archive<false> &ar, std::vector<T> &v) { return do_serialize_container(ar, v); }
-template <template <bool> class Archive, class T> bool do_serialize(Archive<true> &ar, std::vector<T> &v) { return do_serialize_container(ar, v); }
+template <template <bool> class Archive, class T> bool do_serialize(Archive<false> &ar, std::vector<T> &v) { return ::serialization::detail::do_serialize_vector(ar, v, typename is_blob_type<T>::type()); }
+template <template <bool> class Archive, class T> bool do_serialize(Archive<true> &ar, std::vector<T> &v) { return ::serialization::detail::do_serialize_vector(ar, v, typename is_blob_type<T>::type()); }
 
 template <template <bool> class Archive, class T> bool do_serialize(Archive<false> &ar, std::deque<T> &v) { return do_serialize_container(ar, v); }
 template <template <bool> class Archive, class T> bool do_serialize(Archive<true> &ar, std::deque<T> &v) { return do_serialize_container(ar, v); }
@@ -0,0 +1,174 @@
+// Copyright (c) 2021, The Monero Project
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of
+//    conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list
+//    of conditions and the following disclaimer in the documentation and/or other
+//    materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be
+//    used to endorse or promote products derived from this software without specific
+//    prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+// THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+
+
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include "common/varint.h"
+#include "crypto/crypto.h"
+#include "crypto/hash.h"
+#include "file_io_utils.h"
+#include "misc_log_ex.h"
+#include "cache_log.h"
+
+#undef MONERO_DEFAULT_LOG_CATEGORY
+#define MONERO_DEFAULT_LOG_CATEGORY "wallet.cachelog"
+
+static const char CACHE_LOG_MAGIC[] = "Monero wallet cache log v1";
+
+namespace tools
+{
+
+cache_log::cache_log():
+  m_has_base(false),
+  m_base_size(0),
+  m_num_records(0),
+  m_size(0)
+{
+  memset(&m_base_iv, 0, sizeof(m_base_iv));
+}
+
+void cache_log::clear()
+{
+  m_has_base = false;
+  memset(&m_base_iv, 0, sizeof(m_base_iv));
+  m_base_size = 0;
+  m_num_records = 0;
+  m_size = 0;
+}
+
+void cache_log::reset(const crypto::chacha_iv &base_iv, uint64_t base_size)
+{
+  m_has_base = true;
+  m_base_iv = base_iv;
+  m_base_size = base_size;
+  m_num_records = 0;
+  m_size = 0;
+}
+
+bool cache_log::load(const std::string &filename, const crypto::chacha_key &key, const crypto::chacha_iv &base_iv, uint64_t base_size,
+    std::vector<std::string> &records)
+{
+  reset(base_iv, base_size);
+  records.clear();
+
+  std::string data;
+  if (!epee::file_io_utils::is_file_exist(filename))
+    return true;
+  if (!epee::file_io_utils::load_file_to_string(filename, data, std::numeric_limits<size_t>::max()))
+  {
+    MWARNING("Failed to read cache log " << filename);
+    return false;
+  }
+
+  const size_t header_size = sizeof(CACHE_LOG_MAGIC) + sizeof(crypto::chacha_iv);
+  if (data.size() < header_size || memcmp(data.data(), CACHE_LOG_MAGIC, sizeof(CACHE_LOG_MAGIC)) != 0)
+  {
+    MWARNING("Cache log " << filename << " has a bad header, ignoring it");
+    return false;
+  }
+  if (memcmp(data.data() + sizeof(CACHE_LOG_MAGIC), &base_iv, sizeof(base_iv)) != 0)
+  {
+    // left over from before the cache file was last saved in full
+    MDEBUG("Cache log " << filename << " is for another cache file, ignoring it");
+    return true;
+  }
+
+  std::string::const_iterator it = data.begin() + header_size;
+  std::string::const_iterator end = data.end();
+  m_size = header_size;
+  while (it != end)
+  {
+    crypto::chacha_iv iv;
+    uint64_t cipher_size;
+    if (static_cast<size_t>(end - it) < sizeof(iv))
+      break;
+    memcpy(&iv, &*it, sizeof(iv));
+    it += sizeof(iv);
+    if (tools::read_varint(it, end, cipher_size) <= 0 || cipher_size < sizeof(crypto::hash) ||
+        cipher_size > static_cast<uint64_t>(end - it))
+      break;
+
+    std::string plain(cipher_size, '\0');
+    crypto::chacha20(&*it, cipher_size, key, iv, &plain[0]);
+    crypto::hash hash;
+    crypto::cn_fast_hash(plain.data() + sizeof(hash), plain.size() - sizeof(hash), hash);
+    if (memcmp(&hash, plain.data(), sizeof(hash)) != 0)
+      break;
+    it += cipher_size;
+
+    records.emplace_back(plain, sizeof(hash), std::string::npos);
+    ++m_num_records;
+    m_size = it - data.begin();
+  }
+
+  if (it != end)
+  {
+    MWARNING("Cache log " << filename << " ends in a torn or corrupt record, using the " << m_num_records << " records before it");
+    return false;
+  }
+  MDEBUG("Loaded cache log with " << m_num_records << " records, " << m_size << " bytes");
+  return true;
+}
+
+bool cache_log::append(const std::string &filename, const crypto::chacha_key &key, const std::string &record)
+{
+  if (!m_has_base)
+    return false;
+
+  std::string plain(sizeof(crypto::hash), '\0');
+  plain += record;
+  crypto::cn_fast_hash(record.data(), record.size(), *reinterpret_cast<crypto::hash*>(&plain[0]));
+
+  std::string data;
+  if (m_num_records == 0)
+  {
+    data.append(CACHE_LOG_MAGIC, sizeof(CACHE_LOG_MAGIC));
+    data.append(reinterpret_cast<const char*>(&m_base_iv), sizeof(m_base_iv));
+  }
+  const crypto::chacha_iv iv = crypto::rand<crypto::chacha_iv>();
+  data.append(reinterpret_cast<const char*>(&iv), sizeof(iv));
+  tools::write_varint(std::back_inserter(data), plain.size());
+  const size_t cipher_offset = data.size();
+  data.resize(cipher_offset + plain.size());
+  crypto::chacha20(plain.data(), plain.size(), key, iv, &data[cipher_offset]);
+
+  // the first record replaces whatever an older log left behind
+  const bool r = m_num_records == 0 ? epee::file_io_utils::save_string_to_file(filename, data) :
+      epee::file_io_utils::append_string_to_file(filename, data);
+  if (!r)
+    return false;
+  ++m_num_records;
+  m_size += data.size();
+  return true;
+}
+
+}
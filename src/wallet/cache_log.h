@@ -0,0 +1,79 @@
+// Copyright (c) 2021, The Monero Project
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of
+//    conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list
+//    of conditions and the following disclaimer in the documentation and/or other
+//    materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be
+//    used to endorse or promote products derived from this software without specific
+//    prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+// THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "crypto/chacha.h"
+
+namespace tools
+{
+  /**
+   * Append-only log of wallet cache updates, written on top of a full cache file
+   * - each record is encrypted with the cache key under its own iv, and carries a hash of its contents
+   *   so a torn or corrupt tail is detected
+   * - a log only applies to the cache file saved with the iv in its header; saving a new cache file
+   *   orphans it, so replacing the cache file is all a compaction has to do for the old log to be ignored
+   */
+  class cache_log
+  {
+  public:
+    cache_log();
+
+    /// forget the base and the records (the file is left alone)
+    void clear();
+    /// start an empty log on top of the cache file saved with 'base_iv', of 'base_size' bytes
+    void reset(const crypto::chacha_iv &base_iv, uint64_t base_size);
+    /**
+     * Read the records logged on top of the cache file saved with 'base_iv'
+     * - a missing log, or one for another cache file, has no records
+     * - returns false if the log ends in a torn or corrupt record; the records before it are still returned
+     */
+    bool load(const std::string &filename, const crypto::chacha_key &key, const crypto::chacha_iv &base_iv, uint64_t base_size,
+        std::vector<std::string> &records);
+    /// append one record, starting the file with its header if the log is empty
+    bool append(const std::string &filename, const crypto::chacha_key &key, const std::string &record);
+
+    bool has_base() const { return m_has_base; }
+    uint64_t base_size() const { return m_base_size; }
+    size_t num_records() const { return m_num_records; }
+    /// bytes in the log file, header included
+    uint64_t size() const { return m_size; }
+
+  private:
+    bool m_has_base;
+    crypto::chacha_iv m_base_iv;
+    uint64_t m_base_size;
+    size_t m_num_records;
+    uint64_t m_size;
+  };
+}
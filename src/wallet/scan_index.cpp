@@ -0,0 +1,258 @@
+// Copyright (c) 2021, The Monero Project
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of
+//    conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list
+//    of conditions and the following disclaimer in the documentation and/or other
+//    materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be
+//    used to endorse or promote products derived from this software without specific
+//    prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+// THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <tuple>
+#include "common/varint.h"
+#include "crypto/crypto.h"
+#include "file_io_utils.h"
+#include "misc_log_ex.h"
+#include "scan_index.h"
+
+#undef MONERO_DEFAULT_LOG_CATEGORY
+#define MONERO_DEFAULT_LOG_CATEGORY "wallet.scanindex"
+
+// plaintext prefix, also used to tell a wrong key from a good one
+static const char SCAN_INDEX_MAGIC[] = "Monero scan index v1";
+
+namespace
+{
+  bool match_less(const tools::scan_index::match &a, const tools::scan_index::match &b)
+  {
+    return std::make_tuple(a.height, a.tx_index, a.output_index) < std::make_tuple(b.height, b.tx_index, b.output_index);
+  }
+
+  template<typename T>
+  bool read(std::string::const_iterator &it, std::string::const_iterator end, T &value)
+  {
+    return tools::read_varint(it, end, value) > 0;
+  }
+}
+
+namespace tools
+{
+
+scan_index::scan_index():
+  m_start_height(0),
+  m_end_height(0),
+  m_top_hash(crypto::null_hash)
+{
+}
+
+void scan_index::clear()
+{
+  m_start_height = 0;
+  m_end_height = 0;
+  m_top_hash = crypto::null_hash;
+  m_matches.clear();
+  m_subaddress_checkpoints.clear();
+}
+
+void scan_index::crop(uint64_t height, const crypto::hash &top_hash)
+{
+  if (height >= m_end_height)
+    return;
+  if (height <= m_start_height)
+  {
+    clear();
+    return;
+  }
+
+  m_end_height = height;
+  m_top_hash = top_hash;
+  m_matches.erase(std::lower_bound(m_matches.begin(), m_matches.end(), match{height, 0, 0}, match_less), m_matches.end());
+  while (!m_subaddress_checkpoints.empty() && m_subaddress_checkpoints.back().first >= height)
+    m_subaddress_checkpoints.pop_back();
+}
+
+void scan_index::add_block(uint64_t height, const crypto::hash &block_hash, size_t num_subaddresses, std::vector<match> matches)
+{
+  if (m_end_height == m_start_height || height > m_end_height)
+  {
+    if (m_end_height != m_start_height)
+      MDEBUG("Scan index gap at height " << height << " (covered up to " << m_end_height << "), restarting it");
+    clear();
+    m_start_height = height;
+    m_end_height = height;
+  }
+  if (height < m_end_height)
+    return;
+
+  std::sort(matches.begin(), matches.end(), match_less);
+  for (const match &m: matches)
+  {
+    if (m.height == height)
+      m_matches.push_back(m);
+  }
+  if (m_subaddress_checkpoints.empty() || m_subaddress_checkpoints.back().second != num_subaddresses)
+    m_subaddress_checkpoints.emplace_back(height, num_subaddresses);
+  m_end_height = height + 1;
+  m_top_hash = block_hash;
+}
+
+bool scan_index::covers(uint64_t height, size_t num_subaddresses) const
+{
+  if (height < m_start_height || height >= m_end_height)
+    return false;
+
+  // the table size in effect at 'height' is the one of the last checkpoint at or below it
+  const auto it = std::upper_bound(m_subaddress_checkpoints.begin(), m_subaddress_checkpoints.end(), height,
+      [](uint64_t h, const std::pair<uint64_t, uint64_t> &checkpoint){ return h < checkpoint.first; });
+  if (it == m_subaddress_checkpoints.begin())
+    return false;
+  return num_subaddresses <= std::prev(it)->second;
+}
+
+bool scan_index::is_candidate(uint64_t height, uint32_t tx_index) const
+{
+  const auto it = std::lower_bound(m_matches.begin(), m_matches.end(), match{height, tx_index, 0}, match_less);
+  return it != m_matches.end() && it->height == height && it->tx_index == tx_index;
+}
+
+std::string scan_index::serialize() const
+{
+  // heights are delta coded, so a match usually costs 3 to 5 bytes
+  std::string blob(SCAN_INDEX_MAGIC, sizeof(SCAN_INDEX_MAGIC));
+  blob.append(reinterpret_cast<const char*>(&m_top_hash), sizeof(m_top_hash));
+  auto out = std::back_inserter(blob);
+  write_varint(out, m_start_height);
+  write_varint(out, m_end_height - m_start_height);
+
+  write_varint(out, m_subaddress_checkpoints.size());
+  uint64_t previous_height = m_start_height;
+  for (const auto &checkpoint: m_subaddress_checkpoints)
+  {
+    write_varint(out, checkpoint.first - previous_height);
+    write_varint(out, checkpoint.second);
+    previous_height = checkpoint.first;
+  }
+
+  write_varint(out, m_matches.size());
+  previous_height = m_start_height;
+  for (const match &m: m_matches)
+  {
+    write_varint(out, m.height - previous_height);
+    write_varint(out, m.tx_index);
+    write_varint(out, m.output_index);
+    previous_height = m.height;
+  }
+  return blob;
+}
+
+bool scan_index::deserialize(const std::string &blob)
+{
+  clear();
+  if (blob.size() < sizeof(SCAN_INDEX_MAGIC) || memcmp(blob.data(), SCAN_INDEX_MAGIC, sizeof(SCAN_INDEX_MAGIC)) != 0)
+    return false;
+
+  if (blob.size() < sizeof(SCAN_INDEX_MAGIC) + sizeof(crypto::hash))
+    return false;
+  crypto::hash top_hash;
+  memcpy(&top_hash, blob.data() + sizeof(SCAN_INDEX_MAGIC), sizeof(top_hash));
+
+  std::string::const_iterator it = blob.begin() + sizeof(SCAN_INDEX_MAGIC) + sizeof(crypto::hash);
+  const std::string::const_iterator end = blob.end();
+  uint64_t start_height, num_heights, num_checkpoints, num_matches;
+  if (!read(it, end, start_height) || !read(it, end, num_heights) || !read(it, end, num_checkpoints))
+    return false;
+
+  std::vector<std::pair<uint64_t, uint64_t>> checkpoints;
+  uint64_t height = start_height;
+  for (uint64_t n = 0; n < num_checkpoints; ++n)
+  {
+    uint64_t delta, num_subaddresses;
+    if (!read(it, end, delta) || !read(it, end, num_subaddresses))
+      return false;
+    height += delta;
+    checkpoints.emplace_back(height, num_subaddresses);
+  }
+
+  if (!read(it, end, num_matches))
+    return false;
+  std::vector<match> matches;
+  height = start_height;
+  for (uint64_t n = 0; n < num_matches; ++n)
+  {
+    uint64_t delta;
+    match m;
+    if (!read(it, end, delta) || !read(it, end, m.tx_index) || !read(it, end, m.output_index))
+      return false;
+    height += delta;
+    m.height = height;
+    matches.push_back(m);
+  }
+  if (it != end)
+    return false;
+
+  m_start_height = start_height;
+  m_end_height = start_height + num_heights;
+  m_top_hash = top_hash;
+  m_subaddress_checkpoints = std::move(checkpoints);
+  m_matches = std::move(matches);
+  return true;
+}
+
+bool scan_index::load(const std::string &filename, const crypto::chacha_key &key)
+{
+  clear();
+  std::string data;
+  if (!epee::file_io_utils::load_file_to_string(filename, data))
+    return false;
+  if (data.size() < sizeof(crypto::chacha_iv))
+  {
+    MWARNING("Scan index " << filename << " is too short, ignoring it");
+    return false;
+  }
+
+  crypto::chacha_iv iv;
+  memcpy(&iv, data.data(), sizeof(iv));
+  std::string blob(data.size() - sizeof(iv), '\0');
+  crypto::chacha20(data.data() + sizeof(iv), blob.size(), key, iv, &blob[0]);
+  if (!deserialize(blob))
+  {
+    MWARNING("Scan index " << filename << " is corrupt or for another wallet, ignoring it");
+    return false;
+  }
+  MDEBUG("Loaded scan index for heights " << m_start_height << "-" << m_end_height << ", " << m_matches.size() << " matches");
+  return true;
+}
+
+bool scan_index::store(const std::string &filename, const crypto::chacha_key &key) const
+{
+  const std::string blob = serialize();
+  const crypto::chacha_iv iv = crypto::rand<crypto::chacha_iv>();
+  std::string data(sizeof(iv) + blob.size(), '\0');
+  memcpy(&data[0], &iv, sizeof(iv));
+  crypto::chacha20(blob.data(), blob.size(), key, iv, &data[sizeof(iv)]);
+  return epee::file_io_utils::save_string_to_file(filename, data);
+}
+
+}
@@ -0,0 +1,99 @@
+// Copyright (c) 2021, The Monero Project
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of
+//    conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list
+//    of conditions and the following disclaimer in the documentation and/or other
+//    materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be
+//    used to endorse or promote products derived from this software without specific
+//    prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+// THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+#include "crypto/chacha.h"
+#include "crypto/hash.h"
+
+namespace tools
+{
+  /**
+   * Positions of the outputs matched by a wallet's view key over a contiguous range of scanned blocks
+   * - a rescan of a covered block only has to derive the txes listed here; every other tx in the block
+   *   was already found not to pay the wallet
+   * - txes are numbered within their block: 0 for the miner tx, i + 1 for the block's tx i
+   * - coverage of a block is only trusted while the wallet's subaddress table is no larger than it was
+   *   when the block was scanned, since outputs to later subaddresses could not have matched then
+   */
+  class scan_index
+  {
+  public:
+    struct match
+    {
+      uint64_t height;
+      uint32_t tx_index;
+      uint32_t output_index;
+    };
+
+    scan_index();
+
+    void clear();
+    /// forget every block from 'height' on (reorg); 'top_hash' is the hash of the block at height - 1
+    void crop(uint64_t height, const crypto::hash &top_hash);
+    /**
+     * Record the matches of the block 'block_hash' at 'height', scanned with 'num_subaddresses' subaddresses
+     * - a block below the covered range's end is ignored, a block past it restarts the index there
+     * - matches not at 'height' are dropped
+     */
+    void add_block(uint64_t height, const crypto::hash &block_hash, size_t num_subaddresses, std::vector<match> matches);
+    /// true if the block at 'height' was scanned with at least 'num_subaddresses' subaddresses
+    bool covers(uint64_t height, size_t num_subaddresses) const;
+    /// true if the tx 'tx_index' of the block at 'height' had a match
+    bool is_candidate(uint64_t height, uint32_t tx_index) const;
+
+    uint64_t start_height() const { return m_start_height; }
+    uint64_t end_height() const { return m_end_height; }
+    /// hash of the last covered block, to check the index still matches the chain
+    const crypto::hash &top_hash() const { return m_top_hash; }
+    size_t num_matches() const { return m_matches.size(); }
+
+    /// encrypted with 'key'; returns false (leaving the index empty) if the file is missing, corrupt, or for another key
+    bool load(const std::string &filename, const crypto::chacha_key &key);
+    bool store(const std::string &filename, const crypto::chacha_key &key) const;
+
+  private:
+    std::string serialize() const;
+    bool deserialize(const std::string &blob);
+
+  private:
+    // covered range [m_start_height, m_end_height)
+    uint64_t m_start_height;
+    uint64_t m_end_height;
+    crypto::hash m_top_hash;
+    // sorted by (height, tx_index, output_index)
+    std::vector<match> m_matches;
+    // (first height, subaddress table size) whenever the table size changed while recording
+    std::vector<std::pair<uint64_t, uint64_t>> m_subaddress_checkpoints;
+  };
+}
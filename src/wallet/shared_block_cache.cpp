@@ -0,0 +1,122 @@
+// Copyright (c) 2021, The Monero Project
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of
+//    conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list
+//    of conditions and the following disclaimer in the documentation and/or other
+//    materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be
+//    used to endorse or promote products derived from this software without specific
+//    prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+// THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include <algorithm>
+#include <ctime>
+#include "misc_log_ex.h"
+#include "shared_block_cache.h"
+
+#undef MONERO_DEFAULT_LOG_CATEGORY
+#define MONERO_DEFAULT_LOG_CATEGORY "wallet.wallet2"
+
+namespace tools
+{
+
+shared_block_cache::shared_block_cache(size_t max_batches, uint64_t max_age_seconds):
+  m_max_batches(std::max<size_t>(max_batches, 1)),
+  m_max_age_seconds(max_age_seconds),
+  m_hits(0),
+  m_misses(0)
+{
+}
+
+void shared_block_cache::prune_expired(uint64_t now)
+{
+  while (!m_batches.empty() && m_batches.front()->pulled_time + m_max_age_seconds < now)
+    m_batches.pop_front();
+}
+
+std::shared_ptr<const shared_block_cache::batch> shared_block_cache::find(const crypto::hash &top_hash, uint64_t start_height, bool no_miner_tx)
+{
+  boost::lock_guard<boost::mutex> lock(m_mutex);
+  prune_expired(time(NULL));
+
+  // newest first: after a reorg, the batch pulled last is the one on the daemon's chain
+  for (auto it = m_batches.rbegin(); it != m_batches.rend(); ++it)
+  {
+    const batch &b = **it;
+    if (b.parsed_blocks.front().hash != top_hash || b.no_miner_tx != no_miner_tx)
+      continue;
+    // the daemon would not send blocks below the requested start height
+    if (start_height > b.start_height)
+      continue;
+    ++m_hits;
+    return *it;
+  }
+
+  ++m_misses;
+  return nullptr;
+}
+
+void shared_block_cache::add(std::shared_ptr<const batch> b)
+{
+  if (!b || b->blocks.empty() || b->blocks.size() != b->parsed_blocks.size())
+    return;
+  for (const wallet2::parsed_block &pb: b->parsed_blocks)
+    if (pb.error)
+      return;
+
+  boost::lock_guard<boost::mutex> lock(m_mutex);
+  prune_expired(time(NULL));
+
+  // a newer pull of the same range replaces the older one
+  const crypto::hash &first_hash = b->parsed_blocks.front().hash;
+  for (auto it = m_batches.begin(); it != m_batches.end(); ++it)
+  {
+    if ((*it)->parsed_blocks.front().hash == first_hash && (*it)->no_miner_tx == b->no_miner_tx)
+    {
+      m_batches.erase(it);
+      break;
+    }
+  }
+
+  m_batches.push_back(std::move(b));
+  while (m_batches.size() > m_max_batches)
+    m_batches.pop_front();
+}
+
+void shared_block_cache::clear()
+{
+  boost::lock_guard<boost::mutex> lock(m_mutex);
+  m_batches.clear();
+}
+
+uint64_t shared_block_cache::hits() const
+{
+  boost::lock_guard<boost::mutex> lock(m_mutex);
+  return m_hits;
+}
+
+uint64_t shared_block_cache::misses() const
+{
+  boost::lock_guard<boost::mutex> lock(m_mutex);
+  return m_misses;
+}
+
+}
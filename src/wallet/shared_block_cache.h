@@ -0,0 +1,87 @@
+// Copyright (c) 2021, The Monero Project
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of
+//    conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list
+//    of conditions and the following disclaimer in the documentation and/or other
+//    materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be
+//    used to endorse or promote products derived from this software without specific
+//    prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+// THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#pragma once
+
+#include <boost/thread/mutex.hpp>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <vector>
+#include "crypto/hash.h"
+#include "wallet2.h"
+
+namespace tools
+{
+  /**
+   * Blocks pulled and parsed by one wallet, kept for the other wallets hosted in the same process
+   * - the daemon answers a wallet whose most recent known block is B with a batch starting at B, so a
+   *   batch is looked up by the hash of its first block
+   * - batches expire after 'max_age_seconds': a wallet never takes the tip from the cache for long
+   *   after a reorg, the next miss goes to the daemon and its reorg handling as usual
+   * - only the most recent 'max_batches' batches are kept
+   */
+  class shared_block_cache
+  {
+  public:
+    struct batch
+    {
+      uint64_t start_height;
+      uint64_t current_height;  // daemon height when pulled
+      bool no_miner_tx;
+      std::vector<cryptonote::block_complete_entry> blocks;
+      std::vector<wallet2::parsed_block> parsed_blocks;
+      uint64_t pulled_time;
+    };
+
+    shared_block_cache(size_t max_batches = 8, uint64_t max_age_seconds = 30);
+
+    /**
+     * The batch the daemon would send to a wallet whose most recent known block is 'top_hash',
+     * or nullptr if there is none still fresh
+     */
+    std::shared_ptr<const batch> find(const crypto::hash &top_hash, uint64_t start_height, bool no_miner_tx);
+    /// keep a batch just pulled from the daemon (empty batches and batches with parse errors are ignored)
+    void add(std::shared_ptr<const batch> b);
+    void clear();
+
+    uint64_t hits() const;
+    uint64_t misses() const;
+
+  private:
+    void prune_expired(uint64_t now);
+
+    mutable boost::mutex m_mutex;
+    std::deque<std::shared_ptr<const batch>> m_batches;  // oldest first
+    const size_t m_max_batches;
+    const uint64_t m_max_age_seconds;
+    uint64_t m_hits;
+    uint64_t m_misses;
+  };
+}
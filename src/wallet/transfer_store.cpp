@@ -0,0 +1,303 @@
+// Copyright (c) 2021, The Monero Project
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of
+//    conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list
+//    of conditions and the following disclaimer in the documentation and/or other
+//    materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be
+//    used to endorse or promote products derived from this software without specific
+//    prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+// THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+
+
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <sstream>
+#include "common/threadpool.h"
+#include "common/varint.h"
+#include "crypto/crypto.h"
+#include "file_io_utils.h"
+#include "int-util.h"
+#include "misc_log_ex.h"
+#include "serialization/binary_archive.h"
+#include "transfer_store.h"
+
+#undef MONERO_DEFAULT_LOG_CATEGORY
+#define MONERO_DEFAULT_LOG_CATEGORY "wallet.transferstore"
+
+#define TRANSFER_STORE_CHUNK_SIZE 4096 // transfers per chunk, the unit of parallel decoding
+
+static const char TRANSFER_STORE_MAGIC[] = "Monero wallet transfers v1";
+
+namespace
+{
+  enum : uint8_t
+  {
+    FLAG_SPENT = 1,
+    FLAG_FROZEN = 2,
+    FLAG_RCT = 4,
+    FLAG_KEY_IMAGE_KNOWN = 8,
+    FLAG_KEY_IMAGE_REQUEST = 16,
+    FLAG_KEY_IMAGE_PARTIAL = 32,
+  };
+
+  struct chunk_writer
+  {
+    std::string blob;
+
+    void put(uint64_t value) { value = SWAP64LE(value); blob.append(reinterpret_cast<const char*>(&value), sizeof(value)); }
+    void put(uint32_t value) { value = SWAP32LE(value); blob.append(reinterpret_cast<const char*>(&value), sizeof(value)); }
+    void put(uint8_t value) { blob.push_back(value); }
+    template<typename T>
+    void put_bytes(const T &value) { blob.append(reinterpret_cast<const char*>(&value), sizeof(value)); }
+  };
+
+  struct chunk_reader
+  {
+    const char *ptr;
+    const char *end;
+
+    bool get(uint64_t &value) { if (!get_bytes(value)) return false; value = SWAP64LE(value); return true; }
+    bool get(uint32_t &value) { if (!get_bytes(value)) return false; value = SWAP32LE(value); return true; }
+    bool get(uint8_t &value) { return get_bytes(value); }
+    template<typename T>
+    bool get_bytes(T &value)
+    {
+      if (static_cast<size_t>(end - ptr) < sizeof(value))
+        return false;
+      memcpy(&value, ptr, sizeof(value));
+      ptr += sizeof(value);
+      return true;
+    }
+  };
+
+  uint8_t get_flags(const tools::wallet2::transfer_details &td)
+  {
+    return (td.m_spent ? FLAG_SPENT : 0) | (td.m_frozen ? FLAG_FROZEN : 0) | (td.m_rct ? FLAG_RCT : 0) |
+        (td.m_key_image_known ? FLAG_KEY_IMAGE_KNOWN : 0) | (td.m_key_image_request ? FLAG_KEY_IMAGE_REQUEST : 0) |
+        (td.m_key_image_partial ? FLAG_KEY_IMAGE_PARTIAL : 0);
+  }
+
+  void set_flags(tools::wallet2::transfer_details &td, uint8_t flags)
+  {
+    td.m_spent = flags & FLAG_SPENT;
+    td.m_frozen = flags & FLAG_FROZEN;
+    td.m_rct = flags & FLAG_RCT;
+    td.m_key_image_known = flags & FLAG_KEY_IMAGE_KNOWN;
+    td.m_key_image_request = flags & FLAG_KEY_IMAGE_REQUEST;
+    td.m_key_image_partial = flags & FLAG_KEY_IMAGE_PARTIAL;
+  }
+
+  std::string encode_chunk(const tools::wallet2::transfer_details *transfers, size_t count)
+  {
+    chunk_writer w;
+    for (size_t i = 0; i < count; ++i) w.put(transfers[i].m_block_height);
+    for (size_t i = 0; i < count; ++i) w.put_bytes(transfers[i].m_txid);
+    for (size_t i = 0; i < count; ++i) w.put(transfers[i].m_internal_output_index);
+    for (size_t i = 0; i < count; ++i) w.put(transfers[i].m_global_output_index);
+    for (size_t i = 0; i < count; ++i) w.put(transfers[i].m_spent_height);
+    for (size_t i = 0; i < count; ++i) w.put(transfers[i].m_amount);
+    for (size_t i = 0; i < count; ++i) w.put(transfers[i].m_pk_index);
+    for (size_t i = 0; i < count; ++i) w.put(transfers[i].m_subaddr_index.major);
+    for (size_t i = 0; i < count; ++i) w.put(transfers[i].m_subaddr_index.minor);
+    for (size_t i = 0; i < count; ++i) w.put(get_flags(transfers[i]));
+    for (size_t i = 0; i < count; ++i) w.put_bytes(transfers[i].m_key_image);
+    for (size_t i = 0; i < count; ++i) w.put_bytes(transfers[i].m_mask);
+
+    std::ostringstream oss;
+    binary_archive<true> ar(oss);
+    for (size_t i = 0; i < count; ++i)
+    {
+      tools::wallet2::transfer_details &td = const_cast<tools::wallet2::transfer_details&>(transfers[i]);
+      CHECK_AND_ASSERT_THROW_MES(::do_serialize(ar, td.m_tx) && ::do_serialize(ar, td.m_multisig_k) &&
+          ::do_serialize(ar, td.m_multisig_info) && ::do_serialize(ar, td.m_uses), "Failed to serialize transfer");
+    }
+    w.blob += oss.str();
+    return std::move(w.blob);
+  }
+
+  bool decode_chunk(const char *blob, size_t size, tools::wallet2::transfer_details *transfers, size_t count)
+  {
+    chunk_reader r{blob, blob + size};
+    bool ok = true;
+    for (size_t i = 0; i < count; ++i) ok = ok && r.get(transfers[i].m_block_height);
+    for (size_t i = 0; i < count; ++i) ok = ok && r.get_bytes(transfers[i].m_txid);
+    for (size_t i = 0; i < count; ++i) ok = ok && r.get(transfers[i].m_internal_output_index);
+    for (size_t i = 0; i < count; ++i) ok = ok && r.get(transfers[i].m_global_output_index);
+    for (size_t i = 0; i < count; ++i) ok = ok && r.get(transfers[i].m_spent_height);
+    for (size_t i = 0; i < count; ++i) ok = ok && r.get(transfers[i].m_amount);
+    for (size_t i = 0; i < count; ++i) ok = ok && r.get(transfers[i].m_pk_index);
+    for (size_t i = 0; i < count; ++i) ok = ok && r.get(transfers[i].m_subaddr_index.major);
+    for (size_t i = 0; i < count; ++i) ok = ok && r.get(transfers[i].m_subaddr_index.minor);
+    for (size_t i = 0; i < count; ++i)
+    {
+      uint8_t flags = 0;
+      ok = ok && r.get(flags);
+      set_flags(transfers[i], flags);
+    }
+    for (size_t i = 0; i < count; ++i) ok = ok && r.get_bytes(transfers[i].m_key_image);
+    for (size_t i = 0; i < count; ++i) ok = ok && r.get_bytes(transfers[i].m_mask);
+    if (!ok)
+      return false;
+
+    binary_archive<false> ar{epee::span<const std::uint8_t>(reinterpret_cast<const std::uint8_t*>(r.ptr), r.end - r.ptr)};
+    for (size_t i = 0; i < count; ++i)
+    {
+      tools::wallet2::transfer_details &td = transfers[i];
+      if (!::do_serialize(ar, td.m_tx) || !::do_serialize(ar, td.m_multisig_k) ||
+          !::do_serialize(ar, td.m_multisig_info) || !::do_serialize(ar, td.m_uses))
+        return false;
+    }
+    return ::serialization::check_stream_state(ar);
+  }
+}
+
+namespace tools
+{
+namespace transfer_store
+{
+
+bool store(const std::string &filename, const crypto::chacha_key &key, const crypto::hash &id,
+    const wallet2::transfer_container &transfers)
+{
+  const size_t num_chunks = (transfers.size() + TRANSFER_STORE_CHUNK_SIZE - 1) / TRANSFER_STORE_CHUNK_SIZE;
+  std::vector<std::string> chunks(num_chunks);
+  const bool r = tools::parallel_for(0, num_chunks, 1, [&](const size_t begin, const size_t end){
+    for (size_t chunk = begin; chunk < end; ++chunk)
+    {
+      const size_t first = chunk * TRANSFER_STORE_CHUNK_SIZE;
+      const size_t count = std::min<size_t>(TRANSFER_STORE_CHUNK_SIZE, transfers.size() - first);
+
+      // the hash lets a load tell a corrupt chunk, or another key, from a good one
+      std::string plain(sizeof(crypto::hash), '\0');
+      plain += encode_chunk(transfers.data() + first, count);
+      crypto::cn_fast_hash(plain.data() + sizeof(crypto::hash), plain.size() - sizeof(crypto::hash),
+          *reinterpret_cast<crypto::hash*>(&plain[0]));
+
+      const crypto::chacha_iv iv = crypto::rand<crypto::chacha_iv>();
+      std::string &data = chunks[chunk];
+      data.append(reinterpret_cast<const char*>(&iv), sizeof(iv));
+      tools::write_varint(std::back_inserter(data), plain.size());
+      const size_t cipher_offset = data.size();
+      data.resize(cipher_offset + plain.size());
+      crypto::chacha20(plain.data(), plain.size(), key, iv, &data[cipher_offset]);
+    }
+  });
+  if (!r)
+  {
+    MERROR("Failed to encode transfers");
+    return false;
+  }
+
+  std::string data(TRANSFER_STORE_MAGIC, sizeof(TRANSFER_STORE_MAGIC));
+  data.append(reinterpret_cast<const char*>(&id), sizeof(id));
+  tools::write_varint(std::back_inserter(data), transfers.size());
+  tools::write_varint(std::back_inserter(data), static_cast<uint64_t>(TRANSFER_STORE_CHUNK_SIZE));
+  for (const std::string &chunk: chunks)
+    data += chunk;
+  return epee::file_io_utils::save_string_to_file(filename, data);
+}
+
+bool load(const std::string &filename, const crypto::chacha_key &key, const crypto::hash &id,
+    wallet2::transfer_container &transfers)
+{
+  std::string data;
+  if (!epee::file_io_utils::load_file_to_string(filename, data, std::numeric_limits<size_t>::max()))
+  {
+    MERROR("Failed to read transfer store " << filename);
+    return false;
+  }
+
+  const size_t header_size = sizeof(TRANSFER_STORE_MAGIC) + sizeof(crypto::hash);
+  if (data.size() < header_size || memcmp(data.data(), TRANSFER_STORE_MAGIC, sizeof(TRANSFER_STORE_MAGIC)) != 0 ||
+      memcmp(data.data() + sizeof(TRANSFER_STORE_MAGIC), &id, sizeof(id)) != 0)
+  {
+    MERROR("Transfer store " << filename << " is corrupt or does not belong to this cache file");
+    return false;
+  }
+
+  std::string::const_iterator it = data.begin() + header_size;
+  std::string::const_iterator end = data.end();
+  uint64_t num_transfers, chunk_size;
+  if (tools::read_varint(it, end, num_transfers) <= 0 || tools::read_varint(it, end, chunk_size) <= 0 || chunk_size == 0)
+    return false;
+
+  // find the chunks first, so they can be decoded in parallel
+  struct chunk_ref
+  {
+    crypto::chacha_iv iv;
+    const char *cipher;
+    size_t size;
+  };
+  std::vector<chunk_ref> chunk_refs;
+  while (it != end)
+  {
+    chunk_ref ref;
+    uint64_t size;
+    if (static_cast<size_t>(end - it) < sizeof(ref.iv))
+      return false;
+    memcpy(&ref.iv, &*it, sizeof(ref.iv));
+    it += sizeof(ref.iv);
+    if (tools::read_varint(it, end, size) <= 0 || size < sizeof(crypto::hash) || size > static_cast<uint64_t>(end - it))
+      return false;
+    ref.cipher = &*it;
+    ref.size = size;
+    chunk_refs.push_back(ref);
+    it += size;
+  }
+  if (chunk_refs.size() != (num_transfers + chunk_size - 1) / chunk_size)
+  {
+    MERROR("Transfer store " << filename << " is truncated");
+    return false;
+  }
+
+  wallet2::transfer_container loaded(num_transfers);
+  const bool r = tools::parallel_for(0, chunk_refs.size(), 1, [&](const size_t begin, const size_t end){
+    for (size_t chunk = begin; chunk < end; ++chunk)
+    {
+      const chunk_ref &ref = chunk_refs[chunk];
+      std::string plain(ref.size, '\0');
+      crypto::chacha20(ref.cipher, ref.size, key, ref.iv, &plain[0]);
+      crypto::hash hash;
+      crypto::cn_fast_hash(plain.data() + sizeof(hash), plain.size() - sizeof(hash), hash);
+      CHECK_AND_ASSERT_THROW_MES(memcmp(&hash, plain.data(), sizeof(hash)) == 0, "Transfer store chunk " << chunk << " is corrupt");
+
+      const size_t first = chunk * chunk_size;
+      const size_t count = std::min<uint64_t>(chunk_size, num_transfers - first);
+      CHECK_AND_ASSERT_THROW_MES(decode_chunk(plain.data() + sizeof(hash), plain.size() - sizeof(hash), loaded.data() + first, count),
+          "Failed to decode transfer store chunk " << chunk);
+    }
+  });
+  if (!r)
+  {
+    MERROR("Failed to load transfer store " << filename);
+    return false;
+  }
+
+  transfers = std::move(loaded);
+  MDEBUG("Loaded " << transfers.size() << " transfers in " << chunk_refs.size() << " chunks from " << filename);
+  return true;
+}
+
+}
+}
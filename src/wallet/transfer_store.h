@@ -0,0 +1,55 @@
+// Copyright (c) 2021, The Monero Project
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of
+//    conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list
+//    of conditions and the following disclaimer in the documentation and/or other
+//    materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be
+//    used to endorse or promote products derived from this software without specific
+//    prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+// THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+
+#pragma once
+
+#include <string>
+#include "crypto/chacha.h"
+#include "crypto/hash.h"
+#include "wallet2.h"
+
+namespace tools
+{
+  /**
+   * Columnar form of a wallet's transfers, stored next to its cache file
+   * - transfers are split in chunks, each encrypted on its own, so loading decrypts and decodes chunks in parallel
+   * - within a chunk every fixed size field is stored as an array, and the variable size ones (tx prefix,
+   *   multisig data, uses) follow in a single blob
+   * - a store is tagged with a random id, which the cache file refers to in place of its transfers
+   */
+  namespace transfer_store
+  {
+    bool store(const std::string &filename, const crypto::chacha_key &key, const crypto::hash &id,
+        const wallet2::transfer_container &transfers);
+    /// fails if the file is missing, corrupt, encrypted with another key, or does not carry 'id'
+    bool load(const std::string &filename, const crypto::chacha_key &key, const crypto::hash &id,
+        wallet2::transfer_container &transfers);
+  }
+}
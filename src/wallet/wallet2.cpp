@@ -31,6 +31,7 @@
 #include <numeric>
 #include <tuple>
 #include <queue>
+#include <type_traits>
 #include <boost/format.hpp>
 #include <boost/optional/optional.hpp>
 #include <boost/algorithm/string/classification.hpp>
@@ -50,6 +51,7 @@ using namespace epee;
 #include "wallet_rpc_helpers.h"
 #include "wallet2.h"
 #include "wallet_args.h"
+#include "transfer_store.h"
 #include "cryptonote_basic/cryptonote_format_utils.h"
 #include "net/parse.h"
 #include "rpc/core_rpc_server_commands_defs.h"
@@ -84,6 +86,7 @@ using namespace epee;
 #include "common/perf_timer.h"
 #include "ringct/rctSigs.h"
 #include "ringdb.h"
+#include "shared_block_cache.h"
 #include "device/device_cold.hpp"
 #include "device_trezor/device_trezor.hpp"
 #include "net/socks_connect.h"
@@ -135,6 +138,8 @@ using namespace cryptonote;
 
 #define FIRST_REFRESH_GRANULARITY     1024
 
+#define RCT_DISTRIBUTION_REORG_DEPTH 10 /* blocks refetched on top of a cached rct distribution */
+
 #define GAMMA_SHAPE 19.28
 #define GAMMA_SCALE (1/1.61)
 
@@ -148,6 +153,11 @@ using namespace cryptonote;
 #define DEFAULT_UNLOCK_TIME (CRYPTONOTE_DEFAULT_TX_SPENDABLE_AGE * DIFFICULTY_TARGET_V2)
 #define RECENT_SPEND_WINDOW (15 * DIFFICULTY_TARGET_V2)
 
+#define SCAN_INDEX_REORG_GUARD 100 // the newest blocks of a scan index are always rescanned in full, in case they were reorged
+
+#define CACHE_LOG_COMPACTION_RATIO 2 // the cache log is folded into a full save once it reaches this fraction of the cache file
+#define CACHE_LOG_MAX_RECORDS 1000 // bounds the records replayed on load
+
 static const std::string MULTISIG_SIGNATURE_MAGIC = "SigMultisigPkV1";
 static const std::string MULTISIG_EXTRA_INFO_MAGIC = "MultisigxV1";
 
@@ -1003,6 +1013,75 @@ bool get_pruned_tx(const cryptonote::COMMAND_RPC_GET_TRANSACTIONS::entry &entry,
   return false;
 }
 
+// FNV-1a over everything in a transfer but its tx prefix, which is fixed by its txid and output index
+// - only used to spot transfers changed since the last save, so it does not need to resist collisions
+class transfer_fingerprint
+{
+public:
+  transfer_fingerprint(): m_hash(14695981039346656037ull) {}
+
+  template<typename T>
+  void add(const T &value)
+  {
+    static_assert(std::is_trivially_copyable<T>::value, "fingerprints are taken over plain data");
+    const unsigned char *data = reinterpret_cast<const unsigned char*>(&value);
+    for (size_t i = 0; i < sizeof(T); ++i)
+    {
+      m_hash ^= data[i];
+      m_hash *= 1099511628211ull;
+    }
+  }
+
+  template<typename T>
+  void add(const std::vector<T> &values)
+  {
+    add(values.size());
+    for (const T &value: values)
+      add(value);
+  }
+
+  uint64_t get() const { return m_hash; }
+
+private:
+  uint64_t m_hash;
+};
+
+uint64_t get_transfer_fingerprint(const tools::wallet2::transfer_details &td)
+{
+  transfer_fingerprint fp;
+  fp.add(td.m_block_height);
+  fp.add(td.m_txid);
+  fp.add(td.m_internal_output_index);
+  fp.add(td.m_global_output_index);
+  fp.add(td.m_spent);
+  fp.add(td.m_frozen);
+  fp.add(td.m_spent_height);
+  fp.add(td.m_key_image);
+  fp.add(td.m_mask);
+  fp.add(td.m_amount);
+  fp.add(td.m_rct);
+  fp.add(td.m_key_image_known);
+  fp.add(td.m_key_image_request);
+  fp.add(td.m_pk_index);
+  fp.add(td.m_subaddr_index);
+  fp.add(td.m_key_image_partial);
+  fp.add(td.m_multisig_k);
+  fp.add(td.m_multisig_info.size());
+  for (const auto &info: td.m_multisig_info)
+  {
+    fp.add(info.m_signer);
+    fp.add(info.m_LR);
+    fp.add(info.m_partial_key_images);
+  }
+  fp.add(td.m_uses.size());
+  for (const auto &use: td.m_uses)
+  {
+    fp.add(use.first);
+    fp.add(use.second);
+  }
+  return fp.get();
+}
+
   //-----------------------------------------------------------------
 } //namespace
 
@@ -1202,6 +1281,9 @@ wallet2::wallet2(network_type nettype, uint64_t kdf_rounds, bool unattended, std
   m_ignore_outputs_above(MONEY_SUPPLY),
   m_ignore_outputs_below(0),
   m_track_uses(false),
+  m_use_scan_index(false),
+  m_incremental_cache(false),
+  m_columnar_transfers(false),
   m_inactivity_lock_timeout(DEFAULT_INACTIVITY_LOCK_TIMEOUT),
   m_setup_background_mining(BackgroundMiningMaybe),
   m_persistent_rpc_client_id(false),
@@ -1227,6 +1309,15 @@ wallet2::wallet2(network_type nettype, uint64_t kdf_rounds, bool unattended, std
   m_key_device_type(hw::device::device_type::SOFTWARE),
   m_ring_history_saved(false),
   m_ringdb(),
+  m_scan_index_verified(false),
+  m_cache_log_height(0),
+  m_cache_log_chain_offset(0),
+  m_cache_log_num_subaddresses(0),
+  m_cache_log_force_full(true),
+  m_transfer_store_id(crypto::null_hash),
+  m_unspent_transfers_size(0),
+  m_unspent_transfers_dirty(true),
+  m_rct_distribution_start_height(0),
   m_last_block_reward(0),
   m_unattended(unattended),
   m_devices_registered(false),
@@ -1357,6 +1448,7 @@ bool wallet2::set_daemon(std::string daemon_address, boost::optional<epee::net_u
     m_rpc_payment_state.expected_spent = 0;
     m_rpc_payment_state.discrepancy = 0;
     m_node_rpc_proxy.invalidate();
+    m_rct_distribution.clear();
   }
 
   const std::string address = get_daemon_address();
@@ -1579,6 +1671,44 @@ bool wallet2::should_expand(const cryptonote::subaddress_index &index) const
   return true;
 }
 //----------------------------------------------------------------------------------------------------
+// spend pubkeys of minor indices [begin, end) of each account in 'ranges' (major, begin, end)
+// - in software, the ranges are split into chunks computed on the threadpool; a hardware device gets one call per range
+static std::vector<std::vector<crypto::public_key>> get_subaddress_spend_public_keys_mt(hw::device &hwdev,
+  const cryptonote::account_keys &keys, const std::vector<std::tuple<uint32_t, uint32_t, uint32_t>> &ranges)
+{
+  static constexpr uint32_t chunk_size = 1024;
+
+  std::vector<std::vector<crypto::public_key>> pkeys(ranges.size());
+  tools::threadpool& tpool = tools::threadpool::getInstance();
+  if (hwdev.get_type() != hw::device::device_type::SOFTWARE || tpool.get_max_concurrency() <= 1)
+  {
+    for (size_t n = 0; n < ranges.size(); ++n)
+      pkeys[n] = hwdev.get_subaddress_spend_public_keys(keys, std::get<0>(ranges[n]), std::get<1>(ranges[n]), std::get<2>(ranges[n]));
+    return pkeys;
+  }
+
+  tools::threadpool::waiter waiter(tpool);
+  for (size_t n = 0; n < ranges.size(); ++n)
+  {
+    const uint32_t major = std::get<0>(ranges[n]);
+    const uint32_t begin = std::get<1>(ranges[n]);
+    const uint32_t end = std::get<2>(ranges[n]);
+    THROW_WALLET_EXCEPTION_IF(begin > end, error::wallet_internal_error, "begin > end");
+    pkeys[n].resize(end - begin);
+    for (uint32_t chunk_begin = begin; chunk_begin < end; chunk_begin += std::min(chunk_size, end - chunk_begin))
+    {
+      const uint32_t chunk_end = chunk_begin + std::min(chunk_size, end - chunk_begin);
+      crypto::public_key *out = pkeys[n].data() + (chunk_begin - begin);
+      tpool.submit(&waiter, [&hwdev, &keys, major, chunk_begin, chunk_end, out](){
+        const std::vector<crypto::public_key> chunk = hwdev.get_subaddress_spend_public_keys(keys, major, chunk_begin, chunk_end);
+        std::copy(chunk.begin(), chunk.end(), out);
+      });
+    }
+  }
+  THROW_WALLET_EXCEPTION_IF(!waiter.wait(), error::wallet_internal_error, "Exception in thread pool");
+  return pkeys;
+}
+//----------------------------------------------------------------------------------------------------
 void wallet2::expand_subaddresses(const cryptonote::subaddress_index& index)
 {
   hw::device &hwdev = m_account.get_device();
@@ -1587,14 +1717,19 @@ void wallet2::expand_subaddresses(const cryptonote::subaddress_index& index)
     // add new accounts
     cryptonote::subaddress_index index2;
     const uint32_t major_end = get_subaddress_clamped_sum(index.major, m_subaddress_lookahead_major);
+    std::vector<std::tuple<uint32_t, uint32_t, uint32_t>> ranges;
     for (index2.major = m_subaddress_labels.size(); index2.major < major_end; ++index2.major)
+      ranges.emplace_back(index2.major, 0, get_subaddress_clamped_sum((index2.major == index.major ? index.minor : 0), m_subaddress_lookahead_minor));
+    const std::vector<std::vector<crypto::public_key>> pkeys = get_subaddress_spend_public_keys_mt(hwdev, m_account.get_keys(), ranges);
+    for (size_t n = 0; n < ranges.size(); ++n)
     {
-      const uint32_t end = get_subaddress_clamped_sum((index2.major == index.major ? index.minor : 0), m_subaddress_lookahead_minor);
-      const std::vector<crypto::public_key> pkeys = hwdev.get_subaddress_spend_public_keys(m_account.get_keys(), index2.major, 0, end);
+      index2.major = std::get<0>(ranges[n]);
+      const uint32_t end = std::get<2>(ranges[n]);
       for (index2.minor = 0; index2.minor < end; ++index2.minor)
       {
-         const crypto::public_key &D = pkeys[index2.minor];
+         const crypto::public_key &D = pkeys[n][index2.minor];
          m_subaddresses[D] = index2;
+         m_subaddress_table.insert(D, index2);
       }
     }
     m_subaddress_labels.resize(index.major + 1, {"Untitled account"});
@@ -1607,11 +1742,12 @@ void wallet2::expand_subaddresses(const cryptonote::subaddress_index& index)
     const uint32_t end = get_subaddress_clamped_sum(index.minor, m_subaddress_lookahead_minor);
     const uint32_t begin = m_subaddress_labels[index.major].size();
     cryptonote::subaddress_index index2 = {index.major, begin};
-    const std::vector<crypto::public_key> pkeys = hwdev.get_subaddress_spend_public_keys(m_account.get_keys(), index2.major, index2.minor, end);
+    const std::vector<std::vector<crypto::public_key>> pkeys = get_subaddress_spend_public_keys_mt(hwdev, m_account.get_keys(), {std::make_tuple(index2.major, begin, end)});
     for (; index2.minor < end; ++index2.minor)
     {
-       const crypto::public_key &D = pkeys[index2.minor - begin];
+       const crypto::public_key &D = pkeys[0][index2.minor - begin];
        m_subaddresses[D] = index2;
+       m_subaddress_table.insert(D, index2);
     }
     m_subaddress_labels[index.major].resize(index.minor + 1);
   }
@@ -1621,6 +1757,7 @@ void wallet2::create_one_off_subaddress(const cryptonote::subaddress_index& inde
 {
   const crypto::public_key pkey = get_subaddress_spend_public_key(index);
   m_subaddresses[pkey] = index;
+  m_subaddress_table.insert(pkey, index);
 }
 //----------------------------------------------------------------------------------------------------
 std::string wallet2::get_subaddress_label(const cryptonote::subaddress_index& index) const
@@ -1706,6 +1843,8 @@ void wallet2::set_spent(size_t idx, uint64_t height)
   LOG_PRINT_L2("Setting SPENT at " << height << ": ki " << td.m_key_image << ", amount " << print_money(td.m_amount));
   td.m_spent = true;
   td.m_spent_height = height;
+  if (idx < m_unspent_transfers_size)
+    m_unspent_transfers[td.m_subaddr_index.major].erase(idx);
 }
 //----------------------------------------------------------------------------------------------------
 void wallet2::set_unspent(size_t idx)
@@ -1715,6 +1854,8 @@ void wallet2::set_unspent(size_t idx)
   LOG_PRINT_L2("Setting UNSPENT: ki " << td.m_key_image << ", amount " << print_money(td.m_amount));
   td.m_spent = false;
   td.m_spent_height = 0;
+  if (idx < m_unspent_transfers_size)
+    m_unspent_transfers[td.m_subaddr_index.major].insert(idx);
 }
 //----------------------------------------------------------------------------------------------------
 bool wallet2::is_spent(const transfer_details &td, bool strict) const
@@ -1729,6 +1870,31 @@ bool wallet2::is_spent(const transfer_details &td, bool strict) const
   }
 }
 //----------------------------------------------------------------------------------------------------
+const std::map<uint32_t, std::set<size_t>> &wallet2::get_unspent_transfers()
+{
+  if (m_unspent_transfers_dirty || m_unspent_transfers_size > m_transfers.size())
+  {
+    m_unspent_transfers.clear();
+    m_unspent_transfers_size = 0;
+    m_unspent_transfers_dirty = false;
+  }
+  for (; m_unspent_transfers_size < m_transfers.size(); ++m_unspent_transfers_size)
+  {
+    const transfer_details &td = m_transfers[m_unspent_transfers_size];
+    if (!is_spent(td, false))
+      m_unspent_transfers[td.m_subaddr_index.major].insert(m_unspent_transfers_size);
+  }
+  return m_unspent_transfers;
+}
+//----------------------------------------------------------------------------------------------------
+const std::set<size_t> &wallet2::get_unspent_transfers(uint32_t index_major)
+{
+  static const std::set<size_t> empty;
+  const std::map<uint32_t, std::set<size_t>> &unspent_transfers = get_unspent_transfers();
+  const auto it = unspent_transfers.find(index_major);
+  return it == unspent_transfers.end() ? empty : it->second;
+}
+//----------------------------------------------------------------------------------------------------
 bool wallet2::is_spent(size_t idx, bool strict) const
 {
   CHECK_AND_ASSERT_THROW_MES(idx < m_transfers.size(), "Invalid index");
@@ -1788,6 +1954,14 @@ bool wallet2::frozen(const transfer_details &td) const
   return td.m_frozen;
 }
 //----------------------------------------------------------------------------------------------------
+boost::optional<cryptonote::subaddress_receive_info> wallet2::is_out_to_acc(const crypto::public_key &out_key, const crypto::key_derivation &derivation, const std::vector<crypto::key_derivation> &additional_derivations, size_t i, hw::device &hwdev) const
+{
+  // the table is kept in step with m_subaddresses; should they ever disagree, the map is authoritative
+  if (m_subaddress_table.size() == m_subaddresses.size())
+    return is_out_to_acc_precomp(m_subaddress_table, out_key, derivation, additional_derivations, i, hwdev);
+  return is_out_to_acc_precomp(m_subaddresses, out_key, derivation, additional_derivations, i, hwdev);
+}
+//----------------------------------------------------------------------------------------------------
 void wallet2::check_acc_out_precomp(const tx_out &o, const crypto::key_derivation &derivation, const std::vector<crypto::key_derivation> &additional_derivations, size_t i, tx_scan_info_t &tx_scan_info) const
 {
   hw::device &hwdev = m_account.get_device();
@@ -1799,7 +1973,7 @@ void wallet2::check_acc_out_precomp(const tx_out &o, const crypto::key_derivatio
      LOG_ERROR("wrong type id in transaction out");
      return;
   }
-  tx_scan_info.received = is_out_to_acc_precomp(m_subaddresses, boost::get<txout_to_key>(o.target).key, derivation, additional_derivations, i, hwdev);
+  tx_scan_info.received = is_out_to_acc(boost::get<txout_to_key>(o.target).key, derivation, additional_derivations, i, hwdev);
   if(tx_scan_info.received)
   {
     tx_scan_info.money_transfered = o.amount; // may be 0 for ringct outputs
@@ -1867,6 +2041,7 @@ static uint64_t decodeRct(const rct::rctSig & rv, const crypto::key_derivation &
 //----------------------------------------------------------------------------------------------------
 void wallet2::scan_output(const cryptonote::transaction &tx, bool miner_tx, const crypto::public_key &tx_pub_key, size_t i, tx_scan_info_t &tx_scan_info, int &num_vouts_received, std::unordered_map<cryptonote::subaddress_index, uint64_t> &tx_money_got_in_outs, std::vector<size_t> &outs, bool pool)
 {
+  PERF_TIMER(scan_output);
   THROW_WALLET_EXCEPTION_IF(i >= tx.vout.size(), error::wallet_internal_error, "Invalid vout index");
 
   // if keys are encrypted, ask for password
@@ -2766,81 +2941,161 @@ void wallet2::process_parsed_blocks(uint64_t start_height, const std::vector<cry
   for (size_t i = 0; i < blocks.size(); ++i)
     num_txes += 1 + parsed_blocks[i].txes.size();
   tx_cache_data.resize(num_txes);
-  size_t txidx = 0;
-  for (size_t i = 0; i < blocks.size(); ++i)
-  {
-    THROW_WALLET_EXCEPTION_IF(parsed_blocks[i].txes.size() != parsed_blocks[i].block.tx_hashes.size(),
-        error::wallet_internal_error, "Mismatched parsed_blocks[i].txes.size() and parsed_blocks[i].block.tx_hashes.size()");
-    if (should_skip_block(parsed_blocks[i].block, start_height + i))
-    {
-      txidx += 1 + parsed_blocks[i].block.tx_hashes.size();
-      continue;
-    }
-    if (m_refresh_type != RefreshNoCoinbase)
-      tpool.submit(&waiter, [&, i, txidx](){ cache_tx_data(parsed_blocks[i].block.miner_tx, get_transaction_hash(parsed_blocks[i].block.miner_tx), tx_cache_data[txidx]); });
-    ++txidx;
-    for (size_t idx = 0; idx < parsed_blocks[i].txes.size(); ++idx)
-    {
-      tpool.submit(&waiter, [&, i, idx, txidx](){ cache_tx_data(parsed_blocks[i].txes[idx], parsed_blocks[i].block.tx_hashes[idx], tx_cache_data[txidx]); });
-      ++txidx;
-    }
-  }
-  THROW_WALLET_EXCEPTION_IF(txidx != num_txes, error::wallet_internal_error, "txidx does not match tx_cache_data size");
-  THROW_WALLET_EXCEPTION_IF(!waiter.wait(), error::wallet_internal_error, "Exception in thread pool");
 
   hw::device &hwdev =  m_account.get_device();
   hw::reset_mode rst(hwdev);
   hwdev.set_mode(hw::device::TRANSACTION_PARSE);
   const cryptonote::account_keys &keys = m_account.get_keys();
 
-  auto gender = [&](wallet2::is_out_data &iod) {
-    if (!hwdev.generate_key_derivation(iod.pkey, keys.m_view_secret_key, iod.derivation))
-    {
-      MWARNING("Failed to generate key derivation from tx pubkey, skipping");
-      static_assert(sizeof(iod.derivation) == sizeof(rct::key), "Mismatched sizes of key_derivation and rct::key");
-      memcpy(&iod.derivation, rct::identity().bytes, sizeof(iod.derivation));
-    }
+  struct tx_cache_job
+  {
+    const cryptonote::transaction *tx;
+    const crypto::hash *txid; // null for the miner tx, whose hash is computed in the job
+    size_t n_vouts;
+    size_t txidx;
+    bool scan; // false if the scan index shows none of the outputs are ours
   };
 
-  for (size_t i = 0; i < tx_cache_data.size(); ++i)
+  // the scan index is only trusted once checked against the chain, and is only extended if it is either
+  // trusted or empty; the subaddress table size is taken before scanning, as later growth in this batch
+  // is not seen by the precomputed results
+  const size_t num_subaddresses = m_subaddresses.size();
+  const bool use_scan_index = m_use_scan_index && m_scan_index_verified;
+  const bool record_scan_index = m_use_scan_index && (m_scan_index_verified || m_scan_index.end_height() == m_scan_index.start_height());
+
+  // an output key to test against the subaddresses with one derivation; a match is recorded in primary[l]
+  struct out_query
   {
-    if (tx_cache_data[i].empty())
-      continue;
-    tpool.submit(&waiter, [&gender, &tx_cache_data, i]() {
-      auto &slot = tx_cache_data[i];
+    size_t txidx;
+    size_t k;
+    size_t l;
+    crypto::public_key out_key;
+    crypto::key_derivation derivation;
+  };
+  const bool use_subaddress_table = m_subaddress_table.size() == m_subaddresses.size();
+  auto check_outs = [&](const std::vector<out_query> &queries) {
+    if (queries.empty())
+      return;
+    std::vector<crypto::public_key> out_keys;
+    std::vector<crypto::key_derivation> derivations;
+    std::vector<size_t> output_indices;
+    out_keys.reserve(queries.size());
+    derivations.reserve(queries.size());
+    output_indices.reserve(queries.size());
+    for (const out_query &query: queries)
+    {
+      out_keys.push_back(query.out_key);
+      derivations.push_back(query.derivation);
+      output_indices.push_back(query.k);
+    }
+    std::vector<crypto::public_key> spendkeys(queries.size());
+    std::unique_ptr<bool[]> valid(new bool[queries.size()]);
+    hwdev.derive_subaddress_public_keys(out_keys.data(), derivations.data(), output_indices.data(), queries.size(), spendkeys.data(), valid.get());
+    for (size_t n = 0; n < queries.size(); ++n)
+    {
+      if (!valid[n])
+        continue;
+      // the table is kept in step with m_subaddresses; should they ever disagree, the map is authoritative
+      const cryptonote::subaddress_index *found = nullptr;
+      if (use_subaddress_table)
+        found = m_subaddress_table.find(spendkeys[n]);
+      else
+      {
+        const auto it = m_subaddresses.find(spendkeys[n]);
+        if (it != m_subaddresses.end())
+          found = &it->second;
+      }
+      if (found)
+        tx_cache_data[queries[n].txidx].primary[queries[n].l].received[queries[n].k] = cryptonote::subaddress_receive_info{*found, queries[n].derivation};
+    }
+  };
+
+  // parse, derive and precompute output ownership for a run of txes in a single job, so a batch only
+  // waits on the pool once instead of draining it between the three stages
+  // - all tx pubkeys of a run go through one batched derivation, which shares point decompression
+  //   and compression work across them
+  std::vector<tx_cache_job> tx_cache_jobs;
+  tx_cache_jobs.reserve(num_txes);
+  auto prepare_txes = [&](size_t begin, size_t end) {
+    std::vector<wallet2::is_out_data*> iods;
+    for (size_t n = begin; n < end; ++n)
+    {
+      const tx_cache_job &job = tx_cache_jobs[n];
+      auto &slot = tx_cache_data[job.txidx];
+      cache_tx_data(*job.tx, job.txid ? *job.txid : get_transaction_hash(*job.tx), slot);
+      if (!job.scan)
+        continue;
       for (auto &iod: slot.primary)
-        gender(iod);
+        iods.push_back(&iod);
       for (auto &iod: slot.additional)
-        gender(iod);
-    }, true);
-  }
-  THROW_WALLET_EXCEPTION_IF(!waiter.wait(), error::wallet_internal_error, "Exception in thread pool");
+        iods.push_back(&iod);
+    }
+
+    std::vector<crypto::public_key> pkeys;
+    pkeys.reserve(iods.size());
+    for (const wallet2::is_out_data *iod: iods)
+      pkeys.push_back(iod->pkey);
+    std::vector<crypto::key_derivation> derivations(iods.size());
+    std::unique_ptr<bool[]> valid(new bool[iods.size()]);
+    hwdev.generate_key_derivations(pkeys.data(), pkeys.size(), keys.m_view_secret_key, derivations.data(), valid.get());
+    for (size_t n = 0; n < iods.size(); ++n)
+    {
+      if (!valid[n])
+      {
+        MWARNING("Failed to generate key derivation from tx pubkey, skipping");
+        static_assert(sizeof(derivations[n]) == sizeof(rct::key), "Mismatched sizes of key_derivation and rct::key");
+        memcpy(&derivations[n], rct::identity().bytes, sizeof(derivations[n]));
+      }
+      iods[n]->derivation = derivations[n];
+    }
 
-  auto geniod = [&](const cryptonote::transaction &tx, size_t n_vouts, size_t txidx) {
-    for (size_t k = 0; k < n_vouts; ++k)
+    // check the run's outputs against the subaddresses, also with one batched derivation per pass: first with
+    // every primary derivation, then with the matching additional derivation for outputs the first primary missed
+    std::vector<out_query> queries;
+    for (size_t n = begin; n < end; ++n)
     {
-      const auto &o = tx.vout[k];
-      if (o.target.type() == typeid(cryptonote::txout_to_key))
+      const tx_cache_job &job = tx_cache_jobs[n];
+      auto &slot = tx_cache_data[job.txidx];
+      if (!job.scan || slot.empty())
+        continue;
+      for (const auto &iod: slot.primary)
+        THROW_WALLET_EXCEPTION_IF(iod.received.size() != job.n_vouts,
+            error::wallet_internal_error, "Unexpected received array size");
+      for (size_t k = 0; k < job.n_vouts; ++k)
       {
-        std::vector<crypto::key_derivation> additional_derivations;
-        additional_derivations.reserve(tx_cache_data[txidx].additional.size());
-        for (const auto &iod: tx_cache_data[txidx].additional)
-          additional_derivations.push_back(iod.derivation);
+        const auto &o = job.tx->vout[k];
+        if (o.target.type() != typeid(cryptonote::txout_to_key))
+          continue;
         const auto &key = boost::get<txout_to_key>(o.target).key;
-        for (size_t l = 0; l < tx_cache_data[txidx].primary.size(); ++l)
-        {
-          THROW_WALLET_EXCEPTION_IF(tx_cache_data[txidx].primary[l].received.size() != n_vouts,
-              error::wallet_internal_error, "Unexpected received array size");
-          tx_cache_data[txidx].primary[l].received[k] = is_out_to_acc_precomp(m_subaddresses, key, tx_cache_data[txidx].primary[l].derivation, additional_derivations, k, hwdev);
-          additional_derivations.clear();
-        }
+        for (size_t l = 0; l < slot.primary.size(); ++l)
+          queries.push_back({job.txidx, k, l, key, slot.primary[l].derivation});
       }
     }
+
+    std::vector<out_query> additional_queries;
+    check_outs(queries);
+    for (const out_query &query: queries)
+    {
+      if (query.l != 0 || tx_cache_data[query.txidx].primary[0].received[query.k])
+        continue;
+      const auto &additional = tx_cache_data[query.txidx].additional;
+      if (additional.empty())
+        continue;
+      if (query.k >= additional.size())
+      {
+        MERROR("wrong number of additional derivations");
+        continue;
+      }
+      additional_queries.push_back({query.txidx, query.k, 0, query.out_key, additional[query.k].derivation});
+    }
+    check_outs(additional_queries);
   };
 
-  txidx = 0;
+  size_t txidx = 0;
   for (size_t i = 0; i < blocks.size(); ++i)
   {
+    THROW_WALLET_EXCEPTION_IF(parsed_blocks[i].txes.size() != parsed_blocks[i].block.tx_hashes.size(),
+        error::wallet_internal_error, "Mismatched parsed_blocks[i].txes.size() and parsed_blocks[i].block.tx_hashes.size()");
     if (should_skip_block(parsed_blocks[i].block, start_height + i))
     {
       txidx += 1 + parsed_blocks[i].block.tx_hashes.size();
@@ -2850,19 +3105,36 @@ void wallet2::process_parsed_blocks(uint64_t start_height, const std::vector<cry
     if (m_refresh_type != RefreshType::RefreshNoCoinbase)
     {
       THROW_WALLET_EXCEPTION_IF(txidx >= tx_cache_data.size(), error::wallet_internal_error, "txidx out of range");
-      const cryptonote::transaction& tx = parsed_blocks[i].block.miner_tx;
-      const size_t n_vouts = (m_refresh_type == RefreshType::RefreshOptimizeCoinbase && tx.version < 2) ? 1 : tx.vout.size();
-      tpool.submit(&waiter, [&, n_vouts, txidx](){ geniod(tx, n_vouts, txidx); }, true);
+      const cryptonote::transaction &miner_tx = parsed_blocks[i].block.miner_tx;
+      const size_t n_vouts = (m_refresh_type == RefreshType::RefreshOptimizeCoinbase && miner_tx.version < 2) ? 1 : miner_tx.vout.size();
+      // the miner tx is always scanned, as its results depend on the refresh type
+      tx_cache_jobs.push_back({&miner_tx, nullptr, n_vouts, txidx, true});
     }
     ++txidx;
+    // a block the wallet holds under another hash is being reorged, and the index knows nothing about it
+    const uint64_t height = start_height + i;
+    const bool indexed = use_scan_index && height + SCAN_INDEX_REORG_GUARD < m_scan_index.end_height() &&
+        m_scan_index.covers(height, num_subaddresses) &&
+        (!m_blockchain.is_in_bounds(height) || m_blockchain[height] == parsed_blocks[i].hash);
     for (size_t j = 0; j < parsed_blocks[i].txes.size(); ++j)
     {
       THROW_WALLET_EXCEPTION_IF(txidx >= tx_cache_data.size(), error::wallet_internal_error, "txidx out of range");
-      tpool.submit(&waiter, [&, i, j, txidx](){ geniod(parsed_blocks[i].txes[j], parsed_blocks[i].txes[j].vout.size(), txidx); }, true);
+      const bool scan = !indexed || m_scan_index.is_candidate(height, j + 1);
+      tx_cache_jobs.push_back({&parsed_blocks[i].txes[j], &parsed_blocks[i].block.tx_hashes[j], parsed_blocks[i].txes[j].vout.size(), txidx, scan});
       ++txidx;
     }
   }
-  THROW_WALLET_EXCEPTION_IF(txidx != tx_cache_data.size(), error::wallet_internal_error, "txidx did not reach expected value");
+
+  // runs of up to 32 txes (a few dozen pubkeys) amortize the batched derivation, while still leaving
+  // several jobs per thread so uneven txes balance out
+  const size_t num_jobs_target = 4 * std::max<size_t>(tpool.get_max_concurrency(), 1);
+  const size_t txes_per_job = std::max<size_t>(1, std::min<size_t>(32, tx_cache_jobs.size() / num_jobs_target));
+  for (size_t begin = 0; begin < tx_cache_jobs.size(); begin += txes_per_job)
+  {
+    const size_t end = std::min(begin + txes_per_job, tx_cache_jobs.size());
+    tpool.submit(&waiter, [&prepare_txes, begin, end](){ prepare_txes(begin, end); }, true);
+  }
+  THROW_WALLET_EXCEPTION_IF(txidx != num_txes, error::wallet_internal_error, "txidx does not match tx_cache_data size");
   THROW_WALLET_EXCEPTION_IF(!waiter.wait(), error::wallet_internal_error, "Exception in thread pool");
   hwdev.set_mode(hw::device::NONE);
 
@@ -2892,11 +3164,355 @@ void wallet2::process_parsed_blocks(uint64_t start_height, const std::vector<cry
     {
       LOG_PRINT_L2("Block is already in blockchain: " << string_tools::pod_to_hex(bl_id));
     }
+    if (record_scan_index && !should_skip_block(bl, current_index))
+      record_scan_index_block(current_index, bl_id, num_subaddresses, tx_cache_data, tx_cache_data_offset, 1 + parsed_blocks[i].txes.size());
     ++current_index;
     tx_cache_data_offset += 1 + parsed_blocks[i].txes.size();
   }
 }
 //----------------------------------------------------------------------------------------------------
+void wallet2::record_scan_index_block(uint64_t height, const crypto::hash &block_hash, size_t num_subaddresses, const std::vector<tx_cache_data> &tx_cache_data, size_t tx_cache_data_offset, size_t num_txes)
+{
+  std::vector<scan_index::match> matches;
+  for (size_t n = 0; n < num_txes; ++n)
+  {
+    for (const is_out_data &iod: tx_cache_data[tx_cache_data_offset + n].primary)
+    {
+      for (size_t k = 0; k < iod.received.size(); ++k)
+      {
+        if (iod.received[k])
+          matches.push_back({height, static_cast<uint32_t>(n), static_cast<uint32_t>(k)});
+      }
+    }
+  }
+  m_scan_index.add_block(height, block_hash, num_subaddresses, std::move(matches));
+  m_scan_index_verified = true;
+}
+//----------------------------------------------------------------------------------------------------
+void wallet2::use_scan_index(bool value)
+{
+  // an index left over from an earlier period of use may have missed reorgs, so always start afresh
+  if (value != m_use_scan_index)
+  {
+    m_scan_index.clear();
+    m_scan_index_verified = false;
+  }
+  m_use_scan_index = value;
+}
+//----------------------------------------------------------------------------------------------------
+void wallet2::verify_scan_index()
+{
+  if (!m_use_scan_index || m_scan_index_verified || m_scan_index.end_height() == m_scan_index.start_height())
+    return;
+
+  const uint64_t top_height = m_scan_index.end_height() - 1;
+  crypto::hash hash;
+  if (m_blockchain.is_in_bounds(top_height))
+  {
+    hash = m_blockchain[top_height];
+  }
+  else
+  {
+    // the wallet's own chain is shorter (rescan, lost cache), ask the daemon
+    cryptonote::COMMAND_RPC_GET_BLOCK_HEADER_BY_HEIGHT::request req = AUTO_VAL_INIT(req);
+    cryptonote::COMMAND_RPC_GET_BLOCK_HEADER_BY_HEIGHT::response res = AUTO_VAL_INIT(res);
+
+    bool r;
+    {
+      const boost::lock_guard<boost::recursive_mutex> lock{m_daemon_rpc_mutex};
+      req.height = top_height;
+      uint64_t pre_call_credits = m_rpc_payment_state.credits;
+      req.client = get_client_signature();
+      r = net_utils::invoke_http_json_rpc("/json_rpc", "getblockheaderbyheight", req, res, *m_http_client, rpc_timeout);
+      if (r && res.status == CORE_RPC_STATUS_OK)
+        check_rpc_cost("getblockheaderbyheight", res.credits, pre_call_credits, COST_PER_BLOCK_HEADER);
+    }
+
+    if (!r || res.status != CORE_RPC_STATUS_OK || !epee::string_tools::hex_to_pod(res.block_header.hash, hash))
+    {
+      MWARNING("Failed to request block header from daemon, not using the scan index for now");
+      return;
+    }
+  }
+
+  if (hash != m_scan_index.top_hash())
+  {
+    MWARNING("Scan index does not match the blockchain at height " << top_height << ", discarding it");
+    m_scan_index.clear();
+    return;
+  }
+  m_scan_index_verified = true;
+}
+//----------------------------------------------------------------------------------------------------
+void wallet2::incremental_cache(bool value)
+{
+  // the saved state is only tracked while the mode is on, so turning it on starts with a full save
+  if (value != m_incremental_cache)
+    m_cache_log_force_full = true;
+  m_incremental_cache = value;
+}
+//----------------------------------------------------------------------------------------------------
+void wallet2::mark_cache_log_saved()
+{
+  m_cache_log_force_full = false;
+  m_cache_log_height = m_blockchain.size();
+  m_cache_log_chain_offset = m_blockchain.offset();
+  m_cache_log_num_subaddresses = m_subaddresses.size();
+  m_cache_log_fingerprints.clear();
+  if (!m_incremental_cache)
+    return;
+  m_cache_log_fingerprints.reserve(m_transfers.size());
+  for (const transfer_details &td: m_transfers)
+    m_cache_log_fingerprints.push_back(get_transfer_fingerprint(td));
+}
+//----------------------------------------------------------------------------------------------------
+void wallet2::reset_cache_log(const crypto::chacha_iv &base_iv, uint64_t base_size)
+{
+  // the log was written on top of the previous cache file, so it no longer applies
+  const std::string cache_log_file = get_cache_log_file();
+  if (boost::filesystem::exists(cache_log_file))
+  {
+    boost::system::error_code ec;
+    if (!boost::filesystem::remove(cache_log_file, ec))
+      LOG_ERROR("error removing file: " << cache_log_file);
+  }
+  m_cache_log.reset(base_iv, base_size);
+  mark_cache_log_saved();
+}
+//----------------------------------------------------------------------------------------------------
+void wallet2::load_cache_log(const crypto::chacha_iv &base_iv, uint64_t base_size)
+{
+  std::vector<std::string> records;
+  bool complete = m_cache_log.load(get_cache_log_file(), m_cache_key, base_iv, base_size, records);
+  size_t applied = 0;
+  for (const std::string &record: records)
+  {
+    if (!apply_cache_log_record(record))
+    {
+      MERROR("Failed to apply cache log record " << applied << ", resuming from the state before it");
+      complete = false;
+      break;
+    }
+    ++applied;
+  }
+  if (applied > 0)
+    MINFO("Applied " << applied << " cache log records");
+
+  mark_cache_log_saved();
+  // a log with a bad tail can't be appended to
+  m_cache_log_force_full = !complete;
+}
+//----------------------------------------------------------------------------------------------------
+bool wallet2::apply_cache_log_record(const std::string &blob)
+{
+  cache_log_record record;
+  binary_archive<false> ar{epee::strspan<std::uint8_t>(blob)};
+  if (!::serialization::serialize(ar, record) || !::serialization::check_stream_state(ar))
+    return false;
+
+  // check the record fits before touching anything
+  if (record.start_height < m_blockchain.offset() || record.start_height > m_blockchain.size() ||
+      record.blockchain_offset < m_blockchain.offset() || record.blockchain_offset >= record.start_height + record.blockchain.size())
+    return false;
+  size_t num_transfers = std::min<uint64_t>(m_transfers.size(), record.num_transfers);
+  for (size_t n = 0; n < record.transfers.size(); ++n)
+  {
+    const uint64_t index = record.transfers[n].index;
+    if (index > num_transfers || (n > 0 && index <= record.transfers[n - 1].index))
+      return false;
+    if (index == num_transfers)
+      ++num_transfers;
+  }
+  if (num_transfers != record.num_transfers)
+    return false;
+
+  {
+    binary_archive<false> other_ar{epee::strspan<std::uint8_t>(record.other)};
+    if (!serialize_cache_log_other(other_ar) || !::serialization::check_stream_state(other_ar))
+      return false;
+  }
+
+  // transfers past the new count go first, then the changed ones are overwritten or appended, with the key
+  // image and public key maps following them
+  auto unindex_transfer = [this](size_t idx)
+  {
+    const transfer_details &td = m_transfers[idx];
+    const auto it_ki = m_key_images.find(td.m_key_image);
+    if (it_ki != m_key_images.end() && it_ki->second == idx)
+      m_key_images.erase(it_ki);
+    const auto it_pk = m_pub_keys.find(td.get_public_key());
+    if (it_pk != m_pub_keys.end() && it_pk->second == idx)
+      m_pub_keys.erase(it_pk);
+  };
+  for (size_t idx = record.num_transfers; idx < m_transfers.size(); ++idx)
+    unindex_transfer(idx);
+  if (record.num_transfers < m_transfers.size())
+    m_transfers.erase(m_transfers.begin() + record.num_transfers, m_transfers.end());
+  m_unspent_transfers_dirty = true;
+  for (cache_log_transfer &t: record.transfers)
+  {
+    if (t.index < m_transfers.size())
+    {
+      unindex_transfer(t.index);
+      m_transfers[t.index] = std::move(t.td);
+    }
+    else
+    {
+      m_transfers.push_back(std::move(t.td));
+    }
+    const transfer_details &td = m_transfers[t.index];
+    if (t.key_image_indexed)
+      m_key_images[td.m_key_image] = t.index;
+    if (t.pub_key_indexed)
+      m_pub_keys[td.get_public_key()] = t.index;
+  }
+
+  m_blockchain.crop(record.start_height);
+  for (const crypto::hash &hash: record.blockchain)
+    m_blockchain.push_back(hash);
+  m_blockchain.trim(record.blockchain_offset);
+
+  for (auto it = m_payments.begin(); it != m_payments.end(); )
+  {
+    if (record.start_height <= it->second.m_block_height)
+      it = m_payments.erase(it);
+    else
+      ++it;
+  }
+  for (auto &payment: record.payments)
+    m_payments.emplace(std::move(payment));
+
+  for (auto it = m_confirmed_txs.begin(); it != m_confirmed_txs.end(); )
+  {
+    if (record.start_height <= it->second.m_block_height)
+      it = m_confirmed_txs.erase(it);
+    else
+      ++it;
+  }
+  for (auto &confirmed_tx: record.confirmed_txs)
+    m_confirmed_txs.emplace(std::move(confirmed_tx));
+
+  if (record.has_subaddresses)
+  {
+    m_subaddresses.clear();
+    for (const auto &subaddress: record.subaddresses)
+      m_subaddresses.emplace(subaddress);
+  }
+  return true;
+}
+//----------------------------------------------------------------------------------------------------
+bool wallet2::append_cache_log()
+{
+  if (!m_incremental_cache || m_light_wallet || m_cache_log_force_full || !m_cache_log.has_base())
+    return false;
+
+  // compaction: past a point, replaying the log on load costs more than the full save it replaces
+  if (m_cache_log.num_records() >= CACHE_LOG_MAX_RECORDS ||
+      m_cache_log.size() * CACHE_LOG_COMPACTION_RATIO >= m_cache_log.base_size())
+    return false;
+
+  // a record can only replace hashes the last save still had
+  if (m_blockchain.offset() < m_cache_log_chain_offset || m_cache_log_height < m_blockchain.offset() ||
+      m_cache_log_height > m_blockchain.size())
+    return false;
+
+  try
+  {
+    cache_log_record record;
+    std::vector<uint64_t> fingerprints;
+    fingerprints.reserve(m_transfers.size());
+    record.num_transfers = m_transfers.size();
+    for (size_t i = 0; i < m_transfers.size(); ++i)
+    {
+      const transfer_details &td = m_transfers[i];
+      fingerprints.push_back(get_transfer_fingerprint(td));
+      if (i < m_cache_log_fingerprints.size() && fingerprints.back() == m_cache_log_fingerprints[i])
+        continue;
+      const auto it_ki = m_key_images.find(td.m_key_image);
+      const auto it_pk = m_pub_keys.find(td.get_public_key());
+      record.transfers.push_back({i, td, it_ki != m_key_images.end() && it_ki->second == i, it_pk != m_pub_keys.end() && it_pk->second == i});
+    }
+
+    // the history only changes at the chain tip, or below it on a reorg
+    record.start_height = m_cache_log_height;
+    record.blockchain_offset = m_blockchain.offset();
+    for (uint64_t height = record.start_height; height < m_blockchain.size(); ++height)
+      record.blockchain.push_back(m_blockchain[height]);
+    for (const auto &payment: m_payments)
+    {
+      if (payment.second.m_block_height >= record.start_height)
+        record.payments.push_back(payment);
+    }
+    for (const auto &confirmed_tx: m_confirmed_txs)
+    {
+      if (confirmed_tx.second.m_block_height >= record.start_height)
+        record.confirmed_txs.push_back(confirmed_tx);
+    }
+
+    // the subaddress table only ever grows between full saves
+    record.has_subaddresses = m_subaddresses.size() != m_cache_log_num_subaddresses;
+    if (record.has_subaddresses)
+      record.subaddresses.assign(m_subaddresses.begin(), m_subaddresses.end());
+
+    {
+      std::stringstream oss;
+      binary_archive<true> ar(oss);
+      if (!serialize_cache_log_other(ar))
+        return false;
+      record.other = oss.str();
+    }
+
+    std::stringstream oss;
+    binary_archive<true> ar(oss);
+    if (!::serialization::serialize(ar, record))
+      return false;
+    if (!m_cache_log.append(get_cache_log_file(), m_cache_key, oss.str()))
+    {
+      MWARNING("Failed to append to the cache log, saving the cache in full");
+      return false;
+    }
+    MDEBUG("Appended cache log record: " << record.transfers.size() << " transfers, " << record.blockchain.size() <<
+        " block hashes, " << oss.str().size() << " bytes");
+
+    m_cache_log_fingerprints = std::move(fingerprints);
+    m_cache_log_height = m_blockchain.size();
+    m_cache_log_chain_offset = m_blockchain.offset();
+    m_cache_log_num_subaddresses = m_subaddresses.size();
+    return true;
+  }
+  catch (const std::exception &e)
+  {
+    MWARNING("Failed to make a cache log record (" << e.what() << "), saving the cache in full");
+    return false;
+  }
+}
+//----------------------------------------------------------------------------------------------------
+std::string wallet2::get_transfer_store_file(const std::string &wallet_file, const crypto::hash &id)
+{
+  return wallet_file + ".transfers-" + epee::string_tools::pod_to_hex(id).substr(0, 16);
+}
+//----------------------------------------------------------------------------------------------------
+void wallet2::remove_transfer_stores(const std::string &wallet_file, const crypto::hash &keep)
+{
+  const boost::filesystem::path wallet_path(wallet_file);
+  const boost::filesystem::path dir = wallet_path.has_parent_path() ? wallet_path.parent_path() : boost::filesystem::path(".");
+  const std::string prefix = wallet_path.filename().string() + ".transfers-";
+  const std::string kept = keep == crypto::null_hash ? std::string() :
+      boost::filesystem::path(get_transfer_store_file(wallet_file, keep)).filename().string();
+
+  // stale stores are left behind by changes of setting and by saves interrupted before the cache file was replaced
+  boost::system::error_code ec;
+  for (boost::filesystem::directory_iterator it(dir, ec), end; !ec && it != end; it.increment(ec))
+  {
+    const std::string name = it->path().filename().string();
+    if (!boost::starts_with(name, prefix) || name == kept)
+      continue;
+    boost::system::error_code remove_ec;
+    if (!boost::filesystem::remove(it->path(), remove_ec))
+      LOG_ERROR("error removing file: " << it->path().string());
+  }
+}
+//----------------------------------------------------------------------------------------------------
 void wallet2::refresh(bool trusted_daemon)
 {
   uint64_t blocks_fetched = 0;
@@ -2928,6 +3544,23 @@ void wallet2::pull_and_parse_next_blocks(uint64_t start_height, uint64_t &blocks
       short_chain_history.push_front(s->hash);
     }
 
+    // another wallet in this process may already have pulled and parsed the same blocks
+    const bool no_miner_tx = m_refresh_type == RefreshNoCoinbase;
+    if (m_shared_block_cache && !short_chain_history.empty())
+    {
+      const std::shared_ptr<const shared_block_cache::batch> cached =
+        m_shared_block_cache->find(short_chain_history.front(), start_height, no_miner_tx);
+      if (cached)
+      {
+        MDEBUG("Pulled blocks from the shared cache: blocks_start_height " << cached->start_height << ", count " << cached->blocks.size());
+        blocks_start_height = cached->start_height;
+        blocks = cached->blocks;
+        parsed_blocks = cached->parsed_blocks;
+        last = cryptonote::get_block_height(parsed_blocks.back().block) + 1 == cached->current_height;
+        return;
+      }
+    }
+
     // pull the new blocks
     std::vector<cryptonote::COMMAND_RPC_GET_BLOCKS_FAST::block_output_indices> o_indices;
     uint64_t current_height;
@@ -2970,6 +3603,18 @@ void wallet2::pull_and_parse_next_blocks(uint64_t start_height, uint64_t &blocks
     }
     THROW_WALLET_EXCEPTION_IF(!waiter.wait(), error::wallet_internal_error, "Exception in thread pool");
     last = !blocks.empty() && cryptonote::get_block_height(parsed_blocks.back().block) + 1 == current_height;
+
+    if (m_shared_block_cache && !error && !blocks.empty())
+    {
+      std::shared_ptr<shared_block_cache::batch> pulled = std::make_shared<shared_block_cache::batch>();
+      pulled->start_height = blocks_start_height;
+      pulled->current_height = current_height;
+      pulled->no_miner_tx = no_miner_tx;
+      pulled->blocks = blocks;
+      pulled->parsed_blocks = parsed_blocks;
+      pulled->pulled_time = time(NULL);
+      m_shared_block_cache->add(std::move(pulled));
+    }
   }
   catch(...)
   {
@@ -3404,6 +4049,7 @@ void wallet2::refresh(bool trusted_daemon, uint64_t start_height, uint64_t & blo
     // Lighwallet refresh done
     return;
   }
+  verify_scan_index();
   received_money = false;
   blocks_fetched = 0;
   uint64_t added_blocks = 0;
@@ -3655,10 +4301,18 @@ bool wallet2::get_rct_distribution(uint64_t &start_height, std::vector<uint64_t>
     }
   }
 
+  // if we have it cached, only the blocks past it are needed, plus a few more in case of a reorg
+  const uint64_t cached_blocks = m_rct_distribution.size() > RCT_DISTRIBUTION_REORG_DEPTH ? m_rct_distribution.size() - RCT_DISTRIBUTION_REORG_DEPTH : 0;
+  auto retry_in_full = [&]()
+  {
+    m_rct_distribution.clear();
+    return cached_blocks > 0 && get_rct_distribution(start_height, distribution);
+  };
+
   cryptonote::COMMAND_RPC_GET_OUTPUT_DISTRIBUTION::request req = AUTO_VAL_INIT(req);
   cryptonote::COMMAND_RPC_GET_OUTPUT_DISTRIBUTION::response res = AUTO_VAL_INIT(res);
   req.amounts.push_back(0);
-  req.from_height = 0;
+  req.from_height = cached_blocks > 0 ? m_rct_distribution_start_height + cached_blocks : 0;
   req.cumulative = false;
   req.binary = true;
   req.compress = true;
@@ -3675,22 +4329,44 @@ bool wallet2::get_rct_distribution(uint64_t &start_height, std::vector<uint64_t>
   }
   catch(...)
   {
-    return false;
+    return retry_in_full();
   }
   if (res.distributions.size() != 1)
   {
     MWARNING("Failed to request output distribution: not the expected single result");
-    return false;
+    return retry_in_full();
   }
   if (res.distributions[0].amount != 0)
   {
     MWARNING("Failed to request output distribution: results are not for amount 0");
-    return false;
+    return retry_in_full();
   }
-  for (size_t i = 1; i < res.distributions[0].data.distribution.size(); ++i)
-    res.distributions[0].data.distribution[i] += res.distributions[0].data.distribution[i-1];
-  start_height = res.distributions[0].data.start_height;
-  distribution = std::move(res.distributions[0].data.distribution);
+
+  cryptonote::rpc::output_distribution_data &data = res.distributions[0].data;
+  if (cached_blocks > 0)
+  {
+    // the daemon also sends how many outputs precede what it sent, which must match our cache
+    if (data.start_height != req.from_height || data.base != m_rct_distribution[cached_blocks - 1])
+    {
+      MDEBUG("Cached rct distribution does not match the daemon's, requesting it in full");
+      return retry_in_full();
+    }
+    m_rct_distribution.resize(cached_blocks);
+  }
+  else
+  {
+    m_rct_distribution.clear();
+    m_rct_distribution_start_height = data.start_height;
+  }
+  m_rct_distribution.reserve(m_rct_distribution.size() + data.distribution.size());
+  uint64_t total = m_rct_distribution.empty() ? 0 : m_rct_distribution.back();
+  for (uint64_t n: data.distribution)
+  {
+    total += n;
+    m_rct_distribution.push_back(total);
+  }
+  start_height = m_rct_distribution_start_height;
+  distribution = m_rct_distribution;
   return true;
 }
 //----------------------------------------------------------------------------------------------------
@@ -3746,9 +4422,23 @@ void wallet2::detach_blockchain(uint64_t height, std::map<std::pair<uint64_t, ui
   }
   transfers_detached = std::distance(it, m_transfers.end());
   m_transfers.erase(it, m_transfers.end());
+  m_unspent_transfers_dirty = true;
 
   size_t blocks_detached = m_blockchain.size() - height;
   m_blockchain.crop(height);
+  m_cache_log_height = std::min<uint64_t>(m_cache_log_height, height);
+  if (height > m_rct_distribution_start_height)
+    m_rct_distribution.resize(std::min<uint64_t>(m_rct_distribution.size(), height - m_rct_distribution_start_height));
+  else
+    m_rct_distribution.clear();
+
+  if (height < m_scan_index.end_height())
+  {
+    if (height > 0 && m_blockchain.is_in_bounds(height - 1))
+      m_scan_index.crop(height, m_blockchain[height - 1]);
+    else
+      m_scan_index.clear();
+  }
 
   for (auto it = m_payments.begin(); it != m_payments.end(); )
   {
@@ -3795,9 +4485,13 @@ bool wallet2::clear()
   m_scanned_pool_txs[1].clear();
   m_address_book.clear();
   m_subaddresses.clear();
+  m_subaddress_table.clear();
   m_subaddress_labels.clear();
   m_multisig_rounds_passed = 0;
   m_device_last_key_image_sync = 0;
+  m_cache_log_force_full = true;
+  m_transfer_store_id = crypto::null_hash;
+  m_unspent_transfers_dirty = true;
   return true;
 }
 //----------------------------------------------------------------------------------------------------
@@ -3814,6 +4508,8 @@ void wallet2::clear_soft(bool keep_key_images)
   m_unconfirmed_payments.clear();
   m_scanned_pool_txs[0].clear();
   m_scanned_pool_txs[1].clear();
+  m_cache_log_force_full = true;
+  m_unspent_transfers_dirty = true;
 
   cryptonote::block b;
   generate_genesis(b);
@@ -4000,6 +4696,15 @@ boost::optional<wallet2::keys_file_data> wallet2::get_keys_file_data(const epee:
   value2.SetInt(m_track_uses ? 1 : 0);
   json.AddMember("track_uses", value2, json.GetAllocator());
 
+  value2.SetInt(m_use_scan_index ? 1 : 0);
+  json.AddMember("use_scan_index", value2, json.GetAllocator());
+
+  value2.SetInt(m_incremental_cache ? 1 : 0);
+  json.AddMember("incremental_cache", value2, json.GetAllocator());
+
+  value2.SetInt(m_columnar_transfers ? 1 : 0);
+  json.AddMember("columnar_transfers", value2, json.GetAllocator());
+
   value2.SetInt(m_inactivity_lock_timeout);
   json.AddMember("inactivity_lock_timeout", value2, json.GetAllocator());
 
@@ -4184,6 +4889,9 @@ bool wallet2::load_keys_buf(const std::string& keys_buf, const epee::wipeable_st
     m_ignore_outputs_above = MONEY_SUPPLY;
     m_ignore_outputs_below = 0;
     m_track_uses = false;
+    m_use_scan_index = false;
+    m_incremental_cache = false;
+    m_columnar_transfers = false;
     m_inactivity_lock_timeout = DEFAULT_INACTIVITY_LOCK_TIMEOUT;
     m_setup_background_mining = BackgroundMiningMaybe;
     m_subaddress_lookahead_major = SUBADDRESS_LOOKAHEAD_MAJOR;
@@ -4358,6 +5066,12 @@ bool wallet2::load_keys_buf(const std::string& keys_buf, const epee::wipeable_st
     m_ignore_outputs_below = field_ignore_outputs_below;
     GET_FIELD_FROM_JSON_RETURN_ON_ERROR(json, track_uses, int, Int, false, false);
     m_track_uses = field_track_uses;
+    GET_FIELD_FROM_JSON_RETURN_ON_ERROR(json, use_scan_index, int, Int, false, false);
+    m_use_scan_index = field_use_scan_index;
+    GET_FIELD_FROM_JSON_RETURN_ON_ERROR(json, incremental_cache, int, Int, false, false);
+    m_incremental_cache = field_incremental_cache;
+    GET_FIELD_FROM_JSON_RETURN_ON_ERROR(json, columnar_transfers, int, Int, false, false);
+    m_columnar_transfers = field_columnar_transfers;
     GET_FIELD_FROM_JSON_RETURN_ON_ERROR(json, inactivity_lock_timeout, uint32_t, Uint, false, DEFAULT_INACTIVITY_LOCK_TIMEOUT);
     m_inactivity_lock_timeout = field_inactivity_lock_timeout;
     GET_FIELD_FROM_JSON_RETURN_ON_ERROR(json, setup_background_mining, BackgroundMiningSetupType, Int, false, BackgroundMiningMaybe);
@@ -5203,6 +5917,7 @@ std::string wallet2::exchange_multisig_keys(const epee::wipeable_string &passwor
     }
 
     m_subaddresses.clear();
+    m_subaddress_table.clear();
     m_subaddress_labels.clear();
     add_subaddress_account(tr("Primary account"));
 
@@ -5720,6 +6435,7 @@ void wallet2::load(const std::string& wallet_, const epee::wipeable_string& pass
     wallet2::cache_file_data cache_file_data;
     std::string cache_file_buf;
     bool r = true;
+    bool cache_log_base = false; // a cache log can only be on top of a cache in the current format
     if (use_fs)
     {
       load_from_file(m_wallet_file, cache_file_buf, std::numeric_limits<size_t>::max());
@@ -5764,6 +6480,7 @@ void wallet2::load(const std::string& wallet_, const epee::wipeable_string& pass
           boost::archive::portable_binary_iarchive ar(iss);
           ar >> *this;
         }
+        cache_log_base = use_fs;
       }
       catch(...)
       {
@@ -5824,6 +6541,18 @@ void wallet2::load(const std::string& wallet_, const epee::wipeable_string& pass
       m_account_public_address.m_spend_public_key != m_account.get_keys().m_account_address.m_spend_public_key ||
       m_account_public_address.m_view_public_key  != m_account.get_keys().m_account_address.m_view_public_key,
       error::wallet_files_doesnt_correspond, m_keys_file, m_wallet_file);
+
+    if (m_transfer_store_id != crypto::null_hash)
+    {
+      const std::string transfer_store_file = get_transfer_store_file(m_wallet_file, m_transfer_store_id);
+      THROW_WALLET_EXCEPTION_IF(!use_fs || !transfer_store::load(transfer_store_file, m_cache_key, m_transfer_store_id, m_transfers),
+          error::file_read_error, transfer_store_file);
+      m_transfer_store_id = crypto::null_hash;
+    }
+
+    // replay what incremental saves appended since the cache file was last saved in full
+    if (cache_log_base)
+      load_cache_log(cache_file_data.iv, cache_file_data.cache_data.size());
   }
 
   if (!m_persistent_rpc_client_id)
@@ -5845,6 +6574,12 @@ void wallet2::load(const std::string& wallet_, const epee::wipeable_string& pass
 
   trim_hashchain();
 
+  m_scan_index.clear();
+  m_scan_index_verified = false;
+  if (m_use_scan_index && use_fs)
+    m_scan_index.load(get_scan_index_file(), m_cache_key);
+
+  m_subaddress_table.assign(m_subaddresses);
   if (get_num_subaddress_accounts() == 0)
     add_subaddress_account(tr("Primary account"));
 
@@ -5964,9 +6699,27 @@ void wallet2::store_to(const std::string &path, const epee::wipeable_string &pas
     }
   }
 
+  // in incremental mode, most saves only append what changed to the cache log
+  const bool appended = same_file && append_cache_log();
+
   // get wallet cache data
-  boost::optional<wallet2::cache_file_data> cache_file_data = get_cache_file_data(password);
-  THROW_WALLET_EXCEPTION_IF(cache_file_data == boost::none, error::wallet_internal_error, "failed to generate wallet cache data");
+  boost::optional<wallet2::cache_file_data> cache_file_data;
+  crypto::hash transfer_store_id = crypto::null_hash;
+  if (!appended)
+  {
+    // stores are named after their id, so this never overwrites the one the current cache file refers to
+    if (same_file && m_columnar_transfers)
+    {
+      transfer_store_id = crypto::rand<crypto::hash>();
+      const std::string transfer_store_file = get_transfer_store_file(m_wallet_file, transfer_store_id);
+      THROW_WALLET_EXCEPTION_IF(!transfer_store::store(transfer_store_file, m_cache_key, transfer_store_id, m_transfers),
+          error::file_save_error, transfer_store_file);
+    }
+    m_transfer_store_id = transfer_store_id;
+    cache_file_data = get_cache_file_data(password);
+    m_transfer_store_id = crypto::null_hash;
+    THROW_WALLET_EXCEPTION_IF(cache_file_data == boost::none, error::wallet_internal_error, "failed to generate wallet cache data");
+  }
 
   const std::string new_file = same_file ? m_wallet_file + ".new" : path;
   const std::string old_file = m_wallet_file;
@@ -6010,7 +6763,19 @@ void wallet2::store_to(const std::string &path, const epee::wipeable_string &pas
         LOG_ERROR("error removing file: " << old_mms_file);
       }
     }
-  } else {
+    // remove old cache log file
+    const std::string old_cache_log_file = old_file + ".cachelog";
+    if (boost::filesystem::exists(old_cache_log_file))
+    {
+      r = boost::filesystem::remove(old_cache_log_file);
+      if (!r) {
+        LOG_ERROR("error removing file: " << old_cache_log_file);
+      }
+    }
+    m_cache_log.clear();
+    m_cache_log_force_full = true;
+    remove_transfer_stores(old_file, crypto::null_hash);
+  } else if (!appended) {
     // save to new file
 #ifdef WIN32
     // On Windows avoid using std::ofstream which does not work with UTF-8 filenames
@@ -6034,6 +6799,24 @@ void wallet2::store_to(const std::string &path, const epee::wipeable_string &pas
     // here we have "*.new" file, we need to rename it to be without ".new"
     std::error_code e = tools::replace_file(new_file, m_wallet_file);
     THROW_WALLET_EXCEPTION_IF(e, error::file_save_error, m_wallet_file, e);
+
+    reset_cache_log(cache_file_data->iv, cache_file_data->cache_data.size());
+    remove_transfer_stores(m_wallet_file, transfer_store_id);
+  }
+
+  // the scan index is a cache of derivation work, so failing to save it is not fatal
+  const std::string old_scan_index_file = old_file + ".scanidx";
+  if (m_use_scan_index)
+  {
+    if (!m_scan_index.store(get_scan_index_file(), m_cache_key))
+      MERROR("Failed to save scan index to " << get_scan_index_file());
+  }
+  if ((!m_use_scan_index || !same_file) && boost::filesystem::exists(old_scan_index_file))
+  {
+    // either stale (the index is off) or moved along with the wallet
+    boost::system::error_code ec;
+    if (!boost::filesystem::remove(old_scan_index_file, ec))
+      LOG_ERROR("error removing file: " << old_scan_index_file);
   }
   
   if (m_message_store.get_active())
@@ -6345,6 +7128,9 @@ void wallet2::rescan_blockchain(bool hard, bool refresh, bool keep_key_images)
     clear_soft(keep_key_images);
   }
 
+  // the daemon's chain may have moved on since the index was last checked
+  m_scan_index_verified = false;
+
   if (refresh)
     this->refresh(false);
 
@@ -6965,7 +7751,7 @@ bool wallet2::sign_tx(unsigned_tx_set &exported_txs, std::vector<wallet2::pendin
         continue;
       const cryptonote::txout_to_key &out = boost::get<cryptonote::txout_to_key>(tx.vout[i].target);
       // if this output is back to this wallet, we can calculate its key image already
-      if (!is_out_to_acc_precomp(m_subaddresses, out.key, derivation, additional_derivations, i, hwdev))
+      if (!is_out_to_acc(out.key, derivation, additional_derivations, i, hwdev))
         continue;
       crypto::key_image ki;
       cryptonote::keypair in_ephemeral;
@@ -9244,8 +10030,10 @@ std::vector<size_t> wallet2::pick_preferred_rct_inputs(uint64_t needed_money, ui
 
   LOG_PRINT_L2("pick_preferred_rct_inputs: needed_money " << print_money(needed_money));
 
+  const std::set<size_t> &unspent_transfers = get_unspent_transfers(subaddr_account);
+
   // try to find a rct input of enough size
-  for (size_t i = 0; i < m_transfers.size(); ++i)
+  for (size_t i: unspent_transfers)
   {
     const transfer_details& td = m_transfers[i];
     if (!is_spent(td, false) && !td.m_frozen && td.is_rct() && td.amount() >= needed_money && is_transfer_unlocked(td) && td.m_subaddr_index.major == subaddr_account && subaddr_indices.count(td.m_subaddr_index.minor) == 1)
@@ -9265,8 +10053,9 @@ std::vector<size_t> wallet2::pick_preferred_rct_inputs(uint64_t needed_money, ui
   // this could be made better by picking one of the outputs to be a small one, since those
   // are less useful since often below the needed money, so if one can be used in a pair,
   // it gets rid of it for the future
-  for (size_t i = 0; i < m_transfers.size(); ++i)
+  for (auto it = unspent_transfers.begin(); it != unspent_transfers.end(); ++it)
   {
+    const size_t i = *it;
     const transfer_details& td = m_transfers[i];
     if (!is_spent(td, false) && !td.m_frozen && !td.m_key_image_partial && td.is_rct() && is_transfer_unlocked(td) && td.m_subaddr_index.major == subaddr_account && subaddr_indices.count(td.m_subaddr_index.minor) == 1)
     {
@@ -9276,8 +10065,9 @@ std::vector<size_t> wallet2::pick_preferred_rct_inputs(uint64_t needed_money, ui
         continue;
       }
       LOG_PRINT_L2("Considering input " << i << ", " << print_money(td.amount()));
-      for (size_t j = i + 1; j < m_transfers.size(); ++j)
+      for (auto it2 = std::next(it); it2 != unspent_transfers.end(); ++it2)
       {
+        const size_t j = *it2;
         const transfer_details& td2 = m_transfers[j];
         if (td2.amount() > m_ignore_outputs_above || td2.amount() < m_ignore_outputs_below)
         {
@@ -9447,6 +10237,7 @@ void wallet2::light_wallet_get_unspent_outs()
   
   // Clear old outputs
   m_transfers.clear();
+  m_unspent_transfers_dirty = true;
   
   for (const auto &o: ores.outputs) {
     bool spent = false;
@@ -9987,7 +10778,7 @@ std::vector<wallet2::pending_tx> wallet2::create_transactions_2(std::vector<cryp
   // gather all dust and non-dust outputs belonging to specified subaddresses
   size_t num_nondust_outputs = 0;
   size_t num_dust_outputs = 0;
-  for (size_t i = 0; i < m_transfers.size(); ++i)
+  for (size_t i: get_unspent_transfers(subaddr_account))
   {
     const transfer_details& td = m_transfers[i];
     if (m_ignore_fractional_outputs && td.amount() < fractional_threshold)
@@ -10950,20 +11741,24 @@ uint64_t wallet2::get_upper_transaction_weight_limit()
 std::vector<size_t> wallet2::select_available_outputs(const std::function<bool(const transfer_details &td)> &f)
 {
   std::vector<size_t> outputs;
-  size_t n = 0;
-  for (transfer_container::const_iterator i = m_transfers.begin(); i != m_transfers.end(); ++i, ++n)
+  for (const auto &e: get_unspent_transfers())
   {
-    if (is_spent(*i, false))
-      continue;
-    if (i->m_frozen)
-      continue;
-    if (i->m_key_image_partial)
-      continue;
-    if (!is_transfer_unlocked(*i))
-      continue;
-    if (f(*i))
-      outputs.push_back(n);
+    for (size_t n: e.second)
+    {
+      const transfer_details &td = m_transfers[n];
+      if (is_spent(td, false))
+        continue;
+      if (td.m_frozen)
+        continue;
+      if (td.m_key_image_partial)
+        continue;
+      if (!is_transfer_unlocked(td))
+        continue;
+      if (f(td))
+        outputs.push_back(n);
+    }
   }
+  std::sort(outputs.begin(), outputs.end());
   return outputs;
 }
 //----------------------------------------------------------------------------------------------------
@@ -12767,32 +13562,51 @@ uint64_t wallet2::import_key_images(const std::vector<std::pair<crypto::key_imag
   req.key_images.reserve(signed_key_images.size());
 
   PERF_TIMER_START(import_key_images_A);
+  // the checks are independent: run them on the threadpool, then report the first failure in order
+  enum { ki_ok, ki_bad_domain, ki_bad_signature };
+  std::vector<crypto::public_key> pkeys(signed_key_images.size());
+  std::vector<uint8_t> check_results(signed_key_images.size(), ki_ok);
   for (size_t n = 0; n < signed_key_images.size(); ++n)
   {
     const transfer_details &td = m_transfers[n + offset];
-    const crypto::key_image &key_image = signed_key_images[n].first;
-    const crypto::signature &signature = signed_key_images[n].second;
 
     // get ephemeral public key
     const cryptonote::tx_out &out = td.m_tx.vout[td.m_internal_output_index];
     THROW_WALLET_EXCEPTION_IF(out.target.type() != typeid(txout_to_key), error::wallet_internal_error,
       "Non txout_to_key output found");
-    const cryptonote::txout_to_key &o = boost::get<cryptonote::txout_to_key>(out.target);
-    const crypto::public_key pkey = o.key;
-
-    if (!td.m_key_image_known || !(key_image == td.m_key_image))
+    pkeys[n] = boost::get<cryptonote::txout_to_key>(out.target).key;
+  }
+  const bool checked = tools::parallel_for(0, signed_key_images.size(), 64, [&](const size_t begin, const size_t end){
+    for (size_t n = begin; n < end; ++n)
     {
-      std::vector<const crypto::public_key*> pkeys;
-      pkeys.push_back(&pkey);
-      THROW_WALLET_EXCEPTION_IF(!(rct::scalarmultKey(rct::ki2rct(key_image), rct::curveOrder()) == rct::identity()),
-          error::wallet_internal_error, "Key image out of validity domain: input " + boost::lexical_cast<std::string>(n + offset) + "/"
-          + boost::lexical_cast<std::string>(signed_key_images.size()) + ", key image " + epee::string_tools::pod_to_hex(key_image));
-
-      THROW_WALLET_EXCEPTION_IF(!crypto::check_ring_signature((const crypto::hash&)key_image, key_image, pkeys, &signature),
-          error::signature_check_failed, boost::lexical_cast<std::string>(n + offset) + "/"
-          + boost::lexical_cast<std::string>(signed_key_images.size()) + ", key image " + epee::string_tools::pod_to_hex(key_image)
-          + ", signature " + epee::string_tools::pod_to_hex(signature) + ", pubkey " + epee::string_tools::pod_to_hex(*pkeys[0]));
+      const transfer_details &td = m_transfers[n + offset];
+      const crypto::key_image &key_image = signed_key_images[n].first;
+      if (td.m_key_image_known && key_image == td.m_key_image)
+        continue;
+      const crypto::public_key *pkey = &pkeys[n];
+      bool in_domain;
+      try { in_domain = rct::scalarmultKey(rct::ki2rct(key_image), rct::curveOrder()) == rct::identity(); }
+      catch (const std::exception &e) { in_domain = false; } // not a point: report it in order below
+      if (!in_domain)
+        check_results[n] = ki_bad_domain;
+      else if (!crypto::check_ring_signature((const crypto::hash&)key_image, key_image, &pkey, 1, &signed_key_images[n].second))
+        check_results[n] = ki_bad_signature;
     }
+  });
+  THROW_WALLET_EXCEPTION_IF(!checked, error::wallet_internal_error, "Failed to check key image signatures");
+  for (size_t n = 0; n < signed_key_images.size(); ++n)
+  {
+    const crypto::key_image &key_image = signed_key_images[n].first;
+    const crypto::signature &signature = signed_key_images[n].second;
+
+    THROW_WALLET_EXCEPTION_IF(check_results[n] == ki_bad_domain,
+        error::wallet_internal_error, "Key image out of validity domain: input " + boost::lexical_cast<std::string>(n + offset) + "/"
+        + boost::lexical_cast<std::string>(signed_key_images.size()) + ", key image " + epee::string_tools::pod_to_hex(key_image));
+
+    THROW_WALLET_EXCEPTION_IF(check_results[n] == ki_bad_signature,
+        error::signature_check_failed, boost::lexical_cast<std::string>(n + offset) + "/"
+        + boost::lexical_cast<std::string>(signed_key_images.size()) + ", key image " + epee::string_tools::pod_to_hex(key_image)
+        + ", signature " + epee::string_tools::pod_to_hex(signature) + ", pubkey " + epee::string_tools::pod_to_hex(pkeys[n]));
     req.key_images.push_back(epee::string_tools::pod_to_hex(key_image));
   }
   PERF_TIMER_STOP(import_key_images_A);
@@ -12828,6 +13642,7 @@ uint64_t wallet2::import_key_images(const std::vector<std::pair<crypto::key_imag
       transfer_details &td = m_transfers[n + offset];
       td.m_spent = daemon_resp.spent_status[n] != COMMAND_RPC_IS_KEY_IMAGE_SPENT::UNSPENT;
     }
+    m_unspent_transfers_dirty = true;
   }
   spent = 0;
   unspent = 0;
@@ -12889,6 +13704,9 @@ uint64_t wallet2::import_key_images(const std::vector<std::pair<crypto::key_imag
 
   if (check_spent)
   {
+    // outgoing txes found here go into the history at their own (old) heights, which only a full save picks up
+    m_cache_log_force_full = true;
+
     // query outgoing txes
     COMMAND_RPC_GET_TRANSACTIONS::request gettxs_req;
     COMMAND_RPC_GET_TRANSACTIONS::response gettxs_res;
@@ -13085,6 +13903,7 @@ wallet2::payment_container wallet2::export_payments() const
 }
 void wallet2::import_payments(const payment_container &payments)
 {
+  m_cache_log_force_full = true;
   m_payments.clear();
   for (auto const &p : payments)
   {
@@ -13093,6 +13912,7 @@ void wallet2::import_payments(const payment_container &payments)
 }
 void wallet2::import_payments_out(const std::list<std::pair<crypto::hash,wallet2::confirmed_transfer_details>> &confirmed_payments)
 {
+  m_cache_log_force_full = true;
   m_confirmed_txs.clear();
   for (auto const &p : confirmed_payments)
   {
@@ -13182,6 +14002,7 @@ size_t wallet2::import_outputs(const std::pair<uint64_t, std::vector<tools::wall
   const size_t offset = outputs.first;
   const size_t original_size = m_transfers.size();
   m_transfers.resize(offset + outputs.second.size());
+  m_unspent_transfers_dirty = true;
   for (size_t i = 0; i < offset; ++i)
     m_transfers[i].m_key_image_request = false;
   for (size_t i = 0; i < outputs.second.size(); ++i)
@@ -13968,9 +14789,10 @@ std::vector<std::pair<uint64_t, uint64_t>> wallet2::estimate_backlog(const std::
     const boost::lock_guard<boost::recursive_mutex> lock{m_daemon_rpc_mutex};
     uint64_t pre_call_credits = m_rpc_payment_state.credits;
     req.client = get_client_signature();
+    req.fee_histogram = true;
     bool r = net_utils::invoke_http_json_rpc("/json_rpc", "get_txpool_backlog", req, res, *m_http_client, rpc_timeout);
     THROW_ON_RPC_RESPONSE_ERROR(r, {}, res, "get_txpool_backlog", error::get_tx_pool_error);
-    check_rpc_cost("get_txpool_backlog", res.credits, pre_call_credits, COST_PER_TX_POOL_STATS * res.backlog.size());
+    check_rpc_cost("get_txpool_backlog", res.credits, pre_call_credits, COST_PER_TX_POOL_STATS * (res.fee_histogram.empty() ? res.backlog.size() : res.fee_histogram.size()));
   }
 
   uint64_t block_weight_limit = 0;
@@ -13985,6 +14807,15 @@ std::vector<std::pair<uint64_t, uint64_t>> wallet2::estimate_backlog(const std::
     const double our_fee_byte_min = fee_level.first;
     const double our_fee_byte_max = fee_level.second;
     uint64_t priority_weight_min = 0, priority_weight_max = 0;
+    // a bucket straddling our fee is counted in full, erring towards a larger backlog
+    for (const auto &i: res.fee_histogram)
+    {
+      if (i.max_fee_per_byte > our_fee_byte_min)
+        priority_weight_min += i.weight;
+      if (i.max_fee_per_byte > our_fee_byte_max)
+        priority_weight_max += i.weight;
+    }
+    // daemons without fee_histogram support send the whole backlog instead
     for (const auto &i: res.backlog)
     {
       if (i.weight == 0)
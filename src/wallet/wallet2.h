@@ -69,6 +69,8 @@
 #include "common/password.h"
 #include "node_rpc_proxy.h"
 #include "message_store.h"
+#include "scan_index.h"
+#include "cache_log.h"
 #include "wallet_light_rpc.h"
 #include "wallet_rpc_helpers.h"
 
@@ -91,6 +93,7 @@ class wallet_accessor_test;
 namespace tools
 {
   class ringdb;
+  class shared_block_cache;
   class wallet2;
   class Notify;
 
@@ -630,6 +633,50 @@ private:
       END_SERIALIZE()
     };
 
+    struct cache_log_transfer
+    {
+      uint64_t index;
+      transfer_details td;
+      bool key_image_indexed; // m_key_images maps the transfer's key image to it
+      bool pub_key_indexed; // m_pub_keys maps the transfer's public key to it
+
+      BEGIN_SERIALIZE_OBJECT()
+        VARINT_FIELD(index)
+        FIELD(td)
+        FIELD(key_image_indexed)
+        FIELD(pub_key_indexed)
+      END_SERIALIZE()
+    };
+
+    // the changes to the wallet cache since the previous save, as appended to the cache log
+    struct cache_log_record
+    {
+      uint64_t num_transfers;
+      std::vector<cache_log_transfer> transfers; // new or changed, by increasing index
+      uint64_t start_height; // block hashes, payments and confirmed txes from this height on are replaced
+      uint64_t blockchain_offset;
+      std::vector<crypto::hash> blockchain;
+      std::vector<std::pair<crypto::hash, payment_details>> payments;
+      std::vector<std::pair<crypto::hash, confirmed_transfer_details>> confirmed_txs;
+      bool has_subaddresses; // only logged when the table grew
+      std::vector<std::pair<crypto::public_key, cryptonote::subaddress_index>> subaddresses;
+      std::string other; // every other cache field, in full
+
+      BEGIN_SERIALIZE_OBJECT()
+        VERSION_FIELD(0)
+        VARINT_FIELD(num_transfers)
+        FIELD(transfers)
+        VARINT_FIELD(start_height)
+        VARINT_FIELD(blockchain_offset)
+        FIELD(blockchain)
+        FIELD(payments)
+        FIELD(confirmed_txs)
+        FIELD(has_subaddresses)
+        FIELD(subaddresses)
+        FIELD(other)
+      END_SERIALIZE()
+    };
+
     // GUI Address book
     struct address_book_row
     {
@@ -1140,9 +1187,17 @@ private:
 
     BEGIN_SERIALIZE_OBJECT()
       MAGIC_FIELD("monero wallet cache")
-      VERSION_FIELD(0)
+      VERSION_FIELD(m_transfer_store_id == crypto::null_hash ? 0 : 1)
       FIELD(m_blockchain)
-      FIELD(m_transfers)
+      // from version 1, the transfers are in a columnar store next to the cache file (see transfer_store)
+      if (version < 1)
+      {
+        FIELD(m_transfers)
+      }
+      else
+      {
+        FIELD(m_transfer_store_id)
+      }
       FIELD(m_account_public_address)
       FIELD(m_key_images)
       FIELD(m_unconfirmed_txs)
@@ -1168,6 +1223,33 @@ private:
       FIELD(m_rpc_client_secret_key)
     END_SERIALIZE()
 
+    // the cache fields a cache log record carries in full (see cache_log_record)
+    template <bool W, template <bool> class Archive>
+    bool serialize_cache_log_other(Archive<W> &ar)
+    {
+      ar.begin_object();
+      FIELD(m_account_public_address)
+      FIELD(m_unconfirmed_txs)
+      FIELD(m_tx_keys)
+      FIELD(m_tx_notes)
+      FIELD(m_unconfirmed_payments)
+      FIELD(m_address_book)
+      FIELD(m_scanned_pool_txs[0])
+      FIELD(m_scanned_pool_txs[1])
+      FIELD(m_subaddress_labels)
+      FIELD(m_additional_tx_keys)
+      FIELD(m_attributes)
+      FIELD(m_account_tags)
+      FIELD(m_ring_history_saved)
+      FIELD(m_last_block_reward)
+      FIELD(m_tx_device)
+      FIELD(m_device_last_key_image_sync)
+      FIELD(m_cold_key_images)
+      FIELD(m_rpc_client_secret_key)
+      ar.end_object();
+      return ar.good();
+    }
+
     /*!
      * \brief  Check if wallet keys and bin files exist
      * \param  file_path           Wallet file path
@@ -1229,6 +1311,14 @@ private:
     void ignore_outputs_below(uint64_t value) { m_ignore_outputs_below = value; }
     bool track_uses() const { return m_track_uses; }
     void track_uses(bool value) { m_track_uses = value; }
+    bool use_scan_index() const { return m_use_scan_index; }
+    void use_scan_index(bool value);
+    bool incremental_cache() const { return m_incremental_cache; }
+    void incremental_cache(bool value);
+    bool columnar_transfers() const { return m_columnar_transfers; }
+    void columnar_transfers(bool value) { m_columnar_transfers = value; }
+    /// take pulled and parsed blocks from, and give them to, the other wallets sharing 'cache' (nullptr to stop)
+    void set_shared_block_cache(std::shared_ptr<shared_block_cache> cache) { m_shared_block_cache = std::move(cache); }
     BackgroundMiningSetupType setup_background_mining() const { return m_setup_background_mining; }
     void setup_background_mining(BackgroundMiningSetupType value) { m_setup_background_mining = value; }
     uint32_t inactivity_lock_timeout() const { return m_inactivity_lock_timeout; }
@@ -1592,6 +1682,7 @@ private:
     void fast_refresh(uint64_t stop_height, uint64_t &blocks_start_height, std::list<crypto::hash> &short_chain_history, bool force = false);
     void pull_and_parse_next_blocks(uint64_t start_height, uint64_t &blocks_start_height, std::list<crypto::hash> &short_chain_history, const std::vector<cryptonote::block_complete_entry> &prev_blocks, const std::vector<parsed_block> &prev_parsed_blocks, std::vector<cryptonote::block_complete_entry> &blocks, std::vector<parsed_block> &parsed_blocks, bool &last, bool &error, std::exception_ptr &exception);
     void process_parsed_blocks(uint64_t start_height, const std::vector<cryptonote::block_complete_entry> &blocks, const std::vector<parsed_block> &parsed_blocks, uint64_t& blocks_added, std::map<std::pair<uint64_t, uint64_t>, size_t> *output_tracker_cache = NULL);
+    void record_scan_index_block(uint64_t height, const crypto::hash &block_hash, size_t num_subaddresses, const std::vector<tx_cache_data> &tx_cache_data, size_t tx_cache_data_offset, size_t num_txes);
     uint64_t select_transfers(uint64_t needed_money, std::vector<size_t> unused_transfers_indices, std::vector<size_t>& selected_transfers) const;
     bool prepare_file_names(const std::string& file_path);
     void process_unconfirmed(const crypto::hash &txid, const cryptonote::transaction& tx, uint64_t height);
@@ -1602,6 +1693,7 @@ private:
     bool generate_chacha_key_from_secret_keys(crypto::chacha_key &key) const;
     void generate_chacha_key_from_password(const epee::wipeable_string &pass, crypto::chacha_key &key) const;
     crypto::hash get_payment_id(const pending_tx &ptx) const;
+    boost::optional<cryptonote::subaddress_receive_info> is_out_to_acc(const crypto::public_key &out_key, const crypto::key_derivation &derivation, const std::vector<crypto::key_derivation> &additional_derivations, size_t i, hw::device &hwdev) const;
     void check_acc_out_precomp(const cryptonote::tx_out &o, const crypto::key_derivation &derivation, const std::vector<crypto::key_derivation> &additional_derivations, size_t i, tx_scan_info_t &tx_scan_info) const;
     void check_acc_out_precomp(const cryptonote::tx_out &o, const crypto::key_derivation &derivation, const std::vector<crypto::key_derivation> &additional_derivations, size_t i, const is_out_data *is_out_data, tx_scan_info_t &tx_scan_info) const;
     void check_acc_out_precomp_once(const cryptonote::tx_out &o, const crypto::key_derivation &derivation, const std::vector<crypto::key_derivation> &additional_derivations, size_t i, const is_out_data *is_out_data, tx_scan_info_t &tx_scan_info, bool &already_seen) const;
@@ -1615,6 +1707,8 @@ private:
     void set_unspent(size_t idx);
     bool is_spent(const transfer_details &td, bool strict = true) const;
     bool is_spent(size_t idx, bool strict = true) const;
+    const std::map<uint32_t, std::set<size_t>> &get_unspent_transfers();
+    const std::set<size_t> &get_unspent_transfers(uint32_t index_major);
     void get_outs(std::vector<std::vector<get_outs_entry>> &outs, const std::vector<size_t> &selected_transfers, size_t fake_outputs_count, bool rct);
     void get_outs(std::vector<std::vector<get_outs_entry>> &outs, const std::vector<size_t> &selected_transfers, size_t fake_outputs_count, std::vector<uint64_t> &rct_offsets);
     bool tx_add_fake_output(std::vector<std::vector<tools::wallet2::get_outs_entry>> &outs, uint64_t global_index, const crypto::public_key& tx_public_key, const rct::key& mask, uint64_t real_index, bool unlocked) const;
@@ -1622,6 +1716,16 @@ private:
     std::vector<size_t> get_only_rct(const std::vector<size_t> &unused_dust_indices, const std::vector<size_t> &unused_transfers_indices) const;
     void scan_output(const cryptonote::transaction &tx, bool miner_tx, const crypto::public_key &tx_pub_key, size_t i, tx_scan_info_t &tx_scan_info, int &num_vouts_received, std::unordered_map<cryptonote::subaddress_index, uint64_t> &tx_money_got_in_outs, std::vector<size_t> &outs, bool pool);
     void trim_hashchain();
+    std::string get_scan_index_file() const { return m_wallet_file + ".scanidx"; }
+    void verify_scan_index();
+    std::string get_cache_log_file() const { return m_wallet_file + ".cachelog"; }
+    static std::string get_transfer_store_file(const std::string &wallet_file, const crypto::hash &id);
+    static void remove_transfer_stores(const std::string &wallet_file, const crypto::hash &keep);
+    bool append_cache_log();
+    void reset_cache_log(const crypto::chacha_iv &base_iv, uint64_t base_size);
+    void load_cache_log(const crypto::chacha_iv &base_iv, uint64_t base_size);
+    bool apply_cache_log_record(const std::string &blob);
+    void mark_cache_log_saved();
     crypto::key_image get_multisig_composite_key_image(size_t n) const;
     rct::multisig_kLRki get_multisig_composite_kLRki(size_t n,  const std::unordered_set<crypto::public_key> &ignore_set, std::unordered_set<rct::key> &used_L, std::unordered_set<rct::key> &new_used_L) const;
     rct::multisig_kLRki get_multisig_kLRki(size_t n, const rct::key &k) const;
@@ -1692,6 +1796,7 @@ private:
     serializable_unordered_map<crypto::public_key, size_t> m_pub_keys;
     cryptonote::account_public_address m_account_public_address;
     serializable_unordered_map<crypto::public_key, cryptonote::subaddress_index> m_subaddresses;
+    cryptonote::subaddress_table m_subaddress_table; // mirrors m_subaddresses for scanning
     std::vector<std::vector<std::string>> m_subaddress_labels;
     serializable_unordered_map<crypto::hash, std::string> m_tx_notes;
     serializable_unordered_map<std::string, std::string> m_attributes;
@@ -1749,6 +1854,9 @@ private:
     uint64_t m_ignore_outputs_above;
     uint64_t m_ignore_outputs_below;
     bool m_track_uses;
+    bool m_use_scan_index;
+    bool m_incremental_cache;
+    bool m_columnar_transfers;
     uint32_t m_inactivity_lock_timeout;
     BackgroundMiningSetupType m_setup_background_mining;
     bool m_persistent_rpc_client_id;
@@ -1789,6 +1897,32 @@ private:
     std::unique_ptr<ringdb> m_ringdb;
     boost::optional<crypto::chacha_key> m_ringdb_key;
 
+    scan_index m_scan_index;
+    bool m_scan_index_verified;
+
+    std::shared_ptr<shared_block_cache> m_shared_block_cache;
+
+    // state as of the last save, to tell what the next cache log record has to carry
+    cache_log m_cache_log;
+    std::vector<uint64_t> m_cache_log_fingerprints; // one per transfer
+    uint64_t m_cache_log_height; // lowered by reorgs
+    size_t m_cache_log_chain_offset;
+    size_t m_cache_log_num_subaddresses;
+    bool m_cache_log_force_full;
+
+    // only set while the cache is read or written with its transfers in a transfer store
+    crypto::hash m_transfer_store_id;
+
+    // non strictly unspent transfers per subaddress account, in m_transfers order. Kept current by
+    // set_spent/set_unspent, new transfers are picked up on use, anything else marks it dirty
+    std::map<uint32_t, std::set<size_t>> m_unspent_transfers;
+    size_t m_unspent_transfers_size; // number of leading m_transfers entries indexed
+    bool m_unspent_transfers_dirty;
+
+    // cumulative rct output counts per block from the daemon, so later tx creations only fetch new blocks
+    std::vector<uint64_t> m_rct_distribution;
+    uint64_t m_rct_distribution_start_height;
+
     uint64_t m_last_block_reward;
     std::unique_ptr<tools::file_locker> m_keys_file_locker;
     
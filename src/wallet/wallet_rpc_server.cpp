@@ -67,6 +67,7 @@ namespace
   const command_line::arg_descriptor<bool> arg_disable_rpc_login = {"disable-rpc-login", "Disable HTTP authentication for RPC connections served by this process"};
   const command_line::arg_descriptor<bool> arg_restricted = {"restricted-rpc", "Restricts to view-only commands", false};
   const command_line::arg_descriptor<std::string> arg_wallet_dir = {"wallet-dir", "Directory for newly created wallets"};
+  const command_line::arg_descriptor<bool> arg_multi_wallet = {"multi-wallet", "Keep every wallet opened from --wallet-dir loaded and refresh them all, pulling each block from the daemon once", false};
   const command_line::arg_descriptor<bool> arg_prompt_for_password = {"prompt-for-password", "Prompts for password when not provided", false};
 
   constexpr const char default_rpc_username[] = "monero";
@@ -115,13 +116,14 @@ namespace tools
   }
 
   //------------------------------------------------------------------------------------------------------------------------------
-  wallet_rpc_server::wallet_rpc_server():m_wallet(NULL), rpc_login_file(), m_stop(false), m_restricted(false), m_vm(NULL)
+  wallet_rpc_server::wallet_rpc_server():m_wallet(NULL), m_multi_wallet(false), rpc_login_file(), m_stop(false), m_restricted(false), m_vm(NULL)
   {
   }
   //------------------------------------------------------------------------------------------------------------------------------
   wallet_rpc_server::~wallet_rpc_server()
   {
-    if (m_wallet)
+    // hosted wallets are owned by m_hosted_wallets
+    if (m_wallet && !m_multi_wallet)
       delete m_wallet;
   }
   //------------------------------------------------------------------------------------------------------------------------------
@@ -138,11 +140,7 @@ namespace tools
         return true;
       if (boost::posix_time::microsec_clock::universal_time() < m_last_auto_refresh_time + boost::posix_time::seconds(m_auto_refresh_period))
         return true;
-      try {
-        if (m_wallet) m_wallet->refresh(m_wallet->is_trusted_daemon());
-      } catch (const std::exception& ex) {
-        LOG_ERROR("Exception at while refreshing, what=" << ex.what());
-      }
+      refresh_wallets();
       m_last_auto_refresh_time = boost::posix_time::microsec_clock::universal_time();
       return true;
     }, 1000);
@@ -161,6 +159,18 @@ namespace tools
   //------------------------------------------------------------------------------------------------------------------------------
   void wallet_rpc_server::stop()
   {
+    if (m_multi_wallet)
+    {
+      for (auto &hosted: m_hosted_wallets)
+      {
+        hosted.second->store();
+        hosted.second->deinit();
+      }
+      m_hosted_wallets.clear();
+      m_wallet = NULL;
+      return;
+    }
+
     if (m_wallet)
     {
       m_wallet->store();
@@ -170,6 +180,69 @@ namespace tools
     }
   }
   //------------------------------------------------------------------------------------------------------------------------------
+  void wallet_rpc_server::set_current_wallet(std::unique_ptr<wallet2> wal, const std::string &wallet_file)
+  {
+    if (!m_multi_wallet)
+    {
+      if (m_wallet)
+        delete m_wallet;
+      m_wallet = wal.release();
+      return;
+    }
+
+    // a wallet created or restored over a hosted file replaces it
+    wal->set_shared_block_cache(m_shared_block_cache);
+    std::unique_ptr<wallet2> &hosted = m_hosted_wallets[wallet_file];
+    hosted = std::move(wal);
+    m_wallet = hosted.get();
+    MINFO("Hosting " << m_hosted_wallets.size() << " wallet(s)");
+  }
+  //------------------------------------------------------------------------------------------------------------------------------
+  void wallet_rpc_server::close_current_wallet()
+  {
+    if (!m_multi_wallet)
+    {
+      delete m_wallet;
+      m_wallet = NULL;
+      return;
+    }
+
+    for (auto it = m_hosted_wallets.begin(); it != m_hosted_wallets.end(); ++it)
+    {
+      if (it->second.get() == m_wallet)
+      {
+        m_hosted_wallets.erase(it);
+        break;
+      }
+    }
+    m_wallet = NULL;
+  }
+  //------------------------------------------------------------------------------------------------------------------------------
+  void wallet_rpc_server::refresh_wallets()
+  {
+    if (!m_multi_wallet)
+    {
+      try {
+        if (m_wallet) m_wallet->refresh(m_wallet->is_trusted_daemon());
+      } catch (const std::exception& ex) {
+        LOG_ERROR("Exception at while refreshing, what=" << ex.what());
+      }
+      return;
+    }
+
+    // one after the other: the first wallet at a given height pulls and parses the blocks, the
+    // others take them from the shared cache and only scan them
+    for (auto &hosted: m_hosted_wallets)
+    {
+      try {
+        hosted.second->refresh(hosted.second->is_trusted_daemon());
+      } catch (const std::exception& ex) {
+        LOG_ERROR("Exception at while refreshing " << hosted.first << ", what=" << ex.what());
+      }
+    }
+    MDEBUG("Shared block cache: " << m_shared_block_cache->hits() << " hits, " << m_shared_block_cache->misses() << " misses");
+  }
+  //------------------------------------------------------------------------------------------------------------------------------
   bool wallet_rpc_server::init(const boost::program_options::variables_map *vm)
   {
     auto rpc_config = cryptonote::rpc_args::process(*vm);
@@ -182,6 +255,11 @@ namespace tools
     std::string bind_port = command_line::get_arg(*m_vm, arg_rpc_bind_port);
     const bool disable_auth = command_line::get_arg(*m_vm, arg_disable_rpc_login);
     m_restricted = command_line::get_arg(*m_vm, arg_restricted);
+    if (command_line::get_arg(*m_vm, arg_multi_wallet) && command_line::is_arg_defaulted(*m_vm, arg_wallet_dir))
+    {
+      MERROR(arg_multi_wallet.name << " needs " << arg_wallet_dir.name);
+      return false;
+    }
     if (!command_line::is_arg_defaulted(*m_vm, arg_wallet_dir))
     {
       if (!command_line::is_arg_defaulted(*m_vm, wallet_args::arg_wallet_file()))
@@ -190,6 +268,9 @@ namespace tools
         return false;
       }
       m_wallet_dir = command_line::get_arg(*m_vm, arg_wallet_dir);
+      m_multi_wallet = command_line::get_arg(*m_vm, arg_multi_wallet);
+      if (m_multi_wallet)
+        m_shared_block_cache = std::make_shared<shared_block_cache>();
 #ifdef _WIN32
 #define MKDIR(path, mode)    mkdir(path)
 #else
@@ -3333,9 +3414,8 @@ namespace tools
         handle_rpc_exception(std::current_exception(), er, WALLET_RPC_ERROR_CODE_UNKNOWN_ERROR);
         return false;
       }
-      delete m_wallet;
     }
-    m_wallet = wal.release();
+    set_current_wallet(std::move(wal), wallet_file);
     return true;
   }
   //------------------------------------------------------------------------------------------------------------------------------
@@ -3376,6 +3456,22 @@ namespace tools
       }
     }
     std::string wallet_file = m_wallet_dir + "/" + req.filename;
+    if (m_multi_wallet)
+    {
+      // already loaded: just select it
+      const auto hosted = m_hosted_wallets.find(wallet_file);
+      if (hosted != m_hosted_wallets.end())
+      {
+        if (!hosted->second->verify_password(req.password))
+        {
+          er.code = WALLET_RPC_ERROR_CODE_INVALID_PASSWORD;
+          er.message = "Invalid password";
+          return false;
+        }
+        m_wallet = hosted->second.get();
+        return true;
+      }
+    }
     {
       po::options_description desc("dummy");
       const command_line::arg_descriptor<std::string, true> arg_password = {"password", "password"};
@@ -3404,9 +3500,7 @@ namespace tools
       return false;
     }
 
-    if (m_wallet)
-      delete m_wallet;
-    m_wallet = wal.release();
+    set_current_wallet(std::move(wal), wallet_file);
     return true;
   }
   //------------------------------------------------------------------------------------------------------------------------------
@@ -3426,8 +3520,7 @@ namespace tools
         return false;
       }
     }
-    delete m_wallet;
-    m_wallet = NULL;
+    close_current_wallet();
     return true;
   }
   //------------------------------------------------------------------------------------------------------------------------------
@@ -3718,9 +3811,7 @@ namespace tools
       return false;
     }
 
-    if (m_wallet)
-      delete m_wallet;
-    m_wallet = wal.release();
+    set_current_wallet(std::move(wal), wallet_file);
     res.address = m_wallet->get_account().get_public_address_str(m_wallet->nettype());
     return true;
   }
@@ -3901,9 +3992,7 @@ namespace tools
       return false;
     }
 
-    if (m_wallet)
-      delete m_wallet;
-    m_wallet = wal.release();
+    set_current_wallet(std::move(wal), wallet_file);
     res.address = m_wallet->get_account().get_public_address_str(m_wallet->nettype());
     res.info = "Wallet has been restored successfully.";
     return true;
@@ -4711,6 +4800,7 @@ int main(int argc, char** argv) {
   command_line::add_arg(desc_params, arg_wallet_file);
   command_line::add_arg(desc_params, arg_from_json);
   command_line::add_arg(desc_params, arg_wallet_dir);
+  command_line::add_arg(desc_params, arg_multi_wallet);
   command_line::add_arg(desc_params, arg_prompt_for_password);
   command_line::add_arg(desc_params, arg_rpc_client_secret_key);
 
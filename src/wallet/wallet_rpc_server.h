@@ -32,12 +32,15 @@
 
 #include <boost/program_options/options_description.hpp>
 #include <boost/program_options/variables_map.hpp>
+#include <map>
+#include <memory>
 #include <string>
 #include "common/util.h"
 #include "net/http_server_impl_base.h"
 #include "math_helper.h"
 #include "wallet_rpc_server_commands_defs.h"
 #include "wallet2.h"
+#include "shared_block_cache.h"
 
 #undef MONERO_DEFAULT_LOG_CATEGORY
 #define MONERO_DEFAULT_LOG_CATEGORY "wallet.rpc"
@@ -272,7 +275,15 @@ namespace tools
 
       void check_background_mining();
 
+      // with --multi-wallet, every wallet opened stays loaded in m_hosted_wallets and m_wallet is the selected one
+      void set_current_wallet(std::unique_ptr<wallet2> wal, const std::string &wallet_file);
+      void close_current_wallet();
+      void refresh_wallets();
+
       wallet2 *m_wallet;
+      bool m_multi_wallet;
+      std::map<std::string, std::unique_ptr<wallet2>> m_hosted_wallets;
+      std::shared_ptr<shared_block_cache> m_shared_block_cache;
       std::string m_wallet_dir;
       tools::private_file rpc_login_file;
       std::atomic<bool> m_stop;
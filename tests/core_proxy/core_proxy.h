@@ -35,8 +35,14 @@
 #include "cryptonote_basic/cryptonote_basic_impl.h"
 #include "cryptonote_basic/verification_context.h"
 #include "cryptonote_core/i_core_events.h"
+#include <memory>
 #include <unordered_map>
 
+namespace cryptonote
+{
+  struct txpool_parsed_tx;
+}
+
 namespace tests
 {
   struct block_index {
@@ -95,6 +101,7 @@ namespace tests
     virtual void on_transactions_relayed(epee::span<const cryptonote::blobdata> tx_blobs, cryptonote::relay_method tx_relay) {}
     cryptonote::network_type get_nettype() const { return cryptonote::MAINNET; }
     bool get_pool_transaction(const crypto::hash& id, cryptonote::blobdata& tx_blob, cryptonote::relay_category tx_category) const { return false; }
+    std::shared_ptr<const cryptonote::txpool_parsed_tx> get_pool_parsed_transaction(const crypto::hash& id, cryptonote::relay_category tx_category) const { return nullptr; }
     bool pool_has_tx(const crypto::hash &txid) const { return false; }
     bool get_blocks(uint64_t start_offset, size_t count, std::vector<std::pair<cryptonote::blobdata, cryptonote::block>>& blocks, std::vector<cryptonote::blobdata>& txs) const { return false; }
     bool get_transactions(const std::vector<crypto::hash>& txs_ids, std::vector<cryptonote::transaction>& txs, std::vector<crypto::hash>& missed_txs) const { return false; }
@@ -31,6 +31,7 @@
 #include <cstddef>
 #include <cstring>
 #include <fstream>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -57,6 +58,34 @@ bool operator !=(const key_derivation &a, const key_derivation &b) {
   return 0 != memcmp(&a, &b, sizeof(key_derivation));
 }
 
+struct ring_signature_vector {
+  chash prefix_hash;
+  key_image image;
+  vector<public_key> pubs;
+  vector<signature> sigs;
+  bool expected;
+};
+
+// verifies every check_ring_signature vector again in one batch, so the rings share the batched point work
+static bool check_ring_signatures_batch(const vector<ring_signature_vector> &vectors) {
+  vector<vector<const public_key *>> pubs(vectors.size());
+  vector<ring_signature_check> checks;
+  for (size_t n = 0; n < vectors.size(); n++) {
+    for (const public_key &pub: vectors[n].pubs) {
+      pubs[n].push_back(&pub);
+    }
+    checks.push_back({&vectors[n].prefix_hash, &vectors[n].image, pubs[n].data(), pubs[n].size(), vectors[n].sigs.data()});
+  }
+  std::unique_ptr<bool[]> valid(new bool[checks.size()]);
+  check_ring_signatures(checks.data(), checks.size(), valid.get());
+  for (size_t n = 0; n < vectors.size(); n++) {
+    if (valid[n] != vectors[n].expected) {
+      return false;
+    }
+  }
+  return true;
+}
+
 DISABLE_GCC_WARNING(maybe-uninitialized)
 
 int main(int argc, char *argv[]) {
@@ -65,6 +94,7 @@ int main(int argc, char *argv[]) {
   string cmd;
   size_t test = 0;
   bool error = false;
+  vector<ring_signature_vector> ring_signature_vectors;
   setup_random();
   input.open(argv[1], ios_base::in);
   for (;;) {
@@ -255,6 +285,7 @@ int main(int argc, char *argv[]) {
       if (expected != actual) {
         goto error;
       }
+      ring_signature_vectors.push_back({prefix_hash, image, vpubs, sigs, expected});
     } else if (cmd == "check_ge_p3_identity") {
       public_key point;
       bool expected_bad, expected_good, result_badfunc, result_goodfunc;
@@ -272,6 +303,10 @@ error:
     cerr << "Wrong result on test " << test << endl;
     error = true;
   }
+  if (!check_ring_signatures_batch(ring_signature_vectors)) {
+    cerr << "Wrong result on batched check_ring_signature tests" << endl;
+    error = true;
+  }
   //if (siphash_test() != 0)
   {
     //cerr << "Wrong result on test 'siphash_test'" << endl;
@@ -28,6 +28,7 @@
 // 
 // Parts of this file are originally copyright (c) 2012-2013 The Cryptonote developers
 
+#include <algorithm>
 #include <atomic>
 #include <chrono>
 #include <functional>
@@ -627,6 +628,98 @@ TEST_F(net_load_test_clt, permament_open_and_close_and_connections_closed_by_ser
   ASSERT_EQ(RESERVED_CONN_CNT, m_tcp_server.get_config_object().get_connections_count());
 }
 
+TEST_F(net_load_test_clt, echo_throughput_and_latency_with_many_connections)
+{
+  // Run the server with --io-service-per-thread to compare it with the shared io_service
+  static const size_t REQUESTS_PER_CONNECTION = 20;
+  static const size_t ECHO_SIZE = 256;
+  // long enough to measure the tail rather than fail on slow machines
+  static const size_t ECHO_TIMEOUT = 4 * DEFAULT_OPERATION_TIMEOUT;
+
+  for (const size_t connection_count : {1000, 10000})
+  {
+    CMD_ECHO::request req;
+    req.data.assign(ECHO_SIZE, 'x');
+    std::vector<boost::uuids::uuid> connections(connection_count, boost::uuids::nil_uuid());
+    std::vector<uint64_t> latencies(connection_count * REQUESTS_PER_CONNECTION, 0);
+    std::vector<uint8_t> finished(connection_count, 0);
+    std::atomic<size_t> finished_connections(0);
+    std::atomic<size_t> error_count(0);
+    // a failed invoke may both call back and return false, so finish each connection only once
+    auto finish = [&](size_t conn_idx, bool ok) {
+      if (finished[conn_idx])
+        return;
+      finished[conn_idx] = 1;
+      if (!ok)
+        error_count.fetch_add(1, std::memory_order_relaxed);
+      finished_connections.fetch_add(1, std::memory_order_relaxed);
+    };
+    std::function<void(size_t, size_t)> send_echo = [&](size_t conn_idx, size_t req_idx) {
+      const epee::net_utils::connection_context_base context(connections[conn_idx], {}, false, false);
+      const auto start = std::chrono::steady_clock::now();
+      bool r = epee::net_utils::async_invoke_remote_command2<CMD_ECHO::response>(context, CMD_ECHO::ID, req,
+        m_tcp_server.get_config_object(), [&, conn_idx, req_idx, start](int code, const CMD_ECHO::response& rsp, const test_connection_context&) {
+          if (code <= 0 || rsp.data.size() != ECHO_SIZE)
+          {
+            finish(conn_idx, false);
+            return;
+          }
+          latencies[conn_idx * REQUESTS_PER_CONNECTION + req_idx] = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+          if (req_idx + 1 < REQUESTS_PER_CONNECTION)
+            send_echo(conn_idx, req_idx + 1);
+          else
+            finish(conn_idx, true);
+      }, ECHO_TIMEOUT);
+      if (!r)
+        finish(conn_idx, false);
+    };
+
+    // Each connection sends its echo requests one after another as soon as it is open, so that none
+    // stays idle while the rest are opened (the server shortens idle timeouts under many connections)
+    const auto start = std::chrono::steady_clock::now();
+    std::atomic<size_t> next_connection(0);
+    parallel_exec([&] {
+      for (size_t i = next_connection.fetch_add(1); i < connection_count; i = next_connection.fetch_add(1))
+      {
+        bool r = m_tcp_server.connect_async("127.0.0.1", srv_port, CONNECTION_TIMEOUT, [&, i](const test_connection_context& context, const boost::system::error_code& ec) {
+          if (ec)
+          {
+            finish(i, false);
+            return;
+          }
+          connections[i] = context.m_connection_id;
+          send_echo(i, 0);
+        });
+        if (!r)
+          finish(i, false);
+      }
+    });
+
+    EXPECT_TRUE(busy_wait_for(2 * ECHO_TIMEOUT, [&](){ return connection_count <= finished_connections.load(std::memory_order_relaxed); }, 1));
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    ASSERT_EQ(connection_count, finished_connections.load());
+    // It's OK, if some connections were dropped, because an overloaded machine can leave them idle past the
+    // server's timeout; they are reported, and only the completed requests count
+    ASSERT_LT(error_count.load(), connection_count);
+
+    latencies.erase(std::remove(latencies.begin(), latencies.end(), 0), latencies.end());
+    std::sort(latencies.begin(), latencies.end());
+    auto percentile = [&](double p) { return latencies[std::min<size_t>(latencies.size() - 1, latencies.size() * p)]; };
+    LOG_PRINT_L0(connection_count << " connections (" << error_count.load() << " dropped): " << latencies.size() << " echo requests in " <<
+      seconds << " s, " << uint64_t(latencies.size() / seconds) << " requests/s, latency p50 / p99 / p99.9 / max: " <<
+      percentile(0.5) << " / " << percentile(0.99) << " / " << percentile(0.999) << " / " << latencies.back() << " us");
+
+    // Close connections
+    for (const auto& conn_id : connections)
+      if (!conn_id.is_nil())
+        m_tcp_server.get_config_object().close(conn_id);
+
+    // Wait for all opened connections to close
+    EXPECT_TRUE(busy_wait_for(DEFAULT_OPERATION_TIMEOUT, [&](){ return m_commands_handler.new_connection_counter() <= m_commands_handler.close_connection_counter() + RESERVED_CONN_CNT; }));
+    ASSERT_EQ(RESERVED_CONN_CNT, m_tcp_server.get_config_object().get_connections_count());
+  }
+}
+
 int main(int argc, char** argv)
 {
   TRY_ENTRY();
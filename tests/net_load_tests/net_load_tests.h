@@ -35,6 +35,7 @@
 #include <boost/asio/io_service.hpp>
 #include <boost/uuid/uuid_io.hpp>
 
+#include "buffer_pool.h"
 #include "include_base_utils.h"
 #include "string_tools.h"
 #include "net/levin_protocol_handler_async.h"
@@ -226,7 +227,8 @@ namespace net_load_tests
     cmd_reset_statistics_id,
     cmd_shutdown_id,
     cmd_send_data_requests_id,
-    cmd_data_request_id
+    cmd_data_request_id,
+    cmd_echo_id
   };
 
   struct CMD_CLOSE_ALL_CONNECTIONS
@@ -277,19 +279,29 @@ namespace net_load_tests
       uint64_t opened_connections_count;
       uint64_t new_connection_counter;
       uint64_t close_connection_counter;
+      // message buffers since the last reset, see epee::buffer_pool
+      uint64_t buffer_system_allocations;
+      uint64_t buffer_reuses;
+      uint64_t statistics_ms;
 
       BEGIN_KV_SERIALIZE_MAP()
         KV_SERIALIZE(opened_connections_count)
         KV_SERIALIZE(new_connection_counter)
         KV_SERIALIZE(close_connection_counter)
+        KV_SERIALIZE(buffer_system_allocations)
+        KV_SERIALIZE(buffer_reuses)
+        KV_SERIALIZE(statistics_ms)
       END_KV_SERIALIZE_MAP()
 
       std::string to_string() const
       {
+        const double seconds = std::max<uint64_t>(statistics_ms, 1) / 1000.0;
         std::stringstream ss;
         ss << "opened_connections_count = " << opened_connections_count <<
           ", new_connection_counter = " << new_connection_counter <<
-          ", close_connection_counter = " << close_connection_counter;
+          ", close_connection_counter = " << close_connection_counter <<
+          ", buffer system allocations/s = " << buffer_system_allocations / seconds <<
+          ", buffer reuses/s = " << buffer_reuses / seconds;
         return ss.str();
       }
     };
@@ -360,4 +372,27 @@ namespace net_load_tests
       END_KV_SERIALIZE_MAP()
     };
   };
+
+  struct CMD_ECHO
+  {
+    const static int ID = cmd_echo_id;
+
+    struct request
+    {
+      std::string data;
+
+      BEGIN_KV_SERIALIZE_MAP()
+        KV_SERIALIZE(data)
+      END_KV_SERIALIZE_MAP()
+    };
+
+    struct response
+    {
+      std::string data;
+
+      BEGIN_KV_SERIALIZE_MAP()
+        KV_SERIALIZE(data)
+      END_KV_SERIALIZE_MAP()
+    };
+  };
 }
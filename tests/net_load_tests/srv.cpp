@@ -28,6 +28,8 @@
 // 
 // Parts of this file are originally copyright (c) 2012-2013 The Cryptonote developers
 
+#include <chrono>
+
 #include <boost/thread/mutex.hpp>
 #include <boost/thread/thread.hpp>
 
@@ -49,6 +51,8 @@ namespace
     srv_levin_commands_handler(test_tcp_server& tcp_server)
       : m_tcp_server(tcp_server)
       , m_open_close_test_conn_id(boost::uuids::nil_uuid())
+      , m_buffer_stats_at_reset(epee::buffer_pool::get_stats())
+      , m_statistics_reset_time(std::chrono::steady_clock::now())
     {
     }
 
@@ -89,6 +93,7 @@ namespace
       HANDLE_INVOKE_T2(CMD_GET_STATISTICS, &srv_levin_commands_handler::handle_get_statistics)
       HANDLE_INVOKE_T2(CMD_RESET_STATISTICS, &srv_levin_commands_handler::handle_reset_statistics)
       HANDLE_INVOKE_T2(CMD_START_OPEN_CLOSE_TEST, &srv_levin_commands_handler::handle_start_open_close_test)
+      HANDLE_INVOKE_T2(CMD_ECHO, &srv_levin_commands_handler::handle_echo)
     END_INVOKE_MAP2()
 
     int handle_close_all_connections(int command, const CMD_CLOSE_ALL_CONNECTIONS::request& req, test_connection_context& context)
@@ -102,6 +107,13 @@ namespace
       rsp.opened_connections_count = m_tcp_server.get_config_object().get_connections_count();
       rsp.new_connection_counter = new_connection_counter();
       rsp.close_connection_counter = close_connection_counter();
+      {
+        const epee::buffer_pool::stats buffer_stats = epee::buffer_pool::get_stats();
+        boost::unique_lock<boost::mutex> lock(m_statistics_mutex);
+        rsp.buffer_system_allocations = buffer_stats.system_allocations - m_buffer_stats_at_reset.system_allocations;
+        rsp.buffer_reuses = buffer_stats.reused - m_buffer_stats_at_reset.reused;
+        rsp.statistics_ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - m_statistics_reset_time).count();
+      }
       LOG_PRINT_L0("Statistics: " << rsp.to_string());
       return 1;
     }
@@ -111,6 +123,9 @@ namespace
       m_new_connection_counter.reset();
       m_new_connection_counter.inc();
       m_close_connection_counter.reset();
+      boost::unique_lock<boost::mutex> lock(m_statistics_mutex);
+      m_buffer_stats_at_reset = epee::buffer_pool::get_stats();
+      m_statistics_reset_time = std::chrono::steady_clock::now();
       return 1;
     }
 
@@ -131,6 +146,12 @@ namespace
       }
     }
 
+    int handle_echo(int command, const CMD_ECHO::request& req, CMD_ECHO::response& rsp, test_connection_context& /*context*/)
+    {
+      rsp.data = req.data;
+      return 1;
+    }
+
     int handle_shutdown(int command, const CMD_SHUTDOWN::request& req, test_connection_context& /*context*/)
     {
       LOG_PRINT_L0("Got shutdown request. Shutting down...");
@@ -211,6 +232,10 @@ namespace
     boost::uuids::uuid m_open_close_test_conn_id;
     boost::mutex m_open_close_test_mutex;
     std::unique_ptr<open_close_test_helper> m_open_close_test_helper;
+
+    boost::mutex m_statistics_mutex;
+    epee::buffer_pool::stats m_buffer_stats_at_reset;
+    std::chrono::steady_clock::time_point m_statistics_reset_time;
   };
 }
 
@@ -227,6 +252,11 @@ int main(int argc, char** argv)
   if (!tcp_server.init_server(srv_port, "127.0.0.1"))
     return 1;
 
+  // compare the shared io_service with one io_service per thread, e.g. in the echo load test
+  const bool io_service_per_thread = 1 < argc && std::string(argv[1]) == "--io-service-per-thread";
+  LOG_PRINT_L0("Running " << thread_count << " threads" << (io_service_per_thread ? ", one io_service each" : " on one io_service"));
+  tcp_server.set_io_service_per_thread(io_service_per_thread);
+
   srv_levin_commands_handler *commands_handler = new srv_levin_commands_handler(tcp_server);
   tcp_server.get_config_object().set_handler(commands_handler, [](epee::levin::levin_commands_handler<test_connection_context> *handler) { delete handler; });
   tcp_server.get_config_object().m_invoke_timeout = 10000;
@@ -0,0 +1,193 @@
+// Copyright (c) 2021, The Monero Project
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this list of
+//    conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list
+//    of conditions and the following disclaimer in the documentation and/or other
+//    materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its contributors may be
+//    used to endorse or promote products derived from this software without specific
+//    prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+// THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "alloc_tracker.h"
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#define PERF_ALLOC_TRACKER_ENABLED 1
+#endif
+
+namespace
+{
+  std::atomic<bool> s_tracking{false};
+  std::atomic<uint64_t> s_allocations{0};
+  std::atomic<uint64_t> s_bytes{0};
+  std::atomic<int64_t> s_live_bytes{0};
+  std::atomic<int64_t> s_peak_live_bytes{0};
+
+#if defined(PERF_ALLOC_TRACKER_ENABLED)
+  void record_alloc(void *ptr)
+  {
+    const int64_t size{static_cast<int64_t>(malloc_usable_size(ptr))};
+    s_allocations.fetch_add(1, std::memory_order_relaxed);
+    s_bytes.fetch_add(size, std::memory_order_relaxed);
+
+    const int64_t live{s_live_bytes.fetch_add(size, std::memory_order_relaxed) + size};
+    int64_t peak{s_peak_live_bytes.load(std::memory_order_relaxed)};
+    while (live > peak && !s_peak_live_bytes.compare_exchange_weak(peak, live, std::memory_order_relaxed))
+    {}
+  }
+
+  void record_free(void *ptr)
+  {
+    s_live_bytes.fetch_sub(static_cast<int64_t>(malloc_usable_size(ptr)), std::memory_order_relaxed);
+  }
+
+  void* tracked_alloc(std::size_t size)
+  {
+    void *ptr{malloc(size > 0 ? size : 1)};
+    if (ptr && s_tracking.load(std::memory_order_relaxed))
+      record_alloc(ptr);
+    return ptr;
+  }
+
+  void tracked_free(void *ptr)
+  {
+    if (!ptr)
+      return;
+    if (s_tracking.load(std::memory_order_relaxed))
+      record_free(ptr);
+    free(ptr);
+  }
+#endif
+} //anonymous namespace
+
+bool AllocationTracker::available()
+{
+#if defined(PERF_ALLOC_TRACKER_ENABLED)
+  return true;
+#else
+  return false;
+#endif
+}
+
+void AllocationTracker::start()
+{
+  s_allocations = 0;
+  s_bytes = 0;
+  s_live_bytes = 0;
+  s_peak_live_bytes = 0;
+  s_tracking = true;
+}
+
+void AllocationTracker::stop()
+{
+  s_tracking = false;
+}
+
+int64_t AllocationTracker::reset_peak()
+{
+  const int64_t live{s_live_bytes.load()};
+  s_peak_live_bytes = live;
+  return live;
+}
+
+uint64_t AllocationTracker::peak_since(const int64_t baseline)
+{
+  const int64_t peak{s_peak_live_bytes.load()};
+  return peak > baseline ? static_cast<uint64_t>(peak - baseline) : 0;
+}
+
+int64_t AllocationTracker::live_bytes()
+{
+  return s_live_bytes.load();
+}
+
+AllocationCounts AllocationTracker::read()
+{
+  AllocationCounts counts;
+  counts.valid = available();
+  counts.allocations = s_allocations.load();
+  counts.bytes = s_bytes.load();
+  return counts;
+}
+
+#if defined(PERF_ALLOC_TRACKER_ENABLED)
+// replacement global allocation functions (the aligned C++17 overloads are left to the default implementation)
+void* operator new(std::size_t size)
+{
+  void *ptr{tracked_alloc(size)};
+  if (!ptr)
+    throw std::bad_alloc();
+  return ptr;
+}
+
+void* operator new[](std::size_t size)
+{
+  void *ptr{tracked_alloc(size)};
+  if (!ptr)
+    throw std::bad_alloc();
+  return ptr;
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+  return tracked_alloc(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+  return tracked_alloc(size);
+}
+
+void operator delete(void *ptr) noexcept
+{
+  tracked_free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept
+{
+  tracked_free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept
+{
+  tracked_free(ptr);
+}
+
+void operator delete[](void *ptr, std::size_t) noexcept
+{
+  tracked_free(ptr);
+}
+
+void operator delete(void *ptr, const std::nothrow_t&) noexcept
+{
+  tracked_free(ptr);
+}
+
+void operator delete[](void *ptr, const std::nothrow_t&) noexcept
+{
+  tracked_free(ptr);
+}
+#endif
@@ -0,0 +1,81 @@
+// Copyright (c) 2021, The Monero Project
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this list of
+//    conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list
+//    of conditions and the following disclaimer in the documentation and/or other
+//    materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its contributors may be
+//    used to endorse or promote products derived from this software without specific
+//    prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+// THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+/**
+ * Allocation totals for a measured section
+ * - counts every global operator new/delete on every thread (including threadpool workers) while tracking is on
+ * - byte counts are usable sizes reported by the allocator, which may be slightly larger than requested sizes
+ * - peak_live_bytes is the largest increase of live heap bytes (allocated minus freed) over the section's baseline
+ */
+struct AllocationCounts final
+{
+  bool valid{false};
+  uint64_t allocations{0};
+  uint64_t bytes{0};
+  uint64_t peak_live_bytes{0};
+
+  /// one-line summary of per-call averages
+  std::string per_call_report(const size_t num_calls) const
+  {
+    if (!valid || num_calls == 0)
+      return "allocation tracking unavailable";
+
+    return std::string{"allocations/call "} + std::to_string(allocations / num_calls) +
+      ", bytes allocated/call " + std::to_string(bytes / num_calls) +
+      ", peak live bytes " + std::to_string(peak_live_bytes);
+  }
+};
+
+/**
+ * Process-wide allocation tracker, fed by the replacement global operator new/delete in alloc_tracker.cpp
+ * - tracking is off by default; when off, the replacement operators only pay for one relaxed atomic load
+ * - only available with glibc (needs malloc_usable_size() to account frees without a size header)
+ */
+class AllocationTracker final
+{
+public:
+  static bool available();
+
+  /// turn tracking on and zero the counters (the current live bytes become the baseline)
+  static void start();
+  /// turn tracking off
+  static void stop();
+  /// start a new peak window from the current live bytes; returns the window's baseline
+  static int64_t reset_peak();
+  /// peak live bytes of the current window above 'baseline'
+  static uint64_t peak_since(const int64_t baseline);
+  /// live heap bytes (allocated minus freed) since start()
+  static int64_t live_bytes();
+  /// allocations and bytes since start(); peak_live_bytes is left for the caller to fill in
+  static AllocationCounts read();
+};
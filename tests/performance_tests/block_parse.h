@@ -0,0 +1,127 @@
+// Copyright (c) 2021, The Monero Project
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of
+//    conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list
+//    of conditions and the following disclaimer in the documentation and/or other
+//    materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be
+//    used to endorse or promote products derived from this software without specific
+//    prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+// THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#pragma once
+
+#include <iostream>
+#include <unordered_map>
+#include <vector>
+
+#include "cryptonote_basic/account.h"
+#include "cryptonote_basic/cryptonote_basic.h"
+#include "cryptonote_basic/cryptonote_format_utils.h"
+#include "cryptonote_core/cryptonote_tx_utils.h"
+#include "misc_os_dependent.h"
+
+#include "multi_tx_test_base.h"
+
+// parse throughput of a block and its txes, as done for every block synced
+// - txes are 2-out CLSAG txes with the given ring size, so the binary archive
+//   spends most of its time in bulletproof L/R vectors and CLSAG s arrays
+// - reports blob MB/s parsed per core
+template<size_t a_num_txes, size_t a_ring_size>
+class test_block_parse : private multi_tx_test_base<a_ring_size>
+{
+public:
+  static const size_t loop_count = 20;
+  static const size_t num_txes = a_num_txes;
+
+  typedef multi_tx_test_base<a_ring_size> base_class;
+
+  ~test_block_parse()
+  {
+    if (m_elapsed_ns == 0)
+      return;
+    std::cout << "  ring size " << a_ring_size << ", " << num_txes << " txes, bytes: " << m_blob_size
+      << ", MB/s: " << static_cast<double>(m_blob_size) * m_num_calls * 1e3 / m_elapsed_ns << '\n';
+  }
+
+  bool init()
+  {
+    using namespace cryptonote;
+
+    if (!base_class::init())
+      return false;
+
+    m_alice.generate();
+
+    std::vector<tx_destination_entry> destinations;
+    destinations.push_back(tx_destination_entry(this->m_source_amount - 1, m_alice.get_keys().m_account_address, false));
+    destinations.push_back(tx_destination_entry(1, m_alice.get_keys().m_account_address, false));
+
+    crypto::secret_key tx_key;
+    std::vector<crypto::secret_key> additional_tx_keys;
+    std::unordered_map<crypto::public_key, cryptonote::subaddress_index> subaddresses;
+    subaddresses[this->m_miners[this->real_source_idx].get_keys().m_account_address.m_spend_public_key] = {0,0};
+    rct::RCTConfig rct_config{rct::RangeProofPaddedBulletproof, 3};
+    transaction tx;
+    if (!construct_tx_and_get_tx_key(this->m_miners[this->real_source_idx].get_keys(), subaddresses, this->m_sources, destinations, cryptonote::account_public_address{}, std::vector<uint8_t>(), tx, 0, tx_key, additional_tx_keys, true, rct_config))
+      return false;
+
+    // parsing does not look at the tx hashes, so the same tx can stand in for all of them
+    block b;
+    b.major_version = 14;
+    b.minor_version = 14;
+    b.miner_tx = this->m_miner_txs[0];
+    b.tx_hashes.assign(num_txes, get_transaction_hash(tx));
+    m_block_blob = block_to_blob(b);
+    m_blob_size = m_block_blob.size();
+    m_tx_blobs.assign(num_txes, tx_to_blob(tx));
+    for (const blobdata &blob: m_tx_blobs)
+      m_blob_size += blob.size();
+    return true;
+  }
+
+  bool test()
+  {
+    cryptonote::block b;
+    std::vector<cryptonote::transaction> txes(num_txes);
+
+    const uint64_t start = epee::misc_utils::get_ns_count();
+    if (!cryptonote::parse_and_validate_block_from_blob(m_block_blob, b))
+      return false;
+    for (size_t n = 0; n < num_txes; ++n)
+    {
+      if (!cryptonote::parse_and_validate_tx_from_blob(m_tx_blobs[n], txes[n]))
+        return false;
+    }
+    m_elapsed_ns += epee::misc_utils::get_ns_count() - start;
+    ++m_num_calls;
+    return b.tx_hashes.size() == num_txes;
+  }
+
+private:
+  cryptonote::account_base m_alice;
+  cryptonote::blobdata m_block_blob;
+  std::vector<cryptonote::blobdata> m_tx_blobs;
+  size_t m_blob_size{0};
+  uint64_t m_elapsed_ns{0};
+  uint64_t m_num_calls{0};
+};
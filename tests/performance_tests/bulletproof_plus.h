@@ -32,6 +32,7 @@
 
 #include "ringct/rctSigs.h"
 #include "ringct/bulletproofs_plus.h"
+#include "ringct/multiexp.h"
 
 #include <utility>
 
@@ -64,6 +65,35 @@ private:
   rct::BulletproofPlus proof;
 };
 
+// batch verification with random weights of 'small_weighting_size' bytes combining the proofs
+template<size_t n_proofs, size_t n_amounts, size_t small_weighting_size>
+class test_bulletproof_plus_weighting
+{
+public:
+  static const size_t loop_count = 50;
+
+  bool init()
+  {
+    for (size_t i = 0; i < n_proofs; ++i)
+      proofs.push_back(rct::bulletproof_plus_PROVE(std::vector<uint64_t>(n_amounts, 749327532984), rct::skvGen(n_amounts)));
+    for (const rct::BulletproofPlus &proof: proofs)
+      proof_ptrs.push_back(&proof);
+    return true;
+  }
+
+  bool test()
+  {
+    rct::pippenger_prep_data prep_data;
+    if (!rct::try_get_bulletproof_plus_verification_data(proof_ptrs, prep_data, small_weighting_size))
+      return false;
+    return rct::multiexp_auto(prep_data.data) == rct::identity();
+  }
+
+private:
+  std::vector<rct::BulletproofPlus> proofs;
+  std::vector<const rct::BulletproofPlus*> proof_ptrs;
+};
+
 struct ParamsShuttleBPPAgg final : public ParamsShuttle
 {
   ParamsShuttleBPPAgg() = default;
@@ -0,0 +1,119 @@
+// Copyright (c) 2021, The Monero Project
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this list of
+//    conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list
+//    of conditions and the following disclaimer in the documentation and/or other
+//    materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its contributors may be
+//    used to endorse or promote products derived from this software without specific
+//    prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+// THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#if defined(__linux__)
+#include <unistd.h>
+#endif
+
+/**
+ * Cold-cache mode: evicts the cpu caches between test calls, so each call starts like a verification in a node would
+ * (ref set enotes scattered over a large ledger, generator tables and tx data long gone from L2/L3)
+ * - evicts by streaming over a scratch buffer twice the size of the last level cache (a write per cache line,
+ *   so dirty lines are written back and every way of every set is replaced); the fixtures (mock ledgers, generator
+ *   caches, txs) live in many separate allocations the runner can't enumerate, so flushing them line by line isn't
+ *   an option
+ * - hot: the default (caches stay warm across calls); cold: evict before each call; both: run each test hot, then
+ *   cold, and report the slowdown
+ */
+enum class ColdCacheMode
+{
+  HOT,
+  COLD,
+  BOTH
+};
+
+class CacheEvictor final
+{
+public:
+  /// scratch_bytes: size of the scratch buffer (0 = 2x the last level cache, at least 32 MiB)
+  explicit CacheEvictor(const size_t scratch_bytes)
+    : m_scratch(scratch_bytes > 0 ? scratch_bytes : default_scratch_bytes(), 1)
+  {}
+
+  /// stream over the scratch buffer; afterwards, no data from before the call is left in the caches
+  void evict()
+  {
+    unsigned char sum{0};
+    for (size_t i = 0; i < m_scratch.size(); i += CACHE_LINE_BYTES)
+    {
+      m_scratch[i] += 1;
+      sum += m_scratch[i];
+    }
+
+    // keep the loop from being optimized away
+    m_sink = m_sink + sum;
+  }
+
+  size_t scratch_bytes() const { return m_scratch.size(); }
+
+  /// last level cache size (0 if unknown)
+  static size_t last_level_cache_bytes()
+  {
+#if defined(__linux__) && defined(_SC_LEVEL3_CACHE_SIZE)
+    for (const int level : {_SC_LEVEL4_CACHE_SIZE, _SC_LEVEL3_CACHE_SIZE, _SC_LEVEL2_CACHE_SIZE})
+    {
+      const long bytes = sysconf(level);
+      if (bytes > 0)
+        return static_cast<size_t>(bytes);
+    }
+#endif
+    return 0;
+  }
+
+private:
+  static constexpr size_t CACHE_LINE_BYTES{64};
+
+  static size_t default_scratch_bytes()
+  {
+    return std::max(2 * last_level_cache_bytes(), size_t{32} << 20);
+  }
+
+  std::vector<unsigned char> m_scratch;
+  volatile unsigned char m_sink{0};
+};
+
+inline bool parse_cold_cache_mode(const std::string &mode, ColdCacheMode &mode_out)
+{
+  if (mode == "off" || mode == "hot")
+    mode_out = ColdCacheMode::HOT;
+  else if (mode == "on" || mode == "cold")
+    mode_out = ColdCacheMode::COLD;
+  else if (mode == "both")
+    mode_out = ColdCacheMode::BOTH;
+  else
+    return false;
+  return true;
+}
@@ -35,6 +35,7 @@
 #include "cryptonote_basic/account.h"
 #include "cryptonote_basic/cryptonote_basic.h"
 #include "cryptonote_core/cryptonote_tx_utils.h"
+#include "cryptonote_core/ring_signature_batch.h"
 #include "crypto/crypto.h"
 #include "ringct/rctSigs.h"
 
@@ -172,3 +173,206 @@ private:
   cryptonote::account_base m_alice;
   std::vector<cryptonote::transaction> m_txes;
 };
+
+// a relay batch of txes with a few bad range proofs: find the bad ones by bisecting the failed batch,
+// or (the old fallback) by verifying every tx on its own
+template<size_t a_num_txes, size_t a_num_bad, bool a_bisect>
+class test_check_tx_signature_batch_failures : private multi_tx_test_base<2>
+{
+  static_assert(a_num_bad <= a_num_txes, "more bad txes than txes");
+
+public:
+  static const size_t loop_count = 10;
+
+  typedef multi_tx_test_base<2> base_class;
+
+  bool init()
+  {
+    using namespace cryptonote;
+
+    if (!base_class::init())
+      return false;
+
+    m_alice.generate();
+
+    std::vector<tx_destination_entry> destinations;
+    destinations.push_back(tx_destination_entry(this->m_source_amount - 1, m_alice.get_keys().m_account_address, false));
+    destinations.push_back(tx_destination_entry(1, m_alice.get_keys().m_account_address, false));
+
+    crypto::secret_key tx_key;
+    std::vector<crypto::secret_key> additional_tx_keys;
+    std::unordered_map<crypto::public_key, cryptonote::subaddress_index> subaddresses;
+    subaddresses[this->m_miners[this->real_source_idx].get_keys().m_account_address.m_spend_public_key] = {0,0};
+
+    m_txes.resize(a_num_txes);
+    for (size_t n = 0; n < a_num_txes; ++n)
+    {
+      if (!construct_tx_and_get_tx_key(this->m_miners[this->real_source_idx].get_keys(), subaddresses, this->m_sources, destinations, cryptonote::account_public_address{}, std::vector<uint8_t>(), m_txes[n], 0, tx_key, additional_tx_keys, true, {rct::RangeProofPaddedBulletproof, 2}))
+        return false;
+    }
+
+    // spread the bad txes over the batch
+    for (size_t n = 0; n < a_num_bad; ++n)
+    {
+      const size_t bad = n * a_num_txes / a_num_bad;
+      m_txes[bad].rct_signatures.p.bulletproofs[0].taux = rct::skGen();
+      m_bad.push_back(bad);
+    }
+
+    for (const cryptonote::transaction &tx: m_txes)
+      m_rvv.push_back(&tx.rct_signatures);
+
+    return true;
+  }
+
+  bool test()
+  {
+    if (rct::verRctSemanticsSimple(m_rvv))
+      return m_bad.empty();
+
+    std::vector<size_t> failures;
+    if (a_bisect)
+      failures = rct::findRctSemanticsSimpleFailures(m_rvv, true);
+    else
+    {
+      for (size_t n = 0; n < m_rvv.size(); ++n)
+      {
+        if (!rct::verRctSemanticsSimple(*m_rvv[n]))
+          failures.push_back(n);
+      }
+    }
+    return failures == m_bad;
+  }
+
+private:
+  cryptonote::account_base m_alice;
+  std::vector<cryptonote::transaction> m_txes;
+  std::vector<const rct::rctSig*> m_rvv;
+  std::vector<size_t> m_bad;
+};
+
+template<size_t a_ring_size, size_t a_num_txes, bool a_batched>
+class test_check_tx_ring_signatures_block : private multi_tx_test_base<a_ring_size>
+{
+  static_assert(0 < a_ring_size, "ring_size must be greater than 0");
+
+public:
+  static const size_t loop_count = 10;
+
+  typedef multi_tx_test_base<a_ring_size> base_class;
+
+  bool init()
+  {
+    using namespace cryptonote;
+
+    if (!base_class::init())
+      return false;
+
+    m_alice.generate();
+
+    std::vector<tx_destination_entry> destinations;
+    destinations.push_back(tx_destination_entry(this->m_source_amount - 1, m_alice.get_keys().m_account_address, false));
+    destinations.push_back(tx_destination_entry(1, m_alice.get_keys().m_account_address, false));
+
+    crypto::secret_key tx_key;
+    std::vector<crypto::secret_key> additional_tx_keys;
+    std::unordered_map<crypto::public_key, cryptonote::subaddress_index> subaddresses;
+    subaddresses[this->m_miners[this->real_source_idx].get_keys().m_account_address.m_spend_public_key] = {0,0};
+
+    m_txes.resize(a_num_txes);
+    for (size_t n = 0; n < a_num_txes; ++n)
+    {
+      if (!construct_tx_and_get_tx_key(this->m_miners[this->real_source_idx].get_keys(), subaddresses, this->m_sources, destinations, cryptonote::account_public_address{}, std::vector<uint8_t>(), m_txes[n], 0, tx_key, additional_tx_keys, true, {rct::RangeProofPaddedBulletproof, 3}))
+        return false;
+      if (m_txes[n].rct_signatures.type != rct::RCTTypeCLSAG)
+        return false;
+    }
+
+    return true;
+  }
+
+  bool test()
+  {
+    if (!a_batched)
+    {
+      // what check_tx_inputs() does per tx when verifying without a batch
+      for (const cryptonote::transaction &tx: m_txes)
+      {
+        if (!rct::verRctNonSemanticsSimple(tx.rct_signatures))
+          return false;
+      }
+      return true;
+    }
+
+    cryptonote::ring_signature_batch batch;
+    for (const cryptonote::transaction &tx: m_txes)
+    {
+      if (!batch.rct().add(cryptonote::get_transaction_hash(tx), tx.rct_signatures))
+        return false;
+    }
+    std::vector<crypto::hash> failed_txs;
+    return batch.verify(failed_txs);
+  }
+
+private:
+  cryptonote::account_base m_alice;
+  std::vector<cryptonote::transaction> m_txes;
+};
+
+// pre-RingCT ring signatures of a block's worth of inputs, one check_ring_signature() call per ring or one batched call
+template<size_t a_ring_size, size_t a_num_rings, bool a_batched>
+class test_check_ring_signatures
+{
+public:
+  static const size_t loop_count = a_ring_size < 10 ? 20 : 5;
+
+  bool init()
+  {
+    m_pubs.resize(a_num_rings, std::vector<crypto::public_key>(a_ring_size));
+    m_pub_ptrs.resize(a_num_rings);
+    m_sigs.resize(a_num_rings, std::vector<crypto::signature>(a_ring_size));
+    m_images.resize(a_num_rings);
+    m_prefix_hashes.resize(a_num_rings);
+    for (size_t n = 0; n < a_num_rings; ++n)
+    {
+      crypto::secret_key real_sec;
+      for (size_t i = 0; i < a_ring_size; ++i)
+      {
+        crypto::secret_key sec;
+        crypto::generate_keys(m_pubs[n][i], sec);
+        if (i == n % a_ring_size)
+          real_sec = sec;
+        m_pub_ptrs[n].push_back(&m_pubs[n][i]);
+      }
+      const size_t real_index = n % a_ring_size;
+      crypto::generate_key_image(m_pubs[n][real_index], real_sec, m_images[n]);
+      m_prefix_hashes[n] = crypto::rand<crypto::hash>();
+      crypto::generate_ring_signature(m_prefix_hashes[n], m_images[n], m_pub_ptrs[n], real_sec, real_index, m_sigs[n].data());
+      m_checks.push_back({&m_prefix_hashes[n], &m_images[n], m_pub_ptrs[n].data(), a_ring_size, m_sigs[n].data()});
+    }
+    return true;
+  }
+
+  bool test()
+  {
+    if (a_batched)
+    {
+      bool valid[a_num_rings];
+      return crypto::check_ring_signatures(m_checks.data(), m_checks.size(), valid);
+    }
+    for (size_t n = 0; n < a_num_rings; ++n)
+    {
+      if (!crypto::check_ring_signature(m_prefix_hashes[n], m_images[n], m_pub_ptrs[n], m_sigs[n].data()))
+        return false;
+    }
+    return true;
+  }
+
+private:
+  std::vector<std::vector<crypto::public_key>> m_pubs;
+  std::vector<std::vector<const crypto::public_key*>> m_pub_ptrs;
+  std::vector<std::vector<crypto::signature>> m_sigs;
+  std::vector<crypto::key_image> m_images;
+  std::vector<crypto::hash> m_prefix_hashes;
+  std::vector<crypto::ring_signature_check> m_checks;
+};
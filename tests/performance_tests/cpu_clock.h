@@ -0,0 +1,155 @@
+// Copyright (c) 2021, The Monero Project
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this list of
+//    conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list
+//    of conditions and the following disclaimer in the documentation and/or other
+//    materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its contributors may be
+//    used to endorse or promote products derived from this software without specific
+//    prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+// THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <thread>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "common/perf_timer.h"
+
+/**
+ * Pin a thread to one cpu (linux only)
+ * - returns false if pinning is unsupported, or the cpu is not available to the process
+ */
+inline bool pin_thread_to_cpu(std::thread &thread, const unsigned cpu)
+{
+#if defined(__linux__)
+  cpu_set_t cpuset;
+  CPU_ZERO(&cpuset);
+  CPU_SET(cpu, &cpuset);
+  return pthread_setaffinity_np(thread.native_handle(), sizeof(cpuset), &cpuset) == 0;
+#else
+  return false;
+#endif
+}
+
+/**
+ * Checks that the cpu clock held still over a measured section
+ * - core speed: wall time of a fixed chain of dependent multiplies, which runs at the core clock; if it is slower
+ *   after the section than before, the core clocked down during it (thermal throttling, turbo budget running out,
+ *   or frequency scaling), and if faster, the section started before the clock ramped up
+ * - tick rate: per-call timers convert ticks (the TSC on x86) to ns with a rate calibrated at startup; if the tick
+ *   rate over the section differs from it (e.g. a TSC that isn't invariant), the per-call times are off by as much
+ * - usage: start() before the measured section, stop() after it, then read the changes (relative, e.g. -0.05: 5% lower)
+ */
+class CpuClockCheck final
+{
+public:
+  void start()
+  {
+    m_probe_start_ns = probe_core_speed_ns();
+    m_ticks_start = tools::get_tick_count();
+    m_wall_start = std::chrono::steady_clock::now();
+  }
+
+  void stop()
+  {
+    const uint64_t ticks_stop{tools::get_tick_count()};
+    const auto wall_stop = std::chrono::steady_clock::now();
+    const uint64_t probe_stop_ns{probe_core_speed_ns()};
+
+    const double wall_ns = std::chrono::duration<double, std::nano>(wall_stop - m_wall_start).count();
+    m_valid = m_probe_start_ns > 0 && probe_stop_ns > 0 && wall_ns > 0;
+    if (!m_valid)
+      return;
+
+    // the tick rate is only compared over sections long enough that reading the clocks doesn't skew it
+    m_core_speed_change = static_cast<double>(m_probe_start_ns) / probe_stop_ns - 1.0;
+    m_tick_rate_change = wall_ns >= 50 * 1000 * 1000 ?
+      tools::ticks_to_ns(ticks_stop - m_ticks_start) / wall_ns - 1.0 :
+      0.0;
+  }
+
+  bool valid() const { return m_valid; }
+  double core_speed_change() const { return m_core_speed_change; }
+  double tick_rate_change() const { return m_tick_rate_change; }
+
+  /// true if both the core speed and the tick rate changed by less than 'tolerance'
+  bool stable(const double tolerance = 0.03) const
+  {
+    return !m_valid || (std::fabs(m_core_speed_change) < tolerance && std::fabs(m_tick_rate_change) < tolerance);
+  }
+
+  /// one-line summary
+  std::string report() const
+  {
+    if (!m_valid)
+      return "cpu clock check unavailable";
+
+    std::string report{"cpu clock: core speed " + percent(m_core_speed_change) +
+      ", tick rate " + percent(m_tick_rate_change) + " over the test"};
+    if (!stable())
+      report += " - UNSTABLE (throttling or frequency scaling; timings may be noisy)";
+    return report;
+  }
+
+private:
+  static std::string percent(const double change)
+  {
+    const long tenths{std::lround(change * 1000)};
+    return (tenths < 0 ? "-" : "+") + std::to_string(std::labs(tenths) / 10) + '.' +
+      std::to_string(std::labs(tenths) % 10) + '%';
+  }
+
+  /// wall time of a fixed chain of dependent multiplies (the fastest of a few runs, so preemption doesn't count)
+  static uint64_t probe_core_speed_ns()
+  {
+    uint64_t best_ns{std::numeric_limits<uint64_t>::max()};
+    volatile uint64_t sink{0};
+    for (int run = 0; run < 5; ++run)
+    {
+      const auto start = std::chrono::steady_clock::now();
+      uint64_t x{static_cast<uint64_t>(run) + 1};
+      for (size_t i = 0; i < 1000 * 1000; ++i)
+        x = x * 6364136223846793005ull + 1442695040888963407ull;
+      sink = x;
+      const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+      best_ns = std::min(best_ns, static_cast<uint64_t>(ns.count()));
+    }
+    (void)sink;
+    return best_ns;
+  }
+
+  bool m_valid{false};
+  uint64_t m_probe_start_ns{0};
+  uint64_t m_ticks_start{0};
+  std::chrono::steady_clock::time_point m_wall_start;
+  double m_core_speed_change{0};
+  double m_tick_rate_change{0};
+};
@@ -38,6 +38,10 @@ enum test_op
   op_sc_add,
   op_sc_sub,
   op_sc_mul,
+  op_sc_muladd,
+  op_sc_mul_x4,           // four independent muls per call (AVX2 when available)
+  op_sc_mul_x4_scalar,    // four independent muls per call, without the AVX2 backend
+  op_sc_muladd_x4,
   op_ge_add_raw,
   op_ge_add_p3_p3,
   op_zeroCommitCached,
@@ -88,6 +92,13 @@ public:
     rct::precomp(precomp0, point0);
     rct::precomp(precomp1, point1);
     rct::precomp(precomp2, point2);
+    for (size_t lane = 0; lane < 4; ++lane)
+    {
+      lanes_a[lane] = scalar0.bytes;
+      lanes_b[lane] = scalar1.bytes;
+      lanes_c[lane] = scalar2.bytes;
+      lanes_out[lane] = scalars_out[lane].bytes;
+    }
     return true;
   }
 
@@ -103,6 +114,10 @@ public:
       case op_sc_add: sc_add(key.bytes, scalar0.bytes, scalar1.bytes); break;
       case op_sc_sub: sc_sub(key.bytes, scalar0.bytes, scalar1.bytes); break;
       case op_sc_mul: sc_mul(key.bytes, scalar0.bytes, scalar1.bytes); break;
+      case op_sc_muladd: sc_muladd(key.bytes, scalar0.bytes, scalar1.bytes, scalar2.bytes); break;
+      case op_sc_mul_x4: sc_mul_x4(lanes_out, lanes_a, lanes_b, 1); break;
+      case op_sc_mul_x4_scalar: sc_mul_x4(lanes_out, lanes_a, lanes_b, 0); break;
+      case op_sc_muladd_x4: sc_muladd_x4(lanes_out, lanes_a, lanes_b, lanes_c, 1); break;
       case op_ge_add_p3_p3: {
         ge_p3_to_cached(&tmp_cached, &p3_0);
         ge_add(&tmp_p1p1, &p3_1, &tmp_cached);
@@ -141,4 +156,7 @@ private:
   ge_p3 p3_0, p3_1, p3_2;
   ge_cached cached;
   ge_dsmp precomp0, precomp1, precomp2;
+  rct::key scalars_out[4];
+  const unsigned char *lanes_a[4], *lanes_b[4], *lanes_c[4];
+  unsigned char *lanes_out[4];
 };
@@ -62,3 +62,49 @@ private:
   crypto::key_derivation m_key_derivation;
   crypto::public_key m_spend_public_key;
 };
+
+template<size_t num_keys, bool batched>
+class test_derive_subaddress_public_keys
+{
+public:
+  static const size_t loop_count = 10000 / num_keys + 10;
+
+  bool init()
+  {
+    // stand-ins for the output keys of a refresh batch, each with its own derivation and output index
+    m_out_keys.resize(num_keys);
+    m_derivations.resize(num_keys);
+    m_output_indices.resize(num_keys);
+    for (size_t i = 0; i < num_keys; ++i)
+    {
+      crypto::secret_key seckey;
+      crypto::generate_keys(m_out_keys[i], seckey);
+      crypto::public_key tx_pubkey;
+      crypto::generate_keys(tx_pubkey, seckey);
+      crypto::generate_key_derivation(tx_pubkey, seckey, m_derivations[i]);
+      m_output_indices[i] = i % 16;
+    }
+    m_spendkeys.resize(num_keys);
+    return true;
+  }
+
+  bool test()
+  {
+    if (batched)
+      return crypto::derive_subaddress_public_keys(m_out_keys.data(), m_derivations.data(), m_output_indices.data(), num_keys, m_spendkeys.data(), m_valid);
+
+    for (size_t i = 0; i < num_keys; ++i)
+    {
+      if (!crypto::derive_subaddress_public_key(m_out_keys[i], m_derivations[i], m_output_indices[i], m_spendkeys[i]))
+        return false;
+    }
+    return true;
+  }
+
+private:
+  std::vector<crypto::public_key> m_out_keys;
+  std::vector<crypto::key_derivation> m_derivations;
+  std::vector<size_t> m_output_indices;
+  std::vector<crypto::public_key> m_spendkeys;
+  bool m_valid[num_keys];
+};
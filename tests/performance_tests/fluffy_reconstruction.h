@@ -0,0 +1,210 @@
+// Copyright (c) 2021, The Monero Project
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of
+//    conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list
+//    of conditions and the following disclaimer in the documentation and/or other
+//    materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be
+//    used to endorse or promote products derived from this software without specific
+//    prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+// THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <iostream>
+#include <memory>
+#include <unordered_map>
+
+#include "cryptonote_basic/account.h"
+#include "cryptonote_basic/cryptonote_basic.h"
+#include "cryptonote_basic/cryptonote_format_utils.h"
+#include "cryptonote_core/blockchain.h"
+#include "cryptonote_core/cryptonote_core.h"
+#include "cryptonote_core/cryptonote_tx_utils.h"
+#include "cryptonote_core/tx_pool.h"
+#include "blockchain_db/testdb.h"
+#include "misc_os_dependent.h"
+
+#include "multi_tx_test_base.h"
+
+// an in-memory txpool table, so the pool under test is the real tx_memory_pool
+class fluffy_reconstruction_db: public cryptonote::BaseTestDB
+{
+public:
+  fluffy_reconstruction_db() { m_open = true; }
+
+  virtual void add_block(const cryptonote::block& blk, size_t block_weight, uint64_t long_term_block_weight, const cryptonote::difficulty_type& cumulative_difficulty, const uint64_t& coins_generated, uint64_t num_rct_outs, const crypto::hash& blk_hash) override { ++m_blocks; }
+  virtual uint64_t height() const override { return m_blocks; }
+  virtual crypto::hash get_block_hash_from_height(const uint64_t &height) const override {
+    crypto::hash hash = crypto::null_hash;
+    *(uint64_t*)&hash = height;
+    return hash;
+  }
+  virtual crypto::hash top_block_hash(uint64_t *block_height = NULL) const override {
+    if (block_height)
+      *block_height = m_blocks - 1;
+    return m_blocks ? get_block_hash_from_height(m_blocks - 1) : crypto::null_hash;
+  }
+
+  virtual void add_txpool_tx(const crypto::hash &txid, const cryptonote::blobdata_ref &blob, const cryptonote::txpool_tx_meta_t& details) override {
+    m_txpool[txid] = {details, cryptonote::blobdata(blob.data(), blob.size())};
+  }
+  virtual void update_txpool_tx(const crypto::hash &txid, const cryptonote::txpool_tx_meta_t& details) override { m_txpool.at(txid).meta = details; }
+  virtual bool txpool_has_tx(const crypto::hash &txid, cryptonote::relay_category tx_category) const override {
+    const auto it = m_txpool.find(txid);
+    return it != m_txpool.end() && it->second.meta.matches(tx_category);
+  }
+  virtual void remove_txpool_tx(const crypto::hash& txid) override { m_txpool.erase(txid); }
+  virtual bool get_txpool_tx_meta(const crypto::hash& txid, cryptonote::txpool_tx_meta_t &meta) const override {
+    const auto it = m_txpool.find(txid);
+    if (it == m_txpool.end())
+      return false;
+    meta = it->second.meta;
+    return true;
+  }
+  virtual bool get_txpool_tx_blob(const crypto::hash& txid, cryptonote::blobdata &bd, cryptonote::relay_category tx_category) const override {
+    const auto it = m_txpool.find(txid);
+    if (it == m_txpool.end() || !it->second.meta.matches(tx_category))
+      return false;
+    bd = it->second.blob;
+    return true;
+  }
+
+private:
+  struct txpool_entry
+  {
+    cryptonote::txpool_tx_meta_t meta;
+    cryptonote::blobdata blob;
+  };
+
+  uint64_t m_blocks = 0;
+  std::unordered_map<crypto::hash, txpool_entry> m_txpool;
+};
+
+// latency of getting the pool txes of a fluffy block from tx_memory_pool, as both
+// the block reconstruction and the following take_tx calls do
+// - blobs: get_transaction() (pool and db locks, blob lookup), then a parse of each blob
+// - indexed: get_parsed_transaction() (shared lock and a lookup in the parsed tx index, no parse)
+// - the pool runs at hard fork 1, so the txes are v1 (a ring of 2, 2 outputs); rct txes take longer to parse
+// - reports ns per tx
+template<size_t a_num_txes, bool a_indexed>
+class test_fluffy_reconstruction : private multi_tx_test_base<2>
+{
+public:
+  static const size_t loop_count = 50;
+  static const size_t num_txes = a_num_txes;
+  static const bool indexed = a_indexed;
+
+  typedef multi_tx_test_base<2> base_class;
+
+  test_fluffy_reconstruction(): m_pool(m_blockchain), m_blockchain(m_pool) {}
+
+  ~test_fluffy_reconstruction()
+  {
+    if (m_num_txes == 0)
+      return;
+    std::cout << "  " << (indexed ? "indexed" : "blobs") << ", " << num_txes << " txes, ns/tx: " << static_cast<double>(m_elapsed_ns) / m_num_txes << '\n';
+  }
+
+  bool init()
+  {
+    using namespace cryptonote;
+
+    if (!base_class::init())
+      return false;
+
+    const std::pair<uint8_t, uint64_t> hard_forks[2] = {std::make_pair(1, 0), std::make_pair(0, 0)};
+    const test_options options = {hard_forks, 0};
+    if (!m_blockchain.init(new fluffy_reconstruction_db(), FAKECHAIN, true, &options, 0, NULL))
+      return false;
+
+    m_alice.generate();
+
+    std::vector<tx_destination_entry> destinations;
+    destinations.push_back(tx_destination_entry(this->m_source_amount - 1000000, m_alice.get_keys().m_account_address, false));
+    destinations.push_back(tx_destination_entry(1, m_alice.get_keys().m_account_address, false));
+
+    crypto::secret_key tx_key;
+    std::vector<crypto::secret_key> additional_tx_keys;
+    std::unordered_map<crypto::public_key, cryptonote::subaddress_index> subaddresses;
+    subaddresses[this->m_miners[this->real_source_idx].get_keys().m_account_address.m_spend_public_key] = {0,0};
+    transaction tx;
+    if (!construct_tx_and_get_tx_key(this->m_miners[this->real_source_idx].get_keys(), subaddresses, this->m_sources, destinations, cryptonote::account_public_address{}, std::vector<uint8_t>(), tx, 0, tx_key, additional_tx_keys, false))
+      return false;
+
+    // the same tx under distinct ids is as costly to look up and parse as distinct txes; as if kept by a
+    // popped block, the pool takes them without checking their inputs against the chain
+    const blobdata blob = tx_to_blob(tx);
+    for (size_t n = 0; n < num_txes; ++n)
+    {
+      crypto::hash id = get_transaction_hash(tx);
+      for (size_t b = 0; b < sizeof(n); ++b)
+        id.data[b] ^= static_cast<char>(n >> (8 * b));
+      m_ids.push_back(id);
+
+      transaction pool_tx = tx;
+      tx_verification_context tvc{};
+      if (!m_pool.add_tx(pool_tx, id, blob, blob.size(), tvc, relay_method::block, true, 1) || !m_pool.get_parsed_transaction(id, relay_category::all))
+        return false;
+    }
+    return true;
+  }
+
+  bool test()
+  {
+    std::vector<cryptonote::blobdata> have_tx;
+    std::vector<cryptonote::transaction> taken;
+    have_tx.reserve(num_txes);
+    taken.reserve(num_txes);
+
+    const uint64_t start = epee::misc_utils::get_ns_count();
+    for (const crypto::hash &id: m_ids)
+    {
+      if (indexed)
+      {
+        const std::shared_ptr<const cryptonote::txpool_parsed_tx> entry = m_pool.get_parsed_transaction(id, cryptonote::relay_category::all);
+        if (!entry)
+          return false;
+        have_tx.push_back(entry->blob);
+        taken.push_back(entry->tx);
+      }
+      else
+      {
+        have_tx.emplace_back();
+        if (!m_pool.get_transaction(id, have_tx.back(), cryptonote::relay_category::all))
+          return false;
+        taken.emplace_back();
+        if (!cryptonote::parse_and_validate_tx_from_blob(have_tx.back(), taken.back()))
+          return false;
+      }
+    }
+    m_elapsed_ns += epee::misc_utils::get_ns_count() - start;
+    m_num_txes += num_txes;
+    return have_tx.size() == num_txes && taken.size() == num_txes;
+  }
+
+private:
+  cryptonote::tx_memory_pool m_pool;
+  cryptonote::Blockchain m_blockchain;
+  cryptonote::account_base m_alice;
+  std::vector<crypto::hash> m_ids;
+  uint64_t m_elapsed_ns{0};
+  uint64_t m_num_txes{0};
+};
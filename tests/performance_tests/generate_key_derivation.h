@@ -47,3 +47,45 @@ public:
     return true;
   }
 };
+
+template<size_t num_keys, bool batched>
+class test_generate_key_derivations
+{
+public:
+  static const size_t loop_count = 10000 / num_keys + 10;
+
+  bool init()
+  {
+    crypto::public_key view_pubkey;
+    crypto::generate_keys(view_pubkey, m_view_seckey);
+
+    // stand-ins for the tx pubkeys of a refresh batch
+    m_tx_pubkeys.resize(num_keys);
+    for (crypto::public_key &tx_pubkey : m_tx_pubkeys)
+    {
+      crypto::secret_key tx_seckey;
+      crypto::generate_keys(tx_pubkey, tx_seckey);
+    }
+    m_derivations.resize(num_keys);
+    return true;
+  }
+
+  bool test()
+  {
+    if (batched)
+      return crypto::generate_key_derivations(m_tx_pubkeys.data(), num_keys, m_view_seckey, m_derivations.data(), m_valid);
+
+    for (size_t i = 0; i < num_keys; ++i)
+    {
+      if (!crypto::generate_key_derivation(m_tx_pubkeys[i], m_view_seckey, m_derivations[i]))
+        return false;
+    }
+    return true;
+  }
+
+private:
+  crypto::secret_key m_view_seckey;
+  std::vector<crypto::public_key> m_tx_pubkeys;
+  std::vector<crypto::key_derivation> m_derivations;
+  bool m_valid[num_keys];
+};
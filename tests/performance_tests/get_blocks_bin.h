@@ -0,0 +1,162 @@
+// Copyright (c) 2021, The Monero Project
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of
+//    conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list
+//    of conditions and the following disclaimer in the documentation and/or other
+//    materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be
+//    used to endorse or promote products derived from this software without specific
+//    prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+// THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "byte_slice.h"
+#include "byte_stream.h"
+#include "crypto/crypto.h"
+#include "misc_os_dependent.h"
+#include "rpc/blocks_bin_writer.h"
+#include "rpc/core_rpc_server_commands_defs.h"
+#include "storages/portable_storage_template_helper.h"
+
+// serialize a /get_blocks.bin response over blobs held in memory, standing in for database pages
+// - generic: blobs are copied into the response struct (as get_blocks_from() copies them out of the
+//   database), which is then stored through a portable_storage tree
+// - in place: blobs are written straight into the output by write_get_blocks_fast_response()
+// - reports response MB/s served per core; init() checks that both paths produce the same bytes
+template<size_t NumBlocks, size_t TxesPerBlock, bool Pruned, bool InPlace>
+class test_get_blocks_bin
+{
+public:
+  static const size_t loop_count = 20;
+
+  ~test_get_blocks_bin()
+  {
+    if (m_elapsed_ns == 0 || m_num_calls == 0)
+      return;
+    std::cout << "  " << (InPlace ? "in place" : "generic") << ", response bytes: " << m_response_size
+      << ", MB/s: " << static_cast<double>(m_response_size) * m_num_calls * 1e3 / m_elapsed_ns << '\n';
+  }
+
+  bool init()
+  {
+    // typical sizes: ~1.5 kB of pruned data and ~1 kB of prunable data per 2-out tx
+    m_blocks.resize(NumBlocks);
+    m_res.start_height = 2000000;
+    m_res.current_height = 2000000 + NumBlocks;
+    m_res.status = CORE_RPC_STATUS_OK;
+    for (size_t b = 0; b < NumBlocks; ++b)
+    {
+      m_storage.push_back(random_blob(200));
+      for (size_t t = 0; t < TxesPerBlock; ++t)
+      {
+        m_storage.push_back(random_blob(1500));
+        m_storage.push_back(random_blob(1000));
+      }
+
+      cryptonote::COMMAND_RPC_GET_BLOCKS_FAST::block_output_indices indices;
+      for (size_t t = 0; t < TxesPerBlock + 1; ++t)
+        indices.indices.push_back({{crypto::rand<uint64_t>(), crypto::rand<uint64_t>()}});
+      m_res.output_indices.push_back(std::move(indices));
+    }
+
+    // set the refs once the storage stopped moving
+    size_t next = 0;
+    for (size_t b = 0; b < NumBlocks; ++b)
+    {
+      m_blocks[b].block = epee::strspan<uint8_t>(m_storage[next++]);
+      m_blocks[b].txs.resize(TxesPerBlock);
+      for (cryptonote::tx_blob_ref &tx: m_blocks[b].txs)
+      {
+        tx.pruned = epee::strspan<uint8_t>(m_storage[next++]);
+        tx.prunable = Pruned ? epee::span<const uint8_t>{} : epee::strspan<uint8_t>(m_storage[next]);
+        ++next;
+      }
+    }
+
+    epee::byte_slice generic, in_place;
+    if (!serialize_generic(generic) || !serialize_in_place(in_place))
+      return false;
+    if (generic.size() != in_place.size() || memcmp(generic.data(), in_place.data(), generic.size()) != 0)
+    {
+      std::cerr << "in place response differs from the generic one" << std::endl;
+      return false;
+    }
+    m_response_size = generic.size();
+    return true;
+  }
+
+  bool test()
+  {
+    const uint64_t start = epee::misc_utils::get_ns_count();
+    epee::byte_slice body;
+    const bool r = InPlace ? serialize_in_place(body) : serialize_generic(body);
+    m_elapsed_ns += epee::misc_utils::get_ns_count() - start;
+    ++m_num_calls;
+    return r && body.size() == m_response_size;
+  }
+
+private:
+  static std::string random_blob(const size_t size)
+  {
+    std::string blob(size, '\0');
+    crypto::rand(size, reinterpret_cast<uint8_t*>(&blob[0]));
+    return blob;
+  }
+
+  bool serialize_generic(epee::byte_slice &body) const
+  {
+    cryptonote::COMMAND_RPC_GET_BLOCKS_FAST::response res = m_res;
+    res.blocks.reserve(m_blocks.size());
+    for (const cryptonote::block_blob_refs &block: m_blocks)
+    {
+      res.blocks.resize(res.blocks.size() + 1);
+      res.blocks.back().pruned = Pruned;
+      res.blocks.back().block.assign(reinterpret_cast<const char*>(block.block.data()), block.block.size());
+      for (const cryptonote::tx_blob_ref &tx: block.txs)
+      {
+        cryptonote::blobdata blob(reinterpret_cast<const char*>(tx.pruned.data()), tx.pruned.size());
+        blob.append(reinterpret_cast<const char*>(tx.prunable.data()), tx.prunable.size());
+        res.blocks.back().txs.push_back({std::move(blob), crypto::null_hash});
+      }
+    }
+    return epee::serialization::store_t_to_binary(res, body, 64 * 1024);
+  }
+
+  bool serialize_in_place(epee::byte_slice &body) const
+  {
+    epee::byte_stream out;
+    cryptonote::write_get_blocks_fast_response(out, m_res, m_blocks, Pruned);
+    body = epee::byte_slice{std::move(out)};
+    return true;
+  }
+
+  std::vector<std::string> m_storage;
+  std::vector<cryptonote::block_blob_refs> m_blocks;
+  cryptonote::COMMAND_RPC_GET_BLOCKS_FAST::response m_res;
+  size_t m_response_size{0};
+  uint64_t m_elapsed_ns{0};
+  uint64_t m_num_calls{0};
+};
@@ -61,11 +61,11 @@ class test_grootle
             const std::size_t N = std::pow(n, m);
 
             // Build key vectors
-            M.resize(N_proofs, keyM(N, keyV(num_keys)));
+            M.resize(N_proofs, KeyMatrix{N, num_keys});
             std::vector<std::vector<crypto::secret_key>> proof_privkeys;// privkey tuple per-proof (at secret indices in M)
             proof_privkeys.resize(N_proofs, std::vector<crypto::secret_key>(num_keys));
             proof_messages = keyV(N_proofs);  // message per-proof
-            proof_offsets.resize(N_proofs, keyV(num_keys));
+            proof_offsets.resize(N_proofs, num_keys);
 
             // Random keys
             key temp;
@@ -115,7 +115,7 @@ class test_grootle
                     proofs.push_back(
                         sp::grootle_prove(M[proof_i],
                             proof_i,
-                            proof_offsets[proof_i],
+                            keyV(proof_offsets[proof_i].begin(), proof_offsets[proof_i].end()),
                             proof_privkeys[proof_i],
                             n,
                             m,
@@ -153,8 +153,8 @@ class test_grootle
         }
 
     private:
-        std::vector<keyM> M;  // reference set
-        keyM proof_offsets;   // commitment offset tuple per-proof
+        std::vector<KeyMatrix> M;  // reference set
+        KeyMatrix proof_offsets;   // commitment offset tuple per-proof
         keyV proof_messages;  // message per-proof
         std::vector<sp::GrootleProof> proofs;
         std::vector<const sp::GrootleProof*> proof_ptrs;
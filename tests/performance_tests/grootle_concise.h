@@ -31,8 +31,10 @@
 #include "crypto/crypto.h"
 #include "mock_tx/grootle.h"
 #include "mock_tx/mock_tx_utils.h"
+#include "ringct/multiexp.h"
 #include "ringct/rctTypes.h"
 
+#include <algorithm>
 #include <vector>
 
 
@@ -42,7 +44,8 @@ template<std::size_t a_n,
     std::size_t a_m,
     std::size_t num_proofsV,
     std::size_t num_keysV,
-    std::size_t num_ident_offsetsV>
+    std::size_t num_ident_offsetsV,
+    bool shared_ref_setV = false>
 class test_concise_grootle
 {
     public:
@@ -52,6 +55,7 @@ class test_concise_grootle
         static const std::size_t N_proofs = num_proofsV;
         static const std::size_t num_keys = num_keysV;
         static const std::size_t num_ident_offsets = num_ident_offsetsV;
+        static const bool shared_ref_set = shared_ref_setV;  // all proofs use the same reference set
 
         bool init()
         {
@@ -59,11 +63,11 @@ class test_concise_grootle
             const std::size_t N = std::pow(n, m);
 
             // Build key vectors
-            M.resize(N_proofs, keyM(N, keyV(num_keys)));
+            M.resize(N_proofs, KeyMatrix{N, num_keys});
             std::vector<std::vector<crypto::secret_key>> proof_privkeys;// privkey tuple per-proof (at secret indices in M)
             proof_privkeys.resize(N_proofs, std::vector<crypto::secret_key>(num_keys));
             proof_messages = keyV(N_proofs);  // message per-proof
-            proof_offsets.resize(N_proofs, keyV(num_keys));
+            proof_offsets.resize(N_proofs, num_keys);
 
             // Random keys
             key temp;
@@ -103,6 +107,21 @@ class test_concise_grootle
                 }
             }
 
+            // shared ref set: every proof references all of the signing keys and proof 0's decoys
+            if (shared_ref_set)
+            {
+                for (std::size_t proof_i = 0; proof_i < N_proofs; proof_i++)
+                {
+                    for (std::size_t k = 0; k < N; k++)
+                    {
+                        // copy the keys (assigning a row would only rebind the span)
+                        const std::size_t source_i{k < N_proofs ? k : 0};
+                        if (source_i != proof_i)
+                            std::copy(M[source_i][k].begin(), M[source_i][k].end(), M[proof_i][k].begin());
+                    }
+                }
+            }
+
             proofs.reserve(N_proofs);
             proof_ptrs.reserve(N_proofs);
 
@@ -113,7 +132,7 @@ class test_concise_grootle
                     proofs.push_back(
                         sp::concise_grootle_prove(M[proof_i],
                             proof_i,
-                            proof_offsets[proof_i],
+                            keyV(proof_offsets[proof_i].begin(), proof_offsets[proof_i].end()),
                             proof_privkeys[proof_i],
                             n,
                             m,
@@ -139,7 +158,12 @@ class test_concise_grootle
             // Verify batch
             try
             {
-                if (!sp::concise_grootle_verify(proof_ptrs, M, proof_offsets, n, m, proof_messages))
+                if (shared_ref_set)
+                {
+                    if (!sp::concise_grootle_verify_shared_refs(proof_ptrs, M, proof_offsets, n, m, proof_messages))
+                        return false;
+                }
+                else if (!sp::concise_grootle_verify(proof_ptrs, M, proof_offsets, n, m, proof_messages))
                     return false;
             }
             catch (...)
@@ -150,10 +174,299 @@ class test_concise_grootle
             return true;
         }
 
-    private:
-        std::vector<keyM> M;               // reference set
-        keyM proof_offsets;   // commitment offset tuple per-proof
+    protected:
+        std::vector<KeyMatrix> M;               // reference set
+        KeyMatrix proof_offsets;   // commitment offset tuple per-proof
         keyV proof_messages;  // message per-proof
         std::vector<sp::ConciseGrootleProof> proofs;
         std::vector<const sp::ConciseGrootleProof *> proof_ptrs;
 };
+
+// batch verification with random weights of 'small_weighting_size' bytes combining the proofs
+template<std::size_t a_n,
+    std::size_t a_m,
+    std::size_t num_proofsV,
+    std::size_t num_keysV,
+    std::size_t small_weighting_sizeV>
+class test_concise_grootle_weighting : public test_concise_grootle<a_n, a_m, num_proofsV, num_keysV, 0>
+{
+    public:
+        static const std::size_t small_weighting_size = small_weighting_sizeV;
+
+        bool test()
+        {
+            try
+            {
+                return sp::concise_grootle_verify(this->proof_ptrs,
+                    this->M,
+                    this->proof_offsets,
+                    this->n,
+                    this->m,
+                    this->proof_messages,
+                    small_weighting_size);
+            }
+            catch (...)
+            {
+                return false;
+            }
+        }
+};
+
+// verification data assembly only (no multiexp), to see its allocations (run with --track-allocations)
+// - recycle: give each call's multiexp data back to the thread's pool, as batch verifiers do after their multiexp; with
+//   it, steady-state calls should not allocate
+template<std::size_t a_n,
+    std::size_t a_m,
+    std::size_t num_proofsV,
+    std::size_t num_keysV,
+    bool recycleV>
+class test_concise_grootle_verification_data : public test_concise_grootle<a_n, a_m, num_proofsV, num_keysV, 0>
+{
+    public:
+        static const std::size_t loop_count = (1000/a_n)/num_proofsV;
+        static const bool recycle = recycleV;
+
+        bool test()
+        {
+            try
+            {
+                rct::pippenger_prep_data prep_data{
+                        sp::get_concise_grootle_verification_data(this->proof_ptrs,
+                            this->M,
+                            this->proof_offsets,
+                            this->n,
+                            this->m,
+                            this->proof_messages)
+                    };
+
+                if (prep_data.data.empty())
+                    return false;
+
+                if (recycle)
+                    rct::recycle_multiexp_data_buffer(std::move(prep_data.data));
+            }
+            catch (...)
+            {
+                return false;
+            }
+
+            return true;
+        }
+};
+
+template<std::size_t a_n,
+    std::size_t a_m,
+    std::size_t num_proofsV,
+    std::size_t num_keysV>
+class test_concise_grootle_fixed
+{
+    public:
+        static const std::size_t loop_count = (250/a_n)/num_proofsV;
+        static const std::size_t n = a_n;
+        static const std::size_t m = a_m;
+        static const std::size_t N_proofs = num_proofsV;
+        static const std::size_t num_keys = num_keysV;
+
+        bool init()
+        {
+            // anonymity set size
+            const std::size_t N = sp::grootle_ref_set_size(n, m);
+
+            // Build key vectors (real signer at index 'proof_i', no identity offsets)
+            M.resize(N_proofs, KeyMatrix{N, num_keys});
+            std::vector<std::vector<crypto::secret_key>> proof_privkeys;
+            proof_privkeys.resize(N_proofs, std::vector<crypto::secret_key>(num_keys));
+            proof_messages = keyV(N_proofs);
+            proof_offsets.resize(N_proofs, num_keys);
+
+            key temp, privkey, offset_privkey;
+            for (std::size_t proof_i = 0; proof_i < N_proofs; proof_i++)
+            {
+                for (std::size_t k = 0; k < N; k++)
+                {
+                    for (std::size_t alpha = 0; alpha < num_keys; ++alpha)
+                    {
+                        skpkGen(temp, M[proof_i][k][alpha]);
+                    }
+                }
+
+                proof_messages[proof_i] = skGen();
+                for (std::size_t alpha = 0; alpha < num_keys; ++alpha)
+                {
+                    skpkGen(privkey, M[proof_i][proof_i][alpha]);  //m_{l, alpha} * G
+                    skpkGen(offset_privkey, proof_offsets[proof_i][alpha]);  //c_{alpha} * G
+                    sc_sub(&(proof_privkeys[proof_i][alpha]), privkey.bytes, offset_privkey.bytes); //m - c
+                }
+            }
+
+            proofs.reserve(N_proofs);
+            proof_ptrs.reserve(N_proofs);
+
+            try
+            {
+                for (std::size_t proof_i = 0; proof_i < N_proofs; proof_i++)
+                {
+                    proofs.push_back(
+                        sp::concise_grootle_prove<n, m>(M[proof_i],
+                            proof_i,
+                            keyV(proof_offsets[proof_i].begin(), proof_offsets[proof_i].end()),
+                            proof_privkeys[proof_i],
+                            proof_messages[proof_i])
+                        );
+                }
+            }
+            catch (...)
+            {
+                return false;
+            }
+
+            for (sp::ConciseGrootleProofFixed<n, m> &proof: proofs)
+            {
+                proof_ptrs.push_back(&proof);
+            }
+
+            return true;
+        }
+
+        bool test()
+        {
+            // Verify batch
+            try
+            {
+                if (!sp::concise_grootle_verify<n, m>(proof_ptrs, M, proof_offsets, proof_messages))
+                    return false;
+            }
+            catch (...)
+            {
+                return false;
+            }
+
+            return true;
+        }
+
+    private:
+        std::vector<KeyMatrix> M;               // reference set
+        KeyMatrix proof_offsets;   // commitment offset tuple per-proof
+        keyV proof_messages;  // message per-proof
+        std::vector<sp::ConciseGrootleProofFixed<n, m>> proofs;
+        std::vector<const sp::ConciseGrootleProofFixed<n, m> *> proof_ptrs;
+};
+
+template<std::size_t a_n,
+    std::size_t a_m,
+    std::size_t num_threadsV>
+class test_concise_grootle_threads : public test_concise_grootle<a_n, a_m, 1, 2, 0>
+{
+    public:
+        static const std::size_t loop_count = 10;
+        static const std::size_t num_threads = num_threadsV;  // 0 = threadpool max concurrency
+
+        bool test()
+        {
+            // latency of one proof over a very large ref set
+            try
+            {
+                return sp::concise_grootle_verify(this->proof_ptrs,
+                    this->M,
+                    this->proof_offsets,
+                    this->n,
+                    this->m,
+                    this->proof_messages,
+                    sp::DEFAULT_BATCH_WEIGHT_SIZE,
+                    num_threads);
+            }
+            catch (...)
+            {
+                return false;
+            }
+        }
+};
+
+template<std::size_t a_n,
+    std::size_t a_m,
+    std::size_t num_inputsV,
+    std::size_t num_keysV>
+class test_concise_grootle_aggregate
+{
+    public:
+        static const std::size_t loop_count = (250/a_n)/num_inputsV;
+        static const std::size_t n = a_n;
+        static const std::size_t m = a_m;
+        static const std::size_t num_inputs = num_inputsV;  // inputs proven by one aggregated proof
+        static const std::size_t num_keys = num_keysV;
+
+        bool init()
+        {
+            // anonymity set size
+            const std::size_t N = sp::grootle_ref_set_size(n, m);
+
+            // Build key vectors (one ref set per input, real signer at index 'u', no identity offsets)
+            M.resize(1);
+            M[0].resize(num_inputs, KeyMatrix{N, num_keys});
+            std::vector<std::vector<crypto::secret_key>> input_privkeys;
+            input_privkeys.resize(num_inputs, std::vector<crypto::secret_key>(num_keys));
+            std::vector<std::size_t> l;
+            proof_messages = keyV{skGen()};
+            proof_offsets.resize(1);
+            proof_offsets[0].resize(num_inputs, num_keys);
+
+            key temp, privkey, offset_privkey;
+            for (std::size_t u = 0; u < num_inputs; u++)
+            {
+                for (std::size_t k = 0; k < N; k++)
+                {
+                    for (std::size_t alpha = 0; alpha < num_keys; ++alpha)
+                    {
+                        skpkGen(temp, M[0][u][k][alpha]);
+                    }
+                }
+
+                l.push_back(u % N);
+                for (std::size_t alpha = 0; alpha < num_keys; ++alpha)
+                {
+                    skpkGen(privkey, M[0][u][l[u]][alpha]);  //m_{l, alpha} * G
+                    skpkGen(offset_privkey, proof_offsets[0][u][alpha]);  //c_{alpha} * G
+                    sc_sub(&(input_privkeys[u][alpha]), privkey.bytes, offset_privkey.bytes); //m - c
+                }
+            }
+
+            try
+            {
+                proof = sp::aggregate_concise_grootle_prove(M[0],
+                    l,
+                    proof_offsets[0],
+                    input_privkeys,
+                    n,
+                    m,
+                    proof_messages[0]);
+            }
+            catch (...)
+            {
+                return false;
+            }
+
+            return true;
+        }
+
+        bool test()
+        {
+            // Verify the aggregated proof (compare with test_concise_grootle with 'num_inputs' proofs)
+            try
+            {
+                if (!sp::aggregate_concise_grootle_verify({&proof}, M, proof_offsets, n, m, proof_messages))
+                    return false;
+            }
+            catch (...)
+            {
+                return false;
+            }
+
+            return true;
+        }
+
+    private:
+        std::vector<std::vector<KeyMatrix>> M;  // reference set per-input
+        std::vector<KeyMatrix> proof_offsets;   // commitment offset tuple per-input
+        keyV proof_messages;
+        sp::AggregateConciseGrootleProof proof;
+};
@@ -0,0 +1,86 @@
+// Copyright (c) 2021, The Monero Project
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of
+//    conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list
+//    of conditions and the following disclaimer in the documentation and/or other
+//    materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be
+//    used to endorse or promote products derived from this software without specific
+//    prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+// THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#pragma once
+
+#include "mock_tx/seraphis_crypto_utils.h"
+#include "ringct/rctOps.h"
+#include "ringct/rctTypes.h"
+
+#include <cstddef>
+#include <vector>
+
+// one-of-many verification coefficients t_k = prod_j( f[j][decomp_k[j]] ) for all k in [0, n^m)
+// - shared_prefix: use sp::one_of_many_f_products(), otherwise multiply out all m digits for every k
+template<std::size_t n, std::size_t m, bool shared_prefix>
+class test_grootle_f_products
+{
+public:
+  static const size_t loop_count = 1000;
+
+  bool init()
+  {
+    f.resize(m, n);
+    for (std::size_t j = 0; j < m; ++j)
+      for (rct::key &f_elem : f[j])
+        f_elem = rct::skGen();
+
+    N = 1;
+    for (std::size_t j = 0; j < m; ++j)
+      N *= n;
+    decomp_k.resize(m);
+    return true;
+  }
+
+  bool test()
+  {
+    if (shared_prefix)
+    {
+      sp::one_of_many_f_products(f, n, m, prefix_scratch, t);
+    }
+    else
+    {
+      t.resize(N);
+      for (std::size_t k = 0; k < N; ++k)
+      {
+        sp::decompose(k, n, m, decomp_k);
+
+        t[k] = rct::identity();
+        for (std::size_t j = 0; j < m; ++j)
+          sc_mul(t[k].bytes, t[k].bytes, f[j][decomp_k[j]].bytes);
+      }
+    }
+    return true;
+  }
+
+private:
+  rct::KeyMatrix f;
+  std::size_t N;
+  std::vector<std::size_t> decomp_k;
+  rct::keyV prefix_scratch;
+  rct::keyV t;
+};
@@ -0,0 +1,235 @@
+// Copyright (c) 2021, The Monero Project
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this list of
+//    conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list
+//    of conditions and the following disclaimer in the documentation and/or other
+//    materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its contributors may be
+//    used to endorse or promote products derived from this software without specific
+//    prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+// THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+#include <ostream>
+#include <vector>
+
+/**
+ * Latency histogram with constant memory (the HdrHistogram layout)
+ * - values (ns) are kept to 3 significant decimal digits: buckets double in range, and each bucket is split into
+ *   2048 linear sub-buckets, so the relative error of any recorded value is below 1/1024
+ * - values above 'max_trackable_ns' (default: one hour) are counted at that value (the exact max is kept)
+ * - memory is fixed by 'max_trackable_ns' (~270 kB by default), independent of the number of samples
+ * - usage: record() each sample (e.g. per call), then read percentiles, or export the percentile distribution
+ */
+class LatencyHistogram final
+{
+public:
+  explicit LatencyHistogram(const uint64_t max_trackable_ns = 3600ull * 1000 * 1000 * 1000)
+  {
+    // number of buckets needed to cover the trackable range
+    uint64_t smallest_untrackable{sub_bucket_count};
+    size_t bucket_count{1};
+    while (smallest_untrackable <= max_trackable_ns && bucket_count < 64 - sub_bucket_half_count_magnitude)
+    {
+      smallest_untrackable <<= 1;
+      ++bucket_count;
+    }
+
+    m_max_trackable_ns = smallest_untrackable - 1;
+    m_counts.resize((bucket_count + 1) * sub_bucket_half_count, 0);
+  }
+
+  void record(const uint64_t ns)
+  {
+    ++m_counts[counts_index(std::min(ns, m_max_trackable_ns))];
+    ++m_total_count;
+    m_min = std::min(m_min, ns);
+    m_max = std::max(m_max, ns);
+    m_sum += static_cast<double>(ns);
+    m_sum_squares += static_cast<double>(ns) * ns;
+  }
+
+  /// add another histogram's samples (e.g. to combine per-thread histograms)
+  void merge(const LatencyHistogram &other)
+  {
+    if (other.m_total_count == 0)
+      return;
+
+    for (size_t index = 0; index < other.m_counts.size(); ++index)
+    {
+      if (other.m_counts[index] > 0)
+        m_counts[counts_index(std::min(value_from_index(index), m_max_trackable_ns))] += other.m_counts[index];
+    }
+    m_total_count += other.m_total_count;
+    m_min = std::min(m_min, other.m_min);
+    m_max = std::max(m_max, other.m_max);
+    m_sum += other.m_sum;
+    m_sum_squares += other.m_sum_squares;
+  }
+
+  uint64_t total_count() const { return m_total_count; }
+  uint64_t min() const { return m_total_count > 0 ? m_min : 0; }
+  uint64_t max() const { return m_max; }
+  double mean() const { return m_total_count > 0 ? m_sum / m_total_count : 0.0; }
+  double stddev() const
+  {
+    if (m_total_count == 0)
+      return 0.0;
+    const double mean_value{mean()};
+    return std::sqrt(std::max(0.0, m_sum_squares / m_total_count - mean_value * mean_value));
+  }
+
+  /// smallest value that 'percentile' % of the samples are at or below (to the histogram's precision)
+  uint64_t value_at_percentile(const double percentile) const
+  {
+    if (m_total_count == 0)
+      return 0;
+
+    const double clamped{std::min(std::max(percentile, 0.0), 100.0)};
+    const uint64_t count_at_percentile{
+        std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(clamped / 100.0 * m_total_count)))
+      };
+
+    uint64_t cumulative_count{0};
+    for (size_t index = 0; index < m_counts.size(); ++index)
+    {
+      cumulative_count += m_counts[index];
+      if (cumulative_count >= count_at_percentile)
+        return std::min(std::max(highest_equivalent_value(value_from_index(index)), m_min), m_max);
+    }
+
+    return m_max;
+  }
+
+  /// quantiles like Stats::get_quantiles(): n + 1 values from the min to the max
+  std::vector<uint64_t> get_quantiles(const size_t n) const
+  {
+    std::vector<uint64_t> quantiles;
+    quantiles.reserve(n + 1);
+    for (size_t i = 0; i <= n; ++i)
+      quantiles.push_back(i == 0 ? min() : value_at_percentile(100.0 * i / n));
+    return quantiles;
+  }
+
+  /**
+   * Write the percentile distribution in HdrHistogram's text format (.hgrm, e.g. for its online plotter)
+   * - values are in 'unit_ns' units (default: us), with 5 percentile ticks per halving of the distance to 100%
+   */
+  void export_percentile_distribution(std::ostream &out, const double unit_ns = 1000.0) const
+  {
+    char line[128];
+    out << "       Value     Percentile TotalCount 1/(1-Percentile)\n\n";
+
+    double percentile{0.0};
+    while (m_total_count > 0)
+    {
+      const uint64_t value{value_at_percentile(percentile)};
+      const uint64_t count_at_value{count_at_or_below(value)};
+      const double reached_percentile{100.0 * count_at_value / m_total_count};
+      if (reached_percentile >= 100.0)
+      {
+        snprintf(line, sizeof(line), "%12.3f %14.12f %10llu\n", value / unit_ns, 1.0,
+          static_cast<unsigned long long>(count_at_value));
+        out << line;
+        break;
+      }
+      snprintf(line, sizeof(line), "%12.3f %14.12f %10llu %14.2f\n", value / unit_ns, reached_percentile / 100.0,
+        static_cast<unsigned long long>(count_at_value), 1.0 / (1.0 - reached_percentile / 100.0));
+      out << line;
+
+      // next tick: halving distances to 100% get 5 ticks each
+      const double half_distance{std::pow(2.0, std::floor(std::log2(100.0 / (100.0 - reached_percentile))) + 1)};
+      percentile = std::max(percentile, reached_percentile) + 100.0 / (5 * half_distance);
+    }
+
+    snprintf(line, sizeof(line), "#[Mean    = %12.3f, StdDeviation   = %12.3f]\n", mean() / unit_ns,
+      stddev() / unit_ns);
+    out << line;
+    snprintf(line, sizeof(line), "#[Max     = %12.3f, Total count    = %12llu]\n", m_max / unit_ns,
+      static_cast<unsigned long long>(m_total_count));
+    out << line;
+    snprintf(line, sizeof(line), "#[Buckets = %12zu, SubBuckets     = %12llu]\n",
+      m_counts.size() / sub_bucket_half_count - 1, static_cast<unsigned long long>(sub_bucket_count));
+    out << line;
+  }
+
+private:
+  // 3 significant digits: 2 * 10^3 distinct values per bucket, rounded up to a power of 2
+  static constexpr size_t sub_bucket_count_magnitude = 11;
+  static constexpr size_t sub_bucket_half_count_magnitude = sub_bucket_count_magnitude - 1;
+  static constexpr uint64_t sub_bucket_count = uint64_t{1} << sub_bucket_count_magnitude;
+  static constexpr uint64_t sub_bucket_half_count = sub_bucket_count / 2;
+  static constexpr uint64_t sub_bucket_mask = sub_bucket_count - 1;
+
+  static size_t bucket_index(const uint64_t value)
+  {
+    // position of the highest bit, relative to the first bucket's range
+    size_t highest_bit{0};
+    for (uint64_t v = value | sub_bucket_mask; v > 1; v >>= 1)
+      ++highest_bit;
+    return highest_bit + 1 - sub_bucket_count_magnitude;
+  }
+
+  static size_t counts_index(const uint64_t value)
+  {
+    const size_t bucket{bucket_index(value)};
+    const size_t sub_bucket{static_cast<size_t>(value >> bucket)};
+    return ((bucket + 1) << sub_bucket_half_count_magnitude) + sub_bucket - sub_bucket_half_count;
+  }
+
+  static uint64_t value_from_index(const size_t index)
+  {
+    size_t bucket{index >> sub_bucket_half_count_magnitude};
+    uint64_t sub_bucket{(index & (sub_bucket_half_count - 1)) + sub_bucket_half_count};
+    if (bucket == 0)
+      sub_bucket -= sub_bucket_half_count;
+    else
+      --bucket;
+    return sub_bucket << bucket;
+  }
+
+  static uint64_t highest_equivalent_value(const uint64_t value)
+  {
+    return value + (uint64_t{1} << bucket_index(value)) - 1;
+  }
+
+  uint64_t count_at_or_below(const uint64_t value) const
+  {
+    const size_t last_index{counts_index(std::min(value, m_max_trackable_ns))};
+    uint64_t count{0};
+    for (size_t index = 0; index <= last_index && index < m_counts.size(); ++index)
+      count += m_counts[index];
+    return count;
+  }
+
+  std::vector<uint64_t> m_counts;
+  uint64_t m_max_trackable_ns{0};
+  uint64_t m_total_count{0};
+  uint64_t m_min{std::numeric_limits<uint64_t>::max()};
+  uint64_t m_max{0};
+  double m_sum{0};
+  double m_sum_squares{0};
+};
@@ -0,0 +1,109 @@
+// Copyright (c) 2021, The Monero Project
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of
+//    conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list
+//    of conditions and the following disclaimer in the documentation and/or other
+//    materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be
+//    used to endorse or promote products derived from this software without specific
+//    prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+// THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <string>
+
+#include "misc_log_ex.h"
+#include "check_tx_signature.h"
+
+// sets the log categories for the lifetime of a test, then puts the previous ones back
+class log_categories_scope
+{
+public:
+  void set(const char *categories)
+  {
+    if (!m_set)
+      m_previous = mlog_get_categories();
+    m_set = true;
+    mlog_set_categories(categories);
+  }
+  ~log_categories_scope()
+  {
+    if (m_set)
+      mlog_set_categories(m_previous.c_str());
+  }
+
+private:
+  bool m_set = false;
+  std::string m_previous;
+};
+
+// cost of a disabled MTRACE
+// - a_other_traced: another category logs at TRACE, so the global gate can't reject it and the call site's
+//   cached category level decides
+// - a_uncached: ask the log registry each time instead (a lock and map lookup), as log statements used to
+template<bool a_other_traced, bool a_uncached>
+class test_log_disabled
+{
+public:
+  static const size_t loop_count = 100000;
+  static const size_t calls = 100;
+
+  bool init()
+  {
+    m_categories.set(a_other_traced ? "*:WARNING,perf.log_gate.other:TRACE" : "*:WARNING");
+    return true;
+  }
+
+  bool test()
+  {
+    size_t logged = 0;
+    for (size_t i = 0; i < calls; ++i)
+    {
+      if (a_uncached)
+      {
+        if (el::Loggers::allowed(el::Level::Trace, "perf.log_gate"))
+          ++logged;
+      }
+      else
+        MCTRACE("perf.log_gate", "call " << i << (++logged, ""));
+    }
+    return logged == 0;
+  }
+
+private:
+  log_categories_scope m_categories;
+};
+
+// transaction verification while another category logs at TRACE, so each disabled log statement and
+// PERF_TIMER on the verification path gets past the global gate
+template<size_t a_ring_size, size_t a_outputs>
+class test_check_tx_signature_log_traced: public test_check_tx_signature<a_ring_size, a_outputs, true, rct::RangeProofPaddedBulletproof, 3>
+{
+public:
+  bool init()
+  {
+    m_categories.set("*:WARNING,perf.log_gate.other:TRACE");
+    return test_check_tx_signature<a_ring_size, a_outputs, true, rct::RangeProofPaddedBulletproof, 3>::init();
+  }
+
+private:
+  log_categories_scope m_categories;
+};
@@ -28,10 +28,13 @@
 // 
 // Parts of this file are originally copyright (c) 2012-2013 The Cryptonote developers
 
+#include <fstream>
+#include <limits>
 #include <memory>
 
 #include <boost/regex.hpp>
 
+#include "common/aligned.h"
 #include "common/util.h"
 #include "common/command_line.h"
 #include "performance_tests.h"
@@ -53,9 +56,12 @@
 #include "generate_keypair.h"
 #include "signature.h"
 #include "is_out_to_acc.h"
+#include "log_gate.h"
 #include "subaddress_expand.h"
 #include "sc_reduce32.h"
 #include "sc_check.h"
+#include "scalar_invert.h"
+#include "grootle_f_products.h"
 #include "cn_fast_hash.h"
 #include "rct_mlsag.h"
 #include "equality.h"
@@ -67,19 +73,49 @@
 #include "sig_mlsag.h"
 #include "sig_clsag.h"
 #include "triptych.h"
+#include "mock_block.h"
+#include "mock_enote_file_reads.h"
+#include "mock_ledger.h"
+#include "mock_ledger_stress.h"
+#include "mock_memory_footprint.h"
 #include "mock_tx.h"
+#include "mock_tx_batch_saturation.h"
+#include "mock_tx_cost_model.h"
+#include "mock_tx_numa_scaling.h"
+#include "mock_tx_sweep.h"
+#include "mock_tx_verifier_lanes.h"
+#include "mock_tx_pool_admission.h"
 #include "grootle.h"
 #include "grootle_concise.h"
 #include "view_scan.h"
+#include "get_blocks_bin.h"
+#include "rpc_json_response.h"
+#include "portable_storage_load.h"
+#include "threadpool_dispatch.h"
+#include "fluffy_reconstruction.h"
+#include "block_parse.h"
 #include "pippinger_failure.h"
+#include "pippenger_calibration.h"
 
 namespace po = boost::program_options;
 
+// compare mode: list the tests that got slower than their last run; exit code 2 if there are any
+static int report_regressions(const Params &params)
+{
+  if (!params.regressions || params.regressions->test_names.empty())
+    return 0;
+
+  std::cout << params.regressions->test_names.size() << " performance regression(s) above "
+    << params.regressions->threshold_percent << "%:" << std::endl;
+  for (const std::string &test_name : params.regressions->test_names)
+    std::cout << "  " << test_name << std::endl;
+  return 2;
+}
+
 int main(int argc, char** argv)
 {
   TRY_ENTRY();
   tools::on_startup();
-  set_process_affinity(1);
   set_thread_high_priority();
 
   mlog_configure(mlog_get_default_log_path("performance_tests.log"), true);
@@ -89,12 +125,158 @@ int main(int argc, char** argv)
   const command_line::arg_descriptor<bool> arg_verbose = { "verbose", "Verbose output", false };
   const command_line::arg_descriptor<bool> arg_stats = { "stats", "Including statistics (min/median)", false };
   const command_line::arg_descriptor<unsigned> arg_loop_multiplier = { "loop-multiplier", "Run for that many times more loops", 1 };
+  const command_line::arg_descriptor<int> arg_pin_cpu = { "pin-cpu", "Pin the test runner to this cpu (throughput mode: runner thread i to this cpu + i; default: cpu 1 for single-threaded runs only; -1 = no pinning)", 1 };
+  const command_line::arg_descriptor<unsigned> arg_warm_up_ms = { "warm-up-ms", "Run each test for up to this many ms before timing it, stopping early once its call times settle (0 = no warm-up)", 500 };
+  const command_line::arg_descriptor<bool> arg_latency_histogram = { "latency-histogram", "Tail-latency mode: record call times in a constant-memory histogram (HdrHistogram layout, 3 significant digits) instead of per call, and report p99/p99.9/p99.99/max", false };
+  const command_line::arg_descriptor<std::string> arg_latency_histogram_dir = { "latency-histogram-dir", "Tail-latency mode: export each test's latency percentile distribution (.hgrm) to this directory" };
+  const command_line::arg_descriptor<std::string> arg_cold_cache = { "cold-cache", "Cold-cache mode: off (caches stay warm across calls), on (evict the cpu caches before each call, outside the timings), or both (run each test hot, then cold, and report the slowdown); single-threaded runs only", "off" };
+  const command_line::arg_descriptor<std::size_t> arg_cold_cache_mb = { "cold-cache-mb", "Scratch buffer streamed over by --cold-cache to evict the caches, in MiB (0 = 2x the last level cache, at least 32 MiB)", 0 };
+  const command_line::arg_descriptor<unsigned> arg_threads = { "threads", "Throughput mode: run this many test instances concurrently (reports calls/s and latency percentiles)", 1 };
+  const command_line::arg_descriptor<bool> arg_perf_counters = { "perf-counters", "Collect hardware counters per call (cycles, instructions, IPC, L1d/LLC misses, branch misses; linux only)", false };
+  const command_line::arg_descriptor<bool> arg_track_allocations = { "track-allocations", "Count heap allocations, bytes allocated and peak live bytes per call (glibc only)", false };
   const command_line::arg_descriptor<std::string> arg_timings_database = { "timings-database", "Keep timings history in a file" };
+  const command_line::arg_descriptor<std::string> arg_timings_store = { "timings-store", "Keep timings history in an indexed binary file (one record per test, tx parameters as columns)" };
+  const command_line::arg_descriptor<std::string> arg_timings_store_export = { "timings-store-export", "Export the --timings-store records of the tests that match --filter to this CSV file and exit" };
+  const command_line::arg_descriptor<uint64_t> arg_timings_store_since = { "timings-store-since", "Only export records from this time on (seconds since the epoch)", 0 };
+  const command_line::arg_descriptor<uint64_t> arg_timings_store_until = { "timings-store-until", "Only export records up to this time (seconds since the epoch)", std::numeric_limits<uint64_t>::max() };
+  const command_line::arg_descriptor<bool> arg_compare = { "compare", "Compare each test with its last run in --timings-store (or --timings-database), and exit with an error if any got significantly slower", false };
+  const command_line::arg_descriptor<double> arg_regression_threshold = { "regression-threshold", "Percent slowdown (of the mean time per call) that --compare reports as a regression, if it is also statistically significant", 5 };
+  const command_line::arg_descriptor<std::string> arg_results_file = { "results-file", "Append one structured record per test to this file" };
+  const command_line::arg_descriptor<std::string> arg_results_format = { "results-format", "Format of --results-file: json (one object per line) or csv", "json" };
+  const command_line::arg_descriptor<std::string> arg_huge_pages = { "huge-pages", "Back large buffers (multiexp data and caches, mock ledger arrays) with huge pages: off, thp (transparent, madvise), or hugetlb (reserved pool, else thp)", "off" };
+  const command_line::arg_descriptor<std::string> arg_mock_ledger_dir = { "mock-ledger-dir", "Run mock tx tests against an LMDB ledger in this directory" };
+  const command_line::arg_descriptor<std::size_t> arg_mock_ledger_enotes = { "mock-ledger-enotes", "Pre-populate the LMDB mock ledger with at least this many enotes", 0 };
+  const command_line::arg_descriptor<bool> arg_reuse_mock_txs = { "reuse-mock-txs", "Reuse proven mock txs (and their ledger) across tests that only differ in batch size", false };
+  const command_line::arg_descriptor<std::string> arg_mock_tx_fixture_dir = { "mock-tx-fixture-dir", "Load each Seraphis mock tx test's in-memory ledger and txs from snapshots in this directory, making and saving them there first if missing (ignored with --mock-ledger-dir)" };
+  const command_line::arg_descriptor<std::size_t> arg_mock_ledger_straus_cache = { "mock-ledger-straus-cache", "Keep straus multiples for up to this many squashed enotes in the in-memory mock ledger, and use them to verify squashed Seraphis membership proofs (0 = off)", 0 };
+  const command_line::arg_descriptor<std::size_t> arg_mock_tx_build_threads = { "mock-tx-build-threads", "Prove the independent inputs of each mock tx on this many threads while setting up mock tx tests (0 = all cores)", 1 };
+  const command_line::arg_descriptor<std::size_t> arg_mock_tx_fixture_workers = { "mock-tx-fixture-workers", "Build this many mock txs at once while setting up mock tx tests (0 = all cores, 1 = serial)", 0 };
+  const command_line::arg_descriptor<std::size_t> arg_mock_tx_ref_set_bin_size = { "mock-tx-ref-set-bin-size", "Make squashed Seraphis mock tx ref sets out of bins of this many consecutive ledger enotes (0 = one run per ref set)", 0 };
+  const command_line::arg_descriptor<bool> arg_mock_tx_gamma_decoys = { "mock-tx-gamma-decoys", "Pick squashed Seraphis mock tx decoys from the --mock-ledger-enotes pre-populated enotes with wallet2's gamma distribution (needs --mock-ledger-dir)", false };
+  const command_line::arg_descriptor<bool> arg_mock_tx_from_blobs = { "mock-tx-from-blobs", "Parse each mock tx from its byte blob before validating it (Seraphis mock txs only)", false };
+  const command_line::arg_descriptor<bool> arg_mock_tx_phase_timings = { "mock-tx-phase-timings", "Print how long each mock tx test spends in each validation (or proving) phase (needs a build with -DMOCK_TX_PHASE_TIMERS=ON)", false };
+  const command_line::arg_descriptor<bool> arg_mock_tx_warm_hp_cache = { "mock-tx-warm-hp-cache", "Keep ring members' Hp(P) cached across CLSAG mock tx validation runs instead of clearing the cache before each run", false };
+  const command_line::arg_descriptor<bool> arg_mock_tx_prove = { "mock-tx-prove", "Time proving the txs instead of validating them at --sweep points", false };
+  const command_line::arg_descriptor<std::string> arg_sweep = { "sweep", "Run the mock tx parameter sweeps in this file (JSON, or INI if it ends in .ini) instead of the built-in mock tx test sets" };
+  const command_line::arg_descriptor<bool> arg_memory_footprint = { "memory-footprint", "Report the heap bytes per enote and per linking tag of mock ledgers, and per in-memory mock tx of each type, over a range of ledger and mempool sizes, and exit (glibc only)", false };
+  const command_line::arg_descriptor<std::size_t> arg_memory_footprint_max_enotes = { "memory-footprint-max-enotes", "Largest mock ledger for --memory-footprint (from 1000, x10 per step)", 1000000 };
+  const command_line::arg_descriptor<std::size_t> arg_memory_footprint_max_txs = { "memory-footprint-max-txs", "Largest mempool for --memory-footprint (from 1, x10 per step)", 1000 };
+  const command_line::arg_descriptor<bool> arg_ledger_stress = { "ledger-stress", "Validate squashed Seraphis mock tx batches on several threads while another thread appends txs to the same ledger, report reader/writer throughput and latency, and exit", false };
+  const command_line::arg_descriptor<std::size_t> arg_ledger_stress_readers = { "ledger-stress-readers", "Reader threads for --ledger-stress (each validates its own batch of 8 txs)", 4 };
+  const command_line::arg_descriptor<std::size_t> arg_ledger_stress_writer_interval_us = { "ledger-stress-writer-interval-us", "Time between appended txs for --ledger-stress (0 = back to back)", 1000 };
+  const command_line::arg_descriptor<std::size_t> arg_ledger_stress_seconds = { "ledger-stress-seconds", "Duration of --ledger-stress", 10 };
+  const command_line::arg_descriptor<bool> arg_mock_block = { "mock-block", "Make blocks of mock txs with a mix of in/out counts, verify and append them to one ledger block by block for each mock tx type, report block latency and throughput, and exit", false };
+  const command_line::arg_descriptor<std::size_t> arg_mock_block_count = { "mock-block-count", "Blocks per mock tx type for --mock-block", 10 };
+  const command_line::arg_descriptor<std::size_t> arg_mock_block_txs = { "mock-block-txs", "Txs per block for --mock-block", 32 };
+  const command_line::arg_descriptor<std::string> arg_mock_block_tx_shapes = { "mock-block-tx-shapes", "Tx shape distribution for --mock-block, as in:out:weight,... (default: mostly 1-2 in/2 out, up to 16 in and 16 out)" };
+  const command_line::arg_descriptor<std::size_t> arg_mock_block_threads = { "mock-block-threads", "Threads used to verify each block for --mock-block (0 = all cores)", 0 };
+  const command_line::arg_descriptor<std::string> arg_enote_file_reads_dir = { "enote-file-reads-dir", "Compare random ref set reads from an LMDB ledger and from a flat squashed enote file (io_uring, direct I/O) made in this directory, at cold and warm page cache, and exit" };
+  const command_line::arg_descriptor<std::size_t> arg_enote_file_reads_enotes = { "enote-file-reads-enotes", "Enotes in the ledger for --enote-file-reads-dir", std::size_t{1} << 22 };
+  const command_line::arg_descriptor<std::size_t> arg_enote_file_reads_batches = { "enote-file-reads-batches", "Batches read per backend and cache state for --enote-file-reads-dir", 20 };
+  const command_line::arg_descriptor<std::size_t> arg_enote_file_reads_ref_sets = { "enote-file-reads-ref-sets", "Ref sets (2^7 enotes each) per batch for --enote-file-reads-dir", 64 };
+  const command_line::arg_descriptor<bool> arg_verifier_lanes = { "verifier-lanes", "Stream squashed Seraphis mock txs through the batch verifier with some of them in the urgent lane, report each lane's latency under each urgent policy, and exit", false };
+  const command_line::arg_descriptor<std::size_t> arg_verifier_lanes_txs = { "verifier-lanes-txs", "Txs streamed per urgent policy for --verifier-lanes", 2000 };
+  const command_line::arg_descriptor<std::size_t> arg_verifier_lanes_urgent_every = { "verifier-lanes-urgent-every", "Send every Nth tx to the urgent lane for --verifier-lanes (0 = none)", 20 };
+  const command_line::arg_descriptor<std::size_t> arg_verifier_lanes_interval_us = { "verifier-lanes-interval-us", "Time between added txs for --verifier-lanes (0 = back to back)", 200 };
+  const command_line::arg_descriptor<std::size_t> arg_verifier_lanes_bulk_points = { "verifier-lanes-bulk-points", "Bulk batch multiexp point limit for --verifier-lanes (0 = none)", 65536 };
+  const command_line::arg_descriptor<std::size_t> arg_verifier_lanes_bulk_delay_ms = { "verifier-lanes-bulk-delay-ms", "Bulk batch deadline for --verifier-lanes", 100 };
+  const command_line::arg_descriptor<bool> arg_tx_pool = { "tx-pool", "Submit squashed Seraphis mock txs and conflicting copies of them to a mock tx pool from several threads, report submissions and admissions per second, and exit", false };
+  const command_line::arg_descriptor<std::size_t> arg_tx_pool_submitters = { "tx-pool-submitters", "Submitting threads for --tx-pool (each submits every tx once)", 4 };
+  const command_line::arg_descriptor<std::size_t> arg_tx_pool_interval_us = { "tx-pool-interval-us", "Time between a thread's submissions for --tx-pool (0 = back to back)", 100 };
+  const command_line::arg_descriptor<std::size_t> arg_tx_pool_batch_points = { "tx-pool-batch-points", "Batch verification multiexp point limit for --tx-pool (0 = none)", 65536 };
+  const command_line::arg_descriptor<std::size_t> arg_tx_pool_batch_delay_ms = { "tx-pool-batch-delay-ms", "Batch verification deadline for --tx-pool", 50 };
+  const command_line::arg_descriptor<bool> arg_numa_scaling = { "numa-scaling", "Validate squashed Seraphis mock tx batches on every CPU of 1, 2, ... NUMA nodes, with threads unpinned and pinned to their nodes (node-local generator tables and enote caches), report throughput and cross-node scaling, and exit", false };
+  const command_line::arg_descriptor<std::size_t> arg_numa_scaling_seconds = { "numa-scaling-seconds", "Duration of each --numa-scaling point", 5 };
+  const command_line::arg_descriptor<bool> arg_batch_saturation = { "batch-saturation", "For each mock tx type and --sweep point (or built-in 2-in/2-out points with 2^4 and 2^7 ref sets), search for the batch size where per-tx verification cost flattens out, print the curve and the knee, and exit", false };
+  const command_line::arg_descriptor<double> arg_batch_saturation_threshold = { "batch-saturation-threshold", "Per-tx saving (percent) of a doubled batch below which --batch-saturation considers the cost flat", 5 };
+  const command_line::arg_descriptor<std::size_t> arg_batch_saturation_max_batch = { "batch-saturation-max-batch", "Largest batch size --batch-saturation measures", 256 };
+  const command_line::arg_descriptor<std::size_t> arg_batch_saturation_reps = { "batch-saturation-reps", "Runs per batch size for --batch-saturation (the fastest one is used)", 3 };
+  const command_line::arg_descriptor<bool> arg_check_mock_tx_cost_model = { "check-mock-tx-cost-model", "Compare each --sweep point's mock tx verification time with the verification cost model's estimate, fit the model's per-op costs and exit", false };
+  const command_line::arg_descriptor<std::size_t> arg_check_mock_tx_cost_model_reps = { "check-mock-tx-cost-model-reps", "Runs per sweep point for --check-mock-tx-cost-model (the fastest one is used)", 5 };
   command_line::add_arg(desc_options, arg_filter);
   command_line::add_arg(desc_options, arg_verbose);
   command_line::add_arg(desc_options, arg_stats);
   command_line::add_arg(desc_options, arg_loop_multiplier);
+  command_line::add_arg(desc_options, arg_threads);
+  command_line::add_arg(desc_options, arg_pin_cpu);
+  command_line::add_arg(desc_options, arg_warm_up_ms);
+  command_line::add_arg(desc_options, arg_latency_histogram);
+  command_line::add_arg(desc_options, arg_latency_histogram_dir);
+  command_line::add_arg(desc_options, arg_cold_cache);
+  command_line::add_arg(desc_options, arg_cold_cache_mb);
+  command_line::add_arg(desc_options, arg_perf_counters);
+  command_line::add_arg(desc_options, arg_track_allocations);
   command_line::add_arg(desc_options, arg_timings_database);
+  command_line::add_arg(desc_options, arg_timings_store);
+  command_line::add_arg(desc_options, arg_timings_store_export);
+  command_line::add_arg(desc_options, arg_timings_store_since);
+  command_line::add_arg(desc_options, arg_timings_store_until);
+  command_line::add_arg(desc_options, arg_compare);
+  command_line::add_arg(desc_options, arg_regression_threshold);
+  command_line::add_arg(desc_options, arg_results_file);
+  command_line::add_arg(desc_options, arg_results_format);
+  command_line::add_arg(desc_options, arg_huge_pages);
+  command_line::add_arg(desc_options, arg_mock_ledger_dir);
+  command_line::add_arg(desc_options, arg_mock_ledger_enotes);
+  command_line::add_arg(desc_options, arg_reuse_mock_txs);
+  command_line::add_arg(desc_options, arg_mock_tx_fixture_dir);
+  command_line::add_arg(desc_options, arg_mock_ledger_straus_cache);
+  command_line::add_arg(desc_options, arg_mock_tx_build_threads);
+  command_line::add_arg(desc_options, arg_mock_tx_fixture_workers);
+  command_line::add_arg(desc_options, arg_mock_tx_ref_set_bin_size);
+  command_line::add_arg(desc_options, arg_mock_tx_gamma_decoys);
+  command_line::add_arg(desc_options, arg_mock_tx_from_blobs);
+  command_line::add_arg(desc_options, arg_mock_tx_phase_timings);
+  command_line::add_arg(desc_options, arg_mock_tx_prove);
+  command_line::add_arg(desc_options, arg_mock_tx_warm_hp_cache);
+  const command_line::arg_descriptor<std::string> arg_pippenger_profile = { "pippenger-profile", "Use the pippenger window sizes in this profile (see --calibrate-pippenger)" };
+  const command_line::arg_descriptor<std::string> arg_calibrate_pippenger = { "calibrate-pippenger", "Time every pippenger window size over a range of N, write the best ones to this profile file and exit" };
+  const command_line::arg_descriptor<std::size_t> arg_calibrate_pippenger_max_points = { "calibrate-pippenger-max-points", "Largest N for --calibrate-pippenger", 16384 };
+  const command_line::arg_descriptor<std::string> arg_multiexp_profile = { "multiexp-profile", "Use the multiexp algorithm crossovers in this profile (see --calibrate-multiexp)" };
+  const command_line::arg_descriptor<std::string> arg_calibrate_multiexp = { "calibrate-multiexp", "Time bos-coster, straus and pippenger (with and without caches) over a range of N, write the crossovers to this profile file and exit" };
+  const command_line::arg_descriptor<std::size_t> arg_calibrate_multiexp_max_points = { "calibrate-multiexp-max-points", "Largest N for --calibrate-multiexp", 4096 };
+  command_line::add_arg(desc_options, arg_sweep);
+  command_line::add_arg(desc_options, arg_memory_footprint);
+  command_line::add_arg(desc_options, arg_memory_footprint_max_enotes);
+  command_line::add_arg(desc_options, arg_memory_footprint_max_txs);
+  command_line::add_arg(desc_options, arg_ledger_stress);
+  command_line::add_arg(desc_options, arg_ledger_stress_readers);
+  command_line::add_arg(desc_options, arg_ledger_stress_writer_interval_us);
+  command_line::add_arg(desc_options, arg_ledger_stress_seconds);
+  command_line::add_arg(desc_options, arg_mock_block);
+  command_line::add_arg(desc_options, arg_mock_block_count);
+  command_line::add_arg(desc_options, arg_mock_block_txs);
+  command_line::add_arg(desc_options, arg_mock_block_tx_shapes);
+  command_line::add_arg(desc_options, arg_mock_block_threads);
+  command_line::add_arg(desc_options, arg_enote_file_reads_dir);
+  command_line::add_arg(desc_options, arg_enote_file_reads_enotes);
+  command_line::add_arg(desc_options, arg_enote_file_reads_batches);
+  command_line::add_arg(desc_options, arg_enote_file_reads_ref_sets);
+  command_line::add_arg(desc_options, arg_verifier_lanes);
+  command_line::add_arg(desc_options, arg_verifier_lanes_txs);
+  command_line::add_arg(desc_options, arg_verifier_lanes_urgent_every);
+  command_line::add_arg(desc_options, arg_verifier_lanes_interval_us);
+  command_line::add_arg(desc_options, arg_verifier_lanes_bulk_points);
+  command_line::add_arg(desc_options, arg_verifier_lanes_bulk_delay_ms);
+  command_line::add_arg(desc_options, arg_tx_pool);
+  command_line::add_arg(desc_options, arg_tx_pool_submitters);
+  command_line::add_arg(desc_options, arg_tx_pool_interval_us);
+  command_line::add_arg(desc_options, arg_tx_pool_batch_points);
+  command_line::add_arg(desc_options, arg_tx_pool_batch_delay_ms);
+  command_line::add_arg(desc_options, arg_numa_scaling);
+  command_line::add_arg(desc_options, arg_numa_scaling_seconds);
+  command_line::add_arg(desc_options, arg_batch_saturation);
+  command_line::add_arg(desc_options, arg_batch_saturation_threshold);
+  command_line::add_arg(desc_options, arg_batch_saturation_max_batch);
+  command_line::add_arg(desc_options, arg_batch_saturation_reps);
+  command_line::add_arg(desc_options, arg_check_mock_tx_cost_model);
+  command_line::add_arg(desc_options, arg_check_mock_tx_cost_model_reps);
+  command_line::add_arg(desc_options, arg_pippenger_profile);
+  command_line::add_arg(desc_options, arg_calibrate_pippenger);
+  command_line::add_arg(desc_options, arg_calibrate_pippenger_max_points);
+  command_line::add_arg(desc_options, arg_multiexp_profile);
+  command_line::add_arg(desc_options, arg_calibrate_multiexp);
+  command_line::add_arg(desc_options, arg_calibrate_multiexp_max_points);
 
   po::variables_map vm;
   bool r = command_line::handle_error_helper(desc_options, [&]()
@@ -108,12 +290,169 @@ int main(int argc, char** argv)
 
   const std::string filter = tools::glob_to_regex(command_line::get_arg(vm, arg_filter));
   const std::string timings_database = command_line::get_arg(vm, arg_timings_database);
+  const std::string timings_store = command_line::get_arg(vm, arg_timings_store);
+  const bool compare = command_line::get_arg(vm, arg_compare);
+  if (compare && timings_database.empty() && timings_store.empty())
+  {
+    std::cout << "--compare needs --timings-store or --timings-database" << std::endl;
+    return 1;
+  }
   ParamsShuttle p;
   if (!timings_database.empty())
-    p.core_params.td = std::make_shared<TimingsDatabase>(timings_database);
+    p.core_params.td = std::make_shared<TimingsDatabase>(timings_database, compare && timings_store.empty());
+  if (!timings_store.empty())
+  {
+    p.core_params.timings_store = std::make_shared<PerfTimingsStore>(timings_store);
+    if (!p.core_params.timings_store->good())
+    {
+      std::cout << "Failed to open --timings-store: " << timings_store << std::endl;
+      return 1;
+    }
+  }
+
+  const std::string timings_store_export = command_line::get_arg(vm, arg_timings_store_export);
+  if (!timings_store_export.empty())
+  {
+    if (!p.core_params.timings_store)
+    {
+      std::cout << "--timings-store-export needs --timings-store" << std::endl;
+      return 1;
+    }
+
+    std::ofstream export_file(timings_store_export);
+    const boost::regex filter_regex(filter.empty() ? std::string{".*"} : filter);
+    const size_t num_exported{p.core_params.timings_store->export_csv(export_file,
+      [&filter_regex](const std::string &test_name){ return boost::regex_match(test_name, filter_regex); },
+      command_line::get_arg(vm, arg_timings_store_since),
+      command_line::get_arg(vm, arg_timings_store_until))};
+    if (!export_file.good())
+    {
+      std::cout << "Failed to write --timings-store-export file: " << timings_store_export << std::endl;
+      return 1;
+    }
+    std::cout << "Exported " << num_exported << " of " << p.core_params.timings_store->size() << " records" << std::endl;
+    return 0;
+  }
+  if (compare)
+  {
+    p.core_params.regressions = std::make_shared<PerfRegressions>();
+    p.core_params.regressions->threshold_percent = command_line::get_arg(vm, arg_regression_threshold);
+  }
   p.core_params.verbose = command_line::get_arg(vm, arg_verbose);
   p.core_params.stats = command_line::get_arg(vm, arg_stats);
   p.core_params.loop_multiplier = command_line::get_arg(vm, arg_loop_multiplier);
+  p.core_params.threads = command_line::get_arg(vm, arg_threads);
+  p.core_params.warm_up_ms = command_line::get_arg(vm, arg_warm_up_ms);
+  p.core_params.latency_histogram_dir = command_line::get_arg(vm, arg_latency_histogram_dir);
+  p.core_params.latency_histogram = command_line::get_arg(vm, arg_latency_histogram) ||
+    !p.core_params.latency_histogram_dir.empty();
+  p.core_params.perf_counters = command_line::get_arg(vm, arg_perf_counters);
+
+  const std::string cold_cache = command_line::get_arg(vm, arg_cold_cache);
+  if (!parse_cold_cache_mode(cold_cache, p.core_params.cold_cache))
+  {
+    std::cout << "Invalid --cold-cache: " << cold_cache << " (expected off, on or both)" << std::endl;
+    return 1;
+  }
+  if (p.core_params.cold_cache != ColdCacheMode::HOT)
+  {
+    // concurrent test instances share the last level cache, so evicting it for one would evict it for all
+    if (p.core_params.threads > 1)
+    {
+      std::cout << "--cold-cache needs a single-threaded run (--threads 1)" << std::endl;
+      return 1;
+    }
+
+    p.core_params.cache_evictor =
+      std::make_shared<CacheEvictor>(command_line::get_arg(vm, arg_cold_cache_mb) << 20);
+    if (p.core_params.verbose)
+      std::cout << "Cold-cache mode: evicting with a " << (p.core_params.cache_evictor->scratch_bytes() >> 20)
+        << " MiB scratch buffer" << std::endl;
+  }
+
+  if (p.core_params.perf_counters && !PerfCounterGroup{}.available())
+    std::cout << "Warning: hardware counters are unavailable (check /proc/sys/kernel/perf_event_paranoid)" << std::endl;
+
+  p.core_params.track_allocations = command_line::get_arg(vm, arg_track_allocations);
+  if (p.core_params.track_allocations && !AllocationTracker::available())
+    std::cout << "Warning: allocation tracking is unavailable on this platform" << std::endl;
+
+  const std::string huge_pages = command_line::get_arg(vm, arg_huge_pages);
+  if (huge_pages != "off" && huge_pages != "thp" && huge_pages != "hugetlb")
+  {
+    std::cout << "Invalid --huge-pages: " << huge_pages << std::endl;
+    return 1;
+  }
+  if (aligned_set_huge_pages(huge_pages == "hugetlb" ? ALIGNED_HUGE_PAGES_HUGETLB :
+      huge_pages == "thp" ? ALIGNED_HUGE_PAGES_THP : ALIGNED_HUGE_PAGES_OFF) != 0)
+    std::cout << "Warning: huge pages are unavailable on this platform" << std::endl;
+
+  const std::string results_file = command_line::get_arg(vm, arg_results_file);
+  if (!results_file.empty())
+  {
+    const std::string results_format = command_line::get_arg(vm, arg_results_format);
+    if (results_format != "json" && results_format != "csv")
+    {
+      std::cout << "Unknown --results-format: " << results_format << " (expected json or csv)" << std::endl;
+      return 1;
+    }
+
+    p.core_params.results = std::make_shared<PerfResultsSink>(results_file,
+      results_format == "csv" ? PerfResultsSink::Format::CSV : PerfResultsSink::Format::JSON);
+    if (!p.core_params.results->good())
+    {
+      std::cout << "Failed to open --results-file: " << results_file << std::endl;
+      return 1;
+    }
+  }
+
+  // load sweeps up front, so a bad file fails before any test runs
+  std::vector<MockTxSweep> sweeps;
+  const std::string sweep_file = command_line::get_arg(vm, arg_sweep);
+  if (!sweep_file.empty())
+  {
+    std::string sweep_error;
+    if (!load_mock_tx_sweeps(sweep_file, sweeps, sweep_error))
+    {
+      std::cout << "Failed to load --sweep file " << sweep_file << ": " << sweep_error << std::endl;
+      return 1;
+    }
+  }
+
+  const std::string pippenger_profile = command_line::get_arg(vm, arg_pippenger_profile);
+  if (!pippenger_profile.empty() && !rct::load_pippenger_c_profile(pippenger_profile))
+  {
+    std::cout << "Failed to load --pippenger-profile " << pippenger_profile << std::endl;
+    return 1;
+  }
+
+  const std::string multiexp_profile = command_line::get_arg(vm, arg_multiexp_profile);
+  if (!multiexp_profile.empty() && !rct::load_multiexp_crossovers(multiexp_profile))
+  {
+    std::cout << "Failed to load --multiexp-profile " << multiexp_profile << std::endl;
+    return 1;
+  }
+
+  // pin to one core for single-threaded timings (threads inherit the affinity, so in throughput mode only the runner
+  //   threads are pinned, and only if asked to)
+  const int pin_cpu = command_line::get_arg(vm, arg_pin_cpu);
+  if (p.core_params.threads <= 1 && pin_cpu >= 0)
+    set_process_affinity(pin_cpu);
+  else if (p.core_params.threads > 1 && !command_line::is_arg_defaulted(vm, arg_pin_cpu))
+    p.core_params.pin_cpu = pin_cpu;
+
+  const std::string calibration_profile = command_line::get_arg(vm, arg_calibrate_pippenger);
+  if (!calibration_profile.empty())
+  {
+    return calibrate_pippenger(calibration_profile, command_line::get_arg(vm, arg_calibrate_pippenger_max_points)) ? 0 : 1;
+  }
+
+  const std::string multiexp_calibration_profile = command_line::get_arg(vm, arg_calibrate_multiexp);
+  if (!multiexp_calibration_profile.empty())
+  {
+    return calibrate_multiexp(multiexp_calibration_profile,
+      command_line::get_arg(vm, arg_calibrate_multiexp_max_points)) ? 0 : 1;
+  }
 
   performance_timer timer;
   timer.start();
@@ -143,6 +482,49 @@ int main(int argc, char** argv)
   TEST_PERFORMANCE6(filter, p, test_grootle, 8, 5, 10, 2, 0, 4);
   TEST_PERFORMANCE5(filter, p, test_concise_grootle, 8, 5, 10, 2, 0);
 
+  // shared ref sets (batching): 10 proofs that all reference the same set
+  TEST_PERFORMANCE6(filter, p, test_concise_grootle, 2, 7, 10, 2, 0, true);
+  TEST_PERFORMANCE6(filter, p, test_concise_grootle, 8, 5, 10, 2, 0, true);
+
+  // fixed-size proofs (compile-time decomposition) vs dynamic proofs
+  TEST_PERFORMANCE5(filter, p, test_concise_grootle, 2, 7, 10, 2, 0);
+  TEST_PERFORMANCE4(filter, p, test_concise_grootle_fixed, 2, 7, 10, 2);
+  TEST_PERFORMANCE5(filter, p, test_concise_grootle, 3, 5, 10, 2, 0);
+  TEST_PERFORMANCE4(filter, p, test_concise_grootle_fixed, 3, 5, 10, 2);
+  TEST_PERFORMANCE5(filter, p, test_concise_grootle, 8, 3, 10, 2, 0);
+  TEST_PERFORMANCE4(filter, p, test_concise_grootle_fixed, 8, 3, 10, 2);
+
+  // aggregated multi-input proofs vs one proof per input: 2^7, 2 keys, 1/2/4/8 inputs
+  TEST_PERFORMANCE4(filter, p, test_concise_grootle_aggregate, 2, 7, 1, 2);
+  TEST_PERFORMANCE5(filter, p, test_concise_grootle, 2, 7, 2, 2, 0);
+  TEST_PERFORMANCE4(filter, p, test_concise_grootle_aggregate, 2, 7, 2, 2);
+  TEST_PERFORMANCE5(filter, p, test_concise_grootle, 2, 7, 4, 2, 0);
+  TEST_PERFORMANCE4(filter, p, test_concise_grootle_aggregate, 2, 7, 4, 2);
+  TEST_PERFORMANCE5(filter, p, test_concise_grootle, 2, 7, 8, 2, 0);
+  TEST_PERFORMANCE4(filter, p, test_concise_grootle_aggregate, 2, 7, 8, 2);
+
+  // single-proof latency over very large ref sets (2^12, 2^16) vs thread count
+  TEST_PERFORMANCE3(filter, p, test_concise_grootle_threads, 2, 12, 1);
+  TEST_PERFORMANCE3(filter, p, test_concise_grootle_threads, 2, 12, 2);
+  TEST_PERFORMANCE3(filter, p, test_concise_grootle_threads, 2, 12, 4);
+  TEST_PERFORMANCE3(filter, p, test_concise_grootle_threads, 2, 12, 0);
+  TEST_PERFORMANCE3(filter, p, test_concise_grootle_threads, 2, 16, 1);
+  TEST_PERFORMANCE3(filter, p, test_concise_grootle_threads, 2, 16, 2);
+  TEST_PERFORMANCE3(filter, p, test_concise_grootle_threads, 2, 16, 4);
+  TEST_PERFORMANCE3(filter, p, test_concise_grootle_threads, 2, 16, 0);
+
+  // verification data assembly, with and without recycling the multiexp data (compare with --track-allocations)
+  TEST_PERFORMANCE5(filter, p, test_concise_grootle_verification_data, 2, 7, 10, 2, false);
+  TEST_PERFORMANCE5(filter, p, test_concise_grootle_verification_data, 2, 7, 10, 2, true);
+
+  // batch weight sizes (bytes): 8 (64-bit), 16 (default, 128-bit), 32 (full scalars)
+  TEST_PERFORMANCE5(filter, p, test_concise_grootle_weighting, 2, 7, 10, 2, 8);
+  TEST_PERFORMANCE5(filter, p, test_concise_grootle_weighting, 2, 7, 10, 2, 16);
+  TEST_PERFORMANCE5(filter, p, test_concise_grootle_weighting, 2, 7, 10, 2, 32);
+  TEST_PERFORMANCE3(filter, p, test_bulletproof_plus_weighting, 16, 2, 8);
+  TEST_PERFORMANCE3(filter, p, test_bulletproof_plus_weighting, 16, 2, 16);
+  TEST_PERFORMANCE3(filter, p, test_bulletproof_plus_weighting, 16, 2, 32);
+
 
 
 
@@ -163,6 +545,45 @@ int main(int argc, char** argv)
   TEST_PERFORMANCE0(filter, p_view_hash, test_view_scan_hash_cnhash);
   TEST_PERFORMANCE0(filter, p_view_hash, test_view_scan_hash_b2bhash);
 
+  // view scan over a mapped enote stream: columns scanned in place vs copied into scan records
+  ParamsShuttleViewScanEnoteStream p_view_scan_stream;
+  p_view_scan_stream.core_params = p.core_params;
+  for (const bool zero_copy : {false, true})
+  {
+    p_view_scan_stream.zero_copy = zero_copy;
+    TEST_PERFORMANCE0(filter, p_view_scan_stream, test_view_scan_enote_stream);
+  }
+
+  // /get_blocks.bin responses: generic serialization vs blobs written in place
+  TEST_PERFORMANCE4(filter, p, test_get_blocks_bin, 100, 20, false, false);
+  TEST_PERFORMANCE4(filter, p, test_get_blocks_bin, 100, 20, false, true);
+  TEST_PERFORMANCE4(filter, p, test_get_blocks_bin, 100, 20, true, false);
+  TEST_PERFORMANCE4(filter, p, test_get_blocks_bin, 100, 20, true, true);
+
+  // /get_transaction_pool json responses: portable_storage tree vs streamed
+  TEST_PERFORMANCE2(filter, p, test_rpc_json_response, 1000, false);
+  TEST_PERFORMANCE2(filter, p, test_rpc_json_response, 1000, true);
+
+  // portable_storage binary parsing of p2p and RPC payloads
+  TEST_PERFORMANCE1(filter, p, test_portable_storage_load, false);
+  TEST_PERFORMANCE1(filter, p, test_portable_storage_load, true);
+
+  // tools::threadpool dispatch overhead
+  TEST_PERFORMANCE1(filter, p, test_threadpool_dispatch, 1000);
+  TEST_PERFORMANCE1(filter, p, test_threadpool_dispatch, 100000);
+  TEST_PERFORMANCE2(filter, p, test_threadpool_nested_parallel_for, 16, 256);
+  TEST_PERFORMANCE2(filter, p, test_threadpool_nested_parallel_for, 256, 16);
+
+  // pool tx lookups for fluffy block reconstruction, by blob or from the parsed tx index
+  TEST_PERFORMANCE2(filter, p, test_fluffy_reconstruction, 100, false);
+  TEST_PERFORMANCE2(filter, p, test_fluffy_reconstruction, 100, true);
+  TEST_PERFORMANCE2(filter, p, test_fluffy_reconstruction, 1000, false);
+  TEST_PERFORMANCE2(filter, p, test_fluffy_reconstruction, 1000, true);
+
+  // binary archive parsing of a block and its txes
+  TEST_PERFORMANCE2(filter, p, test_block_parse, 100, 11);
+  TEST_PERFORMANCE2(filter, p, test_block_parse, 100, 16);
+
   // test done, save results
   if (p.core_params.td.get())
     p.core_params.td->save(false);
@@ -178,6 +599,70 @@ int main(int argc, char** argv)
   p_view_scan.test_view_tag_check = true;
   TEST_PERFORMANCE0(filter, p_view_scan, test_view_scan_sp);
   TEST_PERFORMANCE0(filter, p, test_view_scan_sp_siphash);
+  p_view_scan.view_tag_hash = mock_tx::SpViewTagHash::SIPHASH;
+  TEST_PERFORMANCE0(filter, p_view_scan, test_view_scan_sp);
+  p_view_scan.view_tag_hash = mock_tx::SpViewTagHash::HALFSIPHASH;
+  TEST_PERFORMANCE0(filter, p_view_scan, test_view_scan_sp);
+
+  ParamsShuttleViewScanTagWidth p_view_scan_tag_width;
+  p_view_scan_tag_width.core_params = p.core_params;
+  for (const std::size_t view_tag_bytes : {1, 2, 3, 4})
+  {
+    p_view_scan_tag_width.view_tag_bytes = view_tag_bytes;
+    TEST_PERFORMANCE0(filter, p_view_scan_tag_width, test_view_scan_sp_tag_width);
+  }
+
+  ParamsShuttleViewScanBatch p_view_scan_batch;
+  p_view_scan_batch.core_params = p.core_params;
+  TEST_PERFORMANCE0(filter, p_view_scan_batch, test_view_scan_sp_batch);  // 1024 enotes, 1/16 owned, serial
+  p_view_scan_batch.hit_interval = 0;
+  TEST_PERFORMANCE0(filter, p_view_scan_batch, test_view_scan_sp_batch);  // 1024 enotes, none owned, serial
+  p_view_scan_batch.num_threads = 0;
+  p_view_scan_batch.num_enotes = 8192;
+  TEST_PERFORMANCE0(filter, p_view_scan_batch, test_view_scan_sp_batch);  // 8192 enotes, none owned, all cores
+
+  // amount recovery for owned enotes: batched commitment check vs one enote at a time
+  ParamsShuttleAmountRecovery p_amount_recovery;
+  p_amount_recovery.core_params = p.core_params;
+  for (const bool batched : {false, true})
+  {
+    p_amount_recovery.batched = batched;
+    TEST_PERFORMANCE0(filter, p_amount_recovery, test_amount_recovery_sp);
+  }
+
+  // batched payout outputs: recipients' precomputed tables vs variable-base scalarmults
+  ParamsShuttlePayoutOutputs p_payout_outputs;
+  p_payout_outputs.core_params = p.core_params;
+  for (const bool recipient_precomp : {false, true})
+  {
+    p_payout_outputs.recipient_precomp = recipient_precomp;
+    TEST_PERFORMANCE0(filter, p_payout_outputs, test_payout_outputs_sp);
+  }
+
+  // multi-account view scan: shared per-enote tables vs separate per-account scans
+  ParamsShuttleViewScanMultiAccount p_view_scan_multi;
+  p_view_scan_multi.core_params = p.core_params;
+  for (const std::size_t num_accounts : {1, 16, 256})
+  {
+    p_view_scan_multi.num_accounts = num_accounts;
+    p_view_scan_multi.shared_precompute = false;
+    TEST_PERFORMANCE0(filter, p_view_scan_multi, test_view_scan_sp_multi_account);
+    p_view_scan_multi.shared_precompute = true;
+    TEST_PERFORMANCE0(filter, p_view_scan_multi, test_view_scan_sp_multi_account);
+  }
+
+  // parallel view scan scaling: 1 to 64 threads, cryptonote then seraphis
+  ParamsShuttleViewScanParallel p_view_scan_parallel;
+  p_view_scan_parallel.core_params = p.core_params;
+  for (const bool seraphis : {false, true})
+  {
+    p_view_scan_parallel.seraphis = seraphis;
+    for (const std::size_t num_threads : {1, 2, 4, 8, 16, 32, 64})
+    {
+      p_view_scan_parallel.num_threads = num_threads;
+      TEST_PERFORMANCE0(filter, p_view_scan_parallel, test_view_scan_parallel);
+    }
+  }
 
   // test done, save results
   if (p.core_params.td.get())
@@ -222,6 +707,191 @@ int main(int argc, char** argv)
   MockTxPerfIncrementer incrementer;
   ParamsShuttleMockTx p_mock_tx;
   p_mock_tx.core_params = p.core_params;
+  p_mock_tx.ledger_dir = command_line::get_arg(vm, arg_mock_ledger_dir);
+  p_mock_tx.ledger_num_enotes = command_line::get_arg(vm, arg_mock_ledger_enotes);
+  p_mock_tx.reuse_txs = command_line::get_arg(vm, arg_reuse_mock_txs);
+  p_mock_tx.fixture_dir = command_line::get_arg(vm, arg_mock_tx_fixture_dir);
+  p_mock_tx.ledger_straus_cache_points = command_line::get_arg(vm, arg_mock_ledger_straus_cache);
+  p_mock_tx.build_threads = command_line::get_arg(vm, arg_mock_tx_build_threads);
+  p_mock_tx.fixture_workers = command_line::get_arg(vm, arg_mock_tx_fixture_workers);
+  p_mock_tx.ref_set_bin_size = command_line::get_arg(vm, arg_mock_tx_ref_set_bin_size);
+  p_mock_tx.gamma_decoys = command_line::get_arg(vm, arg_mock_tx_gamma_decoys);
+  p_mock_tx.from_blobs = command_line::get_arg(vm, arg_mock_tx_from_blobs);
+  p_mock_tx.phase_timings = command_line::get_arg(vm, arg_mock_tx_phase_timings);
+  p_mock_tx.prove = command_line::get_arg(vm, arg_mock_tx_prove);
+  p_mock_tx.warm_hp_cache = command_line::get_arg(vm, arg_mock_tx_warm_hp_cache);
+  if (p_mock_tx.phase_timings && !mock_tx::mock_tx_phase_timers_enabled())
+    std::cout << "Warning: --mock-tx-phase-timings needs a build with -DMOCK_TX_PHASE_TIMERS=ON, ignoring it" << std::endl;
+
+  // gamma decoys are picked from the on-disk ledger's pre-populated enotes
+  if (p_mock_tx.gamma_decoys && (p_mock_tx.ledger_dir.empty() || p_mock_tx.ledger_num_enotes == 0))
+  {
+    std::cout << "--mock-tx-gamma-decoys needs --mock-ledger-dir and --mock-ledger-enotes" << std::endl;
+    return 1;
+  }
+
+  // an LMDB environment can't be opened more than once per process, so concurrent test instances can't share one
+  if (p.core_params.threads > 1 && !p_mock_tx.ledger_dir.empty())
+  {
+    std::cout << "--mock-ledger-dir can't be used with --threads > 1" << std::endl;
+    return 1;
+  }
+
+  // concurrent test instances would write the same fixture files
+  if (p.core_params.threads > 1 && !p_mock_tx.fixture_dir.empty())
+  {
+    std::cout << "--mock-tx-fixture-dir can't be used with --threads > 1" << std::endl;
+    return 1;
+  }
+
+  // memory footprint of mock ledgers and txs (2-in/2-out txs with 2^7 ref sets; the other mock tx options apply)
+  if (command_line::get_arg(vm, arg_memory_footprint))
+  {
+    ParamsShuttleMockTx p_footprint{p_mock_tx};
+    p_footprint.in_count = 2;
+    p_footprint.out_count = 2;
+    p_footprint.n = 2;
+    p_footprint.m = 7;
+
+    return report_mock_memory_footprint(p_footprint,
+        command_line::get_arg(vm, arg_memory_footprint_max_enotes),
+        command_line::get_arg(vm, arg_memory_footprint_max_txs)) ? 0 : 1;
+  }
+
+  // concurrent validation against one shared ledger (batches of 8 2-in/2-out txs with 2^7 ref sets; the other mock tx
+  //   options apply)
+  if (command_line::get_arg(vm, arg_ledger_stress))
+  {
+    ParamsShuttleMockTx p_stress{p_mock_tx};
+    p_stress.batch_size = 8;
+    p_stress.in_count = 2;
+    p_stress.out_count = 2;
+    p_stress.n = 2;
+    p_stress.m = 7;
+
+    return run_mock_ledger_stress<mock_tx::MockTxSpSquashedV1>(p_stress,
+        command_line::get_arg(vm, arg_ledger_stress_readers),
+        command_line::get_arg(vm, arg_ledger_stress_writer_interval_us),
+        command_line::get_arg(vm, arg_ledger_stress_seconds)) ? 0 : 1;
+  }
+
+  // ref set reads from disk (2^7 ref sets)
+  const std::string enote_file_reads_dir{command_line::get_arg(vm, arg_enote_file_reads_dir)};
+  if (!enote_file_reads_dir.empty())
+  {
+    return run_mock_enote_file_reads(enote_file_reads_dir,
+        command_line::get_arg(vm, arg_enote_file_reads_enotes),
+        command_line::get_arg(vm, arg_enote_file_reads_batches),
+        command_line::get_arg(vm, arg_enote_file_reads_ref_sets),
+        128) ? 0 : 1;
+  }
+
+  // batch verifier lanes (a pool of 16 2-in/2-out txs with 2^7 ref sets; the other mock tx options apply)
+  if (command_line::get_arg(vm, arg_verifier_lanes))
+  {
+    ParamsShuttleMockTx p_lanes{p_mock_tx};
+    p_lanes.batch_size = 16;
+    p_lanes.in_count = 2;
+    p_lanes.out_count = 2;
+    p_lanes.n = 2;
+    p_lanes.m = 7;
+
+    return run_mock_tx_verifier_lanes<mock_tx::MockTxSpSquashedV1>(p_lanes,
+        command_line::get_arg(vm, arg_verifier_lanes_txs),
+        command_line::get_arg(vm, arg_verifier_lanes_urgent_every),
+        command_line::get_arg(vm, arg_verifier_lanes_interval_us),
+        command_line::get_arg(vm, arg_verifier_lanes_bulk_points),
+        command_line::get_arg(vm, arg_verifier_lanes_bulk_delay_ms)) ? 0 : 1;
+  }
+
+  // mock tx pool admission (a pool of 256 2-in/2-out txs with 2^7 ref sets; the other mock tx options apply)
+  if (command_line::get_arg(vm, arg_tx_pool))
+  {
+    ParamsShuttleMockTx p_pool{p_mock_tx};
+    p_pool.batch_size = 256;
+    p_pool.in_count = 2;
+    p_pool.out_count = 2;
+    p_pool.n = 2;
+    p_pool.m = 7;
+
+    return run_mock_tx_pool_admission<mock_tx::MockTxSpSquashedV1>(p_pool,
+        command_line::get_arg(vm, arg_tx_pool_submitters),
+        command_line::get_arg(vm, arg_tx_pool_interval_us),
+        command_line::get_arg(vm, arg_tx_pool_batch_points),
+        command_line::get_arg(vm, arg_tx_pool_batch_delay_ms)) ? 0 : 1;
+  }
+
+  // end-to-end block verification (2^7 ref sets; the other mock tx options apply)
+  if (command_line::get_arg(vm, arg_mock_block))
+  {
+    ParamsShuttleMockTx p_block{p_mock_tx};
+    p_block.n = 2;
+    p_block.m = 7;
+    p_block.num_threads = command_line::get_arg(vm, arg_mock_block_threads);
+
+    std::vector<MockBlockTxShape> shapes{make_default_mock_block_tx_shapes()};
+    const std::string shapes_str{command_line::get_arg(vm, arg_mock_block_tx_shapes)};
+    if (!shapes_str.empty() && !parse_mock_block_tx_shapes(shapes_str, shapes))
+    {
+      std::cout << "Invalid --mock-block-tx-shapes: " << shapes_str << std::endl;
+      return 1;
+    }
+
+    return run_mock_block_verification(p_block,
+        shapes,
+        command_line::get_arg(vm, arg_mock_block_count),
+        command_line::get_arg(vm, arg_mock_block_txs)) ? 0 : 1;
+  }
+
+  // cross-node scaling (batches of 8 2-in/2-out txs with 2^7 ref sets; the other mock tx options apply)
+  if (command_line::get_arg(vm, arg_numa_scaling))
+  {
+    ParamsShuttleMockTx p_numa{p_mock_tx};
+    p_numa.batch_size = 8;
+    p_numa.in_count = 2;
+    p_numa.out_count = 2;
+    p_numa.n = 2;
+    p_numa.m = 7;
+
+    return run_mock_tx_numa_scaling<mock_tx::MockTxSpSquashedV1>(p_numa,
+        command_line::get_arg(vm, arg_numa_scaling_seconds)) ? 0 : 1;
+  }
+
+  // the batch saturation search picks its own batch sizes
+  if (command_line::get_arg(vm, arg_batch_saturation))
+  {
+    const std::vector<MockTxSweep> saturation_sweeps{
+        sweeps.empty() ? std::vector<MockTxSweep>{make_default_batch_saturation_sweep()} : sweeps
+      };
+
+    return find_mock_tx_batch_saturation(saturation_sweeps,
+        p_mock_tx,
+        command_line::get_arg(vm, arg_batch_saturation_reps),
+        command_line::get_arg(vm, arg_batch_saturation_threshold) / 100,
+        command_line::get_arg(vm, arg_batch_saturation_max_batch)) ? 0 : 1;
+  }
+
+  // the cost model check times the sweeps' txs itself
+  if (command_line::get_arg(vm, arg_check_mock_tx_cost_model))
+  {
+    if (sweeps.empty())
+    {
+      std::cout << "--check-mock-tx-cost-model needs --sweep" << std::endl;
+      return 1;
+    }
+
+    return check_mock_tx_cost_model(sweeps, p_mock_tx, command_line::get_arg(vm, arg_check_mock_tx_cost_model_reps)) ?
+      0 : 1;
+  }
+
+  // sweeps from a file replace the built-in mock tx test sets
+  if (!sweeps.empty())
+  {
+    run_mock_tx_sweeps(filter, sweeps, p_mock_tx);
+
+    std::cout << "Tests finished. Elapsed time: " << timer.elapsed_ms() / 1000 << " sec" << std::endl;
+    return report_regressions(p.core_params);
+  }
 
   //// TEST SET 4
   /// TEST 1: MockTxCLSAG
@@ -243,6 +913,146 @@ int main(int argc, char** argv)
   if (p.core_params.td.get())
     p.core_params.td->save(true);
 
+  //// TEST SET 5
+  /// TEST 1: MockTxSpSquashedV1 single tx admission latency
+  // This test set is for tail latencies of validating one tx at a time (run with --latency-histogram)
+
+  incrementer = {
+      {16}, //batch sizes (distinct txs admitted)
+      {0}, //rangeproof splits
+      {1, 2, 4}, //in counts
+      {2}, //out counts
+      {2}, //decomp n
+      {7} //decomp m limits
+    };
+  while (incrementer.next(p_mock_tx))
+  {
+    // only decomp 2^7
+    if (p_mock_tx.m == 7)
+      TEST_PERFORMANCE1(filter, p_mock_tx, test_mock_tx_admission, mock_tx::MockTxSpSquashedV1);
+  }
+  // test done, save results
+  if (p.core_params.td.get())
+    p.core_params.td->save(true);
+
+  /// TEST 2: unbatchable validation steps, statically vs virtually dispatched {Seraphis tx types}, 1-in/2-out
+  // (see test_mock_tx_unbatchable)
+
+  incrementer = {
+      {16}, //batch sizes
+      {0}, //rangeproof splits
+      {1}, //in counts
+      {2}, //out counts
+      {2}, //decomp n
+      {7} //decomp m limits
+    };
+  while (incrementer.next(p_mock_tx))
+  {
+    // only decomp 2^7
+    if (p_mock_tx.m == 7)
+    {
+      TEST_PERFORMANCE2(filter, p_mock_tx, test_mock_tx_unbatchable, mock_tx::MockTxSpConciseV1, false);
+      TEST_PERFORMANCE2(filter, p_mock_tx, test_mock_tx_unbatchable, mock_tx::MockTxSpConciseV1, true);
+      TEST_PERFORMANCE2(filter, p_mock_tx, test_mock_tx_unbatchable, mock_tx::MockTxSpSquashedV1, false);
+      TEST_PERFORMANCE2(filter, p_mock_tx, test_mock_tx_unbatchable, mock_tx::MockTxSpSquashedV1, true);
+    }
+  }
+  // test done, save results
+  if (p.core_params.td.get())
+    p.core_params.td->save(true);
+
+  /// TEST 3: per-input vs shared per-tx ref sets {Plain, Concise, Merge}, equal anonymity set size (2^7)
+  // (with a shared ref set, concise/merge membership proofs evaluate the ref set once per tx)
+
+  incrementer = {
+      {1, 16}, //batch sizes
+      {0}, //rangeproof splits
+      {2, 4, 8}, //in counts
+      {2}, //out counts
+      {2}, //decomp n
+      {7} //decomp m limits
+    };
+  while (incrementer.next(p_mock_tx))
+  {
+    // only decomp 2^7
+    if (p_mock_tx.m != 7)
+      continue;
+
+    for (const bool shared_ref_set : {false, true})
+    {
+      p_mock_tx.shared_ref_set = shared_ref_set;
+      TEST_PERFORMANCE1(filter, p_mock_tx, test_mock_tx, mock_tx::MockTxSpPlainV1);
+      TEST_PERFORMANCE1(filter, p_mock_tx, test_mock_tx, mock_tx::MockTxSpConciseV1);
+      TEST_PERFORMANCE1(filter, p_mock_tx, test_mock_tx, mock_tx::MockTxSpMergeV1);
+    }
+    p_mock_tx.shared_ref_set = false;
+  }
+  // test done, save results
+  if (p.core_params.td.get())
+    p.core_params.td->save(true);
+
+  //// TEST SET 6
+  /// TEST 1: Seraphis tx proving {tx types}
+  // This test set times making txs (ref sets and proofs), not validating them
+
+  incrementer = {
+      {1}, //batch sizes
+      {0}, //rangeproof splits
+      {2}, //in counts
+      {2}, //out counts
+      {2}, //decomp n
+      {7} //decomp m limits
+    };
+  while (incrementer.next(p_mock_tx))
+  {
+    // only decomp 2^7
+    if (p_mock_tx.m == 7)
+    {
+      TEST_PERFORMANCE1(filter, p_mock_tx, test_mock_tx_prove, mock_tx::MockTxSpConciseV1);
+      TEST_PERFORMANCE1(filter, p_mock_tx, test_mock_tx_prove, mock_tx::MockTxSpMergeV1);
+      TEST_PERFORMANCE1(filter, p_mock_tx, test_mock_tx_prove, mock_tx::MockTxSpPlainV1);
+      TEST_PERFORMANCE1(filter, p_mock_tx, test_mock_tx_prove, mock_tx::MockTxSpSquashedV1);
+    }
+  }
+
+  /// TEST 2: MockTxSpSquashedV1 proving {decomp 2-series}
+  incrementer = {
+      {1}, //batch sizes
+      {0}, //rangeproof splits
+      {2}, //in counts
+      {2}, //out counts
+      {2}, //decomp n
+      {10} //decomp m limits
+    };
+  while (incrementer.next(p_mock_tx))
+  {
+    // large m
+    if (p_mock_tx.m >= 6)
+      TEST_PERFORMANCE1(filter, p_mock_tx, test_mock_tx_prove, mock_tx::MockTxSpSquashedV1);
+  }
+
+  /// TEST 3: MockTxSpSquashedV1 proving {outputs, rangeproof splitting}
+  incrementer = {
+      {1}, //batch sizes
+      {0, 1, 2, 3}, //rangeproof splits
+      {2}, //in counts
+      {2, 16}, //out counts
+      {2}, //decomp n
+      {7} //decomp m limits
+    };
+  while (incrementer.next(p_mock_tx))
+  {
+    if (p_mock_tx.num_rangeproof_splits > (p_mock_tx.in_count + p_mock_tx.out_count)/2)
+      continue;
+
+    // only decomp 2^7
+    if (p_mock_tx.m == 7)
+      TEST_PERFORMANCE1(filter, p_mock_tx, test_mock_tx_prove, mock_tx::MockTxSpSquashedV1);
+  }
+  // test done, save results
+  if (p.core_params.td.get())
+    p.core_params.td->save(true);
+
   /*
   //// TEST SET 4
   /// TEST 1: MockTxCLSAG
@@ -1022,6 +1832,32 @@ int main(int argc, char** argv)
       TEST_PERFORMANCE1(filter, p_mock_tx, test_mock_tx, mock_tx::MockTxSpSquashedV1);
   }
   // test done, save results
+  if (p.core_params.td.get())
+    p.core_params.td->save(false);
+
+  // TEST 5.6: MockTxSpSquashedV1 {threads, batch size 25}
+  incrementer = {
+      {25}, //batch sizes
+      {0}, //rangeproof splits
+      {2}, //in counts
+      {2}, //out counts
+      {2}, //decomp n
+      {7} //decomp m limits
+    };
+  while (incrementer.next(p_mock_tx))
+  {
+    // only decomp 2^7
+    if (!(p_mock_tx.n >= 2 && p_mock_tx.m == 7))
+      continue;
+
+    for (const std::size_t num_threads : {1, 2, 4, 8})
+    {
+      p_mock_tx.num_threads = num_threads;
+      TEST_PERFORMANCE1(filter, p_mock_tx, test_mock_tx, mock_tx::MockTxSpSquashedV1);
+    }
+    p_mock_tx.num_threads = 1;
+  }
+  // test done, save results
   if (p.core_params.td.get())
     p.core_params.td->save(false);
   //// TEST SET 3 (end)
@@ -1770,12 +2606,26 @@ int main(int argc, char** argv)
   TEST_PERFORMANCE5(filter, p, test_construct_tx, 100, 2, true, rct::RangeProofPaddedBulletproof, 2);
   TEST_PERFORMANCE5(filter, p, test_construct_tx, 100, 10, true, rct::RangeProofPaddedBulletproof, 2);
 
+  // CLSAG sweeps: inputs (and single-output bulletproofs) are proven on the threadpool
+  TEST_PERFORMANCE5(filter, p, test_construct_tx, 16, 2, true, rct::RangeProofPaddedBulletproof, 3);
+  TEST_PERFORMANCE5(filter, p, test_construct_tx, 32, 2, true, rct::RangeProofPaddedBulletproof, 3);
+  TEST_PERFORMANCE5(filter, p, test_construct_tx, 64, 2, true, rct::RangeProofPaddedBulletproof, 3);
+  TEST_PERFORMANCE5(filter, p, test_construct_tx, 16, 16, true, rct::RangeProofBulletproof, 3);
+
   TEST_PERFORMANCE3(filter, p, test_check_tx_signature, 1, 2, false);
   TEST_PERFORMANCE3(filter, p, test_check_tx_signature, 2, 2, false);
   TEST_PERFORMANCE3(filter, p, test_check_tx_signature, 10, 2, false);
   TEST_PERFORMANCE3(filter, p, test_check_tx_signature, 100, 2, false);
   TEST_PERFORMANCE3(filter, p, test_check_tx_signature, 2, 10, false);
 
+  // pre-RingCT rings of a block: one call per ring vs one batched call
+  TEST_PERFORMANCE3(filter, p, test_check_ring_signatures, 1, 64, false);
+  TEST_PERFORMANCE3(filter, p, test_check_ring_signatures, 1, 64, true);
+  TEST_PERFORMANCE3(filter, p, test_check_ring_signatures, 3, 64, false);
+  TEST_PERFORMANCE3(filter, p, test_check_ring_signatures, 3, 64, true);
+  TEST_PERFORMANCE3(filter, p, test_check_ring_signatures, 11, 16, false);
+  TEST_PERFORMANCE3(filter, p, test_check_ring_signatures, 11, 16, true);
+
   TEST_PERFORMANCE4(filter, p, test_check_tx_signature, 2, 2, true, rct::RangeProofBorromean);
   TEST_PERFORMANCE4(filter, p, test_check_tx_signature, 10, 2, true, rct::RangeProofBorromean);
   TEST_PERFORMANCE4(filter, p, test_check_tx_signature, 100, 2, true, rct::RangeProofBorromean);
@@ -1790,11 +2640,32 @@ int main(int argc, char** argv)
   TEST_PERFORMANCE5(filter, p, test_check_tx_signature, 2, 10, true, rct::RangeProofPaddedBulletproof, 2);
   TEST_PERFORMANCE5(filter, p, test_check_tx_signature, 2, 10, true, rct::RangeProofMultiOutputBulletproof, 2);
 
+  TEST_PERFORMANCE2(filter, p, test_log_disabled, false, false);
+  TEST_PERFORMANCE2(filter, p, test_log_disabled, true, false);
+  TEST_PERFORMANCE2(filter, p, test_log_disabled, true, true);
+  TEST_PERFORMANCE5(filter, p, test_check_tx_signature, 2, 2, true, rct::RangeProofPaddedBulletproof, 3);
+  TEST_PERFORMANCE2(filter, p, test_check_tx_signature_log_traced, 2, 2);
+  TEST_PERFORMANCE5(filter, p, test_check_tx_signature, 16, 2, true, rct::RangeProofPaddedBulletproof, 3);
+  TEST_PERFORMANCE2(filter, p, test_check_tx_signature_log_traced, 16, 2);
+
   TEST_PERFORMANCE3(filter, p, test_check_tx_signature_aggregated_bulletproofs, 2, 2, 64);
   TEST_PERFORMANCE3(filter, p, test_check_tx_signature_aggregated_bulletproofs, 10, 2, 64);
   TEST_PERFORMANCE3(filter, p, test_check_tx_signature_aggregated_bulletproofs, 100, 2, 64);
+
+  TEST_PERFORMANCE3(filter, p, test_check_tx_signature_batch_failures, 64, 0, true);
+  TEST_PERFORMANCE3(filter, p, test_check_tx_signature_batch_failures, 64, 1, false);
+  TEST_PERFORMANCE3(filter, p, test_check_tx_signature_batch_failures, 64, 1, true);
+  TEST_PERFORMANCE3(filter, p, test_check_tx_signature_batch_failures, 64, 4, false);
+  TEST_PERFORMANCE3(filter, p, test_check_tx_signature_batch_failures, 64, 4, true);
+  TEST_PERFORMANCE3(filter, p, test_check_tx_signature_batch_failures, 64, 16, false);
+  TEST_PERFORMANCE3(filter, p, test_check_tx_signature_batch_failures, 64, 16, true);
   TEST_PERFORMANCE3(filter, p, test_check_tx_signature_aggregated_bulletproofs, 2, 10, 64);
 
+  TEST_PERFORMANCE3(filter, p, test_check_tx_ring_signatures_block, 11, 64, false);
+  TEST_PERFORMANCE3(filter, p, test_check_tx_ring_signatures_block, 11, 64, true);
+  TEST_PERFORMANCE3(filter, p, test_check_tx_ring_signatures_block, 16, 64, false);
+  TEST_PERFORMANCE3(filter, p, test_check_tx_ring_signatures_block, 16, 64, true);
+
   TEST_PERFORMANCE4(filter, p, test_check_tx_signature_aggregated_bulletproofs, 2, 2, 62, 4);
   TEST_PERFORMANCE4(filter, p, test_check_tx_signature_aggregated_bulletproofs, 10, 2, 62, 4);
   TEST_PERFORMANCE4(filter, p, test_check_tx_signature_aggregated_bulletproofs, 2, 2, 56, 16);
@@ -1812,8 +2683,18 @@ int main(int argc, char** argv)
   TEST_PERFORMANCE0(filter, p, test_is_out_to_acc_precomp);
   TEST_PERFORMANCE0(filter, p, test_generate_key_image_helper);
   TEST_PERFORMANCE0(filter, p, test_generate_key_derivation);
+  TEST_PERFORMANCE2(filter, p, test_generate_key_derivations, 16, false);
+  TEST_PERFORMANCE2(filter, p, test_generate_key_derivations, 16, true);
+  TEST_PERFORMANCE2(filter, p, test_generate_key_derivations, 64, false);
+  TEST_PERFORMANCE2(filter, p, test_generate_key_derivations, 64, true);
+  TEST_PERFORMANCE2(filter, p, test_generate_key_derivations, 256, false);
+  TEST_PERFORMANCE2(filter, p, test_generate_key_derivations, 256, true);
   TEST_PERFORMANCE0(filter, p, test_generate_key_image);
   TEST_PERFORMANCE0(filter, p, test_derive_public_key);
+  TEST_PERFORMANCE2(filter, p, test_derive_subaddress_public_keys, 16, false);
+  TEST_PERFORMANCE2(filter, p, test_derive_subaddress_public_keys, 16, true);
+  TEST_PERFORMANCE2(filter, p, test_derive_subaddress_public_keys, 256, false);
+  TEST_PERFORMANCE2(filter, p, test_derive_subaddress_public_keys, 256, true);
   TEST_PERFORMANCE0(filter, p, test_derive_secret_key);
   TEST_PERFORMANCE0(filter, p, test_ge_frombytes_vartime);
   TEST_PERFORMANCE0(filter, p, test_ge_tobytes);
@@ -1824,6 +2705,17 @@ int main(int argc, char** argv)
   TEST_PERFORMANCE1(filter, p, test_signature, true);
 
   TEST_PERFORMANCE2(filter, p, test_wallet2_expand_subaddresses, 50, 200);
+  // exchange-style lookaheads: few accounts, many subaddresses each
+  TEST_PERFORMANCE2(filter, p, test_wallet2_expand_subaddresses, 1, 10000);
+  TEST_PERFORMANCE2(filter, p, test_wallet2_expand_subaddresses, 1, 100000);
+  TEST_PERFORMANCE2(filter, p, test_wallet2_expand_subaddresses, 10, 50000);
+
+  TEST_PERFORMANCE2(filter, p, test_subaddress_lookup, 1000, false);
+  TEST_PERFORMANCE2(filter, p, test_subaddress_lookup, 1000, true);
+  TEST_PERFORMANCE2(filter, p, test_subaddress_lookup, 100000, false);
+  TEST_PERFORMANCE2(filter, p, test_subaddress_lookup, 100000, true);
+  TEST_PERFORMANCE2(filter, p, test_subaddress_lookup, 1000000, false);
+  TEST_PERFORMANCE2(filter, p, test_subaddress_lookup, 1000000, true);
 
   TEST_PERFORMANCE1(filter, p, test_cn_slow_hash, 0);
   TEST_PERFORMANCE1(filter, p, test_cn_slow_hash, 1);
@@ -1846,6 +2738,8 @@ int main(int argc, char** argv)
   TEST_PERFORMANCE3(filter, p, test_sig_clsag, 64, 2, 2);
   TEST_PERFORMANCE3(filter, p, test_sig_clsag, 128, 2, 2);
   TEST_PERFORMANCE3(filter, p, test_sig_clsag, 256, 2, 2);
+  TEST_PERFORMANCE4(filter, p, test_sig_clsag, 16, 2, 2, true); // CLSAG verification, ring members' Hp(P) cached
+  TEST_PERFORMANCE4(filter, p, test_sig_clsag, 128, 2, 2, true);
 
   TEST_PERFORMANCE2(filter, p, test_ringct_mlsag, 11, false);
   TEST_PERFORMANCE2(filter, p, test_ringct_mlsag, 11, true);
@@ -1857,6 +2751,10 @@ int main(int argc, char** argv)
 
   TEST_PERFORMANCE1(filter, p, test_range_proof, true);
   TEST_PERFORMANCE1(filter, p, test_range_proof, false);
+
+  // mock ledger reference set gathers
+  TEST_PERFORMANCE2(filter, p, test_mock_ledger_gather, 1000000, 128);
+  TEST_PERFORMANCE2(filter, p, test_mock_ledger_gather, 10000000, 128);
   */
 
   /*
@@ -1939,6 +2837,10 @@ int main(int argc, char** argv)
   TEST_PERFORMANCE1(filter, p, test_crypto_ops, op_sc_add);
   TEST_PERFORMANCE1(filter, p, test_crypto_ops, op_sc_sub);
   TEST_PERFORMANCE1(filter, p, test_crypto_ops, op_sc_mul);
+  TEST_PERFORMANCE1(filter, p, test_crypto_ops, op_sc_muladd);
+  TEST_PERFORMANCE1(filter, p, test_crypto_ops, op_sc_mul_x4);
+  TEST_PERFORMANCE1(filter, p, test_crypto_ops, op_sc_mul_x4_scalar);
+  TEST_PERFORMANCE1(filter, p, test_crypto_ops, op_sc_muladd_x4);
   TEST_PERFORMANCE1(filter, p, test_crypto_ops, op_ge_add_raw);
   TEST_PERFORMANCE1(filter, p, test_crypto_ops, op_ge_add_p3_p3);
   TEST_PERFORMANCE1(filter, p, test_crypto_ops, op_addKeys);
@@ -1962,6 +2864,24 @@ int main(int argc, char** argv)
   TEST_PERFORMANCE1(filter, p, test_crypto_ops, op_zeroCommitUncached);
   TEST_PERFORMANCE1(filter, p, test_crypto_ops, op_zeroCommitCached);
 
+  TEST_PERFORMANCE2(filter, p, test_scalar_invert, 1, false);
+  TEST_PERFORMANCE2(filter, p, test_scalar_invert, 1, true);
+  TEST_PERFORMANCE2(filter, p, test_scalar_invert, 4, false);
+  TEST_PERFORMANCE2(filter, p, test_scalar_invert, 4, true);
+  TEST_PERFORMANCE2(filter, p, test_scalar_invert, 16, false);
+  TEST_PERFORMANCE2(filter, p, test_scalar_invert, 16, true);
+  TEST_PERFORMANCE2(filter, p, test_scalar_invert, 128, false);
+  TEST_PERFORMANCE2(filter, p, test_scalar_invert, 128, true);
+
+  TEST_PERFORMANCE3(filter, p, test_grootle_f_products, 2, 7, false);
+  TEST_PERFORMANCE3(filter, p, test_grootle_f_products, 2, 7, true);
+  TEST_PERFORMANCE3(filter, p, test_grootle_f_products, 3, 5, false);
+  TEST_PERFORMANCE3(filter, p, test_grootle_f_products, 3, 5, true);
+  TEST_PERFORMANCE3(filter, p, test_grootle_f_products, 8, 3, false);
+  TEST_PERFORMANCE3(filter, p, test_grootle_f_products, 8, 3, true);
+  TEST_PERFORMANCE3(filter, p, test_grootle_f_products, 2, 10, false);
+  TEST_PERFORMANCE3(filter, p, test_grootle_f_products, 2, 10, true);
+
   TEST_PERFORMANCE2(filter, p, test_multiexp, multiexp_bos_coster, 2);
   TEST_PERFORMANCE2(filter, p, test_multiexp, multiexp_bos_coster, 4);
   TEST_PERFORMANCE2(filter, p, test_multiexp, multiexp_bos_coster, 8);
@@ -1988,6 +2908,15 @@ int main(int argc, char** argv)
   TEST_PERFORMANCE2(filter, p, test_multiexp, multiexp_straus, 2048);
   TEST_PERFORMANCE2(filter, p, test_multiexp, multiexp_straus, 4096);
 
+  // small fixed-size multiexps (one Schnorr-style proof's equation) vs straus/dispatch at the same sizes
+  TEST_PERFORMANCE2(filter, p, test_multiexp, multiexp_fixed, 2);
+  TEST_PERFORMANCE2(filter, p, test_multiexp, multiexp_fixed, 4);
+  TEST_PERFORMANCE2(filter, p, test_multiexp, multiexp_fixed, 8);
+  TEST_PERFORMANCE2(filter, p, test_multiexp, multiexp_fixed, 9);
+  TEST_PERFORMANCE2(filter, p, test_multiexp, multiexp_fixed, 16);
+  TEST_PERFORMANCE2(filter, p, test_multiexp, multiexp_straus, 9);
+  TEST_PERFORMANCE2(filter, p, test_multiexp, multiexp_dispatch, 9);
+
   TEST_PERFORMANCE2(filter, p, test_multiexp, multiexp_straus_cached, 2);
   TEST_PERFORMANCE2(filter, p, test_multiexp, multiexp_straus_cached, 4);
   TEST_PERFORMANCE2(filter, p, test_multiexp, multiexp_straus_cached, 8);
@@ -2028,6 +2957,27 @@ int main(int argc, char** argv)
   TEST_PERFORMANCE3(filter, p, test_multiexp, multiexp_pippenger_cached, 1024, 7);
   TEST_PERFORMANCE3(filter, p, test_multiexp, multiexp_pippenger_cached, 2048, 8);
   TEST_PERFORMANCE3(filter, p, test_multiexp, multiexp_pippenger_cached, 4096, 9);
+  TEST_PERFORMANCE3(filter, p, test_multiexp, multiexp_pippenger_scalar, 256, 6);
+  TEST_PERFORMANCE3(filter, p, test_multiexp, multiexp_pippenger_scalar, 1024, 7);
+  TEST_PERFORMANCE3(filter, p, test_multiexp, multiexp_pippenger_scalar, 4096, 9);
+  TEST_PERFORMANCE3(filter, p, test_multiexp, multiexp_pippenger_cached_scalar, 256, 6);
+  TEST_PERFORMANCE3(filter, p, test_multiexp, multiexp_pippenger_cached_scalar, 1024, 7);
+  TEST_PERFORMANCE3(filter, p, test_multiexp, multiexp_pippenger_cached_scalar, 4096, 9);
+  TEST_PERFORMANCE2(filter, p, test_multiexp, multiexp_dispatch, 4);
+  TEST_PERFORMANCE2(filter, p, test_multiexp, multiexp_dispatch, 16);
+  TEST_PERFORMANCE2(filter, p, test_multiexp, multiexp_dispatch, 64);
+  TEST_PERFORMANCE2(filter, p, test_multiexp, multiexp_dispatch, 128);
+  TEST_PERFORMANCE2(filter, p, test_multiexp, multiexp_dispatch, 256);
+  TEST_PERFORMANCE2(filter, p, test_multiexp, multiexp_dispatch, 1024);
+  TEST_PERFORMANCE2(filter, p, test_multiexp, multiexp_dispatch, 4096);
+  TEST_PERFORMANCE4(filter, p, test_multiexp, multiexp_pippenger_mt, 1024, 0, 1);
+  TEST_PERFORMANCE4(filter, p, test_multiexp, multiexp_pippenger_mt, 1024, 0, 2);
+  TEST_PERFORMANCE4(filter, p, test_multiexp, multiexp_pippenger_mt, 1024, 0, 4);
+  TEST_PERFORMANCE4(filter, p, test_multiexp, multiexp_pippenger_mt, 4096, 0, 1);
+  TEST_PERFORMANCE4(filter, p, test_multiexp, multiexp_pippenger_mt, 4096, 0, 2);
+  TEST_PERFORMANCE4(filter, p, test_multiexp, multiexp_pippenger_mt, 4096, 0, 4);
+  TEST_PERFORMANCE4(filter, p, test_multiexp, multiexp_pippenger_mt, 4096, 0, 8);
+  TEST_PERFORMANCE4(filter, p, test_multiexp, multiexp_pippenger_mt, 4096, 0, 0);
 #else
   TEST_PERFORMANCE3(filter, p, test_multiexp, multiexp_pippenger_cached, 2, 1);
   TEST_PERFORMANCE3(filter, p, test_multiexp, multiexp_pippenger_cached, 2, 2);
@@ -2251,6 +3201,6 @@ int main(int argc, char** argv)
 
   std::cout << "Tests finished. Elapsed time: " << timer.elapsed_ms() / 1000 << " sec" << std::endl;
 
-  return 0;
+  return report_regressions(p.core_params);
   CATCH_ENTRY_L0("main", 1);
 }
@@ -0,0 +1,260 @@
+// Copyright (c) 2021, The Monero Project
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this list of
+//    conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list
+//    of conditions and the following disclaimer in the documentation and/or other
+//    materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its contributors may be
+//    used to endorse or promote products derived from this software without specific
+//    prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+// THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#pragma once
+
+#include "common/aligned.h"
+#include "latency_histogram.h"
+#include "mock_tx.h"
+#include "mock_tx/ledger_context.h"
+#include "mock_tx/mock_tx.h"
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+
+/**
+ * End-to-end mock block verification
+ * - a block is 'block_size' txs of one type whose (in count, out count) shapes are drawn from a weighted distribution
+ *   (the same seeded sequence of shapes for every tx type, so the types see identical blocks)
+ * - a block is verified like a node would: validate_mock_txs() on the whole block (semantics, linking tags, batched
+ *   proofs), then add_tx_to_ledger() for each tx, so later blocks see the earlier blocks' linking tags and enotes
+ * - all tx types use one ledger (from the mock tx params: --mock-ledger-dir for LMDB); each type's blocks are made up
+ *   front, then verified back to back, and block latency (verify, append, total) and throughput are reported
+ */
+struct MockBlockTxShape final
+{
+    std::size_t in_count;
+    std::size_t out_count;
+    double weight;
+};
+
+/// default tx shapes: mostly 1-2 input/2 output txs, with a tail out to 16 inputs and 16 outputs
+inline std::vector<MockBlockTxShape> make_default_mock_block_tx_shapes()
+{
+    return {
+            {1, 2, 35}, {2, 2, 30}, {3, 2, 8}, {4, 2, 6}, {1, 3, 4}, {2, 3, 3},
+            {5, 2, 3}, {8, 2, 3}, {16, 2, 2}, {1, 8, 2}, {2, 16, 2}, {16, 16, 2}
+        };
+}
+
+/// parse tx shapes from 'in:out:weight,in:out:weight,...'
+inline bool parse_mock_block_tx_shapes(const std::string &shapes_str, std::vector<MockBlockTxShape> &shapes_out)
+{
+    shapes_out.clear();
+
+    std::istringstream shapes_stream{shapes_str};
+    std::string shape_str;
+    while (std::getline(shapes_stream, shape_str, ','))
+    {
+        std::istringstream shape_stream{shape_str};
+        MockBlockTxShape shape;
+        char separator_1{0};
+        char separator_2{0};
+        if (!(shape_stream >> shape.in_count >> separator_1 >> shape.out_count >> separator_2 >> shape.weight) ||
+            separator_1 != ':' ||
+            separator_2 != ':' ||
+            !(shape_stream >> std::ws).eof() ||
+            shape.in_count == 0 ||
+            shape.out_count == 0 ||
+            !(shape.weight > 0))
+            return false;
+
+        shapes_out.emplace_back(shape);
+    }
+
+    return !shapes_out.empty();
+}
+
+namespace mock_block_detail
+{
+/// per tx shape indices of 'num_blocks' blocks, the same for every call with the same arguments
+inline std::vector<std::vector<std::size_t>> draw_block_tx_shapes(const std::vector<MockBlockTxShape> &shapes,
+    const std::size_t num_blocks,
+    const std::size_t block_size)
+{
+    std::vector<double> weights;
+    for (const MockBlockTxShape &shape : shapes)
+        weights.emplace_back(shape.weight);
+
+    std::mt19937_64 rng{0x6d6f636b626c6b};
+    std::discrete_distribution<std::size_t> shape_distribution{weights.begin(), weights.end()};
+
+    std::vector<std::vector<std::size_t>> blocks(num_blocks);
+    for (std::vector<std::size_t> &block : blocks)
+    {
+        for (std::size_t tx_index{0}; tx_index < block_size; ++tx_index)
+            block.emplace_back(shape_distribution(rng));
+    }
+
+    return blocks;
+}
+
+inline uint64_t elapsed_ns(const std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+inline void report_latencies(const char *name, const LatencyHistogram &histogram)
+{
+    std::cout << name << " (ms): mean " << histogram.mean() / 1e6
+        << ", p50 " << histogram.value_at_percentile(50) / 1e6
+        << ", min " << histogram.min() / 1e6
+        << ", max " << histogram.max() / 1e6;
+}
+
+template <typename MockTxType>
+bool run_mock_blocks(const ParamsShuttleMockTx &params,
+    const std::vector<MockBlockTxShape> &shapes,
+    const std::vector<std::vector<std::size_t>> &block_tx_shapes,
+    const std::shared_ptr<mock_tx::LedgerContext> &ledger_context)
+{
+    static_assert(std::is_base_of<mock_tx::MockTx, MockTxType>::value, "Invalid mock tx type.");
+
+    // make the blocks (their txs' ref sets go into the shared ledger)
+    std::vector<std::vector<std::shared_ptr<MockTxType>>> blocks(block_tx_shapes.size());
+    std::size_t num_txs{0};
+    std::size_t num_inputs{0};
+
+    const auto build_start = std::chrono::steady_clock::now();
+    for (std::size_t block_index{0}; block_index < blocks.size(); ++block_index)
+    {
+        for (const std::size_t shape_index : block_tx_shapes[block_index])
+        {
+            ParamsShuttleMockTx tx_params{params};
+            tx_params.in_count = shapes[shape_index].in_count;
+            tx_params.out_count = shapes[shape_index].out_count;
+
+            std::vector<std::shared_ptr<MockTxType>> txs;
+            if (!make_mock_tx_test_txs<MockTxType>(tx_params, 1, ledger_context, txs))
+                return false;
+
+            blocks[block_index].emplace_back(std::move(txs.back()));
+            ++num_txs;
+            num_inputs += tx_params.in_count;
+        }
+    }
+    const uint64_t build_ns{elapsed_ns(build_start)};
+
+    // verify and append each block
+    LatencyHistogram verify_histogram;
+    LatencyHistogram append_histogram;
+    LatencyHistogram block_histogram;
+
+    const auto run_start = std::chrono::steady_clock::now();
+    for (const std::vector<std::shared_ptr<MockTxType>> &block : blocks)
+    {
+        const auto block_start = std::chrono::steady_clock::now();
+        bool block_ok{false};
+        try
+        {
+            block_ok = mock_tx::validate_mock_txs<MockTxType>(block, ledger_context, params.num_threads);
+        }
+        catch (...) {}
+        if (!block_ok)
+        {
+            std::cout << "  " << block.back()->get_descriptor() << ": a block failed to verify" << std::endl;
+            return false;
+        }
+        verify_histogram.record(elapsed_ns(block_start));
+
+        const auto append_start = std::chrono::steady_clock::now();
+        try
+        {
+            for (const std::shared_ptr<MockTxType> &tx : block)
+                mock_tx::add_tx_to_ledger<MockTxType>(ledger_context, *tx);
+        }
+        catch (...)
+        {
+            std::cout << "  " << block.back()->get_descriptor() << ": failed to append a block" << std::endl;
+            return false;
+        }
+        append_histogram.record(elapsed_ns(append_start));
+        block_histogram.record(elapsed_ns(block_start));
+    }
+    const double run_seconds{elapsed_ns(run_start) / 1e9};
+
+    // report
+    std::cout << "  " << blocks.back().back()->get_descriptor()
+        << " || " << num_txs << " txs, " << num_inputs << " inputs"
+        << " || build time (ms): " << build_ns / 1000000 << '\n';
+    std::cout << "    ";
+    report_latencies("block", block_histogram);
+    std::cout << "\n    ";
+    report_latencies("verify", verify_histogram);
+    std::cout << "\n    ";
+    report_latencies("append", append_histogram);
+    std::cout << "\n    throughput: " << blocks.size() / run_seconds << " blocks/s, "
+        << static_cast<uint64_t>(num_txs / run_seconds) << " txs/s, "
+        << static_cast<uint64_t>(num_inputs / run_seconds) << " inputs/s" << std::endl;
+
+    return true;
+}
+} //namespace mock_block_detail
+
+/// verify 'num_blocks' blocks of 'block_size' txs of each mock tx type (ref set size and threads from 'params')
+inline bool run_mock_block_verification(const ParamsShuttleMockTx &params,
+    const std::vector<MockBlockTxShape> &shapes,
+    const std::size_t num_blocks,
+    const std::size_t block_size)
+{
+    using namespace mock_block_detail;
+
+    if (shapes.empty() || num_blocks == 0 || block_size == 0)
+        return false;
+
+    std::shared_ptr<mock_tx::LedgerContext> ledger_context;
+    if (!make_mock_tx_test_ledger(params, ledger_context))
+        return false;
+
+    std::cout << "Mock block verification (" << num_blocks << " blocks x " << block_size << " txs per tx type, "
+        << "ref set: " << params.n << "^" << params.m
+        << ", rangeproof splits: " << params.num_rangeproof_splits
+        << ", threads: " << params.num_threads
+        << ", ledger: " << (params.ledger_dir.empty() ? "memory" : "lmdb")
+        << ", huge pages: " << (aligned_get_huge_pages() == ALIGNED_HUGE_PAGES_HUGETLB ? "hugetlb" :
+            aligned_get_huge_pages() == ALIGNED_HUGE_PAGES_THP ? "thp" : "off") << ")\n";
+    std::cout << "  tx shapes (in:out:weight):";
+    for (const MockBlockTxShape &shape : shapes)
+        std::cout << ' ' << shape.in_count << ':' << shape.out_count << ':' << shape.weight;
+    std::cout << std::endl;
+
+    const std::vector<std::vector<std::size_t>> block_tx_shapes{draw_block_tx_shapes(shapes, num_blocks, block_size)};
+
+    return run_mock_blocks<mock_tx::MockTxCLSAG>(params, shapes, block_tx_shapes, ledger_context) &&
+        run_mock_blocks<mock_tx::MockTxTriptych>(params, shapes, block_tx_shapes, ledger_context) &&
+        run_mock_blocks<mock_tx::MockTxSpConciseV1>(params, shapes, block_tx_shapes, ledger_context) &&
+        run_mock_blocks<mock_tx::MockTxSpMergeV1>(params, shapes, block_tx_shapes, ledger_context) &&
+        run_mock_blocks<mock_tx::MockTxSpPlainV1>(params, shapes, block_tx_shapes, ledger_context) &&
+        run_mock_blocks<mock_tx::MockTxSpSquashedV1>(params, shapes, block_tx_shapes, ledger_context);
+}
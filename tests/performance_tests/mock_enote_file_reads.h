@@ -0,0 +1,232 @@
+// Copyright (c) 2021, The Monero Project
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this list of
+//    conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list
+//    of conditions and the following disclaimer in the documentation and/or other
+//    materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its contributors may be
+//    used to endorse or promote products derived from this software without specific
+//    prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+// THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#pragma once
+
+#include "latency_histogram.h"
+#include "mock_tx/mock_ledger_context_lmdb.h"
+#include "mock_tx/mock_squashed_enote_file.h"
+#include "mock_tx/mock_sp_base_types.h"
+
+#include <boost/filesystem.hpp>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+
+/**
+ * Ref set reads from disk: LMDB (mmap page faults, one read transaction per ref set) vs a flat squashed enote file
+ *   read with batched io_uring reads (each batch's blocks submitted at once), with and without direct I/O
+ * - an LMDB ledger with 'num_enotes' squashed enotes and a flat file copy of it are made in 'dir' (and reused by later
+ *   runs with the same number of enotes)
+ * - each batch is 'ref_sets_per_batch' ref sets of 'ref_set_size' uniformly random ledger indices (e.g. a block's
+ *   membership proofs)
+ * - cold: the files are dropped from the page cache before each batch (LMDB is also reopened, to drop its mapping);
+ *   warm: the batches are read once before timing
+ * - reports per-batch latency and enote reads/s for each backend
+ */
+namespace mock_enote_file_reads_detail
+{
+/// flush a file and drop it from the page cache
+inline bool drop_file_page_cache(const std::string &path)
+{
+    const int fd{open(path.c_str(), O_RDONLY)};
+    if (fd < 0)
+        return false;
+
+    fdatasync(fd);
+    const bool dropped{posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED) == 0};
+    close(fd);
+
+    return dropped;
+}
+
+inline void report_reads(const char *name,
+    const LatencyHistogram &histogram,
+    const std::size_t enotes_per_batch)
+{
+    std::cout << "    " << name << ": p50 " << histogram.value_at_percentile(50) / 1e6
+        << " ms, p99 " << histogram.value_at_percentile(99) / 1e6
+        << " ms, max " << histogram.max() / 1e6
+        << " ms || " << (histogram.mean() > 0 ? enotes_per_batch / (histogram.mean() / 1e9) : 0.0)
+        << " enotes/s\n";
+}
+} //namespace mock_enote_file_reads_detail
+
+inline bool run_mock_enote_file_reads(const std::string &dir,
+    const std::size_t num_enotes,
+    const std::size_t num_batches,
+    const std::size_t ref_sets_per_batch,
+    const std::size_t ref_set_size)
+{
+    using namespace mock_enote_file_reads_detail;
+
+    if (num_enotes == 0 || num_batches == 0 || ref_sets_per_batch == 0 || ref_set_size == 0)
+        return false;
+
+    const boost::filesystem::path ledger_dir{boost::filesystem::path{dir} / "ledger"};
+    const std::string ledger_data_path{(ledger_dir / "data.mdb").string()};
+    const std::string enote_file_path{(boost::filesystem::path{dir} / "squashed_enotes").string()};
+
+    try
+    {
+        boost::filesystem::create_directories(ledger_dir);
+
+        // ledger (distinct enotes from a pool, so the flat file isn't a run of identical blocks)
+        std::unique_ptr<mock_tx::MockLedgerContextLMDB> ledger_context{
+                new mock_tx::MockLedgerContextLMDB{ledger_dir.string()}
+            };
+        if (ledger_context->get_num_enotes() < num_enotes)
+        {
+            std::vector<mock_tx::MockENoteSpV1> enote_pool(1024);
+            for (mock_tx::MockENoteSpV1 &enote : enote_pool)
+                enote.gen();
+
+            ledger_context->add_dummy_enotes_sp_v2(enote_pool, num_enotes - ledger_context->get_num_enotes());
+        }
+
+        // flat file copy of the ledger's first 'num_enotes' squashed enotes
+        bool have_enote_file{false};
+        try
+        {
+            have_enote_file = mock_tx::MockSquashedEnoteFile{enote_file_path, false, 1}.get_num_enotes() == num_enotes;
+        }
+        catch (...) {}
+        if (!have_enote_file)
+            mock_tx::write_mock_squashed_enote_file(enote_file_path, *ledger_context, num_enotes);
+
+        // batches of random ref sets
+        std::mt19937_64 rng{std::random_device{}()};
+        std::uniform_int_distribution<std::size_t> index_dist{0, num_enotes - 1};
+        std::vector<std::vector<std::vector<std::size_t>>> batches(num_batches,
+            std::vector<std::vector<std::size_t>>(ref_sets_per_batch, std::vector<std::size_t>(ref_set_size)));
+        std::vector<std::vector<const std::vector<std::size_t>*>> batch_ptrs(num_batches);
+
+        for (std::size_t batch_index{0}; batch_index < num_batches; ++batch_index)
+        {
+            for (std::vector<std::size_t> &ref_set : batches[batch_index])
+            {
+                for (std::size_t &index : ref_set)
+                    index = index_dist(rng);
+
+                batch_ptrs[batch_index].push_back(&ref_set);
+            }
+        }
+
+        mock_tx::MockSquashedEnoteFile direct_file{enote_file_path, true};
+        mock_tx::MockSquashedEnoteFile buffered_file{enote_file_path, false};
+
+        std::cout << "Ref set reads: " << num_enotes << " enotes || " << num_batches << " batches of "
+            << ref_sets_per_batch << " ref sets of " << ref_set_size << " enotes || flat file reads: "
+            << (direct_file.uses_io_uring() ? "io_uring" : "pread")
+            << (direct_file.uses_direct_io() ? ", direct I/O available" : ", no direct I/O on this file system") << '\n';
+
+        // backends
+        rct::KeyMatrix lmdb_enotes;
+        std::vector<rct::KeyMatrix> file_enotes;
+        const auto read_lmdb =
+            [&](const std::size_t batch_index)
+            {
+                for (const std::vector<std::size_t> &ref_set : batches[batch_index])
+                    ledger_context->get_reference_set_components_sp_v2(ref_set, lmdb_enotes);
+            };
+        const auto read_direct =
+            [&](const std::size_t batch_index)
+            {
+                direct_file.get_reference_sets_sp_v2(batch_ptrs[batch_index], file_enotes);
+            };
+        const auto read_buffered =
+            [&](const std::size_t batch_index)
+            {
+                buffered_file.get_reference_sets_sp_v2(batch_ptrs[batch_index], file_enotes);
+            };
+
+        const auto time_batches =
+            [&](const std::function<void(std::size_t)> &read_batch,
+                const std::function<void()> &before_batch) -> LatencyHistogram
+            {
+                LatencyHistogram histogram;
+
+                for (std::size_t batch_index{0}; batch_index < num_batches; ++batch_index)
+                {
+                    if (before_batch)
+                        before_batch();
+
+                    const auto start{std::chrono::steady_clock::now()};
+                    read_batch(batch_index);
+                    histogram.record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::steady_clock::now() - start).count()));
+                }
+
+                return histogram;
+            };
+
+        const std::size_t enotes_per_batch{ref_sets_per_batch*ref_set_size};
+
+        // cold
+        std::cout << "  cold page cache\n";
+        report_reads("lmdb mmap", time_batches(read_lmdb,
+                [&]()
+                {
+                    ledger_context.reset();
+                    drop_file_page_cache(ledger_data_path);
+                    ledger_context.reset(new mock_tx::MockLedgerContextLMDB{ledger_dir.string()});
+                }),
+            enotes_per_batch);
+        report_reads("flat file, buffered", time_batches(read_buffered,
+                [&]() { drop_file_page_cache(enote_file_path); }),
+            enotes_per_batch);
+        report_reads("flat file, direct", time_batches(read_direct, nullptr), enotes_per_batch);
+
+        // warm
+        for (std::size_t batch_index{0}; batch_index < num_batches; ++batch_index)
+        {
+            read_lmdb(batch_index);
+            read_buffered(batch_index);
+        }
+
+        std::cout << "  warm page cache\n";
+        report_reads("lmdb mmap", time_batches(read_lmdb, nullptr), enotes_per_batch);
+        report_reads("flat file, buffered", time_batches(read_buffered, nullptr), enotes_per_batch);
+        report_reads("flat file, direct (no page cache)", time_batches(read_direct, nullptr), enotes_per_batch);
+    }
+    catch (const std::exception &e)
+    {
+        std::cout << "Ref set read benchmark failed: " << e.what() << std::endl;
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,87 @@
+// Copyright (c) 2021, The Monero Project
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of
+//    conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list
+//    of conditions and the following disclaimer in the documentation and/or other
+//    materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be
+//    used to endorse or promote products derived from this software without specific
+//    prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+// THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include "crypto/crypto.h"
+#include "mock_tx/mock_ledger_context.h"
+#include "mock_tx/mock_sp_transaction_component_types.h"
+#include "performance_tests.h"
+#include "ringct/rctTypes.h"
+
+#include <memory>
+#include <vector>
+
+
+/// gather reference sets of random enotes from a mock ledger with 'num_enotes' enotes
+template <std::size_t num_enotes, std::size_t ref_set_size>
+class test_mock_ledger_gather
+{
+public:
+    static const size_t loop_count = 1000;
+    static const size_t num_ref_sets = 64;
+
+    bool init()
+    {
+        m_ledger_context = std::make_shared<mock_tx::MockLedgerContext>();
+
+        // ledger contents don't matter for gather throughput, so insert copies of one enote (much faster to set up)
+        mock_tx::MockENoteSpV1 enote;
+        enote.gen();
+
+        for (std::size_t i{0}; i < num_enotes; ++i)
+            m_ledger_context->add_enote_sp_v1(enote);
+
+        // random reference sets
+        m_ref_sets.resize(num_ref_sets);
+
+        for (std::vector<std::size_t> &ref_set : m_ref_sets)
+        {
+            ref_set.resize(ref_set_size);
+
+            for (std::size_t &index : ref_set)
+                index = crypto::rand_idx(num_enotes);
+        }
+
+        return true;
+    }
+
+    bool test()
+    {
+        rct::KeyMatrix referenced_enotes_components;
+        m_ledger_context->get_reference_set_components_sp_v1(m_ref_sets[m_ref_set_i], referenced_enotes_components);
+        m_ref_set_i = (m_ref_set_i + 1) % num_ref_sets;
+
+        return referenced_enotes_components.rows() == ref_set_size;
+    }
+
+private:
+    std::shared_ptr<mock_tx::MockLedgerContext> m_ledger_context;
+    std::vector<std::vector<std::size_t>> m_ref_sets;
+    std::size_t m_ref_set_i{0};
+};
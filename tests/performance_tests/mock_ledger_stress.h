@@ -0,0 +1,206 @@
+// Copyright (c) 2021, The Monero Project
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this list of
+//    conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list
+//    of conditions and the following disclaimer in the documentation and/or other
+//    materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its contributors may be
+//    used to endorse or promote products derived from this software without specific
+//    prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+// THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include "crypto/crypto.h"
+#include "latency_histogram.h"
+#include "mock_tx.h"
+#include "mock_tx/ledger_context.h"
+#include "mock_tx/mock_tx.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+/**
+ * Concurrent validation stress: readers validate while a writer appends to one shared ledger
+ * - each of 'num_readers' threads validates its own batch of txs (batch size from the mock tx params) back to back
+ * - a writer thread appends a tx every 'writer_interval_us' (0 = back to back) with add_tx_to_ledger(); the appended
+ *   txs are copies of one tx with fresh linking tags, so they never collide with the readers' txs
+ * - runs for 'seconds', then reports reader throughput and batch latency, and writer throughput and append latency
+ * - the ledger comes from the mock tx params (--mock-ledger-dir for LMDB), so ledger designs can be compared directly
+ */
+namespace mock_ledger_stress_detail
+{
+inline void report_latencies(const char *unit, const double unit_ns, const LatencyHistogram &histogram)
+{
+    std::cout << "latency (" << unit << "): p50 " << histogram.value_at_percentile(50) / unit_ns
+        << ", p99 " << histogram.value_at_percentile(99) / unit_ns
+        << ", p99.9 " << histogram.value_at_percentile(99.9) / unit_ns
+        << ", max " << histogram.max() / unit_ns;
+}
+
+inline uint64_t elapsed_ns(const std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+}
+} //namespace mock_ledger_stress_detail
+
+template <typename MockTxType>
+bool run_mock_ledger_stress(const ParamsShuttleMockTx &params,
+    const std::size_t num_readers,
+    const std::size_t writer_interval_us,
+    const std::size_t seconds)
+{
+    using namespace mock_ledger_stress_detail;
+    static_assert(std::is_base_of<mock_tx::MockTx, MockTxType>::value, "Invalid mock tx type.");
+
+    if (num_readers == 0 || params.batch_size == 0)
+        return false;
+
+    // one shared ledger; each reader gets its own txs, and the writer a template tx
+    std::shared_ptr<mock_tx::LedgerContext> ledger_context;
+    if (!make_mock_tx_test_ledger(params, ledger_context))
+        return false;
+
+    std::vector<std::vector<std::shared_ptr<MockTxType>>> reader_txs(num_readers);
+    for (std::vector<std::shared_ptr<MockTxType>> &txs : reader_txs)
+    {
+        if (!make_mock_tx_test_txs<MockTxType>(params, params.batch_size, ledger_context, txs))
+            return false;
+    }
+
+    std::vector<std::shared_ptr<MockTxType>> writer_txs;
+    if (!make_mock_tx_test_txs<MockTxType>(params, 1, ledger_context, writer_txs))
+        return false;
+
+    std::cout << "Concurrent validation stress (" << writer_txs.back()->get_descriptor() << ", " << num_readers
+        << " readers x batch " << params.batch_size << ", inputs: " << params.in_count
+        << ", outputs: " << params.out_count << ", ref set: " << params.n << "^" << params.m
+        << ", writer interval (us): " << writer_interval_us
+        << ", ledger: " << (params.ledger_dir.empty() ? "memory" : "lmdb") << ", " << seconds << " s)" << std::endl;
+
+    // run
+    std::atomic<bool> stop{false};
+    std::atomic<bool> readers_ok{true};
+    std::vector<LatencyHistogram> reader_histograms(num_readers);
+    LatencyHistogram writer_histogram;
+    std::atomic<bool> writer_ok{true};
+
+    const auto run_start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> readers;
+    readers.reserve(num_readers);
+    for (std::size_t reader_index{0}; reader_index < num_readers; ++reader_index)
+    {
+        readers.emplace_back(
+                [&, reader_index]()
+                {
+                    while (!stop.load(std::memory_order_relaxed))
+                    {
+                        const auto batch_start = std::chrono::steady_clock::now();
+                        bool batch_ok{false};
+                        try
+                        {
+                            batch_ok = mock_tx::validate_mock_txs<MockTxType>(reader_txs[reader_index],
+                                ledger_context,
+                                1);
+                        }
+                        catch (...) {}
+                        reader_histograms[reader_index].record(elapsed_ns(batch_start));
+
+                        if (!batch_ok)
+                        {
+                            readers_ok = false;
+                            return;
+                        }
+                    }
+                }
+            );
+    }
+
+    std::thread writer{
+            [&]()
+            {
+                MockTxType tx_to_add{*writer_txs.back()};
+                auto next_append = std::chrono::steady_clock::now();
+
+                while (!stop.load(std::memory_order_relaxed))
+                {
+                    // fresh linking tags, so the copy can be appended again
+                    for (auto &input_image : tx_to_add.m_input_images)
+                        input_image.m_key_image = crypto::rand<crypto::key_image>();
+
+                    const auto append_start = std::chrono::steady_clock::now();
+                    try
+                    {
+                        mock_tx::add_tx_to_ledger<MockTxType>(ledger_context, tx_to_add);
+                    }
+                    catch (...)
+                    {
+                        writer_ok = false;
+                        return;
+                    }
+                    writer_histogram.record(elapsed_ns(append_start));
+
+                    if (writer_interval_us > 0)
+                    {
+                        next_append += std::chrono::microseconds(writer_interval_us);
+                        std::this_thread::sleep_until(next_append);
+                    }
+                }
+            }
+        };
+
+    std::this_thread::sleep_for(std::chrono::seconds(seconds));
+    stop = true;
+    for (std::thread &reader : readers)
+        reader.join();
+    writer.join();
+    const double run_seconds{elapsed_ns(run_start) / 1e9};
+
+    if (!readers_ok || !writer_ok)
+    {
+        std::cout << (readers_ok ? "Writer failed to append a tx" : "A reader's batch failed to validate") << std::endl;
+        return false;
+    }
+
+    // report
+    LatencyHistogram batch_histogram;
+    for (const LatencyHistogram &histogram : reader_histograms)
+        batch_histogram.merge(histogram);
+
+    std::cout << "  readers: " << static_cast<uint64_t>(batch_histogram.total_count() * params.batch_size / run_seconds)
+        << " txs/s || batch ";
+    report_latencies("ms", 1e6, batch_histogram);
+    std::cout << " (" << batch_histogram.total_count() << " batches)" << std::endl;
+
+    std::cout << "  writer: " << static_cast<uint64_t>(writer_histogram.total_count() / run_seconds)
+        << " txs/s || append ";
+    report_latencies("us", 1e3, writer_histogram);
+    std::cout << " (" << writer_histogram.total_count() << " appends)" << std::endl;
+
+    return true;
+}
@@ -0,0 +1,268 @@
+// Copyright (c) 2021, The Monero Project
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this list of
+//    conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list
+//    of conditions and the following disclaimer in the documentation and/or other
+//    materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its contributors may be
+//    used to endorse or promote products derived from this software without specific
+//    prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+// THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include "alloc_tracker.h"
+#include "crypto/crypto.h"
+#include "mock_tx.h"
+#include "mock_tx/mock_ledger_context.h"
+#include "mock_tx/mock_rct_clsag.h"
+#include "mock_tx/mock_rct_triptych.h"
+#include "mock_tx/mock_sp_transaction_component_types.h"
+#include "mock_tx/mock_sp_txtype_concise_v1.h"
+#include "mock_tx/mock_sp_txtype_merge_v1.h"
+#include "mock_tx/mock_sp_txtype_plain_v1.h"
+#include "mock_tx/mock_sp_txtype_squashed_v1.h"
+#include "mock_tx/mock_tx_utils.h"
+
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+
+/**
+ * Memory footprint of mock ledgers and in-memory mock txs (for capacity planning of ledger caches and mempools)
+ * - sizes are live heap bytes measured with the allocation tracker (allocator usable sizes, so allocator rounding is
+ *   included; allocator bookkeeping and fragmentation are not)
+ * - 'peak' is the largest live size while the elements were added, i.e. including transient growth (vector
+ *   doubling, hash table rehashes)
+ * - ledger and tx sizes go up by 10x per step, so per-element costs can be compared across sizes
+ */
+namespace mock_memory_footprint_detail
+{
+/// live and peak heap bytes of what 'add_elements' allocates (and keeps)
+template <typename AddElementsT>
+void measure_live_bytes(const AddElementsT &add_elements, uint64_t &live_bytes_out, uint64_t &peak_bytes_out)
+{
+    AllocationTracker::start();
+    const int64_t baseline{AllocationTracker::reset_peak()};
+    add_elements();
+    const int64_t live{AllocationTracker::live_bytes()};
+    peak_bytes_out = AllocationTracker::peak_since(baseline);
+    AllocationTracker::stop();
+
+    live_bytes_out = live > baseline ? static_cast<uint64_t>(live - baseline) : 0;
+}
+
+inline std::string per_element(const uint64_t bytes, const std::size_t num_elements)
+{
+    return std::to_string(num_elements > 0 ? bytes / num_elements : 0);
+}
+
+inline const char* storage_mode_name(const mock_tx::MockLedgerStorageMode storage_mode)
+{
+    switch (storage_mode)
+    {
+        case mock_tx::MockLedgerStorageMode::FULL: return "full";
+        case mock_tx::MockLedgerStorageMode::SQUASHED_WITH_COMPONENTS: return "squashed + components";
+        case mock_tx::MockLedgerStorageMode::SQUASHED_ONLY: return "squashed only";
+        default: return "?";
+    }
+}
+
+/// bytes per enote of a MockLedgerContext with 'num_enotes' enotes (v2: squashed enotes stored too)
+inline void report_ledger_enotes(const std::size_t num_enotes,
+    const bool squashed,
+    const mock_tx::MockLedgerStorageMode storage_mode = mock_tx::MockLedgerStorageMode::FULL)
+{
+    // ledger contents don't matter for its size, so add copies of a pool of random enotes (much faster to set up)
+    std::vector<mock_tx::MockENoteSpV1> enote_pool(1024);
+    for (mock_tx::MockENoteSpV1 &enote : enote_pool)
+        enote.gen();
+
+    uint64_t live_bytes{0};
+    uint64_t peak_bytes{0};
+    {
+        std::shared_ptr<mock_tx::MockLedgerContext> ledger_context;
+        measure_live_bytes(
+                [&]()
+                {
+                    ledger_context = std::make_shared<mock_tx::MockLedgerContext>(
+                            mock_tx::MockLedgerContext::DEFAULT_SQUASHED_ENOTE_CACHE_LIMIT,
+                            0,
+                            false,
+                            storage_mode
+                        );
+                    for (std::size_t num_added{0}; num_added < num_enotes; num_added += enote_pool.size())
+                    {
+                        if (squashed)
+                            ledger_context->add_enotes_sp_v2(enote_pool, 1);
+                        else
+                            ledger_context->add_enotes_sp_v1(enote_pool);
+                    }
+                },
+                live_bytes,
+                peak_bytes
+            );
+    }
+
+    // the pool is added whole, so the ledger may hold a few more enotes than asked for
+    const std::size_t num_added{(num_enotes + enote_pool.size() - 1) / enote_pool.size() * enote_pool.size()};
+    std::cout << "  enotes (" << (squashed ? "v2, squashed" : "v1") << ", " << storage_mode_name(storage_mode) << "): "
+        << num_added
+        << " || bytes/enote: " << per_element(live_bytes, num_added)
+        << " || peak bytes/enote: " << per_element(peak_bytes, num_added) << '\n';
+}
+
+/// bytes per linking tag of a MockLedgerContext with 'num_linking_tags' linking tags
+inline void report_ledger_linking_tags(const std::size_t num_linking_tags)
+{
+    // tags are random bytes (they are only looked up), made up front (outside the measurement)
+    std::vector<crypto::key_image> linking_tags(num_linking_tags);
+    for (crypto::key_image &linking_tag : linking_tags)
+        linking_tag = crypto::rand<crypto::key_image>();
+
+    uint64_t live_bytes{0};
+    uint64_t peak_bytes{0};
+    {
+        std::shared_ptr<mock_tx::MockLedgerContext> ledger_context;
+        measure_live_bytes(
+                [&]()
+                {
+                    ledger_context = std::make_shared<mock_tx::MockLedgerContext>();
+                    for (const crypto::key_image &linking_tag : linking_tags)
+                        ledger_context->add_linking_tag_sp_v1(linking_tag);
+                },
+                live_bytes,
+                peak_bytes
+            );
+    }
+
+    std::cout << "  linking tags: " << num_linking_tags
+        << " || bytes/tag: " << per_element(live_bytes, num_linking_tags)
+        << " || peak bytes/tag: " << per_element(peak_bytes, num_linking_tags) << '\n';
+}
+
+/// bytes per in-memory tx of a mempool of 'num_txs' txs of one type (copies of one proven tx)
+template <typename MockTxType>
+bool report_mempool_txs(const char *tx_type, const ParamsShuttleMockTx &params, const std::size_t max_txs)
+{
+    // proving is slow and doesn't change a tx's size, so the mempool holds copies of one tx
+    std::shared_ptr<mock_tx::LedgerContext> ledger_context;
+    std::vector<std::shared_ptr<MockTxType>> txs;
+    if (!make_mock_tx_test_ledger(params, ledger_context) ||
+        !make_mock_tx_test_txs<MockTxType>(params, 1, ledger_context, txs))
+        return false;
+
+    std::cout << "  " << tx_type << " (" << txs.back()->get_descriptor() << ", wire bytes: "
+        << txs.back()->get_size_bytes() << ")\n";
+
+    for (std::size_t num_txs{1}; num_txs <= max_txs; num_txs *= 10)
+    {
+        uint64_t live_bytes{0};
+        uint64_t peak_bytes{0};
+        {
+            std::vector<std::shared_ptr<MockTxType>> mempool;
+            mempool.reserve(num_txs);
+            measure_live_bytes(
+                    [&]()
+                    {
+                        for (std::size_t tx_index{0}; tx_index < num_txs; ++tx_index)
+                            mempool.emplace_back(std::make_shared<MockTxType>(*txs.back()));
+                    },
+                    live_bytes,
+                    peak_bytes
+                );
+        }
+
+        const std::size_t bytes_per_tx{static_cast<std::size_t>(live_bytes / num_txs)};
+        std::cout << "    txs: " << num_txs
+            << " || bytes/tx: " << bytes_per_tx
+            << " || in-memory/wire: " << (txs.back()->get_size_bytes() > 0 ?
+                static_cast<double>(bytes_per_tx) / txs.back()->get_size_bytes() : 0.0) << '\n';
+    }
+
+    return true;
+}
+} //namespace mock_memory_footprint_detail
+
+/**
+ * Report the memory footprint of mock ledgers (per enote and per linking tag, up to 'max_enotes') and of mempools of
+ * each mock tx type (per tx, up to 'max_txs'; tx parameters from 'params')
+ * - returns false if allocation tracking is unavailable or a tx couldn't be made
+ */
+inline bool report_mock_memory_footprint(const ParamsShuttleMockTx &params,
+    const std::size_t max_enotes,
+    const std::size_t max_txs)
+{
+    using namespace mock_memory_footprint_detail;
+
+    if (!AllocationTracker::available())
+    {
+        std::cout << "Memory footprint needs the allocation tracker (glibc only)" << std::endl;
+        return false;
+    }
+
+    std::cout << "Mock ledger memory footprint (MockLedgerContext, live heap bytes)" << std::endl;
+    for (std::size_t num_elements{1000}; num_elements <= max_enotes; num_elements *= 10)
+    {
+        report_ledger_enotes(num_elements, false);
+        for (const mock_tx::MockLedgerStorageMode storage_mode : {mock_tx::MockLedgerStorageMode::FULL,
+            mock_tx::MockLedgerStorageMode::SQUASHED_WITH_COMPONENTS,
+            mock_tx::MockLedgerStorageMode::SQUASHED_ONLY})
+            report_ledger_enotes(num_elements, true, storage_mode);
+        report_ledger_linking_tags(num_elements);
+    }
+
+    // enote columns of a large ledger (spare vector capacity and allocator overhead aside)
+    static constexpr std::size_t NUM_PROJECTED_ENOTES{100000000};
+    std::cout << "Mock ledger enote columns at " << NUM_PROJECTED_ENOTES << " enotes" << std::endl;
+    for (const mock_tx::MockLedgerStorageMode storage_mode : {mock_tx::MockLedgerStorageMode::FULL,
+        mock_tx::MockLedgerStorageMode::SQUASHED_WITH_COMPONENTS,
+        mock_tx::MockLedgerStorageMode::SQUASHED_ONLY})
+    {
+        for (const bool store_converted : {false, true})
+        {
+            const std::size_t enote_bytes{
+                    mock_tx::MockLedgerContext::get_enote_storage_bytes(storage_mode, store_converted)
+                };
+            std::cout << "  " << storage_mode_name(storage_mode) << (store_converted ? ", converted" : "")
+                << " || bytes/enote: " << enote_bytes
+                << " || GiB: " << static_cast<double>(enote_bytes) * NUM_PROJECTED_ENOTES / (1024*1024*1024) << '\n';
+        }
+    }
+
+    std::cout << "Mock tx memory footprint (in-memory txs, live heap bytes; inputs: " << params.in_count
+        << ", outputs: " << params.out_count << ", ref set: " << params.n << "^" << params.m << ")" << std::endl;
+    const bool txs_ok{
+            report_mempool_txs<mock_tx::MockTxCLSAG>("MockTxCLSAG", params, max_txs) &&
+            report_mempool_txs<mock_tx::MockTxTriptych>("MockTxTriptych", params, max_txs) &&
+            report_mempool_txs<mock_tx::MockTxSpConciseV1>("MockTxSpConciseV1", params, max_txs) &&
+            report_mempool_txs<mock_tx::MockTxSpMergeV1>("MockTxSpMergeV1", params, max_txs) &&
+            report_mempool_txs<mock_tx::MockTxSpPlainV1>("MockTxSpPlainV1", params, max_txs) &&
+            report_mempool_txs<mock_tx::MockTxSpSquashedV1>("MockTxSpSquashedV1", params, max_txs)
+        };
+    if (!txs_ok)
+        std::cout << "Failed to make mock txs" << std::endl;
+    std::cout << std::flush;
+
+    return txs_ok;
+}
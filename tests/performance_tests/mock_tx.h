@@ -29,19 +29,31 @@
 #pragma once
 
 #include "mock_tx/mock_ledger_context.h"
+#include "mock_tx/mock_ledger_context_lmdb.h"
 #include "mock_tx/mock_rct_clsag.h"
 #include "mock_tx/mock_rct_triptych.h"
 #include "mock_tx/mock_sp_txtype_concise_v1.h"
 #include "mock_tx/mock_sp_txtype_merge_v1.h"
 #include "mock_tx/mock_sp_txtype_plain_v1.h"
 #include "mock_tx/mock_sp_txtype_squashed_v1.h"
+#include "mock_tx/mock_tx_phase_timers.h"
 #include "mock_tx/mock_tx_utils.h"
 #include "performance_tests.h"
 #include "ringct/rctOps.h"
+#include "ringct/rctSigs.h"
 #include "ringct/rctTypes.h"
 
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
 #include <iostream>
+#include <list>
 #include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <typeindex>
 #include <type_traits>
 #include <vector>
 
@@ -55,8 +67,54 @@ struct ParamsShuttleMockTx final : public ParamsShuttle
     std::size_t n{2};
     std::size_t m{0};
     std::size_t num_rangeproof_splits{0};
+    // squashed Seraphis ref sets: consecutive ledger enotes per bin (0 = one run per ref set)
+    std::size_t ref_set_bin_size{0};
+    // unsquashed Seraphis ref sets: all inputs of a tx share one ref set
+    bool shared_ref_set{false};
+    // on-disk ledger: pick squashed Seraphis decoys from the pre-populated enotes with wallet2's gamma distribution
+    bool gamma_decoys{false};
+    // threads used by batch validation (0 = threadpool max concurrency)
+    std::size_t num_threads{1};
+    // threads used to prove independent inputs while building the txs (0 = threadpool max concurrency)
+    std::size_t build_threads{1};
+    // threads used to build separate txs while setting up tests (0 = threadpool max concurrency; 1 = serial)
+    std::size_t fixture_workers{0};
+    // on-disk ledger: LMDB directory (empty = in-memory mock ledger), and min number of enotes to pre-populate it with
+    std::string ledger_dir;
+    std::size_t ledger_num_enotes{0};
+    // in-memory ledger: max number of squashed enotes to keep straus multiples for (0 = no straus cache)
+    std::size_t ledger_straus_cache_points{0};
+    // reuse proven txs across tests with the same tx parameters (see MockTxFixtureCache)
+    bool reuse_txs{false};
+    // in-memory ledger: load each test's ledger and txs from snapshots in this directory, making and saving them first
+    //   if missing (see load_or_make_mock_tx_test_fixtures(); empty = always make them)
+    std::string fixture_dir;
+    // parse each tx from its byte blob before validating it (ignored by tx types without a blob format)
+    bool from_blobs{false};
+    // report where validation spends its time (needs the mock_tx library built with MOCK_TX_PHASE_TIMERS)
+    bool phase_timings{false};
+    // sweeps: time proving the txs (test_mock_tx_prove) instead of validating them
+    bool prove{false};
+    // keep ring members' Hp(P) in rct's hash_to_p3 cache across runs (CLSAG txs; otherwise it is cleared before each run)
+    bool warm_hp_cache{false};
 };
 
+/// mock tx types that can be serialized to and parsed from byte blobs
+template <typename MockTxType>
+struct mock_tx_has_blob_format : std::false_type {};
+template <> struct mock_tx_has_blob_format<mock_tx::MockTxSpConciseV1> : std::true_type {};
+template <> struct mock_tx_has_blob_format<mock_tx::MockTxSpMergeV1> : std::true_type {};
+template <> struct mock_tx_has_blob_format<mock_tx::MockTxSpPlainV1> : std::true_type {};
+template <> struct mock_tx_has_blob_format<mock_tx::MockTxSpSquashedV1> : std::true_type {};
+
+/// names of mock tx types in fixture file names (stable across builds, unlike typeid names)
+template <typename MockTxType>
+inline std::string mock_tx_fixture_type_name();
+template <> inline std::string mock_tx_fixture_type_name<mock_tx::MockTxSpConciseV1>() { return "sp_concise_v1"; }
+template <> inline std::string mock_tx_fixture_type_name<mock_tx::MockTxSpMergeV1>() { return "sp_merge_v1"; }
+template <> inline std::string mock_tx_fixture_type_name<mock_tx::MockTxSpPlainV1>() { return "sp_plain_v1"; }
+template <> inline std::string mock_tx_fixture_type_name<mock_tx::MockTxSpSquashedV1>() { return "sp_squashed_v1"; }
+
 class MockTxPerfIncrementer final
 {
 public:
@@ -240,64 +298,418 @@ private:
     std::size_t m_decomp_m_current{0};
 };
 
+/// number of distinct enotes that pre-populated on-disk ledgers cycle through
+static constexpr std::size_t MOCK_LEDGER_DUMMY_ENOTE_POOL_SIZE{1024};
+
+/// fresh mock ledger context, or a pre-populated on-disk ledger
+inline bool make_mock_tx_test_ledger(const ParamsShuttleMockTx &params,
+    std::shared_ptr<mock_tx::LedgerContext> &ledger_context_out)
+{
+    if (params.ledger_dir.empty())
+    {
+        ledger_context_out = std::make_shared<mock_tx::MockLedgerContext>(
+                mock_tx::MockLedgerContext::DEFAULT_SQUASHED_ENOTE_CACHE_LIMIT,
+                params.ledger_straus_cache_points
+            );
+        return true;
+    }
+
+    std::shared_ptr<mock_tx::MockLedgerContextLMDB> ledger_context_lmdb;
+
+    try
+    {
+        ledger_context_lmdb = std::make_shared<mock_tx::MockLedgerContextLMDB>(params.ledger_dir);
+
+        // note: the txs' reference sets are appended after the pre-populated enotes
+        const std::size_t num_enotes{ledger_context_lmdb->get_num_enotes()};
+        if (num_enotes < params.ledger_num_enotes)
+        {
+            std::vector<mock_tx::MockENoteSpV1> dummy_enotes(MOCK_LEDGER_DUMMY_ENOTE_POOL_SIZE);
+            for (mock_tx::MockENoteSpV1 &dummy_enote : dummy_enotes)
+                dummy_enote.gen();
+            ledger_context_lmdb->add_dummy_enotes_sp_v2(dummy_enotes, params.ledger_num_enotes - num_enotes);
+        }
+    }
+    catch (...)
+    {
+        return false;
+    }
+
+    ledger_context_out = ledger_context_lmdb;
+    return true;
+}
+
+/// append txs to 'txs_inout' until it holds 'num_txs' txs (their reference sets are added to 'ledger_context')
 template <typename MockTxType>
-class test_mock_tx
+bool make_mock_tx_test_txs(const ParamsShuttleMockTx &params,
+    const std::size_t num_txs,
+    const std::shared_ptr<mock_tx::LedgerContext> &ledger_context,
+    std::vector<std::shared_ptr<MockTxType>> &txs_inout)
 {
-public:
-    static const size_t loop_count = 1;
+    static_assert(std::is_base_of<mock_tx::MockTx, MockTxType>::value, "Invalid mock tx type.");
 
-    bool init(const ParamsShuttleMockTx &params)
+    // divide max amount into equal-size chunks to distribute among more numerous of inputs vs outputs
+    if (params.in_count == 0 || params.out_count == 0)
+        return false;
+
+    rct::xmr_amount amount_chunk{
+            rct::xmr_amount{static_cast<rct::xmr_amount>(-1)} / 
+            (params.in_count > params.out_count ? params.in_count : params.out_count)
+        };
+
+    // input and output amounts
+    std::vector<rct::xmr_amount> input_amounts;
+    std::vector<rct::xmr_amount> output_amounts;
+    input_amounts.resize(params.in_count, amount_chunk);
+    output_amounts.resize(params.out_count, amount_chunk);
+
+    // put leftovers in last amount of either inputs or outputs if they don't already balance
+    if (params.in_count > params.out_count)
+        output_amounts.back() += amount_chunk*(params.in_count - params.out_count);
+    else if (params.out_count > params.in_count)
+        input_amounts.back() += amount_chunk*(params.out_count - params.in_count);
+
+    // mock params
+    mock_tx::MockTxParamPack tx_params;
+
+    tx_params.max_rangeproof_splits = params.num_rangeproof_splits;
+    tx_params.ref_set_decomp_n = params.n;
+    tx_params.ref_set_decomp_m = params.m;
+    tx_params.ref_set_bin_size = params.ref_set_bin_size;
+    tx_params.shared_ref_set = params.shared_ref_set;
+    if (params.gamma_decoys)
+        tx_params.ref_set_gamma_decoy_enotes = params.ledger_num_enotes;
+    tx_params.num_threads = params.build_threads;
+
+    if (txs_inout.size() >= num_txs)
+        return true;
+
+    // make transactions on the fixture workers
+    // - each tx stages its ref set enotes locally and adds them to the ledger in one step, offsetting its ledger
+    //   indices by the first index added before proving (the membership proofs bind those indices), so concurrent
+    //   builders only ever contend on that one add
+    // - ledger enote order (and so tx-to-index layout) varies with the number of workers; each tx stays self-consistent
+    std::vector<std::shared_ptr<MockTxType>> new_txs;
+    new_txs.resize(num_txs - txs_inout.size());
+
+    try
     {
-        static_assert(std::is_base_of<mock_tx::MockTx, MockTxType>::value, "Invalid mock tx type.");
+        if (!mock_tx::run_indexed_jobs_stealing(new_txs.size(), params.fixture_workers,
+                [&](const std::size_t tx_index)
+                {
+                    new_txs[tx_index] =
+                        mock_tx::make_mock_tx<MockTxType>(tx_params, input_amounts, output_amounts, ledger_context);
+                }
+            ))
+        {
+            return false;
+        }
+    }
+    catch (...)
+    {
+        return false;
+    }
 
-        m_txs.reserve(params.batch_size);
+    txs_inout.reserve(num_txs);
+    for (std::shared_ptr<MockTxType> &new_tx : new_txs)
+        txs_inout.emplace_back(std::move(new_tx));
 
-        // fresh mock ledger context
-        m_ledger_contex = std::make_shared<mock_tx::MockLedgerContext>();
+    return true;
+}
 
-        // divide max amount into equal-size chunks to distribute among more numerous of inputs vs outputs
-        if (params.in_count == 0 || params.out_count == 0)
+/**
+ * Mock tx fixtures on disk: a snapshot of an in-memory ledger, and the blobs of txs whose ref sets are in it
+ * - one pair of files per set of tx parameters (batch size excluded) in 'params.fixture_dir'
+ * - the first 'params.batch_size' saved txs are handed out; if there are fewer, the rest are made against the loaded
+ *   ledger and both files are rewritten, so later runs (and other machines given the files) skip building them
+ * - only for mock tx types with a blob format
+ */
+template <typename MockTxType>
+bool load_or_make_mock_tx_test_fixtures(const ParamsShuttleMockTx &params,
+    std::shared_ptr<mock_tx::LedgerContext> &ledger_context_out,
+    std::vector<std::shared_ptr<MockTxType>> &txs_out,
+    std::size_t &num_loaded_out)
+{
+    static_assert(mock_tx_has_blob_format<MockTxType>::value, "Mock tx fixtures need a tx blob format.");
+
+    std::string fixture_name{mock_tx_fixture_type_name<MockTxType>()};
+    fixture_name += "_in" + std::to_string(params.in_count);
+    fixture_name += "_out" + std::to_string(params.out_count);
+    fixture_name += "_n" + std::to_string(params.n);
+    fixture_name += "_m" + std::to_string(params.m);
+    fixture_name += "_rp" + std::to_string(params.num_rangeproof_splits);
+    fixture_name += "_bin" + std::to_string(params.ref_set_bin_size);
+    if (params.shared_ref_set)
+        fixture_name += "_shared";
+    const std::string ledger_path{params.fixture_dir + "/" + fixture_name + ".ledger"};
+    const std::string txs_path{params.fixture_dir + "/" + fixture_name + ".txs"};
+
+    if (!make_mock_tx_test_ledger(params, ledger_context_out))
+        return false;
+    const std::shared_ptr<mock_tx::MockLedgerContext> ledger_context{
+            std::dynamic_pointer_cast<mock_tx::MockLedgerContext>(ledger_context_out)
+        };
+    if (!ledger_context)
+        return false;
+
+    // load the saved txs (tx blobs, each preceded by its size), if their ledger loads
+    std::vector<std::shared_ptr<MockTxType>> txs;
+    std::vector<std::string> tx_blobs;
+
+    try
+    {
+        std::ifstream txs_file{txs_path, std::ios::binary};
+        if (txs_file && ledger_context->load(ledger_path))
+        {
+            std::uint64_t blob_size;
+            while (txs_file.read(reinterpret_cast<char*>(&blob_size), sizeof(blob_size)))
+            {
+                tx_blobs.emplace_back(blob_size, '\0');
+                if (!txs_file.read(&tx_blobs.back()[0], blob_size))
+                    return false;
+                if (txs.size() < params.batch_size)
+                    txs.emplace_back(std::make_shared<MockTxType>(tx_blobs.back()));
+            }
+        }
+    }
+    catch (...)
+    {
+        return false;
+    }
+    num_loaded_out = txs.size();
+
+    // make the missing txs (against the loaded ledger, or a fresh one), then save them and their ledger
+    if (txs.size() < params.batch_size)
+    {
+        if (!make_mock_tx_test_txs<MockTxType>(params, params.batch_size, ledger_context_out, txs))
             return false;
 
-        rct::xmr_amount amount_chunk{
-                rct::xmr_amount{static_cast<rct::xmr_amount>(-1)} / 
-                (params.in_count > params.out_count ? params.in_count : params.out_count)
-            };
+        std::ofstream txs_file{txs_path, std::ios::binary | std::ios::trunc};
+        for (std::size_t tx_index{0}; tx_index < txs.size(); ++tx_index)
+        {
+            if (tx_index >= tx_blobs.size())
+            {
+                tx_blobs.emplace_back();
+                txs[tx_index]->get_tx_byte_blob(tx_blobs.back());
+            }
+
+            const std::uint64_t blob_size{tx_blobs[tx_index].size()};
+            txs_file.write(reinterpret_cast<const char*>(&blob_size), sizeof(blob_size));
+            txs_file.write(tx_blobs[tx_index].data(), tx_blobs[tx_index].size());
+        }
+        txs_file.close();
+
+        if (!txs_file || !ledger_context->save(ledger_path))
+            return false;
+    }
+
+    txs_out = std::move(txs);
+    return true;
+}
+
+/**
+ * Cache of proven mock txs, so sweep points that differ only in batch size don't re-prove their txs
+ * - keyed on (tx type, in count, out count, n, m, rangeproof splits, shared ref set); an entry holds its txs and the ledger they
+ *   reference, and grows when a larger batch is requested
+ * - in-memory ledgers are per entry; an LMDB ledger can only be opened once per process, so all entries share it
+ * - the ledger's decompressed enote cache is cleared on every handout, so each measurement starts cold
+ * - entries are evicted least-recently-used once the cache holds more than 'max_cached_txs' txs
+ */
+class MockTxFixtureCache final
+{
+public:
+    static MockTxFixtureCache& instance()
+    {
+        static MockTxFixtureCache cache;
+        return cache;
+    }
+
+    template <typename MockTxType>
+    bool get_txs(const ParamsShuttleMockTx &params,
+        std::vector<std::shared_ptr<MockTxType>> &txs_out,
+        std::shared_ptr<mock_tx::LedgerContext> &ledger_context_out,
+        std::size_t &num_reused_out)
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
 
-        // make transactions
-        for (std::size_t tx_index{0}; tx_index < params.batch_size; ++tx_index)
+        const Key key{std::type_index{typeid(MockTxType)},
+            params.in_count,
+            params.out_count,
+            params.n,
+            params.m,
+            params.num_rangeproof_splits,
+            params.shared_ref_set};
+
+        // find or make the entry, and mark it most recently used
+        auto entry_it = std::find_if(m_entries.begin(), m_entries.end(),
+                [&key](const Entry &entry) -> bool { return entry.key == key; }
+            );
+        if (entry_it == m_entries.end())
         {
-            try
+            m_entries.emplace_front();
+            m_entries.front().key = key;
+
+            if (!params.ledger_dir.empty())
             {
-                // input and output amounts
-                std::vector<rct::xmr_amount> input_amounts;
-                std::vector<rct::xmr_amount> output_amounts;
-                input_amounts.resize(params.in_count, amount_chunk);
-                output_amounts.resize(params.out_count, amount_chunk);
-
-                // put leftovers in last amount of either inputs or outputs if they don't already balance
-                if (params.in_count > params.out_count)
-                    output_amounts.back() += amount_chunk*(params.in_count - params.out_count);
-                else if (params.out_count > params.in_count)
-                    input_amounts.back() += amount_chunk*(params.out_count - params.in_count);
-
-                // mock params
-                mock_tx::MockTxParamPack tx_params;
-                
-                tx_params.max_rangeproof_splits = params.num_rangeproof_splits;
-                tx_params.ref_set_decomp_n = params.n;
-                tx_params.ref_set_decomp_m = params.m;
-
-                // make tx
-                m_txs.emplace_back(
-                        mock_tx::make_mock_tx<MockTxType>(tx_params, input_amounts, output_amounts, m_ledger_contex)
-                    );
+                if (!m_lmdb_ledger_context && !make_mock_tx_test_ledger(params, m_lmdb_ledger_context))
+                {
+                    m_entries.pop_front();
+                    return false;
+                }
+                m_entries.front().ledger_context = m_lmdb_ledger_context;
             }
-            catch (...)
+            else if (!make_mock_tx_test_ledger(params, m_entries.front().ledger_context))
             {
+                m_entries.pop_front();
                 return false;
             }
         }
+        else
+            m_entries.splice(m_entries.begin(), m_entries, entry_it);
+
+        Entry &entry{m_entries.front()};
+
+        // top up the entry's txs
+        std::vector<std::shared_ptr<MockTxType>> txs;
+        txs.reserve(params.batch_size);
+        for (const std::shared_ptr<mock_tx::MockTx> &tx : entry.txs)
+        {
+            if (txs.size() >= params.batch_size)
+                break;
+            txs.emplace_back(std::static_pointer_cast<MockTxType>(tx));
+        }
+        num_reused_out = txs.size();
+
+        const std::size_t num_cached{txs.size()};
+        if (!make_mock_tx_test_txs<MockTxType>(params, params.batch_size, entry.ledger_context, txs))
+            return false;
+        for (std::size_t tx_index{num_cached}; tx_index < txs.size(); ++tx_index)
+            entry.txs.emplace_back(txs[tx_index]);
+        m_num_cached_txs += txs.size() - num_cached;
+
+        // hand out
+        if (auto ledger_context = std::dynamic_pointer_cast<mock_tx::MockLedgerContext>(entry.ledger_context))
+            ledger_context->clear_squashed_enote_cache();
+
+        txs_out = std::move(txs);
+        ledger_context_out = entry.ledger_context;
+
+        // evict (never the entry just handed out)
+        while (m_num_cached_txs > max_cached_txs && m_entries.size() > 1)
+        {
+            m_num_cached_txs -= m_entries.back().txs.size();
+            m_entries.pop_back();
+        }
+
+        return true;
+    }
+
+    static constexpr std::size_t max_cached_txs{1024};
+
+private:
+    using Key = std::tuple<std::type_index, std::size_t, std::size_t, std::size_t, std::size_t, std::size_t, bool>;
+
+    struct Entry final
+    {
+        Key key{std::type_index{typeid(void)}, 0, 0, 0, 0, 0, false};
+        std::vector<std::shared_ptr<mock_tx::MockTx>> txs;
+        std::shared_ptr<mock_tx::LedgerContext> ledger_context;
+    };
+
+    MockTxFixtureCache() = default;
+
+    std::mutex m_mutex;
+    std::list<Entry> m_entries;  //most recently used at the front
+    std::size_t m_num_cached_txs{0};
+    std::shared_ptr<mock_tx::LedgerContext> m_lmdb_ledger_context;
+};
+
+/**
+ * Phase timings since the last reset, as shares of a wall time (e.g. all of a test's validation runs)
+ * - phases may nest, and phases that run on several threads are summed over them, so shares can exceed 100%
+ */
+inline std::string mock_tx_phase_timings_report(const std::string &wall_time_name, const std::uint64_t wall_ns)
+{
+    const mock_tx::MockTxPhaseTimings timings{mock_tx::get_mock_tx_phase_timings()};
+
+    std::string report{"  phase timings (ms, % of " + wall_time_name + " time, calls, ns/call):\n"};
+    for (std::size_t phase_index{0}; phase_index < timings.m_ns.size(); ++phase_index)
+    {
+        if (timings.m_calls[phase_index] == 0)
+            continue;
+
+        const std::uint64_t ns{timings.m_ns[phase_index]};
+        const std::uint64_t calls{timings.m_calls[phase_index]};
+        report += std::string{"    "} +
+            mock_tx::get_mock_tx_phase_name(static_cast<mock_tx::MockTxValidationPhase>(phase_index)) + ": " +
+            std::to_string(ns / 1000000) + ", " +
+            std::to_string(wall_ns > 0 ? 100 * ns / wall_ns : 0) + "%, " +
+            std::to_string(calls) + ", " +
+            std::to_string(ns / calls) + '\n';
+    }
+
+    return report;
+}
+
+template <typename MockTxType>
+class test_mock_tx
+{
+public:
+    static const size_t loop_count = 1;
+
+    ~test_mock_tx()
+    {
+        // report ledger straus cache use (if the ledger has a straus cache)
+        const std::string report{straus_cache_report()};
+        if (!report.empty())
+            std::cout << "  " << report << '\n';
+
+        // report hash_to_p3 cache use (if this tx type verifies CLSAGs)
+        const std::string hp_report{hp_cache_report()};
+        if (!hp_report.empty())
+            std::cout << "  " << hp_report << '\n';
+
+        // report validation phase timings (if requested)
+        if (m_phase_timings)
+            std::cout << phase_timings_report();
+    }
+
+    bool init(const ParamsShuttleMockTx &params)
+    {
+        static_assert(std::is_base_of<mock_tx::MockTx, MockTxType>::value, "Invalid mock tx type.");
+
+        m_num_threads = params.num_threads;
+        m_from_blobs = params.from_blobs && mock_tx_has_blob_format<MockTxType>::value;
+        m_phase_timings = params.phase_timings && mock_tx::mock_tx_phase_timers_enabled();
+        m_warm_hp_cache = params.warm_hp_cache;
+
+        // reuse previously proven txs, or make a fresh ledger and txs
+        const auto build_start = std::chrono::steady_clock::now();
+        std::size_t num_reused_txs{0};
+        std::size_t num_loaded_txs{0};
+        const bool use_fixtures{
+                !params.fixture_dir.empty() && params.ledger_dir.empty() && mock_tx_has_blob_format<MockTxType>::value
+            };
+        if (use_fixtures)
+        {
+            if (!load_fixtures(params, num_loaded_txs, mock_tx_has_blob_format<MockTxType>{}))
+                return false;
+        }
+        else if (params.reuse_txs)
+        {
+            if (!MockTxFixtureCache::instance().get_txs<MockTxType>(params, m_txs, m_ledger_contex, num_reused_txs))
+                return false;
+        }
+        else
+        {
+            if (!make_mock_tx_test_ledger(params, m_ledger_contex))
+                return false;
+            if (!make_mock_tx_test_txs<MockTxType>(params, params.batch_size, m_ledger_contex, m_txs))
+                return false;
+        }
+        const auto build_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - build_start
+            ).count();
 
         // report tx info
         std::string report;
@@ -308,10 +720,45 @@ public:
         report += std::string{"inputs: "} + std::to_string(params.in_count) + " || ";
         report += std::string{"outputs: "} + std::to_string(params.out_count) + " || ";
         report += std::string{"ref set size ("} + std::to_string(params.n) + "^" + std::to_string(params.m) + "): ";
-        report += std::to_string(mock_tx::ref_set_size_from_decomp(params.n, params.m));
+        report += std::to_string(mock_tx::ref_set_size_from_decomp(params.n, params.m)) + " || ";
+        report += std::string{"threads: "} + std::to_string(params.num_threads) + " || ";
+        report += std::string{"runner threads: "} + std::to_string(params.core_params.threads) + " || ";
+        report += std::string{"ledger: "} + (params.ledger_dir.empty() ? "memory" : "lmdb");
+        if (use_fixtures)
+            report += std::string{" || fixture txs loaded: "} + std::to_string(num_loaded_txs);
+        else if (params.reuse_txs)
+            report += std::string{" || reused txs: "} + std::to_string(num_reused_txs);
+        if (params.ledger_dir.empty() && params.ledger_straus_cache_points > 0)
+            report += std::string{" || straus cache points: "} + std::to_string(params.ledger_straus_cache_points);
+        if (params.ref_set_bin_size > 0)
+            report += std::string{" || ref set bin size: "} + std::to_string(params.ref_set_bin_size);
+        if (params.gamma_decoys)
+            report += " || gamma decoys";
+        if (params.shared_ref_set)
+            report += " || shared ref set";
+        report += std::string{" || build threads: "} + std::to_string(params.build_threads);
+        report += std::string{" || build time (ms): "} + std::to_string(build_ms);
+        if (m_from_blobs)
+            report += " || from blobs";
+        if (m_warm_hp_cache)
+            report += " || warm Hp cache";
 
         std::cout << report << '\n';
 
+        // serialize the txs (they are parsed back out in each test run)
+        if (m_from_blobs && !make_tx_blobs(mock_tx_has_blob_format<MockTxType>{}))
+            return false;
+
+        // save tx info for structured results
+        m_record_info.descriptor = m_txs.back()->get_descriptor() + (params.shared_ref_set ? " shared refs" : "");
+        m_record_info.batch_size = params.batch_size;
+        m_record_info.in_count = params.in_count;
+        m_record_info.out_count = params.out_count;
+        m_record_info.n = params.n;
+        m_record_info.m = params.m;
+        m_record_info.rangeproof_splits = params.num_rangeproof_splits;
+        m_record_info.tx_bytes = m_txs.back()->get_size_bytes();
+
         // add the info report to timings database so it is saved to file
         if (params.core_params.td.get())
         {
@@ -328,27 +775,298 @@ public:
             report_csv += std::to_string(params.out_count) + separator;
             report_csv += std::to_string(params.n) + separator;
             report_csv += std::to_string(params.m) + separator;
-            report_csv += std::to_string(mock_tx::ref_set_size_from_decomp(params.n, params.m));
+            report_csv += std::to_string(mock_tx::ref_set_size_from_decomp(params.n, params.m)) + separator;
+            report_csv += std::to_string(params.num_threads) + separator;
+            report_csv += std::to_string(params.core_params.threads) + separator;
+            report_csv += params.ledger_dir.empty() ? "memory" : "lmdb";
 
             params.core_params.td->add(report_csv.c_str(), null_instance);
         }
 
+        // only time this test's validation runs (building the txs may validate them too)
+        if (m_phase_timings)
+            mock_tx::reset_mock_tx_phase_timings();
+        rct::get_hash_to_p3_cache().clear();
+        rct::get_hash_to_p3_cache().reset_stats();
+
         return true;
     }
 
     bool test()
     {
+        if (!m_warm_hp_cache)
+            rct::get_hash_to_p3_cache().clear();
+
+        const auto validate_start = std::chrono::steady_clock::now();
+        bool result{false};
+
         try
         {
-            return mock_tx::validate_mock_txs<MockTxType>(m_txs, m_ledger_contex);
+            if (m_from_blobs)
+                result = validate_tx_blobs(mock_tx_has_blob_format<MockTxType>{});
+            else
+                result = mock_tx::validate_mock_txs<MockTxType>(m_txs, m_ledger_contex, m_num_threads);
         }
         catch (...)
         {
-            return false;
+            result = false;
+        }
+
+        if (m_phase_timings)
+        {
+            m_validate_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - validate_start
+                ).count();
         }
+
+        return result;
+    }
+
+    // validation phase timings over all of this test's runs, as shares of the validation wall time
+    std::string phase_timings_report() const
+    {
+        return mock_tx_phase_timings_report("validation", m_validate_ns);
+    }
+
+    // ledger straus cache use over all of this test's runs (e.g. "hits 100, misses 20, hit rate 0.83, saved (ms) 4")
+    std::string straus_cache_report() const
+    {
+        const rct::straus_point_cache *straus_cache{
+                m_ledger_contex ? m_ledger_contex->get_squashed_enote_straus_cache_sp_v2() : nullptr
+            };
+        if (!straus_cache)
+            return "";
+
+        const rct::straus_point_cache_stats stats{straus_cache->get_stats()};
+        return std::string{"straus cache: hits "} + std::to_string(stats.hits) +
+            ", misses " + std::to_string(stats.misses) +
+            ", evictions " + std::to_string(stats.evictions) +
+            ", hit rate " + std::to_string(stats.hit_rate()) +
+            ", saved (ms) " + std::to_string(stats.saved_ns / 1000000);
+    }
+
+    // hash_to_p3 cache use over all of this test's runs (e.g. "hash_to_p3 cache: hits 100, misses 20, hit rate 0.83")
+    std::string hp_cache_report() const
+    {
+        const rct::hash_to_p3_cache_stats stats{rct::get_hash_to_p3_cache().get_stats()};
+        if (stats.hits + stats.misses == 0)
+            return "";
+
+        return std::string{"hash_to_p3 cache: hits "} + std::to_string(stats.hits) +
+            ", misses " + std::to_string(stats.misses) +
+            ", evictions " + std::to_string(stats.evictions) +
+            ", hit rate " + std::to_string(stats.hit_rate());
+    }
+
+    // tx info for structured results (run results are filled in by the runner)
+    void get_record_info(PerfTestRecord &record) const
+    {
+        record = m_record_info;
     }
 
 private:
+    bool load_fixtures(const ParamsShuttleMockTx &params, std::size_t &num_loaded_txs_out, std::true_type)
+    {
+        return load_or_make_mock_tx_test_fixtures<MockTxType>(params, m_ledger_contex, m_txs, num_loaded_txs_out);
+    }
+    bool load_fixtures(const ParamsShuttleMockTx&, std::size_t&, std::false_type) { return false; }
+
+    bool make_tx_blobs(std::true_type)
+    {
+        m_tx_blobs.clear();
+        m_tx_blobs.reserve(m_txs.size());
+        for (const std::shared_ptr<MockTxType> &tx : m_txs)
+        {
+            m_tx_blobs.emplace_back();
+            tx->get_tx_byte_blob(m_tx_blobs.back());
+        }
+
+        return true;
+    }
+    bool make_tx_blobs(std::false_type) { return false; }
+
+    bool validate_tx_blobs(std::true_type) const
+    {
+        std::vector<std::shared_ptr<MockTxType>> parsed_txs;
+        parsed_txs.reserve(m_tx_blobs.size());
+        for (const std::string &tx_blob : m_tx_blobs)
+            parsed_txs.emplace_back(std::make_shared<MockTxType>(tx_blob));
+
+        return mock_tx::validate_mock_txs<MockTxType>(parsed_txs, m_ledger_contex, m_num_threads);
+    }
+    bool validate_tx_blobs(std::false_type) const { return false; }
+
+protected:
     std::vector<std::shared_ptr<MockTxType>> m_txs;
-    std::shared_ptr<mock_tx::MockLedgerContext> m_ledger_contex;
+    std::vector<std::string> m_tx_blobs;
+    std::shared_ptr<mock_tx::LedgerContext> m_ledger_contex;
+    std::size_t m_num_threads{1};
+    bool m_from_blobs{false};
+    bool m_phase_timings{false};
+    bool m_warm_hp_cache{false};
+    std::uint64_t m_validate_ns{0};
+    PerfTestRecord m_record_info;
+};
+
+/**
+ * Single tx admission latency: validate one tx at a time without batching (as on mempool admission), back to back
+ * - cycles through the test's txs, so the batch size sets how many distinct txs are admitted
+ * - meant for tail-latency mode (--latency-histogram), e.g. with a large --loop-multiplier, and --threads for load
+ */
+template <typename MockTxType>
+class test_mock_tx_admission final : public test_mock_tx<MockTxType>
+{
+public:
+    bool test()
+    {
+        const std::shared_ptr<MockTxType> &tx{this->m_txs[m_next_tx_index++ % this->m_txs.size()]};
+
+        try
+        {
+            return tx->validate(this->m_ledger_contex);
+        }
+        catch (...)
+        {
+            return false;
+        }
+    }
+
+private:
+    std::size_t m_next_tx_index{0};
+};
+
+/**
+ * Unbatchable validation steps (semantics, linking tags, amount balance, unbatched input proofs) of each tx in a batch
+ * - static dispatch: mock_tx::validate_mock_tx<MockTxType>() (as used by batch validation)
+ * - virtual dispatch: MockTx::validate(), where each step goes through the vtable
+ */
+template <typename MockTxType, bool static_dispatchV>
+class test_mock_tx_unbatchable final : public test_mock_tx<MockTxType>
+{
+public:
+    static const size_t loop_count = 1000;
+
+    bool test()
+    {
+        try
+        {
+            for (const std::shared_ptr<MockTxType> &tx : this->m_txs)
+            {
+                if (static_dispatchV)
+                {
+                    if (!mock_tx::validate_mock_tx(*tx, this->m_ledger_contex, true))
+                        return false;
+                }
+                else if (!tx->mock_tx::MockTx::validate(this->m_ledger_contex, true))
+                    return false;
+            }
+        }
+        catch (...)
+        {
+            return false;
+        }
+
+        return true;
+    }
+};
+
+/**
+ * Tx proving: make a batch of txs with make_mock_tx() in each test run (validation is not timed)
+ * - the txs' ref sets go into one ledger made up front (pre-populated if on disk); it grows over the test's runs
+ * - inputs are proven on --mock-tx-build-threads threads
+ * - with --mock-tx-phase-timings, the proving time is broken down into ref set building and the proofs (membership,
+ *   range, composition)
+ */
+template <typename MockTxType>
+class test_mock_tx_prove final
+{
+public:
+    static const size_t loop_count = 1;
+
+    ~test_mock_tx_prove()
+    {
+        // report proving phase timings (if requested)
+        if (m_phase_timings)
+            std::cout << mock_tx_phase_timings_report("proving", m_prove_ns);
+    }
+
+    bool init(const ParamsShuttleMockTx &params)
+    {
+        static_assert(std::is_base_of<mock_tx::MockTx, MockTxType>::value, "Invalid mock tx type.");
+
+        m_params = params;
+        m_phase_timings = params.phase_timings && mock_tx::mock_tx_phase_timers_enabled();
+
+        // make the ledger, and one batch for the tx info
+        std::vector<std::shared_ptr<MockTxType>> txs;
+        if (!make_mock_tx_test_ledger(params, m_ledger_context))
+            return false;
+        if (!make_mock_tx_test_txs<MockTxType>(params, params.batch_size, m_ledger_context, txs))
+            return false;
+
+        // report tx info
+        std::string report;
+        report += txs.back()->get_descriptor() + " || prove || ";
+        report += std::string{"Size (bytes): "} + std::to_string(txs.back()->get_size_bytes()) + " || ";
+        report += std::string{"batch size: "} + std::to_string(params.batch_size) + " || ";
+        report += std::string{"rangeproof split: "} + std::to_string(params.num_rangeproof_splits) + " || ";
+        report += std::string{"inputs: "} + std::to_string(params.in_count) + " || ";
+        report += std::string{"outputs: "} + std::to_string(params.out_count) + " || ";
+        report += std::string{"ref set size ("} + std::to_string(params.n) + "^" + std::to_string(params.m) + "): ";
+        report += std::to_string(mock_tx::ref_set_size_from_decomp(params.n, params.m)) + " || ";
+        report += std::string{"build threads: "} + std::to_string(params.build_threads) + " || ";
+        report += std::string{"ledger: "} + (params.ledger_dir.empty() ? "memory" : "lmdb");
+        if (params.ref_set_bin_size > 0)
+            report += std::string{" || ref set bin size: "} + std::to_string(params.ref_set_bin_size);
+        if (params.gamma_decoys)
+            report += " || gamma decoys";
+
+        std::cout << report << '\n';
+
+        // save tx info for structured results
+        m_record_info.descriptor = txs.back()->get_descriptor() + " prove";
+        m_record_info.batch_size = params.batch_size;
+        m_record_info.in_count = params.in_count;
+        m_record_info.out_count = params.out_count;
+        m_record_info.n = params.n;
+        m_record_info.m = params.m;
+        m_record_info.rangeproof_splits = params.num_rangeproof_splits;
+        m_record_info.tx_bytes = txs.back()->get_size_bytes();
+
+        // only time this test's proving runs
+        if (m_phase_timings)
+            mock_tx::reset_mock_tx_phase_timings();
+
+        return true;
+    }
+
+    bool test()
+    {
+        const auto prove_start = std::chrono::steady_clock::now();
+
+        std::vector<std::shared_ptr<MockTxType>> txs;
+        const bool result{make_mock_tx_test_txs<MockTxType>(m_params, m_params.batch_size, m_ledger_context, txs)};
+
+        if (m_phase_timings)
+        {
+            m_prove_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - prove_start
+                ).count();
+        }
+
+        return result;
+    }
+
+    // tx info for structured results (run results are filled in by the runner)
+    void get_record_info(PerfTestRecord &record) const
+    {
+        record = m_record_info;
+    }
+
+private:
+    ParamsShuttleMockTx m_params;
+    std::shared_ptr<mock_tx::LedgerContext> m_ledger_context;
+    bool m_phase_timings{false};
+    std::uint64_t m_prove_ns{0};
+    PerfTestRecord m_record_info;
 };
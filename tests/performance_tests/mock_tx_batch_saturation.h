@@ -0,0 +1,281 @@
+// Copyright (c) 2021, The Monero Project
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this list of
+//    conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list
+//    of conditions and the following disclaimer in the documentation and/or other
+//    materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its contributors may be
+//    used to endorse or promote products derived from this software without specific
+//    prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+// THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include "mock_tx.h"
+#include "mock_tx_sweep.h"
+#include "performance_tests.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+
+/**
+ * Mock tx batch size saturation search
+ * - for each tx type and sweep point, finds the batch size where per-tx verification cost flattens out (the knee)
+ * - batch sizes are doubled from 1 until doubling saves less than 'threshold' of the per-tx cost, then the knee is
+ *   bisected between the last two sizes; the knee is the smallest batch size whose doubling saves less than that
+ * - each batch size is timed with one validate_mock_txs() call on the first txs of one pool (best of several runs),
+ *   so all sizes of a sweep point share their txs and ledger
+ */
+namespace mock_tx_batch_saturation_detail
+{
+template <typename MockTxType>
+class MockTxBatchSaturationSearch final
+{
+public:
+//constructors
+    MockTxBatchSaturationSearch(const ParamsShuttleMockTx &params, const std::size_t reps) :
+            m_params{params},
+            m_reps{reps > 0 ? reps : 1}
+    {}
+
+//member functions
+    /// find the knee (0 if doubling still saves at least 'threshold' at 'max_batch_size')
+    bool find_knee(const double threshold, const std::size_t max_batch_size, std::size_t &knee_out)
+    {
+        knee_out = 0;
+
+        // doubling: stop at the first batch size whose doubling doesn't pay off
+        std::size_t batch_size{1};
+        bool saturated{false};
+        for (; 2*batch_size <= max_batch_size; batch_size *= 2)
+        {
+            if (!doubling_saves_less(batch_size, threshold, saturated))
+                return false;
+            if (saturated)
+                break;
+        }
+        if (!saturated)
+            return true;
+
+        // refining: the knee is in (batch_size/2, batch_size]
+        std::size_t not_saturated{batch_size/2};
+        while (batch_size - not_saturated > 1)
+        {
+            const std::size_t mid{not_saturated + (batch_size - not_saturated)/2};
+            if (!doubling_saves_less(mid, threshold, saturated))
+                return false;
+            if (saturated)
+                batch_size = mid;
+            else
+                not_saturated = mid;
+        }
+
+        knee_out = batch_size;
+        return true;
+    }
+
+    /// measured batch sizes and their per-tx verification times (ns)
+    const std::map<std::size_t, double>& get_curve() const { return m_ns_per_tx; }
+
+private:
+    bool doubling_saves_less(const std::size_t batch_size, const double threshold, bool &saves_less_out)
+    {
+        double ns_per_tx{0};
+        double ns_per_tx_doubled{0};
+        if (!measure(batch_size, ns_per_tx) || !measure(2*batch_size, ns_per_tx_doubled))
+            return false;
+
+        saves_less_out = ns_per_tx <= 0 || (ns_per_tx - ns_per_tx_doubled)/ns_per_tx < threshold;
+        return true;
+    }
+
+    bool measure(const std::size_t batch_size, double &ns_per_tx_out)
+    {
+        const auto cached = m_ns_per_tx.find(batch_size);
+        if (cached != m_ns_per_tx.end())
+        {
+            ns_per_tx_out = cached->second;
+            return true;
+        }
+
+        // grow the tx pool (its txs' ref sets go into one ledger)
+        if (!m_ledger_context && !make_mock_tx_test_ledger(m_params, m_ledger_context))
+            return false;
+        if (!make_mock_tx_test_txs<MockTxType>(m_params, batch_size, m_ledger_context, m_txs))
+            return false;
+
+        const std::vector<std::shared_ptr<MockTxType>> batch{m_txs.begin(), m_txs.begin() + batch_size};
+
+        // best of 'reps' (the minimum is the least noisy estimate of the cost itself)
+        uint64_t best_ns{static_cast<uint64_t>(-1)};
+        performance_timer timer;
+        for (std::size_t rep{0}; rep < m_reps; ++rep)
+        {
+            timer.start();
+            if (!mock_tx::validate_mock_txs<MockTxType>(batch, m_ledger_context, m_params.num_threads))
+                return false;
+            best_ns = std::min(best_ns, timer.elapsed_ns());
+        }
+
+        ns_per_tx_out = static_cast<double>(best_ns) / batch_size;
+        m_ns_per_tx[batch_size] = ns_per_tx_out;
+        return true;
+    }
+
+//member variables
+    const ParamsShuttleMockTx m_params;
+    const std::size_t m_reps;
+    std::shared_ptr<mock_tx::LedgerContext> m_ledger_context;
+    std::vector<std::shared_ptr<MockTxType>> m_txs;
+    std::map<std::size_t, double> m_ns_per_tx;
+};
+
+template <typename MockTxType>
+bool find_batch_saturation(const ParamsShuttleMockTx &params,
+    const std::size_t reps,
+    const double threshold,
+    const std::size_t max_batch_size,
+    std::map<std::size_t, double> &curve_out,
+    std::size_t &knee_out)
+{
+    MockTxBatchSaturationSearch<MockTxType> search{params, reps};
+    if (!search.find_knee(threshold, max_batch_size, knee_out))
+        return false;
+
+    curve_out = search.get_curve();
+    return true;
+}
+
+inline bool find_batch_saturation(const std::string &tx_type,
+    const ParamsShuttleMockTx &params,
+    const std::size_t reps,
+    const double threshold,
+    const std::size_t max_batch_size,
+    std::map<std::size_t, double> &curve_out,
+    std::size_t &knee_out)
+{
+    if (tx_type == "MockTxCLSAG")
+        return find_batch_saturation<mock_tx::MockTxCLSAG>(params, reps, threshold, max_batch_size, curve_out,
+            knee_out);
+    else if (tx_type == "MockTxTriptych")
+        return find_batch_saturation<mock_tx::MockTxTriptych>(params, reps, threshold, max_batch_size, curve_out,
+            knee_out);
+    else if (tx_type == "MockTxSpConciseV1")
+        return find_batch_saturation<mock_tx::MockTxSpConciseV1>(params, reps, threshold, max_batch_size, curve_out,
+            knee_out);
+    else if (tx_type == "MockTxSpMergeV1")
+        return find_batch_saturation<mock_tx::MockTxSpMergeV1>(params, reps, threshold, max_batch_size, curve_out,
+            knee_out);
+    else if (tx_type == "MockTxSpPlainV1")
+        return find_batch_saturation<mock_tx::MockTxSpPlainV1>(params, reps, threshold, max_batch_size, curve_out,
+            knee_out);
+    else if (tx_type == "MockTxSpSquashedV1")
+        return find_batch_saturation<mock_tx::MockTxSpSquashedV1>(params, reps, threshold, max_batch_size, curve_out,
+            knee_out);
+
+    return false;
+}
+} //namespace mock_tx_batch_saturation_detail
+
+/// sweep points for the saturation search when there is no --sweep file: 2-in/2-out txs with 2^4 and 2^7 ref sets
+inline MockTxSweep make_default_batch_saturation_sweep()
+{
+    MockTxSweep sweep;
+    sweep.name = "batch saturation (default)";
+    sweep.tx_types = {"MockTxCLSAG", "MockTxTriptych", "MockTxSpConciseV1", "MockTxSpSquashedV1"};
+    sweep.in_counts = {2};
+    sweep.out_counts = {2};
+    sweep.decomp_n = {2};
+    sweep.decomp_m_limits = {7};
+    sweep.only_m = {4, 7};
+
+    return sweep;
+}
+
+/// the sweeps' batch sizes are ignored: each sweep point is searched once per tx type
+/// - 'threshold': per-tx saving of a doubled batch (fraction) below which the cost has flattened out
+inline bool find_mock_tx_batch_saturation(const std::vector<MockTxSweep> &sweeps,
+    ParamsShuttleMockTx &p_mock_tx,
+    const std::size_t reps,
+    const double threshold,
+    const std::size_t max_batch_size)
+{
+    using namespace mock_tx_batch_saturation_detail;
+
+    std::cout << "Mock tx batch saturation (ms per tx; knee = smallest batch size whose doubling saves < "
+        << 100*threshold << "% per tx; max batch size " << max_batch_size << ")" << std::endl;
+
+    for (MockTxSweep sweep : sweeps)
+    {
+        if (!sweep.name.empty())
+            std::cout << "Sweep: " << sweep.name << '\n';
+
+        sweep.batch_sizes = {1};
+        MockTxPerfIncrementer incrementer{sweep.make_incrementer()};
+        while (incrementer.next(p_mock_tx))
+        {
+            for (const std::string &tx_type : sweep.tx_types)
+            {
+                if (!sweep.accepts(p_mock_tx, tx_type))
+                    continue;
+
+                std::map<std::size_t, double> curve;
+                std::size_t knee{0};
+                if (!find_batch_saturation(tx_type, p_mock_tx, reps, threshold, max_batch_size, curve, knee))
+                {
+                    std::cout << "Failed to measure " << tx_type << std::endl;
+                    return false;
+                }
+
+                std::cout << "  " << tx_type
+                    << " in " << p_mock_tx.in_count
+                    << ", out " << p_mock_tx.out_count
+                    << ", ref set " << p_mock_tx.n << "^" << p_mock_tx.m
+                    << ", rp splits " << p_mock_tx.num_rangeproof_splits
+                    << " || knee ";
+                if (knee > 0)
+                    std::cout << "at batch " << knee << std::endl;
+                else
+                    std::cout << "not reached by batch " << max_batch_size << std::endl;
+
+                const double batch_1_ns_per_tx{curve.count(1) ? curve.at(1) : 0};
+                for (const auto &point : curve)
+                {
+                    std::cout << "    batch " << point.first
+                        << " || " << point.second / 1000000;
+                    if (batch_1_ns_per_tx > 0)
+                        std::cout << ", " << static_cast<int>(std::lround(100*point.second / batch_1_ns_per_tx))
+                            << "% of batch 1";
+                    std::cout << (point.first == knee ? " (knee)" : "") << '\n';
+                }
+                std::cout.flush();
+            }
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,311 @@
+// Copyright (c) 2021, The Monero Project
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this list of
+//    conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list
+//    of conditions and the following disclaimer in the documentation and/or other
+//    materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its contributors may be
+//    used to endorse or promote products derived from this software without specific
+//    prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+// THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include "mock_tx.h"
+#include "mock_tx_sweep.h"
+#include "mock_tx/mock_tx_verification_cost.h"
+#include "performance_tests.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+
+/**
+ * Mock tx verification cost model check
+ * - for each point of the --sweep file's sweeps, makes the txs like test_mock_tx, times one validate_mock_txs() call
+ *   (best of several runs) and compares it with mock_tx::MockTxVerificationCostModel's estimate for the txs
+ * - then fits the model's per-op costs to the measured times (least squares on relative error); the fitted costs
+ *   can replace the model's defaults
+ */
+namespace mock_tx_cost_model_detail
+{
+/// one sweep point: the txs' estimated ops, and the measured and predicted verification times
+struct MockTxCostObservation final
+{
+    std::string tx_type;
+    ParamsShuttleMockTx params;
+    mock_tx::MockTxVerificationOps ops;
+    double measured_ns{0};
+    double predicted_ns{0};
+};
+
+inline std::array<double, 4> get_ops_vector(const mock_tx::MockTxVerificationOps &ops)
+{
+    return {
+            static_cast<double>(ops.m_multiexp_points),
+            static_cast<double>(ops.m_generator_points),
+            static_cast<double>(ops.m_hashes),
+            static_cast<double>(ops.m_decompressions)
+        };
+}
+
+template <typename MockTxType>
+bool measure_mock_tx_cost(const ParamsShuttleMockTx &params,
+    const std::size_t reps,
+    MockTxCostObservation &observation_inout)
+{
+    std::shared_ptr<mock_tx::LedgerContext> ledger_context;
+    std::vector<std::shared_ptr<MockTxType>> txs;
+    if (!make_mock_tx_test_ledger(params, ledger_context))
+        return false;
+    if (!make_mock_tx_test_txs<MockTxType>(params, params.batch_size, ledger_context, txs))
+        return false;
+
+    // predicted cost of the whole batch
+    for (const std::shared_ptr<MockTxType> &tx : txs)
+        observation_inout.ops += tx->estimate_verification_ops();
+    observation_inout.predicted_ns = mock_tx::MockTxVerificationCostModel{}.estimate_ns(observation_inout.ops);
+
+    // measured cost: best of 'reps' (the minimum is the least noisy estimate of the cost itself)
+    uint64_t best_ns{static_cast<uint64_t>(-1)};
+    performance_timer timer;
+    for (std::size_t rep{0}; rep < reps; ++rep)
+    {
+        timer.start();
+        if (!mock_tx::validate_mock_txs<MockTxType>(txs, ledger_context, params.num_threads))
+            return false;
+        best_ns = std::min(best_ns, timer.elapsed_ns());
+    }
+    observation_inout.measured_ns = static_cast<double>(best_ns);
+
+    return true;
+}
+
+inline bool measure_mock_tx_cost(const std::string &tx_type,
+    const ParamsShuttleMockTx &params,
+    const std::size_t reps,
+    MockTxCostObservation &observation_out)
+{
+    observation_out = MockTxCostObservation{};
+    observation_out.tx_type = tx_type;
+    observation_out.params = params;
+
+    if (tx_type == "MockTxCLSAG")
+        return measure_mock_tx_cost<mock_tx::MockTxCLSAG>(params, reps, observation_out);
+    else if (tx_type == "MockTxTriptych")
+        return measure_mock_tx_cost<mock_tx::MockTxTriptych>(params, reps, observation_out);
+    else if (tx_type == "MockTxSpConciseV1")
+        return measure_mock_tx_cost<mock_tx::MockTxSpConciseV1>(params, reps, observation_out);
+    else if (tx_type == "MockTxSpMergeV1")
+        return measure_mock_tx_cost<mock_tx::MockTxSpMergeV1>(params, reps, observation_out);
+    else if (tx_type == "MockTxSpPlainV1")
+        return measure_mock_tx_cost<mock_tx::MockTxSpPlainV1>(params, reps, observation_out);
+    else if (tx_type == "MockTxSpSquashedV1")
+        return measure_mock_tx_cost<mock_tx::MockTxSpSquashedV1>(params, reps, observation_out);
+
+    return false;
+}
+
+/// least squares fit of per-op costs, weighted so each observation's relative error counts the same
+inline bool fit_mock_tx_cost_model(const std::vector<MockTxCostObservation> &observations,
+    mock_tx::MockTxVerificationCostModel &model_out)
+{
+    // normal equations: (A^T A) w = A^T 1, with rows A_i = ops_i / measured_i
+    std::array<std::array<double, 5>, 4> normal_system{};
+    for (const MockTxCostObservation &observation : observations)
+    {
+        if (observation.measured_ns <= 0)
+            continue;
+
+        std::array<double, 4> row{get_ops_vector(observation.ops)};
+        for (double &value : row)
+            value /= observation.measured_ns;
+
+        for (std::size_t i{0}; i < 4; ++i)
+        {
+            for (std::size_t j{0}; j < 4; ++j)
+                normal_system[i][j] += row[i] * row[j];
+            normal_system[i][4] += row[i];
+        }
+    }
+
+    // costs must be non-negative: solve, then pin any negative cost to 0 and re-solve without it
+    std::array<bool, 4> active{true, true, true, true};
+    std::array<double, 4> costs{};
+    bool all_non_negative{false};
+    while (!all_non_negative)
+    {
+        // gaussian elimination with partial pivoting over the active costs
+        std::array<std::array<double, 5>, 4> system{normal_system};
+        for (std::size_t i{0}; i < 4; ++i)
+        {
+            if (active[i])
+                continue;
+            system[i].fill(0);
+            system[i][i] = 1;
+            for (std::size_t j{0}; j < 4; ++j)
+            {
+                if (j != i)
+                    system[j][i] = 0;
+            }
+        }
+
+        for (std::size_t col{0}; col < 4; ++col)
+        {
+            std::size_t pivot{col};
+            for (std::size_t row{col + 1}; row < 4; ++row)
+            {
+                if (std::fabs(system[row][col]) > std::fabs(system[pivot][col]))
+                    pivot = row;
+            }
+            if (std::fabs(system[pivot][col]) < 1e-30)
+                return false;  //an op never occurs in the sweeps (or only in fixed proportion to another one)
+            std::swap(system[col], system[pivot]);
+
+            for (std::size_t row{0}; row < 4; ++row)
+            {
+                if (row == col)
+                    continue;
+                const double factor{system[row][col] / system[col][col]};
+                for (std::size_t k{col}; k < 5; ++k)
+                    system[row][k] -= factor * system[col][k];
+            }
+        }
+
+        all_non_negative = true;
+        for (std::size_t i{0}; i < 4; ++i)
+        {
+            costs[i] = system[i][4] / system[i][i];
+            if (costs[i] < 0)
+            {
+                active[i] = false;
+                all_non_negative = false;
+            }
+        }
+    }
+
+    model_out.m_ns_per_multiexp_point = costs[0];
+    model_out.m_ns_per_generator_point = costs[1];
+    model_out.m_ns_per_hash = costs[2];
+    model_out.m_ns_per_decompression = costs[3];
+
+    return true;
+}
+
+/// relative prediction error (predicted / measured - 1)
+inline double get_relative_error(const double predicted_ns, const double measured_ns)
+{
+    return measured_ns > 0 ? predicted_ns / measured_ns - 1 : 0;
+}
+
+inline void report_prediction_errors(const std::string &label,
+    const std::vector<MockTxCostObservation> &observations,
+    const mock_tx::MockTxVerificationCostModel &model)
+{
+    double sum_abs_error{0};
+    double max_abs_error{0};
+    for (const MockTxCostObservation &observation : observations)
+    {
+        const double abs_error{std::fabs(get_relative_error(model.estimate_ns(observation.ops),
+            observation.measured_ns))};
+        sum_abs_error += abs_error;
+        max_abs_error = std::max(max_abs_error, abs_error);
+    }
+
+    const std::streamsize precision{std::cout.precision()};
+    std::cout << label << ": mean |error| " << std::fixed << std::setprecision(1)
+        << (observations.empty() ? 0 : 100 * sum_abs_error / observations.size()) << "%, max |error| "
+        << 100 * max_abs_error << "% over " << observations.size() << " points" << std::endl;
+    std::cout.unsetf(std::ios_base::floatfield);
+    std::cout.precision(precision);
+}
+} //namespace mock_tx_cost_model_detail
+
+inline bool check_mock_tx_cost_model(const std::vector<MockTxSweep> &sweeps,
+    ParamsShuttleMockTx &p_mock_tx,
+    const std::size_t reps)
+{
+    using namespace mock_tx_cost_model_detail;
+
+    const mock_tx::MockTxVerificationCostModel default_model;
+    std::vector<MockTxCostObservation> observations;
+
+    std::cout << "Mock tx cost model check (ms per batch; measured = best of " << reps << " runs)" << std::endl;
+
+    for (const MockTxSweep &sweep : sweeps)
+    {
+        if (!sweep.name.empty())
+            std::cout << "Sweep: " << sweep.name << '\n';
+
+        MockTxPerfIncrementer incrementer{sweep.make_incrementer()};
+        while (incrementer.next(p_mock_tx))
+        {
+            for (const std::string &tx_type : sweep.tx_types)
+            {
+                if (!sweep.accepts(p_mock_tx, tx_type))
+                    continue;
+
+                MockTxCostObservation observation;
+                if (!measure_mock_tx_cost(tx_type, p_mock_tx, reps, observation))
+                {
+                    std::cout << "Failed to measure " << tx_type << std::endl;
+                    return false;
+                }
+
+                std::cout << "  " << tx_type
+                    << " batch " << p_mock_tx.batch_size
+                    << ", in " << p_mock_tx.in_count
+                    << ", out " << p_mock_tx.out_count
+                    << ", ref set " << p_mock_tx.n << "^" << p_mock_tx.m
+                    << ", rp splits " << p_mock_tx.num_rangeproof_splits
+                    << " || measured " << observation.measured_ns / 1000000
+                    << ", predicted " << observation.predicted_ns / 1000000
+                    << ", error " << static_cast<int>(std::lround(100 *
+                        get_relative_error(observation.predicted_ns, observation.measured_ns))) << "%" << std::endl;
+
+                observations.emplace_back(std::move(observation));
+            }
+        }
+    }
+
+    // prediction error of the default model, and of a model refitted to these measurements
+    report_prediction_errors("Default cost model", observations, default_model);
+
+    mock_tx::MockTxVerificationCostModel fitted_model;
+    if (!fit_mock_tx_cost_model(observations, fitted_model))
+    {
+        std::cout << "Not enough distinct sweep points to fit the cost model" << std::endl;
+        return true;
+    }
+
+    report_prediction_errors("Fitted cost model", observations, fitted_model);
+    std::cout << "Fitted costs (ns): multiexp point " << fitted_model.m_ns_per_multiexp_point
+        << ", generator point " << fitted_model.m_ns_per_generator_point
+        << ", hash " << fitted_model.m_ns_per_hash
+        << ", decompression " << fitted_model.m_ns_per_decompression << std::endl;
+
+    return true;
+}
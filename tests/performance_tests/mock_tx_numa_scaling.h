@@ -0,0 +1,183 @@
+// Copyright (c) 2021, The Monero Project
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this list of
+//    conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list
+//    of conditions and the following disclaimer in the documentation and/or other
+//    materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its contributors may be
+//    used to endorse or promote products derived from this software without specific
+//    prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+// THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#pragma once
+
+#include "common/numa_topology.h"
+#include "common/threadpool.h"
+#include "mock_tx.h"
+#include "mock_tx/ledger_context.h"
+#include "mock_tx/mock_tx.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+
+/**
+ * Cross-socket scaling: validation throughput on the CPUs of 1, 2, ... NUMA nodes, with and without NUMA pinning
+ * - for each node count, one validating thread per CPU of the first that many nodes; each validates a batch of txs
+ *   (batch size from the mock tx params) back to back on one shared ledger, for 'seconds'
+ * - pinned: each thread is pinned to its CPU's node, so it reads that node's replicas of the generator tables and
+ *   decompressed squashed enote cache (see tools::numa_replicated), and the threadpool's workers are pinned too;
+ *   unpinned: the scheduler places threads freely and they use the replicas of whatever node they run on
+ * - reports txs/s and the scaling efficiency relative to one node (ideal: throughput grows with the node count)
+ */
+template <typename MockTxType>
+bool run_mock_tx_numa_scaling(const ParamsShuttleMockTx &params, const std::size_t seconds)
+{
+    static_assert(std::is_base_of<mock_tx::MockTx, MockTxType>::value, "Invalid mock tx type.");
+
+    if (params.batch_size == 0 || seconds == 0)
+        return false;
+
+    const std::vector<std::vector<unsigned int>> &node_cpus = tools::get_numa_node_cpus();
+
+    // a few batches shared by the validating threads (validation only reads the txs and the ledger)
+    static constexpr std::size_t NUM_BATCHES{8};
+    std::shared_ptr<mock_tx::LedgerContext> ledger_context;
+    if (!make_mock_tx_test_ledger(params, ledger_context))
+        return false;
+
+    std::vector<std::vector<std::shared_ptr<MockTxType>>> batches(NUM_BATCHES);
+    for (std::vector<std::shared_ptr<MockTxType>> &txs : batches)
+    {
+        if (!make_mock_tx_test_txs<MockTxType>(params, params.batch_size, ledger_context, txs))
+            return false;
+    }
+
+    std::cout << "NUMA scaling (" << batches.back().back()->get_descriptor() << ", batch " << params.batch_size
+        << ", inputs: " << params.in_count << ", outputs: " << params.out_count
+        << ", ref set: " << params.n << "^" << params.m
+        << ", ledger: " << (params.ledger_dir.empty() ? "memory" : "lmdb") << ", " << seconds << " s per point)"
+        << std::endl;
+    std::cout << "  nodes: " << node_cpus.size() << " (CPUs:";
+    for (const std::vector<unsigned int> &cpus : node_cpus)
+        std::cout << " " << cpus.size();
+    std::cout << ")" << std::endl;
+    if (node_cpus.size() == 1)
+        std::cout << "  (single node: pinning only restricts threads, nothing is replicated)" << std::endl;
+
+    tools::threadpool &tpool{tools::threadpool::getInstance()};
+    const bool pool_was_pinned{tpool.get_numa_pinning()};
+    bool all_ok{true};
+
+    for (const bool pin : {false, true})
+    {
+        tpool.set_numa_pinning(pin);
+        double one_node_txs_per_second{0.0};
+
+        for (std::size_t num_nodes{1}; num_nodes <= node_cpus.size(); ++num_nodes)
+        {
+            // one thread per CPU of the first 'num_nodes' nodes
+            std::vector<std::size_t> thread_nodes;
+            for (std::size_t node{0}; node < num_nodes; ++node)
+                thread_nodes.insert(thread_nodes.end(), node_cpus[node].size(), node);
+
+            std::atomic<bool> stop{false};
+            std::atomic<bool> ok{true};
+            std::atomic<std::uint64_t> validated_batches{0};
+
+            const auto start = std::chrono::steady_clock::now();
+            std::vector<std::thread> threads;
+            threads.reserve(thread_nodes.size());
+            for (std::size_t thread_index{0}; thread_index < thread_nodes.size(); ++thread_index)
+            {
+                threads.emplace_back(
+                        [&, thread_index]()
+                        {
+                            if (pin && !tools::pin_current_thread_to_numa_node(thread_nodes[thread_index]))
+                            {
+                                ok = false;
+                                return;
+                            }
+
+                            while (!stop.load(std::memory_order_relaxed))
+                            {
+                                bool batch_ok{false};
+                                try
+                                {
+                                    batch_ok = mock_tx::validate_mock_txs<MockTxType>(
+                                        batches[thread_index % NUM_BATCHES],
+                                        ledger_context,
+                                        1);
+                                }
+                                catch (...) {}
+
+                                if (!batch_ok)
+                                {
+                                    ok = false;
+                                    return;
+                                }
+                                ++validated_batches;
+                            }
+                        }
+                    );
+            }
+
+            std::this_thread::sleep_for(std::chrono::seconds(seconds));
+            stop = true;
+            for (std::thread &thread : threads)
+                thread.join();
+            const double run_seconds{
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start)
+                        .count() / 1e9
+                };
+
+            if (!ok)
+            {
+                std::cout << "  " << (pin ? "pinned" : "unpinned") << ", " << num_nodes
+                    << " node(s): a batch failed to validate (or a thread couldn't be pinned)" << std::endl;
+                all_ok = false;
+                break;
+            }
+
+            const double txs_per_second{validated_batches * params.batch_size / run_seconds};
+            if (num_nodes == 1)
+                one_node_txs_per_second = txs_per_second;
+
+            std::cout << "  " << (pin ? "pinned  " : "unpinned") << " " << num_nodes << " node(s), "
+                << thread_nodes.size() << " threads: " << static_cast<std::uint64_t>(txs_per_second) << " txs/s";
+            if (num_nodes > 1 && one_node_txs_per_second > 0.0)
+            {
+                std::cout << " || scaling " << std::fixed << std::setprecision(2)
+                    << txs_per_second / one_node_txs_per_second << "x (efficiency "
+                    << std::setprecision(1) << 100.0 * txs_per_second / (one_node_txs_per_second * num_nodes) << "%)"
+                    << std::defaultfloat;
+            }
+            std::cout << std::endl;
+        }
+    }
+
+    tpool.set_numa_pinning(pool_was_pinned);
+    return all_ok;
+}
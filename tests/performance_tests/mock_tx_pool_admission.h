@@ -0,0 +1,180 @@
+// Copyright (c) 2021, The Monero Project
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of
+//    conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list
+//    of conditions and the following disclaimer in the documentation and/or other
+//    materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be
+//    used to endorse or promote products derived from this software without specific
+//    prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+// THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include "mock_tx.h"
+#include "mock_tx/mock_tx_pool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+
+/**
+ * Mock tx pool admission: submissions per second into a MockTxPool while it batch-verifies and admits them
+ * - a pool of txs (batch size from the mock tx params) plus one conflicting copy of each (same linking tags, other
+ *   outputs) is submitted by 'num_submitters' threads, each submitting every tx once ('interval_us' apart, 0 = back
+ *   to back), so most submissions are duplicates or conflicts
+ * - meanwhile this thread calls process_admissions(), which verifies pending txs at 'batch_points' multiexp points
+ *   or after 'batch_delay_ms'
+ * - then half of the admitted txs are added to the ledger through the pool, and the conflicting copies of the other
+ *   half (each evicting its admitted original)
+ */
+template <typename MockTxType>
+bool run_mock_tx_pool_admission(const ParamsShuttleMockTx &params,
+    const std::size_t num_submitters,
+    const std::size_t interval_us,
+    const std::size_t batch_points,
+    const std::size_t batch_delay_ms)
+{
+    std::shared_ptr<mock_tx::LedgerContext> ledger_context;
+    std::vector<std::shared_ptr<MockTxType>> txs;
+    if (!make_mock_tx_test_ledger(params, ledger_context) ||
+        !make_mock_tx_test_txs<MockTxType>(params, params.batch_size, ledger_context, txs) ||
+        txs.empty() ||
+        num_submitters == 0)
+        return false;
+
+    // conflicting copies: the same linking tags with a different output
+    const std::size_t num_txs{txs.size()};
+    for (std::size_t tx_index{0}; tx_index < num_txs; ++tx_index)
+    {
+        txs.emplace_back(std::make_shared<MockTxType>(*txs[tx_index]));
+        txs.back()->m_outputs[0].m_onetime_address = rct::pkGen();
+    }
+
+    std::cout << "Mock tx pool admission (" << txs.front()->get_descriptor() << ", " << num_txs << " txs + "
+        << num_txs << " conflicting copies, " << num_submitters << " submitters, interval (us): " << interval_us
+        << ", batch: " << batch_points << " points or " << batch_delay_ms << " ms, inputs: " << params.in_count
+        << ", outputs: " << params.out_count << ", ref set: " << params.n << "^" << params.m << ")" << std::endl;
+
+    mock_tx::MockTxPool<MockTxType> tx_pool{ledger_context,
+        batch_points,
+        std::chrono::milliseconds{batch_delay_ms},
+        params.num_threads};
+
+    // submitters start at different txs, so originals and their copies race each other
+    std::atomic<std::size_t> num_submitters_done{0};
+    std::vector<std::chrono::steady_clock::time_point> submitter_ends(num_submitters);
+    std::vector<std::thread> submitters;
+    const auto submit_start = std::chrono::steady_clock::now();
+    for (std::size_t submitter_index{0}; submitter_index < num_submitters; ++submitter_index)
+    {
+        submitters.emplace_back(
+                [&, submitter_index]()
+                {
+                    auto next_submit = std::chrono::steady_clock::now();
+                    for (std::size_t i{0}; i < txs.size(); ++i)
+                    {
+                        tx_pool.submit_tx(txs[(i + submitter_index*num_txs/num_submitters) % txs.size()]);
+
+                        if (interval_us > 0)
+                        {
+                            next_submit += std::chrono::microseconds(interval_us);
+                            std::this_thread::sleep_until(next_submit);
+                        }
+                    }
+                    submitter_ends[submitter_index] = std::chrono::steady_clock::now();
+                    ++num_submitters_done;
+                }
+            );
+    }
+
+    while (true)
+    {
+        const bool submitters_done{num_submitters_done == num_submitters};
+        if (tx_pool.process_admissions(submitters_done) == 0)
+        {
+            if (submitters_done)
+                break;
+            std::this_thread::sleep_for(std::chrono::milliseconds{1});
+        }
+    }
+    const auto admit_end = std::chrono::steady_clock::now();
+
+    for (std::thread &submitter : submitters)
+        submitter.join();
+    const auto submit_end = *std::max_element(submitter_ends.begin(), submitter_ends.end());
+
+    std::vector<std::shared_ptr<MockTxType>> admitted_txs;
+    tx_pool.get_admitted_txs(admitted_txs);
+    const mock_tx::MockTxPoolStats admission_stats{tx_pool.get_stats()};
+    if (admission_stats.m_invalid != 0 || admitted_txs.size() != num_txs)
+        return false;
+
+    // include half of the admitted txs, and conflicting copies of the others
+    const auto include_start = std::chrono::steady_clock::now();
+    try
+    {
+        for (std::size_t tx_index{0}; tx_index < admitted_txs.size(); ++tx_index)
+        {
+            if (tx_index % 2 == 0)
+            {
+                tx_pool.add_tx_to_ledger(*admitted_txs[tx_index]);
+                continue;
+            }
+
+            MockTxType conflicting_tx{*admitted_txs[tx_index]};
+            conflicting_tx.m_outputs[0].m_onetime_address = rct::pkGen();
+            tx_pool.add_tx_to_ledger(conflicting_tx);
+        }
+    }
+    catch (...)
+    {
+        return false;
+    }
+    const auto include_end = std::chrono::steady_clock::now();
+
+    const mock_tx::MockTxPoolStats stats{tx_pool.get_stats()};
+    if (tx_pool.num_txs() != 0)
+        return false;
+
+    const auto seconds = [](const std::chrono::steady_clock::duration duration) -> double
+        {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count() / 1e9;
+        };
+
+    std::cout << "  submitted: " << stats.m_submitted << " in " << seconds(submit_end - submit_start) << " s || "
+        << static_cast<uint64_t>(stats.m_submitted / seconds(submit_end - submit_start)) << " submissions/s\n";
+    std::cout << "    pending: " << stats.m_submitted - stats.m_duplicates - stats.m_conflicts - stats.m_spent
+        << ", duplicates: " << stats.m_duplicates << ", conflicts: " << stats.m_conflicts << ", spent: "
+        << stats.m_spent << '\n';
+    std::cout << "  admitted: " << stats.m_admitted << " in " << seconds(admit_end - submit_start) << " s || "
+        << static_cast<uint64_t>(stats.m_admitted / seconds(admit_end - submit_start)) << " txs/s\n";
+    std::cout << "  added to ledger: " << admitted_txs.size() << " in " << seconds(include_end - include_start)
+        << " s || included: " << stats.m_included << ", evicted: " << stats.m_evicted << '\n';
+    std::cout.flush();
+
+    return true;
+}
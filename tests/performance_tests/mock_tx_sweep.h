@@ -0,0 +1,334 @@
+// Copyright (c) 2021, The Monero Project
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this list of
+//    conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list
+//    of conditions and the following disclaimer in the documentation and/or other
+//    materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its contributors may be
+//    used to endorse or promote products derived from this software without specific
+//    prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+// THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include "mock_tx.h"
+#include "performance_tests.h"
+
+#include <boost/algorithm/string.hpp>
+#include <boost/property_tree/ini_parser.hpp>
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <vector>
+
+
+/**
+ * One mock tx parameter sweep, loaded from a --sweep file
+ * - the grid is iterated with MockTxPerfIncrementer, in the same order as the built-in test sets
+ * - filters drop grid points before any tx is made (they replace the hand-written 'if (p_mock_tx.m == 7)' conditions)
+ */
+struct MockTxSweep final
+{
+    std::string name;
+    std::vector<std::string> tx_types;
+
+    // grid
+    std::vector<std::size_t> batch_sizes{1};
+    std::vector<std::size_t> rangeproof_splits{0};
+    std::vector<std::size_t> in_counts;
+    std::vector<std::size_t> out_counts;
+    std::vector<std::size_t> decomp_n;
+    std::vector<std::size_t> decomp_m_limits;
+
+    // filters
+    std::size_t min_n{0};
+    std::size_t max_n{static_cast<std::size_t>(-1)};
+    std::size_t min_m{0};
+    std::size_t max_m{static_cast<std::size_t>(-1)};
+    std::vector<std::size_t> only_m;  //empty = any m
+    // skip rangeproof splits > (range proofs per tx)/2 (squashed model: inputs and outputs have range proofs)
+    bool limit_rangeproof_splits{false};
+
+    MockTxPerfIncrementer make_incrementer() const
+    {
+        return {batch_sizes, rangeproof_splits, in_counts, out_counts, decomp_n, decomp_m_limits};
+    }
+
+    bool accepts(const ParamsShuttleMockTx &params, const std::string &tx_type) const
+    {
+        if (limit_rangeproof_splits)
+        {
+            const std::size_t num_range_proofs{
+                    tx_type == "MockTxSpSquashedV1" ? params.in_count + params.out_count : params.out_count
+                };
+            if (params.num_rangeproof_splits > num_range_proofs/2)
+                return false;
+        }
+
+        if (params.n < min_n || params.n > max_n)
+            return false;
+        if (params.m < min_m || params.m > max_m)
+            return false;
+        if (!only_m.empty() && std::find(only_m.begin(), only_m.end(), params.m) == only_m.end())
+            return false;
+
+        return true;
+    }
+};
+
+/// run one sweep point for a tx type by name (returns false if the name is unknown)
+inline bool run_mock_tx_sweep_point(const std::string &filter,
+    ParamsShuttleMockTx &p_mock_tx,
+    const std::string &tx_type)
+{
+    if (p_mock_tx.prove)
+    {
+        if (tx_type == "MockTxCLSAG")
+            TEST_PERFORMANCE1(filter, p_mock_tx, test_mock_tx_prove, mock_tx::MockTxCLSAG);
+        else if (tx_type == "MockTxTriptych")
+            TEST_PERFORMANCE1(filter, p_mock_tx, test_mock_tx_prove, mock_tx::MockTxTriptych);
+        else if (tx_type == "MockTxSpConciseV1")
+            TEST_PERFORMANCE1(filter, p_mock_tx, test_mock_tx_prove, mock_tx::MockTxSpConciseV1);
+        else if (tx_type == "MockTxSpMergeV1")
+            TEST_PERFORMANCE1(filter, p_mock_tx, test_mock_tx_prove, mock_tx::MockTxSpMergeV1);
+        else if (tx_type == "MockTxSpPlainV1")
+            TEST_PERFORMANCE1(filter, p_mock_tx, test_mock_tx_prove, mock_tx::MockTxSpPlainV1);
+        else if (tx_type == "MockTxSpSquashedV1")
+            TEST_PERFORMANCE1(filter, p_mock_tx, test_mock_tx_prove, mock_tx::MockTxSpSquashedV1);
+        else
+            return false;
+
+        return true;
+    }
+
+    if (tx_type == "MockTxCLSAG")
+        TEST_PERFORMANCE1(filter, p_mock_tx, test_mock_tx, mock_tx::MockTxCLSAG);
+    else if (tx_type == "MockTxTriptych")
+        TEST_PERFORMANCE1(filter, p_mock_tx, test_mock_tx, mock_tx::MockTxTriptych);
+    else if (tx_type == "MockTxSpConciseV1")
+        TEST_PERFORMANCE1(filter, p_mock_tx, test_mock_tx, mock_tx::MockTxSpConciseV1);
+    else if (tx_type == "MockTxSpMergeV1")
+        TEST_PERFORMANCE1(filter, p_mock_tx, test_mock_tx, mock_tx::MockTxSpMergeV1);
+    else if (tx_type == "MockTxSpPlainV1")
+        TEST_PERFORMANCE1(filter, p_mock_tx, test_mock_tx, mock_tx::MockTxSpPlainV1);
+    else if (tx_type == "MockTxSpSquashedV1")
+        TEST_PERFORMANCE1(filter, p_mock_tx, test_mock_tx, mock_tx::MockTxSpSquashedV1);
+    else
+        return false;
+
+    return true;
+}
+
+namespace mock_tx_sweep_detail
+{
+// a list is either an array (JSON) or a comma-separated string (JSON or INI)
+inline std::vector<std::string> get_string_list(const boost::property_tree::ptree &node)
+{
+    std::vector<std::string> values;
+    if (!node.empty())
+    {
+        for (const auto &child : node)
+            values.emplace_back(boost::algorithm::trim_copy(child.second.data()));
+    }
+    else
+    {
+        boost::split(values, node.data(), boost::is_any_of(","));
+        for (std::string &value : values)
+            boost::algorithm::trim(value);
+    }
+
+    values.erase(std::remove(values.begin(), values.end(), std::string{}), values.end());
+    return values;
+}
+
+inline std::vector<std::size_t> get_size_list(const boost::property_tree::ptree &node)
+{
+    std::vector<std::size_t> values;
+    for (const std::string &value : get_string_list(node))
+        values.emplace_back(static_cast<std::size_t>(std::stoull(value)));
+    return values;
+}
+
+inline void parse_sweep(const boost::property_tree::ptree &node, MockTxSweep &sweep_inout)
+{
+    for (const auto &field : node)
+    {
+        const std::string &key{field.first};
+
+        if (key == "name")
+            sweep_inout.name = field.second.data();
+        else if (key == "tx_types")
+            sweep_inout.tx_types = get_string_list(field.second);
+        else if (key == "batch_sizes")
+            sweep_inout.batch_sizes = get_size_list(field.second);
+        else if (key == "rangeproof_splits")
+            sweep_inout.rangeproof_splits = get_size_list(field.second);
+        else if (key == "in_counts")
+            sweep_inout.in_counts = get_size_list(field.second);
+        else if (key == "out_counts")
+            sweep_inout.out_counts = get_size_list(field.second);
+        else if (key == "decomp_n")
+            sweep_inout.decomp_n = get_size_list(field.second);
+        else if (key == "decomp_m_limits")
+            sweep_inout.decomp_m_limits = get_size_list(field.second);
+        else if (key == "min_n")
+            sweep_inout.min_n = field.second.get_value<std::size_t>();
+        else if (key == "max_n")
+            sweep_inout.max_n = field.second.get_value<std::size_t>();
+        else if (key == "min_m")
+            sweep_inout.min_m = field.second.get_value<std::size_t>();
+        else if (key == "max_m")
+            sweep_inout.max_m = field.second.get_value<std::size_t>();
+        else if (key == "only_m")
+            sweep_inout.only_m = get_size_list(field.second);
+        else if (key == "limit_rangeproof_splits")
+            sweep_inout.limit_rangeproof_splits = field.second.get_value<bool>();
+        else
+            throw std::runtime_error{"unknown key '" + key + "'"};
+    }
+}
+
+inline std::string validate_sweep(const MockTxSweep &sweep)
+{
+    static const std::vector<std::string> known_tx_types{
+            "MockTxCLSAG",
+            "MockTxTriptych",
+            "MockTxSpConciseV1",
+            "MockTxSpMergeV1",
+            "MockTxSpPlainV1",
+            "MockTxSpSquashedV1"
+        };
+
+    if (sweep.tx_types.empty())
+        return "no tx_types";
+    for (const std::string &tx_type : sweep.tx_types)
+    {
+        if (std::find(known_tx_types.begin(), known_tx_types.end(), tx_type) == known_tx_types.end())
+            return "unknown tx type '" + tx_type + "'";
+    }
+
+    if (sweep.batch_sizes.empty() ||
+        sweep.rangeproof_splits.empty() ||
+        sweep.in_counts.empty() ||
+        sweep.out_counts.empty() ||
+        sweep.decomp_n.empty() ||
+        sweep.decomp_m_limits.empty())
+        return "batch_sizes, rangeproof_splits, in_counts, out_counts, decomp_n and decomp_m_limits must not be empty";
+    if (sweep.decomp_n.size() != sweep.decomp_m_limits.size())
+        return "decomp_n and decomp_m_limits must have the same length";
+
+    return {};
+}
+} //namespace mock_tx_sweep_detail
+
+/**
+ * Load mock tx sweeps from a file
+ * - '.ini': one section per sweep (the section name is the sweep name), lists are comma-separated
+ * - otherwise JSON: {"sweeps": [{"name": ..., "tx_types": [...], "in_counts": [...], ...}, ...]}
+ * - keys: tx_types, batch_sizes (default 1), rangeproof_splits (default 0), in_counts, out_counts, decomp_n,
+ *   decomp_m_limits; filters: min_n, max_n, min_m, max_m, only_m, limit_rangeproof_splits
+ * - on failure, returns false and sets 'error_out'
+ */
+inline bool load_mock_tx_sweeps(const std::string &filename,
+    std::vector<MockTxSweep> &sweeps_out,
+    std::string &error_out)
+{
+    sweeps_out.clear();
+
+    try
+    {
+        boost::property_tree::ptree tree;
+
+        if (boost::algorithm::iends_with(filename, ".ini"))
+        {
+            boost::property_tree::read_ini(filename, tree);
+
+            for (const auto &section : tree)
+            {
+                sweeps_out.emplace_back();
+                sweeps_out.back().name = section.first;
+                mock_tx_sweep_detail::parse_sweep(section.second, sweeps_out.back());
+            }
+        }
+        else
+        {
+            boost::property_tree::read_json(filename, tree);
+
+            for (const auto &sweep_node : tree.get_child("sweeps"))
+            {
+                sweeps_out.emplace_back();
+                mock_tx_sweep_detail::parse_sweep(sweep_node.second, sweeps_out.back());
+            }
+        }
+    }
+    catch (const std::exception &e)
+    {
+        error_out = e.what();
+        return false;
+    }
+
+    if (sweeps_out.empty())
+    {
+        error_out = "no sweeps found";
+        return false;
+    }
+
+    for (std::size_t sweep_index{0}; sweep_index < sweeps_out.size(); ++sweep_index)
+    {
+        const std::string error{mock_tx_sweep_detail::validate_sweep(sweeps_out[sweep_index])};
+        if (!error.empty())
+        {
+            error_out = "sweep " + std::to_string(sweep_index) + " (" + sweeps_out[sweep_index].name + "): " + error;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/// run loaded sweeps (results are saved to the timings database after each sweep)
+inline void run_mock_tx_sweeps(const std::string &filter,
+    const std::vector<MockTxSweep> &sweeps,
+    ParamsShuttleMockTx &p_mock_tx)
+{
+    for (std::size_t sweep_index{0}; sweep_index < sweeps.size(); ++sweep_index)
+    {
+        const MockTxSweep &sweep{sweeps[sweep_index]};
+        if (!sweep.name.empty())
+            std::cout << "Sweep: " << sweep.name << '\n';
+
+        MockTxPerfIncrementer incrementer{sweep.make_incrementer()};
+        while (incrementer.next(p_mock_tx))
+        {
+            for (const std::string &tx_type : sweep.tx_types)
+            {
+                if (sweep.accepts(p_mock_tx, tx_type))
+                    run_mock_tx_sweep_point(filter, p_mock_tx, tx_type);
+            }
+        }
+
+        // sweep done, save results
+        if (p_mock_tx.core_params.td.get())
+            p_mock_tx.core_params.td->save(sweep_index == 0);
+    }
+}
@@ -0,0 +1,139 @@
+// Copyright (c) 2021, The Monero Project
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this list of
+//    conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list
+//    of conditions and the following disclaimer in the documentation and/or other
+//    materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its contributors may be
+//    used to endorse or promote products derived from this software without specific
+//    prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+// THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+#pragma once
+
+#include "latency_histogram.h"
+#include "mock_tx.h"
+#include "mock_tx/mock_tx_batch_verifier.h"
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+/**
+ * Streaming batch verifier lanes: per-lane latency of a stream of bulk txs with some urgent txs mixed in
+ * - a pool of txs (batch size from the mock tx params) is added to a MockTxBatchVerifier over and over, one tx every
+ *   'interval_us' (0 = back to back); every 'urgent_every'-th tx goes to the urgent lane
+ * - the bulk lane flushes at 'bulk_batch_points' multiexp points or after 'bulk_batch_delay_ms'
+ * - run once per urgent policy, reporting each lane's latency (add_tx() until verified) and the tx throughput
+ */
+namespace mock_tx_verifier_lanes_detail
+{
+inline void report_lane(const char *name, const std::vector<std::chrono::nanoseconds> &latencies)
+{
+    LatencyHistogram histogram;
+    for (const std::chrono::nanoseconds latency : latencies)
+        histogram.record(static_cast<uint64_t>(latency.count()));
+
+    std::cout << "    " << name << ": " << histogram.total_count() << " txs || latency (ms): p50 "
+        << histogram.value_at_percentile(50) / 1e6
+        << ", p90 " << histogram.value_at_percentile(90) / 1e6
+        << ", p99 " << histogram.value_at_percentile(99) / 1e6
+        << ", max " << histogram.max() / 1e6 << '\n';
+}
+} //namespace mock_tx_verifier_lanes_detail
+
+template <typename MockTxType>
+bool run_mock_tx_verifier_lanes(const ParamsShuttleMockTx &params,
+    const std::size_t num_txs,
+    const std::size_t urgent_every,
+    const std::size_t interval_us,
+    const std::size_t bulk_batch_points,
+    const std::size_t bulk_batch_delay_ms)
+{
+    using namespace mock_tx_verifier_lanes_detail;
+
+    std::shared_ptr<mock_tx::LedgerContext> ledger_context;
+    std::vector<std::shared_ptr<MockTxType>> txs;
+    if (!make_mock_tx_test_ledger(params, ledger_context) ||
+        !make_mock_tx_test_txs<MockTxType>(params, params.batch_size, ledger_context, txs) ||
+        txs.empty())
+        return false;
+
+    std::cout << "Batch verifier lanes (" << txs.back()->get_descriptor() << ", " << num_txs << " txs, every "
+        << urgent_every << "th urgent, interval (us): " << interval_us << ", bulk batch: " << bulk_batch_points
+        << " points or " << bulk_batch_delay_ms << " ms, inputs: " << params.in_count << ", outputs: "
+        << params.out_count << ", ref set: " << params.n << "^" << params.m << ")" << std::endl;
+
+    for (const mock_tx::MockTxUrgentFlushPolicy policy :
+        {mock_tx::MockTxUrgentFlushPolicy::OWN_BATCH, mock_tx::MockTxUrgentFlushPolicy::FLUSH_BULK})
+    {
+        mock_tx::MockTxBatchVerifier<MockTxType> verifier{ledger_context,
+            bulk_batch_points,
+            std::chrono::milliseconds{bulk_batch_delay_ms},
+            params.num_threads};
+        verifier.set_urgent_policy(policy);
+
+        const auto run_start = std::chrono::steady_clock::now();
+        auto next_add = run_start;
+        for (std::size_t tx_index{0}; tx_index < num_txs; ++tx_index)
+        {
+            const bool urgent{urgent_every > 0 && tx_index % urgent_every == urgent_every - 1};
+            if (!verifier.add_tx(txs[tx_index % txs.size()],
+                    urgent ? mock_tx::MockTxVerificationLane::URGENT : mock_tx::MockTxVerificationLane::BULK))
+                return false;
+
+            if (interval_us > 0)
+            {
+                next_add += std::chrono::microseconds(interval_us);
+                std::this_thread::sleep_until(next_add);
+                verifier.flush_if_due();
+            }
+        }
+        verifier.flush();
+        const double run_seconds{
+                std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - run_start).count()
+                / 1e9
+            };
+
+        std::vector<std::shared_ptr<MockTxType>> valid_txs;
+        std::vector<std::shared_ptr<MockTxType>> invalid_txs;
+        verifier.take_verified_txs(valid_txs, invalid_txs);
+        if (!invalid_txs.empty())
+            return false;
+
+        std::vector<std::chrono::nanoseconds> bulk_latencies;
+        std::vector<std::chrono::nanoseconds> urgent_latencies;
+        verifier.take_lane_latencies(mock_tx::MockTxVerificationLane::BULK, bulk_latencies);
+        verifier.take_lane_latencies(mock_tx::MockTxVerificationLane::URGENT, urgent_latencies);
+
+        std::cout << "  urgent policy: "
+            << (policy == mock_tx::MockTxUrgentFlushPolicy::OWN_BATCH ? "own batch" : "flush bulk")
+            << " || " << static_cast<uint64_t>(num_txs / run_seconds) << " txs/s\n";
+        report_lane("bulk", bulk_latencies);
+        report_lane("urgent", urgent_latencies);
+        std::cout.flush();
+    }
+
+    return true;
+}
@@ -30,9 +30,17 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
 #include <vector>
+#include "performance_tests.h"
 #include "ringct/rctOps.h"
 #include "ringct/multiexp.h"
+#include "mock_tx/seraphis_crypto_utils.h"
 
 enum test_multiexp_algorithm
 {
@@ -41,9 +49,14 @@ enum test_multiexp_algorithm
   multiexp_straus_cached,
   multiexp_pippenger,
   multiexp_pippenger_cached,
+  multiexp_pippenger_mt,
+  multiexp_pippenger_scalar,         // pippenger without the SIMD backend
+  multiexp_pippenger_cached_scalar,
+  multiexp_dispatch,                 // rct::multiexp_auto() with the current crossovers
+  multiexp_fixed,                    // sp::multi_exp_fixed() (stack storage, up to sp::MULTI_EXP_FIXED_MAX points)
 };
 
-template<test_multiexp_algorithm algorithm, size_t npoints, size_t c=0>
+template<test_multiexp_algorithm algorithm, size_t npoints, size_t c=0, size_t num_threads=0>
 class test_multiexp
 {
 public:
@@ -64,6 +77,10 @@ public:
     }
     straus_cache = rct::straus_init_cache(data);
     pippenger_cache = rct::pippenger_init_cache(data);
+    prep_data.resize(1);
+    prep_data[0].data = data;
+    prep_data[0].cache = pippenger_cache;
+    prep_data[0].cache_size = 0;
     return true;
   }
 
@@ -81,14 +98,199 @@ public:
         return res == pippenger(data, NULL, 0, c);
       case multiexp_pippenger_cached:
         return res == pippenger(data, pippenger_cache, 0, c);
+      case multiexp_pippenger_scalar:
+      {
+        simd_disabler no_simd;
+        return res == pippenger(data, NULL, 0, c);
+      }
+      case multiexp_pippenger_cached_scalar:
+      {
+        simd_disabler no_simd;
+        return res == pippenger(data, pippenger_cache, 0, c);
+      }
+      case multiexp_dispatch:
+        return res == rct::multiexp_auto(data);
+      case multiexp_pippenger_mt:
+      {
+        rct::key res_mt;
+        ge_p3 res_mt_p3 = rct::pippenger_p3_mt(prep_data, num_threads, c);
+        ge_p3_tobytes(res_mt.bytes, &res_mt_p3);
+        return res == res_mt;
+      }
+      case multiexp_fixed:
+      {
+        rct::key res_fixed;
+        ge_p3 res_fixed_p3;
+        if (!sp::try_multi_exp_fixed(epee::to_span(data), res_fixed_p3))
+          return false;
+        ge_p3_tobytes(res_fixed.bytes, &res_fixed_p3);
+        return res == res_fixed;
+      }
       default:
         return false;
     }
   }
 
 private:
+  struct simd_disabler
+  {
+    const bool was_enabled{rct::get_multiexp_simd()};
+    simd_disabler() { rct::set_multiexp_simd(false); }
+    ~simd_disabler() { rct::set_multiexp_simd(was_enabled); }
+  };
+
   std::vector<rct::MultiexpData> data;
   std::shared_ptr<rct::straus_cached_data> straus_cache;
   std::shared_ptr<rct::pippenger_cached_data> pippenger_cache;
+  std::vector<rct::pippenger_prep_data> prep_data;
   rct::key res;
 };
+
+/**
+ * Multiexp algorithm calibration
+ * - times bos-coster, straus and pippenger at N = 2, 4, ..., max_points, each with and without its precomputed cache
+ *   where it has one (cached columns are for reference: they apply to fixed generators)
+ * - the uncached timings give the crossovers that rct::multiexp_auto() uses, written as a profile that
+ *   rct::load_multiexp_crossovers() can read (see --multiexp-profile); each crossover between two sampled sizes is
+ *   placed at their geometric mean
+ */
+namespace multiexp_calibration_detail
+{
+  enum algorithm_column { bos_coster, straus, straus_cached, pippenger, pippenger_cached, num_columns };
+
+  inline uint64_t time_multiexp_ns(const std::vector<rct::MultiexpData> &data,
+    const std::shared_ptr<rct::straus_cached_data> &straus_cache,
+    const std::shared_ptr<rct::pippenger_cached_data> &pippenger_cache,
+    const algorithm_column column,
+    const size_t reps,
+    rct::key &result_out)
+  {
+    // best of 'reps' (the minimum is the least noisy estimate of the cost itself)
+    uint64_t best_ns{static_cast<uint64_t>(-1)};
+    performance_timer timer;
+    for (size_t rep = 0; rep < reps; ++rep)
+    {
+      timer.start();
+      switch (column)
+      {
+        case bos_coster: result_out = rct::bos_coster_heap_conv_robust(data); break;
+        case straus: result_out = rct::straus(data); break;
+        case straus_cached: result_out = rct::straus(data, straus_cache); break;
+        case pippenger: result_out = rct::pippenger(data, NULL, 0, rct::get_pippenger_c(data.size())); break;
+        default: result_out = rct::pippenger(data, pippenger_cache, data.size(), rct::get_pippenger_c(data.size()));
+      }
+      best_ns = std::min(best_ns, timer.elapsed_ns());
+    }
+    return best_ns;
+  }
+
+  inline size_t geometric_mean(const size_t a, const size_t b)
+  {
+    return static_cast<size_t>(std::sqrt(static_cast<double>(a) * b));
+  }
+} //namespace multiexp_calibration_detail
+
+inline bool calibrate_multiexp(const std::string &profile_file, const size_t max_points)
+{
+  using namespace multiexp_calibration_detail;
+
+  static constexpr size_t min_points{2};
+  static const char *column_names[num_columns]{"bos-coster", "straus", "straus $", "pippenger", "pippenger $"};
+
+  // per sampled N: whether bos-coster beats both uncached alternatives, and whether straus beats pippenger
+  std::vector<size_t> sampled_N;
+  std::vector<bool> bos_coster_fastest;
+  std::vector<bool> straus_beats_pippenger;
+
+  std::cout << "Multiexp calibration (us per multiexp, best of several runs; $ = precomputed cache)" << std::endl;
+  std::cout << std::setw(8) << "N";
+  for (size_t column = 0; column < num_columns; ++column)
+    std::cout << std::setw(14) << column_names[column];
+  std::cout << std::endl;
+
+  for (size_t num_points = min_points; num_points <= max_points; num_points *= 2)
+  {
+    std::vector<rct::MultiexpData> data;
+    data.reserve(num_points);
+    for (size_t n = 0; n < num_points; ++n)
+    {
+      ge_p3 point;
+      const rct::key point_key{rct::scalarmultBase(rct::skGen())};
+      CHECK_AND_ASSERT_THROW_MES(ge_frombytes_vartime(&point, point_key.bytes) == 0, "ge_frombytes_vartime failed");
+      data.emplace_back(rct::skGen(), point);
+    }
+    const std::shared_ptr<rct::straus_cached_data> straus_cache{rct::straus_init_cache(data)};
+    const std::shared_ptr<rct::pippenger_cached_data> pippenger_cache{rct::pippenger_init_cache(data)};
+    const size_t reps{std::max<size_t>(3, 2048 / num_points)};
+
+    uint64_t ns[num_columns];
+    rct::key expected, result;
+    std::cout << std::setw(8) << num_points;
+    for (size_t column = 0; column < num_columns; ++column)
+    {
+      ns[column] = time_multiexp_ns(data,
+        straus_cache,
+        pippenger_cache,
+        static_cast<algorithm_column>(column),
+        reps,
+        result);
+      if (column == 0)
+        expected = result;
+      else if (!(result == expected))
+      {
+        std::cout << std::endl << "Multiexp results disagree at N = " << num_points << " (" << column_names[column] <<
+          ")" << std::endl;
+        return false;
+      }
+      std::cout << std::setw(14) << ns[column] / 1000.0;
+    }
+    std::cout << std::endl;
+
+    sampled_N.push_back(num_points);
+    bos_coster_fastest.push_back(ns[bos_coster] < ns[straus] && ns[bos_coster] < ns[pippenger]);
+    straus_beats_pippenger.push_back(ns[straus] < ns[pippenger]);
+  }
+
+  if (sampled_N.empty())
+  {
+    std::cout << "No multiexp sizes to calibrate (max points < " << min_points << ")" << std::endl;
+    return false;
+  }
+
+  // crossovers: bos-coster while it is fastest from the smallest N on, then straus until pippenger wins
+  size_t first_non_bos_coster{0};
+  while (first_non_bos_coster < sampled_N.size() && bos_coster_fastest[first_non_bos_coster])
+    ++first_non_bos_coster;
+  size_t first_pippenger{first_non_bos_coster};
+  while (first_pippenger < sampled_N.size() && straus_beats_pippenger[first_pippenger])
+    ++first_pippenger;
+
+  auto crossover = [&sampled_N](const size_t first_above) -> size_t
+    {
+      if (first_above == 0)
+        return 0;
+      if (first_above >= sampled_N.size())
+        return sampled_N.back();
+      return geometric_mean(sampled_N[first_above - 1], sampled_N[first_above]);
+    };
+  const size_t max_bos_coster_N{crossover(first_non_bos_coster)};
+  const size_t max_straus_N{std::max(max_bos_coster_N, crossover(first_pippenger))};
+
+  std::cout << "Crossovers: bos-coster up to N = " << max_bos_coster_N << ", straus up to N = " << max_straus_N <<
+    ", pippenger above" << std::endl;
+
+  std::ofstream file(profile_file);
+  file << "# multiexp crossovers (performance_tests --calibrate-multiexp)\n";
+  file << "# <algorithm> <max N>: bos-coster up to its max N, straus up to its max N, pippenger above\n";
+  file << "bos_coster " << max_bos_coster_N << "\n";
+  file << "straus " << max_straus_N << "\n";
+  file.close();
+  if (!file)
+  {
+    std::cout << "Failed to write multiexp profile " << profile_file << std::endl;
+    return false;
+  }
+
+  std::cout << "Wrote multiexp profile to " << profile_file << std::endl;
+  return true;
+}
@@ -0,0 +1,233 @@
+// Copyright (c) 2021, The Monero Project
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this list of
+//    conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list
+//    of conditions and the following disclaimer in the documentation and/or other
+//    materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its contributors may be
+//    used to endorse or promote products derived from this software without specific
+//    prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+// THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+/**
+ * Hardware counter totals for a measured section (summed over threads in throughput mode)
+ * - 'valid' is false if counters are unavailable (non-linux, or perf_event_open() refused, e.g. due to
+ *   /proc/sys/kernel/perf_event_paranoid)
+ * - if the kernel multiplexed the group, totals are scaled by time_enabled/time_running
+ */
+struct PerfCounterValues final
+{
+  bool valid{false};
+  uint64_t cycles{0};
+  uint64_t instructions{0};
+  uint64_t l1d_misses{0};
+  uint64_t llc_misses{0};
+  uint64_t branch_misses{0};
+
+  PerfCounterValues& operator+=(const PerfCounterValues &other)
+  {
+    valid = valid && other.valid;
+    cycles += other.cycles;
+    instructions += other.instructions;
+    l1d_misses += other.l1d_misses;
+    llc_misses += other.llc_misses;
+    branch_misses += other.branch_misses;
+    return *this;
+  }
+
+  double ipc() const
+  {
+    return cycles > 0 ? static_cast<double>(instructions) / cycles : 0.0;
+  }
+
+  /// one-line summary of per-call averages
+  std::string per_call_report(const size_t num_calls) const
+  {
+    if (!valid || num_calls == 0)
+      return "perf counters unavailable";
+
+    const auto per_call = [num_calls](const uint64_t value) -> std::string
+    {
+      return std::to_string(static_cast<uint64_t>(static_cast<double>(value) / num_calls));
+    };
+
+    return std::string{"cycles/call "} + per_call(cycles) +
+      ", instructions/call " + per_call(instructions) +
+      ", IPC " + std::to_string(ipc()) +
+      ", L1d misses/call " + per_call(l1d_misses) +
+      ", LLC misses/call " + per_call(llc_misses) +
+      ", branch misses/call " + per_call(branch_misses);
+  }
+};
+
+/**
+ * Group of hardware counters for the calling thread, read together with perf_event_open()
+ * - counts only user space, so results are comparable across kernels
+ * - usage: start() before the measured section, stop() after it, then read()
+ */
+class PerfCounterGroup final
+{
+public:
+  PerfCounterGroup()
+  {
+#if defined(__linux__)
+    m_fds[0] = open_counter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, -1);
+    if (m_fds[0] < 0)
+      return;
+    m_fds[1] = open_counter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS, m_fds[0]);
+    m_fds[2] = open_counter(PERF_TYPE_HW_CACHE,
+      PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16),
+      m_fds[0]);
+    m_fds[3] = open_counter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES, m_fds[0]);
+    m_fds[4] = open_counter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES, m_fds[0]);
+
+    // all or nothing: partial groups would silently report zeros
+    for (const int fd : m_fds)
+    {
+      if (fd < 0)
+      {
+        close_all();
+        return;
+      }
+    }
+#endif
+  }
+
+  ~PerfCounterGroup()
+  {
+    close_all();
+  }
+
+  PerfCounterGroup(const PerfCounterGroup&) = delete;
+  PerfCounterGroup& operator=(const PerfCounterGroup&) = delete;
+
+  bool available() const { return m_fds[0] >= 0; }
+
+  void start()
+  {
+#if defined(__linux__)
+    if (!available())
+      return;
+    ioctl(m_fds[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(m_fds[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#endif
+  }
+
+  void stop()
+  {
+#if defined(__linux__)
+    if (!available())
+      return;
+    ioctl(m_fds[0], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+#endif
+  }
+
+  /// continue counting after stop() without resetting the counts (to leave a section out of the measurement)
+  void resume()
+  {
+#if defined(__linux__)
+    if (!available())
+      return;
+    ioctl(m_fds[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#endif
+  }
+
+  PerfCounterValues read() const
+  {
+    PerfCounterValues values;
+#if defined(__linux__)
+    if (!available())
+      return values;
+
+    // PERF_FORMAT_GROUP | TOTAL_TIME_ENABLED | TOTAL_TIME_RUNNING: {nr, time_enabled, time_running, value[nr]}
+    uint64_t buffer[3 + NUM_COUNTERS];
+    if (::read(m_fds[0], buffer, sizeof(buffer)) != static_cast<ssize_t>(sizeof(buffer)) ||
+        buffer[0] != NUM_COUNTERS)
+      return values;
+
+    const uint64_t time_enabled{buffer[1]};
+    const uint64_t time_running{buffer[2]};
+    if (time_running == 0)
+      return values;
+
+    const double scale{static_cast<double>(time_enabled) / time_running};
+    const auto scaled = [scale](const uint64_t value) -> uint64_t
+    {
+      return static_cast<uint64_t>(value * scale);
+    };
+
+    values.valid = true;
+    values.cycles = scaled(buffer[3]);
+    values.instructions = scaled(buffer[4]);
+    values.l1d_misses = scaled(buffer[5]);
+    values.llc_misses = scaled(buffer[6]);
+    values.branch_misses = scaled(buffer[7]);
+#endif
+    return values;
+  }
+
+private:
+#if defined(__linux__)
+  static int open_counter(const uint32_t type, const uint64_t config, const int group_fd)
+  {
+    perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = group_fd < 0 ? 1 : 0;  // the leader controls the group
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    // pid 0, cpu -1: this thread, on any cpu
+    return static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, group_fd, 0));
+  }
+#endif
+
+  void close_all()
+  {
+#if defined(__linux__)
+    for (int &fd : m_fds)
+    {
+      if (fd >= 0)
+        close(fd);
+      fd = -1;
+    }
+#endif
+  }
+
+private:
+  static constexpr size_t NUM_COUNTERS{5};
+  int m_fds[NUM_COUNTERS]{-1, -1, -1, -1, -1};
+};
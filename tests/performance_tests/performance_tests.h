@@ -30,15 +30,32 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <condition_variable>
+#include <fstream>
 #include <iostream>
+#include <iterator>
 #include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
 #include <type_traits>
+#include <vector>
 #include <stdint.h>
 
 #include <boost/chrono.hpp>
 #include <boost/regex.hpp>
 
+#include "alloc_tracker.h"
+#include "cache_evictor.h"
+#include "cpu_clock.h"
+#include "latency_histogram.h"
 #include "misc_language.h"
+#include "perf_counters.h"
+#include "results_sink.h"
+#include "timings_store.h"
 #include "stats.h"
 #include "common/perf_timer.h"
 #include "common/timings.h"
@@ -64,17 +81,45 @@ public:
     return static_cast<int>(boost::chrono::duration_cast<boost::chrono::milliseconds>(elapsed).count());
   }
 
+  uint64_t elapsed_ns()
+  {
+    clock::duration elapsed = clock::now() - m_start;
+    return static_cast<uint64_t>(boost::chrono::duration_cast<boost::chrono::nanoseconds>(elapsed).count());
+  }
+
 private:
   clock::time_point m_base;
   clock::time_point m_start;
 };
 
+/**
+ * Compare mode: tests whose mean time per call got significantly slower than their last run in the timings database
+ * - significant: the 99% t-test rejects 'same distribution', and the mean is more than threshold_percent slower
+ */
+struct PerfRegressions final
+{
+  double threshold_percent{5};
+  std::vector<std::string> test_names;
+};
+
 struct Params final
 {
   std::shared_ptr<TimingsDatabase> td;
   bool verbose;
   bool stats;
   unsigned loop_multiplier;
+  unsigned threads{1};  // > 1: throughput mode, run this many test instances concurrently
+  std::shared_ptr<PerfResultsSink> results;  // structured output: one record per test
+  std::shared_ptr<PerfTimingsStore> timings_store;  // indexed binary history: one record per test
+  bool perf_counters{false};  // collect hardware counters (cycles, instructions, cache/branch misses) over the test loop
+  bool track_allocations{false};  // count heap allocations/bytes and peak live bytes over the test loop
+  std::shared_ptr<PerfRegressions> regressions;  // compare mode: check each test against its timings history
+  int pin_cpu{-1};  // throughput mode: pin runner thread i to cpu pin_cpu + i (-1 = no pinning)
+  unsigned warm_up_ms{500};  // run the test for up to this long before timing it, until its call times settle
+  bool latency_histogram{false};  // tail-latency mode: record call times in a constant-memory histogram
+  std::string latency_histogram_dir;  // tail-latency mode: export each test's percentile distribution here
+  ColdCacheMode cold_cache{ColdCacheMode::HOT};  // cold-cache mode: evict the cpu caches before each call
+  std::shared_ptr<CacheEvictor> cache_evictor;  // cold-cache mode: scratch buffer used for evictions
 };
 
 struct ParamsShuttle
@@ -118,42 +163,126 @@ public:
     : m_elapsed(0)
     , m_params_shuttle(params_shuttle)
     , m_core_params(params_shuttle.core_params)
-    , m_per_call_timers(T::loop_count * params_shuttle.core_params.loop_multiplier, {true})
+    , m_per_call_timers(params_shuttle.core_params.latency_histogram ? 0 :
+        T::loop_count * params_shuttle.core_params.loop_multiplier * num_threads(), {true})
   {
+    if (m_core_params.latency_histogram)
+      m_histogram.reset(new LatencyHistogram);
   }
 
   int run()
   {
     static_assert(0 < T::loop_count, "T::loop_count must be greater than 0");
 
+    if (num_threads() > 1)
+      return run_threaded();
+
     T test;
     if (!init_test(test, m_params_shuttle))
       return -1;
+    get_test_record_info(test, m_record_info, 0);
+
+    // per-call timing is needed for stats, structured results and comparisons with the timings history
+    // - in tail-latency mode, call times go to the histogram instead of per-call timers
+    const bool time_calls = !m_histogram && (m_core_params.stats || m_core_params.results ||
+      m_core_params.timings_store || m_core_params.regressions);
+
+    std::unique_ptr<PerfCounterGroup> counters;
+    if (m_core_params.perf_counters)
+      counters.reset(new PerfCounterGroup);
 
     performance_timer timer;
     timer.start();
-    warm_up();
+    if (!warm_up(test))
+      return 1;
     if (m_core_params.verbose)
-      std::cout << "Warm up: " << timer.elapsed_ms() << " ms" << std::endl;
-
+      std::cout << "Warm up: " << m_warm_up_calls << " calls, " << timer.elapsed_ms() << " ms" << std::endl;
+
+    // allocation peaks are tracked per call (outside the per-call timers), and the largest is reported
+    const bool track_allocations = m_core_params.track_allocations && AllocationTracker::available();
+    uint64_t peak_live_bytes{0};
+    if (track_allocations)
+      AllocationTracker::start();
+
+    // cold-cache mode: the evictions are left out of the elapsed time and the perf counters
+    CacheEvictor *const cache_evictor{
+      m_core_params.cold_cache == ColdCacheMode::COLD ? m_core_params.cache_evictor.get() : nullptr};
+    uint64_t eviction_ns{0};
+
+    m_clock_check.start();
+    if (counters)
+      counters->start();
     timer.start();
     for (size_t i = 0; i < T::loop_count * m_core_params.loop_multiplier; ++i)
     {
-      if (m_core_params.stats)
+      if (cache_evictor)
+      {
+        if (counters)
+          counters->stop();
+        const uint64_t eviction_start_ticks{tools::get_tick_count()};
+        cache_evictor->evict();
+        eviction_ns += tools::ticks_to_ns(tools::get_tick_count() - eviction_start_ticks);
+        if (counters)
+          counters->resume();
+      }
+      const int64_t live_bytes_baseline{track_allocations ? AllocationTracker::reset_peak() : 0};
+      const uint64_t call_start_ticks{m_histogram ? tools::get_tick_count() : 0};
+      if (time_calls)
         m_per_call_timers[i].resume();
       if (!test.test())
+      {
+        AllocationTracker::stop();
         return i + 1;
-      if (m_core_params.stats)
+      }
+      if (time_calls)
         m_per_call_timers[i].pause();
+      if (m_histogram)
+        m_histogram->record(tools::ticks_to_ns(tools::get_tick_count() - call_start_ticks));
+      if (track_allocations)
+        peak_live_bytes = std::max(peak_live_bytes, AllocationTracker::peak_since(live_bytes_baseline));
     }
-    m_elapsed = timer.elapsed_ms();
-    m_stats.reset(new Stats<tools::PerformanceTimer, uint64_t>(m_per_call_timers));
+    m_elapsed_ns = timer.elapsed_ns();
+    m_elapsed_ns -= std::min(eviction_ns, m_elapsed_ns);
+    m_elapsed = static_cast<int>(m_elapsed_ns / 1000000);
+    if (counters)
+    {
+      counters->stop();
+      m_perf_counters = counters->read();
+    }
+    m_clock_check.stop();
+    if (track_allocations)
+    {
+      AllocationTracker::stop();
+      m_allocations = AllocationTracker::read();
+      m_allocations.peak_live_bytes = peak_live_bytes;
+    }
+    if (!m_histogram)
+      m_stats.reset(new Stats<tools::PerformanceTimer, uint64_t>(m_per_call_timers));
 
     return 0;
   }
 
   int elapsed_time() const { return m_elapsed; }
-  size_t get_size() const { return m_stats->get_size(); }
+  size_t get_size() const { return m_histogram ? m_histogram->total_count() : m_stats->get_size(); }
+  size_t num_threads() const { return m_core_params.threads > 1 ? m_core_params.threads : 1; }
+  const PerfTestRecord& get_record_info() const { return m_record_info; }
+  const PerfCounterValues& get_perf_counters() const { return m_perf_counters; }
+  const AllocationCounts& get_allocations() const { return m_allocations; }
+  const CpuClockCheck& get_clock_check() const { return m_clock_check; }
+  const LatencyHistogram* get_latency_histogram() const { return m_histogram.get(); }
+
+  // aggregate throughput (over all threads in threaded mode)
+  double calls_per_second() const
+  {
+    const double total_calls = static_cast<double>(T::loop_count * m_core_params.loop_multiplier * num_threads());
+    return m_elapsed_ns > 0 ? total_calls * 1000000000.0 / m_elapsed_ns : 0.0;
+  }
+
+  // mean time per call from the elapsed time (doesn't need per-call timers)
+  double elapsed_ns_per_call() const
+  {
+    return static_cast<double>(m_elapsed_ns) / (T::loop_count * m_core_params.loop_multiplier);
+  }
 
   int time_per_call(int scale = 1) const
   {
@@ -161,45 +290,285 @@ public:
     return m_elapsed * scale / (T::loop_count * m_core_params.loop_multiplier);
   }
 
-  uint64_t get_min() const { return m_stats->get_min(); }
-  uint64_t get_max() const { return m_stats->get_max(); }
-  double get_mean() const { return m_stats->get_mean(); }
-  uint64_t get_median() const { return m_stats->get_median(); }
-  double get_stddev() const { return m_stats->get_standard_deviation(); }
-  double get_non_parametric_skew() const { return m_stats->get_non_parametric_skew(); }
-  std::vector<uint64_t> get_quantiles(size_t n) const { return m_stats->get_quantiles(n); }
+  // call time stats (from the histogram in tail-latency mode, to its precision)
+  uint64_t get_min() const { return m_histogram ? m_histogram->min() : m_stats->get_min(); }
+  uint64_t get_max() const { return m_histogram ? m_histogram->max() : m_stats->get_max(); }
+  double get_mean() const { return m_histogram ? m_histogram->mean() : m_stats->get_mean(); }
+  uint64_t get_median() const { return m_histogram ? m_histogram->value_at_percentile(50) : m_stats->get_median(); }
+  double get_stddev() const { return m_histogram ? m_histogram->stddev() : m_stats->get_standard_deviation(); }
+  double get_non_parametric_skew() const
+  {
+    if (!m_histogram)
+      return m_stats->get_non_parametric_skew();
+    return m_histogram->stddev() > 0 ? (get_mean() - get_median()) / m_histogram->stddev() : 0.0;
+  }
+  std::vector<uint64_t> get_quantiles(size_t n) const
+  {
+    return m_histogram ? m_histogram->get_quantiles(n) : m_stats->get_quantiles(n);
+  }
 
   bool is_same_distribution(size_t npoints, double mean, double stddev) const
   {
-    return m_stats->is_same_distribution_99(npoints, mean, stddev);
+    if (!m_histogram)
+      return m_stats->is_same_distribution_99(npoints, mean, stddev);
+
+    // Welch's t-test as in Stats, with the large-sample 99% bound (histogram runs have many samples)
+    const double variance = m_histogram->stddev() * m_histogram->stddev();
+    const double d = sqrt(variance / get_size() + stddev * stddev / npoints);
+    return d > 0 ? fabs(get_mean() - mean) / d < 2.576 : get_mean() == mean;
   }
 
 private:
   /**
-   * Warm up processor core, enabling turbo boost, etc.
+   * Throughput mode: run num_threads() independent test instances concurrently
+   * - each thread gets its own test instance (initialized up front, outside the timed section)
+   * - a start barrier releases all threads together; elapsed time is from release to the last thread finishing
+   * - per-call timers are always recorded (or per-thread histograms, merged, in tail-latency mode), so latency
+   *   percentiles are available
+   * - perf counters (if enabled) are per thread, and summed over all threads
+   * - allocation tracking (if enabled) is process-wide, so the peak live bytes cover all threads together
+   * - only the first instance is warmed up (on the calling thread); the cpu clock check covers the whole timed section
    */
-  uint64_t warm_up()
+  int run_threaded()
   {
-    const size_t warm_up_rounds = 1000 * 1000 * 1000;
-    m_warm_up = 0;
-    for (size_t i = 0; i < warm_up_rounds; ++i)
+    const size_t threads_count = num_threads();
+    const size_t calls_per_thread = T::loop_count * m_core_params.loop_multiplier;
+
+    std::vector<std::unique_ptr<T>> tests;
+    tests.reserve(threads_count);
+    for (size_t thread_index = 0; thread_index < threads_count; ++thread_index)
     {
-      ++m_warm_up;
+      // only the first instance writes init info to the timings database
+      ParamsT params_shuttle{m_params_shuttle};
+      if (thread_index > 0)
+        params_shuttle.core_params.td.reset();
+
+      tests.emplace_back(new T);
+      if (!init_test(*tests.back(), params_shuttle))
+        return -1;
     }
-    return m_warm_up;
+    get_test_record_info(*tests[0], m_record_info, 0);
+
+    performance_timer timer;
+    timer.start();
+    if (!warm_up(*tests[0]))
+      return 1;
+    if (m_core_params.verbose)
+      std::cout << "Warm up: " << m_warm_up_calls << " calls, " << timer.elapsed_ms() << " ms" << std::endl;
+
+    std::mutex start_mutex;
+    std::condition_variable start_cv;
+    size_t num_ready = 0;
+    bool start = false;
+    std::vector<int> results(threads_count, 0);
+    std::vector<PerfCounterValues> thread_counters(threads_count);
+    std::vector<LatencyHistogram> thread_histograms(m_histogram ? threads_count : 0);
+    std::vector<std::thread> threads;
+    threads.reserve(threads_count);
+
+    for (size_t thread_index = 0; thread_index < threads_count; ++thread_index)
+    {
+      threads.emplace_back([&, thread_index]()
+      {
+        // counters only measure the thread that opened them
+        std::unique_ptr<PerfCounterGroup> counters;
+        if (m_core_params.perf_counters)
+          counters.reset(new PerfCounterGroup);
+
+        // start barrier
+        {
+          std::unique_lock<std::mutex> lock(start_mutex);
+          ++num_ready;
+          start_cv.notify_all();
+          start_cv.wait(lock, [&start]{ return start; });
+        }
+
+        T &test = *tests[thread_index];
+        tools::PerformanceTimer *per_call_timers =
+          m_histogram ? nullptr : &m_per_call_timers[thread_index * calls_per_thread];
+        LatencyHistogram *histogram = m_histogram ? &thread_histograms[thread_index] : nullptr;
+        if (counters)
+          counters->start();
+        for (size_t i = 0; i < calls_per_thread; ++i)
+        {
+          const uint64_t call_start_ticks{histogram ? tools::get_tick_count() : 0};
+          if (per_call_timers)
+            per_call_timers[i].resume();
+          if (!test.test())
+          {
+            results[thread_index] = i + 1;
+            return;
+          }
+          if (per_call_timers)
+            per_call_timers[i].pause();
+          if (histogram)
+            histogram->record(tools::ticks_to_ns(tools::get_tick_count() - call_start_ticks));
+        }
+        if (counters)
+        {
+          counters->stop();
+          thread_counters[thread_index] = counters->read();
+        }
+      });
+
+      if (m_core_params.pin_cpu >= 0 &&
+          !pin_thread_to_cpu(threads.back(), static_cast<unsigned>(m_core_params.pin_cpu) + thread_index))
+        std::cout << "Failed to pin runner thread " << thread_index << " to cpu " << m_core_params.pin_cpu + thread_index << std::endl;
+    }
+
+    const bool track_allocations = m_core_params.track_allocations && AllocationTracker::available();
+    int64_t live_bytes_baseline{0};
+
+    {
+      std::unique_lock<std::mutex> lock(start_mutex);
+      start_cv.wait(lock, [&]{ return num_ready == threads_count; });
+      if (track_allocations)
+      {
+        AllocationTracker::start();
+        live_bytes_baseline = AllocationTracker::reset_peak();
+      }
+      m_clock_check.start();
+      timer.start();
+      start = true;
+    }
+    start_cv.notify_all();
+
+    for (std::thread &thread : threads)
+      thread.join();
+    m_elapsed = timer.elapsed_ms();
+    m_elapsed_ns = timer.elapsed_ns();
+    m_clock_check.stop();
+    if (track_allocations)
+    {
+      AllocationTracker::stop();
+      m_allocations = AllocationTracker::read();
+      m_allocations.peak_live_bytes = AllocationTracker::peak_since(live_bytes_baseline);
+    }
+
+    for (const int result : results)
+    {
+      if (result != 0)
+        return result;
+    }
+
+    if (m_core_params.perf_counters)
+    {
+      m_perf_counters.valid = true;
+      for (const PerfCounterValues &counters : thread_counters)
+        m_perf_counters += counters;
+    }
+
+    if (m_histogram)
+    {
+      for (const LatencyHistogram &histogram : thread_histograms)
+        m_histogram->merge(histogram);
+    }
+    else
+      m_stats.reset(new Stats<tools::PerformanceTimer, uint64_t>(m_per_call_timers));
+
+    return 0;
+  }
+
+  /**
+   * Warm up caches, branch predictors and the core clock by running the test until its call times settle
+   * - stops once the last 3 calls are within 5% of each other, or after warm_up_ms (at least one call is made, so
+   *   slow tests are only run once)
+   * - returns false if the test failed
+   */
+  bool warm_up(T &test)
+  {
+    m_warm_up_calls = 0;
+    if (m_core_params.warm_up_ms == 0)
+      return true;
+
+    const auto warm_up_start = std::chrono::steady_clock::now();
+    const auto warm_up_end = warm_up_start + std::chrono::milliseconds(m_core_params.warm_up_ms);
+    uint64_t recent_ns[3]{};
+    while (true)
+    {
+      const auto call_start = std::chrono::steady_clock::now();
+      if (!test.test())
+        return false;
+      const auto call_end = std::chrono::steady_clock::now();
+
+      recent_ns[m_warm_up_calls++ % 3] =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(call_end - call_start).count();
+      if (call_end >= warm_up_end)
+        break;
+      if (m_warm_up_calls >= 3)
+      {
+        const uint64_t fastest = *std::min_element(std::begin(recent_ns), std::end(recent_ns));
+        const uint64_t slowest = *std::max_element(std::begin(recent_ns), std::end(recent_ns));
+        if (slowest - fastest <= fastest / 20)
+          break;
+      }
+    }
+
+    return true;
   }
 
 private:
-  volatile uint64_t m_warm_up;  ///<! This field is intended for preclude compiler optimizations
+  size_t m_warm_up_calls{0};
   int m_elapsed;
+  uint64_t m_elapsed_ns{0};
   Params m_core_params;
   ParamsT m_params_shuttle;
   std::vector<tools::PerformanceTimer> m_per_call_timers;
   std::unique_ptr<Stats<tools::PerformanceTimer, uint64_t>> m_stats;
+  std::unique_ptr<LatencyHistogram> m_histogram;
+  PerfTestRecord m_record_info;
+  PerfCounterValues m_perf_counters;
+  AllocationCounts m_allocations;
+  CpuClockCheck m_clock_check;
 };
 
+/**
+ * Single-threaded runs of a test in a timings store, oldest first
+ * - only runs with the same tx parameters as 'record_info' (e.g. the same mock tx sweep point) are included
+ */
+inline std::vector<TimingsDatabase::instance> get_timings_store_history(const PerfTimingsStore &timings_store,
+  const char *test_name, const PerfTestRecord &record_info)
+{
+  std::vector<TimingsDatabase::instance> history;
+  for (const PerfTimingsStore::Entry &entry : timings_store.get(test_name))
+  {
+    const PerfTestRecord &record = entry.record;
+    if (record.threads != 1 ||
+        record.descriptor != record_info.descriptor ||
+        record.batch_size != record_info.batch_size ||
+        record.in_count != record_info.in_count ||
+        record.out_count != record_info.out_count ||
+        record.n != record_info.n ||
+        record.m != record_info.m ||
+        record.rangeproof_splits != record_info.rangeproof_splits)
+      continue;
+
+    history.push_back(TimingsDatabase::instance{static_cast<time_t>(entry.timestamp), record.loop_count, record.min,
+      record.max, record.mean, record.median, record.stddev, 0, record.deciles});
+  }
+  return history;
+}
+
+/**
+ * File name for a test's exported latency histogram: "<sequence number>_<test name>.hgrm"
+ * - the sequence number keeps runs of the same test (e.g. mock tx sweep points) apart
+ */
+inline std::string latency_histogram_file_name(const char *test_name)
+{
+  static size_t sequence_number{0};
+
+  std::string file_name{std::to_string(sequence_number++) + '_'};
+  for (const char *c = test_name; *c; ++c)
+    file_name += std::isalnum(static_cast<unsigned char>(*c)) ? *c : '_';
+  return file_name + ".hgrm";
+}
+
+/**
+ * Run a test and report its timings
+ * - mean_out: if not null, set to the elapsed time per call (ns) of a single-threaded run
+ */
 template <typename T, typename ParamsT>
-bool run_test(const std::string &filter, ParamsT &params_shuttle, const char* test_name)
+bool run_test(const std::string &filter, ParamsT &params_shuttle, const char* test_name, double *mean_out = nullptr)
 {
   static_assert(std::is_base_of<ParamsShuttle, ParamsT>::value, "Must use a ParamsShuttle.");
   Params &params = params_shuttle.core_params;
@@ -208,9 +577,60 @@ bool run_test(const std::string &filter, ParamsT &params_shuttle, const char* te
   if (!filter.empty() && !boost::regex_match(std::string(test_name), match, boost::regex(filter)))
     return true;
 
+  // hot vs cold caches: run the test both ways, and report how much slower it is with cold caches
+  if (params.cold_cache == ColdCacheMode::BOTH)
+  {
+    ParamsT hot_params_shuttle{params_shuttle};
+    ParamsT cold_params_shuttle{params_shuttle};
+    hot_params_shuttle.core_params.cold_cache = ColdCacheMode::HOT;
+    cold_params_shuttle.core_params.cold_cache = ColdCacheMode::COLD;
+
+    double hot_mean{0};
+    double cold_mean{0};
+    if (!run_test<T>(filter, hot_params_shuttle, test_name, &hot_mean) ||
+        !run_test<T>(filter, cold_params_shuttle, test_name, &cold_mean))
+      return false;
+
+    if (hot_mean > 0 && cold_mean > 0)
+    {
+      std::cout << "  cold/hot caches: " << cold_mean / hot_mean << "x (" << static_cast<uint64_t>(hot_mean / 1000)
+        << " us hot, " << static_cast<uint64_t>(cold_mean / 1000) << " us cold)" << std::endl;
+    }
+    if (mean_out)
+      *mean_out = cold_mean;
+    return true;
+  }
+
+  // cold-cache runs are kept apart from hot ones in the timings history and results
+  const std::string cold_test_name{std::string{test_name} + " [cold cache]"};
+  if (params.cold_cache == ColdCacheMode::COLD)
+    test_name = cold_test_name.c_str();
+
+  // records the test adds while it is set up (e.g. its description) are part of its key in the timings database
+  const size_t first_pending_record{params.td.get() != nullptr ? params.td->num_pending() : 0};
+
   test_runner<T, ParamsT> runner(params_shuttle);
   int run_result{runner.run()};
-  if (run_result == 0)
+  if (run_result == 0 && runner.num_threads() > 1)
+  {
+    // throughput mode: aggregate calls/sec, and per-call latency percentiles over all threads
+    const size_t calls_per_thread = T::loop_count * params.loop_multiplier;
+    const auto percentiles = runner.get_quantiles(100);
+
+    std::cout << test_name << " (" << runner.num_threads() << " threads x " << calls_per_thread << " calls) - OK:";
+    std::cout << " " << static_cast<uint64_t>(runner.calls_per_second()) << " calls/s";
+    std::cout << " (latency median " << percentiles[50] / 1000 << " us, 90th " << percentiles[90] / 1000;
+    std::cout << " us, 99th " << percentiles[99] / 1000 << " us, max " << runner.get_max() / 1000 << " us)" << std::endl;
+
+    if (params.td.get() != nullptr)
+    {
+      params.td->add((std::string{test_name} + " [threads=" + std::to_string(runner.num_threads()) + "]").c_str(),
+        TimingsDatabase::instance{time(NULL), runner.get_size(), static_cast<double>(runner.get_min()),
+          static_cast<double>(runner.get_max()), runner.get_mean(), static_cast<double>(runner.get_median()),
+          runner.get_stddev(), runner.get_non_parametric_skew(), runner.get_quantiles(10)});
+    }
+  }
+  else if (run_result == 0)
   {
     if (params.verbose)
     {
@@ -249,14 +669,40 @@ bool run_test(const std::string &filter, ParamsT &params_shuttle, const char* te
     double stddev = runner.get_stddev();
     double npskew = runner.get_non_parametric_skew();
 
-    //std::vector<TimingsDatabase::instance> prev_instances;
+    std::vector<TimingsDatabase::instance> prev_instances;
+    if (params.regressions && params.timings_store)
+      prev_instances = get_timings_store_history(*params.timings_store, test_name, runner.get_record_info());
+    else if (params.regressions && params.td.get() != nullptr)
+      prev_instances = params.td->get(params.td->get_key(test_name, first_pending_record));
+
     if (params.td.get() != nullptr)
     {
-      //prev_instances = params.td->get(test_name);
       params.td->add(test_name,
         TimingsDatabase::instance{time(NULL), runner.get_size(), min, max, mean, med, stddev, npskew, quantiles});
     }
 
+    std::string cmp;
+    if (params.regressions)
+    {
+      if (prev_instances.empty())
+        cmp = " [no history]";
+      else
+      {
+        const TimingsDatabase::instance &prev_instance = prev_instances.back();
+        const double pc = prev_instance.mean > 0 ? 100. * (mean - prev_instance.mean) / prev_instance.mean : 0;
+        const bool same = runner.is_same_distribution(prev_instance.npoints, prev_instance.mean, prev_instance.stddev);
+        if (same)
+          cmp = " [same as last run]";
+        else
+          cmp = " [" + std::to_string(fabs(pc)) + "% " + (pc > 0 ? "slower" : "faster") + " than last run]";
+        if (!same && pc > params.regressions->threshold_percent)
+        {
+          cmp += " - REGRESSION";
+          params.regressions->test_names.emplace_back(test_name);
+        }
+      }
+    }
+
     std::cout << (params.verbose ? "  time per call: " : " ") << time_per_call << " " << unit << "/call" << (params.verbose ? "\n" : "");
     if (params.stats)
     {
@@ -264,22 +710,12 @@ bool run_test(const std::string &filter, ParamsT &params_shuttle, const char* te
       uint64_t meds = med / scale;
       uint64_t p95s = quantiles[9] / scale;
       uint64_t stddevs = stddev / scale;
-      std::string cmp;
-      /*
-      if (!prev_instances.empty())
-      {
-        const TimingsDatabase::instance &prev_instance = prev_instances.back();
-        if (!runner.is_same_distribution(prev_instance.npoints, prev_instance.mean, prev_instance.stddev))
-        {
-          double pc = fabs(100. * (prev_instance.mean - runner.get_mean()) / prev_instance.mean);
-          cmp = ", " + std::to_string(pc) + "% " + (mean > prev_instance.mean ? "slower" : "faster");
-        }
-        cmp += "  -- " + std::to_string(prev_instance.mean);
-      }
-      */
-      std::cout << " (min " << mins << " " << unit << ", 90th " << p95s << " " << unit << ", median " << meds << " " << unit << ", std dev " << stddevs << " " << unit << ")" << cmp;
+      std::cout << " (min " << mins << " " << unit << ", 90th " << p95s << " " << unit << ", median " << meds << " " << unit << ", std dev " << stddevs << " " << unit << ")";
     }
-    std::cout << std::endl;
+    std::cout << cmp << std::endl;
+
+    if (mean_out)
+      *mean_out = runner.elapsed_ns_per_call();
   }
   else if (run_result == -1)
   {
@@ -292,6 +728,119 @@ bool run_test(const std::string &filter, ParamsT &params_shuttle, const char* te
     return false;
   }
 
+  const size_t total_calls = T::loop_count * params.loop_multiplier * runner.num_threads();
+  const PerfCounterValues &perf_counters = runner.get_perf_counters();
+  if (params.perf_counters)
+  {
+    std::cout << "  " << perf_counters.per_call_report(total_calls) << std::endl;
+
+    // add the per-call counters to the timings database (after the timings entry for this test)
+    if (params.td.get() != nullptr && perf_counters.valid)
+    {
+      TimingsDatabase::instance null_instance;
+      null_instance.npoints = 0;
+
+      std::string counters_csv{"perf counters"};
+      std::string separator{','};
+      counters_csv += separator + std::to_string(perf_counters.cycles / total_calls);
+      counters_csv += separator + std::to_string(perf_counters.instructions / total_calls);
+      counters_csv += separator + std::to_string(perf_counters.ipc());
+      counters_csv += separator + std::to_string(perf_counters.l1d_misses / total_calls);
+      counters_csv += separator + std::to_string(perf_counters.llc_misses / total_calls);
+      counters_csv += separator + std::to_string(perf_counters.branch_misses / total_calls);
+
+      params.td->add(counters_csv.c_str(), null_instance);
+    }
+  }
+
+  const AllocationCounts &allocations = runner.get_allocations();
+  if (params.track_allocations)
+  {
+    std::cout << "  " << allocations.per_call_report(total_calls) << std::endl;
+
+    // add the per-call allocation counts to the timings database (after the timings entry for this test)
+    if (params.td.get() != nullptr && allocations.valid)
+    {
+      TimingsDatabase::instance null_instance;
+      null_instance.npoints = 0;
+
+      std::string allocations_csv{"allocations"};
+      std::string separator{','};
+      allocations_csv += separator + std::to_string(allocations.allocations / total_calls);
+      allocations_csv += separator + std::to_string(allocations.bytes / total_calls);
+      allocations_csv += separator + std::to_string(allocations.peak_live_bytes);
+
+      params.td->add(allocations_csv.c_str(), null_instance);
+    }
+  }
+
+  // tail-latency mode: report the tail, and export the percentile distribution
+  if (const LatencyHistogram *histogram = runner.get_latency_histogram())
+  {
+    std::cout << "  latency (us): p50 " << histogram->value_at_percentile(50) / 1000.0
+      << ", p99 " << histogram->value_at_percentile(99) / 1000.0
+      << ", p99.9 " << histogram->value_at_percentile(99.9) / 1000.0
+      << ", p99.99 " << histogram->value_at_percentile(99.99) / 1000.0
+      << ", max " << histogram->max() / 1000.0
+      << " (" << histogram->total_count() << " calls)" << std::endl;
+
+    if (!params.latency_histogram_dir.empty())
+    {
+      const std::string histogram_file{params.latency_histogram_dir + "/" + latency_histogram_file_name(test_name)};
+      std::ofstream out(histogram_file);
+      histogram->export_percentile_distribution(out);
+      if (!out.good())
+        std::cout << "  failed to write latency histogram: " << histogram_file << std::endl;
+    }
+  }
+
+  // report clock changes that make the timings suspect (always in verbose mode)
+  const CpuClockCheck &clock_check = runner.get_clock_check();
+  if (params.verbose || !clock_check.stable())
+    std::cout << "  " << clock_check.report() << std::endl;
+
+  if (params.results || params.timings_store)
+  {
+    PerfTestRecord record{runner.get_record_info()};
+    record.test_name = test_name;
+    record.loop_count = T::loop_count * params.loop_multiplier;
+    record.threads = runner.num_threads();
+    record.min = runner.get_min();
+    record.median = runner.get_median();
+    record.mean = runner.get_mean();
+    record.stddev = runner.get_stddev();
+    record.max = runner.get_max();
+    record.deciles = runner.get_quantiles(10);
+    record.calls_per_second = runner.calls_per_second();
+    if (perf_counters.valid)
+    {
+      record.perf_counters = true;
+      record.cycles_per_call = static_cast<double>(perf_counters.cycles) / total_calls;
+      record.instructions_per_call = static_cast<double>(perf_counters.instructions) / total_calls;
+      record.ipc = perf_counters.ipc();
+      record.l1d_misses_per_call = static_cast<double>(perf_counters.l1d_misses) / total_calls;
+      record.llc_misses_per_call = static_cast<double>(perf_counters.llc_misses) / total_calls;
+      record.branch_misses_per_call = static_cast<double>(perf_counters.branch_misses) / total_calls;
+    }
+    if (allocations.valid)
+    {
+      record.allocations = true;
+      record.allocations_per_call = static_cast<double>(allocations.allocations) / total_calls;
+      record.bytes_allocated_per_call = static_cast<double>(allocations.bytes) / total_calls;
+      record.peak_live_bytes = allocations.peak_live_bytes;
+    }
+    if (clock_check.valid())
+    {
+      record.clock_check = true;
+      record.core_speed_change = clock_check.core_speed_change();
+      record.tick_rate_change = clock_check.tick_rate_change();
+    }
+    if (params.results)
+      params.results->add(record);
+    if (params.timings_store && !params.timings_store->add(record, time(NULL)))
+      std::cout << "  failed to add to the timings store" << std::endl;
+  }
+
   return true;
 }
 
@@ -0,0 +1,167 @@
+// Copyright (c) 2021, The Monero Project
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice, this list of
+//    conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list
+//    of conditions and the following disclaimer in the documentation and/or other
+//    materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its contributors may be
+//    used to endorse or promote products derived from this software without specific
+//    prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+// THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include "performance_tests.h"
+#include "ringct/multiexp.h"
+#include "ringct/rctOps.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+/**
+ * Pippenger window calibration
+ * - times pippenger_p3() for every window size c at N = 16, 32, ..., max_points and writes the fastest c per N as a
+ *   profile that rct::load_pippenger_c_profile() can read (see --pippenger-profile)
+ * - the point mix mimics combined batch verification: half of the points are fixed generators with a pippenger cache,
+ *   half are uncached (ledger) points
+ * - each boundary between two sampled sizes is placed at their geometric mean
+ */
+namespace pippenger_calibration_detail
+{
+  inline uint64_t time_pippenger_ns(const std::vector<rct::pippenger_prep_data> &prep_data,
+    const size_t c,
+    const size_t reps,
+    rct::key &result_out)
+  {
+    // best of 'reps' (the minimum is the least noisy estimate of the cost itself)
+    uint64_t best_ns{static_cast<uint64_t>(-1)};
+    performance_timer timer;
+    for (size_t rep = 0; rep < reps; ++rep)
+    {
+      timer.start();
+      const ge_p3 result{rct::pippenger_p3(prep_data, c)};
+      best_ns = std::min(best_ns, timer.elapsed_ns());
+      ge_p3_tobytes(result_out.bytes, &result);
+    }
+    return best_ns;
+  }
+
+  inline std::vector<rct::pippenger_prep_data> make_prep_data(const size_t num_points)
+  {
+    std::vector<rct::pippenger_prep_data> prep_data(2);
+    for (size_t i = 0; i < num_points; ++i)
+    {
+      rct::pippenger_prep_data &segment = prep_data[i < num_points / 2 ? 0 : 1];
+      ge_p3 point;
+      const rct::key point_key{rct::scalarmultBase(rct::skGen())};
+      CHECK_AND_ASSERT_THROW_MES(ge_frombytes_vartime(&point, point_key.bytes) == 0, "ge_frombytes_vartime failed");
+      segment.data.emplace_back(rct::skGen(), point);
+    }
+
+    prep_data[0].cache = rct::pippenger_init_cache(prep_data[0].data);
+    prep_data[0].cache_size = prep_data[0].data.size();
+    prep_data[1].cache_size = 0;
+    return prep_data;
+  }
+} //namespace pippenger_calibration_detail
+
+inline bool calibrate_pippenger(const std::string &profile_file, const size_t max_points)
+{
+  using namespace pippenger_calibration_detail;
+
+  static constexpr size_t min_points{16};
+  static constexpr size_t max_c{9};
+
+  std::vector<std::pair<size_t, size_t>> best_c_per_N;
+
+  std::cout << "Pippenger calibration (us per multiexp, best of several runs)" << std::endl;
+  std::cout << std::setw(8) << "N";
+  for (size_t c = 1; c <= max_c; ++c)
+    std::cout << std::setw(10) << ("c=" + std::to_string(c));
+  std::cout << std::setw(8) << "best" << std::endl;
+
+  for (size_t num_points = min_points; num_points <= max_points; num_points *= 2)
+  {
+    const std::vector<rct::pippenger_prep_data> prep_data{make_prep_data(num_points)};
+    const size_t reps{std::max<size_t>(3, 2048 / num_points)};
+
+    rct::key expected, result;
+    size_t best_c{0};
+    uint64_t best_ns{0};
+    std::cout << std::setw(8) << num_points;
+    for (size_t c = 1; c <= max_c; ++c)
+    {
+      const uint64_t ns{time_pippenger_ns(prep_data, c, reps, result)};
+      if (c == 1)
+        expected = result;
+      else if (!(result == expected))
+      {
+        std::cout << std::endl << "Pippenger results disagree at N = " << num_points << ", c = " << c << std::endl;
+        return false;
+      }
+
+      if (best_c == 0 || ns < best_ns)
+      {
+        best_c = c;
+        best_ns = ns;
+      }
+      std::cout << std::setw(10) << ns / 1000;
+    }
+    std::cout << std::setw(8) << best_c << std::endl;
+
+    best_c_per_N.emplace_back(num_points, best_c);
+  }
+
+  // thresholds: N <= max_N uses c (consecutive sizes with the same best c are merged)
+  std::vector<std::pair<size_t, size_t>> profile;
+  for (size_t i = 0; i < best_c_per_N.size(); ++i)
+  {
+    const size_t max_N{i + 1 < best_c_per_N.size() ?
+      static_cast<size_t>(std::sqrt(static_cast<double>(best_c_per_N[i].first) * best_c_per_N[i + 1].first)) :
+      best_c_per_N[i].first};
+
+    if (!profile.empty() && profile.back().second == best_c_per_N[i].second)
+      profile.back().first = max_N;
+    else
+      profile.emplace_back(max_N, best_c_per_N[i].second);
+  }
+
+  std::ofstream file(profile_file);
+  file << "# pippenger window profile (performance_tests --calibrate-pippenger)\n";
+  file << "# <max N> <c>; the last c also applies to larger N\n";
+  for (const auto &entry : profile)
+    file << entry.first << " " << entry.second << "\n";
+  file.close();
+  if (!file)
+  {
+    std::cout << "Failed to write pippenger profile " << profile_file << std::endl;
+    return false;
+  }
+
+  std::cout << "Wrote pippenger profile to " << profile_file << std::endl;
+  return true;
+}
@@ -0,0 +1,124 @@
+// Copyright (c) 2021, The Monero Project
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of
+//    conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list
+//    of conditions and the following disclaimer in the documentation and/or other
+//    materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be
+//    used to endorse or promote products derived from this software without specific
+//    prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+// THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <iostream>
+#include <string>
+#include <type_traits>
+
+#include "byte_slice.h"
+#include "crypto/crypto.h"
+#include "cryptonote_protocol/cryptonote_protocol_defs.h"
+#include "misc_os_dependent.h"
+#include "rpc/core_rpc_server_commands_defs.h"
+#include "storages/portable_storage_template_helper.h"
+
+// parse portable_storage binary payloads into their structs, as levin and the binary RPC do
+// - fluffy block: a NOTIFY_NEW_FLUFFY_BLOCK with 20 full txes, as relayed between peers
+// - get_blocks_fast: a /get_blocks.bin response of 100 blocks of 20 txes each, as received by a syncing wallet
+// - reports payload MB/s parsed per core
+template<bool GetBlocksFast>
+class test_portable_storage_load
+{
+public:
+  static const size_t loop_count = GetBlocksFast ? 100 : 10000;
+
+  ~test_portable_storage_load()
+  {
+    if (m_elapsed_ns == 0 || m_num_calls == 0)
+      return;
+    std::cout << "  " << (GetBlocksFast ? "get_blocks_fast" : "fluffy block") << ", payload bytes: " << m_payload.size()
+      << ", MB/s: " << static_cast<double>(m_payload.size()) * m_num_calls * 1e3 / m_elapsed_ns << '\n';
+  }
+
+  bool init()
+  {
+    // typical size: ~2.5 kB per 2-out tx
+    epee::byte_slice payload;
+    if (GetBlocksFast)
+    {
+      cryptonote::COMMAND_RPC_GET_BLOCKS_FAST::response res;
+      res.start_height = 2000000;
+      res.current_height = 2000100;
+      res.status = CORE_RPC_STATUS_OK;
+      for (size_t b = 0; b < 100; ++b)
+      {
+        res.blocks.push_back(random_block(20));
+        cryptonote::COMMAND_RPC_GET_BLOCKS_FAST::block_output_indices indices;
+        for (size_t t = 0; t < 21; ++t)
+          indices.indices.push_back({{crypto::rand<uint64_t>(), crypto::rand<uint64_t>()}});
+        res.output_indices.push_back(std::move(indices));
+      }
+      if (!epee::serialization::store_t_to_binary(res, payload))
+        return false;
+    }
+    else
+    {
+      cryptonote::NOTIFY_NEW_FLUFFY_BLOCK::request req;
+      req.b = random_block(20);
+      req.current_blockchain_height = 2000000;
+      if (!epee::serialization::store_t_to_binary(req, payload))
+        return false;
+    }
+    m_payload.assign(reinterpret_cast<const char*>(payload.data()), payload.size());
+    return true;
+  }
+
+  bool test()
+  {
+    typedef typename std::conditional<GetBlocksFast, cryptonote::COMMAND_RPC_GET_BLOCKS_FAST::response, cryptonote::NOTIFY_NEW_FLUFFY_BLOCK::request>::type payload_t;
+    const uint64_t start = epee::misc_utils::get_ns_count();
+    payload_t p;
+    const bool r = epee::serialization::load_t_from_binary(p, epee::strspan<uint8_t>(m_payload));
+    m_elapsed_ns += epee::misc_utils::get_ns_count() - start;
+    ++m_num_calls;
+    return r;
+  }
+
+private:
+  static std::string random_blob(const size_t size)
+  {
+    std::string blob(size, '\0');
+    crypto::rand(size, reinterpret_cast<uint8_t*>(&blob[0]));
+    return blob;
+  }
+
+  static cryptonote::block_complete_entry random_block(const size_t num_txes)
+  {
+    cryptonote::block_complete_entry b;
+    b.block = random_blob(200);
+    for (size_t t = 0; t < num_txes; ++t)
+      b.txs.push_back({random_blob(2500), crypto::null_hash});
+    return b;
+  }
+
+  std::string m_payload;
+  uint64_t m_elapsed_ns{0};
+  uint64_t m_num_calls{0};
+};
@@ -0,0 +1,353 @@
+// Copyright (c) 2021, The Monero Project
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of
+//    conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list
+//    of conditions and the following disclaimer in the documentation and/or other
+//    materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be
+//    used to endorse or promote products derived from this software without specific
+//    prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+// THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include "version.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * One structured record per performance test
+ * - tx fields are only set by tests that describe a tx (e.g. test_mock_tx); they are 0/empty otherwise
+ * - latency fields are per call, in ns
+ * - hardware counter fields are per call, and only set if the run collected them (--perf-counters)
+ * - allocation fields are per call (peak live bytes: largest single call), and only set with --track-allocations
+ * - clock fields are relative changes over the timed section (see CpuClockCheck)
+ */
+struct PerfTestRecord final
+{
+  std::string test_name;
+
+  // tx parameters
+  std::string descriptor;
+  size_t batch_size{0};
+  size_t in_count{0};
+  size_t out_count{0};
+  size_t n{0};
+  size_t m{0};
+  size_t rangeproof_splits{0};
+  size_t tx_bytes{0};
+
+  // run parameters
+  size_t loop_count{0};
+  unsigned threads{1};
+
+  // results
+  double min{0};
+  double median{0};
+  double mean{0};
+  double stddev{0};
+  double max{0};
+  std::vector<uint64_t> deciles;
+  double calls_per_second{0};
+
+  // hardware counters
+  bool perf_counters{false};
+  double cycles_per_call{0};
+  double instructions_per_call{0};
+  double ipc{0};
+  double l1d_misses_per_call{0};
+  double llc_misses_per_call{0};
+  double branch_misses_per_call{0};
+
+  // heap allocations
+  bool allocations{false};
+  double allocations_per_call{0};
+  double bytes_allocated_per_call{0};
+  uint64_t peak_live_bytes{0};
+
+  // cpu clock
+  bool clock_check{false};
+  double core_speed_change{0};
+  double tick_rate_change{0};
+};
+
+/**
+ * Tests may describe themselves in their records by providing
+ *   void get_record_info(PerfTestRecord &record) const;
+ */
+template <typename T>
+auto get_test_record_info(const T &test, PerfTestRecord &record, int) -> decltype(test.get_record_info(record), void())
+{
+  test.get_record_info(record);
+}
+
+template <typename T>
+void get_test_record_info(const T&, PerfTestRecord&, long)
+{
+}
+
+/**
+ * Result sink: appends one record per test to a file, either as JSON lines (one object per line) or as CSV rows
+ * (a header row is written if the file is empty)
+ * - each record carries the build and CPU info, so files from different machines/builds can be merged
+ * - records are flushed as soon as they are added, so partial runs still leave usable results
+ */
+class PerfResultsSink final
+{
+public:
+  enum class Format
+  {
+    JSON,
+    CSV
+  };
+
+  PerfResultsSink(const std::string &filename, const Format format)
+    : m_format(format)
+    , m_build_info(get_build_info())
+    , m_cpu_info(get_cpu_info())
+    , m_cpu_threads(std::thread::hardware_concurrency())
+  {
+    bool file_is_empty;
+    {
+      std::ifstream existing_file(filename, std::ios::in | std::ios::binary | std::ios::ate);
+      file_is_empty = !existing_file.good() || existing_file.tellg() <= 0;
+    }
+
+    m_file.open(filename, std::ios::out | std::ios::app);
+
+    if (m_format == Format::CSV && m_file.good() && file_is_empty)
+      m_file << csv_header() << std::endl;
+  }
+
+  bool good() const { return m_file.good(); }
+
+  void add(const PerfTestRecord &record)
+  {
+    if (m_format == Format::JSON)
+      m_file << to_json(record) << std::endl;
+    else
+      m_file << to_csv(record, m_build_info, m_cpu_info, m_cpu_threads) << std::endl;
+  }
+
+  // build/CPU info and CSV rows (shared with PerfTimingsStore, which exports its records with the same columns)
+  static std::string get_build_info()
+  {
+    std::string build_info{std::string{"monero "} + MONERO_VERSION_FULL};
+#if defined(__VERSION__)
+    build_info += std::string{"; compiler "} + __VERSION__;
+#endif
+#if defined(NDEBUG)
+    build_info += "; release";
+#else
+    build_info += "; debug";
+#endif
+    return build_info;
+  }
+
+  static std::string get_cpu_info()
+  {
+    // linux only: first 'model name' entry
+    std::ifstream cpuinfo("/proc/cpuinfo");
+    std::string line;
+    while (std::getline(cpuinfo, line))
+    {
+      if (line.compare(0, 10, "model name") != 0)
+        continue;
+      const size_t separator = line.find(':');
+      if (separator == std::string::npos)
+        break;
+      const size_t start = line.find_first_not_of(' ', separator + 1);
+      return start == std::string::npos ? std::string{} : line.substr(start);
+    }
+    return "unknown";
+  }
+
+  static std::string csv_header()
+  {
+    std::string header{"test,descriptor,batch_size,in_count,out_count,n,m,rangeproof_splits,tx_bytes,loop_count,threads,"
+      "min_ns,median_ns,mean_ns,stddev_ns,max_ns,"};
+    for (size_t i = 0; i <= 10; ++i)
+      header += "decile_" + std::to_string(i) + "_ns,";
+    header += "calls_per_second,cycles_per_call,instructions_per_call,ipc,l1d_misses_per_call,llc_misses_per_call,"
+      "branch_misses_per_call,allocations_per_call,bytes_allocated_per_call,peak_live_bytes,core_speed_change,"
+      "tick_rate_change,build,cpu,cpu_threads";
+    return header;
+  }
+
+  static std::string to_csv(const PerfTestRecord &record,
+    const std::string &build_info,
+    const std::string &cpu_info,
+    const unsigned cpu_threads)
+  {
+    std::ostringstream csv;
+    csv.precision(17);
+    csv << csv_string(record.test_name) << ','
+      << csv_string(record.descriptor) << ','
+      << record.batch_size << ','
+      << record.in_count << ','
+      << record.out_count << ','
+      << record.n << ','
+      << record.m << ','
+      << record.rangeproof_splits << ','
+      << record.tx_bytes << ','
+      << record.loop_count << ','
+      << record.threads << ','
+      << record.min << ','
+      << record.median << ','
+      << record.mean << ','
+      << record.stddev << ','
+      << record.max << ',';
+    // always 11 decile columns (min, 10th, ..., max), to match the header
+    for (size_t i = 0; i <= 10; ++i)
+      csv << (i < record.deciles.size() ? record.deciles[i] : 0) << ',';
+    csv << record.calls_per_second << ',';
+    // counter/allocation/clock columns are left empty if they were not collected
+    if (record.perf_counters)
+    {
+      csv << record.cycles_per_call << ','
+        << record.instructions_per_call << ','
+        << record.ipc << ','
+        << record.l1d_misses_per_call << ','
+        << record.llc_misses_per_call << ','
+        << record.branch_misses_per_call << ',';
+    }
+    else
+      csv << ",,,,,,";
+    if (record.allocations)
+    {
+      csv << record.allocations_per_call << ','
+        << record.bytes_allocated_per_call << ','
+        << record.peak_live_bytes << ',';
+    }
+    else
+      csv << ",,,";
+    if (record.clock_check)
+      csv << record.core_speed_change << ',' << record.tick_rate_change << ',';
+    else
+      csv << ",,";
+    csv << csv_string(build_info) << ','
+      << csv_string(cpu_info) << ','
+      << cpu_threads;
+    return csv.str();
+  }
+
+private:
+  static std::string json_string(const std::string &s)
+  {
+    std::string escaped{"\""};
+    for (const char c : s)
+    {
+      if (c == '"' || c == '\\')
+      {
+        escaped += '\\';
+        escaped += c;
+      }
+      else if (static_cast<unsigned char>(c) < 0x20)
+      {
+        char buffer[8];
+        snprintf(buffer, sizeof(buffer), "\\u%04x", static_cast<unsigned>(c));
+        escaped += buffer;
+      }
+      else
+        escaped += c;
+    }
+    escaped += '"';
+    return escaped;
+  }
+
+  static std::string csv_string(const std::string &s)
+  {
+    std::string quoted{"\""};
+    for (const char c : s)
+    {
+      if (c == '"')
+        quoted += '"';
+      quoted += c;
+    }
+    quoted += '"';
+    return quoted;
+  }
+
+  std::string to_json(const PerfTestRecord &record) const
+  {
+    std::ostringstream json;
+    json.precision(17);
+    json << "{\"test\":" << json_string(record.test_name)
+      << ",\"descriptor\":" << json_string(record.descriptor)
+      << ",\"batch_size\":" << record.batch_size
+      << ",\"in_count\":" << record.in_count
+      << ",\"out_count\":" << record.out_count
+      << ",\"n\":" << record.n
+      << ",\"m\":" << record.m
+      << ",\"rangeproof_splits\":" << record.rangeproof_splits
+      << ",\"tx_bytes\":" << record.tx_bytes
+      << ",\"loop_count\":" << record.loop_count
+      << ",\"threads\":" << record.threads
+      << ",\"min_ns\":" << record.min
+      << ",\"median_ns\":" << record.median
+      << ",\"mean_ns\":" << record.mean
+      << ",\"stddev_ns\":" << record.stddev
+      << ",\"max_ns\":" << record.max
+      << ",\"deciles_ns\":[";
+    for (size_t i = 0; i < record.deciles.size(); ++i)
+      json << (i > 0 ? "," : "") << record.deciles[i];
+    json << "]"
+      << ",\"calls_per_second\":" << record.calls_per_second;
+    if (record.perf_counters)
+    {
+      json << ",\"cycles_per_call\":" << record.cycles_per_call
+        << ",\"instructions_per_call\":" << record.instructions_per_call
+        << ",\"ipc\":" << record.ipc
+        << ",\"l1d_misses_per_call\":" << record.l1d_misses_per_call
+        << ",\"llc_misses_per_call\":" << record.llc_misses_per_call
+        << ",\"branch_misses_per_call\":" << record.branch_misses_per_call;
+    }
+    if (record.allocations)
+    {
+      json << ",\"allocations_per_call\":" << record.allocations_per_call
+        << ",\"bytes_allocated_per_call\":" << record.bytes_allocated_per_call
+        << ",\"peak_live_bytes\":" << record.peak_live_bytes;
+    }
+    if (record.clock_check)
+    {
+      json << ",\"core_speed_change\":" << record.core_speed_change
+        << ",\"tick_rate_change\":" << record.tick_rate_change;
+    }
+    json << ",\"build\":" << json_string(m_build_info)
+      << ",\"cpu\":" << json_string(m_cpu_info)
+      << ",\"cpu_threads\":" << m_cpu_threads
+      << "}";
+    return json.str();
+  }
+
+private:
+  Format m_format;
+  std::ofstream m_file;
+  std::string m_build_info;
+  std::string m_cpu_info;
+  unsigned m_cpu_threads;
+};
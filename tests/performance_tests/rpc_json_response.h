@@ -0,0 +1,145 @@
+// Copyright (c) 2021, The Monero Project
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of
+//    conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list
+//    of conditions and the following disclaimer in the documentation and/or other
+//    materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be
+//    used to endorse or promote products derived from this software without specific
+//    prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+// THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <iostream>
+#include <string>
+
+#include "byte_slice.h"
+#include "byte_stream.h"
+#include "crypto/crypto.h"
+#include "misc_os_dependent.h"
+#include "rpc/core_rpc_server_commands_defs.h"
+#include "rpc/json_response_writer.h"
+#include "storages/portable_storage_template_helper.h"
+#include "string_tools.h"
+
+// serialize a /get_transaction_pool response for a large pool as json
+// - generic: through a portable_storage tree and store_t_to_json()
+// - streamed: written by write_get_transaction_pool_response()
+// - reports response MB/s served per core; init() checks that both responses
+//   load back to the same fields
+template<size_t NumTxes, bool Streamed>
+class test_rpc_json_response
+{
+public:
+  static const size_t loop_count = 20;
+
+  ~test_rpc_json_response()
+  {
+    if (m_elapsed_ns == 0 || m_num_calls == 0)
+      return;
+    std::cout << "  " << (Streamed ? "streamed" : "generic") << ", response bytes: " << m_response_size
+      << ", MB/s: " << static_cast<double>(m_response_size) * m_num_calls * 1e3 / m_elapsed_ns << '\n';
+  }
+
+  bool init()
+  {
+    // a 2-in 2-out tx: ~2.5 kB blob, ~10 kB of json
+    m_res.status = CORE_RPC_STATUS_OK;
+    m_res.transactions.resize(NumTxes);
+    for (cryptonote::tx_info &txi: m_res.transactions)
+    {
+      txi.id_hash = epee::string_tools::pod_to_hex(crypto::rand<crypto::hash>());
+      txi.tx_blob = epee::string_tools::buff_to_hex_nodelimer(random_blob(2500));
+      txi.tx_json = "{\n  \"version\": 2, \n  \"extra\": \"" + epee::string_tools::buff_to_hex_nodelimer(random_blob(4000)) + "\"\n}";
+      txi.blob_size = 2500;
+      txi.weight = 2500;
+      txi.fee = crypto::rand<uint32_t>();
+      txi.max_used_block_id_hash = epee::string_tools::pod_to_hex(crypto::rand<crypto::hash>());
+      txi.receive_time = 1600000000;
+      txi.relayed = true;
+      cryptonote::spent_key_image_info ski;
+      ski.id_hash = epee::string_tools::pod_to_hex(crypto::rand<crypto::hash>());
+      ski.txs_hashes.push_back(txi.id_hash);
+      m_res.spent_key_images.push_back(std::move(ski));
+    }
+
+    std::string generic, streamed;
+    if (!serialize_generic(generic) || !serialize_streamed(streamed))
+      return false;
+    cryptonote::COMMAND_RPC_GET_TRANSACTION_POOL::response a, b;
+    if (!epee::serialization::load_t_from_json(a, generic) || !epee::serialization::load_t_from_json(b, streamed))
+      return false;
+    if (a.transactions.size() != NumTxes || b.transactions.size() != NumTxes || a.spent_key_images.size() != b.spent_key_images.size()
+        || a.status != b.status)
+    {
+      std::cerr << "streamed response differs from the generic one" << std::endl;
+      return false;
+    }
+    for (size_t n = 0; n < NumTxes; ++n)
+    {
+      const cryptonote::tx_info &x = a.transactions[n], &y = b.transactions[n];
+      if (x.id_hash != y.id_hash || x.tx_blob != y.tx_blob || x.tx_json != y.tx_json || x.fee != y.fee || x.weight != y.weight)
+      {
+        std::cerr << "streamed response differs from the generic one" << std::endl;
+        return false;
+      }
+    }
+    m_response_size = Streamed ? streamed.size() : generic.size();
+    return true;
+  }
+
+  bool test()
+  {
+    const uint64_t start = epee::misc_utils::get_ns_count();
+    std::string body;
+    const bool r = Streamed ? serialize_streamed(body) : serialize_generic(body);
+    m_elapsed_ns += epee::misc_utils::get_ns_count() - start;
+    ++m_num_calls;
+    return r && body.size() == m_response_size;
+  }
+
+private:
+  static std::string random_blob(const size_t size)
+  {
+    std::string blob(size, '\0');
+    crypto::rand(size, reinterpret_cast<uint8_t*>(&blob[0]));
+    return blob;
+  }
+
+  bool serialize_generic(std::string &body) const
+  {
+    return epee::serialization::store_t_to_json(m_res, body);
+  }
+
+  bool serialize_streamed(std::string &body) const
+  {
+    epee::byte_stream out;
+    cryptonote::write_get_transaction_pool_response(out, m_res);
+    const epee::byte_slice slice{std::move(out)};
+    body.assign(reinterpret_cast<const char*>(slice.data()), slice.size());
+    return true;
+  }
+
+  cryptonote::COMMAND_RPC_GET_TRANSACTION_POOL::response m_res;
+  size_t m_response_size{0};
+  uint64_t m_elapsed_ns{0};
+  uint64_t m_num_calls{0};
+};
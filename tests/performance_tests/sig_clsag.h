@@ -36,7 +36,8 @@
 
 using namespace rct;
 
-template<size_t a_N, size_t a_T, size_t a_w>
+// a_warm: keep ring members' Hp(P) in the hash_to_p3 cache between runs (as for decoys seen in earlier txs)
+template<size_t a_N, size_t a_T, size_t a_w, bool a_warm = false>
 class test_sig_clsag
 {
     public:
@@ -44,6 +45,15 @@ class test_sig_clsag
         static const size_t N = a_N;
         static const size_t T = a_T;
         static const size_t w = a_w;
+        static const bool warm = a_warm;
+
+        ~test_sig_clsag()
+        {
+            if (!warm)
+                return;
+            const hash_to_p3_cache_stats stats = get_hash_to_p3_cache().get_stats();
+            std::cout << "  hash_to_p3 cache: hits " << stats.hits << ", misses " << stats.misses << ", hit rate " << stats.hit_rate() << std::endl;
+        }
 
         bool init()
         {
@@ -120,11 +130,17 @@ class test_sig_clsag
                 sigs.push_back(proveRctCLSAGSimple(messages[u],pubs,sk,s1[u],C_offsets[u],NULL,NULL,NULL,u,hw::get_device("default")));
             }
 
+            get_hash_to_p3_cache().clear();
+            get_hash_to_p3_cache().reset_stats();
+
             return true;
         }
 
         bool test()
         {
+            if (!warm)
+                get_hash_to_p3_cache().clear();
+
             for (size_t u = 0; u < w; u++)
             {
                 if (!verRctCLSAGSimple(messages[u],sigs[u],pubs,C_offsets[u]))
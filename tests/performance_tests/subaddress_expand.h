@@ -31,8 +31,12 @@
 #pragma once
 
 #include "wallet/wallet2.h"
+#include "cryptonote_basic/subaddress_table.h"
 #include "ringct/rctOps.h"
 
+#include <unordered_map>
+#include <vector>
+
 #include "single_tx_test_base.h"
 
 template<size_t Major, size_t Minor>
@@ -63,3 +67,61 @@ public:
 private:
   tools::wallet2 wallet;
 };
+
+// look up nominal spend keys in a wallet's subaddresses, as view scanning does for every output
+// - most lookups miss (outputs to other wallets); every 16th hits
+template<size_t NumSubaddresses, bool UseTable>
+class test_subaddress_lookup
+{
+public:
+  static const size_t loop_count = 100;
+  static const size_t num_lookups = 4096;
+
+  bool init()
+  {
+    // lookups don't need valid points, so random bytes stand in for the spend keys
+    std::vector<crypto::public_key> spend_keys(NumSubaddresses);
+    for (size_t i = 0; i < NumSubaddresses; ++i)
+    {
+      spend_keys[i] = crypto::rand<crypto::public_key>();
+      const cryptonote::subaddress_index index{static_cast<uint32_t>(i / 1000), static_cast<uint32_t>(i % 1000)};
+      if (UseTable)
+        m_table.insert(spend_keys[i], index);
+      else
+        m_map[spend_keys[i]] = index;
+    }
+
+    m_lookups.resize(num_lookups);
+    m_expected_hits = 0;
+    for (size_t i = 0; i < num_lookups; ++i)
+    {
+      if (i % 16 == 0)
+      {
+        m_lookups[i] = spend_keys[crypto::rand_idx(spend_keys.size())];
+        ++m_expected_hits;
+      }
+      else
+        m_lookups[i] = crypto::rand<crypto::public_key>();
+    }
+    return true;
+  }
+
+  bool test()
+  {
+    size_t hits = 0;
+    for (const crypto::public_key &spend_key: m_lookups)
+    {
+      if (UseTable)
+        hits += m_table.find(spend_key) != nullptr;
+      else
+        hits += m_map.find(spend_key) != m_map.end();
+    }
+    return hits == m_expected_hits;
+  }
+
+private:
+  std::unordered_map<crypto::public_key, cryptonote::subaddress_index> m_map;
+  cryptonote::subaddress_table m_table;
+  std::vector<crypto::public_key> m_lookups;
+  size_t m_expected_hits;
+};
@@ -0,0 +1,122 @@
+// Copyright (c) 2021, The Monero Project
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of
+//    conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list
+//    of conditions and the following disclaimer in the documentation and/or other
+//    materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be
+//    used to endorse or promote products derived from this software without specific
+//    prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+// THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include <atomic>
+#include <iostream>
+
+#include "common/threadpool.h"
+#include "misc_os_dependent.h"
+
+// cost of going through tools::threadpool for tiny tasks
+// - dispatch: submit N empty tasks from outside the pool and wait for them
+// - nested parallel-for: Outer tasks each submitting Inner tasks and waiting on them, from within the pool
+// - reports ns per task
+template<size_t N>
+class test_threadpool_dispatch
+{
+public:
+  static const size_t loop_count = 100;
+
+  ~test_threadpool_dispatch()
+  {
+    if (m_num_tasks == 0)
+      return;
+    std::cout << "  dispatch of " << N << " tasks, ns/task: " << static_cast<double>(m_elapsed_ns) / m_num_tasks << '\n';
+  }
+
+  bool init()
+  {
+    return true;
+  }
+
+  bool test()
+  {
+    tools::threadpool &tpool = tools::threadpool::getInstance();
+    tools::threadpool::waiter waiter(tpool);
+    std::atomic<size_t> count(0);
+    const uint64_t start = epee::misc_utils::get_ns_count();
+    for (size_t i = 0; i < N; ++i)
+      tpool.submit(&waiter, [&count](){ ++count; }, true);
+    const bool r = waiter.wait();
+    m_elapsed_ns += epee::misc_utils::get_ns_count() - start;
+    m_num_tasks += N;
+    return r && count == N;
+  }
+
+private:
+  uint64_t m_elapsed_ns{0};
+  uint64_t m_num_tasks{0};
+};
+
+template<size_t Outer, size_t Inner>
+class test_threadpool_nested_parallel_for
+{
+public:
+  static const size_t loop_count = 100;
+
+  ~test_threadpool_nested_parallel_for()
+  {
+    if (m_num_tasks == 0)
+      return;
+    std::cout << "  nested parallel-for " << Outer << "x" << Inner << ", ns/task: " << static_cast<double>(m_elapsed_ns) / m_num_tasks << '\n';
+  }
+
+  bool init()
+  {
+    return true;
+  }
+
+  bool test()
+  {
+    tools::threadpool &tpool = tools::threadpool::getInstance();
+    tools::threadpool::waiter waiter(tpool);
+    std::atomic<size_t> count(0);
+    std::atomic<bool> ok(true);
+    const uint64_t start = epee::misc_utils::get_ns_count();
+    for (size_t i = 0; i < Outer; ++i)
+    {
+      tpool.submit(&waiter, [&tpool, &count, &ok](){
+        tools::threadpool::waiter inner_waiter(tpool);
+        for (size_t j = 0; j < Inner; ++j)
+          tpool.submit(&inner_waiter, [&count](){ ++count; }, true);
+        if (!inner_waiter.wait())
+          ok = false;
+      });
+    }
+    const bool r = waiter.wait();
+    m_elapsed_ns += epee::misc_utils::get_ns_count() - start;
+    m_num_tasks += Outer * (Inner + 1);
+    return r && ok && count == Outer * Inner;
+  }
+
+private:
+  uint64_t m_elapsed_ns{0};
+  uint64_t m_num_tasks{0};
+};
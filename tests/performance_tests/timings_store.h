@@ -0,0 +1,420 @@
+// Copyright (c) 2021, The Monero Project
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of
+//    conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list
+//    of conditions and the following disclaimer in the documentation and/or other
+//    materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be
+//    used to endorse or promote products derived from this software without specific
+//    prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+// THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include "results_sink.h"
+
+#include <boost/filesystem.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/**
+ * Append-only binary timings store: one PerfTestRecord per test run, indexed by test name and time stamp
+ * - file: an 8-byte magic, then records of [u32 body size][body]; the body starts with the time stamp and test name,
+ *   so opening a store only reads those (and seeks past the rest) to build the index
+ * - the record's fields are stored as typed columns (tx parameters, run parameters, results, build/CPU info), so
+ *   mock tx sweep points with the same test name can be told apart without parsing descriptor strings
+ * - integers and doubles are stored in host byte order; stores are not portable across endianness
+ * - a record left incomplete by a crash is cut off when the store is opened
+ */
+class PerfTimingsStore final
+{
+public:
+  struct Entry
+  {
+    uint64_t timestamp{0};
+    PerfTestRecord record;
+    std::string build_info;
+    std::string cpu_info;
+    unsigned cpu_threads{0};
+  };
+
+  explicit PerfTimingsStore(const std::string &filename)
+    : m_filename(filename)
+  {
+    m_good = open();
+  }
+
+  bool good() const { return m_good; }
+  size_t size() const { return m_num_records; }
+
+  std::vector<std::string> get_test_names() const
+  {
+    std::vector<std::string> test_names;
+    test_names.reserve(m_index.size());
+    for (const auto &test_index : m_index)
+      test_names.push_back(test_index.first);
+    return test_names;
+  }
+
+  /// append a record (time stamp: seconds since the epoch)
+  bool add(const PerfTestRecord &record, const uint64_t timestamp)
+  {
+    if (!m_good)
+      return false;
+
+    std::string body;
+    write_u64(body, timestamp);
+    write_string(body, record.test_name);
+    write_string(body, record.descriptor);
+    write_u64(body, record.batch_size);
+    write_u64(body, record.in_count);
+    write_u64(body, record.out_count);
+    write_u64(body, record.n);
+    write_u64(body, record.m);
+    write_u64(body, record.rangeproof_splits);
+    write_u64(body, record.tx_bytes);
+    write_u64(body, record.loop_count);
+    write_u64(body, record.threads);
+    write_f64(body, record.min);
+    write_f64(body, record.median);
+    write_f64(body, record.mean);
+    write_f64(body, record.stddev);
+    write_f64(body, record.max);
+    write_u64(body, record.deciles.size());
+    for (const uint64_t decile : record.deciles)
+      write_u64(body, decile);
+    write_f64(body, record.calls_per_second);
+    write_u64(body, record.perf_counters);
+    write_f64(body, record.cycles_per_call);
+    write_f64(body, record.instructions_per_call);
+    write_f64(body, record.ipc);
+    write_f64(body, record.l1d_misses_per_call);
+    write_f64(body, record.llc_misses_per_call);
+    write_f64(body, record.branch_misses_per_call);
+    write_u64(body, record.allocations);
+    write_f64(body, record.allocations_per_call);
+    write_f64(body, record.bytes_allocated_per_call);
+    write_u64(body, record.peak_live_bytes);
+    write_string(body, m_build_info);
+    write_string(body, m_cpu_info);
+    write_u64(body, m_cpu_threads);
+
+    if (body.size() > MAX_RECORD_SIZE)
+      return false;
+
+    std::ofstream file(m_filename, std::ios::out | std::ios::binary | std::ios::app);
+    const uint32_t body_size = body.size();
+    file.write(reinterpret_cast<const char*>(&body_size), sizeof(body_size));
+    file.write(body.data(), body.size());
+    file.flush();
+    if (!file.good())
+    {
+      m_good = false;
+      return false;
+    }
+
+    add_to_index(record.test_name, timestamp, m_file_size);
+    m_file_size += sizeof(body_size) + body.size();
+    ++m_num_records;
+    return true;
+  }
+
+  /// records of a test with time stamps in [from, to], oldest first
+  std::vector<Entry> get(const std::string &test_name,
+    const uint64_t from = 0,
+    const uint64_t to = std::numeric_limits<uint64_t>::max()) const
+  {
+    std::vector<Entry> entries;
+    const auto test_index = m_index.find(test_name);
+    if (test_index == m_index.end() || from > to)
+      return entries;
+
+    const std::vector<IndexEntry> &index_entries = test_index->second;
+    const auto begin = std::lower_bound(index_entries.begin(), index_entries.end(), from,
+      [](const IndexEntry &index_entry, const uint64_t timestamp){ return index_entry.timestamp < timestamp; });
+    const auto end = std::upper_bound(begin, index_entries.end(), to,
+      [](const uint64_t timestamp, const IndexEntry &index_entry){ return timestamp < index_entry.timestamp; });
+
+    std::ifstream file(m_filename, std::ios::in | std::ios::binary);
+    for (auto index_entry = begin; index_entry != end; ++index_entry)
+    {
+      entries.emplace_back();
+      if (!read_entry(file, index_entry->offset, entries.back()))
+      {
+        entries.pop_back();
+        break;
+      }
+    }
+    return entries;
+  }
+
+  /// write the records of the tests whose names pass a filter, with time stamps in [from, to], as CSV
+  /// (test by test, oldest first; columns as in PerfResultsSink's CSV files, after a time stamp column)
+  template <typename FilterT>
+  size_t export_csv(std::ostream &out, const FilterT &test_name_filter, const uint64_t from, const uint64_t to) const
+  {
+    size_t num_exported{0};
+    out << "timestamp," << PerfResultsSink::csv_header() << '\n';
+    for (const auto &test_index : m_index)
+    {
+      if (!test_name_filter(test_index.first))
+        continue;
+      for (const Entry &entry : get(test_index.first, from, to))
+      {
+        out << entry.timestamp << ','
+          << PerfResultsSink::to_csv(entry.record, entry.build_info, entry.cpu_info, entry.cpu_threads) << '\n';
+        ++num_exported;
+      }
+    }
+    out.flush();
+    return num_exported;
+  }
+
+private:
+  struct IndexEntry
+  {
+    uint64_t timestamp;
+    uint64_t offset;  // of the record's size field
+  };
+
+  static constexpr const char *MAGIC = "MONPERF1";
+  static constexpr size_t MAGIC_SIZE = 8;
+  static constexpr uint32_t MAX_RECORD_SIZE = 1 << 24;
+
+  bool open()
+  {
+    m_build_info = PerfResultsSink::get_build_info();
+    m_cpu_info = PerfResultsSink::get_cpu_info();
+    m_cpu_threads = std::thread::hardware_concurrency();
+
+    uint64_t file_size{0};
+    {
+      std::ifstream existing_file(m_filename, std::ios::in | std::ios::binary | std::ios::ate);
+      if (existing_file.good())
+        file_size = existing_file.tellg();
+    }
+
+    // new store: write the magic
+    if (file_size == 0)
+    {
+      std::ofstream file(m_filename, std::ios::out | std::ios::binary | std::ios::trunc);
+      file.write(MAGIC, MAGIC_SIZE);
+      m_file_size = MAGIC_SIZE;
+      return file.good();
+    }
+
+    std::ifstream file(m_filename, std::ios::in | std::ios::binary);
+    char magic[MAGIC_SIZE];
+    if (file_size < MAGIC_SIZE || !file.read(magic, MAGIC_SIZE) || memcmp(magic, MAGIC, MAGIC_SIZE) != 0)
+      return false;
+
+    // index: read each record's size, time stamp and test name, and skip the rest of it
+    uint64_t offset{MAGIC_SIZE};
+    while (offset < file_size)
+    {
+      uint32_t body_size;
+      uint64_t timestamp;
+      uint64_t name_size;
+      file.seekg(offset);
+      if (file_size - offset < sizeof(body_size) ||
+          !file.read(reinterpret_cast<char*>(&body_size), sizeof(body_size)) ||
+          body_size > MAX_RECORD_SIZE ||
+          body_size > file_size - offset - sizeof(body_size) ||
+          body_size < sizeof(timestamp) + sizeof(name_size) ||
+          !file.read(reinterpret_cast<char*>(&timestamp), sizeof(timestamp)) ||
+          !file.read(reinterpret_cast<char*>(&name_size), sizeof(name_size)) ||
+          name_size > body_size - sizeof(timestamp) - sizeof(name_size))
+        break;
+
+      std::string test_name(name_size, '\0');
+      if (!file.read(&test_name[0], name_size))
+        break;
+
+      add_to_index(test_name, timestamp, offset);
+      offset += sizeof(body_size) + body_size;
+      ++m_num_records;
+    }
+    file.close();
+
+    // cut off an incomplete last record, so new records are appended after the complete ones
+    if (offset != file_size)
+    {
+      boost::system::error_code ec;
+      boost::filesystem::resize_file(m_filename, offset, ec);
+      if (ec)
+        return false;
+    }
+    m_file_size = offset;
+
+    return true;
+  }
+
+  void add_to_index(const std::string &test_name, const uint64_t timestamp, const uint64_t offset)
+  {
+    // records are usually appended in time order, so this is usually a push_back
+    std::vector<IndexEntry> &index_entries = m_index[test_name];
+    const auto position = std::upper_bound(index_entries.begin(), index_entries.end(), timestamp,
+      [](const uint64_t timestamp, const IndexEntry &index_entry){ return timestamp < index_entry.timestamp; });
+    index_entries.insert(position, IndexEntry{timestamp, offset});
+  }
+
+  bool read_entry(std::ifstream &file, const uint64_t offset, Entry &entry_out) const
+  {
+    uint32_t body_size;
+    file.seekg(offset);
+    if (!file.read(reinterpret_cast<char*>(&body_size), sizeof(body_size)) || body_size > MAX_RECORD_SIZE)
+      return false;
+    std::string body(body_size, '\0');
+    if (!file.read(&body[0], body_size))
+      return false;
+
+    BodyReader reader{body.data(), body.data() + body.size()};
+    PerfTestRecord &record = entry_out.record;
+    uint64_t num_deciles{0};
+    uint64_t flag{0};
+    uint64_t value{0};
+
+    entry_out.timestamp = reader.u64();
+    record.test_name = reader.string();
+    record.descriptor = reader.string();
+    record.batch_size = reader.u64();
+    record.in_count = reader.u64();
+    record.out_count = reader.u64();
+    record.n = reader.u64();
+    record.m = reader.u64();
+    record.rangeproof_splits = reader.u64();
+    record.tx_bytes = reader.u64();
+    record.loop_count = reader.u64();
+    record.threads = reader.u64();
+    record.min = reader.f64();
+    record.median = reader.f64();
+    record.mean = reader.f64();
+    record.stddev = reader.f64();
+    record.max = reader.f64();
+    num_deciles = reader.u64();
+    if (num_deciles > body_size / sizeof(uint64_t))
+      return false;
+    record.deciles.resize(num_deciles);
+    for (uint64_t &decile : record.deciles)
+      decile = reader.u64();
+    record.calls_per_second = reader.f64();
+    flag = reader.u64();
+    record.perf_counters = flag != 0;
+    record.cycles_per_call = reader.f64();
+    record.instructions_per_call = reader.f64();
+    record.ipc = reader.f64();
+    record.l1d_misses_per_call = reader.f64();
+    record.llc_misses_per_call = reader.f64();
+    record.branch_misses_per_call = reader.f64();
+    flag = reader.u64();
+    record.allocations = flag != 0;
+    record.allocations_per_call = reader.f64();
+    record.bytes_allocated_per_call = reader.f64();
+    record.peak_live_bytes = reader.u64();
+    entry_out.build_info = reader.string();
+    entry_out.cpu_info = reader.string();
+    value = reader.u64();
+    entry_out.cpu_threads = value;
+
+    return reader.ok;
+  }
+
+  // bounds-checked reads from a record body (reads past the end give 0/empty and clear 'ok')
+  struct BodyReader
+  {
+    const char *position;
+    const char *end;
+    bool ok{true};
+
+    uint64_t u64()
+    {
+      uint64_t value{0};
+      read(&value, sizeof(value));
+      return value;
+    }
+
+    double f64()
+    {
+      double value{0};
+      read(&value, sizeof(value));
+      return value;
+    }
+
+    std::string string()
+    {
+      const uint64_t size{u64()};
+      if (!ok || size > static_cast<uint64_t>(end - position))
+      {
+        ok = false;
+        return {};
+      }
+      std::string value(position, size);
+      position += size;
+      return value;
+    }
+
+    void read(void *value, const size_t size)
+    {
+      if (!ok || size > static_cast<size_t>(end - position))
+      {
+        ok = false;
+        return;
+      }
+      memcpy(value, position, size);
+      position += size;
+    }
+  };
+
+  static void write_u64(std::string &body, const uint64_t value)
+  {
+    body.append(reinterpret_cast<const char*>(&value), sizeof(value));
+  }
+
+  static void write_f64(std::string &body, const double value)
+  {
+    body.append(reinterpret_cast<const char*>(&value), sizeof(value));
+  }
+
+  static void write_string(std::string &body, const std::string &value)
+  {
+    write_u64(body, value.size());
+    body.append(value);
+  }
+
+private:
+  std::string m_filename;
+  bool m_good{false};
+  uint64_t m_file_size{0};
+  size_t m_num_records{0};
+  std::map<std::string, std::vector<IndexEntry>> m_index;
+  std::string m_build_info;
+  std::string m_cpu_info;
+  unsigned m_cpu_threads{0};
+};
@@ -28,6 +28,8 @@
 
 #pragma once
 
+#include <boost/filesystem.hpp>
+#include "blockchain_db/enote_stream.h"
 #include "crypto/crypto.h"
 extern "C"
 {
@@ -36,13 +38,23 @@ extern "C"
 }
 #include "device/device.hpp"
 #include "mock_tx/mock_sp_transaction_component_types.h"
+#include "common/threadpool.h"
 #include "mock_tx/mock_sp_core_utils.h"
+#include "mock_tx/mock_sp_enote_scanner.h"
+#include "mock_tx/mock_sp_transaction_builder_types.h"
+#include "mock_tx/mock_sp_transaction_utils.h"
 #include "mock_tx/mock_tx_utils.h"
 #include "mock_tx/seraphis_crypto_utils.h"
 #include "performance_tests.h"
 #include "ringct/rctOps.h"
 #include "ringct/rctTypes.h"
 
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <vector>
+
 
 /// cryptonote view key scanning
 class test_view_scan_cn
@@ -137,6 +149,7 @@ private:
 struct ParamsShuttleViewScan final : public ParamsShuttle
 {
     bool test_view_tag_check{false};
+    mock_tx::SpViewTagHash view_tag_hash{mock_tx::SpViewTagHash::KECCAK};
 };
 
 class test_view_scan_sp
@@ -147,6 +160,7 @@ public:
     bool init(const ParamsShuttleViewScan &params)
     {
         m_test_view_tag_check = params.test_view_tag_check;
+        m_view_tag_hash = params.view_tag_hash;
 
         // user address
         rct::key recipient_DH_base{rct::pkGen()};
@@ -167,7 +181,8 @@ public:
             0, // no amount
             0, // 0 index
             false,
-            m_enote_pubkey);
+            m_enote_pubkey,
+            m_view_tag_hash);
 
         // invalidate view tag to test the performance of short-circuiting on failed view tags
         if (m_test_view_tag_check)
@@ -190,7 +205,8 @@ public:
             m_enote.m_onetime_address,
             m_enote.m_view_tag,
             sender_receiver_secret_dummy,  //outparam not used
-            nominal_recipient_spendkey))
+            nominal_recipient_spendkey,
+            m_view_tag_hash))
         {
             return m_test_view_tag_check;  // only valid if trying to trigger view tag check
         }
@@ -209,101 +225,839 @@ private:
     rct::key m_enote_pubkey;
 
     bool m_test_view_tag_check;
+    mock_tx::SpViewTagHash m_view_tag_hash;
 };
 
 
+/// seraphis view key scanning with multi-byte view tags: sweep tag width against scan throughput and enote size
+struct ParamsShuttleViewScanTagWidth final : public ParamsShuttle
+{
+    std::size_t view_tag_bytes{1};
+    /// enotes scanned per test (one owned by the scanner, the rest not)
+    std::size_t num_enotes{1024};
+};
 
-void domain_separate_derivation_hash_siphash(const std::string &domain_separator,
-    const crypto::key_derivation &derivation,
-    const std::size_t index,
-    rct::key &hash_result_out)
+class test_view_scan_sp_tag_width
 {
-    // derivation_hash = H("domain-sep", derivation, index)
-    std::string hash;
-    hash.reserve(domain_separator.size() + ((sizeof(std::size_t) * 8 + 6) / 7));
-    // "domain-sep"
-    hash = domain_separator;
-    // index
-    char converted_index[(sizeof(size_t) * 8 + 6) / 7];
-    char* end = converted_index;
-    tools::write_varint(end, index);
-    assert(end <= converted_index + sizeof(converted_index));
-    hash.append(converted_index, end - converted_index);
-
-    // siphash key
-    char siphash_key[16];
-    for (std::size_t i{0}; i < 16; ++i)
-        siphash_key[i] = derivation.data[i];
-
-    // hash to the result
-    siphash(hash.data(), hash.size(), siphash_key, hash_result_out.bytes, 8);
-
-    memwipe(siphash_key, 16);
-}
+public:
+    static const size_t loop_count = 20;
+
+    ~test_view_scan_sp_tag_width()
+    {
+        // report throughput and the fallback rate of non-owned enotes
+        if (m_scan_ns == 0 || m_num_scans == 0)
+            return;
+
+        const double enotes_scanned{static_cast<double>(m_num_scans * m_enote_pubkeys.size())};
+
+        std::cout << "  view tag bytes: " << m_view_tag_bytes
+            << ", enotes/sec: " << static_cast<std::size_t>(enotes_scanned * 1e9 / m_scan_ns)
+            << ", view tag false positives: " << m_num_false_positives << " / " << enotes_scanned
+            << " (expected rate 2^-" << 8 * m_view_tag_bytes << ")"
+            << ", enote bytes: " << m_enotes[0].get_size_bytes()
+            << " (2-out tx +" << 2 * (m_view_tag_bytes - 1) << " bytes vs 1-byte tags)" << '\n';
+    }
+
+    bool init(const ParamsShuttleViewScanTagWidth &params)
+    {
+        m_view_tag_bytes = params.view_tag_bytes;
+
+        if (params.num_enotes == 0)
+            return false;
+
+        // user address
+        rct::key recipient_DH_base{rct::pkGen()};
+        m_recipient_view_privkey = rct::rct2sk(rct::skGen());
+        crypto::secret_key recipient_spendbase_privkey{rct::rct2sk(rct::skGen())};
+        rct::key recipient_view_key;
+
+        rct::scalarmultKey(recipient_view_key, recipient_DH_base, rct::sk2rct(m_recipient_view_privkey));
+        mock_tx::make_seraphis_spendkey(m_recipient_view_privkey, recipient_spendbase_privkey, m_recipient_spend_key);
+
+        // enote 0 is owned; the rest are random (i.e. owned by someone else)
+        m_enotes.resize(params.num_enotes);
+        m_enote_pubkeys.resize(params.num_enotes);
+
+        m_enotes[0].make(rct::rct2sk(rct::skGen()),
+            recipient_DH_base,
+            recipient_view_key,
+            m_recipient_spend_key,
+            0, // no amount
+            0, // 0 index
+            false,
+            m_view_tag_bytes,
+            m_enote_pubkeys[0]);
+
+        for (std::size_t enote_index{1}; enote_index < params.num_enotes; ++enote_index)
+        {
+            m_enotes[enote_index].gen(m_view_tag_bytes);
+            m_enote_pubkeys[enote_index] = rct::pkGen();
+        }
+
+        return true;
+    }
+
+    bool test()
+    {
+        rct::key sender_receiver_secret_dummy;
+        rct::key nominal_recipient_spendkey;
+        crypto::key_derivation derivation;
+        bool found_owned{false};
+
+        const auto scan_start = std::chrono::steady_clock::now();
+        for (std::size_t enote_index{0}; enote_index < m_enotes.size(); ++enote_index)
+        {
+            crypto::generate_key_derivation(rct::rct2pk(m_enote_pubkeys[enote_index]), m_recipient_view_privkey, derivation);
+
+            if (!mock_tx::try_get_seraphis_nominal_spend_key_wide(derivation,
+                    0,
+                    m_enotes[enote_index].m_onetime_address,
+                    m_enotes[enote_index].m_view_tag,
+                    m_view_tag_bytes,
+                    sender_receiver_secret_dummy,  //outparam not used
+                    nominal_recipient_spendkey))
+                continue;
+
+            if (enote_index == 0)
+                found_owned = nominal_recipient_spendkey == m_recipient_spend_key;
+            else
+                ++m_num_false_positives;
+        }
+        m_scan_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - scan_start).count();
+        ++m_num_scans;
+
+        memwipe(&sender_receiver_secret_dummy, sizeof(rct::key));
+        memwipe(&derivation, sizeof(derivation));
+
+        return found_owned;
+    }
+
+private:
+    std::size_t m_view_tag_bytes;
+
+    rct::key m_recipient_spend_key;
+    crypto::secret_key m_recipient_view_privkey;
 
-unsigned char make_seraphis_view_tag_siphash(const crypto::key_derivation &sender_receiver_DH_derivation,
-    const std::size_t output_index)
+    std::vector<mock_tx::MockENoteSpV2> m_enotes;
+    std::vector<rct::key> m_enote_pubkeys;
+
+    std::size_t m_num_false_positives{0};
+    std::size_t m_num_scans{0};
+    std::uint64_t m_scan_ns{0};
+};
+
+
+/// seraphis view key scanning over many enotes at once
+struct ParamsShuttleViewScanBatch final : public ParamsShuttle
 {
-    static std::string salt{config::HASH_KEY_SERAPHIS_VIEW_TAG};
+    std::size_t num_enotes{1024};
+    /// every 'hit_interval'-th enote is owned by the scanner (0 = none owned)
+    std::size_t hit_interval{16};
+    /// max number of threads (0 = threadpool max concurrency; 1 = serial)
+    std::size_t num_threads{1};
+};
 
-    // tag_t = H("domain-sep", derivation, t)
-    // TODO: consider using a simpler/cheaper hash function for view tags
-    rct::key view_tag_scalar;
+class test_view_scan_sp_batch
+{
+public:
+    static const size_t loop_count = 20;
 
-    domain_separate_derivation_hash_siphash(salt,
-        sender_receiver_DH_derivation,
-        output_index,
-        view_tag_scalar);
+    ~test_view_scan_sp_batch()
+    {
+        // report scan throughput
+        if (m_scan_ns == 0 || m_num_scans == 0)
+            return;
+
+        const std::size_t num_cores{
+                m_num_threads == 0
+                ? std::max<std::size_t>(tools::threadpool::getInstance().get_max_concurrency(), 1)
+                : m_num_threads
+            };
+        const double enotes_per_sec{static_cast<double>(m_num_scans * m_records.size()) * 1e9 / m_scan_ns};
+
+        std::cout << "  enotes: " << m_records.size() << ", hits: " << m_num_expected_hits
+            << ", threads: " << num_cores
+            << ", enotes/sec/core: " << static_cast<std::size_t>(enotes_per_sec / num_cores) << '\n';
+    }
 
-    return static_cast<unsigned char>(view_tag_scalar.bytes[0]);
-}
+    bool init(const ParamsShuttleViewScanBatch &params)
+    {
+        m_num_threads = params.num_threads;
+
+        // user address
+        rct::key recipient_DH_base{rct::pkGen()};
+        crypto::secret_key recipient_view_privkey{rct::rct2sk(rct::skGen())};
+        crypto::secret_key recipient_spendbase_privkey{rct::rct2sk(rct::skGen())};
+        rct::key recipient_view_key;
+        rct::key recipient_spend_key;
+
+        rct::scalarmultKey(recipient_view_key, recipient_DH_base, rct::sk2rct(recipient_view_privkey));
+        mock_tx::make_seraphis_spendkey(recipient_view_privkey, recipient_spendbase_privkey, recipient_spend_key);
 
-unsigned char make_seraphis_view_tag_siphash(const crypto::secret_key &privkey,
-    const rct::key &DH_key,
-    const std::size_t output_index,
-    hw::device &hwdev)
+        // make enotes: owned ones are addressed to the user, the rest to random addresses
+        m_records.resize(params.num_enotes);
+        m_num_expected_hits = 0;
+
+        for (std::size_t enote_index{0}; enote_index < params.num_enotes; ++enote_index)
+        {
+            const bool owned{params.hit_interval > 0 && enote_index % params.hit_interval == 0};
+            mock_tx::MockENoteSpV1 enote;
+            rct::key enote_pubkey;
+
+            enote.make(rct::rct2sk(rct::skGen()),
+                owned ? recipient_DH_base : rct::pkGen(),
+                owned ? recipient_view_key : rct::pkGen(),
+                owned ? recipient_spend_key : rct::pkGen(),
+                0, // no amount
+                enote_index % 16,
+                false,
+                enote_pubkey);
+
+            m_records[enote_index].m_enote_pubkey = enote_pubkey;
+            m_records[enote_index].m_onetime_address = enote.m_onetime_address;
+            m_records[enote_index].m_view_tag = enote.m_view_tag;
+            m_records[enote_index].m_output_index = enote_index % 16;
+
+            if (owned)
+                ++m_num_expected_hits;
+        }
+
+        m_scanner.reset(new mock_tx::SeraphisEnoteScanner{recipient_view_privkey});
+        m_recipient_spend_key = recipient_spend_key;
+
+        return true;
+    }
+
+    bool test()
+    {
+        std::vector<mock_tx::SpEnoteScanHit> hits;
+
+        const auto scan_start = std::chrono::steady_clock::now();
+        m_scanner->scan(m_records, hits, m_num_threads);
+        m_scan_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - scan_start).count();
+        ++m_num_scans;
+
+        // random enotes can pass the view tag check (~1/256), but only owned enotes recover the user's spend key
+        std::size_t num_owned_hits{0};
+        for (const mock_tx::SpEnoteScanHit &hit : hits)
+        {
+            if (hit.m_nominal_spend_key == m_recipient_spend_key)
+                ++num_owned_hits;
+        }
+
+        return num_owned_hits == m_num_expected_hits;
+    }
+
+private:
+    std::size_t m_num_threads;
+
+    rct::key m_recipient_spend_key;
+    std::unique_ptr<mock_tx::SeraphisEnoteScanner> m_scanner;
+
+    std::vector<mock_tx::SpEnoteScanRecord> m_records;
+    std::size_t m_num_expected_hits;
+
+    std::size_t m_num_scans{0};
+    std::uint64_t m_scan_ns{0};
+};
+
+
+/// amount recovery for owned seraphis enotes (after their view tags and nominal spend keys matched)
+struct ParamsShuttleAmountRecovery final : public ParamsShuttle
 {
-    // privkey * DH_key
-    crypto::key_derivation derivation;
-    hwdev.generate_key_derivation(rct::rct2pk(DH_key), privkey, derivation);
+    std::size_t num_enotes{1024};
+    /// check the recomputed amount commitments in one multiexp (else one enote at a time)
+    bool batched{true};
+};
 
-    // tag_t = H("domain-sep", derivation, t)
-    unsigned char view_tag{make_seraphis_view_tag_siphash(derivation, output_index)};
+class test_amount_recovery_sp
+{
+public:
+    static const size_t loop_count = 10;
+
+    bool init(const ParamsShuttleAmountRecovery &params)
+    {
+        m_batched = params.batched;
 
-    memwipe(&derivation, sizeof(derivation));
+        m_records.resize(params.num_enotes);
+        m_amounts.resize(params.num_enotes);
+        crypto::secret_key amount_mask;
 
-    return view_tag;
-}
+        for (std::size_t enote_index{0}; enote_index < params.num_enotes; ++enote_index)
+        {
+            mock_tx::SpAmountRecoveryRecord &record = m_records[enote_index];
+            record.m_sender_receiver_secret = rct::rct2sk(rct::skGen());
+            record.m_baked_key = rct::zero();
+            m_amounts[enote_index] = crypto::rand_idx<rct::xmr_amount>(static_cast<rct::xmr_amount>(-1));
+
+            mock_tx::make_seraphis_amount_commitment_mask(record.m_sender_receiver_secret,
+                record.m_baked_key,
+                amount_mask);
+            record.m_amount_commitment = rct::commit(m_amounts[enote_index], rct::sk2rct(amount_mask));
+            record.m_encoded_amount = mock_tx::enc_dec_seraphis_amount(record.m_sender_receiver_secret,
+                record.m_baked_key,
+                m_amounts[enote_index]);
+        }
 
-bool try_get_seraphis_nominal_spend_key_siphash(const crypto::key_derivation &sender_receiver_DH_derivation,
-    const std::size_t output_index,
-    const rct::key &onetime_address,
-    const unsigned char view_tag,
-    rct::key &sender_receiver_secret_out,
-    rct::key &nominal_spend_key_out)
+        return true;
+    }
+
+    bool test()
+    {
+        if (m_batched)
+        {
+            std::vector<rct::xmr_amount> amounts;
+            std::vector<bool> recovered;
+            mock_tx::try_get_seraphis_amounts(m_records, amounts, recovered);
+
+            return amounts == m_amounts;
+        }
+
+        rct::xmr_amount amount;
+        for (std::size_t enote_index{0}; enote_index < m_records.size(); ++enote_index)
+        {
+            const mock_tx::SpAmountRecoveryRecord &record = m_records[enote_index];
+            if (!mock_tx::try_get_seraphis_amount(record.m_sender_receiver_secret,
+                    record.m_baked_key,
+                    record.m_amount_commitment,
+                    record.m_encoded_amount,
+                    amount) ||
+                amount != m_amounts[enote_index])
+                return false;
+        }
+
+        return true;
+    }
+
+private:
+    bool m_batched;
+    std::vector<mock_tx::SpAmountRecoveryRecord> m_records;
+    std::vector<rct::xmr_amount> m_amounts;
+};
+
+
+/// sender-side output construction for batched payouts to a fixed set of recipients
+struct ParamsShuttlePayoutOutputs final : public ParamsShuttle
 {
-    // tag'_t = H(q_t)
-    unsigned char nominal_view_tag{make_seraphis_view_tag_siphash(sender_receiver_DH_derivation, output_index)};
-
-    // check that recomputed tag matches original tag; short-circuit on failure
-    if (nominal_view_tag != view_tag)
-        return false;
-
-    // q_t
-    // note: computing this after view tag check is an optimization
-    mock_tx::make_seraphis_sender_receiver_secret(sender_receiver_DH_derivation,
-        output_index,
-        sender_receiver_secret_out);
-
-    // K'^s_t = Ko_t - H(q_t) X
-    crypto::secret_key k_a_extender;
-    mock_tx::make_seraphis_sender_address_extension(rct::rct2sk(sender_receiver_secret_out), k_a_extender);  // H(q_t)
-    sc_mul(&k_a_extender, sp::MINUS_ONE.bytes, &k_a_extender);  // -H(q_t)
-    nominal_spend_key_out = onetime_address;  // Ko_t
-    mock_tx::extend_seraphis_spendkey(k_a_extender, nominal_spend_key_out); // (-H(q_t)) X + Ko_t
-
-    return true;
-}
+    std::size_t num_recipients{4};
+    std::size_t num_outputs{16};
+    /// use the recipients' precomputed tables (made once, as a wallet would keep them), else plain scalarmults
+    bool recipient_precomp{true};
+};
+
+class test_payout_outputs_sp
+{
+public:
+    static const size_t loop_count = 100;
+
+    bool init(const ParamsShuttlePayoutOutputs &params)
+    {
+        if (params.num_recipients == 0 || params.num_outputs == 0)
+            return false;
+
+        m_recipient_precomp = params.recipient_precomp;
+
+        // each recipient is paid every num_recipients outputs
+        m_destinations = mock_tx::gen_mock_sp_destinations_v1(std::vector<rct::xmr_amount>(params.num_outputs, 1));
+
+        for (std::size_t dest_index{params.num_recipients}; dest_index < m_destinations.size(); ++dest_index)
+        {
+            const mock_tx::MockDestinationSpV1 &recipient{m_destinations[dest_index % params.num_recipients]};
+            m_destinations[dest_index].m_recipient_DHkey = recipient.m_recipient_DHkey;
+            m_destinations[dest_index].m_recipient_viewkey = recipient.m_recipient_viewkey;
+            m_destinations[dest_index].m_recipient_spendkey = recipient.m_recipient_spendkey;
+        }
+
+        // the tables are made outside the timed loop
+        if (m_recipient_precomp)
+        {
+            for (const mock_tx::MockDestinationSpV1 &destination : m_destinations)
+                m_recipient_precomp_cache.get_or_make(destination.m_recipient_DHkey, destination.m_recipient_viewkey);
+        }
+
+        return true;
+    }
+
+    bool test()
+    {
+        std::vector<mock_tx::MockENoteSpV1> outputs;
+        std::vector<rct::xmr_amount> output_amounts;
+        std::vector<crypto::secret_key> output_amount_commitment_blinding_factors;
+        mock_tx::MockSupplementSpV1 tx_supplement;
+
+        if (m_recipient_precomp)
+        {
+            mock_tx::make_v1_tx_outputs_sp_v1(m_destinations,
+                m_recipient_precomp_cache,
+                outputs,
+                output_amounts,
+                output_amount_commitment_blinding_factors,
+                tx_supplement);
+        }
+        else
+        {
+            mock_tx::make_v1_tx_outputs_sp_v1(m_destinations,
+                outputs,
+                output_amounts,
+                output_amount_commitment_blinding_factors,
+                tx_supplement);
+        }
+
+        return outputs.size() == m_destinations.size();
+    }
+
+private:
+    bool m_recipient_precomp;
+    std::vector<mock_tx::MockDestinationSpV1> m_destinations;
+    mock_tx::MockRecipientPrecompCacheSpV1 m_recipient_precomp_cache;
+};
+
+/// seraphis view key scanning of the same enotes for many accounts (light-wallet server)
+struct ParamsShuttleViewScanMultiAccount final : public ParamsShuttle
+{
+    std::size_t num_accounts{16};
+    std::size_t num_enotes{64};
+    /// scan all accounts at once with shared per-enote tables (else scan each account separately)
+    bool shared_precompute{true};
+    /// max number of threads (0 = threadpool max concurrency; 1 = serial)
+    std::size_t num_threads{1};
+};
+
+class test_view_scan_sp_multi_account
+{
+public:
+    static const size_t loop_count = 5;
+
+    ~test_view_scan_sp_multi_account()
+    {
+        // report scan throughput
+        if (m_scan_ns == 0 || m_num_scans == 0)
+            return;
+
+        const double account_enotes{static_cast<double>(m_num_scans * m_view_privkeys.size() * m_records.size())};
+
+        std::cout << "  accounts: " << m_view_privkeys.size() << ", enotes: " << m_records.size()
+            << (m_shared_precompute ? ", shared precompute" : ", per-account scans")
+            << ", account-enotes/sec: " << static_cast<std::size_t>(account_enotes * 1e9 / m_scan_ns) << '\n';
+    }
+
+    bool init(const ParamsShuttleViewScanMultiAccount &params)
+    {
+        m_shared_precompute = params.shared_precompute;
+        m_num_threads = params.num_threads;
+
+        if (params.num_accounts == 0)
+            return false;
+
+        // accounts
+        std::vector<rct::key> recipient_DH_bases(params.num_accounts);
+        std::vector<rct::key> recipient_view_keys(params.num_accounts);
+        m_view_privkeys.resize(params.num_accounts);
+        m_spend_keys.resize(params.num_accounts);
+
+        for (std::size_t account_index{0}; account_index < params.num_accounts; ++account_index)
+        {
+            recipient_DH_bases[account_index] = rct::pkGen();
+            m_view_privkeys[account_index] = rct::rct2sk(rct::skGen());
+            rct::scalarmultKey(recipient_view_keys[account_index],
+                recipient_DH_bases[account_index],
+                rct::sk2rct(m_view_privkeys[account_index]));
+            mock_tx::make_seraphis_spendkey(m_view_privkeys[account_index],
+                rct::rct2sk(rct::skGen()),
+                m_spend_keys[account_index]);
+        }
+
+        // enotes: each one is owned by one of the accounts (round robin)
+        m_records.resize(params.num_enotes);
+
+        for (std::size_t enote_index{0}; enote_index < params.num_enotes; ++enote_index)
+        {
+            const std::size_t owner{enote_index % params.num_accounts};
+            mock_tx::MockENoteSpV1 enote;
+
+            enote.make(rct::rct2sk(rct::skGen()),
+                recipient_DH_bases[owner],
+                recipient_view_keys[owner],
+                m_spend_keys[owner],
+                0, // no amount
+                enote_index % 16,
+                false,
+                m_records[enote_index].m_enote_pubkey);
+
+            m_records[enote_index].m_onetime_address = enote.m_onetime_address;
+            m_records[enote_index].m_view_tag = enote.m_view_tag;
+            m_records[enote_index].m_output_index = enote_index % 16;
+        }
+
+        return true;
+    }
+
+    bool test()
+    {
+        // count hits that recover the owner's spend key (other accounts can pass the view tag check by chance)
+        std::size_t num_owned_hits{0};
+
+        const auto scan_start = std::chrono::steady_clock::now();
+        if (m_shared_precompute)
+        {
+            std::vector<mock_tx::SpMultiAccountScanHit> hits;
+            mock_tx::scan_enotes_sp_multi_account(m_view_privkeys, m_records, m_num_threads, hits);
+
+            for (const mock_tx::SpMultiAccountScanHit &hit : hits)
+            {
+                if (hit.m_nominal_spend_key == m_spend_keys[hit.m_account_index])
+                    ++num_owned_hits;
+            }
+        }
+        else
+        {
+            std::vector<mock_tx::SpEnoteScanHit> hits;
+
+            for (std::size_t account_index{0}; account_index < m_view_privkeys.size(); ++account_index)
+            {
+                mock_tx::scan_enotes_sp_parallel(m_view_privkeys[account_index],
+                    m_records,
+                    mock_tx::DEFAULT_SCAN_CHUNK_SIZE,
+                    m_num_threads,
+                    hits);
+
+                for (const mock_tx::SpEnoteScanHit &hit : hits)
+                {
+                    if (hit.m_nominal_spend_key == m_spend_keys[account_index])
+                        ++num_owned_hits;
+                }
+            }
+        }
+        m_scan_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - scan_start).count();
+        ++m_num_scans;
+
+        return num_owned_hits == m_records.size();
+    }
+
+private:
+    bool m_shared_precompute;
+    std::size_t m_num_threads;
+
+    std::vector<crypto::secret_key> m_view_privkeys;
+    std::vector<rct::key> m_spend_keys;
+    std::vector<mock_tx::SpEnoteScanRecord> m_records;
+
+    std::size_t m_num_scans{0};
+    std::uint64_t m_scan_ns{0};
+};
+
+/// parallel view key scanning over many enotes (per-enote scanning, chunks balanced with work stealing)
+struct ParamsShuttleViewScanParallel final : public ParamsShuttle
+{
+    /// scan seraphis enotes (else cryptonote enotes)
+    bool seraphis{false};
+    std::size_t num_enotes{4096};
+    /// every 'hit_interval'-th enote is owned by the scanner (0 = none owned)
+    std::size_t hit_interval{16};
+    std::size_t chunk_size{mock_tx::DEFAULT_SCAN_CHUNK_SIZE};
+    /// max number of threads (0 = threadpool max concurrency; 1 = serial)
+    std::size_t num_threads{1};
+};
+
+class test_view_scan_parallel
+{
+public:
+    static const size_t loop_count = 10;
+
+    ~test_view_scan_parallel()
+    {
+        // report scan throughput, and scaling relative to the last single-threaded run of the same protocol
+        if (m_scan_ns == 0 || m_num_scans == 0)
+            return;
+
+        const std::size_t num_enotes{m_seraphis ? m_sp_records.size() : m_cn_records.size()};
+        const double enotes_per_sec{static_cast<double>(m_num_scans * num_enotes) * 1e9 / m_scan_ns};
+        double &single_thread_enotes_per_sec{single_thread_enotes_per_sec_ref(m_seraphis)};
+
+        if (m_num_threads == 1)
+            single_thread_enotes_per_sec = enotes_per_sec;
+
+        std::cout << "  " << (m_seraphis ? "seraphis" : "cryptonote") << " enotes: " << num_enotes
+            << ", threads: " << m_num_threads
+            << " (threadpool max " << tools::threadpool::getInstance().get_max_concurrency() << ")"
+            << ", enotes/sec: " << static_cast<std::size_t>(enotes_per_sec);
+
+        if (single_thread_enotes_per_sec > 0)
+            std::cout << ", speedup vs 1 thread: " << enotes_per_sec / single_thread_enotes_per_sec;
+
+        std::cout << '\n';
+    }
+
+    bool init(const ParamsShuttleViewScanParallel &params)
+    {
+        m_seraphis = params.seraphis;
+        m_chunk_size = params.chunk_size;
+        m_num_threads = params.num_threads;
+        m_num_expected_hits = 0;
+
+        m_view_privkey = rct::rct2sk(rct::skGen());
+
+        if (m_seraphis)
+        {
+            // user address
+            rct::key recipient_DH_base{rct::pkGen()};
+            crypto::secret_key recipient_spendbase_privkey{rct::rct2sk(rct::skGen())};
+            rct::key recipient_view_key;
+
+            rct::scalarmultKey(recipient_view_key, recipient_DH_base, rct::sk2rct(m_view_privkey));
+            mock_tx::make_seraphis_spendkey(m_view_privkey, recipient_spendbase_privkey, m_sp_spend_key);
+
+            // enotes: owned ones are addressed to the user, the rest to random addresses
+            m_sp_records.resize(params.num_enotes);
+
+            for (std::size_t enote_index{0}; enote_index < params.num_enotes; ++enote_index)
+            {
+                const bool owned{params.hit_interval > 0 && enote_index % params.hit_interval == 0};
+                mock_tx::MockENoteSpV1 enote;
+                rct::key enote_pubkey;
+
+                enote.make(rct::rct2sk(rct::skGen()),
+                    owned ? recipient_DH_base : rct::pkGen(),
+                    owned ? recipient_view_key : rct::pkGen(),
+                    owned ? m_sp_spend_key : rct::pkGen(),
+                    0, // no amount
+                    enote_index % 16,
+                    false,
+                    enote_pubkey);
+
+                m_sp_records[enote_index].m_enote_pubkey = enote_pubkey;
+                m_sp_records[enote_index].m_onetime_address = enote.m_onetime_address;
+                m_sp_records[enote_index].m_view_tag = enote.m_view_tag;
+                m_sp_records[enote_index].m_output_index = enote_index % 16;
+
+                if (owned)
+                    ++m_num_expected_hits;
+            }
+        }
+        else
+        {
+            m_cn_spend_key = rct::rct2pk(rct::pkGen());
+            m_cn_records.resize(params.num_enotes);
+
+            for (std::size_t enote_index{0}; enote_index < params.num_enotes; ++enote_index)
+            {
+                const bool owned{params.hit_interval > 0 && enote_index % params.hit_interval == 0};
+                mock_tx::CnEnoteScanRecord &record{m_cn_records[enote_index]};
+
+                record.m_tx_pubkey = rct::rct2pk(rct::pkGen());
+                record.m_output_index = enote_index % 16;
+
+                if (owned)
+                {
+                    // Ko_t = H(k^v R, t) G + K^s
+                    crypto::key_derivation derivation;
+                    crypto::generate_key_derivation(record.m_tx_pubkey, m_view_privkey, derivation);
+                    crypto::derive_public_key(derivation, record.m_output_index, m_cn_spend_key, record.m_onetime_address);
+                    ++m_num_expected_hits;
+                }
+                else
+                    record.m_onetime_address = rct::rct2pk(rct::pkGen());
+            }
+        }
+
+        return true;
+    }
+
+    bool test()
+    {
+        std::size_t num_owned_hits{0};
+
+        const auto scan_start = std::chrono::steady_clock::now();
+        if (m_seraphis)
+        {
+            std::vector<mock_tx::SpEnoteScanHit> hits;
+            mock_tx::scan_enotes_sp_parallel(m_view_privkey, m_sp_records, m_chunk_size, m_num_threads, hits);
+
+            // random enotes can pass the view tag check (~1/256), but only owned enotes recover the user's spend key
+            for (const mock_tx::SpEnoteScanHit &hit : hits)
+            {
+                if (hit.m_nominal_spend_key == m_sp_spend_key)
+                    ++num_owned_hits;
+            }
+        }
+        else
+        {
+            std::vector<mock_tx::CnEnoteScanHit> hits;
+            mock_tx::scan_enotes_cn_parallel(m_view_privkey, m_cn_spend_key, m_cn_records, m_chunk_size, m_num_threads, hits);
+            num_owned_hits = hits.size();
+        }
+        m_scan_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - scan_start).count();
+        ++m_num_scans;
+
+        return num_owned_hits == m_num_expected_hits;
+    }
+
+private:
+    static double& single_thread_enotes_per_sec_ref(const bool seraphis)
+    {
+        static double single_thread_enotes_per_sec[2]{0.0, 0.0};
+        return single_thread_enotes_per_sec[seraphis ? 1 : 0];
+    }
+
+    bool m_seraphis;
+    std::size_t m_chunk_size;
+    std::size_t m_num_threads;
+
+    crypto::secret_key m_view_privkey;
+    crypto::public_key m_cn_spend_key;
+    rct::key m_sp_spend_key;
+
+    std::vector<mock_tx::CnEnoteScanRecord> m_cn_records;
+    std::vector<mock_tx::SpEnoteScanRecord> m_sp_records;
+    std::size_t m_num_expected_hits;
+
+    std::size_t m_num_scans{0};
+    std::uint64_t m_scan_ns{0};
+};
+
+
+/// cryptonote view key scanning over a memory-mapped enote stream
+struct ParamsShuttleViewScanEnoteStream final : public ParamsShuttle
+{
+    std::size_t num_enotes{16384};
+    /// consecutive enotes sharing a tx pubkey
+    std::size_t outputs_per_tx{2};
+    /// every 'hit_interval'-th tx pays the scanner (0 = none owned)
+    std::size_t hit_interval{16};
+    /// scan the mapped columns in place (else copy them into scan records first, as a deserializing backend would)
+    bool zero_copy{true};
+    /// max number of threads (0 = threadpool max concurrency; 1 = serial)
+    std::size_t num_threads{1};
+};
+
+class test_view_scan_enote_stream
+{
+public:
+    static const size_t loop_count = 10;
+
+    ~test_view_scan_enote_stream()
+    {
+        m_reader.reset();
+        if (!m_dir.empty())
+        {
+            boost::system::error_code ec;
+            boost::filesystem::remove_all(m_dir, ec);
+        }
+    }
+
+    bool init(const ParamsShuttleViewScanEnoteStream &params)
+    {
+        if (params.outputs_per_tx == 0)
+            return false;
+
+        m_zero_copy = params.zero_copy;
+        m_num_threads = params.num_threads;
+        m_num_expected_hits = 0;
+
+        m_view_privkey = rct::rct2sk(rct::skGen());
+        m_spend_key = rct::rct2pk(rct::pkGen());
+
+        // write the enotes as a stream, one tx per block
+        m_dir = (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("enote_stream_%%%%-%%%%-%%%%")).string();
+        cryptonote::enote_stream_writer writer;
+        if (!writer.open(m_dir))
+            return false;
+
+        std::vector<cryptonote::enote_stream_enote> enotes;
+        for (std::size_t tx_index{0}; tx_index * params.outputs_per_tx < params.num_enotes; ++tx_index)
+        {
+            const bool owned{params.hit_interval > 0 && tx_index % params.hit_interval == 0};
+            const crypto::public_key tx_pubkey{rct::rct2pk(rct::pkGen())};
+            crypto::key_derivation derivation;
+            crypto::generate_key_derivation(tx_pubkey, m_view_privkey, derivation);
+
+            enotes.clear();
+            for (std::size_t output_index{0};
+                output_index < params.outputs_per_tx && tx_index * params.outputs_per_tx + output_index < params.num_enotes;
+                ++output_index)
+            {
+                cryptonote::enote_stream_enote enote{};
+                enote.tx_pubkey = tx_pubkey;
+                enote.additional_pubkey = crypto::null_pkey;
+                enote.output_index = output_index;
+
+                // the first output of an owned tx pays the user: Ko_t = H(k^v R, t) G + K^s
+                if (owned && output_index == 0)
+                {
+                    crypto::derive_public_key(derivation, output_index, m_spend_key, enote.onetime_address);
+                    ++m_num_expected_hits;
+                }
+                else
+                    enote.onetime_address = rct::rct2pk(rct::pkGen());
+
+                enotes.emplace_back(enote);
+            }
+            writer.append_block(rct::rct2hash(rct::skGen()), enotes);
+        }
+        if (!writer.commit())
+            return false;
+
+        m_reader.reset(new cryptonote::enote_stream_reader());
+        return m_reader->open(m_dir) && m_reader->num_enotes() == params.num_enotes;
+    }
+
+    bool test()
+    {
+        std::vector<mock_tx::CnEnoteScanHit> hits;
+
+        if (m_zero_copy)
+        {
+            mock_tx::CnEnoteScanColumns columns;
+            columns.m_tx_pubkeys = m_reader->tx_pubkeys();
+            columns.m_additional_pubkeys = m_reader->additional_pubkeys();
+            columns.m_onetime_addresses = m_reader->onetime_addresses();
+            columns.m_output_indices = m_reader->output_indices();
+            columns.m_num_enotes = m_reader->num_enotes();
+
+            mock_tx::scan_enotes_cn_parallel(m_view_privkey,
+                m_spend_key,
+                columns,
+                mock_tx::DEFAULT_SCAN_CHUNK_SIZE,
+                m_num_threads,
+                hits);
+        }
+        else
+        {
+            std::vector<mock_tx::CnEnoteScanRecord> records(m_reader->num_enotes());
+            for (std::size_t enote_index{0}; enote_index < records.size(); ++enote_index)
+            {
+                records[enote_index].m_tx_pubkey = m_reader->tx_pubkeys()[enote_index];
+                records[enote_index].m_onetime_address = m_reader->onetime_addresses()[enote_index];
+                records[enote_index].m_output_index = m_reader->output_indices()[enote_index];
+            }
+
+            mock_tx::scan_enotes_cn_parallel(m_view_privkey,
+                m_spend_key,
+                records,
+                mock_tx::DEFAULT_SCAN_CHUNK_SIZE,
+                m_num_threads,
+                hits);
+        }
+
+        return hits.size() == m_num_expected_hits;
+    }
+
+private:
+    bool m_zero_copy;
+    std::size_t m_num_threads;
+
+    crypto::secret_key m_view_privkey;
+    crypto::public_key m_spend_key;
+
+    std::string m_dir;
+    std::unique_ptr<cryptonote::enote_stream_reader> m_reader;
+    std::size_t m_num_expected_hits;
+};
+
 
 // seraphis view-key scanning with siphash hsah function
 class test_view_scan_sp_siphash
@@ -332,13 +1086,9 @@ public:
             0, // no amount
             0, // 0 index
             false,
-            m_enote_pubkey);
+            m_enote_pubkey,
+            mock_tx::SpViewTagHash::SIPHASH);
 
-        // kludge: use siphash to make view tag
-        m_enote.m_view_tag = make_seraphis_view_tag_siphash(enote_privkey,
-            recipient_view_key,
-            0,
-            hw::get_device("default"));
         // want view tag test to fail
         ++m_enote.m_view_tag;
 
@@ -354,12 +1104,13 @@ public:
 
         rct::key nominal_recipient_spendkey;
 
-        if (!try_get_seraphis_nominal_spend_key_siphash(derivation,
+        if (!mock_tx::try_get_seraphis_nominal_spend_key(derivation,
             0,
             m_enote.m_onetime_address,
             m_enote.m_view_tag,
             sender_receiver_secret_dummy,  //outparam not used
-            nominal_recipient_spendkey))
+            nominal_recipient_spendkey,
+            mock_tx::SpViewTagHash::SIPHASH))
         {
             return true; //expect it to fail on view tag
         }
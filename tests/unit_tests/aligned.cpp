@@ -28,7 +28,9 @@
 
 #include "gtest/gtest.h"
 
+#include <vector>
 #include "common/aligned.h"
+#include "common/huge_page_allocator.h"
 
 TEST(aligned, large_null) { ASSERT_TRUE(aligned_malloc((size_t)-1, 1) == NULL); }
 TEST(aligned, free_null) { aligned_free(NULL); }
@@ -105,3 +107,41 @@ TEST(aligned, alignment)
 
   ASSERT_TRUE(aligned_malloc(1, ~0) == NULL);
 }
+
+TEST(aligned, huge_pages_bad_mode) { ASSERT_TRUE(aligned_set_huge_pages(3) == -1); ASSERT_TRUE(aligned_get_huge_pages() == ALIGNED_HUGE_PAGES_OFF); }
+
+TEST(aligned, huge_pages)
+{
+  static const int modes[] = {ALIGNED_HUGE_PAGES_THP, ALIGNED_HUGE_PAGES_HUGETLB};
+  for (const int mode: modes)
+  {
+    if (aligned_set_huge_pages(mode) != 0)
+      continue; // not supported on this platform
+
+    // large allocations, and growing them
+    unsigned char *ptr = (unsigned char*)aligned_malloc(ALIGNED_HUGE_PAGE_SIZE + 1, 4096);
+    ASSERT_TRUE(ptr && ((uintptr_t)ptr & 4095) == 0);
+    for (size_t n = 0; n < ALIGNED_HUGE_PAGE_SIZE + 1; ++n)
+      ptr[n] = n;
+    unsigned char *ptr2 = (unsigned char*)aligned_realloc(ptr, 3 * ALIGNED_HUGE_PAGE_SIZE, 4096);
+    ASSERT_TRUE(ptr2 && ((uintptr_t)ptr2 & 4095) == 0);
+    for (size_t n = 0; n < ALIGNED_HUGE_PAGE_SIZE + 1; ++n)
+    {
+      ASSERT_TRUE(ptr2[n] == (unsigned char)n);
+    }
+    ptr2[3 * ALIGNED_HUGE_PAGE_SIZE - 1] = 1;
+    aligned_free(ptr2);
+
+    // small allocations are unchanged
+    ptr = (unsigned char*)aligned_malloc(50, 256);
+    ASSERT_TRUE(ptr && ((uintptr_t)ptr & 255) == 0);
+    aligned_free(ptr);
+
+    // std containers
+    std::vector<uint64_t, tools::huge_page_allocator<uint64_t>> v(ALIGNED_HUGE_PAGE_SIZE / 4, 7);
+    v.push_back(8);
+    ASSERT_TRUE(v[0] == 7 && v.back() == 8);
+    aligned_advise_huge_pages(v.data(), v.capacity() * sizeof(uint64_t));
+  }
+  ASSERT_TRUE(aligned_set_huge_pages(ALIGNED_HUGE_PAGES_OFF) == 0);
+}
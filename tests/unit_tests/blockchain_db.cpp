@@ -30,6 +30,7 @@
 #include <boost/algorithm/string/predicate.hpp>
 #include <cstdio>
 #include <iostream>
+#include <map>
 #include <chrono>
 #include <thread>
 
@@ -341,4 +342,228 @@ TYPED_TEST(BlockchainDBTest, RetrieveBlockData)
   ASSERT_HASH_EQ(get_block_hash(this->m_blocks[1].first), hashes[1]);
 }
 
+TYPED_TEST(BlockchainDBTest, SplitTxBlobs)
+{
+  boost::filesystem::path tempPath = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+  std::string dirPath = tempPath.string();
+
+  this->set_prefix(dirPath);
+
+  ASSERT_NO_THROW(this->m_db->open(dirPath));
+  this->get_filenames();
+  this->init_hard_fork();
+
+  db_wtxn_guard guard(this->m_db);
+
+  ASSERT_NO_THROW(this->m_db->add_block(this->m_blocks[0], t_sizes[0], t_sizes[0], t_diffs[0], t_coins[0], this->m_txs[0]));
+  ASSERT_NO_THROW(this->m_db->add_block(this->m_blocks[1], t_sizes[1], t_sizes[1], t_diffs[1], t_coins[1], this->m_txs[1]));
+
+  // all stored txes in reverse, plus a missing hash and a repeat
+  std::vector<crypto::hash> hashes;
+  for (size_t n = 2; n-- > 0; )
+    for (auto& h : this->m_blocks[n].first.tx_hashes)
+      hashes.push_back(h);
+  hashes.push_back(crypto::null_hash);
+  hashes.push_back(hashes.front());
+  ASSERT_LT(2, hashes.size());
+
+  std::vector<split_tx_blob> batched, single;
+  ASSERT_NO_THROW(this->m_db->get_split_tx_blobs(epee::to_span(hashes), batched));
+  ASSERT_NO_THROW(this->m_db->BlockchainDB::get_split_tx_blobs(epee::to_span(hashes), single));
+  ASSERT_EQ(hashes.size(), batched.size());
+  ASSERT_EQ(hashes.size(), single.size());
+
+  for (size_t i = 0; i < hashes.size(); ++i)
+  {
+    ASSERT_EQ(single[i].found, batched[i].found);
+    ASSERT_EQ(hashes[i] != crypto::null_hash, batched[i].found);
+    if (!batched[i].found)
+      continue;
+    blobdata bd;
+    ASSERT_TRUE(this->m_db->get_tx_blob(hashes[i], bd));
+    ASSERT_EQ(bd, batched[i].pruned + batched[i].prunable);
+    ASSERT_EQ(single[i].pruned, batched[i].pruned);
+    ASSERT_EQ(single[i].prunable, batched[i].prunable);
+    ASSERT_EQ(single[i].has_prunable_hash, batched[i].has_prunable_hash);
+    ASSERT_HASH_EQ(single[i].prunable_hash, batched[i].prunable_hash);
+  }
+}
+
+TYPED_TEST(BlockchainDBTest, PopBlockUndoLog)
+{
+  boost::filesystem::path tempPath = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+  std::string dirPath = tempPath.string();
+
+  this->set_prefix(dirPath);
+
+  this->m_db->set_undo_log_depth(10);
+  ASSERT_NO_THROW(this->m_db->open(dirPath));
+  this->get_filenames();
+  this->init_hard_fork();
+
+  db_wtxn_guard guard(this->m_db);
+
+  ASSERT_NO_THROW(this->m_db->add_block(this->m_blocks[0], t_sizes[0], t_sizes[0], t_diffs[0], t_coins[0], this->m_txs[0]));
+  const uint64_t tx_count = this->m_db->get_tx_count();
+
+  // every tx of the block on top, and what it spent and created
+  const block &top = this->m_blocks[1].first;
+  std::vector<crypto::hash> tx_hashes = top.tx_hashes;
+  tx_hashes.push_back(get_transaction_hash(top.miner_tx));
+  std::vector<crypto::key_image> spent_keys;
+  std::map<uint64_t, uint64_t> num_outputs;
+  for (const auto &tx : this->m_txs[1])
+  {
+    for (const auto &in : tx.first.vin)
+      if (in.type() == typeid(txin_to_key))
+        spent_keys.push_back(boost::get<txin_to_key>(in).k_image);
+    for (const auto &out : tx.first.vout)
+      num_outputs[out.amount] = this->m_db->get_num_outputs(out.amount);
+  }
+  for (const auto &out : top.miner_tx.vout)
+    num_outputs[out.amount] = this->m_db->get_num_outputs(out.amount);
+
+  // popped with its undo log, then without one, then with one again, leaving the same db each time
+  std::vector<std::vector<uint64_t>> output_indices;
+  for (const uint64_t undo_log_depth : {10, 0, 10})
+  {
+    this->m_db->set_undo_log_depth(undo_log_depth);
+    ASSERT_NO_THROW(this->m_db->add_block(this->m_blocks[1], t_sizes[1], t_sizes[1], t_diffs[1], t_coins[1], this->m_txs[1]));
+    std::vector<std::vector<uint64_t>> indices;
+    ASSERT_NO_THROW(indices = this->m_db->get_tx_amount_output_indices(tx_count, tx_hashes.size()));
+    if (output_indices.empty())
+      output_indices = indices;
+    ASSERT_EQ(output_indices, indices);
+
+    block blk;
+    std::vector<transaction> txs;
+    ASSERT_NO_THROW(this->m_db->pop_block(blk, txs));
+    ASSERT_HASH_EQ(get_block_hash(top), get_block_hash(blk));
+    ASSERT_EQ(top.tx_hashes.size(), txs.size());
+
+    ASSERT_EQ(1, this->m_db->height());
+    ASSERT_EQ(tx_count, this->m_db->get_tx_count());
+    for (const crypto::hash &h : tx_hashes)
+      ASSERT_FALSE(this->m_db->tx_exists(h));
+    for (const crypto::key_image &k_image : spent_keys)
+      ASSERT_FALSE(this->m_db->has_key_image(k_image));
+    for (const auto &amount_count : num_outputs)
+      ASSERT_EQ(amount_count.second, this->m_db->get_num_outputs(amount_count.first));
+  }
+}
+
+TYPED_TEST(BlockchainDBTest, OpenReadOnlyWithoutUndoLog)
+{
+  boost::filesystem::path tempPath = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+  std::string dirPath = tempPath.string();
+
+  this->set_prefix(dirPath);
+
+  this->m_db->set_undo_log_depth(10);
+  ASSERT_NO_THROW(this->m_db->open(dirPath));
+  this->get_filenames();
+  this->init_hard_fork();
+  {
+    db_wtxn_guard guard(this->m_db);
+    ASSERT_NO_THROW(this->m_db->add_block(this->m_blocks[0], t_sizes[0], t_sizes[0], t_diffs[0], t_coins[0], this->m_txs[0]));
+    ASSERT_NO_THROW(this->m_db->add_block(this->m_blocks[1], t_sizes[1], t_sizes[1], t_diffs[1], t_coins[1], this->m_txs[1]));
+  }
+  ASSERT_NO_THROW(this->m_db->close());
+
+  // drop the undo log table, leaving the layout of a db written before it existed
+  MDB_env *env;
+  MDB_txn *txn;
+  MDB_dbi dbi;
+  ASSERT_EQ(0, mdb_env_create(&env));
+  ASSERT_EQ(0, mdb_env_set_maxdbs(env, 32));
+  ASSERT_EQ(0, mdb_env_open(env, dirPath.c_str(), 0, 0644));
+  ASSERT_EQ(0, mdb_txn_begin(env, NULL, 0, &txn));
+  ASSERT_EQ(0, mdb_dbi_open(txn, "block_undo", 0, &dbi));
+  ASSERT_EQ(0, mdb_drop(txn, dbi, 1));
+  ASSERT_EQ(0, mdb_txn_commit(txn));
+  mdb_env_close(env);
+
+  ASSERT_NO_THROW(this->m_db->open(dirPath, DBF_RDONLY));
+  ASSERT_EQ(2, this->m_db->height());
+  ASSERT_HASH_EQ(get_block_hash(this->m_blocks[1].first), this->m_db->top_block_hash());
+  ASSERT_NO_THROW(this->m_db->close());
+
+  // a read-write open creates it again, and the block added before has no record to pop with
+  ASSERT_NO_THROW(this->m_db->open(dirPath));
+  db_wtxn_guard guard(this->m_db);
+  block blk;
+  std::vector<transaction> txs;
+  ASSERT_NO_THROW(this->m_db->pop_block(blk, txs));
+  ASSERT_HASH_EQ(get_block_hash(this->m_blocks[1].first), get_block_hash(blk));
+  ASSERT_EQ(1, this->m_db->height());
+  for (const crypto::hash &h : this->m_blocks[1].first.tx_hashes)
+    ASSERT_FALSE(this->m_db->tx_exists(h));
+}
+
+TYPED_TEST(BlockchainDBTest, CumulativeRctOutputsRange)
+{
+  boost::filesystem::path tempPath = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+  std::string dirPath = tempPath.string();
+
+  this->set_prefix(dirPath);
+
+  ASSERT_NO_THROW(this->m_db->open(dirPath));
+  this->get_filenames();
+  this->init_hard_fork();
+
+  const auto expected = [this](uint64_t db_height) {
+    std::vector<uint64_t> heights;
+    for (uint64_t h = 0; h < db_height; ++h)
+      heights.push_back(h);
+    return this->m_db->get_block_cumulative_rct_outputs(heights);
+  };
+
+  {
+    db_wtxn_guard guard(this->m_db);
+    ASSERT_NO_THROW(this->m_db->add_block(this->m_blocks[0], t_sizes[0], t_sizes[0], t_diffs[0], t_coins[0], this->m_txs[0]));
+  }
+  ASSERT_EQ(expected(1), this->m_db->get_block_cumulative_rct_outputs_range(0, 0));
+
+  // added on top
+  {
+    db_wtxn_guard guard(this->m_db);
+    ASSERT_NO_THROW(this->m_db->add_block(this->m_blocks[1], t_sizes[1], t_sizes[1], t_diffs[1], t_coins[1], this->m_txs[1]));
+  }
+  const std::vector<uint64_t> two_blocks = expected(2);
+  ASSERT_EQ(two_blocks, this->m_db->get_block_cumulative_rct_outputs_range(0, 1));
+  ASSERT_EQ(std::vector<uint64_t>(1, two_blocks[1]), this->m_db->get_block_cumulative_rct_outputs_range(1, 1));
+
+  // a pop that is aborted leaves the chain as it was
+  {
+    db_wtxn_guard guard(this->m_db);
+    block blk;
+    std::vector<transaction> txs;
+    ASSERT_NO_THROW(this->m_db->pop_block(blk, txs));
+    ASSERT_THROW(this->m_db->get_block_cumulative_rct_outputs_range(0, 1), BLOCK_DNE);
+    ASSERT_EQ(std::vector<uint64_t>(1, two_blocks[0]), this->m_db->get_block_cumulative_rct_outputs_range(0, 0));
+    guard.abort();
+  }
+  ASSERT_EQ(two_blocks, this->m_db->get_block_cumulative_rct_outputs_range(0, 1));
+
+  // a pop that is committed
+  {
+    db_wtxn_guard guard(this->m_db);
+    block blk;
+    std::vector<transaction> txs;
+    ASSERT_NO_THROW(this->m_db->pop_block(blk, txs));
+  }
+  ASSERT_THROW(this->m_db->get_block_cumulative_rct_outputs_range(0, 1), BLOCK_DNE);
+  ASSERT_EQ(std::vector<uint64_t>(1, two_blocks[0]), this->m_db->get_block_cumulative_rct_outputs_range(0, 0));
+
+  // an add that is aborted
+  {
+    db_wtxn_guard guard(this->m_db);
+    ASSERT_NO_THROW(this->m_db->add_block(this->m_blocks[1], t_sizes[1], t_sizes[1], t_diffs[1], t_coins[1], this->m_txs[1]));
+    ASSERT_EQ(two_blocks, this->m_db->get_block_cumulative_rct_outputs_range(0, 1));
+    guard.abort();
+  }
+  ASSERT_THROW(this->m_db->get_block_cumulative_rct_outputs_range(0, 1), BLOCK_DNE);
+  ASSERT_EQ(std::vector<uint64_t>(1, two_blocks[0]), this->m_db->get_block_cumulative_rct_outputs_range(0, 0));
+}
+
 }  // anonymous namespace
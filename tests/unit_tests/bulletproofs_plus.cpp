@@ -77,6 +77,25 @@ TEST(bulletproofs_plus, valid_multi_random)
   }
 }
 
+TEST(bulletproofs_plus, find_invalid)
+{
+  std::vector<rct::BulletproofPlus> proofs;
+  for (int n = 0; n < 9; ++n)
+    proofs.push_back(bulletproof_plus_PROVE(crypto::rand<uint64_t>(), rct::skGen()));
+
+  std::vector<const rct::BulletproofPlus*> proof_pointers;
+  for (const rct::BulletproofPlus &proof: proofs)
+    proof_pointers.push_back(&proof);
+  ASSERT_TRUE(rct::bulletproof_plus_find_invalid(proof_pointers).empty());
+
+  // a bad scalar only shows up in the batch; a malformed proof is caught while building the batch
+  proofs[3].r1 = rct::skGen();
+  proofs[7].L.clear();
+  const std::vector<size_t> expected = {3, 7};
+  ASSERT_TRUE(rct::bulletproof_plus_find_invalid(proof_pointers) == expected);
+  ASSERT_FALSE(rct::bulletproof_plus_VERIFY(proof_pointers));
+}
+
 TEST(bulletproofs_plus, valid_aggregated)
 {
   static const size_t N_PROOFS = 8;
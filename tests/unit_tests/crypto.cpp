@@ -31,6 +31,7 @@
 #include <memory>
 #include <sstream>
 #include <string>
+#include <vector>
 
 #include "cryptonote_basic/cryptonote_basic_impl.h"
 #include "cryptonote_basic/merge_mining.h"
@@ -312,3 +313,63 @@ TEST(Crypto, tree_branch)
     }
   }
 }
+
+TEST(Crypto, derive_subaddress_public_keys)
+{
+  // non-canonical: y = 2^255 - 1 is not reduced mod p
+  crypto::public_key non_canonical;
+  memset(non_canonical.data, 0xff, sizeof(non_canonical.data));
+  non_canonical.data[31] = 0x7f;
+  ASSERT_FALSE(crypto::check_key(non_canonical));
+
+  // not a point at all
+  crypto::public_key off_curve;
+  do
+  {
+    off_curve = crypto::rand<crypto::public_key>();
+  } while (crypto::check_key(off_curve));
+
+  // group sizes around the 64 keys that share an inversion
+  for (const std::size_t num_keys : {0, 1, 63, 64, 65, 128, 130})
+  {
+    for (const bool with_invalid : {false, true})
+    {
+      std::vector<crypto::public_key> out_keys(num_keys);
+      std::vector<crypto::key_derivation> derivations(num_keys);
+      std::vector<std::size_t> output_indices(num_keys);
+      for (std::size_t i = 0; i < num_keys; ++i)
+      {
+        crypto::secret_key sec;
+        crypto::public_key tx_pub;
+        crypto::generate_keys(out_keys[i], sec);
+        crypto::generate_keys(tx_pub, sec);
+        ASSERT_TRUE(crypto::generate_key_derivation(tx_pub, sec, derivations[i]));
+        output_indices[i] = i % 7;
+      }
+      if (with_invalid)
+      {
+        for (const std::size_t i : {std::size_t(0), std::size_t(63), std::size_t(64), num_keys - 1})
+          if (i < num_keys)
+            out_keys[i] = i % 2 ? non_canonical : off_curve;
+      }
+
+      std::vector<crypto::public_key> derived_keys(num_keys);
+      std::unique_ptr<bool[]> valid(new bool[num_keys + 1]);
+      const bool all_valid = crypto::derive_subaddress_public_keys(out_keys.data(), derivations.data(), output_indices.data(),
+          num_keys, derived_keys.data(), valid.get());
+
+      bool expected_all_valid = true;
+      for (std::size_t i = 0; i < num_keys; ++i)
+      {
+        crypto::public_key derived_key;
+        const bool r = crypto::derive_subaddress_public_key(out_keys[i], derivations[i], output_indices[i], derived_key);
+        ASSERT_EQ(r, valid[i]) << num_keys << "/" << i;
+        if (r)
+          ASSERT_EQ(derived_key, derived_keys[i]) << num_keys << "/" << i;
+        expected_all_valid &= r;
+      }
+      ASSERT_EQ(expected_all_valid, all_valid);
+      ASSERT_EQ(!with_invalid || num_keys == 0, all_valid);
+    }
+  }
+}
@@ -32,6 +32,7 @@
 #include <boost/range/algorithm/equal.hpp>
 #include <boost/range/algorithm_ext/iota.hpp>
 #include <cstdint>
+#include <cstring>
 #include <gtest/gtest.h>
 #include <iterator>
 #include <string>
@@ -44,6 +45,7 @@
 
 #include "boost/archive/portable_binary_iarchive.hpp"
 #include "boost/archive/portable_binary_oarchive.hpp"
+#include "buffer_pool.h"
 #include "byte_slice.h"
 #include "byte_stream.h"
 #include "crypto/crypto.h"
@@ -1184,6 +1186,65 @@ TEST(ByteStream, Clear)
   EXPECT_EQ(stream.available(), stream.capacity() - stream.size());
 }
 
+TEST(BufferPool, Reuse)
+{
+  epee::buffer_pool::trim();
+  void* const first = epee::buffer_pool::allocate(100);
+  ASSERT_NE(nullptr, first);
+  EXPECT_LE(100u, epee::buffer_pool::capacity(first));
+  std::memset(first, 0xab, 100);
+
+  const epee::buffer_pool::stats before = epee::buffer_pool::get_stats();
+  epee::buffer_pool::release(first);
+  EXPECT_EQ(epee::buffer_pool::capacity(first), epee::buffer_pool::get_stats().cached_bytes);
+
+  // same size class, different size
+  void* const second = epee::buffer_pool::allocate(200);
+  EXPECT_EQ(first, second);
+
+  const epee::buffer_pool::stats after = epee::buffer_pool::get_stats();
+  EXPECT_EQ(before.system_allocations, after.system_allocations);
+  EXPECT_EQ(before.reused + 1, after.reused);
+  EXPECT_EQ(before.released + 1, after.released);
+  EXPECT_EQ(0u, after.cached_bytes);
+  epee::buffer_pool::release(second);
+}
+
+TEST(BufferPool, Resize)
+{
+  static constexpr const std::uint8_t source[] =
+    {0xde, 0xad, 0xbe, 0xef, 0xef};
+
+  void* ptr = epee::buffer_pool::resize(nullptr, sizeof(source));
+  ASSERT_NE(nullptr, ptr);
+  std::memcpy(ptr, source, sizeof(source));
+
+  // within the size class
+  void* const same = epee::buffer_pool::resize(ptr, epee::buffer_pool::capacity(ptr));
+  EXPECT_EQ(ptr, same);
+
+  // into the next size classes, and past the largest one
+  for (const std::size_t size : {std::size_t(16 * 1024), std::size_t(1024 * 1024), std::size_t(2 * 1024 * 1024), std::size_t(64)})
+  {
+    ptr = epee::buffer_pool::resize(ptr, size);
+    ASSERT_NE(nullptr, ptr);
+    EXPECT_LE(size, epee::buffer_pool::capacity(ptr));
+    EXPECT_TRUE(boost::range::equal(source, epee::span<const std::uint8_t>{static_cast<const std::uint8_t*>(ptr), sizeof(source)}));
+  }
+  epee::buffer_pool::release(ptr);
+  epee::buffer_pool::release(nullptr);
+}
+
+TEST(BufferPool, Allocator)
+{
+  std::vector<std::uint8_t, epee::pooled_allocator<std::uint8_t>> bytes;
+  bytes.resize(10000, 0x42);
+  bytes.resize(100000, 0x43);
+  EXPECT_EQ(0x42, bytes.front());
+  EXPECT_EQ(0x43, bytes.back());
+  EXPECT_LE(bytes.size(), epee::buffer_pool::capacity(bytes.data()));
+}
+
 TEST(ToHex, String)
 {
   EXPECT_TRUE(epee::to_hex::string(nullptr).empty());
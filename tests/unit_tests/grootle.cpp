@@ -29,7 +29,9 @@
 #include "crypto/crypto.h"
 #include "ringct/rctOps.h"
 #include "mock_tx/grootle.h"
+#include "mock_tx/grootle_generators.h"
 #include "mock_tx/mock_tx_utils.h"
+#include "mock_tx/seraphis_crypto_utils.h"
 
 #include "gtest/gtest.h"
 
@@ -42,6 +44,7 @@ using namespace rct;
 enum GrootleProofType
 {
     Concise,
+    ConciseSharedRefs,
     Plain
 };
 
@@ -57,11 +60,13 @@ bool test_plain_grootle(const std::size_t N_proofs,
     proofs.reserve(N_proofs);
     std::vector<const sp::GrootleProof *> proof_ptrs;
     proof_ptrs.reserve(N_proofs);
+    const std::vector<KeyMatrix> M_flat(M.begin(), M.end());
+    const KeyMatrix proof_offsets_flat{proof_offsets};
 
     for (std::size_t proof_i = 0; proof_i < N_proofs; proof_i++)
     {
         proofs.push_back(
-            sp::grootle_prove(M[proof_i],
+            sp::grootle_prove(M_flat[proof_i],
                 proof_i,
                 proof_offsets[proof_i],
                 proof_privkeys[proof_i],
@@ -76,7 +81,7 @@ bool test_plain_grootle(const std::size_t N_proofs,
     }
 
     // Verify batch
-    if (!sp::grootle_verify(proof_ptrs, M, proof_offsets, n, m, proof_messages, 4))
+    if (!sp::grootle_verify(proof_ptrs, M_flat, proof_offsets_flat, n, m, proof_messages, 4))
         return false;
 
     return true;
@@ -94,11 +99,13 @@ bool test_concise_grootle(const std::size_t N_proofs,
     proofs.reserve(N_proofs);
     std::vector<const sp::ConciseGrootleProof *> proof_ptrs;
     proof_ptrs.reserve(N_proofs);
+    const std::vector<KeyMatrix> M_flat(M.begin(), M.end());
+    const KeyMatrix proof_offsets_flat{proof_offsets};
 
     for (std::size_t proof_i = 0; proof_i < N_proofs; proof_i++)
     {
         proofs.push_back(
-            sp::concise_grootle_prove(M[proof_i],
+            sp::concise_grootle_prove(M_flat[proof_i],
                 proof_i,
                 proof_offsets[proof_i],
                 proof_privkeys[proof_i],
@@ -113,7 +120,11 @@ bool test_concise_grootle(const std::size_t N_proofs,
     }
 
     // Verify batch
-    if (!sp::concise_grootle_verify(proof_ptrs, M, proof_offsets, n, m, proof_messages))
+    if (!sp::concise_grootle_verify(proof_ptrs, M_flat, proof_offsets_flat, n, m, proof_messages))
+        return false;
+
+    // Verify batch (merging shared ref set keys)
+    if (!sp::concise_grootle_verify_shared_refs(proof_ptrs, M_flat, proof_offsets_flat, n, m, proof_messages))
         return false;
 
     return true;
@@ -179,10 +190,32 @@ bool test_grootle_proof(const std::size_t n,  // size base: N = n^m
             }
         }
 
+        // shared ref sets: every proof references the other proofs' signing keys and proof 0's decoys
+        // - odd proofs get one unique decoy, so their ref sets only partially overlap with the others
+        if (type == GrootleProofType::ConciseSharedRefs)
+        {
+            for (std::size_t proof_i = 0; proof_i < N_proofs; proof_i++)
+            {
+                for (std::size_t k = 0; k < N; k++)
+                {
+                    if (k < N_proofs)
+                        M[proof_i][k] = M[k][k];
+                    else
+                        M[proof_i][k] = M[0][k];
+                }
+
+                if (proof_i % 2 == 1 && N_proofs < N)
+                {
+                    for (std::size_t alpha = 0; alpha < num_keys; ++alpha)
+                        skpkGen(temp, M[proof_i][N - 1][alpha]);
+                }
+            }
+        }
+
         // make and test proofs
         try
         {
-            if (type == GrootleProofType::Concise)
+            if (type == GrootleProofType::Concise || type == GrootleProofType::ConciseSharedRefs)
             {
                 if (!test_concise_grootle(N_proofs, n, m, M, proof_offsets, proof_privkeys, proof_messages))
                     return false;
@@ -212,7 +245,11 @@ TEST(grootle, random)
     //const std::size_t num_ident_offsets   // number of commitment-to-zero offsets to set to identity element
     //const GrootleProofType type           // proof type to test
 
-    std::vector<GrootleProofType> types = {GrootleProofType::Concise, GrootleProofType::Plain};
+    std::vector<GrootleProofType> types = {
+            GrootleProofType::Concise,
+            GrootleProofType::ConciseSharedRefs,
+            GrootleProofType::Plain
+        };
 
     for (const auto type : types)
     {
@@ -236,3 +273,352 @@ TEST(grootle, random)
         EXPECT_TRUE(test_grootle_proof(3, 3, 3, 3, type));
     }
 }
+
+template <std::size_t n, std::size_t m>
+static void test_concise_grootle_fixed(const std::size_t N_proofs, const std::size_t num_keys)
+{
+    constexpr std::size_t N{sp::grootle_ref_set_size(n, m)};
+
+    // ref sets, signing keys (real signer at index 'proof_i'), offsets (offset 0 is the identity)
+    std::vector<KeyMatrix> M(N_proofs, KeyMatrix{N, num_keys});
+    std::vector<std::vector<crypto::secret_key>> proof_privkeys(N_proofs, std::vector<crypto::secret_key>(num_keys));
+    keyM proof_offsets(N_proofs, keyV(num_keys));
+    keyV proof_messages(N_proofs);
+    key temp, privkey, offset_privkey;
+
+    for (std::size_t proof_i = 0; proof_i < N_proofs; ++proof_i)
+    {
+        for (std::size_t k = 0; k < N; ++k)
+        {
+            for (std::size_t alpha = 0; alpha < num_keys; ++alpha)
+                skpkGen(temp, M[proof_i][k][alpha]);
+        }
+
+        proof_messages[proof_i] = skGen();
+        for (std::size_t alpha = 0; alpha < num_keys; ++alpha)
+        {
+            skpkGen(privkey, M[proof_i][proof_i][alpha]);
+
+            if (alpha == 0)
+            {
+                proof_offsets[proof_i][alpha] = identity();
+                proof_privkeys[proof_i][alpha] = rct::rct2sk(privkey);
+            }
+            else
+            {
+                skpkGen(offset_privkey, proof_offsets[proof_i][alpha]);
+                sc_sub(&(proof_privkeys[proof_i][alpha]), privkey.bytes, offset_privkey.bytes);
+            }
+        }
+    }
+
+    // fixed-size proofs
+    std::vector<sp::ConciseGrootleProofFixed<n, m>> proofs;
+    std::vector<const sp::ConciseGrootleProofFixed<n, m>*> proof_ptrs;
+    for (std::size_t proof_i = 0; proof_i < N_proofs; ++proof_i)
+    {
+        proofs.push_back(sp::concise_grootle_prove<n, m>(M[proof_i],
+            proof_i,
+            proof_offsets[proof_i],
+            proof_privkeys[proof_i],
+            proof_messages[proof_i]));
+    }
+    for (const sp::ConciseGrootleProofFixed<n, m> &proof : proofs)
+        proof_ptrs.push_back(&proof);
+
+    const KeyMatrix proof_offsets_flat{proof_offsets};
+    EXPECT_TRUE((sp::concise_grootle_verify<n, m>(proof_ptrs, M, proof_offsets_flat, proof_messages)));
+
+    // same proofs in the dynamic layout
+    std::vector<sp::ConciseGrootleProof> dynamic_proofs;
+    std::vector<const sp::ConciseGrootleProof*> dynamic_proof_ptrs;
+    for (const sp::ConciseGrootleProofFixed<n, m> &proof : proofs)
+        dynamic_proofs.push_back(sp::to_dynamic_concise_grootle_proof(proof));
+    for (const sp::ConciseGrootleProof &proof : dynamic_proofs)
+        dynamic_proof_ptrs.push_back(&proof);
+
+    EXPECT_TRUE(sp::concise_grootle_verify(dynamic_proof_ptrs, M, proof_offsets_flat, n, m, proof_messages));
+
+    // bad proof
+    proofs.back().f[m - 1][n - 2] = skGen();
+    EXPECT_FALSE((sp::concise_grootle_verify<n, m>(proof_ptrs, M, proof_offsets_flat, proof_messages)));
+}
+
+TEST(grootle, concise_fixed)
+{
+    test_concise_grootle_fixed<2, 7>(1, 1);
+    test_concise_grootle_fixed<2, 7>(3, 2);
+    test_concise_grootle_fixed<3, 5>(2, 2);
+    test_concise_grootle_fixed<8, 3>(2, 3);
+}
+
+TEST(grootle, baked_generators)
+{
+    // the generated tables must match the generator definitions
+    ge_p3 gen;
+    rct::key baked, derived;
+
+    for (std::size_t i = 0; i < sp::GROOTLE_MAX_MN; ++i)
+    {
+        sp::make_grootle_Hi_A_p3(i, gen);
+        ge_p3_tobytes(derived.bytes, &gen);
+        ge_p3_tobytes(baked.bytes, &sp::grootle_Hi_A_p3[i]);
+        EXPECT_TRUE(baked == derived);
+
+        sp::make_grootle_Hi_B_p3(i, gen);
+        ge_p3_tobytes(derived.bytes, &gen);
+        ge_p3_tobytes(baked.bytes, &sp::grootle_Hi_B_p3[i]);
+        EXPECT_TRUE(baked == derived);
+    }
+}
+
+TEST(grootle, one_of_many_coefficients)
+{
+    // the shared-prefix coefficients must match a per-member chain of convolutions
+    for (const std::size_t n : {2, 3, 5})
+    {
+        for (std::size_t m = 1; m <= 4; ++m)
+        {
+            std::size_t N{1};
+            for (std::size_t j = 0; j < m; ++j)
+                N *= n;
+
+            rct::keyM a = rct::keyMInit(n, m);
+            for (rct::keyV &a_row : a)
+                for (rct::key &a_elem : a_row)
+                    a_elem = rct::skGen();
+
+            for (const std::size_t l : {std::size_t{0}, N/2, N - 1})
+            {
+                std::vector<std::size_t> decomp_l(m), decomp_k(m);
+                sp::decompose(l, n, m, decomp_l);
+
+                rct::keyM p;
+                sp::one_of_many_coefficients(a, decomp_l, n, m, p);
+                ASSERT_TRUE(p.size() == N);
+
+                for (std::size_t k = 0; k < N; ++k)
+                {
+                    sp::decompose(k, n, m, decomp_k);
+
+                    rct::keyV p_expected(m + 1, rct::zero());
+                    p_expected[0] = rct::identity();
+                    for (std::size_t j = 0; j < m; ++j)
+                    {
+                        p_expected = sp::convolve(p_expected,
+                            {a[j][decomp_k[j]], sp::kronecker_delta(decomp_l[j], decomp_k[j])},
+                            m);
+                    }
+
+                    EXPECT_TRUE(p[k] == p_expected);
+                }
+            }
+        }
+    }
+}
+
+TEST(grootle, one_of_many_f_products)
+{
+    // the shared-prefix products must match a per-member product over all digits
+    rct::keyV prefix_scratch, t;
+    for (const std::size_t n : {2, 3, 5})
+    {
+        for (std::size_t m = 1; m <= 4; ++m)
+        {
+            std::size_t N{1};
+            for (std::size_t j = 0; j < m; ++j)
+                N *= n;
+
+            rct::KeyMatrix f{m, n};
+            for (std::size_t j = 0; j < m; ++j)
+                for (rct::key &f_elem : f[j])
+                    f_elem = rct::skGen();
+
+            sp::one_of_many_f_products(f, n, m, prefix_scratch, t);
+            ASSERT_TRUE(t.size() == N);
+
+            std::vector<std::size_t> decomp_k(m);
+            for (std::size_t k = 0; k < N; ++k)
+            {
+                sp::decompose(k, n, m, decomp_k);
+
+                rct::key t_expected{rct::identity()};
+                for (std::size_t j = 0; j < m; ++j)
+                    sc_mul(t_expected.bytes, t_expected.bytes, f[j][decomp_k[j]].bytes);
+
+                EXPECT_TRUE(t[k] == t_expected);
+            }
+
+            // chunked across threads (each chunk rebuilds its own prefixes)
+            for (const std::size_t num_threads : {0, 2, 3})
+            {
+                rct::keyV t_mt;
+                sp::one_of_many_f_products_mt(f, n, m, num_threads, t_mt);
+                EXPECT_TRUE(t_mt == t);
+            }
+        }
+    }
+}
+
+TEST(grootle, concise_parallel_large_ref_set)
+{
+    // 2^11 members x 2 keys: big enough for each proof's ref set terms to be split across threads
+    const std::size_t n{2};
+    const std::size_t m{11};
+    const std::size_t N_proofs{2};
+    const std::size_t num_keys{2};
+    const std::size_t N{sp::grootle_ref_set_size(n, m)};
+
+    std::vector<KeyMatrix> M(N_proofs, KeyMatrix{N, num_keys});
+    std::vector<std::vector<crypto::secret_key>> proof_privkeys(N_proofs, std::vector<crypto::secret_key>(num_keys));
+    keyM proof_offsets(N_proofs, keyV(num_keys));
+    keyV proof_messages(N_proofs);
+    key temp, privkey, offset_privkey;
+
+    for (std::size_t proof_i = 0; proof_i < N_proofs; ++proof_i)
+    {
+        for (std::size_t k = 0; k < N; ++k)
+        {
+            for (std::size_t alpha = 0; alpha < num_keys; ++alpha)
+                skpkGen(temp, M[proof_i][k][alpha]);
+        }
+
+        proof_messages[proof_i] = skGen();
+        for (std::size_t alpha = 0; alpha < num_keys; ++alpha)
+        {
+            skpkGen(privkey, M[proof_i][proof_i][alpha]);
+            skpkGen(offset_privkey, proof_offsets[proof_i][alpha]);
+            sc_sub(&(proof_privkeys[proof_i][alpha]), privkey.bytes, offset_privkey.bytes);
+        }
+    }
+
+    std::vector<sp::ConciseGrootleProof> proofs;
+    std::vector<const sp::ConciseGrootleProof*> proof_ptrs;
+    for (std::size_t proof_i = 0; proof_i < N_proofs; ++proof_i)
+    {
+        proofs.push_back(sp::concise_grootle_prove(M[proof_i],
+            proof_i,
+            proof_offsets[proof_i],
+            proof_privkeys[proof_i],
+            n,
+            m,
+            proof_messages[proof_i]));
+    }
+    for (const sp::ConciseGrootleProof &proof : proofs)
+        proof_ptrs.push_back(&proof);
+
+    const KeyMatrix proof_offsets_flat{proof_offsets};
+    for (const std::size_t num_threads : {1, 0, 3})
+    {
+        EXPECT_TRUE(sp::concise_grootle_verify(proof_ptrs, M, proof_offsets_flat, n, m, proof_messages,
+            sp::DEFAULT_BATCH_WEIGHT_SIZE, num_threads));
+    }
+
+    // bad ref set member (in the last chunk)
+    skpkGen(temp, M[1][N - 1][1]);
+    EXPECT_FALSE(sp::concise_grootle_verify(proof_ptrs, M, proof_offsets_flat, n, m, proof_messages,
+        sp::DEFAULT_BATCH_WEIGHT_SIZE, 0));
+}
+
+static void test_aggregate_concise_grootle(const std::size_t n,
+    const std::size_t m,
+    const std::vector<std::size_t> &inputs_per_proof,
+    const std::size_t num_keys)
+{
+    const std::size_t N_proofs{inputs_per_proof.size()};
+    const std::size_t N{sp::grootle_ref_set_size(n, m)};
+
+    // per-input ref sets, signing keys (real signer at index 'u' of input u), offsets (offset 0 is the identity)
+    std::vector<std::vector<KeyMatrix>> M(N_proofs);
+    std::vector<std::vector<std::size_t>> l(N_proofs);
+    std::vector<KeyMatrix> proof_offsets;
+    std::vector<std::vector<std::vector<crypto::secret_key>>> proof_privkeys(N_proofs);
+    keyV proof_messages(N_proofs);
+    key temp, privkey, offset_privkey;
+
+    for (std::size_t proof_i = 0; proof_i < N_proofs; ++proof_i)
+    {
+        const std::size_t num_inputs{inputs_per_proof[proof_i]};
+        M[proof_i].resize(num_inputs, KeyMatrix{N, num_keys});
+        proof_offsets.emplace_back(num_inputs, num_keys);
+        proof_privkeys[proof_i].resize(num_inputs, std::vector<crypto::secret_key>(num_keys));
+        proof_messages[proof_i] = skGen();
+
+        for (std::size_t u = 0; u < num_inputs; ++u)
+        {
+            l[proof_i].push_back(u % N);
+
+            for (std::size_t k = 0; k < N; ++k)
+            {
+                for (std::size_t alpha = 0; alpha < num_keys; ++alpha)
+                    skpkGen(temp, M[proof_i][u][k][alpha]);
+            }
+
+            for (std::size_t alpha = 0; alpha < num_keys; ++alpha)
+            {
+                skpkGen(privkey, M[proof_i][u][l[proof_i][u]][alpha]);
+
+                if (alpha == 0)
+                {
+                    proof_offsets[proof_i][u][alpha] = identity();
+                    proof_privkeys[proof_i][u][alpha] = rct::rct2sk(privkey);
+                }
+                else
+                {
+                    skpkGen(offset_privkey, proof_offsets[proof_i][u][alpha]);
+                    sc_sub(&(proof_privkeys[proof_i][u][alpha]), privkey.bytes, offset_privkey.bytes);
+                }
+            }
+        }
+    }
+
+    std::vector<sp::AggregateConciseGrootleProof> proofs;
+    std::vector<const sp::AggregateConciseGrootleProof*> proof_ptrs;
+    for (std::size_t proof_i = 0; proof_i < N_proofs; ++proof_i)
+    {
+        proofs.push_back(sp::aggregate_concise_grootle_prove(M[proof_i],
+            l[proof_i],
+            proof_offsets[proof_i],
+            proof_privkeys[proof_i],
+            n,
+            m,
+            proof_messages[proof_i]));
+
+        // one A, B, {X}, zA, z for all the inputs
+        EXPECT_TRUE(proofs.back().f.size() == inputs_per_proof[proof_i]*m);
+        EXPECT_TRUE(proofs.back().X.size() == m);
+    }
+    for (const sp::AggregateConciseGrootleProof &proof : proofs)
+        proof_ptrs.push_back(&proof);
+
+    EXPECT_TRUE(sp::aggregate_concise_grootle_verify(proof_ptrs, M, proof_offsets, n, m, proof_messages));
+
+    // wrong message
+    keyV bad_messages{proof_messages};
+    bad_messages.back() = skGen();
+    EXPECT_FALSE(sp::aggregate_concise_grootle_verify(proof_ptrs, M, proof_offsets, n, m, bad_messages));
+
+    // inputs swapped between proofs' ref sets
+    if (inputs_per_proof.back() > 1)
+    {
+        std::vector<std::vector<KeyMatrix>> bad_M{M};
+        std::swap(bad_M.back()[0], bad_M.back()[1]);
+        EXPECT_FALSE(sp::aggregate_concise_grootle_verify(proof_ptrs, bad_M, proof_offsets, n, m, proof_messages));
+    }
+
+    // bad proof
+    proofs.back().f.back()[n - 2] = skGen();
+    EXPECT_FALSE(sp::aggregate_concise_grootle_verify(proof_ptrs, M, proof_offsets, n, m, proof_messages));
+}
+
+TEST(grootle, aggregate)
+{
+    test_aggregate_concise_grootle(2, 7, {1}, 1);
+    test_aggregate_concise_grootle(2, 7, {2}, 2);
+    test_aggregate_concise_grootle(2, 7, {4}, 2);
+    test_aggregate_concise_grootle(3, 3, {3}, 3);
+    test_aggregate_concise_grootle(2, 4, {3, 1, 2}, 2);
+
+    // too many inputs for the shared matrix commitment generators
+    EXPECT_ANY_THROW(test_aggregate_concise_grootle(2, 7, {10}, 1));
+}
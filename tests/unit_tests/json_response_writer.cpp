@@ -0,0 +1,173 @@
+// Copyright (c) 2022, The Monero Project
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of
+//    conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list
+//    of conditions and the following disclaimer in the documentation and/or other
+//    materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be
+//    used to endorse or promote products derived from this software without specific
+//    prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+// THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include <gtest/gtest.h>
+#include <rapidjson/document.h>
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+#include <string>
+
+#include "byte_slice.h"
+#include "byte_stream.h"
+#include "rpc/core_rpc_server_commands_defs.h"
+#include "rpc/json_response_writer.h"
+#include "storages/portable_storage_template_helper.h"
+
+namespace
+{
+  // every byte class the escaper handles, plus raw utf-8 and a byte that isn't valid utf-8;
+  // '\v' is left out, store_t_to_json() writes it as "\v" which is not json
+  const std::string awkward = "quote\" backslash\\ slash/ \b\f\n\r\t caf\xc3\xa9 \xff end";
+
+  // store_t_to_json() indents and writes '/' as "\/", so both sides go through a compact
+  // rapidjson writer first; names, their order and the values must then match byte for byte
+  std::string canonical(const std::string &json)
+  {
+    rapidjson::Document doc;
+    doc.Parse(json.c_str());
+    EXPECT_FALSE(doc.HasParseError()) << json;
+    rapidjson::StringBuffer buffer;
+    rapidjson::Writer<rapidjson::StringBuffer> writer{buffer};
+    doc.Accept(writer);
+    return {buffer.GetString(), buffer.GetSize()};
+  }
+
+  template<typename T, typename F>
+  void check_matches_generic(const T &res, F write)
+  {
+    std::string generic;
+    ASSERT_TRUE(epee::serialization::store_t_to_json(res, generic));
+
+    epee::byte_stream out;
+    write(out, res);
+    const epee::byte_slice slice{std::move(out)};
+    const std::string streamed{reinterpret_cast<const char*>(slice.data()), slice.size()};
+
+    EXPECT_EQ(canonical(generic), canonical(streamed));
+  }
+
+  cryptonote::tx_info make_tx_info(const std::string &suffix)
+  {
+    cryptonote::tx_info txi;
+    txi.id_hash = "id" + suffix;
+    txi.tx_json = "{\n  \"version\": 2\n}" + awkward;
+    txi.blob_size = 2500;
+    txi.weight = 2600;
+    txi.fee = 18446744073709551615ull;
+    txi.max_used_block_id_hash = awkward;
+    txi.max_used_block_height = 12;
+    txi.kept_by_block = true;
+    txi.last_failed_height = 0;
+    txi.last_failed_id_hash = "";
+    txi.receive_time = 1600000000;
+    txi.relayed = false;
+    txi.last_relayed_time = 1;
+    txi.do_not_relay = true;
+    txi.double_spend_seen = false;
+    txi.tx_blob = "00ff" + suffix;
+    return txi;
+  }
+
+  cryptonote::COMMAND_RPC_GET_TRANSACTIONS::entry make_entry(bool in_pool, const std::string &suffix)
+  {
+    cryptonote::COMMAND_RPC_GET_TRANSACTIONS::entry e;
+    e.tx_hash = "hash" + suffix;
+    e.as_hex = "";
+    e.pruned_as_hex = "0a0b" + suffix;
+    e.prunable_as_hex = awkward;
+    e.prunable_hash = "";
+    e.as_json = "{\"vin\": [], \"extra\": \"" + awkward + "\"}";
+    e.in_pool = in_pool;
+    e.double_spend_seen = in_pool;
+    e.block_height = in_pool ? 0 : 1000;
+    e.confirmations = in_pool ? 0 : 3;
+    e.block_timestamp = in_pool ? 0 : 1600000100;
+    e.received_timestamp = in_pool ? 1600000200 : 0;
+    e.relayed = in_pool;
+    return e;
+  }
+}
+
+TEST(json_response_writer, transaction_pool_empty)
+{
+  cryptonote::COMMAND_RPC_GET_TRANSACTION_POOL::response res{};
+  check_matches_generic(res, cryptonote::write_get_transaction_pool_response);
+
+  res.status = CORE_RPC_STATUS_OK;
+  res.untrusted = true;
+  check_matches_generic(res, cryptonote::write_get_transaction_pool_response);
+}
+
+TEST(json_response_writer, transaction_pool)
+{
+  cryptonote::COMMAND_RPC_GET_TRANSACTION_POOL::response res{};
+  res.status = awkward;
+  res.top_hash = "top";
+  res.credits = 7;
+  res.transactions.push_back(make_tx_info("0"));
+  res.transactions.push_back(make_tx_info(awkward));
+  res.transactions.back().weight = 0;
+  res.transactions.push_back(cryptonote::tx_info{});
+
+  cryptonote::spent_key_image_info ski;
+  ski.id_hash = awkward;
+  res.spent_key_images.push_back(ski);
+  ski.txs_hashes = {"a", awkward, ""};
+  res.spent_key_images.push_back(ski);
+
+  check_matches_generic(res, cryptonote::write_get_transaction_pool_response);
+}
+
+TEST(json_response_writer, transactions_empty)
+{
+  cryptonote::COMMAND_RPC_GET_TRANSACTIONS::response res{};
+  check_matches_generic(res, cryptonote::write_get_transactions_response);
+
+  res.status = CORE_RPC_STATUS_OK;
+  res.missed_tx = {"missing", awkward};
+  check_matches_generic(res, cryptonote::write_get_transactions_response);
+}
+
+TEST(json_response_writer, transactions)
+{
+  cryptonote::COMMAND_RPC_GET_TRANSACTIONS::response res{};
+  res.status = CORE_RPC_STATUS_OK;
+  res.top_hash = awkward;
+  res.untrusted = true;
+  res.txs_as_hex = {"0102", ""};
+  res.txs_as_json = {awkward};
+
+  res.txs.push_back(make_entry(false, "0"));
+  res.txs.back().output_indices = {0, 5, 18446744073709551615ull};
+  res.txs.push_back(make_entry(false, "1")); // mined, no output indices
+  res.txs.push_back(make_entry(true, awkward));
+  res.txs.push_back(cryptonote::COMMAND_RPC_GET_TRANSACTIONS::entry{});
+
+  check_matches_generic(res, cryptonote::write_get_transactions_response);
+}
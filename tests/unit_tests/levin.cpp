@@ -687,6 +687,11 @@ TEST_F(levin_notify, stem_without_padding)
             notifier.run_fluff();
             ASSERT_LT(0u, io_service_.poll());
         }
+        else
+        {
+            notifier.run_stems();
+            ASSERT_LT(0u, io_service_.poll());
+        }
 
         std::size_t send_count = 0;
         EXPECT_EQ(0u, context->process_send_queue());
@@ -817,6 +822,11 @@ TEST_F(levin_notify, local_without_padding)
             notifier.run_fluff();
             ASSERT_LT(0u, io_service_.poll());
         }
+        else
+        {
+            notifier.run_stems();
+            ASSERT_LT(0u, io_service_.poll());
+        }
 
         std::size_t send_count = 0;
         EXPECT_EQ(0u, context->process_send_queue());
@@ -890,6 +900,11 @@ TEST_F(levin_notify, forward_without_padding)
             notifier.run_fluff();
             ASSERT_LT(0u, io_service_.poll());
         }
+        else
+        {
+            notifier.run_stems();
+            ASSERT_LT(0u, io_service_.poll());
+        }
 
         std::size_t send_count = 0;
         EXPECT_EQ(0u, context->process_send_queue());
@@ -1067,6 +1082,11 @@ TEST_F(levin_notify, stem_with_padding)
             notifier.run_fluff();
             ASSERT_LT(0u, io_service_.poll());
         }
+        else
+        {
+            notifier.run_stems();
+            ASSERT_LT(0u, io_service_.poll());
+        }
 
         std::size_t send_count = 0;
         EXPECT_EQ(0u, context->process_send_queue());
@@ -1192,6 +1212,11 @@ TEST_F(levin_notify, local_with_padding)
             notifier.run_fluff();
             ASSERT_LT(0u, io_service_.poll());
         }
+        else
+        {
+            notifier.run_stems();
+            ASSERT_LT(0u, io_service_.poll());
+        }
 
         std::size_t send_count = 0;
         EXPECT_EQ(0u, context->process_send_queue());
@@ -1260,6 +1285,11 @@ TEST_F(levin_notify, forward_with_padding)
             notifier.run_fluff();
             ASSERT_LT(0u, io_service_.poll());
         }
+        else
+        {
+            notifier.run_stems();
+            ASSERT_LT(0u, io_service_.poll());
+        }
 
         std::size_t send_count = 0;
         EXPECT_EQ(0u, context->process_send_queue());
@@ -1939,6 +1969,8 @@ TEST_F(levin_notify, stem_mappings)
         ASSERT_LT(0u, io_service_.poll());
     }
     EXPECT_EQ(txs, events_.take_relayed(cryptonote::relay_method::stem));
+    notifier.run_stems();
+    ASSERT_LT(0u, io_service_.poll());
 
     std::set<boost::uuids::uuid> used;
     std::map<boost::uuids::uuid, boost::uuids::uuid> mappings;
@@ -1976,6 +2008,8 @@ TEST_F(levin_notify, stem_mappings)
         io_service_.reset();
         ASSERT_LT(0u, io_service_.poll());
         EXPECT_EQ(txs, events_.take_relayed(cryptonote::relay_method::stem));
+        notifier.run_stems();
+        ASSERT_LT(0u, io_service_.poll());
 
         std::size_t send_count = 0;
         for (auto context = contexts_.begin(); context != contexts_.end(); ++context)
@@ -2007,6 +2041,72 @@ TEST_F(levin_notify, stem_mappings)
     EXPECT_EQ(CRYPTONOTE_DANDELIONPP_STEMS, used.size());
 }
 
+TEST_F(levin_notify, stem_batching)
+{
+    std::shared_ptr<cryptonote::levin::notify> notifier_ptr = make_notifier(0, true, false);
+    auto &notifier = *notifier_ptr;
+
+    for (unsigned count = 0; count < 10; ++count)
+        add_connection(count % 2 == 0);
+
+    notifier.new_out_connection();
+    io_service_.poll();
+
+    std::vector<cryptonote::blobdata> txs(2);
+    txs[0].resize(100, 'f');
+    txs[1].resize(200, 'e');
+    std::vector<cryptonote::blobdata> more_txs(1);
+    more_txs[0].resize(300, 'g');
+
+    ASSERT_EQ(10u, contexts_.size());
+    for (;;)
+    {
+        EXPECT_TRUE(notifier.send_txs(txs, contexts_.front().get_id(), cryptonote::relay_method::stem));
+
+        io_service_.reset();
+        ASSERT_LT(0u, io_service_.poll());
+        if (events_.has_stem_txes())
+            break;
+
+        EXPECT_EQ(txs, events_.take_relayed(cryptonote::relay_method::fluff));
+        notifier.run_fluff();
+        io_service_.reset();
+        ASSERT_LT(0u, io_service_.poll());
+        for (auto& context : contexts_)
+            context.process_send_queue();
+        while (receiver_.notified_size())
+            receiver_.get_notification<cryptonote::NOTIFY_NEW_TRANSACTIONS>();
+
+        notifier.run_epoch();
+        io_service_.reset();
+        ASSERT_LT(0u, io_service_.poll());
+    }
+
+    // a second stem relay for the same peer, within the batch window
+    EXPECT_TRUE(notifier.send_txs(more_txs, contexts_.front().get_id(), cryptonote::relay_method::stem));
+    ASSERT_LT(0u, io_service_.poll());
+
+    std::vector<cryptonote::blobdata> all_txs = txs;
+    all_txs.insert(all_txs.end(), more_txs.begin(), more_txs.end());
+    EXPECT_EQ(all_txs, events_.take_relayed(cryptonote::relay_method::stem));
+
+    std::size_t send_count = 0;
+    for (auto& context : contexts_)
+        send_count += context.process_send_queue();
+    EXPECT_EQ(0u, send_count);
+
+    notifier.run_stems();
+    ASSERT_LT(0u, io_service_.poll());
+    for (auto& context : contexts_)
+        send_count += context.process_send_queue();
+
+    EXPECT_EQ(1u, send_count);
+    ASSERT_EQ(1u, receiver_.notified_size());
+    auto notification = receiver_.get_notification<cryptonote::NOTIFY_NEW_TRANSACTIONS>().second;
+    EXPECT_EQ(all_txs, notification.txs);
+    EXPECT_FALSE(notification.dandelionpp_fluff);
+}
+
 TEST_F(levin_notify, fluff_multiple)
 {
     static constexpr const unsigned test_connections_count = (CRYPTONOTE_DANDELIONPP_STEMS + 1) * 2;
@@ -2041,6 +2141,8 @@ TEST_F(levin_notify, fluff_multiple)
             break;
 
         EXPECT_EQ(txs, events_.take_relayed(cryptonote::relay_method::stem));
+        notifier.run_stems();
+        ASSERT_LT(0u, io_service_.poll());
 
         std::size_t send_count = 0;
         EXPECT_EQ(0u, context->process_send_queue());
@@ -195,6 +195,53 @@ TEST(logging, multiline)
   cleanup();
 }
 
+// one call site for every level, so its cached category state is reused across the checks below
+static bool cached_site_logs(el::Level level)
+{
+  bool logged = false;
+  IFLOG(level, "cache.site", el::Color::Default, el::base::DispatchAction::NormalLog, logged = true, "cached site");
+  return logged;
+}
+
+TEST(logging, cached_site_follows_category_changes)
+{
+  init();
+  mlog_set_categories("cache.site:INFO");
+  ASSERT_TRUE(cached_site_logs(el::Level::Info));
+  ASSERT_FALSE(cached_site_logs(el::Level::Debug));
+
+  // a level some other category logs at, but this one doesn't
+  mlog_set_categories("cache.site:INFO,other:TRACE");
+  ASSERT_FALSE(cached_site_logs(el::Level::Debug));
+  ASSERT_FALSE(cached_site_logs(el::Level::Trace));
+
+  mlog_set_categories("cache.site:TRACE");
+  ASSERT_TRUE(cached_site_logs(el::Level::Trace));
+  ASSERT_TRUE(cached_site_logs(el::Level::Debug));
+
+  mlog_set_categories("cache.site:ERROR");
+  ASSERT_FALSE(cached_site_logs(el::Level::Info));
+  ASSERT_TRUE(cached_site_logs(el::Level::Error));
+
+  mlog_set_categories("");
+  ASSERT_FALSE(cached_site_logs(el::Level::Fatal));
+
+  // mlog_set_log_level() replaces the categories too
+  mlog_set_log_level(4);
+  ASSERT_TRUE(cached_site_logs(el::Level::Trace));
+  mlog_set_log_level(0);
+  ASSERT_FALSE(cached_site_logs(el::Level::Info));
+  ASSERT_TRUE(cached_site_logs(el::Level::Warning));
+  mlog_set_log_level(2);
+  ASSERT_TRUE(cached_site_logs(el::Level::Debug));
+  ASSERT_FALSE(cached_site_logs(el::Level::Trace));
+
+  std::string str;
+  ASSERT_TRUE(load_log_to_string(log_filename, str));
+  ASSERT_TRUE(str.find("cached site") != std::string::npos);
+  cleanup();
+}
+
 // These operations might segfault
 TEST(logging, copy_ctor_segfault)
 {
@@ -0,0 +1,119 @@
+// Copyright (c) 2022, The Monero Project
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of
+//    conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list
+//    of conditions and the following disclaimer in the documentation and/or other
+//    materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be
+//    used to endorse or promote products derived from this software without specific
+//    prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+// THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include <limits>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "common/metrics.h"
+
+namespace
+{
+  // registered for every write_metrics() in this binary
+  tools::MetricsHistogram unit_test_histogram("monero_unit_test_histogram", "A histogram for the unit tests", 2.0);
+}
+
+TEST(metrics, counter_and_gauge)
+{
+  tools::PrometheusWriter writer;
+  writer.counter("monero_test_total", "Things counted", 18446744073709551615ull);
+  writer.gauge("monero_test_ratio", "A ratio", 0.25);
+  ASSERT_EQ(writer.str(),
+    "# HELP monero_test_total Things counted\n"
+    "# TYPE monero_test_total counter\n"
+    "monero_test_total 18446744073709551615\n"
+    "# HELP monero_test_ratio A ratio\n"
+    "# TYPE monero_test_ratio gauge\n"
+    "monero_test_ratio 0.25\n");
+}
+
+TEST(metrics, label_escaping)
+{
+  tools::PrometheusWriter writer;
+  writer.sample("monero_test", {{"a", "plain"}, {"b", "quote\" backslash\\ newline\n end"}, {"c", ""}}, uint64_t(3));
+  writer.sample("monero_test", {}, 1.5);
+  ASSERT_EQ(writer.str(),
+    "monero_test{a=\"plain\",b=\"quote\\\" backslash\\\\ newline\\n end\",c=\"\"} 3\n"
+    "monero_test 1.5\n");
+}
+
+TEST(metrics, cumulative_buckets)
+{
+  tools::PrometheusWriter writer;
+  writer.histogram("monero_test", {{"name", "x"}}, 10.5, {{1, 2}, {3, 0}, {7, 5}, {15, 0}, {31, 0}});
+  ASSERT_EQ(writer.str(),
+    "monero_test_bucket{name=\"x\",le=\"1\"} 2\n"
+    "monero_test_bucket{name=\"x\",le=\"3\"} 2\n"
+    "monero_test_bucket{name=\"x\",le=\"7\"} 7\n"
+    "monero_test_bucket{name=\"x\",le=\"+Inf\"} 7\n"
+    "monero_test_sum{name=\"x\"} 10.5\n"
+    "monero_test_count{name=\"x\"} 7\n");
+}
+
+TEST(metrics, infinite_bucket)
+{
+  // a last, open ended bucket only shows in +Inf and _count
+  tools::PrometheusWriter writer;
+  writer.histogram("monero_test", {}, 0, {{1, 1}, {2, 0}, {std::numeric_limits<double>::infinity(), 4}});
+  ASSERT_EQ(writer.str(),
+    "monero_test_bucket{le=\"1\"} 1\n"
+    "monero_test_bucket{le=\"+Inf\"} 5\n"
+    "monero_test_sum 0\n"
+    "monero_test_count 5\n");
+
+  tools::PrometheusWriter empty;
+  empty.histogram("monero_test", {}, 0, {{1, 0}, {std::numeric_limits<double>::infinity(), 0}});
+  ASSERT_EQ(empty.str(),
+    "monero_test_bucket{le=\"+Inf\"} 0\n"
+    "monero_test_sum 0\n"
+    "monero_test_count 0\n");
+}
+
+TEST(metrics, registered_histogram)
+{
+  for (const uint64_t value: {0, 1, 2, 3, 4, 100})
+    unit_test_histogram.add(value);
+
+  // bucket b holds values up to 2^(b+1) - 1, exported times the scale of 2
+  tools::PrometheusWriter writer;
+  tools::write_metrics(writer);
+  ASSERT_NE(writer.str().find(
+    "# HELP monero_unit_test_histogram A histogram for the unit tests\n"
+    "# TYPE monero_unit_test_histogram histogram\n"
+    "monero_unit_test_histogram_bucket{le=\"2\"} 2\n"
+    "monero_unit_test_histogram_bucket{le=\"6\"} 4\n"
+    "monero_unit_test_histogram_bucket{le=\"14\"} 5\n"
+    "monero_unit_test_histogram_bucket{le=\"30\"} 5\n"
+    "monero_unit_test_histogram_bucket{le=\"62\"} 5\n"
+    "monero_unit_test_histogram_bucket{le=\"126\"} 5\n"
+    "monero_unit_test_histogram_bucket{le=\"254\"} 6\n"
+    "monero_unit_test_histogram_bucket{le=\"+Inf\"} 6\n"
+    "monero_unit_test_histogram_sum 220\n"
+    "monero_unit_test_histogram_count 6\n"), std::string::npos) << writer.str();
+}
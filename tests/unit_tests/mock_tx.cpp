@@ -27,21 +27,48 @@
 // THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "crypto/crypto.h"
+extern "C"
+{
+#include "crypto/crypto-ops.h"
+}
+#include "mock_tx/mock_decoy_selection.h"
 #include "mock_tx/mock_ledger_context.h"
+#include "mock_tx/mock_ledger_context_lmdb.h"
+#include "mock_tx/mock_linking_tag_set.h"
 #include "mock_tx/mock_tx.h"
+#include "mock_tx/mock_tx_batch_verifier.h"
+#include "mock_tx/mock_tx_phase_timers.h"
+#include "mock_tx/mock_tx_pool.h"
+#include "mock_tx/mock_tx_verification_scheduler.h"
 #include "mock_tx/mock_rct_clsag.h"
 #include "mock_tx/mock_rct_triptych.h"
+#include "mock_tx/mock_sp_core_utils.h"
+#include "mock_tx/mock_sp_transaction_utils.h"
 #include "mock_tx/mock_sp_txtype_concise_v1.h"
 #include "mock_tx/mock_sp_txtype_merge_v1.h"
 #include "mock_tx/mock_sp_txtype_plain_v1.h"
 #include "mock_tx/mock_sp_txtype_squashed_v1.h"
+#include "mock_tx/mock_sp_validators.h"
+#include "mock_tx/mock_squashed_enote_file.h"
+#include "mock_tx/mock_tx_utils.h"
+#include "mock_tx/seraphis_scratch_arena.h"
 #include "ringct/rctOps.h"
 #include "ringct/rctTypes.h"
+#include "serialization/binary_utils.h"
 
+#include <boost/filesystem.hpp>
 #include "gtest/gtest.h"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <future>
 #include <iostream>
+#include <limits>
 #include <memory>
+#include <string>
+#include <thread>
 #include <type_traits>
 #include <vector>
 
@@ -153,6 +180,10 @@ static void run_mock_tx_test_batch(const std::vector<MockTxGenData> &gen_data)
     {
         // validate tx
         EXPECT_TRUE(mock_tx::validate_mock_txs<MockTxType>(txs_to_verify, ledger_context));
+
+        // validate tx with the batch split across threads
+        EXPECT_TRUE(mock_tx::validate_mock_txs<MockTxType>(txs_to_verify, ledger_context, 1));
+        EXPECT_TRUE(mock_tx::validate_mock_txs<MockTxType>(txs_to_verify, ledger_context, 3));
     }
     catch (...)
     {
@@ -621,3 +652,1605 @@ TEST(mock_tx_batching, seraphis_squashed)
     run_mock_tx_test_batch<mock_tx::MockTxSpSquashedV1>(get_mock_tx_gen_data_batching());
     run_mock_tx_test_batch<mock_tx::MockTxSpSquashedV1>(get_mock_tx_gen_data_batch_splitting());
 }
+
+TEST(mock_tx, seraphis_squashed_enote_cache)
+{
+    // small cache so lookups hit, miss, and evict
+    mock_tx::MockLedgerContext ledger_context{2};
+
+    for (std::size_t i{0}; i < 5; ++i)
+    {
+        mock_tx::MockENoteSpV1 enote;
+        enote.gen();
+        EXPECT_TRUE(ledger_context.add_enote_sp_v2(enote) == i);
+    }
+
+    const std::vector<std::size_t> indices{0, 1, 0, 2, 3, 1, 4, 4, 0};
+    rct::KeyMatrix squashed_enotes;
+    std::vector<ge_p3> squashed_enote_points;
+
+    for (std::size_t pass{0}; pass < 2; ++pass)
+    {
+        ledger_context.get_reference_set_components_sp_v2_p3(indices, squashed_enotes, squashed_enote_points);
+        ASSERT_TRUE(squashed_enotes.rows() == indices.size());
+        ASSERT_TRUE(squashed_enote_points.size() == indices.size());
+
+        rct::KeyMatrix squashed_enotes_expected;
+        ledger_context.get_reference_set_components_sp_v2(indices, squashed_enotes_expected);
+        EXPECT_TRUE(squashed_enotes == squashed_enotes_expected);
+
+        for (std::size_t i{0}; i < indices.size(); ++i)
+        {
+            rct::key point;
+            ge_p3_tobytes(point.bytes, &squashed_enote_points[i]);
+            EXPECT_TRUE(point == squashed_enotes[i][0]);
+        }
+    }
+}
+
+TEST(mock_tx, seraphis_squashed_enote_converted_storage)
+{
+    // the default ledger doesn't store converted squashed enotes
+    mock_tx::MockLedgerContext default_ledger_context;
+    mock_tx::MockENoteSpV1 default_enote;
+    default_enote.gen();
+    default_ledger_context.add_enote_sp_v2(default_enote);
+
+    rct::KeyMatrix squashed_enotes;
+    std::vector<ge_p3> squashed_enote_points;
+    std::vector<ge_cached> squashed_enote_cached;
+    EXPECT_FALSE(default_ledger_context.try_get_reference_set_components_sp_v2_cached({0},
+        squashed_enotes,
+        squashed_enote_points,
+        squashed_enote_cached));
+
+    // stored conversions match the squashed enotes
+    std::shared_ptr<mock_tx::MockLedgerContext> ledger_context{
+            std::make_shared<mock_tx::MockLedgerContext>(0, 0, true)
+        };
+    mock_tx::MockENoteSpV1 enote;
+    enote.gen();
+    ledger_context->add_enote_sp_v1(enote);  //no squashed enote at index 0
+    for (std::size_t i{1}; i < 4; ++i)
+    {
+        enote.gen();
+        EXPECT_TRUE(ledger_context->add_enote_sp_v2(enote) == i);
+    }
+
+    const std::vector<std::size_t> indices{3, 1, 2, 1};
+    EXPECT_ANY_THROW(ledger_context->try_get_reference_set_components_sp_v2_cached({0, 1},
+        squashed_enotes,
+        squashed_enote_points,
+        squashed_enote_cached));
+    ASSERT_TRUE(ledger_context->try_get_reference_set_components_sp_v2_cached(indices,
+        squashed_enotes,
+        squashed_enote_points,
+        squashed_enote_cached));
+    ASSERT_TRUE(squashed_enote_points.size() == indices.size());
+    ASSERT_TRUE(squashed_enote_cached.size() == indices.size());
+
+    rct::KeyMatrix squashed_enotes_expected;
+    ledger_context->get_reference_set_components_sp_v2(indices, squashed_enotes_expected);
+    EXPECT_TRUE(squashed_enotes == squashed_enotes_expected);
+
+    for (std::size_t i{0}; i < indices.size(); ++i)
+    {
+        rct::key point;
+        ge_p3_tobytes(point.bytes, &squashed_enote_points[i]);
+        EXPECT_TRUE(point == squashed_enotes[i][0]);
+
+        ge_cached expected_cached;
+        ge_p3_to_cached(&expected_cached, &squashed_enote_points[i]);
+        EXPECT_TRUE(memcmp(&expected_cached, &squashed_enote_cached[i], sizeof(ge_cached)) == 0);
+    }
+
+    // txs verify with ref sets fed to pippenger in cached form
+    mock_tx::MockTxParamPack tx_params;
+    tx_params.max_rangeproof_splits = 0;
+    tx_params.ref_set_decomp_n = 2;
+    tx_params.ref_set_decomp_m = 3;
+
+    std::vector<std::shared_ptr<mock_tx::MockTxSpSquashedV1>> txs;
+    txs.emplace_back(mock_tx::make_mock_tx<mock_tx::MockTxSpSquashedV1>(tx_params, {2, 2}, {1, 3}, ledger_context));
+    txs.emplace_back(mock_tx::make_mock_tx<mock_tx::MockTxSpSquashedV1>(tx_params, {3}, {3}, ledger_context));
+    EXPECT_TRUE(txs[0]->validate(ledger_context));
+    EXPECT_TRUE(mock_tx::validate_mock_txs<mock_tx::MockTxSpSquashedV1>(txs, ledger_context));
+}
+
+TEST(mock_tx, mock_ledger_concurrent_access)
+{
+    mock_tx::MockLedgerContext ledger_context{16};
+
+    // initial ledger contents
+    std::vector<crypto::key_image> linking_tags;
+    for (std::size_t i{0}; i < 64; ++i)
+    {
+        mock_tx::MockENoteSpV1 enote;
+        enote.gen();
+        ledger_context.add_enote_sp_v2(enote);
+
+        linking_tags.emplace_back(rct::rct2ki(rct::pkGen()));
+        ledger_context.add_linking_tag_sp_v1(linking_tags.back());
+    }
+
+    rct::KeyMatrix squashed_enotes_expected;
+    std::vector<std::size_t> indices(64);
+    for (std::size_t i{0}; i < indices.size(); ++i)
+        indices[i] = (i*7) % 64;
+    ledger_context.get_reference_set_components_sp_v2(indices, squashed_enotes_expected);
+
+    // readers race each other (and a writer) on linking tag shards and the squashed enote cache
+    std::atomic<bool> readers_ok{true};
+    std::vector<std::thread> readers;
+
+    for (std::size_t thread_index{0}; thread_index < 4; ++thread_index)
+    {
+        readers.emplace_back(
+                [&]()
+                {
+                    rct::KeyMatrix squashed_enotes;
+                    std::vector<ge_p3> squashed_enote_points;
+
+                    for (std::size_t pass{0}; pass < 50; ++pass)
+                    {
+                        for (const crypto::key_image &linking_tag : linking_tags)
+                        {
+                            if (!ledger_context.linking_tag_exists_sp_v1(linking_tag))
+                                readers_ok = false;
+                        }
+
+                        ledger_context.get_reference_set_components_sp_v2_p3(indices,
+                            squashed_enotes,
+                            squashed_enote_points);
+                        if (squashed_enotes != squashed_enotes_expected)
+                            readers_ok = false;
+
+                        for (std::size_t i{0}; i < indices.size(); ++i)
+                        {
+                            rct::key point;
+                            ge_p3_tobytes(point.bytes, &squashed_enote_points[i]);
+                            if (!(point == squashed_enotes[i][0]))
+                                readers_ok = false;
+                        }
+                    }
+                }
+            );
+    }
+
+    std::vector<crypto::key_image> new_linking_tags;
+    for (std::size_t i{0}; i < 64; ++i)
+    {
+        mock_tx::MockENoteSpV1 enote;
+        enote.gen();
+        ledger_context.add_enote_sp_v2(enote);
+
+        new_linking_tags.emplace_back(rct::rct2ki(rct::pkGen()));
+        ledger_context.add_linking_tag_sp_v1(new_linking_tags.back());
+    }
+
+    for (std::thread &reader : readers)
+        reader.join();
+
+    EXPECT_TRUE(readers_ok);
+
+    for (const crypto::key_image &linking_tag : new_linking_tags)
+        EXPECT_TRUE(ledger_context.linking_tag_exists_sp_v1(linking_tag));
+    EXPECT_ANY_THROW(ledger_context.add_linking_tag_sp_v1(new_linking_tags.back()));
+}
+
+TEST(mock_tx, seraphis_lmdb_ledger)
+{
+    const boost::filesystem::path db_path{
+            boost::filesystem::temp_directory_path() / boost::filesystem::unique_path()
+        };
+    ASSERT_TRUE(boost::filesystem::create_directory(db_path));
+
+    std::vector<crypto::key_image> spent_linking_tags;
+    std::size_t num_enotes{0};
+
+    {
+        std::shared_ptr<mock_tx::MockLedgerContextLMDB> ledger_context{
+                std::make_shared<mock_tx::MockLedgerContextLMDB>(db_path.string(), std::size_t{1} << 26)
+            };
+
+        // enotes that come before the txs' reference sets
+        mock_tx::MockENoteSpV1 dummy_enote;
+        dummy_enote.gen();
+        ledger_context->add_dummy_enotes_sp_v2(dummy_enote, 100);
+        EXPECT_TRUE(ledger_context->get_num_enotes() == 100);
+
+        // make and validate txs against the on-disk ledger
+        mock_tx::MockTxParamPack tx_params;
+        tx_params.ref_set_decomp_n = 2;
+        tx_params.ref_set_decomp_m = 3;
+
+        std::vector<std::shared_ptr<mock_tx::MockTxSpSquashedV1>> txs;
+        for (std::size_t tx_index{0}; tx_index < 3; ++tx_index)
+        {
+            txs.emplace_back(
+                    mock_tx::make_mock_tx<mock_tx::MockTxSpSquashedV1>(tx_params, {2, 2}, {1, 3}, ledger_context)
+                );
+        }
+
+        std::shared_ptr<mock_tx::MockTxSpConciseV1> concise_tx{
+                mock_tx::make_mock_tx<mock_tx::MockTxSpConciseV1>(tx_params, {2}, {2}, ledger_context)
+            };
+
+        EXPECT_TRUE(mock_tx::validate_mock_txs<mock_tx::MockTxSpSquashedV1>(txs, ledger_context));
+        EXPECT_TRUE(mock_tx::validate_mock_txs<mock_tx::MockTxSpSquashedV1>(txs, ledger_context, 2));
+        EXPECT_TRUE(concise_tx->validate(ledger_context));
+
+        // add the txs; validation then fails due to double-spends
+        for (const auto &tx : txs)
+            mock_tx::add_tx_to_ledger<mock_tx::MockTxSpSquashedV1>(ledger_context, *tx);
+
+        EXPECT_FALSE(mock_tx::validate_mock_txs<mock_tx::MockTxSpSquashedV1>(txs, ledger_context));
+        EXPECT_ANY_THROW(mock_tx::add_tx_to_ledger<mock_tx::MockTxSpSquashedV1>(ledger_context, *txs[0]));
+
+        // a failed add leaves the ledger untouched
+        num_enotes = ledger_context->get_num_enotes();
+        EXPECT_ANY_THROW(mock_tx::add_tx_to_ledger<mock_tx::MockTxSpSquashedV1>(ledger_context, *txs[1]));
+        EXPECT_TRUE(ledger_context->get_num_enotes() == num_enotes);
+
+        for (const auto &tx : txs)
+        {
+            for (const auto &input_image : tx->m_input_images)
+                spent_linking_tags.emplace_back(input_image.m_key_image);
+        }
+
+        // missing enotes
+        rct::KeyMatrix squashed_enotes;
+        EXPECT_ANY_THROW(ledger_context->get_reference_set_components_sp_v2({num_enotes}, squashed_enotes));
+
+        // background fetches match direct lookups, and report errors when waited for
+        const std::vector<std::size_t> fetch_indices{0, 99, num_enotes - 1};
+        rct::KeyMatrix fetched_enotes;
+        std::vector<ge_p3> fetched_points;
+        ledger_context->get_reference_set_components_sp_v2_p3_async(fetch_indices, fetched_enotes, fetched_points).get();
+        ledger_context->get_reference_set_components_sp_v2(fetch_indices, squashed_enotes);
+        ASSERT_TRUE(fetched_enotes.size() == fetch_indices.size());
+        ASSERT_TRUE(fetched_points.size() == fetch_indices.size());
+        for (std::size_t i{0}; i < fetch_indices.size(); ++i)
+        {
+            EXPECT_TRUE(fetched_enotes[i][0] == squashed_enotes[i][0]);
+            rct::key fetched_point;
+            ge_p3_tobytes(fetched_point.bytes, &fetched_points[i]);
+            EXPECT_TRUE(fetched_point == squashed_enotes[i][0]);
+        }
+
+        const std::vector<std::size_t> missing_indices{num_enotes};
+        std::future<void> missing_fetch{
+                ledger_context->get_reference_set_components_sp_v2_p3_async(missing_indices,
+                    fetched_enotes,
+                    fetched_points)
+            };
+        EXPECT_ANY_THROW(missing_fetch.get());
+    }
+
+    // the ledger persists
+    {
+        mock_tx::MockLedgerContextLMDB ledger_context{db_path.string(), std::size_t{1} << 26};
+        EXPECT_TRUE(ledger_context.get_num_enotes() == num_enotes);
+
+        for (const crypto::key_image &linking_tag : spent_linking_tags)
+            EXPECT_TRUE(ledger_context.linking_tag_exists_sp_v1(linking_tag));
+    }
+
+    boost::filesystem::remove_all(db_path);
+}
+
+TEST(mock_tx, squashed_enote_file)
+{
+    const boost::filesystem::path db_path{
+            boost::filesystem::temp_directory_path() / boost::filesystem::unique_path()
+        };
+    ASSERT_TRUE(boost::filesystem::create_directory(db_path));
+    const std::string file_path{(db_path / "squashed_enotes").string()};
+
+    {
+        // ledger with distinct enotes, spanning several file blocks (with a partial last block)
+        mock_tx::MockLedgerContextLMDB ledger_context{db_path.string(), std::size_t{1} << 26};
+        std::vector<mock_tx::MockENoteSpV1> enote_pool(7);
+        for (mock_tx::MockENoteSpV1 &enote : enote_pool)
+            enote.gen();
+        ledger_context.add_dummy_enotes_sp_v2(enote_pool, 300);
+
+        mock_tx::write_mock_squashed_enote_file(file_path, ledger_context, ledger_context.get_num_enotes());
+
+        // random ref sets (with repeats across and within ref sets) read from the file match the ledger
+        std::vector<std::vector<std::size_t>> ref_sets(5, std::vector<std::size_t>(16));
+        std::vector<const std::vector<std::size_t>*> ref_set_ptrs;
+        for (std::vector<std::size_t> &ref_set : ref_sets)
+        {
+            for (std::size_t &index : ref_set)
+                index = crypto::rand_idx<std::size_t>(300);
+            ref_set_ptrs.push_back(&ref_set);
+        }
+        ref_sets[1][3] = ref_sets[1][4];
+        ref_sets[2][0] = 299;
+
+        for (const bool direct_io : {true, false})
+        {
+            mock_tx::MockSquashedEnoteFile enote_file{file_path, direct_io, 4};
+            EXPECT_TRUE(enote_file.get_num_enotes() == 300);
+
+            std::vector<rct::KeyMatrix> file_enotes;
+            enote_file.get_reference_sets_sp_v2(ref_set_ptrs, file_enotes);
+            ASSERT_TRUE(file_enotes.size() == ref_sets.size());
+
+            rct::KeyMatrix ledger_enotes;
+            for (std::size_t ref_set_index{0}; ref_set_index < ref_sets.size(); ++ref_set_index)
+            {
+                ledger_context.get_reference_set_components_sp_v2(ref_sets[ref_set_index], ledger_enotes);
+                EXPECT_TRUE(file_enotes[ref_set_index] == ledger_enotes);
+            }
+
+            // missing enotes
+            const std::vector<std::size_t> missing_ref_set{300};
+            EXPECT_ANY_THROW(enote_file.get_reference_sets_sp_v2({&missing_ref_set}, file_enotes));
+        }
+    }
+
+    // not a squashed enote file
+    {
+        std::ofstream bad_file{file_path, std::ios::binary | std::ios::trunc};
+        bad_file << std::string(8192, 'x');
+    }
+    EXPECT_ANY_THROW(mock_tx::MockSquashedEnoteFile{file_path});
+
+    boost::filesystem::remove_all(db_path);
+}
+
+TEST(mock_tx, mock_ledger_snapshot)
+{
+    const boost::filesystem::path snapshot_path{
+            boost::filesystem::temp_directory_path() / boost::filesystem::unique_path()
+        };
+
+    // ledger with txs added to it, and txs that reference it
+    std::shared_ptr<mock_tx::MockLedgerContext> ledger_context{
+            std::make_shared<mock_tx::MockLedgerContext>(0, 0, true)
+        };
+    mock_tx::MockENoteSpV1 enote;
+    enote.gen();
+    ledger_context->add_enote_sp_v1(enote);  //no squashed enote at index 0
+
+    mock_tx::MockTxParamPack tx_params;
+    tx_params.ref_set_decomp_n = 2;
+    tx_params.ref_set_decomp_m = 3;
+
+    std::vector<std::shared_ptr<mock_tx::MockTxSpSquashedV1>> spent_txs;
+    spent_txs.emplace_back(mock_tx::make_mock_tx<mock_tx::MockTxSpSquashedV1>(tx_params, {2, 2}, {1, 3}, ledger_context));
+    mock_tx::add_tx_to_ledger<mock_tx::MockTxSpSquashedV1>(ledger_context, *spent_txs[0]);
+
+    std::vector<std::shared_ptr<mock_tx::MockTxSpSquashedV1>> txs;
+    txs.emplace_back(mock_tx::make_mock_tx<mock_tx::MockTxSpSquashedV1>(tx_params, {2}, {2}, ledger_context));
+    txs.emplace_back(mock_tx::make_mock_tx<mock_tx::MockTxSpSquashedV1>(tx_params, {3}, {3}, ledger_context));
+
+    ASSERT_TRUE(ledger_context->save(snapshot_path.string()));
+
+    // loaded ledgers (with and without converted squashed enotes) have the same contents
+    std::vector<std::size_t> all_indices;
+    for (std::size_t index{1}; index < ledger_context->get_num_enotes(); ++index)
+        all_indices.push_back(index);
+
+    rct::KeyMatrix squashed_enotes_expected;
+    ledger_context->get_reference_set_components_sp_v2(all_indices, squashed_enotes_expected);
+
+    for (const bool store_converted : {true, false})
+    {
+        std::shared_ptr<mock_tx::MockLedgerContext> loaded_ledger_context{
+                std::make_shared<mock_tx::MockLedgerContext>(0, 0, store_converted)
+            };
+        ASSERT_TRUE(loaded_ledger_context->load(snapshot_path.string()));
+        EXPECT_TRUE(loaded_ledger_context->get_num_enotes() == ledger_context->get_num_enotes());
+
+        rct::KeyMatrix squashed_enotes;
+        loaded_ledger_context->get_reference_set_components_sp_v2(all_indices, squashed_enotes);
+        EXPECT_TRUE(squashed_enotes == squashed_enotes_expected);
+        EXPECT_ANY_THROW(loaded_ledger_context->get_reference_set_components_sp_v2({0}, squashed_enotes));
+
+        for (const auto &input_image : spent_txs[0]->m_input_images)
+            EXPECT_TRUE(loaded_ledger_context->linking_tag_exists_sp_v1(input_image.m_key_image));
+        EXPECT_FALSE(mock_tx::validate_mock_txs<mock_tx::MockTxSpSquashedV1>(spent_txs, loaded_ledger_context));
+        EXPECT_TRUE(mock_tx::validate_mock_txs<mock_tx::MockTxSpSquashedV1>(txs, loaded_ledger_context));
+    }
+
+    // the enote without a squashed enote isn't covered by the state commitment, so this snapshot can't be loaded
+    //   against a checkpoint
+    const rct::key state_commitment{ledger_context->get_state_commitment()};
+    {
+        std::shared_ptr<mock_tx::MockLedgerContext> bootstrapped_ledger_context{
+                std::make_shared<mock_tx::MockLedgerContext>(0, 0, true)
+            };
+        EXPECT_FALSE(bootstrapped_ledger_context->load(snapshot_path.string(), state_commitment));
+        EXPECT_TRUE(bootstrapped_ledger_context->get_num_enotes() == 0);
+    }
+
+    // a compact ledger squashes every enote; bootstrap from its snapshot with a checkpoint's state commitment (only a
+    //   matching commitment is accepted)
+    const std::string compact_snapshot_path{snapshot_path.string() + ".compact"};
+    rct::key compact_state_commitment;
+    {
+        std::shared_ptr<mock_tx::MockLedgerContext> compact_ledger_context{
+                std::make_shared<mock_tx::MockLedgerContext>(0,
+                    0,
+                    true,
+                    mock_tx::MockLedgerStorageMode::SQUASHED_WITH_COMPONENTS)
+            };
+        ASSERT_TRUE(compact_ledger_context->load(snapshot_path.string()));
+        ASSERT_TRUE(compact_ledger_context->save(compact_snapshot_path));
+        compact_state_commitment = compact_ledger_context->get_state_commitment();
+    }
+    {
+        std::shared_ptr<mock_tx::MockLedgerContext> bootstrapped_ledger_context{
+                std::make_shared<mock_tx::MockLedgerContext>(0,
+                    0,
+                    true,
+                    mock_tx::MockLedgerStorageMode::SQUASHED_WITH_COMPONENTS)
+            };
+        EXPECT_FALSE(bootstrapped_ledger_context->load(compact_snapshot_path, rct::zero()));
+        EXPECT_TRUE(bootstrapped_ledger_context->get_num_enotes() == 0);
+        ASSERT_TRUE(bootstrapped_ledger_context->load(compact_snapshot_path, compact_state_commitment));
+        EXPECT_TRUE(bootstrapped_ledger_context->get_state_commitment() == compact_state_commitment);
+        EXPECT_TRUE(mock_tx::validate_mock_txs<mock_tx::MockTxSpSquashedV1>(txs, bootstrapped_ledger_context));
+
+        // new linking tags move the commitment
+        mock_tx::add_tx_to_ledger<mock_tx::MockTxSpSquashedV1>(bootstrapped_ledger_context, *txs[0]);
+        EXPECT_FALSE(bootstrapped_ledger_context->get_state_commitment() == compact_state_commitment);
+    }
+
+    // columns the commitment doesn't cover can't change what a checkpointed load installs
+    {
+        // snapshot layout: 72 byte header, onetime addresses, amount commitments, squashed enotes, converted squashed
+        //   enotes (the encoded amount column is empty in a compact snapshot)
+        const std::size_t num_enotes{ledger_context->get_num_enotes()};
+        const std::streamoff onetime_address_offset{72 + sizeof(rct::key)};
+        const std::streamoff converted_offset{static_cast<std::streamoff>(72 + 3*num_enotes*sizeof(rct::key))};
+
+        // garbage converted squashed enotes are ignored
+        {
+            std::fstream snapshot{compact_snapshot_path, std::ios::binary | std::ios::in | std::ios::out};
+            snapshot.seekp(converted_offset);
+            const std::string zeros(num_enotes*sizeof(ge_p3), '\0');
+            snapshot.write(zeros.data(), zeros.size());
+        }
+        std::shared_ptr<mock_tx::MockLedgerContext> bootstrapped_ledger_context{
+                std::make_shared<mock_tx::MockLedgerContext>(0,
+                    0,
+                    true,
+                    mock_tx::MockLedgerStorageMode::SQUASHED_WITH_COMPONENTS)
+            };
+        ASSERT_TRUE(bootstrapped_ledger_context->load(compact_snapshot_path, compact_state_commitment));
+        EXPECT_TRUE(mock_tx::validate_mock_txs<mock_tx::MockTxSpSquashedV1>(txs, bootstrapped_ledger_context));
+
+        // enote components that don't squash to their squashed enote are refused if the ledger keeps them
+        {
+            std::fstream snapshot{compact_snapshot_path, std::ios::binary | std::ios::in | std::ios::out};
+            snapshot.seekg(onetime_address_offset);
+            const char onetime_address_byte{static_cast<char>(snapshot.get())};
+            snapshot.seekp(onetime_address_offset);
+            snapshot.put(static_cast<char>(~onetime_address_byte));
+        }
+        EXPECT_FALSE(bootstrapped_ledger_context->load(compact_snapshot_path, compact_state_commitment));
+        EXPECT_TRUE(bootstrapped_ledger_context->load(compact_snapshot_path));
+
+        std::shared_ptr<mock_tx::MockLedgerContext> squashed_ledger_context{
+                std::make_shared<mock_tx::MockLedgerContext>(0, 0, true, mock_tx::MockLedgerStorageMode::SQUASHED_ONLY)
+            };
+        EXPECT_TRUE(squashed_ledger_context->load(compact_snapshot_path, compact_state_commitment));
+    }
+    boost::filesystem::remove(compact_snapshot_path);
+
+    // a snapshot whose contents don't match the commitment in its header is rejected
+    {
+        // the last linking tag comes before the view tag and squashed enote flag columns
+        const std::streamoff last_linking_tag_offset{
+                -static_cast<std::streamoff>(2*ledger_context->get_num_enotes() + sizeof(crypto::key_image))
+            };
+        std::fstream snapshot{snapshot_path.string(), std::ios::binary | std::ios::in | std::ios::out};
+        snapshot.seekg(last_linking_tag_offset, std::ios::end);
+        const char linking_tag_byte{static_cast<char>(snapshot.get())};
+        snapshot.seekp(last_linking_tag_offset, std::ios::end);
+        snapshot.put(static_cast<char>(~linking_tag_byte));
+    }
+    EXPECT_FALSE(ledger_context->load(snapshot_path.string()));
+    EXPECT_FALSE(ledger_context->load(snapshot_path.string(), state_commitment));
+    ASSERT_TRUE(ledger_context->save(snapshot_path.string()));
+
+    // a bad snapshot leaves the ledger untouched
+    {
+        std::ofstream snapshot{snapshot_path.string(), std::ios::binary | std::ios::app};
+        snapshot.put(0);
+    }
+    EXPECT_FALSE(ledger_context->load(snapshot_path.string()));
+    EXPECT_FALSE(ledger_context->load(snapshot_path.string() + ".missing"));
+    EXPECT_TRUE(mock_tx::validate_mock_txs<mock_tx::MockTxSpSquashedV1>(txs, ledger_context));
+
+    boost::filesystem::remove(snapshot_path);
+}
+
+TEST(mock_tx, mock_ledger_storage_modes)
+{
+    const boost::filesystem::path snapshot_path{
+            boost::filesystem::temp_directory_path() / boost::filesystem::unique_path()
+        };
+
+    EXPECT_TRUE(mock_tx::MockLedgerContext::get_enote_storage_bytes(mock_tx::MockLedgerStorageMode::FULL, false) ==
+        106);
+    EXPECT_TRUE(mock_tx::MockLedgerContext::get_enote_storage_bytes(
+        mock_tx::MockLedgerStorageMode::SQUASHED_WITH_COMPONENTS, false) == 96);
+    EXPECT_TRUE(mock_tx::MockLedgerContext::get_enote_storage_bytes(mock_tx::MockLedgerStorageMode::SQUASHED_ONLY,
+        false) == 32);
+
+    // full ledger: squashed enotes, and a snapshot where the first enote has no squashed enote
+    std::vector<mock_tx::MockENoteSpV1> enotes(64);
+    for (mock_tx::MockENoteSpV1 &enote : enotes)
+        enote.gen();
+
+    std::shared_ptr<mock_tx::MockLedgerContext> full_ledger_context{std::make_shared<mock_tx::MockLedgerContext>()};
+    full_ledger_context->add_enote_sp_v1(enotes[0]);
+    full_ledger_context->add_enotes_sp_v2({enotes.begin() + 1, enotes.end()}, 1);
+    ASSERT_TRUE(full_ledger_context->save(snapshot_path.string()));
+
+    std::vector<std::size_t> all_indices;
+    for (std::size_t index{0}; index < enotes.size(); ++index)
+        all_indices.push_back(index);
+
+    rct::KeyMatrix squashed_enotes_expected;
+    EXPECT_ANY_THROW(full_ledger_context->get_reference_set_components_sp_v2(all_indices, squashed_enotes_expected));
+
+    std::shared_ptr<mock_tx::MockLedgerContext> squashed_full_ledger_context{
+            std::make_shared<mock_tx::MockLedgerContext>()
+        };
+    squashed_full_ledger_context->add_enotes_sp_v2(enotes, 1);
+    squashed_full_ledger_context->get_reference_set_components_sp_v2(all_indices, squashed_enotes_expected);
+
+    // compact ledgers, built directly and loaded from the full ledger's snapshot, squash every enote
+    for (const mock_tx::MockLedgerStorageMode storage_mode :
+        {mock_tx::MockLedgerStorageMode::SQUASHED_WITH_COMPONENTS, mock_tx::MockLedgerStorageMode::SQUASHED_ONLY})
+    {
+        for (const bool store_converted : {false, true})
+        {
+            std::shared_ptr<mock_tx::MockLedgerContext> built_ledger_context{
+                    std::make_shared<mock_tx::MockLedgerContext>(0, 0, store_converted, storage_mode)
+                };
+            built_ledger_context->add_enote_sp_v1(enotes[0]);
+            built_ledger_context->add_enotes_sp_v2({enotes.begin() + 1, enotes.end()}, 1);
+
+            std::shared_ptr<mock_tx::MockLedgerContext> loaded_ledger_context{
+                    std::make_shared<mock_tx::MockLedgerContext>(0, 0, store_converted, storage_mode)
+                };
+            ASSERT_TRUE(loaded_ledger_context->load(snapshot_path.string()));
+
+            for (const std::shared_ptr<mock_tx::MockLedgerContext> &ledger_context :
+                {built_ledger_context, loaded_ledger_context})
+            {
+                EXPECT_TRUE(ledger_context->get_num_enotes() == enotes.size());
+
+                rct::KeyMatrix squashed_enotes;
+                ledger_context->get_reference_set_components_sp_v2(all_indices, squashed_enotes);
+                EXPECT_TRUE(squashed_enotes == squashed_enotes_expected);
+                EXPECT_ANY_THROW(ledger_context->get_reference_set_components_sp_v2({enotes.size()}, squashed_enotes));
+
+                std::vector<ge_p3> squashed_enote_points;
+                ledger_context->get_reference_set_components_sp_v2_p3(all_indices,
+                    squashed_enotes,
+                    squashed_enote_points);
+                EXPECT_TRUE(squashed_enotes == squashed_enotes_expected);
+
+                std::vector<mock_tx::MockENoteSpV1> enotes_out;
+                EXPECT_ANY_THROW(ledger_context->get_reference_set_sp_v1({0}, enotes_out));
+
+                rct::KeyMatrix enote_components;
+                if (storage_mode == mock_tx::MockLedgerStorageMode::SQUASHED_ONLY)
+                    EXPECT_ANY_THROW(ledger_context->get_reference_set_components_sp_v1({0}, enote_components));
+                else
+                {
+                    ledger_context->get_reference_set_components_sp_v1({0}, enote_components);
+                    EXPECT_TRUE(enote_components[0][0] == enotes[0].m_onetime_address);
+                    EXPECT_TRUE(enote_components[0][1] == enotes[0].m_amount_commitment);
+                }
+            }
+
+            // compact snapshots round trip, but can't be loaded into a ledger that keeps more
+            ASSERT_TRUE(built_ledger_context->save(snapshot_path.string() + ".compact"));
+            EXPECT_TRUE(loaded_ledger_context->load(snapshot_path.string() + ".compact"));
+            EXPECT_TRUE(loaded_ledger_context->get_num_enotes() == enotes.size());
+            EXPECT_FALSE(full_ledger_context->load(snapshot_path.string() + ".compact"));
+            EXPECT_TRUE(full_ledger_context->get_num_enotes() == enotes.size());
+            boost::filesystem::remove(snapshot_path.string() + ".compact");
+        }
+    }
+
+    // the squashed-only ledger is the smallest
+    std::shared_ptr<mock_tx::MockLedgerContext> squashed_ledger_context{
+            std::make_shared<mock_tx::MockLedgerContext>(0, 0, false, mock_tx::MockLedgerStorageMode::SQUASHED_ONLY)
+        };
+    squashed_ledger_context->add_enotes_sp_v2(enotes, 1);
+    EXPECT_TRUE(squashed_ledger_context->get_storage_bytes() < squashed_full_ledger_context->get_storage_bytes());
+
+    boost::filesystem::remove(snapshot_path);
+}
+
+TEST(mock_tx, seraphis_find_invalid_txs)
+{
+    std::shared_ptr<mock_tx::MockLedgerContext> ledger_context = std::make_shared<mock_tx::MockLedgerContext>();
+
+    mock_tx::MockTxParamPack tx_params;
+    tx_params.max_rangeproof_splits = 0;
+    tx_params.ref_set_decomp_n = 2;
+    tx_params.ref_set_decomp_m = 2;
+
+    std::vector<std::shared_ptr<mock_tx::MockTxSpSquashedV1>> txs;
+    for (std::size_t tx_index{0}; tx_index < 9; ++tx_index)
+    {
+        txs.emplace_back(
+                mock_tx::make_mock_tx<mock_tx::MockTxSpSquashedV1>(tx_params, {2}, {1, 1}, ledger_context)
+            );
+    }
+
+    std::vector<std::size_t> invalid_tx_indices;
+    EXPECT_TRUE(mock_tx::validate_mock_txs(txs, ledger_context, invalid_tx_indices));
+    EXPECT_TRUE(invalid_tx_indices.size() == 0);
+
+    // two txs with bad batchable proofs, one that doesn't balance (checked in the batch), one double spend
+    txs[1]->m_balance_proof->m_bpp_proofs[0].r1 = rct::skGen();
+    txs[8]->m_balance_proof->m_bpp_proofs[0].r1 = rct::skGen();
+    txs[6]->m_balance_proof->m_remainder_blinding_factor = rct::skGen();
+    mock_tx::add_tx_to_ledger<mock_tx::MockTxSpSquashedV1>(ledger_context, *txs[4]);
+
+    EXPECT_FALSE(txs[6]->validate(ledger_context));
+    EXPECT_TRUE(txs[6]->validate(ledger_context, true));
+
+    for (const std::size_t num_threads : {1, 3})
+    {
+        EXPECT_FALSE(mock_tx::validate_mock_txs(txs, ledger_context, invalid_tx_indices, num_threads));
+        EXPECT_TRUE(invalid_tx_indices == (std::vector<std::size_t>{1, 4, 6, 8}));
+    }
+}
+
+TEST(mock_tx, seraphis_balance_small_order)
+{
+    std::shared_ptr<mock_tx::MockLedgerContext> ledger_context = std::make_shared<mock_tx::MockLedgerContext>();
+
+    mock_tx::MockTxParamPack tx_params;
+    tx_params.max_rangeproof_splits = 0;
+    tx_params.ref_set_decomp_n = 2;
+    tx_params.ref_set_decomp_m = 2;
+
+    // plain txs don't range proof their input image commitments, so those can carry a small-order component
+    std::shared_ptr<mock_tx::MockTxSpPlainV1> tx{
+            mock_tx::make_mock_tx<mock_tx::MockTxSpPlainV1>(tx_params, {1, 1}, {2}, ledger_context)
+        };
+
+    // the batched balance terms of the tx alone, each call with a fresh random weight
+    const auto batched_balance_passes = [&tx]() -> bool
+    {
+        rct::pippenger_prep_data prep_data;
+        prep_data.cache_size = 0;
+        mock_tx::get_mock_tx_sp_amount_balance_validation_data(tx->m_input_images,
+            tx->m_outputs,
+            tx->m_balance_proof->m_remainder_blinding_factor,
+            prep_data);
+        return rct::pippenger(std::vector<rct::pippenger_prep_data>{std::move(prep_data)}) == rct::identity();
+    };
+
+    // add the order-2 point to one input image: the sum is off by it, and an odd weight would not cancel it
+    rct::key order2_point;
+    memset(order2_point.bytes, 0xff, sizeof(order2_point.bytes));
+    order2_point.bytes[0] = 0xec;
+    order2_point.bytes[31] = 0x7f;
+    tx->m_input_images[0].m_masked_commitment = rct::addKeys(tx->m_input_images[0].m_masked_commitment, order2_point);
+
+    // both checks clear the cofactor, so they agree for every weight
+    EXPECT_TRUE(mock_tx::validate_mock_tx_sp_amount_balance_v1(tx->m_input_images,
+        tx->m_outputs,
+        tx->m_balance_proof,
+        false));
+    for (std::size_t i{0}; i < 16; ++i)
+        EXPECT_TRUE(batched_balance_passes());
+
+    // a difference outside the small-order subgroup still fails both
+    tx->m_input_images[1].m_masked_commitment = rct::addKeys(tx->m_input_images[1].m_masked_commitment, rct::G);
+    EXPECT_FALSE(mock_tx::validate_mock_tx_sp_amount_balance_v1(tx->m_input_images,
+        tx->m_outputs,
+        tx->m_balance_proof,
+        false));
+    EXPECT_FALSE(batched_balance_passes());
+}
+
+TEST(mock_tx, seraphis_batch_verifier)
+{
+    std::shared_ptr<mock_tx::MockLedgerContext> ledger_context = std::make_shared<mock_tx::MockLedgerContext>();
+
+    mock_tx::MockTxParamPack tx_params;
+    tx_params.max_rangeproof_splits = 0;
+    tx_params.ref_set_decomp_n = 2;
+    tx_params.ref_set_decomp_m = 2;
+
+    std::vector<std::shared_ptr<mock_tx::MockTxSpSquashedV1>> txs;
+    for (std::size_t tx_index{0}; tx_index < 7; ++tx_index)
+    {
+        txs.emplace_back(
+                mock_tx::make_mock_tx<mock_tx::MockTxSpSquashedV1>(tx_params, {2}, {1, 1}, ledger_context)
+            );
+    }
+
+    // break the batchable parts of two txs (their unbatchable checks still pass)
+    txs[2]->m_balance_proof->m_bpp_proofs[0].r1 = rct::skGen();
+    txs[5]->m_balance_proof->m_bpp_proofs[0].r1 = rct::skGen();
+
+    // one tx fails its unbatchable checks (double spend)
+    mock_tx::add_tx_to_ledger<mock_tx::MockTxSpSquashedV1>(ledger_context, *txs[6]);
+
+    std::vector<std::shared_ptr<mock_tx::MockTxSpSquashedV1>> valid_txs;
+    std::vector<std::shared_ptr<mock_tx::MockTxSpSquashedV1>> invalid_txs;
+
+    // flush on demand (no point limit, long deadline)
+    mock_tx::MockTxBatchVerifier<mock_tx::MockTxSpSquashedV1> verifier{ledger_context, 0, std::chrono::hours{1}};
+
+    for (std::size_t tx_index{0}; tx_index < 6; ++tx_index)
+        EXPECT_TRUE(verifier.add_tx(txs[tx_index]));
+    EXPECT_FALSE(verifier.add_tx(txs[6]));
+    EXPECT_TRUE(verifier.num_pending_txs() == 6);
+    EXPECT_FALSE(verifier.flush_if_due());
+
+    verifier.flush();
+    EXPECT_TRUE(verifier.num_pending_txs() == 0);
+    verifier.take_verified_txs(valid_txs, invalid_txs);
+    ASSERT_TRUE(valid_txs.size() == 4);
+    ASSERT_TRUE(invalid_txs.size() == 3);
+    EXPECT_TRUE(invalid_txs[0] == txs[6]);
+    EXPECT_TRUE(invalid_txs[1] == txs[2]);
+    EXPECT_TRUE(invalid_txs[2] == txs[5]);
+
+    // flush on point count
+    mock_tx::MockTxBatchVerifier<mock_tx::MockTxSpSquashedV1> verifier_points{ledger_context, 1, std::chrono::hours{1}};
+
+    EXPECT_TRUE(verifier_points.add_tx(txs[0]));
+    EXPECT_TRUE(verifier_points.num_pending_txs() == 0);
+    verifier_points.take_verified_txs(valid_txs, invalid_txs);
+    EXPECT_TRUE(valid_txs.size() == 1);
+    EXPECT_TRUE(invalid_txs.size() == 0);
+
+    // flush on deadline
+    mock_tx::MockTxBatchVerifier<mock_tx::MockTxSpSquashedV1> verifier_deadline{ledger_context,
+        0,
+        std::chrono::milliseconds{0}};
+
+    EXPECT_TRUE(verifier_deadline.add_tx(txs[5]));
+    EXPECT_TRUE(verifier_deadline.num_pending_txs() == 0);
+    verifier_deadline.take_verified_txs(valid_txs, invalid_txs);
+    EXPECT_TRUE(valid_txs.size() == 0);
+    EXPECT_TRUE(invalid_txs.size() == 1);
+
+    // urgent txs are verified on their own while the bulk batch keeps filling
+    std::vector<std::chrono::nanoseconds> bulk_latencies;
+    std::vector<std::chrono::nanoseconds> urgent_latencies;
+    mock_tx::MockTxBatchVerifier<mock_tx::MockTxSpSquashedV1> verifier_lanes{ledger_context, 0, std::chrono::hours{1}};
+
+    EXPECT_TRUE(verifier_lanes.add_tx(txs[0]));
+    EXPECT_TRUE(verifier_lanes.add_tx(txs[1]));
+    EXPECT_TRUE(verifier_lanes.add_tx(txs[2], mock_tx::MockTxVerificationLane::URGENT));
+    EXPECT_TRUE(verifier_lanes.num_pending_txs() == 2);
+    verifier_lanes.take_verified_txs(valid_txs, invalid_txs);
+    EXPECT_TRUE(valid_txs.size() == 0);
+    ASSERT_TRUE(invalid_txs.size() == 1);
+    EXPECT_TRUE(invalid_txs[0] == txs[2]);
+    verifier_lanes.take_lane_latencies(mock_tx::MockTxVerificationLane::URGENT, urgent_latencies);
+    EXPECT_TRUE(urgent_latencies.size() == 1);
+
+    // urgent txs that flush the bulk batch take the pending bulk txs with them
+    verifier_lanes.set_urgent_policy(mock_tx::MockTxUrgentFlushPolicy::FLUSH_BULK);
+    EXPECT_TRUE(verifier_lanes.num_pending_txs() == 2);
+    EXPECT_TRUE(verifier_lanes.add_tx(txs[3], mock_tx::MockTxVerificationLane::URGENT));
+    EXPECT_TRUE(verifier_lanes.num_pending_txs() == 0);
+    verifier_lanes.take_verified_txs(valid_txs, invalid_txs);
+    EXPECT_TRUE(valid_txs.size() == 3);
+    EXPECT_TRUE(invalid_txs.size() == 0);
+    verifier_lanes.take_lane_latencies(mock_tx::MockTxVerificationLane::BULK, bulk_latencies);
+    verifier_lanes.take_lane_latencies(mock_tx::MockTxVerificationLane::URGENT, urgent_latencies);
+    EXPECT_TRUE(bulk_latencies.size() == 2);
+    EXPECT_TRUE(urgent_latencies.size() == 1);
+
+    // a small urgent batch waits for its own point limit
+    verifier_lanes.set_urgent_policy(mock_tx::MockTxUrgentFlushPolicy::OWN_BATCH,
+        std::numeric_limits<std::size_t>::max(),
+        std::chrono::hours{1});
+    EXPECT_TRUE(verifier_lanes.add_tx(txs[0], mock_tx::MockTxVerificationLane::URGENT));
+    EXPECT_TRUE(verifier_lanes.add_tx(txs[1]));
+    EXPECT_TRUE(verifier_lanes.num_pending_txs() == 2);
+    verifier_lanes.flush();
+    verifier_lanes.take_verified_txs(valid_txs, invalid_txs);
+    EXPECT_TRUE(valid_txs.size() == 2);
+    EXPECT_TRUE(valid_txs[0] == txs[0]);
+}
+
+TEST(mock_tx, seraphis_tx_pool)
+{
+    std::shared_ptr<mock_tx::MockLedgerContext> ledger_context = std::make_shared<mock_tx::MockLedgerContext>();
+
+    mock_tx::MockTxParamPack tx_params;
+    tx_params.max_rangeproof_splits = 0;
+    tx_params.ref_set_decomp_n = 2;
+    tx_params.ref_set_decomp_m = 2;
+
+    std::vector<std::shared_ptr<mock_tx::MockTxSpSquashedV1>> txs;
+    for (std::size_t tx_index{0}; tx_index < 5; ++tx_index)
+    {
+        txs.emplace_back(
+                mock_tx::make_mock_tx<mock_tx::MockTxSpSquashedV1>(tx_params, {2}, {1, 1}, ledger_context)
+            );
+    }
+
+    // a tx that spends the same linking tag as txs[0] (e.g. a double spend relayed by another node)
+    std::shared_ptr<mock_tx::MockTxSpSquashedV1> conflicting_tx{std::make_shared<mock_tx::MockTxSpSquashedV1>(*txs[0])};
+    conflicting_tx->m_outputs = txs[1]->m_outputs;
+
+    // txs[2] is already in the ledger, and txs[3] fails batch verification
+    mock_tx::add_tx_to_ledger<mock_tx::MockTxSpSquashedV1>(ledger_context, *txs[2]);
+    txs[3]->m_balance_proof->m_bpp_proofs[0].r1 = rct::skGen();
+
+    // submissions (verified on demand: no point limit, long deadline)
+    mock_tx::MockTxPool<mock_tx::MockTxSpSquashedV1> tx_pool{ledger_context, 0, std::chrono::hours{1}};
+
+    EXPECT_TRUE(tx_pool.submit_tx(txs[0]) == mock_tx::MockTxPoolSubmitResult::PENDING);
+    EXPECT_TRUE(tx_pool.submit_tx(txs[0]) == mock_tx::MockTxPoolSubmitResult::DUPLICATE);
+    EXPECT_TRUE(tx_pool.submit_tx(std::make_shared<mock_tx::MockTxSpSquashedV1>(*txs[0])) ==
+        mock_tx::MockTxPoolSubmitResult::DUPLICATE);
+    EXPECT_TRUE(tx_pool.submit_tx(conflicting_tx) == mock_tx::MockTxPoolSubmitResult::CONFLICT);
+    EXPECT_TRUE(tx_pool.submit_tx(txs[1]) == mock_tx::MockTxPoolSubmitResult::PENDING);
+    EXPECT_TRUE(tx_pool.submit_tx(txs[2]) == mock_tx::MockTxPoolSubmitResult::SPENT);
+    EXPECT_TRUE(tx_pool.submit_tx(txs[3]) == mock_tx::MockTxPoolSubmitResult::PENDING);
+    EXPECT_TRUE(tx_pool.num_txs() == 3);
+
+    // admission
+    EXPECT_TRUE(tx_pool.process_admissions() == 0);
+    EXPECT_TRUE(tx_pool.num_admitted_txs() == 0);
+    EXPECT_TRUE(tx_pool.process_admissions(true) == 3);
+    EXPECT_TRUE(tx_pool.num_txs() == 2);
+
+    std::vector<std::shared_ptr<mock_tx::MockTxSpSquashedV1>> admitted_txs;
+    tx_pool.get_admitted_txs(admitted_txs);
+    ASSERT_TRUE(admitted_txs.size() == 2);
+    EXPECT_TRUE(std::find(admitted_txs.begin(), admitted_txs.end(), txs[0]) != admitted_txs.end());
+    EXPECT_TRUE(std::find(admitted_txs.begin(), admitted_txs.end(), txs[1]) != admitted_txs.end());
+
+    // an invalid tx releases its linking tags
+    EXPECT_TRUE(tx_pool.submit_tx(txs[3]) == mock_tx::MockTxPoolSubmitResult::PENDING);
+    EXPECT_TRUE(tx_pool.process_admissions(true) == 1);
+
+    // including a conflicting tx evicts the pool tx it conflicts with
+    EXPECT_TRUE(tx_pool.add_tx_to_ledger(*conflicting_tx) == 1);
+    EXPECT_TRUE(tx_pool.num_admitted_txs() == 1);
+    EXPECT_TRUE(tx_pool.submit_tx(txs[0]) == mock_tx::MockTxPoolSubmitResult::SPENT);
+
+    // including a pool tx removes it
+    EXPECT_TRUE(tx_pool.add_tx_to_ledger(*txs[1]) == 0);
+    EXPECT_TRUE(tx_pool.num_txs() == 0);
+    EXPECT_ANY_THROW(tx_pool.add_tx_to_ledger(*txs[1]));
+
+    const mock_tx::MockTxPoolStats stats{tx_pool.get_stats()};
+    EXPECT_TRUE(stats.m_submitted == 9);
+    EXPECT_TRUE(stats.m_duplicates == 2);
+    EXPECT_TRUE(stats.m_conflicts == 1);
+    EXPECT_TRUE(stats.m_spent == 2);
+    EXPECT_TRUE(stats.m_invalid == 2);
+    EXPECT_TRUE(stats.m_admitted == 2);
+    EXPECT_TRUE(stats.m_evicted == 1);
+    EXPECT_TRUE(stats.m_included == 1);
+
+    // of a set of conflicting txs submitted at the same time, exactly one gets in
+    std::vector<std::shared_ptr<mock_tx::MockTxSpSquashedV1>> conflicting_txs;
+    for (std::size_t tx_index{0}; tx_index < 8; ++tx_index)
+    {
+        conflicting_txs.emplace_back(std::make_shared<mock_tx::MockTxSpSquashedV1>(*txs[4]));
+        conflicting_txs.back()->m_outputs[0].m_onetime_address = rct::pkGen();
+    }
+
+    std::atomic<std::size_t> num_pending{0};
+    std::vector<std::thread> submitters;
+    for (const std::shared_ptr<mock_tx::MockTxSpSquashedV1> &tx : conflicting_txs)
+    {
+        submitters.emplace_back(
+                [&tx_pool, &num_pending, tx]()
+                {
+                    if (tx_pool.submit_tx(tx) == mock_tx::MockTxPoolSubmitResult::PENDING)
+                        ++num_pending;
+                }
+            );
+    }
+    for (std::thread &submitter : submitters)
+        submitter.join();
+
+    EXPECT_TRUE(num_pending == 1);
+    EXPECT_TRUE(tx_pool.num_txs() == 1);
+    EXPECT_TRUE(tx_pool.get_stats().m_conflicts == 8);
+}
+
+TEST(mock_tx, seraphis_verification_scheduler)
+{
+    std::shared_ptr<mock_tx::MockLedgerContext> ledger_context = std::make_shared<mock_tx::MockLedgerContext>();
+
+    mock_tx::MockTxParamPack tx_params_small;
+    tx_params_small.max_rangeproof_splits = 0;
+    tx_params_small.ref_set_decomp_n = 2;
+    tx_params_small.ref_set_decomp_m = 2;
+
+    mock_tx::MockTxParamPack tx_params_large{tx_params_small};
+    tx_params_large.ref_set_decomp_m = 3;
+
+    // mixed tx set: two squashed decompositions, concise, merge, plain
+    std::vector<std::shared_ptr<mock_tx::MockTx>> txs;
+    txs.emplace_back(mock_tx::make_mock_tx<mock_tx::MockTxSpSquashedV1>(tx_params_small, {2}, {1, 1}, ledger_context));
+    txs.emplace_back(mock_tx::make_mock_tx<mock_tx::MockTxSpConciseV1>(tx_params_small, {2}, {1, 1}, ledger_context));
+    txs.emplace_back(mock_tx::make_mock_tx<mock_tx::MockTxSpSquashedV1>(tx_params_large, {2}, {1, 1}, ledger_context));
+    txs.emplace_back(mock_tx::make_mock_tx<mock_tx::MockTxSpMergeV1>(tx_params_small, {1, 1}, {2}, ledger_context));
+    txs.emplace_back(mock_tx::make_mock_tx<mock_tx::MockTxSpSquashedV1>(tx_params_small, {3}, {2, 1}, ledger_context));
+    txs.emplace_back(mock_tx::make_mock_tx<mock_tx::MockTxSpPlainV1>(tx_params_small, {2}, {1, 1}, ledger_context));
+    txs.emplace_back(mock_tx::make_mock_tx<mock_tx::MockTxSpConciseV1>(tx_params_small, {2}, {1, 1}, ledger_context));
+
+    std::vector<mock_tx::MockTxVerificationGroupReport> group_reports;
+    EXPECT_TRUE(mock_tx::validate_mock_txs_scheduled(txs, ledger_context, group_reports));
+
+    // groups are ordered by family, then decomposition
+    ASSERT_TRUE(group_reports.size() == 5);
+    EXPECT_TRUE(group_reports[0].m_family == mock_tx::MockTxBatchFamily::SP_PLAIN_V1);
+    EXPECT_TRUE(group_reports[1].m_family == mock_tx::MockTxBatchFamily::SP_CONCISE_V1);
+    EXPECT_TRUE(group_reports[1].m_tx_indices == (std::vector<std::size_t>{1, 6}));
+    EXPECT_TRUE(group_reports[2].m_family == mock_tx::MockTxBatchFamily::SP_MERGE_V1);
+    EXPECT_TRUE(group_reports[3].m_family == mock_tx::MockTxBatchFamily::SP_SQUASHED_V1);
+    EXPECT_TRUE(group_reports[3].m_ref_set_decomp_m == 2);
+    EXPECT_TRUE(group_reports[3].m_tx_indices == (std::vector<std::size_t>{0, 4}));
+    EXPECT_TRUE(group_reports[4].m_family == mock_tx::MockTxBatchFamily::SP_SQUASHED_V1);
+    EXPECT_TRUE(group_reports[4].m_ref_set_decomp_m == 3);
+    EXPECT_TRUE(group_reports[4].m_tx_indices == (std::vector<std::size_t>{2}));
+
+    for (const mock_tx::MockTxVerificationGroupReport &report : group_reports)
+    {
+        EXPECT_TRUE(report.m_valid);
+        EXPECT_TRUE(report.m_num_multiexp_points > 0);
+    }
+
+    // a bad batchable proof only fails its own group
+    std::static_pointer_cast<mock_tx::MockTxSpConciseV1>(txs[6])->m_balance_proof->m_bpp_proofs[0].r1 = rct::skGen();
+
+    EXPECT_FALSE(mock_tx::validate_mock_txs_scheduled(txs, ledger_context, group_reports, 1));
+    ASSERT_TRUE(group_reports.size() == 5);
+
+    for (std::size_t group_index{0}; group_index < group_reports.size(); ++group_index)
+        EXPECT_TRUE(group_reports[group_index].m_valid == (group_index != 1));
+
+    // empty tx set
+    txs.clear();
+    EXPECT_TRUE(mock_tx::validate_mock_txs_scheduled(txs, ledger_context, group_reports));
+    EXPECT_TRUE(group_reports.size() == 0);
+}
+
+template <typename MockTxType>
+static void test_mock_tx_blob_round_trip(const std::size_t num_rangeproof_splits)
+{
+    std::shared_ptr<mock_tx::MockLedgerContext> ledger_context = std::make_shared<mock_tx::MockLedgerContext>();
+
+    mock_tx::MockTxParamPack tx_params;
+    tx_params.max_rangeproof_splits = num_rangeproof_splits;
+    tx_params.ref_set_decomp_n = 2;
+    tx_params.ref_set_decomp_m = 2;
+
+    std::shared_ptr<MockTxType> tx{
+            mock_tx::make_mock_tx<MockTxType>(tx_params, {3, 2}, {1, 1, 3}, ledger_context)
+        };
+
+    std::string tx_blob;
+    tx->get_tx_byte_blob(tx_blob);
+    EXPECT_FALSE(tx_blob.empty());
+
+    // parse, reserialize, validate
+    std::shared_ptr<MockTxType> parsed_tx;
+    ASSERT_NO_THROW(parsed_tx = std::make_shared<MockTxType>(tx_blob));
+
+    std::string parsed_tx_blob;
+    parsed_tx->get_tx_byte_blob(parsed_tx_blob);
+    EXPECT_TRUE(parsed_tx_blob == tx_blob);
+    EXPECT_TRUE(parsed_tx->get_size_bytes() == tx->get_size_bytes());
+    EXPECT_TRUE(mock_tx::validate_mock_txs<MockTxType>({parsed_tx}, ledger_context));
+
+    // truncated and padded blobs don't parse
+    EXPECT_ANY_THROW(MockTxType{tx_blob.substr(0, tx_blob.size() - 1)});
+    EXPECT_ANY_THROW(MockTxType{tx_blob + '\0'});
+}
+
+TEST(mock_tx, seraphis_tx_blob_round_trip)
+{
+    test_mock_tx_blob_round_trip<mock_tx::MockTxSpConciseV1>(0);
+    test_mock_tx_blob_round_trip<mock_tx::MockTxSpMergeV1>(0);
+    test_mock_tx_blob_round_trip<mock_tx::MockTxSpPlainV1>(0);
+    test_mock_tx_blob_round_trip<mock_tx::MockTxSpSquashedV1>(0);
+    test_mock_tx_blob_round_trip<mock_tx::MockTxSpSquashedV1>(2);
+}
+
+TEST(mock_tx, seraphis_squashed_tx_views)
+{
+    std::shared_ptr<mock_tx::MockLedgerContext> ledger_context = std::make_shared<mock_tx::MockLedgerContext>();
+
+    mock_tx::MockTxParamPack tx_params;
+    tx_params.max_rangeproof_splits = 0;
+    tx_params.ref_set_decomp_n = 2;
+    tx_params.ref_set_decomp_m = 2;
+
+    // back-to-back tx blobs (e.g. a block's txs)
+    std::vector<std::shared_ptr<mock_tx::MockTxSpSquashedV1>> txs;
+    std::string txs_blob;
+    std::string tx_blob;
+    for (std::size_t tx_index{0}; tx_index < 4; ++tx_index)
+    {
+        txs.emplace_back(
+                mock_tx::make_mock_tx<mock_tx::MockTxSpSquashedV1>(tx_params, {3, 2}, {1, 1, 3}, ledger_context)
+            );
+        txs.back()->get_tx_byte_blob(tx_blob);
+        txs_blob += tx_blob;
+    }
+
+    std::vector<mock_tx::MockTxSpSquashedV1View> tx_views;
+    ASSERT_NO_THROW(tx_views = mock_tx::get_mock_tx_sp_squashed_v1_views(epee::strspan<std::uint8_t>(txs_blob)));
+    ASSERT_TRUE(tx_views.size() == txs.size());
+
+    // input images and outputs are read in place
+    for (std::size_t tx_index{0}; tx_index < txs.size(); ++tx_index)
+    {
+        const mock_tx::MockTxSpSquashedV1View &tx_view{tx_views[tx_index]};
+        ASSERT_TRUE(tx_view.m_input_images.size() == txs[tx_index]->m_input_images.size());
+        ASSERT_TRUE(tx_view.m_outputs.size() == txs[tx_index]->m_outputs.size());
+        EXPECT_TRUE(reinterpret_cast<const char*>(tx_view.m_outputs.data()) >= txs_blob.data() &&
+            reinterpret_cast<const char*>(tx_view.m_outputs.end()) <= txs_blob.data() + txs_blob.size());
+        EXPECT_TRUE(tx_view.m_input_images[0].m_key_image == txs[tx_index]->m_input_images[0].m_key_image);
+        EXPECT_TRUE(tx_view.m_outputs[1].m_amount_commitment == txs[tx_index]->m_outputs[1].m_amount_commitment);
+        EXPECT_TRUE(tx_view.validate(ledger_context));
+    }
+
+    for (const std::size_t num_threads : {1, 2})
+        EXPECT_TRUE(mock_tx::validate_mock_tx_views(tx_views, ledger_context, num_threads));
+
+    // a changed output breaks its range proof (the commitment is restored from the blob)
+    std::string bad_tx_blob;
+    txs[0]->get_tx_byte_blob(bad_tx_blob);
+    const std::size_t output_commitment_offset{3 + 1 + 2*sizeof(mock_tx::MockENoteImageSpV1View) + 1 + sizeof(rct::key)};
+    memcpy(&bad_tx_blob[output_commitment_offset], rct::pkGen().bytes, sizeof(rct::key));
+
+    epee::span<const std::uint8_t> bad_tx_blob_span{epee::strspan<std::uint8_t>(bad_tx_blob)};
+    const mock_tx::MockTxSpSquashedV1View bad_tx_view{bad_tx_blob_span};
+    EXPECT_TRUE(bad_tx_blob_span.empty());
+    EXPECT_FALSE(bad_tx_view.validate(ledger_context));
+
+    // truncated blobs don't parse
+    EXPECT_ANY_THROW(mock_tx::get_mock_tx_sp_squashed_v1_views(
+            epee::strspan<std::uint8_t>(txs_blob.substr(0, txs_blob.size() - 1))
+        ));
+}
+
+TEST(mock_tx, ledger_enote_index_encoding)
+{
+    // runs of consecutive indices
+    std::vector<mock_tx::LedgerIndexRange> ranges;
+    mock_tx::get_ledger_index_ranges({3, 4, 5, 9, 9, 10}, ranges);
+    ASSERT_TRUE(ranges.size() == 3);
+    EXPECT_TRUE(ranges[0].m_first == 3 && ranges[0].m_count == 3);
+    EXPECT_TRUE(ranges[1].m_first == 9 && ranges[1].m_count == 1);
+    EXPECT_TRUE(ranges[2].m_first == 9 && ranges[2].m_count == 2);
+    mock_tx::get_ledger_index_ranges({}, ranges);
+    EXPECT_TRUE(ranges.empty());
+
+    // delta varints: a clustered ref set deep in the ledger costs about a byte per index
+    mock_tx::MockMembershipProofSpV1 proof;
+    proof.m_ref_set_decomp_n = 2;
+    proof.m_ref_set_decomp_m = 7;
+
+    std::string proof_blob;
+    ASSERT_TRUE(serialization::dump_binary(proof, proof_blob));
+    const std::size_t proof_blob_size_without_indices{proof_blob.size()};
+
+    for (std::size_t i{0}; i < 128; ++i)
+        proof.m_ledger_enote_indices.push_back(100000000 + 3*i);
+    ASSERT_TRUE(serialization::dump_binary(proof, proof_blob));
+    // count: +1 byte; first index: 4 bytes; differences: 1 byte each
+    EXPECT_TRUE(proof_blob.size() - proof_blob_size_without_indices == 1 + 4 + 127);
+
+    mock_tx::MockMembershipProofSpV1 parsed_proof;
+    ASSERT_TRUE(serialization::parse_binary(proof_blob, parsed_proof));
+    EXPECT_TRUE(parsed_proof.m_ledger_enote_indices == proof.m_ledger_enote_indices);
+
+    // unsorted indices still round-trip
+    proof.m_ledger_enote_indices = {7, 2, std::numeric_limits<std::size_t>::max(), 0};
+    ASSERT_TRUE(serialization::dump_binary(proof, proof_blob));
+    ASSERT_TRUE(serialization::parse_binary(proof_blob, parsed_proof));
+    EXPECT_TRUE(parsed_proof.m_ledger_enote_indices == proof.m_ledger_enote_indices);
+}
+
+template <typename MockTxType>
+static void run_mock_tx_test_shared_ref_set()
+{
+    std::shared_ptr<mock_tx::MockLedgerContext> ledger_context{std::make_shared<mock_tx::MockLedgerContext>()};
+
+    mock_tx::MockTxParamPack tx_params;
+    tx_params.max_rangeproof_splits = 0;
+    tx_params.ref_set_decomp_n = 2;
+    tx_params.ref_set_decomp_m = 2;
+    tx_params.shared_ref_set = true;
+
+    // all inputs of a tx reference the same ledger enotes, with distinct real spends
+    std::vector<std::shared_ptr<MockTxType>> txs;
+    txs.emplace_back(mock_tx::make_mock_tx<MockTxType>(tx_params, {1, 1, 1, 1}, {2, 2}, ledger_context));
+    txs.emplace_back(mock_tx::make_mock_tx<MockTxType>(tx_params, {2, 2}, {1, 3}, ledger_context));
+
+    for (const auto &tx : txs)
+    {
+        for (const auto &membership_proof : tx->m_membership_proofs)
+            EXPECT_TRUE(membership_proof.m_ledger_enote_indices == tx->m_membership_proofs[0].m_ledger_enote_indices);
+
+        EXPECT_TRUE(tx->validate(ledger_context));
+    }
+    EXPECT_TRUE(mock_tx::validate_mock_txs<MockTxType>(txs, ledger_context));
+
+    // a shared 2^2 ref set can't hold 5 real spends
+    EXPECT_ANY_THROW(mock_tx::make_mock_tx<MockTxType>(tx_params, {1, 1, 1, 1, 1}, {5}, ledger_context));
+}
+
+TEST(mock_tx, seraphis_shared_ref_sets)
+{
+    run_mock_tx_test_shared_ref_set<mock_tx::MockTxSpConciseV1>();
+    run_mock_tx_test_shared_ref_set<mock_tx::MockTxSpMergeV1>();
+    run_mock_tx_test_shared_ref_set<mock_tx::MockTxSpPlainV1>();
+}
+
+TEST(mock_tx, seraphis_binned_ref_sets)
+{
+    const boost::filesystem::path db_path{
+            boost::filesystem::temp_directory_path() / boost::filesystem::unique_path()
+        };
+    ASSERT_TRUE(boost::filesystem::create_directory(db_path));
+
+    {
+        const std::vector<std::shared_ptr<mock_tx::LedgerContext>> ledger_contexts{
+                std::make_shared<mock_tx::MockLedgerContext>(),
+                std::make_shared<mock_tx::MockLedgerContextLMDB>(db_path.string(), std::size_t{1} << 26)
+            };
+
+        mock_tx::MockTxParamPack tx_params;
+        tx_params.max_rangeproof_splits = 0;
+        tx_params.ref_set_decomp_n = 2;
+        tx_params.ref_set_decomp_m = 4;
+        tx_params.ref_set_bin_size = 4;
+
+        for (const auto &ledger_context : ledger_contexts)
+        {
+            std::vector<std::shared_ptr<mock_tx::MockTxSpSquashedV1>> txs;
+            txs.emplace_back(
+                    mock_tx::make_mock_tx<mock_tx::MockTxSpSquashedV1>(tx_params, {2, 2}, {1, 3}, ledger_context)
+                );
+            EXPECT_TRUE(mock_tx::validate_mock_txs<mock_tx::MockTxSpSquashedV1>(txs, ledger_context));
+
+            for (const auto &membership_proof : txs[0]->m_membership_proofs)
+            {
+                // 16 ref set members: 4 bins of 4 consecutive enotes, with gaps between them
+                std::vector<mock_tx::LedgerIndexRange> ranges;
+                mock_tx::get_ledger_index_ranges(membership_proof.m_ledger_enote_indices, ranges);
+                ASSERT_TRUE(ranges.size() == 4);
+
+                for (std::size_t bin_index{0}; bin_index < ranges.size(); ++bin_index)
+                {
+                    EXPECT_TRUE(ranges[bin_index].m_count == 4);
+                    if (bin_index > 0)
+                    {
+                        EXPECT_TRUE(ranges[bin_index].m_first >
+                            ranges[bin_index - 1].m_first + ranges[bin_index - 1].m_count);
+                    }
+                }
+
+                // range lookups match index lookups
+                rct::KeyMatrix components_by_index;
+                rct::KeyMatrix components_by_range;
+                ledger_context->get_reference_set_components_sp_v2(membership_proof.m_ledger_enote_indices,
+                    components_by_index);
+                ledger_context->get_reference_set_components_sp_v2_ranges(epee::to_span(ranges), components_by_range);
+                EXPECT_TRUE(components_by_range == components_by_index);
+
+                // runs that go past the end of the ledger
+                ranges.back().m_count = std::numeric_limits<std::size_t>::max();
+                EXPECT_ANY_THROW(ledger_context->get_reference_set_components_sp_v2_ranges(epee::to_span(ranges),
+                    components_by_range));
+            }
+
+            // no ranges
+            rct::KeyMatrix components;
+            ledger_context->get_reference_set_components_sp_v2_ranges(nullptr, components);
+            EXPECT_TRUE(components.empty());
+        }
+    }
+
+    boost::filesystem::remove_all(db_path);
+}
+
+TEST(mock_tx, linking_tag_set)
+{
+    mock_tx::LinkingTagSet linking_tag_set;
+    std::vector<bool> exist;
+
+    // empty set
+    const crypto::key_image zero_tag{};
+    EXPECT_FALSE(linking_tag_set.contains(zero_tag));
+    EXPECT_FALSE(linking_tag_set.contains(rct::rct2ki(rct::pkGen())));
+    linking_tag_set.contains_batch(nullptr, exist);
+    EXPECT_TRUE(exist.empty());
+
+    // inserts that grow the set one at a time, and in batches
+    std::vector<crypto::key_image> linking_tags;
+    for (std::size_t i{0}; i < 1000; ++i)
+        linking_tags.push_back(rct::rct2ki(rct::pkGen()));
+
+    for (std::size_t i{0}; i < 100; ++i)
+        EXPECT_TRUE(linking_tag_set.insert(linking_tags[i]));
+    EXPECT_TRUE(linking_tag_set.insert_batch({linking_tags.data() + 100, 900}) == 900);
+    EXPECT_TRUE(linking_tag_set.size() == 1000);
+
+    // repeats are not inserted again (including repeats within a batch)
+    EXPECT_FALSE(linking_tag_set.insert(linking_tags[500]));
+    EXPECT_TRUE(linking_tag_set.insert_batch({linking_tags.data(), 10}) == 0);
+
+    std::vector<crypto::key_image> new_tags{rct::rct2ki(rct::pkGen()), zero_tag, zero_tag};
+    new_tags.push_back(new_tags[0]);
+    EXPECT_TRUE(linking_tag_set.insert_batch(epee::to_span(new_tags)) == 2);
+    EXPECT_TRUE(linking_tag_set.size() == 1002);
+
+    // lookups
+    linking_tags.push_back(zero_tag);
+    linking_tags.push_back(rct::rct2ki(rct::pkGen()));
+    linking_tag_set.contains_batch(epee::to_span(linking_tags), exist);
+    ASSERT_TRUE(exist.size() == linking_tags.size());
+
+    for (std::size_t i{0}; i < linking_tags.size(); ++i)
+    {
+        EXPECT_TRUE(exist[i] == (i + 1 < linking_tags.size()));
+        EXPECT_TRUE(linking_tag_set.contains(linking_tags[i]) == exist[i]);
+    }
+
+    // ledger tx adds are all or nothing
+    std::shared_ptr<mock_tx::MockLedgerContext> ledger_context{std::make_shared<mock_tx::MockLedgerContext>()};
+    mock_tx::MockTxParamPack tx_params;
+    tx_params.max_rangeproof_splits = 0;
+    tx_params.ref_set_decomp_n = 2;
+    tx_params.ref_set_decomp_m = 2;
+
+    std::shared_ptr<mock_tx::MockTxSpSquashedV1> tx{
+            mock_tx::make_mock_tx<mock_tx::MockTxSpSquashedV1>(tx_params, {2, 2}, {1, 3}, ledger_context)
+        };
+    ledger_context->add_transaction_sp_squashed_v1(*tx);
+    const std::size_t num_enotes{ledger_context->add_enote_sp_v1(tx->m_outputs[0]) + 1};
+
+    tx->m_input_images[0].m_key_image = rct::rct2ki(rct::pkGen());
+    EXPECT_ANY_THROW(ledger_context->add_transaction_sp_squashed_v1(*tx));
+    EXPECT_FALSE(ledger_context->linking_tag_exists_sp_v1(tx->m_input_images[0].m_key_image));
+    EXPECT_TRUE(ledger_context->add_enote_sp_v1(tx->m_outputs[0]) == num_enotes);
+
+    tx->m_input_images[1].m_key_image = tx->m_input_images[0].m_key_image;
+    EXPECT_ANY_THROW(ledger_context->add_transaction_sp_squashed_v1(*tx));
+    EXPECT_FALSE(ledger_context->linking_tag_exists_sp_v1(tx->m_input_images[0].m_key_image));
+}
+
+TEST(mock_tx, seraphis_batch_squashed_enotes)
+{
+    // sizes around the batch group size, so groups are full, partial, and empty
+    for (const std::size_t num_enotes : {0, 1, 63, 64, 65, 150})
+    {
+        std::vector<mock_tx::MockENoteSpV1> enotes(num_enotes);
+        for (mock_tx::MockENoteSpV1 &enote : enotes)
+            enote.gen();
+
+        for (const std::size_t num_threads : {1, 4})
+        {
+            rct::keyV squashed_enotes;
+            mock_tx::make_squashed_enotes_sp_v1(enotes, squashed_enotes, num_threads);
+            ASSERT_TRUE(squashed_enotes.size() == enotes.size());
+
+            for (std::size_t i{0}; i < enotes.size(); ++i)
+            {
+                rct::key squashed_enote;
+                mock_tx::seraphis_squashed_enote_Q(enotes[i].m_onetime_address,
+                    enotes[i].m_amount_commitment,
+                    squashed_enote);
+                EXPECT_TRUE(squashed_enotes[i] == squashed_enote);
+            }
+        }
+    }
+
+    // mismatched inputs
+    rct::keyV squashed_enotes;
+    EXPECT_ANY_THROW(mock_tx::seraphis_squashed_enotes_Q({rct::pkGen()}, {}, squashed_enotes));
+
+    // bad points
+    rct::key bad_point{rct::identity()};
+    ge_p3 temp_p3;
+    while (ge_frombytes_vartime(&temp_p3, bad_point.bytes) == 0)
+        ++bad_point.bytes[0];
+
+    EXPECT_ANY_THROW(mock_tx::seraphis_squashed_enotes_Q({bad_point}, {rct::pkGen()}, squashed_enotes));
+    EXPECT_ANY_THROW(mock_tx::seraphis_squashed_enotes_Q({rct::pkGen()}, {bad_point}, squashed_enotes));
+}
+
+TEST(mock_tx, ledger_bulk_enote_adds)
+{
+    const boost::filesystem::path db_path{
+            boost::filesystem::temp_directory_path() / boost::filesystem::unique_path()
+        };
+    ASSERT_TRUE(boost::filesystem::create_directory(db_path));
+
+    {
+        const std::vector<std::shared_ptr<mock_tx::LedgerContext>> ledger_contexts{
+                std::make_shared<mock_tx::MockLedgerContext>(),
+                std::make_shared<mock_tx::MockLedgerContextLMDB>(db_path.string(), std::size_t{1} << 26)
+            };
+
+        std::vector<mock_tx::MockENoteSpV1> enotes(50);
+        for (mock_tx::MockENoteSpV1 &enote : enotes)
+            enote.gen();
+
+        for (const auto &ledger_context : ledger_contexts)
+        {
+            // bulk adds land at consecutive indices after any earlier enotes
+            EXPECT_TRUE(ledger_context->add_enote_sp_v2(enotes[0]) == 0);
+            EXPECT_TRUE(ledger_context->add_enotes_sp_v2(enotes, 4) == 1);
+            EXPECT_TRUE(ledger_context->add_enotes_sp_v1(enotes) == 1 + enotes.size());
+            EXPECT_TRUE(ledger_context->add_enotes_sp_v2({}, 4) == 1 + 2*enotes.size());
+
+            // squashed enotes match the ones added one at a time
+            std::vector<std::size_t> indices;
+            for (std::size_t i{0}; i < enotes.size(); ++i)
+                indices.push_back(1 + i);
+
+            rct::KeyMatrix squashed_enotes;
+            ledger_context->get_reference_set_components_sp_v2(indices, squashed_enotes);
+            ASSERT_TRUE(squashed_enotes.rows() == enotes.size());
+
+            for (std::size_t i{0}; i < enotes.size(); ++i)
+            {
+                rct::key squashed_enote;
+                mock_tx::seraphis_squashed_enote_Q(enotes[i].m_onetime_address,
+                    enotes[i].m_amount_commitment,
+                    squashed_enote);
+                EXPECT_TRUE(squashed_enotes[i][0] == squashed_enote);
+            }
+
+            // v1 enotes have no squashed enotes
+            EXPECT_ANY_THROW(ledger_context->get_reference_set_components_sp_v2({1 + enotes.size()}, squashed_enotes));
+
+            // txs whose ref sets were made in parallel
+            mock_tx::MockTxParamPack tx_params;
+            tx_params.max_rangeproof_splits = 0;
+            tx_params.ref_set_decomp_n = 2;
+            tx_params.ref_set_decomp_m = 5;
+            tx_params.ref_set_bin_size = 8;
+            tx_params.num_threads = 4;
+
+            std::vector<std::shared_ptr<mock_tx::MockTxSpSquashedV1>> txs;
+            txs.emplace_back(
+                    mock_tx::make_mock_tx<mock_tx::MockTxSpSquashedV1>(tx_params, {2, 2}, {1, 3}, ledger_context)
+                );
+            EXPECT_TRUE(mock_tx::validate_mock_txs<mock_tx::MockTxSpSquashedV1>(txs, ledger_context));
+
+            std::shared_ptr<mock_tx::MockTxSpConciseV1> concise_tx{
+                    mock_tx::make_mock_tx<mock_tx::MockTxSpConciseV1>(tx_params, {2, 2}, {1, 3}, ledger_context)
+                };
+            EXPECT_TRUE(concise_tx->validate(ledger_context));
+        }
+    }
+
+    boost::filesystem::remove_all(db_path);
+}
+
+TEST(mock_tx, seraphis_gamma_decoys)
+{
+    // picks are unlocked and mostly recent (median age: ~1.6 days, ~1300 blocks)
+    mock_tx::MockGammaDecoySelector decoy_selector{1000000};
+    EXPECT_TRUE(decoy_selector.get_num_unlocked_enotes() ==
+        1000000 - 10*mock_tx::MockGammaDecoySelector::DEFAULT_ENOTES_PER_BLOCK);
+
+    std::vector<std::size_t> decoys;
+    decoy_selector.pick_distinct(1001, decoys);
+    ASSERT_TRUE(decoys.size() == 1001);
+    EXPECT_TRUE(std::adjacent_find(decoys.begin(), decoys.end()) == decoys.end());
+    EXPECT_TRUE(decoys.back() < decoy_selector.get_num_unlocked_enotes());
+
+    const std::size_t median_age{decoy_selector.get_num_unlocked_enotes() - decoys[500]};
+    EXPECT_TRUE(median_age > 5000 && median_age < 500000);
+
+    // too small a chain
+    EXPECT_ANY_THROW(mock_tx::MockGammaDecoySelector{10*mock_tx::MockGammaDecoySelector::DEFAULT_ENOTES_PER_BLOCK});
+    EXPECT_ANY_THROW(mock_tx::MockGammaDecoySelector{4000}.pick_distinct(4000, decoys));
+
+    // txs whose decoys are picked from a pre-populated ledger
+    std::shared_ptr<mock_tx::MockLedgerContext> ledger_context{std::make_shared<mock_tx::MockLedgerContext>()};
+
+    std::vector<mock_tx::MockENoteSpV1> ledger_enotes(4000);
+    for (mock_tx::MockENoteSpV1 &enote : ledger_enotes)
+        enote.gen();
+    ledger_context->add_enotes_sp_v2(ledger_enotes, 4);
+
+    mock_tx::MockTxParamPack tx_params;
+    tx_params.max_rangeproof_splits = 0;
+    tx_params.ref_set_decomp_n = 2;
+    tx_params.ref_set_decomp_m = 3;
+    tx_params.ref_set_gamma_decoy_enotes = ledger_enotes.size();
+
+    std::vector<std::shared_ptr<mock_tx::MockTxSpSquashedV1>> txs;
+    for (std::size_t tx_index{0}; tx_index < 2; ++tx_index)
+    {
+        txs.emplace_back(
+                mock_tx::make_mock_tx<mock_tx::MockTxSpSquashedV1>(tx_params, {2, 2}, {1, 3}, ledger_context)
+            );
+    }
+    EXPECT_TRUE(mock_tx::validate_mock_txs<mock_tx::MockTxSpSquashedV1>(txs, ledger_context));
+
+    for (const auto &tx : txs)
+    {
+        for (const auto &membership_proof : tx->m_membership_proofs)
+        {
+            // decoys from the pre-populated enotes, then the real spend
+            const std::vector<std::size_t> &indices{membership_proof.m_ledger_enote_indices};
+            ASSERT_TRUE(indices.size() == 8);
+            EXPECT_TRUE(std::is_sorted(indices.begin(), indices.end()));
+            EXPECT_TRUE(indices[6] < ledger_enotes.size());
+            EXPECT_TRUE(indices[7] >= ledger_enotes.size());
+        }
+    }
+}
+
+TEST(mock_tx, verification_cost_estimates)
+{
+    std::shared_ptr<mock_tx::MockLedgerContext> ledger_context = std::make_shared<mock_tx::MockLedgerContext>();
+    const mock_tx::MockTxVerificationCostModel cost_model;
+
+    mock_tx::MockTxParamPack tx_params_small;
+    tx_params_small.max_rangeproof_splits = 0;
+    tx_params_small.ref_set_decomp_n = 2;
+    tx_params_small.ref_set_decomp_m = 2;
+
+    mock_tx::MockTxParamPack tx_params_large{tx_params_small};
+    tx_params_large.ref_set_decomp_m = 4;
+
+    // more inputs, outputs, or ref set members cost more
+    const mock_tx::MockTxVerificationOps base_ops{
+            mock_tx::make_mock_tx<mock_tx::MockTxSpSquashedV1>(tx_params_small, {2}, {1, 1}, ledger_context)
+                ->estimate_verification_ops()
+        };
+    const mock_tx::MockTxVerificationOps more_inputs_ops{
+            mock_tx::make_mock_tx<mock_tx::MockTxSpSquashedV1>(tx_params_small, {1, 1, 2}, {2, 2}, ledger_context)
+                ->estimate_verification_ops()
+        };
+    const mock_tx::MockTxVerificationOps more_outputs_ops{
+            mock_tx::make_mock_tx<mock_tx::MockTxSpSquashedV1>(tx_params_small, {4}, {1, 1, 1, 1}, ledger_context)
+                ->estimate_verification_ops()
+        };
+    const mock_tx::MockTxVerificationOps larger_ref_set_ops{
+            mock_tx::make_mock_tx<mock_tx::MockTxSpSquashedV1>(tx_params_large, {2}, {1, 1}, ledger_context)
+                ->estimate_verification_ops()
+        };
+
+    EXPECT_TRUE(cost_model.estimate_ns(base_ops) > 0);
+    EXPECT_TRUE(cost_model.estimate_ns(more_inputs_ops) > cost_model.estimate_ns(base_ops));
+    EXPECT_TRUE(cost_model.estimate_ns(more_outputs_ops) > cost_model.estimate_ns(base_ops));
+    EXPECT_TRUE(cost_model.estimate_ns(larger_ref_set_ops) > cost_model.estimate_ns(base_ops));
+    EXPECT_TRUE(larger_ref_set_ops.m_multiexp_points > base_ops.m_multiexp_points);
+
+    // a merged composition proof is cheaper than one proof per input
+    const mock_tx::MockTxVerificationOps concise_ops{
+            mock_tx::make_mock_tx<mock_tx::MockTxSpConciseV1>(tx_params_small, {1, 1, 2}, {2, 2}, ledger_context)
+                ->estimate_verification_ops()
+        };
+    const mock_tx::MockTxVerificationOps merge_ops{
+            mock_tx::make_mock_tx<mock_tx::MockTxSpMergeV1>(tx_params_small, {1, 1, 2}, {2, 2}, ledger_context)
+                ->estimate_verification_ops()
+        };
+    EXPECT_TRUE(cost_model.estimate_ns(merge_ops) < cost_model.estimate_ns(concise_ops));
+
+    // CLSAG cost is linear in the ring size
+    const mock_tx::MockTxVerificationOps clsag_ops{
+            mock_tx::make_mock_tx<mock_tx::MockTxCLSAG>(tx_params_small, {2}, {1, 1}, ledger_context)
+                ->estimate_verification_ops()
+        };
+    const mock_tx::MockTxVerificationOps clsag_large_ops{
+            mock_tx::make_mock_tx<mock_tx::MockTxCLSAG>(tx_params_large, {2}, {1, 1}, ledger_context)
+                ->estimate_verification_ops()
+        };
+    EXPECT_TRUE(clsag_large_ops.m_multiexp_points - clsag_ops.m_multiexp_points ==
+        mock_tx::get_clsag_verification_ops(16).m_multiexp_points -
+        mock_tx::get_clsag_verification_ops(4).m_multiexp_points);
+}
+//-------------------------------------------------------------------------------------------------------------------
+TEST(mock_tx, validation_phase_timers)
+{
+    std::shared_ptr<mock_tx::MockLedgerContext> ledger_context = std::make_shared<mock_tx::MockLedgerContext>();
+
+    mock_tx::MockTxParamPack tx_params;
+    tx_params.max_rangeproof_splits = 0;
+    tx_params.ref_set_decomp_n = 2;
+    tx_params.ref_set_decomp_m = 2;
+
+    std::vector<std::shared_ptr<mock_tx::MockTxSpSquashedV1>> txs;
+    txs.emplace_back(mock_tx::make_mock_tx<mock_tx::MockTxSpSquashedV1>(tx_params, {2}, {1, 1}, ledger_context));
+
+    // timings only count calls made since the last reset
+    mock_tx::reset_mock_tx_phase_timings();
+    const mock_tx::MockTxPhaseTimings reset_timings{mock_tx::get_mock_tx_phase_timings()};
+    for (std::size_t phase_index{0}; phase_index < reset_timings.m_calls.size(); ++phase_index)
+    {
+        EXPECT_TRUE(reset_timings.m_calls[phase_index] == 0);
+        EXPECT_TRUE(reset_timings.m_ns[phase_index] == 0);
+    }
+
+    EXPECT_TRUE(mock_tx::validate_mock_txs<mock_tx::MockTxSpSquashedV1>(txs, ledger_context, 1));
+
+    // with timers compiled in, every phase of batched squashed Seraphis validation is timed; otherwise none is
+    // - the proving phases come after the validation phases
+    const std::size_t first_proving_phase{static_cast<std::size_t>(mock_tx::MockTxValidationPhase::REF_SET_BUILD)};
+    const mock_tx::MockTxPhaseTimings timings{mock_tx::get_mock_tx_phase_timings()};
+    for (std::size_t phase_index{0}; phase_index < timings.m_calls.size(); ++phase_index)
+    {
+        const mock_tx::MockTxValidationPhase phase{static_cast<mock_tx::MockTxValidationPhase>(phase_index)};
+        EXPECT_TRUE(std::string{mock_tx::get_mock_tx_phase_name(phase)} != "unknown");
+        EXPECT_TRUE((timings.m_calls[phase_index] > 0) ==
+            (mock_tx::mock_tx_phase_timers_enabled() && phase_index < first_proving_phase));
+    }
+
+    // likewise, making a squashed Seraphis tx times every proving phase
+    mock_tx::reset_mock_tx_phase_timings();
+    txs.emplace_back(mock_tx::make_mock_tx<mock_tx::MockTxSpSquashedV1>(tx_params, {2}, {1, 1}, ledger_context));
+
+    const mock_tx::MockTxPhaseTimings proving_timings{mock_tx::get_mock_tx_phase_timings()};
+    for (std::size_t phase_index{first_proving_phase}; phase_index < proving_timings.m_calls.size(); ++phase_index)
+        EXPECT_TRUE((proving_timings.m_calls[phase_index] > 0) == mock_tx::mock_tx_phase_timers_enabled());
+}
+//-------------------------------------------------------------------------------------------------------------------
+TEST(mock_tx, scratch_arena)
+{
+    sp::SpScratchArena arena;
+    const rct::key *outer_storage{nullptr};
+    const rct::key *inner_storage{nullptr};
+
+    for (int round{0}; round < 2; ++round)
+    {
+        sp::SpScratchFrame outer{arena};
+        rct::keyV &outer_keys = outer.keys(5);
+        EXPECT_EQ(outer_keys.size(), 5);
+
+        {
+            // nested frame: new buffers, the outer frame's buffer is untouched
+            sp::SpScratchFrame inner{arena};
+            rct::keyV &inner_keys = inner.keys(7);
+            EXPECT_NE(&inner_keys, &outer_keys);
+            EXPECT_EQ(inner_keys.size(), 7);
+            EXPECT_EQ(outer_keys.size(), 5);
+
+            rct::KeyMatrix &matrix = inner.key_matrix(3, 2);
+            EXPECT_EQ(matrix.rows(), 3);
+            EXPECT_EQ(matrix.cols(), 2);
+            EXPECT_TRUE(inner.points().empty());
+            EXPECT_TRUE(inner.multiexp_data().empty());
+
+            // second round: the same storage is handed out again
+            if (round == 0)
+                inner_storage = inner_keys.data();
+            else
+                EXPECT_EQ(inner_keys.data(), inner_storage);
+        }
+
+        if (round == 0)
+            outer_storage = outer_keys.data();
+        else
+            EXPECT_EQ(outer_keys.data(), outer_storage);
+    }
+
+    // all frames closed: everything was given back
+    const sp::SpScratchArena::Mark mark{arena.mark()};
+    EXPECT_EQ(mark.keys, 0);
+    EXPECT_EQ(mark.key_matrices, 0);
+}
@@ -29,6 +29,7 @@
 #include "gtest/gtest.h"
 
 #include "crypto/crypto.h"
+#include "misc_language.h"
 #include "ringct/rctOps.h"
 #include "ringct/multiexp.h"
 
@@ -209,6 +210,27 @@ TEST(multiexp, pippenger_random)
   }
 }
 
+TEST(multiexp, multiexp_auto)
+{
+  const std::pair<size_t, size_t> default_crossovers = rct::get_multiexp_crossovers();
+  ASSERT_FALSE(rct::set_multiexp_crossovers(16, 8));
+
+  // every algorithm region, including all bos-coster and all pippenger
+  const std::vector<std::pair<size_t, size_t>> crossovers{{0, 95}, {4, 16}, {0, 0}, {64, 64}};
+  for (const auto &crossover : crossovers)
+  {
+    ASSERT_TRUE(rct::set_multiexp_crossovers(crossover.first, crossover.second));
+    std::vector<rct::MultiexpData> data;
+    for (int n = 0; n < 64; ++n)
+    {
+      data.push_back({rct::skGen(), get_p3(rct::scalarmultBase(rct::skGen()))});
+      ASSERT_TRUE(basic(data) == rct::multiexp_auto(data));
+    }
+  }
+
+  ASSERT_TRUE(rct::set_multiexp_crossovers(default_crossovers.first, default_crossovers.second));
+}
+
 TEST(multiexp, straus_cached)
 {
   static constexpr size_t N = 256;
@@ -253,6 +275,146 @@ TEST(multiexp, pippenger_cached)
   }
 }
 
+TEST(multiexp, pippenger_mt)
+{
+  // large enough to take the multithreaded path; split into a cached set and an uncached set
+  static constexpr size_t N = 1024;
+  std::vector<rct::MultiexpData> P(N/2);
+  for (size_t n = 0; n < N/2; ++n)
+  {
+    P[n].scalar = rct::zero();
+    ASSERT_TRUE(ge_frombytes_vartime(&P[n].point, rct::scalarmultBase(rct::skGen()).bytes) == 0);
+  }
+  std::shared_ptr<rct::pippenger_cached_data> cache = rct::pippenger_init_cache(P);
+
+  std::vector<rct::pippenger_prep_data> prep_data(2);
+  std::vector<rct::MultiexpData> data;
+  for (size_t n = 0; n < N/2; ++n)
+  {
+    prep_data[0].data.push_back({rct::skGen(), P[n].point});
+    prep_data[1].data.push_back({rct::skGen(), get_p3(rct::scalarmultBase(rct::skGen()))});
+  }
+  prep_data[0].cache = cache;
+  prep_data[0].cache_size = N/2;
+  data = prep_data[0].data;
+  data.insert(data.end(), prep_data[1].data.begin(), prep_data[1].data.end());
+
+  const rct::key expected = basic(data);
+  for (const size_t num_threads : {0, 1, 2, 3, 4, 7, 64})
+  {
+    ge_p3 result_p3 = rct::pippenger_p3_mt(prep_data, num_threads);
+    rct::key result;
+    ge_p3_tobytes(result.bytes, &result_p3);
+    ASSERT_TRUE(expected == result);
+  }
+}
+
+TEST(multiexp, offload_backend)
+{
+  static constexpr size_t N = 64;
+  std::vector<rct::pippenger_prep_data> prep_data(1);
+  for (size_t n = 0; n < N; ++n)
+    prep_data[0].data.push_back({rct::skGen(), get_p3(rct::scalarmultBase(rct::skGen()))});
+  const rct::key expected = basic(prep_data[0].data);
+
+  // the backend gets data sets at or above its threshold; a declined data set runs on the CPU
+  size_t num_offloaded = 0;
+  bool decline = false;
+  // the backend captures locals: uninstall it even if an assert returns early
+  auto backend_reset = epee::misc_utils::create_scope_leave_handler([]{ rct::set_multiexp_offload(nullptr, 0); });
+  rct::set_multiexp_offload([&](const std::vector<rct::pippenger_prep_data> &data, ge_p3 &result_out) -> bool {
+    ++num_offloaded;
+    if (decline)
+      return false;
+    result_out = rct::pippenger_p3(data, rct::get_pippenger_c(N));
+    return true;
+  }, N);
+  ASSERT_EQ(rct::get_multiexp_offload_min_data_size(), N);
+
+  ASSERT_TRUE(expected == rct::pippenger(prep_data));
+  ASSERT_EQ(num_offloaded, 1u);
+  decline = true;
+  ASSERT_TRUE(expected == rct::pippenger(prep_data));
+  ASSERT_EQ(num_offloaded, 2u);
+
+  // below the threshold, or with an explicit c: CPU only
+  prep_data[0].data.pop_back();
+  ASSERT_TRUE(!(expected == rct::pippenger(prep_data)));
+  ASSERT_EQ(num_offloaded, 2u);
+  ge_p3 result_p3 = rct::pippenger_p3_mt(prep_data, 1, rct::get_pippenger_c(N));
+  (void)result_p3;
+  ASSERT_EQ(num_offloaded, 2u);
+
+  rct::set_multiexp_offload(nullptr, N);
+  ASSERT_EQ(rct::get_multiexp_offload_min_data_size(), 0u);
+}
+
+TEST(multiexp, pippenger_find_failing_segments)
+{
+  // each segment sums to the identity: x*P + y*P - (x + y)*P
+  static constexpr size_t N = 37;
+  std::vector<std::vector<rct::pippenger_prep_data>> segments(N);
+  for (size_t n = 0; n < N; ++n)
+  {
+    const ge_p3 point = get_p3(rct::scalarmultBase(rct::skGen()));
+    const rct::key x = rct::skGen();
+    const rct::key y = rct::skGen();
+    rct::key z;
+    sc_add(z.bytes, x.bytes, y.bytes);
+    sc_sub(z.bytes, rct::zero().bytes, z.bytes);
+
+    segments[n].resize(1 + n % 2);
+    segments[n][0].data.push_back({x, point});
+    segments[n].back().data.push_back({y, point});
+    segments[n].back().data.push_back({z, point});
+  }
+
+  for (const size_t num_threads : {1, 4})
+  {
+    ASSERT_TRUE(rct::pippenger_find_failing_segments({}, num_threads).empty());
+    ASSERT_TRUE(rct::pippenger_find_failing_segments(segments, num_threads).empty());
+  }
+
+  const std::vector<size_t> expected = {0, 5, 6, 20, 36};
+  for (const size_t n : expected)
+    segments[n][0].data[0].scalar = rct::skGen();
+
+  for (const size_t num_threads : {1, 4})
+    ASSERT_TRUE(rct::pippenger_find_failing_segments(segments, num_threads) == expected);
+}
+
+TEST(multiexp, fixed_base_cached)
+{
+  static constexpr size_t N = 64;
+  std::vector<ge_p3> bases(N);
+  for (size_t n = 0; n < N; ++n)
+    ASSERT_TRUE(ge_frombytes_vartime(&bases[n], rct::scalarmultBase(rct::skGen()).bytes) == 0);
+  std::shared_ptr<rct::fixed_base_cached_data> cache = rct::fixed_base_init_cache(bases);
+  for (size_t n = 0; n < N/4; ++n)
+  {
+    std::vector<rct::MultiexpData> data;
+    std::vector<rct::key> scalars;
+    size_t sz = 1 + crypto::rand<size_t>() % (N-1);
+    for (size_t s = 0; s < sz; ++s)
+    {
+      // include edge-case scalars: zero, small, and all digits at the signed window boundary
+      rct::key scalar = rct::skGen();
+      if (s % 8 == 1)
+        scalar = rct::zero();
+      else if (s % 8 == 2)
+        scalar = TESTSMALLSCALAR;
+      else if (s % 8 == 3)
+        memset(scalar.bytes, 0x80, 31);
+      scalars.push_back(scalar);
+      data.push_back({scalar, bases[s]});
+    }
+    ge_p3 result_p3 = rct::fixed_base_multiexp_p3(scalars, cache);
+    rct::key result;
+    ge_p3_tobytes(result.bytes, &result_p3);
+    ASSERT_TRUE(basic(data) == result);
+  }
+}
+
 TEST(multiexp, scalarmult_triple)
 {
   std::vector<rct::MultiexpData> data;
@@ -314,3 +476,31 @@ TEST(multiexp, scalarmult_triple)
     }
   }
 }
+
+TEST(multiexp, multiexp_data_buffer_pool)
+{
+  // a recycled buffer comes back (with its storage) when a request fits in it
+  std::vector<rct::MultiexpData> buffer = rct::take_multiexp_data_buffer(64);
+  ASSERT_TRUE(buffer.empty());
+  ASSERT_GE(buffer.capacity(), 64);
+  buffer.resize(10);
+  const rct::MultiexpData *storage = buffer.data();
+  rct::recycle_multiexp_data_buffer(std::move(buffer));
+
+  std::vector<rct::MultiexpData> reused = rct::take_multiexp_data_buffer(32);
+  ASSERT_TRUE(reused.empty());
+  ASSERT_EQ(reused.data(), storage);
+
+  // consumed prep data sets give their buffers back too
+  std::vector<rct::pippenger_prep_data> prep_data;
+  prep_data.push_back(rct::pippenger_prep_data{std::move(reused), nullptr, 0});
+  rct::recycle_pippenger_prep_data(prep_data);
+  ASSERT_TRUE(prep_data.empty());
+
+  std::vector<rct::MultiexpData> reused_again = rct::take_multiexp_data_buffer(16);
+  ASSERT_EQ(reused_again.data(), storage);
+
+  // a request larger than any pooled buffer still gets enough capacity
+  rct::recycle_multiexp_data_buffer(std::move(reused_again));
+  ASSERT_GE(rct::take_multiexp_data_buffer(1000).capacity(), 1000);
+}
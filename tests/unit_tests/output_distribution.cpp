@@ -183,3 +183,19 @@ TEST(output_distribution, part_noncumulative)
   ASSERT_EQ(res->distribution.size(), 5);
   ASSERT_EQ(res->distribution, std::vector<uint64_t>({0, 1, 5, 1, 4}));
 }
+
+TEST(output_distribution, cumulative_rct_outputs_range)
+{
+  TestDB db;
+  std::vector<uint64_t> heights;
+  for (uint64_t h = 3; h <= 9; ++h)
+    heights.push_back(h);
+  ASSERT_EQ(db.get_block_cumulative_rct_outputs_range(3, 9), db.get_block_cumulative_rct_outputs(heights));
+  ASSERT_EQ(db.get_block_cumulative_rct_outputs_range(9, 3), std::vector<uint64_t>());
+
+  // shrinking the chain invalidates the mirror
+  db.blockchain_height = 8;
+  ASSERT_THROW(db.get_block_cumulative_rct_outputs_range(3, 9), cryptonote::BLOCK_DNE);
+  heights.resize(5);
+  ASSERT_EQ(db.get_block_cumulative_rct_outputs_range(3, 7), db.get_block_cumulative_rct_outputs(heights));
+}
@@ -0,0 +1,156 @@
+// Copyright (c) 2022, The Monero Project
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of
+//    conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list
+//    of conditions and the following disclaimer in the documentation and/or other
+//    materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be
+//    used to endorse or promote products derived from this software without specific
+//    prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+// THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include <limits>
+#include <thread>
+
+#include "gtest/gtest.h"
+#include "common/perf_timer.h"
+
+namespace
+{
+  // one PERF_TIMER call site, shared by every thread that calls it
+  void timed_call()
+  {
+    PERF_TIMER(unit_test_histogram_site);
+  }
+
+  void timed_calls(size_t n)
+  {
+    for (size_t i = 0; i < n; ++i)
+      timed_call();
+  }
+
+  // the histogram of timed_call()'s site since the last clear, with a zero count if it has none
+  tools::PerformanceTimerHistogram get_histogram()
+  {
+    for (const tools::PerformanceTimerHistogram &h: tools::get_performance_timer_histograms())
+      if (h.name == "unit_test_histogram_site")
+        return h;
+    return {"unit_test_histogram_site", "", 0, 0, {}};
+  }
+
+  uint64_t bucket_sum(const tools::PerformanceTimerHistogram &h)
+  {
+    uint64_t sum = 0;
+    for (const uint64_t b: h.buckets)
+      sum += b;
+    return sum;
+  }
+
+  struct histogram_mode
+  {
+    histogram_mode() { tools::set_performance_timer_histograms(true); tools::clear_performance_timer_histograms(); }
+    ~histogram_mode() { tools::set_performance_timer_histograms(false); }
+  };
+}
+
+TEST(perf_timer, bucket_math)
+{
+  // bucket b holds [2^b, 2^(b+1)) ticks, bucket 0 also holds 0
+  ASSERT_EQ(tools::performance_timer_bucket(0), 0u);
+  ASSERT_EQ(tools::performance_timer_bucket(1), 0u);
+  for (size_t b = 1; b < PERF_TIMER_HISTOGRAM_BUCKETS; ++b)
+  {
+    ASSERT_EQ(tools::performance_timer_bucket(uint64_t(1) << b), b);
+    ASSERT_EQ(tools::performance_timer_bucket((uint64_t(1) << b) - 1), b - 1);
+  }
+  ASSERT_EQ(tools::performance_timer_bucket(std::numeric_limits<uint64_t>::max()), PERF_TIMER_HISTOGRAM_BUCKETS - 1);
+
+  // the limits grow with the buckets and the last one is open ended
+  for (size_t b = 1; b < PERF_TIMER_HISTOGRAM_BUCKETS; ++b)
+    ASSERT_LE(tools::performance_timer_bucket_limit_ns(b - 1), tools::performance_timer_bucket_limit_ns(b));
+  ASSERT_EQ(tools::performance_timer_bucket_limit_ns(PERF_TIMER_HISTOGRAM_BUCKETS - 1), std::numeric_limits<uint64_t>::max());
+}
+
+TEST(perf_timer, histogram_counts)
+{
+  histogram_mode mode;
+  timed_calls(100);
+  const tools::PerformanceTimerHistogram h = get_histogram();
+  ASSERT_EQ(h.count, 100u);
+  ASSERT_EQ(bucket_sum(h), 100u);
+  ASSERT_EQ(h.cat, "perf." MONERO_DEFAULT_LOG_CATEGORY);
+
+  // not recorded outside histogram mode
+  tools::set_performance_timer_histograms(false);
+  timed_calls(10);
+  ASSERT_EQ(get_histogram().count, 100u);
+}
+
+TEST(perf_timer, histogram_clear)
+{
+  histogram_mode mode;
+  timed_calls(50);
+  ASSERT_EQ(get_histogram().count, 50u);
+
+  // a clear reports from a new baseline; the site is left out until it records again
+  tools::clear_performance_timer_histograms();
+  ASSERT_EQ(get_histogram().count, 0u);
+  timed_calls(20);
+  const tools::PerformanceTimerHistogram h = get_histogram();
+  ASSERT_EQ(h.count, 20u);
+  ASSERT_EQ(bucket_sum(h), 20u);
+
+  tools::clear_performance_timer_histograms();
+  tools::clear_performance_timer_histograms();
+  ASSERT_EQ(get_histogram().count, 0u);
+}
+
+TEST(perf_timer, histogram_exited_threads)
+{
+  histogram_mode mode;
+  timed_calls(5);
+
+  // the counters of a thread that has exited are kept
+  std::thread t1(timed_calls, 30);
+  t1.join();
+  tools::PerformanceTimerHistogram h = get_histogram();
+  ASSERT_EQ(h.count, 35u);
+  ASSERT_EQ(bucket_sum(h), 35u);
+
+  // and only count from the baseline after a clear, whether the thread exited before or after it
+  std::thread t2(timed_calls, 7);
+  t2.join();
+  tools::clear_performance_timer_histograms();
+  std::thread t3(timed_calls, 11);
+  t3.join();
+  timed_calls(2);
+  h = get_histogram();
+  ASSERT_EQ(h.count, 13u);
+  ASSERT_EQ(bucket_sum(h), 13u);
+
+  std::thread t4([]{
+    timed_calls(3);
+    tools::clear_performance_timer_histograms();
+    timed_calls(4);
+  });
+  t4.join();
+  ASSERT_EQ(get_histogram().count, 4u);
+}
@@ -1230,6 +1230,48 @@ TEST(ringct, zeroCommitCache)
   ASSERT_EQ(rct::zeroCommit(900000000000000), uncachedZeroCommit(900000000000000));
 }
 
+TEST(ringct, hash_prefix)
+{
+  for (size_t n: {0, 1, 4, 5, 17})
+  {
+    rct::keyV keys = rct::skvGen(n + 2);
+    const rct::hash_prefix prefix(keys.data(), n);
+    rct::key hash;
+    prefix.hash_to_scalar(hash, &keys[n], 2);
+    ASSERT_EQ(hash, rct::hash_to_scalar(keys));
+
+    // the saved state is reused, not consumed
+    keys[n + 1] = rct::skGen();
+    prefix.hash_to_scalar(hash, &keys[n], 2);
+    ASSERT_EQ(hash, rct::hash_to_scalar(keys));
+  }
+}
+
+TEST(ringct, hash_to_p3_cache)
+{
+  rct::hash_to_p3_cache cache(2);
+  const rct::keyV P = {rct::pkGen(), rct::pkGen(), rct::pkGen()};
+  for (const rct::key &k: {P[0], P[1], P[0], P[2], P[1]})
+  {
+    ge_p3 hash8_p3;
+    rct::geDsmp expected, precomp;
+    rct::hash_to_p3(hash8_p3, k);
+    ge_dsm_precomp(expected.k, &hash8_p3);
+    cache.get(precomp.k, k);
+    ASSERT_EQ(memcmp(&precomp, &expected, sizeof(expected)), 0);
+  }
+
+  // P[0] is hit once; P[2] evicts P[1], which is then missed again
+  const rct::hash_to_p3_cache_stats stats = cache.get_stats();
+  ASSERT_EQ(stats.hits, 1u);
+  ASSERT_EQ(stats.misses, 4u);
+  ASSERT_EQ(stats.evictions, 2u);
+  ASSERT_EQ(cache.size(), 2u);
+
+  cache.clear();
+  ASSERT_EQ(cache.size(), 0u);
+}
+
 TEST(ringct, H)
 {
   ge_p3 p3;
@@ -1252,6 +1294,62 @@ TEST(ringct, mul8)
   ASSERT_EQ(rct::scalarmultKey(rct::scalarmultKey(rct::H, rct::INV_EIGHT), rct::EIGHT), rct::H);
 }
 
+TEST(ringct, sc_muladd_x4)
+{
+  // the four-lane kernels match sc_mul/sc_muladd, including for unreduced inputs and outputs that alias inputs
+  for (int i = 0; i < 256; ++i)
+  {
+    rct::key a[4], b[4], c[4], expected[4], result[4];
+    for (size_t lane = 0; lane < 4; ++lane)
+    {
+      a[lane] = rct::skGen();
+      b[lane] = rct::skGen();
+      c[lane] = rct::skGen();
+    }
+    if (i % 4 == 0)
+      memset(a[i % 16 / 4].bytes, 0xff, 32);
+    if (i % 8 == 1)
+      b[0] = rct::zero();
+
+    const unsigned char *pa[4], *pb[4], *pc[4];
+    unsigned char *pout[4];
+    for (size_t lane = 0; lane < 4; ++lane)
+    {
+      pa[lane] = a[lane].bytes;
+      pb[lane] = b[lane].bytes;
+      pc[lane] = c[lane].bytes;
+      pout[lane] = result[lane].bytes;
+    }
+
+    for (const int use_simd : {0, 1})
+    {
+      for (size_t lane = 0; lane < 4; ++lane)
+        sc_mul(expected[lane].bytes, a[lane].bytes, b[lane].bytes);
+      sc_mul_x4(pout, pa, pb, use_simd);
+      for (size_t lane = 0; lane < 4; ++lane)
+        ASSERT_EQ(result[lane], expected[lane]);
+
+      for (size_t lane = 0; lane < 4; ++lane)
+        sc_muladd(expected[lane].bytes, a[lane].bytes, b[lane].bytes, c[lane].bytes);
+      sc_muladd_x4(pout, pa, pb, pc, use_simd);
+      for (size_t lane = 0; lane < 4; ++lane)
+        ASSERT_EQ(result[lane], expected[lane]);
+    }
+
+    // in place
+    rct::key in_place[4];
+    unsigned char *pin_place[4];
+    for (size_t lane = 0; lane < 4; ++lane)
+    {
+      in_place[lane] = c[lane];
+      pin_place[lane] = in_place[lane].bytes;
+    }
+    sc_muladd_x4(pin_place, pa, pb, pin_place, 1);
+    for (size_t lane = 0; lane < 4; ++lane)
+      ASSERT_EQ(in_place[lane], expected[lane]);
+  }
+}
+
 TEST(ringct, aggregated)
 {
   static const size_t N_PROOFS = 16;
@@ -1268,3 +1366,36 @@ TEST(ringct, aggregated)
 
   ASSERT_TRUE(verRctSemanticsSimple(sp));
 }
+
+TEST(ringct, key_matrix)
+{
+  rct::keyM rows = rct::keyMInit(3, 4);
+  for (rct::keyV &row : rows)
+    for (rct::key &k : row)
+      k = rct::skGen();
+
+  // rows are contiguous and line up with the keyM
+  const rct::KeyMatrix matrix{rows};
+  ASSERT_EQ(matrix.rows(), 4u);
+  ASSERT_EQ(matrix.cols(), 3u);
+  ASSERT_EQ(matrix.size(), 12u);
+  for (size_t i = 0; i < rows.size(); ++i)
+  {
+    ASSERT_EQ(matrix[i].data(), matrix.data() + i*3);
+    for (size_t j = 0; j < rows[i].size(); ++j)
+      ASSERT_EQ(matrix[i][j], rows[i][j]);
+  }
+  ASSERT_TRUE(matrix.to_keyM() == rows);
+
+  // ragged rows can't be flattened
+  rows[2].pop_back();
+  ASSERT_THROW(rct::KeyMatrix{rows}, std::exception);
+
+  // reshaping keeps the allocation
+  rct::KeyMatrix scratch{8, 2};
+  const rct::key *buffer = scratch.data();
+  scratch.resize(4, 4);
+  ASSERT_EQ(scratch.data(), buffer);
+  ASSERT_EQ(scratch.rows(), 4u);
+  ASSERT_EQ(scratch[3].size(), 4u);
+}
@@ -40,11 +40,14 @@ extern "C"
 #include "mock_tx/mock_tx_utils.h"
 #include "mock_tx/seraphis_composition_proof.h"
 #include "mock_tx/seraphis_crypto_utils.h"
+#include "mock_tx/seraphis_multisig_nonce_pool.h"
+#include "ringct/multiexp.h"
 #include "ringct/rctOps.h"
 #include "ringct/rctTypes.h"
 
 #include "gtest/gtest.h"
 
+#include <memory>
 #include <vector>
 
 
@@ -302,6 +305,109 @@ TEST(seraphis, multi_exp)
     }
 }
 //-------------------------------------------------------------------------------------------------------------------
+TEST(seraphis, multi_exp_fixed)
+{
+    rct::key test_key;
+    rct::key check;
+    rct::key temp;
+    ge_p3 result_p3;
+
+    // every fixed size matches the general multiexp (with a zero and a unit scalar mixed in)
+    for (std::size_t i = 1; i <= sp::MULTI_EXP_FIXED_MAX; ++i)
+    {
+        std::vector<rct::MultiexpData> data;
+        data.reserve(i);
+        check = rct::identity();
+
+        for (std::size_t j = 0; j < i; ++j)
+        {
+            const rct::key privkey{j == 1 ? rct::zero() : (j == 2 ? rct::identity() : rct::skGen())};
+            const rct::key pubkey{rct::pkGen()};
+            data.emplace_back(privkey, pubkey);
+
+            rct::scalarmultKey(temp, pubkey, privkey);
+            rct::addKeys(check, check, temp);
+        }
+
+        ASSERT_TRUE(sp::try_multi_exp_fixed(epee::to_span(data), result_p3));
+        ge_p3_tobytes(test_key.bytes, &result_p3);
+        EXPECT_TRUE(test_key == check);
+    }
+
+    // all-zero scalars give the identity
+    std::vector<rct::MultiexpData> data(3, rct::MultiexpData{rct::zero(), rct::pkGen()});
+    ASSERT_TRUE(sp::try_multi_exp_fixed(epee::to_span(data), result_p3));
+    EXPECT_TRUE(ge_p3_is_point_at_infinity_vartime(&result_p3));
+
+    // out of range sizes are declined
+    EXPECT_FALSE(sp::try_multi_exp_fixed({}, result_p3));
+    data.resize(sp::MULTI_EXP_FIXED_MAX + 1, rct::MultiexpData{rct::skGen(), rct::pkGen()});
+    EXPECT_FALSE(sp::try_multi_exp_fixed(epee::to_span(data), result_p3));
+}
+//-------------------------------------------------------------------------------------------------------------------
+TEST(seraphis, invert_batch)
+{
+    for (const std::size_t num_scalars : {0, 1, 2, 7})
+    {
+        rct::keyV scalars;
+        for (std::size_t i = 0; i < num_scalars; ++i)
+            scalars.push_back(rct::skGen());
+
+        // matches one-at-a-time inversion
+        rct::keyV inverses{scalars};
+        sp::invert_batch(inverses);
+        ASSERT_TRUE(inverses.size() == num_scalars);
+
+        for (std::size_t i = 0; i < num_scalars; ++i)
+            EXPECT_TRUE(inverses[i] == sp::invert(scalars[i]));
+    }
+
+    // zero can't be inverted
+    rct::keyV scalars{rct::skGen(), rct::zero(), rct::skGen()};
+    EXPECT_ANY_THROW(sp::invert_batch(scalars));
+}
+//-------------------------------------------------------------------------------------------------------------------
+TEST(seraphis, domain_hasher)
+{
+    // a long separator spans more than one keccak block
+    for (const std::string &domain_separator : {std::string{}, std::string{"seraphis test"}, std::string(200, 'x')})
+    {
+        const sp::SpDomainHasher domain_hasher{domain_separator};
+        const rct::key rct_key{rct::skGen()};
+        const rct::key extra_key{rct::skGen()};
+
+        // H("domain-sep", key, [OPTIONAL extra_key]) matches hashing the concatenation
+        for (const rct::key &extra : {rct::zero(), extra_key})
+        {
+            std::string concat{domain_separator};
+            concat.append((const char*) rct_key.bytes, sizeof(rct::key));
+            if (!(extra == rct::zero()))
+                concat.append((const char*) extra.bytes, sizeof(rct::key));
+            rct::key expected;
+            rct::hash_to_scalar(expected, concat.data(), concat.size());
+
+            crypto::secret_key hash_result;
+            sp::domain_separate_rct_hash_with_extra(domain_hasher, rct_key, extra, hash_result);
+            EXPECT_TRUE(rct::sk2rct(hash_result) == expected);
+            sp::domain_separate_rct_hash_with_extra(domain_separator, rct_key, extra, hash_result);
+            EXPECT_TRUE(rct::sk2rct(hash_result) == expected);
+        }
+
+        // H("domain-sep", derivation, varint(index))
+        crypto::key_derivation derivation;
+        const rct::key derivation_key{rct::pkGen()};
+        memcpy(&derivation, derivation_key.bytes, sizeof(derivation));
+        std::string concat{domain_separator};
+        concat.append((const char*) &derivation, sizeof(derivation));
+        concat += '\x81';
+        concat += '\x01';
+        rct::key expected, hash_result;
+        rct::hash_to_scalar(expected, concat.data(), concat.size());
+        sp::domain_separate_derivation_hash(domain_hasher, derivation, 129, hash_result);
+        EXPECT_TRUE(hash_result == expected);
+    }
+}
+//-------------------------------------------------------------------------------------------------------------------
 TEST(seraphis, composition_proof)
 {
     rct::keyV K;
@@ -372,6 +478,77 @@ TEST(seraphis, composition_proof)
     }
 }
 //-------------------------------------------------------------------------------------------------------------------
+TEST(seraphis, composition_proof_batch)
+{
+    // proofs with different key counts and messages
+    const std::size_t num_proofs{4};
+    std::vector<rct::keyV> K(num_proofs);
+    std::vector<std::vector<crypto::key_image>> KI(num_proofs);
+    rct::keyV messages(num_proofs);
+    std::vector<sp::SpCompositionProof> proofs(num_proofs);
+    std::vector<const sp::SpCompositionProof*> proof_ptrs;
+
+    try
+    {
+        for (std::size_t proof_i{0}; proof_i < num_proofs; ++proof_i)
+        {
+            const std::size_t num_keys{proof_i + 1};
+            std::vector<crypto::secret_key> x(num_keys), y(num_keys), z(num_keys);
+            K[proof_i].resize(num_keys);
+            KI[proof_i].resize(num_keys);
+
+            for (std::size_t i{0}; i < num_keys; ++i)
+            {
+                std::vector<crypto::secret_key> temp_z = {z[i]};
+                make_fake_sp_masked_address(x[i], y[i], temp_z, K[proof_i][i]);
+                z[i] = temp_z[0];
+                mock_tx::make_seraphis_key_image(y[i], z[i], KI[proof_i][i]);
+            }
+
+            messages[proof_i] = rct::skGen();
+            proofs[proof_i] = sp::sp_composition_prove(K[proof_i], x, y, z, messages[proof_i]);
+            proof_ptrs.push_back(&proofs[proof_i]);
+        }
+
+        // valid batch
+        EXPECT_TRUE(sp::check_pippenger_data(sp::get_sp_composition_verification_data(proof_ptrs, K, KI, messages)));
+
+        // verification data merges with other data sets
+        std::vector<rct::pippenger_prep_data> prep_datas;
+        prep_datas.emplace_back(sp::get_sp_composition_verification_data({proof_ptrs[0], proof_ptrs[1]},
+            {K[0], K[1]},
+            {KI[0], KI[1]},
+            {messages[0], messages[1]}));
+        prep_datas.emplace_back(sp::get_sp_composition_verification_data({proof_ptrs[2], proof_ptrs[3]},
+            {K[2], K[3]},
+            {KI[2], KI[3]},
+            {messages[2], messages[3]}));
+        EXPECT_TRUE(sp::check_pippenger_data(prep_datas));
+
+        // wrong message for one proof
+        rct::keyV bad_messages{messages};
+        bad_messages[2] = rct::skGen();
+        EXPECT_FALSE(sp::check_pippenger_data(
+            sp::get_sp_composition_verification_data(proof_ptrs, K, KI, bad_messages)));
+
+        // tampered proof
+        sp::SpCompositionProof bad_proof{proofs[3]};
+        bad_proof.r_i[1] = rct::skGen();
+        proof_ptrs[3] = &bad_proof;
+        EXPECT_FALSE(sp::check_pippenger_data(sp::get_sp_composition_verification_data(proof_ptrs, K, KI, messages)));
+        EXPECT_FALSE(sp::sp_composition_verify(bad_proof, K[3], KI[3], messages[3]));
+
+        // tampered commitment
+        bad_proof = proofs[3];
+        bad_proof.A_KI = rct::pkGen();
+        EXPECT_FALSE(sp::check_pippenger_data(sp::get_sp_composition_verification_data(proof_ptrs, K, KI, messages)));
+    }
+    catch (...)
+    {
+        EXPECT_TRUE(false);
+    }
+}
+//-------------------------------------------------------------------------------------------------------------------
 TEST(seraphis, composition_proof_multisig)
 {
     rct::keyV K, signer_nonces_1_pubs, signer_nonces_2_pubs;
@@ -511,6 +688,151 @@ TEST(seraphis, composition_proof_multisig)
     }
 }
 //-------------------------------------------------------------------------------------------------------------------
+TEST(seraphis, composition_proof_multisig_batch)
+{
+    const std::size_t num_proposals{3};
+    const std::size_t num_keys{2};
+    const std::size_t num_signers{2};
+
+    // each signer keeps a nonce pool
+    std::vector<std::unique_ptr<sp::SpCompositionMultisigNoncePool>> nonce_pools;
+    for (std::size_t signer_index{0}; signer_index < num_signers; ++signer_index)
+    {
+        nonce_pools.emplace_back(new sp::SpCompositionMultisigNoncePool{4, 2});
+        nonce_pools.back()->refill();
+        EXPECT_TRUE(nonce_pools.back()->size() == 4);
+    }
+
+    std::vector<rct::keyV> K(num_proposals, rct::keyV(num_keys));
+    std::vector<std::vector<crypto::key_image>> KI(num_proposals, std::vector<crypto::key_image>(num_keys));
+    std::vector<std::vector<crypto::secret_key>> x(num_proposals, std::vector<crypto::secret_key>(num_keys));
+    std::vector<std::vector<crypto::secret_key>> y(num_proposals, std::vector<crypto::secret_key>(num_keys));
+    // z_pieces[signer][proposal][key]
+    std::vector<std::vector<std::vector<crypto::secret_key>>> z_pieces(num_signers,
+        std::vector<std::vector<crypto::secret_key>>(num_proposals, std::vector<crypto::secret_key>(num_keys)));
+    rct::keyV messages(num_proposals);
+    std::vector<sp::SpCompositionProofMultisigProposal> proposals;
+    std::vector<const sp::SpCompositionProofMultisigProposal*> proposal_ptrs;
+
+    try
+    {
+        // prepare keys and proposals
+        std::vector<crypto::secret_key> z_pieces_temp(num_signers);
+
+        for (std::size_t proposal_index{0}; proposal_index < num_proposals; ++proposal_index)
+        {
+            for (std::size_t i{0}; i < num_keys; ++i)
+            {
+                make_fake_sp_masked_address(x[proposal_index][i], y[proposal_index][i], z_pieces_temp, K[proposal_index][i]);
+
+                crypto::secret_key z{rct::rct2sk(rct::zero())};
+                for (std::size_t signer_index{0}; signer_index < num_signers; ++signer_index)
+                {
+                    z_pieces[signer_index][proposal_index][i] = z_pieces_temp[signer_index];
+                    sc_add(&z, &z, &z_pieces_temp[signer_index]);
+                }
+
+                mock_tx::make_seraphis_key_image(y[proposal_index][i], z, KI[proposal_index][i]);
+            }
+
+            messages[proposal_index] = rct::skGen();
+            proposals.emplace_back(
+                    sp::sp_composition_multisig_proposal(KI[proposal_index], K[proposal_index], messages[proposal_index])
+                );
+        }
+
+        for (const sp::SpCompositionProofMultisigProposal &proposal : proposals)
+            proposal_ptrs.emplace_back(&proposal);
+
+        // all participants: signature openers from their pools (one prep per proposal)
+        std::vector<std::vector<sp::SpCompositionProofMultisigPrep>> signer_preps;
+        std::vector<rct::keyV> signer_nonces_1_pubs(num_proposals, rct::keyV(num_signers));
+        std::vector<rct::keyV> signer_nonces_2_pubs(num_proposals, rct::keyV(num_signers));
+
+        for (std::size_t signer_index{0}; signer_index < num_signers; ++signer_index)
+        {
+            signer_preps.emplace_back(nonce_pools[signer_index]->take_preps(num_proposals));
+            ASSERT_TRUE(signer_preps.back().size() == num_proposals);
+
+            for (std::size_t proposal_index{0}; proposal_index < num_proposals; ++proposal_index)
+            {
+                signer_nonces_1_pubs[proposal_index][signer_index] =
+                    signer_preps[signer_index][proposal_index].signature_nonce_1_KI_pub;
+                signer_nonces_2_pubs[proposal_index][signer_index] =
+                    signer_preps[signer_index][proposal_index].signature_nonce_2_KI_pub;
+            }
+        }
+
+        // preps are single-use: no nonce pair was handed out twice
+        for (std::size_t proposal_index{1}; proposal_index < num_proposals; ++proposal_index)
+            EXPECT_FALSE(signer_nonces_1_pubs[proposal_index][0] == signer_nonces_1_pubs[0][0]);
+
+        // all participants: respond to every proposal at once
+        std::vector<std::vector<sp::SpCompositionProofMultisigPartial>> partial_sigs;
+
+        for (std::size_t signer_index{0}; signer_index < num_signers; ++signer_index)
+        {
+            std::vector<crypto::secret_key> local_nonces_1_priv;
+            std::vector<crypto::secret_key> local_nonces_2_priv;
+
+            for (const sp::SpCompositionProofMultisigPrep &prep : signer_preps[signer_index])
+            {
+                local_nonces_1_priv.emplace_back(prep.signature_nonce_1_KI_priv);
+                local_nonces_2_priv.emplace_back(prep.signature_nonce_2_KI_priv);
+            }
+
+            partial_sigs.emplace_back(
+                    sp::sp_composition_multisig_partial_sig_batch(proposal_ptrs,
+                        x,
+                        y,
+                        z_pieces[signer_index],
+                        signer_nonces_1_pubs,
+                        signer_nonces_2_pubs,
+                        local_nonces_1_priv,
+                        local_nonces_2_priv)
+                );
+            ASSERT_TRUE(partial_sigs.back().size() == num_proposals);
+
+            // batch partial sigs match the one-at-a-time partial sigs
+            for (std::size_t proposal_index{0}; proposal_index < num_proposals; ++proposal_index)
+            {
+                const sp::SpCompositionProofMultisigPartial partial_sig{
+                        sp::sp_composition_multisig_partial_sig(proposals[proposal_index],
+                            x[proposal_index],
+                            y[proposal_index],
+                            z_pieces[signer_index][proposal_index],
+                            signer_nonces_1_pubs[proposal_index],
+                            signer_nonces_2_pubs[proposal_index],
+                            local_nonces_1_priv[proposal_index],
+                            local_nonces_2_priv[proposal_index])
+                    };
+                EXPECT_TRUE(partial_sig.r_b_partial == partial_sigs.back()[proposal_index].r_b_partial);
+                EXPECT_TRUE(partial_sig.K_t1 == partial_sigs.back()[proposal_index].K_t1);
+            }
+        }
+
+        // assemble and verify each proof
+        for (std::size_t proposal_index{0}; proposal_index < num_proposals; ++proposal_index)
+        {
+            std::vector<sp::SpCompositionProofMultisigPartial> proposal_partial_sigs;
+            for (std::size_t signer_index{0}; signer_index < num_signers; ++signer_index)
+                proposal_partial_sigs.emplace_back(partial_sigs[signer_index][proposal_index]);
+
+            const sp::SpCompositionProof proof{sp::sp_composition_prove_multisig_final(proposal_partial_sigs)};
+            EXPECT_TRUE(sp::sp_composition_verify(proof, K[proposal_index], KI[proposal_index], messages[proposal_index]));
+        }
+
+        // a pool that runs dry makes preps inline
+        std::vector<sp::SpCompositionProofMultisigPrep> extra_preps{nonce_pools[0]->take_preps(8)};
+        EXPECT_TRUE(extra_preps.size() == 8);
+        EXPECT_TRUE(nonce_pools[0]->num_made_inline() > 0);
+    }
+    catch (...)
+    {
+        EXPECT_TRUE(false);
+    }
+}
+//-------------------------------------------------------------------------------------------------------------------
 TEST(seraphis, information_recovery_pieces)
 {
     // different methods for making key images all have same results
@@ -533,6 +855,25 @@ TEST(seraphis, information_recovery_pieces)
     EXPECT_TRUE(key_image1 == key_image2);
     EXPECT_TRUE(key_image2 == key_image3);
 
+    // batched key images match one-at-a-time key images
+    std::vector<crypto::secret_key> y_keys(3), z_keys(3);
+    for (std::size_t i{0}; i < y_keys.size(); ++i)
+    {
+        make_secret_key(y_keys[i]);
+        make_secret_key(z_keys[i]);
+    }
+    y_keys[2] = y;
+    z_keys[2] = z;
+    std::vector<crypto::key_image> key_images;
+    mock_tx::make_seraphis_key_images(y_keys, z_keys, key_images);
+    ASSERT_TRUE(key_images.size() == y_keys.size());
+    for (std::size_t i{0}; i < y_keys.size(); ++i)
+    {
+        mock_tx::make_seraphis_key_image(y_keys[i], z_keys[i], key_image2);
+        EXPECT_TRUE(key_images[i] == key_image2);
+    }
+    EXPECT_TRUE(key_images[2] == key_image1);
+
     // encoding/decoding amounts succeeds
     crypto::secret_key sender_receiver_secret = rct::rct2sk(rct::identity());
     while (sender_receiver_secret == rct::rct2sk(rct::identity()))
@@ -618,6 +959,115 @@ TEST(seraphis, enote_v1_information_recovery)
     EXPECT_TRUE(sender_receiver_secret2 == sender_receiver_secret);
 }
 //-------------------------------------------------------------------------------------------------------------------
+TEST(seraphis, recipient_precomp_outputs)
+{
+    // destinations: two payouts to each of three recipients
+    std::vector<mock_tx::MockDestinationSpV1> destinations{mock_tx::gen_mock_sp_destinations_v1({1, 2, 3, 4, 5, 6})};
+
+    for (std::size_t dest_index{3}; dest_index < destinations.size(); ++dest_index)
+    {
+        destinations[dest_index].m_recipient_DHkey = destinations[dest_index - 3].m_recipient_DHkey;
+        destinations[dest_index].m_recipient_viewkey = destinations[dest_index - 3].m_recipient_viewkey;
+        destinations[dest_index].m_recipient_spendkey = destinations[dest_index - 3].m_recipient_spendkey;
+    }
+
+    // outputs made with and without the recipients' tables must match
+    std::vector<mock_tx::MockENoteSpV1> outputs;
+    std::vector<rct::xmr_amount> output_amounts;
+    std::vector<crypto::secret_key> output_amount_commitment_blinding_factors;
+    mock_tx::MockSupplementSpV1 tx_supplement;
+    mock_tx::make_v1_tx_outputs_sp_v1(destinations,
+        outputs,
+        output_amounts,
+        output_amount_commitment_blinding_factors,
+        tx_supplement);
+
+    mock_tx::MockRecipientPrecompCacheSpV1 recipient_precomp_cache;
+    std::vector<mock_tx::MockENoteSpV1> outputs_cached;
+    std::vector<rct::xmr_amount> output_amounts_cached;
+    std::vector<crypto::secret_key> output_amount_commitment_blinding_factors_cached;
+    mock_tx::MockSupplementSpV1 tx_supplement_cached;
+    mock_tx::make_v1_tx_outputs_sp_v1(destinations,
+        recipient_precomp_cache,
+        outputs_cached,
+        output_amounts_cached,
+        output_amount_commitment_blinding_factors_cached,
+        tx_supplement_cached);
+    EXPECT_TRUE(recipient_precomp_cache.size() == 3);
+
+    ASSERT_TRUE(outputs_cached.size() == outputs.size());
+    for (std::size_t output_index{0}; output_index < outputs.size(); ++output_index)
+    {
+        EXPECT_TRUE(outputs_cached[output_index].m_onetime_address == outputs[output_index].m_onetime_address);
+        EXPECT_TRUE(outputs_cached[output_index].m_amount_commitment == outputs[output_index].m_amount_commitment);
+        EXPECT_TRUE(outputs_cached[output_index].m_encoded_amount == outputs[output_index].m_encoded_amount);
+        EXPECT_TRUE(outputs_cached[output_index].m_view_tag == outputs[output_index].m_view_tag);
+    }
+    EXPECT_TRUE(tx_supplement_cached.m_output_enote_pubkeys == tx_supplement.m_output_enote_pubkeys);
+
+    // a recipient who changed DH base is remade instead of reusing stale tables
+    destinations[0].m_recipient_DHkey = rct::pkGen();
+    const mock_tx::SpRecipientPrecompV1 &recipient_precomp{
+            recipient_precomp_cache.get_or_make(destinations[0].m_recipient_DHkey, destinations[0].m_recipient_viewkey)
+        };
+    EXPECT_TRUE(recipient_precomp_cache.size() == 3);
+
+    rct::key enote_pubkey;
+    rct::key enote_pubkey_cached;
+    const mock_tx::MockENoteSpV1 enote{destinations[0].to_enote_v1(0, enote_pubkey)};
+    const mock_tx::MockENoteSpV1 enote_cached{destinations[0].to_enote_v1(0, recipient_precomp, enote_pubkey_cached)};
+    EXPECT_TRUE(enote_cached.m_onetime_address == enote.m_onetime_address);
+    EXPECT_TRUE(enote_pubkey_cached == enote_pubkey);
+
+    // tables for another recipient are rejected
+    EXPECT_ANY_THROW(destinations[1].to_enote_v1(1, recipient_precomp, enote_pubkey_cached));
+}
+//-------------------------------------------------------------------------------------------------------------------
+TEST(seraphis, batched_amount_recovery)
+{
+    // owned enotes' amount fields
+    std::vector<mock_tx::SpAmountRecoveryRecord> records(6);
+    std::vector<rct::xmr_amount> amounts(records.size());
+    crypto::secret_key amount_mask;
+
+    for (std::size_t record_index{0}; record_index < records.size(); ++record_index)
+    {
+        mock_tx::SpAmountRecoveryRecord &record = records[record_index];
+        record.m_sender_receiver_secret = rct::rct2sk(rct::skGen());
+        record.m_baked_key = record_index % 2 ? rct::zero() : rct::skGen();
+        amounts[record_index] = crypto::rand_idx<rct::xmr_amount>(static_cast<rct::xmr_amount>(-1));
+
+        mock_tx::make_seraphis_amount_commitment_mask(record.m_sender_receiver_secret, record.m_baked_key, amount_mask);
+        record.m_amount_commitment = rct::commit(amounts[record_index], rct::sk2rct(amount_mask));
+        record.m_encoded_amount =
+            mock_tx::enc_dec_seraphis_amount(record.m_sender_receiver_secret, record.m_baked_key, amounts[record_index]);
+    }
+
+    // all recovered in one batch
+    std::vector<rct::xmr_amount> amounts_recovered;
+    std::vector<bool> recovered;
+    mock_tx::try_get_seraphis_amounts(records, amounts_recovered, recovered);
+    EXPECT_TRUE(amounts_recovered == amounts);
+    EXPECT_TRUE(recovered == std::vector<bool>(records.size(), true));
+
+    // a wrong commitment only fails its own enote
+    records[2].m_amount_commitment = rct::pkGen();
+    mock_tx::try_get_seraphis_amounts(records, amounts_recovered, recovered);
+    for (std::size_t record_index{0}; record_index < records.size(); ++record_index)
+    {
+        EXPECT_TRUE(recovered[record_index] == (record_index != 2));
+        EXPECT_TRUE(amounts_recovered[record_index] == (record_index != 2 ? amounts[record_index] : 0));
+    }
+
+    // so does a commitment that is not a point
+    records[2].m_amount_commitment = rct::zero();
+    records[2].m_amount_commitment.bytes[0] = 2;
+    mock_tx::try_get_seraphis_amounts(records, amounts_recovered, recovered);
+    EXPECT_FALSE(recovered[2]);
+    EXPECT_TRUE(recovered[5]);
+    EXPECT_TRUE(amounts_recovered[5] == amounts[5]);
+}
+//-------------------------------------------------------------------------------------------------------------------
 TEST(seraphis, sp_txtype_concise_v1)
 {
     // demo making SpTxTypeConciseV1 with raw tx builder API
@@ -654,5 +1104,8 @@ TEST(seraphis, sp_txtype_concise_v1)
 
     // validation should fail due to double-spend
     EXPECT_FALSE(mock_tx::validate_mock_txs<mock_tx::MockTxSpConciseV1>(txs, ledger_context));
+
+    // a failure in any shard fails the batch
+    EXPECT_FALSE(mock_tx::validate_mock_txs<mock_tx::MockTxSpConciseV1>(txs, ledger_context, 3));
 }
 //-------------------------------------------------------------------------------------------------------------------
@@ -202,6 +202,27 @@ TEST(Serialization, Overflow) {
   ASSERT_EQ(0, bigvector.size());
 }
 
+TEST(Serialization, serializes_blob_vectors_in_bulk)
+{
+  std::vector<rct::key> v(3), v1;
+  for (size_t i = 0; i < v.size(); ++i)
+    v[i] = rct::skGen();
+
+  string blob;
+  ASSERT_TRUE(serialization::dump_binary(v, blob));
+  ASSERT_EQ(1 + 3 * sizeof(rct::key), blob.size());
+  ASSERT_EQ(0, memcmp(blob.data() + 1, v.data(), 3 * sizeof(rct::key)));
+  ASSERT_TRUE(serialization::parse_binary(blob, v1));
+  ASSERT_EQ(v, v1);
+
+  // a truncated array fails, as does a count larger than the buffer
+  ASSERT_FALSE(serialization::parse_binary(blob.substr(0, blob.size() - 1), v1));
+  blob[0] = 4;
+  ASSERT_FALSE(serialization::parse_binary(blob, v1));
+  blob[0] = 2;
+  ASSERT_FALSE(serialization::parse_binary(blob, v1));
+}
+
 TEST(Serialization, serializes_vector_uint64_as_varint)
 {
   std::vector<uint64_t> v;
@@ -465,6 +486,81 @@ TEST(Serialization, serializes_transacion_signatures_correctly)
   ASSERT_FALSE(serialization::parse_binary(blob, tx1));
 }
 
+TEST(Serialization, tx_hashes_from_parsed_blob)
+{
+  using namespace cryptonote;
+
+  txin_gen txin_gen1;
+  txin_gen1.height = 12345;
+  tx_out out;
+  out.amount = 1000;
+  out.target = txout_to_key(crypto::public_key{});
+
+  for (size_t version = 1; version <= 2; ++version)
+  {
+    transaction tx;
+    tx.version = version;
+    tx.unlock_time = 12345 + CRYPTONOTE_MINED_MONEY_UNLOCK_WINDOW;
+    tx.vin.push_back(txin_gen1);
+    tx.vout.push_back(out);
+    tx.extra.resize(33, 1);
+    string blob;
+    ASSERT_TRUE(serialization::dump_binary(tx, blob));
+
+    // the hashes are taken from the blob when parsing, and must match those of a re-serialization
+    transaction tx1;
+    ASSERT_TRUE(parse_and_validate_tx_from_blob(blob, tx1));
+    ASSERT_TRUE(tx1.is_hash_valid());
+    ASSERT_TRUE(tx1.is_prefix_hash_valid());
+    const crypto::hash hash = tx1.hash;
+    const crypto::hash prefix_hash = tx1.prefix_hash;
+    ASSERT_EQ(prefix_hash, get_transaction_prefix_hash(tx1));
+
+    tx1.invalidate_hashes();
+    ASSERT_FALSE(tx1.is_prefix_hash_valid());
+    ASSERT_EQ(hash, get_transaction_hash(tx1));
+    ASSERT_EQ(prefix_hash, get_transaction_prefix_hash(tx1));
+    ASSERT_FALSE(tx1.is_prefix_hash_valid());
+
+    // copies keep them
+    tx1.set_prefix_hash(prefix_hash);
+    transaction tx2 = tx1;
+    ASSERT_TRUE(tx2.is_prefix_hash_valid());
+    ASSERT_EQ(prefix_hash, tx2.prefix_hash);
+  }
+}
+
+TEST(Serialization, tx_lazy_parsing)
+{
+  using namespace cryptonote;
+
+  txin_gen txin_gen1;
+  txin_gen1.height = 12345;
+  tx_out out;
+  out.amount = 1000;
+  out.target = txout_to_key(crypto::public_key{});
+
+  transaction tx;
+  tx.version = 2;
+  tx.vin.push_back(txin_gen1);
+  tx.vout.push_back(out);
+  string blob;
+  ASSERT_TRUE(serialization::dump_binary(tx, blob));
+
+  transaction full, lazy;
+  ASSERT_TRUE(parse_and_validate_tx_from_blob(blob, full));
+  ASSERT_TRUE(parse_tx_base_lazily_from_blob(blob, lazy));
+  ASSERT_TRUE(lazy.pruned);
+  ASSERT_EQ(get_transaction_hash(full), get_transaction_hash(lazy));
+  ASSERT_EQ(get_transaction_prefix_hash(full), get_transaction_prefix_hash(lazy));
+
+  // trailing data is only found when decoding the rest
+  ASSERT_FALSE(expand_tx_prunable_from_blob(blob + "x", lazy));
+  ASSERT_TRUE(expand_tx_prunable_from_blob(blob, lazy));
+  ASSERT_FALSE(lazy.pruned);
+  ASSERT_EQ(full, lazy);
+}
+
 TEST(Serialization, serializes_ringct_types)
 {
   string blob;
@@ -0,0 +1,163 @@
+// Copyright (c) 2021, The Monero Project
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of
+//    conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list
+//    of conditions and the following disclaimer in the documentation and/or other
+//    materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be
+//    used to endorse or promote products derived from this software without specific
+//    prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+// THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "gtest/gtest.h"
+
+#include <ctime>
+#include "crypto/crypto.h"
+#include "wallet/shared_block_cache.h"
+
+namespace
+{
+  // a batch of 'n' blocks starting at 'start_height', the first one with hash 'first_hash'
+  std::shared_ptr<tools::shared_block_cache::batch> make_batch(const crypto::hash &first_hash, uint64_t start_height, size_t n = 2, bool no_miner_tx = false, uint64_t pulled_time = time(NULL))
+  {
+    auto b = std::make_shared<tools::shared_block_cache::batch>();
+    b->start_height = start_height;
+    b->current_height = start_height + 100;
+    b->no_miner_tx = no_miner_tx;
+    b->blocks.resize(n);
+    b->parsed_blocks.resize(n);
+    for (size_t i = 0; i < n; ++i)
+    {
+      b->parsed_blocks[i].hash = i ? crypto::rand<crypto::hash>() : first_hash;
+      b->parsed_blocks[i].error = false;
+    }
+    b->pulled_time = pulled_time;
+    return b;
+  }
+}
+
+TEST(shared_block_cache, find_by_first_block_hash)
+{
+  tools::shared_block_cache cache;
+  const crypto::hash h0 = crypto::rand<crypto::hash>(), h1 = crypto::rand<crypto::hash>();
+  const auto b0 = make_batch(h0, 100), b1 = make_batch(h1, 200);
+  cache.add(b0);
+  cache.add(b1);
+
+  ASSERT_EQ(cache.find(h0, 100, false), b0);
+  ASSERT_EQ(cache.find(h1, 200, false), b1);
+  ASSERT_EQ(cache.find(crypto::rand<crypto::hash>(), 100, false), nullptr);
+  // only the first block of a batch is a key
+  ASSERT_EQ(cache.find(b0->parsed_blocks[1].hash, 101, false), nullptr);
+  ASSERT_EQ(cache.hits(), 2);
+  ASSERT_EQ(cache.misses(), 2);
+
+  cache.clear();
+  ASSERT_EQ(cache.find(h0, 100, false), nullptr);
+}
+
+TEST(shared_block_cache, unusable_batches_are_not_kept)
+{
+  tools::shared_block_cache cache;
+  const crypto::hash h = crypto::rand<crypto::hash>();
+
+  cache.add(nullptr);
+  cache.add(make_batch(h, 100, 0));
+  auto mismatched = make_batch(h, 100);
+  mismatched->blocks.pop_back();
+  cache.add(mismatched);
+  auto parse_error = make_batch(h, 100);
+  parse_error->parsed_blocks.back().error = true;
+  cache.add(parse_error);
+
+  ASSERT_EQ(cache.find(h, 100, false), nullptr);
+}
+
+TEST(shared_block_cache, start_height_filter)
+{
+  tools::shared_block_cache cache;
+  const crypto::hash h = crypto::rand<crypto::hash>();
+  const auto b = make_batch(h, 100);
+  cache.add(b);
+
+  // a wallet starting lower still gets the batch, the daemon would not send blocks below its start height
+  ASSERT_EQ(cache.find(h, 50, false), b);
+  ASSERT_EQ(cache.find(h, 100, false), b);
+  ASSERT_EQ(cache.find(h, 101, false), nullptr);
+}
+
+TEST(shared_block_cache, no_miner_tx_filter)
+{
+  tools::shared_block_cache cache;
+  const crypto::hash h = crypto::rand<crypto::hash>();
+  const auto with_miner_tx = make_batch(h, 100, 2, false);
+  cache.add(with_miner_tx);
+  ASSERT_EQ(cache.find(h, 100, true), nullptr);
+
+  // both flavours of the same range are kept side by side
+  const auto without_miner_tx = make_batch(h, 100, 2, true);
+  cache.add(without_miner_tx);
+  ASSERT_EQ(cache.find(h, 100, false), with_miner_tx);
+  ASSERT_EQ(cache.find(h, 100, true), without_miner_tx);
+}
+
+TEST(shared_block_cache, expiry)
+{
+  tools::shared_block_cache cache(8, 30);
+  const crypto::hash fresh = crypto::rand<crypto::hash>(), stale = crypto::rand<crypto::hash>();
+  const uint64_t now = time(NULL);
+  cache.add(make_batch(stale, 100, 2, false, now - 60));
+  cache.add(make_batch(fresh, 200, 2, false, now - 5));
+
+  ASSERT_EQ(cache.find(stale, 100, false), nullptr);
+  ASSERT_NE(cache.find(fresh, 200, false), nullptr);
+}
+
+TEST(shared_block_cache, max_batches)
+{
+  tools::shared_block_cache cache(3);
+  std::vector<crypto::hash> hashes;
+  for (size_t i = 0; i < 5; ++i)
+  {
+    hashes.push_back(crypto::rand<crypto::hash>());
+    cache.add(make_batch(hashes.back(), 100 * i));
+  }
+
+  // the oldest ones went
+  ASSERT_EQ(cache.find(hashes[0], 0, false), nullptr);
+  ASSERT_EQ(cache.find(hashes[1], 100, false), nullptr);
+  for (size_t i = 2; i < 5; ++i)
+    ASSERT_NE(cache.find(hashes[i], 100 * i, false), nullptr);
+}
+
+TEST(shared_block_cache, newer_pull_replaces_older)
+{
+  tools::shared_block_cache cache(2);
+  const crypto::hash h = crypto::rand<crypto::hash>(), other = crypto::rand<crypto::hash>();
+  const auto older = make_batch(h, 100, 2);
+  const auto newer = make_batch(h, 100, 5);
+  cache.add(older);
+  cache.add(make_batch(other, 300));
+  cache.add(newer);
+
+  ASSERT_EQ(cache.find(h, 100, false), newer);
+  // the older pull did not take a slot: the other batch is still there
+  ASSERT_NE(cache.find(other, 300, false), nullptr);
+}
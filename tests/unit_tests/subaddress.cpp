@@ -101,3 +101,56 @@ TEST_F(WalletSubaddress, OutOfBoundsIndexes)
     EXPECT_STREQ("index.minor is out of bound", e.what());  
   }   
 }
+
+TEST(subaddress, batched_spend_public_keys)
+{
+  hw::device &hwdev = hw::get_device("default");
+  cryptonote::account_base account;
+  account.generate();
+  const cryptonote::account_keys &keys = account.get_keys();
+
+  // across the 64 key groups sharing an inversion, and the (0,0) index which is the main spend key
+  const std::vector<std::tuple<uint32_t, uint32_t, uint32_t>> ranges = {
+    std::make_tuple(0, 0, 1), std::make_tuple(0, 0, 130), std::make_tuple(0, 1, 65), std::make_tuple(0, 63, 129),
+    std::make_tuple(0, 1000, 1100), std::make_tuple(3, 0, 64), std::make_tuple(3, 5, 5), std::make_tuple(7, 60, 200),
+  };
+  for (const auto &range : ranges)
+  {
+    const uint32_t major = std::get<0>(range), begin = std::get<1>(range), end = std::get<2>(range);
+    const std::vector<crypto::public_key> pkeys = hwdev.get_subaddress_spend_public_keys(keys, major, begin, end);
+    ASSERT_EQ(end - begin, pkeys.size());
+    for (uint32_t minor = begin; minor < end; ++minor)
+      ASSERT_EQ(hwdev.get_subaddress_spend_public_key(keys, {major, minor}), pkeys[minor - begin]) << major << "/" << minor;
+  }
+  ASSERT_EQ(keys.m_account_address.m_spend_public_key, hwdev.get_subaddress_spend_public_keys(keys, 0, 0, 1)[0]);
+}
+
+TEST(subaddress, wallet_expansion_matches_single_keys)
+{
+  // the wallet splits expansion into 1024 index chunks on the threadpool
+  tools::wallet2 w;
+  w.set_subaddress_lookahead(2, 1100);
+  w.generate("", "testpass", crypto::secret_key(), true, false);
+  hw::device &hwdev = hw::get_device("default");
+  const cryptonote::account_keys &keys = w.get_account().get_keys();
+
+  const auto check = [&](uint32_t major, uint32_t begin, uint32_t end)
+  {
+    for (uint32_t minor = begin; minor < end; ++minor)
+    {
+      cryptonote::account_public_address address{};
+      address.m_spend_public_key = hwdev.get_subaddress_spend_public_key(keys, {major, minor});
+      const boost::optional<cryptonote::subaddress_index> index = w.get_subaddress_index(address);
+      ASSERT_TRUE(index) << major << "/" << minor;
+      ASSERT_EQ(major, index->major);
+      ASSERT_EQ(minor, index->minor);
+    }
+  };
+
+  check(0, 0, 1100);
+  check(1, 0, 1100);
+
+  // expanding an existing account starts past its first index
+  w.expand_subaddresses({1, 1500});
+  check(1, 1100, 2600);
+}
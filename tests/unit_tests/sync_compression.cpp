@@ -0,0 +1,82 @@
+// Copyright (c) 2018, The Monero Project
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of
+//    conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list
+//    of conditions and the following disclaimer in the documentation and/or other
+//    materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be
+//    used to endorse or promote products derived from this software without specific
+//    prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+// THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "gtest/gtest.h"
+#include "cryptonote_protocol/sync_compression.h"
+
+#ifdef HAVE_ZSTD
+
+TEST(sync_compression, round_trip)
+{
+  ASSERT_TRUE(cryptonote::sync_compression_available());
+
+  std::string data;
+  for (size_t i = 0; i < 100000; ++i)
+    data.push_back("monero"[i % 6]);
+
+  std::string compressed, decompressed;
+  ASSERT_TRUE(cryptonote::sync_compress(epee::strspan<uint8_t>(data), 1, compressed));
+  ASSERT_LT(compressed.size(), data.size());
+  ASSERT_TRUE(cryptonote::sync_decompress(compressed, data.size(), decompressed));
+  ASSERT_EQ(decompressed, data);
+}
+
+TEST(sync_compression, too_large)
+{
+  const std::string data(10000, 'x');
+  std::string compressed, decompressed;
+  ASSERT_TRUE(cryptonote::sync_compress(epee::strspan<uint8_t>(data), 1, compressed));
+  ASSERT_FALSE(cryptonote::sync_decompress(compressed, data.size() - 1, decompressed));
+  ASSERT_TRUE(cryptonote::sync_decompress(compressed, data.size(), decompressed));
+}
+
+TEST(sync_compression, invalid)
+{
+  std::string decompressed;
+  ASSERT_FALSE(cryptonote::sync_decompress("", 1000, decompressed));
+  ASSERT_FALSE(cryptonote::sync_decompress("not a zstd frame", 1000, decompressed));
+
+  const std::string data(10000, 'x');
+  std::string compressed;
+  ASSERT_TRUE(cryptonote::sync_compress(epee::strspan<uint8_t>(data), 1, compressed));
+  compressed.resize(compressed.size() / 2);
+  ASSERT_FALSE(cryptonote::sync_decompress(compressed, data.size(), decompressed));
+}
+
+#else
+
+TEST(sync_compression, unavailable)
+{
+  const std::string data(1000, 'x');
+  std::string out;
+  ASSERT_FALSE(cryptonote::sync_compression_available());
+  ASSERT_FALSE(cryptonote::sync_compress(epee::strspan<uint8_t>(data), 1, out));
+  ASSERT_FALSE(cryptonote::sync_decompress(data, data.size(), out));
+}
+
+#endif
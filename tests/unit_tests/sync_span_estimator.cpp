@@ -0,0 +1,88 @@
+// Copyright (c) 2018, The Monero Project
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of
+//    conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list
+//    of conditions and the following disclaimer in the documentation and/or other
+//    materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be
+//    used to endorse or promote products derived from this software without specific
+//    prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+// THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "gtest/gtest.h"
+#include "cryptonote_basic/sync_span_estimator.h"
+
+TEST(sync_span_estimator, empty)
+{
+  cryptonote::sync_span_estimator estimator;
+  ASSERT_FALSE(estimator.has_estimate());
+  ASSERT_EQ(estimator.get_expected_seconds(100), 0.0);
+  ASSERT_EQ(estimator.get_span_blocks(2.0, 4, 100, 20), 20);
+  ASSERT_EQ(estimator.get_span_blocks(2.0, 4, 100, 1000), 100);
+  ASSERT_EQ(estimator.get_span_blocks(2.0, 4, 100, 1), 4);
+}
+
+TEST(sync_span_estimator, ignores_bad_spans)
+{
+  cryptonote::sync_span_estimator estimator;
+  estimator.add_span(0, 1.0);
+  estimator.add_span(10, -1.0);
+  ASSERT_FALSE(estimator.has_estimate());
+}
+
+TEST(sync_span_estimator, fits_rtt_and_rate)
+{
+  // 0.2 s round trip, 10 ms per block
+  cryptonote::sync_span_estimator estimator;
+  for (const uint64_t blocks: {20, 50, 100, 20, 80})
+    estimator.add_span(blocks, 0.2 + blocks * 0.01);
+  ASSERT_TRUE(estimator.has_estimate());
+  ASSERT_NEAR(estimator.get_rtt(), 0.2, 1e-6);
+  ASSERT_NEAR(estimator.get_seconds_per_block(), 0.01, 1e-9);
+  ASSERT_NEAR(estimator.get_expected_seconds(30), 0.5, 1e-6);
+  ASSERT_EQ(estimator.get_span_blocks(1.2, 4, 1000, 20), 100);
+  ASSERT_EQ(estimator.get_span_blocks(1.2, 4, 50, 20), 50);
+  ASSERT_EQ(estimator.get_span_blocks(0.1, 4, 50, 20), 4);
+}
+
+TEST(sync_span_estimator, same_size_spans)
+{
+  // the latency can't be told apart, it all goes to the blocks
+  cryptonote::sync_span_estimator estimator;
+  for (int i = 0; i < 5; ++i)
+    estimator.add_span(20, 1.0);
+  ASSERT_EQ(estimator.get_rtt(), 0.0);
+  ASSERT_NEAR(estimator.get_seconds_per_block(), 0.05, 1e-9);
+  ASSERT_EQ(estimator.get_span_blocks(2.0, 4, 100, 20), 40);
+}
+
+TEST(sync_span_estimator, follows_changes)
+{
+  // a peer that gets 10x slower is soon given much smaller spans
+  cryptonote::sync_span_estimator estimator;
+  for (int i = 0; i < 10; ++i)
+    estimator.add_span(50, 0.5);
+  const size_t fast_blocks = estimator.get_span_blocks(2.0, 4, 1000, 20);
+  for (int i = 0; i < 10; ++i)
+    estimator.add_span(50, 5.0);
+  const size_t slow_blocks = estimator.get_span_blocks(2.0, 4, 1000, 20);
+  ASSERT_EQ(fast_blocks, 200);
+  ASSERT_LT(slow_blocks, 30);
+}
@@ -29,6 +29,7 @@
 #include <atomic>
 #include "gtest/gtest.h"
 #include "misc_language.h"
+#include "common/numa_topology.h"
 #include "common/threadpool.h"
 
 TEST(threadpool, wait_nothing)
@@ -144,3 +145,101 @@ TEST(threadpool, leaf_reentrancy)
   waiter.wait();
   ASSERT_EQ(counter, 500000);
 }
+
+TEST(threadpool, parallel_for)
+{
+  for (const size_t grain : {0, 1, 7, 1000, 5000})
+  {
+    std::vector<std::atomic<int>> hits(1000);
+    for (auto &h: hits)
+      h = 0;
+    ASSERT_TRUE(tools::parallel_for(0, hits.size(), grain, [&](size_t begin, size_t end){
+      if (grain)
+        ASSERT_LE(end - begin, grain);
+      for (size_t i = begin; i < end; ++i)
+        ++hits[i];
+    }));
+    for (const auto &h: hits)
+      ASSERT_EQ(h, 1);
+  }
+  ASSERT_TRUE(tools::parallel_for(5, 5, 0, [](size_t, size_t){ throw std::runtime_error("empty range"); }));
+  ASSERT_FALSE(tools::parallel_for(0, 100, 10, [](size_t begin, size_t){ if (begin == 50) throw std::runtime_error("chunk"); }));
+}
+
+TEST(threadpool, parallel_reduce)
+{
+  // concatenation is associative but not commutative, so this checks the chunks are combined in order
+  for (const size_t grain : {0, 1, 3, 64, 100})
+  {
+    std::vector<size_t> result{12345};
+    ASSERT_TRUE(tools::parallel_reduce(10, 74, grain, result,
+      [](size_t begin, size_t end){ std::vector<size_t> v; for (size_t i = begin; i < end; ++i) v.push_back(i); return v; },
+      [](std::vector<size_t> a, std::vector<size_t> &&b){ a.insert(a.end(), b.begin(), b.end()); return a; }));
+    ASSERT_EQ(result.size(), 65);
+    ASSERT_EQ(result[0], 12345);
+    for (size_t i = 1; i < result.size(); ++i)
+      ASSERT_EQ(result[i], i + 9);
+  }
+  size_t sum = 7;
+  ASSERT_FALSE(tools::parallel_reduce(0, 64, 4, sum,
+    [](size_t begin, size_t end) -> size_t { if (begin == 32) throw std::runtime_error("chunk"); return end - begin; },
+    [](size_t a, size_t b){ return a + b; }));
+  ASSERT_EQ(sum, 7);
+}
+
+TEST(threadpool, numa_pinning)
+{
+  const auto &node_cpus = tools::get_numa_node_cpus();
+  ASSERT_EQ(node_cpus.size(), tools::get_numa_node_count());
+  ASSERT_GE(node_cpus.size(), 1);
+  for (const auto &cpus: node_cpus)
+    ASSERT_FALSE(cpus.empty());
+  ASSERT_LT(tools::get_current_numa_node(), tools::get_numa_node_count());
+  ASSERT_FALSE(tools::pin_current_thread_to_numa_node(tools::get_numa_node_count()));
+
+  // pinned workers report their node and still run everything, including tasks stolen across nodes
+  std::shared_ptr<tools::threadpool> tpool(tools::threadpool::getNewForUnitTests(4));
+  tpool->set_numa_pinning(true);
+  ASSERT_TRUE(tpool->get_numa_pinning());
+  std::atomic<size_t> count(0), bad_node(0);
+  tools::threadpool::waiter waiter(*tpool);
+  for (size_t n = 0; n < 1000; ++n)
+    tpool->submit(&waiter, [&](){
+      if (tools::get_current_numa_node() >= tools::get_numa_node_count())
+        ++bad_node;
+      ++count;
+    });
+  ASSERT_TRUE(waiter.wait());
+  ASSERT_EQ(count, 1000);
+  ASSERT_EQ(bad_node, 0);
+  tpool->set_numa_pinning(false);
+  ASSERT_FALSE(tpool->get_numa_pinning());
+}
+
+TEST(threadpool, numa_replicated)
+{
+  std::atomic<int> copies(0);
+  const tools::numa_replicated<std::vector<int>> replicated(std::make_shared<std::vector<int>>(100, 7),
+    [&copies](const std::vector<int> &v){ ++copies; return std::make_shared<std::vector<int>>(v); });
+
+  // every thread sees equal contents, and there is at most one copy per node
+  std::shared_ptr<tools::threadpool> tpool(tools::threadpool::getNewForUnitTests(4));
+  tpool->set_numa_pinning(true);
+  std::atomic<size_t> mismatches(0);
+  tools::threadpool::waiter waiter(*tpool);
+  for (size_t n = 0; n < 100; ++n)
+    tpool->submit(&waiter, [&](){
+      const std::shared_ptr<std::vector<int>> v = replicated.get();
+      if (!v || *v != *replicated.original())
+        ++mismatches;
+    });
+  ASSERT_TRUE(waiter.wait());
+  ASSERT_EQ(mismatches, 0);
+  if (tools::get_numa_node_count() == 1)
+  {
+    ASSERT_EQ(copies, 0);
+    ASSERT_TRUE(replicated.get() == replicated.original());
+  }
+  else
+    ASSERT_LE(copies, tools::get_numa_node_count());
+}
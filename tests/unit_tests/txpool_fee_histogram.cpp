@@ -0,0 +1,266 @@
+// Copyright (c) 2022, The Monero Project
+// 
+// All rights reserved.
+// 
+// Redistribution and use in source and binary forms, with or without modification, are
+// permitted provided that the following conditions are met:
+// 
+// 1. Redistributions of source code must retain the above copyright notice, this list of
+//    conditions and the following disclaimer.
+// 
+// 2. Redistributions in binary form must reproduce the above copyright notice, this list
+//    of conditions and the following disclaimer in the documentation and/or other
+//    materials provided with the distribution.
+// 
+// 3. Neither the name of the copyright holder nor the names of its contributors may be
+//    used to endorse or promote products derived from this software without specific
+//    prior written permission.
+// 
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+// MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL
+// THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+// SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+// STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+// THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "gtest/gtest.h"
+#include "cryptonote_basic/cryptonote_format_utils.h"
+#include "cryptonote_core/blockchain.h"
+#include "cryptonote_core/tx_pool.h"
+#include "cryptonote_core/cryptonote_core.h"
+#include "blockchain_db/testdb.h"
+
+#include <unordered_map>
+
+namespace
+{
+
+class TestDB: public cryptonote::BaseTestDB
+{
+public:
+  TestDB() { m_open = true; }
+
+  virtual void add_block( const cryptonote::block& blk
+                        , size_t block_weight
+                        , uint64_t long_term_block_weight
+                        , const cryptonote::difficulty_type& cumulative_difficulty
+                        , const uint64_t& coins_generated
+                        , uint64_t num_rct_outs
+                        , const crypto::hash& blk_hash
+                        ) override {
+    ++blocks;
+  }
+  virtual uint64_t height() const override { return blocks; }
+  virtual crypto::hash get_block_hash_from_height(const uint64_t &height) const override {
+    crypto::hash hash = crypto::null_hash;
+    *(uint64_t*)&hash = height;
+    return hash;
+  }
+  virtual crypto::hash top_block_hash(uint64_t *block_height = NULL) const override {
+    crypto::hash top = crypto::null_hash;
+    if (blocks)
+      *(uint64_t*)&top = blocks - 1;
+    if (block_height)
+      *block_height = blocks - 1;
+    return top;
+  }
+
+  virtual void add_txpool_tx(const crypto::hash &txid, const cryptonote::blobdata_ref &blob, const cryptonote::txpool_tx_meta_t& details) override {
+    txpool[txid] = {details, cryptonote::blobdata(blob.data(), blob.size())};
+  }
+  virtual void update_txpool_tx(const crypto::hash &txid, const cryptonote::txpool_tx_meta_t& details) override {
+    txpool.at(txid).meta = details;
+  }
+  virtual uint64_t get_txpool_tx_count(cryptonote::relay_category tx_relay = cryptonote::relay_category::broadcasted) const override {
+    uint64_t count = 0;
+    for (const auto &e: txpool)
+      count += e.second.meta.matches(tx_relay);
+    return count;
+  }
+  virtual bool txpool_has_tx(const crypto::hash &txid, cryptonote::relay_category tx_category) const override {
+    const auto it = txpool.find(txid);
+    return it != txpool.end() && it->second.meta.matches(tx_category);
+  }
+  virtual void remove_txpool_tx(const crypto::hash& txid) override { txpool.erase(txid); }
+  virtual bool get_txpool_tx_meta(const crypto::hash& txid, cryptonote::txpool_tx_meta_t &meta) const override {
+    const auto it = txpool.find(txid);
+    if (it == txpool.end())
+      return false;
+    meta = it->second.meta;
+    return true;
+  }
+  virtual bool get_txpool_tx_blob(const crypto::hash& txid, cryptonote::blobdata &bd, cryptonote::relay_category tx_category) const override {
+    if (!txpool_has_tx(txid, tx_category))
+      return false;
+    bd = txpool.at(txid).blob;
+    return true;
+  }
+  virtual cryptonote::blobdata get_txpool_tx_blob(const crypto::hash& txid, cryptonote::relay_category tx_category) const override {
+    cryptonote::blobdata bd;
+    get_txpool_tx_blob(txid, bd, tx_category);
+    return bd;
+  }
+  virtual bool for_all_txpool_txes(std::function<bool(const crypto::hash&, const cryptonote::txpool_tx_meta_t&, const cryptonote::blobdata_ref*)> f, bool include_blob = false, cryptonote::relay_category category = cryptonote::relay_category::broadcasted) const override {
+    for (const auto &e: txpool)
+    {
+      if (!e.second.meta.matches(category))
+        continue;
+      const cryptonote::blobdata_ref blob{e.second.blob};
+      if (!f(e.first, e.second.meta, include_blob ? &blob : nullptr))
+        return false;
+    }
+    return true;
+  }
+
+private:
+  struct txpool_entry
+  {
+    cryptonote::txpool_tx_meta_t meta;
+    cryptonote::blobdata blob;
+  };
+
+  uint64_t blocks = 0;
+  std::unordered_map<crypto::hash, txpool_entry> txpool;
+};
+
+struct BlockchainAndPool
+{
+  cryptonote::tx_memory_pool txpool;
+  cryptonote::Blockchain bc;
+  BlockchainAndPool(): txpool(bc), bc(txpool) {}
+};
+
+// a v1 tx spending one fake output, paying the given fee
+cryptonote::transaction make_tx(uint64_t fee)
+{
+  cryptonote::transaction tx;
+  tx.version = 1;
+  cryptonote::txin_to_key in;
+  in.amount = 1000000 + fee;
+  in.key_offsets.push_back(0);
+  in.k_image = rct::rct2ki(rct::pkGen());
+  tx.vin.push_back(in);
+  cryptonote::tx_out out;
+  out.amount = 1000000;
+  out.target = cryptonote::txout_to_key(rct::rct2pk(rct::pkGen()));
+  tx.vout.push_back(out);
+  tx.signatures.resize(1);
+  tx.signatures[0].resize(1);
+  return tx;
+}
+
+void add_to_db(TestDB &db, const cryptonote::transaction &tx, uint64_t weight, cryptonote::relay_method method)
+{
+  cryptonote::txpool_tx_meta_t meta{};
+  meta.weight = weight;
+  meta.fee = cryptonote::get_tx_fee(tx);
+  meta.receive_time = time(NULL);
+  meta.kept_by_block = method == cryptonote::relay_method::block;
+  meta.set_relay_method(method);
+  db.add_txpool_tx(cryptonote::get_transaction_hash(tx), cryptonote::t_serializable_object_to_blob(tx), meta);
+}
+
+// each histogram bucket must hold exactly the backlog txes whose fee per byte falls in its range
+void check_histogram(const cryptonote::tx_memory_pool &txpool, bool include_sensitive, size_t expected_txs)
+{
+  std::vector<cryptonote::tx_backlog_entry> backlog;
+  txpool.get_transaction_backlog(backlog, include_sensitive);
+  ASSERT_EQ(backlog.size(), expected_txs);
+
+  std::vector<cryptonote::tx_backlog_fee_bucket> histogram;
+  txpool.get_transaction_backlog_histogram(histogram, include_sensitive);
+
+  uint64_t histogram_txs = 0;
+  for (const auto &bucket: histogram)
+  {
+    uint64_t weight = 0, txs = 0;
+    for (const auto &e: backlog)
+    {
+      const double fee_per_byte = e.fee / (double)e.weight;
+      if (fee_per_byte >= bucket.min_fee_per_byte && fee_per_byte < bucket.max_fee_per_byte)
+      {
+        weight += e.weight;
+        ++txs;
+      }
+    }
+    ASSERT_EQ(bucket.weight, weight);
+    ASSERT_EQ(bucket.txs, txs);
+    histogram_txs += bucket.txs;
+  }
+  ASSERT_EQ(histogram_txs, backlog.size());
+}
+
+}
+
+#define CHECK_HISTOGRAM(all, broadcasted) \
+  do { \
+    check_histogram(bap.txpool, true, all); \
+    check_histogram(bap.txpool, false, broadcasted); \
+  } while(0)
+
+TEST(txpool_fee_histogram, add_remove_relay_init)
+{
+  BlockchainAndPool bap;
+  const std::pair<uint8_t, uint64_t> hard_forks[2] = {std::make_pair(1, 0), std::make_pair(0, 0)};
+  const cryptonote::test_options test_options = {hard_forks, 0};
+  TestDB *db = new TestDB();
+  ASSERT_TRUE(bap.bc.init(db, cryptonote::FAKECHAIN, true, &test_options, 0, NULL));
+
+  // fees per byte of 100 and 101 share a bucket, 3 has its own, none on a bucket boundary
+  const cryptonote::transaction fluffed = make_tx(100 * 1000);
+  const cryptonote::transaction local = make_tx(101 * 1000);
+  const cryptonote::transaction from_block = make_tx(3 * 2000);
+  add_to_db(*db, fluffed, 1000, cryptonote::relay_method::fluff);
+  add_to_db(*db, local, 1000, cryptonote::relay_method::local);
+  add_to_db(*db, from_block, 2000, cryptonote::relay_method::block);
+
+  // init() builds the histogram from the pool in the database
+  ASSERT_TRUE(bap.txpool.init());
+  CHECK_HISTOGRAM(3, 2);
+  std::vector<cryptonote::tx_backlog_fee_bucket> histogram;
+  bap.txpool.get_transaction_backlog_histogram(histogram, true);
+  ASSERT_EQ(histogram.size(), 2);
+  ASSERT_EQ(histogram[0].txs, 2);
+  ASSERT_EQ(histogram[0].weight, 2000);
+  ASSERT_EQ(histogram[1].txs, 1);
+  ASSERT_EQ(histogram[1].weight, 2000);
+
+  // add
+  cryptonote::transaction added = make_tx(1000 * 500);
+  const cryptonote::blobdata added_blob = cryptonote::t_serializable_object_to_blob(added);
+  const crypto::hash added_id = cryptonote::get_transaction_hash(added);
+  cryptonote::tx_verification_context tvc{};
+  ASSERT_TRUE(bap.txpool.add_tx(added, added_id, added_blob, 500, tvc, cryptonote::relay_method::block, true, 1));
+  CHECK_HISTOGRAM(4, 3);
+
+  // relay method change: the local tx gets broadcasted
+  const crypto::hash local_id = cryptonote::get_transaction_hash(local);
+  bap.txpool.set_relayed(epee::span<const crypto::hash>(&local_id, 1), cryptonote::relay_method::fluff);
+  CHECK_HISTOGRAM(4, 4);
+
+  // remove
+  cryptonote::transaction tx;
+  cryptonote::blobdata blob;
+  size_t weight;
+  uint64_t fee;
+  bool relayed, do_not_relay, double_spend_seen, pruned;
+  ASSERT_TRUE(bap.txpool.take_tx(cryptonote::get_transaction_hash(fluffed), tx, blob, weight, fee, relayed, do_not_relay, double_spend_seen, pruned));
+  CHECK_HISTOGRAM(3, 3);
+
+  // a rebuild gives the same histogram as the incremental updates
+  std::vector<cryptonote::tx_backlog_fee_bucket> before, after;
+  bap.txpool.get_transaction_backlog_histogram(before, true);
+  ASSERT_TRUE(bap.txpool.init());
+  CHECK_HISTOGRAM(3, 3);
+  bap.txpool.get_transaction_backlog_histogram(after, true);
+  ASSERT_EQ(before.size(), after.size());
+  for (size_t i = 0; i < before.size(); ++i)
+  {
+    ASSERT_EQ(before[i].min_fee_per_byte, after[i].min_fee_per_byte);
+    ASSERT_EQ(before[i].weight, after[i].weight);
+    ASSERT_EQ(before[i].txs, after[i].txs);
+  }
+}
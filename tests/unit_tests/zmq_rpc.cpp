@@ -34,11 +34,14 @@
 #include "cryptonote_basic/cryptonote_basic.h"
 #include "cryptonote_basic/events.h"
 #include "cryptonote_basic/cryptonote_format_utils.h"
+#include "cryptonote_core/tx_verification_batch.h"
 #include "json_serialization.h"
 #include "net/zmq.h"
 #include "rpc/message.h"
 #include "rpc/zmq_pub.h"
 #include "rpc/zmq_server.h"
+#include "rpc/zmq_verification.h"
+#include "serialization/binary_utils.h"
 #include "serialization/json_object.h"
 
 #define MASSERT(...)                                                      \
@@ -705,8 +708,7 @@ TEST_F(zmq_pub, JsonAll)
   {
     const std::array<cryptonote::block, 1> blocks{{make_block()}};
 
-    EXPECT_EQ(2u, pub->send_chain_main(100, epee::to_span(blocks)));
-    EXPECT_TRUE(pub->relay_to_pub(relay.get(), dummy_pub.get()));
+    EXPECT_EQ(1u, pub->send_chain_main(100, epee::to_span(blocks)));
     EXPECT_TRUE(pub->relay_to_pub(relay.get(), dummy_pub.get()));
 
     auto pubs = get_published(dummy_client.get());
@@ -717,7 +719,6 @@ TEST_F(zmq_pub, JsonAll)
 
     EXPECT_NO_THROW(cryptonote::listener::zmq_pub::chain_main{pub}(533, epee::to_span(blocks)));
     EXPECT_TRUE(pub->relay_to_pub(relay.get(), dummy_pub.get()));
-    EXPECT_TRUE(pub->relay_to_pub(relay.get(), dummy_pub.get()));
 
     pubs = get_published(dummy_client.get());
     EXPECT_EQ(2u, pubs.size());
@@ -774,3 +775,119 @@ TEST_F(zmq_server, pub)
   EXPECT_TRUE(compare_minimal_txpool(epee::to_span(events), pubs.front()));
   EXPECT_TRUE(compare_minimal_block(200, epee::to_span(blocks), pubs.back()));
 }
+
+namespace
+{
+  struct zmq_verification : public zmq_base
+  {
+    //! A ringct tx spending every output of a miner tx, with the ring members a node would resolve
+    cryptonote::tx_verification_job make_job()
+    {
+      const cryptonote::transaction miner_tx = make_miner_transaction();
+      cryptonote::account_base to;
+      to.generate();
+      const cryptonote::transaction tx =
+        test::make_transaction(acct.get_keys(), {miner_tx}, {to.get_keys().m_account_address}, true, true);
+
+      // inputs are sorted by key image, so find the output each one spends
+      std::unordered_map<crypto::public_key, cryptonote::subaddress_index> subaddresses;
+      subaddresses[acct.get_keys().m_account_address.m_spend_public_key] = {0, 0};
+      std::unordered_map<crypto::key_image, rct::ctkey> spent;
+      for (std::size_t i = 0; i < miner_tx.vout.size(); ++i)
+      {
+        const crypto::public_key& key = boost::get<cryptonote::txout_to_key>(miner_tx.vout[i].target).key;
+        cryptonote::keypair ephemeral{};
+        crypto::key_image key_image{};
+        EXPECT_TRUE(cryptonote::generate_key_image_helper(acct.get_keys(), subaddresses, key,
+          cryptonote::get_tx_pub_key_from_extra(miner_tx), {}, i, ephemeral, key_image, hw::get_device("default")));
+        spent[key_image] = {rct::pk2rct(key), rct::zeroCommit(miner_tx.vout[i].amount)};
+      }
+
+      cryptonote::tx_verification_job job{cryptonote::tx_to_blob(tx), {}};
+      for (const cryptonote::txin_v& in : tx.vin)
+      {
+        const cryptonote::txin_to_key& to_key = boost::get<cryptonote::txin_to_key>(in);
+        job.ring_members.emplace_back(to_key.key_offsets.size(), spent.at(to_key.k_image));
+      }
+      return job;
+    }
+  };
+}
+
+TEST(zmq_verification_batch, Serialization)
+{
+  cryptonote::tx_verification_batch batch{7, 14, {}};
+  batch.txs.push_back({"not a tx", {{{rct::identity(), rct::H}}, {}}});
+  batch.txs.push_back({"", {}});
+
+  std::string blob;
+  ASSERT_TRUE(::serialization::dump_binary(batch, blob));
+  cryptonote::tx_verification_batch parsed{};
+  ASSERT_TRUE(::serialization::parse_binary(blob, parsed));
+  EXPECT_EQ(7u, parsed.batch_id);
+  EXPECT_EQ(14u, parsed.hf_version);
+  ASSERT_EQ(2u, parsed.txs.size());
+  EXPECT_EQ("not a tx", parsed.txs[0].tx_blob);
+  ASSERT_EQ(2u, parsed.txs[0].ring_members.size());
+  ASSERT_EQ(1u, parsed.txs[0].ring_members[0].size());
+  EXPECT_EQ(rct::H, parsed.txs[0].ring_members[0][0].mask);
+  EXPECT_TRUE(parsed.txs[0].ring_members[1].empty());
+  EXPECT_TRUE(parsed.txs[1].tx_blob.empty());
+}
+
+TEST_F(zmq_verification, VerifyBatch)
+{
+  // the test rings repeat one output, which is only allowed before v6
+  cryptonote::tx_verification_batch batch{3, 1, {}};
+  batch.txs.push_back(make_job());
+  batch.txs.push_back({"garbage", {}});
+  batch.txs.push_back(make_job());
+  batch.txs.back().ring_members.back().back().mask = rct::zeroCommit(1);
+  batch.txs.push_back(make_job());
+  batch.txs.back().ring_members.pop_back();
+
+  cryptonote::tx_verification_result result = cryptonote::verify_tx_batch(batch);
+  EXPECT_EQ(3u, result.batch_id);
+  EXPECT_EQ((std::vector<std::uint8_t>{1, 0, 0, 0}), result.verdicts);
+
+  batch.hf_version = 14;
+  result = cryptonote::verify_tx_batch(batch);
+  EXPECT_EQ((std::vector<std::uint8_t>{0, 0, 0, 0}), result.verdicts);
+}
+
+TEST_F(zmq_verification, Workers)
+{
+  static constexpr const char jobs_address[] = "tcp://127.0.0.1:38190";
+  static constexpr const char results_address[] = "tcp://127.0.0.1:38191";
+
+  cryptonote::rpc::ZmqVerificationCoordinator coordinator;
+  ASSERT_TRUE(coordinator.init(jobs_address, results_address));
+
+  // two workers, one with two threads
+  cryptonote::rpc::ZmqVerificationWorker worker1, worker2;
+  ASSERT_TRUE(worker1.init(jobs_address, results_address, 1));
+  ASSERT_TRUE(worker2.init(jobs_address, results_address, 2));
+  worker1.run();
+  worker2.run();
+
+  std::vector<cryptonote::tx_verification_job> jobs;
+  std::vector<std::uint8_t> expected;
+  for (unsigned i = 0; i < 10; ++i)
+  {
+    if (i % 3 == 1)
+      jobs.push_back(make_job());
+    else
+      jobs.push_back({std::string(i, 'x'), {}});
+    expected.push_back(i % 3 == 1);
+  }
+
+  const expect<std::vector<std::uint8_t>> verdicts = coordinator.verify(std::move(jobs), 1, 3);
+  ASSERT_TRUE(bool(verdicts));
+  EXPECT_EQ(expected, *verdicts);
+  EXPECT_EQ(0u, coordinator.in_flight());
+
+  EXPECT_FALSE(bool(coordinator.verify({}, 1, 0)));
+
+  worker1.stop();
+  worker2.stop();
+}